@@ -112,6 +112,10 @@ do { \
 
 #  ifdef CONFIG_MM_SHM
 #    define ARCH_SHM_NSECTS   ARCH_PG2SECT(ARCH_SHM_MAXPAGES)
+
+/* Large page shared memory is mapped with 1MiB sections */
+
+#    define ARCH_SHM_LPGSHIFT 20
 #  endif
 
 #  ifdef CONFIG_ARCH_STACK_DYNAMIC
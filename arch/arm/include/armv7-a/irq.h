@@ -262,10 +262,12 @@ struct xcptcontext
   /* Extra fault address register saved for common paging logic.  In the
    * case of the pre-fetch abort, this value is the same as regs[REG_R15];
    * For the case of the data abort, this value is the value of the fault
-   * address register (FAR) at the time of data abort exception.
+   * address register (FAR) at the time of data abort exception.  It is
+   * also used to pass the faulting address of a file mapping to the page
+   * fill.
    */
 
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING) || defined(CONFIG_FS_FILEMAP)
   uintptr_t far;
 #endif
 
@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/arm/include/tls.h
  *
- *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 #include <assert.h>
 #include <nuttx/arch.h>
+#include <nuttx/sched.h>
 #include <nuttx/tls.h>
 
 #ifdef CONFIG_TLS
@@ -51,6 +52,7 @@
  * Inline Functions
  ****************************************************************************/
 
+#ifndef CONFIG_TLS_THREADPTR
 /****************************************************************************
  * Name: up_getsp
  ****************************************************************************/
@@ -103,5 +105,53 @@ static inline FAR struct tls_info_s *up_tls_info(void)
   return TLS_INFO((uintptr_t)up_getsp());
 }
 
+#else /* CONFIG_TLS_THREADPTR */
+/****************************************************************************
+ * Name: up_tls_info
+ *
+ * Description:
+ *   Return the TLS information structure for the currently executing
+ *   thread.  The structure still lies at the "lower" end of the stack, but
+ *   the stack is not aligned.  Its address is kept in the User Read-Only
+ *   Thread ID register (TPIDRURO), which can be read but not written in
+ *   user mode.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tls_info_s *up_tls_info(void)
+{
+  FAR struct tls_info_s *info;
+
+  DEBUGASSERT(!up_interrupt_context());
+  __asm__ __volatile__
+  (
+    "\tmrc p15, 0, %0, c13, c0, 3\n\t"
+    : "=r"(info)
+  );
+
+  return info;
+}
+
+/****************************************************************************
+ * Name: up_tls_resume
+ *
+ * Description:
+ *   Called by sched_resume_scheduler() when the thread 'tcb' is about to
+ *   run on this CPU.  Point TPIDRURO at the TLS information structure of
+ *   the thread.
+ *
+ ****************************************************************************/
+
+static inline void up_tls_resume(FAR struct tcb_s *tcb)
+{
+  __asm__ __volatile__
+  (
+    "\tmcr p15, 0, %0, c13, c0, 3\n\t"
+    :
+    : "r"(tcb->stack_alloc_ptr)
+  );
+}
+#endif /* CONFIG_TLS_THREADPTR */
+
 #endif /* CONFIG_TLS */
 #endif /* __ARCH_ARM_INCLUDE_TLS_H */
@@ -2,7 +2,7 @@
  * arch/arm/src/arm/up_allocpage.c
  * Allocate a new page and map it to the fault address of a task.
  *
- *   Copyright (C) 2010 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2010, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -167,18 +167,32 @@ static bool g_pgwrap;
 
 int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
 {
-  uintptr_t vaddr;
-  uintptr_t paddr;
-  uint32_t *pte;
-  unsigned int pgndx;
-
   /* Since interrupts are disabled, we don't need to anything special. */
 
   DEBUGASSERT(tcb && vpage);
 
-  /* Get the virtual address that caused the fault */
+  /* Map the virtual address that caused the fault */
+
+  return up_allocpage_va(tcb->xcp.far, vpage);
+}
+
+/****************************************************************************
+ * Name: up_allocpage_va()
+ *
+ * Description:
+ *  Allocate a page and map it at a virtual address in the paged text
+ *  region.  Pages are replaced in the order of their allocation so that
+ *  the most recent CONFIG_PAGING_NPPAGED - 1 allocations are always kept.
+ *
+ ****************************************************************************/
+
+int up_allocpage_va(uintptr_t vaddr, FAR void **vpage)
+{
+  uintptr_t paddr;
+  uint32_t *pte;
+  unsigned int pgndx;
 
-  vaddr = tcb->xcp.far;
+  DEBUGASSERT(vpage);
   DEBUGASSERT(vaddr >= PG_PAGED_VBASE && vaddr < PG_PAGED_VEND);
 
   /* Allocate page memory to back up the mapping.  Start by getting the
@@ -186,7 +200,7 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
    */
 
   pgndx = g_pgndx++;
-  if (g_pgndx >= CONFIG_PAGING)
+  if (g_pgndx >= CONFIG_PAGING_NPPAGED)
     {
       g_pgndx  = 0;
       g_pgwrap = true;
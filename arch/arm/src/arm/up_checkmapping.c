@@ -3,7 +3,7 @@
  * Check if the current task's fault address has been mapped into the virtual
  * address space.
  *
- *   Copyright (C) 2010 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2010, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -99,16 +99,28 @@
 
 bool up_checkmapping(FAR struct tcb_s *tcb)
 {
-  uintptr_t vaddr;
-  uint32_t *pte;
-
   /* Since interrupts are disabled, we don't need to anything special. */
 
   DEBUGASSERT(tcb);
 
-  /* Get the virtual address that caused the fault */
+  /* Check the virtual address that caused the fault */
+
+  return up_checkmapping_va(tcb->xcp.far);
+}
+
+/****************************************************************************
+ * Name: up_checkmapping_va()
+ *
+ * Description:
+ *  Return true if the page at the virtual address in the paged text region
+ *  is mapped.
+ *
+ ****************************************************************************/
+
+bool up_checkmapping_va(uintptr_t vaddr)
+{
+  uint32_t *pte;
 
-  vaddr = tcb->xcp.far;
   DEBUGASSERT(vaddr >= PG_PAGED_VBASE && vaddr < PG_PAGED_VEND);
 
   /* Get the PTE associated with this virtual address */
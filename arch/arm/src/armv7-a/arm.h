@@ -83,6 +83,18 @@
 #define PSR_Z_BIT         (1 << 30) /* Bit 30: Zero condition flag */
 #define PSR_N_BIT         (1 << 31) /* Bit 31: Negative condition flag */
 
+/* Fault status (DFSR/IFSR, short-descriptor format).  The five-bit fault
+ * status is held in bits 0-3 and bit 10.
+ */
+
+#define FSR_MASK          (0x0000040f) /* Bits 0-3, 10: Fault status */
+#  define FSR_ALIGN       (0x00000001) /* Alignment fault */
+#  define FSR_SECT        (0x00000005) /* Section translation fault */
+#  define FSR_PAGE        (0x00000007) /* Page translation fault */
+#  define FSR_PERMSECT    (0x0000000d) /* Section permission fault */
+#  define FSR_PERMPAGE    (0x0000000f) /* Page permission fault */
+#define FSR_WNR           (1 << 11)    /* Bit 11: Write not read (DFSR only) */
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -124,6 +136,29 @@ extern "C"
 
 void arm_data_initialize(void);
 
+/****************************************************************************
+ * Name: arm_filemap_redirect
+ *
+ * Description:
+ *   Called from the data abort handler when a translation fault occurs in
+ *   the file mapping window.  The interrupted context is saved in the TCB
+ *   and the return state is modified so that the faulting thread resumes
+ *   in arm_filemap_fault() where the page may be filled with interrupts
+ *   enabled.
+ *
+ * Input Parameters:
+ *   regs - The register save area of the faulting context
+ *   far  - The faulting virtual address
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILEMAP
+void arm_filemap_redirect(uint32_t *regs, uint32_t far);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -377,7 +377,7 @@ int up_addrenv_destroy(FAR group_addrenv_t *addrenv)
    * data).
    */
 
-  arm_addrenv_destroy_region(addrenv->heap, ARCH_SHM_NSECTS,
+  arm_addrenv_destroy_region(addrenv->shm, ARCH_SHM_NSECTS,
                              CONFIG_ARCH_SHM_VBASE, true);
 #endif
 #endif
@@ -599,6 +599,16 @@ int up_addrenv_select(FAR const group_addrenv_t *addrenv,
       /* Set (or clear) the new page table entry */
 
       paddr = (uintptr_t)addrenv->shm[i];
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+      if ((paddr & PMD_TYPE_MASK) == PMD_TYPE_SECT)
+        {
+          /* This is a large page section entry, not a page table */
+
+          mmu_l1_setentry(paddr & PMD_SECT_PADDR_MASK, vaddr,
+                          paddr & ~PMD_SECT_PADDR_MASK);
+        }
+      else
+#endif
       if (paddr)
         {
           mmu_l1_setentry(paddr, vaddr, MMU_L1_PGTABFLAGS);
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <errno.h>
 
@@ -54,6 +55,46 @@
 
 #if defined(CONFIG_BUILD_KERNEL) && defined(CONFIG_MM_SHM)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_shm_issection
+ *
+ * Description:
+ *   Check if the next pages of a shared memory region can be mapped at a
+ *   virtual address with a single section:  The virtual address and the
+ *   first physical page must be section aligned, there must be at least one
+ *   section of pages remaining, and those pages must be physically
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+static bool arm_shm_issection(FAR uintptr_t *pages, unsigned int npages,
+                              uintptr_t vaddr)
+{
+  unsigned int i;
+
+  if ((vaddr & SECTION_MASK) != 0 || (pages[0] & SECTION_MASK) != 0 ||
+      npages < ARCH_SECT2PG(1))
+    {
+      return false;
+    }
+
+  for (i = 1; i < ARCH_SECT2PG(1); i++)
+    {
+      if (pages[i] != pages[0] + (i << MM_PGSHIFT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -62,7 +103,10 @@
  * Name: up_shmat
  *
  * Description:
- *   Attach, i.e, map, on shared memory region to a user virtual address
+ *   Attach, i.e, map, on shared memory region to a user virtual address.
+ *   If CONFIG_MM_SHM_LARGEPAGES is selected, each section aligned run of
+ *   physically contiguous pages is mapped with one section entry in the
+ *   level 1 page table rather than with a level 2 page table.
  *
  * Input Parameters:
  *   pages - A pointer to the first element in a array of physical address,
@@ -113,6 +157,31 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
       /* Has a level 1 page table entry been created for this virtual address */
 
       l1entry = group->tg_addrenv.shm[shmndx];
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+      /* Can the whole section be mapped with one level 1 entry?  The
+       * section entry is kept in the shm[] list (marked by its type bits)
+       * so that it is re-instantiated when the address environment is
+       * selected.
+       */
+
+      if (l1entry == NULL && arm_shm_issection(pages, npages - nmapped, vaddr))
+        {
+          paddr = *pages;
+
+          flags = enter_critical_section();
+          group->tg_addrenv.shm[shmndx] =
+            (FAR uintptr_t *)(paddr | MMU_L1_USHMFLAGS);
+          mmu_l1_setentry(paddr, vaddr, MMU_L1_USHMFLAGS);
+          leave_critical_section(flags);
+
+          pages   += ARCH_SECT2PG(1);
+          nmapped += ARCH_SECT2PG(1);
+          vaddr   += SECTION_SIZE;
+          continue;
+        }
+#endif
+
       if (l1entry == NULL)
         {
           /* No.. Allocate one physical page for the L2 page table */
@@ -265,6 +334,27 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages)
       l1entry = group->tg_addrenv.shm[shmndx];
       DEBUGASSERT(l1entry != NULL);
 
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+      /* Is this section mapped with a single section entry?  If so, just
+       * remove it from the level 1 page table.
+       */
+
+      if (((uintptr_t)l1entry & PMD_TYPE_MASK) == PMD_TYPE_SECT)
+        {
+          DEBUGASSERT((vaddr & SECTION_MASK) == 0 &&
+                      npages - nunmapped >= ARCH_SECT2PG(1));
+
+          flags = enter_critical_section();
+          group->tg_addrenv.shm[shmndx] = NULL;
+          mmu_l1_clrentry(vaddr);
+          leave_critical_section(flags);
+
+          nunmapped += ARCH_SECT2PG(1);
+          vaddr     += SECTION_SIZE;
+          continue;
+        }
+#endif
+
       /* Get the physical address of the L2 page table from the L1 page
        * table entry.
        */
@@ -211,6 +211,16 @@ void arm_addrenv_destroy_region(FAR uintptr_t **list, unsigned int listlen,
       /* Has this page table been allocated? */
 
       paddr = (uintptr_t)list[i];
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+      /* Large page shared memory sections have no page table */
+
+      if ((paddr & PMD_TYPE_MASK) == PMD_TYPE_SECT)
+        {
+          continue;
+        }
+#endif
+
       if (paddr != 0)
         {
           flags = enter_critical_section();
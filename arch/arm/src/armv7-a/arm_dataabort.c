@@ -52,6 +52,11 @@
 #  include "arm.h"
 #endif
 
+#ifdef CONFIG_FS_FILEMAP
+#  include <nuttx/fs/filemap.h>
+#  include "arm.h"
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -162,12 +167,33 @@ segfault:
 
 uint32_t *arm_dataabort(uint32_t *regs, uint32_t dfar, uint32_t dfsr)
 {
+#ifdef CONFIG_FS_FILEMAP
+  uint32_t *savestate = (uint32_t *)CURRENT_REGS;
+#endif
+
   /* Save the saved processor context in CURRENT_REGS where it can be accessed
    * for register dumps and possibly context switching.
    */
 
   CURRENT_REGS = regs;
 
+#ifdef CONFIG_FS_FILEMAP
+  /* A page translation fault in the file mapping window is resolved by the
+   * faulting thread itself:  The page fill may block on file system I/O so
+   * it cannot be performed here.  That is only possible if the fault did
+   * not occur in an interrupt handler or with interrupts disabled.
+   */
+
+  if ((dfsr & FSR_MASK) == FSR_PAGE && FILEMAP_INWINDOW(dfar) &&
+      savestate == NULL && (regs[REG_CPSR] & PSR_I_BIT) == 0)
+    {
+      arm_filemap_redirect(regs, dfar);
+
+      CURRENT_REGS = savestate;
+      return regs;
+    }
+#endif
+
   /* Crash -- possibly showing diagnostic debug information. */
 
   _alert("Data abort. PC: %08x DFAR: %08x DFSR: %08x\n",
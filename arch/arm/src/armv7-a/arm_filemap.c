@@ -0,0 +1,292 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_filemap.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/fs/filemap.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+#include "arm.h"
+#include "mmu.h"
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if MM_PGSIZE != 4096
+#  error The file mapping window requires 4KB pages
+#endif
+
+#if (CONFIG_FS_FILEMAP_VBASE & SECTION_MASK) != 0
+#  error CONFIG_FS_FILEMAP_VBASE must be aligned to a 1MB section
+#endif
+
+/* Number of 1MB sections (and, hence, L2 page tables) in the window.  With
+ * 4KB pages, each L2 page table holds 256 entries.
+ */
+
+#define FILEMAP_NSECTIONS ((FILEMAP_VSIZE + SECTION_MASK) >> SECTION_SHIFT)
+#define FILEMAP_L2ENTRIES 256
+
+/* MMU flags for file pages.  The scratch page is only ever accessed by the
+ * page fill logic.
+ */
+
+#define MMU_L2_FILEMAP_RO (PTE_TYPE_SMALL | PTE_WRITE_BACK | PTE_AP_R01)
+#define MMU_L2_FILEMAP_RW (PTE_TYPE_SMALL | PTE_WRITE_BACK | PTE_AP_RW01)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The level 2 page tables of the window.  These are hooked into the level 1
+ * page table when each section is first used.
+ */
+
+static uint32_t g_filemap_l2[FILEMAP_NSECTIONS][FILEMAP_L2ENTRIES]
+  aligned_data(1024);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_filemap_l2table
+ *
+ * Description:
+ *   Return the L2 page table covering a window address, installing the
+ *   level 1 page table entry the first time that the section is used.
+ *
+ ****************************************************************************/
+
+static FAR uint32_t *arm_filemap_l2table(uintptr_t vaddr)
+{
+  FAR uint32_t *l2table;
+  uint32_t l1entry;
+  uintptr_t paddr;
+
+  DEBUGASSERT(vaddr >= CONFIG_FS_FILEMAP_VBASE && vaddr < FILEMAP_VEND);
+
+  l2table = g_filemap_l2[(vaddr - CONFIG_FS_FILEMAP_VBASE) >> SECTION_SHIFT];
+
+  if ((mmu_l1_getentry(vaddr) & PMD_TYPE_MASK) != PMD_TYPE_PTE)
+    {
+      /* The L2 tables are in .bss which is section mapped.  Get their
+       * physical address from the level 1 entry mapping them.
+       */
+
+      l1entry = mmu_l1_getentry((uint32_t)l2table);
+      DEBUGASSERT((l1entry & PMD_TYPE_MASK) == PMD_TYPE_SECT);
+
+      paddr = (l1entry & PMD_SECT_PADDR_MASK) |
+              ((uintptr_t)l2table & SECTION_MASK);
+
+      up_clean_dcache((uintptr_t)l2table,
+                      (uintptr_t)l2table +
+                      FILEMAP_L2ENTRIES * sizeof(uint32_t));
+
+      mmu_l1_setentry(paddr, vaddr & ~SECTION_MASK, MMU_L1_TEXTFLAGS);
+    }
+
+  return l2table;
+}
+
+/****************************************************************************
+ * Name: arm_filemap_fault
+ *
+ * Description:
+ *   This is the page fill trampoline.  arm_filemap_redirect() forced the
+ *   faulting thread to branch here with interrupts disabled.  The page is
+ *   filled with interrupts enabled and then the faulting context is
+ *   restored so that the faulting instruction is executed again.
+ *
+ ****************************************************************************/
+
+static void arm_filemap_fault(void)
+{
+  struct tcb_s *rtcb = this_task();
+  uint32_t regs[XCPTCONTEXT_REGS];
+  uintptr_t far = rtcb->xcp.far;
+  int ret;
+
+  /* Save the return state on the stack. */
+
+  up_copyfullstate(regs, rtcb->xcp.regs);
+
+#ifndef CONFIG_SUPPRESS_INTERRUPTS
+  up_irq_enable();
+#endif
+
+  ret = filemap_fault(far);
+  if (ret < 0)
+    {
+      _alert("Data abort. PC: %08x DFAR: %08x ERROR: %d\n",
+             regs[REG_PC], far, ret);
+      PANIC();
+    }
+
+  /* Disable interrupts and resume at the faulting instruction */
+
+  (void)up_irq_save();
+  up_fullcontextrestore(regs);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_filemap_redirect
+ *
+ * Description:
+ *   Called from the data abort handler when a translation fault occurs in
+ *   the file mapping window.  The interrupted context is saved in the TCB
+ *   and the return state is modified so that the faulting thread resumes
+ *   in arm_filemap_fault() where the page may be filled with interrupts
+ *   enabled.
+ *
+ * Input Parameters:
+ *   regs - The register save area of the faulting context
+ *   far  - The faulting virtual address
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arm_filemap_redirect(uint32_t *regs, uint32_t far)
+{
+  struct tcb_s *tcb = this_task();
+
+  tcb->xcp.far = far;
+  up_copyfullstate(tcb->xcp.regs, regs);
+
+  /* Then set up to vector to the trampoline with interrupts disabled */
+
+  regs[REG_PC]    = (uint32_t)arm_filemap_fault;
+  regs[REG_CPSR]  = (PSR_MODE_SVC | PSR_I_BIT | PSR_F_BIT);
+#ifdef CONFIG_ARM_THUMB
+  regs[REG_CPSR] |= PSR_T_BIT;
+#endif
+}
+
+/****************************************************************************
+ * Name: up_filemap_map
+ *
+ * Description:
+ *   Map one physical page at an address in the file mapping window.
+ *
+ * Input Parameters:
+ *   vaddr    - The page aligned virtual address in the window
+ *   paddr    - The physical address of the page
+ *   writable - True if the page is to be mapped writable
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_filemap_map(uintptr_t vaddr, uintptr_t paddr, bool writable)
+{
+  FAR uint32_t *l2table;
+  irqstate_t flags;
+  uint32_t mmuflags;
+
+  DEBUGASSERT(MM_ISALIGNED(vaddr) && MM_ISALIGNED(paddr));
+
+  if (vaddr == FILEMAP_SCRATCH_VADDR)
+    {
+      mmuflags = MMU_L2_KDATAFLAGS;
+    }
+  else
+    {
+      mmuflags = writable ? MMU_L2_FILEMAP_RW : MMU_L2_FILEMAP_RO;
+    }
+
+  flags   = enter_critical_section();
+  l2table = arm_filemap_l2table(vaddr);
+  mmu_l2_setentry((uint32_t)l2table, paddr, vaddr, mmuflags);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_filemap_unmap
+ *
+ * Description:
+ *   Remove the mapping of one page from the file mapping window.
+ *
+ * Input Parameters:
+ *   vaddr - The page aligned virtual address in the window
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_filemap_unmap(uintptr_t vaddr)
+{
+  FAR uint32_t *l2table;
+  irqstate_t flags;
+
+  DEBUGASSERT(MM_ISALIGNED(vaddr));
+
+  flags   = enter_critical_section();
+  l2table = arm_filemap_l2table(vaddr);
+  mmu_l2_setentry((uint32_t)l2table, 0, vaddr, 0);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+#endif /* CONFIG_FS_FILEMAP */
@@ -523,6 +523,44 @@ int up_prioritize_irq(int irq, int priority)
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Select the set of CPUs that may service an IRQ.  Bit n of 'cpuset'
+ *   selects CPU n.  Only SPIs may be routed; SGIs and PPIs are always
+ *   private to each CPU.
+ *
+ *   NOTE: This assumes that CPU n is connected to CPU interface n.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_IRQAFFINITY
+int up_affinity_irq(int irq, cpu_set_t cpuset)
+{
+  if (irq >= GIC_IRQ_SPI && irq < NR_IRQS && (cpuset & 0xff) != 0)
+    {
+      uintptr_t regaddr;
+      uint32_t regval;
+
+      /* Write the new CPU targets to the corresponding field in the
+       * distributor Interrupt Processor Targets Register (GIC_ICDIPTR).
+       */
+
+      regaddr  = GIC_ICDIPTR(irq);
+      regval   = getreg32(regaddr);
+      regval  &= ~GIC_ICDIPTR_ID_MASK(irq);
+      regval  |= GIC_ICDIPTR_ID(irq, cpuset & 0xff);
+      putreg32(regval, regaddr);
+
+      arm_gic_dump("Exit up_affinity_irq", false, irq);
+      return OK;
+    }
+
+  return -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Name: arm_gic_irq_trigger
  *
@@ -1,7 +1,7 @@
 /****************************************************************************
  *  arch/arm/src/armv7-a/arm_syscall.c
  *
- *   Copyright (C) 2013-2014, 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2013-2014, 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -429,6 +429,18 @@ uint32_t *arm_syscall(uint32_t *regs)
 
           DEBUGASSERT(cmd >= CONFIG_SYS_RESERVED && cmd < SYS_maxsyscall);
 
+#ifdef CONFIG_LIB_SYSCALL_FASTPATH
+          /* Simple, non-blocking system calls are completed right here.
+           * The return value goes directly into R0.
+           */
+
+          if (syscall_fastpath(cmd, regs[REG_R1], regs[REG_R2],
+                               (FAR uintptr_t *)&regs[REG_R0]))
+            {
+              break;
+            }
+#endif
+
           /* Make sure that there is a no saved SYSCALL return address.  We
            * cannot yet handle nested system calls.
            */
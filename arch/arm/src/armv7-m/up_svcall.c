@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/arm/src/armv7-m/up_svcall.c
  *
- *   Copyright (C) 2009, 2011-2015 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2009, 2011-2015, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -420,6 +420,18 @@ int up_svcall(int irq, FAR void *context, FAR void *arg)
 
           DEBUGASSERT(cmd >= CONFIG_SYS_RESERVED && cmd < SYS_maxsyscall);
 
+#ifdef CONFIG_LIB_SYSCALL_FASTPATH
+          /* Simple, non-blocking system calls are completed right here.
+           * The return value goes directly into R0.
+           */
+
+          if (syscall_fastpath(cmd, regs[REG_R1], regs[REG_R2],
+                               (FAR uintptr_t *)&regs[REG_R0]))
+            {
+              break;
+            }
+#endif
+
           /* Make sure that there is a no saved syscall return address.  We
            * cannot yet handle nested system calls.
            */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/arm/src/common/up_createstack.c
  *
- *   Copyright (C) 2007-2014, 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2014, 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -127,6 +127,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
    stack_size += sizeof(struct tls_info_s);
 
+#ifndef CONFIG_TLS_THREADPTR
    /* The allocated stack size must not exceed the maximum possible for the
     * TLS feature.
     */
@@ -136,6 +137,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
      {
        stack_size = TLS_MAXSTACK;
      }
+#endif
 #endif
 
   /* Is there already a stack allocated of a different size?  Because of
@@ -156,10 +158,11 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
     {
       /* Allocate the stack.  If DEBUG is enabled (but not stack debug),
        * then create a zeroed stack to make stack dumps easier to trace.
-       * If TLS is enabled, then we must allocate aligned stacks.
+       * If TLS is enabled, then we must allocate aligned stacks unless the
+       * TLS information is located through the thread pointer register.
        */
 
-#ifdef CONFIG_TLS
+#if defined(CONFIG_TLS) && !defined(CONFIG_TLS_THREADPTR)
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
@@ -177,7 +180,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
             (uint32_t *)kumm_memalign(TLS_STACK_ALIGN, stack_size);
         }
 
-#else /* CONFIG_TLS */
+#else /* CONFIG_TLS && !CONFIG_TLS_THREADPTR */
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
@@ -192,7 +195,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
           tcb->stack_alloc_ptr = (uint32_t *)kumm_malloc(stack_size);
         }
-#endif /* CONFIG_TLS */
+#endif /* CONFIG_TLS && !CONFIG_TLS_THREADPTR */
 
 #ifdef CONFIG_DEBUG_FEATURES
       /* Was the allocation successful? */
@@ -1,7 +1,7 @@
 /****************************************************************************
  *  arch/arm/src/common/up_interruptcontext.c
  *
- *   Copyright (C) 2007-2009 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -61,3 +61,21 @@ bool up_interrupt_context(void)
 {
   return CURRENT_REGS != NULL;
 }
+
+/****************************************************************************
+ * Name: up_profile_pc
+ *
+ * Description:
+ *   Return the program counter saved in the context of the interrupt that
+ *   is being processed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+uintptr_t up_profile_pc(void)
+{
+  FAR volatile uint32_t *regs = CURRENT_REGS;
+
+  return regs != NULL ? (uintptr_t)regs[REG_PC] : 0;
+}
+#endif
@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <arch/board/board.h>
@@ -299,9 +300,15 @@ int aes_cypher(FAR void *out, FAR const void *in, uint32_t size,
       return -EINVAL;
     }
 
+  /* The hardware only supports 128-bit keys */
+
   if (keysize != 16)
     {
+#ifdef CONFIG_CRYPTO_SW_AES
+      return aes_sw_cypher(out, in, size, iv, key, keysize, mode, encrypt);
+#else
       return -EINVAL;
+#endif
     }
 
   ret = nxsem_wait(&g_stm32aes_lock);
@@ -699,7 +699,12 @@ static void stm32_receive(FAR struct stm32_ethmac_s *priv);
 static void stm32_freeframe(FAR struct stm32_ethmac_s *priv);
 static void stm32_txdone(FAR struct stm32_ethmac_s *priv);
 
+static void stm32_interrupt_process(FAR struct stm32_ethmac_s *priv);
+#ifdef CONFIG_STM32_ETHMAC_IRQTHREAD
+static int  stm32_interrupt_thread(int irq, FAR void *context, FAR void *arg);
+#else
 static void stm32_interrupt_work(FAR void *arg);
+#endif
 static int  stm32_interrupt(int irq, FAR void *context, FAR void *arg);
 
 /* Watchdog timer expirations */
@@ -1990,25 +1995,25 @@ static void stm32_txdone(FAR struct stm32_ethmac_s *priv)
 }
 
 /****************************************************************************
- * Function: stm32_interrupt_work
+ * Function: stm32_interrupt_process
  *
  * Description:
- *   Perform interrupt related work from the worker thread
+ *   Perform interrupt related work from the worker thread or from the
+ *   interrupt thread
  *
  * Input Parameters:
- *   arg - The argument passed when work_queue() was called.
+ *   priv - Reference to the driver state structure
  *
  * Returned Value:
- *   OK on success
+ *   None
  *
  * Assumptions:
  *   Ethernet interrupts are disabled
  *
  ****************************************************************************/
 
-static void stm32_interrupt_work(FAR void *arg)
+static void stm32_interrupt_process(FAR struct stm32_ethmac_s *priv)
 {
-  FAR struct stm32_ethmac_s *priv = (FAR struct stm32_ethmac_s *)arg;
   uint32_t dmasr;
 
   DEBUGASSERT(priv);
@@ -2090,11 +2095,64 @@ static void stm32_interrupt_work(FAR void *arg)
 #endif
 
   net_unlock();
+}
+
+/****************************************************************************
+ * Function: stm32_interrupt_thread
+ *
+ * Description:
+ *   Perform interrupt related work on the interrupt thread.  The Ethernet
+ *   interrupt is re-enabled when this function returns.
+ *
+ * Input Parameters:
+ *   irq     - Number of the IRQ that generated the interrupt
+ *   context - Always NULL
+ *   arg     - The argument passed to irq_attach_thread()
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   Ethernet interrupts are disabled
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32_ETHMAC_IRQTHREAD
+static int stm32_interrupt_thread(int irq, FAR void *context, FAR void *arg)
+{
+  stm32_interrupt_process(&g_stm32ethmac[0]);
+  return OK;
+}
+
+#else
+/****************************************************************************
+ * Function: stm32_interrupt_work
+ *
+ * Description:
+ *   Perform interrupt related work from the worker thread
+ *
+ * Input Parameters:
+ *   arg - The argument passed when work_queue() was called.
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   Ethernet interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void stm32_interrupt_work(FAR void *arg)
+{
+  FAR struct stm32_ethmac_s *priv = (FAR struct stm32_ethmac_s *)arg;
+
+  stm32_interrupt_process(priv);
 
   /* Re-enable Ethernet interrupts at the NVIC */
 
   up_enable_irq(STM32_IRQ_ETH);
 }
+#endif
 
 /****************************************************************************
  * Function: stm32_interrupt
@@ -2123,12 +2181,14 @@ static int stm32_interrupt(int irq, FAR void *context, FAR void *arg)
   dmasr = stm32_getreg(STM32_ETH_DMASR);
   if (dmasr != 0)
     {
+#ifndef CONFIG_STM32_ETHMAC_IRQTHREAD
       /* Disable further Ethernet interrupts.  Because Ethernet interrupts
        * are also disabled if the TX timeout event occurs, there can be no
        * race condition here.
        */
 
       up_disable_irq(STM32_IRQ_ETH);
+#endif
 
       /* Check if a packet transmission just completed. */
 
@@ -2142,9 +2202,17 @@ static int stm32_interrupt(int irq, FAR void *context, FAR void *arg)
            wd_cancel(priv->txtimeout);
         }
 
+#ifdef CONFIG_STM32_ETHMAC_IRQTHREAD
+      /* Perform the interrupt processing on the interrupt thread.  The
+       * interrupt is disabled until then.
+       */
+
+      return IRQ_WAKE_THREAD;
+#else
       /* Schedule to perform the interrupt processing on the worker thread. */
 
       work_queue(ETHWORK, &priv->irqwork, stm32_interrupt_work, priv, 0);
+#endif
     }
 
   return OK;
@@ -4065,7 +4133,13 @@ int stm32_ethinitialize(int intf)
 
   /* Attach the IRQ to the driver */
 
+#ifdef CONFIG_STM32_ETHMAC_IRQTHREAD
+  if (irq_attach_thread(STM32_IRQ_ETH, stm32_interrupt,
+                        stm32_interrupt_thread, NULL,
+                        CONFIG_STM32_ETHMAC_IRQTHREAD_PRIORITY, 0) < 0)
+#else
   if (irq_attach(STM32_IRQ_ETH, stm32_interrupt, NULL))
+#endif
     {
       /* We could not attach the ISR to the interrupt */
 
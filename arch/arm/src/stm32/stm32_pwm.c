@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/arm/src/stm32/stm32_pwm.c
  *
- *   Copyright (C) 2011-2012, 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011-2012, 2016, 2020 Gregory Nutt. All rights reserved.
  *   Copyright (C) 2015 Omni Hoverboards Inc. All rights reserved.
  *   Authors: Gregory Nutt <gnutt@nuttx.org>
  *            Paul Alexander Patience <paul-a.patience@polymtl.ca>
@@ -44,11 +44,13 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <arch/board/board.h>
 
 #include "up_internal.h"
@@ -310,6 +312,70 @@
 #  endif
 #endif
 
+/* Waveform support.  The update DMA request of the timer drives a DMA
+ * burst to consecutive CCR registers through the DMAR register.  Only
+ * TIM1-5 and TIM8 have the DMA burst registers.  The board.h file must
+ * select the DMA mapping if the chip provides more than one.
+ */
+
+#if defined(CONFIG_STM32_PWM_WAVEFORM) && defined(CONFIG_PWM_WAVEFORM)
+#  ifdef HAVE_IP_DMA_V1
+#    if defined(CONFIG_STM32_TIM1_PWM) && defined(DMACHAN_TIM1_UP)
+#      define PWM_TIM1_DMAMAP DMACHAN_TIM1_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM2_PWM) && defined(DMACHAN_TIM2_UP)
+#      define PWM_TIM2_DMAMAP DMACHAN_TIM2_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM3_PWM) && defined(DMACHAN_TIM3_UP)
+#      define PWM_TIM3_DMAMAP DMACHAN_TIM3_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM4_PWM) && defined(DMACHAN_TIM4_UP)
+#      define PWM_TIM4_DMAMAP DMACHAN_TIM4_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM5_PWM) && defined(DMACHAN_TIM5_UP)
+#      define PWM_TIM5_DMAMAP DMACHAN_TIM5_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM8_PWM) && defined(DMACHAN_TIM8_UP)
+#      define PWM_TIM8_DMAMAP DMACHAN_TIM8_UP
+#    endif
+#    define PWM_DMA_CONTROL_WORD (DMA_CCR_MSIZE_32BITS | \
+                                  DMA_CCR_PSIZE_32BITS | \
+                                  DMA_CCR_MINC | \
+                                  DMA_CCR_DIR | \
+                                  DMA_CCR_PRIHI)
+#    define PWM_DMA_CIRC         DMA_CCR_CIRC
+#  else
+#    if defined(CONFIG_STM32_TIM1_PWM) && defined(DMAMAP_TIM1_UP)
+#      define PWM_TIM1_DMAMAP DMAMAP_TIM1_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM2_PWM) && defined(DMAMAP_TIM2_UP)
+#      define PWM_TIM2_DMAMAP DMAMAP_TIM2_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM3_PWM) && defined(DMAMAP_TIM3_UP)
+#      define PWM_TIM3_DMAMAP DMAMAP_TIM3_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM4_PWM) && defined(DMAMAP_TIM4_UP)
+#      define PWM_TIM4_DMAMAP DMAMAP_TIM4_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM5_PWM) && defined(DMAMAP_TIM5_UP)
+#      define PWM_TIM5_DMAMAP DMAMAP_TIM5_UP
+#    endif
+#    if defined(CONFIG_STM32_TIM8_PWM) && defined(DMAMAP_TIM8_UP)
+#      define PWM_TIM8_DMAMAP DMAMAP_TIM8_UP
+#    endif
+#    define PWM_DMA_CONTROL_WORD (DMA_SCR_MSIZE_32BITS | \
+                                  DMA_SCR_PSIZE_32BITS | \
+                                  DMA_SCR_MINC | \
+                                  DMA_SCR_DIR_M2P | \
+                                  DMA_SCR_PRIHI)
+#    define PWM_DMA_CIRC         DMA_SCR_CIRC
+#  endif
+#  ifdef CONFIG_PWM_PULSECOUNT
+#    error "STM32_PWM_WAVEFORM does not support PWM_PULSECOUNT"
+#  endif
+#  define HAVE_PWM_DMA
+#endif
+
 /* Synchronisation support */
 
 #ifdef CONFIG_STM32_PWM_TRGO
@@ -418,6 +484,11 @@ struct stm32_pwmtimer_s
 #ifdef CONFIG_PWM_PULSECOUNT
   FAR void *handle;                     /* Handle used for upper-half callback */
 #endif
+#ifdef HAVE_PWM_DMA
+  DMA_HANDLE dma;                       /* DMA channel of a playing waveform */
+  FAR uint32_t *dmabuf;                 /* CCR values of the waveform */
+  FAR void *wavehandle;                 /* Handle for the waveform callback */
+#endif
 };
 
 /****************************************************************************
@@ -513,6 +584,15 @@ static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
 static int pwm_stop(FAR struct pwm_lowerhalf_s *dev);
 static int pwm_ioctl(FAR struct pwm_lowerhalf_s *dev,
                      int cmd, unsigned long arg);
+#ifdef HAVE_PWM_DMA
+static int pwm_dmamap(FAR struct stm32_pwmtimer_s *priv, FAR uint32_t *map);
+static void pwm_dma_stop(FAR struct stm32_pwmtimer_s *priv);
+static void pwm_dma_callback(DMA_HANDLE handle, uint8_t status,
+                             FAR void *arg);
+static int pwm_waveform(FAR struct pwm_lowerhalf_s *dev,
+                        FAR const struct pwm_waveform_s *wave,
+                        FAR void *handle);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -529,6 +609,9 @@ static const struct pwm_ops_s g_pwmops =
   .start       = pwm_start,
   .stop        = pwm_stop,
   .ioctl       = pwm_ioctl,
+#ifdef HAVE_PWM_DMA
+  .waveform    = pwm_waveform,
+#endif
 };
 
 #ifdef CONFIG_STM32_PWM_LL_OPS
@@ -3576,7 +3659,9 @@ errout:
  * Name: pwm_duty_channels_update
  *
  * Description:
- *   Update duty cycle for given channels
+ *   Update duty cycle for given channels.  The CCR registers are preloaded.
+ *   Update events are disabled while they are written so that the new duty
+ *   cycles of all channels take effect at the same period boundary.
  *
  ****************************************************************************/
 
@@ -3592,6 +3677,8 @@ static int pwm_duty_channels_update(FAR struct pwm_lowerhalf_s *dev,
   int       j       = 0;
 #endif
 
+  pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, 0, GTIM_CR1_UDIS);
+
 #ifdef CONFIG_PWM_MULTICHAN
   for (i = 0; i < CONFIG_PWM_NCHANNELS; i++)
 #endif
@@ -3640,7 +3727,8 @@ static int pwm_duty_channels_update(FAR struct pwm_lowerhalf_s *dev,
     }
 
 errout:
-  return OK;
+  pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, GTIM_CR1_UDIS, 0);
+  return ret;
 }
 
 /****************************************************************************
@@ -4302,26 +4390,19 @@ static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
   FAR struct stm32_pwmtimer_s *priv = (FAR struct stm32_pwmtimer_s *)dev;
   int ret = OK;
 
+#ifdef HAVE_PWM_DMA
+  /* Stop any waveform */
+
+  pwm_dma_stop(priv);
+#endif
+
   /* if frequency has not changed we just update duty */
 
   if (info->frequency == priv->frequency)
     {
-#ifdef CONFIG_PWM_MULTICHAN
-      int i;
+      /* Update all channels at the same period boundary */
 
-      for (i = 0; ret == OK && i < CONFIG_PWM_NCHANNELS; i++)
-        {
-          /* Set output if channel configured */
-
-          if (info->channels[i].channel != 0)
-            {
-              ret = pwm_duty_update(dev, info->channels[i].channel,
-                                    info->channels[i].duty);
-            }
-        }
-#else
-      ret = pwm_duty_update(dev, priv->channels[0].channel, info->duty);
-#endif  /* CONFIG_PWM_MULTICHAN */
+      ret = pwm_duty_channels_update(dev, info);
     }
   else
     {
@@ -4369,6 +4450,12 @@ static int pwm_stop(FAR struct pwm_lowerhalf_s *dev)
 
   pwminfo("TIM%u\n", priv->timid);
 
+#ifdef HAVE_PWM_DMA
+  /* Stop any waveform */
+
+  pwm_dma_stop(priv);
+#endif
+
   /* Determine which timer to reset */
 
   switch (priv->timid)
@@ -4551,6 +4638,272 @@ errout:
   return ret;
 }
 
+#ifdef HAVE_PWM_DMA
+
+/****************************************************************************
+ * Name: pwm_dmamap
+ *
+ * Description:
+ *   Get the DMA mapping of the update DMA request of the timer
+ *
+ ****************************************************************************/
+
+static int pwm_dmamap(FAR struct stm32_pwmtimer_s *priv, FAR uint32_t *map)
+{
+  switch (priv->timid)
+    {
+#ifdef PWM_TIM1_DMAMAP
+      case 1:
+        {
+          *map = PWM_TIM1_DMAMAP;
+          break;
+        }
+#endif
+
+#ifdef PWM_TIM2_DMAMAP
+      case 2:
+        {
+          *map = PWM_TIM2_DMAMAP;
+          break;
+        }
+#endif
+
+#ifdef PWM_TIM3_DMAMAP
+      case 3:
+        {
+          *map = PWM_TIM3_DMAMAP;
+          break;
+        }
+#endif
+
+#ifdef PWM_TIM4_DMAMAP
+      case 4:
+        {
+          *map = PWM_TIM4_DMAMAP;
+          break;
+        }
+#endif
+
+#ifdef PWM_TIM5_DMAMAP
+      case 5:
+        {
+          *map = PWM_TIM5_DMAMAP;
+          break;
+        }
+#endif
+
+#ifdef PWM_TIM8_DMAMAP
+      case 8:
+        {
+          *map = PWM_TIM8_DMAMAP;
+          break;
+        }
+#endif
+
+      default:
+        pwmerr("ERROR: TIM%u has no update DMA\n", priv->timid);
+        return -ENOTTY;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pwm_dma_stop
+ *
+ * Description:
+ *   Stop the waveform DMA, if any, and free its resources.  The CCR
+ *   registers keep the last sample.
+ *
+ ****************************************************************************/
+
+static void pwm_dma_stop(FAR struct stm32_pwmtimer_s *priv)
+{
+  if (priv->dma != NULL)
+    {
+      pwm_modifyreg(priv, STM32_GTIM_DIER_OFFSET, GTIM_DIER_UDE, 0);
+      pwm_putreg(priv, STM32_GTIM_DCR_OFFSET, 0);
+
+      stm32_dmastop(priv->dma);
+      stm32_dmafree(priv->dma);
+      priv->dma = NULL;
+    }
+
+  if (priv->dmabuf != NULL)
+    {
+      kmm_free(priv->dmabuf);
+      priv->dmabuf = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: pwm_dma_callback
+ *
+ * Description:
+ *   The DMA of a waveform that does not loop has completed (or failed).
+ *   Stop the DMA requests, leaving the last sample in the CCR registers,
+ *   and notify the upper half.
+ *
+ ****************************************************************************/
+
+static void pwm_dma_callback(DMA_HANDLE handle, uint8_t status,
+                             FAR void *arg)
+{
+  FAR struct stm32_pwmtimer_s *priv = (FAR struct stm32_pwmtimer_s *)arg;
+
+  if ((status & DMA_STATUS_TEIF) != 0)
+    {
+      pwmerr("ERROR: TIM%u waveform DMA failed: %02x\n",
+             priv->timid, status);
+    }
+
+  pwm_modifyreg(priv, STM32_GTIM_DIER_OFFSET, GTIM_DIER_UDE, 0);
+  pwm_waveform_done(priv->wavehandle);
+}
+
+/****************************************************************************
+ * Name: pwm_waveform
+ *
+ * Description:
+ *   Start playing a waveform.  The duty table is converted to CCR values
+ *   once.  Each update event of the timer then requests a DMA burst that
+ *   writes the next sample to the (preloaded) CCR registers of its
+ *   channels, so that all channels of the sample take effect at the
+ *   following period boundary.
+ *
+ *   The timer is (re)started with the first sample, so the first sample
+ *   is output for up to two periods.
+ *
+ * Input Parameters:
+ *   dev    - A reference to the lower half PWM driver state structure
+ *   wave   - The waveform
+ *   handle - The handle for pwm_waveform_done()
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+static int pwm_waveform(FAR struct pwm_lowerhalf_s *dev,
+                        FAR const struct pwm_waveform_s *wave,
+                        FAR void *handle)
+{
+  FAR struct stm32_pwmtimer_s *priv = (FAR struct stm32_pwmtimer_s *)dev;
+  struct pwm_info_s info;
+  uint32_t dmamap;
+  uint32_t reload;
+  uint32_t scr;
+  size_t nvalues;
+  size_t i;
+  int ret;
+#ifdef CONFIG_PWM_MULTICHAN
+  int j;
+#endif
+
+  ret = pwm_dmamap(priv, &dmamap);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The channels of a sample are consecutive CCR registers */
+
+#ifdef CONFIG_PWM_MULTICHAN
+  if (wave->channel < 1 || wave->nchannels > CONFIG_PWM_NCHANNELS ||
+      wave->channel + wave->nchannels - 1 > 4)
+#else
+  if (wave->channel != priv->channels[0].channel || wave->nchannels != 1)
+#endif
+    {
+      return -EINVAL;
+    }
+
+  /* Stop any previous waveform */
+
+  pwm_dma_stop(priv);
+
+  nvalues      = (size_t)wave->nsamples * wave->nchannels;
+  priv->dmabuf = (FAR uint32_t *)kmm_malloc(nvalues * sizeof(uint32_t));
+  if (priv->dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* (Re)start the timer with the first sample.  This sets the frequency
+   * and verifies the channels.
+   */
+
+  memset(&info, 0, sizeof(struct pwm_info_s));
+  info.frequency = wave->frequency;
+
+#ifdef CONFIG_PWM_MULTICHAN
+  for (j = 0; j < wave->nchannels; j++)
+    {
+      info.channels[j].channel = wave->channel + j;
+      info.channels[j].duty    = wave->duty[j];
+    }
+#else
+  info.duty = wave->duty[0];
+#endif
+
+  ret = pwm_timer(dev, &info);
+  if (ret < 0)
+    {
+      goto errout_with_buf;
+    }
+
+  priv->frequency = info.frequency;
+
+  /* Convert the duty values to CCR values, as pwm_duty_update() does */
+
+  reload = pwm_arr_get(dev);
+  for (i = 0; i < nvalues; i++)
+    {
+      priv->dmabuf[i] = b16toi(wave->duty[i] * reload + b16HALF);
+    }
+
+  priv->dma = stm32_dmachannel(dmamap);
+  if (priv->dma == NULL)
+    {
+      ret = -EBUSY;
+      goto errout_with_buf;
+    }
+
+  /* Each update DMA request is served by a burst of 'nchannels' transfers
+   * through DMAR to consecutive CCR registers, starting at the CCR of the
+   * first channel.
+   */
+
+  pwm_putreg(priv, STM32_GTIM_DCR_OFFSET,
+             (((STM32_GTIM_CCR1_OFFSET >> 2) + wave->channel - 1) <<
+              GTIM_DCR_DBA_SHIFT) |
+             ((wave->nchannels - 1) << GTIM_DCR_DBL_SHIFT));
+
+  scr = PWM_DMA_CONTROL_WORD;
+  if (wave->loop)
+    {
+      scr |= PWM_DMA_CIRC;
+    }
+
+  priv->wavehandle = handle;
+  stm32_dmasetup(priv->dma, priv->base + STM32_GTIM_DMAR_OFFSET,
+                 (uint32_t)priv->dmabuf, nvalues, scr);
+
+  /* A looping waveform never completes */
+
+  stm32_dmastart(priv->dma, wave->loop ? NULL : pwm_dma_callback, priv,
+                 false);
+
+  pwm_modifyreg(priv, STM32_GTIM_DIER_OFFSET, 0, GTIM_DIER_UDE);
+  return OK;
+
+errout_with_buf:
+  kmm_free(priv->dmabuf);
+  priv->dmabuf = NULL;
+  return ret;
+}
+#endif /* HAVE_PWM_DMA */
+
 /****************************************************************************
  * Name: pwm_ioctl
  *
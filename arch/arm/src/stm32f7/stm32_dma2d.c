@@ -48,10 +48,12 @@
 #include <debug.h>
 #include <semaphore.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/nx/nxglib.h>
 
 #include <arch/board/board.h>
 
@@ -59,7 +61,7 @@
 #include "up_internal.h"
 #include "hardware/stm32_ltdc.h"
 #include "hardware/stm32_dma2d.h"
-#include "hardware/stm32_dtcm.h"
+#include "stm32_dtcm.h"
 #include "stm32_dma2d.h"
 #include "stm32_ltdc.h"
 #include "stm32_gpio.h"
@@ -239,6 +241,19 @@ static int stm32_dma2d_blend(FAR struct stm32_dma2d_overlay_s *doverlay,
                              uint32_t forexpos, uint32_t foreypos,
                              FAR struct stm32_dma2d_overlay_s *boverlay,
                              FAR const struct fb_area_s *barea);
+#ifdef CONFIG_NX_ACCEL
+static int stm32_dma2d_nxoverlay(FAR struct stm32_dma2d_overlay_s *overlay,
+                                 FAR struct fb_overlayinfo_s *oinfo,
+                                 FAR const void *mem, unsigned int stride,
+                                 uint8_t bpp);
+static int stm32_dma2d_nxfill(FAR void *dest, unsigned int stride,
+                              uint8_t bpp, unsigned int width,
+                              unsigned int height, uint32_t color);
+static int stm32_dma2d_nxcopy(FAR void *dest, unsigned int deststride,
+                              FAR const void *src, unsigned int srcstride,
+                              uint8_t bpp, unsigned int width,
+                              unsigned int height);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -294,6 +309,16 @@ static struct stm32_dma2d_s g_dma2ddev =
   .lock = &g_lock
 };
 
+#ifdef CONFIG_NX_ACCEL
+/* The raster operations performed on behalf of nxglib */
+
+static const struct nxgl_accel_s g_nxaccel =
+{
+  .fill = stm32_dma2d_nxfill,
+  .copy = stm32_dma2d_nxcopy
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -1074,6 +1099,187 @@ static int stm32_dma2d_blend(FAR struct stm32_dma2d_overlay_s *doverlay,
   return ret;
 }
 
+/****************************************************************************
+ * Name: stm32_dma2d_nxoverlay
+ *
+ * Description:
+ *   Describe a region of memory addressed by nxglib as a DMA2D overlay.
+ *   The region starts at the overlay origin.
+ *
+ * Input Parameters:
+ *   overlay - The overlay to initialize
+ *   oinfo   - The overlay information referenced by the overlay
+ *   mem     - The first pixel of the region
+ *   stride  - The length of a row in bytes
+ *   bpp     - Bits per pixel
+ *
+ * Returned Value:
+ *   OK      - On success
+ *   -ENOSYS - The DMA2D does not support the pixel format
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+static int stm32_dma2d_nxoverlay(FAR struct stm32_dma2d_overlay_s *overlay,
+                                 FAR struct fb_overlayinfo_s *oinfo,
+                                 FAR const void *mem, unsigned int stride,
+                                 uint8_t bpp)
+{
+  /* nxglib colors carry no alpha, these are the formats the LTDC shows */
+
+  switch (bpp)
+    {
+#ifdef CONFIG_STM32F7_DMA2D_RGB565
+      case 16:
+        overlay->fmt = DMA2D_PF_RGB565;
+        break;
+#endif
+#ifdef CONFIG_STM32F7_DMA2D_RGB888
+      case 24:
+        overlay->fmt = DMA2D_PF_RGB888;
+        break;
+#endif
+#ifdef CONFIG_STM32F7_DMA2D_ARGB8888
+      case 32:
+        overlay->fmt = DMA2D_PF_ARGB8888;
+        break;
+#endif
+      default:
+        return -ENOSYS;
+    }
+
+  /* The line offset is programmed in pixels */
+
+  if (stride % DMA2D_PF_BYPP(bpp) != 0)
+    {
+      return -ENOSYS;
+    }
+
+  memset(oinfo, 0, sizeof(struct fb_overlayinfo_s));
+  oinfo->fbmem         = (FAR void *)mem;
+  oinfo->stride        = stride;
+  oinfo->bpp           = bpp;
+
+  overlay->transp_mode = 0;
+  overlay->xres        = stride / DMA2D_PF_BYPP(bpp);
+  overlay->yres        = 0;
+  overlay->oinfo       = oinfo;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_nxfill
+ *
+ * Description:
+ *   Fill a region of framebuffer memory on behalf of nxglib.  Small
+ *   regions are left to the CPU which fills them faster than the DMA2D can
+ *   be set up.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_nxfill(FAR void *dest, unsigned int stride,
+                              uint8_t bpp, unsigned int width,
+                              unsigned int height, uint32_t color)
+{
+  struct stm32_dma2d_overlay_s doverlay;
+  struct fb_overlayinfo_s doinfo;
+  struct fb_area_s area;
+  uintptr_t start;
+  uintptr_t end;
+  int ret;
+
+  if (width * height < CONFIG_STM32F7_DMA2D_NX_MINPIXELS)
+    {
+      return -ENOSYS;
+    }
+
+  ret = stm32_dma2d_nxoverlay(&doverlay, &doinfo, dest, stride, bpp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  area.x = 0;
+  area.y = 0;
+  area.w = width;
+  area.h = height;
+
+  /* The DMA2D writes the memory behind the D-Cache.  Write back any dirty
+   * lines first so that they cannot overwrite the new pixels later, then
+   * discard the stale lines when the transfer has completed.
+   */
+
+  start = (uintptr_t)dest;
+  end   = start + (height - 1) * stride + width * DMA2D_PF_BYPP(bpp);
+
+  up_clean_dcache(start, end);
+  ret = stm32_dma2d_fillcolor(&doverlay, &area, color);
+  up_invalidate_dcache(start, end);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_nxcopy
+ *
+ * Description:
+ *   Copy a region into framebuffer memory on behalf of nxglib.  The DMA2D
+ *   copies from the top down, as it is required by nxglib for moves
+ *   within the framebuffer.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_nxcopy(FAR void *dest, unsigned int deststride,
+                              FAR const void *src, unsigned int srcstride,
+                              uint8_t bpp, unsigned int width,
+                              unsigned int height)
+{
+  struct stm32_dma2d_overlay_s doverlay;
+  struct stm32_dma2d_overlay_s soverlay;
+  struct fb_overlayinfo_s doinfo;
+  struct fb_overlayinfo_s soinfo;
+  struct fb_area_s area;
+  uintptr_t start;
+  uintptr_t end;
+  int ret;
+
+  if (width * height < CONFIG_STM32F7_DMA2D_NX_MINPIXELS)
+    {
+      return -ENOSYS;
+    }
+
+  ret = stm32_dma2d_nxoverlay(&doverlay, &doinfo, dest, deststride, bpp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = stm32_dma2d_nxoverlay(&soverlay, &soinfo, src, srcstride, bpp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  area.x = 0;
+  area.y = 0;
+  area.w = width;
+  area.h = height;
+
+  /* The source must be in memory before the DMA2D reads it */
+
+  start = (uintptr_t)src;
+  end   = start + (height - 1) * srcstride + width * DMA2D_PF_BYPP(bpp);
+  up_clean_dcache(start, end);
+
+  start = (uintptr_t)dest;
+  end   = start + (height - 1) * deststride + width * DMA2D_PF_BYPP(bpp);
+  up_clean_dcache(start, end);
+
+  ret = stm32_dma2d_blit(&doverlay, 0, 0, &soverlay, &area);
+  up_invalidate_dcache(start, end);
+  return ret;
+}
+#endif /* CONFIG_NX_ACCEL */
+
 /****************************************************************************
  * Name: stm32_dma2dinitialize
  *
@@ -1137,6 +1343,12 @@ int stm32_dma2dinitialize(void)
 
       up_enable_irq(g_interrupt.irq);
 
+#ifdef CONFIG_NX_ACCEL
+      /* Accelerate the nxglib raster operations */
+
+      nxgl_accel_register(&g_nxaccel);
+#endif
+
       g_initialized = true;
     }
 
@@ -1153,6 +1365,12 @@ int stm32_dma2dinitialize(void)
 
 void stm32_dma2duninitialize(void)
 {
+#ifdef CONFIG_NX_ACCEL
+  /* Stop accelerating the nxglib raster operations */
+
+  nxgl_accel_register(NULL);
+#endif
+
   /* Disable DMA2D interrupts */
 
   up_disable_irq(g_interrupt.irq);
@@ -58,7 +58,8 @@
  * Private Function Prototypes
  ****************************************************************************/
 
-static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack);
+static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack,
+                            FAR uintptr_t *hwm);
 
 /****************************************************************************
  * Name: do_stackcheck
@@ -77,7 +78,8 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack);
  *
  ****************************************************************************/
 
-static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
+static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack,
+                            FAR uintptr_t *hwm)
 {
   FAR uintptr_t start;
   FAR uintptr_t end;
@@ -113,6 +115,40 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
 
   size  = end - start;
 
+#if CONFIG_STACK_COLORATION_GAP > 0
+  /* If a high-water mark was found before, then the stack below it was
+   * still painted at that time.  Only scan down from the old mark through
+   * the words used since, until CONFIG_STACK_COLORATION_GAP consecutive
+   * painted words are found.
+   */
+
+  if (hwm != NULL && *hwm >= start && *hwm < end)
+    {
+      FAR uint32_t *last = (FAR uint32_t *)*hwm;
+      size_t nwords = (*hwm - start) >> 2;
+      int gap = 0;
+
+      for (ptr = last; nwords > 0 && gap < CONFIG_STACK_COLORATION_GAP;
+           nwords--)
+        {
+          if (*--ptr == STACK_COLOR)
+            {
+              gap++;
+            }
+          else
+            {
+              last = ptr;
+              gap  = 0;
+            }
+        }
+
+      *hwm = (uintptr_t)last;
+      return end - (uintptr_t)last;
+    }
+#else
+  UNUSED(hwm);
+#endif
+
   /* The SIM uses a push-down stack:  the stack grows toward lower addresses
    * in memory.  We need to start at the lowest address in the stack memory
    * allocation and search to higher addresses.  The first word we encounter
@@ -162,6 +198,15 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
     }
 #endif
 
+#if CONFIG_STACK_COLORATION_GAP > 0
+  /* Remember the lowest used word for the next check */
+
+  if (hwm != NULL && mark > 0)
+    {
+      *hwm = end - (mark << 2);
+    }
+#endif
+
   /* Return our guess about how much stack space was used */
 
   return mark << 2;
@@ -189,8 +234,13 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
 
 size_t up_check_tcbstack(FAR struct tcb_s *tcb)
 {
+#if CONFIG_STACK_COLORATION_GAP > 0
   return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size,
-                       false);
+                       false, &tcb->stack_hwm);
+#else
+  return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size,
+                       false, NULL);
+#endif
 }
 
 ssize_t up_check_tcbstack_remain(FAR struct tcb_s *tcb)
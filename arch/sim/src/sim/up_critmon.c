@@ -1,7 +1,7 @@
 /************************************************************************************
  * arch/sim/src/sim/up_critmon.c
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -47,6 +47,14 @@
 #undef USE_CLOCK                                   /* Too slow */
 #define USE_CLOCK_GETTIME 1                        /* Better */
 
+/* The host thread CPU time only advances while the simulated CPU runs */
+
+#ifdef CONFIG_SIM_THREAD_CPUTIME
+#  define CRITMON_CLOCK CLOCK_THREAD_CPUTIME_ID
+#else
+#  define CRITMON_CLOCK CLOCK_MONOTONIC
+#endif
+
 /* From nuttx/clock.h */
  
 #define NSEC_PER_SEC  1000000000
@@ -87,8 +95,13 @@ uint32_t up_critmon_gettime(void)
 uint32_t up_critmon_gettime(void)
 {
   struct timespec ts;
-  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
-  return (uint32_t)ts.tv_nsec;
+  (void)clock_gettime(CRITMON_CLOCK, &ts);
+
+  /* Return the time in nanoseconds modulo 2**32 so that the elapsed time
+   * is still valid when the seconds field increments.
+   */
+
+  return (uint32_t)((uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
 }
 #endif
 
@@ -108,7 +121,7 @@ void up_critmon_convert(uint32_t elapsed, struct timespec *ts)
 #else /* USE_CLOCK_GETTIME */
 void up_critmon_convert(uint32_t elapsed, struct timespec *ts)
 {
-  ts->tv_sec  = 0;
-  ts->tv_nsec = elapsed;
+  ts->tv_sec  = elapsed / NSEC_PER_SEC;
+  ts->tv_nsec = elapsed % NSEC_PER_SEC;
 }
 #endif
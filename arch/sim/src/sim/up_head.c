@@ -1,8 +1,8 @@
 /****************************************************************************
  * arch/sim/src/sim/up_head.c
  *
- *   Copyright (C) 2007-2009, 2011-2013, 2016 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2007-2009, 2011-2013, 2016, 2020 Gregory Nutt. All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -166,6 +166,13 @@ void up_assert(const uint8_t *filename, int line)
 #ifdef CONFIG_BOARDCTL_POWEROFF
 int board_power_off(int status)
 {
+#if defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) && \
+   !defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER)
+  /* Report the spinlock contention of the simulated CPUs */
+
+  sim_spinstat_report();
+#endif
+
   /* Save the return code and exit the simulation */
 
   g_exitcode = status;
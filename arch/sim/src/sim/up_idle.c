@@ -168,6 +168,12 @@ void up_idle(void)
             pwrinfo("IDLE: switching to new state %i\n", state);
           }
       }
+
+#ifdef CONFIG_SMP
+    /* Report the state of this CPU to the scheduler */
+
+    pm_cpu_setstate(up_cpu_index(), state);
+#endif
   }
 #endif
 
@@ -1,8 +1,8 @@
 /****************************************************************************
  * arch/sim/src/up_internal.h
  *
- *   Copyright (C) 2007, 2009, 2011-2012, 2014, 2016-2017 Gregory Nutt.
- *     All rights reserved.
+ *   Copyright (C) 2007, 2009, 2011-2012, 2014, 2016-2017, 2020 Gregory
+ *     Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -260,6 +260,13 @@ void sim_cpu_pause(int cpu, FAR volatile spinlock_t *wait,
 void sim_smp_hook(void);
 #endif
 
+/* up_schednote.c *********************************************************/
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) && \
+   !defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER)
+void sim_spinstat_report(void);
+#endif
+
 /* up_tickless.c **********************************************************/
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/sim/src/sim/up_interruptcontext.c
  *
- *   Copyright (C) 2007-2009 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -41,6 +41,8 @@
 
 #include <stdbool.h>
 #include <nuttx/arch.h>
+
+#include "sched/sched.h"
 #include "up_internal.h"
 
 /****************************************************************************
@@ -62,3 +64,20 @@ bool up_interrupt_context(void)
   return false;
 }
 
+/****************************************************************************
+ * Name: up_profile_pc
+ *
+ * Description:
+ *   The simulation has no timer interrupt:  The timer is processed by the
+ *   IDLE loop.  Return the program counter saved by the running thread at
+ *   its last context switch instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+uintptr_t up_profile_pc(void)
+{
+  return (uintptr_t)this_task()->xcp.regs[JB_PC];
+}
+#endif
+
@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/sim/src/sim/up_schednote.c
  *
- *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -38,13 +38,84 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <syslog.h>
+#include <time.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/sched.h>
 
+#include "up_internal.h"
+
 #if defined(CONFIG_SCHED_INSTRUMENTATION) && \
    !defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SIM_NCPUS   CONFIG_SMP_NCPUS
+#  define SIM_THISCPU up_cpu_index()
+#else
+#  define SIM_NCPUS   1
+#  define SIM_THISCPU 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Spinlock contention seen by one simulated CPU.  The times are in the
+ * units of up_critmon_gettime().  Each CPU only updates its own entry,
+ * with interrupts disabled, so no lock is needed.
+ */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+struct sim_spinstat_s
+{
+  uint32_t nlocks;     /* Number of spinlocks taken */
+  uint32_t naborts;    /* Number of waits that were given up */
+  uint32_t start;      /* Time that the current wait started */
+  uint32_t maxwait;    /* Longest wait */
+  uint64_t totalwait;  /* Total time spent waiting */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+static struct sim_spinstat_s g_sim_spinstat[SIM_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_spinstat_wait
+ *
+ * Description:
+ *   Account for the end of a spinlock wait on this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+static void sim_spinstat_wait(FAR struct sim_spinstat_s *stat)
+{
+  uint32_t elapsed = up_critmon_gettime() - stat->start;
+
+  stat->totalwait += elapsed;
+  if (elapsed > stat->maxwait)
+    {
+      stat->maxwait = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -208,4 +279,95 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+/* Spinlock operations are far too frequent to be logged one by one.  They
+ * are accumulated per simulated CPU instead and reported by
+ * sim_spinstat_report().
+ */
+
+void sched_note_spinlock(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
+{
+  g_sim_spinstat[SIM_THISCPU].start = up_critmon_gettime();
+}
+
+void sched_note_spinlocked(FAR struct tcb_s *tcb,
+                           FAR volatile void *spinlock)
+{
+  FAR struct sim_spinstat_s *stat = &g_sim_spinstat[SIM_THISCPU];
+
+  sim_spinstat_wait(stat);
+  stat->nlocks++;
+}
+
+void sched_note_spinunlock(FAR struct tcb_s *tcb,
+                           FAR volatile void *spinlock)
+{
+}
+
+void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
+{
+  FAR struct sim_spinstat_s *stat = &g_sim_spinstat[SIM_THISCPU];
+
+  sim_spinstat_wait(stat);
+  stat->naborts++;
+}
+
+/****************************************************************************
+ * Name: sim_spinstat_report
+ *
+ * Description:
+ *   Log the spinlock (including the critical section lock) contention of
+ *   each simulated CPU since start-up.
+ *
+ ****************************************************************************/
+
+void sim_spinstat_report(void)
+{
+  FAR struct sim_spinstat_s *stat;
+  struct timespec total;
+  struct timespec max;
+  uint64_t totalwait;
+  int cpu;
+
+  for (cpu = 0; cpu < SIM_NCPUS; cpu++)
+    {
+      stat = &g_sim_spinstat[cpu];
+
+      /* up_critmon_convert() only takes 32 bits.  Convert in chunks. */
+
+      total.tv_sec  = 0;
+      total.tv_nsec = 0;
+
+      for (totalwait = stat->totalwait; totalwait > 0; )
+        {
+          struct timespec ts;
+          uint32_t chunk = totalwait > UINT32_MAX ? UINT32_MAX :
+                           (uint32_t)totalwait;
+
+          up_critmon_convert(chunk, &ts);
+          total.tv_sec  += ts.tv_sec;
+          total.tv_nsec += ts.tv_nsec;
+          if (total.tv_nsec >= NSEC_PER_SEC)
+            {
+              total.tv_sec++;
+              total.tv_nsec -= NSEC_PER_SEC;
+            }
+
+          totalwait -= chunk;
+        }
+
+      up_critmon_convert(stat->maxwait, &max);
+
+      syslog(LOG_INFO, "CPU%d: %lu spinlocks, %lu aborted, "
+             "waited %lu.%06lu s, longest %lu.%06lu s\n",
+             cpu, (unsigned long)stat->nlocks,
+             (unsigned long)stat->naborts,
+             (unsigned long)total.tv_sec,
+             (unsigned long)total.tv_nsec / 1000,
+             (unsigned long)max.tv_sec,
+             (unsigned long)max.tv_nsec / 1000);
+    }
+}
+#endif
+
 #endif /* CONFIG_SCHED_INSTRUMENTATION && !CONFIG_SCHED_INSTRUMENTATION_BUFFER */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * arch/sim/src/sim/up_simsmp.c
  *
- *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -43,6 +43,8 @@
 #include <pthread.h>
 #include <semaphore.h>
 #include <signal.h>
+#include <sched.h>
+#include <unistd.h>
 #include <errno.h>
 
 /****************************************************************************
@@ -108,6 +110,41 @@ void sim_smp_hook(void);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sim_cpu_setaffinity
+ *
+ * Description:
+ *   Bind the calling (host) pthread to the host core of the simulated CPU.
+ *   Failure is not fatal:  The CPU then simply runs unbound.
+ *
+ * Input Parameters:
+ *   cpu - The index of the simulated CPU
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_CPU_AFFINITY_BASE
+static void sim_cpu_setaffinity(int cpu)
+{
+  cpu_set_t cpuset;
+  long ncores;
+
+  ncores = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncores <= 0)
+    {
+      return;
+    }
+
+  CPU_ZERO(&cpuset);
+  CPU_SET((CONFIG_SIM_CPU_AFFINITY_BASE + cpu) % ncores, &cpuset);
+  (void)pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+}
+#else
+#  define sim_cpu_setaffinity(cpu)
+#endif
+
 /****************************************************************************
  * Name: sim_cpu0_trampoline
  *
@@ -136,6 +173,8 @@ static void *sim_cpu0_trampoline(void *arg)
       return NULL;
     }
 
+  sim_cpu_setaffinity(0);
+
   /* Make sure the SIGUSR1 is not masked */
 
   sigemptyset(&set);
@@ -190,6 +229,8 @@ static void *sim_idle_trampoline(void *arg)
       return NULL;
     }
 
+  sim_cpu_setaffinity(cpuinfo->cpu);
+
   /* Make sure the SIGUSR1 is not masked */
 
   sigemptyset(&set);
@@ -56,6 +56,8 @@
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/audio/audio.h>
 #include <mqueue.h>
 
@@ -82,6 +84,36 @@
  * Private Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_RING
+/* This structure describes the ring of a ring-mode PCM stream.  The byte
+ * pointers only increase (modulo 2^32):
+ *
+ *   hwptr <= enqptr <= applptr            (playback)
+ *   applptr <= hwptr <= enqptr            (capture)
+ *
+ * enqptr is the end of the periods enqueued to the lower half.
+ */
+
+struct audio_ring_s
+{
+  FAR struct ap_buffer_s *apb; /* One buffer per period */
+  FAR uint8_t      *data;     /* The ring: nperiods * period bytes */
+  uint32_t          size;     /* Size of the ring */
+  uint32_t          period;   /* Size of one period */
+  uint8_t           nperiods; /* Number of periods */
+  uint8_t           enqidx;   /* Index of the next period to enqueue */
+  uint8_t           nwaiters; /* Number of threads in AUDIOIOC_RINGWAIT */
+  bool              capture;  /* True: The device fills the ring */
+  uint32_t          hwptr;    /* Bytes transferred by the device */
+  uint32_t          enqptr;   /* Bytes enqueued to the lower half */
+  uint32_t          applptr;  /* Bytes committed by the application */
+  uint32_t          hwofs;    /* Offset of hwptr in the ring */
+  uint32_t          applofs;  /* Offset of applptr in the ring */
+  uint32_t          xruns;    /* Number of under- or overruns */
+  sem_t             waitsem;  /* Wakes up threads in AUDIOIOC_RINGWAIT */
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct audio_upperhalf_s
@@ -91,6 +123,9 @@ struct audio_upperhalf_s
   sem_t             exclsem;  /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   mqd_t             usermq;   /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING
+  struct audio_ring_s ring;   /* Ring-mode PCM stream */
+#endif
 };
 
 /****************************************************************************
@@ -111,6 +146,12 @@ static int      audio_start(FAR struct audio_upperhalf_s *upper);
 static void     audio_callback(FAR void *priv, uint16_t reason,
                     FAR struct ap_buffer_s *apb, uint16_t status);
 #endif /* CONFIG_AUDIO_MULTI_SESSION */
+#ifdef CONFIG_AUDIO_RING
+static void     audio_ring_free(FAR struct audio_upperhalf_s *upper);
+static int      audio_ring_enqueue(FAR struct audio_upperhalf_s *upper);
+static int      audio_ring_wait(FAR struct file *filep,
+                    FAR struct audio_upperhalf_s *upper, uint32_t nbytes);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -231,6 +272,12 @@ static int audio_close(FAR struct file *filep)
       audinfo("calling shutdown: %d\n");
 
       lower->ops->shutdown(lower);
+
+#ifdef CONFIG_AUDIO_RING
+      /* The lower half is stopped and no longer uses the ring */
+
+      audio_ring_free(upper);
+#endif
     }
 
   ret = OK;
@@ -316,6 +363,18 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
   if (!upper->started)
     {
+#ifdef CONFIG_AUDIO_RING
+      /* Enqueue the periods of the ring that are ready: The committed data
+       * for playback or all free periods for capture.
+       */
+
+      ret = audio_ring_enqueue(upper);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+
       /* Invoke the bottom half method to start the audio stream */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -339,6 +398,363 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
   return ret;
 }
 
+#ifdef CONFIG_AUDIO_RING
+/****************************************************************************
+ * Name: audio_ring_avail
+ *
+ * Description:
+ *   Return the number of bytes that the application may write (playback) or
+ *   read (capture).
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_ring_avail(FAR struct audio_ring_s *ring)
+{
+  if (ring->capture)
+    {
+      return ring->hwptr - ring->applptr;
+    }
+
+  return ring->size - (ring->applptr - ring->hwptr);
+}
+
+/****************************************************************************
+ * Name: audio_ring_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting in AUDIOIOC_RINGWAIT.
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_ring_wakeup(FAR struct audio_ring_s *ring)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < ring->nwaiters; i++)
+    {
+      nxsem_post(&ring->waitsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: audio_ring_free
+ *
+ * Description:
+ *   Free the ring.  None of its periods may be enqueued to the lower half.
+ *
+ ****************************************************************************/
+
+static void audio_ring_free(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_s *ring = &upper->ring;
+  int i;
+
+  if (ring->data != NULL)
+    {
+      for (i = 0; i < ring->nperiods; i++)
+        {
+          nxsem_destroy(&ring->apb[i].sem);
+        }
+
+      kmm_free(ring->apb);
+      kumm_free(ring->data);
+
+      ring->apb      = NULL;
+      ring->data     = NULL;
+      ring->nperiods = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ring_setup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSETUP ioctl command.  The ring is allocated
+ *   from the user heap so that the application can access it.  The buffer
+ *   headers stay in the kernel heap.
+ *
+ ****************************************************************************/
+
+static int audio_ring_setup(FAR struct audio_upperhalf_s *upper,
+                            FAR struct audio_ring_desc_s *desc)
+{
+  FAR struct audio_ring_s *ring = &upper->ring;
+  FAR struct ap_buffer_s *apb;
+  int i;
+
+  /* The ring cannot be replaced while it is in use */
+
+  if (upper->started || ring->nwaiters > 0 || ring->enqptr != ring->hwptr)
+    {
+      return -EBUSY;
+    }
+
+  audio_ring_free(upper);
+  if (desc->nperiods == 0)
+    {
+      return OK;
+    }
+
+  if (desc->nperiods < 2 || desc->period == 0)
+    {
+      return -EINVAL;
+    }
+
+  ring->apb = (FAR struct ap_buffer_s *)
+    kmm_zalloc(desc->nperiods * sizeof(struct ap_buffer_s));
+  if (ring->apb == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->data = (FAR uint8_t *)kumm_malloc(desc->nperiods * desc->period);
+  if (ring->data == NULL)
+    {
+      kmm_free(ring->apb);
+      ring->apb = NULL;
+      return -ENOMEM;
+    }
+
+  /* Each period is described by one audio pipeline buffer.  The buffers are
+   * never freed by the lower half since the reference count never drops
+   * below one.
+   */
+
+  for (i = 0; i < desc->nperiods; i++)
+    {
+      apb             = &ring->apb[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = desc->period;
+      apb->samp       = &ring->data[i * desc->period];
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      apb->session    = desc->session;
+#endif
+
+      nxsem_init(&apb->sem, 0, 1);
+    }
+
+  ring->size     = desc->nperiods * desc->period;
+  ring->period   = desc->period;
+  ring->nperiods = desc->nperiods;
+  ring->capture  = (desc->flags & AUDIO_RING_CAPTURE) != 0;
+  ring->enqidx   = 0;
+  ring->hwptr    = 0;
+  ring->enqptr   = 0;
+  ring->applptr  = 0;
+  ring->hwofs    = 0;
+  ring->applofs  = 0;
+  ring->xruns    = 0;
+
+  desc->buffer   = ring->data;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ring_enqueue
+ *
+ * Description:
+ *   Enqueue all periods of the ring that are ready to the lower half:  The
+ *   periods filled by the application for playback or the periods consumed
+ *   by the application for capture.
+ *
+ ****************************************************************************/
+
+static int audio_ring_enqueue(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct audio_ring_s *ring = &upper->ring;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  uint32_t ready;
+  int ret;
+
+  if (ring->data == NULL)
+    {
+      return OK;
+    }
+
+  DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+
+  for (; ; )
+    {
+      /* Claim the next period before it is enqueued.  The lower half may
+       * return it before enqueuebuffer() returns.
+       */
+
+      flags = enter_critical_section();
+      if (ring->capture)
+        {
+          ready = ring->applptr + ring->size - ring->enqptr;
+        }
+      else
+        {
+          ready = ring->applptr - ring->enqptr;
+        }
+
+      if (ready < ring->period)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      ring->enqptr += ring->period;
+      leave_critical_section(flags);
+
+      apb          = &ring->apb[ring->enqidx];
+      apb->nbytes  = ring->capture ? 0 : ring->period;
+      apb->curbyte = 0;
+      apb->flags   = 0;
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          flags = enter_critical_section();
+          ring->enqptr -= ring->period;
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      if (++ring->enqidx >= ring->nperiods)
+        {
+          ring->enqidx = 0;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ring_commit
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGCOMMIT ioctl command.
+ *
+ ****************************************************************************/
+
+static int audio_ring_commit(FAR struct audio_upperhalf_s *upper,
+                             uint32_t nbytes)
+{
+  FAR struct audio_ring_s *ring = &upper->ring;
+  irqstate_t flags;
+
+  if (ring->data == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (nbytes > audio_ring_avail(ring))
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  ring->applptr += nbytes;
+  ring->applofs  = (ring->applofs + nbytes) % ring->size;
+  leave_critical_section(flags);
+
+  return audio_ring_enqueue(upper);
+}
+
+/****************************************************************************
+ * Name: audio_ring_wait
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGWAIT ioctl command.  Returns the number of bytes
+ *   available or -EPIPE if the stream is not running.
+ *
+ ****************************************************************************/
+
+static int audio_ring_wait(FAR struct file *filep,
+                           FAR struct audio_upperhalf_s *upper,
+                           uint32_t nbytes)
+{
+  FAR struct audio_ring_s *ring = &upper->ring;
+  irqstate_t flags;
+  uint32_t avail;
+  int ret;
+
+  flags = enter_critical_section();
+  if (ring->data == NULL || nbytes > ring->size)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  while ((avail = audio_ring_avail(ring)) < nbytes)
+    {
+      /* Nothing will change if the stream is not running */
+
+      if (!upper->started)
+        {
+          ret = -EPIPE;
+          goto errout;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      ring->nwaiters++;
+      ret = nxsem_wait(&ring->waitsem);
+      ring->nwaiters--;
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  ret = (int)avail;
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ring_dequeue
+ *
+ * Description:
+ *   A period of the ring was returned by the lower half.  Advance the
+ *   hardware pointer and wake up the waiting threads.  No message is sent.
+ *   If no other period is enqueued, the lower half has run dry.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_ring_dequeue(FAR struct audio_ring_s *ring)
+{
+  irqstate_t flags;
+
+  flags        = enter_critical_section();
+  ring->hwptr += ring->period;
+  ring->hwofs  = (ring->hwofs + ring->period) % ring->size;
+
+  if (ring->hwptr == ring->enqptr)
+    {
+      ring->xruns++;
+    }
+
+  audio_ring_wakeup(ring);
+  leave_critical_section(flags);
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /************************************************************************************
  * Name: audio_ioctl
  *
@@ -360,6 +776,19 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   audinfo("cmd: %d arg: %ld\n", cmd, arg);
 
+#ifdef CONFIG_AUDIO_RING
+  /* AUDIOIOC_RINGWAIT - Wait for space or data in the ring.  The wait does
+   *   not hold the exclusion semaphore so that other threads may commit.
+   *
+   *   ioctl argument:  The number of bytes to wait for
+   */
+
+  if (cmd == AUDIOIOC_RINGWAIT)
+    {
+      return audio_ring_wait(filep, upper, (uint32_t)arg);
+    }
+#endif
+
   /* Get exclusive access to the device structures */
 
   ret = nxsem_wait(&upper->exclsem);
@@ -462,6 +891,10 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = lower->ops->stop(lower);
 #endif
               upper->started = false;
+
+#ifdef CONFIG_AUDIO_RING
+              audio_ring_wakeup(&upper->ring);
+#endif
             }
         }
         break;
@@ -647,6 +1080,90 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_RINGSETUP - Allocate or free the ring
+       *
+       *   ioctl argument:  pointer to an audio_ring_desc_s structure
+       */
+
+      case AUDIOIOC_RINGSETUP:
+        {
+          FAR struct audio_ring_desc_s *desc =
+            (FAR struct audio_ring_desc_s *)((uintptr_t)arg);
+
+          audinfo("AUDIOIOC_RINGSETUP\n");
+          DEBUGASSERT(desc != NULL);
+
+          ret = audio_ring_setup(upper, desc);
+        }
+        break;
+
+      /* AUDIOIOC_RINGCOMMIT - Commit written or consumed bytes
+       *
+       *   ioctl argument:  the number of bytes
+       */
+
+      case AUDIOIOC_RINGCOMMIT:
+        {
+          audinfo("AUDIOIOC_RINGCOMMIT\n");
+          ret = audio_ring_commit(upper, (uint32_t)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGSTATUS - Get the ring pointers
+       *
+       *   ioctl argument:  pointer to an audio_ring_status_s structure
+       */
+
+      case AUDIOIOC_RINGSTATUS:
+        {
+          FAR struct audio_ring_status_s *status =
+            (FAR struct audio_ring_status_s *)((uintptr_t)arg);
+          FAR struct audio_ring_s *ring = &upper->ring;
+          irqstate_t flags;
+
+          DEBUGASSERT(status != NULL);
+          if (ring->data == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          flags           = enter_critical_section();
+          status->hwptr   = ring->hwptr;
+          status->applptr = ring->applptr;
+          status->hwofs   = ring->hwofs;
+          status->applofs = ring->applofs;
+          status->avail   = audio_ring_avail(ring);
+          status->xruns   = ring->xruns;
+          leave_critical_section(flags);
+          ret = OK;
+        }
+        break;
+
+      /* FIOC_MMAP - Map the ring into the application
+       *
+       *   ioctl argument:  pointer to receive the address of the ring
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+          if (upper->ring.data == NULL)
+            {
+              ret = -ENXIO;
+            }
+          else
+            {
+              *ppv = upper->ring.data;
+              ret  = OK;
+            }
+        }
+        break;
+#endif /* CONFIG_AUDIO_RING */
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -707,6 +1224,17 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_RING
+  /* Periods of the ring are recycled without a message */
+
+  if (upper->ring.data != NULL && apb >= upper->ring.apb &&
+      apb < &upper->ring.apb[upper->ring.nperiods])
+    {
+      audio_ring_dequeue(&upper->ring);
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
@@ -748,6 +1276,11 @@ static inline void audio_complete(FAR struct audio_upperhalf_s *upper,
   /* Send a dequeue message to the user if a message queue is registered */
 
   upper->started = false;
+
+#ifdef CONFIG_AUDIO_RING
+  audio_ring_wakeup(&upper->ring);
+#endif
+
   if (upper->usermq != NULL)
     {
       msg.msgId = AUDIO_MSG_COMPLETE;
@@ -786,7 +1319,7 @@ static inline void audio_message(FAR struct audio_upperhalf_s *upper,
   if (upper->usermq != NULL)
     {
 #ifdef CONFIG_AUDIO_MULTI_SESSION
-      msg.session = session;
+      msg->session = session;
 #endif
       (void)nxmq_send(upper->usermq, (FAR const char *)msg, sizeof(*msg),
                       CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO);
@@ -938,6 +1471,15 @@ int audio_register(FAR const char *name, FAR struct audio_lowerhalf_s *dev)
   nxsem_init(&upper->exclsem, 0, 1);
   upper->dev = dev;
 
+#ifdef CONFIG_AUDIO_RING
+  /* The ring wait semaphore is used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  nxsem_init(&upper->ring.waitsem, 0, 0);
+  nxsem_setprotocol(&upper->ring.waitsem, SEM_PRIO_NONE);
+#endif
+
 #ifdef CONFIG_AUDIO_CUSTOM_DEV_PATH
 
 #ifdef CONFIG_AUDIO_DEV_ROOT
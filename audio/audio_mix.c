@@ -0,0 +1,1298 @@
+/****************************************************************************
+ * audio/audio_mix.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mix.h>
+
+#ifdef CONFIG_AUDIO_MIX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_AUDIO_MIX_SAMPLERATE
+#  define CONFIG_AUDIO_MIX_SAMPLERATE 48000
+#endif
+
+#ifndef CONFIG_AUDIO_MIX_NFRAMES
+#  define CONFIG_AUDIO_MIX_NFRAMES 256
+#endif
+
+#ifndef CONFIG_AUDIO_MIX_NBUFFERS
+#  define CONFIG_AUDIO_MIX_NBUFFERS 3
+#endif
+
+#ifndef CONFIG_AUDIO_MIX_PRIORITY
+#  define CONFIG_AUDIO_MIX_PRIORITY 200
+#endif
+
+#ifndef CONFIG_AUDIO_MIX_STACKSIZE
+#  define CONFIG_AUDIO_MIX_STACKSIZE 1024
+#endif
+
+/* The polyphase sample rate converter uses AUDIO_MIX_NPHASES phases of an
+ * AUDIO_MIX_NTAPS tap filter.  The phase is selected by the upper bits of
+ * the Q16 position between two input frames.
+ */
+
+#define AUDIO_MIX_NTAPS      8
+#define AUDIO_MIX_PHASEBITS  5
+#define AUDIO_MIX_NPHASES    (1 << AUDIO_MIX_PHASEBITS)
+#define AUDIO_MIX_ONE        (1 << 16)
+
+/* Unity gain in Q15 */
+
+#define AUDIO_MIX_UNITY      32767
+
+/* Size of one output buffer:  16-bit stereo frames */
+
+#define AUDIO_MIX_BUFSIZE    (CONFIG_AUDIO_MIX_NFRAMES * 4)
+
+/* States of the output */
+
+#define AUDIO_MIX_IDLE       0  /* Not started */
+#define AUDIO_MIX_RUNNING    1  /* Started */
+#define AUDIO_MIX_DRAINING   2  /* The final buffer was enqueued */
+
+/* Calls to the output and to the upper halves of the inputs */
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+#  define AUDIO_MIX_CONFIGURE(l,c) ((l)->ops->configure((l), NULL, (c)))
+#  define AUDIO_MIX_START(l)       ((l)->ops->start((l), NULL))
+#  define AUDIO_MIX_STOP(l)        ((l)->ops->stop((l), NULL))
+#  define audio_mix_notify(in,reason,apb) \
+     (in)->dev.upper((in)->dev.priv, (reason), (apb), OK, NULL)
+#else
+#  define AUDIO_MIX_CONFIGURE(l,c) ((l)->ops->configure((l), (c)))
+#  define AUDIO_MIX_START(l)       ((l)->ops->start((l)))
+#  define AUDIO_MIX_STOP(l)        ((l)->ops->stop((l)))
+#  define audio_mix_notify(in,reason,apb) \
+     (in)->dev.upper((in)->dev.priv, (reason), (apb), OK)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mix_s;
+
+/* This structure describes one input of the mixer */
+
+struct audio_mix_input_s
+{
+  /* This is our appearance to the outside world.  This *MUST* be the first
+   * element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf_s and struct audio_mix_input_s.
+   */
+
+  struct audio_lowerhalf_s dev;
+
+  FAR struct audio_mix_s *mix;      /* The mixer */
+  struct dq_queue_s pendq;          /* Enqueued buffers */
+  uint32_t nframes;                 /* Frames in the enqueued buffers */
+  uint32_t step;                    /* Q16 input frames per output frame */
+  uint32_t frac;                    /* Q16 position between input frames */
+  uint16_t samprate;                /* Input sample rate */
+  uint16_t gain;                    /* Q15 volume */
+  uint8_t nchannels;                /* 1 or 2 */
+  uint8_t bpsamp;                   /* 8 or 16 */
+  bool reserved;                    /* True: Reserved by an upper half */
+  volatile bool running;            /* True: Started */
+  volatile bool paused;             /* True: Paused */
+  volatile bool stopping;           /* True: Stop requested */
+  bool final;                       /* True: Final buffer was consumed */
+  int16_t hist[2][AUDIO_MIX_NTAPS]; /* Filter history, newest last */
+};
+
+/* This structure describes the state of the mixer */
+
+struct audio_mix_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The output */
+  FAR struct audio_mix_input_s *inputs;
+  int ninputs;
+  sem_t exclsem;                    /* Serializes configure and start */
+  sem_t wakesem;                    /* Wakes up the mixer thread */
+  struct dq_queue_s freeq;          /* Output buffers not enqueued */
+  volatile uint8_t outstate;        /* See AUDIO_MIX_* states */
+  FAR struct ap_buffer_s *outbuf[CONFIG_AUDIO_MIX_NBUFFERS];
+  int32_t acc[2 * CONFIG_AUDIO_MIX_NFRAMES]; /* Mixing accumulator */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mix_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                             FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_configure(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session,
+                               FAR const struct audio_caps_s *caps);
+#else
+static int audio_mix_configure(FAR struct audio_lowerhalf_s *dev,
+                               FAR const struct audio_caps_s *caps);
+#endif
+static int audio_mix_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_start(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session);
+#else
+static int audio_mix_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_stop(FAR struct audio_lowerhalf_s *dev,
+                          FAR void *session);
+#else
+static int audio_mix_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_pause(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session);
+static int audio_mix_resume(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#else
+static int audio_mix_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mix_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int audio_mix_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                   FAR struct ap_buffer_s *apb);
+static int audio_mix_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                           unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_reserve(FAR struct audio_lowerhalf_s *dev,
+                             FAR void **session);
+static int audio_mix_release(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#else
+static int audio_mix_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mix_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mix_callback(FAR void *arg, uint16_t reason,
+                               FAR struct ap_buffer_s *apb, uint16_t status,
+                               FAR void *session);
+#else
+static void audio_mix_callback(FAR void *arg, uint16_t reason,
+                               FAR struct ap_buffer_s *apb, uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mix_ops =
+{
+  audio_mix_getcaps,        /* getcaps        */
+  audio_mix_configure,      /* configure      */
+  audio_mix_shutdown,       /* shutdown       */
+  audio_mix_start,          /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mix_stop,           /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mix_pause,          /* pause          */
+  audio_mix_resume,         /* resume         */
+#endif
+  NULL,                     /* allocbuffer    */
+  NULL,                     /* freebuffer     */
+  audio_mix_enqueuebuffer,  /* enqueue_buffer */
+  NULL,                     /* cancel_buffer  */
+  audio_mix_ioctl,          /* ioctl          */
+  NULL,                     /* read           */
+  NULL,                     /* write          */
+  audio_mix_reserve,        /* reserve        */
+  audio_mix_release         /* release        */
+};
+
+/* The Q15 coefficients of the sample rate converter:  A Kaiser windowed
+ * (beta = 6) sinc with the cutoff at 0.9 of the output Nyquist frequency.
+ * Phase p interpolates at p / AUDIO_MIX_NPHASES of an input frame after
+ * tap 3.  Each phase sums to unity.  The cutoff is not lowered when
+ * downsampling.
+ */
+
+static const int16_t g_audio_mix_coef[AUDIO_MIX_NPHASES][AUDIO_MIX_NTAPS] =
+{
+  {    459,  -1477,   2704,  29432,   2704,  -1477,    459,    -37 },
+  {    405,  -1242,   1879,  29394,   3578,  -1719,    515,    -44 },
+  {    351,  -1013,   1104,  29271,   4497,  -1962,    571,    -51 },
+  {    300,   -792,    379,  29061,   5457,  -2207,    626,    -58 },
+  {    250,   -581,   -292,  28767,   6456,  -2449,    680,    -65 },
+  {    203,   -381,   -908,  28390,   7490,  -2687,    732,    -73 },
+  {    160,   -193,  -1470,  27933,   8554,  -2918,    781,    -80 },
+  {    119,    -19,  -1977,  27398,   9644,  -3138,    826,    -87 },
+  {     82,    142,  -2428,  26788,  10754,  -3346,    867,    -93 },
+  {     48,    289,  -2824,  26108,  11880,  -3537,    901,    -98 },
+  {     18,    420,  -3165,  25360,  13017,  -3709,    929,   -102 },
+  {     -8,    537,  -3454,  24549,  14158,  -3859,    949,   -105 },
+  {    -32,    639,  -3691,  23681,  15299,  -3983,    961,   -106 },
+  {    -51,    726,  -3878,  22760,  16432,  -4078,    963,   -106 },
+  {    -68,    798,  -4017,  21791,  17553,  -4142,    954,   -103 },
+  {    -81,    857,  -4111,  20780,  18656,  -4170,    934,    -98 },
+  {    -91,    902,  -4161,  19733,  19733,  -4161,    902,    -91 },
+  {    -98,    934,  -4170,  18656,  20780,  -4111,    857,    -81 },
+  {   -103,    954,  -4142,  17553,  21791,  -4017,    798,    -68 },
+  {   -106,    963,  -4078,  16432,  22760,  -3878,    726,    -51 },
+  {   -106,    961,  -3983,  15299,  23681,  -3691,    639,    -32 },
+  {   -105,    949,  -3859,  14158,  24549,  -3454,    537,     -8 },
+  {   -102,    929,  -3709,  13017,  25360,  -3165,    420,     18 },
+  {    -98,    901,  -3537,  11880,  26108,  -2824,    289,     48 },
+  {    -93,    867,  -3346,  10754,  26788,  -2428,    142,     82 },
+  {    -87,    826,  -3138,   9644,  27398,  -1977,    -19,    119 },
+  {    -80,    781,  -2918,   8554,  27933,  -1470,   -193,    160 },
+  {    -73,    732,  -2687,   7490,  28390,   -908,   -381,    203 },
+  {    -65,    680,  -2449,   6456,  28767,   -292,   -581,    250 },
+  {    -58,    626,  -2207,   5457,  29061,    379,   -792,    300 },
+  {    -51,    571,  -1962,   4497,  29271,   1104,  -1013,    351 },
+  {    -44,    515,  -1719,   3578,  29394,   1879,  -1242,    405 }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mix_saturate
+ *
+ * Description:
+ *   Saturate a block of the accumulator to 16-bit samples.
+ *
+ ****************************************************************************/
+
+static void audio_mix_saturate(FAR int16_t *dst, FAR const int32_t *src,
+                               int nsamples)
+{
+  int32_t val;
+
+  while (nsamples-- > 0)
+    {
+      val = *src++;
+#ifdef __ARM_FEATURE_DSP
+      __asm__ ("ssat %0, #16, %1" : "=r" (val) : "r" (val));
+#else
+      if (val > INT16_MAX)
+        {
+          val = INT16_MAX;
+        }
+      else if (val < INT16_MIN)
+        {
+          val = INT16_MIN;
+        }
+#endif
+
+      *dst++ = (int16_t)val;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_dotprod
+ *
+ * Description:
+ *   Apply one phase of the filter to the history of one channel.
+ *
+ ****************************************************************************/
+
+static inline int32_t audio_mix_dotprod(FAR const int16_t *hist,
+                                        FAR const int16_t *coef)
+{
+  int32_t sum;
+
+  sum  = (int32_t)hist[0] * coef[0] + (int32_t)hist[1] * coef[1];
+  sum += (int32_t)hist[2] * coef[2] + (int32_t)hist[3] * coef[3];
+  sum += (int32_t)hist[4] * coef[4] + (int32_t)hist[5] * coef[5];
+  sum += (int32_t)hist[6] * coef[6] + (int32_t)hist[7] * coef[7];
+
+  return sum >> 15;
+}
+
+/****************************************************************************
+ * Name: audio_mix_getframe
+ *
+ * Description:
+ *   Get the next input frame as 16-bit stereo.  Buffers are returned to the
+ *   upper half as they are consumed.  If no data is queued, a silent frame
+ *   is returned.
+ *
+ * Assumptions:
+ *   Called on the mixer thread.
+ *
+ ****************************************************************************/
+
+static void audio_mix_getframe(FAR struct audio_mix_input_s *input,
+                               FAR int16_t *frame)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const uint8_t *src;
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  apb = (FAR struct ap_buffer_s *)dq_peek(&input->pendq);
+  leave_critical_section(flags);
+
+  if (apb == NULL)
+    {
+      frame[0] = 0;
+      frame[1] = 0;
+      return;
+    }
+
+  src = &apb->samp[apb->curbyte];
+  for (i = 0; i < input->nchannels; i++)
+    {
+      if (input->bpsamp == 8)
+        {
+          /* 8-bit PCM is unsigned */
+
+          frame[i] = (int16_t)(((int)*src++ - 128) << 8);
+        }
+      else
+        {
+          memcpy(&frame[i], src, 2);
+          src += 2;
+        }
+    }
+
+  if (input->nchannels == 1)
+    {
+      frame[1] = frame[0];
+    }
+
+  apb->curbyte += input->nchannels * input->bpsamp / 8;
+  if (apb->curbyte >= apb->nbytes)
+    {
+      flags = enter_critical_section();
+      dq_rem((FAR dq_entry_t *)apb, &input->pendq);
+      input->nframes -= apb->nbytes / (input->nchannels * input->bpsamp / 8);
+      leave_critical_section(flags);
+
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          input->final = true;
+        }
+
+      audio_mix_notify(input, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_flush
+ *
+ * Description:
+ *   Return all enqueued buffers of the input to the upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mix_flush(FAR struct audio_mix_input_s *input)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&input->pendq);
+      if (apb == NULL)
+        {
+          input->nframes = 0;
+        }
+
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mix_notify(input, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_ready
+ *
+ * Description:
+ *   Return true if the input has the data for one period.  An input that
+ *   has received its final buffer is always ready; it is padded with
+ *   silence.
+ *
+ ****************************************************************************/
+
+static bool audio_mix_ready(FAR struct audio_mix_input_s *input)
+{
+  FAR struct ap_buffer_s *apb;
+  uint32_t needed;
+
+  apb = (FAR struct ap_buffer_s *)dq_tail(&input->pendq);
+  if (apb != NULL && (apb->flags & AUDIO_APB_FINAL) != 0)
+    {
+      return true;
+    }
+
+  needed = (input->frac + CONFIG_AUDIO_MIX_NFRAMES * input->step) >> 16;
+  return input->nframes >= needed;
+}
+
+/****************************************************************************
+ * Name: audio_mix_input
+ *
+ * Description:
+ *   Resample one period of the input and add it to the accumulator.
+ *
+ ****************************************************************************/
+
+static void audio_mix_input(FAR struct audio_mix_s *mix,
+                            FAR struct audio_mix_input_s *input)
+{
+  FAR int32_t *acc = mix->acc;
+  FAR const int16_t *coef;
+  int32_t gain = input->gain;
+  int16_t frame[2];
+  int n;
+
+  if (input->step == AUDIO_MIX_ONE)
+    {
+      /* Same rate:  No filtering */
+
+      for (n = 0; n < CONFIG_AUDIO_MIX_NFRAMES; n++)
+        {
+          audio_mix_getframe(input, frame);
+          *acc++ += ((int32_t)frame[0] * gain) >> 15;
+          *acc++ += ((int32_t)frame[1] * gain) >> 15;
+        }
+
+      return;
+    }
+
+  for (n = 0; n < CONFIG_AUDIO_MIX_NFRAMES; n++)
+    {
+      /* Shift in the input frames up to the output position */
+
+      while (input->frac >= AUDIO_MIX_ONE)
+        {
+          audio_mix_getframe(input, frame);
+
+          memmove(&input->hist[0][0], &input->hist[0][1],
+                  (AUDIO_MIX_NTAPS - 1) * sizeof(int16_t));
+          memmove(&input->hist[1][0], &input->hist[1][1],
+                  (AUDIO_MIX_NTAPS - 1) * sizeof(int16_t));
+
+          input->hist[0][AUDIO_MIX_NTAPS - 1] = frame[0];
+          input->hist[1][AUDIO_MIX_NTAPS - 1] = frame[1];
+          input->frac -= AUDIO_MIX_ONE;
+        }
+
+      coef = g_audio_mix_coef[input->frac >> (16 - AUDIO_MIX_PHASEBITS)];
+
+      *acc++ += (audio_mix_dotprod(input->hist[0], coef) * gain) >> 15;
+      *acc++ += (audio_mix_dotprod(input->hist[1], coef) * gain) >> 15;
+
+      input->frac += input->step;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_service
+ *
+ * Description:
+ *   Complete stopped inputs, start or stop the output, and mix periods
+ *   while there are free output buffers and all running inputs have data.
+ *
+ * Assumptions:
+ *   Called on the mixer thread with exclsem held.
+ *
+ ****************************************************************************/
+
+static void audio_mix_service(FAR struct audio_mix_s *mix)
+{
+  FAR struct audio_lowerhalf_s *lower = mix->lower;
+  FAR struct audio_mix_input_s *input;
+  FAR struct ap_buffer_s *apb;
+  struct audio_caps_s caps;
+  irqstate_t flags;
+  bool running;
+  bool ready;
+  int ret;
+  int i;
+
+  for (; ; )
+    {
+      /* Complete the inputs that were stopped or have played their final
+       * buffer.
+       */
+
+      running = false;
+      ready   = true;
+
+      for (i = 0; i < mix->ninputs; i++)
+        {
+          input = &mix->inputs[i];
+          if (!input->running)
+            {
+              continue;
+            }
+
+          if (input->stopping ||
+              (input->final && dq_empty(&input->pendq)))
+            {
+              audio_mix_flush(input);
+              input->running  = false;
+              input->stopping = false;
+              audio_mix_notify(input, AUDIO_CALLBACK_COMPLETE, NULL);
+              continue;
+            }
+
+          running = true;
+          if (!input->paused && !audio_mix_ready(input))
+            {
+              ready = false;
+            }
+        }
+
+      if (!running)
+        {
+          /* Stop the output if the last input was stopped before its final
+           * buffer.
+           */
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+          if (mix->outstate == AUDIO_MIX_RUNNING)
+            {
+              AUDIO_MIX_STOP(lower);
+              mix->outstate = AUDIO_MIX_IDLE;
+            }
+#endif
+
+          return;
+        }
+
+      /* Wait for the end of the previous stream before starting again */
+
+      if (!ready || mix->outstate == AUDIO_MIX_DRAINING)
+        {
+          return;
+        }
+
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mix->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          return;
+        }
+
+      if (mix->outstate == AUDIO_MIX_IDLE)
+        {
+          memset(&caps, 0, sizeof(caps));
+          caps.ac_len            = sizeof(caps);
+          caps.ac_type           = AUDIO_TYPE_OUTPUT;
+          caps.ac_channels       = 2;
+          caps.ac_controls.hw[0] = CONFIG_AUDIO_MIX_SAMPLERATE;
+          caps.ac_controls.b[2]  = 16;
+
+          ret = AUDIO_MIX_CONFIGURE(lower, &caps);
+          if (ret < 0)
+            {
+              auderr("ERROR: Failed to configure the output: %d\n", ret);
+            }
+        }
+
+      /* Mix one period */
+
+      memset(mix->acc, 0, sizeof(mix->acc));
+      running = false;
+
+      for (i = 0; i < mix->ninputs; i++)
+        {
+          input = &mix->inputs[i];
+          if (input->running && !input->paused)
+            {
+              audio_mix_input(mix, input);
+            }
+
+          if (input->running && !(input->final && dq_empty(&input->pendq)))
+            {
+              running = true;
+            }
+        }
+
+      audio_mix_saturate((FAR int16_t *)apb->samp, mix->acc,
+                         2 * CONFIG_AUDIO_MIX_NFRAMES);
+
+      apb->nbytes  = AUDIO_MIX_BUFSIZE;
+      apb->curbyte = 0;
+      apb->flags   = 0;
+
+      /* If no input continues, this is the last buffer of the stream */
+
+      if (!running)
+        {
+          apb->flags |= AUDIO_APB_FINAL;
+        }
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to enqueue: %d\n", ret);
+          flags = enter_critical_section();
+          dq_addlast((FAR dq_entry_t *)apb, &mix->freeq);
+          leave_critical_section(flags);
+          return;
+        }
+
+      if (mix->outstate == AUDIO_MIX_IDLE)
+        {
+          ret = AUDIO_MIX_START(lower);
+          if (ret < 0)
+            {
+              auderr("ERROR: Failed to start the output: %d\n", ret);
+            }
+
+          mix->outstate = AUDIO_MIX_RUNNING;
+        }
+
+      if (!running)
+        {
+          mix->outstate = AUDIO_MIX_DRAINING;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_thread
+ *
+ * Description:
+ *   The mixer thread.
+ *
+ ****************************************************************************/
+
+static int audio_mix_thread(int argc, FAR char *argv[])
+{
+  FAR struct audio_mix_s *mix;
+
+  DEBUGASSERT(argc == 2);
+  mix = (FAR struct audio_mix_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&mix->wakesem);
+      nxsem_wait_uninterruptible(&mix->exclsem);
+      audio_mix_service(mix);
+      nxsem_post(&mix->exclsem);
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Name: audio_mix_wakeup
+ ****************************************************************************/
+
+static void audio_mix_wakeup(FAR struct audio_mix_s *mix)
+{
+  int semcount;
+
+  /* Avoid accumulating wake-ups:  The thread services everything at once */
+
+  if (nxsem_getvalue(&mix->wakesem, &semcount) == OK && semcount <= 0)
+    {
+      nxsem_post(&mix->wakesem);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mix_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                             FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            /* Any rate is converted */
+
+            caps->ac_controls.b[0] = AUDIO_SAMP_RATE_8K | AUDIO_SAMP_RATE_11K |
+                                     AUDIO_SAMP_RATE_16K | AUDIO_SAMP_RATE_22K |
+                                     AUDIO_SAMP_RATE_32K | AUDIO_SAMP_RATE_44K |
+                                     AUDIO_SAMP_RATE_48K;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        caps->ac_subtype = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mix_configure
+ *
+ * Description:
+ *   Configure the input format or the volume of the input.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_configure(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session,
+                               FAR const struct audio_caps_s *caps)
+#else
+static int audio_mix_configure(FAR struct audio_lowerhalf_s *dev,
+                               FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+  FAR struct audio_mix_s *mix = input->mix;
+  int ret = OK;
+
+  DEBUGASSERT(caps != NULL);
+
+  nxsem_wait_uninterruptible(&mix->exclsem);
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            /* The volume ranges from 0 to 1000 */
+
+            uint16_t volume = caps->ac_controls.hw[0];
+
+            if (volume > 1000)
+              {
+                ret = -EDOM;
+                break;
+              }
+
+            input->gain = (uint32_t)volume * AUDIO_MIX_UNITY / 1000;
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        if (caps->ac_channels != 1 && caps->ac_channels != 2)
+          {
+            ret = -ERANGE;
+            break;
+          }
+
+        if (caps->ac_controls.b[2] != 8 && caps->ac_controls.b[2] != 16)
+          {
+            ret = -ERANGE;
+            break;
+          }
+
+        if (caps->ac_controls.hw[0] == 0 || input->running)
+          {
+            ret = input->running ? -EBUSY : -ERANGE;
+            break;
+          }
+
+        input->samprate  = caps->ac_controls.hw[0];
+        input->nchannels = caps->ac_channels;
+        input->bpsamp    = caps->ac_controls.b[2];
+
+        /* The rate fits in 16 bits, so the Q16 step cannot overflow */
+
+        input->step = ((uint32_t)input->samprate << 16) /
+                      CONFIG_AUDIO_MIX_SAMPLERATE;
+        break;
+
+      default:
+        break;
+    }
+
+  nxsem_post(&mix->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mix_shutdown
+ ****************************************************************************/
+
+static int audio_mix_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+
+  if (input->running)
+    {
+      input->stopping = true;
+      audio_mix_wakeup(input->mix);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_start
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_start(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session)
+#else
+static int audio_mix_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+  FAR struct audio_mix_s *mix = input->mix;
+
+  nxsem_wait_uninterruptible(&mix->exclsem);
+  if (input->running)
+    {
+      nxsem_post(&mix->exclsem);
+      return -EBUSY;
+    }
+
+  memset(input->hist, 0, sizeof(input->hist));
+  input->frac     = AUDIO_MIX_ONE;
+  input->final    = false;
+  input->paused   = false;
+  input->stopping = false;
+  input->running  = true;
+  nxsem_post(&mix->exclsem);
+
+  audio_mix_wakeup(mix);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_stop
+ *
+ * Description:
+ *   Stop the input.  The enqueued buffers are returned and the stream is
+ *   completed on the mixer thread.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_stop(FAR struct audio_lowerhalf_s *dev,
+                          FAR void *session)
+#else
+static int audio_mix_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+
+  input->stopping = true;
+  audio_mix_wakeup(input->mix);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mix_pause
+ *
+ * Description:
+ *   Pause the input.  The other inputs continue.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_pause(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session)
+#else
+static int audio_mix_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+
+  input->paused = true;
+  audio_mix_wakeup(input->mix);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_resume
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_resume(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mix_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+
+  input->paused = false;
+  audio_mix_wakeup(input->mix);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mix_enqueuebuffer
+ *
+ * Description:
+ *   Queue a buffer of input samples.  This does not wait for the mixer
+ *   thread.
+ *
+ ****************************************************************************/
+
+static int audio_mix_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                   FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+  irqstate_t flags;
+  int align;
+
+  DEBUGASSERT(apb != NULL);
+
+  align = input->nchannels * input->bpsamp / 8;
+  if (align == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Only whole frames are mixed */
+
+  apb->nbytes -= (apb->nbytes - apb->curbyte) % align;
+
+  flags = enter_critical_section();
+  dq_addlast((FAR dq_entry_t *)apb, &input->pendq);
+  input->nframes += (apb->nbytes - apb->curbyte) / align;
+  leave_critical_section(flags);
+
+  audio_mix_wakeup(input->mix);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_ioctl
+ ****************************************************************************/
+
+static int audio_mix_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                           unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mix_reserve
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_reserve(FAR struct audio_lowerhalf_s *dev,
+                             FAR void **session)
+#else
+static int audio_mix_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&input->mix->exclsem);
+  if (input->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      input->reserved  = true;
+      input->gain      = AUDIO_MIX_UNITY;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session         = NULL;
+#endif
+    }
+
+  nxsem_post(&input->mix->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mix_release
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mix_release(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mix_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mix_input_s *input = (FAR struct audio_mix_input_s *)dev;
+
+  nxsem_wait_uninterruptible(&input->mix->exclsem);
+  input->reserved = false;
+  nxsem_post(&input->mix->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_callback
+ *
+ * Description:
+ *   Called by the output to return buffers and to report the end of the
+ *   stream.  May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mix_callback(FAR void *arg, uint16_t reason,
+                               FAR struct ap_buffer_s *apb, uint16_t status,
+                               FAR void *session)
+#else
+static void audio_mix_callback(FAR void *arg, uint16_t reason,
+                               FAR struct ap_buffer_s *apb, uint16_t status)
+#endif
+{
+  FAR struct audio_mix_s *mix = (FAR struct audio_mix_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast((FAR dq_entry_t *)apb, &mix->freeq);
+        leave_critical_section(flags);
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+        mix->outstate = AUDIO_MIX_IDLE;
+        break;
+
+      default:
+        return;
+    }
+
+  audio_mix_wakeup(mix);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mix_initialize
+ *
+ * Description:
+ *   Create an audio mixer in front of the lower half audio driver 'lower'.
+ *   See include/nuttx/audio/audio_mix.h.
+ *
+ ****************************************************************************/
+
+int audio_mix_initialize(FAR struct audio_lowerhalf_s *lower,
+                         FAR struct audio_lowerhalf_s **inputs,
+                         int ninputs)
+{
+  FAR struct audio_mix_s *mix;
+  struct audio_buf_desc_s bufdesc;
+  FAR char *argv[2];
+  char arg1[16];
+  int ret;
+  int i;
+
+  DEBUGASSERT(lower != NULL && inputs != NULL && ninputs > 0);
+
+  mix = (FAR struct audio_mix_s *)kmm_zalloc(sizeof(struct audio_mix_s));
+  if (mix == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mix->inputs = (FAR struct audio_mix_input_s *)
+    kmm_zalloc(ninputs * sizeof(struct audio_mix_input_s));
+  if (mix->inputs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_mix;
+    }
+
+  mix->lower   = lower;
+  mix->ninputs = ninputs;
+
+  nxsem_init(&mix->exclsem, 0, 1);
+  nxsem_init(&mix->wakesem, 0, 0);
+
+  /* The wake-up semaphore is used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&mix->wakesem, SEM_PRIO_NONE);
+
+  /* Allocate the output buffers.  Prefer the buffers of the output device
+   * since these may have to meet DMA constraints.
+   */
+
+  for (i = 0; i < CONFIG_AUDIO_MIX_NBUFFERS; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.numbytes   = AUDIO_MIX_BUFSIZE;
+      bufdesc.u.ppBuffer = &mix->outbuf[i];
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0 || mix->outbuf[i] == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_buffers;
+        }
+
+      dq_addlast((FAR dq_entry_t *)mix->outbuf[i], &mix->freeq);
+    }
+
+  /* Bind to the output */
+
+  lower->upper = audio_mix_callback;
+  lower->priv  = mix;
+
+  /* Create the inputs */
+
+  for (i = 0; i < ninputs; i++)
+    {
+      FAR struct audio_mix_input_s *input = &mix->inputs[i];
+
+      input->dev.ops   = &g_audio_mix_ops;
+      input->mix       = mix;
+      input->gain      = AUDIO_MIX_UNITY;
+      input->nchannels = 2;
+      input->bpsamp    = 16;
+      input->samprate  = CONFIG_AUDIO_MIX_SAMPLERATE;
+      input->step      = AUDIO_MIX_ONE;
+      inputs[i]        = &input->dev;
+    }
+
+  /* Start the mixer thread */
+
+  snprintf(arg1, sizeof(arg1), "%lx", (unsigned long)(uintptr_t)mix);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("audio_mix", CONFIG_AUDIO_MIX_PRIORITY,
+                       CONFIG_AUDIO_MIX_STACKSIZE,
+                       (main_t)audio_mix_thread, argv);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to start the mixer thread: %d\n", ret);
+      goto errout_with_buffers;
+    }
+
+  return OK;
+
+errout_with_buffers:
+  for (i = 0; i < CONFIG_AUDIO_MIX_NBUFFERS; i++)
+    {
+      if (mix->outbuf[i] != NULL)
+        {
+          apb_free(mix->outbuf[i]);
+        }
+    }
+
+  nxsem_destroy(&mix->wakesem);
+  nxsem_destroy(&mix->exclsem);
+  kmm_free(mix->inputs);
+
+errout_with_mix:
+  kmm_free(mix);
+  return ret;
+}
+
+#endif /* CONFIG_AUDIO_MIX */
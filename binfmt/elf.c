@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/elf.c
  *
- *   Copyright (C) 2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -96,7 +96,11 @@ static struct binfmt_s g_elfbinfmt =
 {
   NULL,             /* next */
   elf_loadbinary,   /* load */
+#ifdef CONFIG_ELF_CACHE
+  elf_cache_unload, /* unload */
+#else
   NULL,             /* unload */
+#endif
 };
 
 /****************************************************************************
@@ -228,6 +232,15 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   binfo("Loading file: %s\n", binp->filename);
 
+#ifdef CONFIG_ELF_CACHE
+  /* Re-use the image of the last execution of the program if possible */
+
+  if (elf_cache_lookup(binp) == OK)
+    {
+      return OK;
+    }
+#endif
+
   /* Initialize the ELF library to load the program binary. */
 
   ret = elf_init(binp->filename, &loadinfo);
@@ -295,6 +308,13 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 #endif
 
   elf_dumpentrypt(binp, &loadinfo);
+
+#ifdef CONFIG_ELF_CACHE
+  /* Keep the relocated image for the next execution of the program */
+
+  elf_cache_add(binp, &loadinfo);
+#endif
+
   elf_uninit(&loadinfo);
   return OK;
 
@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf.h
  *
- *   Copyright (C) 2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -132,6 +132,20 @@ int elf_findsection(FAR struct elf_loadinfo_s *loadinfo,
 
 int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_buffersymtab
+ *
+ * Description:
+ *   Read the symbol and string tables into memory if they are no larger
+ *   than CONFIG_ELF_TABLESIZE_MAX.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void elf_buffersymtab(FAR struct elf_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: elf_readsym
  *
@@ -345,4 +359,54 @@ int elf_addrenv_alloc(FAR struct elf_loadinfo_s *loadinfo, size_t textsize,
 
 void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_cache_lookup
+ *
+ * Description:
+ *   Look for an idle, up-to-date image of 'binp->filename' in the program
+ *   cache and, if one is found, set up 'binp' to execute it.
+ *
+ * Returned Value:
+ *   0 (OK) is returned if the program was loaded from the cache; a negated
+ *   errno value is returned if it must be loaded from the file.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_CACHE
+int elf_cache_lookup(FAR struct binary_s *binp);
+#endif
+
+/****************************************************************************
+ * Name: elf_cache_add
+ *
+ * Description:
+ *   Add the program that was just loaded and bound into 'binp' to the
+ *   program cache.  On success, the cache takes over binp->alloc[].
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_CACHE
+void elf_cache_add(FAR struct binary_s *binp,
+                   FAR struct elf_loadinfo_s *loadinfo);
+#endif
+
+/****************************************************************************
+ * Name: elf_cache_unload
+ *
+ * Description:
+ *   The ELF unload method.  Return the image of a program that ran from
+ *   the program cache to the cache.
+ *
+ * Returned Value:
+ *   0 (OK) is always returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_CACHE
+int elf_cache_unload(FAR struct binary_s *binp);
+#endif
+
 #endif /* __BINFMT_LIBELF_LIBELF_H */
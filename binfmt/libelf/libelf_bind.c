@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf_bind.c
  *
- *   Copyright (C) 2012, 2014, 2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2014, 2019, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -109,7 +109,7 @@ static inline int elf_readrels(FAR struct elf_loadinfo_s *loadinfo,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || index >= (relsec->sh_size / sizeof(Elf32_Rel)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
@@ -155,12 +155,31 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
   FAR dq_entry_t       *e;
   dq_queue_t            q;
   uintptr_t             addr;
+  int                   nrels;
+  int                   bufcount;
   int                   symidx;
   int                   ret;
   int                   i;
   int                   j;
 
-  rels = kmm_malloc(CONFIG_ELF_RELOCATION_BUFFERCOUNT * sizeof(Elf32_Rel));
+  /* Read the whole relocation table at once if it is not too large */
+
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  if (nrels == 0)
+    {
+      return OK;
+    }
+
+  if (relsec->sh_size <= CONFIG_ELF_TABLESIZE_MAX)
+    {
+      bufcount = nrels;
+    }
+  else
+    {
+      bufcount = CONFIG_ELF_RELOCATION_BUFFERCOUNT;
+    }
+
+  rels = kmm_malloc(bufcount * sizeof(Elf32_Rel));
   if (rels == NULL)
     {
       berr("Failed to allocate memory for elf relocation\n");
@@ -176,16 +195,15 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
   ret = OK;
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  for (i = j = 0; i < nrels; i++)
     {
       /* Read the relocation entry into memory */
 
-      rel = &rels[i % CONFIG_ELF_RELOCATION_BUFFERCOUNT];
+      rel = &rels[i % bufcount];
 
-      if (!(i % CONFIG_ELF_RELOCATION_BUFFERCOUNT))
+      if (!(i % bufcount))
         {
-          ret = elf_readrels(loadinfo, relsec, i, rels,
-                             CONFIG_ELF_RELOCATION_BUFFERCOUNT);
+          ret = elf_readrels(loadinfo, relsec, i, rels, bufcount);
           if (ret < 0)
             {
               berr("Section %d reloc %d: Failed to read relocation entry: %d\n",
@@ -362,6 +380,10 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return ret;
     }
 
+  /* Read the symbol and string tables into memory if possible */
+
+  elf_buffersymtab(loadinfo);
+
   /* Allocate an I/O buffer.  This buffer is used by elf_symname() to
    * accumulate the variable length symbol name.
    */
@@ -387,6 +409,14 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
     }
 #endif
 
+#ifdef CONFIG_SYMTAB_HASHED
+  /* Index the exported symbols for the duration of the binding.  Without
+   * the index, elf_symvalue() falls back to the search by name.
+   */
+
+  loadinfo->exphash = symtab_mkhash(exports, nexports);
+#endif
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -425,6 +455,11 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
         }
     }
 
+#ifdef CONFIG_SYMTAB_HASHED
+  symtab_freehash(loadinfo->exphash);
+  loadinfo->exphash = NULL;
+#endif
+
 #if defined(CONFIG_ARCH_ADDRENV)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
@@ -0,0 +1,451 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_cache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/elf.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/binfmt/binfmt.h>
+#include <nuttx/binfmt/elf.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached ELF program image.  The image is relocated for the addresses
+ * of its own .data and .bss, so it can only be used by one instance at a
+ * time.  'binp' is the binary using the image or NULL if it is idle.
+ */
+
+struct elf_cache_s
+{
+  FAR char *filename;                  /* Full path to the ELF file */
+  FAR const struct symtab_s *exports;  /* The symbol table it was bound to */
+  int nexports;                        /* The number of symbols in exports[] */
+  time_t mtime;                        /* Modification time of the file */
+  off_t size;                          /* Size of the file */
+  uint32_t lru;                        /* Time of last use */
+  FAR struct binary_s *binp;           /* The user of the image or NULL */
+
+  FAR void *alloc[BINFMT_NALLOC];      /* The cached allocations */
+  main_t entrypt;                      /* Entry point into the image */
+  FAR uint8_t *dataalloc;              /* .data/.bss in the image */
+  size_t datasize;                     /* Size of .data/.bss */
+  FAR uint8_t *pristine;               /* .data as it was after relocation */
+  size_t pristinesize;                 /* Size of pristine[] */
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  FAR binfmt_ctor_t *ctors;            /* Pointer to a list of constructors */
+  FAR binfmt_dtor_t *dtors;            /* Pointer to a list of destructors */
+  uint16_t nctors;                     /* Number of constructors in the list */
+  uint16_t ndtors;                     /* Number of destructors in the list */
+#endif
+#ifdef CONFIG_CXX_EXCEPTION
+  Elf32_Addr exidx;                    /* Exception index section */
+  Elf32_Word exidxsize;                /* Size of the exception index */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct elf_cache_s g_elf_cache[CONFIG_ELF_CACHE_NENTRIES];
+static sem_t g_elf_cache_sem = SEM_INITIALIZER(1);
+static uint32_t g_elf_cache_tick;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_evict
+ *
+ * Description:
+ *   Free an idle cache entry.
+ *
+ * Assumptions:
+ *   The caller holds g_elf_cache_sem.
+ *
+ ****************************************************************************/
+
+static void elf_cache_evict(FAR struct elf_cache_s *entry)
+{
+  int i;
+
+  DEBUGASSERT(entry->binp == NULL);
+  binfo("Evicting %s\n", entry->filename);
+
+  for (i = 0; i < BINFMT_NALLOC; i++)
+    {
+      if (entry->alloc[i] != NULL)
+        {
+          kumm_free(entry->alloc[i]);
+        }
+    }
+
+  if (entry->pristine != NULL)
+    {
+      kmm_free(entry->pristine);
+    }
+
+  kmm_free(entry->filename);
+  memset(entry, 0, sizeof(struct elf_cache_s));
+}
+
+/****************************************************************************
+ * Name: elf_cache_find
+ *
+ * Description:
+ *   Find the cache entry of the program 'binp->filename'.  Idle entries of
+ *   a program that has been modified since it was cached are evicted.
+ *
+ * Assumptions:
+ *   The caller holds g_elf_cache_sem.
+ *
+ ****************************************************************************/
+
+static FAR struct elf_cache_s *elf_cache_find(FAR struct binary_s *binp,
+                                              FAR const struct stat *buf)
+{
+  FAR struct elf_cache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      entry = &g_elf_cache[i];
+      if (entry->filename == NULL ||
+          strcmp(entry->filename, binp->filename) != 0)
+        {
+          continue;
+        }
+
+      if (entry->mtime == buf->st_mtime && entry->size == buf->st_size &&
+          entry->exports == binp->exports &&
+          entry->nexports == binp->nexports)
+        {
+          return entry;
+        }
+
+      /* The file was replaced or the program is bound to another symbol
+       * table.  The old image can not be used again.
+       */
+
+      if (entry->binp == NULL)
+        {
+          elf_cache_evict(entry);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_unload
+ *
+ * Description:
+ *   The ELF unload method, called by unload_module() when a program exits.
+ *   If the program ran from a cached image, run its destructors and return
+ *   the image to the cache.  The allocations are removed from binp->alloc[]
+ *   so that they are not freed.
+ *
+ ****************************************************************************/
+
+int elf_cache_unload(FAR struct binary_s *binp)
+{
+  FAR struct elf_cache_s *entry;
+  int i;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  int j;
+#endif
+
+  nxsem_wait_uninterruptible(&g_elf_cache_sem);
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      entry = &g_elf_cache[i];
+      if (entry->binp != binp)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+      /* The destructors must run before the image can be re-used.
+       * unload_module() would run them only after this function returns.
+       */
+
+      for (j = 0; j < binp->ndtors; j++)
+        {
+          binp->dtors[j]();
+        }
+
+      binp->ndtors = 0;
+#endif
+
+      memset(binp->alloc, 0, sizeof(binp->alloc));
+      entry->binp = NULL;
+      entry->lru  = ++g_elf_cache_tick;
+      break;
+    }
+
+  nxsem_post(&g_elf_cache_sem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: elf_cache_lookup
+ *
+ * Description:
+ *   Look for an idle, up-to-date image of 'binp->filename' in the cache.
+ *   If one is found, reset its .data and .bss to their initial state and
+ *   set up 'binp' to execute it.
+ *
+ * Returned Value:
+ *   0 (OK) is returned if the program was loaded from the cache; a negated
+ *   errno value is returned if it must be loaded from the file.
+ *
+ ****************************************************************************/
+
+int elf_cache_lookup(FAR struct binary_s *binp)
+{
+  FAR struct elf_cache_s *entry;
+  struct stat buf;
+  int ret;
+
+  ret = stat(binp->filename, &buf);
+  if (ret < 0)
+    {
+      return -ENOENT;
+    }
+
+  nxsem_wait_uninterruptible(&g_elf_cache_sem);
+
+  entry = elf_cache_find(binp, &buf);
+  if (entry == NULL)
+    {
+      ret = -ENOENT;
+      goto errout;
+    }
+
+  if (entry->binp != NULL)
+    {
+      /* Another instance is running from the image */
+
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  binfo("Loading %s from the cache\n", binp->filename);
+
+  /* Restore the relocated .data and clear everything after it */
+
+  memcpy(entry->dataalloc, entry->pristine, entry->pristinesize);
+  memset(entry->dataalloc + entry->pristinesize, 0,
+         entry->datasize - entry->pristinesize);
+
+#ifdef CONFIG_CXX_EXCEPTION
+  if (entry->exidxsize > 0)
+    {
+      up_init_exidx(entry->exidx, entry->exidxsize);
+    }
+#endif
+
+  binp->entrypt   = entry->entrypt;
+  binp->stacksize = CONFIG_ELF_STACKSIZE;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  binp->ctors     = entry->ctors;
+  binp->nctors    = entry->nctors;
+  binp->dtors     = entry->dtors;
+  binp->ndtors    = entry->ndtors;
+#endif
+
+  entry->binp     = binp;
+  entry->lru      = ++g_elf_cache_tick;
+  ret             = OK;
+
+errout:
+  nxsem_post(&g_elf_cache_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_cache_add
+ *
+ * Description:
+ *   Add the program that was just loaded into 'binp' to the cache.  The
+ *   least recently used idle image is evicted if the cache is full.  If
+ *   the program can not be cached, it is left alone and will be unloaded
+ *   normally.
+ *
+ *   The relocated .data is saved so that it can be restored when the
+ *   image is re-used.  This must be called after the program is bound but
+ *   before it runs.
+ *
+ ****************************************************************************/
+
+void elf_cache_add(FAR struct binary_s *binp,
+                   FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_cache_s *entry = NULL;
+  FAR uint8_t *data = (FAR uint8_t *)loadinfo->dataalloc;
+  struct stat buf;
+  size_t size;
+  int i;
+
+  if (stat(binp->filename, &buf) < 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_elf_cache_sem);
+
+  /* Do not cache a second copy of a program that is already cached */
+
+  if (elf_cache_find(binp, &buf) != NULL)
+    {
+      goto errout;
+    }
+
+  /* Use a free entry or the least recently used idle entry */
+
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      if (g_elf_cache[i].filename == NULL)
+        {
+          entry = &g_elf_cache[i];
+          break;
+        }
+
+      if (g_elf_cache[i].binp == NULL &&
+          (entry == NULL || (int32_t)(g_elf_cache[i].lru - entry->lru) < 0))
+        {
+          entry = &g_elf_cache[i];
+        }
+    }
+
+  if (entry == NULL)
+    {
+      goto errout;
+    }
+
+  if (entry->filename != NULL)
+    {
+      elf_cache_evict(entry);
+    }
+
+  /* Nothing after the last non-zero byte needs to be saved */
+
+  for (size = loadinfo->datasize; size > 0 && data[size - 1] == 0; size--)
+    {
+    }
+
+  entry->filename = (FAR char *)kmm_malloc(strlen(binp->filename) + 1);
+  if (entry->filename == NULL)
+    {
+      goto errout;
+    }
+
+  if (size > 0)
+    {
+      entry->pristine = (FAR uint8_t *)kmm_malloc(size);
+      if (entry->pristine == NULL)
+        {
+          kmm_free(entry->filename);
+          entry->filename = NULL;
+          goto errout;
+        }
+
+      memcpy(entry->pristine, data, size);
+    }
+
+  strcpy(entry->filename, binp->filename);
+  entry->exports      = binp->exports;
+  entry->nexports     = binp->nexports;
+  entry->mtime        = buf.st_mtime;
+  entry->size         = buf.st_size;
+  entry->lru          = ++g_elf_cache_tick;
+
+  entry->entrypt      = binp->entrypt;
+  entry->dataalloc    = data;
+  entry->datasize     = loadinfo->datasize;
+  entry->pristinesize = size;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  entry->ctors        = binp->ctors;
+  entry->nctors       = binp->nctors;
+  entry->dtors        = binp->dtors;
+  entry->ndtors       = binp->ndtors;
+#endif
+#ifdef CONFIG_CXX_EXCEPTION
+  i = elf_findsection(loadinfo, CONFIG_ELF_EXIDX_SECTNAME);
+  if (i >= 0)
+    {
+      entry->exidx     = loadinfo->shdr[i].sh_addr;
+      entry->exidxsize = loadinfo->shdr[i].sh_size;
+    }
+#endif
+
+  /* The cache now owns the allocations */
+
+  memcpy(entry->alloc, binp->alloc, sizeof(entry->alloc));
+  memset(binp->alloc, 0, sizeof(binp->alloc));
+
+  entry->binp = binp;
+
+  binfo("Cached %s\n", binp->filename);
+
+errout:
+  nxsem_post(&g_elf_cache_sem);
+}
+
+#endif /* CONFIG_ELF_CACHE */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf_init.c
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
 #include <string.h>
@@ -48,6 +49,7 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/binfmt/elf.h>
 
 #include "libelf.h"
@@ -170,6 +172,18 @@ int elf_init(FAR const char *filename, FAR struct elf_loadinfo_s *loadinfo)
       return ret;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* If the file lies in memory-mapped media, elf_read() and elf_load() can
+   * use the file in place.
+   */
+
+  if (ioctl(loadinfo->filfd, FIOC_MMAP,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = NULL;
+    }
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = elf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr, sizeof(Elf32_Ehdr), 0);
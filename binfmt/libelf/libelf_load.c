@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf_load.c
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -80,6 +81,75 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_xipsection
+ *
+ * Description:
+ *   Return true if the section can be used in place in the memory-mapped
+ *   file:  It must be read-only, properly aligned in place, and not be
+ *   modified by any relocations.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static bool elf_xipsection(FAR struct elf_loadinfo_s *loadinfo, int index)
+{
+  FAR Elf32_Shdr *shdr = &loadinfo->shdr[index];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == NULL || shdr->sh_type == SHT_NOBITS ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC)
+    {
+      return false;
+    }
+
+  addr = (uintptr_t)loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr & (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      if ((loadinfo->shdr[i].sh_type == SHT_REL ||
+           loadinfo->shdr[i].sh_type == SHT_RELA) &&
+          loadinfo->shdr[i].sh_info == index)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_checktls
+ *
+ * Description:
+ *   Thread-local (__thread) variables are not supported in loaded modules:
+ *   There is no per-thread copy of their sections.  Reject such modules
+ *   rather than failing on their TLS relocations later.
+ *
+ ****************************************************************************/
+
+static int elf_checktls(FAR struct elf_loadinfo_s *loadinfo)
+{
+  int i;
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      if ((loadinfo->shdr[i].sh_flags & SHF_TLS) != 0)
+        {
+          berr("ERROR: Section %d holds thread-local data\n", i);
+          return -ENOEXEC;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -111,6 +181,15 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
        * execution.
        */
 
+#ifdef CONFIG_ELF_XIP
+      /* Sections that are used in place need no memory */
+
+      if (elf_xipsection(loadinfo, i))
+        {
+          continue;
+        }
+#endif
+
       if ((shdr->sh_flags & SHF_ALLOC) != 0)
         {
           /* SHF_WRITE indicates that the section address space is write-
@@ -173,6 +252,20 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           continue;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Use read-only sections of a memory-mapped file in place */
+
+      if (elf_xipsection(loadinfo, i))
+        {
+          binfo("%d. %08lx->%08lx (XIP)\n", i,
+                (unsigned long)shdr->sh_addr,
+                (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+          shdr->sh_addr = (uintptr_t)(loadinfo->xipbase + shdr->sh_offset);
+          continue;
+        }
+#endif
+
       /* SHF_WRITE indicates that the section address space is write-
        * able
        */
@@ -263,6 +356,12 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+  ret = elf_checktls(loadinfo);
+  if (ret < 0)
+    {
+      goto errout_with_buffers;
+    }
+
   /* Determine total size to allocate */
 
   elf_elfsize(loadinfo);
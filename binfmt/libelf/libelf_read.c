@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf_read.c
  *
- *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -117,6 +117,23 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
 
+#ifdef CONFIG_ELF_XIP
+  /* If the file is memory-mapped, just copy the data */
+
+  if (loadinfo->xipbase != NULL)
+    {
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
+        {
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, loadinfo->xipbase + offset, readsize);
+      return OK;
+    }
+#endif
+
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf_symbols.c
  *
- *   Copyright (C) 2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -44,6 +44,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -96,6 +97,44 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+  /* If the string table was buffered, just copy the name */
+
+  if (loadinfo->strtab != NULL)
+    {
+      FAR const uint8_t *name;
+      size_t maxlen;
+
+      maxlen = loadinfo->shdr[loadinfo->strtabidx].sh_size;
+      if (sym->st_name >= maxlen)
+        {
+          berr("Symbol name out of range\n");
+          return -EINVAL;
+        }
+
+      name    = &loadinfo->strtab[sym->st_name];
+      maxlen -= sym->st_name;
+      buffer  = memchr(name, '\0', maxlen);
+      if (buffer == NULL)
+        {
+          berr("Symbol name is not terminated\n");
+          return -EINVAL;
+        }
+
+      readlen = buffer - name + 1;
+      if (readlen > loadinfo->buflen)
+        {
+          ret = elf_reallocbuffer(loadinfo, readlen - loadinfo->buflen);
+          if (ret < 0)
+            {
+              berr("elf_reallocbuffer failed: %d\n", ret);
+              return ret;
+            }
+        }
+
+      memcpy(loadinfo->iobuffer, name, readlen);
+      return OK;
+    }
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -197,6 +236,68 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: elf_buffersymtab
+ *
+ * Description:
+ *   Read the symbol and string tables into memory if they are no larger
+ *   than CONFIG_ELF_TABLESIZE_MAX.  After this, elf_readsym() and
+ *   elf_symvalue() do not access the file anymore.  Failure to buffer the
+ *   tables is not an error:  They are then read piecewise.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void elf_buffersymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int ret;
+
+#ifdef CONFIG_ELF_XIP
+  /* Reads from memory-mapped media are already just a memcpy() */
+
+  if (loadinfo->xipbase != NULL)
+    {
+      return;
+    }
+#endif
+
+  if (loadinfo->symtab == NULL && symtab->sh_size > 0 &&
+      symtab->sh_size <= CONFIG_ELF_TABLESIZE_MAX)
+    {
+      loadinfo->symtab = (FAR Elf32_Sym *)kmm_malloc(symtab->sh_size);
+      if (loadinfo->symtab != NULL)
+        {
+          ret = elf_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                         symtab->sh_size, symtab->sh_offset);
+          if (ret < 0)
+            {
+              kmm_free(loadinfo->symtab);
+              loadinfo->symtab = NULL;
+            }
+        }
+    }
+
+  if (loadinfo->strtab == NULL && strtab->sh_size > 0 &&
+      strtab->sh_size <= CONFIG_ELF_TABLESIZE_MAX)
+    {
+      loadinfo->strtab = (FAR uint8_t *)kmm_malloc(strtab->sh_size);
+      if (loadinfo->strtab != NULL)
+        {
+          ret = elf_read(loadinfo, loadinfo->strtab, strtab->sh_size,
+                         strtab->sh_offset);
+          if (ret < 0)
+            {
+              kmm_free(loadinfo->strtab);
+              loadinfo->strtab = NULL;
+            }
+        }
+    }
+}
+
 /****************************************************************************
  * Name: elf_readsym
  *
@@ -222,12 +323,20 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf32_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf32_Sym)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+  /* Use the buffered symbol table if there is one */
+
+  if (loadinfo->symtab != NULL)
+    {
+      *sym = loadinfo->symtab[index];
+      return OK;
+    }
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf32_Sym) * index;
@@ -304,7 +413,12 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
 
         /* Check if the base code exports a symbol of this name */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_HASHED)
+        symbol = symtab_findbyhash(exports, loadinfo->exphash,
+                                   (FAR char *)loadinfo->iobuffer,
+                                   symtab_hash((FAR char *)loadinfo->iobuffer),
+                                   nexports);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
         symbol = symtab_findorderedbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
 #else
         symbol = symtab_findbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
@@ -1,7 +1,7 @@
 /****************************************************************************
  * binfmt/libelf/libelf_uninit.c
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -122,5 +122,17 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+  if (loadinfo->symtab)
+    {
+      kmm_free((FAR void *)loadinfo->symtab);
+      loadinfo->symtab    = NULL;
+    }
+
+  if (loadinfo->strtab)
+    {
+      kmm_free((FAR void *)loadinfo->strtab);
+      loadinfo->strtab    = NULL;
+    }
+
   return OK;
 }
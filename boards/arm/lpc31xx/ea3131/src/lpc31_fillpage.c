@@ -1,8 +1,8 @@
 /****************************************************************************
  * boards/arm/lpc31xx/ea3131/src/lpc31_fillpage.c
  *
- *   Copyright (C) 2010, 2012-2013, 20172018 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2010, 2012-2013, 2017-2018, 2020 Gregory Nutt. All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -419,7 +419,8 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
 #endif
 
   pginfo("TCB: %p vpage: %p far: %08x\n", tcb, vpage, tcb->xcp.far);
-  DEBUGASSERT(tcb->xcp.far >= PG_PAGED_VBASE && tcb->xcp.far < PG_PAGED_VEND);
+  DEBUGASSERT((uintptr_t)vpage >= PG_PAGED_VBASE &&
+              (uintptr_t)vpage < PG_PAGED_VEND);
 
   /* If BINPATH is defined, then it is the full path to a file on a mounted
    * file system.  In this case initialization will be deferred until the
@@ -433,10 +434,13 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
   lpc31_initsrc();
 
   /* Create an offset into the binary image that corresponds to the
-   * virtual address.   File offset 0 corresponds to PG_LOCKED_VBASE.
+   * virtual address of the page.  File offset 0 corresponds to
+   * PG_LOCKED_VBASE.  The address of the page is used, not the fault
+   * address in the TCB:  That fault may be for a different page when
+   * pages are prefetched.
    */
 
-  offset = (off_t)tcb->xcp.far - PG_LOCKED_VBASE;
+  offset = (off_t)((uintptr_t)vpage - PG_LOCKED_VBASE);
 
   /* Seek to that position */
 
@@ -456,10 +460,14 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
   lpc31_initsrc();
 
   /* Create an offset into the binary image that corresponds to the
-   * virtual address.   File offset 0 corresponds to PG_LOCKED_VBASE.
+   * virtual address of the page.  File offset 0 corresponds to
+   * PG_LOCKED_VBASE.  The address of the page is used, not the fault
+   * address in the TCB:  That fault may be for a different page when
+   * pages are prefetched.
    */
 
-  offset = (off_t)tcb->xcp.far - PG_LOCKED_VBASE + CONFIG_EA3131_PAGING_BINOFFSET;
+  offset = (off_t)((uintptr_t)vpage - PG_LOCKED_VBASE) +
+           CONFIG_EA3131_PAGING_BINOFFSET;
 
   /* Read the page at the correct offset into the SPI FLASH device */
 
@@ -483,7 +491,8 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage,
                 up_pgcallback_t pg_callback)
 {
   pginfo("TCB: %p vpage: %d far: %08x\n", tcb, vpage, tcb->xcp.far);
-  DEBUGASSERT(tcb->xcp.far >= PG_PAGED_VBASE && tcb->xcp.far < PG_PAGED_VEND);
+  DEBUGASSERT((uintptr_t)vpage >= PG_PAGED_VBASE &&
+              (uintptr_t)vpage < PG_PAGED_VEND);
 
 #if defined(CONFIG_PAGING_BINPATH)
 #  error "File system-based paging must always be implemented with blocking calls"
@@ -1,7 +1,7 @@
 /****************************************************************************
  * crypto/cryptodev.c
  *
- *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author:  Max Nekludov <macscomp@gmail.com>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -33,6 +33,7 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -46,20 +47,59 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
 #include <nuttx/crypto/cryptodev.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+/* Without AES hardware, the sessions keep the expanded key schedule of the
+ * software AES library.  Otherwise the operations go to the AES engine
+ * through aes_cypher().
+ */
+
+#if defined(CONFIG_CRYPTO_SW_AES) && !defined(CONFIG_ARCH_HAVE_CRYPTO_AES)
+#  define CRYPTODEV_HAVE_SCHEDULE 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One session */
+
+struct cryptodev_session_s
+{
+  uint32_t cipher;                /* CRYPTO_AES_*, zero if not in use */
+  uint32_t keylen;                /* The length of the key in bytes */
+  uint8_t key[AES256_KEY_SIZE];   /* A copy of the key */
+#ifdef CRYPTODEV_HAVE_SCHEDULE
+  struct aes_state_s state;       /* The expanded key schedule */
+#endif
+};
+
+/* The state of one open file.  Sessions belong to the open file. */
+
+struct cryptodev_file_s
+{
+  sem_t cf_exclsem;               /* Mutual exclusion */
+  struct cryptodev_session_s cf_ses[CONFIG_CRYPTO_CRYPTODEV_NSESSIONS];
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  struct work_s cf_work;          /* Processes cf_mop */
+  sem_t cf_donesem;               /* Posted when the close must not wait */
+  FAR struct crypt_mop *cf_mop;   /* The submitted asynchronous batch */
+  FAR struct pollfd *cf_fds;      /* The poll waiter */
+  bool cf_done;                   /* cf_mop has been processed */
+  bool cf_closing;                /* The close waits for cf_mop */
 #endif
+};
 
 /****************************************************************************
  * Private Function Prototypes
@@ -67,12 +107,18 @@
 
 /* Character driver methods */
 
+static int     cryptodev_open(FAR struct file *filep);
+static int     cryptodev_close(FAR struct file *filep);
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
                                size_t len);
-static int cryptodev_ioctl(FAR struct file *filep, int cmd,
-                           unsigned long arg);
+static int     cryptodev_ioctl(FAR struct file *filep, int cmd,
+                               unsigned long arg);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int     cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                              bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -80,13 +126,17 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd,
 
 static const struct file_operations g_cryptodevops =
 {
-  NULL,               /* open   */
-  NULL,               /* close  */
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   NULL,               /* seek   */
   cryptodev_ioctl,    /* ioctl  */
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_poll      /* poll   */
+#else
   NULL                /* poll   */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL              /* unlink */
 #endif
@@ -96,6 +146,342 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_getsession
+ *
+ * Description:
+ *   Return the session with the ID 'ses' or NULL if there is none.
+ *   Session IDs are the index in cf_ses[] plus one.
+ *
+ ****************************************************************************/
+
+static FAR struct cryptodev_session_s *
+cryptodev_getsession(FAR struct cryptodev_file_s *cf, uint32_t ses)
+{
+  if (ses < 1 || ses > CONFIG_CRYPTO_CRYPTODEV_NSESSIONS ||
+      cf->cf_ses[ses - 1].cipher == 0)
+    {
+      return NULL;
+    }
+
+  return &cf->cf_ses[ses - 1];
+}
+
+/****************************************************************************
+ * Name: cryptodev_newsession
+ *
+ * Description:
+ *   Handle CIOCGSESSION:  Allocate a session, copy the key and, with the
+ *   software AES library, expand the key schedule once for all of the
+ *   operations of the session.
+ *
+ ****************************************************************************/
+
+static int cryptodev_newsession(FAR struct cryptodev_file_s *cf,
+                                FAR struct session_op *sop)
+{
+  FAR struct cryptodev_session_s *ses;
+  int i;
+
+  switch (sop->cipher)
+    {
+#ifdef CONFIG_CRYPTO_AES
+      case CRYPTO_AES_ECB:
+      case CRYPTO_AES_CBC:
+      case CRYPTO_AES_CTR:
+        break;
+#endif
+
+      default:
+        return -EINVAL;
+    }
+
+  /* MACs are not supported */
+
+  if (sop->mac != 0 || sop->key == NULL ||
+      (sop->keylen != AES128_KEY_SIZE && sop->keylen != AES192_KEY_SIZE &&
+       sop->keylen != AES256_KEY_SIZE))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NSESSIONS; i++)
+    {
+      if (cf->cf_ses[i].cipher == 0)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_CRYPTO_CRYPTODEV_NSESSIONS)
+    {
+      return -ENOMEM;
+    }
+
+  ses         = &cf->cf_ses[i];
+  ses->keylen = sop->keylen;
+  memcpy(ses->key, sop->key, sop->keylen);
+
+#ifdef CRYPTODEV_HAVE_SCHEDULE
+  if (aes_setupkey(&ses->state, ses->key, ses->keylen) < 0)
+    {
+      memset(ses, 0, sizeof(*ses));
+      return -EINVAL;
+    }
+#endif
+
+  ses->cipher = sop->cipher;
+  sop->ses    = i + 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_crypt
+ *
+ * Description:
+ *   Perform one operation.
+ *
+ ****************************************************************************/
+
+static int cryptodev_crypt(FAR struct cryptodev_file_s *cf,
+                           FAR struct crypt_op *op)
+{
+#ifdef CONFIG_CRYPTO_AES
+  FAR struct cryptodev_session_s *ses;
+  int encrypt;
+  int mode;
+
+  ses = cryptodev_getsession(cf, op->ses);
+  if (ses == NULL)
+    {
+      return -EINVAL;
+    }
+
+  switch (op->op)
+    {
+      case COP_ENCRYPT:
+        encrypt = CYPHER_ENCRYPT;
+        break;
+
+      case COP_DECRYPT:
+        encrypt = CYPHER_DECRYPT;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  switch (ses->cipher)
+    {
+      case CRYPTO_AES_ECB:
+        mode = AES_MODE_ECB;
+        break;
+
+      case CRYPTO_AES_CBC:
+        mode = AES_MODE_CBC;
+        break;
+
+      case CRYPTO_AES_CTR:
+        mode = AES_MODE_CTR;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+#ifdef CRYPTODEV_HAVE_SCHEDULE
+  return aes_state_cypher(&ses->state, op->dst, op->src, op->len, op->iv,
+                          mode, encrypt);
+#else
+  return aes_cypher(op->dst, op->src, op->len, op->iv, ses->key,
+                    ses->keylen, mode, encrypt);
+#endif
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: cryptodev_cryptm
+ *
+ * Description:
+ *   Perform a batch of operations.  The result of each operation is
+ *   returned in its status field.
+ *
+ ****************************************************************************/
+
+static void cryptodev_cryptm(FAR struct cryptodev_file_s *cf,
+                             FAR struct crypt_mop *mop)
+{
+  uint32_t i;
+
+  for (i = 0; i < mop->count; i++)
+    {
+      mop->reqs[i].status = cryptodev_crypt(cf, &mop->reqs[i]);
+    }
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/****************************************************************************
+ * Name: cryptodev_worker
+ *
+ * Description:
+ *   Process an asynchronous batch on the low priority work queue and
+ *   report the completion to the poll waiter.
+ *
+ ****************************************************************************/
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct cryptodev_file_s *cf = (FAR struct cryptodev_file_s *)arg;
+
+  nxsem_wait_uninterruptible(&cf->cf_exclsem);
+
+  if (!cf->cf_closing)
+    {
+      cryptodev_cryptm(cf, cf->cf_mop);
+    }
+
+  cf->cf_done = true;
+
+  if (cf->cf_fds != NULL)
+    {
+      cf->cf_fds->revents |= (cf->cf_fds->events & POLLIN);
+      if (cf->cf_fds->revents != 0)
+        {
+          nxsem_post(cf->cf_fds->sem);
+        }
+    }
+
+  if (cf->cf_closing)
+    {
+      nxsem_post(&cf->cf_donesem);
+    }
+
+  nxsem_post(&cf->cf_exclsem);
+}
+
+/****************************************************************************
+ * Name: cryptodev_submit
+ *
+ * Description:
+ *   Handle CIOCCRYPTM with CRYPTO_MOP_F_ASYNC.  Only one batch may be
+ *   outstanding per open file.
+ *
+ ****************************************************************************/
+
+static int cryptodev_submit(FAR struct cryptodev_file_s *cf,
+                            FAR struct crypt_mop *mop)
+{
+  int ret;
+
+  if (cf->cf_mop != NULL)
+    {
+      return -EBUSY;
+    }
+
+  cf->cf_mop  = mop;
+  cf->cf_done = false;
+
+  ret = work_queue(LPWORK, &cf->cf_work, cryptodev_worker, cf, 0);
+  if (ret < 0)
+    {
+      cf->cf_mop = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cryptodev_retrieve
+ *
+ * Description:
+ *   Handle CIOCCRYPTMRET:  Return the completed asynchronous batch.
+ *
+ ****************************************************************************/
+
+static int cryptodev_retrieve(FAR struct cryptodev_file_s *cf,
+                              FAR struct crypt_mop **mop)
+{
+  if (cf->cf_mop == NULL)
+    {
+      return -ENOENT;
+    }
+
+  if (!cf->cf_done)
+    {
+      return -EAGAIN;
+    }
+
+  *mop       = cf->cf_mop;
+  cf->cf_mop = NULL;
+  return OK;
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
+/****************************************************************************
+ * Name: cryptodev_open
+ ****************************************************************************/
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *cf;
+
+  cf = (FAR struct cryptodev_file_s *)
+    kmm_zalloc(sizeof(struct cryptodev_file_s));
+  if (cf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&cf->cf_exclsem, 0, 1);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxsem_init(&cf->cf_donesem, 0, 0);
+  nxsem_setprotocol(&cf->cf_donesem, SEM_PRIO_NONE);
+#endif
+
+  filep->f_priv = cf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_close
+ ****************************************************************************/
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *cf = filep->f_priv;
+
+  nxsem_wait_uninterruptible(&cf->cf_exclsem);
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* If a batch is still outstanding and the worker can no longer be
+   * cancelled, the worker is about to run.  Let it finish.
+   */
+
+  if (cf->cf_mop != NULL && !cf->cf_done &&
+      work_cancel(LPWORK, &cf->cf_work) < 0)
+    {
+      cf->cf_closing = true;
+      nxsem_post(&cf->cf_exclsem);
+      nxsem_wait_uninterruptible(&cf->cf_donesem);
+      nxsem_wait_uninterruptible(&cf->cf_exclsem);
+    }
+
+  nxsem_destroy(&cf->cf_donesem);
+#endif
+
+  nxsem_post(&cf->cf_exclsem);
+  nxsem_destroy(&cf->cf_exclsem);
+
+  /* Do not leave the keys in the heap */
+
+  memset(cf, 0, sizeof(*cf));
+  kmm_free(cf);
+  filep->f_priv = NULL;
+  return OK;
+}
+
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len)
 {
@@ -108,64 +494,139 @@ static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
   return -EACCES;
 }
 
+/****************************************************************************
+ * Name: cryptodev_ioctl
+ ****************************************************************************/
+
 static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
-  switch (cmd)
-  {
-  case CIOCGSESSION:
-    {
-      FAR struct session_op *ses = (FAR struct session_op *)arg;
-      ses->ses = (uint32_t)ses;
-      return OK;
-    }
+  FAR struct cryptodev_file_s *cf = filep->f_priv;
+  FAR struct cryptodev_session_s *ses;
+  int ret;
 
-  case CIOCFSESSION:
+  ret = nxsem_wait(&cf->cf_exclsem);
+  if (ret < 0)
     {
-      return OK;
+      return ret;
     }
 
-#ifdef CONFIG_CRYPTO_AES
-  case CIOCCRYPT:
+  switch (cmd)
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      case CIOCGSESSION:
+        ret = cryptodev_newsession(cf, (FAR struct session_op *)arg);
+        break;
 
-      switch (op->op)
-        {
-        case COP_ENCRYPT:
-          encrypt = 1;
-          break;
+      case CIOCFSESSION:
+        ses = cryptodev_getsession(cf, *(FAR uint32_t *)arg);
+        if (ses == NULL)
+          {
+            ret = -EINVAL;
+            break;
+          }
 
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
+        memset(ses, 0, sizeof(*ses));
+        break;
 
-        default:
-          return -EINVAL;
+      case CIOCCRYPT:
+        ret = cryptodev_crypt(cf, (FAR struct crypt_op *)arg);
+        break;
+
+      case CIOCCRYPTM:
+        {
+          FAR struct crypt_mop *mop = (FAR struct crypt_mop *)arg;
+
+          if (mop->count > 0 && mop->reqs == NULL)
+            {
+              ret = -EINVAL;
+            }
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+          else if ((mop->flags & CRYPTO_MOP_F_ASYNC) != 0)
+            {
+              ret = cryptodev_submit(cf, mop);
+            }
+#endif
+          else
+            {
+              cryptodev_cryptm(cf, mop);
+            }
         }
+        break;
 
-      switch (ses->cipher)
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCCRYPTMRET:
+        ret = cryptodev_retrieve(cf, (FAR struct crypt_mop **)arg);
+        break;
+#endif
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxsem_post(&cf->cf_exclsem);
+  return ret;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/****************************************************************************
+ * Name: cryptodev_poll
+ *
+ * Description:
+ *   POLLIN is reported when the asynchronous batch has completed.  POLLOUT
+ *   is reported when no batch is outstanding.
+ *
+ ****************************************************************************/
+
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct cryptodev_file_s *cf = filep->f_priv;
+  int ret;
+
+  ret = nxsem_wait(&cf->cf_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      if (cf->cf_fds != NULL)
         {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
+          ret = -EBUSY;
+          goto errout;
+        }
 
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+      cf->cf_fds = fds;
+      fds->priv  = &cf->cf_fds;
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+      /* Report the events that are already pending */
 
-        default:
-           return -EINVAL;
+      if (cf->cf_mop == NULL)
+        {
+          fds->revents |= (fds->events & POLLOUT);
+        }
+      else if (cf->cf_done)
+        {
+          fds->revents |= (fds->events & POLLIN);
+        }
+
+      if (fds->revents != 0)
+        {
+          nxsem_post(fds->sem);
         }
     }
-#endif
+  else if (fds->priv != NULL)
+    {
+      cf->cf_fds = NULL;
+      fds->priv  = NULL;
+    }
 
-  default:
-    return -ENOTTY;
-  }
+errout:
+  nxsem_post(&cf->cf_exclsem);
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -49,6 +49,8 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 
@@ -65,6 +67,30 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  ifdef CONFIG_SMP
+#    define RNG_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define RNG_NCPUS 1
+#  endif
+
+/* Requests up to this size are served by one ChaCha20 block of the per-CPU
+ * generator.  Larger requests use up_rngbulk().
+ */
+
+#  define RNG_CPU_BUFSIZE 32
+
+#  define CHACHA20_QR(a,b,c,d) \
+     do \
+       { \
+         a += b; d ^= a; d = ROTL_32(d, 16); \
+         c += d; b ^= c; b = ROTL_32(b, 12); \
+         a += b; d ^= a; d = ROTL_32(d, 8); \
+         c += d; b ^= c; b = ROTL_32(b, 7); \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -90,9 +116,30 @@ struct rng_s
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  volatile uint32_t rd_epoch; /* Incremented on each reseed from the pool */
+#endif
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* The per-CPU output generator.  This is a ChaCha20 "fast key erasure"
+ * generator:  Each ChaCha20 block replaces the key with its first half and
+ * outputs its second half, so earlier output cannot be recovered from the
+ * state.  It is only accessed by its CPU with local interrupts disabled.
+ */
+
+struct rng_cpu_s
+{
+  uint32_t key[8];              /* ChaCha20 key */
+  uint8_t buf[RNG_CPU_BUFSIZE]; /* Unused output of the last block */
+  uint8_t avail;                /* Bytes available at the end of buf */
+  uint32_t epoch;               /* g_rng.rd_epoch at the last seeding */
+  uint32_t nbytes;              /* Bytes output since the last seeding */
+  clock_t seedtime;             /* Time of the last seeding */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -108,6 +155,10 @@ enum
 
 static struct rng_s g_rng;
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_cpu_s g_rng_cpu[RNG_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -314,6 +365,15 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  /* Have the per-CPU generators reseed.  Zero means never seeded. */
+
+  if (++g_rng.rd_epoch == 0)
+    {
+      g_rng.rd_epoch = 1;
+    }
+#endif
 }
 
 static void rng_buf_internal(FAR void *bytes, size_t nbytes)
@@ -366,6 +426,183 @@ static void rng_buf_internal(FAR void *bytes, size_t nbytes)
     }
 }
 
+/****************************************************************************
+ * Name: rng_lock
+ *
+ * Description:
+ *   Take exclusive access to the entropy pool and its BLAKE2Xs generator.
+ *
+ ****************************************************************************/
+
+static void rng_lock(void)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&g_rng.rd_sem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+
+/****************************************************************************
+ * Name: chacha20_block
+ *
+ * Description:
+ *   Compute one ChaCha20 block with a 64-bit block counter and a zero
+ *   nonce.
+ *
+ ****************************************************************************/
+
+static void chacha20_block(FAR const uint32_t *key, uint64_t counter,
+                           FAR uint32_t *out)
+{
+  uint32_t x[16];
+  int i;
+
+  x[0]  = 0x61707865; /* "expand 32-byte k" */
+  x[1]  = 0x3320646e;
+  x[2]  = 0x79622d32;
+  x[3]  = 0x6b206574;
+  memcpy(&x[4], key, 8 * sizeof(uint32_t));
+  x[12] = (uint32_t)counter;
+  x[13] = (uint32_t)(counter >> 32);
+  x[14] = 0;
+  x[15] = 0;
+
+  memcpy(out, x, sizeof(x));
+
+  for (i = 0; i < 10; i++)
+    {
+      CHACHA20_QR(out[0], out[4], out[8],  out[12]);
+      CHACHA20_QR(out[1], out[5], out[9],  out[13]);
+      CHACHA20_QR(out[2], out[6], out[10], out[14]);
+      CHACHA20_QR(out[3], out[7], out[11], out[15]);
+      CHACHA20_QR(out[0], out[5], out[10], out[15]);
+      CHACHA20_QR(out[1], out[6], out[11], out[12]);
+      CHACHA20_QR(out[2], out[7], out[8],  out[13]);
+      CHACHA20_QR(out[3], out[4], out[9],  out[14]);
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      out[i] += x[i];
+    }
+
+  explicit_bzero(x, sizeof(x));
+}
+
+/****************************************************************************
+ * Name: rng_cpu_reseed
+ *
+ * Description:
+ *   Reseed the generator of this CPU from the BLAKE2Xs generator if it was
+ *   never seeded, if the pool was reseeded since, or if it has produced
+ *   CONFIG_CRYPTO_RANDOM_POOL_RESEED_BYTES bytes or is older than
+ *   CONFIG_CRYPTO_RANDOM_POOL_RESEED_SEC seconds.
+ *
+ *   The state is sampled without protection.  At worst, a CPU that the
+ *   caller migrated to is seeded once more.
+ *
+ ****************************************************************************/
+
+static void rng_cpu_reseed(void)
+{
+  FAR struct rng_cpu_s *cpu = &g_rng_cpu[up_cpu_index()];
+  uint32_t seed[8];
+  irqstate_t flags;
+  uint32_t epoch;
+  int i;
+
+  if (cpu->epoch != 0 && cpu->epoch == g_rng.rd_epoch &&
+      cpu->nbytes < CONFIG_CRYPTO_RANDOM_POOL_RESEED_BYTES &&
+      clock_systimer() - cpu->seedtime <
+      SEC2TICK(CONFIG_CRYPTO_RANDOM_POOL_RESEED_SEC))
+    {
+      return;
+    }
+
+  rng_lock();
+  rng_buf_internal(seed, sizeof(seed));
+  epoch = g_rng.rd_epoch;
+  nxsem_post(&g_rng.rd_sem);
+
+  /* Mix the seed into the key of the CPU that we are running on now */
+
+  flags = up_irq_save();
+  cpu   = &g_rng_cpu[up_cpu_index()];
+
+  for (i = 0; i < 8; i++)
+    {
+      cpu->key[i] ^= seed[i];
+    }
+
+  explicit_bzero(cpu->buf, sizeof(cpu->buf));
+  cpu->avail    = 0;
+  cpu->epoch    = epoch;
+  cpu->nbytes   = 0;
+  cpu->seedtime = clock_systimer();
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+
+/****************************************************************************
+ * Name: rng_cpu_extract
+ *
+ * Description:
+ *   Take up to RNG_CPU_BUFSIZE random bytes from the generator of this CPU.
+ *   No lock is taken:  The generator is private to the CPU and local
+ *   interrupts are disabled for the duration of one ChaCha20 block at
+ *   most.
+ *
+ ****************************************************************************/
+
+static void rng_cpu_extract(FAR void *bytes, size_t nbytes)
+{
+  FAR struct rng_cpu_s *cpu;
+  uint32_t block[16];
+  irqstate_t flags;
+
+  DEBUGASSERT(nbytes <= RNG_CPU_BUFSIZE);
+
+  flags = up_irq_save();
+  cpu   = &g_rng_cpu[up_cpu_index()];
+
+  if (cpu->avail < nbytes)
+    {
+      /* Refill:  The first half of the block is the next key, the second
+       * half is output.
+       */
+
+      chacha20_block(cpu->key, 0, block);
+      memcpy(cpu->key, &block[0], sizeof(cpu->key));
+      memcpy(cpu->buf, &block[8], sizeof(cpu->buf));
+      cpu->avail = RNG_CPU_BUFSIZE;
+      explicit_bzero(block, sizeof(block));
+    }
+
+  /* Use the bytes at the end of the buffer and erase them */
+
+  cpu->avail -= nbytes;
+  memcpy(bytes, &cpu->buf[cpu->avail], nbytes);
+  explicit_bzero(&cpu->buf[cpu->avail], nbytes);
+  cpu->nbytes += nbytes;
+
+  up_irq_restore(flags);
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_PERCPU */
+
 static void rng_init(void)
 {
   cryptinfo("Initializing RNG\n");
@@ -500,21 +737,7 @@ void up_rngaddentropy(enum rnd_source_t kindof, FAR const uint32_t *buf,
 
 void up_rngreseed(void)
 {
-  int ret;
-
-  do
-    {
-      /* Take the semaphore (perhaps waiting) */
-
-      ret = nxsem_wait(&g_rng.rd_sem);
-
-      /* The only case that an error should occur here is if the wait was
-       * awakened by a signal.
-       */
-
-      DEBUGASSERT(ret == OK || ret == -EINTR);
-    }
-  while (ret == -EINTR);
+  rng_lock();
 
   if (g_rng.rd_newentr >= MIN_SEED_NEW_ENTROPY_WORDS)
     {
@@ -563,22 +786,66 @@ void up_randompool_initialize(void)
 
 void getrandom(FAR void *bytes, size_t nbytes)
 {
-  int ret;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  /* The pool lock is only taken when this CPU's generator must reseed */
 
-  do
+  if (nbytes > RNG_CPU_BUFSIZE)
     {
-      /* Take the semaphore (perhaps waiting) */
+      up_rngbulk(bytes, nbytes);
+    }
+  else
+    {
+      rng_cpu_reseed();
+      rng_cpu_extract(bytes, nbytes);
+    }
+#else
+  rng_lock();
+  rng_buf_internal(bytes, nbytes);
+  nxsem_post(&g_rng.rd_sem);
+#endif
+}
 
-      ret = nxsem_wait(&g_rng.rd_sem);
+/****************************************************************************
+ * Name: up_rngbulk
+ *
+ * Description:
+ *   Fill a large buffer with randomness.  A one-time ChaCha20 key is taken
+ *   from the generator of this CPU.  The buffer is then filled with that
+ *   key, outside of any lock and with interrupts enabled.  getrandom()
+ *   uses this for all requests of more than 32 bytes.
+ *
+ * Input Parameters:
+ *   bytes  - Buffer for returned random bytes
+ *   nbytes - Number of bytes requested.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      /* The only case that an error should occur here is if the wait was
-       * awakened by a signal.
-       */
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+void up_rngbulk(FAR void *bytes, size_t nbytes)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)bytes;
+  uint32_t key[8];
+  uint32_t block[16];
+  uint64_t counter;
+  size_t n;
 
-      DEBUGASSERT(ret == OK || ret == -EINTR);
+  rng_cpu_reseed();
+  rng_cpu_extract(key, sizeof(key));
+
+  for (counter = 0; nbytes > 0; counter++)
+    {
+      chacha20_block(key, counter, block);
+
+      n = MIN(nbytes, sizeof(block));
+      memcpy(dest, block, n);
+      dest   += n;
+      nbytes -= n;
     }
-  while (ret == -EINTR);
 
-  rng_buf_internal(bytes, nbytes);
-  nxsem_post(&g_rng.rd_sem);
+  explicit_bzero(block, sizeof(block));
+  explicit_bzero(key, sizeof(key));
 }
+#endif
@@ -1,7 +1,7 @@
 /****************************************************************************
  * crypto/testmngr.c
  *
- *   Copyright (C) 2014-2015 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014-2015, 2020 Gregory Nutt. All rights reserved.
  *   Author:  Max Nekludov <macscomp@gmail.com>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -49,6 +49,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -83,6 +84,57 @@ static int do_test_aes(FAR struct cipher_testvec *test, int mode, int encrypt)
   return res;
 }
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+static int do_test_aes_gcm(FAR struct aead_testvec *test)
+{
+  struct aes_state_s state;
+  uint8_t tag[AES_BLOCK_SIZE];
+  FAR uint8_t *out;
+  int res;
+
+  out = kmm_zalloc(test->ilen);
+  if (out == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  res = aes_setupkey(&state, (FAR const uint8_t *)test->key, test->klen);
+  if (res == OK)
+    {
+      res = aes_gcm_encrypt(&state, (FAR const uint8_t *)test->iv,
+                            test->ivlen, (FAR const uint8_t *)test->assoc,
+                            test->alen, (FAR const uint8_t *)test->input,
+                            out, test->ilen, tag, sizeof(tag));
+    }
+
+  if (res == OK)
+    {
+      if (memcmp(out, test->result, test->ilen) != 0 ||
+          memcmp(tag, test->tag, sizeof(tag)) != 0)
+        {
+          res = -1;
+        }
+    }
+
+  if (res == OK)
+    {
+      res = aes_gcm_decrypt(&state, (FAR const uint8_t *)test->iv,
+                            test->ivlen, (FAR const uint8_t *)test->assoc,
+                            test->alen, (FAR const uint8_t *)test->result,
+                            out, test->ilen, (FAR const uint8_t *)test->tag,
+                            sizeof(tag));
+      if (res == OK && memcmp(out, test->input, test->ilen) != 0)
+        {
+          res = -1;
+        }
+    }
+
+  memset(&state, 0, sizeof(state));
+  kmm_free(out);
+  return res;
+}
+#endif
+
 #define AES_CYPHER_TEST_ENCRYPT(mode, mode_str, count, template) \
   for (i = 0; i < count; i++) { \
     if (do_test_aes(template + i, mode, CYPHER_ENCRYPT)) { \
@@ -117,6 +169,17 @@ static int test_aes(void)
                   ARRAY_SIZE(aes_ctr_dec_tv_template),
                   aes_ctr_enc_tv_template, aes_ctr_dec_tv_template)
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+  for (i = 0; i < ARRAY_SIZE(aes_gcm_tv_template); i++)
+    {
+      if (do_test_aes_gcm(aes_gcm_tv_template + i))
+        {
+          crypterr("ERROR: Failed GCM test #%i\n", i);
+          return -1;
+        }
+    }
+#endif
+
   return OK;
 }
 #endif
@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/crypto/testmngr.h
  *
- *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author:  Max Nekludov <macscomp@gmail.com>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -521,4 +521,96 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
 };
 
 #endif /* CONFIG_CRYPTO_AES */
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+
+/* AES-GCM test vectors */
+
+struct aead_testvec
+{
+  FAR char *key;
+  FAR char *iv;
+  FAR char *assoc;
+  FAR char *input;
+  FAR char *result;
+  FAR char *tag;
+  unsigned char klen;
+  unsigned char ivlen;
+  unsigned short alen;
+  unsigned short ilen;
+};
+
+static struct aead_testvec aes_gcm_tv_template[] =
+{
+#ifndef CONFIG_CRYPTO_AES128_DISABLE
+  { /* From the GCM specification, test case 4 */
+    .key    = "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08",
+    .klen   = 16,
+    .iv     = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad"
+        "\xde\xca\xf8\x88",
+    .ivlen  = 12,
+    .assoc  = "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xab\xad\xda\xd2",
+    .alen   = 20,
+    .input  = "\xd9\x31\x32\x25\xf8\x84\x06\xe5"
+        "\xa5\x59\x09\xc5\xaf\xf5\x26\x9a"
+        "\x86\xa7\xa9\x53\x15\x34\xf7\xda"
+        "\x2e\x4c\x30\x3d\x8a\x31\x8a\x72"
+        "\x1c\x3c\x0c\x95\x95\x68\x09\x53"
+        "\x2f\xcf\x0e\x24\x49\xa6\xb5\x25"
+        "\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57"
+        "\xba\x63\x7b\x39",
+    .ilen   = 60,
+    .result = "\x42\x83\x1e\xc2\x21\x77\x74\x24"
+        "\x4b\x72\x21\xb7\x84\xd0\xd4\x9c"
+        "\xe3\xaa\x21\x2f\x2c\x02\xa4\xe0"
+        "\x35\xc1\x7e\x23\x29\xac\xa1\x2e"
+        "\x21\xd5\x14\xb2\x54\x66\x93\x1c"
+        "\x7d\x8f\x6a\x5a\xac\x84\xaa\x05"
+        "\x1b\xa3\x0b\x39\x6a\x0a\xac\x97"
+        "\x3d\x58\xe0\x91",
+    .tag    = "\x5b\xc9\x4f\xbc\x32\x21\xa5\xdb"
+        "\x94\xfa\xe9\x5a\xe7\x12\x1a\x47",
+  },
+#endif
+#ifndef CONFIG_CRYPTO_AES256_DISABLE
+  { /* Test case 16 */
+    .key    = "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08"
+        "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08",
+    .klen   = 32,
+    .iv     = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad"
+        "\xde\xca\xf8\x88",
+    .ivlen  = 12,
+    .assoc  = "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xab\xad\xda\xd2",
+    .alen   = 20,
+    .input  = "\xd9\x31\x32\x25\xf8\x84\x06\xe5"
+        "\xa5\x59\x09\xc5\xaf\xf5\x26\x9a"
+        "\x86\xa7\xa9\x53\x15\x34\xf7\xda"
+        "\x2e\x4c\x30\x3d\x8a\x31\x8a\x72"
+        "\x1c\x3c\x0c\x95\x95\x68\x09\x53"
+        "\x2f\xcf\x0e\x24\x49\xa6\xb5\x25"
+        "\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57"
+        "\xba\x63\x7b\x39",
+    .ilen   = 60,
+    .result = "\x52\x2d\xc1\xf0\x99\x56\x7d\x07"
+        "\xf4\x7f\x37\xa3\x2a\x84\x42\x7d"
+        "\x64\x3a\x8c\xdc\xbf\xe5\xc0\xc9"
+        "\x75\x98\xa2\xbd\x25\x55\xd1\xaa"
+        "\x8c\xb0\x8e\x48\x59\x0d\xbb\x3d"
+        "\xa7\xb0\x8b\x10\x56\x82\x88\x38"
+        "\xc5\xf6\x1e\x63\x93\xba\x7a\x0a"
+        "\xbc\xc9\xf6\x62",
+    .tag    = "\x76\xfc\x6e\xce\x0f\x4e\x17\x68"
+        "\xcd\xdf\x88\x53\xbb\x2d\x55\x1b",
+  },
+#endif
+};
+
+#endif /* CONFIG_CRYPTO_SW_AES */
 #endif /* __CRYPTO_TESTMNGR_H */
@@ -57,9 +57,13 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/analog/adc.h>
+#include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
 
 #include <nuttx/irq.h>
@@ -75,8 +79,21 @@ static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+#ifdef CONFIG_ADC_STREAM
+static int     adc_receiveblock(FAR struct adc_dev_s *dev,
+                                FAR const void *data, size_t nbytes);
+#endif
 static void    adc_notify(FAR struct adc_dev_s *dev);
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup);
+#ifdef CONFIG_ADC_STREAM
+static void    adc_stream_stop(FAR struct adc_dev_s *dev);
+static ssize_t adc_stream_read(FAR struct file *filep,
+                               FAR struct adc_dev_s *dev, FAR char *buffer,
+                               size_t buflen);
+static int     adc_stream_ioctl(FAR struct file *filep,
+                                FAR struct adc_dev_s *dev, int cmd,
+                                unsigned long arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -99,6 +116,9 @@ static const struct file_operations g_adc_fops =
 static const struct adc_callback_s g_adc_callback =
 {
   adc_receive   /* au_receive */
+#ifdef CONFIG_ADC_STREAM
+  , adc_receiveblock /* au_receiveblock */
+#endif
 };
 
 /****************************************************************************
@@ -206,6 +226,17 @@ static int adc_close(FAR struct file *filep)
 
           dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_STREAM
+          /* Stop streaming.  The block ring is retained because it may
+           * still be mapped.
+           */
+
+          if (dev->ad_stream.as_active)
+            {
+              adc_stream_stop(dev);
+            }
+#endif
+
           /* Free the IRQ and disable the ADC device */
 
           flags = enter_critical_section();       /* Disable interrupts */
@@ -234,6 +265,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_STREAM
+  /* While streaming, return whole blocks */
+
+  if (dev->ad_stream.as_active)
+    {
+      return adc_stream_read(filep, dev, buffer, buflen);
+    }
+#endif
+
   /* Determine size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -408,6 +448,14 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct adc_dev_s *dev = inode->i_private;
   int ret;
 
+#ifdef CONFIG_ADC_STREAM
+  ret = adc_stream_ioctl(filep, dev, cmd, arg);
+  if (ret != -ENOTTY)
+    {
+      return ret;
+    }
+#endif
+
   ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
   return ret;
 }
@@ -555,6 +603,12 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
         {
           adc_pollnotify(dev, POLLIN);
         }
+#ifdef CONFIG_ADC_STREAM
+      else if (dev->ad_stream.as_head != dev->ad_stream.as_tail)
+        {
+          adc_pollnotify(dev, POLLIN);
+        }
+#endif
     }
   else if (fds->priv)
     {
@@ -573,6 +627,345 @@ return_with_irqdisabled:
   return ret;
 }
 
+#ifdef CONFIG_ADC_STREAM
+/****************************************************************************
+ * Name: adc_receiveblock
+ *
+ * Description:
+ *   Called by the lower half, normally from the DMA half and full transfer
+ *   interrupts, with a buffer of raw samples.  Copy the samples into the
+ *   next free block of the stream ring.  If the ring is full, the block is
+ *   dropped and counted as an overrun.
+ *
+ ****************************************************************************/
+
+static int adc_receiveblock(FAR struct adc_dev_s *dev, FAR const void *data,
+                            size_t nbytes)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  FAR struct adc_block_s *block;
+  irqstate_t flags;
+  int nexttail;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (!stream->as_active || stream->as_blocks == NULL)
+    {
+      ret = -EPERM;
+      goto errout;
+    }
+
+  /* The sequence number also counts the dropped blocks so that gaps are
+   * visible to the application.
+   */
+
+  nexttail = stream->as_tail + 1;
+  if (nexttail >= CONFIG_ADC_STREAM_NBLOCKS)
+    {
+      nexttail = 0;
+    }
+
+  if (nexttail == stream->as_head)
+    {
+      stream->as_seqno++;
+      stream->as_overruns++;
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  if (nbytes > CONFIG_ADC_STREAM_BLOCKSIZE)
+    {
+      nbytes = CONFIG_ADC_STREAM_BLOCKSIZE;
+    }
+
+  block              = &stream->as_blocks[stream->as_tail];
+  block->ab_seqno    = stream->as_seqno++;
+  block->ab_overruns = stream->as_overruns;
+  block->ab_nbytes   = nbytes;
+  clock_systimespec(&block->ab_ts);
+  memcpy(block->ab_data, data, nbytes);
+
+  stream->as_tail = nexttail;
+  adc_notify(dev);
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_stream_start
+ *
+ * Description:
+ *   Empty the stream ring and ask the lower half to start streaming.  The
+ *   ring is allocated on first use and then kept for the lifetime of the
+ *   driver since it may be mapped by the application.
+ *
+ ****************************************************************************/
+
+static int adc_stream_start(FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  irqstate_t flags;
+  int ret;
+
+  if (stream->as_blocks == NULL)
+    {
+      stream->as_blocks = (FAR struct adc_block_s *)
+        kmm_zalloc(CONFIG_ADC_STREAM_NBLOCKS * sizeof(struct adc_block_s));
+      if (stream->as_blocks == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  flags               = enter_critical_section();
+  stream->as_head     = 0;
+  stream->as_tail     = 0;
+  stream->as_seqno    = 0;
+  stream->as_overruns = 0;
+  stream->as_active   = true;
+  leave_critical_section(flags);
+
+  ret = ADC_IOCTL(dev, ANIOC_STREAM, 1);
+  if (ret < 0)
+    {
+      aerr("ERROR: Failed to start streaming: %d\n", ret);
+      stream->as_active = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_stream_stop
+ *
+ * Description:
+ *   Ask the lower half to stop streaming and wake up any readers waiting for
+ *   blocks.  Blocks still in the ring may be read until the ring is empty.
+ *
+ ****************************************************************************/
+
+static void adc_stream_stop(FAR struct adc_dev_s *dev)
+{
+  irqstate_t flags;
+  int i;
+
+  ADC_IOCTL(dev, ANIOC_STREAM, 0);
+
+  flags = enter_critical_section();
+  dev->ad_stream.as_active = false;
+
+  for (i = 0; i < dev->ad_nrxwaiters; i++)
+    {
+      nxsem_post(&dev->ad_recv.af_sem);
+    }
+
+  adc_pollnotify(dev, POLLIN);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: adc_stream_wait
+ *
+ * Description:
+ *   Wait until the stream ring holds at least one full block.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static int adc_stream_wait(FAR struct file *filep, FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  int ret;
+
+  while (stream->as_head == stream->as_tail)
+    {
+      /* The ring is empty.  There is nothing to wait for if streaming was
+       * stopped or if non-blocking mode was selected.
+       */
+
+      if (!stream->as_active)
+        {
+          return -ENODATA;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: adc_stream_read
+ *
+ * Description:
+ *   Copy as many whole blocks as fit into the user buffer.  Each block
+ *   occupies ADC_BLOCKLEN(ab_nbytes) bytes.  Returns zero once streaming was
+ *   stopped and the ring is empty.
+ *
+ ****************************************************************************/
+
+static ssize_t adc_stream_read(FAR struct file *filep,
+                               FAR struct adc_dev_s *dev, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  FAR struct adc_block_s *block;
+  irqstate_t flags;
+  size_t blklen;
+  size_t nread = 0;
+  int ret;
+
+  flags = enter_critical_section();
+  ret = adc_stream_wait(filep, dev);
+  if (ret < 0)
+    {
+      leave_critical_section(flags);
+      return ret == -ENODATA ? 0 : ret;
+    }
+
+  while (stream->as_head != stream->as_tail)
+    {
+      block  = &stream->as_blocks[stream->as_head];
+      blklen = ADC_BLOCKLEN(block->ab_nbytes);
+      if (nread + blklen > buflen)
+        {
+          break;
+        }
+
+      memcpy(&buffer[nread], block, blklen);
+      nread += blklen;
+
+      if (++stream->as_head >= CONFIG_ADC_STREAM_NBLOCKS)
+        {
+          stream->as_head = 0;
+        }
+
+      /* Give the DMA interrupt a chance between blocks */
+
+      leave_critical_section(flags);
+      flags = enter_critical_section();
+    }
+
+  leave_critical_section(flags);
+
+  /* Refuse a user buffer that is too small for even one block */
+
+  return nread > 0 ? (ssize_t)nread : -EMSGSIZE;
+}
+
+/****************************************************************************
+ * Name: adc_stream_ioctl
+ *
+ * Description:
+ *   Handle the streaming ioctl commands.  Returns -ENOTTY for any other
+ *   command.
+ *
+ ****************************************************************************/
+
+static int adc_stream_ioctl(FAR struct file *filep,
+                            FAR struct adc_dev_s *dev, int cmd,
+                            unsigned long arg)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  irqstate_t flags;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      /* Start (arg != 0) or stop (arg == 0) streaming */
+
+      case ANIOC_STREAM:
+        if (arg != 0 && !stream->as_active)
+          {
+            ret = adc_stream_start(dev);
+          }
+        else if (arg == 0 && stream->as_active)
+          {
+            adc_stream_stop(dev);
+          }
+        break;
+
+      /* Wait for the oldest full block and return its index in the ring */
+
+      case ANIOC_STREAM_GETBLOCK:
+        {
+          FAR int *ndx = (FAR int *)((uintptr_t)arg);
+
+          DEBUGASSERT(ndx != NULL);
+          flags = enter_critical_section();
+          ret = adc_stream_wait(filep, dev);
+          if (ret >= 0)
+            {
+              *ndx = stream->as_head;
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      /* Return the oldest full block to the ring */
+
+      case ANIOC_STREAM_PUTBLOCK:
+        flags = enter_critical_section();
+        if (stream->as_head == stream->as_tail)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            if (++stream->as_head >= CONFIG_ADC_STREAM_NBLOCKS)
+              {
+                stream->as_head = 0;
+              }
+          }
+
+        leave_critical_section(flags);
+        break;
+
+      /* Return the address of the ring of CONFIG_ADC_STREAM_NBLOCKS blocks.
+       * The ring exists once streaming has been started.
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+          if (stream->as_blocks == NULL)
+            {
+              ret = -ENXIO;
+            }
+          else
+            {
+              *ppv = stream->as_blocks;
+            }
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+#endif /* CONFIG_ADC_STREAM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
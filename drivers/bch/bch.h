@@ -52,9 +52,34 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_BCH_CACHESECTORS
+#  define CONFIG_BCH_CACHESECTORS 1
+#endif
+
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Test if a sector is in the cache and get its address in the cache */
+
+#define BCH_CACHED(b,s) \
+  ((s) >= (b)->sector && (s) - (b)->sector < (b)->ncached)
+#define BCH_SECTBUF(b,s) \
+  (&(b)->buffer[((s) - (b)->sector) * (b)->sectsize])
+
+/* Sectors can only bypass the cache if they need not be encrypted.  Runs
+ * of at least CONFIG_BCH_CACHESECTORS sectors bypass the cache, as do all
+ * transfers of files opened with O_DIRECT.
+ */
+
+#ifdef CONFIG_BCH_ENCRYPTION
+#  define BCH_BYPASS(b,s,n) (false)
+#  define BCH_DIRECT(f)     (false)
+#else
+#  define BCH_BYPASS(b,s,n) \
+  ((n) >= CONFIG_BCH_CACHESECTORS && !BCH_CACHED(b,s))
+#  define BCH_DIRECT(f)     (((f)->f_oflags & O_DIRECT) != 0)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -64,13 +89,17 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the cache */
+  size_t ncached;          /* The number of sectors in the cache */
+  size_t nextsector;       /* The sector following the last access */
+  size_t dirtystart;       /* The first modified sector in the cache */
+  size_t dirtyend;         /* The sector following the last modified one */
   sem_t sem;               /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
+  bool dirty;              /* true: Data has been written to the cache */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* CONFIG_BCH_CACHESECTORS sector cache */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -98,6 +127,14 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
+EXTERN ssize_t bchlib_readdirect(FAR struct bchlib_s *bch,
+                                 FAR char *buffer, size_t offset,
+                                 size_t len);
+EXTERN ssize_t bchlib_writedirect(FAR struct bchlib_s *bch,
+                                  FAR const char *buffer, size_t offset,
+                                  size_t len);
 
 #undef EXTERN
 #if defined(__cplusplus)
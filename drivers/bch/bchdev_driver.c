@@ -297,10 +297,18 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer, size_t len)
   bch = (FAR struct bchlib_s *)inode->i_private;
 
   bchlib_semtake(bch);
-  ret = bchlib_read(bch, buffer, filep->f_pos, len);
+  if (BCH_DIRECT(filep))
+    {
+      ret = bchlib_readdirect(bch, buffer, filep->f_pos, len);
+    }
+  else
+    {
+      ret = bchlib_read(bch, buffer, filep->f_pos, len);
+    }
+
   if (ret > 0)
     {
-      filep->f_pos += len;
+      filep->f_pos += ret;
     }
 
   bchlib_semgive(bch);
@@ -323,10 +331,18 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer, size_t
   if (!bch->readonly)
     {
       bchlib_semtake(bch);
-      ret = bchlib_write(bch, buffer, filep->f_pos, len);
+      if (BCH_DIRECT(filep))
+        {
+          ret = bchlib_writedirect(bch, buffer, filep->f_pos, len);
+        }
+      else
+        {
+          ret = bchlib_write(bch, buffer, filep->f_pos, len);
+        }
+
       if (ret > 0)
         {
-          filep->f_pos += len;
+          filep->f_pos += ret;
         }
 
       bchlib_semgive(bch);
@@ -1,7 +1,8 @@
 /****************************************************************************
  * drivers/bch/bchlib_cache.c
  *
- *   Copyright (C) 2008-2009, 2014, 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2008-2009, 2014, 2016, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -48,9 +49,20 @@
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-#  include <crypto/crypto.h>
+#  include <nuttx/crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of 16-byte cypher blocks that are passed to the AES engine in
+ * one call.  Each call costs a key setup and, with a hardware engine, a
+ * round trip to the peripheral.
+ */
+
+#define BCH_CYPHER_BATCH 8
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -74,29 +86,53 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t sector,
+                      int encrypt)
 {
+  uint32_t X[4 * BCH_CYPHER_BATCH];
+  uint32_t T[4 * BCH_CYPHER_BATCH];
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)BCH_SECTBUF(bch, sector);
+  int nblocks;
   int i;
+  int j;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (i = 0; i < blocks; i += nblocks, buffer += 4 * nblocks)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
+      nblocks = blocks - i;
+      if (nblocks > BCH_CYPHER_BATCH)
+        {
+          nblocks = BCH_CYPHER_BATCH;
+        }
+
+      /* Encrypt the tweaks of a batch of blocks at once */
 
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
+      for (j = 0; j < nblocks; j++)
+        {
+          X[4 * j]     = sector;
+          X[4 * j + 1] = 0;
+          X[4 * j + 2] = 0;
+          X[4 * j + 3] = i + j;
+        }
+
+      aes_cypher(X, X, 16 * nblocks, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB,
+                 CYPHER_ENCRYPT);
 
       /* Xor-Encrypt-Xor */
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (j = 0; j < nblocks; j++)
+        {
+          bch_xor(&T[4 * j], &X[4 * j], &buffer[4 * j]);
+        }
+
+      aes_cypher(T, T, 16 * nblocks, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB, encrypt);
+
+      for (j = 0; j < nblocks; j++)
+        {
+          bch_xor(&buffer[4 * j], &X[4 * j], &T[4 * j]);
+        }
     }
 
   return OK;
@@ -111,7 +147,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the modified sectors in the cache (if dirty)
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -122,8 +158,11 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
   ssize_t ret = OK;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t sector;
+#endif
 
-  /* Check if the sector has been modified and is out of synch with the
+  /* Check if the cache has been modified and is out of synch with the
    * media.
    */
 
@@ -134,15 +173,20 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      for (sector = bch->dirtystart; sector < bch->dirtyend; sector++)
+        {
+          bch_cypher(bch, sector, CYPHER_ENCRYPT);
+        }
 #endif
 
-      /* Write the sector to the media */
+      /* Write all of the modified sectors to the media at once */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, BCH_SECTBUF(bch, bch->dirtystart),
+                                   bch->dirtystart,
+                                   bch->dirtyend - bch->dirtystart);
       if (ret < 0)
         {
-          ferr("Write failed: %d\n");
+          ferr("Write failed: %d\n", (int)ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -150,22 +194,27 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      for (sector = bch->dirtystart; sector < bch->dirtyend; sector++)
+        {
+          bch_cypher(bch, sector, CYPHER_DECRYPT);
+        }
 #endif
 
-      /* The sector is now in sync with the media */
+      /* The cache is now in sync with the media */
 
       bch->dirty = false;
     }
 
-  return (int)ret;
+  return ret < 0 ? (int)ret : OK;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the sector is in the cache.  If the sector follows the
+ *   previous access, then as many sectors as fit are read ahead into the
+ *   cache.  Otherwise, only the requested sector is read.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -175,25 +224,85 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  size_t nsectors;
+  ssize_t ret;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t i;
+#endif
 
-  if (bch->sector != sector)
+  if (BCH_CACHED(bch, sector))
     {
-      inode = bch->inode;
+      return OK;
+    }
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+  inode = bch->inode;
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+  ret = bchlib_flushsector(bch);
+  if (ret < 0)
+    {
+      return (int)ret;
+    }
+
+  /* Read ahead on sequential accesses */
+
+  nsectors = 1;
+  if (sector == bch->nextsector || sector == bch->sector + bch->ncached)
+    {
+      nsectors = CONFIG_BCH_CACHESECTORS;
+      if (nsectors > bch->nsectors - sector)
         {
-          ferr("Read failed: %d\n");
+          nsectors = bch->nsectors - sector;
         }
-      bch->sector = sector;
+    }
+
+  bch->ncached = 0;
+
+  ret = inode->u.i_bops->read(inode, bch->buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("Read failed: %d\n", (int)ret);
+      return (int)ret;
+    }
+
+  bch->sector  = sector;
+  bch->ncached = nsectors;
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+  for (i = 0; i < nsectors; i++)
+    {
+      bch_cypher(bch, sector + i, CYPHER_DECRYPT);
     }
-  return (int)ret;
+#endif
+
+  return OK;
 }
 
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Flush and drop the cache if it holds any of the sectors.  This must be
+ *   done before the sectors are accessed without the cache.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors)
+{
+  int ret = OK;
+
+  if (bch->ncached > 0 && sector < bch->sector + bch->ncached &&
+      bch->sector < sector + nsectors)
+    {
+      ret = bchlib_flushsector(bch);
+      if (ret >= 0)
+        {
+          bch->ncached = 0;
+        }
+    }
+
+  return ret;
+}
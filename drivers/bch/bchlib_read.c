@@ -85,7 +85,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   bytesread;
-  int      ret;
+  int      ret = OK;
 
   /* Get rid of this special case right away */
 
@@ -94,105 +94,136 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       return 0;
     }
 
-  /* Convert the file position into a sector number an offset. */
-
-  sector     = offset / bch->sectsize;
-  sectoffset = offset - sector * bch->sectsize;
-
-  if (sector >= bch->nsectors)
-    {
-      /* Return end-of-file */
-
-      return 0;
-    }
-
-  /* Read the initial partial sector */
-
   bytesread = 0;
-  if (sectoffset > 0)
+  while (len > 0)
     {
-      /* Read the sector into the sector buffer */
-
-      bchlib_readsector(bch, sector);
-
-      /* Copy the tail end of the sector to the user buffer */
-
-      if (sectoffset + len > bch->sectsize)
-        {
-          nbytes = bch->sectsize - sectoffset;
-        }
-      else
-        {
-          nbytes = len;
-        }
+      /* Convert the file position into a sector number an offset. */
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
-
-      /* Adjust pointers and counts */
-
-      sector++;
+      sector     = offset / bch->sectsize;
+      sectoffset = offset - sector * bch->sectsize;
 
       if (sector >= bch->nsectors)
         {
-          return nbytes;
-        }
-
-      bytesread  = nbytes;
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
+          /* Return end-of-file */
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
-   */
+          break;
+        }
 
-  if (len >= bch->sectsize)
-    {
       nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
+      if (nsectors > bch->nsectors - sector)
         {
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
+      if (sectoffset == 0 && BCH_BYPASS(bch, sector, nsectors))
         {
-          ferr("ERROR: Read failed: %d\n");
-          return ret;
+          /* Read large runs of full sectors directly into the user buffer,
+           * up to the first sector that is in the cache.
+           */
+
+          if (bch->ncached > 0 && bch->sector > sector &&
+              bch->sector - sector < nsectors)
+            {
+              nsectors = bch->sector - sector;
+            }
+
+          ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
+                                           sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              break;
+            }
+
+          nbytes = nsectors * bch->sectsize;
         }
+      else
+        {
+          /* Read the sector (and those following it) into the cache */
 
-      /* Adjust pointers and counts */
+          ret = bchlib_readsector(bch, sector);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      sector    += nsectors;
-      nbytes     = nsectors * bch->sectsize;
-      bytesread += nbytes;
+          /* Copy as much as is cached to the user buffer */
 
-      if (sector >= bch->nsectors)
-        {
-          return bytesread;
+          nbytes = (bch->sector + bch->ncached - sector) * bch->sectsize -
+                   sectoffset;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
+
+          memcpy(buffer, BCH_SECTBUF(bch, sector) + sectoffset, nbytes);
         }
 
+      /* Adjust pointers and counts */
+
+      offset    += nbytes;
+      bytesread += nbytes;
       buffer    += nbytes;
       len       -= nbytes;
     }
 
-  /* Then read any partial final sector */
+  bch->nextsector = offset / bch->sectsize;
+  return bytesread > 0 ? (ssize_t)bytesread : ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_readdirect
+ *
+ * Description:
+ *   Read from the block device without the cache (O_DIRECT).  The offset
+ *   and length must be multiples of the sector size.  All of the sectors
+ *   are read with a single transfer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+ssize_t bchlib_readdirect(FAR struct bchlib_s *bch, FAR char *buffer,
+                          size_t offset, size_t len)
+{
+  size_t nsectors;
+  size_t sector;
+  int ret;
 
-  if (len > 0)
+  if ((offset % bch->sectsize) != 0 || (len % bch->sectsize) != 0)
     {
-      /* Read the sector into the sector buffer */
+      return -EINVAL;
+    }
+
+  sector   = offset / bch->sectsize;
+  nsectors = len / bch->sectsize;
 
-      bchlib_readsector(bch, sector);
+  if (sector >= bch->nsectors || nsectors == 0)
+    {
+      return 0;
+    }
 
-      /* Copy the head end of the sector to the user buffer */
+  if (nsectors > bch->nsectors - sector)
+    {
+      nsectors = bch->nsectors - sector;
+    }
 
-      memcpy(buffer, bch->buffer, len);
+  /* Modified sectors in the cache must reach the media first */
 
-      /* Adjust counts */
+  ret = bchlib_invalidate(bch, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-      bytesread += len;
+  ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
+                                   sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("ERROR: Read failed: %d\n", ret);
+      return ret;
     }
 
-  return bytesread;
+  return nsectors * bch->sectsize;
 }
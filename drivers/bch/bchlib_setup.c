@@ -124,12 +124,13 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  /* Allocate the sector cache */
 
-  bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+  bch->buffer = (FAR uint8_t *)
+    kmm_malloc(CONFIG_BCH_CACHESECTORS * bch->sectsize);
   if (!bch->buffer)
     {
-      ferr("ERROR: Failed to allocate sector buffer\n");
+      ferr("ERROR: Failed to allocate sector cache\n");
       ret = -ENOMEM;
       goto errout_with_bch;
     }
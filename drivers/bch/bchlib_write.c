@@ -51,6 +51,41 @@
 
 #include "bch.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_markdirty
+ *
+ * Description:
+ *   Record that cached sectors have been modified.
+ *
+ ****************************************************************************/
+
+static void bchlib_markdirty(FAR struct bchlib_s *bch, size_t sector,
+                             size_t nsectors)
+{
+  if (!bch->dirty)
+    {
+      bch->dirtystart = sector;
+      bch->dirtyend   = sector + nsectors;
+      bch->dirty      = true;
+    }
+  else
+    {
+      if (sector < bch->dirtystart)
+        {
+          bch->dirtystart = sector;
+        }
+
+      if (sector + nsectors > bch->dirtyend)
+        {
+          bch->dirtyend = sector + nsectors;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -73,7 +108,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   byteswritten;
-  int      ret;
+  int      ret = OK;
 
   /* Get rid of this special case right away */
 
@@ -82,117 +117,161 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       return 0;
     }
 
-  /* Convert the file position into a sector number and offset. */
-
-  sector     = offset / bch->sectsize;
-  sectoffset = offset - sector * bch->sectsize;
-
-  if (sector >= bch->nsectors)
+  byteswritten = 0;
+  while (len > 0)
     {
-      return -EFBIG;
-    }
+      /* Convert the file position into a sector number and offset. */
 
-  /* Write the initial partial sector */
+      sector     = offset / bch->sectsize;
+      sectoffset = offset - sector * bch->sectsize;
 
-  byteswritten = 0;
-  if (sectoffset > 0)
-    {
-      /* Read the full sector into the sector buffer */
+      if (sector >= bch->nsectors)
+        {
+          if (byteswritten == 0)
+            {
+              ret = -EFBIG;
+            }
 
-      bchlib_readsector(bch, sector);
+          break;
+        }
 
-      /* Copy the tail end of the sector from the user buffer */
+      nsectors = len / bch->sectsize;
+      if (nsectors > bch->nsectors - sector)
+        {
+          nsectors = bch->nsectors - sector;
+        }
 
-      if (sectoffset + len > bch->sectsize)
+      if (sectoffset == 0 && BCH_BYPASS(bch, sector, nsectors))
         {
-          nbytes = bch->sectsize - sectoffset;
+          /* Write large runs of full sectors directly from the user
+           * buffer, up to the first sector that is in the cache.
+           */
+
+          if (bch->ncached > 0 && bch->sector > sector &&
+              bch->sector - sector < nsectors)
+            {
+              nsectors = bch->sector - sector;
+            }
+
+          ret = bch->inode->u.i_bops->write(bch->inode,
+                                            (FAR uint8_t *)buffer,
+                                            sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Write failed: %d\n", ret);
+              break;
+            }
+
+          nbytes = nsectors * bch->sectsize;
         }
       else
         {
-          nbytes = len;
+          /* Read the sector (and those following it) into the cache */
+
+          ret = bchlib_readsector(bch, sector);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          /* Modify as much as is cached */
+
+          nbytes = (bch->sector + bch->ncached - sector) * bch->sectsize -
+                   sectoffset;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
+
+          memcpy(BCH_SECTBUF(bch, sector) + sectoffset, buffer, nbytes);
+          bchlib_markdirty(bch, sector,
+                           (sectoffset + nbytes + bch->sectsize - 1) /
+                           bch->sectsize);
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
-
       /* Adjust pointers and counts */
 
-      sector++;
-
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
-
-      byteswritten  = nbytes;
+      offset       += nbytes;
+      byteswritten += nbytes;
       buffer       += nbytes;
       len          -= nbytes;
     }
 
-  /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
-   */
-
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
+  bch->nextsector = offset / bch->sectsize;
 
-      /* Write the contiguous sectors */
+  /* Finally, flush any cached writes to the device as well */
 
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
+  if (ret >= 0)
+    {
+      ret = bchlib_flushsector(bch);
       if (ret < 0)
         {
-          ferr("ERROR: Write failed: %d\n", ret);
+          ferr("ERROR: Flush failed: %d\n", ret);
           return ret;
         }
+    }
 
-      /* Adjust pointers and counts */
+  return byteswritten > 0 ? (ssize_t)byteswritten : ret;
+}
 
-      sector       += nsectors;
-      nbytes        = nsectors * bch->sectsize;
-      byteswritten += nbytes;
+/****************************************************************************
+ * Name: bchlib_writedirect
+ *
+ * Description:
+ *   Write to the block device without the cache (O_DIRECT).  The offset
+ *   and length must be multiples of the sector size.  All of the sectors
+ *   are written with a single transfer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
 
-      if (sector >= bch->nsectors)
-        {
-          return byteswritten;
-        }
+ssize_t bchlib_writedirect(FAR struct bchlib_s *bch, FAR const char *buffer,
+                           size_t offset, size_t len)
+{
+  size_t nsectors;
+  size_t sector;
+  int ret;
 
-      buffer    += nbytes;
-      len       -= nbytes;
+  if ((offset % bch->sectsize) != 0 || (len % bch->sectsize) != 0)
+    {
+      return -EINVAL;
     }
 
-  /* Then write any partial final sector */
+  sector   = offset / bch->sectsize;
+  nsectors = len / bch->sectsize;
 
-  if (len > 0)
+  if (nsectors == 0)
     {
-      /* Read the sector into the sector buffer */
-
-      bchlib_readsector(bch, sector);
+      return 0;
+    }
 
-      /* Copy the head end of the sector from the user buffer */
+  if (sector >= bch->nsectors)
+    {
+      return -EFBIG;
+    }
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+  if (nsectors > bch->nsectors - sector)
+    {
+      nsectors = bch->nsectors - sector;
+    }
 
-      /* Adjust counts */
+  /* The cached copies of the sectors become stale */
 
-      byteswritten += len;
+  ret = bchlib_invalidate(bch, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
     }
 
-  /* Finally, flush any cached writes to the device as well */
-
-  ret = bchlib_flushsector(bch);
+  ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
+                                    sector, nsectors);
   if (ret < 0)
     {
-      ferr("ERROR: Flush failed: %d\n", ret);
+      ferr("ERROR: Write failed: %d\n", ret);
       return ret;
     }
 
-  return byteswritten;
+  return nsectors * bch->sectsize;
 }
-
@@ -56,6 +56,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
@@ -133,6 +134,17 @@ static uint8_t        can_bytes2dlc(uint8_t nbytes);
 static void           can_txready_work(FAR void *arg);
 #endif
 
+/* Receive filters */
+
+#if CONFIG_CAN_NRXFILTERS > 0
+static bool           can_rxfilter_match(FAR struct can_reader_s *reader,
+                                         FAR struct can_hdr_s *hdr);
+static int            can_add_rxfilter(FAR struct can_reader_s *reader,
+                        FAR const struct canioc_rxfilter_s *filter);
+static int            can_del_rxfilter(FAR struct can_reader_s *reader,
+                                       int ndx);
+#endif
+
 /* Character driver methods */
 
 static int            can_open(FAR struct file *filep);
@@ -215,7 +227,7 @@ static void can_pollnotify(FAR struct can_dev_s *dev, pollevent_t eventset)
           if (fds->revents != 0)
             {
               caninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -392,6 +404,162 @@ static void can_txready_work(FAR void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: can_rxfilter_match
+ *
+ * Description:
+ *   Return true if the message is to be queued for the reader:  The reader
+ *   has no receive filters, or the message matches one of them, or the
+ *   message is an error report.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+#if CONFIG_CAN_NRXFILTERS > 0
+static bool can_rxfilter_match(FAR struct can_reader_s *reader,
+                               FAR struct can_hdr_s *hdr)
+{
+  FAR struct canioc_rxfilter_s *filter;
+  uint32_t id = hdr->ch_id;
+  uint8_t extid;
+  int i;
+
+  if (reader->filtset == 0)
+    {
+      return true;
+    }
+
+#ifdef CONFIG_CAN_ERRORS
+  if (hdr->ch_error)
+    {
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_CAN_EXTID
+  extid = hdr->ch_extid;
+#else
+  extid = 0;
+#endif
+
+  for (i = 0; i < CONFIG_CAN_NRXFILTERS; i++)
+    {
+      filter = &reader->filters[i];
+      if ((reader->filtset & ((uint32_t)1 << i)) == 0 ||
+          filter->rf_extid != extid)
+        {
+          continue;
+        }
+
+      switch (filter->rf_type)
+        {
+          case CAN_FILTER_MASK:
+            if ((id & filter->rf_id2) == (filter->rf_id1 & filter->rf_id2))
+              {
+                return true;
+              }
+            break;
+
+          case CAN_FILTER_DUAL:
+            if (id == filter->rf_id1 || id == filter->rf_id2)
+              {
+                return true;
+              }
+            break;
+
+          case CAN_FILTER_RANGE:
+            if (id >= filter->rf_id1 && id <= filter->rf_id2)
+              {
+                return true;
+              }
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: can_add_rxfilter
+ *
+ * Description:
+ *   Add a receive filter to the reader.  Return the filter ID.
+ *
+ ****************************************************************************/
+
+#if CONFIG_CAN_NRXFILTERS > 0
+static int can_add_rxfilter(FAR struct can_reader_s *reader,
+                            FAR const struct canioc_rxfilter_s *filter)
+{
+  irqstate_t flags;
+  int ret = -ENOSPC;
+  int i;
+
+  if (filter == NULL || filter->rf_type > CAN_FILTER_RANGE)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_CAN_EXTID
+  if (filter->rf_extid > 1)
+#else
+  if (filter->rf_extid != 0)
+#endif
+    {
+      return -EINVAL;
+    }
+
+  /* can_receive() walks the filters from the interrupt handler */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_CAN_NRXFILTERS; i++)
+    {
+      if ((reader->filtset & ((uint32_t)1 << i)) == 0)
+        {
+          reader->filters[i] = *filter;
+          reader->filtset   |= (uint32_t)1 << i;
+          ret = i;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: can_del_rxfilter
+ *
+ * Description:
+ *   Remove the receive filter with the ID 'ndx' from the reader.
+ *
+ ****************************************************************************/
+
+#if CONFIG_CAN_NRXFILTERS > 0
+static int can_del_rxfilter(FAR struct can_reader_s *reader, int ndx)
+{
+  irqstate_t flags;
+
+  if (ndx < 0 || ndx >= CONFIG_CAN_NRXFILTERS ||
+      (reader->filtset & ((uint32_t)1 << ndx)) == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  reader->filtset &= ~((uint32_t)1 << ndx);
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
 static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 {
   FAR struct can_reader_s *reader = kmm_zalloc(sizeof(struct can_reader_s));
@@ -403,6 +571,9 @@ static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
   nxsem_init(&reader->fifo.rx_sem, 0, 1);
   reader->filep = filep;
 
+  /* Remember the reader so that it need not be searched for */
+
+  filep->f_priv = reader;
   return reader;
 }
 
@@ -481,11 +652,17 @@ static int can_open(FAR struct file *filep)
           dev->cd_ocount = tmp;
         }
 
-    irqstate_t flags = enter_critical_section();
-    list_add_head(&dev->cd_readers,
-                  (FAR struct list_node *)init_can_reader(filep));
+      /* Add the receive FIFO of this open file */
 
-    leave_critical_section(flags);
+      if (ret >= 0)
+        {
+          FAR struct can_reader_s *reader = init_can_reader(filep);
+          irqstate_t flags;
+
+          flags = enter_critical_section();
+          list_add_head(&dev->cd_readers, &reader->list);
+          leave_critical_section(flags);
+        }
     }
 
   can_givesem(&dev->cd_closesem);
@@ -507,7 +684,6 @@ static int can_close(FAR struct file *filep)
   FAR struct can_dev_s *dev   = inode->i_private;
   irqstate_t            flags;
   FAR struct list_node *node;
-  FAR struct list_node *tmp;
   int                   ret;
 
   caninfo("ocount: %d\n", dev->cd_ocount);
@@ -518,15 +694,15 @@ static int can_close(FAR struct file *filep)
       return ret;
     }
 
-  list_for_every_safe(&dev->cd_readers, node, tmp)
-    {
-      if (((FAR struct can_reader_s *)node)->filep == filep)
-        {
-          list_delete(node);
-          kmm_free(node);
-          break;
-        }
-    }
+  /* can_receive() walks the list of readers from the interrupt handler */
+
+  node  = (FAR struct list_node *)filep->f_priv;
+  flags = enter_critical_section();
+  list_delete(node);
+  leave_critical_section(flags);
+
+  filep->f_priv = NULL;
+  kmm_free(node);
 
   /* Decrement the references to the driver.  If the reference count will
    * decrement to 0, then uninitialize the driver.
@@ -584,8 +760,7 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct inode         *inode = filep->f_inode;
   FAR struct can_dev_s     *dev = inode->i_private;
-  FAR struct can_reader_s  *reader = NULL;
-  FAR struct list_node     *node;
+  FAR struct can_reader_s  *reader = filep->f_priv;
   FAR struct can_rxfifo_s  *fifo;
   size_t                    nread;
   irqstate_t                flags;
@@ -641,15 +816,6 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
         }
 #endif /* CONFIG_CAN_ERRORS */
 
-      list_for_every(&dev->cd_readers, node)
-        {
-          if (((FAR struct can_reader_s *) node)->filep == filep)
-            {
-              reader = (FAR struct can_reader_s *)node;
-              break;
-            }
-        }
-
       DEBUGASSERT(reader != NULL);
 
       fifo = &reader->fifo;
@@ -1016,6 +1182,26 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = can_rtrread(dev, (FAR struct canioc_rtr_s *)((uintptr_t)arg));
         break;
 
+#if CONFIG_CAN_NRXFILTERS > 0
+      /* CANIOC_ADD_RXFILTER: Add a receive filter to this open file.
+       * Argument is a reference to struct canioc_rxfilter_s.
+       */
+
+      case CANIOC_ADD_RXFILTER:
+        ret = can_add_rxfilter(filep->f_priv,
+                               (FAR const struct canioc_rxfilter_s *)
+                               ((uintptr_t)arg));
+        break;
+
+      /* CANIOC_DEL_RXFILTER: Remove a receive filter from this open file.
+       * Argument is the filter ID.
+       */
+
+      case CANIOC_DEL_RXFILTER:
+        ret = can_del_rxfilter(filep->f_priv, (int)arg);
+        break;
+#endif
+
       /* Not a "built-in" ioctl command.. perhaps it is unique to this
        * lower-half, device driver.
        */
@@ -1037,8 +1223,7 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct inode *inode = (FAR struct inode *)filep->f_inode;
   FAR struct can_dev_s *dev = (FAR struct can_dev_s *)inode->i_private;
-  FAR struct can_reader_s *reader = NULL;
-  FAR struct list_node *node;
+  FAR struct can_reader_s *reader = filep->f_priv;
   pollevent_t eventset;
   int ndx;
   int ret;
@@ -1053,15 +1238,6 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
     }
 #endif
 
-  list_for_every(&dev->cd_readers, node)
-    {
-      if (((FAR struct can_reader_s *)node)->filep == filep)
-        {
-          reader = (FAR struct can_reader_s *)node;
-          break;
-        }
-    }
-
   DEBUGASSERT(reader != NULL);
 
   /* Get exclusive access to the poll structures */
@@ -1275,6 +1451,21 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
   caninfo("ID: %d DLC: %d\n", hdr->ch_id, hdr->ch_dlc);
 
+#ifdef CONFIG_CAN_TIMESTAMP
+  /* Time stamp the message, unless the lower half has done that already
+   * with the hardware receive time.
+   */
+
+  if (!dev->cd_hwtstamp)
+    {
+      struct timespec ts;
+
+      clock_systimespec(&ts);
+      hdr->ch_ts.tv_sec  = ts.tv_sec;
+      hdr->ch_ts.tv_usec = ts.tv_nsec / 1000;
+    }
+#endif
+
   /* Check if adding this new message would over-run the drivers ability to
    * enqueue read data.
    */
@@ -1329,6 +1520,15 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
       FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
       fifo = &reader->fifo;
 
+#if CONFIG_CAN_NRXFILTERS > 0
+      /* Skip the readers that are not interested in this message */
+
+      if (!can_rxfilter_match(reader, hdr))
+        {
+          continue;
+        }
+#endif
+
       nexttail = fifo->rx_tail + 1;
       if (nexttail >= CONFIG_CAN_FIFOSIZE)
         {
@@ -0,0 +1,273 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_I2C_ASYNC_HPWORK) || !defined(CONFIG_SCHED_LPWORK)
+#  define I2CWORK HPWORK
+#else
+#  define I2CWORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the queue of asynchronous transfers of one I2C bus */
+
+struct i2c_async_s
+{
+  FAR struct i2c_async_s *flink;   /* Supports a singly linked list */
+  FAR struct i2c_master_s *dev;    /* The I2C bus */
+  struct work_s work;              /* Performs the queued transfers */
+  sq_queue_t pending;              /* The queued requests, by priority */
+  bool busy;                       /* True: The work is queued or running */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The queues of all I2C buses.  Queues are never destroyed. */
+
+static sq_queue_t g_i2c_async;
+
+/* Serializes the creation of queues */
+
+static sem_t g_i2c_async_lock = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Perform the queued transfers of one I2C bus until the queue is empty.
+ *   The queue is sampled again after each batch so that a batch of higher
+ *   priority that was queued meanwhile goes next.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_s *async = (FAR struct i2c_async_s *)arg;
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req   = (FAR struct i2c_request_s *)sq_remfirst(&async->pending);
+      if (req == NULL)
+        {
+          async->busy = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      ret = I2C_TRANSFER(async->dev, req->msgs, req->count);
+      if (req->callback != NULL)
+        {
+          req->callback(req, ret, req->arg);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: i2c_async_get
+ *
+ * Description:
+ *   Find the queue of the I2C bus, creating it on first use.
+ *
+ ****************************************************************************/
+
+static FAR struct i2c_async_s *i2c_async_get(FAR struct i2c_master_s *dev)
+{
+  FAR struct i2c_async_s *async;
+
+  if (nxsem_wait_uninterruptible(&g_i2c_async_lock) < 0)
+    {
+      return NULL;
+    }
+
+  for (async = (FAR struct i2c_async_s *)sq_peek(&g_i2c_async);
+       async != NULL;
+       async = async->flink)
+    {
+      if (async->dev == dev)
+        {
+          break;
+        }
+    }
+
+  if (async == NULL)
+    {
+      async = (FAR struct i2c_async_s *)
+        kmm_zalloc(sizeof(struct i2c_async_s));
+      if (async != NULL)
+        {
+          async->dev = dev;
+          sq_init(&async->pending);
+          sq_addlast((FAR sq_entry_t *)async, &g_i2c_async);
+        }
+    }
+
+  nxsem_post(&g_i2c_async_lock);
+  return async;
+}
+
+/****************************************************************************
+ * Name: i2c_async_insert
+ *
+ * Description:
+ *   Add the request behind all queued requests of the same or a higher
+ *   priority.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void i2c_async_insert(FAR struct i2c_async_s *async,
+                             FAR struct i2c_request_s *req)
+{
+  FAR struct i2c_request_s *prev = NULL;
+  FAR struct i2c_request_s *curr;
+
+  for (curr = (FAR struct i2c_request_s *)sq_peek(&async->pending);
+       curr != NULL && curr->priority >= req->priority;
+       prev = curr, curr = curr->flink);
+
+  if (prev == NULL)
+    {
+      sq_addfirst((FAR sq_entry_t *)req, &async->pending);
+    }
+  else
+    {
+      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)req,
+                  &async->pending);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a batch of I2C messages and return without waiting.  The batches
+ *   queued on one I2C bus are performed one after the other, highest
+ *   priority first and in order of submission within one priority.
+ *   req->callback is called when each batch completes.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the batch of messages, its priority and the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the batch was queued; a negated errno value on failure.
+ *   The callback will not be called on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_request_s *req)
+{
+  FAR struct i2c_async_s *async;
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(dev != NULL && req != NULL && req->msgs != NULL &&
+              req->count > 0);
+
+  async = i2c_async_get(dev);
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Add the request to the queue.  Start the work unless it is already
+   * working through the queue.
+   */
+
+  flags = enter_critical_section();
+  i2c_async_insert(async, req);
+
+  if (!async->busy)
+    {
+      ret = work_queue(I2CWORK, &async->work, i2c_async_worker, async, 0);
+      if (ret < 0)
+        {
+          sq_rem((FAR sq_entry_t *)req, &async->pending);
+        }
+      else
+        {
+          async->busy = true;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_I2C_ASYNC */
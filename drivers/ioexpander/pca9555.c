@@ -1,7 +1,7 @@
 /****************************************************************************
  * drivers/ioexpander/pca9555.c
  *
- *   Copyright (C) 2015, 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2016-2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Sebastien Lorquet <sebastien@lorquet.fr>
  *
  * References:
@@ -812,6 +812,7 @@ static void pca9555_irqworker(void *arg)
   uint8_t addr = PCA9555_REG_INPUT;
   uint8_t buf[2];
   ioe_pinset_t pinset;
+  ioe_pinset_t changed;
   int ret;
   int i;
 
@@ -826,9 +827,16 @@ static void pca9555_irqworker(void *arg)
       pca->sreg[addr]   = buf[0];
       pca->sreg[addr+1] = buf[1];
 #endif
-      /* Create a 16-bit pinset */
+      /* Create a 16-bit pinset.  Port 0 holds pins 0-7. */
 
-      pinset = ((unsigned int)buf[0] << 8) | buf[1];
+      pinset = (ioe_pinset_t)buf[0] | ((ioe_pinset_t)buf[1] << 8);
+
+      /* The PCA9555 raises one interrupt for any number of input changes.
+       * Report all pins that changed since the last read.
+       */
+
+      changed    = pinset ^ pca->input;
+      pca->input = pinset;
 
       /* Perform pin interrupt callbacks */
 
@@ -842,7 +850,7 @@ static void pca9555_irqworker(void *arg)
             {
               /* Did any of the requested pin interrupts occur? */
 
-              ioe_pinset_t match = pinset & pca->cb[i].pinset;
+              ioe_pinset_t match = changed & pca->cb[i].pinset;
               if (match != 0)
                 {
                   /* Yes.. perform the callback */
@@ -915,6 +923,12 @@ FAR struct ioexpander_dev_s *pca9555_initialize(FAR struct i2c_master_s *i2cdev,
                                                 FAR struct pca9555_config_s *config)
 {
   FAR struct pca9555_dev_s *pcadev;
+#if defined(CONFIG_PCA9555_SHADOW_MODE) || defined(CONFIG_PCA9555_INT_ENABLE)
+  uint8_t addr;
+#endif
+#ifdef CONFIG_PCA9555_INT_ENABLE
+  uint8_t buf[2];
+#endif
 
   DEBUGASSERT(i2cdev != NULL && config != NULL);
 
@@ -946,12 +960,34 @@ FAR struct ioexpander_dev_s *pca9555_initialize(FAR struct i2c_master_s *i2cdev,
   pcadev->dev.ops = &g_pca9555_ops;
   pcadev->config  = config;
 
+  nxsem_init(&pcadev->exclsem, 0, 1);
+
+#ifdef CONFIG_PCA9555_SHADOW_MODE
+  /* Load the shadow registers.  The register address wraps within each
+   * pair of registers, so these are read one pair at a time.
+   */
+
+  for (addr = PCA9555_REG_INPUT; addr < 8; addr += 2)
+    {
+      (void)pca9555_writeread(pcadev, &addr, 1, &pcadev->sreg[addr], 2);
+    }
+#endif
+
 #ifdef CONFIG_PCA9555_INT_ENABLE
+  /* Remember the current inputs so that the first interrupt only reports
+   * the pins that actually changed.
+   */
+
+  addr = PCA9555_REG_INPUT;
+  if (pca9555_writeread(pcadev, &addr, 1, buf, 2) == OK)
+    {
+      pcadev->input = (ioe_pinset_t)buf[0] | ((ioe_pinset_t)buf[1] << 8);
+    }
+
   pcadev->config->attach(pcadev->config, pca9555_interrupt, pcadev);
   pcadev->config->enable(pcadev->config, TRUE);
 #endif
 
-  nxsem_init(&pcadev->exclsem, 0, 1);
   return &pcadev->dev;
 }
 
@@ -1,7 +1,7 @@
 /********************************************************************************************
  * drivers/ioexpander/pca9555.h
  *
- *   Copyright (C) 2015 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2020 Gregory Nutt. All rights reserved.
  *   Author: Sebastien Lorquet <sebastien@lorquet.fr>
  *
  * References:
@@ -154,6 +154,7 @@ struct pca9555_dev_s
 
 #ifdef CONFIG_IOEXPANDER_INT_ENABLE
   struct work_s work;                   /* Supports the interrupt handling "bottom half" */
+  ioe_pinset_t input;                   /* Last value of the input registers */
 
   /* Saved callback information for each I/O expander client */
 
@@ -2,7 +2,7 @@
  * drivers/ioexpander/tca64xx.h
  * Supports the following parts: TCA6408, TCA6416, TCA6424
  *
- *   Copyright (C) 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016-2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * This header file derives, in part, from the Project Ara TCA64xx driver
@@ -44,6 +44,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
@@ -83,6 +84,12 @@ static uint8_t tca64_input_reg(FAR struct tca64_dev_s *priv, uint8_t pin);
 static uint8_t tca64_output_reg(FAR struct tca64_dev_s *priv, uint8_t pin);
 static uint8_t tca64_polarity_reg(FAR struct tca64_dev_s *priv, uint8_t pin);
 static uint8_t tca64_config_reg(FAR struct tca64_dev_s *priv, uint8_t pin);
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+static bool tca64_shadowed(FAR struct tca64_dev_s *priv, uint8_t regaddr,
+             unsigned int count);
+static void tca64_shadow_save(FAR struct tca64_dev_s *priv, uint8_t regaddr,
+             FAR const uint8_t *regval, unsigned int count);
+#endif
 static int tca64_getreg(FAR struct tca64_dev_s *priv, uint8_t regaddr,
              FAR uint8_t *regval, unsigned int count);
 static int tca64_putreg(struct tca64_dev_s *priv, uint8_t regaddr,
@@ -291,7 +298,7 @@ static uint8_t tca64_output_reg(FAR struct tca64_dev_s *priv, uint8_t pin)
 static uint8_t tca64_polarity_reg(FAR struct tca64_dev_s *priv, uint8_t pin)
 {
   FAR const struct tca64_part_s *part = tca64_getpart(priv);
-  uint8_t reg = part->tp_output;
+  uint8_t reg = part->tp_polarity;
 
   DEBUGASSERT(pin <= part->tp_ngpios);
   return reg + (pin >> 3);
@@ -314,6 +321,47 @@ static uint8_t tca64_config_reg(FAR struct tca64_dev_s *priv, uint8_t pin)
   return reg + (pin >> 3);
 }
 
+/****************************************************************************
+ * Name: tca64_shadowed
+ *
+ * Description:
+ *  Return true if a range of registers is held in the shadow registers.
+ *  The input registers are never shadowed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+static bool tca64_shadowed(FAR struct tca64_dev_s *priv, uint8_t regaddr,
+                           unsigned int count)
+{
+  uint16_t mask = ((1 << count) - 1) << regaddr;
+
+  return regaddr >= tca64_getpart(priv)->tp_output &&
+         (priv->svalid & mask) == mask;
+}
+#endif
+
+/****************************************************************************
+ * Name: tca64_shadow_save
+ *
+ * Description:
+ *  Save the values read from or written to a range of registers in the
+ *  shadow registers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+static void tca64_shadow_save(FAR struct tca64_dev_s *priv, uint8_t regaddr,
+                              FAR const uint8_t *regval, unsigned int count)
+{
+  if (regaddr >= tca64_getpart(priv)->tp_output)
+    {
+      memcpy(&priv->sreg[regaddr], regval, count);
+      priv->svalid |= ((1 << count) - 1) << regaddr;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: tca64_getreg
  *
@@ -326,16 +374,35 @@ static int tca64_getreg(FAR struct tca64_dev_s *priv, uint8_t regaddr,
                         FAR uint8_t *regval, unsigned int count)
 {
   struct i2c_msg_s msg[2];
+  uint8_t cmd = regaddr;
   int ret;
 
   DEBUGASSERT(priv != NULL && priv->i2c != NULL && priv->config != NULL);
+  DEBUGASSERT(regaddr + count <= TCA64XX_NR_REGS);
+
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  /* Return shadowed registers without a bus transfer */
+
+  if (tca64_shadowed(priv, regaddr, count))
+    {
+      memcpy(regval, &priv->sreg[regaddr], count);
+      return OK;
+    }
+#endif
+
+  /* The TCA6424 only advances the register address when asked to */
+
+  if (count > 1 && priv->config->part == TCA6424_PART)
+    {
+      cmd |= TCA6424_AUTO_INCREMENT;
+    }
 
   /* Set up for the transfer */
 
   msg[0].frequency = TCA64XX_I2C_MAXFREQUENCY,
   msg[0].addr      = priv->config->address,
   msg[0].flags     = 0,
-  msg[0].buffer    = &regaddr,
+  msg[0].buffer    = &cmd,
   msg[0].length    = 1,
 
   msg[1].frequency = TCA64XX_I2C_MAXFREQUENCY,
@@ -357,6 +424,9 @@ static int tca64_getreg(FAR struct tca64_dev_s *priv, uint8_t regaddr,
     {
       gpioinfo("I2C addr=%02x regaddr=%02x: read %02x\n",
                priv->config->address, regaddr, *regval);
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+      tca64_shadow_save(priv, regaddr, regval, count);
+#endif
       return OK;
     }
 }
@@ -373,15 +443,22 @@ static int tca64_putreg(struct tca64_dev_s *priv, uint8_t regaddr,
                         FAR uint8_t *regval, unsigned int count)
 {
   struct i2c_msg_s msg[1];
-  uint8_t cmd[2];
+  uint8_t cmd[1 + (TCA64XX_NR_GPIO_MAX >> 3)];
   int ret;
   int i;
 
   DEBUGASSERT(priv != NULL && priv->i2c != NULL && priv->config != NULL);
+  DEBUGASSERT(count < sizeof(cmd));
 
-  /* Set up for the transfer */
+  /* Set up for the transfer.  The TCA6424 only advances the register
+   * address when asked to.
+   */
 
   cmd[0] = regaddr;
+  if (count > 1 && priv->config->part == TCA6424_PART)
+    {
+      cmd[0] |= TCA6424_AUTO_INCREMENT;
+    }
 
   for (i = 0; i < count; i++)
     {
@@ -404,7 +481,10 @@ static int tca64_putreg(struct tca64_dev_s *priv, uint8_t regaddr,
   else
     {
       gpioinfo("claddr=%02x, regaddr=%02x, regval=%02x\n",
-               priv->config->address, regaddr, regval);
+               priv->config->address, regaddr, regval[0]);
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+      tca64_shadow_save(priv, regaddr, regval, count);
+#endif
       return OK;
     }
 }
@@ -838,11 +918,11 @@ static int tca64_multiwritepin(FAR struct ioexpander_dev_s *dev,
 
       if (values[i])
         {
-          pinset |= (1 << pin);
+          pinset |= ((ioe_pinset_t)1 << pin);
         }
       else
         {
-          pinset &= ~(1 << pin);
+          pinset &= ~((ioe_pinset_t)1 << pin);
         }
     }
 
@@ -1387,6 +1467,12 @@ FAR struct ioexpander_dev_s *tca64_initialize(FAR struct i2c_master_s *i2c,
   priv->i2c     = i2c;
   priv->config  = config;
 
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  /* Nothing is shadowed until it has been read or written */
+
+  priv->svalid  = 0;
+#endif
+
 #ifdef CONFIG_TCA64XX_INT_ENABLE
   /* Initial interrupt state:  Edge triggered on both edges */
 
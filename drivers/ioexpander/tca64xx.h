@@ -1,7 +1,7 @@
 /********************************************************************************************
  * drivers/ioexpander/tca64.h
  *
- *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Sebastien Lorquet <sebastien@lorquet.fr>
  *
  * References:
@@ -82,6 +82,8 @@
  * CONFIG_TCA64XX_INT_POLLDELAY
  *   If CONFIG_TCA64XX_INT_POLL=y, then this is the delay in microseconds
  *   between polls for missed interrupts.
+ * CONFIG_TCA64XX_SHADOW_MODE
+ *   Keep the output, polarity and configuration registers in RAM.
  */
 
 #ifndef CONFIG_I2C
@@ -143,9 +145,14 @@
 #define TCA6424_CONFIG1_REG             0x0D
 #define TCA6424_CONFIG2_REG             0x0E
 
+/* Set in the command byte to advance the register address */
+
+#define TCA6424_AUTO_INCREMENT          0x80
+
 #define TCA6424_NR_GPIOS                24
 
 #define TCA64XX_NR_GPIO_MAX             TCA6424_NR_GPIOS
+#define TCA64XX_NR_REGS                 (TCA6424_CONFIG2_REG + 1)
 
 /* 1us (datasheet: reset pulse duration (Tw) is 4ns */
 
@@ -221,6 +228,11 @@ struct tca64_dev_s
   uint8_t part;                      /* TCA64xx part ID (see enum tca64xx_part_e) */
   sem_t exclsem;                     /* Mutual exclusion */
 
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  uint16_t svalid;                   /* Bit set: shadow register is valid */
+  uint8_t sreg[TCA64XX_NR_REGS];     /* Shadowed registers, by address */
+#endif
+
 #ifdef CONFIG_IOEXPANDER_INT_ENABLE
 #ifdef CONFIG_TCA64XX_INT_POLL
   WDOG_ID wdog;                      /* Timer used to poll for missed interrupts */
@@ -68,10 +68,31 @@
 #define loop_semgive(d) nxsem_post(&(d)->sem)  /* To match loop_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_LOOP_READCACHE
+#  define CONFIG_LOOP_READCACHE 0
+#endif
+
+#ifndef MIN
+#  define MIN(a,b)      ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_LOOP_DIRECT
+/* A run of sectors of the backing file that are consecutive in the block
+ * driver that holds the file.
+ */
+
+struct loop_extent_s
+{
+  uint32_t     sector;       /* The first sector of the loop device */
+  uint32_t     nsectors;     /* The number of sectors */
+  off_t        blksector;    /* The first sector of the block driver */
+};
+#endif
+
 struct loop_struct_s
 {
   sem_t        sem;          /* For safe read-modify-write operations */
@@ -83,6 +104,16 @@ struct loop_struct_s
   bool         writeenabled; /* true: can write to device */
 #endif
   struct file  devfile;      /* File struct of char device/file */
+#ifdef CONFIG_LOOP_DIRECT
+  FAR struct inode *blkdriver;       /* The block driver holding the file */
+  FAR struct loop_extent_s *extents; /* The extents of the file or NULL */
+  unsigned int nextents;     /* The number of extents */
+#endif
+#if CONFIG_LOOP_READCACHE > 0
+  FAR uint8_t  *cache;       /* The read cache or NULL */
+  uint32_t     cachesector;  /* The first sector in the cache */
+  uint32_t     ncached;      /* The number of sectors in the cache */
+#endif
 };
 
 /****************************************************************************
@@ -90,6 +121,9 @@ struct loop_struct_s
  ****************************************************************************/
 
 static int     loop_semtake(FAR struct loop_struct_s *dev);
+#ifdef CONFIG_LOOP_DIRECT
+static int     loop_mapextents(FAR struct loop_struct_s *dev);
+#endif
 static int     loop_open(FAR struct inode *inode);
 static int     loop_close(FAR struct inode *inode);
 static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
@@ -221,6 +255,234 @@ static int loop_close(FAR struct inode *inode)
   return ret;
 }
 
+/****************************************************************************
+ * Name: loop_fileio
+ *
+ * Description:  Transfer sectors with file_read() or file_write() on the
+ *   backing file.
+ *
+ ****************************************************************************/
+
+static ssize_t loop_fileio(FAR struct loop_struct_s *dev,
+                           FAR unsigned char *buffer, size_t start_sector,
+                           unsigned int nsectors, bool write)
+{
+  ssize_t nbytes;
+  off_t offset;
+  off_t ret;
+
+  /* Calculate the offset of the sectors and seek to the position */
+
+  offset = start_sector * dev->sectsize + dev->offset;
+  ret = file_seek(&dev->devfile, offset, SEEK_SET);
+  if (ret < 0)
+    {
+      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
+      return -EIO;
+    }
+
+  /* Then transfer the requested number of sectors at that position */
+
+  do
+    {
+#ifdef CONFIG_FS_WRITABLE
+      if (write)
+        {
+          nbytes = file_write(&dev->devfile, buffer,
+                              nsectors * dev->sectsize);
+        }
+      else
+#endif
+        {
+          nbytes = file_read(&dev->devfile, buffer,
+                             nsectors * dev->sectsize);
+        }
+
+      if (nbytes < 0 && nbytes != -EINTR)
+        {
+          ferr("ERROR: %s failed: %d\n", write ? "Write" : "Read",
+               (int)nbytes);
+          return nbytes;
+        }
+    }
+  while (nbytes < 0);
+
+  /* Return the number of sectors transferred */
+
+  return nbytes / dev->sectsize;
+}
+
+/****************************************************************************
+ * Name: loop_directio
+ *
+ * Description:  Transfer sectors directly with the block driver that holds
+ *   the backing file, using the extents mapped by loop_mapextents().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LOOP_DIRECT
+static ssize_t loop_directio(FAR struct loop_struct_s *dev,
+                             FAR unsigned char *buffer, size_t start_sector,
+                             unsigned int nsectors, bool write)
+{
+  FAR struct inode *inode = dev->blkdriver;
+  FAR const struct loop_extent_s *extent;
+  unsigned int ndone = 0;
+  unsigned int nxfer;
+  unsigned int low;
+  unsigned int high;
+  unsigned int mid;
+  ssize_t ret;
+
+  while (ndone < nsectors)
+    {
+      /* Find the extent that holds start_sector */
+
+      low  = 0;
+      high = dev->nextents - 1;
+      while (low < high)
+        {
+          mid = (low + high + 1) >> 1;
+          if (dev->extents[mid].sector <= start_sector)
+            {
+              low = mid;
+            }
+          else
+            {
+              high = mid - 1;
+            }
+        }
+
+      extent = &dev->extents[low];
+      nxfer  = MIN(nsectors - ndone,
+                   extent->sector + extent->nsectors - start_sector);
+
+      /* And transfer the sectors that it holds */
+
+#ifdef CONFIG_FS_WRITABLE
+      if (write)
+        {
+          ret = inode->u.i_bops->write(inode, buffer,
+                                       extent->blksector + start_sector -
+                                       extent->sector, nxfer);
+        }
+      else
+#endif
+        {
+          ret = inode->u.i_bops->read(inode, buffer,
+                                      extent->blksector + start_sector -
+                                      extent->sector, nxfer);
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: %s failed: %d\n", write ? "Write" : "Read",
+               (int)ret);
+          return ret;
+        }
+
+      ndone        += ret;
+      start_sector += ret;
+      buffer       += ret * dev->sectsize;
+
+      if (ret < nxfer)
+        {
+          break;
+        }
+    }
+
+  return ndone;
+}
+#endif
+
+/****************************************************************************
+ * Name: loop_rawio
+ *
+ * Description:  Transfer sectors without the read cache
+ *
+ ****************************************************************************/
+
+static ssize_t loop_rawio(FAR struct loop_struct_s *dev,
+                          FAR unsigned char *buffer, size_t start_sector,
+                          unsigned int nsectors, bool write)
+{
+#ifdef CONFIG_LOOP_DIRECT
+  if (dev->extents != NULL)
+    {
+      return loop_directio(dev, buffer, start_sector, nsectors, write);
+    }
+#endif
+
+  return loop_fileio(dev, buffer, start_sector, nsectors, write);
+}
+
+/****************************************************************************
+ * Name: loop_cachedread
+ *
+ * Description:  Read sectors through the read cache.  A read that misses
+ *   the cache fills it with the following sectors, too.  Reads at least as
+ *   large as the cache bypass it.
+ *
+ ****************************************************************************/
+
+#if CONFIG_LOOP_READCACHE > 0
+static ssize_t loop_cachedread(FAR struct loop_struct_s *dev,
+                               FAR unsigned char *buffer,
+                               size_t start_sector, unsigned int nsectors)
+{
+  unsigned int ndone = 0;
+  unsigned int nxfer;
+  ssize_t ret;
+
+  while (ndone < nsectors)
+    {
+      if (start_sector >= dev->cachesector &&
+          start_sector < dev->cachesector + dev->ncached)
+        {
+          /* Copy the cached sectors */
+
+          nxfer = MIN(nsectors - ndone,
+                      dev->cachesector + dev->ncached - start_sector);
+          memcpy(buffer,
+                 dev->cache + (start_sector - dev->cachesector) *
+                 dev->sectsize, nxfer * dev->sectsize);
+          ret = nxfer;
+        }
+      else if (nsectors - ndone >= CONFIG_LOOP_READCACHE)
+        {
+          ret = loop_rawio(dev, buffer, start_sector, nsectors - ndone,
+                           false);
+        }
+      else
+        {
+          /* Fill the cache from start_sector */
+
+          nxfer = MIN(CONFIG_LOOP_READCACHE, dev->nsectors - start_sector);
+          dev->ncached = 0;
+
+          ret = loop_rawio(dev, dev->cache, start_sector, nxfer, false);
+          if (ret > 0)
+            {
+              dev->cachesector = start_sector;
+              dev->ncached     = ret;
+              continue;
+            }
+        }
+
+      if (ret <= 0)
+        {
+          return ndone > 0 ? ndone : ret;
+        }
+
+      ndone        += ret;
+      start_sector += ret;
+      buffer       += ret * dev->sectsize;
+    }
+
+  return ndone;
+}
+#endif
+
 /****************************************************************************
  * Name: loop_read
  *
@@ -232,9 +494,7 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
                          size_t start_sector, unsigned int nsectors)
 {
   FAR struct loop_struct_s *dev;
-  ssize_t nbytesread;
-  off_t offset;
-  off_t ret;
+  ssize_t ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
@@ -245,33 +505,29 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
-  /* Calculate the offset to read the sectors and seek to the position */
+  /* The seek and the transfer, or the cache, must not be interleaved with
+   * those of another request.
+   */
 
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
+  ret = loop_semtake(dev);
   if (ret < 0)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
-      return -EIO;
+      return ret;
     }
 
-  /* Then read the requested number of sectors from that position */
-
-  do
+#if CONFIG_LOOP_READCACHE > 0
+  if (dev->cache != NULL)
     {
-      nbytesread = file_read(&dev->devfile, buffer,
-                             nsectors * dev->sectsize);
-      if (nbytesread < 0 && nbytesread != -EINTR)
-        {
-          ferr("ERROR: Read failed: %d\n", nbytesread);
-          return (int)nbytesread;
-        }
+      ret = loop_cachedread(dev, buffer, start_sector, nsectors);
+    }
+  else
+#endif
+    {
+      ret = loop_rawio(dev, buffer, start_sector, nsectors, false);
     }
-  while (nbytesread < 0);
-
-  /* Return the number of sectors read */
 
-  return nbytesread / dev->sectsize;
+  loop_semgive(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -287,39 +543,122 @@ static ssize_t loop_write(FAR struct inode *inode,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct loop_struct_s *dev;
-  ssize_t nbyteswritten;
-  off_t offset;
-  off_t ret;
+  ssize_t ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
 
-  /* Calculate the offset to write the sectors and seek to the position */
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      ferr("ERROR: Write past end of file\n");
+      return -EIO;
+    }
 
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
+  ret = loop_semtake(dev);
   if (ret < 0)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
+      return ret;
     }
 
-  /* Then write the requested number of sectors to that position */
+#if CONFIG_LOOP_READCACHE > 0
+  /* Drop the cached sectors that are overwritten */
 
-  do
+  if (start_sector < dev->cachesector + dev->ncached &&
+      start_sector + nsectors > dev->cachesector)
     {
-      nbyteswritten = file_write(&dev->devfile, buffer,
-                                 nsectors * dev->sectsize);
-      if (nbyteswritten < 0 && nbyteswritten != -EINTR)
+      dev->ncached = 0;
+    }
+#endif
+
+  ret = loop_rawio(dev, (FAR unsigned char *)buffer, start_sector,
+                   nsectors, true);
+
+  loop_semgive(dev);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: loop_mapextents
+ *
+ * Description:  Map the extents of the backing file with FIOC_BMAP, so that
+ *   the sectors can be transferred directly with the block driver that
+ *   holds the file.  This fails if the file system does not support
+ *   FIOC_BMAP, or if the sectors of the file and of the block driver do
+ *   not match.  The file is then accessed with file_read() and
+ *   file_write().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LOOP_DIRECT
+static int loop_mapextents(FAR struct loop_struct_s *dev)
+{
+  FAR struct loop_extent_s *extents = NULL;
+  FAR struct loop_extent_s *newextents;
+  FAR struct inode *inode;
+  struct file_bmap_s bmap;
+  unsigned int nextents = 0;
+  uint32_t sector = 0;
+  uint32_t nmapped;
+  int ret;
+
+  while (sector < dev->nsectors)
+    {
+      bmap.offset = dev->offset + (off_t)sector * dev->sectsize;
+      ret = file_ioctl(&dev->devfile, FIOC_BMAP,
+                       (unsigned long)((uintptr_t)&bmap));
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      nmapped = MIN(bmap.nbytes / dev->sectsize, dev->nsectors - sector);
+      if (bmap.sectsize != dev->sectsize || nmapped == 0)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      newextents = (FAR struct loop_extent_s *)
+        kmm_realloc(extents, (nextents + 1) * sizeof(struct loop_extent_s));
+      if (newextents == NULL)
         {
-          ferr("ERROR: nx_write failed: %d\n", nbyteswritten);
-          return nbyteswritten;
+          ret = -ENOMEM;
+          goto errout;
         }
+
+      extents = newextents;
+      extents[nextents].sector    = sector;
+      extents[nextents].nsectors  = nmapped;
+      extents[nextents].blksector = bmap.sector;
+      nextents++;
+
+      sector += nmapped;
+    }
+
+  /* The block driver must support the transfers */
+
+  inode = bmap.blkdriver;
+  if (nextents == 0 || inode == NULL || inode->u.i_bops->read == NULL
+#ifdef CONFIG_FS_WRITABLE
+      || (dev->writeenabled && inode->u.i_bops->write == NULL)
+#endif
+     )
+    {
+      ret = -ENOSYS;
+      goto errout;
     }
-  while (nbyteswritten < 0);
 
-  /* Return the number of sectors written */
+  finfo("Mapped %u extents\n", nextents);
+
+  dev->blkdriver = inode;
+  dev->extents   = extents;
+  dev->nextents  = nextents;
+  return OK;
 
-  return nbyteswritten / dev->sectsize;
+errout:
+  kmm_free(extents);
+  return ret;
 }
 #endif
 
@@ -446,6 +785,22 @@ int losetup(FAR const char *devname, FAR const char *filename,
         }
     }
 
+#ifdef CONFIG_LOOP_DIRECT
+  /* Transfer the sectors directly with the block driver if possible */
+
+  ret = loop_mapextents(dev);
+  if (ret < 0)
+    {
+      finfo("Using file I/O: %d\n", ret);
+    }
+#endif
+
+#if CONFIG_LOOP_READCACHE > 0
+  /* Allocate the read cache.  The device works without it, too. */
+
+  dev->cache = (FAR uint8_t *)kmm_malloc(CONFIG_LOOP_READCACHE * sectsize);
+#endif
+
   /* Inode private data will be reference to the loop device structure */
 
   ret = register_blockdriver(devname, &g_bops, 0, dev);
@@ -458,6 +813,12 @@ int losetup(FAR const char *devname, FAR const char *filename,
   return OK;
 
 errout_with_file:
+#if CONFIG_LOOP_READCACHE > 0
+  kmm_free(dev->cache);
+#endif
+#ifdef CONFIG_LOOP_DIRECT
+  kmm_free(dev->extents);
+#endif
   file_close(&dev->devfile);
 
 errout_with_dev:
@@ -524,6 +885,12 @@ int loteardown(FAR const char *devname)
       (void)file_close(&dev->devfile);
     }
 
+#if CONFIG_LOOP_READCACHE > 0
+  kmm_free(dev->cache);
+#endif
+#ifdef CONFIG_LOOP_DIRECT
+  kmm_free(dev->extents);
+#endif
   kmm_free(dev);
   return ret;
 }
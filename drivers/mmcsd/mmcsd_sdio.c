@@ -123,6 +123,11 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+  uint8_t cmd23:1;                 /* true: card supports SET_BLOCK_COUNT (CMD23) */
+#ifdef CONFIG_SDIO_UHS
+  uint8_t uhs:1;                   /* true: 1.8V signaling selected (SD UHS-I) */
+  uint8_t hs200:1;                 /* true: card supports HS200 (from EXT_CSD) */
+#endif
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -198,6 +203,8 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 uint32_t nblocks);
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
@@ -244,9 +251,18 @@ static int     mmcsd_ioctl(FAR struct inode *inode, int cmd,
 
 static void    mmcsd_mediachange(FAR void *arg);
 static int     mmcsd_widebus(FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_SDIO_UHS
+static int     mmcsd_sdswitchvoltage(FAR struct mmcsd_state_s *priv);
+static int     mmcsd_sduhs(FAR struct mmcsd_state_s *priv);
+#endif
 #ifdef CONFIG_MMCSD_MMCSUPPORT
 static int     mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv);
 static int     mmcsd_mmcreadextCSD (FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_SDIO_UHS
+static int     mmcsd_mmcswitch(FAR struct mmcsd_state_s *priv, uint8_t index,
+                 uint8_t value);
+static int     mmcsd_mmchs200(FAR struct mmcsd_state_s *priv);
+#endif
 #endif
 static int     mmcsd_sdinitialize(FAR struct mmcsd_state_s *priv);
 static int     mmcsd_cardidentify(FAR struct mmcsd_state_s *priv);
@@ -997,13 +1013,16 @@ static void mmcsd_decodeSCR(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
    *   DATA_STATE_AFTER_ERASE 55:55 1-bit erase status
    *   SD_SECURITY            54:52 3-bit SD security support level
    *   SD_BUS_WIDTHS          51:48 4-bit bus width indicator
-   *   Reserved               47:32 16-bit SD reserved space
+   *   Reserved               47:36 12-bit SD reserved space
+   *   CMD_SUPPORT            35:32 4-bit command support bits
    */
 
 #ifdef CONFIG_ENDIAN_BIG  /* Card transfers SCR in big-endian order */
   priv->buswidth     = (scr[0] >> 16) & 15;
+  priv->cmd23        = (scr[0] & MMCSD_SCR_CMD23_SUPPORT) != 0;
 #else
   priv->buswidth     = (scr[0] >> 8) & 15;
+  priv->cmd23        = ((scr[0] >> 24) & MMCSD_SCR_CMD23_SUPPORT) != 0;
 #endif
 
 #ifdef CONFIG_DEBUG_FS_INFO
@@ -1327,6 +1346,35 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send SET_BLOCK_COUNT just before a multiple block transfer.  The
+ *   transfer then ends by itself after the given number of blocks and no
+ *   STOP_TRANSMISSION is needed.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               uint32_t nblocks)
+{
+  int ret;
+
+  /* Send CMD23, SET_BLOCK_COUNT, and verify good R1 return status  */
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD23, nblocks);
+  ret = mmcsd_recvR1(priv, MMCSD_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1602,6 +1650,20 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       SDIO_RECVSETUP(priv->dev, buffer, nbytes);
     }
 
+  /* If the card supports it, send CMD23 so that no STOP_TRANSMISSION is
+   * needed at the end of the transfer.
+   */
+
+  if (priv->cmd23)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+
   /* Send CMD18, READ_MULT_BLOCK: Read a block of the size selected by
    * the mmcsd_setblocklen() and verify that good R1 status is returned
    */
@@ -1625,9 +1687,13 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the block count was set with CMD23 */
+
+  if (!priv->cmd23)
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
 #ifdef CONFIG_SDIO_DMA
   SDIO_DMADELYDINVLDT(priv->dev, buffer, priv->blocksize * nblocks);
 #endif
@@ -1962,10 +2028,11 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
   /* If this is an SD card, then send ACMD23 (SET_WR_BLK_ERASE_COUNT) just
    * before sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of
    * write blocks to be pre-erased and might make the following multiple block
-   * write command faster.
+   * write command faster.  This is not needed if the block count is set
+   * with CMD23.
    */
 
-  if (IS_SD(priv->type))
+  if (IS_SD(priv->type) && !priv->cmd23)
     {
       /* Send CMD55, APP_CMD, a verify that good R1 status is returned */
 
@@ -1996,6 +2063,17 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
   if ((priv->caps & SDIO_CAPS_DMABEFOREWRITE) == 0)
     {
+      /* Send CMD23, SET_BLOCK_COUNT, if supported by the card */
+
+      if (priv->cmd23)
+        {
+          ret = mmcsd_setblockcount(priv, nblocks);
+          if (ret != OK)
+            {
+              return ret;
+            }
+        }
+
       /* Send CMD25, WRITE_MULTIPLE_BLOCK, and verify that good R1 status
        * is returned
        */
@@ -2035,6 +2113,17 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
   if ((priv->caps & SDIO_CAPS_DMABEFOREWRITE) != 0)
     {
+      /* Send CMD23, SET_BLOCK_COUNT, if supported by the card */
+
+      if (priv->cmd23)
+        {
+          ret = mmcsd_setblockcount(priv, nblocks);
+          if (ret != OK)
+            {
+              return ret;
+            }
+        }
+
       /* Send CMD25, WRITE_MULTIPLE_BLOCK, and verify that good R1 status
        * is returned
        */
@@ -2063,9 +2152,16 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION.  With CMD23, this is only needed to recover
+   * from a failed transfer.
+   */
+
+  ret = OK;
+  if (!priv->cmd23 || evret != OK)
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
   if (evret != OK)
     {
       return evret;
@@ -2617,6 +2713,137 @@ static int mmcsd_widebus(FAR struct mmcsd_state_s *priv)
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: mmcsd_sdswitchvoltage
+ *
+ * Description:
+ *   The SD card has accepted 1.8V signaling in the ACMD41 response.  Send
+ *   CMD11 (VOLTAGE_SWITCH) and let the SDIO driver switch the signaling
+ *   voltage.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_UHS
+static int mmcsd_sdswitchvoltage(FAR struct mmcsd_state_s *priv)
+{
+  int ret;
+
+  mmcsd_sendcmdpoll(priv, SD_CMD11, 0);
+  ret = mmcsd_recvR1(priv, SD_CMD11);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD11 failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = SDIO_SWITCHVOLTAGE(priv->dev);
+  if (ret != OK)
+    {
+      ferr("ERROR: SDIO_SWITCHVOLTAGE failed: %d\n", ret);
+      return ret;
+    }
+
+  finfo("1.8V signaling selected\n");
+  priv->uhs = true;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mmcsd_sduhs
+ *
+ * Description:
+ *   Select the fastest UHS-I access mode supported by both the card and the
+ *   SDIO driver with CMD6 (SWITCH_FUNC), then tune the sampling point.  The
+ *   card must already use 1.8V signaling and the 4-bit bus.  On a tuning
+ *   failure, fall back to the normal 4-bit clocking.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_UHS
+static int mmcsd_sduhs(FAR struct mmcsd_state_s *priv)
+{
+  uint8_t status[MMCSD_CMD6_STATUSLEN] aligned_data(16);
+  enum sdio_clock_e clock;
+  uint32_t mode;
+  int ret;
+
+  if ((priv->caps & SDIO_CAPS_UHS_SDR104) != 0)
+    {
+      mode  = MMCSD_CMD6_SDR104;
+      clock = CLOCK_SD_TRANSFER_SDR104;
+    }
+  else
+    {
+      mode  = MMCSD_CMD6_SDR50;
+      clock = CLOCK_SD_TRANSFER_SDR50;
+    }
+
+  /* Set the block size to the size of the switch status */
+
+  ret = mmcsd_setblocklen(priv, MMCSD_CMD6_STATUSLEN);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_setblocklen failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Setup up to receive data with interrupt mode */
+
+  SDIO_BLOCKSETUP(priv->dev, MMCSD_CMD6_STATUSLEN, 1);
+  SDIO_RECVSETUP(priv->dev, status, MMCSD_CMD6_STATUSLEN);
+
+  (void)SDIO_WAITENABLE(priv->dev,
+                        SDIOWAIT_TRANSFERDONE | SDIOWAIT_TIMEOUT |
+                        SDIOWAIT_ERROR);
+
+  /* Send CMD6, SWITCH_FUNC, to switch the access mode */
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD6, MMCSD_CMD6_SWITCH(mode));
+  ret = mmcsd_recvR1(priv, MMCSD_CMD6);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD6 failed: %d\n", ret);
+      SDIO_CANCEL(priv->dev);
+      return ret;
+    }
+
+  ret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR,
+                        MMCSD_SCR_DATADELAY);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_eventwait for CMD6 status failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The status reports the function that was actually selected */
+
+  if ((status[MMCSD_CMD6_GROUP1_RESULT] & MMCSD_CMD6_GROUP1_MASK) != mode)
+    {
+      fwarn("WARNING: Card did not switch to UHS-I mode %d\n", mode);
+      return -ENOSYS;
+    }
+
+  SDIO_CLOCK(priv->dev, clock);
+  up_udelay(MMCSD_CLK_DELAY);
+
+  /* Then send CMD19 until the SDIO driver has found the sampling point */
+
+  ret = SDIO_EXECUTETUNING(priv->dev, SD_CMD19);
+  if (ret != OK && ret != -ENOSYS)
+    {
+      ferr("ERROR: UHS-I tuning failed: %d\n", ret);
+
+      SDIO_CLOCK(priv->dev, CLOCK_SD_TRANSFER_4BIT);
+      up_udelay(MMCSD_CLK_DELAY);
+      return ret;
+    }
+
+  finfo("UHS-I mode %d selected\n", mode);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_mmcinitialize
  *
@@ -2739,6 +2966,21 @@ static int mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv)
 
   SDIO_CLOCK(priv->dev, CLOCK_MMC_TRANSFER);
   up_udelay(MMCSD_CLK_DELAY);
+
+#ifdef CONFIG_SDIO_UHS
+  /* Select HS200 timing if both the card and the SDIO driver support it */
+
+  if (priv->hs200 && (priv->caps & SDIO_CAPS_MMC_HS200) != 0 &&
+      (priv->caps & SDIO_CAPS_1BIT_ONLY) == 0)
+    {
+      ret = mmcsd_mmchs200(priv);
+      if (ret != OK)
+        {
+          fwarn("WARNING: HS200 mode not selected: %d\n", ret);
+        }
+    }
+#endif
+
   return OK;
 }
 
@@ -2861,12 +3103,107 @@ static int mmcsd_mmcreadextCSD (FAR struct mmcsd_state_s *priv)
   finfo("MMC ext CSD read succsesfully, number of block %d\n",
          priv->nblocks);
 
+  /* Cards with an EXT_CSD (MMC 4.0 and later) support SET_BLOCK_COUNT */
+
+  priv->cmd23 = true;
+#ifdef CONFIG_SDIO_UHS
+  priv->hs200 = (buffer[MMC_EXTCSD_DEVICE_TYPE] &
+                 MMC_EXTCSD_DEVICE_HS200) != 0;
+#endif
+
   /* Return value:  One sector read */
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: mmcsd_mmcswitch
+ *
+ * Description:
+ *   Write one byte of the MMC EXT_CSD with CMD6 (SWITCH) and wait until the
+ *   card has completed the switch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_UHS
+static int mmcsd_mmcswitch(FAR struct mmcsd_state_s *priv, uint8_t index,
+                           uint8_t value)
+{
+  int ret;
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD6, MMC_CMD6_SWITCH(index, value));
+  ret = mmcsd_recvR1(priv, MMC_CMD6);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD6 failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The card is busy until the switch is done.  Wait for it to return to
+   * the transfer state just as after a write.
+   */
+
+  priv->wrbusy = true;
+  return mmcsd_transferready(priv);
+}
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_mmchs200
+ *
+ * Description:
+ *   Select the 4-bit bus and HS200 timing and tune the sampling point.
+ *   On a tuning failure, fall back to the backward compatible timing with
+ *   the 4-bit bus.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_UHS
+static int mmcsd_mmchs200(FAR struct mmcsd_state_s *priv)
+{
+  int ret;
+
+  /* HS200 requires a 4 or 8-bit bus */
+
+  ret = mmcsd_mmcswitch(priv, MMC_EXTCSD_BUS_WIDTH, MMC_EXTCSD_BUS_WIDTH_4);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  SDIO_WIDEBUS(priv->dev, true);
+  priv->widebus = true;
+
+  ret = mmcsd_mmcswitch(priv, MMC_EXTCSD_HS_TIMING,
+                        MMC_EXTCSD_HS_TIMING_HS200);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  SDIO_CLOCK(priv->dev, CLOCK_MMC_TRANSFER_HS200);
+  up_udelay(MMCSD_CLK_DELAY);
+
+  /* Then send CMD21 until the SDIO driver has found the sampling point */
+
+  ret = SDIO_EXECUTETUNING(priv->dev, MMC_CMD21);
+  if (ret != OK && ret != -ENOSYS)
+    {
+      ferr("ERROR: HS200 tuning failed: %d\n", ret);
+
+      SDIO_CLOCK(priv->dev, CLOCK_MMC_TRANSFER);
+      up_udelay(MMCSD_CLK_DELAY);
+      (void)mmcsd_mmcswitch(priv, MMC_EXTCSD_HS_TIMING,
+                            MMC_EXTCSD_HS_TIMING_LEGACY);
+      return ret;
+    }
+
+  finfo("HS200 mode selected\n");
+  return OK;
+}
+#endif
+#endif /* CONFIG_MMCSD_MMCSUPPORT */
+
 /****************************************************************************
  * Name: mmcsd_sdinitialize
  *
@@ -3005,6 +3342,21 @@ static int mmcsd_sdinitialize(FAR struct mmcsd_state_s *priv)
       ferr("ERROR: Failed to set wide bus operation: %d\n", ret);
     }
 
+#ifdef CONFIG_SDIO_UHS
+  /* If 1.8V signaling was selected during identification, then switch to
+   * the fastest UHS-I mode.  UHS-I requires the 4-bit bus.
+   */
+
+  if (priv->uhs && priv->widebus)
+    {
+      ret = mmcsd_sduhs(priv);
+      if (ret != OK)
+        {
+          fwarn("WARNING: UHS-I mode not selected: %d\n", ret);
+        }
+    }
+#endif
+
   /* TODO: If wide-bus selected, then send CMD6 to see if the card supports
    * high speed mode.  A new SDIO method will be needed to set high speed
    * mode.
@@ -3026,6 +3378,7 @@ static int mmcsd_cardidentify(FAR struct mmcsd_state_s *priv)
 {
   uint32_t response;
   uint32_t sdcapacity = MMCSD_ACMD41_STDCAPACITY;
+  uint32_t sdvoltage  = 0;
 #ifdef CONFIG_MMCSD_MMCSUPPORT
   uint32_t mmccapacity = MMCSD_R3_HIGHCAPACITY;
 #endif
@@ -3035,7 +3388,12 @@ static int mmcsd_cardidentify(FAR struct mmcsd_state_s *priv)
 
   /* Assume failure to identify the card */
 
-  priv->type = MMCSD_CARDTYPE_UNKNOWN;
+  priv->type  = MMCSD_CARDTYPE_UNKNOWN;
+  priv->cmd23 = false;
+#ifdef CONFIG_SDIO_UHS
+  priv->uhs   = false;
+  priv->hs200 = false;
+#endif
 
   /* Check if there is a card present in the slot.  This is normally a matter is
    * of GPIO sensing.
@@ -3154,6 +3512,17 @@ static int mmcsd_cardidentify(FAR struct mmcsd_state_s *priv)
               finfo("SD V2.x card\n");
               priv->type = MMCSD_CARDTYPE_SDV2;
               sdcapacity = MMCSD_ACMD41_HIGHCAPACITY;
+
+#ifdef CONFIG_SDIO_UHS
+              /* Ask for 1.8V signaling if UHS-I can be used */
+
+              if ((priv->caps &
+                   (SDIO_CAPS_UHS_SDR50 | SDIO_CAPS_UHS_SDR104)) != 0 &&
+                  (priv->caps & SDIO_CAPS_1BIT_ONLY) == 0)
+                {
+                  sdvoltage = MMCSD_ACMD41_S18R;
+                }
+#endif
             }
           else
             {
@@ -3199,7 +3568,8 @@ static int mmcsd_cardidentify(FAR struct mmcsd_state_s *priv)
               /* Send ACMD41 */
 
               mmcsd_sendcmdpoll(priv, SD_ACMD41,
-                                MMCSD_ACMD41_VOLTAGEWINDOW_33_32 | sdcapacity);
+                                MMCSD_ACMD41_VOLTAGEWINDOW_33_32 | sdcapacity |
+                                sdvoltage);
               ret = SDIO_RECVR3(priv->dev, SD_ACMD41, &response);
               if (ret != OK)
                 {
@@ -3246,6 +3616,16 @@ static int mmcsd_cardidentify(FAR struct mmcsd_state_s *priv)
                           priv->type |= MMCSD_CARDTYPE_BLOCK;
                         }
 
+#ifdef CONFIG_SDIO_UHS
+                      /* Switch to 1.8V signaling if the card accepted it */
+
+                      if (sdvoltage != 0 &&
+                          (response & MMCSD_R3_S18A) != 0)
+                        {
+                          (void)mmcsd_sdswitchvoltage(priv);
+                        }
+#endif
+
                       /* And break out of the loop with an SD card identified */
 
                       break;
@@ -3506,6 +3886,11 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->rca          = 0;
   priv->selblocklen  = 0;
+  priv->cmd23        = false;
+#ifdef CONFIG_SDIO_UHS
+  priv->uhs          = false;
+  priv->hs200        = false;
+#endif
 
   /* Go back to the default 1-bit data bus. */
 
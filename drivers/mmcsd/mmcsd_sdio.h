@@ -73,6 +73,34 @@
 #define MMCSD_ACMD41_VOLTAGEWINDOW_32_31 ((uint32_t)1 << 19)
 #define MMCSD_ACMD41_HIGHCAPACITY   ((uint32_t)1 << 30)
 #define MMCSD_ACMD41_STDCAPACITY    ((uint32_t)0)
+#define MMCSD_ACMD41_S18R           ((uint32_t)1 << 24)    /* Request 1.8V signaling */
+
+/* CMD6 (SD SWITCH_FUNC) argument and the returned 512-bit status */
+
+#define MMCSD_CMD6_MODE_SWITCH      ((uint32_t)1 << 31)    /* 0=Check function, 1=Switch */
+#define MMCSD_CMD6_GROUP1_SHIFT     (0)                    /* Bits 0-3: Access mode */
+#define MMCSD_CMD6_GROUP1_MASK      ((uint32_t)15 << MMCSD_CMD6_GROUP1_SHIFT)
+#  define MMCSD_CMD6_SDR50          (2)                    /* UHS-I SDR50 */
+#  define MMCSD_CMD6_SDR104         (3)                    /* UHS-I SDR104 */
+#define MMCSD_CMD6_NOCHANGE         ((uint32_t)0x00fffff0) /* Keep groups 2-6 */
+#define MMCSD_CMD6_SWITCH(mode)     (MMCSD_CMD6_MODE_SWITCH | MMCSD_CMD6_NOCHANGE | \
+                                     ((uint32_t)(mode) << MMCSD_CMD6_GROUP1_SHIFT))
+#define MMCSD_CMD6_STATUSLEN        (64)                   /* Bytes in the status */
+#define MMCSD_CMD6_GROUP1_RESULT    (16)                   /* Byte with the group 1 result */
+
+/* MMC CMD6 (SWITCH) argument and the EXT_CSD bytes it writes */
+
+#define MMC_CMD6_WRITEBYTE          ((uint32_t)3 << 24)    /* Access: Write byte */
+#define MMC_CMD6_SWITCH(index,value) \
+  (MMC_CMD6_WRITEBYTE | ((uint32_t)(index) << 16) | ((uint32_t)(value) << 8))
+
+#define MMC_EXTCSD_BUS_WIDTH        (183)                  /* Bus width mode */
+#  define MMC_EXTCSD_BUS_WIDTH_4    (1)                    /* 4-bit data bus */
+#define MMC_EXTCSD_HS_TIMING        (185)                  /* High speed interface timing */
+#  define MMC_EXTCSD_HS_TIMING_LEGACY (0)                  /* Backward compatible timing */
+#  define MMC_EXTCSD_HS_TIMING_HS200 (2)                   /* HS200 timing */
+#define MMC_EXTCSD_DEVICE_TYPE      (196)                  /* Supported device types */
+#  define MMC_EXTCSD_DEVICE_HS200   (0x30)                 /* HS200 at 1.8V or 1.2V */
 
 /* ACMD42 argument */
 
@@ -149,6 +177,7 @@
 #define MMCSD_VDD_34_35             ((uint32_t)1 << 22)    /* VDD voltage 3.4-3.5 */
 #define MMCSD_VDD_35_36             ((uint32_t)1 << 23)    /* VDD voltage 3.5-3.6 */
 #define MMCSD_R3_HIGHCAPACITY       ((uint32_t)1 << 30)    /* true: Card supports block addressing */
+#define MMCSD_R3_S18A               ((uint32_t)1 << 24)    /* true: Card accepts 1.8V signaling */
 #define MMCSD_CARD_BUSY             ((uint32_t)1 << 31)    /* Card power-up busy bit */
 #define MMCSD_R3_STDCAPACITY        ((uint32_t)0)
 
@@ -181,6 +210,8 @@
 #define MMCSD_SCR_BUSWIDTH_4BIT     (4)
 #define MMCSD_SCR_BUSWIDTH_8BIT     (8)
 
+#define MMCSD_SCR_CMD23_SUPPORT     (2)                    /* CMD_SUPPORT: SET_BLOCK_COUNT */
+
 /* Last 4 bytes of the 48-bit R7 response */
 
 #define MMCSD_R7VERSION_SHIFT       (28)                   /* Bits 28-31: Command version number */
@@ -52,6 +52,9 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -73,10 +76,33 @@
 
 #define DEV_NAME_MAX    (NAME_MAX + 5)
 
+/* The write-back cache is flushed on a worker thread */
+
+#ifdef CONFIG_FTL_WRITEBACK
+#  ifdef CONFIG_SCHED_LPWORK
+#    define FTL_WORK    LPWORK
+#  else
+#    define FTL_WORK    HPWORK
+#  endif
+#  define FTL_WB_DELAY  MSEC2TICK(CONFIG_FTL_WRITEBACK_DELAY)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_WRITEBACK
+/* One slot of the write-back cache */
+
+struct ftl_cache_s
+{
+  FAR uint8_t          *buffer;  /* In-memory copy of the erase block */
+  off_t                 eblock;  /* The cached erase block (-1 if unused) */
+  uint32_t              stamp;   /* Time of last use, for LRU replacement */
+  bool                  dirty;   /* Modified since last written back */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -90,12 +116,35 @@ struct ftl_struct_s
 #ifdef CONFIG_FS_WRITABLE
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
+#ifdef CONFIG_FTL_WRITEBACK
+  sem_t                 exclsem; /* Exclusive access to the cache */
+  struct work_s         work;    /* Deferred write-back */
+  uint32_t              stamp;   /* Incremented on each use of a slot */
+  struct ftl_cache_s    cache[CONFIG_FTL_WRITEBACK_NBLOCKS];
+#endif
 };
 
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_WRITEBACK
+static void    ftl_wb_lock(FAR struct ftl_struct_s *dev);
+static FAR struct ftl_cache_s *ftl_wb_find(FAR struct ftl_struct_s *dev,
+                 off_t eblock);
+static int     ftl_wb_writeback(FAR struct ftl_struct_s *dev,
+                 FAR struct ftl_cache_s *slot);
+static FAR struct ftl_cache_s *ftl_wb_alloc(FAR struct ftl_struct_s *dev,
+                 off_t eblock, bool load);
+static int     ftl_wb_flush(FAR struct ftl_struct_s *dev);
+static void    ftl_wb_worker(FAR void *arg);
+static ssize_t ftl_wb_read(FAR struct ftl_struct_s *dev,
+                 FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+static ssize_t ftl_wb_write(FAR struct ftl_struct_s *dev,
+                 FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+static void    ftl_wb_free(FAR struct ftl_struct_s *dev);
+#endif
+
 static int     ftl_open(FAR struct inode *inode);
 static int     ftl_close(FAR struct inode *inode);
 static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
@@ -139,6 +188,378 @@ static const struct block_operations g_bops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ftl_wb_lock
+ *
+ * Description: Get exclusive access to the write-back cache
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static void ftl_wb_lock(FAR struct ftl_struct_s *dev)
+{
+  (void)nxsem_wait_uninterruptible(&dev->exclsem);
+}
+
+#define ftl_wb_unlock(dev) (void)nxsem_post(&(dev)->exclsem)
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_find
+ *
+ * Description: Return the cache slot holding an erase block, if any
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static FAR struct ftl_cache_s *ftl_wb_find(FAR struct ftl_struct_s *dev,
+                                           off_t eblock)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FTL_WRITEBACK_NBLOCKS; i++)
+    {
+      if (dev->cache[i].eblock == eblock)
+        {
+          return &dev->cache[i];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_writeback
+ *
+ * Description: Erase and re-write a modified erase block from the cache
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static int ftl_wb_writeback(FAR struct ftl_struct_s *dev,
+                            FAR struct ftl_cache_s *slot)
+{
+  off_t rwblock;
+  ssize_t nxfrd;
+  int ret;
+
+  if (slot->eblock < 0 || !slot->dirty)
+    {
+      return OK;
+    }
+
+  ret = MTD_ERASE(dev->mtd, slot->eblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", slot->eblock, ret);
+      return ret;
+    }
+
+  finfo("Write back erase block=%d\n", slot->eblock);
+
+  rwblock = slot->eblock * dev->blkper;
+  nxfrd   = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, slot->buffer);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+
+  slot->dirty = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_alloc
+ *
+ * Description:
+ *   Get a cache slot for an erase block.  An unused slot is taken if there
+ *   is one, otherwise the least recently used slot is written back and
+ *   re-used.  If 'load' is true, the erase block is read from FLASH.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static FAR struct ftl_cache_s *ftl_wb_alloc(FAR struct ftl_struct_s *dev,
+                                            off_t eblock, bool load)
+{
+  FAR struct ftl_cache_s *slot = NULL;
+  FAR struct ftl_cache_s *candidate;
+  ssize_t nxfrd;
+  int i;
+
+  for (i = 0; i < CONFIG_FTL_WRITEBACK_NBLOCKS; i++)
+    {
+      candidate = &dev->cache[i];
+      if (candidate->eblock < 0)
+        {
+          slot = candidate;
+          break;
+        }
+
+      if (slot == NULL || (int32_t)(candidate->stamp - slot->stamp) < 0)
+        {
+          slot = candidate;
+        }
+    }
+
+  if (ftl_wb_writeback(dev, slot) < 0)
+    {
+      return NULL;
+    }
+
+  slot->eblock = -1;
+  if (slot->buffer == NULL)
+    {
+      slot->buffer = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
+      if (slot->buffer == NULL)
+        {
+          ferr("ERROR: Failed to allocate an erase block buffer\n");
+          return NULL;
+        }
+    }
+
+  if (load)
+    {
+      nxfrd = MTD_BREAD(dev->mtd, eblock * dev->blkper, dev->blkper,
+                        slot->buffer);
+      if (nxfrd != dev->blkper)
+        {
+          ferr("ERROR: Read erase block %d failed: %d\n", eblock, nxfrd);
+          return NULL;
+        }
+    }
+
+  slot->eblock = eblock;
+  slot->dirty  = false;
+  return slot;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_flush
+ *
+ * Description: Write back all modified erase blocks
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static int ftl_wb_flush(FAR struct ftl_struct_s *dev)
+{
+  int ret = OK;
+  int err;
+  int i;
+
+  for (i = 0; i < CONFIG_FTL_WRITEBACK_NBLOCKS; i++)
+    {
+      err = ftl_wb_writeback(dev, &dev->cache[i]);
+      if (err < 0 && ret == OK)
+        {
+          ret = err;
+        }
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_worker
+ *
+ * Description: Deferred write-back of modified erase blocks
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static void ftl_wb_worker(FAR void *arg)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+
+  ftl_wb_lock(dev);
+  (void)ftl_wb_flush(dev);
+  ftl_wb_unlock(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_read
+ *
+ * Description:
+ *   Read sectors, taking those of the cached erase blocks from the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static ssize_t ftl_wb_read(FAR struct ftl_struct_s *dev,
+                           FAR uint8_t *buffer, off_t startblock,
+                           size_t nblocks)
+{
+  FAR struct ftl_cache_s *slot;
+  size_t remaining = nblocks;
+  size_t nxfr;
+  ssize_t nread;
+  off_t offset;
+
+  while (remaining > 0)
+    {
+      /* Get the part of the read that falls into this erase block */
+
+      offset = startblock % dev->blkper;
+      nxfr   = dev->blkper - offset;
+      if (nxfr > remaining)
+        {
+          nxfr = remaining;
+        }
+
+      slot = ftl_wb_find(dev, startblock / dev->blkper);
+      if (slot != NULL)
+        {
+          memcpy(buffer, slot->buffer + offset * dev->geo.blocksize,
+                 nxfr * dev->geo.blocksize);
+          slot->stamp = ++dev->stamp;
+        }
+      else
+        {
+          nread = MTD_BREAD(dev->mtd, startblock, nxfr, buffer);
+          if (nread != nxfr)
+            {
+              ferr("ERROR: Read %d blocks starting at block %d failed: %d\n",
+                   nxfr, startblock, nread);
+              return nread < 0 ? nread : -EIO;
+            }
+        }
+
+      startblock += nxfr;
+      buffer     += nxfr * dev->geo.blocksize;
+      remaining  -= nxfr;
+    }
+
+  return nblocks;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_write
+ *
+ * Description:
+ *   Merge sectors into the cached erase blocks and schedule the deferred
+ *   write-back.  Whole erase blocks that are not cached are written to
+ *   FLASH directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static ssize_t ftl_wb_write(FAR struct ftl_struct_s *dev,
+                            FAR const uint8_t *buffer, off_t startblock,
+                            size_t nblocks)
+{
+  FAR struct ftl_cache_s *slot;
+  size_t remaining = nblocks;
+  size_t nxfr;
+  ssize_t nxfrd;
+  off_t eblock;
+  off_t offset;
+  int ret;
+
+  while (remaining > 0)
+    {
+      /* Get the part of the write that falls into this erase block */
+
+      eblock = startblock / dev->blkper;
+      offset = startblock % dev->blkper;
+      nxfr   = dev->blkper - offset;
+      if (nxfr > remaining)
+        {
+          nxfr = remaining;
+        }
+
+      slot = ftl_wb_find(dev, eblock);
+      if (slot == NULL && nxfr == dev->blkper)
+        {
+          /* The whole erase block is replaced; no need to cache it */
+
+          ret = MTD_ERASE(dev->mtd, eblock, 1);
+          if (ret < 0)
+            {
+              ferr("ERROR: Erase block=%d failed: %d\n", eblock, ret);
+              return ret;
+            }
+
+          nxfrd = MTD_BWRITE(dev->mtd, startblock, nxfr, buffer);
+          if (nxfrd != nxfr)
+            {
+              ferr("ERROR: Write erase block %d failed: %d\n",
+                   startblock, nxfrd);
+              return -EIO;
+            }
+        }
+      else
+        {
+          /* Merge the sectors into the cached copy of the erase block */
+
+          if (slot == NULL)
+            {
+              slot = ftl_wb_alloc(dev, eblock, true);
+              if (slot == NULL)
+                {
+                  return -EIO;
+                }
+            }
+
+          memcpy(slot->buffer + offset * dev->geo.blocksize, buffer,
+                 nxfr * dev->geo.blocksize);
+          slot->dirty = true;
+          slot->stamp = ++dev->stamp;
+        }
+
+      startblock += nxfr;
+      buffer     += nxfr * dev->geo.blocksize;
+      remaining  -= nxfr;
+    }
+
+  /* Write back the modified erase blocks after a delay.  The delay starts
+   * with the first write that has not yet been written back so that a
+   * steady stream of writes cannot postpone the write-back forever.
+   */
+
+  if (work_available(&dev->work))
+    {
+      (void)work_queue(FTL_WORK, &dev->work, ftl_wb_worker, dev,
+                       FTL_WB_DELAY);
+    }
+
+  return nblocks;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_wb_free
+ *
+ * Description: Release the resources of the write-back cache
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITEBACK
+static void ftl_wb_free(FAR struct ftl_struct_s *dev)
+{
+  int i;
+
+  (void)work_cancel(FTL_WORK, &dev->work);
+
+  for (i = 0; i < CONFIG_FTL_WRITEBACK_NBLOCKS; i++)
+    {
+      if (dev->cache[i].buffer != NULL)
+        {
+          kmm_free(dev->cache[i].buffer);
+        }
+    }
+
+  nxsem_destroy(&dev->exclsem);
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_open
  *
@@ -175,11 +596,20 @@ static int ftl_close(FAR struct inode *inode)
   rwb_flush(&dev->rwb);
 #endif
 
+#ifdef CONFIG_FTL_WRITEBACK
+  ftl_wb_lock(dev);
+  (void)ftl_wb_flush(dev);
+  ftl_wb_unlock(dev);
+#endif
+
   if (--dev->refs == 0 && dev->unlinked)
     {
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_WRITEBACK
+      ftl_wb_free(dev);
+#endif
 #ifdef CONFIG_FS_WRITABLE
       if (dev->eblock)
         {
@@ -205,6 +635,15 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
 
+#ifdef CONFIG_FTL_WRITEBACK
+  /* Modified sectors may still be in the write-back cache */
+
+  ftl_wb_lock(dev);
+  nread = ftl_wb_read(dev, buffer, startblock, nblocks);
+  ftl_wb_unlock(dev);
+  return nread;
+#endif
+
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
@@ -275,6 +714,15 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   int    nbytes;
   int    ret;
 
+#ifdef CONFIG_FTL_WRITEBACK
+  /* Merge the write into the write-back cache */
+
+  ftl_wb_lock(dev);
+  nxfrd = ftl_wb_write(dev, buffer, startblock, nblocks);
+  ftl_wb_unlock(dev);
+  return nxfrd;
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -554,6 +1002,22 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       return rwb_flush(&dev->rwb);
     }
 #endif
+#if defined(FTL_HAVE_RWBUFFER) && defined(CONFIG_DRVR_RWBSTATS)
+  else if (cmd == BIOC_RWBSTATS)
+    {
+      return rwb_getstats(&dev->rwb,
+                          (FAR struct rwb_stats_s *)((uintptr_t)arg));
+    }
+#endif
+#ifdef CONFIG_FTL_WRITEBACK
+  else if (cmd == BIOC_FLUSH)
+    {
+      ftl_wb_lock(dev);
+      ret = ftl_wb_flush(dev);
+      ftl_wb_unlock(dev);
+      return ret;
+    }
+#endif
 
   /* No other block driver ioctl commmands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
@@ -590,6 +1054,12 @@ static int ftl_unlink(FAR struct inode *inode)
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_WRITEBACK
+      ftl_wb_lock(dev);
+      (void)ftl_wb_flush(dev);
+      ftl_wb_unlock(dev);
+      ftl_wb_free(dev);
+#endif
 #ifdef CONFIG_FS_WRITABLE
       if (dev->eblock)
         {
@@ -622,6 +1092,9 @@ static int ftl_unlink(FAR struct inode *inode)
 int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
 {
   struct ftl_struct_s *dev;
+#ifdef CONFIG_FTL_WRITEBACK
+  int i;
+#endif
   int ret = -ENOMEM;
 
   /* Sanity check */
@@ -658,6 +1131,18 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_WRITEBACK
+      /* Initialize the write-back cache.  Erase block buffers are allocated
+       * on first use.
+       */
+
+      nxsem_init(&dev->exclsem, 0, 1);
+      for (i = 0; i < CONFIG_FTL_WRITEBACK_NBLOCKS; i++)
+        {
+          dev->cache[i].eblock = -1;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
@@ -679,6 +1164,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_WRITEBACK
+          nxsem_destroy(&dev->exclsem);
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -692,6 +1180,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_WRITEBACK
+          nxsem_destroy(&dev->exclsem);
 #endif
           kmm_free(dev);
         }
@@ -76,6 +76,19 @@
 
 #define NAND_BLOCKSTATUS_BAD 0xba
 
+/* Multi-page transfers are performed by the lower half.  They are not
+ * possible with software ECC.
+ */
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  ifdef CONFIG_MTD_NAND_SWECC
+#    define nand_multipage(r,m) \
+       ((r)->m != NULL && (r)->ecctype != NANDECC_SWECC)
+#  else
+#    define nand_multipage(r,m) ((r)->m != NULL)
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -107,6 +120,14 @@ static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR const void *data);
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static int      nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, unsigned int npages,
+                  FAR uint8_t *data);
+static int      nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, unsigned int npages,
+                  FAR const void *data);
+#endif
 
 /* MTD driver methods */
 
@@ -539,6 +560,85 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+/****************************************************************************
+ * Name: nand_readpages
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages within one block into the
+ *   provided buffer using the multi-page method of the lower half.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static int nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                          unsigned int page, unsigned int npages,
+                          FAR uint8_t *data)
+{
+  finfo("block=%d page=%d npages=%d data=%p\n",
+        (int)block, page, npages, data);
+
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+  /* Check that the block is not BAD */
+
+  if (nand_checkblock(nand, block) != GOODBLOCK)
+    {
+      ferr("ERROR: Block is BAD\n");
+      return -EAGAIN;
+    }
+#endif
+
+  return NAND_READPAGES(nand->raw, block, page, npages, data);
+}
+#endif
+
+/****************************************************************************
+ * Name: nand_writepages
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages within one block from the
+ *   provided buffer using the multi-page method of the lower half.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static int nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                           unsigned int page, unsigned int npages,
+                           FAR const void *data)
+{
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+  /* Check that the block is good */
+
+  if (nand_checkblock(nand, block) != GOODBLOCK)
+    {
+      ferr("ERROR: Block is BAD\n");
+      return -EAGAIN;
+    }
+#endif
+
+  return NAND_WRITEPAGES(nand->raw, block, page, npages, data);
+}
+#endif
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -595,6 +695,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int nxfr;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -628,7 +729,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then read every page from NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= nxfr)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -641,14 +742,41 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Read the next page from NAND */
+      nxfr = 1;
 
-      ret = nand_readpage(nand, block, page, buffer);
-      if (ret < 0)
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+      /* Read the pages up to the end of this block with one transfer if
+       * the lower half supports it.
+       */
+
+      if (remaining > 1 && nand_multipage(raw, readpages))
         {
-          ferr("ERROR: nand_readpage failed block=%ld page=%d: %d\n",
-               (long)block, page, ret);
-          goto errout_with_lock;
+          nxfr = pagesperblock - page;
+          if (nxfr > remaining)
+            {
+              nxfr = remaining;
+            }
+
+          ret = nand_readpages(nand, block, page, nxfr, buffer);
+          if (ret < 0)
+            {
+              ferr("ERROR: nand_readpages failed block=%ld page=%d: %d\n",
+                   (long)block, page, ret);
+              goto errout_with_lock;
+            }
+        }
+      else
+#endif
+        {
+          /* Read the next page from NAND */
+
+          ret = nand_readpage(nand, block, page, buffer);
+          if (ret < 0)
+            {
+              ferr("ERROR: nand_readpage failed block=%ld page=%d: %d\n",
+                   (long)block, page, ret);
+              goto errout_with_lock;
+            }
         }
 
       /* Increment the page number.  If we exceed the number of
@@ -656,15 +784,16 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += nxfr;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += nxfr * pagesize;
     }
 
   nand_unlock(nand);
@@ -691,6 +820,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int nxfr;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -724,7 +854,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then write every page into NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= nxfr)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -737,14 +867,41 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Write the next page into NAND */
+      nxfr = 1;
 
-      ret = nand_writepage(nand, block, page, buffer);
-      if (ret < 0)
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+      /* Write the pages up to the end of this block with one transfer if
+       * the lower half supports it.
+       */
+
+      if (remaining > 1 && nand_multipage(raw, writepages))
         {
-          ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
-               (long)block, page, ret);
-          goto errout_with_lock;
+          nxfr = pagesperblock - page;
+          if (nxfr > remaining)
+            {
+              nxfr = remaining;
+            }
+
+          ret = nand_writepages(nand, block, page, nxfr, buffer);
+          if (ret < 0)
+            {
+              ferr("ERROR: nand_writepages failed block=%ld page=%d: %d\n",
+                   (long)block, page, ret);
+              goto errout_with_lock;
+            }
+        }
+      else
+#endif
+        {
+          /* Write the next page into NAND */
+
+          ret = nand_writepage(nand, block, page, buffer);
+          if (ret < 0)
+            {
+              ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
+                   (long)block, page, ret);
+              goto errout_with_lock;
+            }
         }
 
       /* Increment the page number.  If we exceed the number of
@@ -752,15 +909,16 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += nxfr;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += nxfr * pagesize;
     }
 
   nand_unlock(nand);
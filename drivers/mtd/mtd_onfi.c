@@ -80,6 +80,12 @@
 
 #define NAND_CMD_RESET           0xff
 #define NAND_CMD_READ0           0x00
+#define NAND_CMD_READ1           0x30
+#define NAND_CMD_READ_CACHE      0x31
+#define NAND_CMD_READ_CACHE_END  0x3f
+#define NAND_CMD_PROGRAM0        0x80
+#define NAND_CMD_PROGRAM1        0x10
+#define NAND_CMD_PROGRAM_CACHE   0x15
 #define NAND_CMD_READID          0x90
 #define NAND_CMD_STATUS          0x70
 #define NAND_CMD_READ_PARAM_PAGE 0xec
@@ -118,59 +124,94 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: onfi_readstatus
+ * Name: onfi_waitstatus
  *
  * Description:
- *   This function Reads the status register of the NAND device by issuing a
- *   0x70 command.
+ *   Issue the read status command and wait until all of the 'ready' bits
+ *   are set.
  *
  * Input Parameters:
  *   cmdaddr  - NAND command address base
  *   dataaddr - NAND data address
+ *   ready    - The status bits that indicate completion
+ *   fail     - The status bits that indicate failure
  *
  * Returned Value:
- *   OK        : The function completed operation successfully
- *  -EIO       : The function dif not complete operation successfully
+ *   OK        : The operation completed successfully
+ *  -EIO       : One of the 'fail' bits is set
  *  -ETIMEDOUT : A time out occurred before the operation completed
  *
  ****************************************************************************/
 
-static int onfi_readstatus(uintptr_t cmdaddr, uintptr_t dataaddr)
+static int onfi_waitstatus(uintptr_t cmdaddr, uintptr_t dataaddr,
+                           uint8_t ready, uint8_t fail)
 {
   uint32_t timeout;
   uint8_t status;
 
-  /* Issue command */
-
   WRITE_NAND_COMMAND(NAND_CMD_STATUS, cmdaddr);
-  timeout = 0;
 
-  while (timeout < MAX_READ_STATUS_COUNT)
+  for (timeout = 0; timeout < MAX_READ_STATUS_COUNT; timeout++)
     {
-      /* Read status byte */
-
       status = READ_NAND(dataaddr);
+      if ((status & ready) == ready)
+        {
+          return (status & fail) == 0 ? OK : -EIO;
+        }
+    }
 
-      /* Check status. If status bit 6 = 1 device is ready */
+  return -ETIMEDOUT;
+}
 
-      if ((status & STATUS_BIT_6) == STATUS_BIT_6)
-        {
-          /* If status bit 0 = 0 the last operation was successful */
+/****************************************************************************
+ * Name: onfi_writeaddr
+ *
+ * Description:
+ *   Write the address cycles of a full page access:  Two column cycles of
+ *   zero followed by the row address cycles.
+ *
+ ****************************************************************************/
 
-          if ((status & STATUS_BIT_0) == 0)
-            {
-              return OK;
-            }
-          else
-            {
-              return -EIO;
-            }
-        }
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static void onfi_writeaddr(uintptr_t addraddr, uint32_t rowaddr,
+                           unsigned int rowcycles)
+{
+  WRITE_NAND_ADDRESS(0, addraddr);
+  WRITE_NAND_ADDRESS(0, addraddr);
 
-      timeout++;
+  for (; rowcycles > 0; rowcycles--)
+    {
+      WRITE_NAND_ADDRESS(rowaddr & 0xff, addraddr);
+      rowaddr >>= 8;
     }
+}
+#endif
 
-  return -ETIMEDOUT;
+/****************************************************************************
+ * Name: onfi_readstatus
+ *
+ * Description:
+ *   This function Reads the status register of the NAND device by issuing a
+ *   0x70 command.
+ *
+ * Input Parameters:
+ *   cmdaddr  - NAND command address base
+ *   dataaddr - NAND data address
+ *
+ * Returned Value:
+ *   OK        : The function completed operation successfully
+ *  -EIO       : The function dif not complete operation successfully
+ *  -ETIMEDOUT : A time out occurred before the operation completed
+ *
+ ****************************************************************************/
+
+static int onfi_readstatus(uintptr_t cmdaddr, uintptr_t dataaddr)
+{
+  /* If status bit 6 = 1 device is ready.  If status bit 0 = 0 the last
+   * operation was successful.
+   */
+
+  return onfi_waitstatus(cmdaddr, dataaddr, STATUS_BIT_6, STATUS_BIT_0);
 }
 
 /****************************************************************************
@@ -356,12 +397,17 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->model = *(FAR uint8_t *)(parmtab + 49);
 
+  /* Optional commands supported (bytes 8-9 in the param table) */
+
+  onfi->optcmds = *(FAR uint16_t *)(FAR void *)(parmtab + 8);
+
   finfo("Returning:\n");
   finfo("  manufacturer:  0x%02x\n", onfi->manufacturer);
   finfo("  buswidth:      %d\n",     onfi->buswidth);
   finfo("  luns:          %d\n",     onfi->luns);
   finfo("  eccsize:       %d\n",     onfi->eccsize);
   finfo("  model:         0x%02s\n", onfi->model);
+  finfo("  optcmds:       0x%04x\n", onfi->optcmds);
   finfo("  sparesize:     %d\n",     onfi->sparesize);
   finfo("  pagesperblock: %d\n",     onfi->pagesperblock);
   finfo("  blocksperlun:  %d\n",     onfi->blocksperlun);
@@ -504,3 +550,157 @@ bool onfi_ebidetect(uintptr_t cmdaddr, uintptr_t addraddr,
 
   return found;
 }
+
+/****************************************************************************
+ * Name: onfi_cacheread
+ *
+ * Description:
+ *   Read consecutive pages with the read cache sequential command so that
+ *   the array read of the next page overlaps the data output of the
+ *   current page.
+ *
+ * Input Parameters:
+ *   cmdaddr   - NAND command address base
+ *   addraddr  - NAND address address base
+ *   dataaddr  - NAND data address
+ *   rowaddr   - Row address of the first page
+ *   rowcycles - Number of row address cycles of the device
+ *   pagesize  - Number of data bytes per page
+ *   npages    - Number of pages to read
+ *   buffer    - Buffer where the data will be stored
+ *
+ * Returned Value:
+ *   OK is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+int onfi_cacheread(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
+                   uint32_t rowaddr, unsigned int rowcycles,
+                   unsigned int pagesize, unsigned int npages,
+                   FAR uint8_t *buffer)
+{
+  unsigned int i;
+  unsigned int j;
+
+  finfo("rowaddr=%08lx npages=%u\n", (unsigned long)rowaddr, npages);
+
+  /* Read the first page into the data register */
+
+  WRITE_NAND_COMMAND(NAND_CMD_READ0, cmdaddr);
+  onfi_writeaddr(addraddr, rowaddr, rowcycles);
+  WRITE_NAND_COMMAND(NAND_CMD_READ1, cmdaddr);
+
+  if (onfi_readstatus(cmdaddr, dataaddr) == -ETIMEDOUT)
+    {
+      return -ETIMEDOUT;
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      /* Move the page into the cache register.  Except for the last page,
+       * this also starts the array read of the next page.
+       */
+
+      WRITE_NAND_COMMAND(i + 1 < npages ? NAND_CMD_READ_CACHE :
+                         NAND_CMD_READ_CACHE_END, cmdaddr);
+
+      if (onfi_readstatus(cmdaddr, dataaddr) == -ETIMEDOUT)
+        {
+          return -ETIMEDOUT;
+        }
+
+      /* Re-enable data output mode required after Read Status command */
+
+      WRITE_NAND_COMMAND(NAND_CMD_READ0, cmdaddr);
+
+      for (j = 0; j < pagesize; j++)
+        {
+          *buffer++ = READ_NAND(dataaddr);
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: onfi_cacheprogram
+ *
+ * Description:
+ *   Program consecutive pages with the page cache program command so that
+ *   the data input of the next page overlaps the programming of the
+ *   current page.
+ *
+ * Input Parameters:
+ *   cmdaddr   - NAND command address base
+ *   addraddr  - NAND address address base
+ *   dataaddr  - NAND data address
+ *   rowaddr   - Row address of the first page
+ *   rowcycles - Number of row address cycles of the device
+ *   pagesize  - Number of data bytes per page
+ *   npages    - Number of pages to program
+ *   buffer    - Buffer containing the data to be written
+ *
+ * Returned Value:
+ *   OK is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+int onfi_cacheprogram(uintptr_t cmdaddr, uintptr_t addraddr,
+                      uintptr_t dataaddr, uint32_t rowaddr,
+                      unsigned int rowcycles, unsigned int pagesize,
+                      unsigned int npages, FAR const uint8_t *buffer)
+{
+  unsigned int i;
+  unsigned int j;
+  int ret;
+
+  finfo("rowaddr=%08lx npages=%u\n", (unsigned long)rowaddr, npages);
+
+  for (i = 0; i < npages; i++)
+    {
+      WRITE_NAND_COMMAND(NAND_CMD_PROGRAM0, cmdaddr);
+      onfi_writeaddr(addraddr, rowaddr + i, rowcycles);
+
+      for (j = 0; j < pagesize; j++)
+        {
+          WRITE_NAND(*buffer++, dataaddr);
+        }
+
+      if (i + 1 < npages)
+        {
+          /* Wait only for the cache register (status bit 6).  Status
+           * bit 1 reports the failure of the previous page.
+           */
+
+          WRITE_NAND_COMMAND(NAND_CMD_PROGRAM_CACHE, cmdaddr);
+          ret = onfi_waitstatus(cmdaddr, dataaddr, STATUS_BIT_6,
+                                STATUS_BIT_1);
+        }
+      else
+        {
+          /* Wait for the array (status bit 5) to complete the last page and
+           * check both the last and the previous page.
+           */
+
+          WRITE_NAND_COMMAND(NAND_CMD_PROGRAM1, cmdaddr);
+          ret = onfi_waitstatus(cmdaddr, dataaddr,
+                                STATUS_BIT_5 | STATUS_BIT_6,
+                                STATUS_BIT_0 | STATUS_BIT_1);
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Cache program failed at row %08lx: %d\n",
+               (unsigned long)(rowaddr + i), ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
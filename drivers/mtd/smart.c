@@ -58,7 +58,10 @@
 #include <crc32.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -71,6 +74,19 @@
 
 //#define CONFIG_SMART_LOCAL_CHECKFREE
 
+#if !defined(CONFIG_FS_WRITABLE) || !defined(CONFIG_SCHED_WORKQUEUE)
+#  undef CONFIG_MTD_SMART_BGCOLLECT
+#endif
+
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+#  define SMART_BGDELAY     MSEC2TICK(CONFIG_MTD_SMART_BGCOLLECT_DELAY)
+#  define smart_lock(d)     (void)nxsem_wait_uninterruptible(&(d)->exclsem)
+#  define smart_unlock(d)   (void)nxsem_post(&(d)->exclsem)
+#else
+#  define smart_lock(d)
+#  define smart_unlock(d)
+#endif
+
 #define SMART_STATUS_COMMITTED    0x80
 #define SMART_STATUS_RELEASED     0x40
 #define SMART_STATUS_CRC          0x20
@@ -225,6 +241,7 @@ struct smart_struct_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   uint32_t              unusedsectors;    /* Count of unused sectors (i.e. free when erased) */
   uint32_t              blockerases;      /* Count of unused sectors (i.e. free when erased) */
+  uint32_t              relocations;      /* Count of sectors relocated by a write */
 #endif
   uint16_t              neraseblocks;     /* Number of erase blocks or sub-sectors */
   uint16_t              lastallocblock;   /* Last  block we allocated a sector from */
@@ -267,6 +284,10 @@ struct smart_struct_s
   uint16_t              cache_lastlog;    /* Keep track of the last sector accessed */
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  uint32_t              cache_hits;       /* Number of cache lookup hits */
+  uint32_t              cache_misses;     /* Number of lookups that scanned the volume */
+#endif
 #endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
@@ -275,6 +296,13 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+  sem_t                 exclsem;          /* Serializes the background work */
+  struct work_s         work;             /* Background collection work */
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  uint16_t              wlblock;          /* Worn block waiting for static data */
+#endif
+#endif
 };
 
 #define SMART_WEARFLAGS_FORCE_REORG    0x01
@@ -827,6 +855,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -836,7 +865,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_lock(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -873,7 +906,7 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_lock(dev);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -912,9 +945,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -941,9 +972,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -955,6 +984,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 #endif /* CONFIG_FS_WRITABLE */
@@ -1072,6 +1102,7 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   dev->unusedsectors = 0;
+  dev->relocations = 0;
   dev->blockerases = 0;
 #endif
 
@@ -1094,6 +1125,10 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
   dev->cache_entries = 0;
   dev->cache_lastlog = 0xffff;
   dev->cache_nextbirth = 0;
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  dev->cache_hits = 0;
+  dev->cache_misses = 0;
+#endif
 #endif
 
   if (dev->rwbuffer != NULL)
@@ -1373,6 +1408,36 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_touch_cache_entry
+ *
+ * Description: Mark a sector map cache entry as the most recently used.
+ *              When the aging value is about to wrap, all birthdays are
+ *              halved.  This keeps their relative order so that the least
+ *              recently used entry is still the one with the lowest value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_touch_cache_entry(FAR struct smart_struct_s *dev,
+                                    uint16_t index)
+{
+  uint16_t    x;
+
+  if (dev->cache_nextbirth == 0xffff)
+    {
+      for (x = 0; x < dev->cache_entries; x++)
+        {
+          dev->sCache[x].birth >>= 1;
+        }
+
+      dev->cache_nextbirth >>= 1;
+    }
+
+  dev->sCache[index].birth = dev->cache_nextbirth++;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1380,9 +1445,8 @@ errout:
  *              map cache.  The cache is used to minimize RAM by eliminating
  *              a one-to-one mapping of all logical sectors and only keeping
  *              a fixed number of mappings per the
- *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  Sectors are
- *              automatically managed and removed based on the time since
- *              they were accessed last.
+ *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  When the cache
+ *              is full, the least recently used entry is replaced.
  *
  ****************************************************************************/
 
@@ -1398,7 +1462,6 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
   index = 1;
   if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
     {
-      oldest = 0;
       index  = dev->cache_entries++;
     }
   else
@@ -1413,7 +1476,7 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
           if (dev->sCache[x].logical < SMART_FIRST_ALLOC_SECTOR)
             continue;
 
-          /* If the hit count is zero, then choose this entry */
+          /* Choose the least recently used entry */
 
           if (dev->sCache[x].birth < oldest)
             {
@@ -1427,7 +1490,7 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
 
   dev->sCache[index].logical = logical;
   dev->sCache[index].physical = physical;
-  dev->sCache[index].birth = dev->cache_nextbirth++;
+  smart_touch_cache_entry(dev, index);
   dev->cache_lastlog = logical;
   dev->cache_lastphys = physical;
 
@@ -1437,18 +1500,6 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
           logical, physical, index, line);
     }
 
-  /* Test if the birthdays need to be adjusted */
-
-  if (oldest >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + 1024)
-    {
-      for (x = 0; x < dev->cache_entries; x++)
-        {
-          dev->sCache[x].birth -= 1024;
-        }
-
-      dev->cache_nextbirth -= 1024;
-    }
-
   return index;
 }
 #endif
@@ -1457,10 +1508,11 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
  * Name: smart_cache_lookup
  *
  * Description: Perform a cache lookup for the requested logical sector.
- *              If the sector is in the cache, then update the hitcount and
- *              return the physical mapping.  If a cache miss occurs, then
- *              the routine will scan the volume to find the logical sector
- *              and add / replace a cache entry with the newly located sector.
+ *              If the sector is in the cache, then mark it as most recently
+ *              used and return the physical mapping.  If a cache miss
+ *              occurs, then the routine will scan the volume to find the
+ *              logical sector and replace the least recently used cache
+ *              entry with the newly located sector.
  *
  ****************************************************************************/
 
@@ -1479,6 +1531,9 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
   if (logical == dev->cache_lastlog)
     {
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+      dev->cache_hits++;
+#endif
       return dev->cache_lastphys;
     }
 
@@ -1491,6 +1546,10 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
           /* Entry found in the cache.  Grab the physical mapping. */
 
           physical = dev->sCache[x].physical;
+          smart_touch_cache_entry(dev, x);
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+          dev->cache_hits++;
+#endif
           break;
         }
     }
@@ -1501,6 +1560,10 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
   if (physical == 0xffff)
     {
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+      dev->cache_misses++;
+#endif
+
       /* Now scan the MTD device.  Instead of scanning start to end, we
        * span the erase blocks and read one sector from each at a time.
        * this helps speed up the search on volumes that aren't full
@@ -1616,6 +1679,7 @@ static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t
             {
                 dev->sCache[x].logical = dev->sCache[dev->cache_entries-1].logical;
                 dev->sCache[x].physical = dev->sCache[dev->cache_entries-1].physical;
+                dev->sCache[x].birth = dev->sCache[dev->cache_entries-1].birth;
                 dev->cache_entries--;
             }
 
@@ -2563,7 +2627,15 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
        * be worn less).
        */
 
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+#if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && defined(CONFIG_MTD_SMART_BGCOLLECT)
+      /* Leave the relocation to the background work */
+
+      if (!forceerase && smart_get_wear_level(dev, block) >=
+          SMART_WEAR_FULL_RELOCATE_THRESHOLD)
+        {
+          dev->wlblock = block;
+        }
+#elif defined(CONFIG_MTD_SMART_WEAR_LEVEL)
       if (!forceerase)
         {
           smart_relocate_static_data(dev, block);
@@ -4414,6 +4486,9 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
     {
       /* Find a new physical sector to save data to */
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+      dev->relocations++;
+#endif
       oldphyssector = physsector;
       physsector = smart_findfreephyssector(dev, FALSE);
       if (physsector == 0xffff)
@@ -5167,6 +5242,154 @@ errout:
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_bgcollect
+ *
+ * Description:  Performs one step of the background work:  Either the
+ *               deferred static data relocation into a worn erase block or
+ *               the collection of the erase block with the most released
+ *               sectors, if at least half of its sectors are released.
+ *               Returns true if a step was performed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+static bool smart_bgcollect(FAR struct smart_struct_s *dev)
+{
+  uint16_t  collectblock;
+  uint16_t  releasemax;
+  uint16_t  release;
+  uint16_t  freecnt;
+  uint16_t  live;
+  int       x;
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wlblock != 0xffff)
+    {
+      uint16_t block = dev->wlblock;
+
+      dev->wlblock = 0xffff;
+
+      /* The relocation fills the block from its first sector, so it must
+       * still be erased.
+       */
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      freecnt = smart_get_count(dev, dev->freecount, block);
+      release = smart_get_count(dev, dev->releasecount, block);
+#else
+      freecnt = dev->freecount[block];
+      release = dev->releasecount[block];
+#endif
+
+      if (freecnt + release == dev->availSectPerBlk && release <= 2 &&
+          (release == 0 || (block == dev->geo.neraseblocks - 1 &&
+                            dev->totalsectors == 65534)))
+        {
+          finfo("Background static data relocation to block %d\n", block);
+          (void)smart_relocate_static_data(dev, block);
+          return true;
+        }
+    }
+#endif
+
+  /* Find the block with the most released sectors */
+
+  collectblock = 0xffff;
+  releasemax   = 0;
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      release = smart_get_count(dev, dev->releasecount, x);
+#else
+      release = dev->releasecount[x];
+#endif
+      if (release > releasemax)
+        {
+          releasemax   = release;
+          collectblock = x;
+        }
+    }
+
+  if (collectblock == 0xffff || releasemax < (dev->availSectPerBlk + 1) / 2)
+    {
+      return false;
+    }
+
+  /* Only collect if the live sectors fit into the freecnt sectors of the
+   * other blocks.  Keep the reserve of the foreground collection.
+   */
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  freecnt = smart_get_count(dev, dev->freecount, collectblock);
+#else
+  freecnt = dev->freecount[collectblock];
+#endif
+
+  live = dev->availSectPerBlk - releasemax - freecnt;
+  if (dev->freesectors < freecnt + live + dev->sectorsPerBlk + 4)
+    {
+      return false;
+    }
+
+  finfo("Background collection of block %d, released=%d\n",
+        collectblock, releasemax);
+
+  return smart_relocate_block(dev, collectblock) == OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_bgworker
+ *
+ * Description:  The background garbage collection and wear leveling work.
+ *               The device is locked for one step at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+static void smart_bgworker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  bool more;
+
+  /* Never wait for the device on the worker thread.  If it is in use, the
+   * work is queued again when the access completes.
+   */
+
+  if (nxsem_trywait(&dev->exclsem) < 0)
+    {
+      return;
+    }
+
+  more = smart_bgcollect(dev);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  /* Continue with the next step, if any, after any pending access */
+
+  if (more)
+    {
+      (void)work_queue(LPWORK, &dev->work, smart_bgworker, dev, 0);
+    }
+
+  smart_unlock(dev);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -5192,6 +5415,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  smart_lock(dev);
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5208,7 +5433,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5316,6 +5542,14 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
       procfs_data->uneven_wearcount = dev->uneven_wearcount;
+      procfs_data->minwearlevel   = dev->minwearlevel;
+      procfs_data->maxwearlevel   = dev->maxwearlevel;
+#endif
+      procfs_data->relocations    = dev->relocations;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+      procfs_data->cacheentries   = dev->cache_entries;
+      procfs_data->cachehits      = dev->cache_hits;
+      procfs_data->cachemisses    = dev->cache_misses;
 #endif
       ret = OK;
       goto ok_out;
@@ -5350,6 +5584,20 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+  /* Writes and frees may create work for the background collection.  Any
+   * access restarts the idle delay of pending work.
+   */
+
+  if (cmd == BIOC_WRITESECT || cmd == BIOC_FREESECT ||
+      !work_available(&dev->work))
+    {
+      (void)work_queue(LPWORK, &dev->work, smart_bgworker, dev,
+                       SMART_BGDELAY);
+    }
+#endif
+
+  smart_unlock(dev);
   return ret;
 }
 
@@ -5398,6 +5646,13 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 
       dev->mtd = mtd;
 
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+      nxsem_init(&dev->exclsem, 0, 1);
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      dev->wlblock = 0xffff;
+#endif
+#endif
+
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
        * from the size of a pointer).
@@ -5545,6 +5800,9 @@ errout:
       smart_free(dev, rootdirdev);
     }
 #endif
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+  nxsem_destroy(&dev->exclsem);
+#endif
 
   kmm_free(dev);
   return ret;
@@ -5662,6 +5920,13 @@ static int smart_loteardown(FAR const char *devname)
 
   /* Now teardown the filemtd */
 
+#ifdef CONFIG_MTD_SMART_BGCOLLECT
+  smart_lock(dev);
+  (void)work_cancel(LPWORK, &dev->work);
+  smart_unlock(dev);
+  nxsem_destroy(&dev->exclsem);
+#endif
+
   filemtd_teardown(dev->mtd);
   unregister_blockdriver(devname);
 
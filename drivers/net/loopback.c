@@ -522,6 +522,15 @@ int localhost_initialize(void)
   priv->lo_dev.d_buf     = g_iobuffer;   /* Attach the IO buffer */
   priv->lo_dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
 
+#ifdef CONFIG_NETDEV_LOOPBACK_NOCHKSUM
+  /* Looped-back packets are never corrupted.  There is no need to compute
+   * or to verify any checksum.
+   */
+
+  priv->lo_dev.d_offload = NETDEV_TXCSUM_IP | NETDEV_TXCSUM_L4 |
+                           NETDEV_RXCSUM_IP | NETDEV_RXCSUM_L4;
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmissions */
 
   priv->lo_polldog       = wd_create();  /* Create periodic poll timer */
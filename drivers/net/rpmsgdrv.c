@@ -145,6 +145,25 @@
 
 #define NET_RPMSG_DRV_WDDELAY      (1*CLK_TCK)
 
+/* The space taken by a frame of n bytes in a NET_RPMSG_BATCH message */
+
+#define NET_RPMSG_DRV_FRAMESIZE(n) \
+  ((sizeof(struct net_rpmsg_frame_s) + (n) + NET_RPMSG_FRAME_ALIGN - 1) & \
+   ~(NET_RPMSG_FRAME_ALIGN - 1))
+
+/* The checksums left to the remote in outgoing frames */
+
+#ifdef CONFIG_NET_RPMSG_TXCSUM
+#  define NET_RPMSG_DRV_TXFLAGS    (NET_RPMSG_FRAME_CSUM_IP | \
+                                    NET_RPMSG_FRAME_CSUM_L4)
+#else
+#  define NET_RPMSG_DRV_TXFLAGS    0
+#endif
+
+#ifndef MIN
+#  define MIN(a,b)                 ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -167,6 +186,16 @@ struct net_rpmsg_drv_s
   WDOG_ID               txpoll;   /* TX poll timer */
   struct work_s         pollwork; /* For deferring poll work to the work queue */
 
+#ifdef CONFIG_NET_RPMSG_BATCH
+  /* The TX buffer that collects the outgoing frames */
+
+  FAR struct net_rpmsg_batch_s *txbatch;
+  uint32_t              txlen;    /* The bytes used in txbatch */
+  uint32_t              bufsize;  /* The size of an rpmsg buffer */
+  uint16_t              pktsize;  /* The packet size of the link layer */
+  FAR uint8_t           *rxbuf;   /* Holds the frames received in a batch */
+#endif
+
   /* This holds the information visible to the NuttX network */
 
   struct net_driver_s  dev;      /* Interface understood by the network */
@@ -178,6 +207,12 @@ struct net_rpmsg_drv_s
 
 /* Common TX logic */
 
+#ifdef CONFIG_NET_RPMSG_BATCH
+static void net_rpmsg_drv_flush(FAR struct net_driver_s *dev);
+static FAR struct net_rpmsg_frame_s *
+net_rpmsg_drv_nextframe(FAR struct net_driver_s *dev);
+#endif
+static void net_rpmsg_drv_getbuf(FAR struct net_driver_s *dev);
 static int  net_rpmsg_drv_transmit(FAR struct net_driver_s *dev,
                                    bool nocopy);
 static int  net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev);
@@ -194,6 +229,11 @@ static int net_rpmsg_drv_sockioctl_handler(FAR struct rpmsg_endpoint *ept,
 static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
                                           FAR void *data, size_t len,
                                           uint32_t src, FAR void *priv);
+#ifdef CONFIG_NET_RPMSG_BATCH
+static int net_rpmsg_drv_batch_handler(FAR struct rpmsg_endpoint *ept,
+                                       FAR void *data, size_t len,
+                                       uint32_t src, FAR void *priv);
+#endif
 
 static void net_rpmsg_drv_device_created(FAR struct rpmsg_device *rdev,
                                          FAR void *priv_);
@@ -247,6 +287,9 @@ static const rpmsg_ept_cb g_net_rpmsg_drv_handler[] =
   [NET_RPMSG_DEVIOCTL]  = net_rpmsg_drv_default_handler,
   [NET_RPMSG_SOCKIOCTL] = net_rpmsg_drv_sockioctl_handler,
   [NET_RPMSG_TRANSFER]  = net_rpmsg_drv_transfer_handler,
+#ifdef CONFIG_NET_RPMSG_BATCH
+  [NET_RPMSG_BATCH]     = net_rpmsg_drv_batch_handler,
+#endif
 };
 
 /****************************************************************************
@@ -272,6 +315,157 @@ static void net_rpmsg_drv_wait(FAR sem_t *sem)
   while (ret == -EINTR);
 }
 
+/****************************************************************************
+ * Name: net_rpmsg_drv_flush
+ *
+ * Description:
+ *   Send the frames collected in the TX buffer as one NET_RPMSG_BATCH
+ *   message.  An empty TX buffer is kept for the next frame.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RPMSG_BATCH
+static void net_rpmsg_drv_flush(FAR struct net_driver_s *dev)
+{
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  FAR struct net_rpmsg_batch_s *msg = priv->txbatch;
+  uint32_t count;
+  int ret;
+
+  if (msg == NULL || msg->count == 0)
+    {
+      return;
+    }
+
+  count               = msg->count;
+  msg->header.command = NET_RPMSG_BATCH;
+  msg->header.result  = 0;
+  msg->header.cookie  = 0;
+
+  priv->txbatch = NULL;
+  ret = rpmsg_send_nocopy(&priv->ept, msg, priv->txlen);
+
+  for (; count > 0; count--)
+    {
+      if (ret < 0)
+        {
+          NETDEV_TXERRORS(dev);
+        }
+      else
+        {
+          NETDEV_TXDONE(dev);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_nextframe
+ *
+ * Description:
+ *   Return the next free frame in the TX buffer.  If a packet of the full
+ *   size no longer fits, the collected frames are sent first.  A new TX
+ *   buffer is taken if there is none.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   The free frame or NULL if no TX buffer is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct net_rpmsg_frame_s *
+net_rpmsg_drv_nextframe(FAR struct net_driver_s *dev)
+{
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  uint32_t size;
+
+  if (priv->txbatch != NULL &&
+      priv->txlen + NET_RPMSG_DRV_FRAMESIZE(dev->d_pktsize) > priv->bufsize)
+    {
+      net_rpmsg_drv_flush(dev);
+    }
+
+  if (priv->txbatch == NULL)
+    {
+      priv->txbatch = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
+      if (priv->txbatch == NULL)
+        {
+          return NULL;
+        }
+
+      priv->txbatch->count = 0;
+      priv->txlen          = sizeof(struct net_rpmsg_batch_s);
+      priv->bufsize        = size;
+
+      /* Keep the packets to the size of the link layer so that several
+       * of them fit into one buffer.
+       */
+
+      size -= sizeof(struct net_rpmsg_batch_s) +
+              sizeof(struct net_rpmsg_frame_s);
+      dev->d_pktsize = MIN(priv->pktsize,
+                           size & ~(NET_RPMSG_FRAME_ALIGN - 1));
+    }
+
+  return (FAR struct net_rpmsg_frame_s *)
+    ((FAR uint8_t *)priv->txbatch + priv->txlen);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_getbuf
+ *
+ * Description:
+ *   Point dev->d_buf to the space for the next outgoing packet, if it does
+ *   not point there yet.  dev->d_buf is NULL if no TX buffer is available.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void net_rpmsg_drv_getbuf(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_RPMSG_BATCH
+  FAR struct net_rpmsg_frame_s *frame;
+
+  frame = net_rpmsg_drv_nextframe(dev);
+  dev->d_buf = frame != NULL ? frame->data : NULL;
+#else
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  uint32_t size;
+
+  if (dev->d_buf == NULL)
+    {
+      dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
+      if (dev->d_buf)
+        {
+          dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
+          dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
+        }
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: net_rpmsg_drv_transmit
  *
@@ -292,8 +486,12 @@ static void net_rpmsg_drv_wait(FAR sem_t *sem)
 static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
 {
   FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+#ifdef CONFIG_NET_RPMSG_BATCH
+  FAR struct net_rpmsg_frame_s *frame;
+#else
   FAR struct net_rpmsg_transfer_s *msg;
   int ret;
+#endif
 
   /* Verify that the hardware is ready to send another packet. If we get
    * here, then we are committed to sending a packet; Higher level logic
@@ -305,6 +503,36 @@ static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
   net_rpmsg_drv_dumppacket("transmit", dev->d_buf, dev->d_len);
   NETDEV_TXPACKETS(dev);
 
+#ifdef CONFIG_NET_RPMSG_BATCH
+  /* Add the packet to the TX buffer.  It is sent by the next
+   * net_rpmsg_drv_flush().
+   */
+
+  if (nocopy)
+    {
+      /* The packet was built in the next free frame */
+
+      frame = (FAR struct net_rpmsg_frame_s *)dev->d_buf - 1;
+    }
+  else
+    {
+      frame = net_rpmsg_drv_nextframe(dev);
+      if (frame == NULL || dev->d_len > dev->d_pktsize)
+        {
+          NETDEV_TXERRORS(dev);
+          return -ENOMEM;
+        }
+
+      memcpy(frame->data, dev->d_buf, dev->d_len);
+    }
+
+  frame->length = dev->d_len;
+  frame->flags  = NET_RPMSG_DRV_TXFLAGS;
+
+  priv->txlen += NET_RPMSG_DRV_FRAMESIZE(dev->d_len);
+  priv->txbatch->count++;
+  return OK;
+#else
   /* Send the packet: address=dev->d_buf, length=dev->d_len */
 
   msg = (FAR struct net_rpmsg_transfer_s *)dev->d_buf - 1;
@@ -333,6 +561,7 @@ static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
       NETDEV_TXDONE(dev);
       return OK;
     }
+#endif
 }
 
 /****************************************************************************
@@ -360,9 +589,6 @@ static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
 
 static int net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev)
 {
-  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
-  uint32_t size;
-
   /* If the polling resulted in data that should be sent out on the network,
    * the field d_len is set to a value > 0.
    */
@@ -397,13 +623,8 @@ static int net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev)
            * return a non-zero value to terminate the poll.
            */
 
-          dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
-          if (dev->d_buf)
-            {
-              dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
-              dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
-            }
-
+          dev->d_buf = NULL;
+          net_rpmsg_drv_getbuf(dev);
           return dev->d_buf == NULL;
         }
     }
@@ -599,52 +820,64 @@ static bool net_rpmsg_drv_is_arp(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Name: net_rpmsg_drv_transfer_handler
+ * Name: net_rpmsg_drv_input
  *
  * Description:
- *   An message was received indicating the availability of a new RX packet
+ *   Dispatch one received frame to the network.  The frame is processed
+ *   in place, so the buffer must have room for a reply of the full packet
+ *   size.
  *
  * Parameters:
- *   ept - Reference to the endpoint which receive the message
+ *   dev    - Reference to the NuttX driver state structure
+ *   data   - The frame
+ *   length - The length of the frame
+ *   flags  - The checksums verified by the remote, see
+ *            NET_RPMSG_FRAME_CSUM_IP
  *
  * Returned Value:
- *   OK on success
+ *   None
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
-                                          FAR void *data, size_t len,
-                                          uint32_t src, FAR void *priv)
+static void net_rpmsg_drv_input(FAR struct net_driver_s *dev,
+                                FAR uint8_t *data, uint32_t length,
+                                uint32_t flags)
 {
-  FAR struct net_driver_s *dev = ept->priv;
-  FAR struct net_rpmsg_transfer_s *msg = data;
-  FAR void *oldbuf;
-
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
-   */
-
-  net_lock();
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint8_t offload = dev->d_offload;
+#endif
 
   /* Check for errors and update statistics */
 
-  net_rpmsg_drv_dumppacket("receive", msg->data, msg->length);
+  net_rpmsg_drv_dumppacket("receive", data, length);
 
   NETDEV_RXPACKETS(dev);
 
-  /* Copy the data from the hardware to dev->d_buf. Set
-   * amount of data in dev->d_len
+  /* Set dev->d_buf to the received frame and the amount of data in
+   * dev->d_len.
    */
 
-  oldbuf = dev->d_buf;
+  dev->d_buf = data;
+  dev->d_len = length;
 
-  dev->d_buf = msg->data;
-  dev->d_len = msg->length;
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Do not verify again the checksums that the remote has verified */
+
+  if ((flags & NET_RPMSG_FRAME_CSUM_IP) != 0)
+    {
+      dev->d_offload |= NETDEV_RXCSUM_IP;
+    }
+
+  if ((flags & NET_RPMSG_FRAME_CSUM_L4) != 0)
+    {
+      dev->d_offload |= NETDEV_RXCSUM_L4;
+    }
+#else
+  UNUSED(flags);
+#endif
 
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the packet tap */
@@ -709,11 +942,177 @@ static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
       NETDEV_RXDROPPED(dev);
     }
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_offload = offload;
+#endif
+}
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_rxdone
+ *
+ * Description:
+ *   Restore dev->d_buf after the received frames have been dispatched.
+ *   With CONFIG_NET_RPMSG_BATCH, the replies collected in the TX buffer
+ *   are sent now.
+ *
+ * Parameters:
+ *   dev    - Reference to the NuttX driver state structure
+ *   oldbuf - The value of dev->d_buf before the frames were dispatched
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void net_rpmsg_drv_rxdone(FAR struct net_driver_s *dev,
+                                 FAR uint8_t *oldbuf)
+{
+#ifdef CONFIG_NET_RPMSG_BATCH
+  /* The replies may have used the frame that oldbuf pointed to.  The next
+   * poll takes a new one.
+   */
+
+  UNUSED(oldbuf);
+
+  net_rpmsg_drv_flush(dev);
+  dev->d_buf = NULL;
+#else
   dev->d_buf = oldbuf;
+#endif
+}
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_transfer_handler
+ *
+ * Description:
+ *   An message was received indicating the availability of a new RX packet
+ *
+ * Parameters:
+ *   ept - Reference to the endpoint which receive the message
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
+                                          FAR void *data, size_t len,
+                                          uint32_t src, FAR void *priv)
+{
+  FAR struct net_driver_s *dev = ept->priv;
+  FAR struct net_rpmsg_transfer_s *msg = data;
+  FAR uint8_t *oldbuf;
+
+  /* Lock the network and serialize driver operations if necessary.
+   * NOTE: Serialization is only required in the case where the driver work
+   * is performed on an LP worker thread and where more than one LP worker
+   * thread has been configured.
+   */
+
+  net_lock();
+
+  oldbuf = dev->d_buf;
+  net_rpmsg_drv_input(dev, msg->data, msg->length, 0);
+  net_rpmsg_drv_rxdone(dev, oldbuf);
+
+  net_unlock();
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_batch_handler
+ *
+ * Description:
+ *   A NET_RPMSG_BATCH message was received with several RX packets.  A
+ *   reply to a packet may be longer than the packet itself.  Only the last
+ *   packet is therefore processed in place, and only if the rest of the
+ *   buffer can hold a reply of the full packet size.  The others are
+ *   copied to rxbuf first.
+ *
+ * Parameters:
+ *   ept - Reference to the endpoint which receive the message
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RPMSG_BATCH
+static int net_rpmsg_drv_batch_handler(FAR struct rpmsg_endpoint *ept,
+                                       FAR void *data, size_t len,
+                                       uint32_t src, FAR void *priv_)
+{
+  FAR struct net_driver_s *dev = ept->priv;
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  FAR struct net_rpmsg_batch_s *msg = data;
+  FAR struct net_rpmsg_frame_s *frame;
+  FAR uint8_t *oldbuf;
+  size_t offset;
+  uint32_t i;
+
+  net_lock();
+
+  oldbuf = dev->d_buf;
+  offset = sizeof(struct net_rpmsg_batch_s);
+
+  for (i = 0; i < msg->count; i++)
+    {
+      frame = (FAR struct net_rpmsg_frame_s *)((FAR uint8_t *)data + offset);
+      if (offset + sizeof(struct net_rpmsg_frame_s) > len ||
+          frame->length > len - offset - sizeof(struct net_rpmsg_frame_s))
+        {
+          /* The message is truncated */
+
+          NETDEV_RXERRORS(dev);
+          break;
+        }
+
+      offset += sizeof(struct net_rpmsg_frame_s);
+      if (i + 1 == msg->count && offset + dev->d_pktsize <= priv->bufsize)
+        {
+          net_rpmsg_drv_input(dev, frame->data, frame->length,
+                              frame->flags);
+          break;
+        }
+
+      /* The frame must be copied.  The buffer is allocated on first use. */
+
+      if (priv->rxbuf == NULL)
+        {
+          priv->rxbuf = kmm_malloc(priv->pktsize);
+        }
+
+      if (priv->rxbuf == NULL || frame->length > priv->pktsize)
+        {
+          NETDEV_RXDROPPED(dev);
+        }
+      else
+        {
+          memcpy(priv->rxbuf, frame->data, frame->length);
+          net_rpmsg_drv_input(dev, priv->rxbuf, frame->length,
+                              frame->flags);
+        }
+
+      offset += NET_RPMSG_DRV_FRAMESIZE(frame->length) -
+                sizeof(struct net_rpmsg_frame_s);
+    }
+
+  net_rpmsg_drv_rxdone(dev, oldbuf);
   net_unlock();
 
   return 0;
 }
+#endif
 
 static void net_rpmsg_drv_device_created(FAR struct rpmsg_device *rdev,
                                          FAR void *priv_)
@@ -743,6 +1142,9 @@ static void net_rpmsg_drv_device_destroy(FAR struct rpmsg_device *rdev,
     {
       rpmsg_destroy_ept(&priv->ept);
       dev->d_buf = NULL;
+#ifdef CONFIG_NET_RPMSG_BATCH
+      priv->txbatch = NULL;
+#endif
     }
 }
 
@@ -812,7 +1214,6 @@ static void net_rpmsg_drv_poll_work(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
   FAR struct net_rpmsg_drv_s *priv = dev->d_private;
-  uint32_t size;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -828,17 +1229,9 @@ static void net_rpmsg_drv_poll_work(FAR void *arg)
    * the TX poll if he are unable to accept another packet for transmission.
    */
 
-  if (dev->d_buf == NULL)
-    {
-      /* Try to get the payload buffer if not yet */
+  /* Try to get the payload buffer if not yet */
 
-      dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
-      if (dev->d_buf)
-        {
-          dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
-          dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
-        }
-    }
+  net_rpmsg_drv_getbuf(dev);
 
   if (dev->d_buf)
     {
@@ -848,6 +1241,13 @@ static void net_rpmsg_drv_poll_work(FAR void *arg)
        */
 
       devif_timer(dev, net_rpmsg_drv_txpoll);
+
+#ifdef CONFIG_NET_RPMSG_BATCH
+      /* Send the frames collected by the poll */
+
+      net_rpmsg_drv_flush(dev);
+      dev->d_buf = NULL;
+#endif
     }
 
   /* Setup the watchdog poll timer again */
@@ -1079,8 +1479,6 @@ static int net_rpmsg_drv_ifdown(FAR struct net_driver_s *dev)
 static void net_rpmsg_drv_txavail_work(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
-  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
-  uint32_t size;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -1096,15 +1494,7 @@ static void net_rpmsg_drv_txavail_work(FAR void *arg)
     {
       /* Try to get the payload buffer if not yet */
 
-      if (dev->d_buf == NULL)
-        {
-          dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
-          if (dev->d_buf)
-            {
-              dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
-              dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
-            }
-        }
+      net_rpmsg_drv_getbuf(dev);
 
       /* Check if there is room in the hardware to hold another outgoing packet. */
 
@@ -1113,6 +1503,13 @@ static void net_rpmsg_drv_txavail_work(FAR void *arg)
           /* If so, then poll the network for new XMIT data */
 
           devif_poll(dev, net_rpmsg_drv_txpoll);
+
+#ifdef CONFIG_NET_RPMSG_BATCH
+          /* Send the frames collected by the poll */
+
+          net_rpmsg_drv_flush(dev);
+          dev->d_buf = NULL;
+#endif
         }
     }
 
@@ -1398,6 +1795,10 @@ int net_rpmsg_drv_init(FAR const char *cpuname,
   dev->d_ioctl   = net_rpmsg_drv_ioctl;   /* Handle network IOCTL commands */
 #endif
   dev->d_private = priv;                  /* Used to recover private state from dev */
+#ifdef CONFIG_NET_RPMSG_TXCSUM
+  dev->d_offload = NETDEV_TXCSUM_IP |     /* The remote inserts the checksums */
+                   NETDEV_TXCSUM_L4;
+#endif
 
   /* Create a watchdog for timing polling for transmissions */
 
@@ -1414,5 +1815,14 @@ int net_rpmsg_drv_init(FAR const char *cpuname,
   /* Register the device with the OS so that socket IOCTLs can be performed */
 
   netdev_register(dev, lltype);
+
+#ifdef CONFIG_NET_RPMSG_BATCH
+  /* Remember the packet size of the link layer.  It limits the size of the
+   * frames in a batch.
+   */
+
+  priv->pktsize = dev->d_pktsize;
+#endif
+
   return OK;
 }
@@ -55,6 +55,7 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/napi.h>
 
 #ifdef CONFIG_NET_PKT
 #  include <nuttx/net/pkt.h>
@@ -72,6 +73,12 @@
 #  error Work queue support is required in this configuration (CONFIG_SCHED_WORKQUEUE)
 #else
 
+/* The interrupt mitigation framework is used for interrupt processing */
+
+#ifndef CONFIG_NETDEV_NAPI
+#  error Interrupt mitigation support is required (CONFIG_NETDEV_NAPI)
+#endif
+
 /* The low priority work queue is preferred.  If it is not enabled, LPWORK
  * will be the same as HPWORK.
  *
@@ -116,7 +123,8 @@ struct skel_driver_s
   bool sk_bifup;               /* true:ifup false:ifdown */
   WDOG_ID sk_txpoll;           /* TX poll timer */
   WDOG_ID sk_txtimeout;        /* TX timeout timer */
-  struct work_s sk_irqwork;    /* For deferring interrupt work to the work queue */
+  struct work_s sk_irqwork;    /* For deferring TX timeout work to the work queue */
+  struct netdev_napi_s sk_napi; /* Budget-limited interrupt processing */
   struct work_s sk_pollwork;   /* For deferring poll work to the work queue */
 
   /* This holds the information visible to the NuttX network */
@@ -161,11 +169,12 @@ static int  skel_txpoll(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
-static void skel_reply(struct skel_driver_s *priv)
-static void skel_receive(FAR struct skel_driver_s *priv);
+static void skel_reply(struct skel_driver_s *priv);
+static int  skel_receive(FAR struct skel_driver_s *priv, int budget);
 static void skel_txdone(FAR struct skel_driver_s *priv);
 
-static void skel_interrupt_work(FAR void *arg);
+static int  skel_napi_poll(FAR struct netdev_napi_s *napi, int budget);
+static void skel_napi_irq(FAR struct netdev_napi_s *napi, bool enable);
 static int  skel_interrupt(int irq, FAR void *context, FAR void *arg);
 
 /* Watchdog timer expirations */
@@ -183,6 +192,10 @@ static int  skel_ifdown(FAR struct net_driver_s *dev);
 
 static void skel_txavail_work(FAR void *arg);
 static int  skel_txavail(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+static int  skel_xmit(FAR struct net_driver_s *dev, FAR const uint8_t *buf,
+                      unsigned int len);
+#endif
 
 #if defined(CONFIG_NET_MCASTGROUP) || defined(CONFIG_NET_ICMPv6)
 static int  skel_addmac(FAR struct net_driver_s *dev,
@@ -387,18 +400,21 @@ static void skel_reply(struct skel_driver_s *priv)
  *   An interrupt was received indicating the availability of a new RX packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   priv   - Reference to the driver state structure
+ *   budget - The maximum number of packets to process
  *
  * Returned Value:
- *   None
+ *   The number of packets processed
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static void skel_receive(FAR struct skel_driver_s *priv)
+static int skel_receive(FAR struct skel_driver_s *priv, int budget)
 {
+  int npackets = 0;
+
   do
     {
       /* Check for errors and update statistics */
@@ -481,8 +497,12 @@ static void skel_receive(FAR struct skel_driver_s *priv)
         {
           NETDEV_RXDROPPED(&priv->sk_dev);
         }
+
+      npackets++;
     }
-  while (); /* While there are more packets to be processed */
+  while (npackets < budget); /* And while there are more packets to be processed */
+
+  return npackets;
 }
 
 /****************************************************************************
@@ -526,33 +546,31 @@ static void skel_txdone(FAR struct skel_driver_s *priv)
 }
 
 /****************************************************************************
- * Name: skel_interrupt_work
+ * Name: skel_napi_poll
  *
  * Description:
- *   Perform interrupt related work from the worker thread
+ *   Perform interrupt related work from the worker thread.  This is the
+ *   poll callback of the interrupt mitigation framework.
  *
  * Input Parameters:
- *   arg - The argument passed when work_queue() was called.
+ *   napi   - The polling state of the device
+ *   budget - The maximum number of packets to receive
  *
  * Returned Value:
- *   OK on success
+ *   The number of packets received.  If this is less than the budget, the
+ *   framework re-enables the Ethernet interrupts.
  *
  * Assumptions:
- *   Runs on a worker thread.
+ *   Runs on a worker thread with the network locked and the Ethernet
+ *   interrupts disabled.
  *
  ****************************************************************************/
 
-static void skel_interrupt_work(FAR void *arg)
+static int skel_napi_poll(FAR struct netdev_napi_s *napi, int budget)
 {
-  FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
-
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
-   */
-
-  net_lock();
+  FAR struct skel_driver_s *priv =
+    (FAR struct skel_driver_s *)napi->dev->d_private;
+  int npackets = 0;
 
   /* Process pending Ethernet interrupts */
 
@@ -562,7 +580,7 @@ static void skel_interrupt_work(FAR void *arg)
 
   /* Check if we received an incoming packet, if so, call skel_receive() */
 
-  skel_receive(priv);
+  npackets = skel_receive(priv, budget);
 
   /* Check if a packet transmission just completed.  If so, call skel_txdone.
    * This may disable further Tx interrupts if there are no pending
@@ -570,11 +588,35 @@ static void skel_interrupt_work(FAR void *arg)
    */
 
   skel_txdone(priv);
-  net_unlock();
+  return npackets;
+}
 
-  /* Re-enable Ethernet interrupts */
+/****************************************************************************
+ * Name: skel_napi_irq
+ *
+ * Description:
+ *   Disable or re-enable the Ethernet interrupts for the interrupt
+ *   mitigation framework.
+ *
+ * Input Parameters:
+ *   napi   - The polling state of the device
+ *   enable - True: Enable the interrupts
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-  up_enable_irq(CONFIG_skeleton_IRQ);
+static void skel_napi_irq(FAR struct netdev_napi_s *napi, bool enable)
+{
+  if (enable)
+    {
+      up_enable_irq(CONFIG_skeleton_IRQ);
+    }
+  else
+    {
+      up_disable_irq(CONFIG_skeleton_IRQ);
+    }
 }
 
 /****************************************************************************
@@ -602,13 +644,6 @@ static int skel_interrupt(int irq, FAR void *context, FAR void *arg)
 
   DEBUGASSERT(priv != NULL);
 
-  /* Disable further Ethernet interrupts.  Because Ethernet interrupts are
-   * also disabled if the TX timeout event occurs, there can be no race
-   * condition here.
-   */
-
-  up_disable_irq(CONFIG_skeleton_IRQ);
-
   /* TODO: Determine if a TX transfer just completed */
 
     {
@@ -620,9 +655,13 @@ static int skel_interrupt(int irq, FAR void *context, FAR void *arg)
        wd_cancel(priv->sk_txtimeout);
     }
 
-  /* Schedule to perform the interrupt processing on the worker thread. */
+  /* Disable further Ethernet interrupts and schedule to perform the
+   * interrupt processing on the worker thread.  Because Ethernet
+   * interrupts are also disabled if the TX timeout event occurs, there can
+   * be no race condition here.
+   */
 
-  work_queue(ETHWORK, &priv->sk_irqwork, skel_interrupt_work, priv, 0);
+  netdev_napi_schedule(&priv->sk_napi);
   return OK;
 }
 
@@ -858,7 +897,7 @@ static int skel_ifdown(FAR struct net_driver_s *dev)
   /* Disable the Ethernet interrupt */
 
   flags = enter_critical_section();
-  up_disable_irq(CONFIG_skeleton_IRQ);
+  netdev_napi_cancel(&priv->sk_napi);
 
   /* Cancel the TX poll timer and TX timeout timers */
 
@@ -958,6 +997,54 @@ static int skel_txavail(FAR struct net_driver_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: skel_xmit
+ *
+ * Description:
+ *   Driver callback invoked by the IP forwarding fast path to send a
+ *   complete Ethernet frame immediately.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   buf - The frame to send.  This buffer belongs to another device.
+ *   len - The length of the frame
+ *
+ * Returned Value:
+ *   OK on success; -EBUSY if the transmitter is not ready.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+static int skel_xmit(FAR struct net_driver_s *dev, FAR const uint8_t *buf,
+                     unsigned int len)
+{
+  FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)dev->d_private;
+  int ret;
+
+  /* Check if there is room in the hardware to hold another outgoing
+   * packet.  If not, return -EBUSY and the packet will be sent on the
+   * next TX poll.
+   */
+
+  /* Copy the frame into the TX buffer (the interfaces share g_pktbuf in
+   * this skeleton) and send it.
+   */
+
+  if (buf != dev->d_buf)
+    {
+      memcpy(dev->d_buf, buf, len);
+    }
+
+  dev->d_len = len;
+  ret        = skel_transmit(priv);
+  dev->d_len = 0;
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: skel_addmac
  *
@@ -1174,6 +1261,9 @@ int skel_initialize(int intf)
   priv->sk_dev.d_ifup    = skel_ifup;     /* I/F up (new IP address) callback */
   priv->sk_dev.d_ifdown  = skel_ifdown;   /* I/F down callback */
   priv->sk_dev.d_txavail = skel_txavail;  /* New TX data callback */
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+  priv->sk_dev.d_transmit = skel_xmit;    /* Send a forwarded frame */
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
   priv->sk_dev.d_addmac  = skel_addmac;   /* Add multicast MAC address */
   priv->sk_dev.d_rmmac   = skel_rmmac;    /* Remove multicast MAC address */
@@ -1183,6 +1273,11 @@ int skel_initialize(int intf)
 #endif
   priv->sk_dev.d_private = (FAR void *)g_skel; /* Used to recover private state from dev */
 
+  /* Process interrupts with a budget-limited poll on the work queue */
+
+  netdev_napi_init(&priv->sk_napi, &priv->sk_dev, skel_napi_poll,
+                   skel_napi_irq, ETHWORK, 0);
+
   /* Create a watchdog for timing polling for and timing of transmissions */
 
   priv->sk_txpoll        = wd_create();   /* Create periodic poll timer */
@@ -58,6 +58,7 @@
 #endif
 
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
@@ -99,6 +100,24 @@
 #  define CONFIG_TUN_NINTERFACES 1
 #endif
 
+/* CONFIG_TUN_NREADBUFS is the number of outgoing packets that may wait to
+ * be read.  CONFIG_TUN_NQUEUES is the number of files that may be attached
+ * to one interface with IFF_MULTI_QUEUE.
+ */
+
+#ifndef CONFIG_TUN_NREADBUFS
+#  define CONFIG_TUN_NREADBUFS 1
+#endif
+
+#ifndef CONFIG_TUN_NQUEUES
+#  define CONFIG_TUN_NQUEUES 1
+#endif
+
+/* The read buffer that receives the next outgoing packet */
+
+#define TUN_READ_TAIL(p) \
+  (((p)->read_head + (p)->read_count) % CONFIG_TUN_NREADBUFS)
+
 /* Make sure that packet buffers include in configured guard size and are an
  * even multiple of 16-bits in length.
  */
@@ -133,21 +152,25 @@
 struct tun_device_s
 {
   bool              bifup;     /* true:ifup false:ifdown */
-  bool              read_wait;
+  bool              multiqueue; /* true: More files may attach */
+  uint8_t           nfiles;    /* Number of attached files */
+  uint8_t           read_wait; /* Number of readers waiting for a packet */
+  uint8_t           read_head; /* Index of the next packet to be read */
+  uint8_t           read_count; /* Number of packets waiting to be read */
   WDOG_ID           txpoll;    /* TX poll timer */
   struct work_s     work;      /* For deferring poll work to the work queue */
   FAR struct file  *filep;
-  FAR struct pollfd *poll_fds;
+  FAR struct pollfd *poll_fds[CONFIG_TUN_NQUEUES];
   sem_t             waitsem;
   sem_t             read_wait_sem;
-  size_t            read_d_len;
+  size_t            read_d_len[CONFIG_TUN_NREADBUFS];
   size_t            write_d_len;
 
   /* These packet buffer arrays required 16-bit alignment.  That alignment
    * is assured only by the preceding wide data types.
    */
 
-  uint8_t           read_buf[NET_TUN_PKTSIZE];
+  uint8_t           read_buf[CONFIG_TUN_NREADBUFS][NET_TUN_PKTSIZE];
   uint8_t           write_buf[NET_TUN_PKTSIZE];
 
   /* This holds the information visible to the NuttX network */
@@ -317,19 +340,24 @@ static void tun_unlock(FAR struct tun_device_s *priv)
 static void tun_pollnotify(FAR struct tun_device_s *priv,
                            pollevent_t eventset)
 {
-  FAR struct pollfd *fds = priv->poll_fds;
+  FAR struct pollfd *fds;
+  pollevent_t events;
+  int i;
 
-  if (fds == NULL)
+  for (i = 0; i < CONFIG_TUN_NQUEUES; i++)
     {
-      return;
-    }
-
-  eventset &= fds->events;
+      fds = priv->poll_fds[i];
+      if (fds == NULL)
+        {
+          continue;
+        }
 
-  if (eventset != 0)
-    {
-      fds->revents |= eventset;
-      nxsem_post(fds->sem);
+      events = eventset & fds->events;
+      if (events != 0)
+        {
+          fds->revents |= events;
+          poll_notify(fds);
+        }
     }
 }
 
@@ -337,8 +365,9 @@ static void tun_pollnotify(FAR struct tun_device_s *priv,
  * Name: tun_fd_transmit
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
+ *   Queue the packet in the tail read buffer and wake up one waiting
+ *   reader.  Called either from the txdone interrupt handling or from
+ *   watchdog based polling.
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -359,12 +388,16 @@ static int tun_fd_transmit(FAR struct tun_device_s *priv)
 
   /* Verify that the hardware is ready to send another packet.  If we get
    * here, then we are committed to sending a packet; Higher level logic
-   * must have assured that there is no transmission in progress.
+   * must have assured that there is a free read buffer.
    */
 
-  if (priv->read_wait)
+  DEBUGASSERT(priv->read_count < CONFIG_TUN_NREADBUFS);
+  priv->read_d_len[TUN_READ_TAIL(priv)] = priv->dev.d_len;
+  priv->read_count++;
+
+  if (priv->read_wait > 0)
     {
-      priv->read_wait = false;
+      priv->read_wait--;
       nxsem_post(&priv->read_wait_sem);
     }
 
@@ -473,10 +506,18 @@ static int tun_txpoll_tap(FAR struct net_driver_s *dev)
         {
           /* Send the packet */
 
-          priv->read_d_len = priv->dev.d_len;
           tun_fd_transmit(priv);
 
-          return 1;
+          /* Stop the poll when all read buffers are in use.  Otherwise,
+           * continue polling into the next read buffer.
+           */
+
+          if (priv->read_count >= CONFIG_TUN_NREADBUFS)
+            {
+              return 1;
+            }
+
+          priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
         }
     }
 
@@ -527,10 +568,18 @@ static int tun_txpoll_tun(FAR struct net_driver_s *dev)
         {
           /* Send the packet */
 
-          priv->read_d_len = priv->dev.d_len;
           tun_fd_transmit(priv);
 
-          return 1;
+          /* Stop the poll when all read buffers are in use.  Otherwise,
+           * continue polling into the next read buffer.
+           */
+
+          if (priv->read_count >= CONFIG_TUN_NREADBUFS)
+            {
+              return 1;
+            }
+
+          priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
         }
     }
 
@@ -805,10 +854,16 @@ static void tun_txdone(FAR struct tun_device_s *priv)
 
   NETDEV_TXDONE(&priv->dev);
 
-  /* Then poll the network for new XMIT data */
+  /* Then poll the network for new XMIT data.  Outgoing data is announced
+   * with txavail, which cannot poll while all read buffers are in use.  So
+   * a poll is needed only if this frees the first read buffer.
+   */
 
-  priv->dev.d_buf = priv->read_buf;
-  (void)devif_poll(&priv->dev, tun_txpoll);
+  if (priv->read_count == CONFIG_TUN_NREADBUFS - 1)
+    {
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
+      (void)devif_poll(&priv->dev, tun_txpoll);
+    }
 }
 
 /****************************************************************************
@@ -841,11 +896,11 @@ static void tun_poll_work(FAR void *arg)
    * the TX poll if he are unable to accept another packet for transmission.
    */
 
-  if (priv->read_d_len == 0)
+  if (priv->read_count < CONFIG_TUN_NREADBUFS)
     {
       /* If so, poll the network for new XMIT data. */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
       (void)devif_timer(&priv->dev, tun_txpoll);
     }
 
@@ -998,7 +1053,7 @@ static void tun_txavail_work(FAR void *arg)
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len != 0)
+  if (priv->read_count >= CONFIG_TUN_NREADBUFS)
     {
       tun_unlock(priv);
       return;
@@ -1009,7 +1064,7 @@ static void tun_txavail_work(FAR void *arg)
     {
       /* Poll the network for new XMIT data */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
       (void)devif_poll(&priv->dev, tun_txpoll);
     }
 
@@ -1191,6 +1246,7 @@ static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
     }
 
   priv->filep         = filep;        /* Set link to file */
+  priv->nfiles        = 1;
   filep->f_priv       = priv;         /* Set link to TUN device */
 
   return ret;
@@ -1246,8 +1302,13 @@ static int tun_close(FAR struct file *filep)
   intf = priv - g_tun_devices;
   tundev_lock(tun);
 
-  tun->free_tuns |= (1 << intf);
-  (void)tun_dev_uninit(priv);
+  /* The interface is destroyed when its last file is closed */
+
+  if (--priv->nfiles == 0)
+    {
+      tun->free_tuns |= (1 << intf);
+      (void)tun_dev_uninit(priv);
+    }
 
   tundev_unlock(tun);
 
@@ -1312,6 +1373,7 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
   size_t write_d_len;
   size_t read_d_len;
+  int ndx;
 
   if (priv == NULL)
     {
@@ -1341,7 +1403,11 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
       goto out;
     }
 
-  if (priv->read_d_len == 0)
+  /* Wait for a packet.  Another reader of a multi-queue interface may take
+   * the packet first.
+   */
+
+  while (priv->read_count == 0)
     {
       if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
@@ -1349,26 +1415,38 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
           goto out;
         }
 
-      priv->read_wait = true;
+      priv->read_wait++;
       tun_unlock(priv);
-      (void)nxsem_wait(&priv->read_wait_sem);
+      ret = nxsem_wait(&priv->read_wait_sem);
       tun_lock(priv);
+
+      if (ret < 0)
+        {
+          if (priv->read_wait > 0)
+            {
+              priv->read_wait--;
+            }
+
+          goto out;
+        }
     }
 
   net_lock();
 
-  read_d_len = priv->read_d_len;
+  ndx        = priv->read_head;
+  read_d_len = priv->read_d_len[ndx];
   if (buflen < read_d_len)
     {
       ret = -EINVAL;
     }
   else
     {
-      memcpy(buffer, priv->read_buf, read_d_len);
+      memcpy(buffer, priv->read_buf[ndx], read_d_len);
       ret = (ssize_t)read_d_len;
     }
 
-  priv->read_d_len = 0;
+  priv->read_head = (ndx + 1) % CONFIG_TUN_NREADBUFS;
+  priv->read_count--;
   tun_txdone(priv);
 
   net_unlock();
@@ -1388,6 +1466,7 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   FAR struct tun_device_s *priv = filep->f_priv;
   pollevent_t eventset;
   int ret = OK;
+  int i;
 
   /* Some sanity checking */
 
@@ -1400,13 +1479,19 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
   if (setup)
     {
-      if (priv->poll_fds)
+      /* Each file attached to the interface may be polled */
+
+      for (i = 0; i < CONFIG_TUN_NQUEUES && priv->poll_fds[i] != NULL; i++)
+        {
+        }
+
+      if (i >= CONFIG_TUN_NQUEUES)
         {
           ret = -EBUSY;
           goto errout;
         }
 
-      priv->poll_fds = fds;
+      priv->poll_fds[i] = fds;
 
       eventset = 0;
 
@@ -1421,7 +1506,7 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
        * So check it too.
        */
 
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (priv->read_count != 0 || priv->write_d_len != 0)
         {
           eventset |= (fds->events & POLLIN);
         }
@@ -1433,7 +1518,14 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
     }
   else
     {
-      priv->poll_fds = 0;
+      for (i = 0; i < CONFIG_TUN_NQUEUES; i++)
+        {
+          if (priv->poll_fds[i] == fds)
+            {
+              priv->poll_fds[i] = NULL;
+              break;
+            }
+        }
     }
 
 errout:
@@ -1442,6 +1534,59 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: tun_attach
+ *
+ * Description:
+ *   Attach the file to the existing multi-queue interface with the name
+ *   and the type in the request.  All files of the interface share its
+ *   packet buffers:  Any of them may read the next outgoing packet or
+ *   write an incoming packet.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such interface; another negated
+ *   errno on failure.
+ *
+ * Assumptions:
+ *   The caller holds the driver lock.
+ *
+ ****************************************************************************/
+
+static int tun_attach(FAR struct tun_driver_s *tun, FAR struct file *filep,
+                      FAR struct ifreq *ifr)
+{
+  FAR struct tun_device_s *priv;
+  uint8_t lltype;
+  int intf;
+
+  lltype = (ifr->ifr_flags & IFF_MASK) == IFF_TUN ? NET_LL_TUN :
+                                                     NET_LL_ETHERNET;
+
+  for (intf = 0; intf < CONFIG_TUN_NINTERFACES; intf++)
+    {
+      priv = &g_tun_devices[intf];
+      if ((tun->free_tuns & (1 << intf)) == 0 &&
+          strncmp(priv->dev.d_ifname, ifr->ifr_name, IFNAMSIZ) == 0)
+        {
+          if (!priv->multiqueue || priv->dev.d_lltype != lltype)
+            {
+              return -EINVAL;
+            }
+
+          if (priv->nfiles >= CONFIG_TUN_NQUEUES)
+            {
+              return -EBUSY;
+            }
+
+          priv->nfiles++;
+          filep->f_priv = priv;
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+
 /****************************************************************************
  * Name: tun_ioctl
  ****************************************************************************/
@@ -1468,6 +1613,18 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       tundev_lock(tun);
 
+      /* Attach another file to an existing multi-queue interface */
+
+      if ((ifr->ifr_flags & IFF_MULTI_QUEUE) != 0 && *ifr->ifr_name)
+        {
+          ret = tun_attach(tun, filep, ifr);
+          if (ret != -ENOENT)
+            {
+              tundev_unlock(tun);
+              return ret;
+            }
+        }
+
       free_tuns = tun->free_tuns;
 
       if (free_tuns == 0)
@@ -1492,6 +1649,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       tun->free_tuns &= ~(1 << intf);
 
       priv = filep->f_priv;
+      priv->multiqueue = (ifr->ifr_flags & IFF_MULTI_QUEUE) != 0;
       strncpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
       tundev_unlock(tun);
 
@@ -85,6 +85,8 @@
  ****************************************************************************/
 
 static void pipecommon_semtake(sem_t *sem);
+static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
+                                  pollevent_t eventset);
 
 /****************************************************************************
  * Private Functions
@@ -113,6 +115,127 @@ static void pipecommon_semtake(FAR sem_t *sem)
   while (ret == -EINTR);
 }
 
+/****************************************************************************
+ * Name: pipecommon_isfull
+ *
+ * Description:
+ *   Return true if there is no room for another byte in the pipe.
+ *
+ ****************************************************************************/
+
+static bool pipecommon_isfull(FAR struct pipe_dev_s *dev)
+{
+  size_t nxtwrndx = dev->d_wrndx + 1;
+
+  if (nxtwrndx >= dev->d_bufsize)
+    {
+      nxtwrndx = 0;
+    }
+
+  return nxtwrndx == dev->d_rdndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the size of the pipe so that it holds 'capacity' bytes.  The
+ *   buffered data is preserved.
+ *
+ * Returned Value:
+ *   The new capacity on success; -EINVAL if the capacity is not supported;
+ *   -EBUSY if the buffered data would not fit; -ENOMEM if the new buffer
+ *   could not be allocated.
+ *
+ * Assumptions:
+ *   The caller holds d_bfsem.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev,
+                             unsigned long capacity)
+{
+  FAR uint8_t *buffer;
+  size_t bufsize;
+  size_t count;
+  size_t ncopy;
+  bool full;
+  int sval;
+
+  /* One byte of the circular buffer is always unused */
+
+  if (capacity == 0 || capacity >= CONFIG_DEV_PIPE_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  bufsize = capacity + 1;
+  if (bufsize == dev->d_bufsize)
+    {
+      return (int)capacity;
+    }
+
+  /* If the buffer has not been allocated yet, just remember the size */
+
+  if (dev->d_buffer == NULL)
+    {
+      dev->d_bufsize = bufsize;
+      return (int)capacity;
+    }
+
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      count = dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      count = dev->d_bufsize - dev->d_rdndx + dev->d_wrndx;
+    }
+
+  if (count > capacity)
+    {
+      return -EBUSY;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(bufsize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Move the buffered data to the beginning of the new buffer */
+
+  full  = pipecommon_isfull(dev);
+  ncopy = count;
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      ncopy = dev->d_bufsize - dev->d_rdndx;
+      memcpy(&buffer[ncopy], dev->d_buffer, dev->d_wrndx);
+    }
+
+  memcpy(buffer, &dev->d_buffer[dev->d_rdndx], ncopy);
+  kmm_free(dev->d_buffer);
+
+  dev->d_buffer  = buffer;
+  dev->d_bufsize = bufsize;
+  dev->d_rdndx   = 0;
+  dev->d_wrndx   = count;
+
+  /* If the pipe was full and is no longer, wake up the writers */
+
+  if (full && !pipecommon_isfull(dev))
+    {
+      while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+        {
+          nxsem_post(&dev->d_wrsem);
+        }
+
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  return (int)capacity;
+}
+
 /****************************************************************************
  * Name: pipecommon_pollnotify
  ****************************************************************************/
@@ -145,7 +268,7 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -425,6 +548,8 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
   ssize_t                nread  = 0;
+  size_t                 count;
+  bool                   full;
   int                    sval;
   int                    ret;
 
@@ -476,30 +601,57 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
         }
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Writers wait and poll waiters are notified only while the pipe is
+   * full.  If it is not full now, there is nobody to wake up.
+   */
+
+  full = pipecommon_isfull(dev);
+
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).  The data is copied in at most two blocks:  Up to the end of the
+   * circular buffer and then from the beginning.
+   */
 
   nread = 0;
   while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      if (dev->d_rdndx < dev->d_wrndx)
+        {
+          count = dev->d_wrndx - dev->d_rdndx;
+        }
+      else
         {
-          dev->d_rdndx = 0;
+          count = dev->d_bufsize - dev->d_rdndx;
         }
 
-      nread++;
-    }
+      if (count > len - nread)
+        {
+          count = len - nread;
+        }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], count);
+      buffer += count;
+      nread  += count;
 
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
+      count  += dev->d_rdndx;
+      dev->d_rdndx = count >= dev->d_bufsize ? 0 : count;
     }
 
-  /* Notify all poll/select waiters that they can write to the FIFO */
+  if (full)
+    {
+      /* Notify all waiting writers that bytes have been removed from the
+       * buffer
+       */
 
-  pipecommon_pollnotify(dev, POLLOUT);
+      while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+        {
+          nxsem_post(&dev->d_wrsem);
+        }
+
+      /* Notify all poll/select waiters that they can write to the FIFO */
+
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
 
   nxsem_post(&dev->d_bfsem);
   pipe_dumpbuffer("From PIPE:", start, nread);
@@ -517,7 +669,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
+  size_t                 count;
+  bool                   empty;
   int                    sval;
   int                    ret;
 
@@ -567,90 +720,343 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Readers wait and poll waiters are notified only while the pipe is
+       * empty.  If it is not empty now, there is nobody to wake up.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      empty = dev->d_wrndx == dev->d_rdndx;
+
+      /* Copy as much as fits in at most two blocks:  Up to the end of the
+       * circular buffer and then from the beginning.  One byte always
+       * remains free to distinguish a full from an empty buffer.
+       */
+
+      last = nwritten;
+      while ((size_t)nwritten < len)
         {
-          nxtwrndx = 0;
+          if (dev->d_wrndx >= dev->d_rdndx)
+            {
+              count = dev->d_bufsize - dev->d_wrndx;
+              if (dev->d_rdndx == 0)
+                {
+                  count--;
+                }
+            }
+          else
+            {
+              count = dev->d_rdndx - dev->d_wrndx - 1;
+            }
+
+          if (count == 0)
+            {
+              break;
+            }
+
+          if (count > len - nwritten)
+            {
+              count = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[dev->d_wrndx], buffer, count);
+          buffer   += count;
+          nwritten += count;
+
+          count    += dev->d_wrndx;
+          dev->d_wrndx = count >= dev->d_bufsize ? 0 : count;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Was anything written in this pass to a pipe that was empty? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if (empty && last < nwritten)
         {
-          /* No... copy the byte */
+          /* Yes.. Notify all of the waiting readers that more data is
+           * available
+           */
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+            {
+              nxsem_post(&dev->d_rdsem);
+            }
+
+          /* Notify all poll/select waiters that they can read from the
+           * FIFO
+           */
 
-          /* Is the write complete? */
+          pipecommon_pollnotify(dev, POLLIN);
+        }
+
+      /* Is the write complete? */
+
+      if ((size_t)nwritten >= len)
+        {
+          /* Return the number of bytes written */
 
-          nwritten++;
-          if ((size_t)nwritten >= len)
+          nxsem_post(&dev->d_bfsem);
+          return len;
+        }
+
+      /* If O_NONBLOCK was set, then return partial bytes written or
+       * EGAIN
+       */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              nwritten = -EAGAIN;
+            }
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+          nxsem_post(&dev->d_bfsem);
+          return nwritten;
+        }
+
+      /* There is more to be written.. wait for data to be removed from the
+       * pipe
+       */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_xfer
+ *
+ * Description:
+ *   Transfer data between the pipe buffer and another descriptor, at the
+ *   offset if one is provided.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_xfer(int fd, FAR off_t *offset, FAR uint8_t *buf,
+                               size_t len, bool write)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  if (offset == NULL)
+    {
+      return write ? nx_write(fd, buf, len) : nx_read(fd, buf, len);
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = write ? file_pwrite(filep, buf, len, *offset) :
+                file_pread(filep, buf, len, *offset);
+  if (ret > 0)
+    {
+      *offset += ret;
+    }
+
+  return ret;
+}
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Move data between the pipe and another descriptor without an
+ *   intermediate buffer:  The other descriptor reads into or writes from
+ *   the circular buffer of the pipe directly.  PIPE_SPLICE_TEE writes the
+ *   data of the pipe to the other descriptor without removing it.
+ *
+ *   The pipe is locked during the transfer, so the other descriptor must
+ *   not refer to the same pipe.
+ *
+ ****************************************************************************/
 
-              pipecommon_pollnotify(dev, POLLIN);
+ssize_t pipecommon_splice(FAR struct file *filep, int fd,
+                          FAR off_t *offset, size_t len, int mode,
+                          bool nonblock)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  ssize_t                total = 0;
+  ssize_t                ret;
+  size_t                 count;
+  size_t                 ndx;
+  int                    sval;
+
+  DEBUGASSERT(dev);
 
-              /* Return the number of bytes written */
+  if (len == 0)
+    {
+      return 0;
+    }
 
-              nxsem_post(&dev->d_bfsem);
-              return len;
+  nonblock |= (filep->f_oflags & O_NONBLOCK) != 0;
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for room in the pipe or for data in the pipe, as read() and
+   * write() do.
+   */
+
+  for (; ; )
+    {
+      if (mode == PIPE_SPLICE_IN)
+        {
+          if (dev->d_nreaders <= 0)
+            {
+              ret = -EPIPE;
+              goto errout;
+            }
+
+          ndx = dev->d_wrndx + 1;
+          if (ndx >= dev->d_bufsize)
+            {
+              ndx = 0;
+            }
+
+          if (ndx != dev->d_rdndx)
+            {
+              break;
             }
         }
       else
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
-
-          if (last < nwritten)
+          if (dev->d_wrndx != dev->d_rdndx)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              break;
+            }
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+          if (dev->d_nwriters <= 0)
+            {
+              ret = 0;
+              goto errout;
+            }
+        }
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
 
-              pipecommon_pollnotify(dev, POLLIN);
-            }
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(mode == PIPE_SPLICE_IN ? &dev->d_wrsem :
+                       &dev->d_rdsem);
+      sched_unlock();
 
-          last = nwritten;
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+  /* Transfer the contiguous parts of the buffer, at most two */
 
-          if (filep->f_oflags & O_NONBLOCK)
+  ndx = mode == PIPE_SPLICE_IN ? dev->d_wrndx : dev->d_rdndx;
+  while ((size_t)total < len)
+    {
+      if (mode == PIPE_SPLICE_IN)
+        {
+          if (dev->d_wrndx >= dev->d_rdndx)
             {
-              if (nwritten == 0)
+              count = dev->d_bufsize - dev->d_wrndx;
+              if (dev->d_rdndx == 0)
                 {
-                  nwritten = -EAGAIN;
+                  count--;
                 }
-
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
             }
+          else
+            {
+              count = dev->d_rdndx - dev->d_wrndx - 1;
+            }
+        }
+      else if (ndx <= dev->d_wrndx)
+        {
+          count = dev->d_wrndx - ndx;
+        }
+      else
+        {
+          count = dev->d_bufsize - ndx;
+        }
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
+      if (count == 0)
+        {
+          break;
+        }
 
-          sched_lock();
-          nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
+      if (count > len - total)
+        {
+          count = len - total;
+        }
+
+      ret = pipecommon_xfer(fd, offset, &dev->d_buffer[ndx], count,
+                            mode != PIPE_SPLICE_IN);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      total += ret;
+      ndx   += ret;
+      if (ndx >= dev->d_bufsize)
+        {
+          ndx = 0;
+        }
+
+      if (mode == PIPE_SPLICE_IN)
+        {
+          dev->d_wrndx = ndx;
+        }
+      else if (mode == PIPE_SPLICE_OUT)
+        {
+          dev->d_rdndx = ndx;
+        }
+
+      if ((size_t)ret < count)
+        {
+          break;
         }
     }
+
+  if (total > 0 && mode == PIPE_SPLICE_IN)
+    {
+      /* Notify all waiting readers that more data is available */
+
+      while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+        {
+          nxsem_post(&dev->d_rdsem);
+        }
+
+      pipecommon_pollnotify(dev, POLLIN);
+    }
+  else if (total > 0 && mode == PIPE_SPLICE_OUT)
+    {
+      /* Notify all waiting writers that bytes have been removed */
+
+      while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+        {
+          nxsem_post(&dev->d_wrsem);
+        }
+
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  if (total > 0)
+    {
+      ret = total;
+    }
+
+errout:
+  nxsem_post(&dev->d_bfsem);
+  return ret;
 }
 
 /****************************************************************************
@@ -813,6 +1219,18 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case PIPEIOC_SETSIZE:
+        {
+          ret = pipecommon_resize(dev, arg);
+        }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        {
+          ret = dev->d_bufsize - 1;
+        }
+        break;
+
       case FIONWRITE:  /* Number of bytes waiting in send queue */
       case FIONREAD:   /* Number of bytes available for reading */
         {
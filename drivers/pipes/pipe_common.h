@@ -107,6 +107,12 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+/* pipecommon_splice() modes */
+
+#define PIPE_SPLICE_OUT     0        /* Move data out of the pipe */
+#define PIPE_SPLICE_IN      1        /* Move data into the pipe */
+#define PIPE_SPLICE_TEE     2        /* Copy data out of the pipe */
+
 
 /****************************************************************************
  * Public Types
@@ -173,6 +179,9 @@ ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
+ssize_t pipecommon_splice(FAR struct file *filep, int fd,
+                          FAR off_t *offset, size_t len, int mode,
+                          bool nonblock);
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 int     pipecommon_unlink(FAR struct inode *priv);
 #endif
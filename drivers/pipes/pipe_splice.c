@@ -0,0 +1,286 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "pipe_common.h"
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pipe_getpipe
+ *
+ * Description:
+ *   Return the pipe that a descriptor refers to, or NULL if it is not a
+ *   pipe or FIFO.
+ *
+ ****************************************************************************/
+
+static FAR struct pipe_dev_s *pipe_getpipe(int fd, FAR struct file **filep)
+{
+  FAR struct inode *inode;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS ||
+      fs_getfilep(fd, filep) < 0)
+    {
+      return NULL;
+    }
+
+  inode = (*filep)->f_inode;
+  if (inode == NULL || !INODE_IS_DRIVER(inode) || inode->u.i_ops == NULL ||
+      inode->u.i_ops->ioctl != pipecommon_ioctl)
+    {
+      return NULL;
+    }
+
+  return (FAR struct pipe_dev_s *)inode->i_private;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes between two descriptors, at least one of which
+ *   must be a pipe or FIFO.  The other descriptor reads into or writes from
+ *   the buffer of the pipe directly, without an intermediate copy.  If the
+ *   other descriptor is a file, 'off_in' or 'off_out' may point to the file
+ *   offset to use, which is then updated.  Otherwise the file position is
+ *   used.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to move data from
+ *   off_in  - The offset in fd_in, NULL if fd_in is a pipe
+ *   fd_out  - The descriptor to move data to
+ *   off_out - The offset in fd_out, NULL if fd_out is a pipe
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK:  Do not wait on the pipe
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero at the end of the input.  On error, -1
+ *   is returned and errno is set:
+ *
+ *   EINVAL - Neither descriptor is a pipe, or both refer to the same pipe
+ *   ESPIPE - An offset was provided for a pipe
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the pipe is empty or full
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct pipe_dev_s *inpipe;
+  FAR struct pipe_dev_s *outpipe;
+  FAR struct file *infilep;
+  FAR struct file *outfilep;
+  bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+  ssize_t ret;
+
+  inpipe  = pipe_getpipe(fd_in, &infilep);
+  outpipe = pipe_getpipe(fd_out, &outfilep);
+
+  if (inpipe != NULL)
+    {
+      if (off_in != NULL || (outpipe != NULL && off_out != NULL))
+        {
+          ret = -ESPIPE;
+        }
+      else if (inpipe == outpipe)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = pipecommon_splice(infilep, fd_out, off_out, len,
+                                  PIPE_SPLICE_OUT, nonblock);
+        }
+    }
+  else if (outpipe != NULL)
+    {
+      if (off_out != NULL)
+        {
+          ret = -ESPIPE;
+        }
+      else
+        {
+          ret = pipecommon_splice(outfilep, fd_in, off_in, len,
+                                  PIPE_SPLICE_IN, nonblock);
+        }
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   Copy up to 'len' bytes from one pipe to another without removing them
+ *   from the first pipe.
+ *
+ * Input Parameters:
+ *   fd_in  - The pipe to copy data from
+ *   fd_out - The pipe to copy data to
+ *   len    - The maximum number of bytes to copy
+ *   flags  - SPLICE_F_NONBLOCK:  Do not wait for data in fd_in
+ *
+ * Returned Value:
+ *   The number of bytes copied; zero if fd_in is empty and has no writers.
+ *   On error, -1 is returned and errno is set:
+ *
+ *   EINVAL - A descriptor is not a pipe, or both refer to the same pipe
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and fd_in is empty
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct pipe_dev_s *inpipe;
+  FAR struct pipe_dev_s *outpipe;
+  FAR struct file *infilep;
+  FAR struct file *outfilep;
+  ssize_t ret;
+
+  inpipe  = pipe_getpipe(fd_in, &infilep);
+  outpipe = pipe_getpipe(fd_out, &outfilep);
+
+  if (inpipe == NULL || outpipe == NULL || inpipe == outpipe)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      ret = pipecommon_splice(infilep, fd_out, NULL, len, PIPE_SPLICE_TEE,
+                              (flags & SPLICE_F_NONBLOCK) != 0);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vmsplice
+ *
+ * Description:
+ *   Write the I/O vectors to a pipe.  The data is copied into the buffer of
+ *   the pipe once.
+ *
+ * Input Parameters:
+ *   fd      - The pipe
+ *   iov     - The I/O vectors
+ *   nr_segs - The number of I/O vectors
+ *   flags   - Ignored:  The mode of the pipe descriptor applies
+ *
+ * Returned Value:
+ *   The number of bytes written.  On error, -1 is returned and errno is
+ *   set:
+ *
+ *   EBADF  - fd is not a pipe
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, unsigned long nr_segs,
+                 unsigned int flags)
+{
+  FAR struct file *filep;
+  ssize_t total = 0;
+  ssize_t ret = OK;
+  unsigned long i;
+
+  if (pipe_getpipe(fd, &filep) == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  for (i = 0; i < nr_segs; i++)
+    {
+      ret = file_write(filep, iov[i].iov_base, iov[i].iov_len);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      total += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  if (total == 0 && ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return total;
+}
+
+#endif /* CONFIG_PIPES */
@@ -0,0 +1,108 @@
+/****************************************************************************
+ * drivers/power/pm_cpustate.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/power/pm.h>
+
+#if defined(CONFIG_PM) && defined(CONFIG_SMP)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The power state of each CPU.  Each entry is written only by its own CPU
+ * but may be read by any CPU.
+ */
+
+static volatile int8_t g_pm_cpustate[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_cpu_setstate
+ *
+ * Description:
+ *   This function is called by the IDLE loop of a CPU when the CPU enters
+ *   or leaves a low power state.  The scheduler uses this information to
+ *   avoid waking a CPU from a low power state when another CPU can run a
+ *   task.
+ *
+ * Input Parameters:
+ *   cpu   - The index of the CPU
+ *   state - The new power state of the CPU
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pm_cpu_setstate(int cpu, enum pm_state_e state)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS);
+  g_pm_cpustate[cpu] = (int8_t)state;
+}
+
+/****************************************************************************
+ * Name: pm_cpu_querystate
+ *
+ * Description:
+ *   This function returns the power state last reported for a CPU by
+ *   pm_cpu_setstate().  The initial state of all CPUs is PM_NORMAL.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU
+ *
+ * Returned Value:
+ *   The power state of the CPU.
+ *
+ ****************************************************************************/
+
+enum pm_state_e pm_cpu_querystate(int cpu)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS);
+  return (enum pm_state_e)g_pm_cpustate[cpu];
+}
+
+#endif /* CONFIG_PM && CONFIG_SMP */
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <inttypes.h>
+#include <unistd.h>
 #include <stdio.h>
 #include <fcntl.h>
 
@@ -76,6 +77,8 @@ struct rptun_priv_s
   struct metal_list            bind;
   struct metal_list            node;
   int                          pid;
+  unsigned int                 nkicks;
+  unsigned int                 maxkicks;
 };
 
 struct rptun_bind_s
@@ -192,6 +195,16 @@ static int rptun_thread(int argc, FAR char *argv[])
       if (ret == SIGUSR1)
         {
           remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+
+          /* Send the notifications that were deferred while the received
+           * messages were handled.
+           */
+
+          if (priv->nkicks > 0)
+            {
+              priv->nkicks = 0;
+              RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
+            }
         }
     }
 
@@ -297,6 +310,20 @@ static int rptun_notify(FAR struct remoteproc *rproc, uint32_t id)
 {
   FAR struct rptun_priv_s *priv = rproc->priv;
 
+  /* The replies and the buffer releases of the endpoint callbacks run on
+   * the rptun thread.  Coalesce their notifications into one that is sent
+   * when all received messages have been handled, but notify at least
+   * every maxkicks messages so that the remote can keep the vrings moving.
+   * Each notification covers all vrings, so any other one flushes the
+   * deferred ones too.
+   */
+
+  if (getpid() == priv->pid && ++priv->nkicks < priv->maxkicks)
+    {
+      return 0;
+    }
+
+  priv->nkicks = 0;
   RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
 
   return 0;
@@ -406,6 +433,11 @@ static int rptun_dev_start(FAR struct remoteproc *rproc)
         }
     }
 
+  /* Defer at most half a vring of notifications */
+
+  priv->nkicks   = 0;
+  priv->maxkicks = MAX(rsc->rpmsg_vring0.num / 2, 1);
+
   /* Update resource table on MASTER side */
 
   if (RPTUN_IS_MASTER(priv->dev))
@@ -71,10 +71,30 @@
 #  error "Worker thread support is required (CONFIG_SCHED_WORKQUEUE)"
 #endif
 
+#if !defined(CONFIG_DRVR_WRITEBUFFER) || !defined(CONFIG_SCHED_WORKQUEUE)
+#  undef CONFIG_DRVR_WRITEBEHIND
+#endif
+
+/* Statistics */
+
+#ifdef CONFIG_DRVR_RWBSTATS
+#  define rwb_stat(r,f,n) ((r)->stats.f += (n))
+#else
+#  define rwb_stat(r,f,n)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -154,6 +174,154 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_resetrhbuffer
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD
+static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
+{
+  /* We assume that the caller holds the readAheadBufferSemphore */
+
+  rwb->rhnblocks    = 0;
+  rwb->rhblockstart = (off_t)-1;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_rhdiscard
+ *
+ * Description:
+ *   Discard the read-ahead buffer if it overlaps the blocks.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBEHIND) && defined(CONFIG_DRVR_READAHEAD)
+static void rwb_rhdiscard(FAR struct rwbuffer_s *rwb, off_t startblock,
+                          size_t nblocks)
+{
+  if (rwb->rhmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->rhsem);
+      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks,
+                      startblock, nblocks))
+        {
+          rwb_resetrhbuffer(rwb);
+        }
+
+      rwb_semgive(&rwb->rhsem);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_flworker
+ *
+ * Description:
+ *   Flush the write-behind buffer on the worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+static void rwb_flworker(FAR void *arg)
+{
+  FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
+  int ret;
+
+  DEBUGASSERT(rwb != NULL);
+
+  finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+        (long)rwb->flblockstart, rwb->flnblocks, rwb->flbuffer);
+
+  ret = rwb->wrflush(rwb->dev, rwb->flbuffer, rwb->flblockstart,
+                     rwb->flnblocks);
+  if (ret != rwb->flnblocks)
+    {
+      ferr("ERROR: Error flushing write-behind buffer: %d\n", ret);
+      if (rwb->flresult == OK)
+        {
+          rwb->flresult = ret < 0 ? ret : -EIO;
+        }
+    }
+
+#ifdef CONFIG_DRVR_READAHEAD
+  /* The read-ahead buffer may have been reloaded with the old data while
+   * the flush was in progress.
+   */
+
+  rwb_rhdiscard(rwb, rwb->flblockstart, rwb->flnblocks);
+#endif
+
+  rwb->flnblocks = 0;
+  rwb_semgive(&rwb->flsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_flwait
+ *
+ * Description:
+ *   Wait until the pending write-behind flush, if any, has completed.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore so that no new flush is started.
+ *   Not called from the worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+static void rwb_flwait(FAR struct rwbuffer_s *rwb)
+{
+  rwb_semtake(&rwb->flsem);
+  rwb_semgive(&rwb->flsem);
+}
+#else
+#  define rwb_flwait(r)
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrbehind
+ *
+ * Description:
+ *   Swap the write buffers and flush the full one on the worker thread.
+ *   This waits only if the previous flush has not yet completed.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+static void rwb_wrbehind(FAR struct rwbuffer_s *rwb)
+{
+  FAR uint8_t *buffer;
+  int ret;
+
+  if (nxsem_trywait(&rwb->flsem) < 0)
+    {
+      rwb_stat(rwb, wrwaits, 1);
+      rwb_semtake(&rwb->flsem);
+    }
+
+  buffer            = rwb->flbuffer;
+  rwb->flbuffer     = rwb->wrbuffer;
+  rwb->flblockstart = rwb->wrblockstart;
+  rwb->flnblocks    = rwb->wrnblocks;
+  rwb->wrbuffer     = buffer;
+
+  rwb_resetwrbuffer(rwb);
+  rwb_stat(rwb, wrflushes, 1);
+
+  ret = work_queue(LPWORK, &rwb->flwork, rwb_flworker, (FAR void *)rwb, 0);
+  if (ret < 0)
+    {
+      /* Flush synchronously if the work queue is not available */
+
+      rwb_flworker(rwb);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_wrflush
  *
@@ -167,6 +335,10 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
 {
   int ret;
 
+  /* The blocks must reach the media in the order that they were written */
+
+  rwb_flwait(rwb);
+
   if (rwb->wrnblocks > 0)
     {
       finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
@@ -183,6 +355,8 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
           ferr("ERROR: Error flushing write buffer: %d\n", ret);
         }
 
+      rwb_stat(rwb, wrflushes, 1);
+
       rwb_resetwrbuffer(rwb);
     }
 }
@@ -207,7 +381,30 @@ static void rwb_wrtimeout(FAR void *arg)
    * worker thread.
    */
 
+#ifdef CONFIG_DRVR_WRITEBEHIND
+  /* Never wait on the worker thread.  A writer may hold the wrsem while it
+   * waits for the write-behind flush that is queued behind this work.
+   * Try again later instead.
+   */
+
+  if (nxsem_trywait(&rwb->wrsem) < 0)
+    {
+      rwb_wrstarttimeout(rwb);
+      return;
+    }
+
+  if (nxsem_trywait(&rwb->flsem) < 0)
+    {
+      rwb_semgive(&rwb->wrsem);
+      rwb_wrstarttimeout(rwb);
+      return;
+    }
+
+  rwb_semgive(&rwb->flsem);
+#else
   rwb_semtake(&rwb->wrsem);
+#endif
+
   rwb_wrflush(rwb);
   rwb_semgive(&rwb->wrsem);
 }
@@ -253,7 +450,9 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
+#ifndef CONFIG_DRVR_WRITEBEHIND
   int ret;
+#endif
 
   /* Write writebuffer Logic */
 
@@ -270,6 +469,11 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
       finfo("writebuffer miss, expected: %08x, given: %08x\n",
             rwb->wrexpectedblock, startblock);
 
+#ifdef CONFIG_DRVR_WRITEBEHIND
+      /* Flush the write buffer on the worker thread */
+
+      rwb_wrbehind(rwb);
+#else
       /* Flush the write buffer */
 
       ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
@@ -279,7 +483,9 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
           return ret;
         }
 
+      rwb_stat(rwb, wrflushes, 1);
       rwb_resetwrbuffer(rwb);
+#endif
     }
 
   /* writebuffer is empty? Then initialize it */
@@ -300,25 +506,12 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 
   rwb->wrnblocks      += nblocks;
   rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
+  rwb_stat(rwb, wrhits, nblocks);
   rwb_wrstarttimeout(rwb);
   return nblocks;
 }
 #endif
 
-/****************************************************************************
- * Name: rwb_resetrhbuffer
- ****************************************************************************/
-
-#ifdef CONFIG_DRVR_READAHEAD
-static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
-{
-  /* We assume that the caller holds the readAheadBufferSemphore */
-
-  rwb->rhnblocks    = 0;
-  rwb->rhblockstart = (off_t)-1;
-}
-#endif
-
 /****************************************************************************
  * Name: rwb_bufferread
  ****************************************************************************/
@@ -346,10 +539,56 @@ rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
   /* Copy the data from the read-ahead buffer into the IO buffer */
 
   memcpy(*rdbuffer, rhbuffer, nbytes);
+  rwb_stat(rwb, rhhits, nblocks);
 
   /* Update the caller's copy for the next address */
 
   *rdbuffer += nbytes;
+
+#ifdef CONFIG_DRVR_READAHEAD_ADAPTIVE
+  /* Remember where a sequential stream would continue */
+
+  rwb->rhexpectedblock = startblock + nblocks;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_rhadapt
+ *
+ * Description:
+ *   Select the number of blocks to read on the next reload of the
+ *   read-ahead buffer.  A reload that continues a sequential stream
+ *   doubles the window, up to the size of the buffer.  Any other reload
+ *   reads only the requested blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD_ADAPTIVE
+static void rwb_rhadapt(FAR struct rwbuffer_s *rwb, off_t startblock,
+                        size_t nblocks)
+{
+  size_t window;
+
+  if (startblock == rwb->rhexpectedblock)
+    {
+      window = (size_t)rwb->rhwindow << 1;
+      if (window < nblocks)
+        {
+          window = nblocks;
+        }
+    }
+  else
+    {
+      window = nblocks;
+    }
+
+  if (window > rwb->rhmaxblocks)
+    {
+      window = rwb->rhmaxblocks;
+    }
+
+  rwb->rhwindow = window > 0 ? window : 1;
 }
 #endif
 
@@ -375,7 +614,11 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
    * read-ahead buffer
    */
 
+#ifdef CONFIG_DRVR_READAHEAD_ADAPTIVE
+  endblock = startblock + rwb->rhwindow;
+#else
   endblock = startblock + rwb->rhmaxblocks;
+#endif
 
   /* Make sure that we don't read past the end of the device */
 
@@ -400,6 +643,12 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
       rwb->rhnblocks    = nblocks;
       rwb->rhblockstart = startblock;
 
+      rwb_stat(rwb, rhreloads, 1);
+      rwb_stat(rwb, rhblocks, nblocks);
+#ifdef CONFIG_DRVR_RWBSTATS
+      rwb->stats.rhwindow = nblocks;
+#endif
+
       /* The return value is not the number of blocks we asked to be loaded. */
 
       return nblocks;
@@ -475,6 +724,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
           offset  = block - rwb->wrblockstart;
           src     = rwb->wrbuffer + offset * rwb->blocksize;
 
+          rwb_flwait(rwb);
           ret = rwb->wrflush(rwb->dev, src, block, nblocks);
           if (ret < 0)
             {
@@ -685,6 +935,12 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
   DEBUGASSERT(rwb->wrflush != NULL);
   rwb->wrbuffer = NULL;
 #endif
+#ifdef CONFIG_DRVR_WRITEBEHIND
+  rwb->flbuffer = NULL;
+#endif
+#ifdef CONFIG_DRVR_RWBSTATS
+  memset(&rwb->stats, 0, sizeof(struct rwb_stats_s));
+#endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
   rwb->rhbuffer = NULL;
@@ -715,6 +971,26 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
               ferr("Write buffer kmm_malloc(%d) failed\n", allocsize);
               return -ENOMEM;
             }
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+          /* The second buffer is flushed while the first one is filled.
+           * The flsem is used for signaling and, hence, should not have
+           * priority inheritance enabled.
+           */
+
+          rwb->flbuffer = kmm_malloc(allocsize);
+          if (!rwb->flbuffer)
+            {
+              ferr("Write-behind buffer kmm_malloc(%d) failed\n",
+                   allocsize);
+              return -ENOMEM;
+            }
+
+          nxsem_init(&rwb->flsem, 0, 1);
+          nxsem_setprotocol(&rwb->flsem, SEM_PRIO_NONE);
+          rwb->flnblocks = 0;
+          rwb->flresult  = OK;
+#endif
         }
 
       finfo("Write buffer size: %d bytes\n", allocsize);
@@ -733,6 +1009,10 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
       /* Initialize read-ahead buffer parameters */
 
       rwb_resetrhbuffer(rwb);
+#ifdef CONFIG_DRVR_READAHEAD_ADAPTIVE
+      rwb->rhwindow        = 1;
+      rwb->rhexpectedblock = (off_t)-1;
+#endif
 
       /* Allocate the read-ahead buffer */
 
@@ -765,6 +1045,15 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
   if (rwb->wrmaxblocks > 0)
     {
       rwb_wrcanceltimeout(rwb);
+#ifdef CONFIG_DRVR_WRITEBEHIND
+      if (rwb->flbuffer)
+        {
+          rwb_flwait(rwb);
+          nxsem_destroy(&rwb->flsem);
+          kmm_free(rwb->flbuffer);
+        }
+#endif
+
       nxsem_destroy(&rwb->wrsem);
       if (rwb->wrbuffer)
         {
@@ -835,6 +1124,9 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 
           if (remaining > 0)
             {
+#ifdef CONFIG_DRVR_READAHEAD_ADAPTIVE
+              rwb_rhadapt(rwb, startblock, remaining);
+#endif
               ret = rwb_rhreload(rwb, startblock);
               if (ret < 0)
                 {
@@ -889,6 +1181,18 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
       /* If the write buffer overlaps the block(s) requested */
 
       rwb_semtake(&rwb->wrsem);
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+      /* Blocks that are being flushed must reach the media first */
+
+      if (rwb->flnblocks > 0 &&
+          rwb_overlap(rwb->flblockstart, rwb->flnblocks, startblock,
+                      nblocks))
+        {
+          rwb_flwait(rwb);
+        }
+#endif
+
       if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks))
         {
           size_t rdblocks = 0;
@@ -988,15 +1292,16 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       if (nblocks > rwb->wrmaxblocks)
         {
-          /* First flush the cache */
+          /* First flush the cache.  Then transfer the data directly to
+           * the media.  The wrsem is held so that no other flush can be
+           * started in between.
+           */
 
           rwb_semtake(&rwb->wrsem);
           rwb_wrflush(rwb);
-          rwb_semgive(&rwb->wrsem);
-
-          /* Then transfer the data directly to the media */
-
           ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+          rwb_stat(rwb, wrdirect, nblocks);
+          rwb_semgive(&rwb->wrsem);
         }
       else
         {
@@ -1069,6 +1374,7 @@ int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
   if (rwb->wrmaxblocks > 0)
     {
       rwb_semtake(&rwb->wrsem);
+      rwb_flwait(rwb);
       rwb_resetwrbuffer(rwb);
       rwb_semgive(&rwb->wrsem);
     }
@@ -1134,11 +1440,41 @@ int rwb_invalidate(FAR struct rwbuffer_s *rwb,
 #ifdef CONFIG_DRVR_WRITEBUFFER
 int rwb_flush(FAR struct rwbuffer_s *rwb)
 {
+  int ret = OK;
+
   rwb_semtake(&rwb->wrsem);
   rwb_wrcanceltimeout(rwb);
   rwb_wrflush(rwb);
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+  /* Report any error of the write-behind flushes since the last call */
+
+  ret           = rwb->flresult;
+  rwb->flresult = OK;
+#endif
+
   rwb_semgive(&rwb->wrsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_getstats
+ *
+ * Description:
+ *   Return the buffering statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_RWBSTATS
+int rwb_getstats(FAR struct rwbuffer_s *rwb, FAR struct rwb_stats_s *stats)
+{
+  if (stats == NULL)
+    {
+      return -EINVAL;
+    }
 
+  memcpy(stats, &rwb->stats, sizeof(struct rwb_stats_s));
   return OK;
 }
 #endif
@@ -0,0 +1,745 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEVNAME_FMT    "/dev/sensor/%s%d"
+#define DEVNAME_MAX    32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The size of the sample and the device name of each sensor type */
+
+struct sensor_info_s
+{
+  uint8_t esize;
+  FAR const char *name;
+};
+
+/* This structure describes one open file, i.e. one reader of a sensor */
+
+struct sensor_user_s
+{
+  FAR struct sensor_user_s *flink; /* Supports a singly linked list */
+  unsigned long tail;              /* Count of samples read by the reader */
+  bool active;                     /* True: The reader enabled the sensor */
+  FAR struct pollfd *fds;          /* The poll waiter of the reader */
+};
+
+/* This structure describes the state of the upper half of one sensor.
+ * The samples are held in a ring buffer that is shared by all readers.
+ * 'head' counts all samples ever pushed and each reader counts the samples
+ * that it has read, so each reader sees every sample until it falls more
+ * than a full buffer behind.
+ */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* The lower half driver */
+  FAR uint8_t *buffer;             /* The ring buffer of samples */
+  size_t esize;                    /* The size of one sample */
+  unsigned int nbuffer;            /* The capacity of the buffer */
+  unsigned long head;              /* Count of samples pushed */
+  unsigned int nactive;            /* Number of readers that enabled it */
+  unsigned int nwaiters;           /* Number of readers waiting in read() */
+  sem_t exclsem;                   /* Manages exclusive access */
+  sem_t buffersem;                 /* Wakes up the waiting readers */
+  sq_queue_t users;                /* The readers */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct sensor_info_s g_sensor_info[SENSOR_TYPE_COUNT] =
+{
+  { sizeof(struct sensor_event_accel_s), "accel" },
+  { sizeof(struct sensor_event_mag_s),   "mag"   },
+  { sizeof(struct sensor_event_gyro_s),  "gyro"  },
+  { sizeof(struct sensor_event_light_s), "light" },
+  { sizeof(struct sensor_event_baro_s),  "baro"  },
+  { sizeof(struct sensor_event_prox_s),  "prox"  },
+  { sizeof(struct sensor_event_humi_s),  "humi"  },
+  { sizeof(struct sensor_event_temp_s),  "temp"  },
+};
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,   /* open */
+  sensor_close,  /* close */
+  sensor_read,   /* read */
+  sensor_write,  /* write */
+  NULL,          /* seek */
+  sensor_ioctl,  /* ioctl */
+  sensor_poll    /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_navail
+ *
+ * Description:
+ *   Return the number of samples that the reader has not read yet.  If the
+ *   reader fell more than a full buffer behind, skip the lost samples.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static unsigned long sensor_navail(FAR struct sensor_upperhalf_s *upper,
+                                   FAR struct sensor_user_s *user)
+{
+  unsigned long navail = upper->head - user->tail;
+
+  if (navail > upper->nbuffer)
+    {
+      user->tail = upper->head - upper->nbuffer;
+      navail     = upper->nbuffer;
+    }
+
+  return navail;
+}
+
+/****************************************************************************
+ * Name: sensor_push_event
+ *
+ * Description:
+ *   Called by the lower half with one or more new samples.  Add them to the
+ *   ring buffer and wake up the readers once for the whole batch.
+ *
+ ****************************************************************************/
+
+static void sensor_push_event(FAR void *priv, FAR const void *data,
+                              size_t bytes)
+{
+  FAR struct sensor_upperhalf_s *upper = priv;
+  FAR const uint8_t *src = data;
+  FAR struct sensor_user_s *user;
+  unsigned long nevents = bytes / upper->esize;
+  unsigned long index;
+  unsigned long n;
+  irqstate_t flags;
+
+  if (nevents == 0)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Only the newest samples fit if the batch exceeds the buffer */
+
+  if (nevents > upper->nbuffer)
+    {
+      src         += (nevents - upper->nbuffer) * upper->esize;
+      upper->head += nevents - upper->nbuffer;
+      nevents      = upper->nbuffer;
+    }
+
+  /* Copy the samples, in up to two pieces if they wrap around the end of
+   * the buffer.
+   */
+
+  while (nevents > 0)
+    {
+      index = upper->head % upper->nbuffer;
+      n     = upper->nbuffer - index;
+      if (n > nevents)
+        {
+          n = nevents;
+        }
+
+      memcpy(upper->buffer + index * upper->esize, src, n * upper->esize);
+      src         += n * upper->esize;
+      upper->head += n;
+      nevents     -= n;
+    }
+
+  /* Notify the readers waiting in poll() and in read() */
+
+  for (user = (FAR struct sensor_user_s *)sq_peek(&upper->users);
+       user != NULL;
+       user = user->flink)
+    {
+      FAR struct pollfd *fds = user->fds;
+
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & POLLIN);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+
+  while (upper->nwaiters > 0)
+    {
+      upper->nwaiters--;
+      nxsem_post(&upper->buffersem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sensor_activate
+ *
+ * Description:
+ *   Enable or disable the sensor for one reader.  The lower half is
+ *   enabled with the first reader and disabled with the last one.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static int sensor_activate(FAR struct sensor_upperhalf_s *upper,
+                           FAR struct sensor_user_s *user, bool enable)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret = OK;
+
+  if (enable == user->active)
+    {
+      return OK;
+    }
+
+  if (lower->ops->activate != NULL &&
+      upper->nactive == (enable ? 0 : 1))
+    {
+      ret = lower->ops->activate(lower, enable);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (enable)
+    {
+      upper->nactive++;
+    }
+  else
+    {
+      upper->nactive--;
+    }
+
+  user->active = enable;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_open
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user;
+  irqstate_t flags;
+  int ret;
+
+  user = (FAR struct sensor_user_s *)kmm_zalloc(sizeof(*user));
+  if (user == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      kmm_free(user);
+      return ret;
+    }
+
+  /* A new reader only sees the samples pushed from now on */
+
+  flags      = enter_critical_section();
+  user->tail = upper->head;
+  sq_addlast((FAR sq_entry_t *)user, &upper->users);
+  leave_critical_section(flags);
+
+  filep->f_priv = user;
+  nxsem_post(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  irqstate_t flags;
+
+  nxsem_wait_uninterruptible(&upper->exclsem);
+
+  sensor_activate(upper, user, false);
+
+  flags = enter_critical_section();
+  sq_rem((FAR sq_entry_t *)user, &upper->users);
+  leave_critical_section(flags);
+
+  nxsem_post(&upper->exclsem);
+  kmm_free(user);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Return as many whole samples as are buffered and fit into the buffer.
+ *   Wait for the next batch if none are buffered, unless O_NONBLOCK.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  unsigned long nevents = buflen / upper->esize;
+  unsigned long navail;
+  unsigned long index;
+  unsigned long n;
+  irqstate_t flags;
+  ssize_t ret;
+
+  if (buffer == NULL || nevents == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+  while ((navail = sensor_navail(upper, user)) == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      /* Wait for the next push.  Let other readers in meanwhile. */
+
+      upper->nwaiters++;
+      nxsem_post(&upper->exclsem);
+
+      ret = nxsem_wait(&upper->buffersem);
+      if (ret < 0)
+        {
+          upper->nwaiters--;
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      ret = nxsem_wait(&upper->exclsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* Copy the samples, in up to two pieces if they wrap around the end of
+   * the buffer.
+   */
+
+  if (nevents > navail)
+    {
+      nevents = navail;
+    }
+
+  ret = nevents * upper->esize;
+  while (nevents > 0)
+    {
+      index = user->tail % upper->nbuffer;
+      n     = upper->nbuffer - index;
+      if (n > nevents)
+        {
+          n = nevents;
+        }
+
+      memcpy(buffer, upper->buffer + index * upper->esize,
+             n * upper->esize);
+      buffer     += n * upper->esize;
+      user->tail += n;
+      nevents    -= n;
+    }
+
+errout:
+  leave_critical_section(flags);
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_write
+ ****************************************************************************/
+
+static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  return -ENOSYS;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  FAR unsigned int *val = (FAR unsigned int *)((uintptr_t)arg);
+  irqstate_t flags;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      /* Enable or disable the sensor for this reader.  Arg: bool value */
+
+      case SNIOC_ACTIVATE:
+        ret = sensor_activate(upper, user, arg != 0);
+        break;
+
+      /* Set the sample interval.  Arg: unsigned int* (microseconds) */
+
+      case SNIOC_SET_INTERVAL:
+        if (val == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (lower->ops->set_interval == NULL)
+          {
+            ret = -ENOTSUP;
+          }
+        else
+          {
+            ret = lower->ops->set_interval(lower, val);
+          }
+        break;
+
+      /* Set the batch latency.  Arg: unsigned int* (microseconds) */
+
+      case SNIOC_BATCH:
+        if (val == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (lower->ops->batch == NULL)
+          {
+            ret = -ENOTSUP;
+          }
+        else
+          {
+            ret = lower->ops->batch(lower, val);
+          }
+        break;
+
+      /* Get the number of samples available to this reader.
+       * Arg: unsigned int* pointer
+       */
+
+      case SNIOC_GET_NEVENTS:
+        if (val == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            flags = enter_critical_section();
+            *val  = sensor_navail(upper, user);
+            leave_critical_section(flags);
+          }
+        break;
+
+      default:
+        if (lower->ops->control != NULL)
+          {
+            ret = lower->ops->control(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      /* Each open file supports one poll waiter */
+
+      if (user->fds != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          user->fds = fds;
+          fds->priv = user;
+
+          if (sensor_navail(upper, user) > 0)
+            {
+              fds->revents |= (fds->events & POLLIN);
+              if (fds->revents != 0)
+                {
+                  nxsem_post(fds->sem);
+                }
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      user->fds = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register the character device /dev/sensor/<name><devno> with the
+ *   upper half sensor driver for a lower half sensor driver.
+ *
+ * Input Parameters:
+ *   lower - The lower half sensor driver
+ *   devno - The number of the sensor among the sensors of the same type
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower, int devno)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  char path[DEVNAME_MAX];
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL);
+
+  if (lower->type < 0 || lower->type >= SENSOR_TYPE_COUNT)
+    {
+      return -EINVAL;
+    }
+
+  upper = (FAR struct sensor_upperhalf_s *)kmm_zalloc(sizeof(*upper));
+  if (upper == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->lower   = lower;
+  upper->esize   = g_sensor_info[lower->type].esize;
+  upper->nbuffer = lower->nbuffer > 0 ? lower->nbuffer : 1;
+
+  upper->buffer  = (FAR uint8_t *)kmm_malloc(upper->nbuffer * upper->esize);
+  if (upper->buffer == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_upper;
+    }
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->buffersem, 0, 0);
+
+  /* The buffer semaphore is used for signaling and must not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_setprotocol(&upper->buffersem, SEM_PRIO_NONE);
+  sq_init(&upper->users);
+
+  lower->push_event = sensor_push_event;
+  lower->priv       = upper;
+
+  snprintf(path, sizeof(path), DEVNAME_FMT,
+           g_sensor_info[lower->type].name, devno);
+
+  sninfo("Registering %s\n", path);
+
+  ret = register_driver(path, &g_sensor_fops, 0666, upper);
+  if (ret < 0)
+    {
+      goto errout_with_sem;
+    }
+
+  return OK;
+
+errout_with_sem:
+  lower->push_event = NULL;
+  lower->priv       = NULL;
+  nxsem_destroy(&upper->exclsem);
+  nxsem_destroy(&upper->buffersem);
+  kmm_free(upper->buffer);
+
+errout_with_upper:
+  kmm_free(upper);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_unregister
+ *
+ * Description:
+ *   Unregister the character device of a lower half sensor driver.
+ *
+ * Input Parameters:
+ *   lower - The lower half sensor driver
+ *   devno - The number that was passed to sensor_register()
+ *
+ ****************************************************************************/
+
+void sensor_unregister(FAR struct sensor_lowerhalf_s *lower, int devno)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  char path[DEVNAME_MAX];
+
+  DEBUGASSERT(lower != NULL && lower->priv != NULL);
+
+  upper = lower->priv;
+
+  snprintf(path, sizeof(path), DEVNAME_FMT,
+           g_sensor_info[lower->type].name, devno);
+  unregister_driver(path);
+
+  lower->push_event = NULL;
+  lower->priv       = NULL;
+
+  nxsem_destroy(&upper->exclsem);
+  nxsem_destroy(&upper->buffersem);
+  kmm_free(upper->buffer);
+  kmm_free(upper);
+}
+
+#endif /* CONFIG_SENSORS_UPPER */
@@ -81,6 +81,12 @@
 #  endif
 #endif
 
+/* VMIN/VTIME are only honoured if read() may return less than requested */
+
+#if defined(CONFIG_SERIAL_TERMIOS) && !defined(CONFIG_DEV_SERIAL_FULLBLOCKS)
+#  define HAVE_RXTIMING 1
+#endif
+
 /* Timing */
 
 #define POLL_DELAY_USEC 1000
@@ -96,9 +102,21 @@
 static int     uart_takesem(FAR sem_t *sem, bool errout);
 static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 
+/* Read support */
+
+static unsigned int uart_recvavail(FAR uart_dev_t *dev);
+#ifndef CONFIG_DEV_SERIAL_FULLBLOCKS
+static bool    uart_recvdone(FAR uart_dev_t *dev, size_t recvd, size_t buflen);
+#endif
+static uint16_t uart_recvwakeup(FAR uart_dev_t *dev, size_t recvd,
+                                size_t buflen);
+static int     uart_recvwait(FAR uart_dev_t *dev, size_t recvd);
+
 /* Write support */
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static size_t  uart_copyxmit(FAR uart_dev_t *dev, FAR const char *buffer,
+                             size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
@@ -176,6 +194,158 @@ static int uart_takesem(FAR sem_t *sem, bool errout)
 
 #define uart_givesem(sem) (void)nxsem_post(sem)
 
+/************************************************************************************
+ * Name: uart_recvavail
+ *
+ * Description:
+ *   Return the number of bytes in the RX buffer.
+ *
+ ************************************************************************************/
+
+static unsigned int uart_recvavail(FAR uart_dev_t *dev)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  int16_t head = rxbuf->head;
+  int16_t tail = rxbuf->tail;
+
+  if (head >= tail)
+    {
+      return head - tail;
+    }
+  else
+    {
+      return rxbuf->size - tail + head;
+    }
+}
+
+/************************************************************************************
+ * Name: uart_recvdone
+ *
+ * Description:
+ *   Return true if read() has received enough data to return to the caller:
+ *   Anything at all by default, at least VMIN bytes if VMIN is set, or anything
+ *   received before an idle line.
+ *
+ ************************************************************************************/
+
+#ifndef CONFIG_DEV_SERIAL_FULLBLOCKS
+static bool uart_recvdone(FAR uart_dev_t *dev, size_t recvd, size_t buflen)
+{
+#ifdef CONFIG_SERIAL_RXDMA
+  if (dev->recvidle && recvd > 0)
+    {
+      return true;
+    }
+#endif
+
+#ifdef HAVE_RXTIMING
+  if (dev->tc_vmin == 0)
+    {
+      /* With VTIME also zero, read() never waits */
+
+      return recvd > 0 || dev->tc_vtime == 0;
+    }
+  else
+    {
+      /* Otherwise at least VMIN bytes.  The read also ends if the user
+       * buffer is full.
+       */
+
+      return recvd >= (size_t)dev->tc_vmin;
+    }
+#else
+  return recvd > 0;
+#endif
+}
+#endif
+
+/************************************************************************************
+ * Name: uart_recvwakeup
+ *
+ * Description:
+ *   Return the number of bytes that must be buffered before a waiting read() is
+ *   woken up.  This keeps the per-DMA-completion wake-ups down when VMIN asks for
+ *   more than one byte.  The threshold is limited to the level where the RX buffer
+ *   stops accepting data.
+ *
+ ************************************************************************************/
+
+static uint16_t uart_recvwakeup(FAR uart_dev_t *dev, size_t recvd, size_t buflen)
+{
+#ifdef HAVE_RXTIMING
+  size_t needed = buflen;
+  size_t limit;
+
+  /* The VTIME timer runs from the first byte, so that byte must wake us */
+
+  if (dev->tc_vtime != 0 && recvd == 0)
+    {
+      return 1;
+    }
+
+  if ((size_t)dev->tc_vmin < needed)
+    {
+      needed = dev->tc_vmin;
+    }
+
+  if (needed <= recvd)
+    {
+      return 1;
+    }
+
+  needed -= recvd;
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  limit = (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK * dev->recv.size) / 100;
+#else
+  limit = dev->recv.size - 1;
+#endif
+
+  if (limit < 1)
+    {
+      limit = 1;
+    }
+
+  return (uint16_t)(needed < limit ? needed : limit);
+#else
+  return 1;
+#endif
+}
+
+/************************************************************************************
+ * Name: uart_recvwait
+ *
+ * Description:
+ *   Wait for the reader to be woken up by received data.  If VTIME is set, the
+ *   wait times out after VTIME deciseconds once some data has been received (or
+ *   immediately if VMIN is zero).  Returns -ETIMEDOUT in that case.
+ *
+ * Assumptions:
+ *   Called within a critical section with recvwaiting set.
+ *
+ ************************************************************************************/
+
+static int uart_recvwait(FAR uart_dev_t *dev, size_t recvd)
+{
+#ifdef HAVE_RXTIMING
+  int ret;
+
+  if (dev->tc_vtime != 0 && (recvd > 0 || dev->tc_vmin == 0))
+    {
+      ret = nxsem_tickwait(&dev->recvsem, clock_systimer(),
+                           DSEC2TICK(dev->tc_vtime));
+      if (ret == -ETIMEDOUT)
+        {
+          dev->recvwaiting = false;
+        }
+
+      return ret;
+    }
+#endif
+
+  return uart_takesem(&dev->recvsem, true);
+}
+
 /****************************************************************************
  * Name: uart_pollnotify
  ****************************************************************************/
@@ -203,14 +373,14 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
 
               /* Limit the number of times that the semaphore is posted.
                * The critical section is needed to make the following
-               * operation atomic.
+               * operation atomic.  A callback (epoll) is always notified.
                */
 
               flags = enter_critical_section();
               nxsem_getvalue(fds->sem, &semcount);
-              if (semcount < 1)
+              if (fds->cb != NULL || semcount < 1)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
 
               leave_critical_section(flags);
@@ -373,6 +543,108 @@ err_out:
   return ret;
 }
 
+/************************************************************************************
+ * Name: uart_copyxmit
+ *
+ * Description:
+ *   Copy the leading characters of 'buffer' that need no output processing into
+ *   the TX buffer, one contiguous span at a time, for as long as there is space.
+ *   Returns the number of characters copied.  Zero is returned if the first
+ *   character needs output processing or if the TX buffer is full; the caller
+ *   then continues with uart_putxmitchar().
+ *
+ ************************************************************************************/
+
+static size_t uart_copyxmit(FAR uart_dev_t *dev, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+  size_t ncopied = 0;
+  size_t nrun = buflen;
+  size_t nspan;
+  int16_t head;
+  int16_t tail;
+  bool opost;
+
+  /* Is any newline processing enabled? */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  opost = (dev->tc_oflag & OPOST) != 0 &&
+          (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) != 0;
+#else
+  opost = dev->isconsole;
+#endif
+
+  if (opost)
+    {
+      for (nrun = 0; nrun < buflen; nrun++)
+        {
+          if (buffer[nrun] == '\n' || buffer[nrun] == '\r')
+            {
+              break;
+            }
+        }
+    }
+
+#ifdef CONFIG_SMP
+  flags = enter_critical_section();
+#endif
+
+  while (ncopied < nrun)
+    {
+      /* The tail index may be advanced asynchronously as data is sent, but the
+       * head index is only modified with xmit.sem held.  A stale tail index only
+       * makes the free space look smaller than it is.
+       */
+
+      head = txbuf->head;
+      tail = txbuf->tail;
+
+      if (head >= tail)
+        {
+          nspan = txbuf->size - head;
+          if (tail == 0)
+            {
+              nspan--;
+            }
+        }
+      else
+        {
+          nspan = tail - head - 1;
+        }
+
+      if (nspan == 0)
+        {
+          break;
+        }
+
+      if (nspan > nrun - ncopied)
+        {
+          nspan = nrun - ncopied;
+        }
+
+      memcpy(&txbuf->buffer[head], &buffer[ncopied], nspan);
+
+      head += nspan;
+      if (head >= txbuf->size)
+        {
+          head = 0;
+        }
+
+      txbuf->head = head;
+      ncopied    += nspan;
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return ncopied;
+}
+
 /************************************************************************************
  * Name: uart_putc
  ************************************************************************************/
@@ -879,7 +1151,7 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        * to the caller?
        */
 
-      else if (recvd > 0)
+      else if (uart_recvdone(dev, recvd, buflen))
        {
           /* Yes.. break out of the loop and return the number of bytes
            * received up to the wait condition.
@@ -964,11 +1236,19 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                    */
 
                   dev->recvwaiting = true;
-                  ret = uart_takesem(&dev->recvsem, true);
+                  dev->recvwakeup  = uart_recvwakeup(dev, recvd, buflen);
+                  ret = uart_recvwait(dev, recvd);
                 }
 
               leave_critical_section(flags);
 
+              /* Did the VTIME timer expire?  Then return what we have. */
+
+              if (ret == -ETIMEDOUT)
+                {
+                  break;
+                }
+
               /* Was a signal received while waiting for data to be
                * received?  Was a removable device disconnected while
                * we were waiting?
@@ -1019,9 +1299,12 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
     }
 
 #ifdef CONFIG_SERIAL_RXDMA
-  /* Notify DMA that there is free space in the RX buffer */
+  /* Notify DMA that there is free space in the RX buffer.  Any idle line
+   * indication has been consumed by this read.
+   */
 
   flags = enter_critical_section();
+  dev->recvidle = false;
   uart_dmarxfree(dev);
   leave_critical_section(flags);
 #endif
@@ -1083,6 +1366,7 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            ncopied;
   bool              oktoblock;
   int               ret;
   char              ch;
@@ -1155,6 +1439,20 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   uart_disabletxint(dev);
   for (; buflen; buflen--)
     {
+      /* Copy characters that need no output processing in blocks.  The next
+       * character, if any, needs processing or must wait for space in the TX
+       * buffer.
+       */
+
+      ncopied = uart_copyxmit(dev, buffer, buflen);
+      buffer += ncopied;
+      buflen -= ncopied;
+
+      if (buflen == 0)
+        {
+          break;
+        }
+
       ch  = *buffer++;
       ret = OK;
 
@@ -1435,6 +1733,9 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               termiosp->c_iflag = dev->tc_iflag;
               termiosp->c_oflag = dev->tc_oflag;
               termiosp->c_lflag = dev->tc_lflag;
+
+              termiosp->c_cc[VMIN]  = dev->tc_vmin;
+              termiosp->c_cc[VTIME] = dev->tc_vtime;
             }
             break;
 
@@ -1454,6 +1755,11 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               dev->tc_oflag = termiosp->c_oflag;
               dev->tc_lflag = termiosp->c_lflag;
 
+              /* VMIN and VTIME are honoured by uart_read() */
+
+              dev->tc_vmin  = termiosp->c_cc[VMIN];
+              dev->tc_vtime = termiosp->c_cc[VTIME];
+
 #if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
               /* If the ISIG flag has been cleared in c_lflag, then un-
                * register the controlling terminal.
@@ -1634,6 +1940,11 @@ int uart_register(FAR const char *path, FAR uart_dev_t *dev)
   dev->pid = (pid_t)-1;
 #  endif
 
+  /* By default, read() returns as soon as any data is available */
+
+  dev->tc_vmin  = 1;
+  dev->tc_vtime = 0;
+
   /* If this UART is a serial console */
 
   if (dev->isconsole)
@@ -1682,9 +1993,17 @@ int uart_register(FAR const char *path, FAR uart_dev_t *dev)
 
 void uart_datareceived(FAR uart_dev_t *dev)
 {
-  /* Is there a thread waiting for read data?  */
+  /* Is there a thread waiting for read data?  Do not wake it up until
+   * enough data for the read() has been buffered or an idle line ends the
+   * received data.
+   */
 
-  if (dev->recvwaiting)
+#ifdef CONFIG_SERIAL_RXDMA
+  if (dev->recvwaiting &&
+      (dev->recvidle || uart_recvavail(dev) >= dev->recvwakeup))
+#else
+  if (dev->recvwaiting && uart_recvavail(dev) >= dev->recvwakeup)
+#endif
     {
       /* Yes... wake it up */
 
@@ -409,4 +409,33 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *   Called by the lower half instead of uart_recvchars_done() when the RX
+ *   DMA transfer was ended by an idle line.  Any waiting read() returns the
+ *   data received so far without waiting for the VMIN threshold.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_idle(FAR uart_dev_t *dev)
+{
+  size_t nbytes = dev->dmarx.nbytes;
+
+  dev->recvidle = true;
+  uart_recvchars_done(dev);
+
+  /* uart_recvchars_done() only wakes up the reader if new data arrived.
+   * Data that was already buffered ends at the idle line, too.
+   */
+
+  if (nbytes == 0 && dev->recv.head != dev->recv.tail)
+    {
+      uart_datareceived(dev);
+    }
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
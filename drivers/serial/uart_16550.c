@@ -765,7 +765,14 @@ static int u16550_attach(struct uart_dev_s *dev)
 
   /* Attach and enable the IRQ */
 
+#ifdef CONFIG_16550_IRQTHREAD
+  /* All of the interrupt processing is done on the interrupt thread */
+
+  ret = irq_attach_thread(priv->irq, NULL, u16550_interrupt, dev,
+                          CONFIG_16550_IRQTHREAD_PRIORITY, 0);
+#else
   ret = irq_attach(priv->irq, u16550_interrupt, dev);
+#endif
 #ifndef CONFIG_ARCH_NOINTC
   if (ret == OK)
     {
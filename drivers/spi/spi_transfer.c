@@ -40,16 +40,151 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <stdbool.h>
+#include <queue.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/signal.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/spi/spi_transfer.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+#  if defined(CONFIG_SPI_ASYNC_HPWORK) || !defined(CONFIG_SCHED_LPWORK)
+#    define SPIWORK HPWORK
+#  else
+#    define SPIWORK LPWORK
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+/* This structure holds the queue of asynchronous transfers of one SPI bus */
+
+struct spi_async_s
+{
+  FAR struct spi_async_s *flink;   /* Supports a singly linked list */
+  FAR struct spi_dev_s *spi;       /* The SPI bus */
+  struct work_s work;              /* Performs the queued transfers */
+  sq_queue_t pending;              /* The queued requests */
+  bool busy;                       /* True: The work is queued or running */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+/* The queues of all SPI buses.  Queues are never destroyed. */
+
+static sq_queue_t g_spi_async;
+
+/* Serializes the creation of queues */
+
+static sem_t g_spi_async_lock = SEM_INITIALIZER(1);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Perform the queued transfers of one SPI bus, in order, until the queue
+ *   is empty.
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_async_s *async = (FAR struct spi_async_s *)arg;
+  FAR struct spi_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req   = (FAR struct spi_request_s *)sq_remfirst(&async->pending);
+      if (req == NULL)
+        {
+          async->busy = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      ret = spi_transfer(async->spi, req->seq);
+      if (req->callback != NULL)
+        {
+          req->callback(req, ret, req->arg);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: spi_async_get
+ *
+ * Description:
+ *   Find the queue of the SPI bus, creating it on first use.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_async_s *spi_async_get(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_async_s *async;
+
+  if (nxsem_wait_uninterruptible(&g_spi_async_lock) < 0)
+    {
+      return NULL;
+    }
+
+  for (async = (FAR struct spi_async_s *)sq_peek(&g_spi_async);
+       async != NULL;
+       async = async->flink)
+    {
+      if (async->spi == spi)
+        {
+          break;
+        }
+    }
+
+  if (async == NULL)
+    {
+      async = (FAR struct spi_async_s *)
+        kmm_zalloc(sizeof(struct spi_async_s));
+      if (async != NULL)
+        {
+          async->spi = spi;
+          sq_init(&async->pending);
+          sq_addlast((FAR sq_entry_t *)async, &g_spi_async);
+        }
+    }
+
+  nxsem_post(&g_spi_async_lock);
+  return async;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -158,4 +293,65 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   return ret;
 }
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting.  The
+ *   sequences queued on one SPI bus are performed in order, one after the
+ *   other, by spi_transfer() on a work queue.  req->callback is called
+ *   when each sequence completes.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the sequence of transfers and the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the sequence was queued; a negated errno value on
+ *   failure.  The callback will not be called on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_request_s *req)
+{
+  FAR struct spi_async_s *async;
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(spi != NULL && req != NULL && req->seq != NULL &&
+              req->seq->trans != NULL);
+
+  async = spi_async_get(spi);
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Add the request to the queue.  Start the work unless it is already
+   * working through the queue.
+   */
+
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req, &async->pending);
+
+  if (!async->busy)
+    {
+      ret = work_queue(SPIWORK, &async->work, spi_async_worker, async, 0);
+      if (ret < 0)
+        {
+          sq_rem((FAR sq_entry_t *)req, &async->pending);
+        }
+      else
+        {
+          async->busy = true;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_SPI_EXCHANGE */
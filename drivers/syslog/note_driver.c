@@ -41,9 +41,12 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/fs/fs.h>
 
@@ -80,17 +83,18 @@ static const struct file_operations note_fops =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: note_read
+ * Name: note_getnotes
+ *
+ * Description:
+ *   Transfer as many complete notes as fit into the user buffer.
+ *
  ****************************************************************************/
 
-static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
-                         size_t buflen)
+static ssize_t note_getnotes(FAR char *buffer, size_t buflen)
 {
   ssize_t notelen;
   ssize_t retlen ;
 
-  DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
-
   /* Then loop, adding as many notes as possible to the user buffer. */
 
   retlen = 0;
@@ -139,6 +143,43 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
   return retlen;
 }
 
+/****************************************************************************
+ * Name: note_read
+ ****************************************************************************/
+
+static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  ssize_t retlen;
+#ifdef CONFIG_DRIVER_NOTE_STREAM
+  int ret;
+#endif
+
+  DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
+
+  retlen = note_getnotes(buffer, buflen);
+
+#ifdef CONFIG_DRIVER_NOTE_STREAM
+  /* In streaming mode, a blocking read does not return end-of-file when the
+   * buffer is empty.  Notes cannot wake up the reader (that would generate
+   * more notes) so the buffer is polled instead.
+   */
+
+  while (retlen == 0 && (filep->f_oflags & O_NONBLOCK) == 0)
+    {
+      ret = nxsig_usleep(CONFIG_DRIVER_NOTE_STREAM_DELAY * USEC_PER_MSEC);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      retlen = note_getnotes(buffer, buflen);
+    }
+#endif
+
+  return retlen;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -42,7 +42,24 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A binary SYSLOG record in the asynchronous SYSLOG rings starts with a
+ * NUL marker byte, a magic byte, and a two byte little-endian record
+ * length.  NUL bytes do not otherwise occur in SYSLOG text.
+ */
+
+#define SYSLOG_BINARY_MARKER  0x00
+#define SYSLOG_BINARY_MAGIC   0xb1
+#define SYSLOG_BINARY_HDRSIZE 4
 
 /****************************************************************************
  * Public Data
@@ -252,6 +269,162 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_async_initialize
+ *
+ * Description:
+ *   Start the drain thread of the asynchronous SYSLOG.  Until then, SYSLOG
+ *   output is sent directly to the SYSLOG channel.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+int syslog_async_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_write
+ *
+ * Description:
+ *   Add bytes to the per-CPU ring of the asynchronous SYSLOG.  This never
+ *   blocks.  Bytes that do not fit are dropped and counted.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   On success, buflen is returned.  -ENOSYS is returned if the drain
+ *   thread is not running; the caller must then output the data itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+ssize_t syslog_async_write(FAR const char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_flush
+ *
+ * Description:
+ *   Drain the rings of the asynchronous SYSLOG in the context of the
+ *   caller.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+int syslog_async_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_record
+ *
+ * Description:
+ *   Add a binary record to the per-CPU ring of the asynchronous SYSLOG.
+ *   The record is either added completely or dropped.
+ *
+ * Input Parameters:
+ *   record - The record
+ *   reclen - The size of the record in bytes
+ *
+ * Returned Value:
+ *   On success, reclen is returned.  -ENOSYS is returned if the drain
+ *   thread is not running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+ssize_t syslog_async_record(FAR const void *record, size_t reclen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_running
+ *
+ * Description:
+ *   Return true if the drain thread of the asynchronous SYSLOG is running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+bool syslog_async_running(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_binary_write
+ *
+ * Description:
+ *   Queue a SYSLOG message as a binary record holding the format string
+ *   pointer and the raw arguments.  The message is formatted later by the
+ *   drain thread.
+ *
+ * Input Parameters:
+ *   ts  - The time stamp of the message or NULL
+ *   fmt - The format string.  It must stay valid until the message has
+ *         been drained.
+ *   ap  - The arguments
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   if the message cannot be deferred; the arguments have then not been
+ *   consumed and the caller must format the message itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_binary_write(FAR const struct timespec *ts,
+                        FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_binary_reclen
+ *
+ * Description:
+ *   Return the length of the binary record that starts with the header
+ *   'hdr' (SYSLOG_BINARY_HDRSIZE bytes) or zero if the header is not
+ *   valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_binary_reclen(FAR const uint8_t *hdr);
+#endif
+
+/****************************************************************************
+ * Name: syslog_binary_decode
+ *
+ * Description:
+ *   Format a binary record into text.
+ *
+ * Input Parameters:
+ *   record - The binary record
+ *   reclen - The length of the record
+ *   buffer - The buffer that receives the text
+ *   buflen - The size of the buffer
+ *
+ * Returned Value:
+ *   The length of the text.  The text is truncated to fit into the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_binary_decode(FAR const uint8_t *record, size_t reclen,
+                         FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
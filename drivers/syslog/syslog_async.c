@@ -0,0 +1,624 @@
+/****************************************************************************
+ * drivers/syslog/syslog_async.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kthread.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_NRINGS CONFIG_SMP_NCPUS
+#else
+#  define SYSLOG_NRINGS 1
+#endif
+
+#define SYSLOG_RINGSIZE CONFIG_SYSLOG_ASYNC_BUFSIZE
+
+/* Memory barriers are only needed between CPUs */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One ring per CPU.  Only code running on the CPU adds to the ring, with
+ * local interrupts disabled, and only the holder of sa_drainsem removes
+ * from it.  Hence each index has exactly one writer and no lock is needed.
+ */
+
+struct syslog_ring_s
+{
+  volatile uint32_t sr_head;     /* Next byte to be written */
+  volatile uint32_t sr_tail;     /* Next byte to be drained */
+  volatile uint32_t sr_dropped;  /* Number of bytes dropped on overflow */
+  char sr_buffer[SYSLOG_RINGSIZE];
+};
+
+/* This structure encapsulates the state of the asynchronous SYSLOG */
+
+struct syslog_async_s
+{
+  volatile bool sa_running;      /* The drain thread has been started */
+  volatile bool sa_waiting;      /* The drain thread waits for data */
+  sem_t sa_wakesem;              /* Wakes up the drain thread */
+  sem_t sa_drainsem;             /* Serializes draining of the rings */
+  uint32_t sa_reported;          /* Dropped bytes already reported */
+  struct syslog_ring_s sa_ring[SYSLOG_NRINGS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_async_s g_syslog_async;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_async_empty
+ *
+ * Description:
+ *   Return true if there is nothing to drain.
+ *
+ ****************************************************************************/
+
+static bool syslog_async_empty(void)
+{
+  int i;
+
+  for (i = 0; i < SYSLOG_NRINGS; i++)
+    {
+      if (g_syslog_async.sa_ring[i].sr_head !=
+          g_syslog_async.sa_ring[i].sr_tail)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_async_output
+ *
+ * Description:
+ *   Send a contiguous block of bytes to the SYSLOG channel.  The block is
+ *   passed in one call to the channel write method if there is one.
+ *
+ ****************************************************************************/
+
+static void syslog_async_output(FAR const char *buffer, size_t buflen,
+                                bool force)
+{
+  FAR const struct syslog_channel_s *channel = g_syslog_channel;
+  size_t i;
+
+  if (force)
+    {
+      for (i = 0; i < buflen; i++)
+        {
+          channel->sc_force(buffer[i]);
+        }
+    }
+#ifdef CONFIG_SYSLOG_WRITE
+  else if (channel->sc_write != NULL)
+    {
+      channel->sc_write(buffer, buflen);
+    }
+#endif
+  else
+    {
+      for (i = 0; i < buflen; i++)
+        {
+          channel->sc_putc(buffer[i]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_async_add
+ *
+ * Description:
+ *   Add bytes to the ring of the current CPU and wake up the drain thread
+ *   if it is waiting.  If 'partial' is false, either all of the bytes are
+ *   added or none are.  The bytes that are not added are counted as
+ *   dropped.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_async_add(FAR const char *buffer, size_t buflen,
+                                bool partial)
+{
+  FAR struct syslog_ring_s *ring;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  size_t space;
+  size_t nbytes;
+  size_t chunk;
+
+  if (!g_syslog_async.sa_running)
+    {
+      return -ENOSYS;
+    }
+
+  /* Disabling local interrupts excludes all other producers on this CPU
+   * and keeps us on this CPU.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_async.sa_ring[up_cpu_index()];
+
+  head  = ring->sr_head;
+  tail  = ring->sr_tail;
+  space = tail > head ? tail - head - 1 : SYSLOG_RINGSIZE - 1 - (head - tail);
+
+  if (buflen <= space)
+    {
+      nbytes = buflen;
+    }
+  else
+    {
+      nbytes = partial ? space : 0;
+    }
+
+  if (nbytes > 0)
+    {
+      /* Copy up to the end of the buffer, then the remainder to the
+       * beginning.
+       */
+
+      chunk = SYSLOG_RINGSIZE - head;
+      if (chunk > nbytes)
+        {
+          chunk = nbytes;
+        }
+
+      memcpy(&ring->sr_buffer[head], buffer, chunk);
+      memcpy(ring->sr_buffer, buffer + chunk, nbytes - chunk);
+
+      head += nbytes;
+      if (head >= SYSLOG_RINGSIZE)
+        {
+          head -= SYSLOG_RINGSIZE;
+        }
+
+      /* Make sure that the data is visible before the new head */
+
+      SP_DMB();
+      ring->sr_head = head;
+    }
+
+  ring->sr_dropped += buflen - nbytes;
+  up_irq_restore(flags);
+
+  if (g_syslog_async.sa_waiting)
+    {
+      g_syslog_async.sa_waiting = false;
+      nxsem_post(&g_syslog_async.sa_wakesem);
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: syslog_async_copyout
+ *
+ * Description:
+ *   Copy bytes out of a ring, handling wrap-around.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+static void syslog_async_copyout(FAR struct syslog_ring_s *ring,
+                                 uint32_t tail, FAR uint8_t *buffer,
+                                 size_t buflen)
+{
+  size_t chunk = SYSLOG_RINGSIZE - tail;
+
+  if (chunk > buflen)
+    {
+      chunk = buflen;
+    }
+
+  memcpy(buffer, &ring->sr_buffer[tail], chunk);
+  memcpy(buffer + chunk, ring->sr_buffer, buflen - chunk);
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_decode
+ *
+ * Description:
+ *   Remove the binary record at the tail of a ring, format it, and send
+ *   the text to the SYSLOG channel.  A marker byte that does not start a
+ *   valid record is skipped.
+ *
+ * Assumptions:
+ *   The caller holds sa_drainsem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+static void syslog_async_decode(FAR struct syslog_ring_s *ring, bool force)
+{
+  uint8_t record[CONFIG_SYSLOG_BINARY_RECSIZE];
+  char line[CONFIG_SYSLOG_BINARY_LINESIZE];
+  uint32_t head = ring->sr_head;
+  uint32_t tail = ring->sr_tail;
+  size_t avail;
+  size_t reclen = 1;
+  int len;
+
+  avail = head >= tail ? head - tail : SYSLOG_RINGSIZE - tail + head;
+  if (avail >= SYSLOG_BINARY_HDRSIZE)
+    {
+      syslog_async_copyout(ring, tail, record, SYSLOG_BINARY_HDRSIZE);
+      len = syslog_binary_reclen(record);
+      if (len > 0 && (size_t)len <= avail)
+        {
+          reclen = len;
+        }
+    }
+
+  if (reclen > 1)
+    {
+      syslog_async_copyout(ring, tail, record, reclen);
+    }
+
+  /* Give the space back to the producer before the slow output */
+
+  SP_DMB();
+  tail += reclen;
+  ring->sr_tail = tail < SYSLOG_RINGSIZE ? tail : tail - SYSLOG_RINGSIZE;
+
+  if (reclen > 1)
+    {
+      len = syslog_binary_decode(record, reclen, line, sizeof(line));
+      if (len > 0)
+        {
+          syslog_async_output(line, len, force);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_drain
+ *
+ * Description:
+ *   Move the content of all rings to the SYSLOG channel, then report any
+ *   bytes that were dropped since the last report.
+ *
+ * Assumptions:
+ *   The caller holds sa_drainsem.
+ *
+ ****************************************************************************/
+
+static void syslog_async_drain(bool force)
+{
+  FAR struct syslog_ring_s *ring;
+#ifdef CONFIG_SYSLOG_BINARY
+  FAR char *marker;
+#endif
+  uint32_t dropped;
+  uint32_t head;
+  uint32_t tail;
+  int i;
+
+  dropped = 0;
+  for (i = 0; i < SYSLOG_NRINGS; i++)
+    {
+      ring = &g_syslog_async.sa_ring[i];
+
+      while ((head = ring->sr_head) != (tail = ring->sr_tail))
+        {
+          /* Output up to the head or up to the end of the buffer */
+
+          if (head < tail)
+            {
+              head = SYSLOG_RINGSIZE;
+            }
+
+#ifdef CONFIG_SYSLOG_BINARY
+          /* The text ends at the next binary record */
+
+          marker = memchr(&ring->sr_buffer[tail], SYSLOG_BINARY_MARKER,
+                          head - tail);
+          if (marker == &ring->sr_buffer[tail])
+            {
+              syslog_async_decode(ring, force);
+              continue;
+            }
+          else if (marker != NULL)
+            {
+              head = marker - ring->sr_buffer;
+            }
+#endif
+
+          syslog_async_output(&ring->sr_buffer[tail], head - tail, force);
+
+          /* Make sure that the data has been read before the space is
+           * given back to the producer.
+           */
+
+          SP_DMB();
+          ring->sr_tail = head < SYSLOG_RINGSIZE ? head : 0;
+        }
+
+      dropped += ring->sr_dropped;
+    }
+
+  if (dropped != g_syslog_async.sa_reported)
+    {
+      char msg[40];
+      int len;
+
+      len = snprintf(msg, sizeof(msg), "[syslog: %lu bytes dropped]\n",
+                     (unsigned long)(dropped - g_syslog_async.sa_reported));
+      g_syslog_async.sa_reported = dropped;
+
+      syslog_async_output(msg, len, force);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_async_thread
+ *
+ * Description:
+ *   The drain thread.  Wait for data and move it to the SYSLOG channel.
+ *
+ ****************************************************************************/
+
+static int syslog_async_thread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      /* Announce the wait before checking for data.  A producer that adds
+       * data after the check will see the flag and wake us up.
+       */
+
+      g_syslog_async.sa_waiting = true;
+      SP_DMB();
+
+      if (syslog_async_empty())
+        {
+          nxsem_wait_uninterruptible(&g_syslog_async.sa_wakesem);
+        }
+
+      g_syslog_async.sa_waiting = false;
+
+      nxsem_wait_uninterruptible(&g_syslog_async.sa_drainsem);
+      syslog_async_drain(false);
+      nxsem_post(&g_syslog_async.sa_drainsem);
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_async_initialize
+ *
+ * Description:
+ *   Start the drain thread.  Until then, SYSLOG output is sent directly
+ *   to the SYSLOG channel.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int syslog_async_initialize(void)
+{
+  int ret;
+
+  if (g_syslog_async.sa_running)
+    {
+      return OK;
+    }
+
+  /* The wake-up semaphore is used for signaling and must not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_init(&g_syslog_async.sa_wakesem, 0, 0);
+  nxsem_setprotocol(&g_syslog_async.sa_wakesem, SEM_PRIO_NONE);
+  nxsem_init(&g_syslog_async.sa_drainsem, 0, 1);
+
+  ret = kthread_create("syslogd", CONFIG_SYSLOG_ASYNC_PRIORITY,
+                       CONFIG_SYSLOG_ASYNC_STACKSIZE,
+                       (main_t)syslog_async_thread, NULL);
+  if (ret < 0)
+    {
+      nxsem_destroy(&g_syslog_async.sa_drainsem);
+      nxsem_destroy(&g_syslog_async.sa_wakesem);
+      return ret;
+    }
+
+  g_syslog_async.sa_running = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_async_write
+ *
+ * Description:
+ *   Add bytes to the ring of the current CPU and wake up the drain thread
+ *   if it is waiting.  This never blocks and may be called from interrupt
+ *   handlers.  The bytes that do not fit into the ring are dropped and
+ *   counted.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   On success, buflen is returned, including any dropped bytes.  -ENOSYS
+ *   is returned if the drain thread is not running; the caller must then
+ *   send the data to the SYSLOG channel itself.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_async_write(FAR const char *buffer, size_t buflen)
+{
+  return syslog_async_add(buffer, buflen, true);
+}
+
+/****************************************************************************
+ * Name: syslog_async_record
+ *
+ * Description:
+ *   Add a binary record to the ring of the current CPU.  The record is
+ *   either added completely or dropped.
+ *
+ * Input Parameters:
+ *   record - The record
+ *   reclen - The size of the record in bytes
+ *
+ * Returned Value:
+ *   On success, reclen is returned, even if the record was dropped.
+ *   -ENOSYS is returned if the drain thread is not running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+ssize_t syslog_async_record(FAR const void *record, size_t reclen)
+{
+  return syslog_async_add((FAR const char *)record, reclen, false);
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_running
+ *
+ * Description:
+ *   Return true if the drain thread is running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+bool syslog_async_running(void)
+{
+  return g_syslog_async.sa_running;
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_flush
+ *
+ * Description:
+ *   Drain the rings synchronously in the context of the caller.  From an
+ *   interrupt handler or the IDLE thread, the channel force method is used
+ *   and nothing is done if the rings are being drained already.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int syslog_async_flush(void)
+{
+  bool force;
+  int ret;
+
+  if (!g_syslog_async.sa_running || syslog_async_empty())
+    {
+      return OK;
+    }
+
+  force = up_interrupt_context() || sched_idletask();
+  if (force)
+    {
+      ret = nxsem_trywait(&g_syslog_async.sa_drainsem);
+    }
+  else
+    {
+      ret = nxsem_wait_uninterruptible(&g_syslog_async.sa_drainsem);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  syslog_async_drain(force);
+  nxsem_post(&g_syslog_async.sa_drainsem);
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_ASYNC */
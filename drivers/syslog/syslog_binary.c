@@ -0,0 +1,649 @@
+/****************************************************************************
+ * drivers/syslog/syslog_binary.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_BINARY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Record layout:  The header, the format string pointer, the optional
+ * time stamp, and the arguments in the order of the format string.
+ */
+
+#define SYSLOG_FMT_OFFSET     SYSLOG_BINARY_HDRSIZE
+#define SYSLOG_TS_OFFSET      (SYSLOG_FMT_OFFSET + sizeof(FAR const char *))
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+#  define SYSLOG_ARG_OFFSET   (SYSLOG_TS_OFFSET + 2 * sizeof(uint32_t))
+#else
+#  define SYSLOG_ARG_OFFSET   SYSLOG_TS_OFFSET
+#endif
+
+/* Big enough for any conversion specification with expanded '*' */
+
+#define SYSLOG_SPEC_MAX       32
+
+/* Argument types */
+
+#define ARG_NONE              0  /* "%%" */
+#define ARG_INT               1  /* int, or smaller types promoted to int */
+#define ARG_LONG              2  /* long */
+#define ARG_LLONG             3  /* long long */
+#define ARG_SIZE              4  /* size_t */
+#define ARG_PTR               5  /* FAR void * */
+#define ARG_DOUBLE            6  /* double */
+#define ARG_STR               7  /* string, copied into the record */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_binary_spec
+ *
+ * Description:
+ *   Parse the conversion specification that starts at the '%' 'fmt'.
+ *
+ * Returned Value:
+ *   A pointer to the character that follows the specification, or NULL if
+ *   the conversion cannot be deferred.  The argument type and the number
+ *   of '*' width and precision arguments are returned in 'type' and
+ *   'nstars'.
+ *
+ ****************************************************************************/
+
+static FAR const char *syslog_binary_spec(FAR const char *fmt,
+                                          FAR int *type, FAR int *nstars)
+{
+  int nlong = 0;
+  bool size = false;
+
+  *nstars = 0;
+  fmt++;
+
+  if (*fmt == '%')
+    {
+      *type = ARG_NONE;
+      return fmt + 1;
+    }
+
+  /* Flags, field width, and precision */
+
+  while (*fmt != '\0' && strchr("-+ #0123456789.*", *fmt) != NULL)
+    {
+      if (*fmt++ == '*')
+        {
+          (*nstars)++;
+        }
+    }
+
+  /* Length modifiers */
+
+  for (; ; fmt++)
+    {
+      if (*fmt == 'l')
+        {
+          nlong++;
+        }
+      else if (*fmt == 'z')
+        {
+          size = true;
+        }
+      else if (*fmt != 'h')
+        {
+          break;
+        }
+    }
+
+  switch (*fmt)
+    {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c':
+        if (size)
+          {
+            *type = ARG_SIZE;
+          }
+        else if (nlong == 0)
+          {
+            *type = ARG_INT;
+          }
+        else if (nlong == 1)
+          {
+            *type = ARG_LONG;
+          }
+#ifdef CONFIG_HAVE_LONG_LONG
+        else if (nlong == 2)
+          {
+            *type = ARG_LLONG;
+          }
+#endif
+        else
+          {
+            return NULL;
+          }
+        break;
+
+      case 'p':
+        *type = ARG_PTR;
+        break;
+
+      case 's':
+        *type = ARG_STR;
+        break;
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+        *type = ARG_DOUBLE;
+        break;
+#endif
+
+      default:
+        return NULL;
+    }
+
+  return fmt + 1;
+}
+
+/****************************************************************************
+ * Name: syslog_binary_argsize
+ *
+ * Description:
+ *   Return the size of an argument in the record.  Strings take at least
+ *   their NUL terminator.
+ *
+ ****************************************************************************/
+
+static size_t syslog_binary_argsize(int type)
+{
+  switch (type)
+    {
+      case ARG_INT:
+        return sizeof(int);
+
+      case ARG_LONG:
+        return sizeof(long);
+
+#ifdef CONFIG_HAVE_LONG_LONG
+      case ARG_LLONG:
+        return sizeof(long long);
+#endif
+
+      case ARG_SIZE:
+        return sizeof(size_t);
+
+      case ARG_PTR:
+        return sizeof(FAR void *);
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+      case ARG_DOUBLE:
+        return sizeof(double);
+#endif
+
+      case ARG_STR:
+        return 1;
+
+      default:
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_binary_write
+ *
+ * Description:
+ *   Queue a SYSLOG message as a binary record holding the format string
+ *   pointer and the raw arguments.  The message is formatted later by the
+ *   drain thread.
+ *
+ * Input Parameters:
+ *   ts  - The time stamp of the message or NULL
+ *   fmt - The format string.  It must stay valid until the message has
+ *         been drained.
+ *   ap  - The arguments
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   if the message cannot be deferred; the arguments have then not been
+ *   consumed and the caller must format the message itself.
+ *
+ ****************************************************************************/
+
+int syslog_binary_write(FAR const struct timespec *ts,
+                        FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  uint8_t record[CONFIG_SYSLOG_BINARY_RECSIZE];
+  FAR const char *ptr;
+  size_t reclen;
+  size_t len;
+  int nstars;
+  int type;
+
+  if (!syslog_async_running())
+    {
+      return -ENOSYS;
+    }
+
+  /* First make sure that all conversions are supported and that all
+   * fixed size arguments fit.  Nothing is consumed from 'ap' before that.
+   */
+
+  reclen = SYSLOG_ARG_OFFSET;
+  for (ptr = strchr(fmt, '%'); ptr != NULL; ptr = strchr(ptr, '%'))
+    {
+      ptr = syslog_binary_spec(ptr, &type, &nstars);
+      if (ptr == NULL)
+        {
+          return -ENOTSUP;
+        }
+
+      reclen += nstars * sizeof(int) + syslog_binary_argsize(type);
+    }
+
+  if (reclen > CONFIG_SYSLOG_BINARY_RECSIZE)
+    {
+      return -E2BIG;
+    }
+
+  /* Then store the arguments.  Strings get what is left of the record. */
+
+  memcpy(&record[SYSLOG_FMT_OFFSET], &fmt, sizeof(FAR const char *));
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  {
+    uint32_t tsval[2];
+
+    tsval[0] = ts != NULL ? (uint32_t)ts->tv_sec : 0;
+    tsval[1] = ts != NULL ? (uint32_t)(ts->tv_nsec / 1000) : 0;
+    memcpy(&record[SYSLOG_TS_OFFSET], tsval, sizeof(tsval));
+  }
+#endif
+
+  len = reclen;
+  reclen = SYSLOG_ARG_OFFSET;
+
+  for (ptr = strchr(fmt, '%'); ptr != NULL; ptr = strchr(ptr, '%'))
+    {
+      ptr = syslog_binary_spec(ptr, &type, &nstars);
+
+      for (; nstars > 0; nstars--)
+        {
+          int value = va_arg(*ap, int);
+          memcpy(&record[reclen], &value, sizeof(int));
+          reclen += sizeof(int);
+        }
+
+      switch (type)
+        {
+          case ARG_INT:
+            {
+              int value = va_arg(*ap, int);
+              memcpy(&record[reclen], &value, sizeof(value));
+            }
+            break;
+
+          case ARG_LONG:
+            {
+              long value = va_arg(*ap, long);
+              memcpy(&record[reclen], &value, sizeof(value));
+            }
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case ARG_LLONG:
+            {
+              long long value = va_arg(*ap, long long);
+              memcpy(&record[reclen], &value, sizeof(value));
+            }
+            break;
+#endif
+
+          case ARG_SIZE:
+            {
+              size_t value = va_arg(*ap, size_t);
+              memcpy(&record[reclen], &value, sizeof(value));
+            }
+            break;
+
+          case ARG_PTR:
+            {
+              FAR void *value = va_arg(*ap, FAR void *);
+              memcpy(&record[reclen], &value, sizeof(value));
+            }
+            break;
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case ARG_DOUBLE:
+            {
+              double value = va_arg(*ap, double);
+              memcpy(&record[reclen], &value, sizeof(value));
+            }
+            break;
+#endif
+
+          case ARG_STR:
+            {
+              FAR const char *value = va_arg(*ap, FAR const char *);
+              size_t maxlen = CONFIG_SYSLOG_BINARY_RECSIZE - len;
+              size_t slen;
+
+              /* The string is copied, truncated to the space left over */
+
+              if (value == NULL)
+                {
+                  value = "(null)";
+                }
+
+              slen = strnlen(value, maxlen);
+              memcpy(&record[reclen], value, slen);
+              record[reclen + slen] = '\0';
+
+              reclen += slen;
+              len    += slen;
+            }
+            break;
+
+          default:
+            break;
+        }
+
+      reclen += syslog_binary_argsize(type);
+    }
+
+  record[0] = SYSLOG_BINARY_MARKER;
+  record[1] = SYSLOG_BINARY_MAGIC;
+  record[2] = (uint8_t)(reclen & 0xff);
+  record[3] = (uint8_t)(reclen >> 8);
+
+  return syslog_async_record(record, reclen) < 0 ? -ENOSYS : OK;
+}
+
+/****************************************************************************
+ * Name: syslog_binary_reclen
+ *
+ * Description:
+ *   Return the length of the binary record that starts with the header
+ *   'hdr' or zero if the header is not valid.
+ *
+ ****************************************************************************/
+
+int syslog_binary_reclen(FAR const uint8_t *hdr)
+{
+  int reclen;
+
+  if (hdr[0] != SYSLOG_BINARY_MARKER || hdr[1] != SYSLOG_BINARY_MAGIC)
+    {
+      return 0;
+    }
+
+  reclen = hdr[2] | (hdr[3] << 8);
+  if (reclen < SYSLOG_ARG_OFFSET || reclen > CONFIG_SYSLOG_BINARY_RECSIZE)
+    {
+      return 0;
+    }
+
+  return reclen;
+}
+
+/****************************************************************************
+ * Name: syslog_binary_decode
+ *
+ * Description:
+ *   Format a binary record into text.  Each conversion is formatted by
+ *   lib_sprintf() with its own specification and its argument taken from
+ *   the record, so no va_list has to be rebuilt.
+ *
+ * Input Parameters:
+ *   record - The binary record
+ *   reclen - The length of the record
+ *   buffer - The buffer that receives the text
+ *   buflen - The size of the buffer
+ *
+ * Returned Value:
+ *   The length of the text.  The text is truncated to fit into the buffer.
+ *
+ ****************************************************************************/
+
+int syslog_binary_decode(FAR const uint8_t *record, size_t reclen,
+                         FAR char *buffer, size_t buflen)
+{
+  struct lib_memoutstream_s stream;
+  FAR struct lib_outstream_s *out = &stream.public;
+  char spec[SYSLOG_SPEC_MAX];
+  FAR const char *fmt;
+  FAR const char *start;
+  FAR const char *end;
+  size_t offset = SYSLOG_ARG_OFFSET;
+  size_t argsize;
+  size_t nspec;
+  int nstars;
+  int type;
+
+  lib_memoutstream(&stream, buffer, buflen);
+  memcpy(&fmt, &record[SYSLOG_FMT_OFFSET], sizeof(FAR const char *));
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  {
+    uint32_t tsval[2];
+
+    memcpy(tsval, &record[SYSLOG_TS_OFFSET], sizeof(tsval));
+    lib_sprintf(out, "[%5lu.%06lu] ",
+                (unsigned long)tsval[0], (unsigned long)tsval[1]);
+  }
+#endif
+
+#ifdef CONFIG_SYSLOG_PREFIX
+  lib_sprintf(out, "%s", CONFIG_SYSLOG_PREFIX_STRING);
+#endif
+
+  while (*fmt != '\0')
+    {
+      if (*fmt != '%')
+        {
+          out->put(out, *fmt++);
+          continue;
+        }
+
+      start = fmt;
+      end   = syslog_binary_spec(start, &type, &nstars);
+      if (end == NULL)
+        {
+          break;
+        }
+
+      fmt = end;
+      if (type == ARG_NONE)
+        {
+          out->put(out, '%');
+          continue;
+        }
+
+      /* Copy the specification, replacing each '*' by its value */
+
+      nspec = 0;
+      for (; start < end; start++)
+        {
+          /* Leave room for an expanded '*' and the NUL terminator */
+
+          if (nspec + 12 > SYSLOG_SPEC_MAX)
+            {
+              goto truncated;
+            }
+
+          if (*start == '*')
+            {
+              int value;
+
+              if (offset + sizeof(int) > reclen)
+                {
+                  goto truncated;
+                }
+
+              memcpy(&value, &record[offset], sizeof(int));
+              offset += sizeof(int);
+              nspec  += snprintf(&spec[nspec], SYSLOG_SPEC_MAX - nspec,
+                                 "%d", value);
+            }
+          else
+            {
+              spec[nspec++] = *start;
+            }
+        }
+
+      spec[nspec] = '\0';
+
+      argsize = syslog_binary_argsize(type);
+      if (offset + argsize > reclen)
+        {
+          goto truncated;
+        }
+
+      switch (type)
+        {
+          case ARG_INT:
+            {
+              int value;
+              memcpy(&value, &record[offset], sizeof(value));
+              lib_sprintf(out, spec, value);
+            }
+            break;
+
+          case ARG_LONG:
+            {
+              long value;
+              memcpy(&value, &record[offset], sizeof(value));
+              lib_sprintf(out, spec, value);
+            }
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case ARG_LLONG:
+            {
+              long long value;
+              memcpy(&value, &record[offset], sizeof(value));
+              lib_sprintf(out, spec, value);
+            }
+            break;
+#endif
+
+          case ARG_SIZE:
+            {
+              size_t value;
+              memcpy(&value, &record[offset], sizeof(value));
+              lib_sprintf(out, spec, value);
+            }
+            break;
+
+          case ARG_PTR:
+            {
+              FAR void *value;
+              memcpy(&value, &record[offset], sizeof(value));
+              lib_sprintf(out, spec, value);
+            }
+            break;
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case ARG_DOUBLE:
+            {
+              double value;
+              memcpy(&value, &record[offset], sizeof(value));
+              lib_sprintf(out, spec, value);
+            }
+            break;
+#endif
+
+          case ARG_STR:
+            {
+              FAR const char *value = (FAR const char *)&record[offset];
+
+              argsize = strnlen(value, reclen - offset) + 1;
+              if (offset + argsize > reclen)
+                {
+                  goto truncated;
+                }
+
+              lib_sprintf(out, spec, value);
+            }
+            break;
+
+          default:
+            break;
+        }
+
+      offset += argsize;
+    }
+
+  return out->nput;
+
+truncated:
+  lib_sprintf(out, "[truncated]\n");
+  return out->nput;
+}
+
+#endif /* CONFIG_SYSLOG_BINARY */
@@ -63,6 +63,16 @@
 #  define NEED_LOWPUTC
 #endif
 
+/* The single character output of the default channel */
+
+#if defined(CONFIG_RAMLOG_SYSLOG)
+#  define syslog_default_putc1(ch) ramlog_putc(ch)
+#elif defined(HAVE_LOWPUTC)
+#  define syslog_default_putc1(ch) up_putc(ch)
+#else
+#  define syslog_default_putc1(ch)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -71,6 +81,9 @@
 static int syslog_default_putc(int ch);
 #endif
 static int syslog_default_flush(void);
+#ifdef CONFIG_SYSLOG_WRITE
+static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -81,21 +94,30 @@ const struct syslog_channel_s g_default_channel =
 {
   ramlog_putc,
   ramlog_putc,
-  syslog_default_flush
+  syslog_default_flush,
+#ifdef CONFIG_SYSLOG_WRITE
+  syslog_default_write
+#endif
 };
 #elif defined(HAVE_LOWPUTC)
 const struct syslog_channel_s g_default_channel =
 {
   up_putc,
   up_putc,
-  syslog_default_flush
+  syslog_default_flush,
+#ifdef CONFIG_SYSLOG_WRITE
+  syslog_default_write
+#endif
 };
 #else
 const struct syslog_channel_s g_default_channel =
 {
   syslog_default_putc,
   syslog_default_putc,
-  syslog_default_flush
+  syslog_default_flush,
+#ifdef CONFIG_SYSLOG_WRITE
+  syslog_default_write
+#endif
 };
 #endif
 
@@ -127,6 +149,30 @@ static int syslog_default_flush(void)
   return OK;
 }
 
+/****************************************************************************
+ * Name: syslog_default_write
+ *
+ * Description:
+ *   Write a block of data to the default channel.  The asynchronous SYSLOG
+ *   drain thread uses this to output each contiguous block with a single
+ *   call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_WRITE
+static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen)
+{
+  size_t i;
+
+  for (i = 0; i < buflen; i++)
+    {
+      syslog_default_putc1(buffer[i]);
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
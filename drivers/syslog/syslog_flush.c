@@ -89,6 +89,12 @@ int syslog_flush(void)
   (void)syslog_flush_intbuffer(g_syslog_channel, true);
 #endif
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  /* Drain any output queued for the drain thread */
+
+  (void)syslog_async_flush();
+#endif
+
   /* Then flush all of the buffered output to the SYSLOG device */
 
   DEBUGASSERT(g_syslog_channel->sc_flush != NULL);
@@ -80,6 +80,12 @@ int syslog_force(int ch)
   (void)syslog_flush_intbuffer(g_syslog_channel, true);
 #endif
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  /* Output anything queued for the drain thread first */
+
+  (void)syslog_async_flush();
+#endif
+
   /* Then send the character to the emergency channel */
 
   return g_syslog_channel->sc_force(ch);
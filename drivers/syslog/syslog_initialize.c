@@ -116,6 +116,15 @@ int syslog_initialize(enum syslog_init_e phase)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  if (phase == SYSLOG_INIT_LATE && ret >= 0)
+    {
+      /* Start draining SYSLOG output asynchronously */
+
+      ret = syslog_async_initialize();
+    }
+#endif
+
   return ret;
 }
 
@@ -70,8 +70,21 @@
 
 int syslog_putc(int ch)
 {
+#ifdef CONFIG_SYSLOG_ASYNC
+  char buffer = (char)ch;
+#endif
+
   DEBUGASSERT(g_syslog_channel != NULL);
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  /* Queue the character for the drain thread, if it is running */
+
+  if (syslog_async_write(&buffer, 1) >= 0)
+    {
+      return ch;
+    }
+#endif
+
   /* Is this an attempt to do SYSLOG output from an interrupt handler? */
 
   if (up_interrupt_context() || sched_idletask())
@@ -1,7 +1,7 @@
 /****************************************************************************
  * drivers/syslog/syslog_stream.c
  *
- *   Copyright (C) 2012, 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2016-2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -219,6 +219,7 @@ void syslogstream_create(FAR struct lib_syslogstream_s *stream)
   /* Initialize the common fields */
 
   stream->public.put   = syslogstream_putc;
+  stream->public.puts  = NULL;
   stream->public.flush = lib_noflush;
   stream->public.nput  = 0;
 
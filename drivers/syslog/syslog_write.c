@@ -130,6 +130,18 @@ static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen)
 
 ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 {
+#ifdef CONFIG_SYSLOG_ASYNC
+  ssize_t ret;
+
+  /* Queue the data for the drain thread, if it is running */
+
+  ret = syslog_async_write(buffer, buflen);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   if (!up_interrupt_context() && !sched_idletask())
     {
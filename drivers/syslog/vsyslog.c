@@ -49,6 +49,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -110,6 +112,23 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_BINARY
+  /* Defer the formatting to the drain thread, if possible */
+
+  if (priority != LOG_EMERG)
+    {
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      ret = syslog_binary_write(&ts, fmt, ap);
+#else
+      ret = syslog_binary_write(NULL, fmt, ap);
+#endif
+      if (ret >= 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.  NOTE that emergency priority output is handled
    * differently.. it will use the SYSLOG emergency stream.
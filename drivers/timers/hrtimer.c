@@ -0,0 +1,453 @@
+/****************************************************************************
+ * drivers/timers/hrtimer.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/tree.h>
+#include <nuttx/timers/oneshot.h>
+#include <nuttx/timers/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CONFIG_HRTIMER requires 64-bit integer support
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The shortest interval that will be programmed into the oneshot timer.
+ * Timers that are already due are expired after this interval.
+ */
+
+#define HRTIMER_MINDELAY  NSEC_PER_USEC
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+RB_HEAD(hrtimer_tree_s, hrtimer_s);
+
+/* This structure describes the state of the high resolution timers */
+
+struct hrtimer_state_s
+{
+  FAR struct oneshot_lowerhalf_s *lower; /* The bound oneshot timer */
+  FAR struct hrtimer_s *first;           /* The timer programmed now */
+  uint64_t expired;                      /* Its programmed expiration */
+  uint64_t maxdelay;                     /* Maximum oneshot delay (nsec) */
+  struct hrtimer_tree_s tree;            /* Active timers by expiration */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int hrtimer_compare(FAR struct hrtimer_s *a, FAR struct hrtimer_s *b);
+static void hrtimer_expiration(FAR struct oneshot_lowerhalf_s *lower,
+                               FAR void *arg);
+
+RB_PROTOTYPE_STATIC(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct hrtimer_state_s g_hrtimer =
+{
+  NULL, NULL, 0, 0, RB_INITIALIZER(&g_hrtimer.tree)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+RB_GENERATE_STATIC(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Name: hrtimer_compare
+ *
+ * Description:
+ *   Order the active timers by expiration time.  Timers with the same
+ *   expiration time are ordered by address since the tree may hold only
+ *   unique keys.
+ *
+ ****************************************************************************/
+
+static int hrtimer_compare(FAR struct hrtimer_s *a, FAR struct hrtimer_s *b)
+{
+  if (a->expired != b->expired)
+    {
+      return a->expired < b->expired ? -1 : 1;
+    }
+
+  if (a != b)
+    {
+      return (uintptr_t)a < (uintptr_t)b ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hrtimer_ts2nsec and hrtimer_nsec2ts
+ *
+ * Description:
+ *   Convert between struct timespec and nanoseconds.
+ *
+ ****************************************************************************/
+
+static inline uint64_t hrtimer_ts2nsec(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static inline void hrtimer_nsec2ts(FAR struct timespec *ts, uint64_t nsec)
+{
+  ts->tv_sec  = nsec / NSEC_PER_SEC;
+  ts->tv_nsec = nsec - (uint64_t)ts->tv_sec * NSEC_PER_SEC;
+}
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current time of the bound oneshot timer.
+ *
+ ****************************************************************************/
+
+static uint64_t hrtimer_now(void)
+{
+  struct timespec ts;
+
+  if (ONESHOT_CURRENT(g_hrtimer.lower, &ts) < 0)
+    {
+      return 0;
+    }
+
+  return hrtimer_ts2nsec(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the oneshot timer for the earliest active timer unless that
+ *   timer and its expiration time are already programmed.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_reprogram(void)
+{
+  FAR struct hrtimer_s *first;
+  struct timespec ts;
+  uint64_t delay;
+  uint64_t now;
+
+  first = RB_MIN(hrtimer_tree_s, &g_hrtimer.tree);
+  if (first == g_hrtimer.first &&
+      (first == NULL || first->expired == g_hrtimer.expired))
+    {
+      return;
+    }
+
+  if (g_hrtimer.first != NULL)
+    {
+      (void)ONESHOT_CANCEL(g_hrtimer.lower, &ts);
+    }
+
+  g_hrtimer.first = first;
+  if (first != NULL)
+    {
+      g_hrtimer.expired = first->expired;
+
+      now   = hrtimer_now();
+      delay = first->expired > now ? first->expired - now : 0;
+
+      if (delay < HRTIMER_MINDELAY)
+        {
+          delay = HRTIMER_MINDELAY;
+        }
+      else if (delay > g_hrtimer.maxdelay)
+        {
+          delay = g_hrtimer.maxdelay;
+        }
+
+      hrtimer_nsec2ts(&ts, delay);
+      (void)ONESHOT_START(g_hrtimer.lower, hrtimer_expiration, NULL, &ts);
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_expiration
+ *
+ * Description:
+ *   Called from the interrupt handler of the oneshot timer.  Execute every
+ *   timer that is due and then program the oneshot timer for the next one.
+ *
+ ****************************************************************************/
+
+static void hrtimer_expiration(FAR struct oneshot_lowerhalf_s *lower,
+                               FAR void *arg)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  /* The oneshot timer is no longer running */
+
+  g_hrtimer.first = NULL;
+
+  now = hrtimer_now();
+  while ((timer = RB_MIN(hrtimer_tree_s, &g_hrtimer.tree)) != NULL &&
+         timer->expired <= now)
+    {
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer.tree, timer);
+      timer->active = false;
+
+      /* The callback may start or cancel timers */
+
+      timer->callback(timer, timer->arg);
+    }
+
+  /* Then program the oneshot timer for the next active timer (if any).
+   * Since first is now NULL, the oneshot timer is not cancelled.
+   */
+
+  hrtimer_reprogram();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Bind the high resolution timers to a oneshot timer lower half.  That
+ *   oneshot timer must be dedicated to the hrtimer logic and must support
+ *   the current() method which provides the time base of the timers.  This
+ *   is normally called from board bring-up logic.
+ *
+ * Input Parameters:
+ *   lower - An instance of the oneshot lower half timer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower)
+{
+  struct timespec ts;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && g_hrtimer.lower == NULL);
+
+  if (lower->ops->current == NULL)
+    {
+      tmrerr("ERROR: The oneshot timer has no current() method\n");
+      return -ENOSYS;
+    }
+
+  ret = ONESHOT_MAX_DELAY(lower, &ts);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags              = enter_critical_section();
+  g_hrtimer.maxdelay = hrtimer_ts2nsec(&ts);
+  g_hrtimer.lower    = lower;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer structure before its first use.
+ *
+ * Input Parameters:
+ *   timer    - The timer to initialize
+ *   callback - The function to call when the timer expires
+ *   arg      - An opaque argument that will accompany the callback
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t callback,
+                  FAR void *arg)
+{
+  DEBUGASSERT(timer != NULL && callback != NULL);
+
+  timer->expired  = 0;
+  timer->callback = callback;
+  timer->arg      = arg;
+  timer->active   = false;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer.  If the timer is already active, it is
+ *   restarted with the new expiration time.  Timers may be started from
+ *   the interrupt level, including from the callback of a timer.
+ *
+ * Input Parameters:
+ *   timer - The timer to start
+ *   nsec  - The expiration time in nanoseconds
+ *   mode  - HRTIMER_MODE_REL if nsec is relative to the current time or
+ *           HRTIMER_MODE_ABS if nsec is on the hrtimer_gettime() time base
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENODEV is returned if no oneshot
+ *   timer has been bound by hrtimer_initialize().
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t nsec, int mode)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL && timer->callback != NULL);
+
+  if (g_hrtimer.lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = enter_critical_section();
+
+  if (timer->active)
+    {
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer.tree, timer);
+    }
+
+  timer->expired = mode == HRTIMER_MODE_ABS ? nsec : hrtimer_now() + nsec;
+  timer->active  = true;
+
+  RB_INSERT(hrtimer_tree_s, &g_hrtimer.tree, timer);
+  hrtimer_reprogram();
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a high resolution timer.  Cancelling a timer that is not active
+ *   has no effect.
+ *
+ * Input Parameters:
+ *   timer - The timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL);
+
+  flags = enter_critical_section();
+
+  if (timer->active)
+    {
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer.tree, timer);
+      timer->active = false;
+      hrtimer_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution timers.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in nanoseconds since the oneshot timer was initialized, or
+ *   zero if hrtimer_initialize() has not been called.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void)
+{
+  return g_hrtimer.lower != NULL ? hrtimer_now() : 0;
+}
+
+#endif /* CONFIG_HRTIMER */
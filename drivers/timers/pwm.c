@@ -1,7 +1,8 @@
 /****************************************************************************
  * drivers/timers/pwm.c
  *
- *   Copyright (C) 2011-2013, 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011-2013, 2016-2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -61,6 +62,16 @@
 
 #ifdef CONFIG_PWM
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Callers may wait for a pulse count or for a waveform to complete */
+
+#if defined(CONFIG_PWM_PULSECOUNT) || defined(CONFIG_PWM_WAVEFORM)
+#  define HAVE_PWM_WAIT 1
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -71,11 +82,11 @@ struct pwm_upperhalf_s
 {
   uint8_t           crefs;    /* The number of times the device has been opened */
   volatile bool     started;  /* True: pulsed output is being generated */
-#ifdef CONFIG_PWM_PULSECOUNT
+#ifdef HAVE_PWM_WAIT
   volatile bool     waiting;  /* True: Caller is waiting for the pulse count to expire */
 #endif
   sem_t             exclsem;  /* Supports mutual exclusion */
-#ifdef CONFIG_PWM_PULSECOUNT
+#ifdef HAVE_PWM_WAIT
   sem_t             waitsem;  /* Used to wait for the pulse count to expire */
 #endif
   struct pwm_info_s info;     /* Pulsed output characteristics */
@@ -97,6 +108,11 @@ static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
 static int     pwm_start(FAR struct pwm_upperhalf_s *upper,
                          unsigned int oflags);
+#ifdef CONFIG_PWM_WAVEFORM
+static int     pwm_waveform(FAR struct pwm_upperhalf_s *upper,
+                            FAR const struct pwm_waveform_s *wave,
+                            unsigned int oflags);
+#endif
 static int     pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 
 /****************************************************************************
@@ -413,6 +429,71 @@ static int pwm_start(FAR struct pwm_upperhalf_s *upper, unsigned int oflags)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_waveform
+ *
+ * Description:
+ *   Handle the PWMIOC_WAVEFORM ioctl command
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_WAVEFORM
+static int pwm_waveform(FAR struct pwm_upperhalf_s *upper,
+                        FAR const struct pwm_waveform_s *wave,
+                        unsigned int oflags)
+{
+  FAR struct pwm_lowerhalf_s *lower = upper->dev;
+  irqstate_t flags;
+  int ret;
+
+  if (lower->ops->waveform == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  if (wave == NULL || wave->duty == NULL || wave->frequency == 0 ||
+      wave->nsamples == 0 || wave->nchannels == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Disable interrupts so that the completion of a short waveform cannot
+   * be missed.  Decide whether to wait before starting the waveform.
+   */
+
+  flags = enter_critical_section();
+  upper->waiting = !wave->loop && (oflags & O_NONBLOCK) == 0;
+
+  ret = lower->ops->waveform(lower, wave, upper);
+  if (ret == OK)
+    {
+      upper->started        = true;
+      upper->info.frequency = wave->frequency;
+
+      /* Wait until we are awakened by pwm_waveform_done().  A signal ends
+       * the wait, but not the waveform.
+       */
+
+      while (upper->waiting)
+        {
+          ret = nxsem_wait(&upper->waitsem);
+          if (ret < 0)
+            {
+              upper->waiting = false;
+            }
+        }
+    }
+  else
+    {
+      pwminfo("waveform failed: %d\n", ret);
+      upper->waiting = false;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pwm_ioctl
  *
@@ -525,7 +606,7 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             {
               ret = lower->ops->stop(lower);
               upper->started = false;
-#ifdef CONFIG_PWM_PULSECOUNT
+#ifdef HAVE_PWM_WAIT
               if (upper->waiting)
                 {
                   upper->waiting = false;
@@ -535,6 +616,22 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_PWM_WAVEFORM
+      /* PWMIOC_WAVEFORM - Play a waveform by DMA.
+       *
+       *   ioctl argument:  A read-only reference to struct pwm_waveform_s
+       */
+
+      case PWMIOC_WAVEFORM:
+        {
+          FAR const struct pwm_waveform_s *wave =
+            (FAR const struct pwm_waveform_s *)((uintptr_t)arg);
+
+          ret = pwm_waveform(upper, wave, filep->f_oflags);
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -595,7 +692,7 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev)
   /* Initialize the PWM device structure (it was already zeroed by kmm_zalloc()) */
 
   nxsem_init(&upper->exclsem, 0, 1);
-#ifdef CONFIG_PWM_PULSECOUNT
+#ifdef HAVE_PWM_WAIT
   nxsem_init(&upper->waitsem, 0, 0);
 
   /* The wait semaphore is used for signaling and, hence, should not have priority
@@ -678,4 +775,39 @@ void pwm_expired(FAR void *handle)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_waveform_done
+ *
+ * Description:
+ *   Called by the lower half when a waveform that does not loop has loaded
+ *   its last sample.  This wakes up the caller of PWMIOC_WAVEFORM, if it
+ *   is waiting.  The output remains started, holding the last sample.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     waveform() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_WAVEFORM
+void pwm_waveform_done(FAR void *handle)
+{
+  FAR struct pwm_upperhalf_s *upper = (FAR struct pwm_upperhalf_s *)handle;
+
+  pwminfo("waiting: %d\n", upper->waiting);
+
+  if (upper->waiting)
+    {
+      upper->waiting = false;
+      nxsem_post(&upper->waitsem);
+    }
+}
+#endif
+
 #endif /* CONFIG_PWM */
@@ -80,6 +80,16 @@
 
 #define CDCACM_RXDELAY   (CLK_TCK / 5)
 
+/* The size of a read request.  At least one full packet */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+#  define CDCACM_RDREQLEN \
+     MAX(CONFIG_CDCACM_BULKOUT_REQLEN, CONFIG_CDCACM_EPBULKOUT_HSSIZE)
+#else
+#  define CDCACM_RDREQLEN \
+     MAX(CONFIG_CDCACM_BULKOUT_REQLEN, CONFIG_CDCACM_EPBULKOUT_FSSIZE)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -325,23 +335,41 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
   FAR struct uart_buffer_s *xmit = &serdev->xmit;
   irqstate_t flags;
   uint16_t nbytes = 0;
+  uint16_t ncopy;
 
   /* Disable interrupts */
 
   flags = enter_critical_section();
 
-  /* Transfer bytes while we have bytes available and there is room in the
-   * request.
+  /* Copy blocks while we have bytes available and there is room in the
+   * request.  There are at most two blocks:  From the tail to the end of
+   * the buffer, then from the start of the buffer to the head.
    */
 
   while (xmit->head != xmit->tail && nbytes < reqlen)
     {
-      *reqbuf++ = xmit->buffer[xmit->tail];
-      nbytes++;
+      if (xmit->head > xmit->tail)
+        {
+          ncopy = xmit->head - xmit->tail;
+        }
+      else
+        {
+          ncopy = xmit->size - xmit->tail;
+        }
+
+      if (ncopy > reqlen - nbytes)
+        {
+          ncopy = reqlen - nbytes;
+        }
+
+      memcpy(reqbuf, &xmit->buffer[xmit->tail], ncopy);
+      reqbuf += ncopy;
+      nbytes += ncopy;
 
-      /* Increment the tail pointer */
+      /* Advance the tail pointer */
 
-      if (++(xmit->tail) >= xmit->size)
+      xmit->tail += ncopy;
+      if (xmit->tail >= xmit->size)
         {
           xmit->tail = 0;
         }
@@ -434,11 +462,21 @@ static int cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv)
           (void)sq_remfirst(&priv->txfree);
           priv->nwrq--;
 
-          /* Then submit the request to the endpoint */
+          /* Then submit the request to the endpoint.  A transfer that
+           * ends on a packet boundary needs a null packet to terminate it,
+           * but only if no more data follows.  Any remaining data is sent
+           * in the next request, now or when a request completes.
+           */
 
           req->len     = len;
           req->priv    = wrcontainer;
-          req->flags   = USBDEV_REQFLAGS_NULLPKT;
+          req->flags   = 0;
+
+          if (priv->serdev.xmit.head == priv->serdev.xmit.tail)
+            {
+              req->flags = USBDEV_REQFLAGS_NULLPKT;
+            }
+
           ret          = EP_SUBMIT(ep, req);
           if (ret != OK)
             {
@@ -483,6 +521,10 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
   uint16_t reqlen;
   uint16_t nexthead;
   uint16_t nbytes = 0;
+#if !defined(CONFIG_SERIAL_IFLOWCONTROL) || \
+    !defined(CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS)
+  uint16_t ncopy;
+#endif
 
   DEBUGASSERT(priv != NULL && rdcontainer != NULL);
 
@@ -538,10 +580,12 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
    * proper way to throttle a serial device.
    */
 
-  while (nexthead != recv->tail && nbytes < reqlen)
-    {
 #if defined(CONFIG_SERIAL_IFLOWCONTROL) && \
     defined(CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS)
+  /* The watermark is checked byte by byte */
+
+  while (nexthead != recv->tail && nbytes < reqlen)
+    {
       unsigned int nbuffered;
 
       /* How many bytes are buffered */
@@ -570,7 +614,6 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
               break;
             }
         }
-#endif
 
       /* Copy one byte to the head of the circular RX buffer */
 
@@ -585,6 +628,51 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
           nexthead = 0;
         }
     }
+#else
+  /* Copy blocks.  There are at most two blocks:  From the head to the end
+   * of the buffer, then from the start of the buffer to the byte before
+   * the tail.
+   */
+
+  while (nexthead != recv->tail && nbytes < reqlen)
+    {
+      if (recv->tail > recv->head)
+        {
+          ncopy = recv->tail - recv->head - 1;
+        }
+      else
+        {
+          ncopy = recv->size - recv->head;
+          if (recv->tail == 0)
+            {
+              ncopy--;
+            }
+        }
+
+      if (ncopy > reqlen - nbytes)
+        {
+          ncopy = reqlen - nbytes;
+        }
+
+      memcpy(&recv->buffer[recv->head], reqbuf, ncopy);
+      reqbuf += ncopy;
+      nbytes += ncopy;
+
+      /* Advance the head index and check for wrap around */
+
+      recv->head += ncopy;
+      if (recv->head >= recv->size)
+        {
+          recv->head = 0;
+        }
+
+      nexthead = recv->head + 1;
+      if (nexthead >= recv->size)
+        {
+          nexthead = 0;
+        }
+    }
+#endif
 
 #if defined(CONFIG_SERIAL_IFLOWCONTROL) && \
     !defined(CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS)
@@ -646,7 +734,7 @@ static int cdcacm_requeue_rdrequest(FAR struct cdcacm_dev_s *priv,
   /* Requeue the read request */
 
   ep       = priv->epbulkout;
-  req->len = ep->maxpacket;
+  req->len = (CDCACM_RDREQLEN / ep->maxpacket) * ep->maxpacket;
   ret      = EP_SUBMIT(ep, req);
   if (ret != OK)
     {
@@ -1393,13 +1481,11 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
 
   priv->epbulkout->priv = priv;
 
-  /* Pre-allocate read requests.  The buffer size is one full packet. */
+  /* Pre-allocate read requests.  The buffer size is at least one full
+   * packet.
+   */
 
-#ifdef CONFIG_USBDEV_DUALSPEED
-  reqlen = CONFIG_CDCACM_EPBULKOUT_HSSIZE;
-#else
-  reqlen = CONFIG_CDCACM_EPBULKOUT_FSSIZE;
-#endif
+  reqlen = CDCACM_RDREQLEN;
 
   for (i = 0; i < CONFIG_CDCACM_NRDREQS; i++)
     {
@@ -111,6 +111,16 @@
 #  define CONFIG_CDCECM_NINTERFACES 1
 #endif
 
+/* The number of read and write requests that can be in flight */
+
+#ifndef CONFIG_CDCECM_NRDREQS
+#  define CONFIG_CDCECM_NRDREQS 2
+#endif
+
+#ifndef CONFIG_CDCECM_NWRREQS
+#  define CONFIG_CDCECM_NWRREQS 2
+#endif
+
 /* TX poll delay = 1 seconds. CLK_TCK is the number of clock ticks per second */
 
 #define CDCECM_WDDELAY   (1*CLK_TCK)
@@ -127,6 +137,14 @@
  * Private Types
  ****************************************************************************/
 
+/* Container that lets a read or write request be kept in a list */
+
+struct cdcecm_req_s
+{
+  FAR struct cdcecm_req_s     *flink;       /* Supports a singly linked list */
+  FAR struct usbdev_req_s     *req;         /* The contained request */
+};
+
 /* The cdcecm_driver_s encapsulates all state information for a single hardware
  * interface
  */
@@ -145,11 +163,12 @@ struct cdcecm_driver_s
 
   uint8_t                      pktbuf[CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE];
 
-  struct usbdev_req_s         *rdreq;       /* Single read request */
-  bool                         rxpending;   /* Packet available in rdreq */
+  struct cdcecm_req_s          rdreqs[CONFIG_CDCECM_NRDREQS];
+  sq_queue_t                   rxpending;   /* Completed read requests */
 
-  struct usbdev_req_s         *wrreq;       /* Single write request */
-  sem_t                        wrreq_idle;  /* Is the wrreq available? */
+  struct cdcecm_req_s          wrreqs[CONFIG_CDCECM_NWRREQS];
+  sq_queue_t                   txfree;      /* Available write requests */
+  sem_t                        wrreq_idle;  /* Counts the available wrreqs */
   bool                         txdone;      /* Did a write request complete? */
 
   /* Network device */
@@ -182,7 +201,8 @@ static int  cdcecm_txpoll(FAR struct net_driver_s *dev);
 /* Interrupt handling */
 
 static void cdcecm_reply(struct cdcecm_driver_s *priv);
-static void cdcecm_receive(FAR struct cdcecm_driver_s *priv);
+static void cdcecm_receive(FAR struct cdcecm_driver_s *priv,
+                           FAR struct usbdev_req_s *req);
 static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv);
 
 static void cdcecm_interrupt_work(FAR void *arg);
@@ -323,24 +343,45 @@ static const struct usb_devdesc_s g_devdesc =
 
 static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
 {
-  /* Wait until the USB device request for Ethernet frame transmissions becomes
-   * available.
+  FAR struct cdcecm_req_s *wrcontainer;
+  irqstate_t flags;
+  int ret;
+
+  /* Wait until one of the USB device requests for Ethernet frame
+   * transmissions becomes available.  The frames of the other requests
+   * may still be in flight.
    */
 
   while (nxsem_wait(&self->wrreq_idle) != OK)
     {
     }
 
+  flags = enter_critical_section();
+  wrcontainer = (FAR struct cdcecm_req_s *)sq_remfirst(&self->txfree);
+  leave_critical_section(flags);
+
+  DEBUGASSERT(wrcontainer != NULL);
+
   /* Increment statistics */
 
   NETDEV_TXPACKETS(self->dev);
 
   /* Send the packet: address=priv->dev.d_buf, length=priv->dev.d_len */
 
-  memcpy(self->wrreq->buf, self->dev.d_buf, self->dev.d_len);
-  self->wrreq->len = self->dev.d_len;
+  memcpy(wrcontainer->req->buf, self->dev.d_buf, self->dev.d_len);
+  wrcontainer->req->len = self->dev.d_len;
+
+  ret = EP_SUBMIT(self->epbulkin, wrcontainer->req);
+  if (ret < 0)
+    {
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)wrcontainer, &self->txfree);
+      leave_critical_section(flags);
 
-  return EP_SUBMIT(self->epbulkin, self->wrreq);
+      nxsem_post(&self->wrreq_idle);
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -494,7 +535,8 @@ static void cdcecm_reply(struct cdcecm_driver_s *priv)
  *
  ****************************************************************************/
 
-static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
+static void cdcecm_receive(FAR struct cdcecm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   /* Check for errors and update statistics */
 
@@ -506,8 +548,8 @@ static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
    * amount of data in self->dev.d_len
    */
 
-  memcpy(self->dev.d_buf, self->rdreq->buf, self->rdreq->xfrd);
-  self->dev.d_len = self->rdreq->xfrd;
+  memcpy(self->dev.d_buf, req->buf, req->xfrd);
+  self->dev.d_len = req->xfrd;
 
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the packet tap */
@@ -624,6 +666,7 @@ static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv)
 static void cdcecm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)arg;
+  FAR struct cdcecm_req_s *rdcontainer;
   irqstate_t flags;
 
   /* Lock the network and serialize driver operations if necessary.
@@ -634,15 +677,26 @@ static void cdcecm_interrupt_work(FAR void *arg)
 
   net_lock();
 
-  /* Check if we received an incoming packet, if so, call cdcecm_receive() */
+  /* Handle all incoming packets received so far.  Each read request is
+   * re-submitted as soon as its packet has been handled, while the others
+   * stay queued in the bulk OUT endpoint.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
-      cdcecm_receive(self);
+      flags = enter_critical_section();
+      rdcontainer = (FAR struct cdcecm_req_s *)sq_remfirst(&self->rxpending);
+      leave_critical_section(flags);
+
+      if (rdcontainer == NULL)
+        {
+          break;
+        }
+
+      cdcecm_receive(self, rdcontainer->req);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      EP_SUBMIT(self->epbulkout, rdcontainer->req);
       leave_critical_section(flags);
     }
 
@@ -684,7 +738,8 @@ static void cdcecm_poll_work(FAR void *arg)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)arg;
 
-  ninfo("rxpending: %d, txdone: %d\n", self->rxpending, self->txdone);
+  ninfo("rxpending: %d, txdone: %d\n", !sq_empty(&self->rxpending),
+        self->txdone);
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -1121,8 +1176,7 @@ static void cdcecm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          sq_addlast((FAR sq_entry_t *)req->priv, &self->rxpending);
           work_queue(ETHWORK, &self->irqwork, cdcecm_interrupt_work, self, 0);
         }
         break;
@@ -1133,7 +1187,7 @@ static void cdcecm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1152,13 +1206,19 @@ static void cdcecm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)ep->priv;
+  irqstate_t flags;
   int rc;
 
   uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again. */
+  /* The USB device write request is available for upcoming transmissions
+   * again.
+   */
+
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->txfree);
+  leave_critical_section(flags);
 
   rc = nxsem_post(&self->wrreq_idle);
 
@@ -1270,6 +1330,7 @@ static int cdcecm_setconfig(FAR struct cdcecm_driver_s *self, uint8_t config)
 {
   struct usb_epdesc_s epdesc;
   int ret = OK;
+  int i;
 
   if (config == self->config)
     {
@@ -1320,14 +1381,16 @@ static int cdcecm_setconfig(FAR struct cdcecm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  DEBUGASSERT(sq_empty(&self->rxpending));
 
-  self->rdreq->callback = cdcecm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCECM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i].req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -1795,7 +1858,9 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+  FAR struct usbdev_req_s *req;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -1833,33 +1898,54 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests.  The buffer size is one full packet. */
 
-  self->rdreq = cdcecm_allocreq(self->epbulkout,
-                                CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
-  if (self->rdreq == NULL)
+  sq_init(&self->rxpending);
+  for (i = 0; i < CONFIG_CDCECM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      req = cdcecm_allocreq(self->epbulkout,
+                            CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->rdreq->callback = cdcecm_rdcomplete;
+      req->callback         = cdcecm_rdcomplete;
+      req->priv             = &self->rdreqs[i];
+      self->rdreqs[i].req   = req;
+    }
 
-  /* Pre-allocate a single write request.  Buffer size is one full packet. */
+  /* Pre-allocate write requests and put them in the free list.  The buffer
+   * size is one full packet.
+   */
 
-  self->wrreq = cdcecm_allocreq(self->epbulkin,
-                                CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
-  if (self->wrreq == NULL)
+  sq_init(&self->txfree);
+  for (i = 0; i < CONFIG_CDCECM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      req = cdcecm_allocreq(self->epbulkin,
+                            CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcecm_wrcomplete;
+      req->callback         = cdcecm_wrcomplete;
+      req->priv             = &self->wrreqs[i];
+      self->wrreqs[i].req   = req;
+      sq_addlast((FAR sq_entry_t *)&self->wrreqs[i], &self->txfree);
+    }
 
-  /* The single write request just allocated is available now. */
+  /* The write requests just allocated are available now.  The semaphore is
+   * used for signaling and must not have priority inheritance enabled.
+   */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCECM_NWRREQS);
+  if (ret == OK)
+    {
+      nxsem_setprotocol(&self->wrreq_idle, SEM_PRIO_NONE);
+    }
 
   if (ret != OK)
     {
@@ -1893,6 +1979,7 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -1932,12 +2019,17 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCECM_NRDREQS; i++)
     {
-      cdcecm_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i].req != NULL)
+        {
+          cdcecm_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
     }
 
+  sq_init(&self->rxpending);
+
   /* Free the bulk OUT endpoint */
 
   if (self->epbulkout)
@@ -1950,12 +2042,17 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCECM_NWRREQS; i++)
     {
-      cdcecm_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          cdcecm_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
+  sq_init(&self->txfree);
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
@@ -73,10 +73,38 @@
 #  define CONFIG_RNDIS_NWRREQS  (2)
 #endif
 
+#ifndef CONFIG_RNDIS_TXPACKETS
+#  define CONFIG_RNDIS_TXPACKETS (1)
+#endif
+
+#ifndef CONFIG_RNDIS_RXPACKETS
+#  define CONFIG_RNDIS_RXPACKETS (1)
+#endif
+
+/* Each RNDIS packet message in a multi-packet transfer starts on a 4-byte
+ * boundary (PacketAlignmentFactor 2).
+ */
+
 #define RNDIS_PACKET_HDR_SIZE   (sizeof(struct rndis_packet_msg))
+#define RNDIS_PACKET_ALIGN      (4)
+#define RNDIS_ALIGN(n) \
+  (((n) + RNDIS_PACKET_ALIGN - 1) & ~(RNDIS_PACKET_ALIGN - 1))
+#define RNDIS_PACKET_MSG_SIZE \
+  RNDIS_ALIGN(CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE + \
+              RNDIS_PACKET_HDR_SIZE)
+
+/* A write request holds up to CONFIG_RNDIS_TXPACKETS messages.  The read
+ * request holds a full transfer of up to CONFIG_RNDIS_RXPACKETS messages,
+ * plus the single byte short packet that the host appends to a transfer
+ * whose length is a multiple of the max packet size.  Its length is a
+ * multiple of the high speed max packet size.
+ */
+
+#define RNDIS_RX_XFRSIZE        (CONFIG_RNDIS_RXPACKETS * RNDIS_PACKET_MSG_SIZE)
 #define CONFIG_RNDIS_BULKIN_REQLEN \
-  (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE + RNDIS_PACKET_HDR_SIZE)
-#define CONFIG_RNDIS_BULKOUT_REQLEN CONFIG_RNDIS_BULKIN_REQLEN
+  (CONFIG_RNDIS_TXPACKETS * RNDIS_PACKET_MSG_SIZE)
+#define CONFIG_RNDIS_BULKOUT_REQLEN \
+  (((RNDIS_RX_XFRSIZE + 1 + 511) / 512) * 512)
 
 #define RNDIS_NCONFIGS          (1)
 #define RNDIS_CONFIGID          (1)
@@ -158,10 +186,11 @@ struct rndis_dev_s
   uint8_t config;                        /* USB Configuration number */
   FAR struct rndis_req_s *net_req;       /* Pointer to request whose buffer is assigned to network */
   FAR struct rndis_req_s *rx_req;        /* Pointer request container that holds RX buffer */
-  size_t current_rx_received;            /* Number of bytes of current RX datagram received over USB */
+  size_t current_rx_xfrd;                /* Number of bytes of the current RX transfer */
+  size_t current_rx_offset;              /* Offset of the next message in the RX transfer */
   size_t current_rx_datagram_size;       /* Total number of bytes of the current RX datagram */
-  size_t current_rx_datagram_offset;     /* Offset of current RX datagram */
-  size_t current_rx_msglen;              /* Length of the entire message to be received */
+  size_t host_xfrsize;                   /* Max transfer size accepted by the host */
+  uint16_t tx_lastmsg;                   /* Offset of the last message in net_req */
   bool rdreq_submitted;                  /* Indicates if the read request is submitted */
   bool rx_blocked;                       /* Indicates if we can receive packets on bulk in endpoint */
   bool ctrlreq_has_encap_response;       /* Indicates if ctrlreq buffer holds a response */
@@ -224,6 +253,7 @@ static int rndis_ifdown(FAR struct net_driver_s *dev);
 static int rndis_txavail(FAR struct net_driver_s *dev);
 static int rndis_transmit(FAR struct rndis_dev_s *priv);
 static int rndis_txpoll(FAR struct net_driver_s *dev);
+static int rndis_recvpacket(FAR struct rndis_dev_s *priv);
 static void rndis_polltimer(int argc, uint32_t arg, ...);
 
 /* usbclass callbacks */
@@ -486,7 +516,13 @@ static int rndis_submit_rdreq(FAR struct rndis_dev_s *priv)
 
   if (!priv->rdreq_submitted && !priv->rx_blocked)
     {
-      priv->rdreq->len = priv->epbulkout->maxpacket;
+      /* Receive a full transfer.  The host terminates it with a short
+       * packet.
+       */
+
+      priv->rdreq->len = (CONFIG_RNDIS_BULKOUT_REQLEN /
+                          priv->epbulkout->maxpacket) *
+                         priv->epbulkout->maxpacket;
       ret = EP_SUBMIT(priv->epbulkout, priv->rdreq);
       if (ret != OK)
         {
@@ -664,6 +700,7 @@ static bool rndis_allocnetreq(FAR struct rndis_dev_s *priv)
   priv->net_req = rndis_allocwrreq(priv);
   if (priv->net_req)
     {
+      priv->net_req->req->len = 0;
       priv->netdev.d_buf = &priv->net_req->req->buf[RNDIS_PACKET_HDR_SIZE];
       priv->netdev.d_len = CONFIG_NET_ETH_PKTSIZE;
     }
@@ -726,6 +763,37 @@ static void rndis_freenetreq(FAR struct rndis_dev_s *priv)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: rndis_flushnetreq
+ *
+ * Description:
+ *   Releases the request buffer held by the network at the end of a poll.
+ *   The request is submitted if it holds packets that were queued for
+ *   transmission, otherwise it is freed.
+ *
+ * Input Parameters:
+ *   priv: pointer to RNDIS device driver structure
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void rndis_flushnetreq(FAR struct rndis_dev_s *priv)
+{
+  if (priv->net_req != NULL)
+    {
+      if (priv->net_req->req->len > 0)
+        {
+          rndis_sendnetreq(priv);
+        }
+      else
+        {
+          rndis_freenetreq(priv);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: rndis_allocrxreq
  *
@@ -774,6 +842,7 @@ static void rndis_giverxreq(FAR struct rndis_dev_s *priv)
   DEBUGASSERT(priv->net_req == NULL);
 
   priv->net_req      = priv->rx_req;
+  priv->net_req->req->len = 0;
   priv->netdev.d_buf = &priv->net_req->req->buf[RNDIS_PACKET_HDR_SIZE];
   priv->netdev.d_len = CONFIG_NET_ETH_PKTSIZE;
   priv->rx_req       = NULL;
@@ -783,7 +852,9 @@ static void rndis_giverxreq(FAR struct rndis_dev_s *priv)
  * Name: rndis_fillrequest
  *
  * Description:
- *   Fills the RNDIS header to the request buffer
+ *   Fills the RNDIS header of the packet in d_buf.  The packet message is
+ *   appended to the messages already in the request buffer.  All but the
+ *   last message of a transfer are padded to RNDIS_PACKET_ALIGN.
  *
  * Input Parameters:
  *   priv: pointer to RNDIS device driver structure
@@ -800,17 +871,27 @@ static void rndis_giverxreq(FAR struct rndis_dev_s *priv)
 static uint16_t rndis_fillrequest(FAR struct rndis_dev_s *priv,
                                   FAR struct usbdev_req_s *req)
 {
+  FAR struct rndis_packet_msg *msg;
+  size_t offset;
   size_t datalen;
 
-  req->len = 0;
+  /* Pad the previous message */
+
+  offset = RNDIS_ALIGN(req->len);
+  if (offset > req->len)
+    {
+      msg = (FAR struct rndis_packet_msg *)&req->buf[priv->tx_lastmsg];
+      memset(&req->buf[req->len], 0, offset - req->len);
+      msg->msglen += offset - req->len;
+    }
 
   datalen = min(priv->netdev.d_len,
-                CONFIG_RNDIS_BULKIN_REQLEN - RNDIS_PACKET_HDR_SIZE);
+                CONFIG_RNDIS_BULKIN_REQLEN - RNDIS_PACKET_HDR_SIZE - offset);
   if (datalen > 0)
     {
       /* Send the required headers */
 
-      FAR struct rndis_packet_msg *msg = (FAR struct rndis_packet_msg *)req->buf;
+      msg = (FAR struct rndis_packet_msg *)&req->buf[offset];
       memset(msg, 0, RNDIS_PACKET_HDR_SIZE);
 
       msg->msgtype    = RNDIS_PACKET_MSG;
@@ -818,8 +899,9 @@ static uint16_t rndis_fillrequest(FAR struct rndis_dev_s *priv,
       msg->dataoffset = RNDIS_PACKET_HDR_SIZE - 8;
       msg->datalen    = datalen;
 
+      priv->tx_lastmsg = offset;
       req->flags      = USBDEV_REQFLAGS_NULLPKT;
-      req->len        = datalen + RNDIS_PACKET_HDR_SIZE;
+      req->len        = offset + RNDIS_PACKET_HDR_SIZE + datalen;
     }
 
   return req->len;
@@ -841,6 +923,7 @@ static void rndis_rxdispatch(FAR void *arg)
   FAR struct rndis_dev_s *priv = (FAR struct rndis_dev_s *)arg;
   FAR struct eth_hdr_s *hdr;
   irqstate_t flags;
+  int ret;
 
   net_lock();
   flags = enter_critical_section();
@@ -944,13 +1027,23 @@ static void rndis_rxdispatch(FAR void *arg)
     }
 
   priv->current_rx_datagram_size = 0;
-  rndis_unblock_rx(priv);
+  rndis_flushnetreq(priv);
 
-  if (priv->net_req != NULL)
+  /* Continue with the next packet message of the transfer.  When the
+   * transfer has been consumed, receive the next one.
+   */
+
+  flags = enter_critical_section();
+  ret = rndis_recvpacket(priv);
+  DEBUGASSERT(ret != -ENOMEM);
+
+  if (ret == OK)
     {
-      rndis_freenetreq(priv);
+      rndis_unblock_rx(priv);
+      rndis_submit_rdreq(priv);
     }
 
+  leave_critical_section(flags);
   net_unlock();
 }
 
@@ -1031,11 +1124,28 @@ static int rndis_txpoll(FAR struct net_driver_s *dev)
 
 static int rndis_transmit(FAR struct rndis_dev_s *priv)
 {
+  FAR struct usbdev_req_s *req = priv->net_req->req;
+  size_t offset;
   int ret = OK;
 
   /* Queue the packet */
 
-  rndis_fillrequest(priv, priv->net_req->req);
+  rndis_fillrequest(priv, req);
+
+  /* If the request has room for another full packet message and the host
+   * accepts the larger transfer, let the network fill the next packet in
+   * place.  The request is sent when it is full or at the end of the poll.
+   */
+
+  offset = RNDIS_ALIGN(req->len);
+  if (offset + RNDIS_PACKET_MSG_SIZE <= CONFIG_RNDIS_BULKIN_REQLEN &&
+      offset + RNDIS_PACKET_MSG_SIZE <= priv->host_xfrsize)
+    {
+      priv->netdev.d_buf = &req->buf[offset + RNDIS_PACKET_HDR_SIZE];
+      priv->netdev.d_len = CONFIG_NET_ETH_PKTSIZE;
+      return OK;
+    }
+
   rndis_sendnetreq(priv);
 
   if (!rndis_allocnetreq(priv))
@@ -1065,11 +1175,7 @@ static void rndis_pollworker(FAR void *arg)
   if (rndis_allocnetreq(priv))
     {
       devif_timer(&priv->netdev, rndis_txpoll);
-
-      if (priv->net_req != NULL)
-        {
-          rndis_freenetreq(priv);
-        }
+      rndis_flushnetreq(priv);
     }
 
   net_unlock();
@@ -1152,10 +1258,7 @@ static void rndis_txavail_work(FAR void *arg)
   if (rndis_allocnetreq(priv))
     {
       devif_poll(&priv->netdev, rndis_txpoll);
-      if (priv->net_req != NULL)
-        {
-          rndis_freenetreq(priv);
-        }
+      rndis_flushnetreq(priv);
     }
 
   net_unlock();
@@ -1183,20 +1286,34 @@ static int rndis_txavail(FAR struct net_driver_s *dev)
   return OK;
 }
 
-/************************************************************************************
+/****************************************************************************
  * Name: rndis_recvpacket
  *
  * Description:
- *   Handles a USB packet arriving on the data bulk out endpoint.
+ *   Handles the next RNDIS packet message of the transfer received on the
+ *   data bulk out endpoint.  The transfer may contain several packet
+ *   messages.  The datagram of the next valid one is copied to the RX
+ *   buffer and passed to the network by the RX worker.
+ *
+ * Returned Value:
+ *   -EBUSY if a datagram was passed to the RX worker.  Reception stays
+ *   blocked until the worker has handled it and the rest of the transfer.
+ *   OK if the whole transfer has been consumed.
  *
  * Assumptions:
- *   Called from the USB interrupt handler with interrupts disabled.
+ *   Called with interrupts disabled.
  *
- ************************************************************************************/
+ ****************************************************************************/
 
-static inline int rndis_recvpacket(FAR struct rndis_dev_s *priv,
-                                   FAR uint8_t *reqbuf, uint16_t reqlen)
+static int rndis_recvpacket(FAR struct rndis_dev_s *priv)
 {
+  FAR uint8_t *reqbuf = priv->rdreq->buf;
+  FAR struct rndis_packet_msg *msg;
+  size_t remaining;
+  size_t dataoffset;
+  size_t datalen;
+  int ret;
+
   if (!rndis_allocrxreq(priv))
     {
       return -ENOMEM;
@@ -1204,106 +1321,69 @@ static inline int rndis_recvpacket(FAR struct rndis_dev_s *priv,
 
   if (!priv->connected)
     {
+      priv->current_rx_xfrd   = 0;
+      priv->current_rx_offset = 0;
       return -EBUSY;
     }
 
-  if (!priv->current_rx_datagram_size)
-    {
-      if (reqlen < 16)
-        {
-          /* Packet too small to contain a message header */
-        }
-      else
-        {
-          /* The packet contains a RNDIS packet message header */
-
-          FAR struct rndis_packet_msg *msg = (FAR struct rndis_packet_msg *)reqbuf;
-          if (msg->msgtype == RNDIS_PACKET_MSG)
-            {
-              priv->current_rx_received = reqlen;
-              priv->current_rx_datagram_size = msg->datalen;
-              priv->current_rx_msglen = msg->msglen;
-
-              /* According to RNDIS-over-USB send, if the message length is a
-               * multiple of endpoint max packet size, the host must send an
-               * additional single-byte zero packet. Take that in account here.
-               */
+  /* A trailing single byte or zero length short packet is shorter than a
+   * message header and ends the loop.
+   */
 
-              if ((priv->current_rx_msglen % priv->epbulkout->maxpacket) == 0)
-                {
-                  priv->current_rx_msglen += 1;
-                }
+  while (priv->current_rx_xfrd >= priv->current_rx_offset + 16)
+    {
+      msg       = (FAR struct rndis_packet_msg *)
+                  &reqbuf[priv->current_rx_offset];
+      remaining = priv->current_rx_xfrd - priv->current_rx_offset;
 
-              /* Data offset is defined as an offset from the beginning of the
-               * offset field itself
-               */
+      if (msg->msgtype != RNDIS_PACKET_MSG || msg->msglen < 16 ||
+          msg->msglen > remaining)
+        {
+          /* The rest of the transfer cannot be parsed.  Drop it. */
 
-              priv->current_rx_datagram_offset = msg->dataoffset + 8;
-              if (priv->current_rx_datagram_offset < reqlen)
-                {
-                  memcpy(&priv->rx_req->req->buf[RNDIS_PACKET_HDR_SIZE],
-                         &reqbuf[priv->current_rx_datagram_offset],
-                         reqlen - priv->current_rx_datagram_offset);
-                }
-            }
-          else
-            {
-              uerr("Unknown RNDIS message type %u\n", msg->msgtype);
-            }
+          uerr("Unknown RNDIS message type %u\n", msg->msgtype);
+          break;
         }
-    }
-  else
-    {
-      if (priv->current_rx_received >= priv->current_rx_datagram_offset &&
-          priv->current_rx_received <= priv->current_rx_datagram_size +
-          priv->current_rx_datagram_offset)
-        {
-          size_t index = priv->current_rx_received - priv->current_rx_datagram_offset;
-          size_t copysize = min(reqlen, priv->current_rx_datagram_size - index);
 
-          /* Check if the received packet exceeds request buffer */
+      priv->current_rx_offset += msg->msglen;
 
-          if ((index + copysize) <= CONFIG_NET_ETH_PKTSIZE)
-            {
-              memcpy(&priv->rx_req->req->buf[RNDIS_PACKET_HDR_SIZE + index], reqbuf,
-                     copysize);
-            }
-          else
-            {
-              uerr("The packet exceeds request buffer (reqlen=%d) \n", reqlen);
-            }
-        }
-      priv->current_rx_received += reqlen;
-    }
+      /* Data offset is defined as an offset from the beginning of the
+       * offset field itself
+       */
+
+      dataoffset = msg->dataoffset + 8;
+      datalen    = msg->datalen;
 
-  if (priv->current_rx_received >= priv->current_rx_msglen)
-    {
       /* Check for a usable packet length (4 added for the CRC) */
 
-      if (priv->current_rx_datagram_size > (CONFIG_NET_ETH_PKTSIZE + 4) ||
-          priv->current_rx_datagram_size <= (ETH_HDRLEN + 4))
+      if (dataoffset > msg->msglen || datalen > msg->msglen - dataoffset ||
+          datalen > (CONFIG_NET_ETH_PKTSIZE + 4) ||
+          datalen <= (ETH_HDRLEN + 4))
         {
-          uerr("ERROR: Bad packet size dropped (%d)\n",
-               priv->current_rx_datagram_size);
+          uerr("ERROR: Bad packet size dropped (%d)\n", datalen);
           NETDEV_RXERRORS(&priv->netdev);
-          priv->current_rx_datagram_size = 0;
+          continue;
         }
-      else
-        {
-          int ret;
 
-          DEBUGASSERT(work_available(&priv->rxwork));
-          ret = work_queue(ETHWORK, &priv->rxwork, rndis_rxdispatch,
-                           priv, 0);
-          DEBUGASSERT(ret == 0);
-          UNUSED(ret);
+      memcpy(&priv->rx_req->req->buf[RNDIS_PACKET_HDR_SIZE],
+             (FAR uint8_t *)msg + dataoffset,
+             min(datalen, CONFIG_NET_ETH_PKTSIZE));
 
-          rndis_block_rx(priv);
-          priv->rndis_host_tx_count++;
-          return -EBUSY;
-        }
+      priv->current_rx_datagram_size = datalen;
+
+      DEBUGASSERT(work_available(&priv->rxwork));
+      ret = work_queue(ETHWORK, &priv->rxwork, rndis_rxdispatch,
+                       priv, 0);
+      DEBUGASSERT(ret == 0);
+      UNUSED(ret);
+
+      rndis_block_rx(priv);
+      priv->rndis_host_tx_count++;
+      return -EBUSY;
     }
 
+  priv->current_rx_xfrd   = 0;
+  priv->current_rx_offset = 0;
   return OK;
 }
 
@@ -1391,8 +1471,16 @@ static int rndis_handle_control_message(FAR struct rndis_dev_s *priv,
     {
       case RNDIS_INITIALIZE_MSG:
         {
+          FAR struct rndis_initialize_msg *msg =
+            (FAR struct rndis_initialize_msg *)dataout;
           FAR struct rndis_initialize_cmplt *resp;
 
+          /* More than one packet message is sent per transfer only if the
+           * host accepts the larger transfers.
+           */
+
+          priv->host_xfrsize = msg->xfrsize;
+
           rndis_prepare_response(priv, sizeof(struct rndis_initialize_cmplt), cmd_hdr);
           resp = (FAR struct rndis_initialize_cmplt *)priv->ctrlreq->buf;
 
@@ -1400,8 +1488,13 @@ static int rndis_handle_control_message(FAR struct rndis_dev_s *priv,
           resp->minor      = RNDIS_MINOR_VERSION;
           resp->devflags   = RNDIS_DEVICEFLAGS;
           resp->medium     = RNDIS_MEDIUM_802_3;
+#if CONFIG_RNDIS_RXPACKETS > 1
+          resp->pktperxfer = CONFIG_RNDIS_RXPACKETS;
+          resp->xfrsize    = RNDIS_RX_XFRSIZE;
+#else
           resp->pktperxfer = 1;
           resp->xfrsize    = (4 + 44 + 22) + RNDIS_BUFFER_SIZE;
+#endif
           resp->pktalign   = 2;
 
           rndis_send_encapsulated_response(priv);
@@ -1608,7 +1701,9 @@ static void rndis_rdcomplete(FAR struct usbdev_ep_s *ep,
   switch (req->result)
     {
     case 0: /* Normal completion */
-      ret = rndis_recvpacket(priv, req->buf, req->xfrd);
+      priv->current_rx_xfrd   = req->xfrd;
+      priv->current_rx_offset = 0;
+      ret = rndis_recvpacket(priv);
       DEBUGASSERT(ret != -ENOMEM);
       break;
 
@@ -2657,6 +2752,8 @@ static int usbclass_setconfig(FAR struct rndis_dev_s *priv, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
+  priv->current_rx_xfrd   = 0;
+  priv->current_rx_offset = 0;
   priv->rdreq->callback = rndis_rdcomplete;
   ret = rndis_submit_rdreq(priv);
   if (ret != OK)
@@ -123,7 +123,7 @@
 
 #ifndef CONFIG_USBMSC_BULKINREQLEN
 #  ifdef CONFIG_USBDEV_DUALSPEED
-#    define CONFIG_USBMSC_BULKINREQLEN 512
+#    define CONFIG_USBMSC_BULKINREQLEN 4096
 #  else
 #    define CONFIG_USBMSC_BULKINREQLEN 64
 #  endif
@@ -165,6 +165,20 @@
 #  endif
 #endif
 
+/* The number of sectors transferred by one block driver read or write */
+
+#ifndef CONFIG_USBMSC_IOSECTORS
+#  ifdef CONFIG_USBDEV_DUALSPEED
+#    define CONFIG_USBMSC_IOSECTORS 8
+#  else
+#    define CONFIG_USBMSC_IOSECTORS 1
+#  endif
+#endif
+
+#if CONFIG_USBMSC_IOSECTORS < 1
+#  error "CONFIG_USBMSC_IOSECTORS must be at least one"
+#endif
+
 /* Vendor and product IDs and strings */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -429,9 +443,10 @@ struct usbmsc_dev_s
   uint8_t           cbwdir:2;         /* Direction from CBW. See USBMSC_FLAGS_DIR* definitions */
   uint8_t           cdblen;           /* Length of cdb[] from CBW */
   uint8_t           cbwlun;           /* LUN from the CBW */
-  uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
-  uint16_t          iosize;           /* Size of iobuffer[] */
+  uint32_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint32_t          niobytes;         /* Bytes read into iobuffer[] */
+  uint32_t          iosize;           /* Size of iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
   uint32_t          cbwtag;           /* Tag from the CBW */
   union
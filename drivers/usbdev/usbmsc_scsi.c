@@ -1827,6 +1827,7 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   /* No data is buffered */
 
   priv->nsectbytes   = 0;
+  priv->niobytes     = 0;
   priv->nreqbytes    = 0;
 
   /* Get exclusive access to the block driver */
@@ -2106,10 +2107,16 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes not yet copied from iobuffer[]
+ *   niobytes   - holds the number of bytes read into iobuffer[]
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
+ *   Up to iosize bytes of sectors are read from the block driver at once.
+ *   The sector data is copied into the write requests which are then
+ *   submitted.  Several write requests may be in flight so that the USB
+ *   transfer of one block of sectors overlaps the reading of the next one.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
@@ -2119,6 +2126,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+  uint32_t nsectors;
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2137,10 +2145,12 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read as many of the next sectors as will fit */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+          nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+          nread    = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                      nsectors);
+          if (nread <= 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
               lun->sd     = SCSI_KCQME_UNRRE1;
@@ -2148,9 +2158,13 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          /* The block driver may have returned fewer sectors */
+
+          nsectors         = MIN((uint32_t)nread, nsectors);
+          priv->niobytes   = nsectors * lun->sectorsize;
+          priv->nsectbytes = priv->niobytes;
+          priv->u.xfrlen  -= nsectors;
+          priv->sector    += nsectors;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2178,7 +2192,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
       nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes, priv->nsectbytes);
@@ -2253,10 +2267,16 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be written.
  *   sector     - holds the sector number of the next sector to write
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes buffered in iobuffer[]
  *   nreqbytes  - holds the number of untransferred bytes currently in the
  *                request at the head of the rdreqlist.
  *
+ *   The received data is gathered in iobuffer[] and written to the block
+ *   driver when iobuffer[] is full or when it holds the rest of the
+ *   transfer.  The read requests are returned to the bulk OUT endpoint as
+ *   soon as they have been copied so that the host can continue sending
+ *   while the sectors are written.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
@@ -2265,6 +2285,8 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbmsc_req_s *privreq;
   FAR struct usbdev_req_s *req;
   ssize_t nwritten;
+  uint32_t nsectors;
+  uint32_t iolen;
   uint16_t xfrd;
   uint8_t *src;
   uint8_t *dest;
@@ -2313,10 +2335,13 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
         {
           /* Copy the data received in the read request into the sector I/O buffer */
 
+          nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+          iolen    = nsectors * lun->sectorsize;
+
           src  = &req->buf[xfrd - priv->nreqbytes];
           dest = &priv->iobuffer[priv->nsectbytes];
 
-          nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
+          nbytes = MIN(iolen - priv->nsectbytes, priv->nreqbytes);
 
           /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2326,12 +2351,13 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
           /* Is the I/O buffer full? */
 
-          if (priv->nsectbytes >= lun->sectorsize)
+          if (priv->nsectbytes >= iolen)
             {
-              /* Yes.. Write the next sector */
+              /* Yes.. Write the buffered sectors */
 
-              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, 1);
-              if (nwritten < 0)
+              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector,
+                                           nsectors);
+              if (nwritten < (ssize_t)nsectors)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
                   lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
@@ -2340,9 +2366,9 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
                 }
 
               priv->nsectbytes = 0;
-              priv->residue   -= lun->sectorsize;
-              priv->u.xfrlen--;
-              priv->sector++;
+              priv->residue   -= iolen;
+              priv->u.xfrlen  -= nsectors;
+              priv->sector    += nsectors;
             }
         }
 
@@ -2365,6 +2391,27 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       if (xfrd != CONFIG_USBMSC_BULKOUTREQLEN)
         {
+          /* Write the complete sectors that are still buffered */
+
+          nsectors = priv->nsectbytes / lun->sectorsize;
+          if (priv->u.xfrlen > 0 && nsectors > 0)
+            {
+              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector,
+                                           nsectors);
+              if (nwritten < (ssize_t)nsectors)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
+                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+                  lun->sdinfo = priv->sector;
+                }
+              else
+                {
+                  priv->residue  -= nsectors * lun->sectorsize;
+                  priv->u.xfrlen -= nsectors;
+                  priv->sector   += nsectors;
+                }
+            }
+
           priv->shortpacket = 1;
           goto errout;
         }
@@ -90,6 +90,20 @@
 #  error "Currently limited to 26 devices /dev/sda-z"
 #endif
 
+/* Read-ahead of consecutive sectors needs asynchronous transfers */
+
+#ifndef CONFIG_USBHOST_MSC_READAHEAD
+#  define CONFIG_USBHOST_MSC_READAHEAD 0
+#endif
+
+#if defined(CONFIG_USBHOST_ASYNCH) && CONFIG_USBHOST_MSC_READAHEAD > 0
+#  define HAVE_READAHEAD 1
+#endif
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
 /* Driver support ***********************************************************/
 /* This format is used to construct the /dev/sd[n] device driver path.  It
  * defined here so that it will be used consistently in all places.
@@ -137,6 +151,15 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#ifdef HAVE_READAHEAD
+  FAR uint8_t            *rabuffer;     /* The allocated read-ahead buffer */
+  uint32_t                rasector;     /* First sector in rabuffer */
+  uint16_t                ransectors;   /* Valid sectors in rabuffer */
+  uint16_t                rapending;    /* Number of sectors being read ahead */
+  uint32_t                nextsector;   /* Sector following the previous read */
+  volatile ssize_t        raresult;     /* Result of the read-ahead transfer */
+  sem_t                   rasem;        /* Signals read-ahead completion */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -937,6 +960,25 @@ static void usbhost_destroy(FAR void *arg)
 
   usbhost_freedevno(priv);
 
+#ifdef HAVE_READAHEAD
+  /* Cancel any pending read-ahead and free the read-ahead buffer */
+
+  if (priv->rapending > 0)
+    {
+      DRVR_CANCEL(hport->drvr, priv->bulkin);
+      nxsem_wait_uninterruptible(&priv->rasem);
+      priv->rapending = 0;
+    }
+
+  if (priv->rabuffer != NULL)
+    {
+      DRVR_IOFREE(hport->drvr, priv->rabuffer);
+      priv->rabuffer = NULL;
+    }
+
+  nxsem_destroy(&priv->rasem);
+#endif
+
   /* Free the bulk endpoints */
 
   if (priv->bulkout)
@@ -1649,6 +1691,186 @@ static FAR struct usbmsc_cbw_s *usbhost_cbwalloc(FAR struct usbhost_state_s *pri
   return cbw;
 }
 
+/****************************************************************************
+ * Name: usbhost_racallback
+ *
+ * Description:
+ *   Called by the USB host controller driver when the data transfer of the
+ *   read-ahead completes.  This function probably executes in the context
+ *   of an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_READAHEAD
+static void usbhost_racallback(FAR void *arg, ssize_t result)
+{
+  FAR struct usbhost_state_s *priv = (FAR struct usbhost_state_s *)arg;
+
+  priv->raresult = result;
+  nxsem_post(&priv->rasem);
+}
+#endif
+
+/****************************************************************************
+ * Name: usbhost_rastart
+ *
+ * Description:
+ *   Start reading the sectors that follow the previous read into the
+ *   read-ahead buffer.  The CBW is sent synchronously, then the data
+ *   transfer is started asynchronously so that it proceeds while the
+ *   caller handles the data that it has just read.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem and no read-ahead is pending.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_READAHEAD
+static void usbhost_rastart(FAR struct usbhost_state_s *priv,
+                            uint32_t startsector)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_cbw_s *cbw;
+  uint32_t nsectors;
+  ssize_t nbytes;
+  int ret;
+
+  DEBUGASSERT(priv->rapending == 0);
+
+  if (startsector >= priv->nblocks)
+    {
+      return;
+    }
+
+  nsectors = MIN(priv->nblocks - startsector, CONFIG_USBHOST_MSC_READAHEAD);
+
+  /* Allocate the read-ahead buffer on the first use, when the block size
+   * is known.
+   */
+
+  if (priv->rabuffer == NULL)
+    {
+      ret = DRVR_IOALLOC(hport->drvr, &priv->rabuffer,
+                         priv->blocksize * CONFIG_USBHOST_MSC_READAHEAD);
+      if (ret < 0)
+        {
+          priv->rabuffer = NULL;
+          return;
+        }
+    }
+
+  /* Construct and send the CBW */
+
+  cbw = usbhost_cbwalloc(priv);
+  usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
+  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                         (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+  if (nbytes < 0)
+    {
+      return;
+    }
+
+  priv->rasector   = startsector;
+  priv->ransectors = 0;
+  priv->rapending  = nsectors;
+
+  /* Start receiving the data */
+
+  ret = DRVR_ASYNCH(hport->drvr, priv->bulkin, priv->rabuffer,
+                    priv->blocksize * nsectors, usbhost_racallback, priv);
+  if (ret < 0)
+    {
+      /* The device waits for the data phase, so receive the data now */
+
+      priv->raresult = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                     priv->rabuffer,
+                                     priv->blocksize * nsectors);
+      nxsem_post(&priv->rasem);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: usbhost_rawait
+ *
+ * Description:
+ *   Wait for the pending read-ahead to complete and receive its CSW.  On
+ *   success, the sectors become valid in the read-ahead buffer.  The bulk
+ *   endpoints are then available for the next command.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_READAHEAD
+static void usbhost_rawait(FAR struct usbhost_state_s *priv)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_csw_s *csw;
+  ssize_t nbytes;
+
+  if (priv->rapending == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&priv->rasem);
+
+  nbytes = priv->raresult;
+  if (nbytes >= 0)
+    {
+      /* Receive the CSW */
+
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                             priv->tbuffer, USBMSC_CSW_SIZEOF);
+      if (nbytes >= 0)
+        {
+          /* Check the CSW status */
+
+          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+          if (csw->status == 0)
+            {
+              priv->ransectors = MIN(priv->rapending,
+                                     priv->raresult / priv->blocksize);
+            }
+        }
+    }
+
+  priv->rapending = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: usbhost_ranext
+ *
+ * Description:
+ *   Called after a read.  If the read followed the previous one and the
+ *   next sectors are not in the read-ahead buffer yet, start reading them
+ *   ahead.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem and no read-ahead is pending.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_READAHEAD
+static void usbhost_ranext(FAR struct usbhost_state_s *priv,
+                           uint32_t startsector, unsigned int nsectors)
+{
+  uint32_t next = startsector + nsectors;
+
+  if (startsector == priv->nextsector &&
+      (next < priv->rasector ||
+       next >= priv->rasector + priv->ransectors))
+    {
+      usbhost_rastart(priv, next);
+    }
+
+  priv->nextsector = next;
+}
+#endif
+
 /****************************************************************************
  * struct usbhost_registry_s methods
  ****************************************************************************/
@@ -1711,6 +1933,15 @@ usbhost_create(FAR struct usbhost_hubport_s *hport,
 
           nxsem_init(&priv->exclsem, 0, 1);
 
+#ifdef HAVE_READAHEAD
+          /* The read-ahead semaphore is used for signaling and must not
+           * have priority inheritance enabled.
+           */
+
+          nxsem_init(&priv->rasem, 0, 0);
+          nxsem_setprotocol(&priv->rasem, SEM_PRIO_NONE);
+#endif
+
           /* NOTE: We do not yet know the geometry of the USB mass storage device */
 
           /* Return the instance of the USB mass storage class */
@@ -2016,9 +2247,31 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
 
       nbytes = -ENOMEM;
 
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
+#ifdef HAVE_READAHEAD
+      /* Complete any pending read-ahead.  Then check if the sectors are
+       * already in the read-ahead buffer.
+       */
+
+      usbhost_rawait(priv);
+      if (startsector >= priv->rasector &&
+          startsector + nsectors <= priv->rasector + priv->ransectors)
+        {
+          memcpy(buffer,
+                 &priv->rabuffer[(startsector - priv->rasector) *
+                                 priv->blocksize],
+                 priv->blocksize * nsectors);
+
+          nbytes = priv->blocksize * nsectors;
+          cbw    = NULL;
+        }
+      else
+#endif
+        {
+          /* Initialize a CBW (re-using the allocated transfer buffer) */
+
+          cbw = usbhost_cbwalloc(priv);
+        }
 
-      cbw = usbhost_cbwalloc(priv);
       if (cbw)
         {
           /* Loop in the event that EAGAIN is returned (mean that the
@@ -2067,6 +2320,13 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
           while (nbytes == -EAGAIN);
         }
 
+#ifdef HAVE_READAHEAD
+      if (nbytes >= 0)
+        {
+          usbhost_ranext(priv, startsector, nsectors);
+        }
+#endif
+
       usbhost_givesem(&priv->exclsem);
     }
 
@@ -2117,6 +2377,15 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 
       usbhost_takesem(&priv->exclsem);
 
+#ifdef HAVE_READAHEAD
+      /* Complete any pending read-ahead and discard the read-ahead data,
+       * which may be overwritten now.
+       */
+
+      usbhost_rawait(priv);
+      priv->ransectors = 0;
+#endif
+
      /* Assume allocation failure */
 
       nbytes = -ENOMEM;
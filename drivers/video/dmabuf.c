@@ -0,0 +1,285 @@
+/****************************************************************************
+ * drivers/video/dmabuf.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/video/dmabuf.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A handle is the slot number in the low byte and a generation count in the
+ * upper bits, so that a stale handle does not refer to a re-used slot.
+ */
+
+#define DMABUF_SLOT_BITS   8
+#define DMABUF_SLOT_MASK   ((1 << DMABUF_SLOT_BITS) - 1)
+#define DMABUF_GEN_MASK    0x7fff
+
+#define DMABUF_HANDLE(s,g) (((g) << DMABUF_SLOT_BITS) | (s))
+#define DMABUF_SLOT(h)     ((h) & DMABUF_SLOT_MASK)
+#define DMABUF_GEN(h)      (((h) >> DMABUF_SLOT_BITS) & DMABUF_GEN_MASK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dmabuf_s
+{
+  FAR void *addr;              /* Start of the buffer */
+  size_t size;                 /* Size of the buffer in bytes */
+  dmabuf_release_t release;    /* Called when the last reference is dropped */
+  FAR void *arg;               /* Argument of the release function */
+  uint16_t gen;                /* Generation of the slot.  Zero if free */
+  uint16_t crefs;              /* Number of references */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dmabuf_s g_dmabuf[CONFIG_VIDEO_DMABUF_NHANDLES];
+
+/* The generation of the next buffer */
+
+static uint16_t g_dmabuf_gen;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_find
+ *
+ * Description:
+ *   Return the buffer referred to by a handle or NULL.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct dmabuf_s *dmabuf_find(int handle)
+{
+  FAR struct dmabuf_s *buf;
+  int slot;
+
+  if (handle < 0)
+    {
+      return NULL;
+    }
+
+  slot = DMABUF_SLOT(handle);
+  if (slot >= CONFIG_VIDEO_DMABUF_NHANDLES)
+    {
+      return NULL;
+    }
+
+  buf = &g_dmabuf[slot];
+  if (buf->gen == 0 || buf->gen != DMABUF_GEN(handle))
+    {
+      return NULL;
+    }
+
+  return buf;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Create a handle for a block of memory.  The handle holds a reference
+ *   that belongs to the caller and is dropped with dmabuf_release().
+ *
+ * Input Parameters:
+ *   addr    - The start of the buffer
+ *   size    - The size of the buffer in bytes
+ *   release - Called when the last reference is dropped, or NULL
+ *   arg     - The argument passed to 'release'
+ *
+ * Returned Value:
+ *   A non-negative handle is returned on success; a negated errno value is
+ *   returned on failure.  -ENFILE means that all CONFIG_VIDEO_DMABUF_NHANDLES
+ *   handles are in use.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR void *addr, size_t size, dmabuf_release_t release,
+                  FAR void *arg)
+{
+  FAR struct dmabuf_s *buf;
+  irqstate_t flags;
+  int slot;
+  int ret = -ENFILE;
+
+  if (addr == NULL || size == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  for (slot = 0; slot < CONFIG_VIDEO_DMABUF_NHANDLES; slot++)
+    {
+      buf = &g_dmabuf[slot];
+      if (buf->gen == 0)
+        {
+          /* Generation zero marks a free slot */
+
+          g_dmabuf_gen = (g_dmabuf_gen + 1) & DMABUF_GEN_MASK;
+          if (g_dmabuf_gen == 0)
+            {
+              g_dmabuf_gen = 1;
+            }
+
+          buf->addr    = addr;
+          buf->size    = size;
+          buf->release = release;
+          buf->arg     = arg;
+          buf->gen     = g_dmabuf_gen;
+          buf->crefs   = 1;
+
+          ret = DMABUF_HANDLE(slot, buf->gen);
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dmabuf_import
+ *
+ * Description:
+ *   Look up the buffer referred to by a handle and take a reference to it.
+ *   The reference is dropped with dmabuf_release().
+ *
+ * Input Parameters:
+ *   handle - The handle returned by dmabuf_export()
+ *   info   - The location to return the address and size of the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EBADF is returned if the handle does
+ *   not refer to a buffer.
+ *
+ ****************************************************************************/
+
+int dmabuf_import(int handle, FAR struct dmabuf_info_s *info)
+{
+  FAR struct dmabuf_s *buf;
+  irqstate_t flags;
+  int ret = -EBADF;
+
+  DEBUGASSERT(info != NULL);
+
+  flags = enter_critical_section();
+  buf = dmabuf_find(handle);
+  if (buf != NULL)
+    {
+      DEBUGASSERT(buf->crefs < UINT16_MAX);
+      buf->crefs++;
+
+      info->addr = buf->addr;
+      info->size = buf->size;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dmabuf_release
+ *
+ * Description:
+ *   Drop one reference to a buffer.  When the last reference is dropped,
+ *   the handle becomes invalid and the release function of the buffer is
+ *   called.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by dmabuf_export()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void dmabuf_release(int handle)
+{
+  FAR struct dmabuf_s *buf;
+  dmabuf_release_t release = NULL;
+  FAR void *arg = NULL;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  buf = dmabuf_find(handle);
+  if (buf != NULL)
+    {
+      DEBUGASSERT(buf->crefs > 0);
+      if (--buf->crefs == 0)
+        {
+          release  = buf->release;
+          arg      = buf->arg;
+          buf->gen = 0;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* The memory is freed outside of the critical section */
+
+  if (release != NULL)
+    {
+      release(arg);
+    }
+}
+
+#endif /* CONFIG_VIDEO_DMABUF */
@@ -44,14 +44,17 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <poll.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/video/dmabuf.h>
 
 /****************************************************************************
  * Private Types
@@ -60,9 +63,18 @@
 /* This structure defines one framebuffer device.  Note that which is
  * everything in this structure is constant data set up and initialization
  * time.  Therefore, no there is requirement for serialized access to this
- * structure.
+ * structure.  The exception are the shared DMA buffer handles which are
+ * updated within a critical section.
  */
 
+#ifdef CONFIG_VIDEO_DMABUF
+struct fb_dmabuf_layer_s
+{
+  int exported;                   /* Handle of the own memory or -1 */
+  int imported;                   /* Handle being scanned out or -1 */
+};
+#endif
+
 struct fb_chardev_s
 {
   FAR struct fb_vtable_s *vtable; /* Framebuffer interface */
@@ -70,6 +82,19 @@ struct fb_chardev_s
   size_t fblen;                   /* Size of the framebuffer */
   uint8_t plane;                  /* Video plan number */
   uint8_t bpp;                    /* Bits per pixel */
+#ifdef CONFIG_VIDEO_DMABUF
+  uint8_t nlayers;                /* The plane and each overlay */
+  FAR struct fb_dmabuf_layer_s *layers;
+#endif
+#ifdef CONFIG_FB_PANDISPLAY
+  FAR struct fb_chardev_s *flink; /* Supports a singly linked list */
+  fb_coord_t yres;                /* Number of displayed lines */
+  fb_coord_t yres_virtual;        /* Number of lines in fbmem */
+  fb_coord_t yoffset;             /* First displayed line */
+  bool pending;                   /* A flip waits for the vsync */
+  struct fb_planeinfo_s pan;      /* The pending flip */
+  FAR struct pollfd *fds[CONFIG_FB_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -84,6 +109,21 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
 static off_t   fb_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifdef CONFIG_FB_PANDISPLAY
+static int     fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                 bool setup);
+static void    fb_pollnotify(FAR struct fb_chardev_s *fb);
+static int     fb_pandisplay(FAR struct fb_chardev_s *fb,
+                 FAR const struct fb_planeinfo_s *pinfo);
+#endif
+#ifdef CONFIG_VIDEO_DMABUF
+static int     fb_dmabuf_mem(FAR struct fb_chardev_s *fb, int overlay,
+                 FAR void **fbmem, FAR size_t *fblen);
+static int     fb_dmabuf_get(FAR struct fb_chardev_s *fb,
+                 FAR struct fb_dmabuf_s *dmabuf);
+static int     fb_dmabuf_set(FAR struct fb_chardev_s *fb,
+                 FAR const struct fb_dmabuf_s *dmabuf);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -97,12 +137,24 @@ static const struct file_operations fb_fops =
   fb_write,      /* write */
   fb_seek,       /* seek */
   fb_ioctl,      /* ioctl */
+#ifdef CONFIG_FB_PANDISPLAY
+  fb_poll        /* poll */
+#else
   NULL           /* poll */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL         /* unlink */
 #endif
 };
 
+#ifdef CONFIG_FB_PANDISPLAY
+/* The list of registered framebuffer devices, used to find the device of a
+ * plane in fb_vsync_notify().
+ */
+
+static FAR struct fb_chardev_s *g_fb_list;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -295,6 +347,329 @@ static off_t fb_seek(FAR struct file *filep, off_t offset, int whence)
   return ret;
 }
 
+/****************************************************************************
+ * Name: fb_dmabuf_mem
+ *
+ * Description:
+ *   Return the own memory of the plane or of an overlay.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VIDEO_DMABUF
+static int fb_dmabuf_mem(FAR struct fb_chardev_s *fb, int overlay,
+                         FAR void **fbmem, FAR size_t *fblen)
+{
+#ifdef CONFIG_FB_OVERLAY
+  struct fb_overlayinfo_s oinfo;
+  int ret;
+#endif
+
+  if (overlay == FB_DMABUF_PLANE)
+    {
+      *fbmem = fb->fbmem;
+      *fblen = fb->fblen;
+      return OK;
+    }
+
+  if (overlay < 0 || overlay + 1 >= fb->nlayers)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_FB_OVERLAY
+  ret = fb->vtable->getoverlayinfo(fb->vtable, overlay, &oinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *fbmem = oinfo.fbmem;
+  *fblen = oinfo.fblen;
+  return OK;
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: fb_dmabuf_get
+ *
+ * Description:
+ *   Export the own memory of the plane or of an overlay.  The memory is
+ *   exported once and is never freed.
+ *
+ ****************************************************************************/
+
+static int fb_dmabuf_get(FAR struct fb_chardev_s *fb,
+                         FAR struct fb_dmabuf_s *dmabuf)
+{
+  FAR struct fb_dmabuf_layer_s *layer;
+  FAR void *fbmem;
+  size_t fblen;
+  irqstate_t flags;
+  int handle;
+  int ret;
+
+  ret = fb_dmabuf_mem(fb, dmabuf->overlay, &fbmem, &fblen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  layer = &fb->layers[dmabuf->overlay + 1];
+  if (layer->exported < 0)
+    {
+      handle = dmabuf_export(fbmem, fblen, NULL, NULL);
+      if (handle < 0)
+        {
+          return handle;
+        }
+
+      /* Keep only one handle if there was a concurrent export */
+
+      flags = enter_critical_section();
+      if (layer->exported < 0)
+        {
+          layer->exported = handle;
+          handle = -1;
+        }
+
+      leave_critical_section(flags);
+
+      if (handle >= 0)
+        {
+          dmabuf_release(handle);
+        }
+    }
+
+  dmabuf->handle = layer->exported;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fb_dmabuf_set
+ *
+ * Description:
+ *   Scan out the plane or an overlay from a shared DMA buffer, or restore
+ *   the own memory if the handle is negative.  A reference to the buffer is
+ *   held until it is replaced.  Read, write and mmap still access the
+ *   own memory.
+ *
+ ****************************************************************************/
+
+static int fb_dmabuf_set(FAR struct fb_chardev_s *fb,
+                         FAR const struct fb_dmabuf_s *dmabuf)
+{
+  FAR struct fb_dmabuf_layer_s *layer;
+  struct dmabuf_info_s info;
+  FAR void *fbmem;
+  size_t fblen;
+  irqstate_t flags;
+  int previous;
+  int ret;
+
+  if (fb->vtable->setbuffer == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = fb_dmabuf_mem(fb, dmabuf->overlay, &fbmem, &fblen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dmabuf->handle < 0)
+    {
+      info.addr = NULL;
+      info.size = 0;
+    }
+  else
+    {
+      ret = dmabuf_import(dmabuf->handle, &info);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The buffer must hold a complete image of the overlay */
+
+      if (info.size < fblen)
+        {
+          dmabuf_release(dmabuf->handle);
+          return -EINVAL;
+        }
+    }
+
+  ret = fb->vtable->setbuffer(fb->vtable, dmabuf->overlay, info.addr,
+                              info.size);
+  if (ret < 0)
+    {
+      if (dmabuf->handle >= 0)
+        {
+          dmabuf_release(dmabuf->handle);
+        }
+
+      return ret;
+    }
+
+  /* The previous buffer is no longer scanned out */
+
+  layer = &fb->layers[dmabuf->overlay + 1];
+
+  flags           = enter_critical_section();
+  previous        = layer->imported;
+  layer->imported = dmabuf->handle < 0 ? -1 : dmabuf->handle;
+  leave_critical_section(flags);
+
+  if (previous >= 0)
+    {
+      dmabuf_release(previous);
+    }
+
+  return OK;
+}
+#endif /* CONFIG_VIDEO_DMABUF */
+
+#ifdef CONFIG_FB_PANDISPLAY
+/****************************************************************************
+ * Name: fb_pollnotify
+ *
+ * Description:
+ *   Wake up the threads waiting for the next flip to be possible.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void fb_pollnotify(FAR struct fb_chardev_s *fb)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FB_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = fb->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & POLLOUT);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fb_poll
+ *
+ * Description:
+ *   The standard poll method.  POLLOUT is reported while no flip is
+ *   waiting for the vsync, i.e. when the previous front buffer may be
+ *   drawn into.
+ *
+ ****************************************************************************/
+
+static int fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                   bool setup)
+{
+  FAR struct inode *inode;
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  fb    = (FAR struct fb_chardev_s *)inode->i_private;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_FB_NPOLLWAITERS; i++)
+        {
+          if (fb->fds[i] == NULL)
+            {
+              fb->fds[i] = fds;
+              fds->priv  = &fb->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FB_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (!fb->pending)
+        {
+          fb_pollnotify(fb);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fb_pandisplay
+ *
+ * Description:
+ *   Request that the buffer at pinfo->yoffset is displayed.  With
+ *   CONFIG_FB_SYNC, the flip is applied by fb_vsync_notify().  Only one
+ *   flip may be pending.
+ *
+ ****************************************************************************/
+
+static int fb_pandisplay(FAR struct fb_chardev_s *fb,
+                         FAR const struct fb_planeinfo_s *pinfo)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  if (fb->vtable->pandisplay == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if ((uint32_t)pinfo->yoffset + fb->yres > fb->yres_virtual)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (fb->pending)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+#ifdef CONFIG_FB_SYNC
+      fb->pan     = *pinfo;
+      fb->pending = true;
+#else
+      ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+      if (ret >= 0)
+        {
+          fb->yoffset = pinfo->yoffset;
+        }
+#endif
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_FB_PANDISPLAY */
+
 /****************************************************************************
  * Name: fb_ioctl
  *
@@ -351,10 +726,29 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           DEBUGASSERT(pinfo != 0 && fb->vtable != NULL &&
                       fb->vtable->getplaneinfo != NULL);
+#ifdef CONFIG_FB_PANDISPLAY
+          memset(pinfo, 0, sizeof(struct fb_planeinfo_s));
+#endif
           ret = fb->vtable->getplaneinfo(fb->vtable, fb->plane, pinfo);
+#ifdef CONFIG_FB_PANDISPLAY
+          pinfo->yres_virtual = fb->yres_virtual;
+          pinfo->yoffset      = fb->yoffset;
+#endif
         }
         break;
 
+#ifdef CONFIG_FB_PANDISPLAY
+      case FBIOPAN_DISPLAY:  /* Flip to another buffer */
+        {
+          FAR const struct fb_planeinfo_s *pinfo =
+            (FAR const struct fb_planeinfo_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(pinfo != NULL);
+          ret = fb_pandisplay(fb, pinfo);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_FB_CMAP
       case FBIOGET_CMAP:       /* Get RGB color mapping */
         {
@@ -534,6 +928,28 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIOGET_DMABUF:  /* Export the plane or an overlay */
+        {
+          FAR struct fb_dmabuf_s *dmabuf =
+            (FAR struct fb_dmabuf_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(dmabuf != NULL);
+          ret = fb_dmabuf_get(fb, dmabuf);
+        }
+        break;
+
+      case FBIOSET_DMABUF:  /* Scan out a shared DMA buffer */
+        {
+          FAR const struct fb_dmabuf_s *dmabuf =
+            (FAR const struct fb_dmabuf_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(dmabuf != NULL);
+          ret = fb_dmabuf_set(fb, dmabuf);
+        }
+        break;
+#endif
+
       default:
         gerr("ERROR: Unsupported IOCTL command: %d\n", cmd);
         ret = -ENOTTY;
@@ -580,6 +996,12 @@ int fb_register(int display, int plane)
 #endif
   char devname[16];
   int nplanes;
+#ifdef CONFIG_FB_PANDISPLAY
+  irqstate_t flags;
+#endif
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+#endif
   int ret;
 
   /* Allocate a framebuffer state instance */
@@ -623,6 +1045,9 @@ int fb_register(int display, int plane)
   DEBUGASSERT(vinfo.nplanes > 0 && (unsigned)plane < vinfo.nplanes);
 
   DEBUGASSERT(fb->vtable->getplaneinfo != NULL);
+#ifdef CONFIG_FB_PANDISPLAY
+  memset(&pinfo, 0, sizeof(struct fb_planeinfo_s));
+#endif
   ret = fb->vtable->getplaneinfo(fb->vtable, plane, &pinfo);
   if (ret < 0)
     {
@@ -634,6 +1059,15 @@ int fb_register(int display, int plane)
   fb->fblen  = pinfo.fblen;
   fb->bpp    = pinfo.bpp;
 
+#ifdef CONFIG_FB_PANDISPLAY
+  /* Drivers without multiple buffers do not set yres_virtual */
+
+  fb->yres         = vinfo.yres;
+  fb->yres_virtual = pinfo.yres_virtual > vinfo.yres ?
+                     pinfo.yres_virtual : vinfo.yres;
+  fb->yoffset      = pinfo.yoffset;
+#endif
+
   /* Clear the framebuffer memory */
 
   memset(pinfo.fbmem, 0, pinfo.fblen);
@@ -656,6 +1090,30 @@ int fb_register(int display, int plane)
   memset(oinfo.fbmem, 0, oinfo.fblen);
 #endif
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Allocate the shared DMA buffer handles of the plane and overlays */
+
+#ifdef CONFIG_FB_OVERLAY
+  fb->nlayers = vinfo.noverlays + 1;
+#else
+  fb->nlayers = 1;
+#endif
+
+  fb->layers = (FAR struct fb_dmabuf_layer_s *)
+    kmm_malloc(fb->nlayers * sizeof(struct fb_dmabuf_layer_s));
+  if (fb->layers == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_fb;
+    }
+
+  for (i = 0; i < fb->nlayers; i++)
+    {
+      fb->layers[i].exported = -1;
+      fb->layers[i].imported = -1;
+    }
+#endif
+
   /* Register the framebuffer device */
 
   if (nplanes < 2)
@@ -674,9 +1132,70 @@ int fb_register(int display, int plane)
       goto errout_with_fb;
     }
 
+#ifdef CONFIG_FB_PANDISPLAY
+  flags      = enter_critical_section();
+  fb->flink  = g_fb_list;
+  g_fb_list  = fb;
+  leave_critical_section(flags);
+#endif
+
   return OK;
 
 errout_with_fb:
+#ifdef CONFIG_VIDEO_DMABUF
+  if (fb->layers != NULL)
+    {
+      kmm_free(fb->layers);
+    }
+
+#endif
   kmm_free(fb);
   return ret;
 }
+
+/****************************************************************************
+ * Name: fb_vsync_notify
+ *
+ * Description:
+ *   Called by the framebuffer driver at each vertical sync, normally from
+ *   the vsync interrupt handler.  Apply a page flip requested with
+ *   FBIOPAN_DISPLAY and wake up the threads waiting in poll() for POLLOUT.
+ *
+ * Input Parameters:
+ *   vtable - The plane as returned by up_fbgetvplane()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PANDISPLAY
+void fb_vsync_notify(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (fb = g_fb_list; fb != NULL; fb = fb->flink)
+    {
+      if (fb->vtable != vtable)
+        {
+          continue;
+        }
+
+      if (fb->pending)
+        {
+          if (fb->vtable->pandisplay(fb->vtable, &fb->pan) >= 0)
+            {
+              fb->yoffset = fb->pan.yoffset;
+            }
+
+          fb->pending = false;
+        }
+
+      fb_pollnotify(fb);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
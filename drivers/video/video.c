@@ -50,6 +50,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/video/dmabuf.h>
 
 #include <arch/board/board.h>
 
@@ -70,6 +71,23 @@
 
 #define VIDEO_REMAINING_CAPNUM_INFINITY (-1)
 
+/* Alignment of the buffers allocated by VIDIOC_REQBUFS(V4L2_MEMORY_MMAP).
+ * This is the largest cache line size of the supported cores, so that a
+ * buffer can be invalidated without affecting its neighbours.
+ */
+
+#define VIDEO_MMAP_ALIGN        (32)
+
+#define VIDEO_ALIGN_UP(n)       (((n) + VIDEO_MMAP_ALIGN - 1) & \
+                                 ~(VIDEO_MMAP_ALIGN - 1))
+
+#ifdef CONFIG_VIDEO_DMABUF
+#  define SIZEOF_VIDEO_MMAP_S(n) \
+     (sizeof(struct video_mmap_s) + ((n) - 1) * sizeof(int))
+#else
+#  define SIZEOF_VIDEO_MMAP_S(n) sizeof(struct video_mmap_s)
+#endif
+
 /* Debug option */
 
 #ifdef CONFIG_DEBUG_VIDEO_ERROR
@@ -128,6 +146,23 @@ struct video_wait_dma_s
 
 typedef struct video_wait_dma_s video_wait_dma_t;
 
+/* The buffers allocated by VIDIOC_REQBUFS(V4L2_MEMORY_MMAP).  They are
+ * freed when the stream and all importers of exported buffers have
+ * released them.
+ */
+
+struct video_mmap_s
+{
+  FAR uint8_t          *base;      /* nbufs buffers of bufsize bytes */
+  uint32_t             bufsize;
+  uint16_t             nbufs;
+  uint16_t             crefs;      /* The stream and each exported buffer */
+#ifdef CONFIG_VIDEO_DMABUF
+  int                  handle[1];  /* Exported handles or -1.
+                                    * Actually nbufs entries */
+#endif
+};
+
 struct video_type_inf_s
 {
   sem_t                lock_state;
@@ -135,6 +170,8 @@ struct video_type_inf_s
   int32_t              remaining_capnum;
   video_wait_dma_t     wait_dma;
   video_framebuff_t    bufinf;
+  uint32_t             sizeimage;  /* Image size of the current format */
+  FAR struct video_mmap_s *mmap;   /* Buffers of V4L2_MEMORY_MMAP */
 };
 
 typedef struct video_type_inf_s video_type_inf_t;
@@ -177,6 +214,12 @@ static void change_video_state(FAR video_mng_t    *vmng,
                                enum video_state_e next_state);
 static bool is_taking_still_picture(FAR video_mng_t *vmng);
 static bool is_bufsize_sufficient(FAR video_mng_t *vmng, uint32_t bufsize);
+static uint32_t get_sizeimage(FAR struct v4l2_pix_format *pix);
+static int video_mmap_alloc(FAR video_type_inf_t *type_inf, uint32_t count);
+static void video_mmap_put(FAR void *arg);
+static void video_mmap_free(FAR video_type_inf_t *type_inf);
+static int video_resolve_buf(FAR video_type_inf_t *type_inf,
+                             FAR vbuf_container_t *container);
 static void cleanup_resources(FAR video_mng_t *vmng);
 static bool is_sem_waited(FAR sem_t *sem);
 
@@ -190,6 +233,12 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
                        FAR struct v4l2_buffer *buf);
 static int video_cancel_dqbuf(FAR struct video_mng_s *vmng,
                               enum v4l2_buf_type type);
+static int video_querybuf(FAR struct video_mng_s *vmng,
+                          FAR struct v4l2_buffer *buf);
+#ifdef CONFIG_VIDEO_DMABUF
+static int video_expbuf(FAR struct video_mng_s *vmng,
+                        FAR struct v4l2_exportbuffer *expbuf);
+#endif
 static int video_enum_fmt(FAR struct v4l2_fmtdesc *fmt);
 static int video_enum_framesizes(FAR struct v4l2_frmsizeenum *frmsize);
 static int video_s_fmt(FAR struct video_mng_s *priv,
@@ -295,6 +344,7 @@ static FAR video_type_inf_t *get_video_type_inf
   switch (type)
     {
       case V4L2_BUF_TYPE_VIDEO_CAPTURE:
+      case V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE:
         type_inf = &vmng->video_inf;
         break;
 
@@ -382,8 +432,8 @@ static void change_video_state(FAR video_mng_t    *vmng,
       if (dma_container)
         {
           g_video_devops->set_buftype(V4L2_BUF_TYPE_VIDEO_CAPTURE);
-          g_video_devops->set_buf(dma_container->buf.m.userptr,
-                                  dma_container->buf.length);
+          g_video_devops->set_buf(dma_container->dmaaddr,
+                                  dma_container->dmasize);
         }
       else
         {
@@ -417,6 +467,236 @@ static bool is_bufsize_sufficient(FAR video_mng_t *vmng, uint32_t bufsize)
   return true;
 }
 
+static uint32_t get_sizeimage(FAR struct v4l2_pix_format *pix)
+{
+  if (pix->sizeimage != 0)
+    {
+      return pix->sizeimage;
+    }
+
+  if (pix->bytesperline != 0)
+    {
+      return pix->bytesperline * pix->height;
+    }
+
+  switch (pix->pixelformat)
+    {
+      case V4L2_PIX_FMT_UYVY:
+      case V4L2_PIX_FMT_RGB565:
+        return pix->width * pix->height * 2;
+
+      default:
+
+        /* The size of compressed images must be given by sizeimage */
+
+        return 0;
+    }
+}
+
+static int video_mmap_alloc(FAR video_type_inf_t *type_inf, uint32_t count)
+{
+  FAR struct video_mmap_s *mmap;
+  uint32_t bufsize;
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+#endif
+
+  bufsize = VIDEO_ALIGN_UP(type_inf->sizeimage);
+  if (bufsize == 0)
+    {
+      return -EINVAL;
+    }
+
+  mmap = (FAR struct video_mmap_s *)kmm_zalloc(SIZEOF_VIDEO_MMAP_S(count));
+  if (mmap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The buffers are accessed by the application, so they are allocated
+   * from the user heap.
+   */
+
+  mmap->base = (FAR uint8_t *)kumm_memalign(VIDEO_MMAP_ALIGN,
+                                            bufsize * count);
+  if (mmap->base == NULL)
+    {
+      kmm_free(mmap);
+      return -ENOMEM;
+    }
+
+  mmap->bufsize = bufsize;
+  mmap->nbufs   = count;
+  mmap->crefs   = 1;
+
+#ifdef CONFIG_VIDEO_DMABUF
+  for (i = 0; i < count; i++)
+    {
+      mmap->handle[i] = -1;
+    }
+#endif
+
+  type_inf->mmap = mmap;
+  return OK;
+}
+
+static void video_mmap_put(FAR void *arg)
+{
+  FAR struct video_mmap_s *mmap = (FAR struct video_mmap_s *)arg;
+  irqstate_t flags;
+  uint16_t crefs;
+
+  /* Called by the stream and, through dmabuf_release(), by importers */
+
+  flags = enter_critical_section();
+  crefs = --mmap->crefs;
+  leave_critical_section(flags);
+
+  if (crefs == 0)
+    {
+      kumm_free(mmap->base);
+      kmm_free(mmap);
+    }
+}
+
+static void video_mmap_free(FAR video_type_inf_t *type_inf)
+{
+  FAR struct video_mmap_s *mmap = type_inf->mmap;
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+#endif
+
+  if (mmap == NULL)
+    {
+      return;
+    }
+
+  type_inf->mmap = NULL;
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Drop the references of the exported handles.  Importers may still hold
+   * the memory.
+   */
+
+  for (i = 0; i < mmap->nbufs; i++)
+    {
+      if (mmap->handle[i] >= 0)
+        {
+          dmabuf_release(mmap->handle[i]);
+        }
+    }
+#endif
+
+  video_mmap_put(mmap);
+}
+
+static int video_resolve_buf(FAR video_type_inf_t *type_inf,
+                             FAR vbuf_container_t *container)
+{
+  FAR struct v4l2_buffer *buf = &container->buf;
+  FAR struct v4l2_plane  *plane = NULL;
+#ifdef CONFIG_VIDEO_DMABUF
+  struct dmabuf_info_s   info;
+  int                    ret;
+#endif
+  uint32_t               offset;
+  uint32_t               i;
+
+  if (buf->type == V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+    {
+      /* 'length' is the number of planes.  Keep a copy of the planes:  The
+       * caller of DQBUF provides its own array.
+       */
+
+      if (buf->m.planes == NULL || buf->length == 0 ||
+          buf->length > VIDEO_MAX_PLANES ||
+          (buf->memory != V4L2_MEMORY_USERPTR && buf->length != 1))
+        {
+          return -EINVAL;
+        }
+
+      memcpy(container->planes, buf->m.planes,
+             buf->length * sizeof(struct v4l2_plane));
+      plane = container->planes;
+    }
+
+  switch (buf->memory)
+    {
+      case V4L2_MEMORY_MMAP:
+        if (type_inf->mmap == NULL || buf->index >= type_inf->mmap->nbufs)
+          {
+            return -EINVAL;
+          }
+
+        offset             = buf->index * type_inf->mmap->bufsize;
+        container->dmaaddr = (uint32_t)(uintptr_t)
+                             (type_inf->mmap->base + offset);
+        container->dmasize = type_inf->mmap->bufsize;
+
+        if (plane != NULL)
+          {
+            plane->m.mem_offset = offset;
+            plane->length       = container->dmasize;
+          }
+        else
+          {
+            buf->m.offset = offset;
+            buf->length   = container->dmasize;
+          }
+        break;
+
+#ifdef CONFIG_VIDEO_DMABUF
+      case V4L2_MEMORY_DMABUF:
+
+        /* The exporter keeps the memory while the application holds the
+         * handle, so no reference is kept while the buffer is queued.
+         */
+
+        ret = dmabuf_import(plane != NULL ? plane->m.fd : buf->m.fd, &info);
+        if (ret < 0)
+          {
+            return ret;
+          }
+
+        dmabuf_release(plane != NULL ? plane->m.fd : buf->m.fd);
+
+        container->dmaaddr = (uint32_t)(uintptr_t)info.addr;
+        container->dmasize = info.size;
+        break;
+#endif
+
+      case V4L2_MEMORY_USERPTR:
+      default:
+        if (plane == NULL)
+          {
+            container->dmaaddr = buf->m.userptr;
+            container->dmasize = buf->length;
+            break;
+          }
+
+        /* The lower half captures into one buffer, so the planes
+         * must follow each other in memory.
+         */
+
+        container->dmaaddr = plane[0].m.userptr;
+        container->dmasize = plane[0].length;
+
+        for (i = 1; i < buf->length; i++)
+          {
+            if (plane[i].m.userptr !=
+                container->dmaaddr + container->dmasize)
+              {
+                return -EINVAL;
+              }
+
+            container->dmasize += plane[i].length;
+          }
+        break;
+    }
+
+  return OK;
+}
+
 static void initialize_streamresources(FAR video_type_inf_t *type_inf)
 {
   memset(type_inf, 0, sizeof(video_type_inf_t));
@@ -439,6 +719,7 @@ static void initialize_resources(FAR video_mng_t *vmng)
 static void cleanup_streamresources(FAR video_type_inf_t *type_inf)
 {
   video_framebuff_uninit(&type_inf->bufinf);
+  video_mmap_free(type_inf);
   sem_destroy(&type_inf->wait_dma.dqbuf_wait_flg);
   sem_destroy(&type_inf->lock_state);
   memset(type_inf, 0, sizeof(video_type_inf_t));
@@ -552,12 +833,37 @@ static int video_reqbufs(FAR struct video_mng_s         *vmng,
       return -EINVAL;
     }
 
-  flags = enter_critical_section();
+  if (reqbufs->count > V4L2_REQBUFS_COUNT_MAX)
+    {
+      reqbufs->count = V4L2_REQBUFS_COUNT_MAX;
+    }
 
   if (type_inf->state == VIDEO_STATE_DMA)
     {
       /* In DMA, REQBUFS is not permitted */
 
+      return -EPERM;
+    }
+
+  /* Buffers allocated by a previous REQBUFS(V4L2_MEMORY_MMAP) are freed
+   * before new ones are allocated.
+   */
+
+  video_mmap_free(type_inf);
+
+  if (reqbufs->memory == V4L2_MEMORY_MMAP && reqbufs->count > 0)
+    {
+      ret = video_mmap_alloc(type_inf, reqbufs->count);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  flags = enter_critical_section();
+
+  if (type_inf->state == VIDEO_STATE_DMA)
+    {
       ret = -EPERM;
     }
   else
@@ -580,6 +886,7 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
   FAR vbuf_container_t *container;
   enum video_state_e   next_video_state;
   irqstate_t           flags;
+  int                  ret;
 
   if ((vmng == NULL) || (buf == NULL))
     {
@@ -592,11 +899,6 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (!is_bufsize_sufficient(vmng, buf->length))
-    {
-      return -EINVAL;
-    }
-
   container = video_framebuff_get_container(&type_inf->bufinf);
   if (container == NULL)
     {
@@ -604,6 +906,19 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
     }
 
   memcpy(&container->buf, buf, sizeof(struct v4l2_buffer));
+
+  ret = video_resolve_buf(type_inf, container);
+  if (ret == OK && !is_bufsize_sufficient(vmng, container->dmasize))
+    {
+      ret = -EINVAL;
+    }
+
+  if (ret < 0)
+    {
+      video_framebuff_free_container(&type_inf->bufinf, container);
+      return ret;
+    }
+
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
   video_lock(&type_inf->lock_state);
@@ -612,7 +927,7 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
     {
       leave_critical_section(flags);
 
-      if (buf->type == V4L2_BUF_TYPE_VIDEO_CAPTURE)
+      if (type_inf == &vmng->video_inf)
         {
           video_lock(&vmng->still_inf.lock_state);
           next_video_state = estimate_next_video_state
@@ -626,8 +941,8 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
           if (container)
             {
               g_video_devops->set_buftype(buf->type);
-              g_video_devops->set_buf(container->buf.m.userptr,
-                                      container->buf.length);
+              g_video_devops->set_buf(container->dmaaddr,
+                                      container->dmasize);
               type_inf->state = VIDEO_STATE_DMA;
             }
         }
@@ -650,6 +965,10 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
   FAR vbuf_container_t *container;
   sem_t                *dqbuf_wait_flg;
   enum video_state_e   next_video_state;
+  FAR struct v4l2_plane *planes = NULL;
+  uint32_t             nplanes = 0;
+  uint32_t             remaining;
+  uint32_t             i;
 
   if ((vmng == NULL) || (buf == NULL))
     {
@@ -662,6 +981,18 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
+  if (buf->type == V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+    {
+      /* The planes are returned in the array of the caller */
+
+      planes  = buf->m.planes;
+      nplanes = buf->length;
+      if (planes == NULL || nplanes == 0)
+        {
+          return -EINVAL;
+        }
+    }
+
   container = video_framebuff_dq_valid_container(&type_inf->bufinf);
   if (container == NULL)
     {
@@ -673,7 +1004,7 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
 
       do
         {
-          if (buf->type == V4L2_BUF_TYPE_VIDEO_CAPTURE)
+          if (type_inf == &vmng->video_inf)
             {
               /* If start DMA condition is satisfied, start DMA */
 
@@ -709,11 +1040,135 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
 
+  if (planes != NULL)
+    {
+      /* Split the captured data over the planes */
+
+      if (nplanes > container->buf.length)
+        {
+          nplanes = container->buf.length;
+        }
+
+      remaining = container->buf.bytesused;
+      for (i = 0; i < nplanes; i++)
+        {
+          planes[i] = container->planes[i];
+          planes[i].bytesused = remaining < planes[i].length ?
+                                remaining : planes[i].length;
+          remaining -= planes[i].bytesused;
+        }
+
+      buf->m.planes = planes;
+      buf->length   = nplanes;
+    }
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
 }
 
+static int video_querybuf(FAR struct video_mng_s *vmng,
+                          FAR struct v4l2_buffer *buf)
+{
+  FAR video_type_inf_t *type_inf;
+  FAR struct video_mmap_s *mmap;
+  uint32_t offset;
+
+  if ((vmng == NULL) || (buf == NULL))
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_video_type_inf(vmng, buf->type);
+  if (type_inf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  mmap = type_inf->mmap;
+  if (mmap == NULL || buf->index >= mmap->nbufs)
+    {
+      return -EINVAL;
+    }
+
+  offset         = buf->index * mmap->bufsize;
+  buf->bytesused = 0;
+  buf->flags     = 0;
+  buf->memory    = V4L2_MEMORY_MMAP;
+
+  if (buf->type == V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+    {
+      if (buf->m.planes == NULL || buf->length == 0)
+        {
+          return -EINVAL;
+        }
+
+      memset(buf->m.planes, 0, sizeof(struct v4l2_plane));
+      buf->m.planes[0].m.mem_offset = offset;
+      buf->m.planes[0].length       = mmap->bufsize;
+      buf->length                   = 1;
+    }
+  else
+    {
+      buf->m.offset = offset;
+      buf->length   = mmap->bufsize;
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_VIDEO_DMABUF
+static int video_expbuf(FAR struct video_mng_s *vmng,
+                        FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR video_type_inf_t *type_inf;
+  FAR struct video_mmap_s *mmap;
+  irqstate_t flags;
+  int ret;
+
+  if ((vmng == NULL) || (expbuf == NULL))
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_video_type_inf(vmng, expbuf->type);
+  if (type_inf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  mmap = type_inf->mmap;
+  if (mmap == NULL || expbuf->index >= mmap->nbufs || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* A buffer is exported once.  The handle is valid until the buffers are
+   * freed by REQBUFS or close and all importers have released it.
+   */
+
+  if (mmap->handle[expbuf->index] < 0)
+    {
+      flags = enter_critical_section();
+      mmap->crefs++;
+      leave_critical_section(flags);
+
+      ret = dmabuf_export(mmap->base + expbuf->index * mmap->bufsize,
+                          mmap->bufsize, video_mmap_put, mmap);
+      if (ret < 0)
+        {
+          video_mmap_put(mmap);
+          return ret;
+        }
+
+      mmap->handle[expbuf->index] = ret;
+    }
+
+  expbuf->fd = mmap->handle[expbuf->index];
+  return OK;
+}
+#endif
+
 static int video_cancel_dqbuf(FAR struct video_mng_s *vmng,
                               enum v4l2_buf_type type)
 {
@@ -780,7 +1235,18 @@ static int video_try_fmt(FAR struct v4l2_format *fmt)
       return -EINVAL;
     }
 
-  ret = g_video_devops->try_format(fmt);
+  if (fmt->type == V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+    {
+      /* The lower half knows only the single-planar video stream */
+
+      fmt->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      ret = g_video_devops->try_format(fmt);
+      fmt->type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+    }
+  else
+    {
+      ret = g_video_devops->try_format(fmt);
+    }
 
   return ret;
 }
@@ -788,6 +1254,7 @@ static int video_try_fmt(FAR struct v4l2_format *fmt)
 static int video_s_fmt(FAR struct video_mng_s *priv,
                        FAR struct v4l2_format *fmt)
 {
+  FAR video_type_inf_t *type_inf;
   int ret;
 
   if ((g_video_devops == NULL) || (g_video_devops->set_format == NULL))
@@ -795,7 +1262,24 @@ static int video_s_fmt(FAR struct video_mng_s *priv,
       return -EINVAL;
     }
 
-  ret = g_video_devops->set_format(fmt);
+  if (fmt->type == V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+    {
+      fmt->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      ret = g_video_devops->set_format(fmt);
+      fmt->type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+    }
+  else
+    {
+      ret = g_video_devops->set_format(fmt);
+    }
+
+  /* Remember the image size for VIDIOC_REQBUFS(V4L2_MEMORY_MMAP) */
+
+  type_inf = get_video_type_inf(priv, fmt->type);
+  if (ret == OK && type_inf != NULL)
+    {
+      type_inf->sizeimage = get_sizeimage(&fmt->fmt.pix);
+    }
 
   return ret;
 }
@@ -849,7 +1333,7 @@ static int video_streamon(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (*type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+  if (type_inf != &vmng->video_inf)
     {
       /* No procedure for VIDIOC_STREAMON(STILL_CAPTURE) */
 
@@ -893,7 +1377,7 @@ static int video_streamoff(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (*type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+  if (type_inf != &vmng->video_inf)
     {
       /* No procedure for VIDIOC_STREAMOFF(STILL_CAPTURE) */
 
@@ -975,8 +1459,8 @@ static int video_takepict_start(FAR struct video_mng_s *vmng,
          /* Start video stream DMA */
 
          g_video_devops->set_buftype(V4L2_BUF_TYPE_STILL_CAPTURE);
-         g_video_devops->set_buf(dma_container->buf.m.userptr,
-                              dma_container->buf.length);
+         g_video_devops->set_buf(dma_container->dmaaddr,
+                              dma_container->dmasize);
          vmng->still_inf.state = VIDEO_STATE_DMA;
         }
     else
@@ -1268,6 +1752,43 @@ static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         break;
 
+      case VIDIOC_QUERYBUF:
+        ret = video_querybuf(priv, (FAR struct v4l2_buffer *)arg);
+
+        break;
+
+#ifdef CONFIG_VIDEO_DMABUF
+      case VIDIOC_EXPBUF:
+        ret = video_expbuf(priv, (FAR struct v4l2_exportbuffer *)arg);
+
+        break;
+#endif
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          /* The offsets returned by VIDIOC_QUERYBUF are relative to the
+           * buffers of the video stream or, if there are none, to the
+           * buffers of the still stream.
+           */
+
+          DEBUGASSERT(ppv != NULL);
+          if (priv->video_inf.mmap != NULL)
+            {
+              *ppv = priv->video_inf.mmap->base;
+            }
+          else if (priv->still_inf.mmap != NULL)
+            {
+              *ppv = priv->still_inf.mmap->base;
+            }
+          else
+            {
+              ret = -ENODEV;
+            }
+        }
+        break;
+
       case VIDIOC_CANCEL_DQBUF:
         ret = video_cancel_dqbuf(priv, (FAR enum v4l2_buf_type)arg);
 
@@ -1598,8 +2119,8 @@ int video_common_notify_dma_done(uint8_t  err_code,
         }
       else
         {
-          g_video_devops->set_buf(container->buf.m.userptr,
-                                  container->buf.length);
+          g_video_devops->set_buf(container->dmaaddr,
+                                  container->dmasize);
         }
     }
 
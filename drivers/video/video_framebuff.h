@@ -43,6 +43,9 @@ struct vbuf_container_s
 {
   struct v4l2_buffer       buf;    /* Buffer information */
   struct vbuf_container_s *next;  /* pointer to next buffer */
+  uint32_t                 dmaaddr; /* Address of the buffer memory */
+  uint32_t                 dmasize; /* Size of the buffer memory */
+  struct v4l2_plane        planes[VIDEO_MAX_PLANES]; /* multi-planar */
 };
 
 typedef struct vbuf_container_s vbuf_container_t;
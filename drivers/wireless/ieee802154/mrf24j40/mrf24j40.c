@@ -475,6 +475,7 @@ FAR struct ieee802154_radio_s *
   dev->radio.beaconupdate = mrf24j40_beaconupdate;
   dev->radio.beaconstop   = mrf24j40_beaconstop;
   dev->radio.sfupdate     = mrf24j40_sfupdate;
+  dev->radio.getcaps      = mrf24j40_getcaps;
 
   dev->lower    = lower;
   dev->spi      = spi;
@@ -770,3 +770,12 @@ int mrf24j40_sfupdate(FAR struct ieee802154_radio_s *radio,
 
   return OK;
 }
+
+uint8_t mrf24j40_getcaps(FAR struct ieee802154_radio_s *radio)
+{
+  /* The MRF24J40 does unslotted and slotted CSMA-CA, acknowledges received
+   * frames, and retransmits unacknowledged frames in hardware.
+   */
+
+  return IEEE802154_RADIOCAP_ALL;
+}
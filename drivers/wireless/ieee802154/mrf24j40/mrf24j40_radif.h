@@ -71,4 +71,6 @@ int mrf24j40_beaconstop(FAR struct ieee802154_radio_s *radio);
 int mrf24j40_sfupdate(FAR struct ieee802154_radio_s *radio,
                       FAR const struct ieee802154_superframespec_s *sfspec);
 
+uint8_t mrf24j40_getcaps(FAR struct ieee802154_radio_s *radio);
+
 #endif /* __DRIVERS_WIRELESS_IEEE802154_MRF24J40_RADIF_H */
\ No newline at end of file
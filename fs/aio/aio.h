@@ -63,6 +63,29 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* Number of I/O worker threads.  Zero selects the low priority work
+ * queue.
+ */
+
+#ifndef CONFIG_FS_AIO_NWORKERS
+#  define CONFIG_FS_AIO_NWORKERS 0
+#endif
+
+#if CONFIG_FS_AIO_NWORKERS > 0
+#  ifndef CONFIG_FS_AIO_PRIORITY
+#    define CONFIG_FS_AIO_PRIORITY 100
+#  endif
+#  ifndef CONFIG_FS_AIO_STACKSIZE
+#    define CONFIG_FS_AIO_STACKSIZE 2048
+#  endif
+
+/* The I/O workers restore their own priority */
+
+#  define aio_restorepriority(p) ((void)(p))
+#else
+#  define aio_restorepriority(p) lpwork_restorepriority(p)
+#endif
+
 #undef AIO_HAVE_PSOCK
 
 #ifdef CONFIG_NET_TCP
@@ -91,7 +114,14 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
+#if CONFIG_FS_AIO_NWORKERS > 0
+  dq_entry_t aioc_qlink;           /* Supports the queue of the I/O workers */
+  worker_t aioc_worker;            /* Performs the I/O on the I/O worker */
+  FAR void *aioc_key;              /* The device (inode or socket) */
+  bool aioc_queued;                /* True: Not yet taken by an I/O worker */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
@@ -248,6 +278,67 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been started from the queue.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -ENOENT if the I/O has already been
+ *   started.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
+#if CONFIG_FS_AIO_NWORKERS > 0
+/****************************************************************************
+ * Name: aio_worker_queue
+ *
+ * Description:
+ *   Queue asynchronous I/O to the I/O worker threads.  The threads are
+ *   created on first use.  I/O on the same device is performed in order,
+ *   one at a time, while I/O on different devices is performed in
+ *   parallel.
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   worker - The function that performs the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_worker_queue(FAR struct aio_container_s *aioc, worker_t worker);
+
+/****************************************************************************
+ * Name: aio_worker_cancel
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been taken by an I/O worker.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -ENOENT otherwise.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_worker_cancel(FAR struct aio_container_s *aioc);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -58,7 +58,8 @@
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or on the
+ *   I/O worker threads
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -74,6 +75,22 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
   int ret;
 
+#if CONFIG_FS_AIO_NWORKERS > 0
+  /* The I/O workers inherit the priority of each request themselves */
+
+  ret = aio_worker_queue(aioc, worker);
+  if (ret < 0)
+    {
+      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+      DEBUGASSERT(aiocbp);
+
+      aiocbp->aio_result = ret;
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+#else
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Prohibit context switches until we complete the queuing */
 
@@ -108,6 +125,46 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   sched_unlock();
 #endif
   return ret;
+#endif
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been started from the queue.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -ENOENT if the I/O has already been
+ *   started.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+#if CONFIG_FS_AIO_NWORKERS > 0
+  return aio_worker_cancel(aioc);
+#else
+  int ret;
+
+  ret = work_cancel(LPWORK, &aioc->aioc_work);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (ret >= 0)
+    {
+      /* The worker will not restore the priority of the work queue */
+
+      lpwork_restorepriority(aioc->aioc_prio);
+    }
+#endif
+
+  return ret;
+#endif
 }
 
 #endif /* CONFIG_FS_AIO */
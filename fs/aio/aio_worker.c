@@ -0,0 +1,355 @@
+/****************************************************************************
+ * fs/aio/aio_worker.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && CONFIG_FS_AIO_NWORKERS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AIOC_FROM_QLINK(e) \
+  ((FAR struct aio_container_s *) \
+   ((uintptr_t)(e) - offsetof(struct aio_container_s, aioc_qlink)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct aio_workers_s
+{
+  dq_queue_t queue;                       /* I/O not yet taken, in order */
+  sem_t wake;                             /* Wakes up idle I/O workers */
+  uint8_t nidle;                          /* Number of idle I/O workers */
+  bool started;                           /* True: Workers were created */
+  FAR void *busy[CONFIG_FS_AIO_NWORKERS]; /* Device of each I/O worker */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct aio_workers_s g_aio_workers =
+{
+  { NULL, NULL },
+  SEM_INITIALIZER(0)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_worker_busy
+ *
+ * Description:
+ *   Return true if an I/O worker is performing I/O on the device.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static bool aio_worker_busy(FAR void *key)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++)
+    {
+      if (g_aio_workers.busy[i] == key)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_worker_take
+ *
+ * Description:
+ *   Take the oldest queued I/O on a device that is not busy.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_container_s *aio_worker_take(int ndx)
+{
+  FAR struct aio_container_s *aioc;
+  FAR dq_entry_t *entry;
+
+  for (entry = dq_peek(&g_aio_workers.queue);
+       entry != NULL;
+       entry = dq_next(entry))
+    {
+      aioc = AIOC_FROM_QLINK(entry);
+      if (!aio_worker_busy(aioc->aioc_key))
+        {
+          dq_rem(entry, &g_aio_workers.queue);
+          aioc->aioc_queued       = false;
+          g_aio_workers.busy[ndx] = aioc->aioc_key;
+          return aioc;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: aio_worker_main
+ *
+ * Description:
+ *   The body of an I/O worker thread.
+ *
+ ****************************************************************************/
+
+static int aio_worker_main(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *aioc;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  struct sched_param param;
+  pid_t me = getpid();
+#endif
+  worker_t worker;
+  int ndx;
+
+  DEBUGASSERT(argc == 2);
+  ndx = atoi(argv[1]);
+
+  aio_lock();
+  for (; ; )
+    {
+      aioc = aio_worker_take(ndx);
+      if (aioc == NULL)
+        {
+          /* Nothing to do that is not blocked by another worker.  A worker
+           * that completes I/O looks for more before it becomes idle.
+           */
+
+          g_aio_workers.nidle++;
+          aio_unlock();
+          nxsem_wait_uninterruptible(&g_aio_workers.wake);
+          aio_lock();
+          continue;
+        }
+
+      worker = aioc->aioc_worker;
+      aio_unlock();
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* Perform the I/O at no less than the priority of the requester */
+
+      if (aioc->aioc_prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          param.sched_priority = aioc->aioc_prio;
+          (void)nxsched_setparam(me, &param);
+        }
+#endif
+
+      /* The worker releases the container */
+
+      worker(aioc);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      param.sched_priority = CONFIG_FS_AIO_PRIORITY;
+      (void)nxsched_setparam(me, &param);
+#endif
+
+      aio_lock();
+      g_aio_workers.busy[ndx] = NULL;
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Name: aio_worker_start
+ *
+ * Description:
+ *   Create the I/O worker threads.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static int aio_worker_start(void)
+{
+  FAR char *argv[2];
+  char arg1[8];
+  int ret;
+  int i;
+
+  /* The semaphore is used for signaling and must not have priority
+   * inheritance enabled.
+   */
+
+  (void)nxsem_setprotocol(&g_aio_workers.wake, SEM_PRIO_NONE);
+
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++)
+    {
+      snprintf(arg1, sizeof(arg1), "%d", i);
+      ret = kthread_create("aio", CONFIG_FS_AIO_PRIORITY,
+                           CONFIG_FS_AIO_STACKSIZE,
+                           (main_t)aio_worker_main, argv);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to create I/O worker %d: %d\n", i, ret);
+
+          /* Keep the workers that could be created */
+
+          if (i == 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+    }
+
+  g_aio_workers.started = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_worker_queue
+ *
+ * Description:
+ *   Queue asynchronous I/O to the I/O worker threads.  The threads are
+ *   created on first use.  I/O on the same device is performed in order,
+ *   one at a time, while I/O on different devices is performed in
+ *   parallel.
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   worker - The function that performs the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_worker_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  int ret = OK;
+
+  aio_lock();
+  if (!g_aio_workers.started)
+    {
+      ret = aio_worker_start();
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  aioc->aioc_worker = worker;
+  aioc->aioc_queued = true;
+  dq_addlast(&aioc->aioc_qlink, &g_aio_workers.queue);
+
+  if (g_aio_workers.nidle > 0)
+    {
+      g_aio_workers.nidle--;
+      nxsem_post(&g_aio_workers.wake);
+    }
+
+errout:
+  aio_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aio_worker_cancel
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been taken by an I/O worker.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -ENOENT otherwise.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_worker_cancel(FAR struct aio_container_s *aioc)
+{
+  if (!aioc->aioc_queued)
+    {
+      return -ENOENT;
+    }
+
+  dq_rem(&aioc->aioc_qlink, &g_aio_workers.queue);
+  aioc->aioc_queued = false;
+  return OK;
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_AIO_NWORKERS > 0 */
@@ -85,6 +85,9 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   struct sched_param param;
+#endif
+#if CONFIG_FS_AIO_NWORKERS > 0
+  FAR void *key;
 #endif
   int ret;
 
@@ -101,6 +104,9 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
         }
 
       DEBUGASSERT(u.filep != NULL);
+#if CONFIG_FS_AIO_NWORKERS > 0
+      key = u.filep->f_inode;
+#endif
     }
 #ifdef AIO_HAVE_PSOCK
   else
@@ -117,6 +123,10 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
           ret = -EBADF;
           goto errout;
         }
+
+#if CONFIG_FS_AIO_NWORKERS > 0
+      key = u.psock;
+#endif
     }
 #endif
 
@@ -133,6 +143,9 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   aioc->aioc_aiocbp = aiocbp;
   aioc->u.ptr = u.ptr;
   aioc->aioc_pid = getpid();
+#if CONFIG_FS_AIO_NWORKERS > 0
+  aioc->aioc_key = key;
+#endif
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   DEBUGVERIFY(nxsched_getparam (aioc->aioc_pid, &param));
@@ -1,7 +1,7 @@
 /****************************************************************************
  * fs/cromfs/cromfs.h
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -43,6 +43,18 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The header type of a data block compressed with LZ4 instead of LZF.  The
+ * header has the same layout as struct lzf_type1_header_s.  An image uses
+ * either LZF or LZ4 compressed blocks (and uncompressed LZF_TYPE0_HDR
+ * blocks), depending on how it was generated.
+ */
+
+#define CROMFS_LZ4_HDR 2
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -1,7 +1,7 @@
 /****************************************************************************
  * fs/cromfs/fs_cromfs.c
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -48,11 +48,14 @@
 #include <string.h>
 #include <fcntl.h>
 #include <lzf.h>
+#include <lz4.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -61,6 +64,18 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 0
+#endif
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
+#  undef CONFIG_FS_CROMFS_READAHEAD
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,11 +85,31 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+  FAR struct lzf_header_s *ff_hdr;          /* Header of the last block read */
+  uint32_t ff_blkoffs;                      /* File offset of that block */
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
 };
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+/* This structure describes one decompressed block in the shared cache.
+ * Blocks are identified by the address of their compressed data, so the
+ * cache can be shared by all mounted volumes.
+ */
+
+struct cromfs_cache_s
+{
+  FAR const uint8_t *cc_src;                /* Compressed data (NULL: unused) */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
+  uint32_t cc_bsize;                        /* Allocated size of cc_buffer */
+  uint32_t cc_age;                          /* Time of the last access */
+  uint16_t cc_ulen;                         /* Length of decompressed data */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -114,6 +149,19 @@ static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+static unsigned int cromfs_decompress(uint8_t type, FAR const uint8_t *src,
+                                      uint16_t clen, FAR uint8_t *dest,
+                                      unsigned int destlen);
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+static FAR struct cromfs_cache_s *
+                cromfs_cache_get(uint8_t type, FAR const uint8_t *src,
+                                 uint16_t clen, uint32_t bsize);
+#endif
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void     cromfs_readahead_worker(FAR void *arg);
+static void     cromfs_readahead(FAR const struct cromfs_volume_s *fs,
+                                 FAR struct lzf_header_s *hdr);
+#endif
 
 /* Common file system methods */
 
@@ -182,6 +230,30 @@ const struct mountpt_operations cromfs_operations =
   cromfs_stat        /* stat */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+/* The cache of decompressed blocks shared by all open files */
+
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static uint32_t g_cromfs_cacheage;
+static sem_t g_cromfs_cachesem = SEM_INITIALIZER(1);
+#endif
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+/* The block to be decompressed by the read-ahead worker.  Protected by
+ * g_cromfs_cachesem.
+ */
+
+static struct work_s g_cromfs_rawork;
+static FAR const uint8_t *g_cromfs_rasrc;
+static uint16_t g_cromfs_raclen;
+static uint8_t g_cromfs_ratype;
+static uint32_t g_cromfs_rabsize;
+#endif
+
 /* The CROMFS uses a global, in-memory instance of the file system image
  * rather than a ROMDISK as does, same the ROMFS file system.  This is
  * primarily because the compression logic needs contiguous, in-memory
@@ -477,6 +549,188 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_decompress
+ *
+ * Description:
+ *   Decompress the data of a compressed block with the codec selected by
+ *   the block header type, LZF (LZF_TYPE1_HDR) or LZ4 (CROMFS_LZ4_HDR).
+ *
+ * Returned Value:
+ *   The number of decompressed bytes or zero on failure.
+ *
+ ****************************************************************************/
+
+static unsigned int cromfs_decompress(uint8_t type, FAR const uint8_t *src,
+                                      uint16_t clen, FAR uint8_t *dest,
+                                      unsigned int destlen)
+{
+  if (type == LZF_TYPE1_HDR)
+    {
+      return lzf_decompress(src, clen, dest, destlen);
+    }
+#ifdef CONFIG_FS_CROMFS_LZ4
+  else if (type == CROMFS_LZ4_HDR)
+    {
+      return lz4_decompress(src, clen, dest, destlen);
+    }
+#endif
+
+  ferr("ERROR: Unsupported block type %u\n", type);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_get
+ *
+ * Description:
+ *   Return the cache entry holding the decompressed data of the compressed
+ *   block at 'src', decompressing it into the least recently used entry if
+ *   it is not in the cache yet.
+ *
+ * Returned Value:
+ *   The cache entry or NULL if the data could not be decompressed.
+ *
+ * Assumptions:
+ *   The caller holds g_cromfs_cachesem.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+static FAR struct cromfs_cache_s *
+  cromfs_cache_get(uint8_t type, FAR const uint8_t *src, uint16_t clen,
+                   uint32_t bsize)
+{
+  FAR struct cromfs_cache_s *victim = &g_cromfs_cache[0];
+  FAR struct cromfs_cache_s *cc;
+  unsigned int decomplen;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      cc = &g_cromfs_cache[i];
+      if (cc->cc_src == src)
+        {
+          cc->cc_age = ++g_cromfs_cacheage;
+          return cc;
+        }
+
+      /* Unused entries have age zero and are chosen first */
+
+      if (cc->cc_age < victim->cc_age)
+        {
+          victim = cc;
+        }
+    }
+
+  /* Not cached.  Replace the least recently used entry. */
+
+  cc         = victim;
+  cc->cc_src = NULL;
+  cc->cc_age = 0;
+
+  if (cc->cc_bsize < bsize)
+    {
+      kmm_free(cc->cc_buffer);
+      cc->cc_bsize  = 0;
+      cc->cc_buffer = (FAR uint8_t *)kmm_malloc(bsize);
+      if (cc->cc_buffer == NULL)
+        {
+          return NULL;
+        }
+
+      cc->cc_bsize = bsize;
+    }
+
+  decomplen = cromfs_decompress(type, src, clen, cc->cc_buffer,
+                                cc->cc_bsize);
+  if (decomplen == 0)
+    {
+      return NULL;
+    }
+
+  cc->cc_src  = src;
+  cc->cc_ulen = decomplen;
+  cc->cc_age  = ++g_cromfs_cacheage;
+  return cc;
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_readahead_worker
+ *
+ * Description:
+ *   Decompress the block selected by cromfs_readahead() into the cache.
+ *   Runs on the low priority work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void cromfs_readahead_worker(FAR void *arg)
+{
+  if (nxsem_wait_uninterruptible(&g_cromfs_cachesem) >= 0)
+    {
+      if (g_cromfs_rasrc != NULL)
+        {
+          cromfs_cache_get(g_cromfs_ratype, g_cromfs_rasrc,
+                           g_cromfs_raclen, g_cromfs_rabsize);
+          g_cromfs_rasrc = NULL;
+        }
+
+      nxsem_post(&g_cromfs_cachesem);
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_readahead
+ *
+ * Description:
+ *   Schedule the decompression of the compressed block with header 'hdr'
+ *   if it is not already cached.  Nothing is done if the worker is still
+ *   busy with an earlier block.
+ *
+ ****************************************************************************/
+
+static void cromfs_readahead(FAR const struct cromfs_volume_s *fs,
+                             FAR struct lzf_header_s *hdr)
+{
+  FAR struct lzf_type1_header_s *hdr1 = (FAR struct lzf_type1_header_s *)hdr;
+  FAR const uint8_t *src = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+  int i;
+
+  if (nxsem_wait_uninterruptible(&g_cromfs_cachesem) < 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      if (g_cromfs_cache[i].cc_src == src)
+        {
+          goto out;
+        }
+    }
+
+  if (g_cromfs_rasrc == NULL && work_available(&g_cromfs_rawork))
+    {
+      g_cromfs_rasrc   = src;
+      g_cromfs_raclen  = (uint16_t)hdr1->lzf_clen[0] << 8 |
+                         (uint16_t)hdr1->lzf_clen[1];
+      g_cromfs_ratype  = hdr->lzf_type;
+      g_cromfs_rabsize = fs->cv_bsize;
+
+      if (work_queue(LPWORK, &g_cromfs_rawork, cromfs_readahead_worker,
+                     NULL, 0) < 0)
+        {
+          g_cromfs_rasrc = NULL;
+        }
+    }
+
+out:
+  nxsem_post(&g_cromfs_cachesem);
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -545,6 +799,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -553,6 +808,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       kmm_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -578,11 +834,13 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   kmm_free(ff->ff_buffer);
+#endif
   kmm_free(ff);
 
   return OK;
@@ -624,7 +882,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -650,10 +908,23 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
   ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+
+  /* Resume the search at the block of the previous read unless the file
+   * position has moved back before it.
+   */
+
+  if (ff->ff_hdr != NULL && fpos >= ff->ff_blkoffs)
+    {
+      blkoffs = ff->ff_blkoffs;
+      nexthdr = ff->ff_hdr;
+    }
+  else
+    {
+      blkoffs = 0;
+      nexthdr = (FAR struct lzf_header_s *)
+                cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+    }
 
   /* Look until we find the compressed block containing the start of the
    * requested data.
@@ -725,85 +996,108 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
           finfo("blkoffs=%lu ulen=%u copysize=%u\n",
                 (unsigned long)blkoffs, ulen, copysize);
         }
-      else
+      else if (filep->f_pos <= blkoffs && ulen <= remaining)
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
+          unsigned int decomplen;
+
+          /* The source of the data is at the beginning of the compressed
+           * data buffer and the uncompressed data will not overrun the
+           * user buffer.  Decompress directly into the user buffer.
            */
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          copysize  = ulen;
+          src       = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          decomplen = cromfs_decompress(currhdr->lzf_type, src, clen, dest,
+                                        ulen);
+
+          finfo("blkoffs=%lu ulen=%u clen=%u decomplen=%u\n",
+                (unsigned long)blkoffs, ulen, clen, decomplen);
+
+          if (decomplen != ulen)
             {
-              uint32_t voloffs;
+              ferr("ERROR: Failed to decompress block at %lu\n",
+                   (unsigned long)blkoffs);
+              return -EIO;
+            }
+        }
+      else
+        {
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+          FAR struct cromfs_cache_s *cc;
+          int ret;
+#else
+          uint32_t voloffs;
+#endif
+
+          /* No, we will need to decompress into an intermediate
+           * decompression buffer.
+           */
 
-              copyoffs = 0;
-              copysize = ulen;
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
+          if (copysize > remaining)  /* Clip to the size really needed */
+            {
+              copysize = remaining;
+            }
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+          DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+          /* Use the decompressed block shared by all open files */
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
+          ret = nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+          if (ret < 0)
             {
-              uint32_t voloffs;
+              return ret;
+            }
 
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
+          cc = cromfs_cache_get(currhdr->lzf_type, src, clen, fs->cv_bsize);
+          if (cc == NULL || cc->cc_ulen < copyoffs + copysize)
+            {
+              nxsem_post(&g_cromfs_cachesem);
+              ferr("ERROR: Failed to decompress block at %lu\n",
+                   (unsigned long)blkoffs);
+              return -EIO;
+            }
 
-              copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
+          finfo("blkoffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+                (unsigned long)blkoffs, ulen, clen, copyoffs, copysize);
 
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
-                }
+          memcpy(dest, &cc->cc_buffer[copyoffs], copysize);
+          nxsem_post(&g_cromfs_cachesem);
+#else
+          voloffs = cromfs_addr2offset(fs, src);
+          if (voloffs != ff->ff_offset)
+            {
+              unsigned int decomplen;
 
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
+              decomplen = cromfs_decompress(currhdr->lzf_type, src, clen,
+                                            ff->ff_buffer, fs->cv_bsize);
 
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+              ff->ff_offset = voloffs;
+              ff->ff_ulen   = decomplen;
+            }
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+          finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
+                "copyoffs=%u copysize=%u\n",
+                (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
+                clen, ff->ff_offset, copyoffs, copysize);
+          DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+          /* Then copy to user buffer */
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+          memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+#endif
+        }
 
-              /* Then copy to user buffer */
+      /* Remember where this block is for the next read */
 
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
-            }
-        }
+      ff->ff_hdr     = currhdr;
+      ff->ff_blkoffs = blkoffs;
 
       /* Adjust pointers counts and offset */
 
@@ -812,6 +1106,16 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  /* Start decompressing the following block if it is compressed */
+
+  if (buflen > 0 && blkoffs + ulen < ff->ff_node->cn_size &&
+      nexthdr->lzf_type != LZF_TYPE0_HDR)
+    {
+      cromfs_readahead(fs, nexthdr);
+    }
+#endif
+
   /* Update the file pointer */
 
   filep->f_pos = fpos;
@@ -857,7 +1161,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -869,6 +1173,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -877,6 +1182,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       kmm_free(newff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
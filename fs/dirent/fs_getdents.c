@@ -0,0 +1,161 @@
+/****************************************************************************
+ * fs/dirent/fs_getdents.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/dirent.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getdents
+ *
+ * Description:
+ *   The getdents() function reads as many directory entries from the
+ *   directory stream as fit in the buffer.  The buffer is an array of
+ *   struct dirent.  This is equivalent to calling readdir() repeatedly and
+ *   copying each result, but mounted file systems that provide the
+ *   getdents() method return all entries with one call, taking their
+ *   locks and walking their directory structures only once.
+ *
+ *   Unlike the Linux system call of the same name, this operates on a
+ *   directory stream returned by opendir() and the entries have a fixed
+ *   size.
+ *
+ * Input Parameters:
+ *   dirp    - An instance of type DIR created by a previous call to
+ *             opendir()
+ *   entries - The buffer that receives the directory entries
+ *   nbytes  - The size of the buffer in bytes.  At least one struct dirent
+ *             must fit.
+ *
+ * Returned Value:
+ *   The number of bytes returned in the buffer, a multiple of the size of
+ *   struct dirent, is returned on success.  Zero is returned at the end of
+ *   the directory.  On error, -1 is returned and errno is set:
+ *
+ *   EBADF   - Invalid directory stream descriptor dir
+ *   EINVAL  - The buffer is too small
+ *
+ ****************************************************************************/
+
+ssize_t getdents(FAR DIR *dirp, FAR struct dirent *entries, size_t nbytes)
+{
+  FAR struct fs_dirent_s *idir = (FAR struct fs_dirent_s *)dirp;
+  FAR struct dirent *entry;
+  size_t nentries;
+  size_t nread;
+  int errcode;
+
+  /* Verify that we were provided with a valid directory structure */
+
+  if (idir == NULL)
+    {
+      errcode = EBADF;
+      goto errout;
+    }
+
+  nentries = nbytes / sizeof(struct dirent);
+  if (entries == NULL || nentries == 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  /* Use the batched method of the mounted file system, if it has one */
+
+  if (idir->fd_root != NULL && INODE_IS_MOUNTPT(idir->fd_root) &&
+      !DIRENT_ISPSEUDONODE(idir->fd_flags) &&
+      idir->fd_root->u.i_mops != NULL &&
+      idir->fd_root->u.i_mops->getdents != NULL)
+    {
+      int ret;
+
+      ret = idir->fd_root->u.i_mops->getdents(idir->fd_root, idir, entries,
+                                              nentries);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      DEBUGASSERT((size_t)ret <= nentries);
+      idir->fd_position += ret;
+      return ret * sizeof(struct dirent);
+    }
+#endif
+
+  /* Otherwise, read the entries one at a time.  readdir() returns NULL
+   * with errno cleared at the end of the directory.  An error is only
+   * reported if no entries were read.
+   */
+
+  for (nread = 0; nread < nentries; nread++)
+    {
+      entry = readdir(dirp);
+      if (entry == NULL)
+        {
+          errcode = get_errno();
+          if (errcode != OK && nread == 0)
+            {
+              goto errout;
+            }
+
+          break;
+        }
+
+      memcpy(&entries[nread], entry, sizeof(struct dirent));
+    }
+
+  return nread * sizeof(struct dirent);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
@@ -0,0 +1,1003 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "driver/driver.h"
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_BLOCKCACHE_SIZE
+#  define CONFIG_FS_BLOCKCACHE_SIZE 16384
+#endif
+
+#ifndef CONFIG_FS_BLOCKCACHE_PAGESECTORS
+#  define CONFIG_FS_BLOCKCACHE_PAGESECTORS 4
+#endif
+
+#ifndef CONFIG_FS_BLOCKCACHE_NHASH
+#  define CONFIG_FS_BLOCKCACHE_NHASH 32
+#endif
+
+#ifndef CONFIG_FS_BLOCKCACHE_FLUSHDELAY
+#  define CONFIG_FS_BLOCKCACHE_FLUSHDELAY 500
+#endif
+
+#if (CONFIG_FS_BLOCKCACHE_NHASH & (CONFIG_FS_BLOCKCACHE_NHASH - 1)) != 0
+#  error CONFIG_FS_BLOCKCACHE_NHASH must be a power of two
+#endif
+
+/* Write-back is performed on the low priority work queue, if available */
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define BCACHE_WORK LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define BCACHE_WORK HPWORK
+#else
+#  error Work queue support is required (CONFIG_SCHED_LPWORK)
+#endif
+
+#define BCACHE_NSECTORS   CONFIG_FS_BLOCKCACHE_PAGESECTORS
+#define BCACHE_HASH(d,p)  \
+  ((((uintptr_t)(d) >> 4) ^ ((p) * 2654435761u)) & \
+   (CONFIG_FS_BLOCKCACHE_NHASH - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached block device */
+
+struct bcache_dev_s
+{
+  FAR struct inode *parent;        /* The cached block driver */
+  size_t sectorsize;               /* Sector size (zero until known) */
+  size_t nsectors;                 /* Number of sectors on the device */
+};
+
+/* One page of the cache:  BCACHE_NSECTORS consecutive sectors of one
+ * device, starting at a multiple of BCACHE_NSECTORS.
+ */
+
+struct bcache_page_s
+{
+  dq_entry_t lru;                  /* Must be first: LRU list */
+  FAR struct bcache_page_s *hnext; /* Hash chain */
+  FAR struct bcache_dev_s *dev;    /* The device that the page belongs to */
+  size_t page;                     /* Page number (sector / BCACHE_NSECTORS) */
+  size_t size;                     /* Allocated size of the page */
+  bool dirty;                      /* True: Must be written back */
+  uint8_t data[1];                 /* Sector data (actual size varies) */
+};
+
+#define SIZEOF_BCACHE_PAGE_S(n) \
+  (sizeof(struct bcache_page_s) - 1 + (n))
+
+/* The cache that is shared by all cached devices */
+
+struct bcache_s
+{
+  sem_t lock;                      /* Protects all of the cache */
+  dq_queue_t lru;                  /* Pages, most recently used first */
+  size_t size;                     /* Memory used for pages */
+  bool flushpending;               /* True: Write-back work is queued */
+  struct work_s work;              /* Delayed write-back */
+  FAR struct bcache_page_s *hash[CONFIG_FS_BLOCKCACHE_NHASH];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     bcache_open(FAR struct inode *inode);
+static int     bcache_close(FAR struct inode *inode);
+static ssize_t bcache_read(FAR struct inode *inode, unsigned char *buffer,
+                           size_t start_sector, unsigned int nsectors);
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t bcache_write(FAR struct inode *inode,
+                            const unsigned char *buffer,
+                            size_t start_sector, unsigned int nsectors);
+#endif
+static int     bcache_geometry(FAR struct inode *inode,
+                               FAR struct geometry *geometry);
+static int     bcache_ioctl(FAR struct inode *inode, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     bcache_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bcache_bops =
+{
+  bcache_open,     /* open     */
+  bcache_close,    /* close    */
+  bcache_read,     /* read     */
+#ifdef CONFIG_FS_WRITABLE
+  bcache_write,    /* write    */
+#else
+  NULL,            /* write    */
+#endif
+  bcache_geometry, /* geometry */
+  bcache_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , bcache_unlink  /* unlink   */
+#endif
+};
+
+static struct bcache_s g_bcache =
+{
+  SEM_INITIALIZER(1)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_pagesectors
+ *
+ * Description:
+ *   Return the number of sectors in a page.  The last page of a device may
+ *   be short.
+ *
+ ****************************************************************************/
+
+static size_t bcache_pagesectors(FAR struct bcache_dev_s *dev, size_t page)
+{
+  size_t start = page * BCACHE_NSECTORS;
+
+  if (start + BCACHE_NSECTORS > dev->nsectors)
+    {
+      return dev->nsectors - start;
+    }
+
+  return BCACHE_NSECTORS;
+}
+
+/****************************************************************************
+ * Name: bcache_find
+ *
+ * Description:
+ *   Find a page in the cache or return NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_page_s *bcache_find(FAR struct bcache_dev_s *dev,
+                                             size_t page)
+{
+  FAR struct bcache_page_s *pg;
+
+  for (pg = g_bcache.hash[BCACHE_HASH(dev, page)]; pg != NULL;
+       pg = pg->hnext)
+    {
+      if (pg->dev == dev && pg->page == page)
+        {
+          return pg;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bcache_touch
+ *
+ * Description:
+ *   Make a page the most recently used one.
+ *
+ ****************************************************************************/
+
+static void bcache_touch(FAR struct bcache_page_s *pg)
+{
+  dq_rem(&pg->lru, &g_bcache.lru);
+  dq_addfirst(&pg->lru, &g_bcache.lru);
+}
+
+/****************************************************************************
+ * Name: bcache_writeback
+ *
+ * Description:
+ *   Write a dirty page back to the device.
+ *
+ ****************************************************************************/
+
+static int bcache_writeback(FAR struct bcache_page_s *pg)
+{
+  FAR struct bcache_dev_s *dev = pg->dev;
+  FAR struct inode *parent = dev->parent;
+  size_t nsectors;
+  ssize_t nwritten;
+
+  nsectors = bcache_pagesectors(dev, pg->page);
+  nwritten = parent->u.i_bops->write(parent, pg->data,
+                                     pg->page * BCACHE_NSECTORS, nsectors);
+  if (nwritten < 0)
+    {
+      ferr("ERROR: Write-back of sector %lu failed: %d\n",
+           (unsigned long)(pg->page * BCACHE_NSECTORS), (int)nwritten);
+      return (int)nwritten;
+    }
+
+  pg->dirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_remove
+ *
+ * Description:
+ *   Remove a page from the cache and free it.  A dirty page is discarded.
+ *
+ ****************************************************************************/
+
+static void bcache_remove(FAR struct bcache_page_s *pg)
+{
+  FAR struct bcache_page_s **pprev;
+
+  pprev = &g_bcache.hash[BCACHE_HASH(pg->dev, pg->page)];
+  while (*pprev != pg)
+    {
+      pprev = &(*pprev)->hnext;
+    }
+
+  *pprev = pg->hnext;
+  dq_rem(&pg->lru, &g_bcache.lru);
+
+  g_bcache.size -= pg->size;
+  kmm_free(pg);
+}
+
+/****************************************************************************
+ * Name: bcache_evict
+ *
+ * Description:
+ *   Remove the least recently used page from the cache, writing it back
+ *   first if it is dirty.
+ *
+ ****************************************************************************/
+
+static int bcache_evict(void)
+{
+  FAR struct bcache_page_s *pg;
+  int ret;
+
+  pg = (FAR struct bcache_page_s *)dq_tail(&g_bcache.lru);
+  if (pg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (pg->dirty)
+    {
+      ret = bcache_writeback(pg);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  bcache_remove(pg);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_alloc
+ *
+ * Description:
+ *   Add a new, empty page to the cache.  Pages are evicted as necessary to
+ *   stay within CONFIG_FS_BLOCKCACHE_SIZE, and also when the heap is
+ *   exhausted.
+ *
+ ****************************************************************************/
+
+static int bcache_alloc(FAR struct bcache_dev_s *dev, size_t page,
+                        FAR struct bcache_page_s **ppg)
+{
+  FAR struct bcache_page_s *pg;
+  size_t size;
+  int ndx;
+  int ret;
+
+  size = SIZEOF_BCACHE_PAGE_S(BCACHE_NSECTORS * dev->sectorsize);
+
+  while (g_bcache.size + size > CONFIG_FS_BLOCKCACHE_SIZE &&
+         dq_tail(&g_bcache.lru) != NULL)
+    {
+      ret = bcache_evict();
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  while ((pg = (FAR struct bcache_page_s *)kmm_malloc(size)) == NULL)
+    {
+      /* Give memory back to the heap */
+
+      ret = bcache_evict();
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  pg->dev   = dev;
+  pg->page  = page;
+  pg->size  = size;
+  pg->dirty = false;
+
+  ndx                 = BCACHE_HASH(dev, page);
+  pg->hnext           = g_bcache.hash[ndx];
+  g_bcache.hash[ndx]  = pg;
+  g_bcache.size      += size;
+  dq_addfirst(&pg->lru, &g_bcache.lru);
+
+  *ppg = pg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_fill
+ *
+ * Description:
+ *   Add a page to the cache and read it from the device.  All sectors of
+ *   the page are read at once:  This is the read-ahead of the cache.
+ *
+ ****************************************************************************/
+
+static int bcache_fill(FAR struct bcache_dev_s *dev, size_t page,
+                       FAR struct bcache_page_s **ppg)
+{
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_page_s *pg;
+  size_t nsectors;
+  ssize_t nread;
+  int ret;
+
+  ret = bcache_alloc(dev, page, &pg);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nsectors = bcache_pagesectors(dev, page);
+  nread    = parent->u.i_bops->read(parent, pg->data,
+                                    page * BCACHE_NSECTORS, nsectors);
+  if (nread != (ssize_t)nsectors)
+    {
+      bcache_remove(pg);
+      return nread < 0 ? (int)nread : -EIO;
+    }
+
+  *ppg = pg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_flushdev
+ *
+ * Description:
+ *   Write back all dirty pages of one device (or of all devices if dev is
+ *   NULL).  If discard is true, the pages of the device are also removed.
+ *
+ ****************************************************************************/
+
+static int bcache_flushdev(FAR struct bcache_dev_s *dev, bool discard)
+{
+  FAR struct bcache_page_s *pg;
+  FAR struct bcache_page_s *next;
+  int ret = OK;
+  int tmp;
+
+  for (pg = (FAR struct bcache_page_s *)dq_peek(&g_bcache.lru);
+       pg != NULL;
+       pg = next)
+    {
+      next = (FAR struct bcache_page_s *)dq_next(&pg->lru);
+      if (dev != NULL && pg->dev != dev)
+        {
+          continue;
+        }
+
+      if (pg->dirty)
+        {
+          tmp = bcache_writeback(pg);
+          if (tmp < 0)
+            {
+              ret = tmp;
+            }
+        }
+
+      if (discard)
+        {
+          bcache_remove(pg);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_worker
+ *
+ * Description:
+ *   Delayed write-back of all dirty pages.
+ *
+ ****************************************************************************/
+
+static void bcache_worker(FAR void *arg)
+{
+  if (nxsem_wait_uninterruptible(&g_bcache.lock) >= 0)
+    {
+      g_bcache.flushpending = false;
+      (void)bcache_flushdev(NULL, false);
+      nxsem_post(&g_bcache.lock);
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_setup
+ *
+ * Description:
+ *   Get the sector size and count of the device if they are not yet known.
+ *   If the media has changed, the cached pages of the device are dropped.
+ *
+ ****************************************************************************/
+
+static int bcache_setup(FAR struct bcache_dev_s *dev,
+                        FAR struct geometry *geo)
+{
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  ret = parent->u.i_bops->geometry(parent, geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (geo->geo_mediachanged || !geo->geo_available ||
+      geo->geo_sectorsize != dev->sectorsize ||
+      geo->geo_nsectors != dev->nsectors)
+    {
+      /* Whatever is cached is no longer valid */
+
+      (void)bcache_flushdev(dev, true);
+      dev->sectorsize = geo->geo_available ? geo->geo_sectorsize : 0;
+      dev->nsectors   = geo->geo_available ? geo->geo_nsectors : 0;
+    }
+
+  return dev->sectorsize > 0 ? OK : -ENODEV;
+}
+
+/****************************************************************************
+ * Name: bcache_prepare
+ *
+ * Description:
+ *   Take the cache lock and validate the sector range of a transfer.  The
+ *   number of sectors to transfer is returned.
+ *
+ ****************************************************************************/
+
+static int bcache_prepare(FAR struct bcache_dev_s *dev, size_t start_sector,
+                          FAR unsigned int *nsectors)
+{
+  struct geometry geo;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_bcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dev->sectorsize == 0)
+    {
+      ret = bcache_setup(dev, &geo);
+      if (ret < 0)
+        {
+          nxsem_post(&g_bcache.lock);
+          return ret;
+        }
+    }
+
+  if (start_sector >= dev->nsectors)
+    {
+      *nsectors = 0;
+    }
+  else if (start_sector + *nsectors > dev->nsectors)
+    {
+      *nsectors = dev->nsectors - start_sector;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int bcache_open(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->open)
+    {
+      ret = parent->u.i_bops->open(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_close
+ *
+ * Description: Write back the cached data and close the block device
+ *
+ ****************************************************************************/
+
+static int bcache_close(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_bcache.lock);
+  if (ret >= 0)
+    {
+      ret = bcache_flushdev(dev, false);
+      nxsem_post(&g_bcache.lock);
+    }
+
+  if (parent->u.i_bops->close)
+    {
+      int tmp = parent->u.i_bops->close(parent);
+      if (ret >= 0)
+        {
+          ret = tmp;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_read(FAR struct inode *inode, unsigned char *buffer,
+                           size_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_page_s *pg;
+  ssize_t nread = 0;
+  size_t page;
+  size_t offset;
+  size_t count;
+  int ret;
+
+  ret = bcache_prepare(dev, start_sector, &nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nsectors > 0)
+    {
+      page   = start_sector / BCACHE_NSECTORS;
+      offset = start_sector % BCACHE_NSECTORS;
+      count  = BCACHE_NSECTORS - offset;
+      if (count > nsectors)
+        {
+          count = nsectors;
+        }
+
+      pg = bcache_find(dev, page);
+      if (pg == NULL && count == BCACHE_NSECTORS)
+        {
+          ssize_t tmp;
+
+          /* Read whole pages that are not cached directly, as many at a
+           * time as possible.  This does not pollute the cache with large
+           * streaming reads.
+           */
+
+          while (count + BCACHE_NSECTORS <= nsectors &&
+                 bcache_find(dev, page + count / BCACHE_NSECTORS) == NULL)
+            {
+              count += BCACHE_NSECTORS;
+            }
+
+          tmp = parent->u.i_bops->read(parent, buffer, start_sector, count);
+          if (tmp != (ssize_t)count)
+            {
+              ret = tmp < 0 ? (int)tmp : -EIO;
+              break;
+            }
+        }
+      else
+        {
+          if (pg == NULL)
+            {
+              ret = bcache_fill(dev, page, &pg);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+          else
+            {
+              bcache_touch(pg);
+            }
+
+          memcpy(buffer, &pg->data[offset * dev->sectorsize],
+                 count * dev->sectorsize);
+        }
+
+      buffer       += count * dev->sectorsize;
+      start_sector += count;
+      nsectors     -= count;
+      nread        += count;
+    }
+
+  nxsem_post(&g_bcache.lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description: Write (or cache) the specified number of sectors
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t bcache_write(FAR struct inode *inode,
+                            const unsigned char *buffer,
+                            size_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_page_s *pg;
+  ssize_t nwritten = 0;
+  size_t page;
+  size_t offset;
+  size_t count;
+  int ret;
+
+  if (parent->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  ret = bcache_prepare(dev, start_sector, &nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nsectors > 0)
+    {
+      page   = start_sector / BCACHE_NSECTORS;
+      offset = start_sector % BCACHE_NSECTORS;
+      count  = BCACHE_NSECTORS - offset;
+      if (count > nsectors)
+        {
+          count = nsectors;
+        }
+
+      pg = bcache_find(dev, page);
+      if (pg == NULL && count == BCACHE_NSECTORS)
+        {
+          ssize_t tmp;
+
+          /* Write whole pages that are not cached directly */
+
+          while (count + BCACHE_NSECTORS <= nsectors &&
+                 bcache_find(dev, page + count / BCACHE_NSECTORS) == NULL)
+            {
+              count += BCACHE_NSECTORS;
+            }
+
+          tmp = parent->u.i_bops->write(parent, buffer, start_sector,
+                                        count);
+          if (tmp != (ssize_t)count)
+            {
+              ret = tmp < 0 ? (int)tmp : -EIO;
+              break;
+            }
+        }
+      else
+        {
+          /* Modify the cached page.  It is written back later. */
+
+          if (pg == NULL)
+            {
+              ret = bcache_fill(dev, page, &pg);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+          else
+            {
+              bcache_touch(pg);
+            }
+
+          memcpy(&pg->data[offset * dev->sectorsize], buffer,
+                 count * dev->sectorsize);
+          pg->dirty = true;
+
+          if (!g_bcache.flushpending)
+            {
+              g_bcache.flushpending = true;
+              (void)work_queue(BCACHE_WORK, &g_bcache.work, bcache_worker,
+                               NULL,
+                               MSEC2TICK(CONFIG_FS_BLOCKCACHE_FLUSHDELAY));
+            }
+        }
+
+      buffer       += count * dev->sectorsize;
+      start_sector += count;
+      nsectors     -= count;
+      nwritten     += count;
+    }
+
+  nxsem_post(&g_bcache.lock);
+  return nwritten > 0 ? nwritten : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: bcache_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int bcache_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_bcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = bcache_setup(dev, geometry);
+  if (ret == -ENODEV)
+    {
+      /* No media is not an error of the geometry method */
+
+      ret = OK;
+    }
+
+  nxsem_post(&g_bcache.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_ioctl
+ *
+ * Description: Flush the cache or pass the command to the device
+ *
+ ****************************************************************************/
+
+static int bcache_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = -ENOTTY;
+
+  if (cmd == BIOC_FLUSH)
+    {
+      ret = nxsem_wait_uninterruptible(&g_bcache.lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = bcache_flushdev(dev, false);
+      nxsem_post(&g_bcache.lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = -ENOTTY;
+    }
+  else if (cmd == BIOC_XIPBASE)
+    {
+      /* Direct access to the media would bypass the cache */
+
+      return -ENOTTY;
+    }
+
+  if (parent->u.i_bops->ioctl)
+    {
+      ret = parent->u.i_bops->ioctl(parent, cmd, arg);
+    }
+
+  /* Flushing the cache was enough if the device has nothing to flush */
+
+  return cmd == BIOC_FLUSH && ret == -ENOTTY ? OK : ret;
+}
+
+/****************************************************************************
+ * Name: bcache_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int bcache_unlink(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+  nxsem_wait_uninterruptible(&g_bcache.lock);
+  (void)bcache_flushdev(dev, true);
+  nxsem_post(&g_bcache.lock);
+
+  inode_release(parent);
+  kmm_free(dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver inode that caches the block driver at 'parent'.
+ *   All cached block drivers share one LRU cache of pages of
+ *   CONFIG_FS_BLOCKCACHE_PAGESECTORS sectors, hashed by device and page
+ *   number.  A page is read as a whole when one of its sectors is
+ *   accessed.  Writes to cached pages are written back after
+ *   CONFIG_FS_BLOCKCACHE_FLUSHDELAY milliseconds, on close and on
+ *   BIOC_FLUSH.  Transfers of whole pages that are not cached bypass the
+ *   cache.
+ *
+ *   The cached block driver, not the parent, must then be used by file
+ *   systems or the BCH layer.
+ *
+ * Input Parameters:
+ *   path   - The path to the cached block driver inode
+ *   mode   - The access mode of the new inode
+ *   parent - The path to the block driver to be cached
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure:
+ *
+ *   EINVAL - 'path' is invalid for this operation
+ *   EEXIST - An inode already exists at 'path'
+ *   ENOMEM - Failed to allocate in-memory resources for the operation
+ *
+ ****************************************************************************/
+
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret;
+
+  /* Allocate a cached device structure */
+
+  dev = kmm_zalloc(sizeof(*dev));
+  if (!dev)
+    {
+      return -ENOMEM;
+    }
+
+  /* Find the block driver */
+
+  if (mode & (S_IWOTH | S_IWGRP | S_IWUSR))
+    {
+      ret = find_blockdriver(parent, 0, &dev->parent);
+    }
+  else
+    {
+      ret = find_blockdriver(parent, MS_RDONLY, &dev->parent);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_free;
+    }
+
+  /* Inode private data is a reference to the cached device structure */
+
+  ret = register_blockdriver(path, &g_bcache_bops, mode, dev);
+  if (ret < 0)
+    {
+      goto errout_release;
+    }
+
+  return OK;
+
+errout_release:
+  inode_release(dev->parent);
+errout_free:
+  kmm_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
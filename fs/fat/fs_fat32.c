@@ -64,6 +64,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 #include <nuttx/fs/dirent.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -91,8 +92,13 @@ static int     fat_truncate(FAR struct file *filep, off_t length);
 
 static int     fat_opendir(FAR struct inode *mountpt,
                  FAR const char *relpath, FAR struct fs_dirent_s *dir);
+static int     fat_readdirentry(FAR struct fat_mountpt_s *fs,
+                 FAR struct fs_dirent_s *dir);
 static int     fat_readdir(FAR struct inode *mountpt,
                  FAR struct fs_dirent_s *dir);
+static int     fat_getdents(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir, FAR struct dirent *entries,
+                 size_t nentries);
 static int     fat_rewinddir(FAR struct inode *mountpt,
                  FAR struct fs_dirent_s *dir);
 
@@ -155,7 +161,9 @@ const struct mountpt_operations fat_operations =
   fat_mkdir,         /* mkdir */
   fat_rmdir,         /* rmdir */
   fat_rename,        /* rename */
-  fat_stat           /* stat */
+  fat_stat,          /* stat */
+
+  fat_getdents       /* getdents */
 };
 
 /****************************************************************************
@@ -272,6 +280,12 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
             {
               goto errout_with_semaphore;
             }
+
+          /* The directory sector is back in the cache, but not
+           * necessarily in the same buffer.
+           */
+
+          direntry = &fs->fs_buffer[dirinfo.fd_seq.ds_offset];
         }
 
       /* fall through to finish the file open operations */
@@ -434,6 +448,17 @@ static int fat_close(FAR struct file *filep)
 
       ret = fat_sync(filep);
 
+      /* Release any clusters that were allocated beyond the end of the
+       * file.
+       */
+
+      if (ret >= 0 && (ff->ff_bflags & FFBUFF_PREALLOC) != 0)
+        {
+          fat_semtake(fs);
+          ret = fat_unreserve(fs, ff);
+          fat_semgive(fs);
+        }
+
       /* Remove the file structure from the list of open files in the
        * mountpoint structure.
        */
@@ -493,6 +518,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int ncontig;
+  int32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -613,12 +640,28 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the clusters that follow it
+           * contiguously on the media.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          lastcluster = ff->ff_currentcluster;
+          ncontig     = ff->ff_sectorsincluster;
+
+          while (nsectors > ncontig)
             {
-              nsectors = ff->ff_sectorsincluster;
+              cluster = fat_getcluster(fs, lastcluster);
+              if (cluster != lastcluster + 1 || cluster >= fs->fs_nclusters)
+                {
+                  break;
+                }
+
+              lastcluster = cluster;
+              ncontig    += fs->fs_fatsecperclus;
+            }
+
+          if (nsectors > ncontig)
+            {
+              nsectors = ncontig;
             }
 
           /* We are not sure of the state of the file buffer so
@@ -652,7 +695,8 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = ncontig - nsectors;
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -727,6 +771,8 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int ncontig;
+  int32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -797,9 +843,13 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
         {
           /* No.. we have to create a new cluster chain */
 
-          ff->ff_startcluster     = fat_createchain(fs);
+          ff->ff_startcluster     = fat_extendrun(fs, 0,
+                                                  CONFIG_FAT_ALLOC_EXTENT);
           ff->ff_currentcluster   = ff->ff_startcluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+#if CONFIG_FAT_ALLOC_EXTENT > 1
+          ff->ff_bflags          |= FFBUFF_PREALLOC;
+#endif
         }
 
       /* The current sector can then be determined from the current cluster
@@ -829,11 +879,12 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
       if (ff->ff_sectorsincluster < 1)
         {
-          /* Extend the current cluster by one (unless lseek was used to
-           * move the file position back from the end of the file)
+          /* Extend the current cluster (unless lseek was used to move
+           * the file position back from the end of the file)
            */
 
-          cluster = fat_extendchain(fs, ff->ff_currentcluster);
+          cluster = fat_extendrun(fs, ff->ff_currentcluster,
+                                  CONFIG_FAT_ALLOC_EXTENT);
 
           /* Verify the cluster number */
 
@@ -848,6 +899,10 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
               goto errout_with_semaphore;
             }
 
+#if CONFIG_FAT_ALLOC_EXTENT > 1
+          ff->ff_bflags |= FFBUFF_PREALLOC;
+#endif
+
           /* Setup to write the first sector from the new cluster */
 
           ff->ff_currentcluster   = cluster;
@@ -872,12 +927,30 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the clusters that follow it
+           * contiguously on the media.  A cluster that is allocated
+           * here but is not contiguous is simply used next time
+           * through the loop.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          lastcluster = ff->ff_currentcluster;
+          ncontig     = ff->ff_sectorsincluster;
+
+          while (nsectors > ncontig)
             {
-              nsectors = ff->ff_sectorsincluster;
+              cluster = fat_extendchain(fs, lastcluster);
+              if (cluster != lastcluster + 1 || cluster >= fs->fs_nclusters)
+                {
+                  break;
+                }
+
+              lastcluster = cluster;
+              ncontig    += fs->fs_fatsecperclus;
+            }
+
+          if (nsectors > ncontig)
+            {
+              nsectors = ncontig;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -912,7 +985,8 @@ fat_write_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = ncontig - nsectors;
           ff->ff_currentsector    += nsectors;
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
@@ -1306,10 +1380,56 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
-  /* ioctl calls are just passed through to the contained block driver */
+  if (cmd == FIOC_FALLOCATE)
+    {
+      FAR off_t *length = (FAR off_t *)((uintptr_t)arg);
+
+      /* Allocate the clusters to hold the file up to 'length' bytes */
+
+      if ((ff->ff_oflags & O_WROK) == 0)
+        {
+          ret = -EBADF;
+        }
+      else if (length == NULL || *length < 0)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = fat_reserve(fs, ff, *length);
+          if (ret >= 0)
+            {
+              ret = fat_updatefsinfo(fs);
+            }
+        }
+    }
+  else if (cmd == FIOC_BMAP)
+    {
+      FAR struct file_bmap_s *bmap =
+        (FAR struct file_bmap_s *)((uintptr_t)arg);
+
+      /* Map the file offset to a sector of the block driver */
+
+      if (bmap == NULL)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = fat_bmap(fs, ff, bmap);
+        }
+    }
+  else
+    {
+      /* ioctl calls are just passed through to the contained block
+       * driver
+       */
+
+      ret = -ENOSYS;
+    }
 
   fat_semgive(fs);
-  return -ENOSYS;
+  return ret;
 }
 
 /****************************************************************************
@@ -1835,15 +1955,16 @@ errout_with_semaphore:
 }
 
 /****************************************************************************
- * Name: fat_readdir
+ * Name: fat_readdirentry
  *
- * Description: Read the next directory entry
+ * Description: Read the next directory entry into dir->fd_dir.  The caller
+ *   holds the volume semaphore.
  *
  ****************************************************************************/
 
-static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
+static int fat_readdirentry(FAR struct fat_mountpt_s *fs,
+                            FAR struct fs_dirent_s *dir)
 {
-  FAR struct fat_mountpt_s *fs;
   unsigned int dirindex;
   FAR uint8_t *direntry;
   uint8_t ch;
@@ -1851,25 +1972,6 @@ static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
   bool found;
   int ret;
 
-  /* Sanity checks */
-
-  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
-
-  /* Recover our private data from the inode instance */
-
-  fs = mountpt->i_private;
-
-  /* Make sure that the mount is still healthy.
-   * REVISIT: What if a forced unmount was done since opendir() was called?
-   */
-
-  fat_semtake(fs);
-  ret = fat_checkmount(fs);
-  if (ret != OK)
-    {
-      goto errout_with_semaphore;
-    }
-
   /* Read the next directory entry */
 
   dir->fd_dir.d_name[0] = '\0';
@@ -1880,7 +1982,7 @@ static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
       ret = fat_fscacheread(fs, dir->u.fat.fd_currsector);
       if (ret < 0)
         {
-          goto errout_with_semaphore;
+          return ret;
         }
 
       /* Get a reference to the current directory entry */
@@ -1897,8 +1999,7 @@ static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
            * special error -ENOENT
            */
 
-          ret = -ENOENT;
-          goto errout_with_semaphore;
+          return -ENOENT;
         }
 
       /* No, is the current entry a valid entry? */
@@ -1963,19 +2064,106 @@ static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
             }
         }
 
-      /* Set up the next directory index */
+      /* Set up the next directory index.  If there is none, then this
+       * was the last entry of the directory.  Return it, if it was valid,
+       * and the end of the directory next time.
+       */
 
       if (fat_nextdirentry(fs, &dir->u.fat) != OK)
         {
-          ret = -ENOENT;
-          goto errout_with_semaphore;
+          dir->u.fat.fd_currsector = 0;
+          return found ? OK : -ENOENT;
         }
     }
 
+  return found ? OK : -ENOENT;
+
+}
+
+/****************************************************************************
+ * Name: fat_readdir
+ *
+ * Description: Read the next directory entry
+ *
+ ****************************************************************************/
+
+static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
+{
+  FAR struct fat_mountpt_s *fs;
+  int ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+  /* Recover our private data from the inode instance */
+
+  fs = mountpt->i_private;
+
+  /* Make sure that the mount is still healthy.
+   * REVISIT: What if a forced unmount was done since opendir() was called?
+   */
+
+  fat_semtake(fs);
+  ret = fat_checkmount(fs);
+  if (ret == OK)
+    {
+      ret = fat_readdirentry(fs, dir);
+    }
+
   fat_semgive(fs);
-  return OK;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_getdents
+ *
+ * Description: Read up to 'nentries' directory entries, taking the volume
+ *   semaphore once.
+ *
+ ****************************************************************************/
+
+static int fat_getdents(FAR struct inode *mountpt,
+                        FAR struct fs_dirent_s *dir,
+                        FAR struct dirent *entries, size_t nentries)
+{
+  FAR struct fat_mountpt_s *fs;
+  size_t nread = 0;
+  int ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+  /* Recover our private data from the inode instance */
+
+  fs = mountpt->i_private;
+
+  fat_semtake(fs);
+  ret = fat_checkmount(fs);
+  if (ret == OK)
+    {
+      while (nread < nentries)
+        {
+          ret = fat_readdirentry(fs, dir);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          memcpy(&entries[nread++], &dir->fd_dir, sizeof(struct dirent));
+        }
+
+      /* The end of the directory or an error after some entries were read
+       * ends the batch.  The error is reported again on the next call.
+       */
+
+      if (ret == -ENOENT || nread > 0)
+        {
+          ret = nread;
+        }
+    }
 
-errout_with_semaphore:
   fat_semgive(fs);
   return ret;
 }
@@ -2172,6 +2360,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+  /* Write back any dirty sectors that are still in the sector cache */
+
+  if (fs->fs_mounted)
+    {
+      (void)fat_fscacheflush(fs);
+    }
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2201,9 +2396,17 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   if (fs->fs_buffer)
     {
-      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fat_io_free(fs->fs_cache[0].cs_buffer,
+                  CONFIG_FAT_SECTORCACHE * fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      kmm_free(fs->fs_freemap);
+    }
+#endif
+
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
@@ -2416,11 +2619,11 @@ static int fat_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
-  /* Flush any existing, dirty data in fs_buffer (because we need
-   * it to create the directory entries.
+  /* Get a cleared sector of the sector cache for the first sector of the
+   * new directory.
    */
 
-  ret = fat_fscacheflush(fs);
+  ret = fat_fscachezero(fs, dirsector);
   if (ret < 0)
     {
       goto errout_with_semaphore;
@@ -2430,11 +2633,6 @@ static int fat_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   direntry = fs->fs_buffer;
 
-  /* Now erase the contents of fs_buffer */
-
-  fs->fs_currentsector = dirsector;
-  memset(direntry, 0, fs->fs_hwsectorsize);
-
   /* Now clear all sectors in the new directory cluster (except for the first) */
 
   for (i = 1; i < fs->fs_fatsecperclus; i++)
@@ -2565,6 +2763,12 @@ int fat_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
 
       ret = fat_remove(fs, relpath, true);
+
+#ifdef CONFIG_FAT_DIRCACHE
+      /* The cluster of the directory may be re-used */
+
+      dircache_flush(&fs->fs_dircache);
+#endif
     }
 
   fat_semgive(fs);
@@ -2704,6 +2908,12 @@ int fat_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_FAT_DIRCACHE
+  /* If a directory was renamed, the paths below it are no longer valid */
+
+  dircache_flush(&fs->fs_dircache);
+#endif
+
   /* Write the old entry to disk and update FSINFO if necessary */
 
   ret = fat_updatefsinfo(fs);
@@ -51,11 +51,26 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/dirent.h>
+#include <nuttx/fs/dircache.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FAT_SECTORCACHE
+#  define CONFIG_FAT_SECTORCACHE 1
+#endif
+
+#if CONFIG_FAT_SECTORCACHE < 1 || CONFIG_FAT_SECTORCACHE > 255
+#  error CONFIG_FAT_SECTORCACHE is out of range
+#endif
+
+#ifndef CONFIG_FAT_ALLOC_EXTENT
+#  define CONFIG_FAT_ALLOC_EXTENT 1
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record (MBR).
  *
@@ -346,6 +361,7 @@
 #define FFBUFF_VALID         1
 #define FFBUFF_DIRTY         2
 #define FFBUFF_MODIFIED      4
+#define FFBUFF_PREALLOC     16 /* Clusters may be allocated beyond the end of file */
 
 /* Mount status flags (ff_bflags) */
 
@@ -867,6 +883,19 @@
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one sector of the mountpoint sector cache.  The
+ * sector that is current (i.e., available in fs_buffer) is also described
+ * by fs_currentsector and fs_dirty of struct fat_mountpt_s.
+ */
+
+struct fat_cachesect_s
+{
+  off_t    cs_sector;              /* The sector held in cs_buffer (-1: none) */
+  uint32_t cs_lru;                 /* fs_lrucount when last made current */
+  bool     cs_dirty;               /* true: cs_buffer is dirty */
+  uint8_t *cs_buffer;              /* One sector of the cache memory */
+};
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -899,8 +928,17 @@ struct fat_mountpt_s
   uint8_t  fs_type;                /* FSTYPE_FAT12, FSTYPE_FAT16, or FSTYPE_FAT32 */
   uint8_t  fs_fatnumfats;          /* MBR: Number of FATs (probably 2) */
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
-  uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
-                                    * from the device */
+  uint8_t  fs_cacheslot;           /* Index of the current sector in fs_cache[] */
+  uint32_t fs_lrucount;            /* Incremented when the current sector changes */
+  uint8_t *fs_buffer;              /* The current sector of the sector cache */
+  struct fat_cachesect_s fs_cache[CONFIG_FAT_SECTORCACHE];
+                                   /* FAT and directory sector cache */
+#ifdef CONFIG_FAT_DIRCACHE
+  struct dircache_s fs_dircache;   /* Start clusters of recently used directories */
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t *fs_freemap;            /* Bitmap of free clusters (built on first use) */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1052,9 +1090,11 @@ EXTERN off_t  fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno);
 EXTERN int    fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                              off_t startsector);
 EXTERN int    fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster);
-EXTERN int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster);
+EXTERN int32_t fat_extendrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                             uint32_t nclusters);
 
-#define fat_createchain(fs) fat_extendchain(fs, 0)
+#define fat_extendchain(fs, cluster) fat_extendrun(fs, cluster, 1)
+#define fat_createchain(fs) fat_extendrun(fs, 0, 1)
 
 /* Help for traversing directory trees and accessing directory entries */
 
@@ -1078,10 +1118,22 @@ EXTERN int    fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s
 EXTERN int    fat_dircreate(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo);
 EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath, bool directory);
 
+/* Preallocation of file clusters */
+
+EXTERN int    fat_reserve(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                          off_t length);
+EXTERN int    fat_unreserve(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff);
+
+/* Mapping of file offsets to sectors */
+
+EXTERN int    fat_bmap(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                       FAR struct file_bmap_s *bmap);
+
 /* Mountpoint and file buffer cache (for partial sector accesses) */
 
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
+EXTERN int    fat_fscachezero(struct fat_mountpt_s *fs, off_t sector);
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff);
@@ -2301,6 +2301,11 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
   uint8_t *direntry;
   char     terminator;
   int      ret;
+#ifdef CONFIG_FAT_DIRCACHE
+  const char *start = path;
+  uintptr_t value;
+  size_t   len;
+#endif
 
   /* Initialize to traverse the chain.  Set it to the cluster of the root
    * directory
@@ -2349,6 +2354,23 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
 
   dirinfo->fd_root = false;
 
+#ifdef CONFIG_FAT_DIRCACHE
+  /* Start in the deepest directory of the path that is in the cache */
+
+  len = dircache_lookup(&fs->fs_dircache, path, &value);
+  if (len > 0)
+    {
+      cluster = (off_t)value;
+
+      dirinfo->dir.fd_startcluster = cluster;
+      dirinfo->dir.fd_currcluster  = cluster;
+      dirinfo->dir.fd_currsector   = fat_cluster2sector(fs, cluster);
+      dirinfo->dir.fd_index        = 2;
+
+      path += len + 1;
+    }
+#endif
+
   /* Now loop until the directory entry corresponding to the path is found */
 
   for (; ; )
@@ -2441,6 +2463,18 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
           ((uint32_t)DIR_GETFSTCLUSTHI(direntry) << 16) |
           DIR_GETFSTCLUSTLO(direntry);
 
+#ifdef CONFIG_FAT_DIRCACHE
+      /* Remember the directory.  '..' in the root directory has cluster
+       * zero and is not cached.
+       */
+
+      if (cluster >= 2)
+        {
+          dircache_add(&fs->fs_dircache, start, path - start - 1,
+                       (uintptr_t)cluster);
+        }
+#endif
+
       /* Then restart scanning at the new directory, skipping over both the
        * '.' and '..' entries that exist in all directories EXCEPT the root
        * directory.
@@ -2557,11 +2591,12 @@ int fat_allocatedirentry(struct fat_mountpt_s *fs,
           return cluster;
         }
 
-      /* Flush out any cached data in fs_buffer.. we are going to use
+      /* Get a cleared sector of the sector cache.. we are going to use
        * it to initialize the new directory cluster.
        */
 
-      ret = fat_fscacheflush(fs);
+      sector = fat_cluster2sector(fs, cluster);
+      ret = fat_fscachezero(fs, sector);
       if (ret < 0)
         {
           return ret;
@@ -2569,10 +2604,6 @@ int fat_allocatedirentry(struct fat_mountpt_s *fs,
 
       /* Clear all sectors comprising the new directory cluster */
 
-      fs->fs_currentsector = fat_cluster2sector(fs, cluster);
-      memset(fs->fs_buffer, 0, fs->fs_hwsectorsize);
-
-      sector = fs->fs_currentsector;
       for (i = fs->fs_fatsecperclus; i; i--)
         {
           ret = fat_hwwrite(fs, fs->fs_buffer, sector, 1);
@@ -278,6 +278,376 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscachesave
+ *
+ * Description:
+ *   Save the state of the current sector of the sector cache.  The rest of
+ *   the file system marks the current sector dirty through fs_dirty.
+ *
+ ****************************************************************************/
+
+static inline void fat_fscachesave(FAR struct fat_mountpt_s *fs)
+{
+  fs->fs_cache[fs->fs_cacheslot].cs_dirty = fs->fs_dirty;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheselect
+ *
+ * Description:
+ *   Make a sector of the sector cache the current sector, i.e., the one
+ *   that is available in fs_buffer.
+ *
+ ****************************************************************************/
+
+static void fat_fscacheselect(FAR struct fat_mountpt_s *fs, int slot)
+{
+  FAR struct fat_cachesect_s *cs = &fs->fs_cache[slot];
+
+  cs->cs_lru           = ++fs->fs_lrucount;
+  fs->fs_cacheslot     = slot;
+  fs->fs_buffer        = cs->cs_buffer;
+  fs->fs_currentsector = cs->cs_sector;
+  fs->fs_dirty         = cs->cs_dirty;
+}
+
+/****************************************************************************
+ * Name: fat_fscachefind
+ *
+ * Description:
+ *   Return the index of the sector in the sector cache or -1 if the sector
+ *   is not cached.
+ *
+ ****************************************************************************/
+
+static int fat_fscachefind(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      if (fs->fs_cache[i].cs_sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: fat_fscachewrite
+ *
+ * Description:
+ *   Write back a dirty sector of the sector cache, including all copies of
+ *   the FAT if the sector lies in the FAT region.
+ *
+ ****************************************************************************/
+
+static int fat_fscachewrite(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_cachesect_s *cs)
+{
+  off_t sector = cs->cs_sector;
+  int ret;
+
+  /* Write the dirty sector */
+
+  ret = fat_hwwrite(fs, cs->cs_buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      int i;
+
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, cs->cs_buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* No longer dirty */
+
+  cs->cs_dirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachevictim
+ *
+ * Description:
+ *   Free a sector of the sector cache:  An unused one if there is one,
+ *   otherwise the least recently used one, which is written back first if
+ *   it is dirty.  The index of the free sector is returned.
+ *
+ ****************************************************************************/
+
+static int fat_fscachevictim(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *cs;
+  int victim = 0;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_sector < 0)
+        {
+          victim = i;
+          break;
+        }
+
+      if ((int32_t)(cs->cs_lru - fs->fs_cache[victim].cs_lru) < 0)
+        {
+          victim = i;
+        }
+    }
+
+  cs = &fs->fs_cache[victim];
+  if (cs->cs_dirty)
+    {
+      ret = fat_fscachewrite(fs, cs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  cs->cs_sector = -1;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: fat_fscachediscard
+ *
+ * Description:
+ *   Discard the cached copies of sectors that have just been written to the
+ *   media from another buffer.  This keeps the sector cache coherent when
+ *   clusters are re-used, e.g., when a freed directory cluster is
+ *   allocated to a file.
+ *
+ ****************************************************************************/
+
+static void fat_fscachediscard(FAR struct fat_mountpt_s *fs,
+                               FAR const uint8_t *buffer, off_t sector,
+                               unsigned int nsectors)
+{
+  FAR struct fat_cachesect_s *cs;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_buffer != buffer && cs->cs_sector >= sector &&
+          cs->cs_sector < sector + nsectors)
+        {
+          cs->cs_sector = -1;
+          cs->cs_dirty  = false;
+
+          if (i == fs->fs_cacheslot)
+            {
+              fs->fs_currentsector = -1;
+              fs->fs_dirty         = false;
+            }
+        }
+    }
+}
+
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Build the in-memory bitmap of free clusters with one pass over the
+ *   FAT.  This also gives the exact count of free clusters.
+ *
+ ****************************************************************************/
+
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  FAR uint32_t *freemap;
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  freemap = (FAR uint32_t *)
+    kmm_zalloc(((fs->fs_nclusters + 31) >> 5) * sizeof(uint32_t));
+  if (freemap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          kmm_free(freemap);
+          return (int)next;
+        }
+      else if (next == 0)
+        {
+          freemap[cluster >> 5] |= (uint32_t)1 << (cluster & 31);
+          nfreeclusters++;
+        }
+    }
+
+  fs->fs_freemap = freemap;
+
+  if (fs->fs_fsifreecount != nfreeclusters)
+    {
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapupdate
+ *
+ * Description:
+ *   Keep the free cluster bitmap (if it has been built) in sync with a
+ *   change of the FAT entry of a cluster.
+ *
+ ****************************************************************************/
+
+static inline void fat_freemapupdate(FAR struct fat_mountpt_s *fs,
+                                     uint32_t cluster, bool isfree)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      uint32_t bit = (uint32_t)1 << (cluster & 31);
+
+      if (isfree)
+        {
+          fs->fs_freemap[cluster >> 5] |= bit;
+        }
+      else
+        {
+          fs->fs_freemap[cluster >> 5] &= ~bit;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findrun
+ *
+ * Description:
+ *   Find *nclusters contiguous free clusters.  The search starts after
+ *   startcluster and wraps around once to the beginning of the FAT.  If
+ *   there is no such run, the longest run that was found is returned and
+ *   its length in *nclusters.  If the free cluster bitmap is enabled, it is
+ *   built by the first search.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: first cluster of the run
+ *
+ ****************************************************************************/
+
+static int32_t fat_findrun(FAR struct fat_mountpt_s *fs,
+                           uint32_t startcluster, FAR uint32_t *nclusters)
+{
+  uint32_t cluster = startcluster;
+  uint32_t nfound  = 0;
+  uint32_t nbest   = 0;
+  uint32_t best    = 0;
+  uint32_t count;
+  off_t next;
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap == NULL)
+    {
+      /* If there is not enough memory, search the FAT itself */
+
+      (void)fat_freemapbuild(fs);
+    }
+#endif
+
+  for (count = 2; count < fs->fs_nclusters; count++)
+    {
+      /* Examine the next cluster, wrapping back to the beginning because
+       * we might have started at a non-optimal place.  A run does not wrap.
+       */
+
+      cluster++;
+      if (cluster >= fs->fs_nclusters)
+        {
+          cluster = 2;
+          nfound  = 0;
+        }
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (fs->fs_freemap != NULL)
+        {
+          uint32_t word = fs->fs_freemap[cluster >> 5];
+
+          /* Skip whole words of allocated clusters */
+
+          if (word == 0 && (cluster & 31) == 0 &&
+              cluster + 32 <= fs->fs_nclusters)
+            {
+              cluster += 31;
+              count   += 31;
+              nfound   = 0;
+              continue;
+            }
+
+          next = (word & ((uint32_t)1 << (cluster & 31))) != 0 ? 0 : 1;
+        }
+      else
+#endif
+        {
+          next = fat_getcluster(fs, cluster);
+          if (next < 0)
+            {
+              /* Some error occurred, return the error number */
+
+              return (int32_t)next;
+            }
+        }
+
+      if (next != 0)
+        {
+          nfound = 0;
+        }
+      else if (++nfound >= *nclusters)
+        {
+          return cluster - nfound + 1;
+        }
+      else if (nfound > nbest)
+        {
+          nbest = nfound;
+          best  = cluster - nfound + 1;
+        }
+    }
+
+  /* There are not enough contiguous free clusters.  Return the longest
+   * run (if any).
+   */
+
+  *nclusters = nbest;
+  return best;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -521,11 +891,18 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   FAR struct inode *inode;
   struct geometry geo;
   int ret;
+  int i;
 
   /* Assume that the mount is successful */
 
   fs->fs_mounted = true;
 
+#ifdef CONFIG_FAT_DIRCACHE
+  /* Nothing is known about the directories of the (new) media */
+
+  dircache_init(&fs->fs_dircache);
+#endif
+
   /* Check if there is media available */
 
   inode = fs->fs_blkdriver;
@@ -549,15 +926,29 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
-  /* Allocate a buffer to hold one hardware sector */
+  /* Allocate the sector cache.  Nothing is cached yet. */
 
-  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  fs->fs_buffer = (FAR uint8_t *)
+    fat_io_alloc(CONFIG_FAT_SECTORCACHE * fs->fs_hwsectorsize);
   if (!fs->fs_buffer)
     {
       ret = -ENOMEM;
       goto errout;
     }
 
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      fs->fs_cache[i].cs_sector = -1;
+      fs->fs_cache[i].cs_lru    = 0;
+      fs->fs_cache[i].cs_dirty  = false;
+      fs->fs_cache[i].cs_buffer = fs->fs_buffer + i * fs->fs_hwsectorsize;
+    }
+
+  fs->fs_cacheslot     = 0;
+  fs->fs_lrucount      = 0;
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -586,7 +977,6 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
        * partition number.
        */
 
-      int i;
       for (i = 0; i < 4; i++)
         {
           /* Check if the partition exists and, if so, get the bootsector for that
@@ -685,7 +1075,8 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
-  fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+  fat_io_free(fs->fs_cache[0].cs_buffer,
+              CONFIG_FAT_SECTORCACHE * fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
 errout:
@@ -798,6 +1189,10 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
             {
               ret = nsectorswritten;
             }
+
+          /* The media no longer matches any other cached copy */
+
+          fat_fscachediscard(fs, buffer, sector, nsectors);
         }
     }
 
@@ -1115,6 +1510,13 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (clusterno >= 2)
+        {
+          fat_freemapupdate(fs, clusterno, nextcluster == 0);
+        }
+#endif
       return OK;
     }
 
@@ -1173,22 +1575,30 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 }
 
 /****************************************************************************
- * Name: fat_extendchain
+ * Name: fat_extendrun
  *
  * Description:
- *   Add a new cluster to the chain following cluster (if cluster is non-
- *   NULL).  if cluster is zero, then a new chain is created.
+ *   Add new clusters to the chain following cluster (if cluster is non-
+ *   NULL).  if cluster is zero, then a new chain is created.  If cluster
+ *   is already followed by another cluster, that cluster is returned and
+ *   nothing is added.
+ *
+ *   Up to nclusters clusters are added.  They are contiguous on the media:
+ *   If there is no free run of nclusters clusters, the longest free run is
+ *   added.
  *
  * Returned Value:
- *   <0:error, 0: no free cluster, >=2: new cluster number
+ *   <0:error, 0: no free cluster, >=2: first new cluster number
  *
  ****************************************************************************/
 
-int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
+int32_t fat_extendrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                      uint32_t nclusters)
 {
   off_t    startsector;
   uint32_t newcluster;
   uint32_t startcluster;
+  uint32_t i;
   int      ret;
 
   /* The special value 0 is used when the new chain should start */
@@ -1238,69 +1648,31 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
+  /* Find a contiguous run of free clusters or, failing that, the longest
+   * run that there is.
    */
 
-  newcluster = startcluster;
-  for (; ; )
+  if (nclusters < 1)
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
+      nclusters = 1;
+    }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+  ret = fat_findrun(fs, startcluster, &nclusters);
+  if (ret <= 0)
+    {
+      /* No free cluster (0) or an error (<0) */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return ret;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  newcluster = ret;
+
+  /* Now mark the clusters as in-use, linking each to the next, and
+   * terminate the chain.  The chain is built back to front so that it
+   * is valid at any time.
    */
 
-  ret = fat_putcluster(fs, newcluster, 0x0fffffff);
+  ret = fat_putcluster(fs, newcluster + nclusters - 1, 0x0fffffff);
   if (ret < 0)
     {
       /* An error occurred */
@@ -1308,6 +1680,15 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       return ret;
     }
 
+  for (i = nclusters - 1; i > 0; i--)
+    {
+      ret = fat_putcluster(fs, newcluster + i - 1, newcluster + i);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
   /* And link if to the start cluster (if any) */
 
   if (cluster)
@@ -1323,14 +1704,16 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
 
   /* And update the FINSINFO for the next time we have to search */
 
-  fs->fs_fsinextfree = newcluster;
+  fs->fs_fsinextfree = newcluster + nclusters - 1;
   if (fs->fs_fsifreecount != 0xffffffff)
     {
-      fs->fs_fsifreecount--;
+      fs->fs_fsifreecount -= nclusters;
       fs->fs_fsidirty = 1;
     }
 
-  /* Return then number of the new cluster that was added to the chain */
+  /* Return then number of the first new cluster that was added to the
+   * chain
+   */
 
   return newcluster;
 }
@@ -1769,102 +2152,365 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
 }
 
 /****************************************************************************
- * Name: fat_fscacheflush
+ * Name: fat_reserve
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Make sure that clusters are allocated to hold 'length' bytes of the
+ *   file without changing the file size.  New clusters are allocated in
+ *   one contiguous run if possible.  Clusters beyond the end of the file
+ *   are released by fat_unreserve() when the file is closed.
+ *
+ * Assumptions:
+ *   The caller holds the mountpoint semaphore.
  *
  ****************************************************************************/
 
-int fat_fscacheflush(struct fat_mountpt_s *fs)
+int fat_reserve(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                off_t length)
 {
-  int ret;
+  off_t    clustersize;
+  uint32_t nclusters;
+  uint32_t nhave = 0;
+  int32_t  lastcluster = 0;
+  int32_t  cluster;
 
-  /* Check if the fs_buffer is dirty.  In this case, we will write back the
-   * contents of fs_buffer.
-   */
+  if (length <= ff->ff_size)
+    {
+      return OK;
+    }
+
+  clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  nclusters   = (length + clustersize - 1) / clustersize;
 
-  if (fs->fs_dirty)
+  /* Find the end of the existing cluster chain */
+
+  cluster = ff->ff_startcluster;
+  while (cluster >= 2 && cluster < fs->fs_nclusters)
     {
-      /* Write the dirty sector */
+      lastcluster = cluster;
+      if (++nhave >= nclusters)
+        {
+          return OK;
+        }
 
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-      if (ret < 0)
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 0)
         {
-          return ret;
+          return cluster;
         }
+    }
 
-      /* Does the sector lie in the FAT region? */
+  /* Then add the missing clusters to it */
 
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
+  while (nhave < nclusters)
+    {
+      cluster = fat_extendrun(fs, lastcluster, nclusters - nhave);
+      if (cluster < 0)
+        {
+          return cluster;
+        }
+      else if (cluster == 0)
         {
-          int i;
+          return -ENOSPC;
+        }
+
+      ff->ff_bflags |= FFBUFF_PREALLOC;
+      if (lastcluster == 0)
+        {
+          /* This is the first cluster of the file */
 
-          /* Yes, then make the change in the FAT copy as well */
+          ff->ff_startcluster   = cluster;
+          ff->ff_currentcluster = cluster;
+          ff->ff_bflags        |= FFBUFF_MODIFIED;
+        }
+
+      /* Skip over the run that was just added */
+
+      do
+        {
+          lastcluster = cluster;
+          nhave++;
 
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
+          cluster = fat_getcluster(fs, cluster);
+          if (cluster < 0)
             {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
+              return cluster;
             }
         }
+      while (cluster >= 2 && cluster < fs->fs_nclusters);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_unreserve
+ *
+ * Description:
+ *   Release the clusters that were allocated beyond the end of the file by
+ *   fat_reserve() or by writes with CONFIG_FAT_ALLOC_EXTENT > 1.
+ *
+ * Assumptions:
+ *   The caller holds the mountpoint semaphore.
+ *
+ ****************************************************************************/
+
+int fat_unreserve(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff)
+{
+  FAR uint8_t *direntry;
+  int ret;
 
-      /* No longer dirty */
+  if ((ff->ff_bflags & FFBUFF_PREALLOC) == 0 || ff->ff_startcluster == 0)
+    {
+      return OK;
+    }
+
+  /* Read the directory entry into the fs_buffer */
+
+  ret = fat_fscacheread(fs, ff->ff_dirsector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  direntry = &fs->fs_buffer[(ff->ff_dirindex & DIRSEC_NDXMASK(fs)) *
+                            DIR_SIZE];
+
+  /* Then cut the cluster chain at the end of the file */
+
+  if (ff->ff_size == 0)
+    {
+      ret = fat_dirtruncate(fs, direntry);
+      ff->ff_startcluster = 0;
+    }
+  else
+    {
+      ret = fat_dirshrink(fs, direntry, ff->ff_size);
+    }
 
-      fs->fs_dirty = false;
+  if (ret < 0)
+    {
+      return ret;
     }
 
+  ff->ff_bflags &= ~FFBUFF_PREALLOC;
+  return fat_updatefsinfo(fs);
+}
+
+/****************************************************************************
+ * Name: fat_bmap
+ *
+ * Description:
+ *   Map the file offset bmap->offset to the sector of the block driver
+ *   that holds it, and return how many bytes of the file are stored in
+ *   consecutive sectors from there.  See FIOC_BMAP.  The dirty sector of
+ *   the file buffer is written first, so that the block driver holds the
+ *   current data.
+ *
+ * Assumptions:
+ *   The caller holds the mountpoint semaphore.
+ *
+ ****************************************************************************/
+
+int fat_bmap(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+             FAR struct file_bmap_s *bmap)
+{
+  off_t    clustersize;
+  off_t    position;
+  off_t    sector;
+  int32_t  cluster;
+  int32_t  next;
+  int      ret;
+
+  if (bmap->offset < 0 || bmap->offset >= ff->ff_size ||
+      (bmap->offset & SEC_NDXMASK(fs)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = fat_ffcacheflush(fs, ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Find the cluster that holds the offset.  'position' is the file offset
+   * at the end of that cluster.
+   */
+
+  clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  cluster     = ff->ff_startcluster;
+  position    = clustersize;
+
+  for (; ; )
+    {
+      if (cluster < 2 || cluster >= fs->fs_nclusters)
+        {
+          return -EIO;
+        }
+
+      if (position > bmap->offset)
+        {
+          break;
+        }
+
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 0)
+        {
+          return cluster;
+        }
+
+      position += clustersize;
+    }
+
+  sector = fat_cluster2sector(fs, cluster);
+  if (sector < 0)
+    {
+      return sector;
+    }
+
+  bmap->blkdriver = fs->fs_blkdriver;
+  bmap->sector    = sector + SEC_NSECTORS(fs, bmap->offset -
+                                              (position - clustersize));
+  bmap->sectsize  = fs->fs_hwsectorsize;
+
+  /* Then follow the chain while the clusters are consecutive */
+
+  while (position < ff->ff_size)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster   = next;
+      position += clustersize;
+    }
+
+  bmap->nbytes = MIN(position, ff->ff_size) - bmap->offset;
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscacheflush
+ *
+ * Description:
+ *   Write back all dirty sectors of the sector cache
+ *
+ ****************************************************************************/
+
+int fat_fscacheflush(struct fat_mountpt_s *fs)
+{
+  int ret = OK;
+  int i;
+
+  fat_fscachesave(fs);
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      if (fs->fs_cache[i].cs_dirty)
+        {
+          ret = fat_fscachewrite(fs, &fs->fs_cache[i]);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+
+  fat_fscacheselect(fs, fs->fs_cacheslot);
+  return ret;
+}
+
 /****************************************************************************
  * Name: fat_fscacheread
  *
  * Description:
- *   Read the specified sector into the sector cache, flushing any existing
- *   dirty sectors as necessary.
+ *   Make the specified sector the current sector of the sector cache,
+ *   reading it from the media (and replacing the least recently used
+ *   sector) if it is not already cached.
  *
  ****************************************************************************/
 
 int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 {
-  int ret;
+  int slot;
+  int ret = OK;
 
   /* fs->fs_currentsector holds the current sector that is buffered in
    * fs->fs_buffer. If the requested sector is the same as this sector, then
-   * we do nothing. Otherwise, we will have to read the new sector.
+   * we do nothing.
    */
 
-  if (fs->fs_currentsector != sector)
+  if (fs->fs_currentsector == sector)
     {
-      /* We will need to read the new sector.  First, flush the cached
-       * sector if it is dirty.
-       */
+      return OK;
+    }
 
-      ret = fat_fscacheflush(fs);
-      if (ret < 0)
+  /* Otherwise, check if the sector is elsewhere in the cache.  If not, we
+   * will have to read it into a free sector of the cache.
+   */
+
+  fat_fscachesave(fs);
+
+  slot = fat_fscachefind(fs, sector);
+  if (slot < 0)
+    {
+      slot = fat_fscachevictim(fs);
+      if (slot < 0)
         {
-          return ret;
+          return slot;
         }
 
-      /* Then read the specified sector into the cache */
-
-      ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
-      if (ret < 0)
+      ret = fat_hwread(fs, fs->fs_cache[slot].cs_buffer, sector, 1);
+      if (ret >= 0)
         {
-          return ret;
+          fs->fs_cache[slot].cs_sector = sector;
         }
+    }
 
-      /* Update the cached sector number */
+  fat_fscacheselect(fs, slot);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_fscachezero
+ *
+ * Description:
+ *   Make the specified sector the current sector of the sector cache with
+ *   all-zero content, without reading it from the media.  The caller fills
+ *   in the sector and either marks it dirty or writes it to the media.
+ *
+ ****************************************************************************/
+
+int fat_fscachezero(struct fat_mountpt_s *fs, off_t sector)
+{
+  FAR struct fat_cachesect_s *cs;
+  int slot;
 
-      fs->fs_currentsector = sector;
+  fat_fscachesave(fs);
+
+  slot = fat_fscachefind(fs, sector);
+  if (slot < 0)
+    {
+      slot = fat_fscachevictim(fs);
+      if (slot < 0)
+        {
+          return slot;
+        }
     }
 
+  cs            = &fs->fs_cache[slot];
+  cs->cs_sector = sector;
+  cs->cs_dirty  = false;
+  memset(cs->cs_buffer, 0, fs->fs_hwsectorsize);
+
+  fat_fscacheselect(fs, slot);
   return OK;
 }
 
@@ -2012,7 +2658,12 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
         {
           /* Create an image of the FSINFO sector in the fs_buffer */
 
-          memset(fs->fs_buffer, 0, fs->fs_hwsectorsize);
+          ret = fat_fscachezero(fs, fs->fs_fsinfo);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
           FSI_PUTLEADSIG(fs->fs_buffer, 0x41615252);
           FSI_PUTSTRUCTSIG(fs->fs_buffer, 0x61417272);
           FSI_PUTFREECOUNT(fs->fs_buffer, fs->fs_fsifreecount);
@@ -2021,9 +2672,8 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 
           /* Then flush this to disk */
 
-          fs->fs_currentsector = fs->fs_fsinfo;
-          fs->fs_dirty         = true;
-          ret                  = fat_fscacheflush(fs);
+          fs->fs_dirty = true;
+          ret          = fat_fscacheflush(fs);
 
           /* No longer dirty */
 
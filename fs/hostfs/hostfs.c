@@ -52,6 +52,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
@@ -262,6 +263,400 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+/****************************************************************************
+ * Name: hostfs_flush
+ *
+ * Description:
+ *   Write back any buffered write data and discard any read-ahead data.
+ *   On return, the host file position is the file position seen by the
+ *   caller and the file buffer is empty.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+static int hostfs_flush(FAR struct hostfs_ofile_s *hf)
+{
+  ssize_t nwritten;
+  off_t pos;
+  int ret = OK;
+
+  if (hf->buffer == NULL || hf->buflen == 0)
+    {
+      return OK;
+    }
+
+  if (hf->dirty)
+    {
+      uint16_t offset = 0;
+
+      while (offset < hf->buflen)
+        {
+          nwritten = host_write(hf->fd, &hf->buffer[offset],
+                                hf->buflen - offset);
+          if (nwritten <= 0)
+            {
+              ret = nwritten < 0 ? (int)nwritten : -EIO;
+              break;
+            }
+
+          offset += nwritten;
+        }
+
+      /* The data that could not be written is lost */
+
+      hf->bufpos += offset;
+      hf->dirty   = false;
+    }
+  else if (hf->bufoff < hf->buflen)
+    {
+      /* Move the host file position back to the caller's position */
+
+      pos = hf->bufpos + hf->bufoff;
+      if (host_lseek(hf->fd, pos, SEEK_SET) < 0)
+        {
+          ret = -EIO;
+        }
+
+      hf->bufpos = pos;
+    }
+  else
+    {
+      hf->bufpos += hf->buflen;
+    }
+
+  hf->buflen = 0;
+  hf->bufoff = 0;
+  return ret;
+}
+#else
+#  define hostfs_flush(hf) (OK)
+#endif
+
+/****************************************************************************
+ * Name: hostfs_flushall
+ *
+ * Description:
+ *   Write back the buffered write data of all open files so that the host
+ *   reports up-to-date file sizes.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+static void hostfs_flushall(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_ofile_s *hf;
+
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      if (hf->dirty)
+        {
+          hostfs_flush(hf);
+        }
+    }
+}
+#else
+#  define hostfs_flushall(fs)
+#endif
+
+/****************************************************************************
+ * Name: hostfs_bufread
+ *
+ * Description:
+ *   Read through the file buffer.  Small reads are satisfied from the
+ *   read-ahead data, which is refilled with one host call per buffer.
+ *   Large reads go directly to the caller's buffer.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+static ssize_t hostfs_bufread(FAR struct hostfs_ofile_s *hf,
+                              FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret;
+  size_t ncopy;
+  int err;
+
+  /* Write back any buffered write data first */
+
+  if (hf->dirty)
+    {
+      err = hostfs_flush(hf);
+      if (err < 0)
+        {
+          return err;
+        }
+    }
+
+  while (buflen > 0)
+    {
+      /* Copy what is available in the read-ahead data */
+
+      ncopy = hf->buflen - hf->bufoff;
+      if (ncopy > 0)
+        {
+          if (ncopy > buflen)
+            {
+              ncopy = buflen;
+            }
+
+          memcpy(buffer, &hf->buffer[hf->bufoff], ncopy);
+          hf->bufoff += ncopy;
+          buffer     += ncopy;
+          buflen     -= ncopy;
+          nread      += ncopy;
+          continue;
+        }
+
+      /* The read-ahead data is exhausted.  The host file position is now
+       * the caller's position.
+       */
+
+      hf->bufpos += hf->buflen;
+      hf->buflen  = 0;
+      hf->bufoff  = 0;
+
+      if (buflen >= CONFIG_FS_HOSTFS_BUFFERSIZE)
+        {
+          /* Read the large remainder directly */
+
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              hf->bufpos += ret;
+              nread      += ret;
+            }
+          else if (nread == 0)
+            {
+              nread = ret;
+            }
+
+          break;
+        }
+
+      /* Refill the read-ahead data */
+
+      ret = host_read(hf->fd, hf->buffer, CONFIG_FS_HOSTFS_BUFFERSIZE);
+      if (ret <= 0)
+        {
+          if (nread == 0)
+            {
+              nread = ret;
+            }
+
+          break;
+        }
+
+      hf->buflen = ret;
+    }
+
+  return nread;
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_bufwrite
+ *
+ * Description:
+ *   Write through the file buffer.  Small writes are collected and written
+ *   back with one host call per buffer.  Large writes go directly to the
+ *   host.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+static ssize_t hostfs_bufwrite(FAR struct hostfs_ofile_s *hf,
+                               FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
+  int err;
+
+  /* Discard any read-ahead data.  If the write does not fit into the
+   * buffer, write back the buffered data.
+   */
+
+  if ((!hf->dirty && hf->buflen > 0) ||
+      hf->buflen + buflen > CONFIG_FS_HOSTFS_BUFFERSIZE)
+    {
+      err = hostfs_flush(hf);
+      if (err < 0)
+        {
+          return err;
+        }
+    }
+
+  if (buflen >= CONFIG_FS_HOSTFS_BUFFERSIZE)
+    {
+      /* Write the large data directly */
+
+      ret = host_write(hf->fd, buffer, buflen);
+      if (ret > 0)
+        {
+          hf->bufpos += ret;
+        }
+
+      return ret;
+    }
+
+  memcpy(&hf->buffer[hf->buflen], buffer, buflen);
+  hf->buflen += buflen;
+  hf->bufoff  = hf->buflen;
+  hf->dirty   = true;
+  return buflen;
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attr_invalidate
+ *
+ * Description:
+ *   Discard all cached stat() results.  This is called whenever the volume
+ *   is modified.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+static void hostfs_attr_invalidate(FAR struct hostfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      if (fs->fs_attr[i].path != NULL)
+        {
+          kmm_free(fs->fs_attr[i].path);
+          fs->fs_attr[i].path = NULL;
+        }
+    }
+}
+#else
+#  define hostfs_attr_invalidate(fs)
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attr_lookup
+ *
+ * Description:
+ *   Look up a cached stat() result that has not yet expired.  Returns NULL
+ *   if there is none.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+static FAR struct hostfs_attr_s *
+hostfs_attr_lookup(FAR struct hostfs_mountpt_s *fs, FAR const char *relpath)
+{
+  FAR struct hostfs_attr_s *attr;
+  clock_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      attr = &fs->fs_attr[i];
+      if (attr->path != NULL && strcmp(attr->path, relpath) == 0)
+        {
+          if (now - attr->time < MSEC2TICK(CONFIG_FS_HOSTFS_ATTRCACHE_MSEC))
+            {
+              return attr;
+            }
+
+          /* Expired.  The entry will be refreshed by hostfs_attr_update(). */
+
+          break;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attr_update
+ *
+ * Description:
+ *   Remember the result of a host stat() call.  Only success and -ENOENT
+ *   are cached.
+ *
+ * Assumptions:
+ *   The caller holds the volume semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+static void hostfs_attr_update(FAR struct hostfs_mountpt_s *fs,
+                               FAR const char *relpath, int ret,
+                               FAR const struct stat *buf)
+{
+  FAR struct hostfs_attr_s *attr;
+  FAR char *path;
+  int i;
+
+  if (ret != OK && ret != -ENOENT)
+    {
+      return;
+    }
+
+  /* Re-use the entry of an expired result for the same path */
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      attr = &fs->fs_attr[i];
+      if (attr->path != NULL && strcmp(attr->path, relpath) == 0)
+        {
+          goto found;
+        }
+    }
+
+  path = strdup(relpath);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  /* Otherwise, replace the entries in round-robin order */
+
+  attr = &fs->fs_attr[fs->fs_attrnext];
+  if (++fs->fs_attrnext >= CONFIG_FS_HOSTFS_ATTRCACHE)
+    {
+      fs->fs_attrnext = 0;
+    }
+
+  if (attr->path != NULL)
+    {
+      kmm_free(attr->path);
+    }
+
+  attr->path = path;
+
+found:
+  attr->time = clock_systimer();
+  attr->ret  = ret;
+
+  if (ret == OK)
+    {
+      memcpy(&attr->buf, buf, sizeof(struct stat));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -301,6 +696,24 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+  /* Allocate the file buffer.  Files opened for append are not buffered:
+   * The host decides where the data is written.  The file is still usable
+   * without the buffer if the allocation fails.
+   */
+
+  hf->buffer = NULL;
+  hf->bufpos = 0;
+  hf->buflen = 0;
+  hf->bufoff = 0;
+  hf->dirty  = false;
+
+  if ((oflags & O_APPEND) == 0)
+    {
+      hf->buffer = (FAR uint8_t *)kmm_malloc(CONFIG_FS_HOSTFS_BUFFERSIZE);
+    }
+#endif
+
   /* Append to the host's root directory */
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
@@ -329,10 +742,18 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
         }
       else
         {
+          host_close(hf->fd);
           goto errout_with_buffer;
         }
     }
 
+  /* Creating or truncating the file changes its attributes */
+
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_attr_invalidate(fs);
+    }
+
   /* Attach the private date to the struct file instance */
 
   filep->f_priv = hf;
@@ -352,6 +773,13 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
   goto errout_with_semaphore;
 
 errout_with_buffer:
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      kmm_free(hf->buffer);
+    }
+
+#endif
   kmm_free(hf);
 
 errout_with_semaphore:
@@ -434,13 +862,26 @@ static int hostfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Write back any buffered data and close the host file */
 
+  hostfs_flush(hf);
   host_close(hf->fd);
 
+  if ((hf->oflags & O_WROK) != 0)
+    {
+      hostfs_attr_invalidate(fs);
+    }
+
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      kmm_free(hf->buffer);
+    }
+
+#endif
   kmm_free(hf);
 
 okout:
@@ -476,6 +917,20 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      ret = hostfs_bufread(hf, buffer, buflen);
+      if (ret >= 0)
+        {
+          filep->f_pos = hf->bufpos + hf->bufoff;
+        }
+
+      hostfs_semgive(fs);
+      return ret;
+    }
+#endif
+
   /* Call the host to perform the read */
 
   ret = host_read(hf->fd, buffer, buflen);
@@ -538,6 +993,21 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
+  hostfs_attr_invalidate(fs);
+
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      ret = hostfs_bufwrite(hf, buffer, buflen);
+      if (ret >= 0)
+        {
+          filep->f_pos = hf->bufpos + hf->bufoff;
+        }
+
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = host_write(hf->fd, buffer, buflen);
@@ -578,12 +1048,55 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      off_t curpos = hf->bufpos + hf->bufoff;
+      off_t newpos = -1;
+
+      if (whence == SEEK_SET)
+        {
+          newpos = offset;
+        }
+      else if (whence == SEEK_CUR)
+        {
+          newpos = curpos + offset;
+        }
+
+      /* Seeking to the current position or within the read-ahead data
+       * does not require the host.
+       */
+
+      if (newpos == curpos ||
+          (!hf->dirty && newpos >= hf->bufpos &&
+           newpos <= hf->bufpos + hf->buflen))
+        {
+          hf->bufoff   = newpos - hf->bufpos;
+          filep->f_pos = newpos;
+          hostfs_semgive(fs);
+          return newpos;
+        }
+
+      /* Otherwise, bring the host file position up to date first */
+
+      ret = hostfs_flush(hf);
+      if (ret < 0)
+        {
+          hostfs_semgive(fs);
+          return ret;
+        }
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, offset, whence);
   if (ret >= 0)
     {
       filep->f_pos = ret;
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+      hf->bufpos   = ret;
+#endif
     }
 
   hostfs_semgive(fs);
@@ -619,6 +1132,7 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
+  hostfs_flush(hf);
   ret = host_ioctl(hf->fd, cmd, arg);
 
   hostfs_semgive(fs);
@@ -655,6 +1169,7 @@ static int hostfs_sync(FAR struct file *filep)
 
   hostfs_semtake(fs);
 
+  hostfs_flush(hf);
   host_sync(hf->fd);
 
   hostfs_semgive(fs);
@@ -725,9 +1240,15 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   hostfs_semtake(fs);
 
-  /* Call the host to perform the read */
+  /* Write back any buffered data so that the size is up to date, then
+   * call the host to perform the fstat.
+   */
 
-  ret = host_fstat(hf->fd, buf);
+  ret = hostfs_flush(hf);
+  if (ret >= 0)
+    {
+      ret = host_fstat(hf->fd, buf);
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -768,7 +1289,13 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = host_ftruncate(hf->fd, length);
+  ret = hostfs_flush(hf);
+  if (ret >= 0)
+    {
+      ret = host_ftruncate(hf->fd, length);
+    }
+
+  hostfs_attr_invalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1051,6 +1578,7 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return (flags != 0) ? -ENOSYS : -EBUSY;
     }
 
+  hostfs_attr_invalidate(fs);
   hostfs_semgive(fs);
   kmm_free(fs);
   return ret;
@@ -1118,6 +1646,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_attr_invalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1154,6 +1683,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_attr_invalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1191,6 +1721,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_attr_invalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1231,6 +1762,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_attr_invalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1247,6 +1779,9 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                        FAR struct stat *buf)
 {
   FAR struct hostfs_mountpt_s *fs;
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  FAR struct hostfs_attr_s *attr;
+#endif
   char path[HOSTFS_MAX_PATH];
   int ret;
 
@@ -1260,6 +1795,29 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  /* Check for a recent result */
+
+  attr = hostfs_attr_lookup(fs, relpath);
+  if (attr != NULL)
+    {
+      ret = attr->ret;
+      if (ret == OK)
+        {
+          memcpy(buf, &attr->buf, sizeof(struct stat));
+        }
+
+      hostfs_semgive(fs);
+      return ret;
+    }
+#endif
+
+  /* Write back any buffered data so that the host reports the correct
+   * file sizes.
+   */
+
+  hostfs_flushall(fs);
+
   /* Append to the host's root directory */
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
@@ -1268,6 +1826,10 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = host_stat(path, buf);
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  hostfs_attr_update(fs, relpath, ret, buf);
+#endif
+
   hostfs_semgive(fs);
   return ret;
 }
@@ -43,9 +43,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -63,6 +65,18 @@
 
 #define HOSTFS_MAX_PATH     256
 
+#ifndef CONFIG_FS_HOSTFS_BUFFERSIZE
+#  define CONFIG_FS_HOSTFS_BUFFERSIZE 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE
+#  define CONFIG_FS_HOSTFS_ATTRCACHE 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE_MSEC
+#  define CONFIG_FS_HOSTFS_ATTRCACHE_MSEC 1000
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,8 +91,38 @@ struct hostfs_ofile_s
   int16_t                   crefs;      /* Reference count */
   mode_t                    oflags;     /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFFERSIZE > 0
+
+  /* The file buffer holds either read-ahead data or write-back data.
+   *
+   * Read-ahead:  buffer[0..buflen) holds the file data at bufpos.  bufoff
+   *   bytes have been consumed.  The host file position is bufpos + buflen.
+   * Write-back:  buffer[0..buflen) holds the data to be written at bufpos
+   *   and bufoff == buflen.  The host file position is bufpos.
+   *
+   * In both cases, the file position seen by the caller is bufpos + bufoff.
+   */
+
+  FAR uint8_t              *buffer;     /* File buffer or NULL */
+  off_t                     bufpos;     /* File position of buffer[0] */
+  uint16_t                  buflen;     /* Number of valid bytes in buffer */
+  uint16_t                  bufoff;     /* Current offset into buffer */
+  bool                      dirty;      /* True: Write-back data */
+#endif
 };
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+/* This structure describes one cached stat() result */
+
+struct hostfs_attr_s
+{
+  FAR char                 *path;       /* Relative path (strdup'ed) */
+  clock_t                   time;       /* Time when the entry was filled */
+  int                       ret;        /* OK or -ENOENT */
+  struct stat               buf;        /* The cached result if OK */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a hostfs filesystem.
@@ -89,6 +133,10 @@ struct hostfs_mountpt_s
   sem_t                      *fs_sem;       /* Used to assure thread-safe access */
   FAR struct hostfs_ofile_s  *fs_head;      /* A singly-linked list of open files */
   char                        fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  uint8_t                     fs_attrnext;  /* Next attribute entry to replace */
+  struct hostfs_attr_s        fs_attr[CONFIG_FS_HOSTFS_ATTRCACHE];
+#endif
 };
 
 /****************************************************************************
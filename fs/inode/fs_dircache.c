@@ -0,0 +1,206 @@
+/****************************************************************************
+ * fs/inode/fs_dircache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/fs/dircache.h>
+
+#ifdef CONFIG_FS_DIRCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* FNV-1a hash.  It can be computed incrementally while scanning the path
+ * so that the hashes of all prefixes are obtained in one pass.
+ */
+
+#define DIRCACHE_FNV_BASIS 2166136261u
+#define DIRCACHE_FNV_PRIME 16777619u
+
+#define DIRCACHE_HASH(h,c) (((h) ^ (uint8_t)(c)) * DIRCACHE_FNV_PRIME)
+
+/* The number of the deepest prefixes that are probed */
+
+#define DIRCACHE_MAXDEPTH  8
+
+#define DIRCACHE_INDEX(h)  ((h) & (CONFIG_FS_DIRCACHE_NENTRIES - 1))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dircache_probe
+ ****************************************************************************/
+
+static FAR struct dircache_entry_s *
+dircache_probe(FAR struct dircache_s *dc, FAR const char *path, size_t len,
+               uint32_t hash)
+{
+  FAR struct dircache_entry_s *entry = &dc->entries[DIRCACHE_INDEX(hash)];
+
+  if (entry->len == len && entry->hash == hash &&
+      memcmp(entry->path, path, len) == 0)
+    {
+      return entry;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dircache_flush
+ *
+ * Description:
+ *   Discard all entries.  Called when the directory tree changes in some way
+ *   that could make an entry stale (rename, directory removal, unmount).
+ *
+ ****************************************************************************/
+
+void dircache_flush(FAR struct dircache_s *dc)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_DIRCACHE_NENTRIES; i++)
+    {
+      dc->entries[i].len = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: dircache_add
+ *
+ * Description:
+ *   Remember the directory at 'path' (the first 'len' bytes).  Paths that
+ *   are too long to be cached are ignored.
+ *
+ ****************************************************************************/
+
+void dircache_add(FAR struct dircache_s *dc, FAR const char *path,
+                  size_t len, uintptr_t value)
+{
+  FAR struct dircache_entry_s *entry;
+  uint32_t hash = DIRCACHE_FNV_BASIS;
+  size_t i;
+
+  if (len == 0 || len > CONFIG_FS_DIRCACHE_PATHLEN)
+    {
+      return;
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      hash = DIRCACHE_HASH(hash, path[i]);
+    }
+
+  /* Replace whatever was in the slot */
+
+  entry        = &dc->entries[DIRCACHE_INDEX(hash)];
+  entry->value = value;
+  entry->hash  = hash;
+  entry->len   = (uint8_t)len;
+  memcpy(entry->path, path, len);
+}
+
+/****************************************************************************
+ * Name: dircache_lookup
+ *
+ * Description:
+ *   Find the longest directory prefix of 'path' that is in the cache.  Only
+ *   prefixes that end before a '/' are considered, so the final component
+ *   of the path is never matched.
+ *
+ * Returned Value:
+ *   The length of the matching prefix, with the cached value in 'value', or
+ *   zero if there is no match.
+ *
+ ****************************************************************************/
+
+size_t dircache_lookup(FAR struct dircache_s *dc, FAR const char *path,
+                       FAR uintptr_t *value)
+{
+  FAR struct dircache_entry_s *entry;
+  uint32_t hashes[DIRCACHE_MAXDEPTH];
+  size_t lens[DIRCACHE_MAXDEPTH];
+  uint32_t hash = DIRCACHE_FNV_BASIS;
+  int nprefix = 0;
+  size_t i;
+  int j;
+
+  /* Hash all directory prefixes in one pass, keeping the deepest ones */
+
+  for (i = 0; path[i] != '\0' && i <= CONFIG_FS_DIRCACHE_PATHLEN; i++)
+    {
+      if (path[i] == '/' && i > 0)
+        {
+          j         = nprefix % DIRCACHE_MAXDEPTH;
+          lens[j]   = i;
+          hashes[j] = hash;
+          nprefix++;
+        }
+
+      hash = DIRCACHE_HASH(hash, path[i]);
+    }
+
+  /* Then probe, starting with the deepest prefix */
+
+  for (j = nprefix - 1; j >= 0 && j >= nprefix - DIRCACHE_MAXDEPTH; j--)
+    {
+      int k = j % DIRCACHE_MAXDEPTH;
+
+      entry = dircache_probe(dc, path, lens[k], hashes[k]);
+      if (entry != NULL)
+        {
+          *value = entry->value;
+          return lens[k];
+        }
+    }
+
+  return 0;
+}
+
+#endif /* CONFIG_FS_DIRCACHE */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * fs/inode/fs_fileclose.c
  *
- *   Copyright (C) 2016-2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016-2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -80,6 +80,12 @@ int file_close(FAR struct file *filep)
 
   if (inode)
     {
+#ifdef CONFIG_FS_POLL_CACHE
+      /* Drop the poll registrations cached for the file */
+
+      poll_cache_close(filep);
+#endif
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
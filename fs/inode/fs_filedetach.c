@@ -160,6 +160,7 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_pos    = 0;
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
+  list->fl_used[fd >> 5] &= ~((uint32_t)1 << (fd & 31));
 
   _files_semgive(list);
   return OK;
@@ -1,8 +1,8 @@
 /****************************************************************************
  * fs/inode/fs_files.c
  *
- *   Copyright (C) 2007-2009, 2011-2013, 2016-2017 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2007-2009, 2011-2013, 2016-2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,6 +42,7 @@
 
 #include <sys/types.h>
 #include <string.h>
+#include <strings.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <sched.h>
@@ -85,6 +86,32 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_setused
+ *
+ * Description:
+ *   Update the bit of the file descriptor in the set of used descriptors
+ *   to match the state of the file structure.
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static void _files_setused(FAR struct filelist *list, int fd)
+{
+  uint32_t bit = (uint32_t)1 << (fd & 31);
+
+  if (list->fl_files[fd].f_inode != NULL)
+    {
+      list->fl_used[fd >> 5] |= bit;
+    }
+  else
+    {
+      list->fl_used[fd >> 5] &= ~bit;
+    }
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -105,6 +132,12 @@ static int _files_close(FAR struct file *filep)
 
   if (inode)
     {
+#ifdef CONFIG_FS_POLL_CACHE
+      /* Drop the poll registrations cached for the file */
+
+      poll_cache_close(filep);
+#endif
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -158,6 +191,7 @@ void files_initlist(FAR struct filelist *list)
   /* Initialize the list access mutex */
 
   (void)nxsem_init(&list->fl_sem, 0, 1);
+  memset(list->fl_used, 0, sizeof(list->fl_used));
 }
 
 /****************************************************************************
@@ -210,6 +244,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 {
   FAR struct filelist *list;
   FAR struct inode *inode;
+  int fd = -1;
   int ret;
 
   if (!filep1 || !filep1->f_inode || !filep2)
@@ -229,6 +264,16 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
   if (list != NULL)
     {
       _files_semtake(list);
+
+      /* Is the new file structure in our list?  (It is not when the files
+       * of a new task are being duplicated).
+       */
+
+      if (filep2 >= &list->fl_files[0] &&
+          filep2 < &list->fl_files[CONFIG_NFILE_DESCRIPTORS])
+        {
+          fd = filep2 - &list->fl_files[0];
+        }
     }
 
   /* If there is already an inode contained in the new file structure,
@@ -285,6 +330,11 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 
   if (list != NULL)
     {
+      if (fd >= 0)
+        {
+          _files_setused(list, fd);
+        }
+
       _files_semgive(list);
     }
 
@@ -302,6 +352,11 @@ errout_with_inode:
 errout_with_sem:
   if (list != NULL)
     {
+      if (fd >= 0)
+        {
+          _files_setused(list, fd);
+        }
+
       _files_semgive(list);
     }
 
@@ -315,11 +370,16 @@ errout_with_sem:
  *   Allocate a struct files instance and associate it with an inode instance.
  *   Returns the file descriptor == index into the files array.
  *
+ *   The lowest free descriptor is found in the set of used descriptors, 32
+ *   descriptors at a time.
+ *
  ****************************************************************************/
 
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
+  uint32_t avail;
+  int word;
   int i;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
@@ -327,15 +387,47 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  if (minfd < 0)
+    {
+      minfd = 0;
+    }
+
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (word = minfd >> 5; word < FILELIST_NWORDS; word++)
     {
-      if (!list->fl_files[i].f_inode)
+      /* Free descriptors in this word, ignoring those below minfd */
+
+      avail = ~list->fl_used[word];
+      if (word == (minfd >> 5))
+        {
+          avail &= ~(((uint32_t)1 << (minfd & 31)) - 1);
+        }
+
+      while (avail != 0)
         {
+          i      = (word << 5) + ffs((int)avail) - 1;
+          avail &= avail - 1;
+
+          if (i >= CONFIG_NFILE_DESCRIPTORS)
+            {
+              break;
+            }
+
+          /* The files of a new task are duplicated without updating the
+           * set of used descriptors.  Catch up with that here.
+           */
+
+          if (list->fl_files[i].f_inode != NULL)
+            {
+              _files_setused(list, i);
+              continue;
+            }
+
           list->fl_files[i].f_oflags = oflags;
           list->fl_files[i].f_pos    = pos;
           list->fl_files[i].f_inode  = inode;
           list->fl_files[i].f_priv   = NULL;
+          _files_setused(list, i);
           _files_semgive(list);
           return i;
         }
@@ -379,6 +471,7 @@ int files_close(int fd)
 
   _files_semtake(list);
   ret = _files_close(&list->fl_files[fd]);
+  _files_setused(list, fd);
   _files_semgive(list);
   return ret;
 }
@@ -405,6 +498,7 @@ void files_release(int fd)
       list->fl_files[fd].f_oflags  = 0;
       list->fl_files[fd].f_pos     = 0;
       list->fl_files[fd].f_inode = NULL;
+      _files_setused(list, fd);
       _files_semgive(list);
     }
 }
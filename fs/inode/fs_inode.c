@@ -40,45 +40,27 @@
 
 #include <nuttx/config.h>
 
-#include <unistd.h>
-#include <semaphore.h>
 #include <assert.h>
-#include <errno.h>
 
+#include <nuttx/rwsem.h>
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
 
 /****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#define NO_HOLDER ((pid_t)-1)
-
-/****************************************************************************
- * Private Types
+ * Private Data
  ****************************************************************************/
 
-/* Implements a re-entrant mutex for inode access.  This must be re-entrant
- * because there can be cycles.  For example, it may be necessary to destroy
- * a block driver inode on umount() after a removable block device has been
- * removed.  In that case umount() holds the inode semaphore, but the block
- * driver may callback to unregister_blockdriver() after the un-mount,
- * requiring the semaphore again.
+/* Controls access to the inode tree.  Readers that only search the tree
+ * may hold the lock at the same time.  The write lock must be re-entrant
+ * because there can be cycles.  For example, it may be necessary to
+ * destroy a block driver inode on umount() after a removable block device
+ * has been removed.  In that case umount() holds the inode lock, but the
+ * block driver may callback to unregister_blockdriver() after the
+ * un-mount, requiring the lock again.
  */
 
-struct inode_sem_s
-{
-  sem_t   sem;     /* The semaphore */
-  pid_t   holder;  /* The current holder of the semaphore */
-  int16_t count;   /* Number of counts held */
-};
-
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-static struct inode_sem_s g_inode_sem;
+static rw_semaphore_t g_inode_lock;
 
 /****************************************************************************
  * Public Functions
@@ -95,13 +77,9 @@ static struct inode_sem_s g_inode_sem;
 
 void inode_initialize(void)
 {
-  /* Initialize the semaphore to one (to support one-at-a-time access to the
-   * inode tree).
-   */
+  /* Initialize the lock that supports access to the inode tree */
 
-  (void)nxsem_init(&g_inode_sem.sem, 0, 1);
-  g_inode_sem.holder = NO_HOLDER;
-  g_inode_sem.count  = 0;
+  (void)nxrwsem_init(&g_inode_lock);
 
   /* Initialize files array (if it is used) */
 
@@ -117,77 +95,65 @@ void inode_initialize(void)
  * Name: inode_semtake
  *
  * Description:
- *   Get exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Get exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
 void inode_semtake(void)
 {
-  pid_t me;
-
-  /* Do we already hold the semaphore? */
-
-  me = getpid();
-  if (me == g_inode_sem.holder)
-    {
-      /* Yes... just increment the count */
-
-      g_inode_sem.count++;
-      DEBUGASSERT(g_inode_sem.count > 0);
-    }
-
-  /* Take the semaphore (perhaps waiting) */
-
-  else
-    {
-      int ret;
-
-      do
-        {
-          ret = nxsem_wait(&g_inode_sem.sem);
-
-          /* The only case that an error should occur here is if the wait
-           * was awakened by a signal.
-           */
+  int ret;
 
-          DEBUGASSERT(ret == OK || ret == -EINTR);
-        }
-      while (ret == -EINTR);
-
-      /* No we hold the semaphore */
+  /* Take the write lock (perhaps waiting).  This cannot be interrupted by
+   * signals.
+   */
 
-      g_inode_sem.holder = me;
-      g_inode_sem.count  = 1;
-    }
+  ret = nxrwsem_wrlock(&g_inode_lock);
+  DEBUGASSERT(ret == OK);
+  UNUSED(ret);
 }
 
 /****************************************************************************
  * Name: inode_semgive
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Relinquish exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
 void inode_semgive(void)
 {
-  DEBUGASSERT(g_inode_sem.holder == getpid());
+  nxrwsem_wrunlock(&g_inode_lock);
+}
 
-  /* Is this our last count on the semaphore? */
+/****************************************************************************
+ * Name: inode_rdlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (g_inode_lock).  The
+ *   tree may be searched, but not modified, while the read lock is held.
+ *   The read lock must not be nested and must not be upgraded by calling
+ *   inode_semtake().
+ *
+ ****************************************************************************/
 
-  if (g_inode_sem.count > 1)
-    {
-      /* No.. just decrement the count */
+void inode_rdlock(void)
+{
+  int ret;
 
-      g_inode_sem.count--;
-    }
+  ret = nxrwsem_rdlock(&g_inode_lock);
+  DEBUGASSERT(ret == OK);
+  UNUSED(ret);
+}
 
-  /* Yes.. then we can really release the semaphore */
+/****************************************************************************
+ * Name: inode_rdunlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (g_inode_lock).
+ *
+ ****************************************************************************/
 
-  else
-    {
-      g_inode_sem.holder = NO_HOLDER;
-      g_inode_sem.count  = 0;
-      nxsem_post(&g_inode_sem.sem);
-    }
+void inode_rdunlock(void)
+{
+  nxrwsem_rdunlock(&g_inode_lock);
 }
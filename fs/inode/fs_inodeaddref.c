@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 #include "inode/inode.h"
 
@@ -58,10 +59,16 @@
 
 void inode_addref(FAR struct inode *inode)
 {
+  irqstate_t flags;
+
   if (inode)
     {
-      inode_semtake();
+      /* Other readers may be incrementing the count at the same time */
+
+      inode_rdlock();
+      flags = enter_critical_section();
       inode->i_crefs++;
-      inode_semgive();
+      leave_critical_section(flags);
+      inode_rdunlock();
     }
 }
@@ -42,6 +42,7 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
@@ -64,13 +65,14 @@
 
 int inode_find(FAR struct inode_search_s *desc)
 {
+  irqstate_t flags;
   int ret;
 
   /* Find the node matching the path.  If found, increment the count of
    * references on the node.
    */
 
-  inode_semtake();
+  inode_rdlock();
   ret = inode_search(desc);
   if (ret >= 0)
     {
@@ -79,11 +81,15 @@ int inode_find(FAR struct inode_search_s *desc)
       FAR struct inode *node = desc->node;
       DEBUGASSERT(node != NULL);
 
-      /* Increment the reference count on the inode */
+      /* Increment the reference count on the inode.  Other readers may be
+       * doing the same.
+       */
 
+      flags = enter_critical_section();
       node->i_crefs++;
+      leave_critical_section(flags);
     }
 
-  inode_semgive();
+  inode_rdunlock();
   return ret;
 }
@@ -117,6 +117,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+      /* The node, and any node below it, may be cached as a directory */
+
+      inode_dircache_flush();
     }
 
   RELEASE_SEARCH(&desc);
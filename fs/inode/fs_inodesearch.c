@@ -45,7 +45,10 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/dircache.h>
 
 #include "inode/inode.h"
 
@@ -66,6 +69,22 @@ static int _inode_search(FAR struct inode_search_s *desc);
 
 FAR struct inode *g_root_inode = NULL;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DIRCACHE
+/* Cache of the directory inodes of the pseudo file system, indexed by path.
+ * Searches may run concurrently under the inode read lock, so the cache has
+ * its own lock.
+ */
+
+static struct dircache_s g_inode_dircache;
+#ifdef CONFIG_SPINLOCK_SCOPED
+static spinlock_t g_inode_dircache_lock SP_SECTION = SP_UNLOCKED;
+#endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -155,7 +174,7 @@ static int _inode_compare(FAR const char *fname, FAR struct inode *node)
  *   link, and (3) return the inode referenced by the soft link.
  *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds the g_inode_lock read or write lock
  *
  ****************************************************************************/
 
@@ -230,7 +249,7 @@ static int _inode_linktarget(FAR struct inode *node,
  *   that link WILL be deferenced unconditionally.
  *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds the g_inode_lock read or write lock
  *
  ****************************************************************************/
 
@@ -241,6 +260,10 @@ static int _inode_search(FAR struct inode_search_s *desc)
   FAR struct inode *left    = NULL;
   FAR struct inode *above   = NULL;
   FAR const char   *relpath = NULL;
+#ifdef CONFIG_FS_DIRCACHE
+  FAR const char   *start;
+  bool              cacheable = true;
+#endif
   int ret = -ENOENT;
 
   /* Get the search path, skipping over the leading '/'.  The leading '/' is
@@ -273,6 +296,37 @@ static int _inode_search(FAR struct inode_search_s *desc)
       return -ENOSYS;
     }
 
+#ifdef CONFIG_FS_DIRCACHE
+  /* Resume the search below the deepest directory of the path that is in
+   * the cache.  Mountpoints are not cached.  The search must examine the
+   * mountpoint itself in order to return its peer and parent.
+   */
+
+  start = name;
+  if (g_root_inode != NULL)
+    {
+      irqstate_t flags;
+      uintptr_t value;
+      size_t len;
+
+      flags = spin_lock_irqsave_scoped(&g_inode_dircache_lock);
+      len   = dircache_lookup(&g_inode_dircache, name, &value);
+      spin_unlock_irqrestore_scoped(&g_inode_dircache_lock, flags);
+
+      if (len > 0)
+        {
+          FAR struct inode *dir = (FAR struct inode *)value;
+
+          if (!INODE_IS_MOUNTPT(dir))
+            {
+              above = dir;
+              node  = dir->i_child;
+              name  = inode_nextname(name + len);
+            }
+        }
+    }
+#endif
+
   /* Traverse the pseudo file system node tree until either (1) all nodes
    * have been examined without finding the matching node, or (2) the
    * matching node is found.
@@ -311,6 +365,10 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
       else
         {
+#ifdef CONFIG_FS_DIRCACHE
+          FAR const char *segend = name + strcspn(name, "/");
+#endif
+
           /* Now there are three remaining possibilities:
            *   (1) This is the node that we are looking for.
            *   (2) The node we are looking for is "below" this one.
@@ -344,6 +402,12 @@ static int _inode_search(FAR struct inode_search_s *desc)
                 {
                   int status;
 
+#ifdef CONFIG_FS_DIRCACHE
+                  /* The rest of the path is relative to the link target */
+
+                  cacheable = false;
+#endif
+
                   /* If this intermediate inode in the is a soft link, then
                    * (1) get the name of the full path of the soft link, (2)
                    * recursively look-up the inode referenced by the soft
@@ -397,6 +461,21 @@ static int _inode_search(FAR struct inode_search_s *desc)
                 }
 #endif
 
+#ifdef CONFIG_FS_DIRCACHE
+              /* Remember this directory for the next search */
+
+              if (cacheable)
+                {
+                  irqstate_t flags;
+
+                  flags = spin_lock_irqsave_scoped(&g_inode_dircache_lock);
+                  dircache_add(&g_inode_dircache, start, segend - start,
+                               (uintptr_t)node);
+                  spin_unlock_irqrestore_scoped(&g_inode_dircache_lock,
+                                                flags);
+                }
+#endif
+
               /* Keep looking at the next level "down" */
 
               above = node;
@@ -435,6 +514,29 @@ static int _inode_search(FAR struct inode_search_s *desc)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: inode_dircache_flush
+ *
+ * Description:
+ *   Discard the cached directory inodes.  This must be called whenever an
+ *   inode is added to or removed from the tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_lock write lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DIRCACHE
+void inode_dircache_flush(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_scoped(&g_inode_dircache_lock);
+  dircache_flush(&g_inode_dircache);
+  spin_unlock_irqrestore_scoped(&g_inode_dircache_lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -455,7 +557,7 @@ static int _inode_search(FAR struct inode_search_s *desc)
  *   that link WILL be deferenced unconditionally.
  *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds the g_inode_lock read or write lock
  *
  ****************************************************************************/
 
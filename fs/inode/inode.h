@@ -1,7 +1,8 @@
 /****************************************************************************
  * fs/inode/inode.h
  *
- *   Copyright (C) 2007, 2009, 2012, 2014, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2009, 2012, 2014, 2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -47,6 +48,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <dirent.h>
+#include <poll.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -184,7 +186,7 @@ void inode_initialize(void);
  * Name: inode_semtake
  *
  * Description:
- *   Get exclusive access to the in-memory inode tree (tree_sem).
+ *   Get exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
@@ -194,12 +196,51 @@ void inode_semtake(void);
  * Name: inode_semgive
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (tree_sem).
+ *   Relinquish exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
 void inode_semgive(void);
 
+/****************************************************************************
+ * Name: inode_rdlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (g_inode_lock).  The
+ *   tree may be searched, but not modified, while the read lock is held.
+ *
+ ****************************************************************************/
+
+void inode_rdlock(void);
+
+/****************************************************************************
+ * Name: inode_rdunlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (g_inode_lock).
+ *
+ ****************************************************************************/
+
+void inode_rdunlock(void);
+
+/****************************************************************************
+ * Name: inode_dircache_flush
+ *
+ * Description:
+ *   Discard the cached directory inodes.  This must be called whenever an
+ *   inode is added to or removed from the tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_lock write lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DIRCACHE
+void inode_dircache_flush(void);
+#else
+#  define inode_dircache_flush()
+#endif
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -220,7 +261,7 @@ void inode_semgive(void);
  *   that link WILL be deferenced unconditionally.
  *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds the g_inode_lock read or write lock
  *
  ****************************************************************************/
 
@@ -424,6 +465,19 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   The poll() operation using the poll cache of the current thread.
+ *   -ENOMEM is returned if the cache cannot be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+int poll_cache(FAR struct pollfd *fds, nfds_t nfds, int timeout);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
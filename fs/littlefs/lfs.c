@@ -421,6 +421,7 @@ static int lfs_alloc(FAR lfs_t *lfs, FAR lfs_block_t *block)
               /* found a free block */
 
               *block = (lfs->free.off + off) % lfs->cfg->block_count;
+              lfs->stats.allocs++;
 
               /* eagerly find next off so an alloc ack can
                * discredit old lookahead blocks
@@ -455,6 +456,8 @@ static int lfs_alloc(FAR lfs_t *lfs, FAR lfs_block_t *block)
       /* find mask of free blocks from tree */
 
       memset(lfs->free.buffer, 0, lfs->cfg->lookahead / 8);
+      lfs->stats.scans++;
+
       int err = lfs_traverse(lfs, lfs_alloc_lookahead, lfs);
       if (err)
         {
@@ -687,6 +690,7 @@ static int lfs_dir_commit(FAR lfs_t *lfs, FAR lfs_dir_t *dir,
   /* increment revision count */
 
   dir->d.rev += 1;
+  lfs->stats.commits++;
 
   /* keep pairs in order such that pair[0] is most recent */
 
@@ -832,6 +836,7 @@ relocate:
       /* Drop caches and prepare to relocate block */
 
       relocated = true;
+      lfs->stats.relocs++;
       lfs_cache_drop(lfs, &lfs->pcache);
 
       /* Can't relocate superblock, filesystem is now frozen */
@@ -1408,6 +1413,7 @@ relocate:
 
       /* Just clear cache and try a new block */
 
+      lfs->stats.relocs++;
       lfs_cache_drop(lfs, &lfs->pcache);
     }
 }
@@ -1476,6 +1482,7 @@ static int lfs_file_relocate(FAR lfs_t *lfs, FAR lfs_file_t *file)
 
 relocate:
   LFS_DEBUG("Bad block at %" PRIu32, file->block);
+  lfs->stats.relocs++;
 
   /* just relocate what exists into new block */
 
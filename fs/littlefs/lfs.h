@@ -379,6 +379,18 @@ typedef struct lfs_free_s
   FAR uint32_t *buffer;
 } lfs_free_t;
 
+/* Allocator and commit statistics.  These accumulate for as long as the
+ * littlefs object exists.
+ */
+
+typedef struct lfs_stats_s
+{
+  uint32_t allocs;      /* Number of blocks allocated */
+  uint32_t scans;       /* Number of lookahead scans of the filesystem */
+  uint32_t commits;     /* Number of directory pair commits */
+  uint32_t relocs;      /* Number of blocks relocated after a bad block */
+} lfs_stats_t;
+
 /* The littlefs type */
 
 typedef struct lfs_s
@@ -393,6 +405,7 @@ typedef struct lfs_s
   lfs_cache_t pcache;
 
   lfs_free_t free;
+  lfs_stats_t stats;
   bool deorphaned;
   bool moving;
 } lfs_t;
@@ -50,12 +50,18 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <queue.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/semaphore.h>
 
@@ -65,10 +71,45 @@
 #include "lfs.h"
 #include "lfs_util.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mount option flags */
+
+#define LITTLEFS_FORCEFORMAT  (1 << 0)  /* -o forceformat */
+#define LITTLEFS_AUTOFORMAT   (1 << 1)  /* -o autoformat */
+
+/* Size of the line buffer used by the procfs entry */
+
+#define LITTLEFS_LINELEN      96
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One read_size unit of the shared read cache */
+
+struct littlefs_rcentry_s
+{
+  lfs_block_t           block;    /* The block that the data belongs to */
+  lfs_off_t             off;      /* The offset of the data in the block */
+  uint32_t              age;      /* Last use, for least recently used */
+  bool                  valid;    /* True: The entry holds data */
+  FAR uint8_t          *buffer;   /* read_size bytes of data */
+};
+
+/* Block device access statistics */
+
+struct littlefs_bdstats_s
+{
+  uint32_t              reads;    /* Number of block device reads */
+  uint32_t              progs;    /* Number of block device programs */
+  uint32_t              erases;   /* Number of block device erases */
+  uint32_t              hits;     /* Reads satisfied by the read cache */
+  uint32_t              misses;   /* Reads that missed the read cache */
+};
+
 /* This structure represents the overall mountpoint state. An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a littlefs filesystem.
@@ -76,13 +117,33 @@
 
 struct littlefs_mountpt_s
 {
+  FAR struct littlefs_mountpt_s *flink;      /* Supports a singly linked list */
   sem_t                 sem;
   FAR struct inode     *drv;
   struct mtd_geometry_s geo;
   struct lfs_config_s   cfg;
   lfs_t                 lfs;
+
+  /* The read cache is shared by the metadata and all open files.  It is
+   * accessed only by the block device callbacks, always with sem held.
+   */
+
+  FAR struct littlefs_rcentry_s *rcache;     /* Array of nrcache entries */
+  int                   nrcache;             /* Number of cache entries */
+  uint32_t              rcage;               /* Incremented on each use */
+  struct littlefs_bdstats_s stats;           /* Block device statistics */
 };
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS)
+/* This structure describes one open fs/littlefs procfs file */
+
+struct littlefs_procfile_s
+{
+  struct procfs_file_s  base;                /* Base open file structure */
+  char                  line[LITTLEFS_LINELEN];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -119,6 +180,10 @@ static int     littlefs_readdir(FAR struct inode *mountpt,
                                 FAR struct fs_dirent_s *dir);
 static int     littlefs_rewinddir(FAR struct inode *mountpt,
                                   FAR struct fs_dirent_s *dir);
+static int     littlefs_getdents(FAR struct inode *mountpt,
+                                 FAR struct fs_dirent_s *dir,
+                                 FAR struct dirent *entries,
+                                 size_t nentries);
 
 static int     littlefs_bind(FAR struct inode *driver,
                              FAR const void *data, FAR void **handle);
@@ -139,6 +204,28 @@ static int     littlefs_rename(FAR struct inode *mountpt,
 static int     littlefs_stat(FAR struct inode *mountpt,
                              FAR const char *relpath, FAR struct stat *buf);
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS)
+static int     littlefs_procfs_open(FAR struct file *filep,
+                                    FAR const char *relpath, int oflags,
+                                    mode_t mode);
+static int     littlefs_procfs_close(FAR struct file *filep);
+static ssize_t littlefs_procfs_read(FAR struct file *filep,
+                                    FAR char *buffer, size_t buflen);
+static int     littlefs_procfs_dup(FAR const struct file *oldp,
+                                   FAR struct file *newp);
+static int     littlefs_procfs_stat(FAR const char *relpath,
+                                    FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of all littlefs mountpoints and the semaphore that protects it */
+
+static sq_queue_t g_littlefs_mounts;
+static sem_t g_littlefs_lock = SEM_INITIALIZER(1);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -175,9 +262,29 @@ const struct mountpt_operations littlefs_operations =
   littlefs_mkdir,         /* mkdir */
   littlefs_rmdir,         /* rmdir */
   littlefs_rename,        /* rename */
-  littlefs_stat           /* stat */
+  littlefs_stat,          /* stat */
+
+  littlefs_getdents       /* getdents */
 };
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS)
+/* See fs_procfs.c -- this structure is explicitly extern'ed there */
+
+const struct procfs_operations littlefs_procfsoperations =
+{
+  littlefs_procfs_open,   /* open */
+  littlefs_procfs_close,  /* close */
+  littlefs_procfs_read,   /* read */
+  NULL,                   /* write */
+  littlefs_procfs_dup,    /* dup */
+  NULL,                   /* opendir */
+  NULL,                   /* closedir */
+  NULL,                   /* readdir */
+  NULL,                   /* rewinddir */
+  littlefs_procfs_stat    /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -717,6 +824,53 @@ static int littlefs_readdir(FAR struct inode *mountpt,
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_getdents
+ *
+ * Description: Read up to 'nentries' directory entries, taking the volume
+ *   semaphore once.
+ *
+ ****************************************************************************/
+
+static int littlefs_getdents(FAR struct inode *mountpt,
+                             FAR struct fs_dirent_s *dir,
+                             FAR struct dirent *entries, size_t nentries)
+{
+  FAR struct littlefs_mountpt_s *fs;
+  FAR struct lfs_dir_s *priv;
+  struct lfs_info_s info;
+  size_t nread = 0;
+  int ret = OK;
+
+  /* Recover our private data from the inode instance */
+
+  priv = dir->u.littlefs;
+  fs   = mountpt->i_private;
+
+  littlefs_semtake(fs);
+  while (nread < nentries)
+    {
+      ret = lfs_dir_read(&fs->lfs, priv, &info);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      entries[nread].d_type = info.type == LFS_TYPE_REG ? DTYPE_FILE :
+                                                          DTYPE_DIRECTORY;
+      strncpy(entries[nread].d_name, info.name, NAME_MAX + 1);
+      nread++;
+    }
+
+  littlefs_semgive(fs);
+
+  /* An error after some entries were read is reported again by the next
+   * call.
+   */
+
+  return ret < 0 && nread == 0 ? ret : (int)nread;
+}
+
 /****************************************************************************
  * Name: littlefs_rewindir
  *
@@ -761,18 +915,18 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
  *
  ****************************************************************************/
 
-static int littlefs_read_block(FAR const struct lfs_config_s *c,
-                               lfs_block_t block, lfs_off_t off,
-                               FAR void *buffer, lfs_size_t size)
+static int littlefs_read_device(FAR struct littlefs_mountpt_s *fs,
+                                lfs_block_t block, lfs_off_t off,
+                                FAR void *buffer, lfs_size_t size)
 {
-  FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
   FAR struct inode *drv = fs->drv;
   int ret;
 
-  block = (block * c->block_size + off) / geo->blocksize;
+  block = (block * fs->cfg.block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  fs->stats.reads++;
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
@@ -785,6 +939,95 @@ static int littlefs_read_block(FAR const struct lfs_config_s *c,
   return ret >= 0 ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_invalidate
+ *
+ * Description:
+ *   Forget any read cache entries in the region [off, off + size) of the
+ *   block.
+ *
+ ****************************************************************************/
+
+static void littlefs_invalidate(FAR struct littlefs_mountpt_s *fs,
+                                lfs_block_t block, lfs_off_t off,
+                                lfs_size_t size)
+{
+  FAR struct littlefs_rcentry_s *entry;
+  int i;
+
+  for (i = 0; i < fs->nrcache; i++)
+    {
+      entry = &fs->rcache[i];
+      if (entry->valid && entry->block == block &&
+          entry->off < off + size && off < entry->off + fs->cfg.read_size)
+        {
+          entry->valid = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: littlefs_read_block
+ *
+ * Description:
+ *   littlefs reads whole read_size units to fill its own caches, both for
+ *   the metadata and for each open file.  Those single unit reads are
+ *   served from the read cache that is shared by the whole mountpoint.
+ *   Larger reads are bulk file data and go straight to the device.
+ *
+ ****************************************************************************/
+
+static int littlefs_read_block(FAR const struct lfs_config_s *c,
+                               lfs_block_t block, lfs_off_t off,
+                               FAR void *buffer, lfs_size_t size)
+{
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  FAR struct littlefs_rcentry_s *victim = NULL;
+  FAR struct littlefs_rcentry_s *entry;
+  int ret;
+  int i;
+
+  if (fs->nrcache == 0 || size != c->read_size)
+    {
+      return littlefs_read_device(fs, block, off, buffer, size);
+    }
+
+  for (i = 0; i < fs->nrcache; i++)
+    {
+      entry = &fs->rcache[i];
+      if (entry->valid && entry->block == block && entry->off == off)
+        {
+          fs->stats.hits++;
+          entry->age = ++fs->rcage;
+          memcpy(buffer, entry->buffer, size);
+          return OK;
+        }
+
+      /* Select an empty entry or else the least recently used one */
+
+      if (victim == NULL || (victim->valid &&
+          (!entry->valid || entry->age < victim->age)))
+        {
+          victim = entry;
+        }
+    }
+
+  fs->stats.misses++;
+  victim->valid = false;
+
+  ret = littlefs_read_device(fs, block, off, victim->buffer, size);
+  if (ret >= 0)
+    {
+      victim->block = block;
+      victim->off   = off;
+      victim->age   = ++fs->rcage;
+      victim->valid = true;
+      memcpy(buffer, victim->buffer, size);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_write_block
  ****************************************************************************/
@@ -798,6 +1041,9 @@ static int littlefs_write_block(FAR const struct lfs_config_s *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  littlefs_invalidate(fs, block, off, size);
+  fs->stats.progs++;
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -824,6 +1070,9 @@ static int littlefs_erase_block(FAR const struct lfs_config_s *c,
   FAR struct inode *drv = fs->drv;
   int ret = OK;
 
+  littlefs_invalidate(fs, block, 0, c->block_size);
+  fs->stats.erases++;
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -858,6 +1107,184 @@ static int littlefs_sync_block(FAR const struct lfs_config_s *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parseopts
+ *
+ * Description:
+ *   Parse the comma separated mount options.  In addition to forceformat
+ *   and autoformat, these override the littlefs configuration:
+ *
+ *     read_size=<bytes>   Unit of reads, a multiple of the device block
+ *     prog_size=<bytes>   Unit of programs, a multiple of read_size
+ *     block_size=<bytes>  Size of a littlefs block, a multiple of prog_size
+ *                         and of the device erase block
+ *     lookahead=<blocks>  Blocks scanned per allocator pass, a multiple of
+ *                         32
+ *     readcache=<units>   Number of read_size units in the read cache
+ *
+ *   Options that are not given are zero on return.
+ *
+ ****************************************************************************/
+
+static int littlefs_parseopts(FAR struct littlefs_mountpt_s *fs,
+                              FAR const char *opts, FAR int *flags)
+{
+  FAR const char *value;
+  FAR char *end;
+  unsigned long num;
+  size_t len;
+
+  *flags      = 0;
+  fs->nrcache = -1;
+
+  while (opts != NULL && *opts != '\0')
+    {
+      len   = strcspn(opts, ",");
+      value = memchr(opts, '=', len);
+
+      if (value == NULL)
+        {
+          if (len == 11 && strncmp(opts, "forceformat", len) == 0)
+            {
+              *flags |= LITTLEFS_FORCEFORMAT;
+            }
+          else if (len == 10 && strncmp(opts, "autoformat", len) == 0)
+            {
+              *flags |= LITTLEFS_AUTOFORMAT;
+            }
+          else
+            {
+              return -EINVAL;
+            }
+        }
+      else
+        {
+          num = strtoul(++value, &end, 0);
+          if (end == value || end != opts + len)
+            {
+              return -EINVAL;
+            }
+
+          len = value - opts - 1;
+          if (len == 9 && strncmp(opts, "read_size", len) == 0)
+            {
+              fs->cfg.read_size = num;
+            }
+          else if (len == 9 && strncmp(opts, "prog_size", len) == 0)
+            {
+              fs->cfg.prog_size = num;
+            }
+          else if (len == 10 && strncmp(opts, "block_size", len) == 0)
+            {
+              fs->cfg.block_size = num;
+            }
+          else if (len == 9 && strncmp(opts, "lookahead", len) == 0)
+            {
+              fs->cfg.lookahead = num;
+            }
+          else if (len == 9 && strncmp(opts, "readcache", len) == 0)
+            {
+              fs->nrcache = num;
+            }
+          else
+            {
+              return -EINVAL;
+            }
+
+          len = end - opts;
+        }
+
+      opts += len;
+      if (*opts == ',')
+        {
+          opts++;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_config
+ *
+ * Description:
+ *   Complete the littlefs configuration with the defaults derived from the
+ *   device geometry, verify it and allocate the read cache.
+ *
+ ****************************************************************************/
+
+static int littlefs_config(FAR struct littlefs_mountpt_s *fs)
+{
+  FAR struct mtd_geometry_s *geo = &fs->geo;
+  FAR struct lfs_config_s *cfg = &fs->cfg;
+  FAR uint8_t *buffer;
+  int i;
+
+  if (cfg->read_size == 0)
+    {
+      cfg->read_size = geo->blocksize;
+    }
+
+  if (cfg->prog_size == 0)
+    {
+      cfg->prog_size = lfs_max(cfg->read_size, geo->blocksize);
+    }
+
+  if (cfg->block_size == 0)
+    {
+      cfg->block_size = geo->erasesize;
+    }
+
+  if (cfg->read_size == 0 || cfg->read_size % geo->blocksize != 0 ||
+      cfg->prog_size % cfg->read_size != 0 ||
+      cfg->block_size % cfg->prog_size != 0 ||
+      cfg->block_size % geo->erasesize != 0)
+    {
+      return -EINVAL;
+    }
+
+  cfg->block_count = geo->neraseblocks / (cfg->block_size / geo->erasesize);
+
+  if (cfg->lookahead == 0)
+    {
+      cfg->lookahead = 32 * ((cfg->block_count + 31) / 32);
+      if (cfg->lookahead > 32 * cfg->read_size)
+        {
+          cfg->lookahead = 32 * cfg->read_size;
+        }
+    }
+  else if (cfg->lookahead % 32 != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Allocate the read cache entries and their data in one chunk */
+
+  if (fs->nrcache < 0)
+    {
+      fs->nrcache = CONFIG_FS_LITTLEFS_READCACHE;
+    }
+
+  if (fs->nrcache > 0)
+    {
+      fs->rcache = kmm_zalloc(fs->nrcache *
+                              (sizeof(struct littlefs_rcentry_s) +
+                               cfg->read_size));
+      if (fs->rcache == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      buffer = (FAR uint8_t *)&fs->rcache[fs->nrcache];
+      for (i = 0; i < fs->nrcache; i++)
+        {
+          fs->rcache[i].buffer = buffer + i * cfg->read_size;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -866,6 +1293,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  int flags;
   int ret;
 
   /* Open the block driver */
@@ -939,15 +1367,18 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.prog        = littlefs_write_block;
   fs->cfg.erase       = littlefs_erase_block;
   fs->cfg.sync        = littlefs_sync_block;
-  fs->cfg.read_size   = fs->geo.blocksize;
-  fs->cfg.prog_size   = fs->geo.blocksize;
-  fs->cfg.block_size  = fs->geo.erasesize;
-  fs->cfg.block_count = fs->geo.neraseblocks;
-  fs->cfg.lookahead   = 32 * ((fs->cfg.block_count + 31) / 32);
 
-  if (fs->cfg.lookahead > 32 * fs->cfg.read_size)
+  /* The mount options may override the defaults of the geometry */
+
+  ret = littlefs_parseopts(fs, data, &flags);
+  if (ret >= 0)
     {
-      fs->cfg.lookahead = 32 * fs->cfg.read_size;
+      ret = littlefs_config(fs);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_fs;
     }
 
   /* Then get information about the littlefs filesystem on the devices
@@ -956,7 +1387,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if ((flags & LITTLEFS_FORCEFORMAT) != 0)
     {
       ret = lfs_format(&fs->lfs, &fs->cfg);
       if (ret < 0)
@@ -970,8 +1401,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != LFS_ERR_CORRUPT ||
-          !data || strcmp(data, "autoformat"))
+      if (ret != LFS_ERR_CORRUPT || (flags & LITTLEFS_AUTOFORMAT) == 0)
         {
           goto errout_with_fs;
         }
@@ -991,12 +1421,19 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
         }
     }
 
+  /* Add the mountpoint to the list reported by procfs */
+
+  nxsem_wait_uninterruptible(&g_littlefs_lock);
+  sq_addlast((FAR sq_entry_t *)fs, &g_littlefs_mounts);
+  nxsem_post(&g_littlefs_lock);
+
   *handle = fs;
   littlefs_semgive(fs);
   return OK;
 
 errout_with_fs:
   nxsem_destroy(&fs->sem);
+  kmm_free(fs->rcache);
   kmm_free(fs);
 errout_with_block:
   if (INODE_IS_BLOCK(driver) && driver->u.i_bops->close)
@@ -1050,7 +1487,12 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+      nxsem_wait_uninterruptible(&g_littlefs_lock);
+      sq_rem((FAR sq_entry_t *)fs, &g_littlefs_mounts);
+      nxsem_post(&g_littlefs_lock);
+
       nxsem_destroy(&fs->sem);
+      kmm_free(fs->rcache);
       kmm_free(fs);
     }
 
@@ -1243,3 +1685,145 @@ static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   return ret;
 }
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS)
+/****************************************************************************
+ * Name: littlefs_procfs_open
+ ****************************************************************************/
+
+static int littlefs_procfs_open(FAR struct file *filep,
+                                FAR const char *relpath, int oflags,
+                                mode_t mode)
+{
+  FAR struct littlefs_procfile_s *procfile;
+
+  /* PROCFS is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (strcmp(relpath, "fs/littlefs") != 0)
+    {
+      return -ENOENT;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct littlefs_procfile_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_close
+ ****************************************************************************/
+
+static int littlefs_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_read
+ *
+ * Description:
+ *   Report one line of statistics for each littlefs mountpoint, identified
+ *   by the name of its driver.
+ *
+ ****************************************************************************/
+
+static ssize_t littlefs_procfs_read(FAR struct file *filep,
+                                    FAR char *buffer, size_t buflen)
+{
+  FAR struct littlefs_procfile_s *procfile = filep->f_priv;
+  FAR struct littlefs_mountpt_s *fs;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset = filep->f_pos;
+
+  DEBUGASSERT(procfile != NULL && buffer != NULL && buflen > 0);
+
+  linesize  = snprintf(procfile->line, LITTLEFS_LINELEN,
+                       "%-12s%8s%8s%8s%8s%8s%8s%8s%8s%8s\n",
+                       "DEVICE", "READS", "PROGS", "ERASES", "HITS",
+                       "MISSES", "ALLOCS", "SCANS", "COMMITS", "RELOCS");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  nxsem_wait_uninterruptible(&g_littlefs_lock);
+  for (fs = (FAR struct littlefs_mountpt_s *)sq_peek(&g_littlefs_mounts);
+       fs != NULL && totalsize < buflen;
+       fs = fs->flink)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, LITTLEFS_LINELEN,
+                            "%-12s%8lu%8lu%8lu%8lu%8lu%8lu%8lu%8lu%8lu\n",
+                            fs->drv->i_name,
+                            (unsigned long)fs->stats.reads,
+                            (unsigned long)fs->stats.progs,
+                            (unsigned long)fs->stats.erases,
+                            (unsigned long)fs->stats.hits,
+                            (unsigned long)fs->stats.misses,
+                            (unsigned long)fs->lfs.stats.allocs,
+                            (unsigned long)fs->lfs.stats.scans,
+                            (unsigned long)fs->lfs.stats.commits,
+                            (unsigned long)fs->lfs.stats.relocs);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  nxsem_post(&g_littlefs_lock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_dup
+ ****************************************************************************/
+
+static int littlefs_procfs_dup(FAR const struct file *oldp,
+                               FAR struct file *newp)
+{
+  FAR struct littlefs_procfile_s *newfile;
+
+  newfile = kmm_malloc(sizeof(struct littlefs_procfile_s));
+  if (newfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newfile, oldp->f_priv, sizeof(struct littlefs_procfile_s));
+  newp->f_priv = newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_stat
+ ****************************************************************************/
+
+static int littlefs_procfs_stat(FAR const char *relpath,
+                                FAR struct stat *buf)
+{
+  if (strcmp(relpath, "fs/littlefs") != 0)
+    {
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif /* CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS */
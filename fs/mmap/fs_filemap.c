@@ -0,0 +1,640 @@
+/****************************************************************************
+ * fs/mmap/fs_filemap.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+
+#include "fs_filemap.h"
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_FS_FILEMAP_NPAGES < 2
+#  error CONFIG_FS_FILEMAP_NPAGES must include the scratch page
+#endif
+
+#if CONFIG_FS_FILEMAP_MAXPAGES > 65535
+#  error CONFIG_FS_FILEMAP_MAXPAGES is too large
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* This is the list of all demand-paged file mappings */
+
+struct fs_allfilemaps_s g_filemaps;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap_freeframe
+ *
+ * Description:
+ *   Unmap a resident page and return its page frame to the page allocator.
+ *   The caller must hold the exclsem.
+ *
+ ****************************************************************************/
+
+static void filemap_freeframe(int ndx)
+{
+  FAR struct fs_filemapframe_s *frame = &g_filemaps.frames[ndx];
+  FAR struct fs_filemap_s *map = frame->map;
+
+  DEBUGASSERT(map != NULL && frame->paddr != 0);
+
+  up_filemap_unmap(map->vaddr + ((uintptr_t)frame->pgndx << MM_PGSHIFT));
+  map->pages[frame->pgndx] = 0;
+
+  mm_pgfree(frame->paddr, 1);
+  frame->map   = NULL;
+  frame->paddr = 0;
+}
+
+/****************************************************************************
+ * Name: filemap_getframe
+ *
+ * Description:
+ *   Get a page frame for a page that is about to be filled.  An unused
+ *   slot in the frame table is used if a physical page can be allocated for
+ *   it.  Otherwise, a resident page of a read-only mapping is evicted.  The
+ *   caller must hold the exclsem.
+ *
+ *   Clean pages are simply discarded since they can always be read again
+ *   from the file.  Pages of writable mappings are never evicted because
+ *   there is no write-back path to the file.
+ *
+ * Returned Value:
+ *   The index of the frame on success; -ENOMEM if no frame is available.
+ *
+ ****************************************************************************/
+
+static int filemap_getframe(void)
+{
+  FAR struct fs_filemapframe_s *frame;
+  FAR struct fs_filemap_s *map;
+  int ndx;
+  int i;
+
+  for (ndx = 0; ndx < CONFIG_FS_FILEMAP_MAXPAGES; ndx++)
+    {
+      frame = &g_filemaps.frames[ndx];
+      if (frame->map == NULL)
+        {
+          frame->paddr = mm_pgalloc(1);
+          if (frame->paddr != 0)
+            {
+              return ndx;
+            }
+
+          break;
+        }
+    }
+
+  /* The budget is exhausted (or physical memory is).  The architecture
+   * interface does not report accessed pages, so the sweep simply evicts
+   * the next clean page after the clock hand, i.e., in FIFO order.
+   */
+
+  for (i = 0; i < CONFIG_FS_FILEMAP_MAXPAGES; i++)
+    {
+      ndx             = g_filemaps.hand;
+      g_filemaps.hand = (ndx + 1) % CONFIG_FS_FILEMAP_MAXPAGES;
+
+      frame = &g_filemaps.frames[ndx];
+      map   = frame->map;
+
+      if (map != NULL && !map->writable)
+        {
+          finfo("Evict vaddr=%08lx\n",
+                (unsigned long)(map->vaddr +
+                                ((uintptr_t)frame->pgndx << MM_PGSHIFT)));
+
+          up_filemap_unmap(map->vaddr +
+                           ((uintptr_t)frame->pgndx << MM_PGSHIFT));
+          map->pages[frame->pgndx] = 0;
+          frame->map = NULL;
+          return ndx;
+        }
+    }
+
+  return -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: filemap_fill
+ *
+ * Description:
+ *   Read one page of file data into a page frame and map the frame at its
+ *   address in the mapping.  The frame is filled through the scratch page
+ *   so that other threads can never see a partially filled page.  The
+ *   caller must hold the exclsem.
+ *
+ ****************************************************************************/
+
+static int filemap_fill(FAR struct fs_filemap_s *map, unsigned int pgndx,
+                        uintptr_t paddr)
+{
+  FAR uint8_t *buffer = (FAR uint8_t *)FILEMAP_SCRATCH_VADDR;
+  uintptr_t vaddr = map->vaddr + ((uintptr_t)pgndx << MM_PGSHIFT);
+  size_t pgoffset = (size_t)pgndx << MM_PGSHIFT;
+  size_t nbytes = MM_PGSIZE;
+  size_t nread = 0;
+  ssize_t ret;
+
+  if (pgoffset + nbytes > map->length)
+    {
+      nbytes = map->length - pgoffset;
+    }
+
+  ret = up_filemap_map(FILEMAP_SCRATCH_VADDR, paddr, true);
+  if (ret < 0)
+    {
+      return (int)ret;
+    }
+
+  while (nread < nbytes)
+    {
+      ret = file_pread(&map->file, buffer + nread, nbytes - nread,
+                       map->offset + pgoffset + nread);
+      if (ret < 0)
+        {
+          if (ret == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Read failed: offset=%ld ret=%d\n",
+               (long)(map->offset + pgoffset + nread), (int)ret);
+          up_filemap_unmap(FILEMAP_SCRATCH_VADDR);
+          return (int)ret;
+        }
+
+      /* The rest of the page beyond the end of the file reads as zero */
+
+      if (ret == 0)
+        {
+          break;
+        }
+
+      nread += ret;
+    }
+
+  memset(buffer + nread, 0, MM_PGSIZE - nread);
+  up_filemap_unmap(FILEMAP_SCRATCH_VADDR);
+
+  ret = up_filemap_map(vaddr, paddr, map->writable);
+  if (ret < 0)
+    {
+      return (int)ret;
+    }
+
+  /* The page may be executed (NXFLAT) and the same virtual address may
+   * have held a different page before, so make the instruction cache
+   * coherent with the new contents.
+   */
+
+  up_coherent_dcache(vaddr, MM_PGSIZE);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: filemap_find
+ *
+ * Description:
+ *   Find the mapping that contains a virtual address.  The caller must hold
+ *   the exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct fs_filemap_s *filemap_find(uintptr_t vaddr,
+                                             FAR struct fs_filemap_s **prev)
+{
+  FAR struct fs_filemap_s *curr;
+
+  for (*prev = NULL, curr = g_filemaps.head;
+       curr != NULL;
+       *prev = curr, curr = curr->flink)
+    {
+      if (vaddr >= curr->vaddr &&
+          vaddr < curr->vaddr + ((uintptr_t)curr->npages << MM_PGSHIFT))
+        {
+          return curr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap_initialize
+ *
+ * Description:
+ *   Verify that this capability has been initialized.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int filemap_initialize(void)
+{
+  if (!g_filemaps.initialized)
+    {
+      /* The first page of the window is reserved for the scratch mapping */
+
+      g_filemaps.window =
+        gran_initialize((FAR void *)(CONFIG_FS_FILEMAP_VBASE + MM_PGSIZE),
+                        (CONFIG_FS_FILEMAP_NPAGES - 1) << MM_PGSHIFT,
+                        MM_PGSHIFT, MM_PGSHIFT);
+      if (g_filemaps.window == NULL)
+        {
+          ferr("ERROR: gran_initialize() failed\n");
+          return -ENOMEM;
+        }
+
+      nxsem_init(&g_filemaps.exclsem, 0, 1);
+      g_filemaps.initialized = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: filemap
+ *
+ * Description:
+ *   Create a demand-paged mapping of a file.  No file data is read until
+ *   the mapping is accessed.
+ *
+ * Input Parameters:
+ *   fd      file descriptor of the backing file -- required.
+ *   length  The length of the mapping.
+ *   offset  The offset into the file to map
+ *   prot    The requested protection (see PROT_* in sys/mman.h)
+ *
+ * Returned Value:
+ *   On success, filemap() returns a pointer to the mapped area. On error,
+ *   the value MAP_FAILED is returned, and errno is set  appropriately.
+ *
+ *     EBADF
+ *      'fd' is not a valid file descriptor.
+ *     EINVAL
+ *       'length' is invalid
+ *     ENOMEM
+ *       The mapping window is exhausted or no memory for the mapping state.
+ *
+ ****************************************************************************/
+
+FAR void *filemap(int fd, size_t length, off_t offset, int prot)
+{
+  FAR struct fs_filemap_s *map;
+  FAR struct file *filep;
+  size_t pgoffset;
+  size_t npages;
+  int errcode;
+  int ret;
+
+  ret = filemap_initialize();
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* The mapping starts on a page boundary.  An unaligned offset is
+   * accommodated by returning an address within the first page.
+   */
+
+  pgoffset = (size_t)(offset & MM_PGMASK);
+  npages   = MM_NPAGES(pgoffset + length);
+
+  if (length == 0 || npages > UINT16_MAX)
+    {
+      ferr("ERROR: Invalid length: %lu\n", (unsigned long)length);
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  map = (FAR struct fs_filemap_s *)kmm_zalloc(SIZEOF_FS_FILEMAP_S(npages));
+  if (map == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  /* Take a private reference to the file so that the mapping persists
+   * after the file descriptor is closed.
+   */
+
+  ret = file_dup2(filep, &map->file);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_map;
+    }
+
+  map->offset   = offset - pgoffset;
+  map->length   = pgoffset + length;
+  map->npages   = (uint16_t)npages;
+  map->writable = (prot & PROT_WRITE) != 0;
+
+  /* Reserve the virtual address range.  Nothing is mapped until the first
+   * access to each page.
+   */
+
+  ret = nxsem_wait(&g_filemaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_file;
+    }
+
+  map->vaddr = (uintptr_t)gran_alloc(g_filemaps.window,
+                                     npages << MM_PGSHIFT);
+  if (map->vaddr == 0)
+    {
+      nxsem_post(&g_filemaps.exclsem);
+      ferr("ERROR: No space in the mapping window, npages: %lu\n",
+           (unsigned long)npages);
+      errcode = ENOMEM;
+      goto errout_with_file;
+    }
+
+  map->flink      = g_filemaps.head;
+  g_filemaps.head = map;
+  nxsem_post(&g_filemaps.exclsem);
+
+  finfo("vaddr=%08lx npages=%u offset=%ld\n",
+        (unsigned long)map->vaddr, map->npages, (long)map->offset);
+
+  return (FAR void *)(map->vaddr + pgoffset);
+
+errout_with_file:
+  file_close(&map->file);
+
+errout_with_map:
+  kmm_free(map);
+
+errout:
+  set_errno(errcode);
+  return MAP_FAILED;
+}
+
+/****************************************************************************
+ * Name: filemap_fault
+ *
+ * Description:
+ *   Resolve a translation fault within the file mapping window by reading
+ *   the missing page from the backing file and mapping it.  If the page
+ *   budget is exhausted, a clean resident page is evicted to make room.
+ *
+ * Input Parameters:
+ *   vaddr - The faulting virtual address
+ *
+ * Returned Value:
+ *   Zero (OK) if the page is now mapped and the faulting access may be
+ *   retried; a negated errno value if the fault cannot be resolved.
+ *
+ * Assumptions:
+ *   This function may block on file system I/O.  It must be called from
+ *   the context of the faulting thread with interrupts enabled, never from
+ *   the exception handler itself.
+ *
+ ****************************************************************************/
+
+int filemap_fault(uintptr_t vaddr)
+{
+  FAR struct fs_filemapframe_s *frame;
+  FAR struct fs_filemap_s *prev;
+  FAR struct fs_filemap_s *map;
+  unsigned int pgndx;
+  int ndx;
+  int ret;
+
+  if (!g_filemaps.initialized)
+    {
+      return -EFAULT;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_filemaps.exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  map = filemap_find(vaddr, &prev);
+  if (map == NULL)
+    {
+      ret = -EFAULT;
+      goto errout_with_sem;
+    }
+
+  /* Another thread may have faulted on the same page while we waited */
+
+  pgndx = (vaddr - map->vaddr) >> MM_PGSHIFT;
+  if (map->pages[pgndx] != 0)
+    {
+      ret = OK;
+      goto errout_with_sem;
+    }
+
+  ndx = filemap_getframe();
+  if (ndx < 0)
+    {
+      ferr("ERROR: No page frame for vaddr=%08lx\n", (unsigned long)vaddr);
+      ret = ndx;
+      goto errout_with_sem;
+    }
+
+  frame = &g_filemaps.frames[ndx];
+  ret   = filemap_fill(map, pgndx, frame->paddr);
+  if (ret < 0)
+    {
+      mm_pgfree(frame->paddr, 1);
+      frame->paddr = 0;
+      goto errout_with_sem;
+    }
+
+  frame->map        = map;
+  frame->pgndx      = pgndx;
+  map->pages[pgndx] = ndx + 1;
+
+errout_with_sem:
+  nxsem_post(&g_filemaps.exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: filemap_munmap
+ *
+ * Description:
+ *   Remove all or the tail of a demand-paged file mapping.  Like the RAM
+ *   mapping emulation, a mapping can only be unmapped to its end.
+ *
+ * Input Parameters:
+ *   start   An address within the mapping window
+ *   length  The length region to be umapped.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int filemap_munmap(FAR void *start, size_t length)
+{
+  FAR struct fs_filemap_s *prev;
+  FAR struct fs_filemap_s *map;
+  uintptr_t addr = (uintptr_t)start;
+  unsigned int first;
+  unsigned int i;
+  int ret;
+
+  ret = filemap_initialize();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxsem_wait(&g_filemaps.exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  map = filemap_find(addr, &prev);
+  if (map == NULL)
+    {
+      ferr("ERROR: Region not found\n");
+      ret = -EINVAL;
+      goto errout_with_sem;
+    }
+
+  if (addr + length < map->vaddr + map->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      ret = -ENOSYS;
+      goto errout_with_sem;
+    }
+
+  /* Unmapping from within the first page (i.e., from the address returned
+   * by mmap()) removes the whole mapping.  Otherwise, only the pages that
+   * lie entirely after 'start' are removed.
+   */
+
+  first = (MM_PGALIGNDOWN(addr) == map->vaddr) ?
+          0 : MM_NPAGES(addr - map->vaddr);
+
+  for (i = first; i < map->npages; i++)
+    {
+      if (map->pages[i] != 0)
+        {
+          filemap_freeframe(map->pages[i] - 1);
+        }
+    }
+
+  if (first < map->npages)
+    {
+      gran_free(g_filemaps.window,
+                (FAR void *)(map->vaddr + ((uintptr_t)first << MM_PGSHIFT)),
+                (size_t)(map->npages - first) << MM_PGSHIFT);
+    }
+
+  if (first == 0)
+    {
+      if (prev)
+        {
+          prev->flink = map->flink;
+        }
+      else
+        {
+          g_filemaps.head = map->flink;
+        }
+
+      file_close(&map->file);
+      kmm_free(map);
+    }
+  else if (first < map->npages)
+    {
+      map->npages = first;
+      map->length = (size_t)first << MM_PGSHIFT;
+    }
+
+  ret = OK;
+
+errout_with_sem:
+  nxsem_post(&g_filemaps.exclsem);
+  return ret;
+}
+
+#endif /* CONFIG_FS_FILEMAP */
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * fs/mmap/fs_filemap.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_FILEMAP_H
+#define __FS_MMAP_FS_FILEMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/gran.h>
+#include <nuttx/fs/filemap.h>
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of a mapping structure with 'n' page table entries */
+
+#define SIZEOF_FS_FILEMAP_S(n) \
+  (sizeof(struct fs_filemap_s) + ((n) - 1) * sizeof(uint16_t))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one demand-paged file mapping.  The mapping
+ * holds its own reference to the backing file so that it persists after
+ * the file descriptor is closed.  Each virtual page of the mapping is
+ * either not resident (zero) or refers to one entry of the page frame
+ * table (frame index plus one).
+ */
+
+struct fs_filemap_s
+{
+  FAR struct fs_filemap_s *flink;  /* Implements a singly linked list */
+  struct file     file;            /* Private reference to the backing file */
+  uintptr_t       vaddr;           /* Page aligned start of the mapping */
+  off_t           offset;          /* Page aligned file offset */
+  size_t          length;          /* Length of the file data to map */
+  uint16_t        npages;          /* Number of virtual pages */
+  bool            writable;        /* Pages are mapped writable and pinned */
+  uint16_t        pages[1];        /* Frame of each page (0 = not resident) */
+};
+
+/* This structure describes one page frame holding resident file data */
+
+struct fs_filemapframe_s
+{
+  FAR struct fs_filemap_s *map;    /* Owning mapping (NULL = frame unused) */
+  uintptr_t       paddr;           /* Physical address of the frame */
+  uint16_t        pgndx;           /* Page index within the mapping */
+};
+
+/* This structure defines all demand-paged file mappings */
+
+struct fs_allfilemaps_s
+{
+  bool            initialized;     /* True: This structure has been initialized */
+  sem_t           exclsem;         /* Provides exclusive access */
+  GRAN_HANDLE     window;          /* Allocator for the virtual window */
+  FAR struct fs_filemap_s *head;   /* List of mapped files */
+  uint16_t        hand;            /* Clock hand of the eviction sweep */
+  struct fs_filemapframe_s frames[CONFIG_FS_FILEMAP_MAXPAGES];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* This is the list of all demand-paged file mappings */
+
+extern struct fs_allfilemaps_s g_filemaps;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap_initialize
+ *
+ * Description:
+ *   Verify that this capability has been initialized.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int filemap_initialize(void);
+
+/****************************************************************************
+ * Name: filemap
+ *
+ * Description:
+ *   Create a demand-paged mapping of a file.  No file data is read until
+ *   the mapping is accessed.
+ *
+ * Input Parameters:
+ *   fd      file descriptor of the backing file -- required.
+ *   length  The length of the mapping.
+ *   offset  The offset into the file to map
+ *   prot    The requested protection (see PROT_* in sys/mman.h)
+ *
+ * Returned Value:
+ *   On success, filemap() returns a pointer to the mapped area. On error,
+ *   the value MAP_FAILED is returned, and errno is set  appropriately.
+ *
+ *     EBADF
+ *      'fd' is not a valid file descriptor.
+ *     EINVAL
+ *       'length' is invalid
+ *     ENOMEM
+ *       The mapping window is exhausted or no memory for the mapping state.
+ *
+ ****************************************************************************/
+
+FAR void *filemap(int fd, size_t length, off_t offset, int prot);
+
+/****************************************************************************
+ * Name: filemap_munmap
+ *
+ * Description:
+ *   Remove all or the tail of a demand-paged file mapping.  Like the RAM
+ *   mapping emulation, a mapping can only be unmapped to its end.
+ *
+ * Input Parameters:
+ *   start   An address within the mapping window
+ *   length  The length region to be umapped.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int filemap_munmap(FAR void *start, size_t length);
+
+#endif /* CONFIG_FS_FILEMAP */
+#endif /* __FS_MMAP_FS_FILEMAP_H */
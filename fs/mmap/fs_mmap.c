@@ -50,6 +50,7 @@
 
 #include "inode/inode.h"
 #include "fs_rammap.h"
+#include "fs_filemap.h"
 
 /****************************************************************************
  * Public Functions
@@ -74,7 +75,11 @@
  *        command that maps the underlying media to a randomly accessible
  *        address. At  present, only the RAM/ROM disk driver does this.
  *
- *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
+ *   2. If CONFIG_FS_FILEMAP is defined in the configuration, then mmap()
+ *      will create a demand-paged mapping using the MMU.  File pages are
+ *      read only when they are accessed and clean pages may be evicted.
+ *
+ *   3. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.
  *
@@ -203,7 +208,22 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
        * not support random access.
        */
 
+#ifdef CONFIG_FS_FILEMAP
+      /* Map the file into the file mapping window.  Pages will be filled
+       * from the file on demand.
+       */
+
+      addr = filemap(fd, length, offset, prot);
 #ifdef CONFIG_FS_RAMMAP
+      if (addr == MAP_FAILED)
+        {
+          addr = rammap(fd, length, offset);
+        }
+#endif
+
+      return addr;
+
+#elif defined(CONFIG_FS_RAMMAP)
       /* Allocate memory and copy the file into memory.  We would, of course,
        * do much better in the KERNEL build using the MMU.
        */
@@ -73,6 +73,14 @@
 
 #define NFS_DIRBLKSIZ      1024           /* Must be a multiple of DIRBLKSIZ */
 
+#ifndef CONFIG_NFS_MAXREQUESTS
+#  define CONFIG_NFS_MAXREQUESTS 1
+#endif
+
+#ifndef CONFIG_NFS_ATTRCACHE_TIMEOUT
+#  define CONFIG_NFS_ATTRCACHE_TIMEOUT 0
+#endif
+
 /* Increment NFS statistics */
 
 #ifdef CONFIG_NFS_STATISTICS
@@ -119,9 +127,11 @@ EXTERN void nfs_semtake(FAR struct nfsmount *nmp);
 EXTERN void nfs_semgive(FAR struct nfsmount *nmp);
 EXTERN int  nfs_checkmount(FAR struct nfsmount *nmp);
 EXTERN int  nfs_fsinfo(FAR struct nfsmount *nmp);
+EXTERN int  nfs_checkreply(FAR void *response);
 EXTERN int nfs_request(struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int  nfs_getattr(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -104,9 +104,21 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fs;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* Data read ahead of the last sequential read.  Holds nm_ralen bytes of
+   * the file nm_ranode from file offset nm_raoffset.
+   */
+
+  FAR struct nfsnode *nm_ranode;              /* File of the read-ahead data */
+  FAR uint8_t     *nm_rabuffer;               /* Read-ahead data */
+  uint64_t         nm_raoffset;               /* File offset of the read-ahead data */
+  uint16_t         nm_ralen;                  /* Valid bytes in nm_rabuffer */
+#endif
+
   /* I/O buffer (must be a aligned to 32-bit boundaries).  This buffer used for all
    * reply messages EXCEPT for the WRITE RPC. In that case it is used for the WRITE
    * call message that contains the data to be written.  This buffer must be
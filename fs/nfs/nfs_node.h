@@ -48,6 +48,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <time.h>
+
 #include "nfs_proto.h"
 
 /****************************************************************************
@@ -57,7 +59,8 @@
 /* Flags for struct nfsnode n_flag */
 
 #define NFSNODE_OPEN           (1 << 0) /* File is still open */
-#define NFSNODE_MODIFIED       (1 << 1) /* Might have a modified buffer */
+#define NFSNODE_MODIFIED       (1 << 1) /* Has UNSTABLE writes not yet committed */
+#define NFSNODE_WRITEERR       (1 << 2) /* Uncommitted data was lost by the server */
 
 /****************************************************************************
  * Public Types
@@ -79,6 +82,13 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file */
+  clock_t            n_attrstamp;   /* Time attributes were last updated */
+#ifdef CONFIG_NFS_READAHEAD
+  uint64_t           n_rapos;       /* End of the last read (for read-ahead) */
+#endif
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  uint8_t            n_verf[NFSX_V3WRITEVERF]; /* Verifier of uncommitted writes */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
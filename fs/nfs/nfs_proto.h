@@ -570,5 +570,18 @@ struct FS3args
   struct file_handle fsroot;
 };
 
+struct COMMIT3args
+{
+  struct file_handle fhandle;     /* Variable length */
+  uint64_t           offset;
+  uint32_t           count;
+};
+
+struct COMMIT3resok
+{
+  struct wcc_data    file_wcc;
+  uint8_t            verf[NFSX_V3WRITEVERF];
+};
+
 #endif /* __FS_NFS_NFS_PROTO_H */
 
@@ -52,6 +52,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/dirent.h>
 
@@ -188,34 +189,23 @@ int nfs_checkmount(struct nfsmount *nmp)
 }
 
 /****************************************************************************
- * Name: nfs_request
+ * Name: nfs_checkreply
  *
  * Description:
- *   Perform the NFS request. On successful receipt, it verifies the NFS level of the
- *   returned values.
+ *   Verify the NFS level of the reply message in 'response'.  The RPC level
+ *   has already been verified.
  *
  * Returned Value:
- *   Zero on success; a positive errno value on failure.
+ *   Zero on success; a positive errno value on failure.  EAGAIN means that
+ *   the request should be sent again.
  *
  ****************************************************************************/
 
-int nfs_request(struct nfsmount *nmp, int procnum,
-                FAR void *request, size_t reqlen,
-                FAR void *response, size_t resplen)
+int nfs_checkreply(FAR void *response)
 {
-  struct rpcclnt *clnt = nmp->nm_rpcclnt;
   struct nfs_reply_header replyh;
   int error;
 
-tryagain:
-  error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
-                          request, reqlen, response, resplen);
-  if (error != 0)
-    {
-      ferr("ERROR: rpcclnt_request failed: %d\n", error);
-      return error;
-    }
-
   memcpy(&replyh, response, sizeof(struct nfs_reply_header));
 
   if (replyh.nfs_status != 0)
@@ -237,14 +227,11 @@ tryagain:
   if (replyh.rpc_verfi.authtype != 0)
     {
       error = fxdr_unsigned(int, replyh.rpc_verfi.authtype);
-
-      if (error == EAGAIN)
+      if (error != EAGAIN)
         {
-          error = 0;
-          goto tryagain;
+          ferr("ERROR: NFS error %d from server\n", error);
         }
 
-      ferr("ERROR: NFS error %d from server\n", error);
       return error;
     }
 
@@ -252,6 +239,114 @@ tryagain:
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_request
+ *
+ * Description:
+ *   Perform the NFS request. On successful receipt, it verifies the NFS level of the
+ *   returned values.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_request(struct nfsmount *nmp, int procnum,
+                FAR void *request, size_t reqlen,
+                FAR void *response, size_t resplen)
+{
+  struct rpcclnt *clnt = nmp->nm_rpcclnt;
+  int error;
+
+  do
+    {
+      error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
+                              request, reqlen, response, resplen);
+      if (error != 0)
+        {
+          ferr("ERROR: rpcclnt_request failed: %d\n", error);
+          return error;
+        }
+
+      error = nfs_checkreply(response);
+    }
+  while (error == EAGAIN);
+
+  return error;
+}
+
+/****************************************************************************
+ * Name: nfs_getattr
+ *
+ * Description:
+ *   Make sure that the cached attributes of the open file are not older
+ *   than CONFIG_NFS_ATTRCACHE_TIMEOUT seconds, fetching them again from the
+ *   server if necessary.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+int nfs_getattr(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR struct rpc_reply_getattr *resok;
+  FAR uint32_t *ptr;
+  uint64_t size;
+  time_t mtime;
+  int reqlen;
+  int error;
+
+  if (CONFIG_NFS_ATTRCACHE_TIMEOUT > 0 &&
+      clock_systimer() - np->n_attrstamp <
+      SEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT))
+    {
+      return OK;
+    }
+
+  /* Create the GETATTR RPC call arguments: just the file handle */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.fs.fs;
+  *ptr++  = txdr_unsigned(np->n_fhsize);
+  reqlen  = sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+
+  nfs_statistics(NFSPROC_GETATTR);
+  error = nfs_request(nmp, NFSPROC_GETATTR,
+                      (FAR void *)&nmp->nm_msgbuffer.fs, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error != OK)
+    {
+      ferr("ERROR: GETATTR failed: %d\n", error);
+      return error;
+    }
+
+  size  = np->n_size;
+  mtime = np->n_mtime;
+
+  resok = (FAR struct rpc_reply_getattr *)nmp->nm_iobuffer;
+  nfs_attrupdate(np, &resok->attr);
+
+#ifdef CONFIG_NFS_READAHEAD
+  /* Discard read-ahead data if the file was changed on the server */
+
+  if (nmp->nm_ranode == np && (np->n_size != size || np->n_mtime != mtime))
+    {
+      nmp->nm_ranode = NULL;
+    }
+#else
+  UNUSED(size);
+  UNUSED(mtime);
+#endif
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: nfs_lookup
  *
@@ -599,4 +694,6 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
 
   fxdr_nfsv3time(&attributes->fa_ctime, &ts);
   np->n_ctime  = ts.tv_sec;
+
+  np->n_attrstamp = clock_systimer();
 }
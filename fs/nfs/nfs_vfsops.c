@@ -103,6 +103,14 @@
 #  error "Length of cookie verify in fs_dirent_s is incorrect"
 #endif
 
+/* The stability level requested for WRITE RPCs */
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+#  define NFS_WRITE_STABLE      NFSV3WRITE_UNSTABLE
+#else
+#  define NFS_WRITE_STABLE      NFSV3WRITE_FILESYNC
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -119,6 +127,16 @@ struct nfs_statinfo_s
   time_t   ns_ctime;   /* Time of last status change */
 };
 
+/* Describes one outstanding READ or WRITE RPC of a pipelined transfer */
+
+struct nfs_rpcslot_s
+{
+  uint32_t xid;        /* Transaction ID of the request */
+  uint32_t offset;     /* Offset of the data from the start of the transfer */
+  uint16_t len;        /* Number of bytes requested */
+  bool     active;     /* True: Waiting for the reply */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -135,6 +153,20 @@ struct nfsstats nfsstats;
  * Private Function Prototypes
  ****************************************************************************/
 
+static uint32_t nfs_readsize(FAR struct nfsmount *nmp);
+static int     nfs_sendread(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                            uint64_t pos, uint32_t len, FAR uint32_t *xid);
+static ssize_t nfs_readrpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                            uint64_t pos, FAR uint8_t *buffer, size_t buflen,
+                            FAR uint8_t *rabuffer, size_t ralen);
+static int     nfs_sendwrite(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                             uint64_t pos, FAR const uint8_t *buffer,
+                             uint32_t len, FAR uint32_t *xid);
+static ssize_t nfs_writerpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                             uint64_t pos, FAR const uint8_t *buffer,
+                             size_t buflen);
+static int     nfs_filecommit(FAR struct nfsmount *nmp,
+                              FAR struct nfsnode *np);
 static int     nfs_filecreate(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    mode_t mode);
@@ -150,6 +182,7 @@ static int     nfs_close(FAR struct file *filep);
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+static int     nfs_sync(FAR struct file *filep);
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
 static int     nfs_truncate(FAR struct file *filep, off_t length);
@@ -179,45 +212,664 @@ static void    nfs_stat_common(FAR struct nfs_statinfo_s *info,
 static int     nfs_stat(struct inode *mountpt, FAR const char *relpath,
                    FAR struct stat *buf);
 
-/****************************************************************************
- * Public Data
- ****************************************************************************/
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* nfs vfs operations. */
+
+const struct mountpt_operations nfs_operations =
+{
+  nfs_open,                     /* open */
+  nfs_close,                    /* close */
+  nfs_read,                     /* read */
+  nfs_write,                    /* write */
+  NULL,                         /* seek */
+  NULL,                         /* ioctl */
+
+  nfs_sync,                     /* sync */
+  nfs_dup,                      /* dup */
+  nfs_fstat,                    /* fstat */
+  nfs_truncate,                 /* truncate */
+
+  nfs_opendir,                  /* opendir */
+  NULL,                         /* closedir */
+  nfs_readdir,                  /* readdir */
+  nfs_rewinddir,                /* rewinddir */
+
+  nfs_bind,                     /* bind */
+  nfs_unbind,                   /* unbind */
+  nfs_statfs,                   /* statfs */
+
+  nfs_remove,                   /* unlink */
+  nfs_mkdir,                    /* mkdir */
+  nfs_rmdir,                    /* rmdir */
+  nfs_rename,                   /* rename */
+  nfs_stat                      /* stat */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nfs_readsize
+ *
+ * Description:
+ *   Return the number of bytes requested by one READ RPC.  This is the
+ *   negotiated read size, clipped so that the reply fits into the I/O
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static uint32_t nfs_readsize(FAR struct nfsmount *nmp)
+{
+  uint32_t readsize = nmp->nm_rsize;
+  uint32_t tmp;
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  return readsize;
+}
+
+/****************************************************************************
+ * Name: nfs_sendread
+ *
+ * Description:
+ *   Send one READ RPC for 'len' bytes at file offset 'pos' without waiting
+ *   for the reply.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_sendread(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        uint64_t pos, uint32_t len, FAR uint32_t *xid)
+{
+  FAR uint32_t *ptr;
+  size_t reqlen;
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper(pos, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(len);
+  reqlen += sizeof(uint32_t);
+
+  finfo("Reading %lu bytes at %lu\n", (unsigned long)len,
+        (unsigned long)pos);
+  nfs_statistics(NFSPROC_READ);
+  return rpcclnt_send_request(nmp->nm_rpcclnt, NFSPROC_READ, NFS_PROG,
+                              NFS_VER3, (FAR void *)&nmp->nm_msgbuffer.read,
+                              reqlen, xid);
+}
+
+/****************************************************************************
+ * Name: nfs_readrpcs
+ *
+ * Description:
+ *   Read 'buflen' bytes at file offset 'pos' into 'buffer', followed by up
+ *   to 'ralen' more bytes into 'rabuffer'.  Up to CONFIG_NFS_MAXREQUESTS
+ *   READ RPCs are kept outstanding.  The replies may arrive in any order
+ *   and are matched to their requests by their xid.
+ *
+ * Returned Value:
+ *   The number of contiguous bytes read on success; a negated errno value
+ *   on failure.  The count is less than buflen + ralen at the end of the
+ *   file or if the server returned less data than requested.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_readrpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                            uint64_t pos, FAR uint8_t *buffer, size_t buflen,
+                            FAR uint8_t *rabuffer, size_t ralen)
+{
+  struct nfs_rpcslot_s slots[CONFIG_NFS_MAXREQUESTS];
+  FAR struct rpcclnt *rpc = nmp->nm_rpcclnt;
+  FAR struct nfs_rpcslot_s *slot;
+  FAR uint32_t *ptr;
+  FAR uint8_t *dest;
+  uint32_t readsize = nfs_readsize(nmp);
+  uint32_t total = buflen + ralen;
+  uint32_t next = 0;
+  uint32_t end = total;
+  uint32_t count;
+  uint32_t xid;
+  int nactive = 0;
+  int retries = 0;
+  int error;
+  int i;
+
+  memset(slots, 0, sizeof(slots));
+
+  for (; ; )
+    {
+      /* Keep the window of outstanding requests full.  A request never
+       * spans the user buffer and the read-ahead buffer.
+       */
+
+      for (i = 0; i < CONFIG_NFS_MAXREQUESTS && next < end; i++)
+        {
+          slot = &slots[i];
+          if (!slot->active)
+            {
+              count = (next < buflen ? buflen : total) - next;
+              if (count > readsize)
+                {
+                  count = readsize;
+                }
+
+              error = nfs_sendread(nmp, np, pos + next, count, &slot->xid);
+              if (error != OK)
+                {
+                  return -error;
+                }
+
+              slot->offset = next;
+              slot->len    = count;
+              slot->active = true;
+              next        += count;
+              nactive++;
+            }
+        }
+
+      if (nactive == 0)
+        {
+          break;
+        }
+
+      error = rpcclnt_receive_reply(rpc, nmp->nm_iobuffer, nmp->nm_buflen,
+                                    &xid);
+      if (error == ETIMEDOUT && ++retries <= rpc->rc_retry)
+        {
+          /* Send all outstanding requests again */
+
+          for (i = 0; i < CONFIG_NFS_MAXREQUESTS; i++)
+            {
+              slot = &slots[i];
+              if (slot->active)
+                {
+                  error = nfs_sendread(nmp, np, pos + slot->offset,
+                                       slot->len, &slot->xid);
+                  if (error != OK)
+                    {
+                      return -error;
+                    }
+                }
+            }
+
+          continue;
+        }
+      else if (error != OK)
+        {
+          ferr("ERROR: rpcclnt_receive_reply failed: %d\n", error);
+          return -error;
+        }
+
+      /* Find the request of this reply */
+
+      for (i = 0; i < CONFIG_NFS_MAXREQUESTS; i++)
+        {
+          if (slots[i].active && slots[i].xid == xid)
+            {
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NFS_MAXREQUESTS)
+        {
+          finfo("Discarding reply to xid %08lx\n", (unsigned long)xid);
+          continue;
+        }
+
+      slot = &slots[i];
+      error = nfs_checkreply(nmp->nm_iobuffer);
+      if (error == EAGAIN)
+        {
+          error = nfs_sendread(nmp, np, pos + slot->offset, slot->len,
+                               &slot->xid);
+        }
+
+      if (error != OK)
+        {
+          ferr("ERROR: READ failed: %d\n", error);
+          return -error;
+        }
+
+      slot->active = false;
+      nactive--;
+
+      /* The read was successful.  Get a pointer to the beginning of the NFS
+       * response data.  Update the cached attributes if they are included.
+       */
+
+      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)
+                              nmp->nm_iobuffer)->read;
+      if (*ptr++ != 0)
+        {
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      /* Skip the count and the EOF indication.  A short count is handled
+       * below in either case.  Then get the length of the read data.
+       */
+
+      ptr  += 2;
+      count = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (count > slot->len)
+        {
+          return -EIO;
+        }
+
+      /* Copy the read data into the user or the read-ahead buffer */
+
+      if (slot->offset < buflen)
+        {
+          dest = &buffer[slot->offset];
+        }
+      else
+        {
+          dest = &rabuffer[slot->offset - buflen];
+        }
+
+      memcpy(dest, ptr, count);
+
+      /* A short read ends the transfer.  No more requests are sent and the
+       * data of any requests beyond this point is not used.
+       */
+
+      if (count < slot->len && slot->offset + count < end)
+        {
+          end = slot->offset + count;
+        }
+    }
+
+  return end;
+}
+
+/****************************************************************************
+ * Name: nfs_sendwrite
+ *
+ * Description:
+ *   Send one WRITE RPC for 'len' bytes at file offset 'pos' without waiting
+ *   for the reply.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_sendwrite(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         uint64_t pos, FAR const uint8_t *buffer,
+                         uint32_t len, FAR uint32_t *xid)
+{
+  FAR uint32_t *ptr;
+  size_t reqlen;
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+              nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper(pos, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(len);
+  *ptr++  = txdr_unsigned(NFS_WRITE_STABLE);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(len);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, len);
+  reqlen += uint32_alignup(len);
+
+  finfo("Writing %lu bytes at %lu\n", (unsigned long)len,
+        (unsigned long)pos);
+  nfs_statistics(NFSPROC_WRITE);
+  return rpcclnt_send_request(nmp->nm_rpcclnt, NFSPROC_WRITE, NFS_PROG,
+                              NFS_VER3, (FAR void *)nmp->nm_iobuffer,
+                              reqlen, xid);
+}
+
+/****************************************************************************
+ * Name: nfs_writerpcs
+ *
+ * Description:
+ *   Write 'buflen' bytes from 'buffer' at file offset 'pos'.  Up to
+ *   CONFIG_NFS_MAXREQUESTS WRITE RPCs are kept outstanding.
+ *
+ *   With CONFIG_NFS_UNSTABLE_WRITES, the verifier returned by the server is
+ *   saved in the node.  If it changes before the data is committed, the
+ *   server has lost the uncommitted data and NFSNODE_WRITEERR is set.
+ *
+ * Returned Value:
+ *   The number of contiguous bytes written on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_writerpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                             uint64_t pos, FAR const uint8_t *buffer,
+                             size_t buflen)
+{
+  struct nfs_rpcslot_s slots[CONFIG_NFS_MAXREQUESTS];
+  FAR struct rpcclnt *rpc = nmp->nm_rpcclnt;
+  FAR struct nfs_rpcslot_s *slot;
+  FAR uint32_t *ptr;
+  uint32_t writesize = nmp->nm_wsize;
+  uint32_t next = 0;
+  uint32_t end = buflen;
+  uint32_t count;
+  uint32_t xid;
+  uint32_t tmp;
+  int nactive = 0;
+  int retries = 0;
+  int error;
+  int i;
+
+  /* Make sure that the write size does not exceed the I/O buffer size */
+
+  tmp = SIZEOF_rpc_call_write(writesize);
+  if (tmp > nmp->nm_buflen)
+    {
+      writesize -= (tmp - nmp->nm_buflen);
+    }
+
+  memset(slots, 0, sizeof(slots));
+
+  for (; ; )
+    {
+      /* Keep the window of outstanding requests full */
+
+      for (i = 0; i < CONFIG_NFS_MAXREQUESTS && next < end; i++)
+        {
+          slot = &slots[i];
+          if (!slot->active)
+            {
+              count = end - next;
+              if (count > writesize)
+                {
+                  count = writesize;
+                }
+
+              error = nfs_sendwrite(nmp, np, pos + next, &buffer[next],
+                                    count, &slot->xid);
+              if (error != OK)
+                {
+                  return -error;
+                }
+
+              slot->offset = next;
+              slot->len    = count;
+              slot->active = true;
+              next        += count;
+              nactive++;
+            }
+        }
+
+      if (nactive == 0)
+        {
+          break;
+        }
+
+      error = rpcclnt_receive_reply(rpc, &nmp->nm_msgbuffer.write,
+                                    sizeof(struct rpc_reply_write), &xid);
+      if (error == ETIMEDOUT && ++retries <= rpc->rc_retry)
+        {
+          /* Send all outstanding requests again */
+
+          for (i = 0; i < CONFIG_NFS_MAXREQUESTS; i++)
+            {
+              slot = &slots[i];
+              if (slot->active)
+                {
+                  error = nfs_sendwrite(nmp, np, pos + slot->offset,
+                                        &buffer[slot->offset], slot->len,
+                                        &slot->xid);
+                  if (error != OK)
+                    {
+                      return -error;
+                    }
+                }
+            }
+
+          continue;
+        }
+      else if (error != OK)
+        {
+          ferr("ERROR: rpcclnt_receive_reply failed: %d\n", error);
+          return -error;
+        }
+
+      /* Find the request of this reply */
+
+      for (i = 0; i < CONFIG_NFS_MAXREQUESTS; i++)
+        {
+          if (slots[i].active && slots[i].xid == xid)
+            {
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NFS_MAXREQUESTS)
+        {
+          finfo("Discarding reply to xid %08lx\n", (unsigned long)xid);
+          continue;
+        }
+
+      slot = &slots[i];
+      error = nfs_checkreply(&nmp->nm_msgbuffer.write);
+      if (error == EAGAIN)
+        {
+          error = nfs_sendwrite(nmp, np, pos + slot->offset,
+                                &buffer[slot->offset], slot->len,
+                                &slot->xid);
+        }
+
+      if (error != OK)
+        {
+          ferr("ERROR: WRITE failed: %d\n", error);
+          return -error;
+        }
+
+      slot->active = false;
+      nactive--;
+
+      /* Get a pointer to the WRITE reply data */
+
+      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+      /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+      if (*ptr++ != 0)
+        {
+          /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+          ptr += uint32_increment(sizeof(struct wcc_attr));
+        }
+
+      /* Check if normal file attributes follow */
+
+      if (*ptr++ != 0)
+        {
+          /* Yes.. Update the cached file status in the file structure. */
+
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      /* Get the count of bytes actually written */
+
+      count = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (count > slot->len)
+        {
+          return -EIO;
+        }
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+      /* Data that the server has not committed must be committed later.
+       * A different verifier means that the server has restarted and lost
+       * earlier uncommitted data.
+       */
+
+      if (fxdr_unsigned(uint32_t, *ptr) == NFSV3WRITE_UNSTABLE)
+        {
+          if ((np->n_flags & NFSNODE_MODIFIED) == 0)
+            {
+              memcpy(np->n_verf, ptr + 1, NFSX_V3WRITEVERF);
+              np->n_flags |= NFSNODE_MODIFIED;
+            }
+          else if (memcmp(np->n_verf, ptr + 1, NFSX_V3WRITEVERF) != 0)
+            {
+              ferr("ERROR: Write verifier changed\n");
+              memcpy(np->n_verf, ptr + 1, NFSX_V3WRITEVERF);
+              np->n_flags |= NFSNODE_WRITEERR;
+            }
+        }
+#endif
+
+      /* A short write ends the transfer */
+
+      if (count < slot->len && slot->offset + count < end)
+        {
+          end = slot->offset + count;
+        }
+    }
+
+  return end;
+}
+
+/****************************************************************************
+ * Name: nfs_filecommit
+ *
+ * Description:
+ *   Commit the data of UNSTABLE writes to the stable storage of the server.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  EIO is returned if
+ *   the server lost uncommitted data.
+ *
+ ****************************************************************************/
+
+static int nfs_filecommit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  FAR uint32_t *ptr;
+  int           reqlen;
+  int           error = OK;
+
+  if ((np->n_flags & NFSNODE_MODIFIED) != 0)
+    {
+      /* Create the COMMIT RPC call arguments:  The whole file */
+
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+      reqlen  = 0;
+
+      *ptr++  = txdr_unsigned(np->n_fhsize);
+      reqlen += sizeof(uint32_t);
 
-/* nfs vfs operations. */
+      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+      reqlen += uint32_alignup(np->n_fhsize);
+      ptr    += uint32_increment(np->n_fhsize);
 
-const struct mountpt_operations nfs_operations =
-{
-  nfs_open,                     /* open */
-  nfs_close,                    /* close */
-  nfs_read,                     /* read */
-  nfs_write,                    /* write */
-  NULL,                         /* seek */
-  NULL,                         /* ioctl */
+      txdr_hyper((uint64_t)0, ptr);
+      ptr    += 2;
+      *ptr    = 0;
+      reqlen += 3*sizeof(uint32_t);
 
-  NULL,                         /* sync */
-  nfs_dup,                      /* dup */
-  nfs_fstat,                    /* fstat */
-  nfs_truncate,                 /* truncate */
+      nfs_statistics(NFSPROC_COMMIT);
+      error = nfs_request(nmp, NFSPROC_COMMIT,
+                          (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+      if (error != OK)
+        {
+          ferr("ERROR: COMMIT failed: %d\n", error);
+          return error;
+        }
 
-  nfs_opendir,                  /* opendir */
-  NULL,                         /* closedir */
-  nfs_readdir,                  /* readdir */
-  nfs_rewinddir,                /* rewinddir */
+      /* Parse file_wcc, then check the verifier */
 
-  nfs_bind,                     /* bind */
-  nfs_unbind,                   /* unbind */
-  nfs_statfs,                   /* statfs */
+      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_commit *)
+                              nmp->nm_iobuffer)->commit;
+      if (*ptr++ != 0)
+        {
+          ptr += uint32_increment(sizeof(struct wcc_attr));
+        }
 
-  nfs_remove,                   /* unlink */
-  nfs_mkdir,                    /* mkdir */
-  nfs_rmdir,                    /* rmdir */
-  nfs_rename,                   /* rename */
-  nfs_stat                      /* stat */
-};
+      if (*ptr++ != 0)
+        {
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+      if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+        {
+          ferr("ERROR: Commit verifier changed\n");
+          np->n_flags |= NFSNODE_WRITEERR;
+        }
+
+      np->n_flags &= ~NFSNODE_MODIFIED;
+    }
+
+  if ((np->n_flags & NFSNODE_WRITEERR) != 0)
+    {
+      np->n_flags &= ~NFSNODE_WRITEERR;
+      error = EIO;
+    }
+
+  return error;
+#else
+  return OK;
+#endif
+}
 
 /****************************************************************************
  * Name: nfs_filecreate
@@ -709,6 +1361,7 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+  int error;
   int ret;
 
   /* Sanity checks */
@@ -726,6 +1379,12 @@ static int nfs_close(FAR struct file *filep)
 
   nfs_semtake(nmp);
 
+  /* Commit any UNSTABLE writes so that the data is on stable storage when
+   * close() returns.
+   */
+
+  error = nfs_filecommit(nmp, np);
+
   /* Decrement the reference count.  If the reference count would not
    * decrement to zero, then that is all we have to do.
    */
@@ -772,6 +1431,13 @@ static int nfs_close(FAR struct file *filep)
                   nmp->nm_head = np->n_next;
                 }
 
+#ifdef CONFIG_NFS_READAHEAD
+              if (nmp->nm_ranode == np)
+                {
+                  nmp->nm_ranode = NULL;
+                }
+#endif
+
               /* Then deallocate the file structure and return success */
 
               kmm_free(np);
@@ -783,7 +1449,7 @@ static int nfs_close(FAR struct file *filep)
 
   filep->f_priv = NULL;
   nfs_semgive(nmp);
-  return ret;
+  return ret < 0 ? ret : -error;
 }
 
 /****************************************************************************
@@ -799,12 +1465,13 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  ssize_t                    nread;
+  size_t                     bytesread = 0;
   int                        error = 0;
+#ifdef CONFIG_NFS_READAHEAD
+  uint64_t                   raend;
+  size_t                     ralen;
+#endif
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
 
@@ -829,125 +1496,111 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       goto errout_with_semaphore;
     }
 
+  /* Make sure that the file size is not older than the attribute cache
+   * timeout.
+   */
+
+  error = nfs_getattr(nmp, np);
+  if (error != OK)
+    {
+      goto errout_with_semaphore;
+    }
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  if (filep->f_pos >= np->n_size)
     {
-      buflen = tmp;
+      buflen = 0;
+    }
+  else if (buflen > np->n_size - filep->f_pos)
+    {
+      buflen = np->n_size - filep->f_pos;
       finfo("Read size truncated to %d\n", buflen);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
+#ifdef CONFIG_NFS_READAHEAD
+  /* First take what is available in the read-ahead buffer */
 
-  for (bytesread = 0; bytesread < buflen; )
+  raend = nmp->nm_raoffset + nmp->nm_ralen;
+  if (nmp->nm_ranode == np && filep->f_pos >= nmp->nm_raoffset &&
+      filep->f_pos < raend)
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
+      bytesread = raend - filep->f_pos;
+      if (bytesread > buflen)
         {
-          readsize = nmp->nm_rsize;
+          bytesread = buflen;
         }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
+      memcpy(buffer,
+             &nmp->nm_rabuffer[filep->f_pos - nmp->nm_raoffset],
+             bytesread);
+    }
+
+  if (bytesread < buflen)
+    {
+      /* If the file is being read sequentially, read the data following
+       * the request into the read-ahead buffer at the same time.
+       */
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
+      ralen = 0;
+      raend = filep->f_pos + buflen;
+      if (np->n_rapos == filep->f_pos && raend < np->n_size)
         {
-          readsize -= (tmp - nmp->nm_buflen);
+          ralen = nfs_readsize(nmp);
+          if (ralen > np->n_size - raend)
+            {
+              ralen = np->n_size - raend;
+            }
         }
 
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
+      nmp->nm_ranode = NULL;
+      nread = nfs_readrpcs(nmp, np, filep->f_pos + bytesread,
+                           (FAR uint8_t *)&buffer[bytesread],
+                           buflen - bytesread, nmp->nm_rabuffer, ralen);
+      if (nread < 0)
+        {
+          /* Return the data taken from the read-ahead buffer, if any */
 
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
+          if (bytesread == 0)
+            {
+              error = -nread;
+              goto errout_with_semaphore;
+            }
+        }
+      else if (nread > buflen - bytesread)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
+          nmp->nm_ranode    = np;
+          nmp->nm_raoffset  = raend;
+          nmp->nm_ralen     = nread - (buflen - bytesread);
+          bytesread         = buflen;
         }
-
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
-
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (*ptr != 0)
+      else
         {
-          /* Yes... just skip over the attributes for now */
-
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          bytesread += nread;
         }
+    }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
-      /* Update the read state data */
-
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
-
-      /* Check if we hit the end of file */
-
-      if (tmp != 0)
+  np->n_rapos = filep->f_pos + bytesread;
+#else
+  if (buflen > 0)
+    {
+      nread = nfs_readrpcs(nmp, np, filep->f_pos, (FAR uint8_t *)buffer,
+                           buflen, NULL, 0);
+      if (nread < 0)
         {
-          break;
+          error = -nread;
+          goto errout_with_semaphore;
         }
+
+      bytesread = nread;
     }
+#endif
+
+  /* Update the read state data */
+
+  filep->f_pos += bytesread;
 
   finfo("Read %d bytes\n", bytesread);
   nfs_semgive(nmp);
@@ -972,14 +1625,7 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 {
   struct nfsmount       *nmp;
   struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
   ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
-  int                    committed = NFSV3WRITE_FILESYNC;
   int                    error;
 
   finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
@@ -1013,143 +1659,76 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Now loop until we send the entire user buffer */
-
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
+  if (buflen == 0)
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
-
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
-        {
-          writesize = nmp->nm_wsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
-        {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
-
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
-
-      /* Perform the write */
-
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write,
-                          sizeof(struct rpc_reply_write));
-      if (error)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
-        }
-
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+      nfs_semgive(nmp);
+      return 0;
+    }
 
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+#ifdef CONFIG_NFS_READAHEAD
+  /* Any read-ahead data of this file may be stale now */
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+  if (nmp->nm_ranode == np)
+    {
+      nmp->nm_ranode = NULL;
+    }
+#endif
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
+  /* Send the user buffer in pipelined WRITE RPCs */
 
-      /* Check if normal file attributes follow */
+  byteswritten = nfs_writerpcs(nmp, np, filep->f_pos,
+                               (FAR const uint8_t *)buffer, buflen);
+  if (byteswritten <= 0)
+    {
+      error = byteswritten < 0 ? -byteswritten : EIO;
+      goto errout_with_semaphore;
+    }
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+  /* Update the write state data */
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+  filep->f_pos += byteswritten;
+  if (filep->f_pos > np->n_size)
+    {
+      np->n_size = filep->f_pos;
+    }
 
-      /* Get the count of bytes actually written */
+  nfs_semgive(nmp);
+  return byteswritten;
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
 
-      if (tmp < 1 || tmp > writesize)
-        {
-          error = EIO;
-          goto errout_with_semaphore;
-        }
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Commit the data of UNSTABLE writes to the stable storage of the
+ *   server.
+ *
+ ****************************************************************************/
 
-      writesize = tmp;
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode *np;
+  int error;
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      /* Update the read state data */
+  DEBUGASSERT(nmp != NULL);
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error == OK)
+    {
+      error = nfs_filecommit(nmp, np);
     }
 
-  nfs_semgive(nmp);
-  return writesize;
-
-errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
@@ -1253,6 +1832,14 @@ static int nfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       goto errout_with_semaphore;
     }
 
+  /* Refresh the attributes if they are older than the cache timeout */
+
+  error = nfs_getattr(nmp, np);
+  if (error != OK)
+    {
+      goto errout_with_semaphore;
+    }
+
   /* Extract the file mode, file type, and file size from the nfsnode
    * structure.
    */
@@ -1325,6 +1912,13 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
 
   /* Then perform the SETATTR RPC to set the new file size */
 
+#ifdef CONFIG_NFS_READAHEAD
+  if (nmp->nm_ranode == np)
+    {
+      nmp->nm_ranode = NULL;
+    }
+#endif
+
   error = nfs_filetruncate(nmp, np, length);
 
 errout_with_semaphore:
@@ -1892,13 +2486,25 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   /* Create an instance of the mountpt state structure */
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* The read-ahead buffer follows the I/O buffer.  A READ RPC never
+   * returns more data than fits into the I/O buffer.
+   */
+
+  nmp = (FAR struct nfsmount *)kmm_zalloc(SIZEOF_nfsmount(buflen) + buflen);
+#else
   nmp = (FAR struct nfsmount *)kmm_zalloc(SIZEOF_nfsmount(buflen));
+#endif
   if (!nmp)
     {
       ferr("ERROR: Failed to allocate mountpoint structure\n");
       return ENOMEM;
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  nmp->nm_rabuffer = (FAR uint8_t *)nmp + SIZEOF_nfsmount(buflen);
+#endif
+
   /* Save the allocated I/O buffer size */
 
   nmp->nm_buflen = (uint16_t)buflen;
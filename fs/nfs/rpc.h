@@ -336,6 +336,12 @@ struct rpc_call_fs
   struct FS3args fs;
 };
 
+struct rpc_call_commit
+{
+  struct rpc_call_header ch;
+  struct COMMIT3args commit;
+};
+
 /* Generic RPC reply headers */
 
 struct rpc_reply_header
@@ -466,6 +472,13 @@ struct rpc_reply_getattr
   struct nfs_fattr attr;
 };
 
+struct rpc_reply_commit
+{
+  struct rpc_reply_header rh;
+  uint32_t status;
+  struct COMMIT3resok commit;
+};
+
 struct rpc_reply_setattr
 {
   struct rpc_reply_header rh;
@@ -500,5 +513,10 @@ void rpcclnt_safedisconnect(FAR struct rpcclnt *rpc);
 int  rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog, int version,
                      FAR void *request, size_t reqlen,
                      FAR void *response, size_t resplen);
+int  rpcclnt_send_request(FAR struct rpcclnt *rpc, int procnum, int prog,
+                          int version, FAR void *request, size_t reqlen,
+                          FAR uint32_t *xid);
+int  rpcclnt_receive_reply(FAR struct rpcclnt *rpc, FAR void *response,
+                           size_t resplen, FAR uint32_t *xid);
 
 #endif /* __FS_NFS_RPC_H */
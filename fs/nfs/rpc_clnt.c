@@ -142,6 +142,7 @@ static int rpcclnt_reply(FAR struct rpcclnt *rpc, int procid, int prog,
 static uint32_t rpcclnt_newxid(void);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
+static int rpcclnt_checkreply(FAR struct rpc_reply_header *replymsg);
 
 /****************************************************************************
  * Private Functions
@@ -323,6 +324,64 @@ static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
   ch->rpc_verf.authlen   = 0;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_checkreply
+ *
+ * Description:
+ *   Verify the RPC level of a reply message.  There may still be NFS layer
+ *   errors that will be detected by calling logic.
+ *
+ * Returned Value:
+ *   Returns zero on success or a (positive) errno value on failure.
+ *
+ ****************************************************************************/
+
+static int rpcclnt_checkreply(FAR struct rpc_reply_header *replymsg)
+{
+  uint32_t tmp;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp == RPC_MSGDENIED)
+    {
+      tmp = fxdr_unsigned(uint32_t, replymsg->status);
+      switch (tmp)
+        {
+        case RPC_MISMATCH:
+          ferr("ERROR: RPC_MSGDENIED: RPC_MISMATCH error\n");
+          return EOPNOTSUPP;
+
+        case RPC_AUTHERR:
+          ferr("ERROR: RPC_MSGDENIED: RPC_AUTHERR error\n");
+          return EACCES;
+
+        default:
+          return EOPNOTSUPP;
+        }
+    }
+  else if (tmp != RPC_MSGACCEPTED)
+    {
+      return EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else if (tmp == RPC_PROGMISMATCH)
+    {
+      ferr("ERROR: RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
+      return EOPNOTSUPP;
+    }
+  else if (tmp > 5)
+    {
+      ferr("ERROR: Unsupported RPC type: %d\n", tmp);
+      return EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -684,6 +743,69 @@ bad:
   return error;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_send_request
+ *
+ * Description:
+ *   Format the RPC CALL message with a new xid and send it without waiting
+ *   for the reply.  Used to keep several requests outstanding at the same
+ *   time.  The reply is collected with rpcclnt_receive_reply() and matched
+ *   to the request by the returned xid.
+ *
+ * Returned Value:
+ *   Returns zero on success or a (positive) errno value on failure.
+ *
+ ****************************************************************************/
+
+int rpcclnt_send_request(FAR struct rpcclnt *rpc, int procnum, int prog,
+                         int version, FAR void *request, size_t reqlen,
+                         FAR uint32_t *xid)
+{
+  *xid = rpcclnt_newxid();
+  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
+                    *xid, prog, version, procnum);
+
+  rpc_statistics(rpcrequests);
+  return rpcclnt_send(rpc, procnum, prog, request,
+                      reqlen + sizeof(struct rpc_call_header));
+}
+
+/****************************************************************************
+ * Name: rpcclnt_receive_reply
+ *
+ * Description:
+ *   Receive the next RPC reply message and verify its RPC level.  The xid
+ *   of the reply is returned in 'xid'.
+ *
+ * Returned Value:
+ *   Returns zero on success or a (positive) errno value on failure.
+ *   ETIMEDOUT is returned if no reply was received within the timeout.
+ *
+ ****************************************************************************/
+
+int rpcclnt_receive_reply(FAR struct rpcclnt *rpc, FAR void *response,
+                          size_t resplen, FAR uint32_t *xid)
+{
+  int error;
+
+  rpc->rc_timeout = false;
+  error = rpcclnt_reply(rpc, 0, 0, response, resplen);
+  if (error != OK)
+    {
+      if (rpc->rc_timeout)
+        {
+          rpc_statistics(rpctimeouts);
+          error = ETIMEDOUT;
+        }
+
+      return error;
+    }
+
+  *xid = fxdr_unsigned(uint32_t,
+                       ((FAR struct rpc_reply_header *)response)->rp_xid);
+  return rpcclnt_checkreply((FAR struct rpc_reply_header *)response);
+}
+
 /****************************************************************************
  * Name: rpcclnt_request
  *
@@ -704,7 +826,6 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     FAR void *response, size_t resplen)
 {
   struct rpc_reply_header *replymsg;
-  uint32_t tmp;
   uint32_t xid;
   int retries;
   int error = 0;
@@ -722,7 +843,8 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
    * the messages header).
    */
 
-  reqlen += sizeof(struct rpc_call_header);
+  reqlen  += sizeof(struct rpc_call_header);
+  replymsg = (FAR struct rpc_reply_header *)response;
 
   /* Send the RPC call messages and receive the RPC response.  A limited
    * number of re-tries will be attempted, but only for the case of response
@@ -745,18 +867,36 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
           finfo("ERROR rpcclnt_send failed: %d\n", error);
         }
 
-      /* Wait for the reply from our send */
+      /* Wait for the reply from our send.  Late replies to earlier
+       * requests, re-sent or abandoned, are discarded.
+       */
 
       else
         {
-          error = rpcclnt_reply(rpc, procnum, prog, response, resplen);
-          if (error != OK)
+          do
             {
-              finfo("ERROR rpcclnt_reply failed: %d\n", error);
+              error = rpcclnt_reply(rpc, procnum, prog, response, resplen);
+              if (error != OK)
+                {
+                  finfo("ERROR rpcclnt_reply failed: %d\n", error);
+                }
+              else if (replymsg->rp_xid != txdr_unsigned(xid))
+                {
+                  finfo("Discarding reply to xid %08lx\n",
+                        (unsigned long)fxdr_unsigned(uint32_t,
+                                                     replymsg->rp_xid));
+                  rpc_statistics(rpcinvalid);
+                  error = EAGAIN;
+                }
             }
+          while (error == EAGAIN && !rpc->rc_timeout);
         }
 
       retries++;
+      if (rpc->rc_timeout)
+        {
+          rpc_statistics(rpcretries);
+        }
     }
   while (rpc->rc_timeout && retries <= rpc->rc_retry);
 
@@ -768,46 +908,5 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
 
   /* Break down the RPC header and check if it is OK */
 
-  replymsg = (FAR struct rpc_reply_header *)response;
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp == RPC_MSGDENIED)
-    {
-      tmp = fxdr_unsigned(uint32_t, replymsg->status);
-      switch (tmp)
-        {
-        case RPC_MISMATCH:
-          ferr("ERROR: RPC_MSGDENIED: RPC_MISMATCH error\n");
-          return EOPNOTSUPP;
-
-        case RPC_AUTHERR:
-          ferr("ERROR: RPC_MSGDENIED: RPC_AUTHERR error\n");
-          return EACCES;
-
-        default:
-          return EOPNOTSUPP;
-        }
-    }
-  else if (tmp != RPC_MSGACCEPTED)
-    {
-      return EOPNOTSUPP;
-    }
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
-    {
-      finfo("RPC_SUCCESS\n");
-    }
-  else if (tmp == RPC_PROGMISMATCH)
-    {
-      ferr("ERROR: RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
-      return EOPNOTSUPP;
-    }
-  else if (tmp > 5)
-    {
-      ferr("ERROR: Unsupported RPC type: %d\n", tmp);
-      return EOPNOTSUPP;
-    }
-
-  return OK;
+  return rpcclnt_checkreply(replymsg);
 }
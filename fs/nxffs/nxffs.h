@@ -53,6 +53,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -167,6 +171,19 @@
 #define INODE_STATE_FILE          (CONFIG_NXFFS_ERASEDSTATE ^ 0x22)
 #define INODE_STATE_DELETED       (CONFIG_NXFFS_ERASEDSTATE ^ 0xaa)
 
+/* Values for the state of a checkpoint record:
+ *
+ * CKPT_STATE_VALID - The record describes the current volume limits.
+ * CKPT_STATE_STALE - The volume was changed in a way that the record does
+ *                    not describe (i.e., it is being packed).
+ *
+ * The VALID to STALE transition only involves burning bits from the erased
+ * to non-erased state.
+ */
+
+#define CKPT_STATE_VALID          (CONFIG_NXFFS_ERASEDSTATE ^ 0x33)
+#define CKPT_STATE_STALE          (CONFIG_NXFFS_ERASEDSTATE ^ 0xff)
+
 /* Number of bytes in an the NXFFS magic sequences */
 
 #define NXFFS_MAGICSIZE	          4
@@ -233,6 +250,20 @@ struct nxffs_data_s
 };
 #define SIZEOF_NXFFS_DATA_HDR 10
 
+/* This structure defines each packed checkpoint record.  The records are
+ * appended to the reserved, final erase block of the volume.
+ */
+
+struct nxffs_ckpt_s
+{
+  uint8_t                   magic[4];  /* 0-3: Magic number for valid record */
+  uint8_t                   state;     /* 4: Record state: See CKPT_STATE_* */
+  uint8_t                   inoffs[4]; /* 5-8: FLASH offset to the first inode */
+  uint8_t                   froffs[4]; /* 9-12: FLASH offset to free FLASH */
+  uint8_t                   crc[4];    /* 13-16: CRC32 */
+};
+#define SIZEOF_NXFFS_CKPT 17
+
 /* This is an in-memory representation of the NXFFS inode as extracted from
  * FLASH and with additional state information.
  */
@@ -302,6 +333,15 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_CHECKPOINT
+  off_t                     ckeblock;  /* The erase block holding checkpoints */
+  uint16_t                  ckslot;    /* Next free checkpoint record */
+  bool                      ckvalid;   /* The last record is valid */
+#endif
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+  bool                      reclaim;   /* Inodes were deleted since the last pack */
+  struct work_s             packwork;  /* Supports background packing */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1082,6 +1122,123 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_schedpack
+ *
+ * Description:
+ *   Schedule packing of the volume on the low-priority work queue if the
+ *   free FLASH has dropped below CONFIG_NXFFS_PACK_WATERMARK percent of the
+ *   volume and if inodes were deleted since the volume was last packed.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume exclsem.
+ *
+ * Defined in nxffs_pack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+void nxffs_schedpack(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_rdcheckpoint
+ *
+ * Description:
+ *   Find the most recent checkpoint record and, if it is valid, return the
+ *   volume limits that it holds.  Also determines where the next record
+ *   will be written.
+ *
+ * Input Parameters:
+ *   volume   - Describes the NXFFS volume
+ *   inoffset - Location to return the offset to the first inode
+ *   froffset - Location to return the offset to the free FLASH region
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if there is no valid record.  Other negated
+ *   errno values are returned in the case of MTD failures.
+ *
+ * Defined in nxffs_checkpoint.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_CHECKPOINT
+int nxffs_rdcheckpoint(FAR struct nxffs_volume_s *volume,
+                       FAR off_t *inoffset, FAR off_t *froffset);
+
+/****************************************************************************
+ * Name: nxffs_wrcheckpoint
+ *
+ * Description:
+ *   Append a checkpoint record with the current volume limits.  The
+ *   checkpoint erase block is erased first if it is full.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ * Assumptions:
+ *   There is no writer.  The pack buffer is not in use.
+ *
+ * Defined in nxffs_checkpoint.c
+ *
+ ****************************************************************************/
+
+int nxffs_wrcheckpoint(FAR struct nxffs_volume_s *volume);
+
+/****************************************************************************
+ * Name: nxffs_invcheckpoint
+ *
+ * Description:
+ *   Mark the most recent checkpoint record as stale.  This must be done
+ *   before the volume limits change in a way that does not simply append
+ *   to the volume.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ * Assumptions:
+ *   The pack buffer is not in use.
+ *
+ * Defined in nxffs_checkpoint.c
+ *
+ ****************************************************************************/
+
+int nxffs_invcheckpoint(FAR struct nxffs_volume_s *volume);
+
+/****************************************************************************
+ * Name: nxffs_fmtcheckpoint
+ *
+ * Description:
+ *   Erase the checkpoint erase block as part of reformatting the volume.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ * Defined in nxffs_checkpoint.c
+ *
+ ****************************************************************************/
+
+int nxffs_fmtcheckpoint(FAR struct nxffs_volume_s *volume);
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
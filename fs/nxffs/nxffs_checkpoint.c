@@ -0,0 +1,390 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_checkpoint.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <crc32.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mtd/mtd.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_CHECKPOINT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Checkpoint records do not span R/W blocks */
+
+#define NXFFS_CKPERBLOCK(v) ((v)->geo.blocksize / SIZEOF_NXFFS_CKPT)
+#define NXFFS_NCKSLOTS(v)   (NXFFS_CKPERBLOCK(v) * (v)->blkper)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The magic number that appears that the beginning of each checkpoint
+ * record.
+ */
+
+static const uint8_t g_ckptmagic[NXFFS_MAGICSIZE] =
+{
+  'C', 'k', 'p', 't'
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_ckcrc
+ *
+ * Description:
+ *   Calculate the CRC of a checkpoint record.  The state is not included
+ *   so that the record can be marked stale in place.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_ckcrc(FAR const struct nxffs_ckpt_s *ckpt)
+{
+  struct nxffs_ckpt_s tmp;
+
+  memcpy(&tmp, ckpt, SIZEOF_NXFFS_CKPT);
+  tmp.state = CONFIG_NXFFS_ERASEDSTATE;
+  nxffs_wrle32(tmp.crc, 0);
+
+  return crc32((FAR const uint8_t *)&tmp, SIZEOF_NXFFS_CKPT);
+}
+
+/****************************************************************************
+ * Name: nxffs_ckerased
+ *
+ * Description:
+ *   Return true if the checkpoint record slot was never written.
+ *
+ ****************************************************************************/
+
+static bool nxffs_ckerased(FAR const uint8_t *slot)
+{
+  int i;
+
+  for (i = 0; i < SIZEOF_NXFFS_CKPT; i++)
+    {
+      if (slot[i] != CONFIG_NXFFS_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxffs_ckslot
+ *
+ * Description:
+ *   Read the R/W block holding the checkpoint record slot into the pack
+ *   buffer and return the location of the slot in that buffer.
+ *
+ ****************************************************************************/
+
+static FAR struct nxffs_ckpt_s *
+nxffs_ckslot(FAR struct nxffs_volume_s *volume, uint16_t slot,
+             FAR off_t *block)
+{
+  ssize_t nxfrd;
+
+  *block = volume->ckeblock * volume->blkper +
+           slot / NXFFS_CKPERBLOCK(volume);
+
+  nxfrd = MTD_BREAD(volume->mtd, *block, 1, volume->pack);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Read checkpoint block %d failed: %d\n", *block, nxfrd);
+      return NULL;
+    }
+
+  return (FAR struct nxffs_ckpt_s *)
+    &volume->pack[(slot % NXFFS_CKPERBLOCK(volume)) * SIZEOF_NXFFS_CKPT];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_rdcheckpoint
+ *
+ * Description:
+ *   Find the most recent checkpoint record and, if it is valid, return the
+ *   volume limits that it holds.  Also determines where the next record
+ *   will be written.
+ *
+ * Input Parameters:
+ *   volume   - Describes the NXFFS volume
+ *   inoffset - Location to return the offset to the first inode
+ *   froffset - Location to return the offset to the free FLASH region
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if there is no valid record.  Other negated
+ *   errno values are returned in the case of MTD failures.
+ *
+ ****************************************************************************/
+
+int nxffs_rdcheckpoint(FAR struct nxffs_volume_s *volume,
+                       FAR off_t *inoffset, FAR off_t *froffset)
+{
+  struct nxffs_ckpt_s last;
+  FAR struct nxffs_ckpt_s *ckpt;
+  off_t volsize;
+  off_t block;
+  uint16_t nslots = NXFFS_NCKSLOTS(volume);
+  uint16_t slot;
+  bool found = false;
+
+  /* Records are appended in order.  The first erased slot follows the most
+   * recent record.  Anything else that is not a record means that the
+   * block must be erased before it is used again.
+   */
+
+  for (slot = 0; slot < nslots; slot++)
+    {
+      if (slot % NXFFS_CKPERBLOCK(volume) == 0)
+        {
+          ckpt = nxffs_ckslot(volume, slot, &block);
+          if (ckpt == NULL)
+            {
+              volume->ckslot  = nslots;
+              volume->ckvalid = false;
+              return -EIO;
+            }
+        }
+      else
+        {
+          ckpt = (FAR struct nxffs_ckpt_s *)
+            ((FAR uint8_t *)ckpt + SIZEOF_NXFFS_CKPT);
+        }
+
+      if (nxffs_ckerased((FAR const uint8_t *)ckpt))
+        {
+          break;
+        }
+
+      if (memcmp(ckpt->magic, g_ckptmagic, NXFFS_MAGICSIZE) != 0)
+        {
+          slot  = nslots;
+          found = false;
+          break;
+        }
+
+      memcpy(&last, ckpt, SIZEOF_NXFFS_CKPT);
+      found = true;
+    }
+
+  volume->ckslot  = slot;
+  volume->ckvalid = false;
+
+  if (!found || last.state != CKPT_STATE_VALID ||
+      nxffs_rdle32(last.crc) != nxffs_ckcrc(&last))
+    {
+      finfo("No valid checkpoint\n");
+      return -ENOENT;
+    }
+
+  *inoffset = nxffs_rdle32(last.inoffs);
+  *froffset = nxffs_rdle32(last.froffs);
+
+  volsize = volume->nblocks * volume->geo.blocksize;
+  if (*inoffset > *froffset || *froffset > volsize)
+    {
+      ferr("ERROR: Bad checkpoint: %d %d\n", *inoffset, *froffset);
+      return -ENOENT;
+    }
+
+  volume->ckvalid = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_wrcheckpoint
+ *
+ * Description:
+ *   Append a checkpoint record with the current volume limits.  The
+ *   checkpoint erase block is erased first if it is full.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_wrcheckpoint(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_ckpt_s *ckpt;
+  ssize_t nxfrd;
+  off_t block;
+  int ret;
+
+  if (volume->ckslot >= NXFFS_NCKSLOTS(volume))
+    {
+      ret = nxffs_fmtcheckpoint(volume);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ckpt = nxffs_ckslot(volume, volume->ckslot, &block);
+  if (ckpt == NULL)
+    {
+      return -EIO;
+    }
+
+  memcpy(ckpt->magic, g_ckptmagic, NXFFS_MAGICSIZE);
+  ckpt->state = CKPT_STATE_VALID;
+  nxffs_wrle32(ckpt->inoffs, volume->inoffset);
+  nxffs_wrle32(ckpt->froffs, volume->froffset);
+  nxffs_wrle32(ckpt->crc, nxffs_ckcrc(ckpt));
+
+  /* Consume the slot even if the write fails.  It may be partially
+   * written.
+   */
+
+  volume->ckslot++;
+  volume->ckvalid = false;
+
+  nxfrd = MTD_BWRITE(volume->mtd, block, 1, volume->pack);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write checkpoint block %d failed: %d\n", block, nxfrd);
+      return -EIO;
+    }
+
+  volume->ckvalid = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_invcheckpoint
+ *
+ * Description:
+ *   Mark the most recent checkpoint record as stale.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_invcheckpoint(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_ckpt_s *ckpt;
+  ssize_t nxfrd;
+  off_t block;
+
+  if (!volume->ckvalid)
+    {
+      return OK;
+    }
+
+  DEBUGASSERT(volume->ckslot > 0);
+
+  ckpt = nxffs_ckslot(volume, volume->ckslot - 1, &block);
+  if (ckpt == NULL)
+    {
+      return -EIO;
+    }
+
+  ckpt->state = CKPT_STATE_STALE;
+
+  nxfrd = MTD_BWRITE(volume->mtd, block, 1, volume->pack);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write checkpoint block %d failed: %d\n", block, nxfrd);
+      return -EIO;
+    }
+
+  volume->ckvalid = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_fmtcheckpoint
+ *
+ * Description:
+ *   Erase the checkpoint erase block.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_fmtcheckpoint(FAR struct nxffs_volume_s *volume)
+{
+  int ret;
+
+  ret = MTD_ERASE(volume->mtd, volume->ckeblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase checkpoint block %d failed: %d\n",
+           volume->ckeblock, ret);
+      return ret;
+    }
+
+  volume->ckslot  = 0;
+  volume->ckvalid = false;
+  return OK;
+}
+
+#endif /* CONFIG_NXFFS_CHECKPOINT */
@@ -134,6 +134,183 @@ const uint8_t g_datamagic[NXFFS_MAGICSIZE] =
 struct nxffs_volume_s g_volume;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_scanlimits
+ *
+ * Description:
+ *   Scan the FLASH for the file system limits.  The search for the first
+ *   inode begins no earlier than 'start' and the search for the free FLASH
+ *   region begins no earlier than 'tail'.  Both are zero to scan the whole
+ *   volume.
+ *
+ ****************************************************************************/
+
+static int nxffs_scanlimits(FAR struct nxffs_volume_s *volume, off_t start,
+                            off_t tail)
+{
+  FAR struct nxffs_entry_s entry;
+  off_t block;
+  off_t offset;
+  bool noinodes = false;
+  int nerased;
+  int ret;
+
+  /* Get the offset to the first valid block on the FLASH */
+
+  block = 0;
+  ret = nxffs_validblock(volume, &block);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to find a valid block: %d\n", -ret);
+      return ret;
+    }
+
+  /* Then find the first valid inode in or beyond the first valid block */
+
+  offset = block * volume->geo.blocksize;
+  if (offset < start)
+    {
+      offset = start;
+    }
+
+  ret = nxffs_nextentry(volume, offset, &entry);
+  if (ret < 0)
+    {
+      /* The value -ENOENT is special.  This simply means that the FLASH
+       * was searched to the end and no valid inode was found... the file
+       * system is empty (or, in more perverse cases, all inodes are
+       * deleted or corrupted).
+       */
+
+      if (ret != -ENOENT)
+        {
+          ferr("ERROR: nxffs_nextentry failed: %d\n", -ret);
+          return ret;
+        }
+
+      /* Set a flag the just indicates that no inodes were found.  Later,
+       * we will set the location of the first inode to be the same as
+       * the location of the free FLASH region.
+       */
+
+      finfo("No inodes found\n");
+      noinodes = true;
+    }
+  else
+    {
+      /* Save the offset to the first inode */
+
+      volume->inoffset = entry.hoffset;
+      finfo("First inode at offset %d\n", volume->inoffset);
+
+      /* Discard this entry and set the next offset. */
+
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+    }
+
+  /* Everything before the tail is already known to be in use */
+
+  if (offset < tail)
+    {
+      offset = tail;
+    }
+
+  /* Now, search for the last valid entry */
+
+  if (!noinodes)
+    {
+      while (nxffs_nextentry(volume, offset, &entry) == OK)
+        {
+          /* Discard the entry and guess the next offset. */
+
+          offset = nxffs_inodeend(volume, &entry);
+          nxffs_freeentry(&entry);
+        }
+
+      finfo("Last inode before offset %d\n", offset);
+    }
+
+  /* No inodes were found after this offset.  Now search for a block of
+   * erased flash.
+   */
+
+  nxffs_ioseek(volume, offset);
+  nerased = 0;
+  for (; ; )
+    {
+      int ch = nxffs_getc(volume, 1);
+      if (ch < 0)
+        {
+          /* Failed to read the next byte... this could mean that the FLASH
+           * is full?
+           */
+
+          if (volume->ioblock + 1 >= volume->nblocks &&
+              volume->iooffset + 1 >= volume->geo.blocksize)
+            {
+              /* Yes.. the FLASH is full.  Force the offsets to the end of FLASH */
+
+              volume->froffset = volume->nblocks * volume->geo.blocksize;
+              finfo("Assume no free FLASH, froffset: %d\n", volume->froffset);
+              if (noinodes)
+                {
+                  volume->inoffset = volume->froffset;
+                  finfo("No inodes, inoffset: %d\n", volume->inoffset);
+                }
+
+              return OK;
+            }
+
+          /* No?  Then it is some other failure that we do not know how to handle */
+
+          ferr("ERROR: nxffs_getc failed: %d\n", -ch);
+          return ch;
+        }
+
+      /* Check for another erased byte */
+
+      else if (ch == CONFIG_NXFFS_ERASEDSTATE)
+        {
+          /* If we have encountered NXFFS_NERASED number of consecutive
+           * erased bytes, then presume we have reached the end of valid
+           * data.
+           */
+
+          if (++nerased >= NXFFS_NERASED)
+            {
+              /* Okay.. we have a long stretch of erased FLASH in a valid
+               * FLASH block.  Let's say that this is the beginning of
+               * the free FLASH region.
+               */
+
+              volume->froffset = offset;
+              finfo("Free FLASH region begins at offset: %d\n", volume->froffset);
+              if (noinodes)
+                {
+                  volume->inoffset = offset;
+                  finfo("First inode at offset %d\n", volume->inoffset);
+                }
+
+              return OK;
+            }
+        }
+      else
+        {
+          offset += nerased + 1;
+          nerased = 0;
+        }
+    }
+
+  /* Won't get here */
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -229,6 +406,24 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
    */
 
   volume->blkper  = volume->geo.erasesize / volume->geo.blocksize;
+
+#ifdef CONFIG_NXFFS_CHECKPOINT
+  /* The final erase block is reserved for the checkpoint records and is not
+   * part of the volume.
+   */
+
+  if (volume->geo.neraseblocks < 2 ||
+      volume->geo.blocksize < SIZEOF_NXFFS_CKPT)
+    {
+      ferr("ERROR: Volume too small for a checkpoint\n");
+      ret = -EINVAL;
+      goto errout_with_buffer;
+    }
+
+  volume->geo.neraseblocks--;
+  volume->ckeblock = volume->geo.neraseblocks;
+#endif
+
   volume->nblocks = volume->geo.neraseblocks * volume->blkper;
   DEBUGASSERT((off_t)volume->blkper * volume->geo.blocksize == volume->geo.erasesize);
 
@@ -339,6 +534,10 @@ errout_with_volume:
  *   data is written, or (2) recalculated as part of the file system packing
  *   operation.
  *
+ *   If there is a valid checkpoint, only the FLASH written after the
+ *   checkpoint is scanned.  A new checkpoint is written if the limits
+ *   changed.
+ *
  * Input Parameters:
  *   volume - Identifies the NXFFS volume
  *
@@ -350,151 +549,43 @@ errout_with_volume:
 
 int nxffs_limits(FAR struct nxffs_volume_s *volume)
 {
-  FAR struct nxffs_entry_s entry;
-  off_t block;
-  off_t offset;
-  bool noinodes = false;
-  int nerased;
+#ifdef CONFIG_NXFFS_CHECKPOINT
+  off_t inoffset;
+  off_t froffset;
   int ret;
 
-  /* Get the offset to the first valid block on the FLASH */
-
-  block = 0;
-  ret = nxffs_validblock(volume, &block);
-  if (ret < 0)
-    {
-      ferr("ERROR: Failed to find a valid block: %d\n", -ret);
-      return ret;
-    }
-
-  /* Then find the first valid inode in or beyond the first valid block */
-
-  offset = block * volume->geo.blocksize;
-  ret = nxffs_nextentry(volume, offset, &entry);
-  if (ret < 0)
+  ret = nxffs_rdcheckpoint(volume, &inoffset, &froffset);
+  if (ret == OK)
     {
-      /* The value -ENOENT is special.  This simply means that the FLASH
-       * was searched to the end and no valid inode was found... the file
-       * system is empty (or, in more perverse cases, all inodes are
-       * deleted or corrupted).
-       */
-
-      if (ret != -ENOENT)
+      ret = nxffs_scanlimits(volume, inoffset, froffset);
+      if (ret == OK && volume->inoffset == inoffset &&
+          volume->froffset == froffset)
         {
-          ferr("ERROR: nxffs_nextentry failed: %d\n", -ret);
-          return ret;
+          return OK;
         }
-
-      /* Set a flag the just indicates that no inodes were found.  Later,
-       * we will set the location of the first inode to be the same as
-       * the location of the free FLASH region.
-       */
-
-      finfo("No inodes found\n");
-      noinodes = true;
-    }
-  else
-    {
-      /* Save the offset to the first inode */
-
-      volume->inoffset = entry.hoffset;
-      finfo("First inode at offset %d\n", volume->inoffset);
-
-      /* Discard this entry and set the next offset. */
-
-      offset = nxffs_inodeend(volume, &entry);
-      nxffs_freeentry(&entry);
     }
 
-  /* Now, search for the last valid entry */
-
-  if (!noinodes)
+  if (ret < 0)
     {
-      while (nxffs_nextentry(volume, offset, &entry) == OK)
+      ret = nxffs_scanlimits(volume, 0, 0);
+      if (ret < 0)
         {
-          /* Discard the entry and guess the next offset. */
-
-          offset = nxffs_inodeend(volume, &entry);
-          nxffs_freeentry(&entry);
+          return ret;
         }
-
-      finfo("Last inode before offset %d\n", offset);
     }
 
-  /* No inodes were found after this offset.  Now search for a block of
-   * erased flash.
-   */
+  /* A failure to write the checkpoint only costs a full scan next time */
 
-  nxffs_ioseek(volume, offset);
-  nerased = 0;
-  for (; ; )
+  ret = nxffs_wrcheckpoint(volume);
+  if (ret < 0)
     {
-      int ch = nxffs_getc(volume, 1);
-      if (ch < 0)
-        {
-          /* Failed to read the next byte... this could mean that the FLASH
-           * is full?
-           */
-
-          if (volume->ioblock + 1 >= volume->nblocks &&
-              volume->iooffset + 1 >= volume->geo.blocksize)
-            {
-              /* Yes.. the FLASH is full.  Force the offsets to the end of FLASH */
-
-              volume->froffset = volume->nblocks * volume->geo.blocksize;
-              finfo("Assume no free FLASH, froffset: %d\n", volume->froffset);
-              if (noinodes)
-                {
-                  volume->inoffset = volume->froffset;
-                  finfo("No inodes, inoffset: %d\n", volume->inoffset);
-                }
-
-              return OK;
-            }
-
-          /* No?  Then it is some other failure that we do not know how to handle */
-
-          ferr("ERROR: nxffs_getc failed: %d\n", -ch);
-          return ch;
-        }
-
-      /* Check for another erased byte */
-
-      else if (ch == CONFIG_NXFFS_ERASEDSTATE)
-        {
-          /* If we have encountered NXFFS_NERASED number of consecutive
-           * erased bytes, then presume we have reached the end of valid
-           * data.
-           */
-
-          if (++nerased >= NXFFS_NERASED)
-            {
-              /* Okay.. we have a long stretch of erased FLASH in a valid
-               * FLASH block.  Let's say that this is the beginning of
-               * the free FLASH region.
-               */
-
-              volume->froffset = offset;
-              finfo("Free FLASH region begins at offset: %d\n", volume->froffset);
-              if (noinodes)
-                {
-                  volume->inoffset = offset;
-                  finfo("First inode at offset %d\n", volume->inoffset);
-                }
-
-              return OK;
-            }
-        }
-      else
-        {
-          offset += nerased + 1;
-          nerased = 0;
-        }
+      fwarn("WARNING: Failed to write a checkpoint: %d\n", -ret);
     }
 
-  /* Won't get here */
-
   return OK;
+#else
+  return nxffs_scanlimits(volume, 0, 0);
+#endif
 }
 
 /****************************************************************************
@@ -1168,6 +1168,17 @@ int nxffs_close(FAR struct file *filep)
       if ((ofile->oflags & O_WROK) != 0)
         {
           ret = nxffs_wrclose(volume, (FAR struct nxffs_wrfile_s *)ofile);
+
+#ifdef CONFIG_NXFFS_CHECKPOINT
+          /* Record the new end of the volume so that the next mount does
+           * not have to scan the FLASH written before it.
+           */
+
+          if (ret >= 0 && nxffs_wrcheckpoint(volume) < 0)
+            {
+              fwarn("WARNING: Failed to write a checkpoint\n");
+            }
+#endif
         }
 
       /* Release all resouces held by the open file */
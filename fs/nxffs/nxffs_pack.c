@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 
 #include "nxffs.h"
 
@@ -1252,11 +1253,7 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxffs_pack
+ * Name: nxffs_packvolume
  *
  * Description:
  *   Pack and re-write the filesystem in order to free up memory at the end
@@ -1271,7 +1268,7 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
  *
  ****************************************************************************/
 
-int nxffs_pack(FAR struct nxffs_volume_s *volume)
+static int nxffs_packvolume(FAR struct nxffs_volume_s *volume)
 {
   struct nxffs_pack_s pack;
   FAR struct nxffs_wrfile_s *wrfile;
@@ -1609,3 +1606,163 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_belowmark
+ *
+ * Description:
+ *   Return true if the free FLASH at the end of the volume is below
+ *   CONFIG_NXFFS_PACK_WATERMARK percent of the volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+static bool nxffs_belowmark(FAR struct nxffs_volume_s *volume)
+{
+  off_t volsize = volume->nblocks * volume->geo.blocksize;
+
+  return volsize - volume->froffset <
+         (volsize / 100) * CONFIG_NXFFS_PACK_WATERMARK;
+}
+
+/****************************************************************************
+ * Name: nxffs_packworker
+ *
+ * Description:
+ *   Pack the volume on the low-priority work queue.  Packing is skipped
+ *   while a file is open for writing:  The writer will schedule packing
+ *   again when it deletes the previous version of the file, or it will
+ *   pack the volume itself if it runs out of FLASH.
+ *
+ ****************************************************************************/
+
+static void nxffs_packworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&volume->exclsem);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  if (volume->reclaim && nxffs_belowmark(volume) &&
+      nxffs_findwriter(volume) == NULL)
+    {
+      finfo("Background pack, froffset: %d\n", volume->froffset);
+
+      ret = nxffs_pack(volume);
+      if (ret < 0)
+        {
+          ferr("ERROR: Background pack failed: %d\n", -ret);
+        }
+    }
+
+  nxsem_post(&volume->exclsem);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_pack
+ *
+ * Description:
+ *   Pack and re-write the filesystem in order to free up memory at the end
+ *   of FLASH.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_pack(FAR struct nxffs_volume_s *volume)
+{
+  int ret;
+
+#ifdef CONFIG_NXFFS_CHECKPOINT
+  /* Packing moves inodes.  The checkpoint must not be trusted until a new
+   * one is written.
+   */
+
+  ret = nxffs_invcheckpoint(volume);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+  ret = nxffs_packvolume(volume);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Inodes may have been moved in front of the first inode.  The packed
+   * inodes begin in the first valid block.
+   */
+
+  volume->ioblock = 0;
+  if (nxffs_validblock(volume, &volume->ioblock) == OK)
+    {
+      volume->iooffset = SIZEOF_NXFFS_BLOCK_HDR;
+      volume->inoffset = MIN(volume->froffset, nxffs_iotell(volume));
+    }
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+  volume->reclaim = false;
+#endif
+
+#ifdef CONFIG_NXFFS_CHECKPOINT
+  /* A writer may not have written its inode header yet.  Its close will
+   * write the next checkpoint.
+   */
+
+  if (nxffs_findwriter(volume) == NULL)
+    {
+      ret = nxffs_wrcheckpoint(volume);
+      if (ret < 0)
+        {
+          fwarn("WARNING: Failed to write a checkpoint: %d\n", -ret);
+          ret = OK;
+        }
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_schedpack
+ *
+ * Description:
+ *   Schedule packing of the volume on the low-priority work queue if the
+ *   free FLASH has dropped below CONFIG_NXFFS_PACK_WATERMARK percent of the
+ *   volume and if inodes were deleted since the volume was last packed.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+void nxffs_schedpack(FAR struct nxffs_volume_s *volume)
+{
+  if (volume->reclaim && nxffs_belowmark(volume) &&
+      work_available(&volume->packwork))
+    {
+      work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume,
+                 MSEC2TICK(CONFIG_NXFFS_PACK_DELAY));
+    }
+}
+#endif
@@ -281,6 +281,16 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
 {
   int ret;
 
+#ifdef CONFIG_NXFFS_CHECKPOINT
+  /* Forget the checkpoints first.  They do not describe the new volume. */
+
+  ret = nxffs_fmtcheckpoint(volume);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Erase and reformat the entire volume */
 
   ret = nxffs_format(volume);
@@ -130,6 +130,15 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+  else
+    {
+      /* The FLASH held by the inode can now be reclaimed */
+
+      volume->reclaim = true;
+      nxffs_schedpack(volume);
+    }
+#endif
 
 errout_with_entry:
   nxffs_freeentry(&entry);
@@ -1,7 +1,7 @@
 /****************************************************************************
  * fs/procfs/fs_procfs.c
  *
- *   Copyright (C) 2013-2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2013-2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -79,8 +79,18 @@
 extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations irq_operations;
 extern const struct procfs_operations cpuload_operations;
+extern const struct procfs_operations cpuacct_operations;
 extern const struct procfs_operations critmon_operations;
 extern const struct procfs_operations meminfo_operations;
+extern const struct procfs_operations memtrace_operations;
+extern const struct procfs_operations heapstats_operations;
+extern const struct procfs_operations mempool_operations;
+extern const struct procfs_operations mutexspin_operations;
+extern const struct procfs_operations spinlock_operations;
+extern const struct procfs_operations tasks_operations;
+extern const struct procfs_operations syscalls_operations;
+extern const struct procfs_operations paging_operations;
+extern const struct procfs_operations profile_operations;
 extern const struct procfs_operations iobinfo_operations;
 extern const struct procfs_operations module_operations;
 extern const struct procfs_operations uptime_operations;
@@ -97,6 +107,8 @@ extern const struct procfs_operations net_procfs_routeoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations mount_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
+extern const struct procfs_operations littlefs_procfsoperations;
+extern const struct procfs_operations spiffs_procfsoperations;
 
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
@@ -128,6 +140,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "cpuload",       &cpuload_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_CPUACCT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPUACCT)
+  { "cpuacct",       &cpuacct_operations,         PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_SCHED_CRITMONITOR)
   { "critmon",       &critmon_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -140,6 +156,41 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "meminfo",       &meminfo_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
+  { "mempool",       &mempool_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_TRACE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMTRACE)
+  { "memtrace",      &memtrace_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_HEAPSTATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAPSTATS)
+  { "heapstats",     &heapstats_operations,       PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_PTHREAD_MUTEX_SPINSTATS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MUTEXSPIN)
+  { "mutexspin",     &mutexspin_operations,       PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SPINLOCK_STATISTICS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SPINLOCKS)
+  { "spinlocks",     &spinlock_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_LIB_SYSCALL_STATS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SYSCALLS)
+  { "syscalls",      &syscalls_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_PAGING_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGING)
+  { "paging",        &paging_operations,          PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PROFILE)
+  { "profile",       &profile_operations,         PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",       &iobinfo_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -164,6 +215,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/smartfs**",  &smartfs_procfsoperations,   PROCFS_UNKOWN_TYPE },
 #endif
 
+#if defined(CONFIG_FS_LITTLEFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS)
+  { "fs/littlefs",   &littlefs_procfsoperations,  PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_FS_SPIFFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+  { "fs/spiffs",     &spiffs_procfsoperations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_NET) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
   { "net",           &net_procfsoperations,       PROCFS_DIR_TYPE    },
 #if defined(CONFIG_NET_ROUTE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_ROUTE)
@@ -182,6 +241,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "self/**",       &proc_operations,            PROCFS_UNKOWN_TYPE },
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_TASKS)
+  { "tasks",         &tasks_operations,           PROCFS_FILE_TYPE   },
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
   { "uptime",        &uptime_operations,          PROCFS_FILE_TYPE   },
 #endif
@@ -0,0 +1,328 @@
+/****************************************************************************
+ * fs/procfs/fs_procfscpuacct.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_SCHED_CPUACCT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPUACCT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define CPUACCT_LINELEN 80
+
+#ifdef CONFIG_SMP
+#  define CPUACCT_NCPUS   CONFIG_SMP_NCPUS
+#else
+#  define CPUACCT_NCPUS   1
+#endif
+
+/* Times are shown in seconds with nanosecond resolution */
+
+#define CPUACCT_SEC(t)    ((unsigned long)((t) / NSEC_PER_SEC))
+#define CPUACCT_NSEC(t)   ((unsigned long)((t) % NSEC_PER_SEC))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct cpuacct_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[CPUACCT_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     cpuacct_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     cpuacct_close(FAR struct file *filep);
+static ssize_t cpuacct_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     cpuacct_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     cpuacct_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations cpuacct_operations =
+{
+  cpuacct_open,   /* open */
+  cpuacct_close,  /* close */
+  cpuacct_read,   /* read */
+  NULL,             /* write */
+  cpuacct_dup,    /* dup */
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+  cpuacct_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpuacct_open
+ ****************************************************************************/
+
+static int cpuacct_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct cpuacct_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "cpuacct" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "cpuacct") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct cpuacct_file_s *)
+    kmm_zalloc(sizeof(struct cpuacct_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpuacct_close
+ ****************************************************************************/
+
+static int cpuacct_close(FAR struct file *filep)
+{
+  FAR struct cpuacct_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct cpuacct_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpuacct_read
+ ****************************************************************************/
+
+static ssize_t cpuacct_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct cpuacct_file_s *procfile;
+  struct cpuacct_cpu_s cpuacct;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int cpu;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct cpuacct_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The first line is the headers */
+
+  linesize  = snprintf(procfile->line, CPUACCT_LINELEN,
+                       "%-4s%21s%21s%21s\n",
+                       "CPU", "busy", "idle", "irq");
+  totalsize = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+
+  /* Followed by one line for each CPU */
+
+  for (cpu = 0; cpu < CPUACCT_NCPUS && totalsize < buflen; cpu++)
+    {
+      DEBUGVERIFY(clock_cpuacct_cpu(cpu, &cpuacct));
+
+      linesize = snprintf(procfile->line, CPUACCT_LINELEN,
+                          "%-4d%11lu.%09lu%11lu.%09lu%11lu.%09lu\n", cpu,
+                          CPUACCT_SEC(cpuacct.busy),
+                          CPUACCT_NSEC(cpuacct.busy),
+                          CPUACCT_SEC(cpuacct.idle),
+                          CPUACCT_NSEC(cpuacct.idle),
+                          CPUACCT_SEC(cpuacct.irq),
+                          CPUACCT_NSEC(cpuacct.irq));
+      copysize = procfs_memcpy(procfile->line, linesize,
+                               buffer + totalsize, buflen - totalsize,
+                               &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: cpuacct_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int cpuacct_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct cpuacct_file_s *oldattr;
+  FAR struct cpuacct_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct cpuacct_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct cpuacct_file_s *)
+    kmm_malloc(sizeof(struct cpuacct_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct cpuacct_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpuacct_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int cpuacct_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "cpuacct" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "cpuacct") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "cpuacct" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_SCHED_CPUACCT && !CONFIG_FS_PROCFS_EXCLUDE_CPUACCT */
@@ -70,7 +70,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#define CRITMON_LINELEN 96
 
 /****************************************************************************
  * Private Types
@@ -96,6 +96,10 @@ static int     critmon_open(FAR struct file *filep, FAR const char *relpath,
 static int     critmon_close(FAR struct file *filep);
 static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t critmon_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+#endif
 static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -114,7 +118,11 @@ const struct procfs_operations critmon_operations =
   critmon_open,       /* open */
   critmon_close,      /* close */
   critmon_read,       /* read */
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  critmon_write,      /* write */
+#else
   NULL,               /* write */
+#endif
 
   critmon_dup,        /* dup */
 
@@ -141,6 +149,7 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
+#ifndef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
   /* PROCFS is read-only.  Any attempt to open with any kind of write
    * access is not permitted.
    *
@@ -152,6 +161,7 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
       ferr("ERROR: Only O_RDONLY supported\n");
       return -EACCES;
     }
+#endif
 
   /* "critmon" is the only acceptable value for the relpath */
 
@@ -196,6 +206,89 @@ static int critmon_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: critmon_read_hist
+ *
+ * Description:
+ *   Generate the histogram lines and the top offender lines of one CPU:
+ *
+ *     <cpu>,hist,<bucket start>,<pre-emption>,<csection>,<irq>
+ *     <cpu>,top,premp|csection,<time>,<pid>,<caller>
+ *
+ *   Empty buckets are omitted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t critmon_read_hist(FAR struct critmon_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset, int cpu)
+{
+  FAR struct critmon_cpuhist_s *hist = &g_critmon_hist[cpu];
+  FAR struct critmon_offender_s *top;
+  struct timespec ts;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NBUCKETS; i++)
+    {
+      if (hist->premp[i] == 0 && hist->crit[i] == 0 && hist->irq[i] == 0)
+        {
+          continue;
+        }
+
+      up_critmon_convert(i > 0 ? (uint32_t)1 << i : 0, &ts);
+      linesize = snprintf(attr->line, CRITMON_LINELEN,
+                          "%d,hist,%lu.%09lu,%lu,%lu,%lu\n",
+                          cpu, (unsigned long)ts.tv_sec,
+                          (unsigned long)ts.tv_nsec,
+                          (unsigned long)hist->premp[i],
+                          (unsigned long)hist->crit[i],
+                          (unsigned long)hist->irq[i]);
+      copysize = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                               buflen - totalsize, offset);
+
+      totalsize += copysize;
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+    }
+
+  for (i = 0; i < 2 * CONFIG_SCHED_CRITMONITOR_NOFFENDERS; i++)
+    {
+      top = i < CONFIG_SCHED_CRITMONITOR_NOFFENDERS ?
+            &hist->premp_top[i] :
+            &hist->crit_top[i - CONFIG_SCHED_CRITMONITOR_NOFFENDERS];
+      if (top->elapsed == 0)
+        {
+          continue;
+        }
+
+      up_critmon_convert(top->elapsed, &ts);
+      linesize = snprintf(attr->line, CRITMON_LINELEN,
+                          "%d,top,%s,%lu.%09lu,%d,0x%08lx\n", cpu,
+                          i < CONFIG_SCHED_CRITMONITOR_NOFFENDERS ?
+                          "premp" : "csection",
+                          (unsigned long)ts.tv_sec,
+                          (unsigned long)ts.tv_nsec,
+                          (int)top->pid, (unsigned long)top->caller);
+      copysize = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                               buflen - totalsize, offset);
+
+      totalsize += copysize;
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read_cpu
  ****************************************************************************/
@@ -266,12 +359,38 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   linesize = snprintf(attr->line, CRITMON_LINELEN, "%lu.%09lu\n",
                      (unsigned long)maxtime.tv_sec,
                      (unsigned long)maxtime.tv_nsec);
-  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+  copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, offset);
 
   totalsize += copysize;
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  if (totalsize < buflen)
+    {
+      totalsize += critmon_read_hist(attr, buffer + copysize,
+                                     remaining - copysize, offset, cpu);
+    }
+#endif
+
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_write
+ *
+ * Description:
+ *   Any write clears the histograms and the top offenders.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t critmon_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  sched_critmon_reset();
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -383,10 +502,15 @@ static int critmon_stat(const char *relpath, struct stat *buf)
       return -ENOENT;
     }
 
-  /* "critmon" is the name for a read-only file */
+  /* "critmon" is the name for a read-only file.  With histograms, writing
+   * the file resets them.
+   */
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  buf->st_mode |= S_IWUSR;
+#endif
   return OK;
 }
 
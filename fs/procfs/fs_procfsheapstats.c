@@ -0,0 +1,405 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheapstats.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_MM_HEAPSTATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAPSTATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPSTATS_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heapstats_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  struct mm_heapstats_s stats;    /* Snapshot of the heap being reported */
+  char line[HEAPSTATS_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t heapstats_heap(FAR struct heapstats_file_s *procfile,
+                 FAR struct mm_heap_s *heap, FAR const char *name,
+                 FAR char *buffer, size_t buflen, FAR off_t *offset);
+
+/* File system methods */
+
+static int     heapstats_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heapstats_close(FAR struct file *filep);
+static ssize_t heapstats_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heapstats_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heapstats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heapstats_operations =
+{
+  heapstats_open,   /* open */
+  heapstats_close,  /* close */
+  heapstats_read,   /* read */
+  NULL,             /* write */
+  heapstats_dup,    /* dup */
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+  heapstats_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapstats_heap
+ *
+ * Description:
+ *   Generate the search and latency statistics and the histogram of free
+ *   chunk sizes of one heap.
+ *
+ ****************************************************************************/
+
+static ssize_t heapstats_heap(FAR struct heapstats_file_s *procfile,
+                              FAR struct mm_heap_s *heap,
+                              FAR const char *name, FAR char *buffer,
+                              size_t buflen, FAR off_t *offset)
+{
+  FAR struct mm_heapstats_s *stats = &procfile->stats;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int ndx;
+
+  (void)mm_heapstats(heap, stats);
+
+  /* Show the free list searches */
+
+  linesize  = snprintf(procfile->line, HEAPSTATS_LINELEN,
+                       "%s:\n  SEARCHES    SCANNED    MAXSCAN\n"
+                       "%10lu%11lu%11lu\n",
+                       name, (unsigned long)stats->nsearches,
+                       (unsigned long)stats->nscanned,
+                       (unsigned long)stats->maxscanned);
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            offset);
+  totalsize = copysize;
+
+  /* Then the worst case latencies */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, HEAPSTATS_LINELEN,
+                            "   SEMWAIT     MALLOC       FREE\n"
+                            "%10lu%11lu%11lu\n",
+                            (unsigned long)stats->maxsemwait,
+                            (unsigned long)stats->maxmalloc,
+                            (unsigned long)stats->maxfree);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 offset);
+      totalsize += copysize;
+    }
+
+  /* Then the histogram of free chunk sizes.  Empty bins are omitted. */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, HEAPSTATS_LINELEN,
+                            "   BIN  CHUNKSIZE      NFREE   FREESIZE\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 offset);
+      totalsize += copysize;
+    }
+
+  for (ndx = 0; ndx < MM_NNODES && totalsize < buflen; ndx++)
+    {
+      if (stats->nfree[ndx] == 0)
+        {
+          continue;
+        }
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, HEAPSTATS_LINELEN,
+                            "%6d%11lu%11lu%11lu\n",
+                            ndx, (unsigned long)MM_MIN_CHUNK << ndx,
+                            (unsigned long)stats->nfree[ndx],
+                            (unsigned long)stats->freesize[ndx]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 offset);
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapstats_open
+ ****************************************************************************/
+
+static int heapstats_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct heapstats_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "heapstats" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heapstats") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct heapstats_file_s *)
+    kmm_zalloc(sizeof(struct heapstats_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapstats_close
+ ****************************************************************************/
+
+static int heapstats_close(FAR struct file *filep)
+{
+  FAR struct heapstats_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heapstats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapstats_read
+ ****************************************************************************/
+
+static ssize_t heapstats_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct heapstats_file_s *procfile;
+  size_t copysize = 0;
+  size_t totalsize = 0;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heapstats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  /* Show the kernel heap */
+
+  copysize   = heapstats_heap(procfile, &g_kmmheap, "Kmem", buffer, buflen,
+                              &offset);
+  totalsize += copysize;
+#endif
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+  /* Show the user heap.  In the protected and kernel builds, the user heap
+   * structure is not accessible from here.
+   */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      copysize   = heapstats_heap(procfile, &g_mmheap, "Umem", buffer,
+                                  buflen, &offset);
+      totalsize += copysize;
+    }
+#endif
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapstats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapstats_file_s *oldattr;
+  FAR struct heapstats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heapstats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct heapstats_file_s *)
+    kmm_malloc(sizeof(struct heapstats_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heapstats_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapstats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapstats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heapstats" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heapstats") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "heapstats" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_MM_HEAPSTATS && !CONFIG_FS_PROCFS_EXCLUDE_HEAPSTATS */
@@ -150,6 +150,9 @@ static FAR const char *g_iob_user_names[] =
 #ifdef CONFIG_NET_IPFORWARD
   "ipforward",
 #endif
+#ifdef CONFIG_NET_IPFRAG
+  "ipfrag",
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   "rad802154",
 #endif
@@ -279,6 +282,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   size_t totalsize;
   off_t offset;
   int i;
+#ifdef CONFIG_IOB_CACHE
+  struct iob_cachestats_s cachestats;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -351,6 +357,43 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
       totalsize += copysize;
     }
 
+#ifdef CONFIG_IOB_CACHE
+  /* Then the state of the I/O buffer cache of each CPU */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                            "\n%-16s%16s%16s%16s\n",
+                            "CPU", "CACHED", "HITS", "MISSES");
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          iob_getcachestats(i, &cachestats);
+          linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                                "%-16d%16u%16lu%16lu\n",
+                                i, cachestats.ncached, cachestats.hits,
+                                cachestats.misses);
+
+          copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                     &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
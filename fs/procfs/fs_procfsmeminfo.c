@@ -43,6 +43,7 @@
 #include <sys/stat.h>
 
 #include <stdint.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -101,6 +102,9 @@ struct progmem_info_s
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 static void    meminfo_progmem(FAR struct progmem_info_s *progmem);
 #endif
+#ifdef CONFIG_MM_CACHE
+static unsigned long meminfo_hitrate(FAR const struct mallinfo *mem);
+#endif
 
 /* File system methods */
 
@@ -202,6 +206,35 @@ static void meminfo_progmem(FAR struct progmem_info_s *progmem)
 }
 #endif
 
+/****************************************************************************
+ * Name: meminfo_hitrate
+ *
+ * Description:
+ *   Return the small-object cache hit rate of a heap in percent
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_CACHE
+static unsigned long meminfo_hitrate(FAR const struct mallinfo *mem)
+{
+  unsigned long total = mem->cachehits + mem->cachemisses;
+
+  if (total == 0)
+    {
+      return 0;
+    }
+
+  /* Scale the total down first if the multiplication would overflow */
+
+  if (total > ULONG_MAX / 100)
+    {
+      return mem->cachehits / (total / 100);
+    }
+
+  return mem->cachehits * 100 / total;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_open
  ****************************************************************************/
@@ -355,6 +388,165 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+#ifdef CONFIG_MM_CACHE
+  /* Show the small-object cache statistics of each heap */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "            cached       hits     misses   hit rate\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      mem        = kmm_mallinfo();
+#else
+      (void)kmm_mallinfo(&mem);
+#endif
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Kcache:%11lu%11lu%11lu%10lu%%\n",
+                            (unsigned long)mem.cachedblks,
+                            mem.cachehits, mem.cachemisses,
+                            meminfo_hitrate(&mem));
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
+#if !defined(CONFIG_BUILD_KERNEL)
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      mem        = kumm_mallinfo();
+#else
+      (void)kumm_mallinfo(&mem);
+#endif
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Ucache:%11lu%11lu%11lu%10lu%%\n",
+                            (unsigned long)mem.cachedblks,
+                            mem.cachehits, mem.cachemisses,
+                            meminfo_hitrate(&mem));
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+#endif
+
+#ifdef CONFIG_MM_REALLOC_STATS
+  /* Show how the realloc() requests of each heap were satisfied */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "           inplace      moved     copied\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      mem        = kmm_mallinfo();
+#else
+      (void)kmm_mallinfo(&mem);
+#endif
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Krealloc:%9lu%11lu%11lu\n",
+                            mem.reallocinplace, mem.reallocmoved,
+                            mem.realloccopied);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
+#if !defined(CONFIG_BUILD_KERNEL)
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      mem        = kumm_mallinfo();
+#else
+      (void)kumm_mallinfo(&mem);
+#endif
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Urealloc:%9lu%11lu%11lu\n",
+                            mem.reallocinplace, mem.reallocmoved,
+                            mem.realloccopied);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+#endif
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+  /* Show the memory deallocations that had to be delayed */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "         deferred     queued   maxqueue"
+                            "   maxdrain\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  if (totalsize < buflen)
+    {
+      struct garbageinfo_s info;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      sched_garbage_info(&info);
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Garbage:%9lu%11lu%11lu%11lu\n",
+                            (unsigned long)info.ndeferred,
+                            (unsigned long)info.depth,
+                            (unsigned long)info.maxdepth,
+                            info.maxdrain);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (totalsize < buflen)
     {
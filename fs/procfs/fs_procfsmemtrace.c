@@ -0,0 +1,482 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmemtrace.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_MM_TRACE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMTRACE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MEMTRACE_LINELEN 64
+
+/* The number of distinct (thread, caller) pairs that are reported for each
+ * heap.  Allocations from any further pairs are lumped together.
+ */
+
+#define MEMTRACE_NSITES  32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the outstanding allocations from one caller */
+
+struct memtrace_site_s
+{
+  FAR void *caller;               /* Address of the allocating code */
+  pid_t pid;                      /* The allocating thread */
+  unsigned int nallocs;           /* Number of outstanding allocations */
+  size_t used;                    /* Number of bytes in those allocations */
+};
+
+/* This structure describes one open "file" */
+
+struct memtrace_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int nsites;            /* Number of valid entries in site[] */
+  struct memtrace_site_s site[MEMTRACE_NSITES];
+  struct memtrace_site_s other;   /* Allocations that did not fit in site[] */
+  char line[MEMTRACE_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    memtrace_callback(FAR const struct mm_allocnode_s *node,
+                 FAR void *arg);
+static ssize_t memtrace_heap(FAR struct memtrace_file_s *procfile,
+                 FAR struct mm_heap_s *heap, FAR const char *name,
+                 FAR char *buffer, size_t buflen, FAR off_t *offset);
+
+/* File system methods */
+
+static int     memtrace_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     memtrace_close(FAR struct file *filep);
+static ssize_t memtrace_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     memtrace_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     memtrace_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations memtrace_operations =
+{
+  memtrace_open,   /* open */
+  memtrace_close,  /* close */
+  memtrace_read,   /* read */
+  NULL,            /* write */
+  memtrace_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  memtrace_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memtrace_callback
+ *
+ * Description:
+ *   Called by mm_tracewalk() for each tagged allocation.  The MM semaphore
+ *   is held, so this must not use the heap.
+ *
+ ****************************************************************************/
+
+static void memtrace_callback(FAR const struct mm_allocnode_s *node,
+                              FAR void *arg)
+{
+  FAR struct memtrace_file_s *procfile = (FAR struct memtrace_file_s *)arg;
+  FAR struct memtrace_site_s *site;
+  unsigned int i;
+
+  for (i = 0; i < procfile->nsites; i++)
+    {
+      site = &procfile->site[i];
+      if (site->pid == node->pid && site->caller == node->caller)
+        {
+          break;
+        }
+    }
+
+  if (i >= procfile->nsites)
+    {
+      if (procfile->nsites < MEMTRACE_NSITES)
+        {
+          site         = &procfile->site[procfile->nsites++];
+          site->caller = node->caller;
+          site->pid    = node->pid;
+        }
+      else
+        {
+          site         = &procfile->other;
+        }
+    }
+
+  site->nallocs++;
+  site->used += node->size;
+}
+
+/****************************************************************************
+ * Name: memtrace_heap
+ *
+ * Description:
+ *   Generate the per-thread usage and the per-caller allocation tables of
+ *   one heap.
+ *
+ ****************************************************************************/
+
+static ssize_t memtrace_heap(FAR struct memtrace_file_s *procfile,
+                             FAR struct mm_heap_s *heap, FAR const char *name,
+                             FAR char *buffer, size_t buflen,
+                             FAR off_t *offset)
+{
+  struct mm_traceusage_s usage;
+  FAR struct memtrace_site_s *site;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  unsigned int i;
+  int ndx;
+
+  /* Show the per-thread usage table */
+
+  linesize  = snprintf(procfile->line, MEMTRACE_LINELEN,
+                       "%s:\n   PID       USED       PEAK     NALLOC\n",
+                       name);
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            offset);
+  totalsize = copysize;
+
+  for (ndx = 0; ndx < CONFIG_MAX_TASKS && totalsize < buflen; ndx++)
+    {
+      if (mm_traceusage(heap, ndx, &usage) < 0)
+        {
+          continue;
+        }
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMTRACE_LINELEN,
+                            "%6d%11lu%11lu%11u\n",
+                            (int)usage.pid, (unsigned long)usage.used,
+                            (unsigned long)usage.peak,
+                            (unsigned int)usage.nallocs);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 offset);
+      totalsize += copysize;
+    }
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Then the outstanding allocations grouped by thread and caller */
+
+  procfile->nsites = 0;
+  memset(&procfile->other, 0, sizeof(struct memtrace_site_s));
+  mm_tracewalk(heap, memtrace_callback, procfile);
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = snprintf(procfile->line, MEMTRACE_LINELEN,
+                        "   PID     NALLOC       USED  CALLER\n");
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                             offset);
+  totalsize += copysize;
+
+  for (i = 0; i < procfile->nsites && totalsize < buflen; i++)
+    {
+      site       = &procfile->site[i];
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMTRACE_LINELEN,
+                            "%6d%11u%11lu  %p\n",
+                            (int)site->pid, site->nallocs,
+                            (unsigned long)site->used, site->caller);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 offset);
+      totalsize += copysize;
+    }
+
+  if (procfile->other.nallocs > 0 && totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMTRACE_LINELEN,
+                            " other%11u%11lu\n",
+                            procfile->other.nallocs,
+                            (unsigned long)procfile->other.used);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 offset);
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: memtrace_open
+ ****************************************************************************/
+
+static int memtrace_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct memtrace_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "memtrace" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "memtrace") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct memtrace_file_s *)
+    kmm_zalloc(sizeof(struct memtrace_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: memtrace_close
+ ****************************************************************************/
+
+static int memtrace_close(FAR struct file *filep)
+{
+  FAR struct memtrace_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct memtrace_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: memtrace_read
+ ****************************************************************************/
+
+static ssize_t memtrace_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct memtrace_file_s *procfile;
+  size_t copysize = 0;
+  size_t totalsize = 0;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct memtrace_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  /* Show the kernel heap */
+
+  copysize   = memtrace_heap(procfile, &g_kmmheap, "Kmem", buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+#endif
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+  /* Show the user heap.  In the protected and kernel builds, the user heap
+   * structure is not accessible from here.
+   */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      copysize   = memtrace_heap(procfile, &g_mmheap, "Umem", buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: memtrace_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int memtrace_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct memtrace_file_s *oldattr;
+  FAR struct memtrace_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct memtrace_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct memtrace_file_s *)
+    kmm_malloc(sizeof(struct memtrace_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct memtrace_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: memtrace_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int memtrace_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "memtrace" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "memtrace") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "memtrace" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_MM_TRACE && !CONFIG_FS_PROCFS_EXCLUDE_MEMTRACE */
@@ -66,7 +66,8 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
 
-#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR)
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_CPUACCT)
 #  include <nuttx/clock.h>
 #endif
 
@@ -89,11 +90,31 @@
 #  undef HAVE_GROUPID
 #endif
 
+/* The loadavg file shows the sampled CPU load and/or the exact CPU time */
+
+#undef HAVE_LOADAVG
+
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CPUACCT)
+#  define HAVE_LOADAVG  1
+#endif
+
+/* The run time follows the CPU load percentage, if there is one */
+
+#ifdef CONFIG_SCHED_CPULOAD
+#  define LOADAVG_RUNFMT " %lu.%09lu,"
+#else
+#  define LOADAVG_RUNFMT "%lu.%09lu,"
+#endif
+
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic.
  */
 
-#define STATUS_LINELEN 32
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+#  define STATUS_LINELEN 48
+#else
+#  define STATUS_LINELEN 32
+#endif
 
 /****************************************************************************
  * Private Type Definitions
@@ -108,7 +129,7 @@ enum proc_node_e
   PROC_LEVEL0 = 0,                    /* The top-level directory */
   PROC_STATUS,                        /* Task/thread status */
   PROC_CMDLINE,                       /* Task command line */
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
   PROC_LOADAVG,                       /* Average CPU utilization */
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -170,9 +191,9 @@ struct proc_envinfo_s
  * Private Data
  ****************************************************************************/
 
-static FAR const char *g_policy[4] =
+static FAR const char *g_policy[5] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -189,7 +210,7 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
 static ssize_t proc_cmdline(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
 static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -280,7 +301,7 @@ static const struct proc_node_s g_cmdline =
   "cmdline",      "cmdline", (uint8_t)PROC_CMDLINE,      DTYPE_FILE        /* Task command line */
 };
 
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
 static const struct proc_node_s g_loadavg =
 {
   "loadavg",       "loadavg", (uint8_t)PROC_LOADAVG,     DTYPE_FILE        /* Average CPU utilization */
@@ -328,7 +349,7 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 {
   &g_status,       /* Task/thread status */
   &g_cmdline,      /* Task command line */
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
   &g_loadavg,      /* Average CPU utilization */
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -351,7 +372,7 @@ static const struct proc_node_s * const g_level0info[] =
 {
   &g_status,       /* Task/thread status */
   &g_cmdline,      /* Task command line */
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
   &g_loadavg,      /* Average CPU utilization */
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -729,17 +750,28 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile,
  * Name: proc_loadavg
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
 static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                             FAR struct tcb_s *tcb, FAR char *buffer,
                             size_t buflen, off_t offset)
 {
+#ifdef CONFIG_SCHED_CPULOAD
   struct cpuload_s cpuload;
   uint32_t intpart;
   uint32_t fracpart;
+#endif
+#ifdef CONFIG_SCHED_CPUACCT
+  struct cpuacct_s cpuacct;
+#endif
+  size_t remaining;
   size_t linesize;
   size_t copysize;
+  size_t totalsize;
+
+  remaining = buflen;
+  totalsize = 0;
 
+#ifdef CONFIG_SCHED_CPULOAD
   /* Sample the counts for the thread.  clock_cpuload should only fail if
    * the PID is not valid.  This could happen if the thread exited sometime
    * after the procfs entry was opened.
@@ -767,9 +799,52 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 
   linesize = snprintf(procfile->line, STATUS_LINELEN, "%3d.%01d%%",
                       intpart, fracpart);
-  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+#endif
+
+#ifdef CONFIG_SCHED_CPUACCT
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Then the exact time that the thread has run and the time spent in
+   * interrupts that interrupted it, both in seconds.  clock_cpuacct
+   * returns zero times if the thread has exited.
+   */
+
+  (void)clock_cpuacct(procfile->pid, &cpuacct);
 
-  return copysize;
+  linesize = snprintf(procfile->line, STATUS_LINELEN, LOADAVG_RUNFMT,
+                      (unsigned long)(cpuacct.run / NSEC_PER_SEC),
+                      (unsigned long)(cpuacct.run % NSEC_PER_SEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%lu.%09lu\n",
+                      (unsigned long)(cpuacct.irq / NSEC_PER_SEC),
+                      (unsigned long)(cpuacct.irq % NSEC_PER_SEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+#endif
+
+  return totalsize;
 }
 #endif
 
@@ -787,6 +862,9 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
   size_t linesize;
   size_t copysize;
   size_t totalsize;
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  int i;
+#endif
 
   remaining = buflen;
   totalsize = 0;
@@ -844,9 +922,46 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
   linesize = snprintf(procfile->line, STATUS_LINELEN, "%lu.%09lu\n",
                      (unsigned long)maxtime.tv_sec,
                      (unsigned long)maxtime.tv_nsec);
-  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
 
   totalsize += copysize;
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  /* Generate one line for each non-empty histogram bucket:
+   *
+   *   hist,<bucket start>,<pre-emption>,<csection>
+   */
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NBUCKETS; i++)
+    {
+      if (totalsize >= buflen)
+        {
+          break;
+        }
+
+      if (tcb->premp_hist[i] == 0 && tcb->crit_hist[i] == 0)
+        {
+          continue;
+        }
+
+      buffer    += copysize;
+      remaining -= copysize;
+
+      up_critmon_convert(i > 0 ? (uint32_t)1 << i : 0, &maxtime);
+      linesize = snprintf(procfile->line, STATUS_LINELEN,
+                          "hist,%lu.%09lu,%lu,%lu\n",
+                          (unsigned long)maxtime.tv_sec,
+                          (unsigned long)maxtime.tv_nsec,
+                          (unsigned long)tcb->premp_hist[i],
+                          (unsigned long)tcb->crit_hist[i]);
+      copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      totalsize += copysize;
+    }
+#endif
+
   return totalsize;
 }
 #endif
@@ -1433,7 +1548,7 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_cmdline(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef HAVE_LOADAVG
     case PROC_LOADAVG: /* Average CPU utilization */
       ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
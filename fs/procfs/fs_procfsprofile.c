@@ -0,0 +1,463 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsprofile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PROFILE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define PROFILE_NCPUS     CONFIG_SMP_NCPUS
+#else
+#  define PROFILE_NCPUS     1
+#endif
+
+#ifdef CONFIG_SCHED_PROFILE_EXTCLK
+#  define PROFILE_PERIOD    CONFIG_SCHED_PROFILE_PERIOD
+#else
+#  define PROFILE_PERIOD    USEC_PER_TICK
+#endif
+
+/* The profile is returned in the binary CPU profile format of gperftools.
+ * All values are machine words:  A header, one record per sample with a
+ * count of one and a single program counter, and a trailer.  The trailer
+ * is followed by the memory map in the text format of /proc/self/maps.
+ */
+
+#define PROFILE_WORDSIZE    sizeof(uintptr_t)
+#define PROFILE_HDRSIZE     (5 * PROFILE_WORDSIZE)
+#define PROFILE_RECSIZE     (3 * PROFILE_WORDSIZE)
+#define PROFILE_TRLSIZE     (3 * PROFILE_WORDSIZE)
+#define PROFILE_MAPLEN      64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct profile_file_s
+{
+  struct procfs_file_s base;           /* Base open file structure */
+  size_t nsamples[PROFILE_NCPUS];      /* Number of samples of each CPU */
+  off_t trailer;                       /* Offset of the trailer */
+  size_t maplen;                       /* Length of the memory map */
+  char map[PROFILE_MAPLEN];            /* The memory map */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     profile_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     profile_close(FAR struct file *filep);
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t profile_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     profile_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     profile_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations profile_operations =
+{
+  profile_open,   /* open */
+  profile_close,  /* close */
+  profile_read,   /* read */
+  profile_write,  /* write */
+  profile_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  profile_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_pc
+ *
+ * Description:
+ *   Return the sampled program counter of a record.  The samples of all
+ *   CPUs are returned one CPU after the other.
+ *
+ ****************************************************************************/
+
+static uintptr_t profile_pc(FAR struct profile_file_s *procfile,
+                            size_t index)
+{
+  int cpu;
+
+  for (cpu = 0; index >= procfile->nsamples[cpu]; cpu++)
+    {
+      index -= procfile->nsamples[cpu];
+      DEBUGASSERT(cpu + 1 < PROFILE_NCPUS);
+    }
+
+  return nxsched_profile_pc(cpu, index);
+}
+
+/****************************************************************************
+ * Name: profile_open
+ ****************************************************************************/
+
+static int profile_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct profile_file_s *procfile;
+  size_t nsamples;
+  int cpu;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* "profile" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "profile") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct profile_file_s *)
+    kmm_zalloc(sizeof(struct profile_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The samples are returned as they were when the file was opened.  The
+   * recorded samples do not change until the profile is reset.
+   */
+
+  nsamples = 0;
+  for (cpu = 0; cpu < PROFILE_NCPUS; cpu++)
+    {
+      procfile->nsamples[cpu] = nxsched_profile_nsamples(cpu);
+      nsamples += procfile->nsamples[cpu];
+    }
+
+  procfile->trailer = PROFILE_HDRSIZE + nsamples * PROFILE_RECSIZE;
+
+  /* There is a single image that spans the whole address space */
+
+  procfile->maplen = snprintf(procfile->map, PROFILE_MAPLEN,
+                              "%0*lx-%0*lx r-xp %08lx 00:00 0 nuttx\n",
+                              (int)(2 * PROFILE_WORDSIZE), 0ul,
+                              (int)(2 * PROFILE_WORDSIZE),
+                              (unsigned long)UINTPTR_MAX, 0ul);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_close
+ ****************************************************************************/
+
+static int profile_close(FAR struct file *filep)
+{
+  FAR struct profile_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct profile_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_read
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct profile_file_s *procfile;
+  FAR const char *src;
+  uintptr_t words[5];
+  size_t totalsize;
+  size_t copysize;
+  size_t srclen;
+  size_t index;
+  off_t offset;
+  off_t start;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct profile_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Generate the part of the profile at the file offset until the buffer
+   * is full.  The records have a fixed size so that any part can be found
+   * without generating the preceding parts.
+   */
+
+  src       = (FAR const char *)words;
+  totalsize = 0;
+
+  while (totalsize < buflen)
+    {
+      if (offset < PROFILE_HDRSIZE)
+        {
+          /* The header:  Header count, header words, version, sampling
+           * period in microseconds, padding.
+           */
+
+          words[0] = 0;
+          words[1] = 3;
+          words[2] = 0;
+          words[3] = PROFILE_PERIOD;
+          words[4] = 0;
+          start    = 0;
+          srclen   = PROFILE_HDRSIZE;
+        }
+      else if (offset < procfile->trailer)
+        {
+          /* A sample:  Count, number of program counters, the program
+           * counter.
+           */
+
+          index    = (offset - PROFILE_HDRSIZE) / PROFILE_RECSIZE;
+          words[0] = 1;
+          words[1] = 1;
+          words[2] = profile_pc(procfile, index);
+          start    = PROFILE_HDRSIZE + index * PROFILE_RECSIZE;
+          srclen   = PROFILE_RECSIZE;
+        }
+      else if (offset < procfile->trailer + PROFILE_TRLSIZE)
+        {
+          /* The trailer */
+
+          words[0] = 0;
+          words[1] = 1;
+          words[2] = 0;
+          start    = procfile->trailer;
+          srclen   = PROFILE_TRLSIZE;
+        }
+      else
+        {
+          /* The memory map */
+
+          src      = procfile->map;
+          start    = procfile->trailer + PROFILE_TRLSIZE;
+          srclen   = procfile->maplen;
+
+          if (offset >= start + srclen)
+            {
+              break;
+            }
+        }
+
+      copysize = start + srclen - offset;
+      if (copysize > buflen - totalsize)
+        {
+          copysize = buflen - totalsize;
+        }
+
+      memcpy(buffer + totalsize, src + (offset - start), copysize);
+      totalsize += copysize;
+      offset    += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos = offset;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: profile_write
+ *
+ * Description:
+ *   Control the profiler:  "start", "stop" or "reset".
+ *
+ ****************************************************************************/
+
+static ssize_t profile_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen)
+{
+  size_t len = buflen;
+
+  /* Ignore a trailing newline */
+
+  if (len > 0 && buffer[len - 1] == '\n')
+    {
+      len--;
+    }
+
+  if (len == 5 && strncmp(buffer, "start", 5) == 0)
+    {
+      nxsched_profile_start();
+    }
+  else if (len == 4 && strncmp(buffer, "stop", 4) == 0)
+    {
+      nxsched_profile_stop();
+    }
+  else if (len == 5 && strncmp(buffer, "reset", 5) == 0)
+    {
+      nxsched_profile_reset();
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: profile_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int profile_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct profile_file_s *oldattr;
+  FAR struct profile_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct profile_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct profile_file_s *)
+    kmm_malloc(sizeof(struct profile_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct profile_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int profile_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "profile" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "profile") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "profile" is the name for a readable and writable file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_SCHED_PROFILE && !CONFIG_FS_PROCFS_EXCLUDE_PROFILE */
@@ -0,0 +1,440 @@
+/****************************************************************************
+ * fs/procfs/fs_procfstasks.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_TASKS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  It holds the last snapshot. */
+
+struct tasks_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  uint16_t ntasks;                /* Number of valid entries in tasks[] */
+  struct procfs_taskinfo_s tasks[CONFIG_MAX_TASKS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    tasks_callback(FAR struct tcb_s *tcb, FAR void *arg);
+#ifdef CONFIG_MM_TRACE
+static void    tasks_heapusage(FAR struct tasks_file_s *procfile,
+                 FAR struct mm_heap_s *heap);
+#endif
+static void    tasks_snapshot(FAR struct tasks_file_s *procfile);
+
+/* File system methods */
+
+static int     tasks_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     tasks_close(FAR struct file *filep);
+static ssize_t tasks_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     tasks_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     tasks_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations tasks_operations =
+{
+  tasks_open,      /* open */
+  tasks_close,     /* close */
+  tasks_read,      /* read */
+  NULL,            /* write */
+  tasks_dup,       /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  tasks_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tasks_callback
+ *
+ * Description:
+ *   Called by sched_foreach(), within a critical section, to record the
+ *   state of one thread.
+ *
+ ****************************************************************************/
+
+static void tasks_callback(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct tasks_file_s *procfile = (FAR struct tasks_file_s *)arg;
+  FAR struct procfs_taskinfo_s *info;
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+#ifdef CONFIG_SCHED_CPUACCT
+  struct cpuacct_s cpuacct;
+#endif
+
+  if (procfile->ntasks >= CONFIG_MAX_TASKS)
+    {
+      return;
+    }
+
+  info = &procfile->tasks[procfile->ntasks++];
+  memset(info, 0, sizeof(struct procfs_taskinfo_s));
+
+  info->pid          = tcb->pid;
+  info->state        = tcb->task_state;
+  info->priority     = tcb->sched_priority;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  info->basepriority = tcb->base_priority;
+#else
+  info->basepriority = tcb->sched_priority;
+#endif
+#ifdef CONFIG_SMP
+  info->cpu          = tcb->cpu;
+#endif
+  info->flags        = tcb->flags;
+  info->stacksize    = tcb->adj_stack_size;
+
+#ifdef CONFIG_STACK_COLORATION
+  info->stackused    = up_check_tcbstack(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+  if (clock_cpuload(tcb->pid, &cpuload) == OK && cpuload.total > 0)
+    {
+      info->cpuload  = (1000 * cpuload.active) / cpuload.total;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_CPUACCT
+  if (clock_cpuacct(tcb->pid, &cpuacct) == OK)
+    {
+      info->runtime  = cpuacct.run;
+    }
+#endif
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  strncpy(info->name, tcb->name, CONFIG_TASK_NAME_SIZE);
+  info->name[CONFIG_TASK_NAME_SIZE] = '\0';
+#endif
+}
+
+/****************************************************************************
+ * Name: tasks_heapusage
+ *
+ * Description:
+ *   Add the heap usage recorded by the allocation tracer to the threads of
+ *   the snapshot.  This takes the heap semaphore, so it cannot be done
+ *   while the threads are walked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TRACE
+static void tasks_heapusage(FAR struct tasks_file_s *procfile,
+                            FAR struct mm_heap_s *heap)
+{
+  struct mm_traceusage_s usage;
+  int ndx;
+  int i;
+
+  for (ndx = 0; ndx < CONFIG_MAX_TASKS; ndx++)
+    {
+      if (mm_traceusage(heap, ndx, &usage) < 0)
+        {
+          continue;
+        }
+
+      for (i = 0; i < procfile->ntasks; i++)
+        {
+          if (procfile->tasks[i].pid == usage.pid)
+            {
+              procfile->tasks[i].heapused += usage.used;
+              procfile->tasks[i].heappeak += usage.peak;
+              break;
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tasks_snapshot
+ *
+ * Description:
+ *   Take a new snapshot of all threads.  Pre-emption is disabled for the
+ *   duration of the walk so that the snapshot is consistent:  No thread can
+ *   be created or exit in the meantime.
+ *
+ ****************************************************************************/
+
+static void tasks_snapshot(FAR struct tasks_file_s *procfile)
+{
+  procfile->ntasks = 0;
+
+  sched_lock();
+  sched_foreach(tasks_callback, procfile);
+  sched_unlock();
+
+#ifdef CONFIG_MM_TRACE
+#ifdef CONFIG_MM_KERNEL_HEAP
+  tasks_heapusage(procfile, &g_kmmheap);
+#endif
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+  /* In the protected and kernel builds, the user heap structure is not
+   * accessible from here.
+   */
+
+  tasks_heapusage(procfile, &g_mmheap);
+#endif
+#endif
+}
+
+/****************************************************************************
+ * Name: tasks_open
+ ****************************************************************************/
+
+static int tasks_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct tasks_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "tasks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "tasks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes and the snapshot */
+
+  procfile = (FAR struct tasks_file_s *)
+    kmm_zalloc(sizeof(struct tasks_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_close
+ ****************************************************************************/
+
+static int tasks_close(FAR struct file *filep)
+{
+  FAR struct tasks_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct tasks_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_read
+ *
+ * Description:
+ *   Return the records of the snapshot.  A read from offset zero takes a
+ *   new snapshot, so a buffer of CONFIG_MAX_TASKS records returns the state
+ *   of all threads in one call.
+ *
+ ****************************************************************************/
+
+static ssize_t tasks_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct tasks_file_s *procfile;
+  size_t copysize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct tasks_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  if (filep->f_pos == 0)
+    {
+      tasks_snapshot(procfile);
+    }
+
+  offset   = filep->f_pos;
+  copysize = procfs_memcpy((FAR const char *)procfile->tasks,
+                           procfile->ntasks *
+                           sizeof(struct procfs_taskinfo_s),
+                           buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: tasks_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int tasks_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct tasks_file_s *oldattr;
+  FAR struct tasks_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct tasks_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct tasks_file_s *)
+    kmm_malloc(sizeof(struct tasks_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct tasks_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int tasks_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "tasks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "tasks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "tasks" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_FS_PROCFS_EXCLUDE_TASKS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
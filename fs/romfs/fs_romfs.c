@@ -404,6 +404,18 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* In XIP mode, the file data can be copied directly from the media */
+
+  if (rm->rm_xipbase)
+    {
+      memcpy(userbuffer, rm->rm_xipbase + rf->rf_startoffset + filep->f_pos,
+             buflen);
+
+      filep->f_pos += buflen;
+      romfs_semgive(rm);
+      return buflen;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
@@ -475,7 +487,10 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
             }
 
           finfo("Return %d bytes from sector offset %d\n", bytesread, sectorndx);
-          memcpy(userbuffer, &rf->rf_buffer[sectorndx], bytesread);
+          memcpy(userbuffer,
+                 &rf->rf_buffer[offset -
+                                rf->rf_cachesector * rm->rm_hwsectorsize],
+                 bytesread);
         }
 
       /* Set up for the next sector read */
@@ -670,6 +685,7 @@ static int romfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   newrf->rf_startoffset = oldrf->rf_startoffset;
   newrf->rf_size        = oldrf->rf_size;
+  newrf->rf_type        = oldrf->rf_type;
 
   /* Configure buffering to support access to this file */
 
@@ -692,7 +708,7 @@ static int romfs_dup(FAR const struct file *oldp, FAR struct file *newp)
    */
 
   newrf->rf_next = rm->rm_head;
-  rm->rm_head = newrf->rf_next;
+  rm->rm_head = newrf;
 
   romfs_semgive(rm);
   return OK;
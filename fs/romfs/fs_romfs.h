@@ -125,6 +125,12 @@
 
 #define ROMF_MAX_LINKS 64
 
+/* Number of sectors in the file buffer on non-XIP media */
+
+#ifndef CONFIG_FS_ROMFS_CACHE_FILE_NSECTORS
+#  define CONFIG_FS_ROMFS_CACHE_FILE_NSECTORS 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -161,8 +167,9 @@ struct romfs_file_s
   FAR struct romfs_file_s *rf_next; /* Retained in a singly linked list */
   uint32_t rf_startoffset;          /* Offset to the start of the file data */
   uint32_t rf_size;                 /* Size of the file in bytes */
-  uint32_t rf_cachesector;          /* Current sector in the rf_buffer */
+  uint32_t rf_cachesector;          /* First sector in the rf_buffer */
   uint8_t *rf_buffer;               /* File sector buffer, allocated if rm_xipbase==0 */
+  uint8_t  rf_ncachesectors;        /* Number of valid sectors in rf_buffer */
   uint8_t rf_type;                  /* File type (for fstat()) */
 };
 
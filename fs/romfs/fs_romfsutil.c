@@ -416,13 +416,18 @@ int romfs_hwread(struct romfs_mountpt_s *rm, uint8_t *buffer, uint32_t sector,
  * Name: romfs_filecacheread
  *
  * Description:
- *   Read the specified sector into the sector cache
+ *   Read the specified sector into the sector cache.  On non-XIP media,
+ *   up to CONFIG_FS_ROMFS_CACHE_FILE_NSECTORS sectors of the file starting
+ *   with this one are read.  The data of the sector is then at
+ *   rf_buffer + (sector - rf_cachesector) * rm_hwsectorsize.
  *
  ****************************************************************************/
 
 int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
                         uint32_t sector)
 {
+  uint32_t lastsector;
+  unsigned int nsectors;
   int ret;
 
   finfo("sector: %d cached: %d sectorsize: %d XIP base: %p buffer: %p\n",
@@ -434,7 +439,8 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
    * then we do nothing.
    */
 
-  if (rf->rf_cachesector != sector)
+  if (rf->rf_cachesector == (uint32_t)-1 || sector < rf->rf_cachesector ||
+      sector >= rf->rf_cachesector + rf->rf_ncachesectors)
     {
       /* Check the access mode */
 
@@ -445,24 +451,46 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
            */
 
           rf->rf_buffer = rm->rm_xipbase + sector * rm->rm_hwsectorsize;
+          nsectors      = 1;
           finfo("XIP buffer: %p\n", rf->rf_buffer);
         }
       else
         {
-          /* In non-XIP mode, we will have to read the new sector. */
+          /* In non-XIP mode, we will have to read the new sectors.  Do not
+           * read beyond the last sector of the file or of the device.
+           */
+
+          nsectors   = CONFIG_FS_ROMFS_CACHE_FILE_NSECTORS;
+          lastsector = rf->rf_size > 0 ?
+            SEC_NSECTORS(rm, rf->rf_startoffset + rf->rf_size - 1) : sector;
+          if (lastsector >= rm->rm_hwnsectors)
+            {
+              lastsector = rm->rm_hwnsectors - 1;
+            }
+
+          if (sector > lastsector)
+            {
+              nsectors = 1;
+            }
+          else if (nsectors > lastsector - sector + 1)
+            {
+              nsectors = lastsector - sector + 1;
+            }
 
           finfo("Calling romfs_hwread\n");
-          ret = romfs_hwread(rm, rf->rf_buffer, sector, 1);
+          ret = romfs_hwread(rm, rf->rf_buffer, sector, nsectors);
           if (ret < 0)
             {
               ferr("ERROR: romfs_hwread failed: %d\n", ret);
+              rf->rf_cachesector = (uint32_t)-1;
               return ret;
             }
         }
 
-      /* Update the cached sector number */
+      /* Update the cached sector numbers */
 
-      rf->rf_cachesector = sector;
+      rf->rf_cachesector   = sector;
+      rf->rf_ncachesectors = nsectors;
     }
 
   return OK;
@@ -640,18 +668,21 @@ int romfs_fileconfigure(struct romfs_mountpt_s *rm, struct romfs_file_s *rf)
     {
       /* We'll put a valid address in rf_buffer just in case. */
 
-      rf->rf_cachesector = 0;
-      rf->rf_buffer      = rm->rm_xipbase;
+      rf->rf_cachesector   = 0;
+      rf->rf_ncachesectors = 1;
+      rf->rf_buffer        = rm->rm_xipbase;
     }
   else
     {
       /* Nothing in the cache buffer */
 
-      rf->rf_cachesector = (uint32_t)-1;
+      rf->rf_cachesector   = (uint32_t)-1;
+      rf->rf_ncachesectors = 0;
 
       /* Create a file buffer to support partial sector accesses */
 
-      rf->rf_buffer = (FAR uint8_t *)kmm_malloc(rm->rm_hwsectorsize);
+      rf->rf_buffer = (FAR uint8_t *)
+        kmm_malloc(CONFIG_FS_ROMFS_CACHE_FILE_NSECTORS * rm->rm_hwsectorsize);
       if (!rf->rf_buffer)
         {
           return -ENOMEM;
@@ -222,7 +222,7 @@
 #define SMARTFS_NEXTSECTOR(h)    (*((uint16_t *)h->nextsector))
 #define SMARTFS_USED(h)          (*((uint16_t *)h->used))
 
-#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+#if defined(CONFIG_MTD_SMART_ENABLE_CRC) || defined(CONFIG_SMARTFS_COALESCE_WRITES)
 #define CONFIG_SMARTFS_USE_SECTOR_BUFFER
 #endif
 
@@ -843,6 +843,12 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                                          "Sectors Per Block: %d\nSector Utilization:%d%%\n"
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                                          "Uneven Wear Count: %d\n"
+                                         "Min Wear Level:    %d\nMax Wear Level:    %d\n"
+#endif
+                                         "Relocations:       %d\n"
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+                                         "Cache Entries:     %d\nCache Hits:        %d\n"
+                                         "Cache Misses:      %d\n"
 #endif
                   ,
                   procfs_data.formatversion, procfs_data.namelen,
@@ -853,6 +859,12 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                   procfs_data.sectorsperblk, utilization
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                   , procfs_data.uneven_wearcount
+                  , procfs_data.minwearlevel, procfs_data.maxwearlevel
+#endif
+                  , procfs_data.relocations
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+                  , procfs_data.cacheentries, procfs_data.cachehits
+                  , procfs_data.cachemisses
 #endif
            );
         }
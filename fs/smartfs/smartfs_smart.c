@@ -509,6 +509,9 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
   uint32_t                  bytesread;
   uint16_t                  bytestoread;
   uint16_t                  bytesinsector;
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  uint16_t                  startsector;
+#endif
 
   /* Sanity checks */
 
@@ -526,6 +529,10 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
   smartfs_semtake(fs);
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  startsector = sf->currsector;
+#endif
+
   /* Loop until all byte read or error */
 
   bytesread = 0;
@@ -595,6 +602,16 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
       if ((bytestoread == 0) || (sf->curroffset == fs->fs_llformat.availbytes))
         {
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+          /* Write out any buffered changes before leaving the sector */
+
+          ret = smartfs_sync_internal(fs, sf);
+          if (ret != OK)
+            {
+              goto errout_with_semaphore;
+            }
+#endif
+
           /* Set the next sector as the current sector */
 
           sf->currsector = SMARTFS_NEXTSECTOR(header);
@@ -611,6 +628,28 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
         }
     }
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  /* If we moved to another sector, then it must be loaded into sf->buffer
+   * in case it is written to.
+   */
+
+  if (sf->currsector != startsector &&
+      sf->currsector != SMARTFS_ERASEDSTATE_16BIT)
+    {
+      readwrite.logsector = sf->currsector;
+      readwrite.offset = 0;
+      readwrite.buffer = sf->buffer;
+      readwrite.count = fs->fs_llformat.availbytes;
+      ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long) &readwrite);
+      if (ret < 0)
+        {
+          ferr("ERROR: Error %d reading sector %d data\n",
+               ret, sf->currsector);
+          goto errout_with_semaphore;
+        }
+    }
+#endif
+
   /* Return the number of bytes we read */
 
   ret = bytesread;
@@ -725,6 +764,17 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
 
       /* Now perform the write. */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+      /* The current sector is in sf->buffer.  Update it there and write it
+       * out once, when we leave the sector or sync the file.
+       */
+
+      if (readwrite.count > 0)
+        {
+          memcpy(&sf->buffer[sf->curroffset], readwrite.buffer,
+                 readwrite.count);
+          sf->bflags |= SMARTFS_BFLAG_DIRTY;
+#else
       if (readwrite.count > 0)
         {
           ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
@@ -734,6 +784,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
                    ret, sf->currsector);
               goto errout_with_semaphore;
             }
+#endif
 
           /* Update our control variables */
 
@@ -745,6 +796,45 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
 
       /* Test if we wrote to the end of the current sector */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+      header = (struct smartfs_chain_header_s *) sf->buffer;
+      if (sf->curroffset == fs->fs_llformat.availbytes &&
+          SMARTFS_NEXTSECTOR(header) != SMARTFS_ERASEDSTATE_16BIT)
+        {
+          /* Write this sector out and load the next one in the chain.  If
+           * this is the last sector, stay here and let the append logic
+           * below chain a new sector to it.
+           */
+
+          readwrite.logsector = SMARTFS_NEXTSECTOR(header);
+          ret = smartfs_sync_internal(fs, sf);
+          if (ret != OK)
+            {
+              goto errout_with_semaphore;
+            }
+
+          readwrite.offset = 0;
+          readwrite.buffer = sf->buffer;
+          readwrite.count = fs->fs_llformat.availbytes;
+          ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long) &readwrite);
+          if (ret < 0)
+            {
+              ferr("ERROR: Error %d reading sector %d data\n",
+                   ret, readwrite.logsector);
+              goto errout_with_semaphore;
+            }
+
+          sf->curroffset = sizeof(struct smartfs_chain_header_s);
+          sf->currsector = readwrite.logsector;
+        }
+      else if (sf->curroffset == fs->fs_llformat.availbytes &&
+               sf->filepos < sf->entry.datlen)
+        {
+          ferr("ERROR: Sector chain ends before EOF\n");
+          ret = -EIO;
+          goto errout_with_semaphore;
+        }
+#else
       if (sf->curroffset == fs->fs_llformat.availbytes)
         {
           /* Wrote to the end of the sector.  Update to point to the
@@ -768,6 +858,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
           sf->curroffset = sizeof(struct smartfs_chain_header_s);
           sf->currsector = SMARTFS_NEXTSECTOR(header);
         }
+#endif
     }
 
   /* Now append data to end of the file. */
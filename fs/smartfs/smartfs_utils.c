@@ -1532,7 +1532,11 @@ off_t smartfs_seek_internal(FAR struct smartfs_mountpt_s *fs,
 
   /* Test if we need to sync the file */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  if (sf->byteswritten > 0 || (sf->bflags & SMARTFS_BFLAG_DIRTY) != 0)
+#else
   if (sf->byteswritten > 0)
+#endif
     {
       /* Perform a sync */
 
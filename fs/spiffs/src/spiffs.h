@@ -57,7 +57,10 @@ extern "C"
 #include <sys/mount.h>
 #include <queue.h>
 
+#include <time.h>
+
 #include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/mtd/mtd.h>
 
 /****************************************************************************
@@ -125,6 +128,10 @@ struct spiffs_file_s;               /* Forward reference */
 
 struct spiffs_s
 {
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+  FAR struct spiffs_s *flink;       /* Supports a singly linked list */
+  FAR struct inode *mtdinode;       /* The MTD driver inode (for its name) */
+#endif
   struct mtd_geometry_s geo;        /* FLASH geometry */
   struct spiffs_sem_s exclsem;      /* Supports mutually exclusive access */
   dq_queue_t objq;                  /* A doubly linked list of open file objects */
@@ -148,9 +155,16 @@ struct spiffs_s
   uint32_t stats_gc_runs;
 #endif
   uint32_t cache_size;              /* Cache size */
-#ifdef CONFIG_SPIFFS_CACHEDBG
   uint32_t cache_hits;              /* Number of cache hits */
   uint32_t cache_misses;            /* Number of cache misses */
+  uint32_t gc_fgblocks;             /* Blocks reclaimed by writers */
+  clock_t gc_fgticks;               /* Time writers spent in GC */
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+  struct work_s gc_work;            /* Background GC work */
+  uint32_t gc_bgblocks;             /* Blocks reclaimed in the background */
+  clock_t gc_bgticks;               /* Time spent in background GC */
+  bool gc_queued;                   /* Background GC work is queued or running */
+  bool gc_stop;                     /* The volume is being unmounted */
 #endif
   int16_t free_blkndx;              /* Cursor for free blocks, block index */
   int16_t lu_blkndx;                /* Cursor when searching, block index */
@@ -50,6 +50,8 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "spiffs.h"
 #include "spiffs_core.h"
 #include "spiffs_cache.h"
@@ -1112,6 +1114,7 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 {
   int32_t free_pages;
   uint32_t needed_pages;
+  clock_t start;
   int tries = 0;
   int ret;
 
@@ -1155,6 +1158,11 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
       return -ENOSPC;
     }
 
+  /* The caller has to wait for the garbage collection.  Account for the
+   * time spent here.
+   */
+
+  start = clock_systimer();
   do
     {
       FAR int16_t *cands;
@@ -1183,6 +1191,7 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
       if (count == 0)
         {
           spiffs_gcinfo("No candidates, return\n");
+          fs->gc_fgticks += clock_systimer() - start;
           return (int32_t) needed_pages < free_pages ? OK : -ENOSPC;
         }
 
@@ -1215,6 +1224,7 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
           return ret;
         }
 
+      fs->gc_fgblocks++;
       free_pages = (SPIFFS_GEO_PAGES_PER_BLOCK(fs) -
                     SPIFFS_OBJ_LOOKUP_PAGES(fs)) * (SPIFFS_GEO_BLOCK_COUNT(fs) - 2) -
                     fs->alloc_pages - fs->deleted_pages;
@@ -1242,6 +1252,7 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
       ret = -ENOSPC;
     }
 
+  fs->gc_fgticks += clock_systimer() - start;
   spiffs_gcinfo("Finished, %d dirty, blocks, %d free, %d pages free, "
                 "%d tries, ret=%d\n",
                 fs->alloc_pages + fs->deleted_pages,
@@ -1249,3 +1260,87 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: spiffs_gc_step
+ *
+ * Description:
+ *   Perform one increment of background garbage collection:  If fewer than
+ *   CONFIG_SPIFFS_GC_RESERVE blocks are free and there are deleted pages,
+ *   reclaim one block.  A fully deleted block is simply erased.  Otherwise
+ *   the best candidate block is cleaned and erased.
+ *
+ *   This bounds the work done at a time to one block so that it can be
+ *   done by a low priority worker between file system operations, keeping
+ *   enough free blocks that writers rarely need to collect garbage
+ *   themselves.
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if a block was reclaimed; A negated errno value is
+ *   returned on any failure.  -ENODATA is returned if there is nothing to
+ *   do.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+int spiffs_gc_step(FAR struct spiffs_s *fs)
+{
+  FAR int16_t *cands;
+  int16_t cand;
+  int count;
+  int ret;
+
+  if (fs->free_blocks >= CONFIG_SPIFFS_GC_RESERVE || fs->deleted_pages == 0)
+    {
+      return -ENODATA;
+    }
+
+  spiffs_gcinfo("free_blocks=%lu deleted_pages=%lu\n",
+                (unsigned long)fs->free_blocks,
+                (unsigned long)fs->deleted_pages);
+
+  /* A fully deleted block can be erased without moving any pages */
+
+  ret = spiffs_gc_quick(fs, 0);
+  if (ret != -ENODATA)
+    {
+      return ret;
+    }
+
+  ret = spiffs_gc_find_candidate(fs, &cands, &count, false);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_find_candidate() failed: %d\n", ret);
+      return ret;
+    }
+
+  if (count == 0)
+    {
+      return -ENODATA;
+    }
+
+#ifdef CONFIG_SPIFFS_GCDBG
+  fs->stats_gc_runs++;
+#endif
+  cand = cands[0];
+
+  ret = spiffs_gc_clean(fs, cand);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_epage_stats(fs, cand);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
+      return ret;
+    }
+
+  return spiffs_gc_erase_block(fs, cand);
+}
+#endif
@@ -126,6 +126,28 @@ int spiffs_gc_quick(FAR struct spiffs_s *fs, uint16_t max_free_pages);
 
 int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len);
 
+/****************************************************************************
+ * Name: spiffs_gc_step
+ *
+ * Description:
+ *   Perform one increment of background garbage collection:  If fewer than
+ *   CONFIG_SPIFFS_GC_RESERVE blocks are free and there are deleted pages,
+ *   reclaim one block.
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if a block was reclaimed; A negated errno value is
+ *   returned on any failure.  -ENODATA is returned if there is nothing to
+ *   do.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+int spiffs_gc_step(FAR struct spiffs_s *fs);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -48,6 +48,8 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <dirent.h>
@@ -57,10 +59,14 @@
 #include <queue.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
 
 #include "spiffs.h"
 #include "spiffs_core.h"
@@ -75,6 +81,28 @@
 #define spiffs_lock_volume(fs)       (spiffs_lock_reentrant(&fs->exclsem))
 #define spiffs_unlock_volume(fs)     (spiffs_unlock_reentrant(&fs->exclsem))
 
+/* The cache holds at most 32 pages (the size of the cache use map) */
+
+#define SPIFFS_CACHE_MAXPAGES        32
+
+/* Size of the line buffer used by the procfs entry */
+
+#define SPIFFS_LINELEN               96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+/* This structure describes one open fs/spiffs procfs file */
+
+struct spiffs_procfile_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  char line[SPIFFS_LINELEN];        /* One line of output */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -83,6 +111,12 @@
 
 static void spiffs_lock_reentrant(FAR struct spiffs_sem_s *sem);
 static void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *sem);
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+static void spiffs_gc_worker(FAR void *arg);
+static void spiffs_gc_schedule(FAR struct spiffs_s *fs);
+#else
+#  define spiffs_gc_schedule(fs)
+#endif
 
 /* File system operations */
 
@@ -123,6 +157,29 @@ static int  spiffs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 static int  spiffs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               FAR struct stat *buf);
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+static int  spiffs_procfs_open(FAR struct file *filep,
+              FAR const char *relpath, int oflags, mode_t mode);
+static int  spiffs_procfs_close(FAR struct file *filep);
+static ssize_t spiffs_procfs_read(FAR struct file *filep, FAR char *buffer,
+              size_t buflen);
+static int  spiffs_procfs_dup(FAR const struct file *oldp,
+              FAR struct file *newp);
+static int  spiffs_procfs_stat(FAR const char *relpath,
+              FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+/* The list of all SPIFFS volumes and the semaphore that protects it */
+
+static sq_queue_t g_spiffs_mounts;
+static sem_t g_spiffs_lock = SEM_INITIALIZER(1);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -157,6 +214,24 @@ const struct mountpt_operations spiffs_operations =
   spiffs_stat,       /* stat */
 };
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+/* See fs_procfs.c -- this structure is explicitly extern'ed there */
+
+const struct procfs_operations spiffs_procfsoperations =
+{
+  spiffs_procfs_open,   /* open */
+  spiffs_procfs_close,  /* close */
+  spiffs_procfs_read,   /* read */
+  NULL,                 /* write */
+  spiffs_procfs_dup,    /* dup */
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+  spiffs_procfs_stat    /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -243,6 +318,145 @@ static void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *rsem)
     }
 }
 
+/****************************************************************************
+ * Name: spiffs_gc_schedule
+ *
+ * Description:
+ *   Queue one step of background garbage collection if the number of free
+ *   blocks has dropped below CONFIG_SPIFFS_GC_RESERVE and there is
+ *   something that can be reclaimed.
+ *
+ * Assumptions:
+ *   The caller holds the volume lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+static void spiffs_gc_schedule(FAR struct spiffs_s *fs)
+{
+  int ret;
+
+  if (!fs->gc_stop && !fs->gc_queued && work_available(&fs->gc_work) &&
+      fs->free_blocks < CONFIG_SPIFFS_GC_RESERVE && fs->deleted_pages > 0)
+    {
+      ret = work_queue(LPWORK, &fs->gc_work, spiffs_gc_worker, fs,
+                       MSEC2TICK(CONFIG_SPIFFS_GC_DELAY));
+      if (ret >= 0)
+        {
+          fs->gc_queued = true;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: spiffs_gc_worker
+ *
+ * Description:
+ *   Perform one step of garbage collection on the low priority work queue,
+ *   then re-schedule itself until the free block reserve is restored.
+ *   Taking the volume lock for one block at a time bounds the delay seen
+ *   by the foreground file system operations.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+static void spiffs_gc_worker(FAR void *arg)
+{
+  FAR struct spiffs_s *fs = (FAR struct spiffs_s *)arg;
+  clock_t start;
+  int ret;
+
+  spiffs_lock_volume(fs);
+
+  /* spiffs_unbind() waits for gc_queued to be cleared.  That happens here
+   * with the lock held and, if we are not being unmounted, before the next
+   * step is scheduled.
+   */
+
+  fs->gc_queued = false;
+  if (!fs->gc_stop)
+    {
+      start = clock_systimer();
+      ret   = spiffs_gc_step(fs);
+      fs->gc_bgticks += clock_systimer() - start;
+
+      if (ret >= 0)
+        {
+          fs->gc_bgblocks++;
+          spiffs_gc_schedule(fs);
+        }
+      else if (ret != -ENODATA)
+        {
+          fwarn("WARNING: spiffs_gc_step() failed: %d\n", ret);
+        }
+    }
+
+  spiffs_unlock_volume(fs);
+}
+#endif
+
+/****************************************************************************
+ * Name: spiffs_parseopts
+ *
+ * Description:
+ *   Parse the comma separated mount options.  Only one is currently
+ *   supported:
+ *
+ *     cachepages=<n>  The number of pages in the volume cache (1-32).  The
+ *                     default is derived from CONFIG_SPIFFS_CACHE_SIZE.
+ *
+ ****************************************************************************/
+
+static int spiffs_parseopts(FAR const char *opts, FAR int *cachepages)
+{
+  FAR const char *value;
+  FAR char *end;
+  unsigned long num;
+  size_t len;
+
+  *cachepages = 0;
+
+  while (opts != NULL && *opts != '\0')
+    {
+      len   = strcspn(opts, ",");
+      value = memchr(opts, '=', len);
+      if (value == NULL)
+        {
+          return -EINVAL;
+        }
+
+      num = strtoul(++value, &end, 0);
+      if (end == value || end != opts + len)
+        {
+          return -EINVAL;
+        }
+
+      len = value - opts - 1;
+      if (len == 10 && strncmp(opts, "cachepages", len) == 0)
+        {
+          if (num < 1 || num > SPIFFS_CACHE_MAXPAGES)
+            {
+              return -EINVAL;
+            }
+
+          *cachepages = (int)num;
+        }
+      else
+        {
+          return -EINVAL;
+        }
+
+      opts = end;
+      if (*opts == ',')
+        {
+          opts++;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: spiffs_readdir_callback
  ****************************************************************************/
@@ -574,6 +788,10 @@ static int spiffs_close(FAR struct file *filep)
       spiffs_fobj_free(fs, fobj, (fobj->flags & SFO_FLAG_UNLINKED) != 0);
     }
 
+  /* Start reclaiming deleted pages now, rather than in the next write */
+
+  spiffs_gc_schedule(fs);
+
   /* Release the lock on the file system */
 
   spiffs_unlock_volume(fs);
@@ -822,6 +1040,7 @@ success_with_lock:
   /* Update the file position */
 
   filep->f_pos += nwritten;
+  spiffs_gc_schedule(fs);
 
   /* Release our access to the volume */
 
@@ -1103,6 +1322,7 @@ static int spiffs_sync(FAR struct file *filep)
       ret = (int)nflushed;
     }
 
+  spiffs_gc_schedule(fs);
   spiffs_unlock_volume(fs);
   return spiffs_map_errno(ret);
 }
@@ -1252,6 +1472,7 @@ static int spiffs_truncate(FAR struct file *filep, off_t length)
       filep->f_pos = fsize;
     }
 
+  spiffs_gc_schedule(fs);
   spiffs_unlock_volume(fs);
   return spiffs_map_errno(ret);
 }
@@ -1363,11 +1584,21 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
   size_t cache_max;
   size_t work_size;
   size_t addrmask;
+  int cachepages;
   int ret;
 
   finfo("mtdinode=%p data=%p handle=%p\n", mtdinode, data, handle);
   DEBUGASSERT(mtdinode != NULL && handle != NULL);
 
+  /* Parse the mount options */
+
+  ret = spiffs_parseopts((FAR const char *)data, &cachepages);
+  if (ret < 0)
+    {
+      ferr("ERROR: Bad mount options: %s\n", (FAR const char *)data);
+      return ret;
+    }
+
   /* Extract the MTD interface reference */
 
   DEBUGASSERT(INODE_IS_MTD(mtdinode) && mtdinode->u.i_mtd != NULL);
@@ -1400,11 +1631,23 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
   /* Get the aligned cache size */
 
   addrmask   = (sizeof(FAR void *) - 1);
-  cache_size = (CONFIG_SPIFFS_CACHE_SIZE + addrmask) & ~addrmask;
+  if (cachepages > 0)
+    {
+      cache_size = sizeof(struct spiffs_cache_s) +
+                   cachepages * SPIFFS_CACHE_PAGE_SIZE(fs);
+    }
+  else
+    {
+      cache_size = CONFIG_SPIFFS_CACHE_SIZE;
+    }
+
+  cache_size = (cache_size + addrmask) & ~addrmask;
 
   /* Don't let the cache size exceed the maximum that is needed */
 
-  cache_max  = SPIFFS_GEO_PAGE_SIZE(fs) << 5;
+  cache_max  = sizeof(struct spiffs_cache_s) +
+               SPIFFS_CACHE_MAXPAGES * SPIFFS_CACHE_PAGE_SIZE(fs);
+  cache_max  = (cache_max + addrmask) & ~addrmask;
   if (cache_size > cache_max)
     {
       cache_size = cache_max;
@@ -1483,6 +1726,16 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
     }
 #endif
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+  /* Add the volume to the list reported by procfs */
+
+  fs->mtdinode = mtdinode;
+
+  nxsem_wait_uninterruptible(&g_spiffs_lock);
+  sq_addlast((FAR sq_entry_t *)fs, &g_spiffs_mounts);
+  nxsem_post(&g_spiffs_lock);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)fs;
@@ -1536,6 +1789,34 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
       spiffs_fobj_free(fs, fobj, false);
     }
 
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+  /* Stop the background garbage collection.  If the work cannot be
+   * cancelled, then the worker is already running or waiting for the lock.
+   * Let it finish.
+   */
+
+  fs->gc_stop = true;
+  if (fs->gc_queued && work_cancel(LPWORK, &fs->gc_work) >= 0)
+    {
+      fs->gc_queued = false;
+    }
+
+  while (fs->gc_queued)
+    {
+      spiffs_unlock_volume(fs);
+      nxsig_usleep(10 * 1000);
+      spiffs_lock_volume(fs);
+    }
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+  /* Remove the volume from the list reported by procfs */
+
+  nxsem_wait_uninterruptible(&g_spiffs_lock);
+  sq_rem((FAR sq_entry_t *)fs, &g_spiffs_mounts);
+  nxsem_post(&g_spiffs_lock);
+#endif
+
   /* Free allocated working buffers */
 
   if (fs->work != NULL)
@@ -1552,7 +1833,7 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
 
   nxsem_destroy(&fs->exclsem.sem);
   kmm_free(fs);
-  ret = OK;
+  return OK;
 
 errout_with_lock:
   spiffs_unlock_volume(fs);
@@ -1714,6 +1995,8 @@ static int spiffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
           ferr("ERROR: spiffs_fobj_truncate failed: %d\n", ret);
           goto errout_with_lock;
         }
+
+      spiffs_gc_schedule(fs);
     }
 
   /* Release the lock on the volume */
@@ -1921,6 +2204,154 @@ errout_with_lock:
   return spiffs_map_errno(ret);
 }
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+/****************************************************************************
+ * Name: spiffs_procfs_open
+ ****************************************************************************/
+
+static int spiffs_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath, int oflags,
+                              mode_t mode)
+{
+  FAR struct spiffs_procfile_s *procfile;
+
+  /* PROCFS is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (strcmp(relpath, "fs/spiffs") != 0)
+    {
+      return -ENOENT;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct spiffs_procfile_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_close
+ ****************************************************************************/
+
+static int spiffs_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_read
+ *
+ * Description:
+ *   Report one line of cache and garbage collection statistics for each
+ *   SPIFFS volume, identified by the name of its MTD driver.  GC times are
+ *   in milliseconds.
+ *
+ ****************************************************************************/
+
+static ssize_t spiffs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct spiffs_procfile_s *procfile = filep->f_priv;
+  FAR struct spiffs_s *fs;
+  uint32_t bgblocks = 0;
+  clock_t bgticks = 0;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset = filep->f_pos;
+
+  DEBUGASSERT(procfile != NULL && buffer != NULL && buflen > 0);
+
+  linesize  = snprintf(procfile->line, SPIFFS_LINELEN,
+                       "%-12s%6s%6s%8s%8s%8s%8s%8s%8s\n",
+                       "DEVICE", "FREE", "CACHE", "HITS", "MISSES",
+                       "FGBLKS", "FGMSEC", "BGBLKS", "BGMSEC");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  nxsem_wait_uninterruptible(&g_spiffs_lock);
+  for (fs = (FAR struct spiffs_s *)sq_peek(&g_spiffs_mounts);
+       fs != NULL && totalsize < buflen;
+       fs = fs->flink)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+      bgblocks   = fs->gc_bgblocks;
+      bgticks    = fs->gc_bgticks;
+#endif
+
+      linesize   = snprintf(procfile->line, SPIFFS_LINELEN,
+                            "%-12s%6lu%6u%8lu%8lu%8lu%8lu%8lu%8lu\n",
+                            fs->mtdinode->i_name,
+                            (unsigned long)fs->free_blocks,
+                            (unsigned int)spiffs_get_cache(fs)->cpage_count,
+                            (unsigned long)fs->cache_hits,
+                            (unsigned long)fs->cache_misses,
+                            (unsigned long)fs->gc_fgblocks,
+                            (unsigned long)TICK2MSEC(fs->gc_fgticks),
+                            (unsigned long)bgblocks,
+                            (unsigned long)TICK2MSEC(bgticks));
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  nxsem_post(&g_spiffs_lock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_dup
+ ****************************************************************************/
+
+static int spiffs_procfs_dup(FAR const struct file *oldp,
+                             FAR struct file *newp)
+{
+  FAR struct spiffs_procfile_s *newfile;
+
+  newfile = kmm_malloc(sizeof(struct spiffs_procfile_s));
+  if (newfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newfile, oldp->f_priv, sizeof(struct spiffs_procfile_s));
+  newp->f_priv = newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_stat
+ ****************************************************************************/
+
+static int spiffs_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  if (strcmp(relpath, "fs/spiffs") != 0)
+    {
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif /* CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_SPIFFS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
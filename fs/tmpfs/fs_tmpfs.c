@@ -67,10 +67,14 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
+#if CONFIG_FS_TMPFS_PAGESIZE <= 0
+#  error CONFIG_FS_TMPFS_PAGESIZE must be positive
 #endif
 
+/* Minimum number of page table entries to allocate */
+
+#define TMPFS_MIN_PAGETABLE 4
+
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -94,12 +98,25 @@ static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static int  tmpfs_realloc_pagetable(FAR struct tmpfs_file_s *tfo,
+              size_t npages);
+static FAR uint8_t *tmpfs_file_page(FAR struct tmpfs_file_s *tfo,
+              size_t pageno, bool alloc);
+static int  tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
+static uint32_t tmpfs_hash_name(FAR const char *name);
+static void tmpfs_hash_insert(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_remove(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
+static void tmpfs_free_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
 static int  tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
@@ -323,6 +340,7 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
   FAR struct tmpfs_directory_s *newtdo;
   size_t objsize;
   int ret = oldtdo->tdo_nentries;
+  int i;
 
   /* Get the new object size */
 
@@ -362,10 +380,14 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
   newtdo->tdo_nentries = nentries;
   *tdo                 = newtdo;
 
-  /* Adjust the reference in the parent directory entry */
+  /* The directory entries have moved.  Adjust the backward links of the
+   * existing child objects.
+   */
 
-  DEBUGASSERT(newtdo->tdo_dirent);
-  newtdo->tdo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtdo;
+  for (i = 0; i < ret; i++)
+    {
+      newtdo->tdo_entry[i].tde_object->to_dirent = &newtdo->tdo_entry[i];
+    }
 
   /* Return the index to the first, newly allocated directory entry */
 
@@ -373,72 +395,201 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_realloc_pagetable
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static int tmpfs_realloc_pagetable(FAR struct tmpfs_file_s *tfo,
+                                   size_t npages)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  FAR uint8_t **newpages;
+  size_t i;
+
+  if (npages == 0)
+    {
+      /* Free the page table.  All pages must already have been freed. */
+
+      if (tfo->tfo_pages != NULL)
+        {
+          kmm_free(tfo->tfo_pages);
+          tfo->tfo_alloc -= tfo->tfo_npages * sizeof(FAR uint8_t *);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_npages = 0;
+        }
+
+      return OK;
+    }
+
+  newpages = (FAR uint8_t **)
+    kmm_realloc(tfo->tfo_pages, npages * sizeof(FAR uint8_t *));
+  if (newpages == NULL)
+    {
+      return -ENOMEM;
+    }
 
-  /* Check if the current allocation is sufficient */
+  /* New page table entries are holes */
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+  for (i = tfo->tfo_npages; i < npages; i++)
+    {
+      newpages[i] = NULL;
+    }
 
-  /* Are we growing or shrinking the object? */
+  tfo->tfo_alloc += npages * sizeof(FAR uint8_t *);
+  tfo->tfo_alloc -= tfo->tfo_npages * sizeof(FAR uint8_t *);
+  tfo->tfo_pages  = newpages;
+  tfo->tfo_npages = npages;
+  return OK;
+}
 
-  if (objsize <= oldtfo->tfo_alloc)
+/****************************************************************************
+ * Name: tmpfs_file_page
+ *
+ * Description:
+ *   Return the page 'pageno' of the file.  If the page is a hole, then
+ *   a zeroed page is allocated if 'alloc' is true; otherwise NULL is
+ *   returned.  The page must lie within the page table.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_file_page(FAR struct tmpfs_file_s *tfo,
+                                    size_t pageno, bool alloc)
+{
+  FAR uint8_t *page;
+
+  DEBUGASSERT(pageno < tfo->tfo_npages);
+
+  page = tfo->tfo_pages[pageno];
+  if (page == NULL && alloc)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
+      page = (FAR uint8_t *)kmm_zalloc(TMPFS_PAGESIZE);
+      if (page != NULL)
+        {
+          tfo->tfo_pages[pageno] = page;
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
+        }
+    }
+
+  return page;
+}
+
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ *
+ * Description:
+ *   Change the size of the file.  Growing the file only extends the page
+ *   table; pages are allocated when they are written.  Shrinking the file
+ *   frees the pages beyond the new end of file and zeroes the tail of the
+ *   new last page.
+ *
+ ****************************************************************************/
+
+static int tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
+{
+  size_t npages = TMPFS_NPAGES(newsize);
+  size_t offset;
+  size_t i;
+  int ret;
+
+  if (npages > tfo->tfo_npages)
+    {
+      /* Grow the page table geometrically so that appending to a file
+       * does not reallocate the table each time.
        */
 
-      if (newsize > 0)
+      i = 2 * tfo->tfo_npages;
+      if (i < TMPFS_MIN_PAGETABLE)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          i = TMPFS_MIN_PAGETABLE;
+        }
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+      ret = tmpfs_realloc_pagetable(tfo, i > npages ? i : npages);
+      if (ret < 0)
+        {
+          ret = tmpfs_realloc_pagetable(tfo, npages);
+          if (ret < 0)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
-
-              oldtfo->tfo_size = newsize;
-              return OK;
+              return ret;
             }
         }
     }
+  else if (newsize < tfo->tfo_size)
+    {
+      /* Free the pages beyond the new end of the file */
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+      for (i = npages; i < tfo->tfo_npages; i++)
+        {
+          if (tfo->tfo_pages[i] != NULL)
+            {
+              kmm_free(tfo->tfo_pages[i]);
+              tfo->tfo_pages[i] = NULL;
+              tfo->tfo_alloc   -= TMPFS_PAGESIZE;
+            }
+        }
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+      /* Zero the tail of the new last page so that the file reads as zero
+       * if it grows again.
+       */
 
-  /* Realloc the file object */
+      offset = newsize % TMPFS_PAGESIZE;
+      if (offset > 0 && tfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(&tfo->tfo_pages[npages - 1][offset], 0,
+                 TMPFS_PAGESIZE - offset);
+        }
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
-    {
-      return -ENOMEM;
+      /* Release the page table if most of it is no longer used.  Failing
+       * to shrink it is harmless.
+       */
+
+      if (npages == 0 || 4 * npages <= tfo->tfo_npages)
+        {
+          (void)tmpfs_realloc_pagetable(tfo, npages);
+        }
     }
 
-  /* Adjust the reference in the parent directory entry */
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_object
+ *
+ * Description:
+ *   Free an object that is no longer referenced with all of its memory.
+ *
+ ****************************************************************************/
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+static void tmpfs_free_object(FAR struct tmpfs_object_s *to)
+{
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      FAR struct tmpfs_file_s *tfo = (FAR struct tmpfs_file_s *)to;
+      size_t i;
 
-  /* Return the new address of the reallocated file object */
+      for (i = 0; i < tfo->tfo_npages; i++)
+        {
+          if (tfo->tfo_pages[i] != NULL)
+            {
+              kmm_free(tfo->tfo_pages[i]);
+            }
+        }
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
-  return OK;
+      if (tfo->tfo_pages != NULL)
+        {
+          kmm_free(tfo->tfo_pages);
+        }
+    }
+  else /* if (to->to_type == TMPFS_DIRECTORY) */
+    {
+      FAR struct tmpfs_directory_s *tdo = (FAR struct tmpfs_directory_s *)to;
+
+      if (tdo->tdo_buckets != NULL)
+        {
+          kmm_free(tdo->tdo_buckets);
+        }
+    }
+
+  nxsem_destroy(&to->to_exclsem.ts_sem);
+  kmm_free(to);
 }
 
 /****************************************************************************
@@ -476,8 +627,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_object((FAR struct tmpfs_object_s *)tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -490,44 +640,196 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 }
 
 /****************************************************************************
- * Name: tmpfs_find_dirent
+ * Name: tmpfs_hash_name
+ *
+ * Description:
+ *   Return the FNV-1a hash of a directory entry name.
+ *
  ****************************************************************************/
 
-static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
-                             FAR const char *name)
+static uint32_t tmpfs_hash_name(FAR const char *name)
 {
-  int i;
+  uint32_t hash = 2166136261u;
 
-  /* Search the list of directory entries for a match */
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
 
-  for (i = 0;
-       i < tdo->tdo_nentries &&
-       strcmp(tdo->tdo_entry[i].tde_name, name) != 0;
-       i++);
+/****************************************************************************
+ * Name: tmpfs_hash_insert
+ ****************************************************************************/
 
-  /* Return what we found, if anything */
+static void tmpfs_hash_insert(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *bucket;
 
-  return i < tdo->tdo_nentries ? i : -ENOENT;
+  if (tdo->tdo_buckets != NULL)
+    {
+      bucket        = &tdo->tdo_buckets[tde->tde_hash &
+                                        (tdo->tdo_nbuckets - 1)];
+      tde->tde_next = *bucket;
+      *bucket       = index;
+    }
 }
 
 /****************************************************************************
- * Name: tmpfs_remove_dirent
+ * Name: tmpfs_hash_remove
  ****************************************************************************/
 
-static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
-                               FAR const char *name)
+static void tmpfs_hash_remove(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
 {
-  int index;
-  int last;
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *link;
 
-  /* Search the list of directory entries for a match */
+  if (tdo->tdo_buckets != NULL)
+    {
+      /* Find the link to this entry in its bucket chain and unlink it */
 
-  index = tmpfs_find_dirent(tdo, name);
-  if (index < 0)
+      link = &tdo->tdo_buckets[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+      while (*link != TMPFS_NO_ENTRY && *link != index)
+        {
+          link = &tdo->tdo_entry[*link].tde_next;
+        }
+
+      DEBUGASSERT(*link == index);
+      *link = tde->tde_next;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_rebuild
+ *
+ * Description:
+ *   Create, resize or release the hash index of the directory so that it
+ *   matches the current number of entries.  If the memory for the index
+ *   cannot be allocated, the directory is simply searched linearly.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo)
+{
+  FAR uint16_t *buckets;
+  unsigned int nbuckets;
+  unsigned int i;
+
+  if (CONFIG_FS_TMPFS_DIRECTORY_HASH <= 0 ||
+      tdo->tdo_nentries < CONFIG_FS_TMPFS_DIRECTORY_HASH / 2)
     {
-      return index;
+      nbuckets = 0;
+    }
+  else
+    {
+      /* Use about one bucket per entry */
+
+      for (nbuckets = 8;
+           nbuckets < tdo->tdo_nentries && nbuckets < 0x8000;
+           nbuckets <<= 1);
+    }
+
+  if (nbuckets == tdo->tdo_nbuckets)
+    {
+      return;
+    }
+
+  buckets = NULL;
+  if (nbuckets > 0)
+    {
+      buckets = (FAR uint16_t *)kmm_malloc(nbuckets * sizeof(uint16_t));
+      if (buckets == NULL && tdo->tdo_buckets != NULL)
+        {
+          /* Keep the old index.  It is still valid, just less effective. */
+
+          return;
+        }
+    }
+
+  if (tdo->tdo_buckets != NULL)
+    {
+      kmm_free(tdo->tdo_buckets);
+    }
+
+  tdo->tdo_buckets  = buckets;
+  tdo->tdo_nbuckets = buckets != NULL ? nbuckets : 0;
+
+  if (buckets != NULL)
+    {
+      for (i = 0; i < nbuckets; i++)
+        {
+          buckets[i] = TMPFS_NO_ENTRY;
+        }
+
+      for (i = 0; i < tdo->tdo_nentries; i++)
+        {
+          tmpfs_hash_insert(tdo, i);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_find_dirent
+ ****************************************************************************/
+
+static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
+                             FAR const char *name)
+{
+  FAR struct tmpfs_dirent_s *tde;
+  uint32_t hash = tmpfs_hash_name(name);
+  int i;
+
+  /* Use the hash index, if there is one */
+
+  if (tdo->tdo_buckets != NULL)
+    {
+      for (i = tdo->tdo_buckets[hash & (tdo->tdo_nbuckets - 1)];
+           i != TMPFS_NO_ENTRY;
+           i = tde->tde_next)
+        {
+          tde = &tdo->tdo_entry[i];
+          if (tde->tde_hash == hash && strcmp(tde->tde_name, name) == 0)
+            {
+              return i;
+            }
+        }
+
+      return -ENOENT;
     }
 
+  /* Otherwise, search the list of directory entries for a match */
+
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      tde = &tdo->tdo_entry[i];
+      if (tde->tde_hash == hash && strcmp(tde->tde_name, name) == 0)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_dirent
+ *
+ * Description:
+ *   Free the name of the directory entry at 'index' and remove the entry
+ *   from the directory.  The object is not freed.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_dirent(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  unsigned int last;
+
   /* Free the object name */
 
   if (tdo->tdo_entry[index].tde_name != NULL)
@@ -535,6 +837,8 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
       kmm_free(tdo->tdo_entry[index].tde_name);
     }
 
+  tmpfs_hash_remove(tdo, index);
+
   /* Remove by replacing this entry with the final directory entry */
 
   last = tdo->tdo_nentries - 1;
@@ -546,12 +850,17 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
 
       /* Move the directory entry */
 
+      tmpfs_hash_remove(tdo, last);
+
       newtde             = &tdo->tdo_entry[index];
       oldtde             = &tdo->tdo_entry[last];
       to                 = oldtde->tde_object;
 
       newtde->tde_object = to;
       newtde->tde_name   = oldtde->tde_name;
+      newtde->tde_hash   = oldtde->tde_hash;
+
+      tmpfs_hash_insert(tdo, index);
 
       /* Reset the backward link to the directory entry */
 
@@ -561,6 +870,34 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
   /* And decrement the count of directory entries */
 
   tdo->tdo_nentries = last;
+
+  /* Release the hash index if the directory has become small */
+
+  if (tdo->tdo_buckets != NULL &&
+      tdo->tdo_nentries < CONFIG_FS_TMPFS_DIRECTORY_HASH / 2)
+    {
+      tmpfs_hash_rebuild(tdo);
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_remove_dirent
+ ****************************************************************************/
+
+static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
+                               FAR const char *name)
+{
+  int index;
+
+  /* Search the list of directory entries for a match */
+
+  index = tmpfs_find_dirent(tdo, name);
+  if (index < 0)
+    {
+      return index;
+    }
+
+  tmpfs_free_dirent(tdo, index);
   return OK;
 }
 
@@ -589,10 +926,15 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
       return -ENOMEM;
     }
 
-  /* Get the new number of entries */
+  /* Get the new number of entries.  The hash chains are 16-bit indices. */
 
   oldtdo = *tdo;
   nentries = oldtdo->tdo_nentries + 1;
+  if (nentries >= TMPFS_NO_ENTRY)
+    {
+      kmm_free(newname);
+      return -ENOSPC;
+    }
 
   /* Reallocate the directory object (if necessary) */
 
@@ -609,6 +951,24 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
   tde             = &newtdo->tdo_entry[index];
   tde->tde_object = to;
   tde->tde_name   = newname;
+  tde->tde_hash   = tmpfs_hash_name(newname);
+
+  /* Add the entry to the hash index, creating or growing the index when
+   * the directory has become large.
+   */
+
+  if (CONFIG_FS_TMPFS_DIRECTORY_HASH > 0 &&
+      ((newtdo->tdo_buckets == NULL &&
+        nentries >= CONFIG_FS_TMPFS_DIRECTORY_HASH) ||
+       (newtdo->tdo_buckets != NULL &&
+        nentries > 2 * newtdo->tdo_nbuckets)))
+    {
+      tmpfs_hash_rebuild(newtdo);
+    }
+  else
+    {
+      tmpfs_hash_insert(newtdo, index);
+    }
 
   /* Add backward link to the directory entry to the object */
 
@@ -623,12 +983,10 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  There are no pages yet. */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -638,11 +996,13 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
+  tfo->tfo_alloc  = sizeof(struct tmpfs_file_s);
+  tfo->tfo_type   = TMPFS_REGULAR;
+  tfo->tfo_refs   = 1;
+  tfo->tfo_flags  = 0;
+  tfo->tfo_size   = 0;
+  tfo->tfo_npages = 0;
+  tfo->tfo_pages  = NULL;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -758,8 +1118,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
   /* Error exits */
 
 errout_with_file:
-  nxsem_destroy(&newtfo->tfo_exclsem.ts_sem);
-  kmm_free(newtfo);
+  tmpfs_free_object((FAR struct tmpfs_object_s *)newtfo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -801,6 +1160,8 @@ static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void)
   tdo->tdo_type     = TMPFS_DIRECTORY;
   tdo->tdo_refs     = 0;
   tdo->tdo_nentries = 0;
+  tdo->tdo_nbuckets = 0;
+  tdo->tdo_buckets  = NULL;
 
   tdo->tdo_exclsem.ts_holder = TMPFS_NO_HOLDER;
   tdo->tdo_exclsem.ts_count  = 0;
@@ -920,8 +1281,7 @@ static int tmpfs_create_directory(FAR struct tmpfs_s *fs,
   /* Error exits */
 
 errout_with_directory:
-  nxsem_destroy(&newtdo->tdo_exclsem.ts_sem);
-  kmm_free(newtdo);
+  tmpfs_free_object((FAR struct tmpfs_object_s *)newtdo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -1221,45 +1581,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
                               unsigned int index, FAR void *arg)
 {
-  FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
-
-  /* Free the object name */
-
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      kmm_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
-
-  tde  = &tdo->tdo_entry[index];
-  to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
-
-  if (index != last)
-    {
-      FAR struct tmpfs_dirent_s *oldtde;
-      FAR struct tmpfs_object_s *oldto;
-
-      /* Move the directory entry */
-
-      oldtde           = &tdo->tdo_entry[last];
-      oldto            = oldtde->tde_object;
-
-      tde->tde_object  = oldto;
-      tde->tde_name    = oldtde->tde_name;
-
-      /* Reset the backward link to the directory entry */
-
-      oldto->to_dirent = tde;
-    }
 
-  /* And decrement the count of directory entries */
+  /* Remove the directory entry */
 
-  tdo->tdo_nentries = last;
+  to = tdo->tdo_entry[index].tde_object;
+  tmpfs_free_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1280,8 +1608,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Free the object now */
 
-  nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  tmpfs_free_object(to);
   return TMPFS_DELETED;
 }
 
@@ -1433,7 +1760,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
+              ret = tmpfs_resize_file(tfo, 0);
               if (ret < 0)
                 {
                   goto errout_with_filelock;
@@ -1548,7 +1875,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_object((FAR struct tmpfs_object_s *)tfo);
       return OK;
     }
 
@@ -1566,9 +1893,13 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *page;
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+  size_t offset;
+  size_t ncopy;
+  size_t done;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
         filep, buffer, (unsigned long)buflen);
@@ -1588,15 +1919,41 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the file pages to the user buffer.  Holes read as
+   * zeroes.
+   */
+
+  for (done = 0; done < nread; done += ncopy)
+    {
+      offset = (startpos + done) % TMPFS_PAGESIZE;
+      ncopy  = TMPFS_PAGESIZE - offset;
+      if (ncopy > nread - done)
+        {
+          ncopy = nread - done;
+        }
+
+      page = tmpfs_file_page(tfo, (startpos + done) / TMPFS_PAGESIZE,
+                             false);
+      if (page != NULL)
+        {
+          memcpy(&buffer[done], &page[offset], ncopy);
+        }
+      else
+        {
+          memset(&buffer[done], 0, ncopy);
+        }
+    }
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1613,9 +1970,13 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *page;
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t oldsize;
+  size_t offset;
+  size_t ncopy;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1633,25 +1994,60 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   /* Handle attempts to write beyond the end of the file */
 
   startpos = filep->f_pos;
-  nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Extend the file to handle the write past the end of the file. */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+      ret = tmpfs_resize_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
-
-      filep->f_priv = tfo;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the file pages, allocating the pages
+   * as they are first written.
+   */
+
+  for (nwritten = 0; nwritten < buflen; nwritten += ncopy)
+    {
+      offset = (startpos + nwritten) % TMPFS_PAGESIZE;
+      ncopy  = TMPFS_PAGESIZE - offset;
+      if (ncopy > buflen - nwritten)
+        {
+          ncopy = buflen - nwritten;
+        }
+
+      page = tmpfs_file_page(tfo, (startpos + nwritten) / TMPFS_PAGESIZE,
+                             true);
+      if (page == NULL)
+        {
+          /* Out of memory.  The file only grows by what was written. */
+
+          if (startpos + nwritten > oldsize)
+            {
+              tfo->tfo_size = startpos + nwritten;
+            }
+          else if (endpos > oldsize)
+            {
+              tfo->tfo_size = oldsize;
+            }
+
+          if (nwritten == 0)
+            {
+              ret = -ENOMEM;
+              goto errout_with_lock;
+            }
+
+          break;
+        }
+
+      memcpy(&page[offset], &buffer[nwritten], ncopy);
+    }
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1747,11 +2143,25 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
       /* Return the address on the media corresponding to the start of
-       * the file.
+       * the file.  This is only possible if the file fits in one page.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      if (tfo->tfo_size > TMPFS_PAGESIZE)
+        {
+          return -ENOTTY;
+        }
+
+      if (tfo->tfo_size == 0)
+        {
+          *ppv = NULL;
+          return OK;
+        }
+
+      tmpfs_lock_file(tfo);
+      *ppv = (FAR void *)tmpfs_file_page(tfo, 0, true);
+      tmpfs_unlock_file(tfo);
+
+      return *ppv != NULL ? OK : -ENOMEM;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1853,31 +2263,15 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      filep->f_priv = tfo;
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Resize the page table.  Any
+       * newly added region is a hole and reads as zeroes.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      ret = tmpfs_resize_file(tfo, (size_t)length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2121,8 +2515,7 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Now we can destroy the root file system and the file system itself. */
 
-  nxsem_destroy(&tdo->tdo_exclsem.ts_sem);
-  kmm_free(tdo);
+  tmpfs_free_object((FAR struct tmpfs_object_s *)tdo);
 
   nxsem_destroy(&fs->tfs_exclsem.ts_sem);
   kmm_free(fs);
@@ -2280,8 +2673,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_object((FAR struct tmpfs_object_s *)tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -2406,8 +2798,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Free the directory object */
 
-  nxsem_destroy(&tdo->tdo_exclsem.ts_sem);
-  kmm_free(tdo);
+  tmpfs_free_object((FAR struct tmpfs_object_s *)tdo);
 
   /* Release the reference and lock on the parent directory */
 
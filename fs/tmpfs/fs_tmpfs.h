@@ -58,6 +58,15 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is kept in pages of CONFIG_FS_TMPFS_PAGESIZE bytes */
+
+#define TMPFS_PAGESIZE    CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_NPAGES(n)   (((n) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+
+/* Terminates a directory hash chain */
+
+#define TMPFS_NO_ENTRY    0xffff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -95,6 +104,8 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+  uint32_t tde_hash;     /* Hash of the name */
+  uint16_t tde_next;     /* Next entry in the same hash bucket */
 };
 
 /* The generic form of a TMPFS memory object */
@@ -125,6 +136,8 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
+  uint16_t tdo_nbuckets; /* Number of hash buckets (a power of 2) or zero */
+  FAR uint16_t *tdo_buckets; /* Index of the first entry of each bucket */
   struct tmpfs_dirent_s tdo_entry[1];
 };
 
@@ -137,6 +150,11 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in separately allocated pages that are found
+ * through a page table.  The file object itself never moves.  A NULL
+ * page table entry is a hole that reads as zeroes.  File data beyond
+ * tfo_size in an allocated page is always zero.
  */
 
 struct tmpfs_file_s
@@ -154,11 +172,10 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  size_t   tfo_npages;   /* Number of entries in the page table */
+  FAR uint8_t **tfo_pages; /* The page table */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s
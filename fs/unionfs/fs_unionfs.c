@@ -74,6 +74,16 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+#ifndef CONFIG_UNIONFS_LOOKUP_CACHE
+#  define CONFIG_UNIONFS_LOOKUP_CACHE 0
+#endif
+
+/* What the lookup cache knows about a path on one contained file system */
+
+#define UNIONFS_UNKNOWN  0           /* Not in the cache */
+#define UNIONFS_PRESENT  1           /* Something exists at the path */
+#define UNIONFS_ABSENT   2           /* Nothing exists at the path */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +96,21 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+#if CONFIG_UNIONFS_LOOKUP_CACHE > 0
+/* This structure describes one entry in the lookup cache.  It remembers
+ * on which of the contained file systems a path exists, including the
+ * negative result that it does not exist there.
+ */
+
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Relative path (NULL if unused) */
+  uint32_t ul_hash;                  /* Hash of ul_path */
+  uint32_t ul_age;                   /* Time of the last use */
+  uint8_t ul_state[2];               /* State on each contained file system */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -94,6 +119,10 @@ struct unionfs_inode_s
   sem_t ui_exclsem;                  /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#if CONFIG_UNIONFS_LOOKUP_CACHE > 0
+  uint32_t ui_lookupage;             /* Incremented on each cache use */
+  struct unionfs_lookup_s ui_lookup[CONFIG_UNIONFS_LOOKUP_CACHE];
+#endif
 };
 
 /* This structure descries one opened file */
@@ -140,6 +169,22 @@ static int     unionfs_trystatdir(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
 static int     unionfs_trystatfile(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
+#if CONFIG_UNIONFS_LOOKUP_CACHE > 0
+static FAR struct unionfs_lookup_s *
+               unionfs_lookup_find(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, bool alloc);
+static int     unionfs_lookup_state(FAR struct unionfs_inode_s *ui, int ndx,
+                 FAR const char *relpath);
+static void    unionfs_lookup_update(FAR struct unionfs_inode_s *ui, int ndx,
+                 FAR const char *relpath, int result);
+static void    unionfs_lookup_flush(FAR struct unionfs_inode_s *ui);
+#else
+#  define      unionfs_lookup_state(ui,n,p) UNIONFS_UNKNOWN
+#  define      unionfs_lookup_update(ui,n,p,r)
+#  define      unionfs_lookup_flush(ui)
+#endif
+static int     unionfs_lookup_stat(FAR struct unionfs_inode_s *ui, int ndx,
+                 FAR const char *relpath, FAR struct stat *buf);
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
 
@@ -692,6 +737,179 @@ static int unionfs_tryunlink(FAR struct inode *inode,
   return ops->unlink(inode, trypath);
 }
 
+#if CONFIG_UNIONFS_LOOKUP_CACHE > 0
+/****************************************************************************
+ * Name: unionfs_lookup_find
+ *
+ * Description:
+ *   Find the lookup cache entry of the relative path.  If there is none and
+ *   'alloc' is true, then re-use the least recently used entry for it.
+ *
+ * Assumptions:
+ *   The caller holds the unionfs semaphore.
+ *
+ ****************************************************************************/
+
+static FAR struct unionfs_lookup_s *
+unionfs_lookup_find(FAR struct unionfs_inode_s *ui, FAR const char *relpath,
+                    bool alloc)
+{
+  FAR struct unionfs_lookup_s *entry;
+  FAR struct unionfs_lookup_s *oldest;
+  FAR const char *ptr;
+  uint32_t hash;
+  int i;
+
+  if (relpath == NULL)
+    {
+      return NULL;
+    }
+
+  /* FNV-1a hash of the path */
+
+  hash = 2166136261u;
+  for (ptr = relpath; *ptr != '\0'; ptr++)
+    {
+      hash = (hash ^ (uint8_t)*ptr) * 16777619u;
+    }
+
+  oldest = &ui->ui_lookup[0];
+  for (i = 0; i < CONFIG_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      entry = &ui->ui_lookup[i];
+      if (entry->ul_path != NULL && entry->ul_hash == hash &&
+          strcmp(entry->ul_path, relpath) == 0)
+        {
+          entry->ul_age = ++ui->ui_lookupage;
+          return entry;
+        }
+
+      if (oldest->ul_path != NULL &&
+          (entry->ul_path == NULL || entry->ul_age < oldest->ul_age))
+        {
+          oldest = entry;
+        }
+    }
+
+  if (!alloc)
+    {
+      return NULL;
+    }
+
+  /* Replace the free or least recently used entry */
+
+  if (oldest->ul_path != NULL)
+    {
+      kmm_free(oldest->ul_path);
+    }
+
+  oldest->ul_path = strdup(relpath);
+  if (oldest->ul_path == NULL)
+    {
+      return NULL;
+    }
+
+  oldest->ul_hash     = hash;
+  oldest->ul_age      = ++ui->ui_lookupage;
+  oldest->ul_state[0] = UNIONFS_UNKNOWN;
+  oldest->ul_state[1] = UNIONFS_UNKNOWN;
+  return oldest;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_state
+ *
+ * Description:
+ *   Return what the lookup cache knows about the relative path on file
+ *   system 'ndx':  UNIONFS_UNKNOWN, UNIONFS_PRESENT or UNIONFS_ABSENT.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup_state(FAR struct unionfs_inode_s *ui, int ndx,
+                                FAR const char *relpath)
+{
+  FAR struct unionfs_lookup_s *entry;
+
+  entry = unionfs_lookup_find(ui, relpath, false);
+  return entry != NULL ? entry->ul_state[ndx] : UNIONFS_UNKNOWN;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_update
+ *
+ * Description:
+ *   Record the result of a lookup of the relative path on file system
+ *   'ndx'.  Success means that something exists at the path; -ENOENT means
+ *   that nothing does.  Other errors tell us nothing.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_update(FAR struct unionfs_inode_s *ui, int ndx,
+                                  FAR const char *relpath, int result)
+{
+  FAR struct unionfs_lookup_s *entry;
+
+  if (result >= 0 || result == -ENOENT)
+    {
+      entry = unionfs_lookup_find(ui, relpath, true);
+      if (entry != NULL)
+        {
+          entry->ul_state[ndx] = result >= 0 ? UNIONFS_PRESENT :
+                                               UNIONFS_ABSENT;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_flush
+ *
+ * Description:
+ *   Discard the whole lookup cache.  This is done whenever the name space
+ *   of either file system changes.  Removing or renaming a directory
+ *   affects every path below it so there is no cheaper, selective way.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_flush(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      if (ui->ui_lookup[i].ul_path != NULL)
+        {
+          kmm_free(ui->ui_lookup[i].ul_path);
+          ui->ui_lookup[i].ul_path = NULL;
+        }
+    }
+}
+#endif /* CONFIG_UNIONFS_LOOKUP_CACHE > 0 */
+
+/****************************************************************************
+ * Name: unionfs_lookup_stat
+ *
+ * Description:
+ *   stat() the relative path on file system 'ndx', unless the lookup cache
+ *   already knows that nothing exists there.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup_stat(FAR struct unionfs_inode_s *ui, int ndx,
+                               FAR const char *relpath, FAR struct stat *buf)
+{
+  FAR struct unionfs_mountpt_s *um = &ui->ui_fs[ndx];
+  int ret;
+
+  if (unionfs_lookup_state(ui, ndx, relpath) == UNIONFS_ABSENT)
+    {
+      return -ENOENT;
+    }
+
+  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  unionfs_lookup_update(ui, ndx, relpath, ret);
+  return ret;
+}
+
 /****************************************************************************
  * Name: unionfs_relpath
  ****************************************************************************/
@@ -817,7 +1035,9 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
   (void)unionfs_unbind_child(&ui->ui_fs[0]);
   (void)unionfs_unbind_child(&ui->ui_fs[1]);
 
-  /* Free any allocated prefix strings */
+  /* Free any allocated prefix strings and cached paths */
+
+  unionfs_lookup_flush(ui);
 
   if (ui->ui_fs[0].um_prefix)
     {
@@ -882,7 +1102,22 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   uf->uf_file.f_inode  = um->um_node;
   uf->uf_file.f_priv   = NULL;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+  /* Don't look on file system 1 if we know that the file is not there,
+   * unless it may be created there.
+   */
+
+  if ((oflags & O_CREAT) == 0 &&
+      unionfs_lookup_state(ui, 0, relpath) == UNIONFS_ABSENT)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                            mode);
+      unionfs_lookup_update(ui, 0, relpath, ret);
+    }
+
   if (ret >= 0)
     {
       /* Successfully opened on file system 1 */
@@ -900,10 +1135,21 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_file.f_inode  = um->um_node;
       uf->uf_file.f_priv   = NULL;
 
-      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
-                            mode);
+      if ((oflags & O_CREAT) == 0 &&
+          unionfs_lookup_state(ui, 1, relpath) == UNIONFS_ABSENT)
+        {
+          ret = -ENOENT;
+        }
+      else
+        {
+          ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                oflags, mode);
+          unionfs_lookup_update(ui, 1, relpath, ret);
+        }
+
       if (ret < 0)
         {
+          kmm_free(uf);
           goto errout_with_semaphore;
         }
 
@@ -1474,6 +1720,7 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       fu->fu_relpath = strdup(relpath);
       if (!fu->fu_relpath)
         {
+          ret = -ENOMEM;
           goto errout_with_semaphore;
         }
     }
@@ -1491,7 +1738,17 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   um = &ui->ui_fs[1];
   lowerdir->fd_root = um->um_node;
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, lowerdir);
+  if (unionfs_lookup_state(ui, 1, relpath) == UNIONFS_ABSENT)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               lowerdir);
+      unionfs_lookup_update(ui, 1, relpath, ret);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 2 access info */
@@ -1526,7 +1783,17 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   um = &ui->ui_fs[0];
   lowerdir->fd_root = um->um_node;
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, lowerdir);
+  if (unionfs_lookup_state(ui, 0, relpath) == UNIONFS_ABSENT)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               lowerdir);
+      unionfs_lookup_update(ui, 0, relpath, ret);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 1 access info */
@@ -1689,7 +1956,6 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
-  FAR struct unionfs_mountpt_s *um0;
   FAR const struct mountpt_operations *ops;
   FAR struct fs_unionfsdir_s *fu;
   FAR char *relpath;
@@ -1829,9 +2095,12 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
 
                       /* Check if anything exists at this path on file system 1 */
 
-                      um0 = &ui->ui_fs[0];
-                      tmp = unionfs_trystat(um0->um_node, relpath,
-                                            um0->um_prefix, &buf);
+                      tmp = unionfs_semtake(ui, false);
+                      if (tmp >= 0)
+                        {
+                          tmp = unionfs_lookup_stat(ui, 0, relpath, &buf);
+                          unionfs_semgive(ui);
+                        }
 
                       /* Free the allocated relpath */
 
@@ -1904,9 +2173,12 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
 
                   /* Check if anything exists at this path on file system 1 */
 
-                  um0 = &ui->ui_fs[0];
-                  tmp = unionfs_trystat(um0->um_node, relpath,
-                                        um0->um_prefix, &buf);
+                  tmp = unionfs_semtake(ui, false);
+                  if (tmp >= 0)
+                    {
+                      tmp = unionfs_lookup_stat(ui, 0, relpath, &buf);
+                      unionfs_semgive(ui);
+                    }
                   if (tmp >= 0)
                     {
                       /* There is something there!
@@ -2305,6 +2577,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  unionfs_lookup_flush(ui);
   unionfs_semgive(ui);
   return ret;
 }
@@ -2381,6 +2654,8 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       ret = ret1;
     }
 
+  unionfs_lookup_flush(ui);
+
 errout_with_semaphore:
   unionfs_semgive(ui);
   return ret;
@@ -2435,6 +2710,8 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
           unionfs_semgive(ui);
           return ret;
         }
+
+      unionfs_lookup_flush(ui);
     }
 
   /* Either the directory does not exist on file system 1, or we
@@ -2454,6 +2731,8 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       /* REVISIT:  Should we try to restore the directory on file system 1
        * if we failure to removed the directory on file system 2?
        */
+
+      unionfs_lookup_flush(ui);
     }
 
   unionfs_semgive(ui);
@@ -2510,6 +2789,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
            * file of the same relative path will become visible.
            */
 
+          unionfs_lookup_flush(ui);
           unionfs_semgive(ui);
           return OK;
         }
@@ -2530,6 +2810,10 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
       ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
                               um->um_prefix);
+      if (ret >= 0)
+        {
+          unionfs_lookup_flush(ui);
+        }
     }
 
   unionfs_semgive(ui);
@@ -2565,8 +2849,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* stat this path on file system 1 */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = unionfs_lookup_stat(ui, 0, relpath, buf);
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
@@ -2579,8 +2862,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* stat failed on the file system 1.  Try again on file system 2. */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = unionfs_lookup_stat(ui, 1, relpath, buf);
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
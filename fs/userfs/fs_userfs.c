@@ -356,41 +356,38 @@ static int userfs_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: userfs_read
+ * Name: userfs_read_chunk
+ *
+ * Description:
+ *   Send one read request to the server and receive the response.  If
+ *   CONFIG_FS_USERFS_DIRECTIO is selected, the server reads directly into
+ *   the caller's buffer.  Otherwise, the data accompanies the response and
+ *   no more than mxwrite bytes can be read.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
  ****************************************************************************/
 
-static ssize_t userfs_read(FAR struct file *filep, char *buffer,
-                           size_t buflen)
+static ssize_t userfs_read_chunk(FAR struct userfs_state_s *priv,
+                                 FAR void *openinfo, FAR char *buffer,
+                                 size_t buflen)
 {
-  FAR struct userfs_state_s *priv;
   FAR struct userfs_read_request_s *req;
   FAR struct userfs_read_response_s *resp;
   ssize_t nsent;
   ssize_t nrecvd;
   int respsize;
-  int ret;
-
-  finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
-
-  DEBUGASSERT(filep != NULL &&
-              filep->f_inode != NULL &&
-              filep->f_inode->i_private != NULL);
-  priv = filep->f_inode->i_private;
-
-  /* Get exclusive access */
-
-  ret = sem_wait(&priv->exclsem);
-  if (ret < 0)
-    {
-      return ret;
-    }
 
   /* Construct and send the request to the server */
 
   req           = (FAR struct userfs_read_request_s *)priv->iobuffer;
   req->req      = USERFS_REQ_READ;
-  req->openinfo = filep->f_priv;
+  req->openinfo = openinfo;
   req->readlen  = buflen;
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  req->rdbuffer = buffer;
+#endif
 
   nsent = psock_sendto(&priv->psock, priv->iobuffer,
                        sizeof(struct userfs_read_request_s), 0,
@@ -399,20 +396,17 @@ static ssize_t userfs_read(FAR struct file *filep, char *buffer,
   if (nsent < 0)
     {
       ferr("ERROR: psock_sendto failed: %d\n", (int)nsent);
-      sem_post(&priv->exclsem);
-      return (int)nsent;
+      return nsent;
     }
 
   /* Then get the response from the server */
 
   nrecvd = psock_recvfrom(&priv->psock, priv->iobuffer, IOBUFFER_SIZE(priv),
                           0, NULL, NULL);
-  sem_post(&priv->exclsem);
-
   if (nrecvd < 0)
     {
       ferr("ERROR: psock_recvfrom failed: %d\n", (int)nrecvd);
-      return (int)nrecvd;
+      return nrecvd;
     }
 
   if (nrecvd < SIZEOF_USERFS_READ_RESPONSE_S(0))
@@ -428,92 +422,171 @@ static ssize_t userfs_read(FAR struct file *filep, char *buffer,
       return -EIO;
     }
 
+  /* A negative value is the error reported by the server */
+
+  if (resp->nread < 0)
+    {
+      return resp->nread;
+    }
+
   if (resp->nread > buflen)
     {
       ferr("ERROR: Response size too large: %u\n", (unsigned int)nrecvd);
       return -EIO;
     }
 
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  respsize = SIZEOF_USERFS_READ_RESPONSE_S(0);
+#else
   respsize = SIZEOF_USERFS_READ_RESPONSE_S(resp->nread);
+#endif
   if (respsize != nrecvd)
     {
       ferr("ERROR: Incorrect response size: %u\n", (unsigned int)nrecvd);
       return -EIO;
     }
 
+#ifndef CONFIG_FS_USERFS_DIRECTIO
   /* Copy the received data to the user buffer */
 
   memcpy(buffer, resp->rddata, resp->nread);
+#endif
   return resp->nread;
 }
 
 /****************************************************************************
- * Name: userfs_write
+ * Name: userfs_read
  ****************************************************************************/
 
-static ssize_t userfs_write(FAR struct file *filep, FAR const char *buffer,
-                            size_t buflen)
+static ssize_t userfs_read(FAR struct file *filep, char *buffer,
+                           size_t buflen)
 {
   FAR struct userfs_state_s *priv;
-  FAR struct userfs_write_request_s *req;
-  FAR struct userfs_write_response_s *resp;
-  ssize_t nsent;
-  ssize_t nrecvd;
+  ssize_t nread;
   int ret;
+#ifndef CONFIG_FS_USERFS_DIRECTIO
+  ssize_t ntotal;
+  size_t readlen;
+#endif
 
-  finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
+  finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
 
   DEBUGASSERT(filep != NULL &&
               filep->f_inode != NULL &&
               filep->f_inode->i_private != NULL);
   priv = filep->f_inode->i_private;
 
-  /* Perform multiple writes if the write length exceeds the configured
-   * maximum (mxwrite).
+  /* Get exclusive access */
+
+  ret = sem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  /* The server reads directly into the user buffer.  There is no limit on
+   * the size of the transfer.
+   */
+
+  nread = userfs_read_chunk(priv, filep->f_priv, buffer, buflen);
+#else
+  /* Perform multiple reads if the read length exceeds the configured
+   * maximum (mxwrite).  The exclusive access is held across all of the
+   * requests so that the reads are not interleaved with other requests
+   * on the same file system.  Stop at the first short read.
    */
 
-  if (buflen > priv->mxwrite)
+  ntotal = 0;
+  do
     {
-      return -E2BIG; /* No implememented yet */
+      readlen = buflen - ntotal;
+      if (readlen > priv->mxwrite)
+        {
+          readlen = priv->mxwrite;
+        }
+
+      nread = userfs_read_chunk(priv, filep->f_priv, buffer + ntotal,
+                                readlen);
+      if (nread < 0)
+        {
+          break;
+        }
+
+      ntotal += nread;
     }
+  while (nread == readlen && ntotal < buflen);
 
-  /* Get exclusive access */
+  /* Report the error only if nothing was read */
 
-  ret = sem_wait(&priv->exclsem);
-  if (ret < 0)
+  if (ntotal > 0 || nread >= 0)
     {
-      return ret;
+      nread = ntotal;
     }
+#endif
+
+  sem_post(&priv->exclsem);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: userfs_write_chunk
+ *
+ * Description:
+ *   Send one write request to the server and receive the response.  If
+ *   CONFIG_FS_USERFS_DIRECTIO is selected, the server writes directly from
+ *   the caller's buffer.  Otherwise, the data accompanies the request and
+ *   no more than mxwrite bytes can be written.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static ssize_t userfs_write_chunk(FAR struct userfs_state_s *priv,
+                                  FAR void *openinfo,
+                                  FAR const char *buffer, size_t buflen)
+{
+  FAR struct userfs_write_request_s *req;
+  FAR struct userfs_write_response_s *resp;
+  ssize_t nsent;
+  ssize_t nrecvd;
 
   /* Construct and send the request to the server */
 
   req           = (FAR struct userfs_write_request_s *)priv->iobuffer;
   req->req      = USERFS_REQ_WRITE;
-  req->openinfo = filep->f_priv;
+  req->openinfo = openinfo;
   req->writelen = buflen;
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  req->wrbuffer = buffer;
+
+  nsent = psock_sendto(&priv->psock, priv->iobuffer,
+                       SIZEOF_USERFS_WRITE_REQUEST_S(0), 0,
+                       (FAR struct sockaddr *)&priv->server,
+                       sizeof(struct sockaddr_in));
+#else
   memcpy(req->wrdata, buffer, buflen);
 
   nsent = psock_sendto(&priv->psock, priv->iobuffer,
                        SIZEOF_USERFS_WRITE_REQUEST_S(buflen), 0,
                        (FAR struct sockaddr *)&priv->server,
                        sizeof(struct sockaddr_in));
+#endif
   if (nsent < 0)
     {
       ferr("ERROR: psock_sendto failed: %d\n", (int)nsent);
-      sem_post(&priv->exclsem);
-      return (int)nsent;
+      return nsent;
     }
 
   /* Then get the response from the server */
 
   nrecvd = psock_recvfrom(&priv->psock, priv->iobuffer, IOBUFFER_SIZE(priv),
                           0, NULL, NULL);
-  sem_post(&priv->exclsem);
-
   if (nrecvd < 0)
     {
       ferr("ERROR: psock_recvfrom failed: %d\n", (int)nrecvd);
-      return (int)nrecvd;
+      return nrecvd;
     }
 
   if (nrecvd != sizeof(struct userfs_write_response_s))
@@ -532,6 +605,81 @@ static ssize_t userfs_write(FAR struct file *filep, FAR const char *buffer,
   return resp->nwritten;
 }
 
+/****************************************************************************
+ * Name: userfs_write
+ ****************************************************************************/
+
+static ssize_t userfs_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR struct userfs_state_s *priv;
+  ssize_t nwritten;
+  int ret;
+#ifndef CONFIG_FS_USERFS_DIRECTIO
+  ssize_t ntotal;
+  size_t writelen;
+#endif
+
+  finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
+
+  DEBUGASSERT(filep != NULL &&
+              filep->f_inode != NULL &&
+              filep->f_inode->i_private != NULL);
+  priv = filep->f_inode->i_private;
+
+  /* Get exclusive access */
+
+  ret = sem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  /* The server writes directly from the user buffer.  There is no limit on
+   * the size of the transfer.
+   */
+
+  nwritten = userfs_write_chunk(priv, filep->f_priv, buffer, buflen);
+#else
+  /* Perform multiple writes if the write length exceeds the configured
+   * maximum (mxwrite).  The exclusive access is held across all of the
+   * requests so that the writes are not interleaved with other requests
+   * on the same file system.  Stop at the first short write.
+   */
+
+  ntotal = 0;
+  do
+    {
+      writelen = buflen - ntotal;
+      if (writelen > priv->mxwrite)
+        {
+          writelen = priv->mxwrite;
+        }
+
+      nwritten = userfs_write_chunk(priv, filep->f_priv, buffer + ntotal,
+                                    writelen);
+      if (nwritten < 0)
+        {
+          break;
+        }
+
+      ntotal += nwritten;
+    }
+  while (nwritten == writelen && ntotal < buflen);
+
+  /* Report the error only if nothing was written */
+
+  if (ntotal > 0 || nwritten >= 0)
+    {
+      nwritten = ntotal;
+    }
+#endif
+
+  sem_post(&priv->exclsem);
+  return nwritten;
+}
+
 /****************************************************************************
  * Name: userfs_seek
  ****************************************************************************/
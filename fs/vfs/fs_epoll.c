@@ -42,194 +42,963 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <queue.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The poll events that may be monitored.  Errors and hang-ups are always
+ * reported.
+ */
+
+#define EPOLL_POLLEVENTS     (POLLIN | POLLOUT | POLLERR | POLLHUP)
+
+/* The state of one registered descriptor */
+
+#define EPOLL_ITEM_IDLE      0  /* Waiting for an event */
+#define EPOLL_ITEM_READY     1  /* In the ready list */
+#define EPOLL_ITEM_REARM     2  /* Reported, to be re-checked (level mode) */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one descriptor registered with an epoll
+ * instance.  The embedded pollfd stays registered with the driver from
+ * EPOLL_CTL_ADD until EPOLL_CTL_DEL so that the driver can report events at
+ * any time through poll_notify().
+ */
+
+struct epoll_head_s;
+struct epoll_item_s
+{
+  dq_entry_t               node;     /* Links the ready or re-arm list (must
+                                      * be first) */
+  FAR struct epoll_item_s *flink;    /* Links the list of all items */
+  FAR struct epoll_head_s *eph;      /* The epoll instance */
+  struct epoll_event       ev;       /* The registered events and data */
+  struct pollfd            pfd;      /* The persistent poll registration */
+  int                      fd;       /* The registered descriptor */
+  uint8_t                  state;    /* See EPOLL_ITEM_* definitions */
+  bool                     armed;    /* Registered with the driver */
+  bool                     disabled; /* EPOLLONESHOT event was reported */
+};
+
+/* This structure describes one epoll instance */
+
+struct epoll_head_s
+{
+  sem_t                    lock;     /* Serializes epoll_ctl()/epoll_wait() */
+  sem_t                    waitsem;  /* Posted when an item becomes ready */
+  FAR struct epoll_item_s *items;    /* All registered items */
+  dq_queue_t               rdlist;   /* Items with pending events */
+  dq_queue_t               rearm;    /* Level-triggered items to re-check */
+  int16_t                  crefs;    /* Number of open file descriptors */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_file_open(FAR struct file *filep);
+static int epoll_file_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  epoll_file_open,   /* open */
+  epoll_file_close,  /* close */
+  NULL,              /* read */
+  NULL,              /* write */
+  NULL,              /* seek */
+  NULL,              /* ioctl */
+  NULL               /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL             /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_callback
+ *
+ * Description:
+ *   Called by poll_notify() when the driver reports events on a registered
+ *   descriptor.  Add the item to the ready list and wake up a waiter.
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void epoll_callback(FAR struct pollfd *fds)
+{
+  FAR struct epoll_item_s *item = (FAR struct epoll_item_s *)fds->arg;
+  FAR struct epoll_head_s *eph = item->eph;
+  irqstate_t flags;
+  int semcount;
+
+  flags = enter_critical_section();
+  if (item->state == EPOLL_ITEM_IDLE && !item->disabled)
+    {
+      item->state = EPOLL_ITEM_READY;
+      dq_addlast(&item->node, &eph->rdlist);
+
+      /* Post the semaphore only if a thread is waiting so that the count
+       * does not accumulate.
+       */
+
+      nxsem_getvalue(&eph->waitsem, &semcount);
+      if (semcount < 0)
+        {
+          nxsem_post(&eph->waitsem);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the poll registration of one item.
+ *
+ ****************************************************************************/
+
+static int epoll_pollsetup(FAR struct epoll_item_s *item, bool setup)
+{
+  switch (item->pfd.events & POLLMASK)
+    {
+      case POLLFILE:
+        return file_poll((FAR struct file *)item->pfd.ptr, &item->pfd, setup);
+
+#ifdef CONFIG_NET
+      case POLLSOCK:
+        return psock_poll((FAR struct socket *)item->pfd.ptr, &item->pfd,
+                          setup);
+#endif
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Register the item with its driver.  The driver reports any events that
+ *   are already in effect.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_item_s *item)
+{
+  int ret;
+
+  item->pfd.events   = (item->pfd.events & POLLMASK) |
+                       (item->ev.events & EPOLL_POLLEVENTS) |
+                       POLLERR | POLLHUP;
+  item->pfd.revents  = 0;
+  item->pfd.priv     = NULL;
+
+  ret = epoll_pollsetup(item, true);
+  item->armed = (ret >= 0);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Unregister the item from its driver and remove it from the ready or
+ *   re-arm list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_item_s *item)
+{
+  FAR struct epoll_head_s *eph = item->eph;
+  irqstate_t flags;
+
+  if (item->armed)
+    {
+      (void)epoll_pollsetup(item, false);
+      item->armed = false;
+    }
+
+  flags = enter_critical_section();
+  if (item->state == EPOLL_ITEM_READY)
+    {
+      dq_rem(&item->node, &eph->rdlist);
+    }
+  else if (item->state == EPOLL_ITEM_REARM)
+    {
+      dq_rem(&item->node, &eph->rearm);
+    }
+
+  item->state = EPOLL_ITEM_IDLE;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Re-check the level-triggered items that were reported by the previous
+ *   epoll_wait().  Re-registering each item lets the driver report the
+ *   events that are still in effect.  The cost is proportional to the
+ *   number of events reported, not to the number of registered items.
+ *
+ * Assumptions:
+ *   The caller holds eph->lock.
+ *
+ ****************************************************************************/
+
+static void epoll_rearm(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_item_s *item;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      item  = (FAR struct epoll_item_s *)dq_remfirst(&eph->rearm);
+      if (item != NULL)
+        {
+          item->state = EPOLL_ITEM_IDLE;
+        }
+
+      leave_critical_section(flags);
+
+      if (item == NULL)
+        {
+          break;
+        }
+
+      if (item->armed)
+        {
+          (void)epoll_pollsetup(item, false);
+        }
+
+      if (epoll_arm(item) < 0)
+        {
+          /* The descriptor can no longer be polled */
+
+          item->pfd.revents |= POLLERR;
+          epoll_callback(&item->pfd);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_scan
+ *
+ * Description:
+ *   Drivers that have not been converted to poll_notify() post the
+ *   semaphore directly.  When a wake-up finds the ready list empty, find
+ *   the items with events by checking each one.
+ *
+ * Assumptions:
+ *   The caller holds eph->lock.
+ *
+ ****************************************************************************/
+
+static void epoll_scan(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_item_s *item;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (dq_peek(&eph->rdlist) == NULL)
+    {
+      for (item = eph->items; item != NULL; item = item->flink)
+        {
+          if ((item->pfd.revents & item->pfd.events & EPOLL_POLLEVENTS) != 0)
+            {
+              epoll_callback(&item->pfd);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_harvest
+ *
+ * Description:
+ *   Move up to 'maxevents' events from the ready list to the caller's
+ *   buffer.
+ *
+ * Assumptions:
+ *   The caller holds eph->lock.
+ *
+ ****************************************************************************/
+
+static int epoll_harvest(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_item_s *item;
+  pollevent_t revents;
+  irqstate_t flags;
+  int nevents = 0;
+
+  flags = enter_critical_section();
+  while (nevents < maxevents &&
+         (item = (FAR struct epoll_item_s *)dq_remfirst(&eph->rdlist)) !=
+         NULL)
+    {
+      revents            = item->pfd.revents & item->pfd.events &
+                           EPOLL_POLLEVENTS;
+      item->pfd.revents  = 0;
+      item->state        = EPOLL_ITEM_IDLE;
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = item->ev.data;
+      nevents++;
+
+      /* An edge-triggered item is reported again only when the driver
+       * reports a new event.  A level-triggered item is re-checked by the
+       * next epoll_wait().
+       */
+
+      if ((item->ev.events & EPOLLONESHOT) != 0)
+        {
+          item->disabled = true;
+        }
+      else if ((item->ev.events & EPOLLET) == 0)
+        {
+          item->state = EPOLL_ITEM_REARM;
+          dq_addlast(&item->node, &eph->rearm);
+        }
+    }
+
+  leave_critical_section(flags);
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_gethead
+ *
+ * Description:
+ *   Return the epoll instance of the file descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_gethead(int epfd, FAR struct epoll_head_s **eph)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(epfd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_epoll_ops)
+    {
+      return -EINVAL;
+    }
+
+  *eph = (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_setfd
+ *
+ * Description:
+ *   Bind the item to the file or socket of the descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_setfd(FAR struct epoll_item_s *item, int fd)
+{
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct file *filep;
+      int ret;
+
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      item->pfd.ptr    = filep;
+      item->pfd.events = POLLFILE;
+    }
+#ifdef CONFIG_NET
+  else if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS +
+                               CONFIG_NSOCKET_DESCRIPTORS))
+    {
+      FAR struct socket *psock = sockfd_socket(fd);
+
+      if (psock == NULL || psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      item->pfd.ptr    = psock;
+      item->pfd.events = POLLSOCK;
+    }
+#endif
+  else
+    {
+      return -EBADF;
+    }
+
+  item->fd           = fd;
+  item->pfd.fd       = fd;
+  item->pfd.sem      = &item->eph->waitsem;
+  item->pfd.cb       = epoll_callback;
+  item->pfd.arg      = item;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_item_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd,
+                                           FAR struct epoll_item_s **prev)
+{
+  FAR struct epoll_item_s *item;
+
+  for (*prev = NULL, item = eph->items;
+       item != NULL;
+       *prev = item, item = item->flink)
+    {
+      if (item->fd == fd)
+        {
+          return item;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_file_open
+ *
+ * Description:
+ *   Called when the epoll file descriptor is duplicated.
+ *
+ ****************************************************************************/
+
+static int epoll_file_open(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  eph->crefs++;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_file_close
+ *
+ * Description:
+ *   Called when an epoll file descriptor is closed.  When the last one is
+ *   closed, remove all registrations and free the instance.  The inode is
+ *   freed when it is released.
+ *
+ ****************************************************************************/
+
+static int epoll_file_close(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  FAR struct epoll_item_s *item;
+  irqstate_t flags;
+  bool last;
+
+  flags = enter_critical_section();
+  last  = (--eph->crefs <= 0);
+  leave_critical_section(flags);
+
+  if (last)
+    {
+      while ((item = eph->items) != NULL)
+        {
+          eph->items = item->flink;
+          epoll_disarm(item);
+          kmm_free(item);
+        }
+
+      nxsem_destroy(&eph->waitsem);
+      nxsem_destroy(&eph->lock);
+      kmm_free(eph);
+    }
+
+  return OK;
+}
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: epoll_create
+ * Name: epoll_create1
  *
  * Description:
+ *   Create an epoll instance and return a file descriptor that refers to
+ *   it.
  *
  * Input Parameters:
+ *   flags - Zero or EPOLL_CLOEXEC
  *
  * Returned Value:
+ *   A non-negative file descriptor is returned on success.  On failure, -1
+ *   is returned and errno is set appropriately:
+ *
+ *   EINVAL - Invalid flags
+ *   EMFILE - No free file descriptor
+ *   ENOMEM - Out of memory
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+int epoll_create1(int flags)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if ((flags & ~EPOLL_CLOEXEC) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  /* The inode is not part of the pseudo file system.  It is marked deleted
+   * so that it is freed when the last file descriptor releases it.
    */
 
-  return (int)((intptr_t)eph);
+  inode = (FAR struct inode *)kmm_zalloc(sizeof(struct inode));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
+
+  inode->i_crefs   = 1;
+  inode->i_flags   = FSNODEFLAG_TYPE_DRIVER | FSNODEFLAG_DELETED;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&eph->lock, 0, 1);
+  nxsem_init(&eph->waitsem, 0, 0);
+  nxsem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+  eph->crefs = 1;
+
+  fd = files_allocate(inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_inode;
+    }
+
+  finfo("epfd=%d\n", fd);
+  return fd;
+
+errout_with_inode:
+  nxsem_destroy(&eph->waitsem);
+  nxsem_destroy(&eph->lock);
+  kmm_free(inode);
+
+errout_with_eph:
+  kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
 }
 
 /****************************************************************************
- * Name: epoll_close
+ * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance.  The size is only a hint and must be
+ *   positive.
  *
  * Input Parameters:
+ *   size - Ignored, except that it must be greater than zero
  *
  * Returned Value:
+ *   See epoll_create1()
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+int epoll_create(int size)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  return epoll_create1(0);
+}
 
-  kmm_free(eph->evs);
-  kmm_free(eph);
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Close the epoll instance.  Retained for compatibility; close() may be
+ *   used instead.
+ *
+ * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  (void)close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a descriptor in the interest list of the epoll
+ *   instance.  A descriptor stays registered with its driver until it is
+ *   removed, so it must be removed with EPOLL_CTL_DEL before it is closed.
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The events to monitor and the data to return.  EPOLLET selects
+ *          edge-triggered and EPOLLONESHOT one-shot notification.  Ignored
+ *          for EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, -1 is returned and errno
+ *   is set appropriately:
+ *
+ *   EBADF  - epfd or fd is not a valid descriptor
+ *   EEXIST - fd is already registered (EPOLL_CTL_ADD)
+ *   EINVAL - epfd is not an epoll descriptor or op is invalid
+ *   ENOENT - fd is not registered (EPOLL_CTL_MOD, EPOLL_CTL_DEL)
+ *   ENOMEM - Out of memory
+ *   ENOSYS - The driver does not support poll
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_item_s *item;
+  FAR struct epoll_item_s *prev;
+  int ret;
+
+  ret = epoll_gethead(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      ret = -EFAULT;
+      goto errout;
+    }
+
+  ret = nxsem_wait_uninterruptible(&eph->lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  item = epoll_find(eph, fd, &prev);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
+        finfo("epfd=%d ADD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (item != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        item = (FAR struct epoll_item_s *)
+          kmm_zalloc(sizeof(struct epoll_item_s));
+        if (item == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        item->eph = eph;
+        item->ev  = *ev;
+
+        ret = epoll_setfd(item, fd);
+        if (ret >= 0)
+          {
+            ret = epoll_arm(item);
+          }
+
+        if (ret < 0)
+          {
+            epoll_disarm(item);
+            kmm_free(item);
+            break;
+          }
+
+        item->flink = eph->items;
+        eph->items  = item;
+        break;
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
-
-      case EPOLL_CTL_DEL:
-        {
-          int i;
+      case EPOLL_CTL_MOD:
+        finfo("epfd=%d MOD: fd=%d ev=%08x\n", epfd, fd, ev->events);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (item == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          return -ENOENT;
-        }
+        epoll_disarm(item);
+        item->ev       = *ev;
+        item->disabled = false;
 
-      case EPOLL_CTL_MOD:
-        {
-          int i;
+        ret = epoll_arm(item);
+        break;
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+      case EPOLL_CTL_DEL:
+        finfo("epfd=%d DEL: fd=%d\n", epfd, fd);
+
+        if (item == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        epoll_disarm(item);
+
+        if (prev == NULL)
+          {
+            eph->items = item->flink;
+          }
+        else
+          {
+            prev->flink = item->flink;
+          }
+
+        kmm_free(item);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+  nxsem_post(&eph->lock);
 
-          return -ENOENT;
-        }
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the descriptors registered with the epoll instance.
+ *   Events are taken from a ready list that the drivers fill through
+ *   poll_notify(), so the work done grows with the number of ready events
+ *   rather than with the number of registered descriptors.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The buffer that receives the events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The time to wait in milliseconds.  A negative value waits
+ *               forever, zero does not wait.
  *
  * Returned Value:
+ *   The number of events returned, zero on a timeout.  On failure, -1 is
+ *   returned and errno is set appropriately:
+ *
+ *   EBADF  - epfd is not a valid descriptor
+ *   EINTR  - A signal occurred before any event
+ *   EINVAL - epfd is not an epoll descriptor or maxevents is not positive
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  irqstate_t flags;
+  clock_t start = 0;
+  uint32_t ticks = 0;
+  int nevents = 0;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  (void)enter_cancellation_point();
 
-  if (rc <= 0)
+  if (evs == NULL || maxevents <= 0)
     {
-      if (rc < 0)
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = epoll_gethead(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (timeout > 0)
+    {
+      /* Round timeout up to next full tick, as does poll() */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+      start = clock_systimer();
+    }
+
+  ret = nxsem_wait_uninterruptible(&eph->lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  for (; ; )
+    {
+      epoll_rearm(eph);
+
+      nevents = epoll_harvest(eph, evs, maxevents);
+      if (nevents > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Wait for an item to become ready.  The lock is released while
+       * waiting so that other threads may use epoll_ctl().  The check and
+       * the wait are atomic within the critical section.
+       */
+
+      flags = enter_critical_section();
+      if (dq_peek(&eph->rdlist) == NULL)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          nxsem_post(&eph->lock);
 
-          for (i = 0; i < eph->occupied; i++)
+          if (timeout > 0)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              ret = nxsem_tickwait(&eph->waitsem, start, ticks);
+            }
+          else
+            {
+              ret = nxsem_wait(&eph->waitsem);
             }
-        }
 
-      return rc;
-    }
+          leave_critical_section(flags);
+          (void)nxsem_wait_uninterruptible(&eph->lock);
 
-  /* Iterate over non NULL event fds */
+          if (ret == -ETIMEDOUT)
+            {
+              /* Take any events that arrived with the timeout, then give
+               * up.
+               */
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
-    {
-      if (eph->evs[counter].revents != 0)
+              ret     = OK;
+              timeout = 0;
+            }
+          else if (ret < 0)
+            {
+              break;
+            }
+          else
+            {
+              epoll_scan(eph);
+            }
+        }
+      else
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          leave_critical_section(flags);
         }
     }
 
-  return i;
-}
+  nxsem_post(&eph->lock);
 
+errout:
+  leave_cancellation_point();
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return nevents;
+}
@@ -48,6 +48,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
 #include "inode/inode.h"
@@ -213,6 +214,23 @@ int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
         ret = -ENOSYS; /* Not implemented */
         break;
 
+#ifdef CONFIG_PIPES
+      case F_SETPIPE_SZ:
+        /* Change the capacity of the pipe referred to by fd to at least
+         * the third argument, arg, taken as type int.  The buffered data
+         * must fit into the new capacity.  The new capacity is returned.
+         */
+
+        ret = file_ioctl(filep, PIPEIOC_SETSIZE, va_arg(ap, int));
+        break;
+
+      case F_GETPIPE_SZ:
+        /* Return the capacity of the pipe referred to by fd */
+
+        ret = file_ioctl(filep, PIPEIOC_GETSIZE, 0);
+        break;
+#endif
+
       default:
         break;
     }
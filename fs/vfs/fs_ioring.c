@@ -0,0 +1,341 @@
+/****************************************************************************
+ * fs/vfs/fs_ioring.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioring.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_IORING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_rw
+ *
+ * Description:
+ *   Perform a read or write operation.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_rw(FAR struct ioring_sqe_s *sqe, bool write)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  if (sqe->offset < 0)
+    {
+      /* At the file position, or on a socket */
+
+      return write ? nx_write(sqe->fd, sqe->addr, sqe->len) :
+                     nx_read(sqe->fd, sqe->addr, sqe->len);
+    }
+
+  ret = fs_getfilep(sqe->fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return write ? file_pwrite(filep, sqe->addr, sqe->len, sqe->offset) :
+                 file_pread(filep, sqe->addr, sqe->len, sqe->offset);
+}
+
+/****************************************************************************
+ * Name: ioring_msg
+ *
+ * Description:
+ *   Perform a sendmsg or recvmsg operation.  Like sendmsg() and recvmsg(),
+ *   only a single I/O vector is supported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET
+static ssize_t ioring_msg(FAR struct ioring_sqe_s *sqe, bool send)
+{
+  FAR struct msghdr *msg = (FAR struct msghdr *)sqe->addr;
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  if (msg == NULL || msg->msg_iov == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+  psock = sockfd_socket(sqe->fd);
+  if (psock == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (send)
+    {
+      ret = psock_sendto(psock, msg->msg_iov->iov_base,
+                         msg->msg_iov->iov_len, sqe->rwflags,
+                         msg->msg_name, msg->msg_namelen);
+    }
+  else
+    {
+      socklen_t namelen = msg->msg_namelen;
+
+      ret = psock_recvfrom(psock, msg->msg_iov->iov_base,
+                           msg->msg_iov->iov_len, sqe->rwflags,
+                           msg->msg_name,
+                           msg->msg_name != NULL ? &namelen : NULL);
+      if (ret >= 0)
+        {
+          msg->msg_namelen = msg->msg_name != NULL ? namelen : 0;
+        }
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: ioring_poll
+ *
+ * Description:
+ *   Return the pending events of a descriptor without waiting.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_poll(FAR struct ioring_sqe_s *sqe)
+{
+  struct pollfd fds;
+  int ret;
+
+  fds.fd      = sqe->fd;
+  fds.events  = (pollevent_t)sqe->rwflags;
+  fds.revents = 0;
+
+  ret = poll(&fds, 1, 0);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  return fds.revents;
+}
+
+/****************************************************************************
+ * Name: ioring_perform
+ *
+ * Description:
+ *   Perform one operation and return its result.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_perform(FAR struct ioring_sqe_s *sqe)
+{
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return OK;
+
+      case IORING_OP_READ:
+        return ioring_rw(sqe, false);
+
+      case IORING_OP_WRITE:
+        return ioring_rw(sqe, true);
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      case IORING_OP_FSYNC:
+        {
+          FAR struct file *filep;
+          int ret;
+
+          ret = fs_getfilep(sqe->fd, &filep);
+          if (ret >= 0)
+            {
+              ret = file_fsync(filep);
+            }
+
+          return ret;
+        }
+#endif
+
+      case IORING_OP_POLL:
+        return ioring_poll(sqe);
+
+#ifdef CONFIG_NET
+      case IORING_OP_SENDMSG:
+        return ioring_msg(sqe, true);
+
+      case IORING_OP_RECVMSG:
+        return ioring_msg(sqe, false);
+#endif
+
+      default:
+        return -ENOSYS;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Perform up to 'to_submit' operations from the submission ring and add
+ *   their results to the completion ring, all in one system call.
+ *   Submission stops early when the completion ring is full.  The
+ *   operations are performed in order, each as if by the corresponding
+ *   system call.
+ *
+ * Input Parameters:
+ *   ring      - The submission and completion rings
+ *   to_submit - The maximum number of operations to perform
+ *
+ * Returned Value:
+ *   The number of operations consumed from the submission ring.  On error,
+ *   -1 is returned and errno is set:
+ *
+ *   EINVAL - The ring is not valid
+ *   EBUSY  - The completion ring is full
+ *
+ ****************************************************************************/
+
+int ioring_enter(FAR struct ioring_s *ring, unsigned int to_submit)
+{
+  FAR struct ioring_sqe_s *sqe;
+  FAR struct ioring_cqe_s *cqe;
+  uint32_t sqhead;
+  uint32_t cqtail;
+  bool cancel = false;
+  ssize_t res;
+  int count = 0;
+  int errcode;
+
+  /* ioring_enter() is a cancellation point like read() and write() */
+
+  (void)enter_cancellation_point();
+
+  if (ring == NULL || ring->sqes == NULL || ring->cqes == NULL ||
+      ring->sq_entries == 0 || ring->cq_entries == 0 ||
+      (ring->sq_entries & (ring->sq_entries - 1)) != 0 ||
+      (ring->cq_entries & (ring->cq_entries - 1)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  /* Work on local copies of the indexes owned by the kernel */
+
+  sqhead = ring->sq_head;
+  cqtail = ring->cq_tail;
+
+  while ((unsigned int)count < to_submit && sqhead != ring->sq_tail)
+    {
+      if (cqtail - ring->cq_head >= ring->cq_entries)
+        {
+          /* The completion ring is full */
+
+          break;
+        }
+
+      sqe = &ring->sqes[sqhead & (ring->sq_entries - 1)];
+      cqe = &ring->cqes[cqtail & (ring->cq_entries - 1)];
+
+      if (cancel)
+        {
+          res = -ECANCELED;
+        }
+      else
+        {
+          res = ioring_perform(sqe);
+        }
+
+      /* A failure cancels the rest of a linked chain */
+
+      if ((sqe->flags & IORING_SQE_LINK) == 0)
+        {
+          cancel = false;
+        }
+      else if (res < 0)
+        {
+          cancel = true;
+        }
+
+      cqe->user_data = sqe->user_data;
+      cqe->res       = res;
+
+      /* Publish the completion and release the submission entry */
+
+      ring->cq_tail = ++cqtail;
+      ring->sq_head = ++sqhead;
+      count++;
+    }
+
+  if (count == 0 && to_submit > 0 && sqhead != ring->sq_tail)
+    {
+      errcode = EBUSY;
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return count;
+
+errout:
+  leave_cancellation_point();
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_IORING */
@@ -1,7 +1,8 @@
 /****************************************************************************
  * fs/vfs/fs_poll.c
  *
- *   Copyright (C) 2008-2009, 2012-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2008-2009, 2012-2019, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -151,6 +152,8 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds,
       fds[i].sem     = sem;
       fds[i].revents = 0;
       fds[i].priv    = NULL;
+      fds[i].cb      = NULL;
+      fds[i].arg     = NULL;
 
       /* Check for invalid descriptors. "If the value of fd is less than 0,
        * events shall be ignored, and revents shall be set to 0 in that entry
@@ -360,7 +363,7 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
               fds->revents |= (fds->events & (POLLIN | POLLOUT));
               if (fds->revents != 0)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
             }
 
@@ -371,6 +374,40 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   return ret;
 }
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report the events already accumulated in fds->revents to the waiter.
+ *   Drivers call this in place of posting fds->sem.  If the waiter installed
+ *   a callback (as epoll does), then the callback is invoked; otherwise the
+ *   semaphore is posted.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with the events to report
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  DEBUGASSERT(fds != NULL);
+
+  if (fds->cb != NULL)
+    {
+      fds->cb(fds);
+    }
+  else
+    {
+      poll_semgive(fds->sem);
+    }
+}
+
 /****************************************************************************
  * Name: fdesc_poll
  *
@@ -454,6 +491,23 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   (void)enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Re-use the driver registrations of earlier calls if possible */
+
+  ret = poll_cache(fds, nfds, timeout);
+  if (ret != -ENOMEM)
+    {
+      leave_cancellation_point();
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      return ret;
+    }
+#endif
+
   /* This semaphore is used for signaling and, hence, should not have
    * priority inheritance enabled.
    */
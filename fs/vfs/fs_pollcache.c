@@ -0,0 +1,863 @@
+/****************************************************************************
+ * fs/vfs/fs_pollcache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <time.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_POLL_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One driver registration kept between poll() calls.  pfd.ptr is the
+ * struct file or struct socket, NULL if the entry is free, and the POLLMASK
+ * bits of pfd.events tell which one it is.
+ */
+
+struct pollcache_entry_s
+{
+  struct pollfd pfd;               /* The registration seen by the driver */
+  uint32_t stamp;                  /* The call that last used the entry */
+  bool armed;                      /* The driver holds the registration */
+  bool active;                     /* Used by the current poll() call */
+  bool rearm;                      /* Events were reported, set up again */
+  bool closed;                     /* Closed while active */
+};
+
+/* The poll cache of one thread */
+
+struct pollcache_s
+{
+  FAR struct pollcache_s *flink;   /* Supports a singly linked list */
+  sem_t exclsem;                   /* Held by poll() except while waiting */
+  sem_t waitsem;                   /* Posted when an active entry has events */
+  uint32_t stamp;                  /* Incremented by each poll() call */
+  struct pollcache_entry_s entry[CONFIG_FS_POLL_CACHE_SIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of all poll caches, searched when a file or socket is closed */
+
+static FAR struct pollcache_s *g_pollcaches;
+
+/* Protects the list.  Taken before the exclsem of any cache. */
+
+static sem_t g_pollcache_lock = SEM_INITIALIZER(1);
+
+/* The number of armed entries in all caches.  There is nothing to search
+ * on close() while this is zero.
+ */
+
+static volatile unsigned int g_pollcache_narmed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pollcache_callback
+ *
+ * Description:
+ *   Called by the driver through poll_notify().  Inactive entries only
+ *   accumulate their events in revents.
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void pollcache_callback(FAR struct pollfd *fds)
+{
+  FAR struct pollcache_entry_s *entry =
+    (FAR struct pollcache_entry_s *)fds->arg;
+
+  if (entry->active)
+    {
+      nxsem_post(fds->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pollcache_setup
+ *
+ * Description:
+ *   Setup or teardown the poll of the struct file or struct socket 'ptr'.
+ *   'type' is POLLFILE or POLLSOCK.
+ *
+ ****************************************************************************/
+
+static int pollcache_setup(int type, FAR void *ptr, FAR struct pollfd *fds,
+                           bool setup)
+{
+  switch (type)
+    {
+    case POLLFILE:
+      return file_poll((FAR struct file *)ptr, fds, setup);
+
+#ifdef CONFIG_NET
+    case POLLSOCK:
+      return psock_poll((FAR struct socket *)ptr, fds, setup);
+#endif
+
+    default:
+      return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: pollcache_resolve
+ *
+ * Description:
+ *   Return the struct file or struct socket polled by 'fds' and its type.
+ *   NULL is returned if the entry is to be ignored.
+ *
+ ****************************************************************************/
+
+static int pollcache_resolve(FAR struct pollfd *fds, FAR void **ptr,
+                             FAR int *type)
+{
+  FAR struct file *filep;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+#endif
+  int ret;
+
+  *ptr = NULL;
+
+  switch (fds->events & POLLMASK)
+    {
+    case POLLFD:
+      if (fds->fd < 0)
+        {
+          return OK;
+        }
+
+      if ((unsigned int)fds->fd < CONFIG_NFILE_DESCRIPTORS)
+        {
+          ret = fs_getfilep(fds->fd, &filep);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          if (filep->f_inode == NULL)
+            {
+              return -EBADF;
+            }
+
+          *ptr  = filep;
+          *type = POLLFILE;
+          return OK;
+        }
+
+#ifdef CONFIG_NET
+      psock = sockfd_socket(fds->fd);
+      if (psock == NULL || psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      *ptr  = psock;
+      *type = POLLSOCK;
+      return OK;
+#else
+      return -EBADF;
+#endif
+
+    case POLLFILE:
+#ifdef CONFIG_NET
+    case POLLSOCK:
+#endif
+      *ptr  = fds->ptr;
+      *type = fds->events & POLLMASK;
+      return OK;
+
+    default:
+      return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: pollcache_arm
+ *
+ * Description:
+ *   Register the entry with the driver for the events of 'fds'.
+ *
+ ****************************************************************************/
+
+static int pollcache_arm(FAR struct pollcache_entry_s *entry,
+                         FAR struct pollfd *fds)
+{
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(!entry->armed);
+
+  entry->pfd.events  = (entry->pfd.events & POLLMASK) |
+                       (fds->events & ~POLLMASK);
+  entry->pfd.revents = 0;
+  entry->pfd.priv    = NULL;
+  entry->rearm       = false;
+
+  ret = pollcache_setup(entry->pfd.events & POLLMASK, entry->pfd.ptr,
+                        &entry->pfd, true);
+  if (ret >= 0)
+    {
+      flags        = enter_critical_section();
+      entry->armed = true;
+      g_pollcache_narmed++;
+      leave_critical_section(flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pollcache_disarm
+ *
+ * Description:
+ *   Remove the registration of the entry from the driver.
+ *
+ ****************************************************************************/
+
+static void pollcache_disarm(FAR struct pollcache_entry_s *entry)
+{
+  irqstate_t flags;
+
+  if (entry->armed)
+    {
+      (void)pollcache_setup(entry->pfd.events & POLLMASK, entry->pfd.ptr,
+                            &entry->pfd, false);
+
+      flags        = enter_critical_section();
+      entry->armed = false;
+      g_pollcache_narmed--;
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: pollcache_free
+ ****************************************************************************/
+
+static void pollcache_free(FAR struct pollcache_entry_s *entry)
+{
+  pollcache_disarm(entry);
+  entry->pfd.ptr = NULL;
+  entry->active  = false;
+  entry->closed  = false;
+}
+
+/****************************************************************************
+ * Name: pollcache_find
+ *
+ * Description:
+ *   Find the entry of the struct file or struct socket 'ptr'.  The entry
+ *   used with 'fds' by the previous call is checked first.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_entry_s *
+pollcache_find(FAR struct pollcache_s *cache, FAR struct pollfd *fds,
+               FAR void *ptr, int type)
+{
+  FAR struct pollcache_entry_s *entry;
+  uintptr_t offset;
+  int i;
+
+  offset = (uintptr_t)fds->arg - (uintptr_t)cache->entry;
+  if (offset < sizeof(cache->entry) &&
+      offset % sizeof(struct pollcache_entry_s) == 0)
+    {
+      entry = (FAR struct pollcache_entry_s *)fds->arg;
+      if (entry->pfd.ptr == ptr && (entry->pfd.events & POLLMASK) == type)
+        {
+          return entry;
+        }
+    }
+
+  for (i = 0; i < CONFIG_FS_POLL_CACHE_SIZE; i++)
+    {
+      entry = &cache->entry[i];
+      if (entry->pfd.ptr == ptr && (entry->pfd.events & POLLMASK) == type)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pollcache_alloc
+ *
+ * Description:
+ *   Return a free entry or, if there is none, evict the least recently
+ *   used entry that is not used by the current call.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_entry_s *
+pollcache_alloc(FAR struct pollcache_s *cache, FAR void *ptr, int type)
+{
+  FAR struct pollcache_entry_s *entry = NULL;
+  FAR struct pollcache_entry_s *victim = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_POLL_CACHE_SIZE; i++)
+    {
+      if (cache->entry[i].pfd.ptr == NULL)
+        {
+          entry = &cache->entry[i];
+          break;
+        }
+
+      if (!cache->entry[i].active &&
+          (victim == NULL ||
+           cache->stamp - cache->entry[i].stamp >
+           cache->stamp - victim->stamp))
+        {
+          victim = &cache->entry[i];
+        }
+    }
+
+  if (entry == NULL)
+    {
+      if (victim == NULL)
+        {
+          return NULL;
+        }
+
+      pollcache_free(victim);
+      entry = victim;
+    }
+
+  entry->pfd.fd     = -1;
+  entry->pfd.events = type;
+  entry->pfd.ptr    = ptr;
+  entry->pfd.sem    = &cache->waitsem;
+  entry->pfd.cb     = pollcache_callback;
+  entry->pfd.arg    = entry;
+  return entry;
+}
+
+/****************************************************************************
+ * Name: pollcache_add
+ *
+ * Description:
+ *   Add 'fds' to the current call.  A cached registration is re-used if it
+ *   is still valid; it is set up again if the events changed or if events
+ *   were reported since it was set up, so that level-triggered conditions
+ *   are seen again.  If the cache is full, 'fds' itself is registered for
+ *   this call only.
+ *
+ *   On return, fds->arg is the entry if the cache is used and fds->sem is
+ *   non-NULL if 'fds' itself is registered.
+ *
+ ****************************************************************************/
+
+static int pollcache_add(FAR struct pollcache_s *cache,
+                         FAR struct pollfd *fds)
+{
+  FAR struct pollcache_entry_s *entry;
+  FAR void *ptr;
+  int type;
+  int ret;
+
+  fds->revents = 0;
+  fds->sem     = NULL;
+
+  ret = pollcache_resolve(fds, &ptr, &type);
+  if (ret < 0 || ptr == NULL)
+    {
+      fds->arg = NULL;
+      return ret;
+    }
+
+  entry = pollcache_find(cache, fds, ptr, type);
+  if (entry == NULL)
+    {
+      entry = pollcache_alloc(cache, ptr, type);
+    }
+  else if (entry->active)
+    {
+      /* The same file appears twice in the list */
+
+      entry = NULL;
+    }
+
+  if (entry == NULL)
+    {
+      /* Register 'fds' itself as the normal poll() does.  For POLLFD, save
+       * the resolved pointer for the teardown.
+       */
+
+      fds->arg  = NULL;
+      fds->ptr  = ptr;
+      fds->priv = NULL;
+      fds->cb   = NULL;
+      fds->sem  = &cache->waitsem;
+
+      ret = pollcache_setup(type, ptr, fds, true);
+      if (ret < 0)
+        {
+          fds->sem = NULL;
+        }
+
+      return ret;
+    }
+
+  entry->active = true;
+  entry->stamp  = cache->stamp;
+  fds->arg      = entry;
+
+  if (entry->armed &&
+      (entry->rearm || entry->pfd.revents != 0 ||
+       (entry->pfd.events & ~POLLMASK) != (fds->events & ~POLLMASK)))
+    {
+      pollcache_disarm(entry);
+    }
+
+  if (!entry->armed)
+    {
+      ret = pollcache_arm(entry, fds);
+      if (ret < 0)
+        {
+          pollcache_free(entry);
+          fds->arg = NULL;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pollcache_remove
+ *
+ * Description:
+ *   Remove 'fds' from the current call and return its events in revents.
+ *   Cached registrations stay with the driver.
+ *
+ ****************************************************************************/
+
+static int pollcache_remove(FAR struct pollfd *fds)
+{
+  FAR struct pollcache_entry_s *entry;
+  int type;
+  int ret = OK;
+
+  entry = (FAR struct pollcache_entry_s *)fds->arg;
+  if (entry != NULL)
+    {
+      fds->revents  = entry->pfd.revents;
+      entry->active = false;
+
+      if (entry->closed)
+        {
+          fds->revents = POLLNVAL;
+          pollcache_free(entry);
+        }
+      else if (fds->revents != 0)
+        {
+          entry->rearm = true;
+        }
+    }
+  else if (fds->sem != NULL)
+    {
+      type = fds->events & POLLMASK;
+      if (type == POLLFD)
+        {
+          type = (unsigned int)fds->fd < CONFIG_NFILE_DESCRIPTORS ?
+                 POLLFILE : POLLSOCK;
+        }
+
+      ret = pollcache_setup(type, fds->ptr, fds, false);
+      fds->sem = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pollcache_ready
+ *
+ * Description:
+ *   Return the number of entries of the current call with events.
+ *
+ ****************************************************************************/
+
+static int pollcache_ready(FAR struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct pollcache_entry_s *entry;
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < nfds; i++)
+    {
+      entry = (FAR struct pollcache_entry_s *)fds[i].arg;
+      if (entry != NULL ? (entry->closed || entry->pfd.revents != 0) :
+          fds[i].revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: pollcache_get
+ *
+ * Description:
+ *   Return the poll cache of the current thread, allocating it by the
+ *   first call.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_s *pollcache_get(void)
+{
+  FAR struct tcb_s *rtcb = sched_self();
+  FAR struct pollcache_s *cache = rtcb->pollcache;
+
+  if (cache == NULL)
+    {
+      cache = (FAR struct pollcache_s *)
+        kmm_zalloc(sizeof(struct pollcache_s));
+      if (cache == NULL)
+        {
+          return NULL;
+        }
+
+      /* The wait semaphore is used for signaling and must not have
+       * priority inheritance enabled.
+       */
+
+      nxsem_init(&cache->exclsem, 0, 1);
+      nxsem_init(&cache->waitsem, 0, 0);
+      nxsem_setprotocol(&cache->waitsem, SEM_PRIO_NONE);
+
+      nxsem_wait_uninterruptible(&g_pollcache_lock);
+      cache->flink  = g_pollcaches;
+      g_pollcaches  = cache;
+      rtcb->pollcache = cache;
+      nxsem_post(&g_pollcache_lock);
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   The poll() operation using the poll cache of the current thread.  The
+ *   driver registrations of the descriptors are kept between calls, so a
+ *   call with an unchanged descriptor list and no events performs no setup
+ *   or teardown.
+ *
+ * Input Parameters:
+ *   fds     - List of structures describing file descriptors to be
+ *             monitored
+ *   nfds    - The number of entries in the list
+ *   timeout - The timeout in milliseconds or a negative value to wait
+ *             forever
+ *
+ * Returned Value:
+ *   The number of structures that have non-zero revents fields on success.
+ *   A negated errno value is returned on failure; -ENOMEM if the cache
+ *   could not be allocated, in which case the caller should use the normal
+ *   poll operation.
+ *
+ ****************************************************************************/
+
+int poll_cache(FAR struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  FAR struct pollcache_s *cache;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  nfds_t nsetup;
+  nfds_t i;
+  int count = 0;
+  int status;
+  int ret;
+
+  cache = pollcache_get();
+  if (cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxsem_wait(&cache->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Discard the wake-ups left over from earlier calls */
+
+  while (nxsem_trywait(&cache->waitsem) == OK)
+    {
+    }
+
+  cache->stamp++;
+
+  for (nsetup = 0; nsetup < nfds; nsetup++)
+    {
+      ret = pollcache_add(cache, &fds[nsetup]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      count = pollcache_ready(fds, nfds);
+      if (count == 0 && timeout > 0)
+        {
+          /* Round the timeout up to the next full tick as poll() does */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+          ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+                   (USEC_PER_TICK - 1)) /
+                  USEC_PER_TICK;
+#else
+          ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+                  MSEC_PER_TICK;
+#endif
+          start = clock_systimer();
+        }
+
+      /* Wait with the cache unlocked so that close() can tear down
+       * entries.  Wake-ups by inactive entries were discarded above, but
+       * an entry may report events that are masked out, so wait again
+       * until there really is something to report.
+       */
+
+      while (count == 0 && timeout != 0 && ret >= 0)
+        {
+          nxsem_post(&cache->exclsem);
+
+          if (timeout > 0)
+            {
+              ret = nxsem_tickwait(&cache->waitsem, start, ticks);
+            }
+          else
+            {
+              ret = nxsem_wait(&cache->waitsem);
+            }
+
+          nxsem_wait_uninterruptible(&cache->exclsem);
+          count = pollcache_ready(fds, nfds);
+        }
+
+      if (ret == -ETIMEDOUT || count > 0)
+        {
+          ret = OK;
+        }
+    }
+  else
+    {
+      fds[nsetup].revents |= POLLERR;
+    }
+
+  /* Remove the descriptors from the call and count the events */
+
+  count = 0;
+  for (i = 0; i < nsetup; i++)
+    {
+      status = pollcache_remove(&fds[i]);
+      if (status < 0 && ret >= 0)
+        {
+          ret = status;
+        }
+
+      if (fds[i].revents != 0)
+        {
+          count++;
+        }
+    }
+
+  nxsem_post(&cache->exclsem);
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Tear down the cached poll registrations of the struct file or struct
+ *   socket 'ptr' that is being closed.  A poll() call waiting on it returns
+ *   POLLNVAL for it.
+ *
+ * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_cache_close(FAR void *ptr)
+{
+  FAR struct pollcache_entry_s *entry;
+  FAR struct pollcache_s *cache;
+  int i;
+
+  if (g_pollcache_narmed == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_pollcache_lock);
+  for (cache = g_pollcaches; cache != NULL; cache = cache->flink)
+    {
+      nxsem_wait_uninterruptible(&cache->exclsem);
+      for (i = 0; i < CONFIG_FS_POLL_CACHE_SIZE; i++)
+        {
+          entry = &cache->entry[i];
+          if (entry->pfd.ptr != ptr || entry->closed)
+            {
+              continue;
+            }
+
+          if (entry->active)
+            {
+              pollcache_disarm(entry);
+              entry->closed = true;
+              nxsem_post(&cache->waitsem);
+            }
+          else
+            {
+              pollcache_free(entry);
+            }
+        }
+
+      nxsem_post(&cache->exclsem);
+    }
+
+  nxsem_post(&g_pollcache_lock);
+}
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Tear down the poll registrations of an exiting thread and free its
+ *   poll cache.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_cache_release(FAR struct tcb_s *tcb)
+{
+  FAR struct pollcache_s *cache = tcb->pollcache;
+  FAR struct pollcache_s *curr;
+  FAR struct pollcache_s *prev;
+  int i;
+
+  if (cache == NULL)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_pollcache_lock);
+
+  for (prev = NULL, curr = g_pollcaches;
+       curr != NULL && curr != cache;
+       prev = curr, curr = curr->flink)
+    {
+    }
+
+  DEBUGASSERT(curr == cache);
+  if (prev == NULL)
+    {
+      g_pollcaches = cache->flink;
+    }
+  else
+    {
+      prev->flink = cache->flink;
+    }
+
+  tcb->pollcache = NULL;
+
+  for (i = 0; i < CONFIG_FS_POLL_CACHE_SIZE; i++)
+    {
+      pollcache_free(&cache->entry[i]);
+    }
+
+  nxsem_post(&g_pollcache_lock);
+
+  nxsem_destroy(&cache->exclsem);
+  nxsem_destroy(&cache->waitsem);
+  kmm_free(cache);
+}
+
+#endif /* CONFIG_FS_POLL_CACHE */
@@ -190,6 +190,13 @@ struct nxbe_plane_s
   /* Framebuffer plane info describing destination video plane */
 
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_UPDATE_DEFER
+  /* Updated regions not yet reported with nx_notify_rectangle() */
+
+  uint8_t ndirty;
+  struct nxgl_rect_s dirty[CONFIG_NX_UPDATE_NRECTS];
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -727,6 +734,79 @@ void nxbe_flush(FAR struct nxbe_window_s *wnd,
                  unsigned int stride);
 #endif
 
+/****************************************************************************
+ * Name: nxbe_notify_rectangle
+ *
+ * Description:
+ *   Report that a region of the display has been updated.  If
+ *   CONFIG_NX_UPDATE_DEFER is enabled, the region is accumulated with the
+ *   other updated regions of the plane until nxbe_notify_flush() is
+ *   called.  Otherwise, nx_notify_rectangle() is called immediately.
+ *
+ * Input Parameters:
+ *   plane - The color plane that was updated
+ *   rect  - The updated region (device coordinate frame)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NX_UPDATE_DEFER)
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
+                           FAR const struct nxgl_rect_s *rect);
+#elif defined(CONFIG_NX_UPDATE)
+#  define nxbe_notify_rectangle(plane,rect) \
+     nx_notify_rectangle(&(plane)->pinfo, rect)
+#endif
+
+/****************************************************************************
+ * Name: nxbe_notify_flush
+ *
+ * Description:
+ *   Report all of the accumulated, updated regions of the display with
+ *   nx_notify_rectangle().
+ *
+ * Input Parameters:
+ *   be - The back-end state structure instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_DEFER
+void nxbe_notify_flush(FAR struct nxbe_state_s *be);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_notify_move
+ *
+ * Description:
+ *   Report that a region of the display has been moved.  This calls
+ *   nx_notify_move() unless the source region has updates that were not
+ *   yet reported.  In that case, the destination is accumulated as an
+ *   updated region instead.
+ *
+ * Input Parameters:
+ *   plane  - The color plane that was updated
+ *   rect   - The source region of the move (device coordinate frame)
+ *   offset - The offset that was applied to the source region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NX_UPDATE_MOVE) && defined(CONFIG_NX_UPDATE_DEFER)
+void nxbe_notify_move(FAR struct nxbe_plane_s *plane,
+                      FAR const struct nxgl_rect_s *rect,
+                      FAR const struct nxgl_point_s *offset);
+#elif defined(CONFIG_NX_UPDATE_MOVE)
+#  define nxbe_notify_move(plane,rect,offset) \
+     nx_notify_move(&(plane)->pinfo, rect, offset)
+#endif
+
 /****************************************************************************
  * Name: nxbe_redraw
  *
@@ -80,8 +80,7 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
 {
   struct nxbe_move_s *info = (struct nxbe_move_s *)cops;
   struct nxgl_point_s offset;
-#ifdef CONFIG_NX_UPDATE
-  FAR struct nxbe_window_s *wnd;
+#if defined(CONFIG_NX_UPDATE) && !defined(CONFIG_NX_UPDATE_MOVE)
   struct nxgl_rect_s update;
 #endif
 
@@ -96,20 +95,23 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
 
       plane->dev.moverectangle(&plane->pinfo, rect, &offset);
 
-#ifdef CONFIG_NX_UPDATE
-      /* Move the source rectangle back to window relative coordinates and
-       * apply the offset.
+#if defined(CONFIG_NX_UPDATE_MOVE)
+      /* Notify any listeners that the source rectangle has been moved */
+
+      nxbe_notify_move(plane, rect, &info->offset);
+
+#elif defined(CONFIG_NX_UPDATE)
+      /* The updated region is the source rectangle at the destination
+       * position (device coordinates).
        */
 
-      wnd = info->wnd;
-      nxgl_rectoffset(&update, rect, offset.x - wnd->bounds.pt1.x,
-                      offset.y - wnd->bounds.pt1.y);
+      nxgl_rectoffset(&update, rect, info->offset.x, info->offset.y);
 
       /* Notify any listeners that the graphic content in the update
        * rectangle has changed.
        */
 
-      nx_notify_rectangle(&plane->pinfo, &update);
+      nxbe_notify_rectangle(plane, &update);
 #endif
     }
 }
@@ -0,0 +1,262 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_notify.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nx.h>
+
+#include "nxbe.h"
+
+#ifdef CONFIG_NX_UPDATE_DEFER
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_area
+ *
+ * Description:
+ *   Return the number of pixels in a rectangle.
+ *
+ ****************************************************************************/
+
+static uint32_t nxbe_area(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: nxbe_mergeable
+ *
+ * Description:
+ *   Return true if the bounding rectangle of two regions has no more pixels
+ *   than the two regions together.  Reporting the bounding rectangle then
+ *   costs no more than reporting both regions.  That is true when one
+ *   region contains the other, when they are adjacent rows or columns of
+ *   the same extent, or when they overlap well enough.
+ *
+ ****************************************************************************/
+
+static bool nxbe_mergeable(FAR const struct nxgl_rect_s *rect1,
+                           FAR const struct nxgl_rect_s *rect2)
+{
+  struct nxgl_rect_s bounds;
+
+  nxgl_rectunion(&bounds, rect1, rect2);
+  return nxbe_area(&bounds) <= nxbe_area(rect1) + nxbe_area(rect2);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_notify_rectangle
+ *
+ * Description:
+ *   Accumulate an updated region of the display until nxbe_notify_flush()
+ *   is called.
+ *
+ * Input Parameters:
+ *   plane - The color plane that was updated
+ *   rect  - The updated region (device coordinate frame)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
+                           FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s update;
+  struct nxgl_rect_s bounds;
+  uint32_t growth;
+  uint32_t best;
+  int bestndx;
+  int i;
+
+  nxgl_rectcopy(&update, rect);
+
+restart:
+
+  /* Absorb the accumulated regions that can be reported together with the
+   * new region.  The new region grows each time, so scan again from the
+   * start after each merge.
+   */
+
+  for (i = 0; i < plane->ndirty; )
+    {
+      if (nxbe_mergeable(&plane->dirty[i], &update))
+        {
+          nxgl_rectunion(&update, &update, &plane->dirty[i]);
+
+          plane->ndirty--;
+          nxgl_rectcopy(&plane->dirty[i], &plane->dirty[plane->ndirty]);
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  /* If all regions are in use, merge the new region with the one that
+   * grows the least.  The result may be mergeable with other regions.
+   */
+
+  if (plane->ndirty >= CONFIG_NX_UPDATE_NRECTS)
+    {
+      best    = UINT32_MAX;
+      bestndx = 0;
+
+      for (i = 0; i < plane->ndirty; i++)
+        {
+          nxgl_rectunion(&bounds, &plane->dirty[i], &update);
+          growth = nxbe_area(&bounds) - nxbe_area(&plane->dirty[i]);
+          if (growth < best)
+            {
+              best    = growth;
+              bestndx = i;
+            }
+        }
+
+      nxgl_rectunion(&update, &update, &plane->dirty[bestndx]);
+
+      plane->ndirty--;
+      nxgl_rectcopy(&plane->dirty[bestndx], &plane->dirty[plane->ndirty]);
+      goto restart;
+    }
+
+  nxgl_rectcopy(&plane->dirty[plane->ndirty], &update);
+  plane->ndirty++;
+}
+
+/****************************************************************************
+ * Name: nxbe_notify_flush
+ *
+ * Description:
+ *   Report all of the accumulated, updated regions of the display with
+ *   nx_notify_rectangle().
+ *
+ * Input Parameters:
+ *   be - The back-end state structure instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_notify_flush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  int i;
+  int j;
+
+#if CONFIG_NX_NPLANES > 1
+  for (i = 0; i < be->vinfo.nplanes; i++)
+#else
+  i = 0;
+#endif
+    {
+      plane = &be->plane[i];
+      for (j = 0; j < plane->ndirty; j++)
+        {
+          nx_notify_rectangle(&plane->pinfo, &plane->dirty[j]);
+        }
+
+      plane->ndirty = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_notify_move
+ *
+ * Description:
+ *   Report that a region of the display has been moved.  This calls
+ *   nx_notify_move() unless the source region has updates that were not
+ *   yet reported.  In that case, the destination is accumulated as an
+ *   updated region instead.
+ *
+ * Input Parameters:
+ *   plane  - The color plane that was updated
+ *   rect   - The source region of the move (device coordinate frame)
+ *   offset - The offset that was applied to the source region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_MOVE
+void nxbe_notify_move(FAR struct nxbe_plane_s *plane,
+                      FAR const struct nxgl_rect_s *rect,
+                      FAR const struct nxgl_point_s *offset)
+{
+  struct nxgl_rect_s src;
+  struct nxgl_rect_s dest;
+  int i;
+
+  /* The receiver of the notification copies the source region as it was
+   * last reported.  That copy is stale if an accumulated region overlaps
+   * the source region.
+   */
+
+  nxgl_rectcopy(&src, rect);
+  for (i = 0; i < plane->ndirty; i++)
+    {
+      if (nxgl_rectoverlap(&plane->dirty[i], &src))
+        {
+          nxgl_rectoffset(&dest, &src, offset->x, offset->y);
+          nxbe_notify_rectangle(plane, &dest);
+          return;
+        }
+    }
+
+  nx_notify_move(&plane->pinfo, rect, offset);
+}
+#endif
+
+#endif /* CONFIG_NX_UPDATE_DEFER */
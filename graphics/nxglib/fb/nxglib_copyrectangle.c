@@ -45,6 +45,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib.h"
 
 /****************************************************************************
  * Public Functions
@@ -118,6 +119,16 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   dline = pinfo->fbmem + dest->pt1.y * deststride +
           NXGL_SCALEX(dest->pt1.x);
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the graphics accelerator copy the image, if it can */
+
+  if (nxgl_accel_copy(dline, deststride, sline, srcstride,
+                      NXGLIB_BITSPERPIXEL, width, rows) >= 0)
+    {
+      return;
+    }
+#endif
+
   while (rows--)
     {
 #if NXGLIB_BITSPERPIXEL < 8
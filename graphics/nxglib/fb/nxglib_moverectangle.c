@@ -45,6 +45,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib.h"
 
 /****************************************************************************
  * Private Functions
@@ -183,6 +184,18 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
       /* Yes.. Copy the rectangle from top down (i.e., adding the stride
        * to move to the next, lower row) */
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+      /* The graphics accelerator copies in the same order, so let it do
+       * the move, if it can.
+       */
+
+      if (nxgl_accel_copy(dline, stride, sline, stride,
+                          NXGLIB_BITSPERPIXEL, width, rows) >= 0)
+        {
+          return;
+        }
+#endif
+
       while (rows--)
         {
           /* Copy the row */
@@ -224,12 +237,14 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
           dline -= stride;
           sline -= stride;
 
-          /* Copy the row */
+          /* Copy the row.  The source and destination rows overlap if
+           * the rectangle moves horizontally.
+           */
 
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
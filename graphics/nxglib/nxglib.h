@@ -64,6 +64,27 @@ extern "C"
  * Public Function Prototypes
  ****************************************************************************/
 
+/* Accelerator **************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_fill / nxgl_accel_copy
+ *
+ * Description:
+ *   Fill or copy a region of framebuffer memory with the accelerator
+ *   registered by nxgl_accel_register().  A negated errno value is
+ *   returned if no accelerator is registered or if it cannot perform the
+ *   operation; the caller must then perform it by software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+int nxgl_accel_fill(FAR void *dest, unsigned int stride, uint8_t bpp,
+                    unsigned int width, unsigned int height, uint32_t color);
+int nxgl_accel_copy(FAR void *dest, unsigned int deststride,
+                    FAR const void *src, unsigned int srcstride, uint8_t bpp,
+                    unsigned int width, unsigned int height);
+#endif
+
 /* Rasterizers **************************************************************/
 
 /****************************************************************************
@@ -0,0 +1,128 @@
+/****************************************************************************
+ * graphics/nxglib/nxglib_accel.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "nxglib.h"
+
+#ifdef CONFIG_NX_ACCEL
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered graphics accelerator or NULL */
+
+static FAR const struct nxgl_accel_s *g_nxgl_accel;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Register the graphics accelerator that nxglib uses to fill, copy and
+ *   move rectangular regions of framebuffer memory.
+ *
+ ****************************************************************************/
+
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel)
+{
+  g_nxgl_accel = accel;
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_fill
+ *
+ * Description:
+ *   Fill a region of framebuffer memory with the registered accelerator.
+ *
+ * Returned Value:
+ *   Zero (OK) if the region was filled; a negated errno value if it must
+ *   be filled by software.
+ *
+ ****************************************************************************/
+
+int nxgl_accel_fill(FAR void *dest, unsigned int stride, uint8_t bpp,
+                    unsigned int width, unsigned int height, uint32_t color)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->fill == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  return accel->fill(dest, stride, bpp, width, height, color);
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_copy
+ *
+ * Description:
+ *   Copy a region into framebuffer memory with the registered accelerator.
+ *
+ * Returned Value:
+ *   Zero (OK) if the region was copied; a negated errno value if it must
+ *   be copied by software.
+ *
+ ****************************************************************************/
+
+int nxgl_accel_copy(FAR void *dest, unsigned int deststride,
+                    FAR const void *src, unsigned int srcstride, uint8_t bpp,
+                    unsigned int width, unsigned int height)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->copy == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  return accel->copy(dest, deststride, src, srcstride, bpp, width, height);
+}
+
+#endif /* CONFIG_NX_ACCEL */
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -144,29 +145,13 @@
 #elif NXGLIB_BITSPERPIXEL == 24
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+     nxgl_memset24(dest, value, width)
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy(dest, src, NXGL_SCALEX(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+     memmove(dest, src, NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -185,8 +170,15 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+#else /* NXGLIB_BITSPERPIXEL == 8, 16 or 32 */
 
+#if NXGLIB_BITSPERPIXEL == 8
+#  define NXGL_MEMSET(dest,value,width) \
+     memset(dest, value, width)
+#elif NXGLIB_BITSPERPIXEL == 16
+#  define NXGL_MEMSET(dest,value,width) \
+     nxgl_memset16(dest, value, width)
+#else
 #  define NXGL_MEMSET(dest,value,width) \
    { \
      FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
@@ -196,17 +188,15 @@
          *_ptr++ = (value); \
        } \
    }
+#endif
+
+/* The C library copies whole words wherever the alignment permits */
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy(dest, src, NXGL_SCALEX(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+     memmove(dest, src, NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -238,6 +228,126 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_memset16
+ *
+ * Description:
+ *   Fill a run of 16-bit pixels, storing two pixels with each word.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+static inline void nxgl_memset16(FAR void *dest, uint16_t value,
+                                 unsigned int npixels)
+{
+  FAR uint16_t *hptr = (FAR uint16_t *)dest;
+  FAR uint32_t *wptr;
+  uint32_t wvalue;
+
+  /* Store one pixel if the destination is not word aligned */
+
+  if (npixels > 0 && ((uintptr_t)hptr & 2) != 0)
+    {
+      *hptr++ = value;
+      npixels--;
+    }
+
+  /* Then two pixels per word */
+
+  wvalue = (uint32_t)value << 16 | value;
+  wptr   = (FAR uint32_t *)hptr;
+
+  for (; npixels >= 8; npixels -= 8)
+    {
+      wptr[0] = wvalue;
+      wptr[1] = wvalue;
+      wptr[2] = wvalue;
+      wptr[3] = wvalue;
+      wptr   += 4;
+    }
+
+  for (; npixels >= 2; npixels -= 2)
+    {
+      *wptr++ = wvalue;
+    }
+
+  /* And the odd, final pixel */
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wptr = value;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxgl_memset24
+ *
+ * Description:
+ *   Fill a run of packed 24-bit pixels, storing four pixels with each
+ *   three words.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 24
+static inline void nxgl_memset24(FAR void *dest, uint32_t value,
+                                 unsigned int npixels)
+{
+  FAR uint8_t *bptr = (FAR uint8_t *)dest;
+  FAR uint32_t *wptr;
+  union
+  {
+    uint8_t  b[12];
+    uint32_t w[3];
+  } pattern;
+  int i;
+
+  /* Store single pixels until the destination is word aligned.  That
+   * takes at most three pixels.
+   */
+
+  while (npixels > 0 && ((uintptr_t)bptr & 3) != 0)
+    {
+      *bptr++ = value;
+      *bptr++ = value >> 8;
+      *bptr++ = value >> 16;
+      npixels--;
+    }
+
+  /* Then four pixels in each three words */
+
+  for (i = 0; i < 12; i += 3)
+    {
+      pattern.b[i]     = value;
+      pattern.b[i + 1] = value >> 8;
+      pattern.b[i + 2] = value >> 16;
+    }
+
+  wptr = (FAR uint32_t *)bptr;
+  for (; npixels >= 4; npixels -= 4)
+    {
+      wptr[0] = pattern.w[0];
+      wptr[1] = pattern.w[1];
+      wptr[2] = pattern.w[2];
+      wptr   += 3;
+    }
+
+  /* And the remaining pixels */
+
+  bptr = (FAR uint8_t *)wptr;
+  while (npixels-- > 0)
+    {
+      *bptr++ = value;
+      *bptr++ = value >> 8;
+      *bptr++ = value >> 16;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -227,12 +227,14 @@ void NXGL_FUNCNAME(pwfb_moverectangle,NXGLIB_SUFFIX)
           dline -= stride;
           sline -= stride;
 
-          /* Copy the row */
+          /* Copy the row.  The source and destination rows overlap if
+           * the rectangle moves horizontally.
+           */
 
 #if NXGLIB_BITSPERPIXEL < 8
           pwfb_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
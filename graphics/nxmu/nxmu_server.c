@@ -255,6 +255,298 @@ static inline int nxmu_setup(FAR const char *mqname, FAR NX_DRIVERTYPE *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmu_dispatch
+ *
+ * Description:
+ *   Dispatch one message received by the server.
+ *
+ ****************************************************************************/
+
+static void nxmu_dispatch(FAR struct nxmu_state_s *nxmu,
+                          FAR struct nxsvrmsg_s *msg)
+{
+  switch (msg->msgid)
+    {
+    /* Messages sent from clients to the NX server *********************/
+
+    case NX_SVRMSG_CONNECT: /* Establish connection with new NX server client */
+      {
+        FAR struct nxsvrmsg_s *connmsg = (FAR struct nxsvrmsg_s *)msg;
+        nxmu_connect(connmsg->conn);
+      }
+      break;
+
+    case NX_SVRMSG_DISCONNECT: /* Tear down connection with terminating client */
+      {
+        FAR struct nxsvrmsg_s *disconnmsg = (FAR struct nxsvrmsg_s *)msg;
+        nxmu_disconnect(disconnmsg->conn);
+      }
+      break;
+
+    case NX_SVRMSG_OPENWINDOW: /* Create a new window */
+      {
+        FAR struct nxsvrmsg_openwindow_s *openmsg = (FAR struct nxsvrmsg_openwindow_s *)msg;
+        nxmu_openwindow(&nxmu->be, openmsg->wnd);
+      }
+      break;
+
+    case NX_SVRMSG_CLOSEWINDOW: /* Close an existing window */
+      {
+        FAR struct nxsvrmsg_closewindow_s *closemsg = (FAR struct nxsvrmsg_closewindow_s *)msg;
+        nxbe_closewindow(closemsg->wnd);
+      }
+      break;
+
+    case NX_SVRMSG_BLOCKED: /* Block messages to a window */
+      {
+        FAR struct nxsvrmsg_blocked_s *blocked = (FAR struct nxsvrmsg_blocked_s *)msg;
+        nxmu_event(blocked->wnd, NXEVENT_BLOCKED, blocked->arg);
+      }
+      break;
+
+    case NX_SVRMSG_SYNCH: /* Synchronization request */
+      {
+        FAR struct nxsvrmsg_synch_s *synch = (FAR struct nxsvrmsg_synch_s *)msg;
+
+#ifdef CONFIG_NX_UPDATE_DEFER
+        /* The client has completed a frame.  Report the updates. */
+
+        nxbe_notify_flush(&nxmu->be);
+#endif
+        nxmu_event(synch->wnd, NXEVENT_SYNCHED, synch->arg);
+      }
+      break;
+
+#if defined(CONFIG_NX_SWCURSOR) || defined(CONFIG_NX_HWCURSOR)
+    case NX_SVRMSG_CURSOR_ENABLE: /* Enable/disable cursor */
+      {
+        FAR struct nxsvrmsg_curenable_s *enabmsg = (FAR struct nxsvrmsg_curenable_s *)msg;
+        nxbe_cursor_enable(&nxmu->be, enabmsg->enable);
+      }
+      break;
+
+#if defined(CONFIG_NX_HWCURSORIMAGE) || defined(CONFIG_NX_SWCURSOR)
+    case NX_SVRMSG_CURSOR_IMAGE: /* Set cursor image */
+      {
+        FAR struct nxsvrmsg_curimage_s *imgmsg = (FAR struct nxsvrmsg_curimage_s *)msg;
+        nxbe_cursor_setimage(&nxmu->be, &imgmsg->image);
+      }
+      break;
+#endif
+    case NX_SVRMSG_CURSOR_SETPOS: /* Set cursor position */
+      {
+        FAR struct nxsvrmsg_curpos_s *posmsg = (FAR struct nxsvrmsg_curpos_s *)msg;
+        nxbe_cursor_setposition(&nxmu->be, &posmsg->pos);
+      }
+      break;
+#endif
+
+    case NX_SVRMSG_REQUESTBKGD: /* Give access to the background window */
+      {
+        FAR struct nxsvrmsg_requestbkgd_s *rqbgmsg = (FAR struct nxsvrmsg_requestbkgd_s *)msg;
+        nxmu_requestbkgd(rqbgmsg->conn, &nxmu->be, rqbgmsg->cb, rqbgmsg->arg);
+      }
+      break;
+
+    case NX_SVRMSG_RELEASEBKGD: /* End access to the background window */
+      {
+        nxmu_releasebkgd(nxmu);
+      }
+      break;
+
+    case NX_SVRMSG_SETPOSITION: /* Change window position */
+      {
+        FAR struct nxsvrmsg_setposition_s *setposmsg = (FAR struct nxsvrmsg_setposition_s *)msg;
+        nxbe_setposition(setposmsg->wnd, &setposmsg->pos);
+      }
+      break;
+
+    case NX_SVRMSG_SETSIZE: /* Change window size */
+      {
+        FAR struct nxsvrmsg_setsize_s *setsizemsg = (FAR struct nxsvrmsg_setsize_s *)msg;
+        nxbe_setsize(setsizemsg->wnd, &setsizemsg->size);
+      }
+      break;
+
+    case NX_SVRMSG_GETPOSITION: /* Get the window size/position */
+      {
+        FAR struct nxsvrmsg_getposition_s *getposmsg = (FAR struct nxsvrmsg_getposition_s *)msg;
+        nxmu_reportposition(getposmsg->wnd);
+      }
+      break;
+
+    case NX_SVRMSG_RAISE: /* Move the window to the top of the display */
+      {
+        FAR struct nxsvrmsg_raise_s *raisemsg = (FAR struct nxsvrmsg_raise_s *)msg;
+        nxbe_raise(raisemsg->wnd);
+      }
+      break;
+
+    case NX_SVRMSG_LOWER: /* Lower the window to the bottom of the display */
+      {
+        FAR struct nxsvrmsg_lower_s *lowermsg = (FAR struct nxsvrmsg_lower_s *)msg;
+        nxbe_lower(lowermsg->wnd);
+      }
+      break;
+
+    case NX_SVRMSG_MODAL: /* Select/De-select window modal state */
+      {
+        FAR struct nxsvrmsg_modal_s *modalmsg = (FAR struct nxsvrmsg_modal_s *)msg;
+        nxbe_modal(modalmsg->wnd, modalmsg->modal);
+      }
+      break;
+
+    case NX_SVRMSG_SETVISIBILITY: /* Show or hide a window */
+      {
+        FAR struct nxsvrmsg_setvisibility_s *vismsg =
+          (FAR struct nxsvrmsg_setvisibility_s *)msg;
+        nxbe_setvisibility(vismsg->wnd, vismsg->hide);
+      }
+      break;
+
+    case NX_SVRMSG_SETPIXEL: /* Set a single pixel in the window with a color */
+      {
+        FAR struct nxsvrmsg_setpixel_s *setmsg = (FAR struct nxsvrmsg_setpixel_s *)msg;
+        nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
+      }
+      break;
+
+    case NX_SVRMSG_FILL: /* Fill a rectangular region in the window with a color */
+      {
+        FAR struct nxsvrmsg_fill_s *fillmsg = (FAR struct nxsvrmsg_fill_s *)msg;
+        nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
+      }
+      break;
+
+    case NX_SVRMSG_GETRECTANGLE: /* Get a rectangular region from the window */
+      {
+        FAR struct nxsvrmsg_getrectangle_s *getmsg = (FAR struct nxsvrmsg_getrectangle_s *)msg;
+        nxbe_getrectangle(getmsg->wnd, &getmsg->rect, getmsg->plane, getmsg->dest, getmsg->deststride);
+
+        if (getmsg->sem_done)
+         {
+           nxsem_post(getmsg->sem_done);
+         }
+      }
+      break;
+
+    case NX_SVRMSG_FILLTRAP: /* Fill a trapezoidal region in the window with a color */
+      {
+        FAR struct nxsvrmsg_filltrapezoid_s *trapmsg = (FAR struct nxsvrmsg_filltrapezoid_s *)msg;
+        nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip, &trapmsg->trap, trapmsg->color);
+      }
+      break;
+    case NX_SVRMSG_MOVE: /* Move a rectangular region within the window */
+      {
+        FAR struct nxsvrmsg_move_s *movemsg = (FAR struct nxsvrmsg_move_s *)msg;
+        nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
+      }
+      break;
+
+    case NX_SVRMSG_BITMAP: /* Copy a rectangular bitmap into the window */
+      {
+        FAR struct nxsvrmsg_bitmap_s *bmpmsg = (FAR struct nxsvrmsg_bitmap_s *)msg;
+        nxbe_bitmap(bmpmsg->wnd, &bmpmsg->dest, bmpmsg->src, &bmpmsg->origin, bmpmsg->stride);
+
+        if (bmpmsg->sem_done)
+         {
+           nxsem_post(bmpmsg->sem_done);
+         }
+      }
+      break;
+
+    case NX_SVRMSG_SETBGCOLOR: /* Set the color of the background */
+      {
+        FAR struct nxsvrmsg_setbgcolor_s *bgcolormsg =
+          (FAR struct nxsvrmsg_setbgcolor_s *)msg;
+
+        /* Has the background color changed? */
+
+        if (!nxgl_colorcmp(nxmu->be.bgcolor, bgcolormsg->color))
+          {
+            /* Yes.. fill the background */
+
+            nxgl_colorcopy(nxmu->be.bgcolor, bgcolormsg->color);
+            nxbe_fill(&nxmu->be.bkgd, &nxmu->be.bkgd.bounds, bgcolormsg->color);
+          }
+      }
+      break;
+
+#ifdef CONFIG_NX_XYINPUT
+    case NX_SVRMSG_MOUSEIN: /* New mouse report from mouse client */
+      {
+        FAR struct nxsvrmsg_mousein_s *mousemsg = (FAR struct nxsvrmsg_mousein_s *)msg;
+        nxmu_mousein(nxmu, &mousemsg->pt, mousemsg->buttons);
+      }
+      break;
+#endif
+#ifdef CONFIG_NX_KBD
+    case NX_SVRMSG_KBDIN: /* New keyboard report from keyboard client */
+      {
+        FAR struct nxsvrmsg_kbdin_s *kbdmsg = (FAR struct nxsvrmsg_kbdin_s *)msg;
+        nxmu_kbdin(nxmu, kbdmsg->nch, kbdmsg->ch);
+      }
+      break;
+#endif
+
+    case NX_SVRMSG_REDRAWREQ: /* Request re-drawing of rectangular region */
+      {
+        FAR struct nxsvrmsg_redrawreq_s *redrawmsg = (FAR struct nxsvrmsg_redrawreq_s *)msg;
+        nxmu_redraw(redrawmsg->wnd, &redrawmsg->rect);
+      }
+      break;
+
+#ifdef CONFIG_NX_BATCH
+    case NX_SVRMSG_BATCH: /* Process a buffer of batched messages */
+      {
+        FAR struct nxsvrmsg_batch_s *batchmsg =
+          (FAR struct nxsvrmsg_batch_s *)msg;
+        FAR const uint8_t *ptr = batchmsg->buffer;
+        FAR const uint8_t *end = ptr + batchmsg->nbytes;
+        FAR const uintptr_t *hdr;
+
+        /* Each message is preceded by its length */
+
+        while (ptr < end)
+          {
+            hdr = (FAR const uintptr_t *)ptr;
+            nxmu_dispatch(nxmu, (FAR struct nxsvrmsg_s *)(hdr + 1));
+            ptr += NX_BATCH_RECLEN(*hdr);
+          }
+
+        /* The client may now re-use the buffer */
+
+        nxsem_post(batchmsg->sem_done);
+      }
+      break;
+#endif
+
+    /* Messages sent to the background window **************************/
+
+    case NX_CLIMSG_REDRAW: /* Re-draw the background window */
+       {
+         FAR struct nxclimsg_redraw_s *redraw = (FAR struct nxclimsg_redraw_s *)msg;
+         DEBUGASSERT(redraw->wnd == &nxmu->be.bkgd);
+         ginfo("Re-draw background rect={(%d,%d),(%d,%d)}\n",
+               redraw->rect.pt1.x, redraw->rect.pt1.y,
+               redraw->rect.pt2.x, redraw->rect.pt2.y);
+         nxbe_fill(&nxmu->be.bkgd, &redraw->rect, nxmu->be.bgcolor);
+       }
+     break;
+
+    case NX_CLIMSG_MOUSEIN:      /* Ignored */
+    case NX_CLIMSG_KBDIN:
+      break;
+
+    case NX_CLIMSG_CONNECTED:    /* Shouldn't happen */
+    case NX_CLIMSG_DISCONNECTED:
+    default:
+      gerr("ERROR: Unrecognized command: %d\n", msg->msgid);
+      break;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -284,6 +576,10 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_UPDATE_DEFER
+  struct mq_attr         attr;
+  int                    ndeferred = 0;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -303,6 +599,10 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   nxbe_redraw(&nxmu.be, &nxmu.be.bkgd, &nxmu.be.bkgd.bounds);
 
+#ifdef CONFIG_NX_UPDATE_DEFER
+  nxbe_notify_flush(&nxmu.be);
+#endif
+
   /* Message Loop ***********************************************************/
 
   /* Then loop forever processing incoming messages */
@@ -330,254 +630,26 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
        msg = (FAR struct nxsvrmsg_s *)buffer;
 
        ginfo("Received opcode=%d nbytes=%d\n", msg->msgid, nbytes);
-       switch (msg->msgid)
-         {
-         /* Messages sent from clients to the NX server *********************/
-
-         case NX_SVRMSG_CONNECT: /* Establish connection with new NX server client */
-           {
-             FAR struct nxsvrmsg_s *connmsg = (FAR struct nxsvrmsg_s *)buffer;
-             nxmu_connect(connmsg->conn);
-           }
-           break;
-
-         case NX_SVRMSG_DISCONNECT: /* Tear down connection with terminating client */
-           {
-             FAR struct nxsvrmsg_s *disconnmsg = (FAR struct nxsvrmsg_s *)buffer;
-             nxmu_disconnect(disconnmsg->conn);
-           }
-           break;
-
-         case NX_SVRMSG_OPENWINDOW: /* Create a new window */
-           {
-             FAR struct nxsvrmsg_openwindow_s *openmsg = (FAR struct nxsvrmsg_openwindow_s *)buffer;
-             nxmu_openwindow(&nxmu.be, openmsg->wnd);
-           }
-           break;
-
-         case NX_SVRMSG_CLOSEWINDOW: /* Close an existing window */
-           {
-             FAR struct nxsvrmsg_closewindow_s *closemsg = (FAR struct nxsvrmsg_closewindow_s *)buffer;
-             nxbe_closewindow(closemsg->wnd);
-           }
-           break;
-
-         case NX_SVRMSG_BLOCKED: /* Block messages to a window */
-           {
-             FAR struct nxsvrmsg_blocked_s *blocked = (FAR struct nxsvrmsg_blocked_s *)buffer;
-             nxmu_event(blocked->wnd, NXEVENT_BLOCKED, blocked->arg);
-           }
-           break;
-
-         case NX_SVRMSG_SYNCH: /* Synchronization request */
-           {
-             FAR struct nxsvrmsg_synch_s *synch = (FAR struct nxsvrmsg_synch_s *)buffer;
-             nxmu_event(synch->wnd, NXEVENT_SYNCHED, synch->arg);
-           }
-           break;
+       nxmu_dispatch(&nxmu, msg);
 
-#if defined(CONFIG_NX_SWCURSOR) || defined(CONFIG_NX_HWCURSOR)
-         case NX_SVRMSG_CURSOR_ENABLE: /* Enable/disable cursor */
-           {
-             FAR struct nxsvrmsg_curenable_s *enabmsg = (FAR struct nxsvrmsg_curenable_s *)buffer;
-             nxbe_cursor_enable(&nxmu.be, enabmsg->enable);
-           }
-           break;
+#ifdef CONFIG_NX_UPDATE_DEFER
+       /* Report the accumulated display updates when there are no more
+        * messages to process or when the reports have been deferred for
+        * too long.  A synchronization request has already reported them.
+        */
 
-#if defined(CONFIG_NX_HWCURSORIMAGE) || defined(CONFIG_NX_SWCURSOR)
-         case NX_SVRMSG_CURSOR_IMAGE: /* Set cursor image */
-           {
-             FAR struct nxsvrmsg_curimage_s *imgmsg = (FAR struct nxsvrmsg_curimage_s *)buffer;
-             nxbe_cursor_setimage(&nxmu.be, &imgmsg->image);
-           }
-           break;
-#endif
-         case NX_SVRMSG_CURSOR_SETPOS: /* Set cursor position */
-           {
-             FAR struct nxsvrmsg_curpos_s *posmsg = (FAR struct nxsvrmsg_curpos_s *)buffer;
-             nxbe_cursor_setposition(&nxmu.be, &posmsg->pos);
-           }
-           break;
-#endif
-
-         case NX_SVRMSG_REQUESTBKGD: /* Give access to the background window */
-           {
-             FAR struct nxsvrmsg_requestbkgd_s *rqbgmsg = (FAR struct nxsvrmsg_requestbkgd_s *)buffer;
-             nxmu_requestbkgd(rqbgmsg->conn, &nxmu.be, rqbgmsg->cb, rqbgmsg->arg);
-           }
-           break;
-
-         case NX_SVRMSG_RELEASEBKGD: /* End access to the background window */
-           {
-             nxmu_releasebkgd(&nxmu);
-           }
-           break;
-
-         case NX_SVRMSG_SETPOSITION: /* Change window position */
-           {
-             FAR struct nxsvrmsg_setposition_s *setposmsg = (FAR struct nxsvrmsg_setposition_s *)buffer;
-             nxbe_setposition(setposmsg->wnd, &setposmsg->pos);
-           }
-           break;
-
-         case NX_SVRMSG_SETSIZE: /* Change window size */
-           {
-             FAR struct nxsvrmsg_setsize_s *setsizemsg = (FAR struct nxsvrmsg_setsize_s *)buffer;
-             nxbe_setsize(setsizemsg->wnd, &setsizemsg->size);
-           }
-           break;
-
-         case NX_SVRMSG_GETPOSITION: /* Get the window size/position */
-           {
-             FAR struct nxsvrmsg_getposition_s *getposmsg = (FAR struct nxsvrmsg_getposition_s *)buffer;
-             nxmu_reportposition(getposmsg->wnd);
-           }
-           break;
-
-         case NX_SVRMSG_RAISE: /* Move the window to the top of the display */
-           {
-             FAR struct nxsvrmsg_raise_s *raisemsg = (FAR struct nxsvrmsg_raise_s *)buffer;
-             nxbe_raise(raisemsg->wnd);
-           }
-           break;
-
-         case NX_SVRMSG_LOWER: /* Lower the window to the bottom of the display */
-           {
-             FAR struct nxsvrmsg_lower_s *lowermsg = (FAR struct nxsvrmsg_lower_s *)buffer;
-             nxbe_lower(lowermsg->wnd);
-           }
-           break;
-
-         case NX_SVRMSG_MODAL: /* Select/De-select window modal state */
-           {
-             FAR struct nxsvrmsg_modal_s *modalmsg = (FAR struct nxsvrmsg_modal_s *)buffer;
-             nxbe_modal(modalmsg->wnd, modalmsg->modal);
-           }
-           break;
-
-         case NX_SVRMSG_SETVISIBILITY: /* Show or hide a window */
-           {
-             FAR struct nxsvrmsg_setvisibility_s *vismsg =
-               (FAR struct nxsvrmsg_setvisibility_s *)buffer;
-             nxbe_setvisibility(vismsg->wnd, vismsg->hide);
-           }
-           break;
-
-         case NX_SVRMSG_SETPIXEL: /* Set a single pixel in the window with a color */
-           {
-             FAR struct nxsvrmsg_setpixel_s *setmsg = (FAR struct nxsvrmsg_setpixel_s *)buffer;
-             nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
-           }
-           break;
-
-         case NX_SVRMSG_FILL: /* Fill a rectangular region in the window with a color */
-           {
-             FAR struct nxsvrmsg_fill_s *fillmsg = (FAR struct nxsvrmsg_fill_s *)buffer;
-             nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
-           }
-           break;
-
-         case NX_SVRMSG_GETRECTANGLE: /* Get a rectangular region from the window */
-           {
-             FAR struct nxsvrmsg_getrectangle_s *getmsg = (FAR struct nxsvrmsg_getrectangle_s *)buffer;
-             nxbe_getrectangle(getmsg->wnd, &getmsg->rect, getmsg->plane, getmsg->dest, getmsg->deststride);
-
-             if (getmsg->sem_done)
-              {
-                nxsem_post(getmsg->sem_done);
-              }
-           }
-           break;
-
-         case NX_SVRMSG_FILLTRAP: /* Fill a trapezoidal region in the window with a color */
-           {
-             FAR struct nxsvrmsg_filltrapezoid_s *trapmsg = (FAR struct nxsvrmsg_filltrapezoid_s *)buffer;
-             nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip, &trapmsg->trap, trapmsg->color);
-           }
-           break;
-         case NX_SVRMSG_MOVE: /* Move a rectangular region within the window */
-           {
-             FAR struct nxsvrmsg_move_s *movemsg = (FAR struct nxsvrmsg_move_s *)buffer;
-             nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
-           }
-           break;
-
-         case NX_SVRMSG_BITMAP: /* Copy a rectangular bitmap into the window */
-           {
-             FAR struct nxsvrmsg_bitmap_s *bmpmsg = (FAR struct nxsvrmsg_bitmap_s *)buffer;
-             nxbe_bitmap(bmpmsg->wnd, &bmpmsg->dest, bmpmsg->src, &bmpmsg->origin, bmpmsg->stride);
-
-             if (bmpmsg->sem_done)
-              {
-                nxsem_post(bmpmsg->sem_done);
-              }
-           }
-           break;
-
-         case NX_SVRMSG_SETBGCOLOR: /* Set the color of the background */
-           {
-             FAR struct nxsvrmsg_setbgcolor_s *bgcolormsg =
-               (FAR struct nxsvrmsg_setbgcolor_s *)buffer;
-
-             /* Has the background color changed? */
-
-             if (!nxgl_colorcmp(nxmu.be.bgcolor, bgcolormsg->color))
-               {
-                 /* Yes.. fill the background */
-
-                 nxgl_colorcopy(nxmu.be.bgcolor, bgcolormsg->color);
-                 nxbe_fill(&nxmu.be.bkgd, &nxmu.be.bkgd.bounds, bgcolormsg->color);
-               }
-           }
-           break;
-
-#ifdef CONFIG_NX_XYINPUT
-         case NX_SVRMSG_MOUSEIN: /* New mouse report from mouse client */
-           {
-             FAR struct nxsvrmsg_mousein_s *mousemsg = (FAR struct nxsvrmsg_mousein_s *)buffer;
-             nxmu_mousein(&nxmu, &mousemsg->pt, mousemsg->buttons);
-           }
-           break;
-#endif
-#ifdef CONFIG_NX_KBD
-         case NX_SVRMSG_KBDIN: /* New keyboard report from keyboard client */
-           {
-             FAR struct nxsvrmsg_kbdin_s *kbdmsg = (FAR struct nxsvrmsg_kbdin_s *)buffer;
-             nxmu_kbdin(&nxmu, kbdmsg->nch, kbdmsg->ch);
-           }
-           break;
-#endif
-
-         case NX_SVRMSG_REDRAWREQ: /* Request re-drawing of rectangular region */
-           {
-             FAR struct nxsvrmsg_redrawreq_s *redrawmsg = (FAR struct nxsvrmsg_redrawreq_s *)buffer;
-             nxmu_redraw(redrawmsg->wnd, &redrawmsg->rect);
-           }
-           break;
-
-         /* Messages sent to the background window **************************/
-
-         case NX_CLIMSG_REDRAW: /* Re-draw the background window */
-            {
-              FAR struct nxclimsg_redraw_s *redraw = (FAR struct nxclimsg_redraw_s *)buffer;
-              DEBUGASSERT(redraw->wnd == &nxmu.be.bkgd);
-              ginfo("Re-draw background rect={(%d,%d),(%d,%d)}\n",
-                    redraw->rect.pt1.x, redraw->rect.pt1.y,
-                    redraw->rect.pt2.x, redraw->rect.pt2.y);
-              nxbe_fill(&nxmu.be.bkgd, &redraw->rect, nxmu.be.bgcolor);
-            }
-          break;
-
-         case NX_CLIMSG_MOUSEIN:      /* Ignored */
-         case NX_CLIMSG_KBDIN:
-           break;
-
-         case NX_CLIMSG_CONNECTED:    /* Shouldn't happen */
-         case NX_CLIMSG_DISCONNECTED:
-         default:
-           gerr("ERROR: Unrecognized command: %d\n", msg->msgid);
-           break;
+       if (msg->msgid == NX_SVRMSG_SYNCH)
+         {
+           ndeferred = 0;
          }
+       else if (++ndeferred >= CONFIG_NX_UPDATE_MAXDEFER ||
+           (mq_getattr(nxmu.conn.crdmq, &attr) == OK &&
+            attr.mq_curmsgs == 0))
+         {
+           nxbe_notify_flush(&nxmu.be);
+           ndeferred = 0;
+         }
+#endif
     }
 
   nxmu_shutdown(&nxmu);
@@ -76,6 +76,25 @@
 
 #define VT100_MAX_SEQUENCE 3
 
+/* Batch rendering composes whole pixels in the run buffer */
+
+#if defined(CONFIG_NXTERM_BATCH) && CONFIG_NXTERM_BPP != 8 && \
+    CONFIG_NXTERM_BPP != 16 && CONFIG_NXTERM_BPP != 32
+#  warning CONFIG_NXTERM_BATCH requires CONFIG_NXTERM_BPP of 8, 16, or 32
+#  undef CONFIG_NXTERM_BATCH
+#endif
+
+#ifdef CONFIG_NXTERM_BATCH
+#  ifndef CONFIG_NXTERM_BATCHCHARS
+#    define CONFIG_NXTERM_BATCHCHARS 32
+#  endif
+
+/* The width of the run buffer in pixels and in bytes */
+
+#  define NXTERM_RUNWIDTH(p)  (CONFIG_NXTERM_BATCHCHARS * (p)->fwidth)
+#  define NXTERM_RUNSTRIDE(p) ((NXTERM_RUNWIDTH(p) * CONFIG_NXTERM_BPP) >> 3)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -147,6 +166,13 @@ struct nxterm_state_s
 
   struct nxgl_point_s fpos;                  /* Next display position */
 
+#ifdef CONFIG_NXTERM_BATCH
+  /* Batch rendering */
+
+  uint16_t runstart;                         /* First bm[] not yet drawn */
+  FAR uint8_t *runbuf;                       /* Composes a run of characters */
+#endif
+
   /* VT100 escape sequence processing */
 
   char seq[VT100_MAX_SEQUENCE];              /* Buffered characters */
@@ -240,6 +266,15 @@ int nxterm_hidechar(FAR struct nxterm_state_s *priv,
 int nxterm_backspace(FAR struct nxterm_state_s *priv);
 void nxterm_fillchar(FAR struct nxterm_state_s *priv,
     FAR const struct nxgl_rect_s *rect, FAR const struct nxterm_bitmap_s *bm);
+void nxterm_drawchars(FAR struct nxterm_state_s *priv,
+    FAR const struct nxgl_rect_s *rect, int first, int end);
+#ifdef CONFIG_NXTERM_BATCH
+void nxterm_batchchar(FAR struct nxterm_state_s *priv,
+    FAR const struct nxterm_bitmap_s *bm);
+void nxterm_flushrun(FAR struct nxterm_state_s *priv);
+#else
+#  define nxterm_flushrun(p)
+#endif
 
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch);
 void nxterm_showcursor(FAR struct nxterm_state_s *priv);
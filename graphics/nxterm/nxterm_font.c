@@ -135,6 +135,120 @@ static void nxterm_fillspace(FAR struct nxterm_state_s *priv,
 #endif
 }
 
+#ifdef CONFIG_NXTERM_BATCH
+/****************************************************************************
+ * Name: nxterm_fillrun
+ *
+ * Description:
+ *   Fill 'npixels' pixels of the run buffer with the background color.
+ *
+ ****************************************************************************/
+
+static void nxterm_fillrun(FAR struct nxterm_state_s *priv,
+                           FAR uint8_t *dest, int npixels)
+{
+  nxgl_mxpixel_t color = priv->wndo.wcolor[0];
+
+#if CONFIG_NXTERM_BPP == 8
+  memset(dest, (uint8_t)color, npixels);
+#elif CONFIG_NXTERM_BPP == 16
+  FAR uint16_t *dest16 = (FAR uint16_t *)dest;
+
+  while (npixels-- > 0)
+    {
+      *dest16++ = (uint16_t)color;
+    }
+#else
+  FAR uint32_t *dest32 = (FAR uint32_t *)dest;
+
+  while (npixels-- > 0)
+    {
+      *dest32++ = (uint32_t)color;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: nxterm_composechar
+ *
+ * Description:
+ *   Copy the glyph, or the background for a space if 'glyph' is NULL, into
+ *   the run buffer at pixel column 'xoffset'.  'width' is the width of the
+ *   character in pixels.
+ *
+ ****************************************************************************/
+
+static void nxterm_composechar(FAR struct nxterm_state_s *priv,
+                               FAR const struct nxfonts_glyph_s *glyph,
+                               int xoffset, int width)
+{
+  FAR uint8_t *dest;
+  size_t stride = NXTERM_RUNSTRIDE(priv);
+  size_t nbytes = (width * CONFIG_NXTERM_BPP) >> 3;
+  int row;
+
+  dest = priv->runbuf + ((xoffset * CONFIG_NXTERM_BPP) >> 3);
+  for (row = 0; row < priv->fheight; row++, dest += stride)
+    {
+      if (glyph != NULL && row < glyph->height)
+        {
+          memcpy(dest, &glyph->bitmap[row * glyph->stride], nbytes);
+        }
+      else
+        {
+          nxterm_fillrun(priv, dest, width);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxterm_drawrun
+ *
+ * Description:
+ *   Render the 'width' pixel columns composed in the run buffer at
+ *   'origin', clipped to 'rect' if 'rect' is not NULL.
+ *
+ ****************************************************************************/
+
+static void nxterm_drawrun(FAR struct nxterm_state_s *priv,
+                           FAR const struct nxgl_rect_s *rect,
+                           FAR const struct nxgl_point_s *origin, int width)
+{
+  FAR const void *src;
+  struct nxgl_rect_s bounds;
+  struct nxgl_rect_s intersection;
+  int ret;
+
+  if (width <= 0)
+    {
+      return;
+    }
+
+  bounds.pt1.x = origin->x;
+  bounds.pt1.y = origin->y;
+  bounds.pt2.x = origin->x + width - 1;
+  bounds.pt2.y = origin->y + priv->fheight - 1;
+
+  if (rect != NULL)
+    {
+      nxgl_rectintersect(&intersection, rect, &bounds);
+    }
+  else
+    {
+      nxgl_rectcopy(&intersection, &bounds);
+    }
+
+  if (!nxgl_nullrect(&intersection))
+    {
+      src = (FAR const void *)priv->runbuf;
+      ret = priv->ops->bitmap(priv, &intersection, &src, origin,
+                              (unsigned int)NXTERM_RUNSTRIDE(priv));
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -402,3 +516,159 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
       DEBUGASSERT(ret >= 0);
     }
 }
+
+/****************************************************************************
+ * Name: nxterm_drawchars
+ *
+ * Description:
+ *   Render the characters bm[first] through bm[end-1], clipped to 'rect'
+ *   if 'rect' is not NULL.  With CONFIG_NXTERM_BATCH, adjacent characters
+ *   on the same line are composed and rendered with one bitmap operation.
+ *
+ ****************************************************************************/
+
+void nxterm_drawchars(FAR struct nxterm_state_s *priv,
+                      FAR const struct nxgl_rect_s *rect, int first, int end)
+{
+#ifdef CONFIG_NXTERM_BATCH
+  FAR const struct nxterm_bitmap_s *bm;
+  FAR const struct nxfonts_glyph_s *glyph;
+  struct nxgl_point_s origin;
+  nxgl_coord_t runend = 0;
+  int runwidth = NXTERM_RUNWIDTH(priv);
+  int start = first;
+  int width;
+  int ndx;
+
+  origin.x = 0;
+  origin.y = 0;
+
+  for (ndx = first; ndx < end; ndx++)
+    {
+      bm = &priv->bm[ndx];
+
+      /* Skip over the lines that lie outside of the region */
+
+      if (rect != NULL &&
+          (bm->pos.y > rect->pt2.y ||
+           bm->pos.y + priv->fheight - 1 < rect->pt1.y))
+        {
+          if (ndx > start)
+            {
+              nxterm_drawrun(priv, rect, &origin, runend - origin.x);
+            }
+
+          start = ndx + 1;
+          continue;
+        }
+
+      /* Get the glyph and the width of the character */
+
+      glyph = NULL;
+      if (!BM_ISSPACE(bm))
+        {
+          glyph = nxf_cache_getglyph(priv->fcache, bm->code);
+        }
+
+      width = glyph != NULL ? glyph->width : priv->spwidth;
+      if (width > runwidth)
+        {
+          width = runwidth;
+        }
+
+      /* Render the pending run if this character does not continue it */
+
+      if (ndx > start &&
+          (bm->pos.y != origin.y || bm->pos.x != runend ||
+           bm->pos.x + width - origin.x > runwidth))
+        {
+          nxterm_drawrun(priv, rect, &origin, runend - origin.x);
+          start = ndx;
+        }
+
+      if (ndx == start)
+        {
+          origin.x = bm->pos.x;
+          origin.y = bm->pos.y;
+        }
+
+      nxterm_composechar(priv, glyph, bm->pos.x - origin.x, width);
+      runend = bm->pos.x + width;
+    }
+
+  if (end > start)
+    {
+      nxterm_drawrun(priv, rect, &origin, runend - origin.x);
+    }
+#else
+  int ndx;
+
+  for (ndx = first; ndx < end; ndx++)
+    {
+      nxterm_fillchar(priv, rect, &priv->bm[ndx]);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: nxterm_batchchar
+ *
+ * Description:
+ *   This is part of the nxterm_putc logic.  Defer the rendering of the
+ *   character just added to the bm[] array so that it is rendered together
+ *   with the following characters on the same line.  Any pending run that
+ *   the character does not continue is rendered first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXTERM_BATCH
+void nxterm_batchchar(FAR struct nxterm_state_s *priv,
+                      FAR const struct nxterm_bitmap_s *bm)
+{
+  FAR const struct nxterm_bitmap_s *start;
+  FAR const struct nxterm_bitmap_s *prev;
+  int ndx = bm - priv->bm;
+
+  DEBUGASSERT(ndx >= 0 && ndx < priv->nchars);
+
+  /* Characters may have been removed from the bm[] array since the run was
+   * started.
+   */
+
+  if (priv->runstart > ndx)
+    {
+      priv->runstart = ndx;
+    }
+
+  if (priv->runstart < ndx)
+    {
+      start = &priv->bm[priv->runstart];
+      prev  = &priv->bm[ndx - 1];
+
+      if (bm->pos.y != start->pos.y || bm->pos.x <= prev->pos.x ||
+          bm->pos.x + priv->fwidth - start->pos.x > NXTERM_RUNWIDTH(priv))
+        {
+          nxterm_drawchars(priv, NULL, priv->runstart, ndx);
+          priv->runstart = ndx;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxterm_flushrun
+ *
+ * Description:
+ *   Render all characters deferred by nxterm_batchchar().
+ *
+ ****************************************************************************/
+
+void nxterm_flushrun(FAR struct nxterm_state_s *priv)
+{
+  if (priv->runstart < priv->nchars)
+    {
+      nxterm_drawchars(priv, NULL, priv->runstart, priv->nchars);
+    }
+
+  priv->runstart = priv->nchars;
+}
+#endif
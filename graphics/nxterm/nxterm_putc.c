@@ -129,7 +129,11 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
   bm = nxterm_addchar(priv, ch);
   if (bm)
     {
+#ifdef CONFIG_NXTERM_BATCH
+      nxterm_batchchar(priv, bm);
+#else
       nxterm_fillchar(priv, NULL, bm);
+#endif
     }
 }
 
@@ -78,7 +78,6 @@ void nxterm_redraw(NXTERM handle, FAR const struct nxgl_rect_s *rect, bool more)
 {
   FAR struct nxterm_state_s *priv;
   int ret;
-  int i;
 
   DEBUGASSERT(handle && rect);
   ginfo("rect={(%d,%d),(%d,%d)} more=%s\n",
@@ -120,10 +119,7 @@ void nxterm_redraw(NXTERM handle, FAR const struct nxgl_rect_s *rect, bool more)
    * the rectangle will actually be redrawn).
    */
 
-  for (i = 0; i < priv->nchars; i++)
-    {
-      nxterm_fillchar(priv, rect, &priv->bm[i]);
-    }
+  nxterm_drawchars(priv, rect, 0, priv->nchars);
 
   (void)nxterm_sempost(priv);
 }
@@ -122,7 +122,7 @@ FAR struct nxterm_state_s *
     {
       gerr("ERROR: Failed to get handlr for font ID %d: %d\n",
            wndo->fontid, errno);
-      goto errout;
+      goto errout_with_fcache;
     }
 
   /* Get information about the font set being used and save this in the
@@ -134,6 +134,18 @@ FAR struct nxterm_state_s *
   priv->fwidth    = fontset->mxwidth;
   priv->spwidth   = fontset->spwidth;
 
+#ifdef CONFIG_NXTERM_BATCH
+  /* Allocate the buffer used to compose a run of characters */
+
+  priv->runbuf = (FAR uint8_t *)
+    kmm_malloc(NXTERM_RUNSTRIDE(priv) * priv->fheight);
+  if (priv->runbuf == NULL)
+    {
+      gerr("ERROR: Failed to allocate the run buffer\n");
+      goto errout_with_fcache;
+    }
+#endif
+
   /* Set up the text cache */
 
   priv->maxchars  = CONFIG_NXTERM_MXCHARS;
@@ -162,6 +174,9 @@ FAR struct nxterm_state_s *
 
   return (NXTERM)priv;
 
+errout_with_fcache:
+  nxf_cache_disconnect(priv->fcache);
+
 errout:
   kmm_free(priv);
   return NULL;
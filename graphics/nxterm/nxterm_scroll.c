@@ -72,58 +72,104 @@
 static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
                                      int bottom, int scrollheight)
 {
-  FAR struct nxterm_bitmap_s *bm;
   struct nxgl_rect_s rect;
   nxgl_coord_t row;
+  int prevstart = 0;
+  int prevend = 0;
+  int start;
+  int ndx = 0;
+  int k;
   int ret;
-  int i;
 
-  /* Move each row, one at a time.  They could all be moved at once (by calling
-   * nxterm_redraw), but the since the region is cleared, then re-written, the
-   * effect would not be good.  Below the region is also cleared and re-written,
-   * however, in much smaller chunks.
+  /* The display cannot be read back, so each row of characters must be
+   * re-written.  Only the part of a row that differs from what is already
+   * on the display is cleared and re-written:  The row displayed at 'row'
+   * is the one that is now displayed at 'row - scrollheight'.
+   *
+   * This depends on the bm[] array being ordered by row and then by column
+   * and on the rows being 'scrollheight' apart.
    */
 
-  rect.pt1.x = 0;
+  DEBUGASSERT(scrollheight == priv->fheight + CONFIG_NXTERM_LINESEPARATION);
+
   rect.pt2.x = priv->wndo.wsize.w - 1;
 
-  for (row = CONFIG_NXTERM_LINESEPARATION; row < bottom; row += scrollheight)
+  for (row = CONFIG_NXTERM_LINESEPARATION;
+       row < priv->wndo.wsize.h && (row < bottom || prevend > prevstart);
+       row += scrollheight)
     {
-      /* Create a bounding box the size of one row of characters */
-
-      rect.pt1.y = row;
-      rect.pt2.y = row + scrollheight - 1;
-
-      /* Clear the region */
+      /* Find the characters now on this row */
 
-      ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
-      if (ret < 0)
+      start = ndx;
+      while (ndx < priv->nchars && priv->bm[ndx].pos.y < row + scrollheight)
         {
-          gerr("ERROR: Fill failed: %d\n", errno);
+          ndx++;
         }
 
-      /* Fill each character that might lie within in the bounding box */
+      /* Skip the leading characters that are already on the display.
+       * Nothing is known about the first row which has scrolled off.
+       */
 
-      for (i = 0; i < priv->nchars; i++)
+      k = 0;
+      if (row > CONFIG_NXTERM_LINESEPARATION)
         {
-          bm = &priv->bm[i];
-          if (bm->pos.y <= rect.pt2.y &&
-              bm->pos.y + priv->fheight >= rect.pt1.y)
+          while (prevstart + k < prevend && start + k < ndx &&
+                 priv->bm[prevstart + k].code == priv->bm[start + k].code &&
+                 priv->bm[prevstart + k].pos.x == priv->bm[start + k].pos.x)
+            {
+              k++;
+            }
+
+          if (prevstart + k >= prevend && start + k >= ndx)
+            {
+              /* The row is unchanged */
+
+              prevstart = start;
+              prevend   = ndx;
+              continue;
+            }
+
+          /* Clear from the first character that differs */
+
+          if (start + k < ndx)
+            {
+              rect.pt1.x = priv->bm[start + k].pos.x;
+            }
+          else
+            {
+              rect.pt1.x = priv->bm[prevstart + k].pos.x;
+            }
+
+          if (prevstart + k < prevend &&
+              priv->bm[prevstart + k].pos.x < rect.pt1.x)
             {
-              nxterm_fillchar(priv, &rect, bm);
+              rect.pt1.x = priv->bm[prevstart + k].pos.x;
             }
         }
-    }
+      else
+        {
+          rect.pt1.x = 0;
+        }
 
-  /* Finally, clear the vacated part of the display */
+      /* Clear the rest of the row and re-write the remaining characters */
 
-  rect.pt1.y = bottom;
-  rect.pt2.y = priv->wndo.wsize.h - 1;
+      rect.pt1.y = row;
+      rect.pt2.y = row + scrollheight - 1;
+      if (rect.pt2.y >= priv->wndo.wsize.h)
+        {
+          rect.pt2.y = priv->wndo.wsize.h - 1;
+        }
 
-  ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
-  if (ret < 0)
-    {
-      gerr("ERROR: Fill failed: %d\n", errno);
+      ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
+      if (ret < 0)
+        {
+          gerr("ERROR: Fill failed: %d\n", errno);
+        }
+
+      nxterm_drawchars(priv, &rect, start + k, ndx);
+
+      prevstart = start;
+      prevend   = ndx;
     }
 }
 #else
@@ -187,45 +233,43 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
   int i;
   int j;
 
+  /* Render any characters that are still pending so that the display
+   * matches the bm[] array.
+   */
+
+  nxterm_flushrun(priv);
+
   /* Adjust the vertical position of each character */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
       FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
 
-      /* Has any part of this character scrolled off the screen? */
+      /* Has any part of this character scrolled off the screen?  If so,
+       * delete the character by not keeping it.
+       */
 
-      if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
+      if (bm->pos.y >= scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
-
-          for (j = i; j < priv->nchars - 1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j + 1],
-                     sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
+          /* No.. just decrement its vertical position (moving it "up" the
+           * display by one line) and keep it.
            */
 
-          priv->nchars--;
-        }
-
-      /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
-       */
-
-      else
-        {
           bm->pos.y -= scrollheight;
+          if (j != i)
+            {
+              memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
+            }
 
-          /* We are keeping this one so increment to the next character */
-
-          i++;
+          j++;
         }
     }
 
+  priv->nchars = j;
+#ifdef CONFIG_NXTERM_BATCH
+  priv->runstart = j;
+#endif
+
   /* And move the next display position up by one line as well */
 
   priv->fpos.y -= scrollheight;
@@ -87,6 +87,12 @@ void nxterm_unregister(FAR struct nxterm_state_s *priv)
 
   nxf_cache_disconnect(priv->fcache);
 
+#ifdef CONFIG_NXTERM_BATCH
+  /* Free the run buffer */
+
+  kmm_free(priv->runbuf);
+#endif
+
   /* Unregister the driver */
 
   snprintf(devname, NX_DEVNAME_SIZE, NX_DEVNAME_FORMAT, priv->minor);
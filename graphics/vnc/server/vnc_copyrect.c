@@ -0,0 +1,157 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_copyrect.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_copyrect
+ *
+ * Description:
+ *  Send the framebuffer update using the CopyRect encoding:  The client
+ *  copies the rectangle from another position of its framebuffer.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the destination rectangle.
+ *   srcpos  - The upper left position of the source rectangle.
+ *
+ * Returned Value:
+ *   Zero is returned if CopyRect coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+int vnc_copyrect(FAR struct vnc_session_s *session,
+                 FAR struct nxgl_rect_s *rect,
+                 FAR struct nxgl_point_s *srcpos)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR struct rfb_copyrect_encoding_s *copyrect;
+  FAR const uint8_t *src;
+  size_t nbytes;
+  size_t size;
+  ssize_t nsent;
+
+  /* The client may have changed its encodings since the copy was queued.
+   * Then the destination rectangle is sent with some other encoding.
+   */
+
+  if (!session->copyrect)
+    {
+      return 0;
+    }
+
+  /* Format the FrameBuffer Update with a single CopyRect rectangle */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos,   rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos,   rect->pt1.y);
+  rfb_putbe16(update->rect[0].width,  rect->pt2.x - rect->pt1.x + 1);
+  rfb_putbe16(update->rect[0].height, rect->pt2.y - rect->pt1.y + 1);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_COPYRECT);
+
+  copyrect = (FAR struct rfb_copyrect_encoding_s *)update->rect[0].data;
+  rfb_putbe16(copyrect->xpos, srcpos->x);
+  rfb_putbe16(copyrect->ypos, srcpos->y);
+
+  nbytes = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(
+             SIZEOF_RFB_RECTANGE_S(sizeof(struct rfb_copyrect_encoding_s)));
+
+  /* Okay send until all of the bytes are out.  This may loop for the case
+   * where TCP write buffering is enabled and there are a limited number of
+   * IOBs available.
+   */
+
+  src  = session->outbuf;
+  size = nbytes;
+
+  do
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send CopyRect FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+  while (size > 0);
+
+  updinfo("Sent copy (%d, %d) to {(%d, %d),(%d, %d)}\n",
+          srcpos->x, srcpos->y,
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return nbytes;
+}
@@ -892,3 +892,46 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
     }
 }
 #endif
+
+/****************************************************************************
+ * Name: nx_notify_move
+ *
+ * Description:
+ *   When CONFIG_NX_UPDATE_MOVE=y, then the graphics system will callout to
+ *   inform us that a region of the display has been moved.  The client can
+ *   then copy the region within its framebuffer with the CopyRect
+ *   encoding.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+void nx_notify_move(FAR NX_PLANEINFOTYPE *pinfo,
+                    FAR const struct nxgl_rect_s *rect,
+                    FAR const struct nxgl_point_s *offset)
+{
+  FAR struct vnc_session_s *session;
+  int ret;
+
+  DEBUGASSERT(pinfo != NULL && rect != NULL && offset != NULL);
+
+  /* Recover the session information from the display number in the planeinfo
+   * structure.
+   */
+
+  DEBUGASSERT(pinfo->display >= 0 && pinfo->display < RFB_MAX_DISPLAYS);
+  session = g_vnc_sessions[pinfo->display];
+
+  /* Verify that the session is still valid */
+
+  if (session != NULL && session->state == VNCSERVER_RUNNING)
+    {
+      /* Queue the copy of the rectangular region */
+
+      ret = vnc_copy_rectangle(session, rect, offset);
+      if (ret < 0)
+        {
+          gerr("ERROR: vnc_copy_rectangle failed: %d\n", ret);
+        }
+    }
+}
+#endif
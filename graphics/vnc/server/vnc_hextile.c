@@ -0,0 +1,664 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Tiles are 16x16 pixels (the last tile in a row or column may be smaller) */
+
+#define HEXTILE_SIZE         16
+
+/* The largest encoded tile is a raw tile:  The sub-encoding byte followed
+ * by the pixels.
+ */
+
+#define HEXTILE_MAXSIZE(b)   (1 + HEXTILE_SIZE * HEXTILE_SIZE * (b))
+
+/* Size of the FramebufferUpdate header with one rectangle header */
+
+#define HEXTILE_HDRSIZE \
+  SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0))
+
+/* Get the pixel at column 'c' and row 'r' of a tile in the local
+ * framebuffer.
+ */
+
+#define HEXTILE_PIXEL(t,c,r) \
+  ((t)[(r) * CONFIG_VNCSERVER_SCREENWIDTH + (c)])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of the Hextile encoding of one rectangle */
+
+struct vnc_hextile_s
+{
+  FAR struct vnc_session_s *session;
+  FAR uint8_t *dest;           /* Next free byte in the output buffer */
+  uint8_t bytesperpixel;       /* Remote bytes per pixel */
+  bool bigendian;              /* True: Remote expects big-endian pixels */
+  bool bgvalid;                /* True: Background carries over */
+  bool fgvalid;                /* True: Foreground carries over */
+  lfb_color_t bg;              /* Background of the previous tile */
+  lfb_color_t fg;              /* Foreground of the previous tile */
+
+  union
+  {
+    vnc_convert8_t bpp8;
+    vnc_convert16_t bpp16;
+    vnc_convert32_t bpp32;
+  } convert;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_putpixel
+ *
+ * Description:
+ *   Convert one pixel to the remote pixel format and store it.
+ *
+ * Input Parameters:
+ *   hx    - The state of the Hextile encoding
+ *   dest  - The location to store the pixel
+ *   color - The pixel in the local framebuffer color format
+ *
+ * Returned Value:
+ *   The location following the stored pixel.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_hextile_putpixel(FAR struct vnc_hextile_s *hx,
+                                         FAR uint8_t *dest,
+                                         lfb_color_t color)
+{
+  if (hx->bytesperpixel == 1)
+    {
+      *dest++ = hx->convert.bpp8(color);
+    }
+  else if (hx->bytesperpixel == 2)
+    {
+      uint16_t pixel = hx->convert.bpp16(color);
+
+      if (hx->bigendian)
+        {
+          rfb_putbe16(dest, pixel);
+        }
+      else
+        {
+          rfb_putle16(dest, pixel);
+        }
+
+      dest += sizeof(uint16_t);
+    }
+  else /* bytesperpixel == 4 */
+    {
+      uint32_t pixel = hx->convert.bpp32(color);
+
+      if (hx->bigendian)
+        {
+          rfb_putbe32(dest, pixel);
+        }
+      else
+        {
+          rfb_putle32(dest, pixel);
+        }
+
+      dest += sizeof(uint32_t);
+    }
+
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send the content of the output buffer to the VNC client.  The encoded
+ *   rectangle is a part of the TCP stream like any other data, so it may
+ *   be sent in as many pieces as necessary.
+ *
+ * Input Parameters:
+ *   hx - The state of the Hextile encoding
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct vnc_hextile_s *hx)
+{
+  FAR struct vnc_session_s *session = hx->session;
+  FAR const uint8_t *src = session->outbuf;
+  size_t size = hx->dest - session->outbuf;
+  ssize_t nsent;
+
+  /* Okay send until all of the bytes are out.  This may loop for the case
+   * where TCP write buffering is enabled and there are a limited number of
+   * IOBs available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+
+  hx->dest = session->outbuf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_raw
+ *
+ * Description:
+ *   Encode one tile as raw pixels.
+ *
+ * Input Parameters:
+ *   hx     - The state of the Hextile encoding
+ *   tile   - The upper left pixel of the tile in the local framebuffer
+ *   width  - The width of the tile in pixels
+ *   height - The height of the tile in rows
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_raw(FAR struct vnc_hextile_s *hx,
+                            FAR const lfb_color_t *tile,
+                            unsigned int width, unsigned int height)
+{
+  FAR uint8_t *dest = hx->dest;
+  unsigned int x;
+  unsigned int y;
+
+  *dest++ = RFB_HEXTILE_RAW;
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          dest = vnc_hextile_putpixel(hx, dest, HEXTILE_PIXEL(tile, x, y));
+        }
+    }
+
+  /* Neither the background nor the foreground carry over a raw tile */
+
+  hx->dest    = dest;
+  hx->bgvalid = false;
+  hx->fgvalid = false;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile.  The most frequent color becomes the background.  The
+ *   other pixels are covered with sub-rectangles of a uniform color:  Each
+ *   starts at the first pixel not yet covered and is extended first to
+ *   the right, then downward.  If there is only one other color, it is
+ *   sent once as the foreground.  If the sub-rectangles are not smaller
+ *   than the raw pixels, the tile is sent raw.
+ *
+ * Input Parameters:
+ *   hx     - The state of the Hextile encoding
+ *   tile   - The upper left pixel of the tile in the local framebuffer
+ *   width  - The width of the tile in pixels
+ *   height - The height of the tile in rows
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   There is room for HEXTILE_MAXSIZE() bytes in the output buffer.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_tile(FAR struct vnc_hextile_s *hx,
+                             FAR const lfb_color_t *tile,
+                             unsigned int width, unsigned int height)
+{
+  uint16_t covered[HEXTILE_SIZE];
+  FAR uint8_t *start = hx->dest;
+  FAR uint8_t *limit;
+  FAR uint8_t *nsubrects;
+  FAR uint8_t *dest;
+  lfb_color_t color;
+  lfb_color_t bg;
+  lfb_color_t fg;
+  unsigned int subrectsize;
+  unsigned int nrects;
+  unsigned int count;
+  unsigned int x;
+  unsigned int y;
+  unsigned int w;
+  unsigned int h;
+  unsigned int i;
+  uint16_t mask;
+  uint8_t subenc;
+  bool hasfg;
+  bool mono;
+
+  /* Pick the background color with a majority vote */
+
+  bg    = HEXTILE_PIXEL(tile, 0, 0);
+  count = 0;
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          color = HEXTILE_PIXEL(tile, x, y);
+          if (count == 0)
+            {
+              bg    = color;
+              count = 1;
+            }
+          else if (color == bg)
+            {
+              count++;
+            }
+          else
+            {
+              count--;
+            }
+        }
+    }
+
+  /* Are there other colors?  Is there only one other color? */
+
+  fg    = bg;
+  hasfg = false;
+  mono  = true;
+
+  for (y = 0; y < height && mono; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          color = HEXTILE_PIXEL(tile, x, y);
+          if (color != bg)
+            {
+              if (!hasfg)
+                {
+                  fg    = color;
+                  hasfg = true;
+                }
+              else if (color != fg)
+                {
+                  mono = false;
+                  break;
+                }
+            }
+        }
+    }
+
+  /* Start with the sub-encoding mask and the background */
+
+  subenc = 0;
+  dest   = start + 1;
+
+  if (!hx->bgvalid || bg != hx->bg)
+    {
+      subenc |= RFB_HEXTILE_BACK;
+      dest    = vnc_hextile_putpixel(hx, dest, bg);
+    }
+
+  hx->bg      = bg;
+  hx->bgvalid = true;
+
+  if (!hasfg)
+    {
+      /* A solid tile */
+
+      *start   = subenc;
+      hx->dest = dest;
+      return;
+    }
+
+  subenc |= RFB_HEXTILE_ANY;
+
+  if (mono)
+    {
+      if (!hx->fgvalid || fg != hx->fg)
+        {
+          subenc |= RFB_HEXTILE_FORE;
+          dest    = vnc_hextile_putpixel(hx, dest, fg);
+        }
+
+      subrectsize = sizeof(struct rfb_subrect_s);
+    }
+  else
+    {
+      subenc     |= RFB_HEXTILE_COLORED;
+      subrectsize = sizeof(struct rfb_subrect_s) + hx->bytesperpixel;
+    }
+
+  nsubrects = dest++;
+  nrects    = 0;
+
+  /* The encoding must be smaller than the raw tile */
+
+  limit = start + 1 + width * height * hx->bytesperpixel;
+
+  memset(covered, 0, sizeof(covered));
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          color = HEXTILE_PIXEL(tile, x, y);
+          if (color == bg || (covered[y] & (1 << x)) != 0)
+            {
+              continue;
+            }
+
+          /* Extend the sub-rectangle to the right */
+
+          w = 1;
+          while (x + w < width &&
+                 (covered[y] & (1 << (x + w))) == 0 &&
+                 HEXTILE_PIXEL(tile, x + w, y) == color)
+            {
+              w++;
+            }
+
+          mask = (uint16_t)(((1ul << w) - 1) << x);
+
+          /* Then extend it downward while the whole row matches */
+
+          for (h = 1; y + h < height; h++)
+            {
+              if ((covered[y + h] & mask) != 0)
+                {
+                  break;
+                }
+
+              for (i = 0; i < w; i++)
+                {
+                  if (HEXTILE_PIXEL(tile, x + i, y + h) != color)
+                    {
+                      break;
+                    }
+                }
+
+              if (i < w)
+                {
+                  break;
+                }
+            }
+
+          /* Give up if the sub-rectangles become too large */
+
+          if (nrects >= 255 || dest + subrectsize > limit)
+            {
+              hx->dest = start;
+              vnc_hextile_raw(hx, tile, width, height);
+              return;
+            }
+
+          if (!mono)
+            {
+              dest = vnc_hextile_putpixel(hx, dest, color);
+            }
+
+          *dest++ = (uint8_t)((x << 4) | y);
+          *dest++ = (uint8_t)(((w - 1) << 4) | (h - 1));
+          nrects++;
+
+          for (i = 0; i < h; i++)
+            {
+              covered[y + i] |= mask;
+            }
+
+          x += w - 1;
+        }
+    }
+
+  *start     = subenc;
+  *nsubrects = (uint8_t)nrects;
+  hx->dest   = dest;
+
+  /* The foreground carries over only if it was used for the tile */
+
+  if (mono)
+    {
+      hx->fg      = fg;
+      hx->fgvalid = true;
+    }
+  else
+    {
+      hx->fgvalid = false;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR const lfb_color_t *tile;
+  FAR uint8_t *end;
+  struct vnc_hextile_s hx;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  unsigned int tilew;
+  unsigned int tileh;
+  size_t nbytes;
+  int ret;
+
+  /* Check if the client supports the Hextile encoding */
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  /* Set up characteristics of the client pixel format to use on this
+   * update.  The whole rectangle is sent in the same format, even if a
+   * SetPixelFormat is received asynchronously.
+   */
+
+  hx.session       = session;
+  hx.bytesperpixel = (session->bpp + 7) >> 3;
+  hx.bigendian     = session->bigendian;
+  hx.bgvalid       = false;
+  hx.fgvalid       = false;
+
+  /* The output buffer must hold the headers and one raw tile */
+
+  if (HEXTILE_HDRSIZE + HEXTILE_MAXSIZE(hx.bytesperpixel) >
+      VNCSERVER_UPDATE_BUFSIZE)
+    {
+      return 0;
+    }
+
+  switch (session->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        hx.convert.bpp8 = vnc_convert_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        hx.convert.bpp8 = vnc_convert_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        hx.convert.bpp16 = vnc_convert_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        hx.convert.bpp16 = vnc_convert_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+        hx.convert.bpp32 = vnc_convert_rgb32_888;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  DEBUGASSERT(rect->pt1.x <= rect->pt2.x && rect->pt1.y <= rect->pt2.y);
+  width  = rect->pt2.x - rect->pt1.x + 1;
+  height = rect->pt2.y - rect->pt1.y + 1;
+
+  /* Format the FrameBuffer Update with a single Hextile rectangle */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos,   rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos,   rect->pt1.y);
+  rfb_putbe16(update->rect[0].width,  width);
+  rfb_putbe16(update->rect[0].height, height);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  hx.dest = update->rect[0].data;
+  end     = session->outbuf + VNCSERVER_UPDATE_BUFSIZE;
+  nbytes  = 0;
+
+  /* Encode the tiles from left to right, top to bottom.  Send the output
+   * buffer whenever there may not be room for the next tile.
+   */
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += HEXTILE_SIZE)
+    {
+      tileh = MIN(HEXTILE_SIZE, rect->pt2.y - y + 1);
+
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += HEXTILE_SIZE)
+        {
+          tilew = MIN(HEXTILE_SIZE, rect->pt2.x - x + 1);
+
+          if (hx.dest + HEXTILE_MAXSIZE(hx.bytesperpixel) > end)
+            {
+              nbytes += hx.dest - session->outbuf;
+
+              ret = vnc_hextile_flush(&hx);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          tile = (FAR const lfb_color_t *)
+            (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+          vnc_hextile_tile(&hx, tile, tilew, tileh);
+        }
+    }
+
+  nbytes += hx.dest - session->outbuf;
+
+  ret = vnc_hextile_flush(&hx);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return (int)nbytes;
+}
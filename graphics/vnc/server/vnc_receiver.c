@@ -470,6 +470,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  session->hextile = false;
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  session->copyrect = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -486,6 +492,18 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      else if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      else if (encoding == RFB_ENCODING_COPYRECT)
+        {
+          session->copyrect = true;
+        }
+#endif
     }
 
   session->change = true;
@@ -231,6 +231,10 @@ struct vnc_fbupdate_s
 {
   FAR struct vnc_fbupdate_s *flink;
   bool whupd;                  /* True: whole screen update */
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  bool copy;                   /* True: rect is copied from srcpos */
+  struct nxgl_point_s srcpos;  /* Source position of the copied rectangle */
+#endif
   struct nxgl_rect_s rect;     /* The enqueued update rectangle */
 };
 
@@ -251,6 +255,12 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  volatile bool copyrect;      /* True: Remote supports CopyRect encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -268,6 +278,9 @@ struct vnc_session_s
   struct vnc_fbupdate_s updpool[CONFIG_VNCSERVER_NUPDATES];
   sq_queue_t updfree;
   sq_queue_t updqueue;
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  FAR struct vnc_fbupdate_s *inflight; /* The update being sent */
+#endif
   sem_t freesem;
   sem_t queuesem;
 
@@ -459,6 +472,32 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                          FAR const struct nxgl_rect_s *rect,
                          bool change);
 
+/****************************************************************************
+ * Name: vnc_copy_rectangle
+ *
+ * Description:
+ *  Queue a copy of a rectangular region that was moved on the display.  If
+ *  the client does not support the CopyRect encoding or if its copy of the
+ *  source region is not current, the destination region is queued as a
+ *  normal update instead.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The source region of the move.
+ *   offset  - The offset that was applied to the source region.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copy_rectangle(FAR struct vnc_session_s *session,
+                       FAR const struct nxgl_rect_s *rect,
+                       FAR const struct nxgl_point_s *offset);
+#endif
+
 /****************************************************************************
  * Name: vnc_receiver
  *
@@ -518,6 +557,56 @@ int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
 int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_copyrect
+ *
+ * Description:
+ *  Send the framebuffer update using the CopyRect encoding:  The client
+ *  copies the rectangle from another position of its framebuffer.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the destination rectangle.
+ *   srcpos  - The upper left position of the source rectangle.
+ *
+ * Returned Value:
+ *   Zero is returned if CopyRect coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copyrect(FAR struct vnc_session_s *session,
+                 FAR struct nxgl_rect_s *rect,
+                 FAR struct nxgl_point_s *srcpos);
+#endif
+
 /****************************************************************************
  * Name: vnc_key_map
  *
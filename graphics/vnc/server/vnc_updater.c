@@ -340,6 +340,12 @@ vnc_remove_queue(FAR struct vnc_session_s *session)
       updinfo("Whole screen update: nwhupd=%d\n", session->nwhupd);
     }
 
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  /* Remember the update being sent.  See vnc_copy_rectangle(). */
+
+  session->inflight = rect;
+#endif
+
   sched_unlock();
   return rect;
 }
@@ -385,6 +391,82 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_area
+ *
+ * Description:
+ *   Return the number of pixels in a rectangle.
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_area(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Try to merge a new update rectangle into an update that is already
+ *   queued.  That is done if the bounding rectangle of both has no more
+ *   pixels then the two rectangles together, for example, if one contains
+ *   the other or if they are adjacent.  This reduces the number of
+ *   FramebufferUpdate messages when an area is redrawn many times before
+ *   the updater gets to it.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The new update rectangle.
+ *
+ * Returned Value:
+ *   True is returned if the rectangle was merged into a queued update.
+ *
+ * Assumptions:
+ *   The scheduler is locked and there is no whole screen update queued.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct vnc_fbupdate_s *curr;
+  FAR struct vnc_fbupdate_s *start;
+  struct nxgl_rect_s bounds;
+
+  start = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  /* An update must not be sent before a copy that was queued ahead of it.
+   * The copy could overwrite the updated region.
+   */
+
+  for (curr = start; curr != NULL; curr = curr->flink)
+    {
+      if (curr->copy)
+        {
+          start = curr->flink;
+        }
+    }
+#endif
+
+  for (curr = start; curr != NULL; curr = curr->flink)
+    {
+      nxgl_rectunion(&bounds, &curr->rect, rect);
+      if (vnc_area(&bounds) <= vnc_area(&curr->rect) + vnc_area(rect))
+        {
+          nxgl_rectcopy(&curr->rect, &bounds);
+
+          updinfo("Merged {(%d, %d),(%d, %d)}\n",
+                  bounds.pt1.x, bounds.pt1.y, bounds.pt2.x, bounds.pt2.y);
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -428,9 +510,33 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
+      ret = 0;
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      /* Use the CopyRect encoding for regions moved on the display */
+
+      if (srcrect->copy)
+        {
+          ret = vnc_copyrect(session, &srcrect->rect, &srcrect->srcpos);
+        }
+#endif
+
       /* Attempt to use RRE encoding */
 
-      ret = vnc_rre(session, &srcrect->rect);
+      if (ret == 0)
+        {
+          ret = vnc_rre(session, &srcrect->rect);
+        }
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      /* Then the Hextile encoding */
+
+      if (ret == 0)
+        {
+          ret = vnc_hextile(session, &srcrect->rect);
+        }
+#endif
+
       if (ret == 0)
         {
           /* Perform the framebuffer update using the default RAW encoding */
@@ -440,6 +546,9 @@ static FAR void *vnc_updater(FAR void *arg)
 
       /* Release the update structure */
 
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      session->inflight = NULL;
+#endif
       vnc_free_update(session, srcrect);
 
       /* Break out and terminate the server if the encoding failed */
@@ -641,6 +750,14 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Merge the rectangle into a queued update if possible */
+
+              if (vnc_merge_queue(session, &intersection))
+                {
+                  sched_unlock();
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
@@ -651,6 +768,9 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
           /* Copy the clipped rectangle into the update structure */
 
           update->whupd = whupd;
+#ifdef CONFIG_VNCSERVER_COPYRECT
+          update->copy  = false;
+#endif
           nxgl_rectcopy(&update->rect, &intersection);
 
           /* Add the update to the end of the update queue. */
@@ -671,3 +791,116 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_copy_rectangle
+ *
+ * Description:
+ *  Queue a copy of a rectangular region that was moved on the display.  If
+ *  the client does not support the CopyRect encoding or if its copy of the
+ *  source region is not current, the destination region is queued as a
+ *  normal update instead.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The source region of the move.
+ *   offset  - The offset that was applied to the source region.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copy_rectangle(FAR struct vnc_session_s *session,
+                       FAR const struct nxgl_rect_s *rect,
+                       FAR const struct nxgl_point_s *offset)
+{
+  FAR struct vnc_fbupdate_s *update;
+  FAR struct vnc_fbupdate_s *curr;
+  struct nxgl_rect_s dest;
+  struct nxgl_rect_s src;
+
+  /* Clip the destination rectangle to the screen dimensions and get the
+   * matching source rectangle.
+   */
+
+  nxgl_rectoffset(&src, rect, offset->x, offset->y);
+  nxgl_rectintersect(&dest, &src, &g_wholescreen);
+  if (nxgl_nullrect(&dest))
+    {
+      return OK;
+    }
+
+  nxgl_rectoffset(&src, &dest, -offset->x, -offset->y);
+
+  /* Does the client support the CopyRect encoding? */
+
+  if (!session->copyrect)
+    {
+      return vnc_update_rectangle(session, &dest, true);
+    }
+
+  sched_lock();
+
+  /* Ignore the copy if there is a queued whole screen update */
+
+  if (session->nwhupd > 0)
+    {
+      sched_unlock();
+      return OK;
+    }
+
+  /* The client copies the source region from its framebuffer.  An update
+   * of the source region that is queued or being sent would send the
+   * source region as it is after the move, i.e. too early.  Then send the
+   * destination region as a normal update instead.
+   */
+
+  curr = session->inflight;
+  if (curr != NULL && !curr->copy && nxgl_rectoverlap(&curr->rect, &src))
+    {
+      goto send_update;
+    }
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL;
+       curr = curr->flink)
+    {
+      if (!curr->copy && nxgl_rectoverlap(&curr->rect, &src))
+        {
+          goto send_update;
+        }
+    }
+
+  /* The framebuffer content has changed */
+
+  session->change = true;
+
+  /* Allocate an update structure... waiting if necessary */
+
+  update = vnc_alloc_update(session);
+  DEBUGASSERT(update != NULL);
+
+  update->whupd    = false;
+  update->copy     = true;
+  update->srcpos.x = src.pt1.x;
+  update->srcpos.y = src.pt1.y;
+  nxgl_rectcopy(&update->rect, &dest);
+
+  /* Add the copy to the end of the update queue. */
+
+  vnc_add_queue(session, update);
+  sched_unlock();
+
+  updinfo("Queued copy (%d, %d) to {(%d, %d),(%d, %d)}\n",
+          src.pt1.x, src.pt1.y, dest.pt1.x, dest.pt1.y,
+          dest.pt2.x, dest.pt2.y);
+  return OK;
+
+send_update:
+  sched_unlock();
+  return vnc_update_rectangle(session, &dest, true);
+}
+#endif
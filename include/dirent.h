@@ -133,6 +133,8 @@ int        readdir_r(FAR DIR *dirp, FAR struct dirent *entry,
 void       rewinddir(FAR DIR *dirp);
 void       seekdir(FAR DIR *dirp, off_t loc);
 off_t      telldir(FAR DIR *dirp);
+ssize_t    getdents(FAR DIR *dirp, FAR struct dirent *entries,
+                    size_t nbytes);
 int        scandir(FAR const char *path, FAR struct dirent ***namelist,
                    CODE int (*filter)(FAR const struct dirent *),
                    CODE int (*compar)(FAR const struct dirent **,
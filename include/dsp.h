@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/dsp.h
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Mateusz Szafoni <raiden00@railab.me>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -46,6 +46,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
+#include <fixedmath.h>
 
 #include <assert.h>
 
@@ -88,6 +89,11 @@
 #define ONE_BY_SQRT3_F     (0.57735f)
 #define TWO_BY_SQRT3_F     (1.15470f)
 
+#define SQRT3_BY_TWO_B16   ftob16(SQRT3_BY_TWO_F)
+#define SQRT3_BY_THREE_B16 ftob16(SQRT3_BY_THREE_F)
+#define ONE_BY_SQRT3_B16   ftob16(ONE_BY_SQRT3_F)
+#define TWO_BY_SQRT3_B16   ftob16(TWO_BY_SQRT3_F)
+
 /* Some lib constants **********************************************************/
 
 /* Motor electrical angle is in range 0.0 to 2*PI */
@@ -145,6 +151,7 @@
  ****************************************************************************/
 
 #define SVM3_BASE_VOLTAGE_GET(vbus) (vbus * SQRT3_BY_THREE_F)
+#define SVM3_BASE_VOLTAGE_GET_B16(vbus) b16mulb16(vbus, SQRT3_BY_THREE_B16)
 
 /****************************************************************************
  * Public Types
@@ -372,6 +379,102 @@ struct foc_data_s
   float vab_mod_scale;       /* Voltage alpha-beta modulation scale */
 };
 
+/* Fixed-point (b16_t) variants of the types above.  These are intended for
+ * MCUs without an FPU.  The fields have the same meaning as in the float
+ * types.
+ */
+
+struct phase_angle_b16_s
+{
+  b16_t   angle;               /* Phase angle in radians <0, 2PI> */
+  b16_t   sin;                 /* Phase angle sine */
+  b16_t   cos;                 /* Phase angle cosine */
+};
+
+typedef struct phase_angle_b16_s phase_angle_b16_t;
+
+struct b16_sat_s
+{
+  b16_t min;                    /* Lower limit */
+  b16_t max;                    /* Upper limit */
+};
+
+typedef struct b16_sat_s b16_sat_t;
+
+struct pid_controller_b16_s
+{
+  b16_t       out;              /* Controller output */
+  b16_sat_t   sat;              /* Output saturation */
+  b16_t       err;              /* Current error value */
+  b16_t       err_prev;         /* Previous error value */
+  b16_t       KP;               /* Proportional coefficient */
+  b16_t       KI;               /* Integral coefficient */
+  b16_t       KD;               /* Derivative coefficient */
+  b16_t       part[3];          /* 0 - proporitonal part
+                                 * 1 - integral part
+                                 * 2 - derivative part
+                                 */
+};
+
+typedef struct pid_controller_b16_s pid_controller_b16_t;
+
+struct abc_frame_b16_s
+{
+  b16_t a;                     /* A component */
+  b16_t b;                     /* B component */
+  b16_t c;                     /* C component */
+};
+
+typedef struct abc_frame_b16_s abc_frame_b16_t;
+
+struct ab_frame_b16_s
+{
+  b16_t a;                     /* Alpha component */
+  b16_t b;                     /* Beta component */
+};
+
+typedef struct ab_frame_b16_s ab_frame_b16_t;
+
+struct dq_frame_b16_s
+{
+  b16_t d;                     /* Driect component */
+  b16_t q;                     /* Quadrature component */
+};
+
+typedef struct dq_frame_b16_s dq_frame_b16_t;
+
+struct svm3_state_b16_s
+{
+  uint8_t     sector;          /* Current space vector sector */
+  b16_t       d_u;             /* Duty cycle for phase U */
+  b16_t       d_v;             /* Duty cycle for phase V */
+  b16_t       d_w;             /* Duty cycle for phase W */
+  b16_t       d_max;           /* Duty cycle max */
+  b16_t       d_min;           /* Duty cycle min */
+};
+
+struct foc_data_b16_s
+{
+  abc_frame_b16_t  v_abc;    /* Voltage in ABC frame */
+  ab_frame_b16_t   v_ab;     /* Voltage in alpha-beta frame */
+  dq_frame_b16_t   v_dq;     /* Voltage in dq frame */
+  ab_frame_b16_t   v_ab_mod; /* Modulation voltage normalized to
+                              * magnitude (0.0, 1.0)
+                              */
+
+  abc_frame_b16_t  i_abc;    /* Current in ABC frame */
+  ab_frame_b16_t   i_ab;     /* Current in apha-beta frame*/
+  dq_frame_b16_t   i_dq;     /* Current in dq frame */
+  dq_frame_b16_t   i_dq_err; /* DQ current error */
+
+  dq_frame_b16_t   i_dq_ref; /* Current dq reference frame */
+  pid_controller_b16_t id_pid; /* Current d-axis component PI controller */
+  pid_controller_b16_t iq_pid; /* Current q-axis component PI controller */
+
+  b16_t vdq_mag_max;         /* Maximum dq voltage magnitude */
+  b16_t vab_mod_scale;       /* Voltage alpha-beta modulation scale */
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -401,6 +504,9 @@ void vector2d_saturate(FAR float *x, FAR float *y, float max);
 void dq_saturate(FAR dq_frame_t *dq, float max);
 float dq_mag(FAR dq_frame_t *dq);
 
+void lp_filter_n(FAR float *val, FAR const float *in, FAR float *out,
+                 float filter, int n);
+
 /* PID controller functions */
 
 void pid_controller_init(FAR pid_controller_t *pid,
@@ -423,6 +529,24 @@ void park_transform(FAR phase_angle_t *angle, FAR ab_frame_t *ab,
 void inv_park_transform(FAR phase_angle_t *angle, FAR dq_frame_t *dq,
                         FAR ab_frame_t *ab);
 
+/* Multi-channel transformation functions.  These process n channels (for
+ * example n motors) per call.  Each component is passed as a separate
+ * array (structure-of-arrays), so the loops are free of strided accesses
+ * and can be vectorized by the compiler.
+ */
+
+void clarke_transform_n(FAR const float *a, FAR const float *b,
+                        FAR float *alpha, FAR float *beta, int n);
+void inv_clarke_transform_n(FAR const float *alpha, FAR const float *beta,
+                            FAR float *a, FAR float *b, FAR float *c,
+                            int n);
+void park_transform_n(FAR const float *sin, FAR const float *cos,
+                      FAR const float *alpha, FAR const float *beta,
+                      FAR float *d, FAR float *q, int n);
+void inv_park_transform_n(FAR const float *sin, FAR const float *cos,
+                          FAR const float *d, FAR const float *q,
+                          FAR float *alpha, FAR float *beta, int n);
+
 /* Phase angle related functions */
 
 void angle_norm(FAR float *angle, float per, float bottom, float top);
@@ -465,6 +589,19 @@ void motor_sobserver_div_init(FAR struct motor_sobserver_div_s *so,
 void motor_sobserver_div(FAR struct motor_observer_s *o,
                          float angle, float dir);
 
+/* Block processing versions of the observers.  These process n
+ * consecutive samples per call with the coefficients computed once per
+ * block.
+ */
+
+void motor_observer_smo_n(FAR struct motor_observer_s *o,
+                          FAR const ab_frame_t *i_ab,
+                          FAR const ab_frame_t *v_ab,
+                          FAR struct motor_phy_params_s *phy, float dir,
+                          FAR float *angle, int n);
+void motor_sobserver_div_n(FAR struct motor_observer_s *o,
+                           FAR const float *angle, float dir, int n);
+
 /* Motor openloop control */
 
 void motor_openloop_init(FAR struct openloop_data_s *op,
@@ -489,6 +626,72 @@ void motor_phy_params_init(FAR struct motor_phy_params_s *phy, uint8_t poles,
 void motor_phy_params_temp_set(FAR struct motor_phy_params_s *phy,
                                float res_alpha, float res_temp_ref);
 
+/* Fixed-point (b16_t) math functions */
+
+void b16_saturate(FAR b16_t *val, b16_t min, b16_t max);
+
+b16_t vector2d_mag_b16(b16_t x, b16_t y);
+void vector2d_saturate_b16(FAR b16_t *x, FAR b16_t *y, b16_t max);
+
+void dq_saturate_b16(FAR dq_frame_b16_t *dq, b16_t max);
+b16_t dq_mag_b16(FAR dq_frame_b16_t *dq);
+
+void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top);
+void angle_norm_2pi_b16(FAR b16_t *angle, b16_t bottom, b16_t top);
+void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val);
+
+/* Fixed-point (b16_t) PID controller functions */
+
+void pid_controller_init_b16(FAR pid_controller_b16_t *pid,
+                             b16_t KP, b16_t KI, b16_t KD);
+void pi_controller_init_b16(FAR pid_controller_b16_t *pid,
+                            b16_t KP, b16_t KI);
+void pid_saturation_set_b16(FAR pid_controller_b16_t *pid,
+                            b16_t min, b16_t max);
+void pi_saturation_set_b16(FAR pid_controller_b16_t *pid,
+                           b16_t min, b16_t max);
+void pid_integral_reset_b16(FAR pid_controller_b16_t *pid);
+void pi_integral_reset_b16(FAR pid_controller_b16_t *pid);
+b16_t pi_controller_b16(FAR pid_controller_b16_t *pid, b16_t err);
+b16_t pid_controller_b16(FAR pid_controller_b16_t *pid, b16_t err);
+
+/* Fixed-point (b16_t) transformation functions */
+
+void clarke_transform_b16(FAR abc_frame_b16_t *abc, FAR ab_frame_b16_t *ab);
+void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
+                              FAR abc_frame_b16_t *abc);
+void park_transform_b16(FAR phase_angle_b16_t *angle,
+                        FAR ab_frame_b16_t *ab, FAR dq_frame_b16_t *dq);
+void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
+                            FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
+
+void clarke_transform_n_b16(FAR const b16_t *a, FAR const b16_t *b,
+                            FAR b16_t *alpha, FAR b16_t *beta, int n);
+void park_transform_n_b16(FAR const b16_t *sin, FAR const b16_t *cos,
+                          FAR const b16_t *alpha, FAR const b16_t *beta,
+                          FAR b16_t *d, FAR b16_t *q, int n);
+void inv_park_transform_n_b16(FAR const b16_t *sin, FAR const b16_t *cos,
+                              FAR const b16_t *d, FAR const b16_t *q,
+                              FAR b16_t *alpha, FAR b16_t *beta, int n);
+
+/* Fixed-point (b16_t) 3-phase system space vector modulation */
+
+void svm3_init_b16(FAR struct svm3_state_b16_s *s, b16_t min, b16_t max);
+void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *ab);
+void svm3_current_correct_b16(FAR struct svm3_state_b16_s *s,
+                              int32_t *c0, int32_t *c1, int32_t *c2);
+
+/* Fixed-point (b16_t) Field Oriented control */
+
+void foc_vbase_update_b16(FAR struct foc_data_b16_s *foc, b16_t vbase);
+void foc_idq_ref_set_b16(FAR struct foc_data_b16_s *data, b16_t d, b16_t q);
+
+void foc_init_b16(FAR struct foc_data_b16_s *data,
+                  b16_t id_kp, b16_t id_ki, b16_t iq_kp, b16_t iq_ki);
+void foc_process_b16(FAR struct foc_data_b16_s *foc,
+                     FAR abc_frame_b16_t *i_abc,
+                     FAR phase_angle_b16_t *angle);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
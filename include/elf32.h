@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/elf32.h
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Reference: System V Application Binary Interface, Edition 4.1, March 18,
@@ -165,6 +165,7 @@
 #define SHF_WRITE          1
 #define SHF_ALLOC          2
 #define SHF_EXECINSTR      4
+#define SHF_TLS            0x400
 #define SHF_MASKPROC       0xf0000000
 
 /* Definitions for Elf32_Sym::st_info */
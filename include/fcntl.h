@@ -92,6 +92,13 @@
 
 #define FFCNTL      (FNONBLOCK | FNDELAY | FAPPEND | FSYNC | FASYNC)
 
+/* splice(), tee() and vmsplice() flags */
+
+#define SPLICE_F_MOVE     (1 << 0) /* Ignored: Data is always moved */
+#define SPLICE_F_NONBLOCK (1 << 1) /* Do not wait on the pipe */
+#define SPLICE_F_MORE     (1 << 2) /* Ignored: More data will follow */
+#define SPLICE_F_GIFT     (1 << 3) /* Ignored */
+
 /* fcntl() commands */
 
 #define F_DUPFD     0  /* Duplicate a file descriptor */
@@ -109,6 +116,8 @@
 #define F_SETLKW    12 /* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13 /* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14 /* Set the signal to be sent */
+#define F_SETPIPE_SZ 15 /* Set the capacity of the pipe (linux) */
+#define F_GETPIPE_SZ 16 /* Get the capacity of the pipe (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -172,6 +181,16 @@ extern "C"
 
 int open(const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
+int posix_fallocate(int fd, off_t offset, off_t len);
+
+/* Zero-copy data movement through pipes (Linux) */
+
+struct iovec;
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, unsigned long nr_segs,
+                 unsigned int flags);
 
 #undef EXTERN
 #if defined(__cplusplus)
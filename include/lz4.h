@@ -0,0 +1,171 @@
+/****************************************************************************
+ * include/lz4.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_LZ4_H
+#define __INCLUDE_LZ4_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_LIBC_LZ4
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest block that lz4_compress() accepts.  The hash table holds
+ * 16-bit positions so that it stays small.
+ */
+
+#define LZ4_MAX_INPUT_SIZE 65535
+
+/* Worst-case size of the compressed data (block and frame formats) */
+
+#define LZ4_COMPRESSBOUND(n)       ((n) + (n) / 255 + 16)
+#define LZ4_FRAME_COMPRESSBOUND(n) ((n) + 4 * ((n) / 65536 + 1) + 15)
+
+/* Frame format magic numbers */
+
+#define LZ4_FRAME_MAGIC            0x184d2204
+#define LZ4_SKIPPABLE_MAGIC        0x184d2a50  /* 0x184d2a50-0x184d2a5f */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* LZ4 compression hash table.  It is only needed for compression. */
+
+typedef uint16_t lz4_state_t[1 << CONFIG_LIBC_LZ4_HLOG];
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress in_len (up to LZ4_MAX_INPUT_SIZE) bytes at in_data into an LZ4
+ *   block at out_data of up to out_len bytes.  The output buffer is large
+ *   enough if it holds LZ4_COMPRESSBOUND(in_len) bytes.
+ *
+ * Returned Value:
+ *   The size of the compressed block or zero if it does not fit into the
+ *   output buffer (errno is set to E2BIG) or in_len is too large (errno is
+ *   set to EINVAL).
+ *
+ ****************************************************************************/
+
+size_t lz4_compress(FAR const void *in_data, size_t in_len,
+                    FAR void *out_data, size_t out_len, lz4_state_t htab);
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress the LZ4 block of in_len bytes at in_data into out_data, up to
+ *   a maximum of out_len bytes.  The input is fully validated.
+ *
+ * Returned Value:
+ *   The number of decompressed bytes.  If the output buffer is too small, a
+ *   zero is returned and errno is set to E2BIG.  If the block is corrupted,
+ *   a zero is returned and errno is set to EINVAL.
+ *
+ ****************************************************************************/
+
+size_t lz4_decompress(FAR const void *in_data, size_t in_len,
+                      FAR void *out_data, size_t out_len);
+
+/****************************************************************************
+ * Name: lz4_frame_compress
+ *
+ * Description:
+ *   Compress in_len bytes at in_data into an LZ4 frame (as produced by the
+ *   lz4 command line tool) with independent 64Kb blocks and a content
+ *   checksum.  The output buffer is large enough if it holds
+ *   LZ4_FRAME_COMPRESSBOUND(in_len) bytes.
+ *
+ * Returned Value:
+ *   The size of the frame or zero if it does not fit into the output buffer
+ *   (errno is set to E2BIG).
+ *
+ ****************************************************************************/
+
+size_t lz4_frame_compress(FAR const void *in_data, size_t in_len,
+                          FAR void *out_data, size_t out_len,
+                          lz4_state_t htab);
+
+/****************************************************************************
+ * Name: lz4_frame_decompress
+ *
+ * Description:
+ *   Decompress the LZ4 frames (and skip any skippable frames) in the in_len
+ *   bytes at in_data into out_data, up to a maximum of out_len bytes.
+ *   Linked blocks and all optional checksums are supported; dictionaries
+ *   are not.
+ *
+ * Returned Value:
+ *   The number of decompressed bytes.  If the output buffer is too small, a
+ *   zero is returned and errno is set to E2BIG.  If the input is corrupted
+ *   or a checksum does not match, a zero is returned and errno is set to
+ *   EINVAL.
+ *
+ ****************************************************************************/
+
+size_t lz4_frame_decompress(FAR const void *in_data, size_t in_len,
+                            FAR void *out_data, size_t out_len);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LIBC_LZ4 */
+#endif /* __INCLUDE_LZ4_H */
@@ -31,6 +31,16 @@
 #ifndef __INCLUDE_LZF_H
 #define __INCLUDE_LZF_H 1
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -47,6 +57,14 @@
 #define LZF_MAX_HDR_SIZE   7
 #define LZF_MIN_HDR_SIZE   5
 
+/* Size of the buffers that must be provided to the streaming encoder and
+ * decoder for a given maximum block size.
+ */
+
+#define LZF_ENCODER_BUFSIZE(bs) \
+  (LZF_TYPE0_HDR_SIZE + LZF_TYPE1_HDR_SIZE + 2 * (bs))
+#define LZF_DECODER_BUFSIZE(bs) (2 * (bs))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -86,6 +104,42 @@ struct lzf_type1_header_s   /* Compressed data header */
 
 typedef lzf_hslot_t lzf_state_t[1 << HLOG];
 
+/* Streaming encoder.  The input is collected into blocks of up to
+ * 'blocksize' bytes.  Each block is compressed with lzf_compress() and
+ * output with its LZF header, so the output is a sequence of "ZV" blocks
+ * that can also be decompressed block-by-block with lzf_decompress().
+ * All memory is provided by the caller.
+ */
+
+struct lzf_encoder_s
+{
+  FAR lzf_hslot_t *htab;      /* Hash table provided by the caller */
+  FAR uint8_t *ibuf;          /* Input block, preceded by header space */
+  FAR uint8_t *obuf;          /* Compressed block, preceded by header space */
+  FAR const uint8_t *outptr;  /* Next byte of the pending output block */
+  size_t outlen;              /* Bytes of the pending output block left */
+  uint16_t blocksize;         /* Maximum uncompressed block size */
+  uint16_t ilen;              /* Number of bytes in the input block */
+};
+
+/* Streaming decoder for a sequence of "ZV" blocks of up to 'blocksize'
+ * uncompressed bytes each.
+ */
+
+struct lzf_decoder_s
+{
+  FAR uint8_t *cbuf;          /* Compressed block being collected */
+  FAR uint8_t *ubuf;          /* Decompressed block */
+  FAR const uint8_t *outptr;  /* Next byte of pending decompressed data */
+  uint16_t blocksize;         /* Maximum uncompressed block size */
+  uint16_t outlen;            /* Pending decompressed bytes */
+  uint16_t clen;              /* Payload length of the current block */
+  uint16_t ulen;              /* Uncompressed length of the current block */
+  uint16_t nbytes;            /* Header or payload bytes collected */
+  uint8_t state;              /* See enum lzf_decstate_e in lzf_stream.c */
+  uint8_t hdr[LZF_MAX_HDR_SIZE]; /* Header being collected */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -150,4 +204,77 @@ unsigned int lzf_decompress(FAR const void *const in_data,
                             unsigned int in_len, FAR void *out_data,
                             unsigned int out_len);
 
+/****************************************************************************
+ * Name: lzf_encoder_init
+ *
+ * Description:
+ *   Initialize a streaming encoder.
+ *
+ * Input Parameters:
+ *   enc       - The encoder to be initialized
+ *   htab      - The hash table used by lzf_compress()
+ *   buffer    - Working memory of LZF_ENCODER_BUFSIZE(blocksize) bytes
+ *   blocksize - The maximum uncompressed size of each block (1..65535)
+ *
+ ****************************************************************************/
+
+void lzf_encoder_init(FAR struct lzf_encoder_s *enc, lzf_state_t htab,
+                      FAR void *buffer, uint16_t blocksize);
+
+/****************************************************************************
+ * Name: lzf_encode
+ *
+ * Description:
+ *   Compress data from 'in' to 'out'.  On entry, *inlen holds the number of
+ *   bytes available at 'in'; on return, the number of bytes that were
+ *   consumed.  The input is buffered until a block is full.  If 'flush' is
+ *   true and all of the input was consumed, the partial block is output
+ *   too.  The caller must call again (with more output space) until all of
+ *   the input is consumed and no further output is returned.
+ *
+ * Returned Value:
+ *   The number of bytes written to 'out'.
+ *
+ ****************************************************************************/
+
+size_t lzf_encode(FAR struct lzf_encoder_s *enc, FAR const void *in,
+                  FAR size_t *inlen, FAR void *out, size_t outlen,
+                  bool flush);
+
+/****************************************************************************
+ * Name: lzf_decoder_init
+ *
+ * Description:
+ *   Initialize a streaming decoder.
+ *
+ * Input Parameters:
+ *   dec       - The decoder to be initialized
+ *   buffer    - Working memory of LZF_DECODER_BUFSIZE(blocksize) bytes
+ *   blocksize - The maximum uncompressed size of each block (1..65535)
+ *
+ ****************************************************************************/
+
+void lzf_decoder_init(FAR struct lzf_decoder_s *dec, FAR void *buffer,
+                      uint16_t blocksize);
+
+/****************************************************************************
+ * Name: lzf_decode
+ *
+ * Description:
+ *   Decompress data from 'in' to 'out'.  On entry, *inlen holds the number
+ *   of bytes available at 'in'; on return, the number of bytes that were
+ *   consumed.  Input may be provided in pieces of any size.  Once all of
+ *   the input is consumed, the caller should call again with no new input
+ *   until no further output is returned.
+ *
+ * Returned Value:
+ *   The number of bytes written to 'out' or a negated errno value:
+ *   -EINVAL if the input is not a valid LZF stream or -E2BIG if a block is
+ *   larger than the block size of the decoder.
+ *
+ ****************************************************************************/
+
+ssize_t lzf_decode(FAR struct lzf_decoder_s *dec, FAR const void *in,
+                   FAR size_t *inlen, FAR void *out, size_t outlen);
+
 #endif /* __INCLUDE_LZF_H */
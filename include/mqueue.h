@@ -68,6 +68,16 @@ struct mq_attr
 
 typedef FAR struct mq_des *mqd_t;
 
+/* Describes one message received by the non-standard mq_receive_batch() */
+
+struct mq_rcvbatch_s
+{
+  FAR char      *msg;    /* Buffer to receive the message */
+  size_t         msglen; /* Size of the buffer in bytes */
+  ssize_t        rcvlen; /* Returned: The length of the message */
+  unsigned int   prio;   /* Returned: The priority of the message */
+};
+
 /********************************************************************************
  * Public Data
  ********************************************************************************/
@@ -101,6 +111,19 @@ int     mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat,
                    FAR struct mq_attr *oldstat);
 int     mq_getattr(mqd_t mqdes, FAR struct mq_attr *mq_stat);
 
+/* Non-standard interfaces */
+
+int     mq_receive_batch(mqd_t mqdes, FAR struct mq_rcvbatch_s *batch,
+                         int nbatch);
+
+#ifdef CONFIG_MQ_ZEROCOPY
+FAR void *mq_zcalloc(size_t size);
+void    mq_zcfree(FAR void *buf);
+int     mq_send_zc(mqd_t mqdes, FAR void *buf, size_t msglen,
+                   unsigned int prio);
+ssize_t mq_receive_zc(mqd_t mqdes, FAR void **buf, FAR unsigned int *prio);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
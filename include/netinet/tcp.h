@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -69,4 +70,93 @@
 #define TCP_KEEPCNT   (__SO_PROTOCOL + 3) /* Number of keepalives before death
                                            * Argument: max retry count */
 
+/* TCP protocol socket operation to select the congestion control: */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 4) /* Congestion control algorithm
+                                            * Argument: name string */
+
+/* TCP protocol socket operation to disable delayed ACKs: */
+
+#define TCP_QUICKACK  (__SO_PROTOCOL + 5) /* ACK every segment at once.
+                                           * Argument: int */
+
+/* TCP protocol socket operation to get the connection statistics: */
+
+#define TCP_INFO      (__SO_PROTOCOL + 6) /* Get connection information.
+                                           * Argument: struct tcp_info */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The TCP_INFO option returns this structure.  The layout follows Linux so
+ * that monitoring tools can be ported, but only some of the fields are
+ * maintained by NuttX; the remaining fields are zero.  The result is
+ * truncated to the size of the caller's buffer.
+ *
+ *   tcpi_state       - The NuttX TCP state (TCP_ESTABLISHED, etc.)
+ *   tcpi_retransmits - The number of retransmissions of the last segment
+ *   tcpi_rto         - Retransmission time-out (microseconds)
+ *   tcpi_snd_mss     - Maximum segment size
+ *   tcpi_unacked     - Bytes sent but not yet ACKed
+ *   tcpi_rtt         - Smoothed round trip time (microseconds)
+ *   tcpi_rttvar      - Round trip time variation (microseconds)
+ *   tcpi_snd_ssthresh, tcpi_snd_cwnd - Congestion control state (bytes)
+ *   tcpi_total_retrans - Total number of retransmitted segments
+ *   tcpi_bytes_acked - Bytes sent and ACKed by the peer
+ *   tcpi_bytes_received - In-sequence bytes received from the peer
+ *   tcpi_segs_out, tcpi_segs_in - Total number of segments sent/received
+ */
+
+struct tcp_info
+{
+  uint8_t  tcpi_state;
+  uint8_t  tcpi_ca_state;
+  uint8_t  tcpi_retransmits;
+  uint8_t  tcpi_probes;
+  uint8_t  tcpi_backoff;
+  uint8_t  tcpi_options;
+  uint8_t  tcpi_snd_wscale : 4;
+  uint8_t  tcpi_rcv_wscale : 4;
+
+  uint32_t tcpi_rto;
+  uint32_t tcpi_ato;
+  uint32_t tcpi_snd_mss;
+  uint32_t tcpi_rcv_mss;
+
+  uint32_t tcpi_unacked;
+  uint32_t tcpi_sacked;
+  uint32_t tcpi_lost;
+  uint32_t tcpi_retrans;
+  uint32_t tcpi_fackets;
+
+  uint32_t tcpi_last_data_sent;
+  uint32_t tcpi_last_ack_sent;
+  uint32_t tcpi_last_data_recv;
+  uint32_t tcpi_last_ack_recv;
+
+  uint32_t tcpi_pmtu;
+  uint32_t tcpi_rcv_ssthresh;
+  uint32_t tcpi_rtt;
+  uint32_t tcpi_rttvar;
+  uint32_t tcpi_snd_ssthresh;
+  uint32_t tcpi_snd_cwnd;
+  uint32_t tcpi_advmss;
+  uint32_t tcpi_reordering;
+
+  uint32_t tcpi_rcv_rtt;
+  uint32_t tcpi_rcv_space;
+
+  uint32_t tcpi_total_retrans;
+
+#ifdef __INT64_DEFINED
+  uint64_t tcpi_pacing_rate;
+  uint64_t tcpi_max_pacing_rate;
+  uint64_t tcpi_bytes_acked;
+  uint64_t tcpi_bytes_received;
+  uint32_t tcpi_segs_out;
+  uint32_t tcpi_segs_in;
+#endif
+};
+
 #endif /* __INCLUDE_NETINET_TCP_H */
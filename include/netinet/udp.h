@@ -51,5 +51,9 @@
 #define UDP_BINDTODEVICE   (__SO_PROTOCOL + 0) /* Bind this UDP socket to a
                                                 * specific network device.
                                                 */
+#define UDP_REUSEPORT      (__SO_PROTOCOL + 1) /* Allow several UDP sockets
+                                                * to bind to the same address
+                                                * and port.  arg: int
+                                                */
 
 #endif /* __INCLUDE_NETINET_UDP_H */
@@ -305,6 +305,7 @@
 /* Values for rta_type */
 
 #define IFLA_IFNAME          1
+#define IFLA_STATS           7    /* struct rtnl_link_stats */
 
 /* Definitions for struct rtmsg *********************************************/
 
@@ -456,6 +457,46 @@ struct ifinfomsg
   uint32_t ifi_change;    /* Change mask, must always be 0xffffffff */
 };
 
+/* The payload of the IFLA_STATS attribute.  Only the counters kept in
+ * struct netdev_statistics_s are maintained; the others are zero.
+ */
+
+struct rtnl_link_stats
+{
+  uint32_t rx_packets;    /* Total packets received */
+  uint32_t tx_packets;    /* Total packets transmitted */
+  uint32_t rx_bytes;      /* Total bytes received */
+  uint32_t tx_bytes;      /* Total bytes transmitted */
+  uint32_t rx_errors;     /* Bad packets received */
+  uint32_t tx_errors;     /* Packet transmit problems */
+  uint32_t rx_dropped;    /* Received packets that were not processed */
+  uint32_t tx_dropped;    /* Packets that could not be transmitted */
+  uint32_t multicast;     /* Multicast packets received */
+  uint32_t collisions;
+
+  /* Detailed rx_errors */
+
+  uint32_t rx_length_errors;
+  uint32_t rx_over_errors;
+  uint32_t rx_crc_errors;
+  uint32_t rx_frame_errors;
+  uint32_t rx_fifo_errors;
+  uint32_t rx_missed_errors;
+
+  /* Detailed tx_errors */
+
+  uint32_t tx_aborted_errors;
+  uint32_t tx_carrier_errors;
+  uint32_t tx_fifo_errors;
+  uint32_t tx_heartbeat_errors;
+  uint32_t tx_window_errors;
+
+  /* Compression */
+
+  uint32_t rx_compressed;
+  uint32_t tx_compressed;
+};
+
 /* General form of address family dependent message. */
 
 struct rtgenmsg
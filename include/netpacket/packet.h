@@ -45,8 +45,59 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <sys/socket.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SOL_PACKET protocol-level socket options */
+
+#define PACKET_RX_RING       (__SO_PROTOCOL + 0) /* Set up the receive ring.
+                                                  * arg: struct tpacket_req */
+#define PACKET_TX_RING       (__SO_PROTOCOL + 1) /* Set up the transmit ring.
+                                                  * arg: struct tpacket_req */
+#define PACKET_VERSION       (__SO_PROTOCOL + 2) /* Select the ring frame
+                                                  * header format (get/set).
+                                                  * arg: int */
+#define PACKET_ATTACH_FILTER (__SO_PROTOCOL + 3) /* Attach a socket filter.
+                                                  * arg: struct sock_fprog */
+#define PACKET_DETACH_FILTER (__SO_PROTOCOL + 4) /* Remove the socket filter.
+                                                  * arg: ignored */
+
+/* Ring frame header formats.  Only TPACKET_V2 is supported. */
+
+#define TPACKET_V2           1
+
+/* Receive frame status.  A frame belongs to the kernel while its status is
+ * TP_STATUS_KERNEL and to the application otherwise.
+ */
+
+#define TP_STATUS_KERNEL     0        /* Frame is available to the kernel */
+#define TP_STATUS_USER       (1 << 0) /* Frame holds a received packet */
+#define TP_STATUS_COPY       (1 << 1) /* Packet was truncated to the frame */
+#define TP_STATUS_LOSING     (1 << 2) /* Packets were dropped: Ring full */
+
+/* Transmit frame status */
+
+#define TP_STATUS_AVAILABLE    0        /* Frame is available to the user */
+#define TP_STATUS_SEND_REQUEST (1 << 0) /* Frame is to be sent */
+#define TP_STATUS_SENDING      (1 << 1) /* Frame is being sent */
+#define TP_STATUS_WRONG_FORMAT (1 << 2) /* Frame could not be sent */
+
+/* Frame layout.  Each frame begins with a struct tpacket2_hdr followed by a
+ * struct sockaddr_ll.  The packet data follows at offset tp_mac when
+ * receiving and at TPACKET2_HDRLEN - sizeof(struct sockaddr_ll) when
+ * transmitting.
+ */
+
+#define TPACKET_ALIGNMENT    16
+#define TPACKET_ALIGN(x)     (((x) + TPACKET_ALIGNMENT - 1) & \
+                              ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET2_HDRLEN      (TPACKET_ALIGN(sizeof(struct tpacket2_hdr)) + \
+                              sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,4 +109,34 @@ struct sockaddr_ll
   int16_t  sll_ifindex;
 };
 
+/* Ring geometry passed with PACKET_RX_RING and PACKET_TX_RING.  The ring
+ * is tp_block_nr contiguous blocks of tp_block_size bytes, each holding
+ * tp_block_size / tp_frame_size frames.  A tp_frame_nr of zero releases
+ * the ring.
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;  /* Minimal size of contiguous block */
+  unsigned int tp_block_nr;    /* Number of blocks */
+  unsigned int tp_frame_size;  /* Size of frame */
+  unsigned int tp_frame_nr;    /* Total number of frames */
+};
+
+/* The header at the beginning of each ring frame */
+
+struct tpacket2_hdr
+{
+  uint32_t tp_status;          /* TP_STATUS_* bits */
+  uint32_t tp_len;             /* Length of the packet on the wire */
+  uint32_t tp_snaplen;         /* Length of the packet in the frame */
+  uint16_t tp_mac;             /* Offset of the packet data in the frame */
+  uint16_t tp_net;             /* Offset of the network header */
+  uint32_t tp_sec;             /* Time stamp of the packet */
+  uint32_t tp_nsec;
+  uint16_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint8_t  tp_padding[4];
+};
+
 #endif  /* __INCLUDE_NETPACKET_PACKET_H */
@@ -52,9 +52,11 @@
 
 #include <poll.h>
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#include <time.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/i2c/i2c_master.h>
@@ -78,6 +80,24 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#ifdef CONFIG_ADC_STREAM
+#  if !defined(CONFIG_ADC_STREAM_NBLOCKS) || CONFIG_ADC_STREAM_NBLOCKS < 2
+#    undef  CONFIG_ADC_STREAM_NBLOCKS
+#    define CONFIG_ADC_STREAM_NBLOCKS 4
+#  elif CONFIG_ADC_STREAM_NBLOCKS > 255
+#    undef  CONFIG_ADC_STREAM_NBLOCKS
+#    define CONFIG_ADC_STREAM_NBLOCKS 255
+#  endif
+
+#  ifndef CONFIG_ADC_STREAM_BLOCKSIZE
+#    define CONFIG_ADC_STREAM_BLOCKSIZE 512
+#  endif
+
+/* The size of a block returned by read() with 'n' bytes of sample data */
+
+#  define ADC_BLOCKLEN(n) (offsetof(struct adc_block_s, ab_data) + (n))
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -105,6 +125,26 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_STREAM
+  /* This method is called from the lower half, platform-specific ADC logic when
+   * a DMA half-buffer of raw samples has been filled while streaming.  The data
+   * is copied before the method returns.
+   *
+   * Input Parameters:
+   *   dev    - The ADC device structure that was previously registered by
+   *            adc_register()
+   *   data   - The raw sample data, in the format and channel order of the DMA
+   *   nbytes - The number of bytes of sample data
+   *
+   * Returned Value:
+   *   Zero on success; a negated errno value on failure.  -ENOMEM means that
+   *   the block was dropped and counted as an overrun.
+   */
+
+  CODE int (*au_receiveblock)(FAR struct adc_dev_s *dev, FAR const void *data,
+                              size_t nbytes);
+#endif
 };
 
 /* This describes on ADC message */
@@ -126,6 +166,34 @@ struct adc_fifo_s
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+#ifdef CONFIG_ADC_STREAM
+/* This describes one block of streamed samples.  read() returns blocks of
+ * ADC_BLOCKLEN(ab_nbytes) bytes; the mmap()'ed ring holds
+ * CONFIG_ADC_STREAM_NBLOCKS blocks of full size.
+ */
+
+struct adc_block_s
+{
+  uint32_t     ab_seqno;                 /* Sequence number of the block */
+  uint32_t     ab_overruns;              /* Total number of blocks lost so far */
+  struct timespec ab_ts;                 /* Time when the block was received */
+  uint16_t     ab_nbytes;                /* Number of bytes in ab_data[] */
+  uint8_t      ab_data[CONFIG_ADC_STREAM_BLOCKSIZE];
+};
+
+/* This describes the ring of streamed blocks */
+
+struct adc_stream_s
+{
+  FAR struct adc_block_s *as_blocks;     /* The ring of blocks */
+  uint8_t      as_head;                  /* Index of the oldest full block [OUT] */
+  uint8_t      as_tail;                  /* Index of the next block to fill [IN] */
+  bool         as_active;                /* True: Streaming is enabled */
+  uint32_t     as_seqno;                 /* Sequence number of the next block */
+  uint32_t     as_overruns;              /* Number of blocks lost */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of adc_register().
@@ -189,6 +257,9 @@ struct adc_dev_s
   sem_t                       ad_closesem;   /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+#ifdef CONFIG_ADC_STREAM
+  struct adc_stream_s         ad_stream;     /* Describes the stream ring */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -65,8 +65,21 @@
                                            * IN: Threshold value
                                            * OUT: None */
 
+/* ADC block streaming (CONFIG_ADC_STREAM) */
+
+#define ANIOC_STREAM      _ANIOC(0x0004)  /* Start or stop block streaming
+                                           * IN: 1=start, 0=stop
+                                           * OUT: None */
+#define ANIOC_STREAM_GETBLOCK _ANIOC(0x0005) /* Wait for the oldest full block
+                                           * IN: None
+                                           * OUT: Index of the block in the
+                                           *      mmap()'ed ring */
+#define ANIOC_STREAM_PUTBLOCK _ANIOC(0x0006) /* Release the oldest full block
+                                           * IN: None
+                                           * OUT: None */
+
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          3               /* Number of common commands */
+#define AN_NCMDS          6               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half QE driver to the lower-half QE driver via the ioctl()
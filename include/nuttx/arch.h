@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/arch.h
  *
- *   Copyright (C) 2007-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -1320,6 +1320,49 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr);
 int up_shmdt(uintptr_t vaddr, unsigned int npages);
 #endif
 
+/****************************************************************************
+ * Name: up_filemap_map
+ *
+ * Description:
+ *   Map one physical page at an address in the file mapping window.  This
+ *   is used by the demand-paged file mapping logic to map pages after they
+ *   have been filled from the backing file.
+ *
+ * Input Parameters:
+ *   vaddr    - The page aligned virtual address in the window
+ *   paddr    - The physical address of the page
+ *   writable - True if the page is to be mapped writable
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILEMAP
+int up_filemap_map(uintptr_t vaddr, uintptr_t paddr, bool writable);
+#endif
+
+/****************************************************************************
+ * Name: up_filemap_unmap
+ *
+ * Description:
+ *   Remove the mapping of one page from the file mapping window so that
+ *   the next access to the page causes a translation fault.
+ *
+ * Input Parameters:
+ *   vaddr - The page aligned virtual address in the window
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILEMAP
+int up_filemap_unmap(uintptr_t vaddr);
+#endif
+
 /****************************************************************************
  * Interfaces required for ELF module support
  *
@@ -1342,6 +1385,20 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages);
 
 bool up_interrupt_context(void);
 
+/****************************************************************************
+ * Name: up_profile_pc
+ *
+ * Description:
+ *   Return the program counter of the code that was interrupted by the
+ *   timer interrupt that is being processed.  This is the sample recorded
+ *   by the sampling profiler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+uintptr_t up_profile_pc(void);
+#endif
+
 /****************************************************************************
  * Name: up_enable_irq
  *
@@ -1410,6 +1467,27 @@ void up_trigger_irq(int irq);
 int up_prioritize_irq(int irq, int priority);
 #endif
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Select the set of CPUs that may service an IRQ.  Bit n of 'cpuset'
+ *   selects CPU n.
+ *
+ *   Since this API is not supported on all architectures, it should be
+ *   avoided in common implementations where possible.  Use
+ *   irq_set_affinity() instead.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the affinity of the IRQ cannot be
+ *   changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_IRQAFFINITY
+int up_affinity_irq(int irq, cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Tickless OS Support.
  *
@@ -1668,6 +1746,25 @@ int up_timer_start(FAR const struct timespec *ts);
  */
 #endif
 
+/****************************************************************************
+ * Name: up_tls_resume
+ *
+ * Description:
+ *   With CONFIG_TLS_THREADPTR, up_tls_info() reads the address of the TLS
+ *   information structure from a register of the CPU instead of deriving
+ *   it from the aligned stack.  up_tls_resume() is called by
+ *   sched_resume_scheduler() whenever the thread 'tcb' is about to run on
+ *   the current CPU and loads that register.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_THREADPTR
+/* void up_tls_resume(FAR struct tcb_s *tcb);
+ *
+ * The actual declaration or definition is provided in arch/tls.h.
+ */
+#endif
+
 /****************************************************************************
  * Multiple CPU support
  ****************************************************************************/
@@ -1740,6 +1837,31 @@ int16_t up_fetchsub16(FAR volatile int16_t *addr, int16_t value);
 int8_t up_fetchsub8(FAR volatile int8_t *addr, int8_t value);
 #endif
 
+/****************************************************************************
+ * Name: up_cmpxchg16
+ *
+ * Description:
+ *   Perform an atomic compare and exchange operation on the provided 16-bit
+ *   value:  If the value is equal to oldval, it is replaced with newval.
+ *
+ *   This function must be provided via the architecture-specific logic.
+ *
+ * Input Parameters:
+ *   addr   - The address of 16-bit value to be exchanged.
+ *   oldval - The expected 16-bit value
+ *   newval - The new 16-bit value
+ *
+ * Returned Value:
+ *   True if the value was exchanged; false if the value was not equal to
+ *   oldval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_FETCHADD
+bool up_cmpxchg16(FAR volatile int16_t *addr, int16_t oldval,
+                  int16_t newval);
+#endif
+
 /****************************************************************************
  * Name: up_cpu_index
  *
@@ -2088,6 +2210,31 @@ void nxsched_alarm_expiration(FAR const struct timespec *ts);
 void weak_function nxsched_process_cpuload(void);
 #endif
 
+/****************************************************************************
+ * Name: nxsched_process_profile
+ *
+ * Description:
+ *   Record the program counter interrupted on this CPU in the sampling
+ *   profiler.  When CONFIG_SCHED_PROFILE_EXTCLK is defined, this is an
+ *   exported interface to be called from a dedicated timer interrupt.
+ *   Otherwise, it is an OS Internal interface.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_PROFILE) && defined(CONFIG_SCHED_PROFILE_EXTCLK)
+void weak_function nxsched_process_profile(void);
+#endif
+
 /****************************************************************************
  * Name: irq_dispatch
  *
@@ -2403,7 +2550,10 @@ void arch_sporadic_resume(FAR struct tcb_s *tcb);
  *   units.
  ********************************************************************************/
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_CPUACCT) || \
+    defined(CONFIG_LIB_SYSCALL_STATS) || defined(CONFIG_BOOT_TRACE) || \
+    (defined(CONFIG_ARCH_SIM) && \
+     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS))
 uint32_t up_critmon_gettime(void);
 void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
 #endif
@@ -104,6 +104,30 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSETUP - Allocate (or, with zero periods, free) the ring of
+ *   period buffers of a ring-mode PCM stream (CONFIG_AUDIO_RING).  The ring
+ *   is one contiguous buffer that the application maps with mmap() or uses
+ *   through the returned address.
+ *
+ *   ioctl argument:  Pointer to the audio_ring_desc_s structure
+ *
+ * AUDIOIOC_RINGCOMMIT - Tell the driver that the application has written
+ *   (playback) or consumed (capture) the next bytes of the ring.  Complete
+ *   periods are enqueued to the lower half.
+ *
+ *   ioctl argument:  The number of bytes
+ *
+ * AUDIOIOC_RINGSTATUS - Get the hardware and application pointers of the
+ *   ring.
+ *
+ *   ioctl argument:  Pointer to the audio_ring_status_s structure
+ *
+ * AUDIOIOC_RINGWAIT - Wait until at least the given number of bytes may be
+ *   written (playback) or read (capture).  Returns the number of bytes
+ *   available.
+ *
+ *   ioctl argument:  The number of bytes
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -123,6 +147,10 @@
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
 #define AUDIOIOC_SETBUFFERINFO      _AUDIOIOC(17)
+#define AUDIOIOC_RINGSETUP          _AUDIOIOC(18)
+#define AUDIOIOC_RINGCOMMIT         _AUDIOIOC(19)
+#define AUDIOIOC_RINGSTATUS         _AUDIOIOC(20)
+#define AUDIOIOC_RINGWAIT           _AUDIOIOC(21)
 
 /* Audio Device Types *******************************************************/
 /* The NuttX audio interface support different types of audio devices for
@@ -330,6 +358,10 @@
 #define AUDIO_APB_DEQUEUED          (1 << 2)
 #define AUDIO_APB_FINAL             (1 << 3) /* Last buffer in the stream */
 
+/* Ring-mode PCM stream flags */
+
+#define AUDIO_RING_CAPTURE          (1 << 0) /* Ring is filled by the device */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -469,6 +501,39 @@ struct audio_buf_desc_s
   } u;
 };
 
+#ifdef CONFIG_AUDIO_RING
+/* Structure for setting up a ring-mode PCM stream via the
+ * AUDIOIOC_RINGSETUP ioctl.  The ring holds nperiods * period bytes.  Each
+ * period is passed to the lower half as one audio pipeline buffer.
+ */
+
+struct audio_ring_desc_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  uint8_t             flags;              /* See AUDIO_RING_* definitions */
+  uint8_t             nperiods;           /* Number of periods, 0 to free */
+  apb_samp_t          period;             /* Number of bytes per period */
+  FAR uint8_t         *buffer;            /* Returned: Start of the ring */
+};
+
+/* Structure returned by the AUDIOIOC_RINGSTATUS ioctl.  The pointers count
+ * bytes since the ring was set up and wrap at 2^32.  The offsets locate
+ * them in the ring.
+ */
+
+struct audio_ring_status_s
+{
+  uint32_t            hwptr;              /* Bytes transferred by the device */
+  uint32_t            applptr;            /* Bytes committed by the app */
+  uint32_t            hwofs;              /* Offset of hwptr in the ring */
+  uint32_t            applofs;            /* Offset of applptr in the ring */
+  uint32_t            avail;              /* Bytes the application may access */
+  uint32_t            xruns;              /* Number of under- or overruns */
+};
+#endif
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/binfmt/elf.h
  *
- *   Copyright (C) 2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -50,6 +50,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/symtab.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -113,6 +114,14 @@ struct elf_loadinfo_s
   Elf32_Ehdr        ehdr;        /* Buffered ELF file header */
   FAR Elf32_Shdr    *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
+  FAR Elf32_Sym     *symtab;     /* Buffered symbol table or NULL */
+  FAR uint8_t       *strtab;     /* Buffered string table or NULL */
+#ifdef CONFIG_ELF_XIP
+  FAR const uint8_t *xipbase;    /* The file in memory-mapped media or NULL */
+#endif
+#ifdef CONFIG_SYMTAB_HASHED
+  FAR struct symtab_hash_s *exphash; /* Hash index of the exports */
+#endif
 
   /* Constructors and destructors */
 
@@ -49,6 +49,10 @@
 #include <stdbool.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_CAN_TIMESTAMP
+#  include <sys/time.h>
+#endif
+
 #include <nuttx/list.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -87,6 +91,10 @@
  *   support is needed for this feature.
  * CONFIG_CAN_TXREADY_HIPRI or CONFIG_CAN_TXREADY_LOPRI - Selects which work queue
  *   will be used for the can_txready() processing.
+ * CONFIG_CAN_TIMESTAMP - Add the receive time stamp ch_ts to the CAN message
+ *   header.
+ * CONFIG_CAN_NRXFILTERS - The number of per-open-file receive filters that may
+ *   be added with CANIOC_ADD_RXFILTER.  Zero disables the receive filters.
  */
 
 /* Default configuration settings that may be overridden in the NuttX configuration
@@ -101,6 +109,13 @@
 #  define CONFIG_CAN_FIFOSIZE 255
 #endif
 
+#if !defined(CONFIG_CAN_NRXFILTERS)
+#  define CONFIG_CAN_NRXFILTERS 0
+#elif CONFIG_CAN_NRXFILTERS > 255
+#  undef  CONFIG_CAN_NRXFILTERS
+#  define CONFIG_CAN_NRXFILTERS 255
+#endif
+
 #if !defined(CONFIG_CAN_NPENDINGRTR)
 #  define CONFIG_CAN_NPENDINGRTR 4
 #elif CONFIG_CAN_NPENDINGRTR > 255
@@ -197,6 +212,28 @@
  *                   is returned with the errno variable set to indicate the
  *                   nature of the error.
  *   Dependencies:   None
+ *
+ * CANIOC_ADD_RXFILTER:
+ *   Description:    Add a receive filter to this open file.  Unlike the
+ *                   hardware acceptance filters, these filters are applied
+ *                   by the upper half driver and only to the receive queue
+ *                   of this open file.  Once a filter has been added, only
+ *                   messages that match at least one of the filters of the
+ *                   open file are queued.  Error reports are always queued.
+ *   Argument:       A pointer to a read-able instance of struct
+ *                   canioc_rxfilter_s.
+ *   Returned Value: A non-negative filter ID is returned on success.
+ *                   Otherwise -1 (ERROR) is returned with the errno
+ *                   variable set to indicate the nature of the error.
+ *   Dependencies:   Requires CONFIG_CAN_NRXFILTERS > 0
+ *
+ * CANIOC_DEL_RXFILTER:
+ *   Description:    Remove a receive filter from this open file.
+ *   Argument:       The filter ID returned by CANIOC_ADD_RXFILTER
+ *   Returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.
+ *   Dependencies:   Requires CONFIG_CAN_NRXFILTERS > 0
  */
 
 #define CANIOC_RTR                _CANIOC(1)
@@ -209,9 +246,11 @@
 #define CANIOC_GET_CONNMODES      _CANIOC(8)
 #define CANIOC_SET_CONNMODES      _CANIOC(9)
 #define CANIOC_BUSOFF_RECOVERY    _CANIOC(10)
+#define CANIOC_ADD_RXFILTER       _CANIOC(11)
+#define CANIOC_DEL_RXFILTER       _CANIOC(12)
 
 #define CAN_FIRST                 0x0001         /* First common command */
-#define CAN_NCMDS                 10             /* Ten common commands */
+#define CAN_NCMDS                 12             /* Twelve common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half CAN driver to the lower-half CAN driver via the co_ioctl()
@@ -436,6 +475,9 @@ begin_packed_struct struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Receive time stamp */
+#endif
 } end_packed_struct;
 
 #else
@@ -448,6 +490,9 @@ begin_packed_struct struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Receive time stamp */
+#endif
 } end_packed_struct;
 #endif
 
@@ -553,16 +598,34 @@ struct can_ops_s
  * calling logic need only set all fields to zero except:
  *
  *   The elements of 'cd_ops', and 'cd_priv'
+ *   'cd_hwtstamp' if the lower half provides hardware receive time stamps in
+ *   ch_ts.  Otherwise, the upper half time stamps the message in can_receive().
  *
  * The common logic will initialize all semaphores.
  */
 
+/* CANIOC_ADD_RXFILTER: */
+
+struct canioc_rxfilter_s
+{
+  uint32_t              rf_id1;          /* ID.  For dual match or for the lower
+                                          * address in a range of addresses */
+  uint32_t              rf_id2;          /* ID.  For dual match, address mask or
+                                          * for upper address in address range */
+  uint8_t               rf_type;         /* See CAN_FILTER_* definitions */
+  uint8_t               rf_extid;        /* 1=29-bit extended IDs */
+};
+
 struct can_reader_s
 {
   struct list_node     list;
   sem_t                read_sem;
   FAR struct file     *filep;
   struct can_rxfifo_s  fifo;             /* Describes receive FIFO */
+#if CONFIG_CAN_NRXFILTERS > 0
+  uint32_t             filtset;          /* Bit set of the filters in use */
+  struct canioc_rxfilter_s filters[CONFIG_CAN_NRXFILTERS];
+#endif
 };
 
 struct can_dev_s
@@ -571,6 +634,9 @@ struct can_dev_s
   uint8_t              cd_npendrtr;      /* Number of pending RTR messages */
   volatile uint8_t     cd_ntxwaiters;    /* Number of threads waiting to enqueue a message */
   volatile uint8_t     cd_nrxwaiters;    /* Number of threads waiting to receive a message */
+#ifdef CONFIG_CAN_TIMESTAMP
+  bool                 cd_hwtstamp;      /* Lower half provides ch_ts */
+#endif
   struct list_node     cd_readers;       /* Number of readers */
 #ifdef CONFIG_CAN_ERRORS
   uint8_t              cd_error;         /* Flags to indicate internal device errors */
@@ -228,6 +228,40 @@ struct cpuload_s
 };
 #endif
 
+/* These structures are used to report the exact CPU time used by a
+ * particular thread and by a particular CPU.  All times are in nanoseconds.
+ */
+
+#ifdef CONFIG_SCHED_CPUACCT
+struct cpuacct_s
+{
+  uint64_t run;              /* Time that the thread was running */
+  uint64_t irq;              /* Time in interrupts taken while it was running */
+};
+
+struct cpuacct_cpu_s
+{
+  uint64_t busy;             /* Time that the CPU ran threads other than IDLE */
+  uint64_t idle;             /* Time that the CPU ran its IDLE thread */
+  uint64_t irq;              /* Time that the CPU spent in interrupts */
+};
+#endif
+
+/* The time page is updated by the kernel on each timer tick and may be
+ * read by user space without a system call.  'seq' is odd while the kernel
+ * is updating the page:  A reader must retry if 'seq' was odd or if it
+ * changed while the times were copied.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+struct clock_timepage_s
+{
+  volatile uint32_t seq;     /* Update sequence count */
+  struct timespec monotonic; /* Time since power up (CLOCK_MONOTONIC) */
+  struct timespec basetime;  /* Add to 'monotonic' to get CLOCK_REALTIME */
+};
+#endif
+
 /* This non-standard type used to hold relative clock ticks that may take
  * negative values.  Because of its non-portable nature the type sclock_t
  * should be used only within the OS proper and not by portable applications.
@@ -442,6 +476,67 @@ int clock_systimespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cpuacct
+ *
+ * Description:
+ *   Return the exact CPU time used by the select PID.
+ *
+ * Input Parameters:
+ *   pid - The task ID of the thread of interest.
+ *   cpuacct - The location to return the CPU time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUACCT
+int clock_cpuacct(int pid, FAR struct cpuacct_s *cpuacct);
+#endif
+
+/****************************************************************************
+ * Name:  clock_cpuacct_cpu
+ *
+ * Description:
+ *   Return the exact busy, IDLE, and interrupt time of the select CPU.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU of interest
+ *   cpuacct - The location to return the CPU time
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUACCT
+int clock_cpuacct_cpu(int cpu, FAR struct cpuacct_cpu_s *cpuacct);
+#endif
+
+/****************************************************************************
+ * Name:  clock_timepage
+ *
+ * Description:
+ *   Return the address of the time page.  The page is in user memory so
+ *   that the C library can implement clock_gettime() without a system
+ *   call.  The page must be treated as read-only.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The address of the time page.  NULL is returned only if it could not
+ *   be allocated when the clock was initialized.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+FAR const struct clock_timepage_s *clock_timepage(void);
+#endif
+
 /****************************************************************************
  * Name:  sched_oneshot_extclk
  *
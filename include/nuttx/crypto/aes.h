@@ -42,6 +42,8 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -49,14 +51,25 @@
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_BLOCK_SIZE     16
+#define AES_MAX_ROUNDS     14
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* The expanded key.  The cipher uses 32-bit table lookups, one per byte
+ * and round, instead of computing SubBytes and MixColumns byte by byte.
+ */
+
 struct aes_state_s
 {
-  uint8_t expanded_key[176];
+  uint32_t ek[4 * (AES_MAX_ROUNDS + 1)];  /* Encryption round keys */
+  uint32_t dk[4 * (AES_MAX_ROUNDS + 1)];  /* Decryption round keys */
+  int nrounds;                            /* 10, 12 or 14 */
 };
 
 /****************************************************************************
@@ -118,14 +131,12 @@ void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key, 16 (AES-128), 24 (AES-192) or 32 (AES-256)
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not 16, 24 or 32
  *
  ****************************************************************************/
 
@@ -164,6 +175,100 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk);
 
+/****************************************************************************
+ * Name: aes_sw_cypher
+ *
+ * Description:
+ *   The software implementation of aes_cypher() (see
+ *   include/nuttx/crypto/crypto.h) with AES_MODE_ECB, AES_MODE_CBC (also
+ *   with AES_MODE_MAC), AES_MODE_CTR and AES_MODE_CFB and all three key
+ *   sizes.  It is aes_cypher() if the architecture has no AES hardware.
+ *   AES hardware drivers may use it for the operations that the hardware
+ *   does not support.
+ *
+ *   The size must be a multiple of 16 bytes except in CTR mode.  The IV
+ *   is the 16-byte initial counter block in CTR mode (incremented as a
+ *   128-bit big-endian number).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the mode, key size or data size is
+ *   not supported.
+ *
+ ****************************************************************************/
+
+int aes_sw_cypher(FAR void *out, FAR const void *in, uint32_t size,
+                  FAR const void *iv, FAR const void *key, uint32_t keysize,
+                  int mode, int encrypt);
+
+/****************************************************************************
+ * Name: aes_state_cypher
+ *
+ * Description:
+ *   The same as aes_sw_cypher() but with a key schedule previously set up
+ *   by aes_setupkey().  This avoids the key expansion when many operations
+ *   use the same key.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the mode or data size is not
+ *   supported.
+ *
+ ****************************************************************************/
+
+int aes_state_cypher(FAR const struct aes_state_s *state, FAR void *out,
+                     FAR const void *in, uint32_t size, FAR const void *iv,
+                     int mode, int encrypt);
+
+/****************************************************************************
+ * Name: aes_gcm_encrypt
+ *
+ * Description:
+ *   Encrypt and authenticate 'len' bytes in Galois/Counter Mode (NIST SP
+ *   800-38D) with the key previously set up by aes_setupkey().  'in' and
+ *   'out' may be the same buffer.
+ *
+ * Input Parameters:
+ *   state  - The AES context
+ *   iv     - The initialization vector, normally 12 bytes
+ *   ivlen  - The length of iv (non-zero)
+ *   aad    - Additional data that is authenticated but not encrypted
+ *   aadlen - The length of aad (may be zero)
+ *   in     - The plain text
+ *   out    - The cipher text
+ *   len    - The length of the text
+ *   tag    - The authentication tag is returned here
+ *   taglen - The length of the tag, 4 to 16 bytes
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the IV or tag length is invalid.
+ *
+ ****************************************************************************/
+
+int aes_gcm_encrypt(FAR const struct aes_state_s *state,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR uint8_t *tag, size_t taglen);
+
+/****************************************************************************
+ * Name: aes_gcm_decrypt
+ *
+ * Description:
+ *   Decrypt and verify 'len' bytes in Galois/Counter Mode.  The parameters
+ *   are those of aes_gcm_encrypt() with the cipher text as input and the
+ *   expected tag.  If the tag does not match, the output is cleared.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBADMSG if the tag does not match, -EINVAL if
+ *   the IV or tag length is invalid.
+ *
+ ****************************************************************************/
+
+int aes_gcm_decrypt(FAR const struct aes_state_s *state,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR const uint8_t *tag, size_t taglen);
+
 #ifdef  __cplusplus
 }
 #endif /* __cplusplus */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/crypto/cryptodev.h
  *
- *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014, 2020 Gregory Nutt. All rights reserved.
  *   Author:  Max Nekludov <macscomp@gmail.com>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -53,7 +53,7 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
-#define CRYPTO_ALGORITHM_MAX    1
+#define CRYPTO_ALGORITHM_MAX    3
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
 #define CRYPTO_FLAG_SOFTWARE    0x02000000 /* software implementation */
@@ -65,6 +65,10 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCCRYPTM              104 /* Perform a batch of operations */
+#define CIOCCRYPTMRET           105 /* Retrieve a completed async batch */
+
+#define CRYPTO_MOP_F_ASYNC      0x0001 /* Process the batch in background */
 
 typedef char* caddr_t;
 
@@ -90,6 +94,21 @@ struct crypt_op
   caddr_t src, dst;   /* become iov[] inside kernel */
   caddr_t mac;        /* must be big enough for chosen MAC */
   caddr_t iv;
+  int status;         /* returns: result of the operation in a batch */
+};
+
+/* A batch of operations for CIOCCRYPTM.  Without CRYPTO_MOP_F_ASYNC, the
+ * ioctl returns when all of the operations are done.  With
+ * CRYPTO_MOP_F_ASYNC, the ioctl returns immediately and the batch is
+ * processed in the background.  The batch and its buffers must then remain
+ * valid until poll() reports POLLIN and CIOCCRYPTMRET has returned it.
+ */
+
+struct crypt_mop
+{
+  uint32_t count;               /* The number of operations in reqs[] */
+  uint32_t flags;               /* CRYPTO_MOP_F_* */
+  FAR struct crypt_op *reqs;    /* The operations */
 };
 
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
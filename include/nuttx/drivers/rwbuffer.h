@@ -67,6 +67,22 @@ typedef CODE ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef CODE ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                                    off_t startblock, size_t nblocks);
 
+/* Buffering statistics returned by rwb_getstats() */
+
+#ifdef CONFIG_DRVR_RWBSTATS
+struct rwb_stats_s
+{
+  uint32_t      rhhits;          /* Blocks copied from the read-ahead buffer */
+  uint32_t      rhreloads;       /* Number of read-ahead buffer reloads */
+  uint32_t      rhblocks;        /* Blocks loaded into the read-ahead buffer */
+  uint32_t      rhwindow;        /* Blocks read by the last reload */
+  uint32_t      wrhits;          /* Blocks added to the write buffer */
+  uint32_t      wrflushes;       /* Number of write buffer flushes */
+  uint32_t      wrdirect;        /* Blocks written without buffering */
+  uint32_t      wrwaits;         /* Writes that waited for a write-behind flush */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -144,6 +160,17 @@ struct rwbuffer_s
   off_t         wrexpectedblock; /* Next block expected */
 #endif
 
+  /* This is the state of the write-behind buffer */
+
+#ifdef CONFIG_DRVR_WRITEBEHIND
+  sem_t         flsem;           /* Available when no write-behind flush is pending */
+  struct work_s flwork;          /* Work to flush the write-behind buffer */
+  uint8_t      *flbuffer;        /* Allocated write-behind buffer */
+  uint16_t      flnblocks;       /* Number of blocks being flushed */
+  off_t         flblockstart;    /* First block being flushed */
+  int           flresult;        /* First error of a write-behind flush */
+#endif
+
   /* This is the state of the read-ahead buffering */
 
 #ifdef CONFIG_DRVR_READAHEAD
@@ -152,6 +179,14 @@ struct rwbuffer_s
   uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
   off_t         rhblockstart;    /* First block in read-ahead buffer */
 #endif
+#ifdef CONFIG_DRVR_READAHEAD_ADAPTIVE
+  uint16_t      rhwindow;        /* Number of blocks to read on the next reload */
+  off_t         rhexpectedblock; /* Next block of a sequential stream */
+#endif
+
+#ifdef CONFIG_DRVR_RWBSTATS
+  struct rwb_stats_s stats;      /* Buffering statistics */
+#endif
 };
 
 /****************************************************************************
@@ -206,6 +241,10 @@ int rwb_invalidate(FAR struct rwbuffer_s *rwb,
 int rwb_flush(FAR struct rwbuffer_s *rwb);
 #endif
 
+#ifdef CONFIG_DRVR_RWBSTATS
+int rwb_getstats(FAR struct rwbuffer_s *rwb, FAR struct rwb_stats_s *stats);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
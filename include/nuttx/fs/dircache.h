@@ -0,0 +1,162 @@
+/****************************************************************************
+ * include/nuttx/fs/dircache.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_DIRCACHE_H
+#define __INCLUDE_NUTTX_FS_DIRCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_FS_DIRCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_DIRCACHE_NENTRIES
+#  define CONFIG_FS_DIRCACHE_NENTRIES 16
+#endif
+
+#ifndef CONFIG_FS_DIRCACHE_PATHLEN
+#  define CONFIG_FS_DIRCACHE_PATHLEN  32
+#endif
+
+#if (CONFIG_FS_DIRCACHE_NENTRIES & (CONFIG_FS_DIRCACHE_NENTRIES - 1)) != 0
+#  error CONFIG_FS_DIRCACHE_NENTRIES must be a power of two
+#endif
+
+#if CONFIG_FS_DIRCACHE_PATHLEN > 255
+#  error CONFIG_FS_DIRCACHE_PATHLEN must not exceed 255
+#endif
+
+/* Initialize a directory cache */
+
+#define dircache_init(dc) dircache_flush(dc)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One cached directory.  The key is the path of the directory relative to
+ * the point where the search starts (the root of the pseudo file system or
+ * of the mounted volume), without leading or trailing '/'.  The value is
+ * whatever the owner needs to resume the search in that directory: an inode
+ * pointer, a start cluster, ...
+ */
+
+struct dircache_entry_s
+{
+  uintptr_t value;                          /* The cached directory */
+  uint32_t  hash;                           /* Hash of the path */
+  uint8_t   len;                            /* Length of the path, 0=unused */
+  char      path[CONFIG_FS_DIRCACHE_PATHLEN]; /* The path (no NUL) */
+};
+
+/* A direct-mapped, hashed directory cache.  The owner provides mutual
+ * exclusion.
+ */
+
+struct dircache_s
+{
+  struct dircache_entry_s entries[CONFIG_FS_DIRCACHE_NENTRIES];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dircache_flush
+ *
+ * Description:
+ *   Discard all entries.  Called when the directory tree changes in some way
+ *   that could make an entry stale (rename, directory removal, unmount).
+ *
+ ****************************************************************************/
+
+void dircache_flush(FAR struct dircache_s *dc);
+
+/****************************************************************************
+ * Name: dircache_add
+ *
+ * Description:
+ *   Remember the directory at 'path' (the first 'len' bytes).  Paths that
+ *   are too long to be cached are ignored.
+ *
+ ****************************************************************************/
+
+void dircache_add(FAR struct dircache_s *dc, FAR const char *path,
+                  size_t len, uintptr_t value);
+
+/****************************************************************************
+ * Name: dircache_lookup
+ *
+ * Description:
+ *   Find the longest directory prefix of 'path' that is in the cache.  Only
+ *   prefixes that end before a '/' are considered, so the final component
+ *   of the path is never matched.
+ *
+ * Returned Value:
+ *   The length of the matching prefix, with the cached value in 'value', or
+ *   zero if there is no match.
+ *
+ ****************************************************************************/
+
+size_t dircache_lookup(FAR struct dircache_s *dc, FAR const char *path,
+                       FAR uintptr_t *value);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_DIRCACHE */
+#endif /* __INCLUDE_NUTTX_FS_DIRCACHE_H */
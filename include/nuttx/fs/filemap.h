@@ -0,0 +1,116 @@
+/****************************************************************************
+ * include/nuttx/fs/filemap.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_FILEMAP_H
+#define __INCLUDE_NUTTX_FS_FILEMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_FS_FILEMAP
+#include <nuttx/pgalloc.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Demand-paged file mappings are created in a dedicated virtual address
+ * window of CONFIG_FS_FILEMAP_NPAGES pages.  The first page of the window
+ * is reserved as a scratch mapping that is used to fill page frames before
+ * they are mapped at their final address.
+ */
+
+#define FILEMAP_VSIZE         (CONFIG_FS_FILEMAP_NPAGES << MM_PGSHIFT)
+#define FILEMAP_VEND          (CONFIG_FS_FILEMAP_VBASE + FILEMAP_VSIZE)
+#define FILEMAP_SCRATCH_VADDR (CONFIG_FS_FILEMAP_VBASE)
+
+/* Check if a virtual address lies within the file mapping window.  This is
+ * inexpensive and may be called from the exception handler to decide if a
+ * translation fault should be passed to filemap_fault().
+ */
+
+#define FILEMAP_INWINDOW(a) \
+  ((uintptr_t)(a) >= CONFIG_FS_FILEMAP_VBASE + MM_PGSIZE && \
+   (uintptr_t)(a) < FILEMAP_VEND)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: filemap_fault
+ *
+ * Description:
+ *   Resolve a translation fault within the file mapping window by reading
+ *   the missing page from the backing file and mapping it.  If the page
+ *   budget is exhausted, a clean resident page is evicted to make room.
+ *
+ * Input Parameters:
+ *   vaddr - The faulting virtual address
+ *
+ * Returned Value:
+ *   Zero (OK) if the page is now mapped and the faulting access may be
+ *   retried; a negated errno value if the fault cannot be resolved.
+ *
+ * Assumptions:
+ *   This function may block on file system I/O.  It must be called from
+ *   the context of the faulting thread with interrupts enabled, never from
+ *   the exception handler itself.
+ *
+ ****************************************************************************/
+
+int filemap_fault(uintptr_t vaddr);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FS_FILEMAP */
+#endif /* __INCLUDE_NUTTX_FS_FILEMAP_H */
@@ -1,8 +1,8 @@
 /****************************************************************************
  * include/nuttx/fs/fs.h
  *
- *   Copyright (C) 2007-2009, 2011-2013, 2015-2018 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2007-2009, 2011-2013, 2015-2018, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -215,6 +215,7 @@ struct stat;
 struct statfs;
 struct pollfd;
 struct fs_dirent_s;
+struct dirent;
 struct mtd_dev_s;
 
 /* This structure is provided by devices when they are registered with the
@@ -351,6 +352,16 @@ struct mountpt_operations
   int     (*stat)(FAR struct inode *mountpt, FAR const char *relpath,
             FAR struct stat *buf);
 
+  /* Optional batched readdir:  Return up to 'nentries' directory entries
+   * in 'entries' with one call, advancing the directory like as many
+   * readdir() calls would.  Returns the number of entries, zero at the
+   * end of the directory, or a negated errno value.  If NULL, getdents()
+   * falls back to readdir().
+   */
+
+  int     (*getdents)(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir,
+            FAR struct dirent *entries, size_t nentries);
+
   /* NOTE:  More operations will be needed here to support:  disk usage
    * stats file stat(), file attributes, file truncation, etc.
    */
@@ -421,11 +432,30 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This is the argument of the FIOC_BMAP ioctl.  It maps an offset in a
+ * file to the sector of the block driver that holds the data.
+ */
+
+struct file_bmap_s
+{
+  off_t             offset;     /* IN:  File offset, a multiple of sectsize */
+  FAR struct inode *blkdriver;  /* OUT: The block driver that holds the data */
+  off_t             sector;     /* OUT: The sector in blkdriver */
+  off_t             nbytes;     /* OUT: Bytes stored contiguously from there */
+  uint16_t          sectsize;   /* OUT: The sector size of blkdriver */
+};
+
+/* This defines a list of files indexed by the file descriptor.  fl_used
+ * has one bit set for each file descriptor in use so that a free one can
+ * be found without examining every file structure.
+ */
+
+#define FILELIST_NWORDS ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
 
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
+  uint32_t fl_used[FILELIST_NWORDS]; /* Descriptors in use */
   struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
 };
 
@@ -592,6 +622,32 @@ int register_blockpartition(FAR const char *partition,
                             size_t firstsector, size_t nsectors);
 #endif
 
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver inode that caches the block driver at 'parent'
+ *   in the cache that is shared by all cached block drivers.
+ *
+ * Input Parameters:
+ *   path   - The path to the cached block driver inode
+ *   mode   - The access mode of the new inode
+ *   parent - The path to the block driver to be cached
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure:
+ *
+ *   EINVAL - 'path' is invalid for this operation
+ *   EEXIST - An inode already exists at 'path'
+ *   ENOMEM - Failed to allocate in-memory resources for the operation
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_BLOCKCACHE)
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent);
+#endif
+
 /****************************************************************************
  * Name: unregister_driver
  *
@@ -1301,6 +1357,67 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report the events already accumulated in fds->revents to the waiter.
+ *   Drivers call this in place of posting fds->sem.  If the waiter installed
+ *   a callback (as epoll does), then the callback is invoked; otherwise the
+ *   semaphore is posted.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with the events to report
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Tear down the poll registrations cached by poll() for the struct file
+ *   or struct socket 'ptr' that is being closed.
+ *
+ * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_close(FAR void *ptr);
+#endif
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Tear down the poll registrations cached by poll() for an exiting thread
+ *   and free its poll cache.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+struct tcb_s; /* Forward reference */
+void poll_cache_release(FAR struct tcb_s *tcb);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
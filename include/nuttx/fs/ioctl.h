@@ -171,6 +171,18 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_FALLOCATE  _FIOC(0x000b)     /* IN:  Pointer to an off_t holding the
+                                           *      file size to allocate storage
+                                           *      for.  The file size is not
+                                           *      changed.
+                                           * OUT: None
+                                           */
+#define FIOC_BMAP       _FIOC(0x000c)     /* IN:  Pointer to a struct file_bmap_s
+                                           *      with the file offset.
+                                           * OUT: The block driver sector that
+                                           *      holds it and the number of
+                                           *      contiguous bytes (kernel only).
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -265,6 +277,12 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_RWBSTATS   _BIOC(0x000e)     /* Get read-ahead/write buffer statistics
+                                           * IN:  Pointer to writable instance
+                                           *      of struct rwb_stats_s in which
+                                           *      to return the statistics.
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -388,6 +406,16 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0002)  /* Set the pipe capacity
+                                             * IN: unsigned long integer
+                                             *     capacity in bytes
+                                             * OUT: The new capacity is
+                                             *      the ioctl return
+                                             *      value */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0003)  /* Get the pipe capacity
+                                             * IN: None
+                                             * OUT: The capacity is the
+                                             *      ioctl return value */
 
 /* RTC driver ioctl definitions *********************************************/
 
@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/fs/procfs.h
  *
- *   Copyright (C) 2013 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2013, 2020 Gregory Nutt. All rights reserved.
  *   Author: Ken Pettit <pettitkd@gmail.com>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -133,6 +133,32 @@ struct procfs_dir_priv_s
   FAR const struct procfs_entry_s *procfsentry; /* Pointer to procfs handler entry */
 };
 
+/* /proc/tasks is a binary file holding one of these records for each
+ * thread.  Reading it from offset zero takes a new snapshot of all threads
+ * at once.  That is much cheaper for a monitoring agent than reading the
+ * text files of each /proc/<pid>.  The fields that depend on a disabled
+ * configuration option are zero.
+ */
+
+struct procfs_taskinfo_s
+{
+  pid_t    pid;                 /* Thread ID */
+  uint8_t  state;               /* enum tstate_e */
+  uint8_t  priority;            /* Current priority */
+  uint8_t  basepriority;        /* Priority without any boost */
+  uint8_t  cpu;                 /* CPU that the thread runs or last ran on */
+  uint16_t flags;               /* TCB_FLAG_* bits */
+  uint16_t cpuload;             /* CPU load in 1/10 % (SCHED_CPULOAD) */
+  uint64_t runtime;             /* Run time in nanoseconds (SCHED_CPUACCT) */
+  size_t   stacksize;           /* Size of the stack */
+  size_t   stackused;           /* Stack used (STACK_COLORATION) */
+  size_t   heapused;            /* Heap presently allocated (MM_TRACE) */
+  size_t   heappeak;            /* High-water mark of heapused (MM_TRACE) */
+#if CONFIG_TASK_NAME_SIZE > 0
+  char     name[CONFIG_TASK_NAME_SIZE + 1];
+#endif
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
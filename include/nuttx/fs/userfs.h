@@ -63,7 +63,9 @@
  *    (userfs_run()).  These requests may be accompanied by additional data in
  *    an provided request buffer that was provided when the UserFS was
  *    created.  This buffer would hold, for example, the data to be
- *    written that would accompany a write request.
+ *    written that would accompany a write request.  In the FLAT build with
+ *    CONFIG_FS_USERFS_DIRECTIO, read and write requests carry only the
+ *    address of the caller's buffer and the data is not copied.
  * 4. The user-space logic of userfs_run() listens at the other end of the
  *    LocalHost socket.  It will receive the requests and forward them
  *    to the user file system implementation via the methods of struct
@@ -274,13 +276,17 @@ struct userfs_read_request_s
   uint8_t req;              /* Must be USERFS_REQ_READ */
   FAR void *openinfo;       /* Open file info as returned by open() */
   size_t readlen;           /* Maximum number of bytes to read */
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  FAR char *rdbuffer;       /* The server reads directly into this buffer */
+#endif
 };
 
 struct userfs_read_response_s
 {
   uint8_t resp;             /* Must be USERFS_RESP_READ */
   ssize_t nread;            /* Result of the operation */
-  char rddata[1];           /* Read data follows.  Actual size is nread */
+  char rddata[1];           /* Read data follows.  Actual size is nread
+                             * (zero with CONFIG_FS_USERFS_DIRECTIO) */
 };
 
 #define SIZEOF_USERFS_READ_RESPONSE_S(n) (sizeof(struct userfs_read_response_s) + (n) - 1)
@@ -290,7 +296,11 @@ struct userfs_write_request_s
   uint8_t req;              /* Must be USERFS_REQ_WRITE */
   FAR void *openinfo;       /* Open file info as returned by open() */
   size_t writelen;          /* Number of bytes to write */
-  char wrdata[1];           /* Read data follows.  Actual size is wrsize */
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  FAR const char *wrbuffer; /* The server writes directly from this buffer */
+#endif
+  char wrdata[1];           /* Write data follows.  Actual size is writelen
+                             * (zero with CONFIG_FS_USERFS_DIRECTIO) */
 };
 
 #define SIZEOF_USERFS_WRITE_REQUEST_S(n) (sizeof(struct userfs_write_request_s) + (n) - 1)
@@ -247,6 +247,28 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes a batch of I2C messages queued by i2c_transfer_async().
+ * The structure is provided by the caller and must stay valid until the
+ * callback has been called.  The callback is called on the work queue with
+ * the result of I2C_TRANSFER().
+ */
+
+struct i2c_request_s;
+typedef CODE void (*i2c_callback_t)(FAR struct i2c_request_s *req,
+                                    int result, FAR void *arg);
+
+struct i2c_request_s
+{
+  FAR struct i2c_request_s *flink; /* Supports a singly linked list */
+  FAR struct i2c_msg_s *msgs;      /* Array of I2C messages */
+  int count;                       /* Number of messages in the array */
+  uint8_t priority;                /* Higher priority batches go first */
+  i2c_callback_t callback;         /* Called when the batch completes */
+  FAR void *arg;                   /* Argument passed to the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -286,6 +308,30 @@ extern "C"
 int i2c_register(FAR struct i2c_master_s *i2c, int bus);
 #endif
 
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a batch of I2C messages and return without waiting.  The batches
+ *   queued on one I2C bus are performed one after the other, highest
+ *   priority first and in order of submission within one priority.
+ *   req->callback is called when each batch completes.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the batch of messages, its priority and the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the batch was queued; a negated errno value on failure.
+ *   The callback will not be called on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_request_s *req);
+#endif
+
 /****************************************************************************
  * Name: i2c_writeread
  *
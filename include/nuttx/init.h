@@ -1,7 +1,8 @@
 /****************************************************************************
  * include/nuttx/init.h
  *
- *   Copyright (C) 2007, 2008, 2011, 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2008, 2011, 2016, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -57,10 +58,24 @@
 #define OSINIT_OS_READY()        (g_nx_initstate >= OSINIT_OSREADY)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Boot-time tracing.  The calls vanish if CONFIG_BOOT_TRACE is not
+ * selected.
+ */
+
+#ifndef CONFIG_BOOT_TRACE
+#  define nx_boottrace(n)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* The entry point of an initialization function that may run concurrently
+ * with the rest of the boot sequence.  See nx_bootasync().
+ */
+
+typedef CODE int (*nx_bootasync_t)(FAR void *arg);
+
 /* Initialization state.  OS bring-up occurs in several phases: */
 
 enum nx_initstate_e
@@ -115,6 +130,106 @@ int CONFIG_USER_ENTRYPOINT(int argc, char *argv[]);
 
 void nx_start(void) noreturn_function;
 
+/* Functions contained in nx_boottrace.c ************************************/
+
+/****************************************************************************
+ * Name: nx_boottrace
+ *
+ * Description:
+ *   Record the end of a phase of the boot sequence.  The phase started at
+ *   the previous call to nx_boottrace().
+ *
+ * Input Parameters:
+ *   name - The name of the phase.  The string must persist.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOT_TRACE
+void nx_boottrace(FAR const char *name);
+#endif
+
+/****************************************************************************
+ * Name: nx_boottrace_span
+ *
+ * Description:
+ *   Record a phase that ran concurrently with the boot sequence.  This
+ *   does not affect the start of the next phase recorded by nx_boottrace().
+ *
+ * Input Parameters:
+ *   name  - The name of the phase.  The string must persist.
+ *   start - The start time of the phase as returned by up_critmon_gettime()
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOT_TRACE
+void nx_boottrace_span(FAR const char *name, uint32_t start);
+#endif
+
+/****************************************************************************
+ * Name: nx_bootreport
+ *
+ * Description:
+ *   Send the recorded phases, with their start times and durations, to the
+ *   SYSLOG.  This is done automatically just before the application is
+ *   started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOT_TRACE
+void nx_bootreport(void);
+#endif
+
+/* Functions contained in nx_bootasync.c ************************************/
+
+/****************************************************************************
+ * Name: nx_bootasync
+ *
+ * Description:
+ *   Run an initialization function on its own kernel thread, concurrently
+ *   with the rest of the boot sequence and with the other initialization
+ *   functions.  In an SMP configuration, the threads may run on any CPU.
+ *   This is intended for independent initialization steps that spend most
+ *   of their time waiting, such as SD card probing, network PHY
+ *   auto-negotiation or mounting file systems.
+ *
+ *   The function is called directly if the OS is not yet ready to start
+ *   threads, i.e. from board_early_initialize().
+ *
+ * Input Parameters:
+ *   name  - The name of the thread.  The string must persist.
+ *   entry - The initialization function
+ *   arg   - The argument passed to the initialization function
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the function was started or, if it was
+ *   called directly, the value returned by the function.  A negated errno
+ *   value is returned if the thread could not be created.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOT_ASYNC
+int nx_bootasync(FAR const char *name, nx_bootasync_t entry, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: nx_bootasync_wait
+ *
+ * Description:
+ *   Wait until all initialization functions started by nx_bootasync()
+ *   have returned.  This is done automatically after
+ *   board_late_initialize(), before the application is started.  Only
+ *   one thread may wait at a time.
+ *
+ * Returned Value:
+ *   Zero (OK) if all functions succeeded; otherwise, the first negated
+ *   errno value returned by one of the functions.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOT_ASYNC
+int nx_bootasync_wait(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
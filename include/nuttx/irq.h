@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+# include <sys/types.h>
 # include <stdint.h>
 # include <assert.h>
 #endif
@@ -60,6 +61,12 @@
 
 #  define irq_detach(irq) irq_attach(irq, NULL, NULL)
 
+/* The top half of a threaded interrupt handler returns this value to
+ * request that the bottom half be run on the interrupt thread.
+ */
+
+#  define IRQ_WAKE_THREAD 1
+
 /* Maximum/minimum values of IRQ integer types */
 
 #  if NR_IRQS <= 256
@@ -170,6 +177,78 @@ int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #  define irqchain_detach(irq, isr, arg) irq_detach(irq)
 #endif
 
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is dispatched to
+ *   a threaded interrupt handler.  'isr' is the top half.  It is called in
+ *   the interrupt context and returns IRQ_WAKE_THREAD if the bottom half
+ *   must run.  If 'isr' is NULL, the bottom half runs on every interrupt.
+ *   'isrthread' is the bottom half.  It is called on a dedicated kernel
+ *   thread with a NULL context.  Both receive the argument 'arg'.
+ *
+ *   The interrupt is disabled when the thread is woken up and re-enabled
+ *   when 'isrthread' returns.
+ *
+ *   The thread is created by the first call for the IRQ.  It is not
+ *   destroyed when the IRQ is detached with irq_detach() but is re-used,
+ *   with the new handlers, when the IRQ is attached again.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The top half interrupt handler or NULL
+ *   isrthread  - The bottom half interrupt handler
+ *   arg        - The argument passed to both handlers
+ *   priority   - The priority of the interrupt thread
+ *   stack_size - The stack size of the interrupt thread or zero to use
+ *                CONFIG_IRQTHREAD_STACKSIZE
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQTHREAD
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size);
+#endif
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Select the set of CPUs that may service IRQ number 'irq'.  Bit n of
+ *   'cpuset' selects CPU n.  An IRQ with an explicitly set affinity is not
+ *   moved by automatic interrupt balancing.  If 'cpuset' is zero, the
+ *   current routing is kept but the IRQ is returned to automatic
+ *   balancing.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int irq_set_affinity(int irq, cpu_set_t cpuset);
+#endif
+
+/****************************************************************************
+ * Name: irq_get_affinity
+ *
+ * Description:
+ *   Return the set of CPUs that may service IRQ number 'irq'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if 'irq' is not a valid IRQ number.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset);
+#endif
+
 /****************************************************************************
  * Name: enter_critical_section
  *
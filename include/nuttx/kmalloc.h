@@ -56,6 +56,20 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+/* Statistics of the memory deallocations delayed by sched_kfree() and
+ * sched_ufree().  These are returned by sched_garbage_info().
+ */
+
+struct garbageinfo_s
+{
+  size_t ndeferred;            /* Total number of delayed deallocations */
+  size_t depth;                /* Number of deallocations now queued */
+  size_t maxdepth;             /* Most deallocations ever queued on one CPU */
+  unsigned long maxdrain;      /* Longest drain of one queue (microseconds) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -233,6 +247,12 @@ void sched_garbage_collection(void);
 
 bool sched_have_garbage(void);
 
+/* Return statistics of the delayed deallocations */
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+void sched_garbage_info(FAR struct garbageinfo_s *info);
+#endif
+
 #undef KMALLOC_EXTERN
 #if defined(__cplusplus)
 }
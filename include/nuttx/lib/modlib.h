@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/lib/modlib.h
  *
- *   Copyright (C) 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -171,6 +171,9 @@ struct module_s
   mod_initializer_t initializer;       /* Module initializer function */
 #endif
   struct mod_info_s modinfo;           /* Module information */
+#ifdef CONFIG_SYMTAB_HASHED
+  FAR struct symtab_hash_s *exphash;   /* Hash index of the exports */
+#endif
   FAR void *alloc;                     /* Allocated kernel memory */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   size_t textsize;                     /* Size of the kernel .text memory allocation */
@@ -209,6 +212,11 @@ struct mod_loadinfo_s
   Elf32_Ehdr        ehdr;        /* Buffered module file header */
   FAR Elf32_Shdr   *shdr;        /* Buffered module section headers */
   uint8_t          *iobuffer;    /* File I/O buffer */
+  FAR Elf32_Sym    *symtab;      /* Buffered symbol table or NULL */
+  FAR uint8_t      *strtab;      /* Buffered string table or NULL */
+#ifdef CONFIG_MODLIB_XIP
+  FAR const uint8_t *xipbase;    /* The file in memory-mapped media or NULL */
+#endif
 
   uint16_t          symtabidx;   /* Symbol table section index */
   uint16_t          strtabidx;   /* String table section index */
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -84,10 +85,31 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Large I/O buffers are optional */
+
+#if !defined(CONFIG_IOB_LARGE_NBUFFERS)
+#  define CONFIG_IOB_LARGE_NBUFFERS 0
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  if CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_LARGE_BUFSIZE must be larger than CONFIG_IOB_BUFSIZE
+#  endif
+#  define IOB_MAXBUFSIZE CONFIG_IOB_LARGE_BUFSIZE
+#else
+#  define IOB_MAXBUFSIZE CONFIG_IOB_BUFSIZE
+#endif
+
 /* IOB helpers */
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -103,6 +125,9 @@
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
+ *
+ * Large I/O buffers use the same structure but io_data[] extends for
+ * IOB_BUFSIZE() bytes.  Chains may mix both sizes.
  */
 
 struct iob_s
@@ -113,7 +138,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if IOB_MAXBUFSIZE < 256
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -121,6 +146,9 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  uint16_t io_bufsize;  /* Size of io_data[]; see IOB_BUFSIZE() */
+#endif
 
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
 };
@@ -152,6 +180,16 @@ struct iob_queue_s
 };
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+/* Describes one contiguous segment of an I/O buffer chain for scatter-gather
+ * DMA.  See iob_dmaout() and iob_dmain().
+ */
+
+struct iob_dmaseg_s
+{
+  uintptr_t addr;       /* Address of the first byte of the segment */
+  size_t    len;        /* Length of the segment in bytes */
+};
+
 /* NOTE: When you change any logic here, you must change the logic in
  * fs/procfs/fs_procfsiobinfo.c as it depends on having matching sequential
  * logic.
@@ -202,6 +240,9 @@ enum iob_user_e
 #ifdef CONFIG_NET_IPFORWARD
   IOBUSER_NET_IPFORWARD,
 #endif
+#ifdef CONFIG_NET_IPFRAG
+  IOBUSER_NET_IPFRAG,
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   IOBUSER_WIRELESS_RAD802154,
 #endif
@@ -230,6 +271,17 @@ struct iob_userstats_s
   int totalproduced;
 };
 
+#ifdef CONFIG_IOB_CACHE
+/* The state of the I/O buffer cache of one CPU */
+
+struct iob_cachestats_s
+{
+  unsigned int  ncached;  /* Number of free I/O buffers in the cache */
+  unsigned long hits;     /* Allocations satisfied by the cache */
+  unsigned long misses;   /* Allocations that found the cache empty */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -265,11 +317,36 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid);
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid);
 
+/****************************************************************************
+ * Name: iob_allocsize
+ *
+ * Description:
+ *   Allocate an I/O buffer of the smallest size class that can hold 'size'
+ *   bytes.  If no such buffer is free, a normal I/O buffer is allocated,
+ *   waiting if necessary, and the caller must chain more buffers as needed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_allocsize(unsigned int size, bool throttled,
+                                enum iob_user_e consumerid);
+
+/****************************************************************************
+ * Name: iob_tryallocsize
+ *
+ * Description:
+ *   Like iob_allocsize(), but without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryallocsize(unsigned int size, bool throttled,
+                                   enum iob_user_e consumerid);
+
 /****************************************************************************
  * Name: iob_navail
  *
  * Description:
- *   Return the number of of available IOBs.
+ *   Return the number of of available IOBs.  Large I/O buffers are not
+ *   included.
  *
  ****************************************************************************/
 
@@ -435,6 +512,19 @@ void iob_free_queue(FAR struct iob_queue_s *qhead,
                     enum iob_user_e producerid);
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+/****************************************************************************
+ * Name: iob_get_queue_size
+ *
+ * Description:
+ *   Return the total number of bytes in all of the I/O buffer chains of a
+ *   queue.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+unsigned int iob_get_queue_size(FAR struct iob_queue_s *queue);
+#endif /* CONFIG_IOB_NCHAINS > 0 */
+
 /****************************************************************************
  * Name: iob_copyin
  *
@@ -474,6 +564,60 @@ int iob_trycopyin(FAR struct iob_s *iob, FAR const uint8_t *src,
 int iob_copyout(FAR uint8_t *dest, FAR const struct iob_s *iob,
                 unsigned int len, unsigned int offset);
 
+/****************************************************************************
+ * Name: iob_dmaout
+ *
+ * Description:
+ *   Describe 'len' bytes of data starting at 'offset' in the I/O buffer
+ *   chain as a list of segments for a scatter-gather DMA transfer out of
+ *   memory, i.e., for TX.  The data cache is cleaned over each segment.
+ *   No data is copied.
+ *
+ * Returned Value:
+ *   The number of segments used (>= 0) or -E2BIG if more than 'nsegs'
+ *   segments would be needed.
+ *
+ ****************************************************************************/
+
+int iob_dmaout(FAR const struct iob_s *iob, unsigned int len,
+               unsigned int offset, FAR struct iob_dmaseg_s *segs,
+               int nsegs);
+
+/****************************************************************************
+ * Name: iob_dmain
+ *
+ * Description:
+ *   Prepare an empty I/O buffer chain to receive 'len' bytes by
+ *   scatter-gather DMA into memory, i.e., for RX.  The chain is extended
+ *   as necessary without waiting for buffers, the lengths are set to
+ *   describe the full space, and the data cache is flushed over each
+ *   segment.  When the transfer completes, iob_dmain_complete() must be
+ *   called before the data is accessed.
+ *
+ * Returned Value:
+ *   The number of segments used (> 0) OR a negative error code.
+ *
+ ****************************************************************************/
+
+int iob_dmain(FAR struct iob_s *iob, unsigned int len,
+              FAR struct iob_dmaseg_s *segs, int nsegs, bool throttled,
+              enum iob_user_e consumerid);
+
+/****************************************************************************
+ * Name: iob_dmain_complete
+ *
+ * Description:
+ *   Complete a DMA transfer into an I/O buffer chain prepared by
+ *   iob_dmain().  The data cache is invalidated over the 'rxlen' bytes
+ *   received and the chain is trimmed to that length, freeing any unused
+ *   buffers.  NULL is returned if nothing was received.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_dmain_complete(FAR struct iob_s *iob,
+                                     unsigned int rxlen,
+                                     enum iob_user_e producerid);
+
 /****************************************************************************
  * Name: iob_clone
  *
@@ -601,6 +745,26 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 FAR struct iob_userstats_s * iob_getuserstats(enum iob_user_e userid);
 #endif
 
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return the current state and the statistics of the I/O buffer cache of
+ *   one CPU.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU index, 0 .. CONFIG_SMP_NCPUS-1
+ *   stats - Location to return the cache state
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CACHE
+void iob_getcachestats(int cpu, FAR struct iob_cachestats_s *stats);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* _INCLUDE_NUTTX_MM_IOB_H */
 
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef _INCLUDE_NUTTX_MM_MEMPOOL_H
+#define _INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one pool of fixed-size memory blocks.  It should
+ * be treated as opaque by the users of the pool.
+ *
+ * Free blocks are kept in a singly linked list.  The link is stored in the
+ * first bytes of each free block, so the contents of those bytes are lost
+ * while the block is free.
+ */
+
+struct mempool_s
+{
+  FAR struct mempool_s *flink;   /* Supports a list of all pools */
+  FAR const char *name;          /* Name of the pool, e.g. for procfs */
+  FAR sq_entry_t *freelist;      /* List of free blocks */
+  size_t bsize;                  /* Size of one block */
+  uint16_t ntotal;               /* Total number of blocks */
+  uint16_t nfree;                /* Number of free blocks */
+  uint16_t npeak;                /* Largest number of blocks in use */
+  uint16_t nreserve;             /* Free blocks reserved for interrupt level */
+  uint16_t nexpand;              /* Blocks to add when the pool grows */
+#ifdef CONFIG_SPINLOCK_SCOPED
+  spinlock_t lock;               /* Protects the free list and statistics */
+#endif
+};
+
+/* Statistics of one pool as returned by mempool_foreach() */
+
+struct mempoolinfo_s
+{
+  FAR const char *name;          /* Name of the pool */
+  size_t bsize;                  /* Size of one block */
+  unsigned int ntotal;           /* Total number of blocks */
+  unsigned int nfree;            /* Number of free blocks */
+  unsigned int npeak;            /* Largest number of blocks in use */
+};
+
+typedef CODE void (*mempool_handler_t)(FAR const struct mempoolinfo_s *info,
+                                       FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a pool of fixed-size blocks and register it so that its
+ *   statistics are reported in /proc/mempool.
+ *
+ * Input Parameters:
+ *   pool     - The pool to be initialized
+ *   name     - The name of the pool.  The string is not copied.
+ *   blocks   - The initial blocks, typically a static array.  If NULL, the
+ *              initial blocks are allocated from the kernel heap.
+ *   bsize    - The size of one block.  This is the stride between the
+ *              blocks in 'blocks' and must be at least sizeof(sq_entry_t).
+ *   nblocks  - The number of initial blocks
+ *   nreserve - The number of free blocks that only interrupt handlers may
+ *              allocate.  Task level allocations leave these free and grow
+ *              the pool instead, if it may grow.
+ *   nexpand  - The number of blocks to allocate from the kernel heap when
+ *              a task level allocation finds no free block.  Zero if the
+ *              pool may not grow.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the initial blocks could not be
+ *   allocated.
+ *
+ * Assumptions:
+ *   Pools are never destroyed.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       FAR void *blocks, size_t bsize, unsigned int nblocks,
+                       unsigned int nreserve, unsigned int nexpand);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from a pool.  This may be called from interrupt
+ *   handlers.  The contents of the block are undefined.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated block or NULL if none is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the pool that it was allocated from.  This may be
+ *   called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   pool - The pool that the block came from
+ *   blk  - The block to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
+
+/****************************************************************************
+ * Name: mempool_nfree
+ *
+ * Description:
+ *   Return the number of free blocks in a pool.
+ *
+ ****************************************************************************/
+
+#define mempool_nfree(p) ((unsigned int)(p)->nfree)
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call 'handler' with the statistics of each registered pool.  No lock
+ *   is held while the handler runs.
+ *
+ * Input Parameters:
+ *   handler - The function to be called for each pool
+ *   arg     - An argument passed through to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INCLUDE_NUTTX_MM_MEMPOOL_H */
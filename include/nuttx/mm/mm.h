@@ -156,6 +156,19 @@
 #  define MM_MAX_SHIFT   B2C_SHIFT(22)  /*  4 Mb */
 #endif
 
+/* The allocation tags of CONFIG_MM_TRACE make the chunk headers larger.
+ * Increase the minimum chunk size so that it still holds a free node.
+ */
+
+#ifdef CONFIG_MM_TRACE
+#  undef MM_MIN_SHIFT
+#  if UINTPTR_MAX <= UINT32_MAX
+#    define MM_MIN_SHIFT B2C_SHIFT( 5)  /* 32 bytes */
+#  else
+#    define MM_MIN_SHIFT B2C_SHIFT( 6)  /* 64 bytes */
+#  endif
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -178,6 +191,71 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Two-level segregated fit (TLSF) definitions.  With CONFIG_MM_TLSF, each
+ * of the MM_NNODES power-of-two size ranges is further divided into
+ * MM_TLSF_SLCOUNT linear sub-ranges, each with its own, unordered free
+ * list.  One bitmap records which first-level ranges have free chunks and
+ * one bitmap per first-level range records which of its sub-ranges have
+ * free chunks.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_TLSF_SLBITS   CONFIG_MM_TLSF_SLBITS
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLBITS)
+#endif
+
+/* Small-object cache definitions.  The cache holds allocated chunks of the
+ * smallest sizes in per-CPU free lists in front of the heap.  Each cache
+ * class holds chunks of exactly one chunk size (in units of MM_MIN_CHUNK).
+ *
+ * The cache depends on the ability to disable local interrupts, so it is
+ * not available to the user-space copy of the allocator in the PROTECTED
+ * and KERNEL builds.  The cache state is still present in struct mm_heap_s
+ * in that case so that the heap structure layout does not change.
+ */
+
+#ifdef CONFIG_MM_CACHE
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+#    define MM_HAVE_CACHE 1
+#  endif
+
+#  ifdef CONFIG_SMP
+#    define MM_CACHE_NCPUS       CONFIG_SMP_NCPUS
+#  else
+#    define MM_CACHE_NCPUS       1
+#  endif
+
+#  define MM_CACHE_MAXCHUNK \
+     MM_ALIGN_UP(CONFIG_MM_CACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#  define MM_CACHE_NCLASSES      (MM_CACHE_MAXCHUNK >> MM_MIN_SHIFT)
+#  define MM_CACHE_NDX(s)        (((s) >> MM_MIN_SHIFT) - 1)
+#  define MM_CACHE_SIZE(n)       ((size_t)((n) + 1) << MM_MIN_SHIFT)
+#endif
+
+/* Heap statistics.  The latency measurements use the critical section
+ * monitor timer which is not available to the user-space copy of the
+ * allocator in the PROTECTED and KERNEL builds.  The statistics are still
+ * present in struct mm_heap_s in that case so that the heap structure layout
+ * does not change.
+ */
+
+#ifdef CONFIG_MM_HEAPSTATS
+#  if defined(CONFIG_SCHED_CRITMONITOR) && \
+      (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#    define MM_HAVE_LATENCY 1
+#  endif
+
+#  define MM_HEAPSTATS_MAX(m,v) \
+     do \
+       { \
+         if ((v) > (m)) \
+           { \
+             (m) = (v); \
+           } \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -201,11 +279,22 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_TRACE
+  uint32_t seqno;          /* Allocation sequence number */
+  pid_t pid;               /* PID of the allocating thread */
+  uint16_t reserved;       /* Pad to the next pointer boundary */
+  FAR void *caller;        /* Address of the allocating code */
+#if UINTPTR_MAX <= UINT32_MAX
+  uint32_t reserved2;      /* Keep the header a multiple of 8 bytes */
+#endif
+#endif
 };
 
 /* What is the size of the allocnode? */
 
-#ifdef CONFIG_MM_SMALL
+#if defined(CONFIG_MM_TRACE)
+# define SIZEOF_MM_ALLOCNODE   B2C(24)
+#elif defined(CONFIG_MM_SMALL)
 # define SIZEOF_MM_ALLOCNODE   B2C(4)
 #else
 # define SIZEOF_MM_ALLOCNODE   B2C(8)
@@ -220,6 +309,15 @@ struct mm_freenode_s
 {
   mmsize_t size;                   /* Size of this chunk */
   mmsize_t preceding;              /* Size of the preceding chunk */
+#ifdef CONFIG_MM_TRACE
+  uint32_t seqno;                  /* Unused, overlays mm_allocnode_s */
+  pid_t pid;
+  uint16_t reserved;
+  FAR void *caller;
+#if UINTPTR_MAX <= UINT32_MAX
+  uint32_t reserved2;
+#endif
+#endif
   FAR struct mm_freenode_s *flink; /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
 };
@@ -232,6 +330,76 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_CACHE
+/* This describes one free chunk held in a small-object cache.  The chunk is
+ * still marked as allocated in the heap; the link lives in the user part of
+ * the chunk.
+ */
+
+struct mm_cachenode_s
+{
+  FAR struct mm_cachenode_s *flink;
+};
+
+/* This describes the small-object cache of one CPU */
+
+struct mm_cache_s
+{
+  FAR struct mm_cachenode_s *mc_head[MM_CACHE_NCLASSES];
+  uint16_t mc_count[MM_CACHE_NCLASSES];
+  uint32_t mc_hits;                /* Allocations satisfied from the cache */
+  uint32_t mc_misses;              /* Allocations that went to the heap */
+};
+#endif
+
+#ifdef CONFIG_MM_TRACE
+/* This describes the heap usage of one thread.  The table is indexed by
+ * the hashed PID, just as is the scheduler's PID hash table.
+ */
+
+struct mm_traceusage_s
+{
+  pid_t pid;                       /* PID of the thread using this entry */
+  uint16_t nallocs;                /* Number of live allocations */
+  size_t used;                     /* Bytes presently allocated */
+  size_t peak;                     /* High-water mark of 'used' */
+};
+
+/* Callback used by mm_tracewalk() for each allocated chunk */
+
+typedef CODE void (*mm_tracewalk_t)(FAR const struct mm_allocnode_s *node,
+                                    FAR void *arg);
+
+/* No thread owns the chunk */
+
+#  define MM_TRACE_NOPID           ((pid_t)-1)
+
+/* Record the caller of an allocation interface */
+
+#  ifdef __GNUC__
+#    define MM_TRACE_CALLER()      __builtin_return_address(0)
+#  else
+#    define MM_TRACE_CALLER()      NULL
+#  endif
+
+#  define MM_TRACE_SETCALLER(m,c) \
+     do \
+       { \
+         ((FAR struct mm_allocnode_s *) \
+          ((FAR char *)(m) - SIZEOF_MM_ALLOCNODE))->caller = (c); \
+       } \
+     while (0)
+
+#  define MM_TRACE_COPY(d,s) \
+     do \
+       { \
+         (d)->seqno  = (s)->seqno; \
+         (d)->pid    = (s)->pid; \
+         (d)->caller = (s)->caller; \
+       } \
+     while (0)
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -257,13 +425,78 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are maintained in one doubly linked list per size class.
+   * The bitmaps record which of the lists are not empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_NNODES];
+  FAR struct mm_freenode_s *mm_freelist[MM_NNODES][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_TRACE
+  /* Allocation tracing:  The sequence number of the next allocation and the
+   * heap usage of each thread.
+   */
+
+  uint32_t mm_seqno;
+  struct mm_traceusage_s mm_traceusage[CONFIG_MAX_TASKS];
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Per-CPU small-object caches */
+
+  struct mm_cache_s mm_cache[MM_CACHE_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_REALLOC_STATS
+  /* realloc() statistics */
+
+  uint32_t mm_reallocinplace;      /* Resized without moving the data */
+  uint32_t mm_reallocmoved;        /* Moved into the preceding free chunk */
+  uint32_t mm_realloccopied;       /* Copied to a new allocation */
+#endif
+
+#ifdef CONFIG_MM_HEAPSTATS
+  /* Allocation performance statistics.  Times are in the units of
+   * up_critmon_gettime().
+   */
+
+  uint32_t mm_nsearches;           /* Number of free list searches */
+  uint32_t mm_nscanned;            /* Free nodes visited by all searches */
+  uint32_t mm_maxscanned;          /* Most free nodes visited by one search */
+  uint32_t mm_maxsemwait;          /* Longest wait for the MM semaphore */
+  uint32_t mm_maxmalloc;           /* Longest mm_malloc() */
+  uint32_t mm_maxfree;             /* Longest mm_free() */
+#endif
+};
+
+#ifdef CONFIG_MM_HEAPSTATS
+/* This is a snapshot of the heap statistics returned by mm_heapstats().
+ * The free chunks are binned just as are the heads of the free lists:  Bin
+ * 'n' holds the chunks of size 2**(n + MM_MIN_SHIFT) up to twice that.
+ */
+
+struct mm_heapstats_s
+{
+  uint32_t nfree[MM_NNODES];       /* Number of free chunks in each bin */
+  size_t   freesize[MM_NNODES];    /* Total size of the free chunks in each bin */
+  uint32_t nsearches;              /* Number of free list searches */
+  uint32_t nscanned;               /* Free nodes visited by all searches */
+  uint32_t maxscanned;             /* Most free nodes visited by one search */
+  uint32_t maxsemwait;             /* Longest wait for the MM semaphore */
+  uint32_t maxmalloc;              /* Longest mm_malloc() */
+  uint32_t maxfree;                /* Longest mm_free() */
 };
+#endif
 
 /****************************************************************************
  * Public Data
@@ -368,6 +601,7 @@ void kmm_givesemaphore(void);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t alignsize);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -378,6 +612,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -509,15 +744,60 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c ********************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_TLSF
+void mm_tlsf_initialize(FAR struct mm_heap_s *heap);
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap,
+                                         size_t size);
+#endif
 
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_trace.c ****************************************/
+
+#ifdef CONFIG_MM_TRACE
+void mm_traceinitialize(FAR struct mm_heap_s *heap);
+void mm_tracealloc(FAR struct mm_heap_s *heap, FAR void *mem,
+                   FAR void *caller);
+void mm_tracefree(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_traceresize(FAR struct mm_heap_s *heap, FAR void *mem,
+                    size_t oldsize);
+void mm_traceexit(FAR struct mm_heap_s *heap, pid_t pid);
+int  mm_traceusage(FAR struct mm_heap_s *heap, int ndx,
+                   FAR struct mm_traceusage_s *usage);
+
+/* Functions contained in mm_mallinfo.c *************************************/
+
+void mm_tracewalk(FAR struct mm_heap_s *heap, mm_tracewalk_t handler,
+                  FAR void *arg);
+#endif
+
+#ifdef CONFIG_MM_HEAPSTATS
+int mm_heapstats(FAR struct mm_heap_s *heap,
+                 FAR struct mm_heapstats_s *stats);
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_CACHE
+void mm_cacheinitialize(FAR struct mm_heap_s *heap);
+#ifdef MM_HAVE_CACHE
+FAR void *mm_cachealloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cachefree(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
+void mm_cacheinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -295,6 +295,87 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                           FAR unsigned int *prio,
                           FAR const struct timespec *abstime);
 
+/****************************************************************************
+ * Name: nxmq_receive_batch
+ *
+ * Description:
+ *   Receive up to nbatch messages from the message queue (mqdes) in one
+ *   call.  This waits (unless O_NONBLOCK is set) only for the first
+ *   message; then any further messages that are already in the queue are
+ *   received without waiting.  This is the internal OS version of
+ *   mq_receive_batch():  It is not a cancellation point and it does not
+ *   modify the errno value.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   batch  - Describes the buffers to receive the messages.  Each buffer
+ *            must be at least as large as the "mq_msgsize" attribute of
+ *            the message queue.
+ *   nbatch - The number of entries in batch
+ *
+ * Returned Value:
+ *   The number of messages received (at least one) is returned on success.
+ *   The length and the priority of each message are returned in batch.  A
+ *   negated errno value is returned on failure (see mq_receive()).
+ *
+ ****************************************************************************/
+
+int nxmq_receive_batch(mqd_t mqdes, FAR struct mq_rcvbatch_s *batch,
+                       int nbatch);
+
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: nxmq_send_zc
+ *
+ * Description:
+ *   Send a message without copying the message data.  The message is in a
+ *   buffer allocated with mq_zcalloc(); ownership of the buffer moves to
+ *   the message queue and then to the receiver.  This is the internal OS
+ *   version of mq_send_zc():  It is not a cancellation point and it does
+ *   not modify the errno value.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buf    - The buffer returned by mq_zcalloc() that holds the message
+ *   msglen - The length of the message in bytes.  This is limited only by
+ *            the size of the buffer, not by the "mq_msgsize" attribute.
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see mq_send()).  The caller still owns the buffer if the
+ *   message could not be sent.
+ *
+ ****************************************************************************/
+
+int nxmq_send_zc(mqd_t mqdes, FAR void *buf, size_t msglen,
+                 unsigned int prio);
+
+/****************************************************************************
+ * Name: nxmq_receive_zc
+ *
+ * Description:
+ *   Receive a message without copying the message data.  The caller becomes
+ *   the owner of the returned buffer and must free it with mq_zcfree().
+ *   A message that was sent with a copy is copied once into a newly
+ *   allocated buffer.  This is the internal OS version of mq_receive_zc():
+ *   It is not a cancellation point and it does not modify the errno value.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   buf   - The location to return the buffer holding the message
+ *   prio  - If not NULL, the location to return the message priority
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_zc(mqd_t mqdes, FAR void **buf,
+                        FAR unsigned int *prio);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
@@ -77,6 +77,12 @@
 #define COMMAND_STATUS                  0x70
 #define COMMAND_RESET                   0xff
 
+/* Nand flash cache commands (ONFI optional commands) */
+
+#define COMMAND_READ_CACHE              0x31
+#define COMMAND_READ_CACHE_END          0x3f
+#define COMMAND_WRITE_CACHE             0x15
+
 /* Nand flash commands (small blocks) */
 
 #define COMMAND_READ_A                  0x00
@@ -232,6 +238,56 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READPAGES
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages within one block of a NAND
+ *   FLASH into the provided buffer.  Hardware ECC checking will be
+ *   performed if so configured.  This method is optional.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read.  page + npages does not exceed the
+ *            number of pages per block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in succes; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_READPAGES(r,b,p,n,d) ((r)->readpages(r,b,p,n,d))
+#endif
+
+/****************************************************************************
+ * Name: NAND_WRITEPAGES
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages within one block of a NAND
+ *   FLASH from the provided buffer.  Hardware ECC calculation will be
+ *   performed if so configured.  This method is optional.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write.  page + npages does not exceed the
+ *            number of pages per block.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in succes; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_WRITEPAGES(r,b,p,n,d) ((r)->writepages(r,b,p,n,d))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -268,6 +324,17 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  /* Optional multi-page transfers.  NULL if not supported. */
+
+  CODE int (*readpages)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data);
+  CODE int (*writepages)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data);
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers*/
 
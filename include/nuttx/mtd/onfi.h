@@ -60,6 +60,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Optional commands supported (bytes 8-9 of the parameter page) */
+
+#define ONFI_OPTCMD_CACHEPROGRAM (1 << 0) /* Page cache program */
+#define ONFI_OPTCMD_CACHEREAD    (1 << 1) /* Read cache commands */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -73,6 +78,7 @@ struct onfi_pgparam_s
   uint8_t luns;           /* Number of logical units */
   uint8_t eccsize;        /* Number of bits of ECC correction */
   uint8_t model;          /* Device model */
+  uint16_t optcmds;       /* Optional commands.  See ONFI_OPTCMD_* */
   uint16_t sparesize;     /* Number of spare bytes per page */
   uint16_t pagesperblock; /* Number of pages per block */
   uint16_t blocksperlun;  /* Number of blocks per logical unit (LUN) */
@@ -186,6 +192,72 @@ bool onfi_embeddedecc(FAR const struct onfi_pgparam_s *onfi,
 bool onfi_ebidetect(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t
                     dataaddr);
 
+/****************************************************************************
+ * Name: onfi_cacheread
+ *
+ * Description:
+ *   Read consecutive pages with the read cache sequential command so that
+ *   the array read of the next page overlaps the data output of the
+ *   current page.  The device must support ONFI_OPTCMD_CACHEREAD and have
+ *   an 8-bit data bus.  Only the data areas are read; any ECC is left to
+ *   the caller.
+ *
+ * Input Parameters:
+ *   cmdaddr   - NAND command address base
+ *   addraddr  - NAND address address base
+ *   dataaddr  - NAND data address
+ *   rowaddr   - Row address of the first page
+ *   rowcycles - Number of row address cycles of the device
+ *   pagesize  - Number of data bytes per page
+ *   npages    - Number of pages to read
+ *   buffer    - Buffer where the data will be stored
+ *
+ * Returned Value:
+ *   OK is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+int onfi_cacheread(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
+                   uint32_t rowaddr, unsigned int rowcycles,
+                   unsigned int pagesize, unsigned int npages,
+                   FAR uint8_t *buffer);
+#endif
+
+/****************************************************************************
+ * Name: onfi_cacheprogram
+ *
+ * Description:
+ *   Program consecutive pages with the page cache program command so that
+ *   the data input of the next page overlaps the programming of the
+ *   current page.  The device must support ONFI_OPTCMD_CACHEPROGRAM and
+ *   have an 8-bit data bus.  Only the data areas are written; any ECC is
+ *   left to the caller.
+ *
+ * Input Parameters:
+ *   cmdaddr   - NAND command address base
+ *   addraddr  - NAND address address base
+ *   dataaddr  - NAND data address
+ *   rowaddr   - Row address of the first page
+ *   rowcycles - Number of row address cycles of the device
+ *   pagesize  - Number of data bytes per page
+ *   npages    - Number of pages to program
+ *   buffer    - Buffer containing the data to be written
+ *
+ * Returned Value:
+ *   OK is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+int onfi_cacheprogram(uintptr_t cmdaddr, uintptr_t addraddr,
+                      uintptr_t dataaddr, uint32_t rowaddr,
+                      unsigned int rowcycles, unsigned int pagesize,
+                      unsigned int npages, FAR const uint8_t *buffer);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -96,6 +96,14 @@ struct mtd_smart_procfs_data_s
 #endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   uint32_t            uneven_wearcount; /* Number of uneven block erases */
+  uint8_t             minwearlevel;     /* Lowest erase block wear level */
+  uint8_t             maxwearlevel;     /* Highest erase block wear level */
+#endif
+  uint32_t            relocations;      /* Number of sectors relocated by writes */
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  uint16_t            cacheentries;     /* Number of sector map cache entries used */
+  uint32_t            cachehits;        /* Number of sector map cache hits */
+  uint32_t            cachemisses;      /* Number of sector map cache misses */
 #endif
 };
 
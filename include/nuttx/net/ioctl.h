@@ -122,6 +122,14 @@
 #define SIOCTELNET       _SIOC(0x0029)  /* Create a Telnet sessions.
                                          * See include/nuttx/net/telnet.h */
 
+/* Zero-copy TCP receive (FLAT build only) **********************************/
+
+#define SIOCRECVIOB      _SIOC(0x002a)  /* Take the next read-ahead I/O
+                                         * buffer chain.  arg:
+                                         * FAR struct iob_s ** */
+#define SIOCFREEIOB      _SIOC(0x002b)  /* Release an I/O buffer chain.
+                                         * arg: FAR struct iob_s * */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -0,0 +1,179 @@
+/****************************************************************************
+ * include/nuttx/net/napi.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_NAPI_H
+#define __INCLUDE_NUTTX_NET_NAPI_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_NAPI
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+struct netdev_napi_s;
+
+/* Process up to 'budget' received frames, and any TX completions, and
+ * return the number of frames processed.  Called on the work queue with
+ * the network locked and the device interrupts masked.
+ */
+
+typedef CODE int (*netdev_napipoll_t)(FAR struct netdev_napi_s *napi,
+                                      int budget);
+
+/* Mask (enable == false) or unmask (enable == true) the device interrupts
+ * that schedule the poll.  May be called from the interrupt handler.
+ */
+
+typedef CODE void (*netdev_napiirq_t)(FAR struct netdev_napi_s *napi,
+                                      bool enable);
+
+/* The polling state of one device.  This is normally a member of the
+ * driver state structure; the fields are private to net/netdev except for
+ * the statistics.
+ */
+
+struct netdev_napi_s
+{
+  FAR struct net_driver_s *dev;  /* The device being polled */
+  netdev_napipoll_t poll;        /* Driver poll callback */
+  netdev_napiirq_t irqctl;       /* Driver interrupt mask callback */
+  struct work_s work;            /* Deferred poll work */
+  int16_t budget;                /* Maximum frames per poll callback */
+  uint8_t qid;                   /* Work queue ID, e.g. LPWORK */
+  volatile bool scheduled;       /* Poll scheduled, interrupts masked */
+
+#ifdef CONFIG_NETDEV_STATISTICS
+  uint32_t polls;                /* Number of poll callbacks */
+  uint32_t frames;               /* Number of frames processed */
+  uint32_t exhausted;            /* Number of polls that used the budget */
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: netdev_napi_init
+ *
+ * Description:
+ *   Initialize the polling state of a device.
+ *
+ * Input Parameters:
+ *   napi   - The polling state to initialize
+ *   dev    - The network device
+ *   poll   - The budget-limited driver poll callback
+ *   irqctl - The driver interrupt mask callback
+ *   qid    - The work queue to poll on.  Should be LPWORK.
+ *   budget - The maximum number of frames per poll callback, or zero to
+ *            use CONFIG_NETDEV_NAPI_BUDGET
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_napi_init(FAR struct netdev_napi_s *napi,
+                      FAR struct net_driver_s *dev,
+                      netdev_napipoll_t poll, netdev_napiirq_t irqctl,
+                      int qid, int budget);
+
+/****************************************************************************
+ * Name: netdev_napi_schedule
+ *
+ * Description:
+ *   Mask the device interrupts and schedule the poll callback, unless it
+ *   is already scheduled.  Normally called from the interrupt handler.
+ *
+ *   The interrupts are unmasked again when a poll callback returns less
+ *   than the budget.  Otherwise the poll callback is re-queued, behind any
+ *   other work on the queue, so that a flood of frames cannot starve the
+ *   rest of the system.
+ *
+ * Input Parameters:
+ *   napi - The polling state of the device
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the poll was scheduled; -EBUSY is returned if
+ *   it was already scheduled.
+ *
+ ****************************************************************************/
+
+int netdev_napi_schedule(FAR struct netdev_napi_s *napi);
+
+/****************************************************************************
+ * Name: netdev_napi_cancel
+ *
+ * Description:
+ *   Cancel a scheduled poll, e.g. when the interface is brought down.  The
+ *   device interrupts are left masked.
+ *
+ * Input Parameters:
+ *   napi - The polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_napi_cancel(FAR struct netdev_napi_s *napi);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NETDEV_NAPI */
+#endif /* __INCLUDE_NUTTX_NET_NAPI_H */
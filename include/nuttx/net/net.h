@@ -956,6 +956,44 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                        int flags, FAR struct sockaddr *from,
                        FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' datagrams into 'msgvec' with the network locked
+ *   once for the whole batch.  The first datagram is waited for unless the
+ *   socket is non-blocking or MSG_DONTWAIT is set.  With MSG_WAITFORONE,
+ *   the remaining datagrams are only taken if already available.
+ *   'timeout', if not NULL, limits the time spent collecting datagrams.
+ *   Each message must have exactly one I/O vector.
+ *
+ * Returned Value:
+ *   The number of messages received (and msg_len of each set) is returned
+ *   on success; a negated errno value is returned if no message was
+ *   received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   Send up to 'vlen' datagrams from 'msgvec' with the network locked once
+ *   for the whole batch.  Each message must have exactly one I/O vector.
+ *
+ * Returned Value:
+ *   The number of messages sent (and msg_len of each set) is returned on
+ *   success; a negated errno value is returned if no message was sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /* recv using the underlying socket structure */
 
 #define psock_recv(psock,buf,len,flags) \
@@ -1431,6 +1469,45 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
                      size_t count);
 #endif
 
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Receive data from a connected TCP socket without copying it.  The
+ *   I/O buffer chain at the head of the read-ahead queue is passed to the
+ *   caller, which becomes its owner and must release it with
+ *   psock_freeiob().
+ *
+ * Input Parameters:
+ *   psock - A connected TCP socket
+ *   iob   - The location to return the I/O buffer chain
+ *   flags - Receive flags.  MSG_DONTWAIT is supported.
+ *
+ * Returned Value:
+ *   The number of bytes in the returned I/O buffer chain is returned on
+ *   success.  Zero is returned, and no chain, if the peer has closed the
+ *   connection.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RECVIOB
+struct iob_s;
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags);
+#endif
+
+/****************************************************************************
+ * Name: psock_freeiob
+ *
+ * Description:
+ *   Release an I/O buffer chain obtained with psock_recviob().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RECVIOB
+void psock_freeiob(FAR struct iob_s *iob);
+#endif
+
 /****************************************************************************
  * Name: psock_vfcntl
  *
@@ -51,6 +51,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <sched.h>
 
 #ifdef CONFIG_NET_MCASTGROUP
 #  include <queue.h>
@@ -155,6 +156,39 @@
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Hardware offload capabilities in d_offload.  The driver sets these before
+ * netdev_register().
+ *
+ *   NETDEV_TXCSUM_IP - The hardware inserts the IPv4 header checksum of
+ *                      outgoing packets.  The stack leaves the field zero.
+ *   NETDEV_TXCSUM_L4 - The hardware inserts the complete TCP and UDP
+ *                      checksum (including the pseudo-header) of outgoing
+ *                      IPv4 and IPv6 packets.  The stack leaves the field
+ *                      zero.
+ *   NETDEV_RXCSUM_IP - The driver discards received packets with a bad
+ *                      IPv4 header checksum.
+ *   NETDEV_RXCSUM_L4 - The driver discards received packets with a bad TCP
+ *                      or UDP checksum.  Reassembled IPv4 fragments are
+ *                      still verified in software.
+ *   NETDEV_TSO       - TCP segmentation offload:  The driver accepts TCP
+ *                      packets with up to d_tsomax bytes of payload and
+ *                      splits them into segments of d_tsomss bytes.  The
+ *                      d_buf must be large enough.  Requires
+ *                      NETDEV_TXCSUM_IP and NETDEV_TXCSUM_L4.
+ */
+
+#define NETDEV_TXCSUM_IP   (1 << 0)
+#define NETDEV_TXCSUM_L4   (1 << 1)
+#define NETDEV_RXCSUM_IP   (1 << 2)
+#define NETDEV_RXCSUM_L4   (1 << 3)
+#define NETDEV_TSO         (1 << 4)
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_OFFLOAD(dev,f)  (((dev)->d_offload & (f)) != 0)
+#else
+#  define NETDEV_OFFLOAD(dev,f)  (0)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -217,6 +251,18 @@ struct netdev_varaddr_s
 };
 #endif
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* This structure describes one RX/TX queue of a multiqueue device.  The
+ * array of queues is provided by the driver.
+ */
+
+struct netdev_queue_s
+{
+  FAR uint8_t *q_buf;           /* The packet buffer of the queue */
+  int16_t q_irq;                /* The IRQ of the queue or -1 if none */
+};
+#endif
+
 /* This structure collects information that is specific to a specific network
  * interface driver.  If the hardware platform supports only a single instance
  * of this structure.
@@ -255,6 +301,27 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Hardware offloads.  See NETDEV_TXCSUM_IP etc. above.  The two sizes
+   * are only used with NETDEV_TSO:  d_tsomax is set by the driver and
+   * d_tsomss is set by the stack for each packet that is larger than the
+   * MTU.
+   */
+
+  uint8_t d_offload;            /* Offload capabilities of the device */
+  uint16_t d_tsomax;            /* Maximum TCP payload of a TSO packet */
+  uint16_t d_tsomss;            /* Segment size of the current TSO packet */
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Multiple RX/TX queues.  d_buf refers to the buffer of the queue that
+   * is currently being processed.  See netdev_setqueue().
+   */
+
+  uint8_t d_nqueues;            /* Number of entries in d_queues[] */
+  FAR struct netdev_queue_s *d_queues;
+#endif
+
   /* Link layer address */
 
   union
@@ -343,6 +410,17 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* When d_sndsumlen is non-zero and equal to d_sndlen, d_sndsum holds the
+   * raw checksum of the d_sndlen bytes at d_appdata.  It is computed by
+   * devif_iob_send() while copying the data and consumed by the TCP and UDP
+   * checksum logic.  Anything else that writes to d_appdata must clear it.
+   */
+
+  uint16_t d_sndsum;
+  uint16_t d_sndsumlen;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -390,6 +468,16 @@ struct net_driver_s
   int (*d_ifup)(FAR struct net_driver_s *dev);
   int (*d_ifdown)(FAR struct net_driver_s *dev);
   int (*d_txavail)(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+  /* Optional:  Send one complete link layer frame immediately.  'buf'
+   * belongs to another device; the frame must be sent or copied before
+   * returning.  Return -EBUSY if the transmitter is not ready.  Called
+   * with the network locked.
+   */
+
+  int (*d_transmit)(FAR struct net_driver_s *dev, FAR const uint8_t *buf,
+                    unsigned int len);
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
   int (*d_addmac)(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
   int (*d_rmmac)(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
@@ -406,6 +494,27 @@ struct net_driver_s
 
 typedef CODE int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NET_ETHERNET
+/* Driver callbacks used by netdev_input_batch() */
+
+struct netdev_rxops_s
+{
+  /* Set up d_buf and d_len for the next received frame.  Returns a negated
+   * errno value if there are no more frames.
+   */
+
+  CODE int (*rxframe)(FAR struct net_driver_s *dev);
+
+  /* Send the reply frame in d_buf and d_len */
+
+  CODE int (*txframe)(FAR struct net_driver_s *dev);
+
+  /* Release the receive buffer in d_buf (optional) */
+
+  CODE void (*rxdone)(FAR struct net_driver_s *dev);
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -608,6 +717,147 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_input
+ *
+ * Description:
+ *   Dispatch the Ethernet frame in d_buf to the network.  If the frame
+ *   results in an outgoing packet, the link layer addresses of that packet
+ *   are resolved and it is sent with 'txframe'.
+ *
+ * Input Parameters:
+ *   dev     - The network device.  d_buf and d_len describe the frame.
+ *   txframe - Sends the frame in d_buf and d_len
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the frame was dispatched; -EPROTO is returned
+ *   if the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ETHERNET
+int netdev_input(FAR struct net_driver_s *dev,
+                 CODE int (*txframe)(FAR struct net_driver_s *dev));
+#endif
+
+/****************************************************************************
+ * Name: netdev_input_batch
+ *
+ * Description:
+ *   Receive up to 'budget' frames from the driver with ops->rxframe() and
+ *   dispatch each of them with netdev_input(), taking the network lock once
+ *   for the whole batch.
+ *
+ * Input Parameters:
+ *   dev    - The network device
+ *   ops    - The driver callbacks
+ *   budget - The maximum number of frames to receive
+ *
+ * Returned Value:
+ *   The number of frames received.  If this is equal to 'budget', more
+ *   frames may be pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ETHERNET
+int netdev_input_batch(FAR struct net_driver_s *dev,
+                       FAR const struct netdev_rxops_s *ops, int budget);
+#endif
+
+/****************************************************************************
+ * Name: netdev_flowhash
+ *
+ * Description:
+ *   Calculate the flow hash of an IPv4 or IPv6 packet from its addresses
+ *   and, for TCP and UDP, its port numbers.  All packets of a flow have the
+ *   same hash.
+ *
+ * Input Parameters:
+ *   ipbuf - The start of the IP header
+ *   len   - The number of valid bytes at 'ipbuf'
+ *
+ * Returned Value:
+ *   The flow hash or zero if the packet is not an IP packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+uint32_t netdev_flowhash(FAR const uint8_t *ipbuf, unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: netdev_selectqueue
+ *
+ * Description:
+ *   Select the queue of the packet in d_buf and d_len from its flow hash.
+ *   This is used to steer outgoing packets, and incoming packets of devices
+ *   without hardware steering, to one of the device queues.
+ *
+ * Input Parameters:
+ *   dev - The network device.  d_buf and d_len describe the packet,
+ *         including the link layer header.
+ *
+ * Returned Value:
+ *   The queue index, in the range 0 to d_nqueues - 1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+int netdev_selectqueue(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: netdev_setqueue
+ *
+ * Description:
+ *   Make the buffer of queue 'qid' the current packet buffer, d_buf, of the
+ *   device.  The driver calls this before passing a packet received on the
+ *   queue to the network, or before polling the network for a packet to
+ *   send on the queue.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *   qid - The queue index
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'qid' is not
+ *   a valid queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+int netdev_setqueue(FAR struct net_driver_s *dev, int qid);
+#endif
+
+/****************************************************************************
+ * Name: netdev_queue_affinity
+ *
+ * Description:
+ *   Bind the interrupt of queue 'qid' to the set of CPUs 'cpuset', so that
+ *   the flows steered to different queues are serviced by different CPUs.
+ *
+ * Input Parameters:
+ *   dev    - The network device
+ *   qid    - The queue index
+ *   cpuset - Bit n selects CPU n.  Zero releases the binding.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_MULTIQUEUE) && defined(CONFIG_IRQ_AFFINITY)
+int netdev_queue_affinity(FAR struct net_driver_s *dev, int qid,
+                          cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
@@ -675,6 +925,31 @@ uint16_t net_chksum(FAR uint16_t *data, uint16_t len);
 
 void net_incr32(FAR uint8_t *op32, uint16_t op16);
 
+/****************************************************************************
+ * Name: up_chksum32
+ *
+ * Description:
+ *   Accumulate 'nwords' 32-bit words into a 32-bit one's complement sum in
+ *   native byte order, adding any carry out of bit 31 back into bit 0.
+ *   This is the inner loop of the Internet checksum.
+ *
+ *   If CONFIG_NET_ARCH_CHKSUM32 is defined, then this function must be
+ *   provided by architecture-specific logic.
+ *
+ * Input Parameters:
+ *   sum    - The partial sum to start with
+ *   data   - A pointer to the 32-bit aligned data
+ *   nwords - The number of 32-bit words to be summed
+ *
+ * Returned Value:
+ *   The updated 32-bit partial sum.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARCH_CHKSUM32
+uint32_t up_chksum32(uint32_t sum, FAR const uint32_t *data, size_t nwords);
+#endif
+
 /****************************************************************************
  * Name: ipv4_chksum
  *
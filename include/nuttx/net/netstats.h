@@ -80,6 +80,17 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+/* Statistics of an address resolution table (ARP or Neighbor Table) */
+
+struct addrcache_stats_s
+{
+  net_stats_t hit;              /* Number of lookups that found an entry */
+  net_stats_t miss;             /* Number of lookups that found no entry */
+  net_stats_t evict;            /* Number of entries replaced by new ones */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -117,6 +128,14 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_ARP
+  struct addrcache_stats_s arp; /* ARP table statistics */
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  struct addrcache_stats_s neighbor; /* Neighbor Table statistics */
+#endif
 };
 
 /****************************************************************************
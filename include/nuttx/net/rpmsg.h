@@ -55,6 +55,20 @@
 #define NET_RPMSG_DEVIOCTL              4 /* IP-->LINK */
 #define NET_RPMSG_SOCKIOCTL             5 /* IP<--LINK */
 #define NET_RPMSG_TRANSFER              6 /* IP<->LINK */
+#define NET_RPMSG_BATCH                 7 /* IP<->LINK */
+
+/* Each frame of a NET_RPMSG_BATCH message starts on this boundary */
+
+#define NET_RPMSG_FRAME_ALIGN           4
+
+/* The checksum flags of a frame in a NET_RPMSG_BATCH message.  From IP to
+ * LINK, they ask the LINK side to insert the IPv4 header checksum and the
+ * TCP/UDP checksum of the frame, which the IP side left zero.  From LINK
+ * to IP, they tell that the LINK side has verified these checksums.
+ */
+
+#define NET_RPMSG_FRAME_CSUM_IP         (1 << 0)
+#define NET_RPMSG_FRAME_CSUM_L4         (1 << 1)
 
 /****************************************************************************
  * Public Types
@@ -113,4 +127,22 @@ begin_packed_struct struct net_rpmsg_transfer_s
   uint8_t                   data[0];
 } end_packed_struct;
 
+/* A NET_RPMSG_BATCH message carries 'count' frames in one rpmsg buffer.
+ * Each frame is padded to NET_RPMSG_FRAME_ALIGN bytes.
+ */
+
+begin_packed_struct struct net_rpmsg_frame_s
+{
+  uint32_t                  length;
+  uint32_t                  flags;
+  uint8_t                   data[0];
+} end_packed_struct;
+
+begin_packed_struct struct net_rpmsg_batch_s
+{
+  struct net_rpmsg_header_s header;
+  uint32_t                  count;
+  struct net_rpmsg_frame_s  frames[0];
+} end_packed_struct;
+
 #endif /* __INCLUDE_NUTTX_NET_RPMSG_H */
@@ -56,7 +56,8 @@
 
 #define IFF_TUN          0x01
 #define IFF_TAP          0x02
-#define IFF_MASK         0x7f
+#define IFF_MASK         0x3f
+#define IFF_MULTI_QUEUE  0x40   /* Interface may be shared by several files */
 #define IFF_NO_PI        0x80
 
 /****************************************************************************
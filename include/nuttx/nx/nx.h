@@ -520,6 +520,33 @@ int nx_block(NXWINDOW hwnd, FAR void *arg);
 
 int nx_synch(NXWINDOW hwnd, FAR void *arg);
 
+/****************************************************************************
+ * Name: nx_batchbegin and nx_batchend
+ *
+ * Description:
+ *   Between nx_batchbegin() and nx_batchend(), the drawing requests of the
+ *   client (nx_setpixel(), nx_fill(), nx_filltrapezoid(), nx_move(),
+ *   nx_redrawreq(), and nx_setbgcolor()) are collected in a buffer and
+ *   sent to the server with one message, instead of one message each.
+ *   The buffer is sent when it is full, before any other request of the
+ *   client, and by nx_batchend().  The order of the requests is preserved.
+ *
+ *   The drawing is not visible until the buffer is sent, so a client would
+ *   typically batch the drawing of one frame.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nx_batchbegin(NXHANDLE handle);
+int nx_batchend(NXHANDLE handle);
+#endif
+
 /****************************************************************************
  * Name: nx_requestbkgd
  *
@@ -973,6 +1000,29 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
                          FAR const struct nxgl_rect_s *rect);
 #endif
 
+/****************************************************************************
+ * Name: nx_notify_move
+ *
+ * Description:
+ *   When CONFIG_NX_UPDATE_MOVE=y, then the graphics system will callout to
+ *   inform some external module that a rectangular region of the display
+ *   has been moved.  This is reported instead of nx_notify_rectangle() for
+ *   the destination region.  A VNC server can then ask the client to copy
+ *   the region itself (CopyRect) instead of sending the pixel data again.
+ *
+ * Input Parameters:
+ *   pinfo  - The plane in which the region was moved
+ *   rect   - The source region of the move (device coordinates)
+ *   offset - The offset that was applied to the source region
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_MOVE
+void nx_notify_move(FAR NX_PLANEINFOTYPE *pinfo,
+                    FAR const struct nxgl_rect_s *rect,
+                    FAR const struct nxgl_point_s *offset);
+#endif
+
 /****************************************************************************
  * Name: nx_kbdin
  *
@@ -105,6 +105,32 @@
  * file that also require NXGLIB types.
  */
 
+#ifdef CONFIG_NX_ACCEL
+/* The raster operations that a graphics accelerator may perform on behalf
+ * of nxglib.  'dest' and 'src' address the first pixel of the region,
+ * 'stride' is the length of one row in bytes and 'bpp' is the pixel depth
+ * (8 or more).  Colors are in the native format of the framebuffer.
+ *
+ * Each method returns zero (OK) if the operation has completed or a
+ * negated errno value if it was not performed.  In the later case,
+ * nxglib performs the operation by software.  A NULL method is never
+ * used.
+ *
+ * The copy method copies the rows from the top down and each row from
+ * left to right.  It is also used to move a region within the
+ * framebuffer when 'dest' precedes 'src'.
+ */
+
+struct nxgl_accel_s
+{
+  CODE int (*fill)(FAR void *dest, unsigned int stride, uint8_t bpp,
+                   unsigned int width, unsigned int height, uint32_t color);
+  CODE int (*copy)(FAR void *dest, unsigned int deststride,
+                   FAR const void *src, unsigned int srcstride, uint8_t bpp,
+                   unsigned int width, unsigned int height);
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -495,6 +521,27 @@ void nxgl_circletraps(FAR const struct nxgl_point_s *center,
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1);
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1);
 
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Register the graphics accelerator that nxglib uses to fill, copy and
+ *   move rectangular regions of framebuffer memory.  Only one accelerator
+ *   is supported.
+ *
+ * Input Parameters:
+ *   accel - The accelerator operations or NULL to unregister the current
+ *           accelerator.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -81,6 +81,20 @@
 #define NX_CLIMSG_PRIO 42
 #define NX_SVRMSG_PRIO 42
 
+/* Batched messages.  Each message in a batch buffer is preceded by its
+ * length in a uintptr_t and padded to the alignment of a uintptr_t.
+ */
+
+#ifdef CONFIG_NX_BATCH
+#  ifndef CONFIG_NX_BATCHSIZE
+#    define CONFIG_NX_BATCHSIZE 512
+#  endif
+
+#  define NX_BATCH_ALIGN(n)  (((n) + sizeof(uintptr_t) - 1) & \
+                              ~(sizeof(uintptr_t) - 1))
+#  define NX_BATCH_RECLEN(n) (sizeof(uintptr_t) + NX_BATCH_ALIGN(n))
+#endif
+
 /* Handy macros */
 
 #define nxmu_semgive(sem)    _SEM_POST(sem) /* To match nxmu_semtake() */
@@ -114,6 +128,12 @@ struct nxmu_conn_s
   mqd_t crdmq;            /* MQ to read from the server (may be non-blocking) */
   mqd_t cwrmq;            /* MQ to write to the server (blocking) */
 
+#ifdef CONFIG_NX_BATCH
+  FAR uint8_t *batch;     /* Buffer of batched messages (or NULL) */
+  uint16_t batchlen;      /* Number of bytes in the batch buffer */
+  bool batching;          /* True:  Drawing messages are batched */
+#endif
+
   /* These are only usable on the server side of the connection */
 
   mqd_t swrmq;            /* MQ to write to the client */
@@ -162,7 +182,8 @@ enum nxmsg_e
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_BATCH             /* Process a buffer of batched messages */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -521,6 +542,20 @@ struct nxsvrmsg_redrawreq_s
   struct nxgl_rect_s rect;         /* Describes the rectangular region to be redrawn */
 };
 
+/* Process a buffer of batched messages.  The server posts sem_done when
+ * it no longer needs the buffer.
+ */
+
+#ifdef CONFIG_NX_BATCH
+struct nxsvrmsg_batch_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_BATCH */
+  FAR const uint8_t *buffer;       /* The batched messages */
+  size_t nbytes;                   /* The number of bytes in the buffer */
+  FAR sem_t *sem_done;             /* Semaphore to report when done */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -599,6 +634,25 @@ void nxmu_semtake(sem_t *sem);
 int nxmu_sendserver(FAR struct nxmu_conn_s *conn,
                     FAR const void *msg, size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_flushbatch
+ *
+ * Description:
+ *  Send any batched messages to the server and wait until the server has
+ *  processed them.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_flushbatch(FAR struct nxmu_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: nxmu_sendwindow
  *
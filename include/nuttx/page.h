@@ -2,7 +2,7 @@
  * include/nuttx/page.h
  * This file defines interfaces used to support NuttX On-Demand Paging.
  *
- *   Copyright (C) 2010, 2013 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2010, 2013, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <stdint.h>
 #  include <stdbool.h>
 #  include <nuttx/sched.h>
 #endif
@@ -221,8 +222,40 @@
  *   the (asynchronous) page fill logic.  If the fill takes longer than this
  *   number if microseconds, then a fatal error will be declared.
  *   Default: No timeouts monitored.
+ * CONFIG_PAGING_PREFETCH - The number of unmapped virtual pages following
+ *   the faulting page that are filled with each page fault.  Requires
+ *   up_checkmapping_va() and up_allocpage_va().  Default: 0.
+ * CONFIG_PAGING_STATS - Collect paging statistics.  See pg_statistics().
  */
 
+#ifndef CONFIG_PAGING_PREFETCH
+#  define CONFIG_PAGING_PREFETCH   0
+#endif
+
+#if CONFIG_PAGING_PREFETCH >= CONFIG_PAGING_NPPAGED
+#  error "CONFIG_PAGING_PREFETCH must be less than CONFIG_PAGING_NPPAGED"
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#ifdef CONFIG_PAGING_STATS
+/* Paging statistics as returned by pg_statistics() */
+
+struct pg_stats_s
+{
+  uint32_t faults;             /* Page faults that required a fill */
+  uint32_t refaults;           /* Faults on pages that were filled before */
+  uint32_t fills;              /* Pages filled, including prefetched pages */
+  uint32_t prefetches;         /* Pages filled ahead of a page fault */
+};
+#endif
+
+#endif /* __ASSEMBLY__ */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -311,6 +344,24 @@ extern "C"
 
 void pg_miss(void);
 
+/****************************************************************************
+ * Name: pg_statistics
+ *
+ * Description:
+ *   Return the paging statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_STATS
+void pg_statistics(FAR struct pg_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Public Functions -- Provided by architecture-specific logic to common
  *                     paging logic.
@@ -348,6 +399,25 @@ void pg_miss(void);
 
 bool up_checkmapping(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: up_checkmapping_va()
+ *
+ * Description:
+ *  Like up_checkmapping(), but for the page at a virtual address in the
+ *  paged text region instead of the page that a task faulted on.  This is
+ *  used to decide on the pages to prefetch.  Only required if
+ *  CONFIG_PAGING_PREFETCH is non-zero.
+ *
+ * Input Parameters:
+ *   vaddr - A virtual address in the paged text region
+ *
+ * Returned Value:
+ *   True is returned if the page is mapped.
+ *
+ ****************************************************************************/
+
+bool up_checkmapping_va(uintptr_t vaddr);
+
 /****************************************************************************
  * Name: up_allocpage()
  *
@@ -399,6 +469,31 @@ bool up_checkmapping(FAR struct tcb_s *tcb);
 
 int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
 
+/****************************************************************************
+ * Name: up_allocpage_va()
+ *
+ * Description:
+ *  Like up_allocpage(), but allocate and map the page at a virtual address
+ *  in the paged text region instead of the page that a task faulted on.
+ *  This is used to allocate the pages to prefetch.  Only required if
+ *  CONFIG_PAGING_PREFETCH is non-zero.
+ *
+ *  NOTE: The allocation must not replace any of the CONFIG_PAGING_PREFETCH
+ *  pages that were allocated just before.
+ *
+ * Input Parameters:
+ *   vaddr - A virtual address in the paged text region
+ *   vpage - The location to return the virtual address of the page
+ *
+ * Returned Value:
+ *   This function will return zero (OK) if the allocation was successful.
+ *   A negated errno value may be returned if an error occurs.  All errors,
+ *   however, are fatal.
+ *
+ ****************************************************************************/
+
+int up_allocpage_va(uintptr_t vaddr, FAR void **vpage);
+
 /****************************************************************************
  * Name: up_fillpage()
  *
@@ -425,11 +520,15 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
  *  remap the region so that is is read/execute only.  It should be made
  *  cache-able in any case.
  *
+ *  NOTE 3: If CONFIG_PAGING_PREFETCH is non-zero, the pages following the
+ *  faulting page are filled with the same TCB.  The data to be filled must
+ *  then be selected by the address of the page, vpage.  In the non-
+ *  blocking case, the fills of all of the pages are started at once.
+ *
  * Input Parameters:
  *   tcb - A reference to the task control block of the task that needs to
- *         have a page fill.  Architecture-specific logic can retrieve page
- *         fault information from the architecture-specific context
- *         information in this TCB to perform the fill.
+ *         have a page fill.
+ *   vpage - The virtual address of the page to be filled.
  *   pg_callbck - The function to be called when the page fill is complete.
  *
  * Returned Value:
@@ -438,10 +537,6 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
  *   as the result argument).  A negated errno value may be returned if an
  *   error occurs.  All errors, however, are fatal.
  *
- *   NOTE: -EBUSY has a special meaning. It is used internally to mean that
- *   the callback function has not executed.  Therefore, -EBUSY should
- *   never be provided in the result argument of pg_callback.
- *
  * Assumptions:
  *   - This function is called from the normal tasking context (but
  *     interrupts siabled).  The implementation must take whatever actions
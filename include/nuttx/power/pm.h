@@ -539,6 +539,45 @@ int pm_changestate(int domain, enum pm_state_e newstate);
 
 enum pm_state_e pm_querystate(int domain);
 
+#ifdef CONFIG_SMP
+/****************************************************************************
+ * Name: pm_cpu_setstate
+ *
+ * Description:
+ *   This function is called by the IDLE loop of a CPU when the CPU enters
+ *   or leaves a low power state.  The scheduler uses this information to
+ *   avoid waking a CPU from a low power state when another CPU can run a
+ *   task.
+ *
+ * Input Parameters:
+ *   cpu   - The index of the CPU
+ *   state - The new power state of the CPU
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pm_cpu_setstate(int cpu, enum pm_state_e state);
+
+/****************************************************************************
+ * Name: pm_cpu_querystate
+ *
+ * Description:
+ *   This function returns the power state last reported for a CPU by
+ *   pm_cpu_setstate().  The initial state of all CPUs is PM_NORMAL.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU
+ *
+ * Returned Value:
+ *   The power state of the CPU.
+ *
+ ****************************************************************************/
+
+enum pm_state_e pm_cpu_querystate(int cpu);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -563,6 +602,7 @@ enum pm_state_e pm_querystate(int domain);
 #  define pm_checkstate(domain)        (0)
 #  define pm_changestate(domain,state) (0)
 #  define pm_querystate(domain)        (0)
+#  define pm_cpu_setstate(cpu,state)
 
 #endif /* CONFIG_PM */
 #endif /* __INCLUDE_NUTTX_POWER_PM_H */
@@ -43,6 +43,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <pthread.h>
 #include <sched.h>
 
@@ -110,6 +111,22 @@
   }
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_MUTEX_SPINSTATS
+/* Per-CPU statistics of spinning on adaptive mutexes */
+
+struct pthread_spinstats_s
+{
+  uint32_t nsuccess;  /* Spins that ended with the mutex released */
+  uint32_t nblocked;  /* Spins abandoned because the holder stopped running */
+  uint32_t ntimeout;  /* Spins abandoned after CONFIG_PTHREAD_MUTEX_SPINLOOPS */
+  uint32_t nloops;    /* Total number of loops spent in successful spins */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -128,6 +145,12 @@ extern "C"
 
 EXTERN const pthread_attr_t g_default_pthread_attr;
 
+#ifdef CONFIG_PTHREAD_MUTEX_SPINSTATS
+/* Adaptive mutex spin statistics, one entry for each CPU */
+
+EXTERN struct pthread_spinstats_s g_pthread_spinstats[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -166,6 +166,20 @@ void up_rngreseed(void);
 
 void up_randompool_initialize(void);
 
+/****************************************************************************
+ * Name: up_rngbulk
+ *
+ * Description:
+ *   Fill a large buffer with randomness from a one-time ChaCha20 key taken
+ *   from the generator of the current CPU.  No lock is held while the
+ *   buffer is filled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+void up_rngbulk(FAR void *bytes, size_t nbytes);
+#endif
+
 #endif /* CONFIG_CRYPTO_RANDOM_POOL */
 
 #endif /* __INCLUDE_NUTTX_RANDOM_H */
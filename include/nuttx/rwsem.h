@@ -0,0 +1,246 @@
+/****************************************************************************
+ * include/nuttx/rwsem.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RWSEM_H
+#define __INCLUDE_NUTTX_RWSEM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RWSEM_NO_HOLDER ((pid_t)-1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A kernel reader-writer semaphore.  Any number of readers may hold the
+ * semaphore at the same time; a writer holds it exclusively.
+ *
+ * - Writers are preferred:  Once a writer has claimed the semaphore, new
+ *   readers wait until the writer is done.
+ * - The writer may re-take the semaphore for reading or writing; these
+ *   nested locks are counted.  Readers must not nest read locks and must
+ *   never try to upgrade to a write lock.
+ * - Both readers and writers that wait for a writer wait on that writer's
+ *   semaphore, so the writer inherits their priority.  Readers are not
+ *   tracked individually; a writer waiting for readers to leave does not
+ *   boost them.
+ */
+
+struct rw_semaphore_s
+{
+  sem_t    wsem;      /* Held by the writer.  Waiters wait here */
+  sem_t    drain;     /* Posted when the last reader leaves */
+  pid_t    holder;    /* The writer holding the semaphore */
+  int16_t  nwriters;  /* Number of nested locks held by the writer */
+  int16_t  nreaders;  /* Number of readers holding the semaphore */
+  bool     draining;  /* The writer is waiting for readers to leave */
+};
+
+typedef struct rw_semaphore_s rw_semaphore_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxrwsem_init
+ *
+ * Description:
+ *   Initialize a reader-writer semaphore to its unlocked state.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be initialized
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_init(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_destroy
+ *
+ * Description:
+ *   Destroy a reader-writer semaphore that is no longer held.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be destroyed
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_destroy(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_rdlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for shared, read-only access, waiting
+ *   while a writer holds it.  The wait is not interrupted by signals.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int nxrwsem_rdlock(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_tryrdlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for shared access without waiting.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EAGAIN is returned if a writer
+ *   holds the semaphore.
+ *
+ ****************************************************************************/
+
+int nxrwsem_tryrdlock(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_rdunlock
+ *
+ * Description:
+ *   Release shared access to the reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxrwsem_rdunlock(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_wrlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for exclusive access, waiting for the
+ *   current writer and then for all readers to leave.  The wait is not
+ *   interrupted by signals.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int nxrwsem_wrlock(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_trywrlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for exclusive access without waiting.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EAGAIN is returned if the semaphore
+ *   is held by another writer or by any reader.
+ *
+ ****************************************************************************/
+
+int nxrwsem_trywrlock(FAR rw_semaphore_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_wrunlock
+ *
+ * Description:
+ *   Release one count of exclusive access to the reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxrwsem_wrunlock(FAR rw_semaphore_t *rwsem);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RWSEM_H */
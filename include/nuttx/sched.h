@@ -1,7 +1,8 @@
 /********************************************************************************
  * include/nuttx/sched.h
  *
- *   Copyright (C) 2007-2016, 2018-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2016, 2018-2019, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -90,6 +91,23 @@
 #  define CONFIG_SCHED_SPORADIC_MAXREPL 3
 #endif
 
+/* Critical section monitor histograms */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+#  ifndef CONFIG_SCHED_CRITMONITOR_NBUCKETS
+#    define CONFIG_SCHED_CRITMONITOR_NBUCKETS 24
+#  endif
+#  ifndef CONFIG_SCHED_CRITMONITOR_NOFFENDERS
+#    define CONFIG_SCHED_CRITMONITOR_NOFFENDERS 4
+#  endif
+#endif
+
+/* Pre-allocated signal queue entries per task group */
+
+#ifndef CONFIG_SIG_PREALLOC_GROUP
+#  define CONFIG_SIG_PREALLOC_GROUP 0
+#endif
+
 /* Task Management Definitions **************************************************/
 
 /* Special task IDS.  Any negative PID is invalid. */
@@ -111,16 +129,17 @@
 #define TCB_FLAG_NONCANCELABLE     (1 << 2) /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_DEFERRED   (1 << 3) /* Bit 3: Deferred (vs asynch) cancellation type */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 4) /* Bit 4: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-6: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-7: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT) /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT) /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT) /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT) /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 7) /* Bit 7: Locked to this CPU */
-#define TCB_FLAG_SIGNAL_ACTION     (1 << 8) /* Bit 8: In a signal handler */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 9) /* Bit 9: Exitting */
-                                            /* Bits 10-15: Available */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT) /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 8) /* Bit 8: Locked to this CPU */
+#define TCB_FLAG_SIGNAL_ACTION     (1 << 9) /* Bit 9: In a signal handler */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 10) /* Bit 10: Exitting */
+                                            /* Bits 11-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -318,6 +337,32 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s *************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure.  It is
+ * allocated when the deadline scheduling policy is assigned to a thread.  All
+ * times are in system clock ticks.
+ */
+
+struct deadline_s
+{
+  bool      throttled;              /* The budget of this period is exhausted   */
+  uint8_t   priority;               /* Priority while budget remains            */
+  uint32_t  runtime;                /* Execution budget of each period          */
+  uint32_t  deadline;               /* Deadline relative to the period start    */
+  uint32_t  period;                 /* Period                                   */
+  uint32_t  bandwidth;              /* runtime / period as a 16.16 fraction     */
+  uint32_t  budget;                 /* Budget remaining in this period          */
+  clock_t   abs_deadline;           /* Absolute deadline of this period         */
+  clock_t   eventtime;              /* Time the thread was last resumed         */
+  struct wdog_s period_timer;       /* Starts each period                       */
+  struct wdog_s budget_timer;       /* Expires when the budget is exhausted     */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s *********************************************************/
 
 /* This structure is used to maintain information about child tasks.  pthreads
@@ -530,6 +575,10 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  sq_queue_t tg_sigactionfree;      /* Free pending signal actions of the group */
+  sq_queue_t tg_sigpendfree;        /* Free pending signals of the group        */
+#endif
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -631,6 +680,9 @@ struct tcb_s
   uint8_t  pend_reprios[CONFIG_SEM_NNESTPRIO];
 #endif
   uint8_t  base_priority;                /* "Normal" priority of the thread     */
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  FAR struct semholder_s *holdsem;       /* List of semaphore counts held       */
+#endif
 #endif
 
   uint8_t  task_state;                   /* Current state of the thread         */
@@ -654,8 +706,14 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters      */
+#endif
 
   WDOG_ID waitdog;                       /* All timed waits use this timer      */
+#ifdef CONFIG_HRTIMER
+  FAR struct hrtimer_s *waithrtimer;     /* Or this high resolution timer       */
+#endif
 
   /* Stack-Related Fields *******************************************************/
 
@@ -666,6 +724,14 @@ struct tcb_s
                                          /* Need to deallocate stack            */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#if defined(CONFIG_STACK_COLORATION) && CONFIG_STACK_COLORATION_GAP > 0
+  uintptr_t stack_hwm;                   /* Lowest used stack word found so     */
+                                         /* far or zero if not checked yet      */
+#endif
+#ifdef CONFIG_SCHED_TCBCACHE
+  size_t    cache_stack_size;            /* Requested stack size or zero if     */
+                                         /* the TCB cannot be cached            */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -704,6 +770,27 @@ struct tcb_s
   uint32_t premp_max;                    /* Max time preemption disabled        */
   uint32_t crit_start;                   /* Time critical section entered       */
   uint32_t crit_max;                     /* Max time in critical section        */
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  uintptr_t premp_caller;                /* Caller that disabled preemption     */
+  uintptr_t crit_caller;                 /* Caller that entered critical section */
+  uint32_t premp_hist[CONFIG_SCHED_CRITMONITOR_NBUCKETS]; /* Times preemption
+                                                           * disabled           */
+  uint32_t crit_hist[CONFIG_SCHED_CRITMONITOR_NBUCKETS];  /* Times in critical
+                                                           * section            */
+#endif
+#endif
+
+  /* CPU time accounting ********************************************************/
+
+#ifdef CONFIG_SCHED_CPUACCT
+  uint64_t run_time;                     /* Time spent running                  */
+  uint64_t irq_time;                     /* Time spent in interrupt handlers    */
+#endif
+
+  /* Poll support ***************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct pollcache_s *pollcache;     /* Driver registrations of poll()      */
 #endif
 
   /* Library related fields *****************************************************/
@@ -791,6 +878,35 @@ struct pthread_tcb_s
 };
 #endif /* !CONFIG_DISABLE_PTHREAD */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* This is one of the longest intervals with pre-emption disabled or within
+ * a critical section on a CPU.
+ */
+
+struct critmon_offender_s
+{
+  uintptr_t caller;                      /* Caller of sched_lock() or
+                                          * enter_critical_section()            */
+  uint32_t elapsed;                      /* Duration (up_critmon_gettime units) */
+  pid_t pid;                             /* The thread                          */
+};
+
+/* These are the critical section monitor histograms of one CPU.  Bucket n
+ * counts the intervals of 2^n up to 2^(n+1) - 1 up_critmon_gettime() units.
+ * The last bucket also counts all longer intervals.  The TCB holds the
+ * histograms of each thread.
+ */
+
+struct critmon_cpuhist_s
+{
+  uint32_t premp[CONFIG_SCHED_CRITMONITOR_NBUCKETS]; /* Pre-emption disabled */
+  uint32_t crit[CONFIG_SCHED_CRITMONITOR_NBUCKETS];  /* In critical section */
+  uint32_t irq[CONFIG_SCHED_CRITMONITOR_NBUCKETS];   /* In interrupt handler */
+  struct critmon_offender_s premp_top[CONFIG_SCHED_CRITMONITOR_NOFFENDERS];
+  struct critmon_offender_s crit_top[CONFIG_SCHED_CRITMONITOR_NOFFENDERS];
+};
+#endif
+
 /* This is the callback type used by sched_foreach() */
 
 typedef CODE void (*sched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
@@ -821,6 +937,16 @@ EXTERN uint32_t g_crit_max[CONFIG_SMP_NCPUS];
 EXTERN uint32_t g_premp_max[1];
 EXTERN uint32_t g_crit_max[1];
 #endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* Histograms and longest intervals of each CPU */
+
+#ifdef CONFIG_SMP_NCPUS
+EXTERN struct critmon_cpuhist_s g_critmon_hist[CONFIG_SMP_NCPUS];
+#else
+EXTERN struct critmon_cpuhist_s g_critmon_hist[1];
+#endif
+#endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
 /********************************************************************************
@@ -842,6 +968,24 @@ FAR struct tcb_s *sched_self(void);
 
 void sched_foreach(sched_foreach_t handler, FAR void *arg);
 
+/* Clear the critical section monitor histograms of all CPUs and threads */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+void sched_critmon_reset(void);
+#endif
+
+/* Control the sampling profiler and access the sampled program counters
+ * of each CPU.
+ */
+
+#ifdef CONFIG_SCHED_PROFILE
+void nxsched_profile_start(void);
+void nxsched_profile_stop(void);
+void nxsched_profile_reset(void);
+size_t nxsched_profile_nsamples(int cpu);
+uintptr_t nxsched_profile_pc(int cpu, size_t index);
+#endif
+
 /* Given a task ID, look up the corresponding TCB */
 
 FAR struct tcb_s *sched_gettcb(pid_t pid);
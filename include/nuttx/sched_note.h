@@ -106,6 +106,10 @@ enum note_type_e
   NOTE_SPINLOCK_UNLOCK = 16,
   NOTE_SPINLOCK_ABORT  = 17
 #endif
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  ,
+  NOTE_DROPPED         = 18
+#endif
 };
 
 /* This structure provides the common header of each note */
@@ -119,7 +123,8 @@ struct note_common_s
   uint8_t nc_cpu;              /* CPU thread/task running on */
 #endif
   uint8_t nc_pid[2];           /* ID of the thread/task */
-  uint8_t nc_systime[4];       /* Time when note was buffered */
+  uint8_t nc_systime[4];       /* Time when note was buffered (ticks or
+                                * up_critmon_gettime() units) */
 };
 
 /* This is the specific form of the NOTE_START note */
@@ -234,6 +239,19 @@ struct note_spinlock_s
   uint8_t nsp_value;            /* Value of spinlock */
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS */
+
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+/* This is the specific form of the NOTE_DROPPED note.  It is generated by
+ * sched_note_get() when a CPU was unable to add notes because its buffer
+ * was full.  nc_cpu identifies that CPU.
+ */
+
+struct note_dropped_s
+{
+  struct note_common_s ndr_cmn; /* Common note parameters */
+  uint8_t ndr_count[4];         /* Number of notes lost */
+};
+#endif /* CONFIG_SCHED_NOTE_PERCPU */
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -116,7 +116,8 @@
                                * -Broadcast command, no response 31:16=RCA */
 #  define SDIO_CMDIDX5     5  /* SDIO_SEND_OP_COND
                                * -Addressed Command, R4 response 47:16=IO_OCR */
-#  define MMCSD_CMDIDX6    6  /* HS_SWITCH: Checks switchable function */
+#  define MMCSD_CMDIDX6    6  /* HS_SWITCH: Checks switchable function
+                               * MMC: SWITCH: Writes a byte of the EXT_CSD, R1b response */
 #  define MMCSD_CMDIDX7    7  /* SELECT/DESELECT CARD
                                * -Addressed Command, R1 response 31:16=RCA */
 #  define MMCSD_CMDIDX8    8  /* SD:  IF_COND: Sends SD Memory Card interface condition
@@ -128,6 +129,8 @@
                                * -Addressed Command, R2 response 31:16=RCA */
 #  define MMC_CMDIDX11    11  /* READ_DAT_UNTIL_STOP
                                * -Addressed data transfer command, R1 response 31:0=DADR */
+#  define SD_CMDIDX11     11  /* VOLTAGE_SWITCH: Switch to 1.8V signaling (UHS-I)
+                               * -Addressed command, R1 response */
 #  define MMCSD_CMDIDX12  12  /* STOP_TRANSMISSION: Forces the card to stop transmission
                                * -Addressed Command, R1b response */
 #  define MMCSD_CMDIDX13  13  /* SEND_STATUS: Asks card to send its status register
@@ -141,11 +144,14 @@
                                * -Addressed data transfer command, R1 response 31:0=DADR */
 #  define MMCSD_CMDIDX18  18  /* READ_MULTIPLE_BLOCK: Continuously transfers blocks from card to host
                                * -Addressed data transfer command, R1 response 31:0=DADR */
-#  define MMCSD_CMDIDX19  19  /* HS_BUSTEST_WRITE: */
+#  define MMCSD_CMDIDX19  19  /* HS_BUSTEST_WRITE:
+                               * SD: SEND_TUNING_BLOCK: 64 byte tuning pattern (UHS-I) */
 #  define MMC_CMDIDX20    20  /* WRITE_DAT_UNTIL_STOP: (MMC)
                                * -Addressed data transfer command, R1 response 31:0=DADR R1 */
-#  define MMC_CMDIDX23    23  /* SET_BLOCK_COUNT: (MMC)
-                               * -Addressed command, R1 response 31:0=DADR */
+#  define MMC_CMDIDX21    21  /* SEND_TUNING_BLOCK_HS200: Tuning pattern (MMC HS200)
+                               * -Addressed data transfer command, R1 response */
+#  define MMCSD_CMDIDX23  23  /* SET_BLOCK_COUNT: (MMC, SD if supported in the SCR)
+                               * -Addressed command, R1 response 31:0=Block count */
 #  define MMCSD_CMDIDX24  24  /* WRITE_BLOCK: Writes a block of the selected size
                                * -Addressed data transfer command, R1 response 31:0=DADR */
 #  define MMCSD_CMDIDX25  25  /* WRITE_MULTIPLE_BLOCK: Continuously writes blocks of data
@@ -274,6 +280,7 @@
 #define MMCSD_CMD4      (MMCSD_CMDIDX4 |MMCSD_NO_RESPONSE |MMCSD_NODATAXFR)
 #define SDIO_CMD5       (SDIO_CMDIDX5  |MMCSD_R4_RESPONSE |MMCSD_NODATAXFR)
 #define MMCSD_CMD6      (MMCSD_CMDIDX6 |MMCSD_R1_RESPONSE |MMCSD_RDDATAXFR)
+#define MMC_CMD6        (MMCSD_CMDIDX6 |MMCSD_R1B_RESPONSE|MMCSD_NODATAXFR)
 #define MMCSD_CMD7S     (MMCSD_CMDIDX7 |MMCSD_R1B_RESPONSE|MMCSD_NODATAXFR)
 #define MMCSD_CMD7D     (MMCSD_CMDIDX7 |MMCSD_NO_RESPONSE |MMCSD_NODATAXFR)  /* No response when de-selecting card */
 #define SD_CMD8         (MMCSD_CMDIDX8 |MMCSD_R7_RESPONSE |MMCSD_NODATAXFR)
@@ -281,6 +288,7 @@
 #define MMCSD_CMD9      (MMCSD_CMDIDX9 |MMCSD_R2_RESPONSE |MMCSD_NODATAXFR)
 #define MMCSD_CMD10     (MMCSD_CMDIDX10|MMCSD_R2_RESPONSE |MMCSD_NODATAXFR)
 #define MMC_CMD11       (MMC_CMDIDX11  |MMCSD_R1_RESPONSE |MMCSD_RDSTREAM )
+#define SD_CMD11        (SD_CMDIDX11   |MMCSD_R1_RESPONSE |MMCSD_NODATAXFR)
 #define MMCSD_CMD12     (MMCSD_CMDIDX12|MMCSD_R1B_RESPONSE|MMCSD_NODATAXFR |MMCSD_STOPXFR)
 #define MMCSD_CMD13     (MMCSD_CMDIDX13|MMCSD_R1_RESPONSE |MMCSD_NODATAXFR)
 #define MMCSD_CMD14     (MMCSD_CMDIDX14|MMCSD_R1_RESPONSE |MMCSD_NODATAXFR)
@@ -289,8 +297,10 @@
 #define MMCSD_CMD17     (MMCSD_CMDIDX17|MMCSD_R1_RESPONSE |MMCSD_RDDATAXFR)
 #define MMCSD_CMD18     (MMCSD_CMDIDX18|MMCSD_R1_RESPONSE |MMCSD_RDDATAXFR |MMCSD_MULTIBLOCK)
 #define MMCSD_CMD19     (MMCSD_CMDIDX19|MMCSD_R1_RESPONSE |MMCSD_NODATAXFR)
+#define SD_CMD19        (MMCSD_CMDIDX19|MMCSD_R1_RESPONSE |MMCSD_RDDATAXFR)
 #define MMC_CMD20       (MMC_CMDIDX20  |MMCSD_R1B_RESPONSE|MMCSD_WRSTREAM )
-#define MMC_CMD23       (MMC_CMDIDX23  |MMCSD_R1_RESPONSE |MMCSD_NODATAXFR)
+#define MMC_CMD21       (MMC_CMDIDX21  |MMCSD_R1_RESPONSE |MMCSD_RDDATAXFR)
+#define MMCSD_CMD23     (MMCSD_CMDIDX23|MMCSD_R1_RESPONSE |MMCSD_NODATAXFR)
 #define MMCSD_CMD24     (MMCSD_CMDIDX24|MMCSD_R1_RESPONSE |MMCSD_WRDATAXFR)
 #define MMCSD_CMD25     (MMCSD_CMDIDX25|MMCSD_R1_RESPONSE |MMCSD_WRDATAXFR |MMCSD_MULTIBLOCK)
 #define MMCSD_CMD26     (MMCSD_CMDIDX26|MMCSD_R1_RESPONSE |MMCSD_WRDATAXFR)
@@ -429,6 +439,9 @@
 #define SDIO_CAPS_DMABEFOREWRITE  0x04 /* Bit 2=1: Executes DMA before write command */
 #define SDIO_CAPS_4BIT            0x08 /* Bit 3=1: Supports 4 bit operation */
 #define SDIO_CAPS_8BIT            0x10 /* Bit 4=1: Supports 8 bit operation */
+#define SDIO_CAPS_UHS_SDR50       0x20 /* Bit 5=1: Supports SD UHS-I SDR50 */
+#define SDIO_CAPS_UHS_SDR104      0x40 /* Bit 6=1: Supports SD UHS-I SDR104 */
+#define SDIO_CAPS_MMC_HS200       0x80 /* Bit 7=1: Supports MMC HS200 */
 
 /****************************************************************************
  * Name: SDIO_STATUS
@@ -872,6 +885,59 @@
 #  define SDIO_DMASENDSETUP(dev,buffer,len) (-ENOSYS)
 #endif
 
+/****************************************************************************
+ * Name: SDIO_SWITCHVOLTAGE
+ *
+ * Description:
+ *   Switch the signaling voltage of the bus to 1.8V.  Called after the SD
+ *   card has accepted CMD11 (VOLTAGE_SWITCH).  The lower half stops the
+ *   clock, switches the I/O voltage, waits for it to settle and resumes the
+ *   clock as required by the SD specification.  This method is required for
+ *   SDIO_CAPS_UHS_SDR50 and SDIO_CAPS_UHS_SDR104.  The lower half returns to
+ *   3.3V signaling when the clock is disabled with CLOCK_SDIO_DISABLED.
+ *
+ * Input Parameters:
+ *   dev    - An instance of the SDIO device interface
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_UHS
+#  define SDIO_SWITCHVOLTAGE(dev) \
+     ((dev)->switchvoltage ? (dev)->switchvoltage(dev) : -ENOSYS)
+#else
+#  define SDIO_SWITCHVOLTAGE(dev) (-ENOSYS)
+#endif
+
+/****************************************************************************
+ * Name: SDIO_EXECUTETUNING
+ *
+ * Description:
+ *   Find the sampling point for the clocking selected by the last
+ *   SDIO_CLOCK call (CLOCK_SD_TRANSFER_SDR50, CLOCK_SD_TRANSFER_SDR104 or
+ *   CLOCK_MMC_TRANSFER_HS200).  The lower half repeatedly sends the tuning
+ *   command, compares the received block with the tuning pattern and
+ *   adjusts the sampling point until it is found.
+ *
+ * Input Parameters:
+ *   dev    - An instance of the SDIO device interface
+ *   cmd    - The tuning command (SD_CMD19 or MMC_CMD21)
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure.  -ENOSYS is returned if the
+ *   lower half does not need tuning.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_UHS
+#  define SDIO_EXECUTETUNING(dev,cmd) \
+     ((dev)->executetuning ? (dev)->executetuning(dev,cmd) : -ENOSYS)
+#else
+#  define SDIO_EXECUTETUNING(dev,cmd) (-ENOSYS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -884,7 +950,10 @@ enum sdio_clock_e
   CLOCK_IDMODE,            /* Initial ID mode clocking (<400KHz) */
   CLOCK_MMC_TRANSFER,      /* MMC normal operation clocking */
   CLOCK_SD_TRANSFER_1BIT,  /* SD normal operation clocking (narrow 1-bit mode) */
-  CLOCK_SD_TRANSFER_4BIT   /* SD normal operation clocking (wide 4-bit mode) */
+  CLOCK_SD_TRANSFER_4BIT,  /* SD normal operation clocking (wide 4-bit mode) */
+  CLOCK_SD_TRANSFER_SDR50, /* SD UHS-I SDR50 clocking (<=100MHz, 4-bit, 1.8V) */
+  CLOCK_SD_TRANSFER_SDR104, /* SD UHS-I SDR104 clocking (<=208MHz, 4-bit, 1.8V) */
+  CLOCK_MMC_TRANSFER_HS200 /* MMC HS200 clocking (<=200MHz) */
 };
 
 /* Event set.  A uint8_t is big enough to hold a set of 8-events.  If more are
@@ -987,6 +1056,13 @@ struct sdio_dev_s
           FAR const uint8_t *buffer, size_t buflen);
 #endif
 #endif /* CONFIG_SDIO_DMA */
+
+  /* UHS-I and HS200 support.  These methods may be NULL. */
+
+#ifdef CONFIG_SDIO_UHS
+  int   (*switchvoltage)(FAR struct sdio_dev_s *dev);
+  int   (*executetuning)(FAR struct sdio_dev_s *dev, uint32_t cmd);
+#endif
 };
 
 /****************************************************************************
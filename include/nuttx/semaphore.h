@@ -100,6 +100,20 @@
 #  define _SEM_ERRVAL(r)        (-errno)
 #endif
 
+/* Adjust the count of a semaphore from within a critical section.  If the
+ * uncontended fast path is enabled, the count may also be changed without
+ * entering the critical section so these adjustments must then be atomic
+ * (see up_fetchadd16() in nuttx/arch.h).  Both return the new count.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  define NXSEM_COUNT_INC(s)    up_fetchadd16(&(s)->semcount, 1)
+#  define NXSEM_COUNT_DEC(s)    up_fetchsub16(&(s)->semcount, 1)
+#else
+#  define NXSEM_COUNT_INC(s)    (++(s)->semcount)
+#  define NXSEM_COUNT_DEC(s)    (--(s)->semcount)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -0,0 +1,274 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/sensors/ioctl.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sensor types.  The type selects the sample structure below and the name
+ * of the character device, /dev/sensor/<name><devno>.
+ */
+
+#define SENSOR_TYPE_ACCELEROMETER   0  /* struct sensor_event_accel_s */
+#define SENSOR_TYPE_MAGNETIC_FIELD  1  /* struct sensor_event_mag_s */
+#define SENSOR_TYPE_GYROSCOPE       2  /* struct sensor_event_gyro_s */
+#define SENSOR_TYPE_LIGHT           3  /* struct sensor_event_light_s */
+#define SENSOR_TYPE_BAROMETER       4  /* struct sensor_event_baro_s */
+#define SENSOR_TYPE_PROXIMITY       5  /* struct sensor_event_prox_s */
+#define SENSOR_TYPE_HUMIDITY        6  /* struct sensor_event_humi_s */
+#define SENSOR_TYPE_TEMPERATURE     7  /* struct sensor_event_temp_s */
+#define SENSOR_TYPE_COUNT           8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Samples.  Each starts with the time of the measurement in microseconds
+ * of the system clock (see sensor_get_timestamp()).
+ */
+
+struct sensor_event_accel_s    /* SENSOR_TYPE_ACCELEROMETER */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float x;                     /* Axis X in m/s^2 */
+  float y;                     /* Axis Y in m/s^2 */
+  float z;                     /* Axis Z in m/s^2 */
+  float temperature;           /* Temperature in degrees celsius */
+};
+
+struct sensor_event_mag_s      /* SENSOR_TYPE_MAGNETIC_FIELD */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float x;                     /* Axis X in micro-Tesla */
+  float y;                     /* Axis Y in micro-Tesla */
+  float z;                     /* Axis Z in micro-Tesla */
+  float temperature;           /* Temperature in degrees celsius */
+};
+
+struct sensor_event_gyro_s     /* SENSOR_TYPE_GYROSCOPE */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float x;                     /* Axis X in rad/s */
+  float y;                     /* Axis Y in rad/s */
+  float z;                     /* Axis Z in rad/s */
+  float temperature;           /* Temperature in degrees celsius */
+};
+
+struct sensor_event_light_s    /* SENSOR_TYPE_LIGHT */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float light;                 /* In SI lux units */
+};
+
+struct sensor_event_baro_s     /* SENSOR_TYPE_BAROMETER */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float pressure;              /* In millibar */
+  float temperature;           /* Temperature in degrees celsius */
+};
+
+struct sensor_event_prox_s     /* SENSOR_TYPE_PROXIMITY */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float proximity;             /* Distance in centimeters */
+};
+
+struct sensor_event_humi_s     /* SENSOR_TYPE_HUMIDITY */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float humidity;              /* Relative humidity in percent */
+};
+
+struct sensor_event_temp_s     /* SENSOR_TYPE_TEMPERATURE */
+{
+  uint64_t timestamp;          /* Units is microseconds */
+  float temperature;           /* Temperature in degrees celsius */
+};
+
+/* The lower half sensor driver operations.  All are optional. */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Enable or disable the sensor.  The sensor is enabled while at least
+   * one reader has enabled it with SNIOC_ACTIVATE.
+   */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Set the sample interval (1 / ODR).  The lower half may round the
+   * interval to a supported value and return the value that it chose.
+   */
+
+  CODE int (*set_interval)(FAR struct sensor_lowerhalf_s *lower,
+                           FAR unsigned int *period_us);
+
+  /* Set the batch latency:  The longest time that a sample may be held in
+   * the hardware FIFO of the sensor.  The lower half programs the FIFO
+   * watermark from the latency and the interval and, on the watermark
+   * interrupt, pushes all samples of the FIFO with one call to
+   * push_event().  Zero disables batching.  The lower half may round the
+   * latency and return the value that it chose.
+   */
+
+  CODE int (*batch)(FAR struct sensor_lowerhalf_s *lower,
+                    FAR unsigned int *latency_us);
+
+  /* Any other IOCTL command is passed on to the lower half */
+
+  CODE int (*control)(FAR struct sensor_lowerhalf_s *lower,
+                      int cmd, unsigned long arg);
+};
+
+/* Called by the lower half to push one or more samples of the sensor type
+ * to the upper half.  'bytes' is a multiple of the size of a sample.  May
+ * be called from an interrupt handler.
+ */
+
+typedef CODE void (*sensor_push_event_t)(FAR void *priv,
+                                         FAR const void *data,
+                                         size_t bytes);
+
+/* This structure is provided by the lower half and stays valid while the
+ * sensor is registered.
+ */
+
+struct sensor_lowerhalf_s
+{
+  /* Provided by the lower half */
+
+  int type;                           /* See SENSOR_TYPE_* definitions */
+  unsigned int nbuffer;               /* Samples buffered by the upper half */
+  FAR const struct sensor_ops_s *ops; /* The lower half operations */
+
+  /* Provided by the upper half in sensor_register() */
+
+  sensor_push_event_t push_event;     /* Pushes samples to the upper half */
+  FAR void *priv;                     /* Argument of push_event() */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_get_timestamp
+ *
+ * Description:
+ *   Return the current time of the system clock in microseconds for the
+ *   timestamp of a sample.
+ *
+ ****************************************************************************/
+
+static inline uint64_t sensor_get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_systimespec(&ts);
+  return 1000000ull * ts.tv_sec + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register the character device /dev/sensor/<name><devno> with the
+ *   upper half sensor driver for a lower half sensor driver.
+ *
+ * Input Parameters:
+ *   lower - The lower half sensor driver
+ *   devno - The number of the sensor among the sensors of the same type
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower, int devno);
+
+/****************************************************************************
+ * Name: sensor_unregister
+ *
+ * Description:
+ *   Unregister the character device of a lower half sensor driver.
+ *
+ * Input Parameters:
+ *   lower - The lower half sensor driver
+ *   devno - The number that was passed to sensor_register()
+ *
+ ****************************************************************************/
+
+void sensor_unregister(FAR struct sensor_lowerhalf_s *lower, int devno);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPER */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
@@ -289,6 +289,10 @@ struct uart_dev_s
   uint8_t              open_count;   /* Number of times the device has been opened */
   volatile bool        xmitwaiting;  /* true: User waiting for space in xmit.buffer */
   volatile bool        recvwaiting;  /* true: User waiting for data in recv.buffer */
+#ifdef CONFIG_SERIAL_RXDMA
+  volatile bool        recvidle;     /* true: Idle line ended the received data */
+#endif
+  volatile uint16_t    recvwakeup;   /* Bytes buffered before the reader is woken */
 #ifdef CONFIG_SERIAL_REMOVABLE
   volatile bool        disconnected; /* true: Removable device is not connected */
 #endif
@@ -300,6 +304,8 @@ struct uart_dev_s
   tcflag_t             tc_iflag;     /* Input modes */
   tcflag_t             tc_oflag;     /* Output modes */
   tcflag_t             tc_lflag;     /* Local modes */
+  cc_t                 tc_vmin;      /* Minimum bytes for read() (VMIN) */
+  cc_t                 tc_vtime;     /* read() timeout in deciseconds (VTIME) */
 #if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
   pid_t                pid;          /* Thread PID to receive signals (-1 if none) */
 #endif
@@ -495,6 +501,22 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *   May be called by the lower half instead of uart_recvchars_done() when the RX
+ *   DMA transfer was ended by an idle line.  In addition to the operations of
+ *   uart_recvchars_done(), a waiting read() is woken up and returns the data
+ *   received so far, even if the VMIN threshold has not been reached.  The idle
+ *   line thus marks the end of a received message.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_idle(FAR uart_dev_t *dev);
+#endif
+
 /************************************************************************************
  * Name: uart_reset_sem
  *
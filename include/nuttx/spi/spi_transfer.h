@@ -125,6 +125,26 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence of SPI transactions queued by
+ * spi_transfer_async().  The structure is provided by the caller and must
+ * stay valid until the callback has been called.  The callback is called
+ * on the work queue with the result of spi_transfer().
+ */
+
+struct spi_request_s;
+typedef CODE void (*spi_callback_t)(FAR struct spi_request_s *req,
+                                    int result, FAR void *arg);
+
+struct spi_request_s
+{
+  FAR struct spi_request_s *flink; /* Supports a singly linked list */
+  FAR struct spi_sequence_s *seq;  /* The sequence of transfers */
+  spi_callback_t callback;         /* Called when the sequence completes */
+  FAR void *arg;                   /* Argument passed to the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -148,6 +168,30 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting.  The
+ *   sequences queued on one SPI bus are performed in order, one after the
+ *   other, by spi_transfer() on a work queue.  req->callback is called
+ *   when each sequence completes.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the sequence of transfers and the callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the sequence was queued; a negated errno value on
+ *   failure.  The callback will not be called on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_request_s *req);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
@@ -44,6 +44,9 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
 
 #ifdef CONFIG_SPINLOCK
 
@@ -96,6 +99,102 @@
 #  define SP_SECTION
 #endif
 
+/* The initial, unlocked state of a reader-writer spinlock */
+
+#define RW_SP_UNLOCKED  { SP_UNLOCKED, 0 }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A reader-biased, reader-writer spinlock.  Any number of CPUs may hold the
+ * lock for reading at the same time.  A writer holds the underlying
+ * spinlock and waits until there are no readers.  New readers are not held
+ * off by a waiting writer, so writers may starve under heavy read load.
+ * Reader-writer spinlocks are not reentrant.
+ */
+
+struct rwlock_s
+{
+  spinlock_t lock;           /* Held by writers and briefly by readers */
+  volatile int16_t readers;  /* Number of readers holding the lock */
+};
+
+typedef struct rwlock_s rwlock_t;
+
+/* Contention statistics of one ticket or MCS spinlock.  The times are in
+ * the units of up_critmon_gettime().
+ */
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+struct spinstat_s
+{
+  FAR struct spinstat_s *flink;  /* Supports a list of all locks */
+  FAR const char *name;          /* Name of the lock, e.g. for procfs */
+  uint32_t nacquired;            /* Number of times the lock was taken */
+  uint32_t nspins;               /* Number of loops spent waiting */
+  uint32_t maxhold;              /* Longest time the lock was held */
+  uint32_t start;                /* Time the lock was last taken */
+};
+
+/* Statistics of one lock as returned by spinstat_foreach() */
+
+struct spinstatinfo_s
+{
+  FAR const char *name;          /* Name of the lock */
+  unsigned long nacquired;       /* Number of times the lock was taken */
+  unsigned long nspins;          /* Number of loops spent waiting */
+  unsigned long maxhold;         /* Longest hold time in microseconds */
+};
+
+typedef CODE void (*spinstat_handler_t)(
+  FAR const struct spinstatinfo_s *info, FAR void *arg);
+#endif
+
+/* A ticket spinlock.  CPUs take the lock in the order in which they asked
+ * for it.  Each waiter only reads the 'owner' field while it waits.  If
+ * the architecture has no atomic fetch-and-add, a guard spinlock is held
+ * just long enough to draw a ticket.  Ticket spinlocks are not reentrant.
+ */
+
+struct ticket_lock_s
+{
+#ifndef CONFIG_ARCH_HAVE_FETCHADD
+  spinlock_t guard;              /* Protects 'next' */
+#endif
+  volatile int16_t next;         /* The next ticket to be drawn */
+  volatile int16_t owner;        /* The ticket that holds the lock */
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  struct spinstat_s stat;        /* Contention statistics */
+#endif
+};
+
+typedef struct ticket_lock_s ticket_lock_t;
+
+/* An MCS queue spinlock.  Each waiter provides a queue node, usually on
+ * its stack, and spins on a flag in its own node.  The lock is handed
+ * from one node to the next in FIFO order, so there is no cache line
+ * that all waiters poll.  The guard spinlock is held just long enough to
+ * link or unlink a node.  MCS spinlocks are not reentrant.
+ */
+
+struct mcs_node_s
+{
+  FAR struct mcs_node_s *volatile next; /* The next waiter */
+  volatile bool waiting;                /* True while the lock is not ours */
+};
+
+struct mcs_lock_s
+{
+  spinlock_t guard;                     /* Protects the queue */
+  FAR struct mcs_node_s *volatile tail; /* The last node in the queue */
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  struct spinstat_s stat;               /* Contention statistics */
+#endif
+};
+
+typedef struct mcs_lock_s mcs_lock_t;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -342,5 +441,354 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *orlock);
 #endif
 
+/****************************************************************************
+ * Name: rwlock_init
+ *
+ * Description:
+ *   Initialize a reader-writer spinlock to the unlocked state.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock to initialize.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#define rwlock_init(l) \
+  do \
+    { \
+      (l)->lock    = SP_UNLOCKED; \
+      (l)->readers = 0; \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Name: read_lock
+ *
+ * Description:
+ *   Take the reader-writer spinlock for reading, spinning while a writer
+ *   holds it.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held for reading.
+ *
+ ****************************************************************************/
+
+void read_lock(FAR rwlock_t *rwlock);
+
+/****************************************************************************
+ * Name: read_trylock
+ *
+ * Description:
+ *   Try once to take the reader-writer spinlock for reading.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   true if the lock is now held for reading; false if a writer holds it.
+ *
+ ****************************************************************************/
+
+bool read_trylock(FAR rwlock_t *rwlock);
+
+/****************************************************************************
+ * Name: read_unlock
+ *
+ * Description:
+ *   Release a reader-writer spinlock held for reading.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void read_unlock(FAR rwlock_t *rwlock);
+
+/****************************************************************************
+ * Name: write_lock
+ *
+ * Description:
+ *   Take the reader-writer spinlock for writing, spinning until no other
+ *   writer holds it and all readers have left.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held for writing.
+ *
+ ****************************************************************************/
+
+void write_lock(FAR rwlock_t *rwlock);
+
+/****************************************************************************
+ * Name: write_trylock
+ *
+ * Description:
+ *   Try once to take the reader-writer spinlock for writing.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   true if the lock is now held for writing; false if it is held by a
+ *   writer or by any reader.
+ *
+ ****************************************************************************/
+
+bool write_trylock(FAR rwlock_t *rwlock);
+
+/****************************************************************************
+ * Name: write_unlock
+ *
+ * Description:
+ *   Release a reader-writer spinlock held for writing.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#define write_unlock(l) spin_unlock(&(l)->lock)
+
+/****************************************************************************
+ * Name: ticket_lock_init
+ *
+ * Description:
+ *   Initialize a ticket spinlock to the unlocked state.  If
+ *   CONFIG_SPINLOCK_STATISTICS is enabled, the lock is also registered so
+ *   that its statistics are reported in /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock to initialize.
+ *   name - The name of the lock.  The string is not copied.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Locks with statistics are never destroyed.
+ *
+ ****************************************************************************/
+
+void ticket_lock_init(FAR ticket_lock_t *lock, FAR const char *name);
+
+/****************************************************************************
+ * Name: ticket_lock
+ *
+ * Description:
+ *   Draw a ticket and spin until it is served.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void ticket_lock(FAR ticket_lock_t *lock);
+
+/****************************************************************************
+ * Name: ticket_trylock
+ *
+ * Description:
+ *   Take the ticket spinlock only if it is free and nobody is waiting.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock.
+ *
+ * Returned Value:
+ *   true if the lock is now held by this CPU; false otherwise.
+ *
+ ****************************************************************************/
+
+bool ticket_trylock(FAR ticket_lock_t *lock);
+
+/****************************************************************************
+ * Name: ticket_unlock
+ *
+ * Description:
+ *   Release the ticket spinlock to the next waiter, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ticket_unlock(FAR ticket_lock_t *lock);
+
+/****************************************************************************
+ * Name: mcs_lock_init
+ *
+ * Description:
+ *   Initialize an MCS spinlock to the unlocked state.  If
+ *   CONFIG_SPINLOCK_STATISTICS is enabled, the lock is also registered so
+ *   that its statistics are reported in /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock to initialize.
+ *   name - The name of the lock.  The string is not copied.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Locks with statistics are never destroyed.
+ *
+ ****************************************************************************/
+
+void mcs_lock_init(FAR mcs_lock_t *lock, FAR const char *name);
+
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Queue 'node' on the MCS spinlock and spin on it until the lock is
+ *   handed over.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock.
+ *   node - The queue node of the caller.  It must remain valid until the
+ *          matching mcs_unlock() returns.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void mcs_lock(FAR mcs_lock_t *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Take the MCS spinlock only if it is free.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock.
+ *   node - The queue node of the caller.
+ *
+ * Returned Value:
+ *   true if the lock is now held by this CPU; false otherwise.
+ *
+ ****************************************************************************/
+
+bool mcs_trylock(FAR mcs_lock_t *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release the MCS spinlock to the next queued node, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock.
+ *   node - The node that was passed to mcs_lock() or mcs_trylock().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mcs_unlock(FAR mcs_lock_t *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: spinstat_foreach
+ *
+ * Description:
+ *   Call 'handler' with the statistics of each registered ticket or MCS
+ *   spinlock.  No lock is held while the handler runs.
+ *
+ * Input Parameters:
+ *   handler - The function to be called for each lock
+ *   arg     - An argument passed through to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+void spinstat_foreach(spinstat_handler_t handler, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: spin_lock_irqsave_scoped
+ *
+ * Description:
+ *   If SPINLOCK_SCOPED is enabled:
+ *     Disable local interrupts and take the spinlock that protects one
+ *     particular data structure.  Unlike enter_critical_section(), this
+ *     does not serialize against other CPUs that are in unrelated critical
+ *     sections.
+ *
+ *     NOTE: Scoped spinlocks are not reentrant.  The protected code must
+ *     be short and must not call any logic that may suspend the caller or
+ *     that may call enter_critical_section().
+ *
+ *   If SPINLOCK_SCOPED is not enabled:
+ *     This function is equivalent to enter_critical_section().  The lock
+ *     is not referenced and need not exist.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to take.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to spin_lock_irqsave_scoped();
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SCOPED
+irqstate_t spin_lock_irqsave_scoped(FAR volatile spinlock_t *lock);
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_irqrestore_scoped
+ *
+ * Description:
+ *   If SPINLOCK_SCOPED is enabled:
+ *     Release the spinlock taken by spin_lock_irqsave_scoped() and restore
+ *     the interrupt state as it was prior to that call.
+ *
+ *   If SPINLOCK_SCOPED is not enabled:
+ *     This function is equivalent to leave_critical_section().
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to release.
+ *   flags - The architecture-specific value that represents the state of
+ *           the interrupts prior to the call to spin_lock_irqsave_scoped();
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SCOPED
+void spin_unlock_irqrestore_scoped(FAR volatile spinlock_t *lock,
+                                   irqstate_t flags);
+#endif
+
 #endif /* CONFIG_SPINLOCK */
+
+#ifndef CONFIG_SPINLOCK_SCOPED
+#  define spin_lock_irqsave_scoped(l)         enter_critical_section()
+#  define spin_unlock_irqrestore_scoped(l, f) leave_critical_section(f)
+#endif
+
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/symtab.h
  *
- *   Copyright (C) 2009, 2015 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2009, 2015, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -70,6 +72,18 @@ struct symtab_s
   FAR const void *sym_value;         /* The value associated witht the string */
 };
 
+#ifdef CONFIG_SYMTAB_HASHED
+/* struct symtab_hash_s is one entry of the hash index of a symbol table.
+ * The index is an array of one entry per symbol, sorted by hash value.
+ */
+
+struct symtab_hash_s
+{
+  uint32_t hash;                     /* symtab_hash() of the symbol name */
+  int index;                         /* The index of the symbol in the table */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -150,6 +164,70 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASHED
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name as used by the hash index.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_mkhash
+ *
+ * Description:
+ *   Build the hash index of a symbol table.  The symbol table must not
+ *   change while the index is in use.
+ *
+ * Returned Value:
+ *   The allocated index or NULL if there is not enough memory.  It is freed
+ *   with symtab_freehash().
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *symtab_mkhash(FAR const struct symtab_s *symtab,
+                                        int nsyms);
+
+/****************************************************************************
+ * Name: symtab_freehash
+ *
+ * Description:
+ *   Free a hash index created by symtab_mkhash().  NULL is ignored.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_freehash(FAR struct symtab_hash_s *hashtab);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name, using its
+ *   hash index.  'hash' is symtab_hash() of the name, so that it can be
+ *   computed once when the same name is looked up in several tables.  If
+ *   'hashtab' is NULL, the table is searched by name.
+ *
+ *   If several symbols have the same name, the first one in the symbol
+ *   table is returned.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_s *symtab,
+                  FAR const struct symtab_hash_s *hashtab,
+                  FAR const char *name, uint32_t hash, int nsyms);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
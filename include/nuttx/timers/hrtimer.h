@@ -0,0 +1,204 @@
+/****************************************************************************
+ * include/nuttx/timers/hrtimer.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+#define __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/tree.h>
+#include <nuttx/timers/oneshot.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Modes of hrtimer_start() */
+
+#define HRTIMER_MODE_REL  0  /* The expiration time is relative to now */
+#define HRTIMER_MODE_ABS  1  /* The expiration time is absolute */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the form of the function that is called when a high resolution
+ * timer expires.  It is called from the interrupt handler of the oneshot
+ * timer with the same restrictions as a watchdog function.
+ */
+
+struct hrtimer_s;
+typedef CODE void (*hrtimer_callback_t)(FAR struct hrtimer_s *timer,
+                                        FAR void *arg);
+
+/* This is the high resolution timer structure.  It is allocated by the
+ * caller and must persist while the timer is active.  All fields are
+ * private to the hrtimer logic.
+ */
+
+struct hrtimer_s
+{
+  RB_ENTRY(hrtimer_s) node;       /* Node in the tree of active timers */
+  uint64_t expired;               /* Absolute expiration time (nsec) */
+  hrtimer_callback_t callback;    /* Function to call on expiration */
+  FAR void *arg;                  /* Argument passed to the callback */
+  bool active;                    /* True: The timer is in the tree */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Bind the high resolution timers to a oneshot timer lower half.  That
+ *   oneshot timer must be dedicated to the hrtimer logic and must support
+ *   the current() method which provides the time base of the timers.  This
+ *   is normally called from board bring-up logic.
+ *
+ * Input Parameters:
+ *   lower - An instance of the oneshot lower half timer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer structure before its first use.
+ *
+ * Input Parameters:
+ *   timer    - The timer to initialize
+ *   callback - The function to call when the timer expires
+ *   arg      - An opaque argument that will accompany the callback
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t callback,
+                  FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer.  If the timer is already active, it is
+ *   restarted with the new expiration time.  Timers may be started from
+ *   the interrupt level, including from the callback of a timer.
+ *
+ * Input Parameters:
+ *   timer - The timer to start
+ *   nsec  - The expiration time in nanoseconds
+ *   mode  - HRTIMER_MODE_REL if nsec is relative to the current time or
+ *           HRTIMER_MODE_ABS if nsec is on the hrtimer_gettime() time base
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENODEV is returned if no oneshot
+ *   timer has been bound by hrtimer_initialize().
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t nsec, int mode);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a high resolution timer.  Cancelling a timer that is not active
+ *   has no effect.
+ *
+ * Input Parameters:
+ *   timer - The timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution timers.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in nanoseconds since the oneshot timer was initialized, or
+ *   zero if hrtimer_initialize() has not been called.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_TIMERS_HRTIMER_H */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/timers/pwm.h
  *
- *   Copyright (C) 2011-2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011-2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -57,6 +57,8 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <fixedmath.h>
 
 #include <nuttx/fs/ioctl.h>
@@ -75,6 +77,9 @@
  * CONFIG_PWM_MULTICHAN - Enables support for multiple output channels per
  *   timer.  If selected, then CONFIG_PWM_NCHANNELS must be provided to
  *   indicated the maximum number of supported PWM output channels.
+ * CONFIG_PWM_WAVEFORM - Enables support for DMA waveforms:  The hardware
+ *   plays a table of duty values, one sample per PWM period, without CPU
+ *   involvement.
  * CONFIG_DEBUG_PWM_INFO - This will generate output that can be use to
  *   debug the PWM driver.
  */
@@ -115,12 +120,25 @@
  *   and return immediately.
  *
  *   ioctl argument:  None
+ *
+ * PWMIOC_WAVEFORM - Play a waveform (CONFIG_PWM_WAVEFORM).  The duty values
+ *   of each sample are applied to their channels at the same period
+ *   boundary, one sample per PWM period, by DMA.  Any previous waveform
+ *   is replaced.  A looping waveform plays until it is stopped with
+ *   PWMIOC_STOP or replaced.  Otherwise, this ioctl call will, by default,
+ *   block until the last sample has been loaded; the output then holds the
+ *   last sample.  That default blocking behavior can be overridden by
+ *   using the O_NONBLOCK flag when the PWM driver is opened.
+ *
+ *   ioctl argument:  A read-only reference to struct pwm_waveform_s.  The
+ *   duty table is copied before the ioctl call returns.
  */
 
 #define PWMIOC_SETCHARACTERISTICS _PWMIOC(1)
 #define PWMIOC_GETCHARACTERISTICS _PWMIOC(2)
 #define PWMIOC_START              _PWMIOC(3)
 #define PWMIOC_STOP               _PWMIOC(4)
+#define PWMIOC_WAVEFORM           _PWMIOC(5)
 
 /****************************************************************************
  * Public Types
@@ -159,6 +177,23 @@ struct pwm_info_s
 #endif /* CONFIG_PWM_MULTICHAN */
 };
 
+/* This structure describes a waveform:  A table of 'nsamples' samples.  A
+ * sample holds one duty value for each of the 'nchannels' consecutive
+ * output channels, starting with 'channel'.
+ */
+
+#ifdef CONFIG_PWM_WAVEFORM
+struct pwm_waveform_s
+{
+  uint32_t           frequency; /* Frequency of the pulse train = sample rate */
+  FAR const ub16_t  *duty;      /* nsamples * nchannels duty values */
+  uint16_t           nsamples;  /* Number of samples */
+  uint8_t            channel;   /* First output channel */
+  uint8_t            nchannels; /* Number of output channels */
+  bool               loop;      /* True: Repeat the waveform until stopped */
+};
+#endif
+
 /* This structure is a set a callback functions used to call from the upper-
  * half, generic PWM driver into lower-half, platform-specific logic that
  * supports the low-level timer outputs.
@@ -183,7 +218,13 @@ struct pwm_ops_s
 
   /* (Re-)initialize the timer resources and start the pulsed output. The
    * start method should return an error if it cannot start the timer with
-   * the given parameter (frequency, duty, or optionally pulse count)
+   * the given parameter (frequency, duty, or optionally pulse count).
+   *
+   * If the output is already started, this method changes its
+   * characteristics on the fly.  Where the hardware permits (e.g. with
+   * preloaded compare registers), the new duty of all channels should then
+   * take effect at the same period boundary, without partially updated
+   * periods.  Any waveform being played is stopped.
    */
 
 #ifdef CONFIG_PWM_PULSECOUNT
@@ -203,6 +244,18 @@ struct pwm_ops_s
 
   CODE int (*ioctl)(FAR struct pwm_lowerhalf_s *dev,
                     int cmd, unsigned long arg);
+
+#ifdef CONFIG_PWM_WAVEFORM
+  /* Start playing a waveform, see PWMIOC_WAVEFORM.  This method is
+   * optional.  It must copy the duty table.  When a waveform that does not
+   * loop has loaded its last sample, the lower half must call
+   * pwm_waveform_done() with the handle.
+   */
+
+  CODE int (*waveform)(FAR struct pwm_lowerhalf_s *dev,
+                       FAR const struct pwm_waveform_s *wave,
+                       FAR void *handle);
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -317,6 +370,30 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev);
 void pwm_expired(FAR void *handle);
 #endif
 
+/****************************************************************************
+ * Name: pwm_waveform_done
+ *
+ * Description:
+ *   Called by the lower half when a waveform that does not loop has loaded
+ *   its last sample.  This wakes up the caller of PWMIOC_WAVEFORM, if it
+ *   is waiting.  The output remains started, holding the last sample.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     waveform() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_WAVEFORM
+void pwm_waveform_done(FAR void *handle);
+#endif
+
 /****************************************************************************
  * Platform-Independent "Lower-Half" PWM Driver Interfaces
  ****************************************************************************/
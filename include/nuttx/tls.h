@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/nuttx/tls.h
  *
- *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -51,7 +51,7 @@
  ****************************************************************************/
 /* Configuration ************************************************************/
 
-#ifndef CONFIG_TLS_LOG2_MAXSTACK
+#if !defined(CONFIG_TLS_THREADPTR) && !defined(CONFIG_TLS_LOG2_MAXSTACK)
 #  error CONFIG_TLS_LOG2_MAXSTACK is not defined
 #endif
 
@@ -68,10 +68,16 @@
 
 /* TLS Definitions **********************************************************/
 
-#define TLS_STACK_ALIGN   (1L << CONFIG_TLS_LOG2_MAXSTACK)
-#define TLS_STACK_MASK    (TLS_STACK_ALIGN - 1)
-#define TLS_MAXSTACK      (TLS_STACK_ALIGN)
-#define TLS_INFO(sp)      ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
+/* If the TLS information is located through the thread pointer register,
+ * the stacks need no special alignment.
+ */
+
+#ifndef CONFIG_TLS_THREADPTR
+#  define TLS_STACK_ALIGN (1L << CONFIG_TLS_LOG2_MAXSTACK)
+#  define TLS_STACK_MASK  (TLS_STACK_ALIGN - 1)
+#  define TLS_MAXSTACK    (TLS_STACK_ALIGN)
+#  define TLS_INFO(sp)    ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
+#endif
 
 /****************************************************************************
  * Public Types
@@ -88,6 +94,10 @@
  *
  * The stack memory is fully accessible to user mode threads.  TLS is not
  * available from interrupt handlers (nor from the IDLE thread).
+ *
+ * With CONFIG_TLS_THREADPTR, the stacks are not aligned.  Instead, the
+ * thread pointer register of the CPU holds the address of this structure
+ * for the running thread.  It is written on each context switch.
  */
 
 struct tls_info_s
@@ -172,8 +172,9 @@
  * bulk endpoint.  NOTE that difference sizes may be selected for full (FS)
  * or high speed (HS) modes.
  *
- * NOTE:  The BULKOUT request buffer size is always the same as the
- * maxpacket size.
+ * NOTE:  The BULKOUT request buffer size is at least the maxpacket size.
+ * Larger requests receive several packets in one transfer.  They complete
+ * on a short packet.
  */
 
 #ifndef CONFIG_CDCACM_COMPOSITE
@@ -190,6 +191,14 @@
 #  define CONFIG_CDCACM_EPBULKOUT_HSSIZE 512
 #endif
 
+#ifndef CONFIG_CDCACM_BULKOUT_REQLEN
+#  ifdef CONFIG_USBDEV_DUALSPEED
+#    define CONFIG_CDCACM_BULKOUT_REQLEN CONFIG_CDCACM_EPBULKOUT_HSSIZE
+#  else
+#    define CONFIG_CDCACM_BULKOUT_REQLEN CONFIG_CDCACM_EPBULKOUT_FSSIZE
+#  endif
+#endif
+
 /* Number of requests in the write queue.  This includes write requests used
  * for both the interrupt and bulk IN endpoints.
  */
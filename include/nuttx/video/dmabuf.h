@@ -0,0 +1,152 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A shared DMA buffer is a block of memory that is owned by one driver
+ * (the exporter) and that is used in place by other drivers (the
+ * importers), for example a camera frame that is scanned out by a
+ * framebuffer overlay without being copied.  Buffers are referred to by
+ * small integer handles that may be passed through user space.
+ *
+ * The release function is called when the last reference to the buffer is
+ * dropped.  It may be NULL for memory that is never freed, such as the
+ * memory of a framebuffer.
+ */
+
+typedef CODE void (*dmabuf_release_t)(FAR void *arg);
+
+/* Returned by dmabuf_import() */
+
+struct dmabuf_info_s
+{
+  FAR void *addr;              /* Start of the buffer */
+  size_t    size;              /* Size of the buffer in bytes */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Create a handle for a block of memory.  The handle holds a reference
+ *   that belongs to the caller and is dropped with dmabuf_release().
+ *
+ * Input Parameters:
+ *   addr    - The start of the buffer
+ *   size    - The size of the buffer in bytes
+ *   release - Called when the last reference is dropped, or NULL
+ *   arg     - The argument passed to 'release'
+ *
+ * Returned Value:
+ *   A non-negative handle is returned on success; a negated errno value is
+ *   returned on failure.  -ENFILE means that all CONFIG_VIDEO_DMABUF_NHANDLES
+ *   handles are in use.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR void *addr, size_t size, dmabuf_release_t release,
+                  FAR void *arg);
+
+/****************************************************************************
+ * Name: dmabuf_import
+ *
+ * Description:
+ *   Look up the buffer referred to by a handle and take a reference to it.
+ *   The reference is dropped with dmabuf_release().
+ *
+ * Input Parameters:
+ *   handle - The handle returned by dmabuf_export()
+ *   info   - The location to return the address and size of the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EBADF is returned if the handle does
+ *   not refer to a buffer.
+ *
+ ****************************************************************************/
+
+int dmabuf_import(int handle, FAR struct dmabuf_info_s *info);
+
+/****************************************************************************
+ * Name: dmabuf_release
+ *
+ * Description:
+ *   Drop one reference to a buffer.  When the last reference is dropped,
+ *   the handle becomes invalid and the release function of the buffer is
+ *   called.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by dmabuf_export()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void dmabuf_release(int handle);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
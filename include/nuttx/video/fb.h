@@ -288,6 +288,27 @@
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_VIDEO_DMABUF
+#  define FBIOGET_DMABUF      _FBIOC(0x0012)  /* Export the memory of the
+                                               * plane or of an overlay
+                                               * Argument: writable struct
+                                               *           fb_dmabuf_s */
+#  define FBIOSET_DMABUF      _FBIOC(0x0013)  /* Scan out a shared buffer
+                                               * Argument: read-only struct
+                                               *           fb_dmabuf_s */
+
+/* The overlay number that refers to the plane of the device */
+
+#  define FB_DMABUF_PLANE     (-1)
+#endif
+
+#ifdef CONFIG_FB_PANDISPLAY
+#  define FBIOPAN_DISPLAY     _FBIOC(0x0014)  /* Display the buffer at
+                                               * yoffset at the next vsync
+                                               * Argument: read-only struct
+                                               *           fb_planeinfo_s */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -322,6 +343,11 @@ struct fb_planeinfo_s
   fb_coord_t stride;      /* Length of a line in bytes */
   uint8_t    display;     /* Display number */
   uint8_t    bpp;         /* Bits per pixel */
+#ifdef CONFIG_FB_PANDISPLAY
+  fb_coord_t yres_virtual; /* Number of lines in fbmem.  A multiple of the
+                            * display lines for multiple buffers */
+  fb_coord_t yoffset;     /* First displayed line of fbmem */
+#endif
 };
 
 #ifdef CONFIG_FB_OVERLAY
@@ -388,6 +414,21 @@ struct fb_overlayblend_s
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_VIDEO_DMABUF
+/* This structure is used with FBIOGET_DMABUF and FBIOSET_DMABUF.  The
+ * handle is a shared DMA buffer handle (see nuttx/video/dmabuf.h), for
+ * example a frame exported by the video stream with VIDIOC_EXPBUF.
+ * FBIOSET_DMABUF with a negative handle restores the memory of the
+ * device.
+ */
+
+struct fb_dmabuf_s
+{
+  int16_t    overlay;         /* Overlay number or FB_DMABUF_PLANE */
+  int        handle;          /* Shared DMA buffer handle */
+};
+#endif
+
 /* On video controllers that support mapping of a pixel palette value
  * to an RGB encoding, the following structure may be used to define
  * that mapping.
@@ -574,6 +615,26 @@ struct fb_vtable_s
                FAR const struct fb_overlayblend_s *blend);
 # endif
 #endif
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The following is provided only if the video hardware can scan out the
+   * plane (overlayno is FB_DMABUF_PLANE) or an overlay from other memory.
+   * fbmem is NULL to restore the memory of the plane or overlay.
+   */
+
+  int (*setbuffer)(FAR struct fb_vtable_s *vtable, int overlayno,
+                   FAR void *fbmem, size_t fblen);
+#endif
+
+#ifdef CONFIG_FB_PANDISPLAY
+  /* The following is provided only if the video hardware can scan out the
+   * plane from pinfo->yoffset.  With CONFIG_FB_SYNC, it is called from
+   * fb_vsync_notify(), i.e. normally in the vsync interrupt handler.
+   */
+
+  int (*pandisplay)(FAR struct fb_vtable_s *vtable,
+                    FAR const struct fb_planeinfo_s *pinfo);
+#endif
 };
 
 /****************************************************************************
@@ -681,6 +742,26 @@ void up_fbuninitialize(int display);
 
 int fb_register(int display, int plane);
 
+/****************************************************************************
+ * Name: fb_vsync_notify
+ *
+ * Description:
+ *   Called by the framebuffer driver at each vertical sync, normally from
+ *   the vsync interrupt handler.  Apply a page flip requested with
+ *   FBIOPAN_DISPLAY and wake up the threads waiting in poll() for POLLOUT.
+ *
+ * Input Parameters:
+ *   vtable - The plane as returned by up_fbgetvplane()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PANDISPLAY
+void fb_vsync_notify(FAR struct fb_vtable_s *vtable);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -81,7 +81,7 @@ extern "C"
 
 #define VIDIOC_S_PARM                 _VIDIOC(0x0006)
 
-/* Initiate user pointer I/O */
+/* Initiate user pointer, memory mapping or DMA shared buffer I/O */
 
 #define VIDIOC_REQBUFS                _VIDIOC(0x0007)
 
@@ -163,6 +163,21 @@ extern "C"
 
 #define VIDIOC_CANCEL_DQBUF           _VIDIOC(0x0016)
 
+/* Query the status of a buffer allocated by
+ * VIDIOC_REQBUFS(V4L2_MEMORY_MMAP).  m.offset is the offset of the buffer to
+ * be passed to mmap().
+ *  Address pointing to struct v4l2_buffer
+ */
+
+#define VIDIOC_QUERYBUF               _VIDIOC(0x0017)
+
+/* Export a buffer allocated by VIDIOC_REQBUFS(V4L2_MEMORY_MMAP) as a
+ * shared DMA buffer handle (CONFIG_VIDEO_DMABUF)
+ *  Address pointing to struct v4l2_exportbuffer
+ */
+
+#define VIDIOC_EXPBUF                 _VIDIOC(0x0018)
+
 #define VIDEO_HSIZE_QVGA        (320)   /* QVGA    horizontal size */
 #define VIDEO_VSIZE_QVGA        (240)   /* QVGA    vertical   size */
 #define VIDEO_HSIZE_VGA         (640)   /* VGA     horizontal size */
@@ -213,6 +228,10 @@ extern "C"
 
 #define V4L2_REQBUFS_COUNT_MAX (256)
 
+/* MAX number of planes of a multi-planar buffer */
+
+#define VIDEO_MAX_PLANES       (3)
+
 /* Buffer error flag */
 
 #define V4L2_BUF_FLAG_ERROR    (0x0001)
@@ -221,8 +240,10 @@ extern "C"
  * Public Types
  ****************************************************************************/
 /* Buffer type.
- *  Currently, support only V4L2_BUF_TYPE_VIDEO_CAPTURE and
- *  V4L2_BUF_TYPE_STILL_CAPTURE.
+ *  Currently, support only V4L2_BUF_TYPE_VIDEO_CAPTURE,
+ *  V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE and V4L2_BUF_TYPE_STILL_CAPTURE.
+ *  V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE is the same stream as
+ *  V4L2_BUF_TYPE_VIDEO_CAPTURE.
  */
 
 enum v4l2_buf_type
@@ -244,7 +265,9 @@ enum v4l2_buf_type
   V4L2_BUF_TYPE_STILL_CAPTURE        = 0x81  /* single-planar still capture stream */
 };
 
-/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR. */
+/* Memory I/O method.  Currently, support only V4L2_MEMORY_MMAP,
+ * V4L2_MEMORY_USERPTR and V4L2_MEMORY_DMABUF.
+ */
 
 enum v4l2_memory
 {
@@ -322,8 +345,9 @@ typedef struct v4l2_plane v4l2_plane_t;
 
 /* struct v4l2_buffer
  * Parameter of ioctl(VIDIOC_QBUF) and ioctl(VIDIOC_DQBUF).
- * Currently, support only index, type, bytesused, memory,
- * m.userptr, and length.
+ * Currently, support only index, type, bytesused, flags, memory, m, and
+ * length.  For the multi-planar buffer type, m.planes points to an array of
+ * 'length' planes.  The planes must be contiguous in memory.
  */
 
 struct v4l2_buffer
@@ -348,6 +372,22 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t             type;      /* enum #v4l2_buf_type */
+  uint32_t             index;     /* buffer id */
+  uint32_t             plane;     /* plane number, zero if single-planar */
+  uint32_t             flags;     /* unused */
+  int32_t              fd;        /* Driver sets the handle of the buffer */
+  uint32_t             reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
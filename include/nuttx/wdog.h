@@ -147,6 +147,11 @@ struct wdog_s
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct wdog_s *prev;       /* Doubly links the timing wheel slot */
+  FAR struct wdog_s **slot;      /* Timing wheel slot holding the watchdog */
+  uint32_t           expire;     /* Expiration time on the timing wheel */
+#endif
 };
 
 /* Watchdog 'handle' */
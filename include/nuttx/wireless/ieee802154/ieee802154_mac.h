@@ -726,6 +726,7 @@ struct ieee802154_frame_meta_s
     uint8_t ackreq   : 1;
     uint8_t usegts   : 1;
     uint8_t indirect : 1;
+    uint8_t priority : 1;              /* Send ahead of other data frames */
   } flags;
 
 #ifdef CONFIG_IEEE802154_SECURITY
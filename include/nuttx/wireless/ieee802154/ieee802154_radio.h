@@ -54,6 +54,19 @@
  * Pre-Processor Definitions
  ****************************************************************************/
 
+/* Radio capabilities returned by the getcaps() method.  The MAC performs in
+ * software the retransmissions that the radio does not offload.  A radio
+ * that does not provide getcaps() is assumed to offload everything.
+ */
+
+#define IEEE802154_RADIOCAP_CSMA     (1 << 0) /* Performs CSMA-CA */
+#define IEEE802154_RADIOCAP_AUTOACK  (1 << 1) /* Sends and awaits ACKs */
+#define IEEE802154_RADIOCAP_RETRY    (1 << 2) /* Retransmits on missing ACK */
+
+#define IEEE802154_RADIOCAP_ALL \
+  (IEEE802154_RADIOCAP_CSMA | IEEE802154_RADIOCAP_AUTOACK | \
+   IEEE802154_RADIOCAP_RETRY)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -90,6 +103,7 @@ struct ieee802154_txdesc_s
   uint8_t  retrycount;  /* Number of remaining retries. Set to macMaxFrameRetries
                          * when txdescriptor is allocated
                          */
+  uint8_t  txprio;      /* CSMA queue the frame was taken from (MAC only) */
 
   /* TODO: Add slotting information for GTS transactions */
 };
@@ -108,6 +122,12 @@ enum ieee802154_sfevent_e
 
 /* IEEE802.15.4 Radio Interface Operations **********************************/
 
+/* The radio pulls frames from the MAC with poll().  The MAC notifies the
+ * radio with txnotify() only when its CSMA queue goes from empty to
+ * non-empty, so the radio must poll again after each txdone() until poll()
+ * returns no frame.
+ */
+
 struct ieee802154_radiocb_s
 {
   CODE int (*poll) (FAR const struct ieee802154_radiocb_s *radiocb,
@@ -148,6 +168,7 @@ struct ieee802154_radio_s
   CODE int (*beaconstop)(FAR struct ieee802154_radio_s *radio);
   CODE int (*sfupdate)(FAR struct ieee802154_radio_s *radio,
              FAR const struct ieee802154_superframespec_s *sfspec);
+  CODE uint8_t (*getcaps)(FAR struct ieee802154_radio_s *radio);
 };
 
 #ifdef __cplusplus
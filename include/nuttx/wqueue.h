@@ -1,8 +1,8 @@
 /****************************************************************************
  * include/nuttx/wqueue.h
  *
- *   Copyright (C) 2009, 2011-2014, 2017-2018 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2009, 2011-2014, 2017-2018, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -45,6 +45,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <queue.h>
 
@@ -74,6 +75,10 @@
  *   priority worker thread.  Default: 224
  * CONFIG_SCHED_HPWORKSTACKSIZE - The stack size allocated for the worker
  *   thread.  Default: 2048.
+ * CONFIG_SCHED_HPWORK_PERCPU - In an SMP configuration, also create one
+ *   high-priority worker thread with its own queue for each CPU.  Each of
+ *   these threads runs only on its CPU.  Work is queued to them with
+ *   HPWORK_THISCPU or HPWORK_CPU(n).
  * CONFIG_SIG_SIGWORK - The signal number that will be used to wake-up
  *   the worker thread.  Default: 17
  *
@@ -100,6 +105,12 @@
  *   priority worker thread.  Default: 100
  * CONFIG_LIB_USRWORKSTACKSIZE - The stack size allocated for the lower
  *   priority worker thread.  Default: 2048.
+ * CONFIG_LIB_USRWORKNTHREADS - The number of worker threads of the user-
+ *   mode work queue.  Default: 1
+ * CONFIG_LIB_USRWORKNLANES - The number of priority lanes of each user-
+ *   mode work queue.  Default: 1
+ * CONFIG_LIB_USRWORKNQUEUES - The number of private user-mode work queues
+ *   that may be created with work_usrcreate().  Default: 0
  */
 
 /* Is this a protected build (CONFIG_BUILD_PROTECTED=y) */
@@ -215,6 +226,18 @@
 #    define CONFIG_LIB_USRWORKSTACKSIZE CONFIG_IDLETHREAD_STACKSIZE
 #  endif
 
+#  ifndef CONFIG_LIB_USRWORKNTHREADS
+#    define CONFIG_LIB_USRWORKNTHREADS 1
+#  endif
+
+#  ifndef CONFIG_LIB_USRWORKNLANES
+#    define CONFIG_LIB_USRWORKNLANES 1
+#  endif
+
+#  ifndef CONFIG_LIB_USRWORKNQUEUES
+#    define CONFIG_LIB_USRWORKNQUEUES 0
+#  endif
+
 #endif /* CONFIG_LIB_USRWORK */
 
 /* Work queue IDs:
@@ -232,14 +255,21 @@
  *     references to user-space work queues.  That would be an error.
  *     Otherwise, in a flat build, user applications will use the lower
  *     priority work queue (if there is one).
+ *
+ *   WORK_LANE(qid, lane):  The ID of priority lane 'lane' of the user-mode
+ *     work queue 'qid'.  Ready work of a higher lane is always performed
+ *     before ready work of a lower lane.  Lane zero, the default, is the
+ *     lowest.  Work may be cancelled with the ID of any lane of its queue.
+ *     In kernel mode, the lane is ignored.
  */
 
 #if defined(CONFIG_LIB_USRWORK) && !defined(__KERNEL__)
 /* User mode */
 
 #  define USRWORK  2          /* User mode work queue */
-#  define HPWORK   USRWORK    /* Redirect kernel-mode references */
-#  define LPWORK   USRWORK
+#  define WORK_LANE(qid, lane) ((qid) | ((lane) << 8))
+#  define HPWORK   WORK_LANE(USRWORK, CONFIG_LIB_USRWORKNLANES - 1)
+#  define LPWORK   USRWORK    /* Redirect kernel-mode references */
 
 #else
 /* Kernel mode */
@@ -251,9 +281,34 @@
 #    define LPWORK HPWORK     /* Redirect low-priority references */
 #  endif
 #  define USRWORK  LPWORK     /* Redirect user-mode references */
+#  define WORK_LANE(qid, lane) (qid)
 
 #endif /* CONFIG_LIB_USRWORK && !__KERNEL__ */
 
+/* Per-CPU, high priority work queue IDs:
+ *
+ *   HPWORK_CPU(n): The ID of the high priority work queue whose worker
+ *     thread runs only on CPU n.
+ *
+ *   HPWORK_THISCPU: Selects the per-CPU queue of the CPU that calls
+ *     work_queue().  Queuing from an interrupt handler will then perform
+ *     the work on the CPU that took the interrupt.
+ *
+ * Work on any per-CPU queue may be re-queued or cancelled from any CPU with
+ * any of the per-CPU IDs.
+ *
+ * Without CONFIG_SCHED_HPWORK_PERCPU, these are redirected to HPWORK.
+ */
+
+#if defined(CONFIG_SCHED_HPWORK_PERCPU) && defined(CONFIG_SCHED_HPWORK) && \
+    (!defined(CONFIG_LIB_USRWORK) || defined(__KERNEL__))
+#  define HPWORK_THISCPU 3          /* Queue for the calling CPU */
+#  define HPWORK_CPU(n)  (4 + (n))  /* Queue for CPU n */
+#else
+#  define HPWORK_THISCPU HPWORK
+#  define HPWORK_CPU(n)  HPWORK
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -276,8 +331,25 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   clock_t qtime;         /* Time work queued */
   clock_t delay;         /* Delay until work performed */
+#if defined(CONFIG_LIB_USRWORK) && !defined(__KERNEL__)
+  uint8_t lane;          /* Priority lane of user-mode work */
+#endif
 };
 
+#if defined(CONFIG_LIB_USRWORK) && !defined(__KERNEL__)
+/* The deadline statistics of one lane of a user-mode work queue.  The
+ * lateness of work is the time from when it was due (when it was queued
+ * plus its delay) until its worker was called.
+ */
+
+struct work_stats_s
+{
+  uint32_t nwork;        /* Number of work performed */
+  clock_t maxlate;       /* Maximum lateness in clock ticks */
+  clock_t totallate;     /* Sum of the lateness in clock ticks */
+};
+#endif
+
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
  */
@@ -373,6 +445,54 @@ extern "C"
 int work_usrstart(void);
 #endif
 
+/****************************************************************************
+ * Name: work_usrcreate
+ *
+ * Description:
+ *   Create a private user-mode work queue for an application subsystem.
+ *   The queue has its own worker threads and exists until the process
+ *   exits.  Up to CONFIG_LIB_USRWORKNQUEUES queues may be created.
+ *
+ * Input Parameters:
+ *   name      - The name of the worker threads
+ *   priority  - The priority of the worker threads
+ *   stacksize - The stack size of the worker threads
+ *   nthreads  - The number of worker threads, at most
+ *               CONFIG_LIB_USRWORKNTHREADS
+ *
+ * Returned Value:
+ *   The work queue ID to be used with work_queue() and the other work
+ *   queue interfaces is returned on success.  A negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_LIB_USRWORK) && !defined(__KERNEL__)
+int work_usrcreate(FAR const char *name, int priority, int stacksize,
+                   int nthreads);
+#endif
+
+/****************************************************************************
+ * Name: work_usrstats
+ *
+ * Description:
+ *   Return the deadline statistics of one lane of a user-mode work queue
+ *   and optionally reset them.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID, see WORK_LANE()
+ *   stats - The location to return the statistics
+ *   reset - True: Reset the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_LIB_USRWORK) && !defined(__KERNEL__)
+int work_usrstats(int qid, FAR struct work_stats_s *stats, bool reset);
+#endif
+
 /****************************************************************************
  * Name: work_queue
  *
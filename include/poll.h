@@ -110,6 +110,13 @@ typedef unsigned int nfds_t;
 
 typedef uint8_t pollevent_t;
 
+/* The callback invoked by poll_notify() in place of posting the semaphore.
+ * This is used by epoll to maintain its ready list.
+ */
+
+struct pollfd;
+typedef CODE void (*pollcb_t)(FAR struct pollfd *fds);
+
 /* This is the Nuttx variant of the standard pollfd structure.  The poll()
  * interfaces receive a variable length array of such structures.
  *
@@ -132,6 +139,8 @@ struct pollfd
   FAR void    *ptr;     /* The psock or file being polled */
   FAR sem_t   *sem;     /* Pointer to semaphore used to post output event */
   FAR void    *priv;    /* For use by drivers */
+  pollcb_t     cb;      /* Called by poll_notify() if non-NULL */
+  FAR void    *arg;     /* For use by the callback */
 };
 
 /****************************************************************************
@@ -109,6 +109,11 @@
  *   the mutex before another thread can acquire the mutex. A thread attempting
  *   to unlock a mutex which another thread has locked will return with an error.
  *   A thread attempting to unlock an unlocked mutex will return with an error.
+ * PTHREAD_MUTEX_ADAPTIVE_NP
+ *   Non-standard.  This type of mutex provides the same error checking as
+ *   PTHREAD_MUTEX_ERRORCHECK.  In addition, a thread attempting to lock the
+ *   mutex while it is held by a thread running on another CPU will spin for
+ *   a while, waiting for the mutex to be released, before it blocks.
  * PTHREAD_MUTEX_DEFAULT
  *  An implementation is allowed to map this mutex to one of the other mutex
  *  types.
@@ -117,7 +122,15 @@
 #define PTHREAD_MUTEX_NORMAL          0
 #define PTHREAD_MUTEX_ERRORCHECK      1
 #define PTHREAD_MUTEX_RECURSIVE       2
-#define PTHREAD_MUTEX_DEFAULT         PTHREAD_MUTEX_NORMAL
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+#  define PTHREAD_MUTEX_ADAPTIVE_NP   3
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_DEFAULT_ADAPTIVE
+#  define PTHREAD_MUTEX_DEFAULT       PTHREAD_MUTEX_ADAPTIVE_NP
+#else
+#  define PTHREAD_MUTEX_DEFAULT       PTHREAD_MUTEX_NORMAL
+#endif
 
 /* Valid ranges for the pthread stacksize attribute */
 
@@ -57,6 +57,8 @@
 
 #define PRIOINHERIT_FLAGS_DISABLE (1 << 0)  /* Bit 0: Priority inheritance
                                              * is disabled for this semaphore. */
+#define PRIOINHERIT_FLAGS_BOOSTED (1 << 1)  /* Bit 1: The priority of a holder
+                                             * may have been boosted. */
 
 /****************************************************************************
  * Public Type Declarations
@@ -69,14 +71,17 @@ struct tcb_s; /* Forward reference */
 struct semholder_s
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  struct semholder_s *flink;     /* Implements singly linked list */
+  struct semholder_s *flink;     /* Implements doubly linked list of the */
+  struct semholder_s *blink;     /*   holders of the semaphore */
+  struct semholder_s *tlink;     /* Next holder record of the same TCB */
+  FAR struct sem_s *sem;         /* Semaphore that the counts are held on */
 #endif
   FAR struct tcb_s *htcb;        /* Holder TCB */
   int16_t counts;                /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, NULL, 0}
 #else
 #  define SEMHOLDER_INITIALIZER {NULL, 0}
 #endif
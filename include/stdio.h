@@ -1,7 +1,7 @@
 /****************************************************************************
  * include/stdio.h
  *
- *   Copyright (C) 2007-2009, 2011, 2013-2015, 2018-2019 Gregory Nutt. All
+ *   Copyright (C) 2007-2009, 2011, 2013-2015, 2018-2020 Gregory Nutt. All
  *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
@@ -91,6 +91,8 @@
 #define putchar(c) fputc(c, stdout)
 #define getc(s)    fgetc(s)
 #define getchar()  fgetc(stdin)
+#define getchar_unlocked()  getc_unlocked(stdin)
+#define putchar_unlocked(c) putc_unlocked((c), stdout)
 #define rewind(s)  ((void)fseek((s),0,SEEK_SET))
 
 /* Path to the directory where temporary files can be created */
@@ -173,6 +175,16 @@ void   setbuf(FAR FILE *stream, FAR char *buf);
 int    setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size);
 int    ungetc(int c, FAR FILE *stream);
 
+/* Explicit locking of streams.  The *_unlocked() variants may only be used
+ * by the owner of the stream (or on a stream shared with no other thread).
+ */
+
+void   flockfile(FAR FILE *stream);
+int    ftrylockfile(FAR FILE *stream);
+void   funlockfile(FAR FILE *stream);
+int    fgetc_unlocked(FAR FILE *stream);
+int    fputc_unlocked(int c, FAR FILE *stream);
+
 /* Operations on the stdout stream, buffers, paths, and the whole printf-family */
 
 void   perror(FAR const char *s);
@@ -227,4 +239,68 @@ int pclose(FILE *stream);
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getc_unlocked
+ *
+ * Description:
+ *   Get a character from a stream owned by the caller.  A character that is
+ *   already in the read buffer is taken directly from the buffer.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_HAVE_INLINE) || defined(__cplusplus)
+static inline int getc_unlocked(FAR FILE *stream)
+{
+#if CONFIG_NFILE_STREAMS > 0 && !defined(CONFIG_STDIO_DISABLE_BUFFERING)
+  if (stream->fs_bufpos < stream->fs_bufread
+#if CONFIG_NUNGET_CHARS > 0
+      && stream->fs_nungotten == 0
+#endif
+     )
+    {
+      return *stream->fs_bufpos++;
+    }
+#endif
+
+  return fgetc_unlocked(stream);
+}
+#else
+#  define getc_unlocked(s) fgetc_unlocked(s)
+#endif
+
+/****************************************************************************
+ * Name: putc_unlocked
+ *
+ * Description:
+ *   Put a character to a stream owned by the caller.  If the buffer already
+ *   holds write data and has room for the character, the character is put
+ *   directly into the buffer unless it is a newline that must flush a line
+ *   buffered stream.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_HAVE_INLINE) || defined(__cplusplus)
+static inline int putc_unlocked(int c, FAR FILE *stream)
+{
+#if CONFIG_NFILE_STREAMS > 0 && !defined(CONFIG_STDIO_DISABLE_BUFFERING)
+  if (stream->fs_bufpos > stream->fs_bufstart &&
+      stream->fs_bufpos < stream->fs_bufend &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = (unsigned char)c;
+      return (unsigned char)c;
+    }
+#endif
+
+  return fputc_unlocked(c, stream);
+}
+#else
+#  define putc_unlocked(c,s) fputc_unlocked((c),(s))
+#endif
+
 #endif /* __INCLUDE_STDIO_H */
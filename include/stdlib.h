@@ -95,6 +95,18 @@ struct mallinfo
                  * chunks handed out by malloc. */
   int fordblks; /* This is the total size of memory occupied
                  * by free (not in use) chunks.*/
+#ifdef CONFIG_MM_CACHE
+  int cachedblks;            /* Total size of memory held in the small-
+                              * object caches (included in uordblks) */
+  unsigned long cachehits;   /* Allocations satisfied from the caches */
+  unsigned long cachemisses; /* Small allocations that went to the heap */
+#endif
+#ifdef CONFIG_MM_REALLOC_STATS
+  unsigned long reallocinplace; /* Reallocations resized in place */
+  unsigned long reallocmoved;   /* Reallocations moved into the preceding
+                                 * free chunk */
+  unsigned long realloccopied;  /* Reallocations copied to a new chunk */
+#endif
 };
 
 /* Structure type returned by the div() function. */
@@ -1,5 +1,5 @@
 /****************************************************************************
- * fs/vfs/fs_epoll.c
+ * include/sys/epoll.h
  *
  *   Copyright (C) 2015 Anton D. Kachalov. All rights reserved.
  *   Author: Anton D. Kachalov <mouse@mayc.ru>
@@ -40,6 +40,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <poll.h>
 
 /****************************************************************************
@@ -50,6 +53,17 @@
 #define EPOLL_CTL_DEL 2 /* Remove a file descriptor from the interface.  */
 #define EPOLL_CTL_MOD 3 /* Change file descriptor epoll_event structure.  */
 
+/* Flags for epoll_create1().  NuttX has no exec() that could close the
+ * descriptor, so EPOLL_CLOEXEC is accepted but has no effect.
+ */
+
+#define EPOLL_CLOEXEC (1 << 19)
+
+/* Input flags of struct epoll_event.  These do not fit in pollevent_t. */
+
+#define EPOLLONESHOT  (1u << 30) /* Disable the descriptor after one event */
+#define EPOLLET       (1u << 31) /* Edge-triggered notification */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -76,35 +90,50 @@ enum EPOLL_EVENTS
 #define EPOLLHUP EPOLLHUP
   };
 
-typedef union poll_data
+typedef union epoll_data
 {
+  FAR void    *ptr;
   int          fd;       /* The descriptor being polled */
+  uint32_t     u32;
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t     u64;
+#endif
 } epoll_data_t;
 
 struct epoll_event
 {
-  epoll_data_t data;
-  FAR sem_t   *sem;      /* Pointer to semaphore used to post output event */
-  pollevent_t  events;   /* The input event flags */
-  pollevent_t  revents;  /* The output event flags */
-  FAR void    *priv;     /* For use by drivers */
-};
-
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
+  uint32_t     events;   /* The input or output event flags */
+  epoll_data_t data;     /* Returned unmodified by epoll_wait() */
 };
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
 int epoll_create(int size);
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev);
-int epoll_wait(int epfd, struct epoll_event *evs, int maxevents, int timeout);
+int epoll_create1(int flags);
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+               int timeout);
+
+/* epoll_close() is retained for compatibility.  It is equivalent to
+ * close().
+ */
 
 void epoll_close(int epfd);
 
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* __INCLUDE_SYS_EPOLL_H */
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_IORING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry operations
+ *
+ * IORING_OP_NOP     - Complete with the result zero.
+ * IORING_OP_READ    - Read 'len' bytes into 'addr' at 'offset', or at the
+ *                     file position if 'offset' is negative.
+ * IORING_OP_WRITE   - Write 'len' bytes from 'addr' at 'offset', or at the
+ *                     file position if 'offset' is negative.
+ * IORING_OP_FSYNC   - Synchronize the file.
+ * IORING_OP_POLL    - Return the events of 'rwflags' that are currently
+ *                     pending on the descriptor without waiting.
+ * IORING_OP_SENDMSG - Send the struct msghdr at 'addr' with the socket
+ *                     flags 'rwflags'.
+ * IORING_OP_RECVMSG - Receive into the struct msghdr at 'addr' with the
+ *                     socket flags 'rwflags'.
+ */
+
+#define IORING_OP_NOP      0
+#define IORING_OP_READ     1
+#define IORING_OP_WRITE    2
+#define IORING_OP_FSYNC    3
+#define IORING_OP_POLL     4
+#define IORING_OP_SENDMSG  5
+#define IORING_OP_RECVMSG  6
+
+/* Submission queue entry flags
+ *
+ * IORING_SQE_LINK   - If the entry fails, the following entries of the
+ *                     same call complete with -ECANCELED until an entry
+ *                     without this flag.
+ */
+
+#define IORING_SQE_LINK    (1 << 0)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* One operation submitted by the application */
+
+struct ioring_sqe_s
+{
+  uint8_t opcode;                 /* IORING_OP_* */
+  uint8_t flags;                  /* IORING_SQE_* */
+  int16_t fd;                     /* File or socket descriptor */
+  int rwflags;                    /* Socket flags or poll events */
+  off_t offset;                   /* File offset (negative: current) */
+  FAR void *addr;                 /* Buffer or struct msghdr */
+  size_t len;                     /* Length of the buffer */
+  uintptr_t user_data;            /* Returned in the completion entry */
+};
+
+/* The result of one operation */
+
+struct ioring_cqe_s
+{
+  uintptr_t user_data;            /* From the submission entry */
+  ssize_t res;                    /* Result or negated errno value */
+};
+
+/* The submission and the completion rings, both in application memory.
+ * The number of entries of each ring must be a power of two.  The indexes
+ * are free running:  The entry of index 'i' is at 'i & (entries - 1)'.
+ *
+ * The application fills the submission entries at sq_tail and then
+ * advances sq_tail.  ioring_enter() consumes them from sq_head and
+ * advances sq_head.  The completion entries are added at cq_tail by
+ * ioring_enter() and are consumed from cq_head by the application.
+ */
+
+struct ioring_s
+{
+  volatile uint32_t sq_head;      /* Next entry consumed by the kernel */
+  volatile uint32_t sq_tail;      /* Next entry filled by the application */
+  uint32_t sq_entries;            /* Number of submission entries */
+  FAR struct ioring_sqe_s *sqes;  /* The submission entries */
+
+  volatile uint32_t cq_head;      /* Next entry consumed by the application */
+  volatile uint32_t cq_tail;      /* Next entry filled by the kernel */
+  uint32_t cq_entries;            /* Number of completion entries */
+  FAR struct ioring_cqe_s *cqes;  /* The completion entries */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Perform up to 'to_submit' operations from the submission ring and add
+ *   their results to the completion ring, all in one system call.
+ *   Submission stops early when the completion ring is full.  The
+ *   operations are performed in order, each as if by the corresponding
+ *   system call.
+ *
+ * Input Parameters:
+ *   ring      - The submission and completion rings
+ *   to_submit - The maximum number of operations to perform
+ *
+ * Returned Value:
+ *   The number of operations consumed from the submission ring.  On error,
+ *   -1 is returned and errno is set:
+ *
+ *   EINVAL - The ring is not valid
+ *   EBUSY  - The completion ring is full
+ *
+ ****************************************************************************/
+
+int ioring_enter(FAR struct ioring_s *ring, unsigned int to_submit);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_IORING */
+#endif /* __INCLUDE_SYS_IORING_H */
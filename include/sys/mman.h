@@ -174,7 +174,7 @@ int msync(FAR void *addr, size_t len, int flags);
 int munlock(FAR const void *addr, size_t len);
 int munlockall(void);
 
-#ifdef CONFIG_FS_RAMMAP
+#if defined(CONFIG_FS_RAMMAP) || defined(CONFIG_FS_FILEMAP)
 int munmap(FAR void *start, size_t length);
 #else
 #  define munmap(start, length)
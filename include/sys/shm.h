@@ -54,6 +54,13 @@
 #define SHM_RDONLY 0x01 /* Attach read-only (else read-write) */
 #define SHM_RND    0x02 /* Round attach address to SHMLBA */
 
+/* Non-standard shmget() flag:  Back the segment with physically contiguous
+ * memory that can be mapped with large pages, if the platform supports
+ * them (see CONFIG_MM_SHM_LARGEPAGES).  The flag is ignored otherwise.
+ */
+
+#define SHM_HUGETLB (1 << 13)
+
 /* Segment low boundary address multiple */
 
 #ifdef CONFIG_SHM_SHMLBA
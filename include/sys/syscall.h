@@ -2,7 +2,7 @@
  * include/sys/syscall.h
  * This file contains the system call numbers.
  *
- *   Copyright (C) 2011-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011-2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -45,6 +45,7 @@
 
 #ifndef __ASSEMBLY__
 #  include <stdint.h>
+#  include <stdbool.h>
 #endif
 
 #ifdef CONFIG_LIB_SYSCALL
@@ -253,7 +254,11 @@
 
 #define SYS_clock                      (__SYS_clock + 0)
 #define SYS_clock_getres               (__SYS_clock + 1)
-#define SYS_clock_gettime              (__SYS_clock + 2)
+#ifdef CONFIG_CLOCK_TIMEPAGE
+#  define SYS_clock_timepage           (__SYS_clock + 2)
+#else
+#  define SYS_clock_gettime            (__SYS_clock + 2)
+#endif
 #define SYS_clock_settime              (__SYS_clock + 3)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
 #  define SYS_adjtime                  (__SYS_clock + 4)
@@ -304,9 +309,16 @@
 #  define SYS_aio_write              (__SYS_descriptors + 7)
 #  define SYS_aio_fsync              (__SYS_descriptors + 8)
 #  define SYS_aio_cancel             (__SYS_descriptors + 9)
-#  define __SYS_poll                 (__SYS_descriptors + 10)
+#  define __SYS_ioring               (__SYS_descriptors + 10)
+#else
+#  define __SYS_ioring               (__SYS_descriptors + 6)
+#endif
+
+#ifdef CONFIG_FS_IORING
+#  define SYS_ioring_enter           __SYS_ioring
+#  define __SYS_poll                 (__SYS_ioring + 1)
 #else
-#  define __SYS_poll                 (__SYS_descriptors + 6)
+#  define __SYS_poll                 __SYS_ioring
 #endif
 
 #define SYS_poll                     __SYS_poll
@@ -357,12 +369,13 @@
 #define SYS_statfs                     (__SYS_filedesc + 13)
 #define SYS_fstatfs                    (__SYS_filedesc + 14)
 #define SYS_telldir                    (__SYS_filedesc + 15)
+#define SYS_getdents                   (__SYS_filedesc + 16)
 
-#ifdef CONFIG_FS_RAMMAP
-#  define SYS_munmap                   (__SYS_filedesc + 16)
-#  define __SYS_link                   (__SYS_filedesc + 17)
+#if defined(CONFIG_FS_RAMMAP) || defined(CONFIG_FS_FILEMAP)
+#  define SYS_munmap                   (__SYS_filedesc + 17)
+#  define __SYS_link                   (__SYS_filedesc + 18)
 #else
-#  define __SYS_link                   (__SYS_filedesc + 16)
+#  define __SYS_link                   (__SYS_filedesc + 17)
 #endif
 
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
@@ -382,9 +395,18 @@
 
 #if defined(CONFIG_PIPES) && CONFIG_DEV_FIFO_SIZE > 0
 #  define SYS_mkfifo2                  (__SYS_mkfifo2 + 0)
-#  define __SYS_fs_fdopen              (__SYS_mkfifo2 + 1)
+#  define __SYS_splice                 (__SYS_mkfifo2 + 1)
 #else
-#  define __SYS_fs_fdopen              (__SYS_mkfifo2 + 0)
+#  define __SYS_splice                 (__SYS_mkfifo2 + 0)
+#endif
+
+#if defined(CONFIG_PIPES)
+#  define SYS_splice                   (__SYS_splice + 0)
+#  define SYS_tee                      (__SYS_splice + 1)
+#  define SYS_vmsplice                 (__SYS_splice + 2)
+#  define __SYS_fs_fdopen              (__SYS_splice + 3)
+#else
+#  define __SYS_fs_fdopen              (__SYS_splice + 0)
 #endif
 
 #if CONFIG_NFILE_STREAMS > 0
@@ -549,16 +571,20 @@
 #  define SYS_sendto                   (__SYS_network + 10)
 #  define SYS_setsockopt               (__SYS_network + 11)
 #  define SYS_socket                   (__SYS_network + 12)
+#  define SYS_recvmmsg                 (__SYS_network + 13)
+#  define SYS_sendmmsg                 (__SYS_network + 14)
+#  define __SYS_prctl                  (__SYS_network + 15)
 #else
 #  define SYS_socket                    __SYS_network
+#  define __SYS_prctl                  (__SYS_network + 1)
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
 #if CONFIG_TASK_NAME_SIZE > 0
-#  define SYS_prctl                    (SYS_socket + 1)
+#  define SYS_prctl                    __SYS_prctl
 #else
-#  define SYS_prctl                    SYS_socket
+#  define SYS_prctl                    (__SYS_prctl - 1)
 #endif
 
 /* The following is defined only if entropy pool random number generator
@@ -567,9 +593,18 @@
 
 #ifdef CONFIG_CRYPTO_RANDOM_POOL
 #  define SYS_getrandom                (SYS_prctl + 1)
-#  define SYS_maxsyscall               (SYS_prctl + 2)
+#  define __SYS_multicall              (SYS_prctl + 2)
 #else
-#  define SYS_maxsyscall               (SYS_prctl + 1)
+#  define __SYS_multicall              (SYS_prctl + 1)
+#endif
+
+/* The following is defined only if vectored system calls are enabled */
+
+#ifdef CONFIG_LIB_SYSCALL_MULTICALL
+#  define SYS_multicall                __SYS_multicall
+#  define SYS_maxsyscall               (__SYS_multicall + 1)
+#else
+#  define SYS_maxsyscall               __SYS_multicall
 #endif
 
 /* Note that the reported number of system calls does *NOT* include the
@@ -579,16 +614,39 @@
 
 #define SYS_nsyscalls                  (SYS_maxsyscall-CONFIG_SYS_RESERVED)
 
+#ifndef __ASSEMBLY__
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_LIB_SYSCALL_MULTICALL
+/* One entry of the list of system calls performed by multicall() */
+
+struct multicall_s
+{
+  uintptr_t nbr;               /* The system call number (SYS_xxx) */
+  uintptr_t parm[6];           /* The parameters of the system call */
+  uintptr_t result;            /* The value returned by the system call */
+};
+#endif
+
+#if defined(CONFIG_LIB_SYSCALL_STATS) && defined(__KERNEL__)
+/* The statistics of one system call as returned by syscall_stats() */
+
+struct syscall_stats_s
+{
+  FAR const char *name;        /* The name of the system call */
+  uint32_t count;              /* The number of calls that returned */
+  uint64_t total;              /* The total time of all calls (nsec) */
+  uint64_t max;                /* The longest time of one call (nsec) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-#ifndef __ASSEMBLY__
-
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -616,6 +674,15 @@ EXTERN const uintptr_t g_funclookup[SYS_nsyscalls];
 
 EXTERN const uintptr_t g_stublookup[SYS_nsyscalls];
 
+#ifdef CONFIG_LIB_SYSCALL_STATS
+/* If system call statistics are enabled, all entries of g_stublookup[]
+ * refer to the same statistics stub.  The addresses of the real stub
+ * functions are then provided by this table.
+ */
+
+EXTERN const uintptr_t g_stubtarget[SYS_nsyscalls];
+#endif
+
 #endif
 
 /* Given the system call number, the corresponding entry in this table
@@ -628,6 +695,75 @@ EXTERN const uint8_t g_funcnparms[SYS_nsyscalls];
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: multicall
+ *
+ * Description:
+ *   Perform a list of system calls with a single trap into the kernel.  The
+ *   calls are performed in order and the value returned by each call is
+ *   saved in the 'result' field of its entry.  The list stops after the
+ *   first call that returns -1, leaving errno set by that call.
+ *
+ * Input Parameters:
+ *   calls  - The list of system calls
+ *   ncalls - The number of entries in the list
+ *
+ * Returned Value:
+ *   The number of entries that were processed is returned on success.
+ *   -1 (ERROR) is returned and errno is set to EINVAL if the list is
+ *   invalid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_SYSCALL_MULTICALL
+int multicall(FAR struct multicall_s *calls, int ncalls);
+#endif
+
+#ifdef __KERNEL__
+
+/****************************************************************************
+ * Name: syscall_fastpath
+ *
+ * Description:
+ *   Complete a simple, non-blocking system call in the system call
+ *   exception handler.  Called by the architecture-specific handler before
+ *   it sets up the normal dispatch of the system call.
+ *
+ * Input Parameters:
+ *   nbr    - The system call number (SYS_xxx)
+ *   parm1  - The first system call parameter
+ *   parm2  - The second system call parameter
+ *   result - The location to return the value of the system call
+ *
+ * Returned Value:
+ *   True is returned if the system call was completed.  False is returned
+ *   if the system call must be dispatched in the normal way.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_SYSCALL_FASTPATH
+bool syscall_fastpath(uintptr_t nbr, uintptr_t parm1, uintptr_t parm2,
+                      FAR uintptr_t *result);
+#endif
+
+/****************************************************************************
+ * Name: syscall_stats_record and syscall_stats
+ *
+ * Description:
+ *   syscall_stats_record() counts one completed system call with its
+ *   elapsed time in the units of up_critmon_gettime().  syscall_stats()
+ *   returns the statistics of one system call.  Both are indexed by the
+ *   system call number less CONFIG_SYS_RESERVED.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_SYSCALL_STATS
+void syscall_stats_record(int index, uint32_t elapsed);
+int syscall_stats(int index, FAR struct syscall_stats_s *stats);
+#endif
+
+#endif /* __KERNEL__ */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
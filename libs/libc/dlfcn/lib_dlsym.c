@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/dlfcn/lib_dlsym.c
  *
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -97,8 +97,13 @@ static inline FAR const void *dlgetsym(FAR void *handle,
 
   /* Search the symbol table for the matching symbol */
 
+#ifdef CONFIG_SYMTAB_HASHED
+  symbol = symtab_findbyhash(modp->modinfo.exports, modp->exphash, name,
+                             symtab_hash(name), modp->modinfo.nexports);
+#else
   symbol = symtab_findbyname(modp->modinfo.exports, name,
                              modp->modinfo.nexports);
+#endif
   if (symbol == NULL)
     {
       serr("ERROR: Failed to find symbol in symbol \"%s\" in table\n", name);
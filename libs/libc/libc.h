@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/libc.h
  *
- *   Copyright (C) 2007-2014, 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2014, 2016-2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -43,6 +44,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <limits.h>
@@ -71,6 +73,7 @@
 #ifdef CONFIG_STDIO_DISABLE_BUFFERING
 #  define lib_sem_initialize(s)
 #  define lib_take_semaphore(s)
+#  define lib_trytake_semaphore(s) (0)
 #  define lib_give_semaphore(s)
 #endif
 
@@ -121,6 +124,19 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* Helpers for the string functions that work a machine word at a time.
+ * LIBC_HASZERO() is non-zero if any byte of the word 'w' is zero.
+ */
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#  define LIBC_WORDSIZE      sizeof(uintptr_t)
+#  define LIBC_WORDMASK      (LIBC_WORDSIZE - 1)
+#  define LIBC_ALIGNED(p)    (((uintptr_t)(p) & LIBC_WORDMASK) == 0)
+#  define LIBC_ONES          ((uintptr_t)-1 / 0xff)
+#  define LIBC_HIGHS         (LIBC_ONES << 7)
+#  define LIBC_HASZERO(w)    (((w) - LIBC_ONES) & ~(w) & LIBC_HIGHS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -162,10 +178,13 @@ int lib_mode2oflags(FAR const char *mode);
 
 /* Defined in lib_libfwrite.c */
 
+ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
+                            FAR FILE *stream);
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
 
 /* Defined in lib_libfread.c */
 
+ssize_t lib_fread_unlocked(FAR void *ptr, size_t count, FAR FILE *stream);
 ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream);
 
 /* Defined in lib_libfgets.c */
@@ -190,6 +209,7 @@ int lib_wrflush(FAR FILE *stream);
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
 void lib_sem_initialize(FAR struct file_struct *stream);
 void lib_take_semaphore(FAR struct file_struct *stream);
+int  lib_trytake_semaphore(FAR struct file_struct *stream);
 void lib_give_semaphore(FAR struct file_struct *stream);
 #endif
 
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * libs/libc/lz4/lz4.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_LZ4_LZ4_H
+#define __LIBS_LIBC_LZ4_LZ4_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <lz4.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Little-endian accesses of possibly unaligned data */
+
+#define LZ4_GET16(p)  ((uint16_t)(p)[0] | (uint16_t)(p)[1] << 8)
+#define LZ4_GET32(p)  ((uint32_t)(p)[0]       | (uint32_t)(p)[1] << 8 | \
+                       (uint32_t)(p)[2] << 16 | (uint32_t)(p)[3] << 24)
+
+#define LZ4_PUT16(p,v) \
+  do \
+    { \
+      (p)[0] = (uint8_t)(v); \
+      (p)[1] = (uint8_t)((v) >> 8); \
+    } \
+  while (0)
+
+#define LZ4_PUT32(p,v) \
+  do \
+    { \
+      (p)[0] = (uint8_t)(v); \
+      (p)[1] = (uint8_t)((v) >> 8); \
+      (p)[2] = (uint8_t)((v) >> 16); \
+      (p)[3] = (uint8_t)((v) >> 24); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_decompress_block
+ *
+ * Description:
+ *   Decompress one LZ4 block to 'out'.  Matches may refer back to any data
+ *   from 'base', which is either 'out' or the start of the previously
+ *   decompressed blocks of a frame with linked blocks.
+ *
+ * Returned Value:
+ *   The number of decompressed bytes or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t lz4_decompress_block(FAR const uint8_t *in, size_t in_len,
+                             FAR const uint8_t *base, FAR uint8_t *out,
+                             size_t out_len);
+
+#endif /* __LIBS_LIBC_LZ4_LZ4_H */
@@ -0,0 +1,405 @@
+/****************************************************************************
+ * libs/libc/lz4/lz4_block.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "lz4/lz4.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* LZ4 block format:
+ *
+ *   A block is a sequence of sequences:  A token byte (4 bits of literal
+ *   length, 4 bits of match length), any literal length extension bytes,
+ *   the literals, a 16-bit little-endian match offset and any match length
+ *   extension bytes.  The last sequence has literals only.  A length field
+ *   of 15 is followed by extension bytes that are added until a byte which
+ *   is not 255.  The minimum match length is 4.  The last 5 bytes of a
+ *   block are always literals and the last match must start at least 12
+ *   bytes before the end of the block.
+ */
+
+#define LZ4_MINMATCH       4
+#define LZ4_LASTLITERALS   5
+#define LZ4_MFLIMIT        12
+#define LZ4_MAXOFFSET      65535
+
+#define LZ4_HASH(v) \
+  (((uint32_t)(v) * 2654435761u) >> (32 - CONFIG_LIBC_LZ4_HLOG))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_putlen
+ *
+ * Description:
+ *   Output the extension bytes of a length field
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *lz4_putlen(FAR uint8_t *op, size_t len)
+{
+  while (len >= 255)
+    {
+      *op++ = 255;
+      len  -= 255;
+    }
+
+  *op++ = (uint8_t)len;
+  return op;
+}
+
+/****************************************************************************
+ * Name: lz4_extlen
+ *
+ * Description:
+ *   Return the number of bytes needed to output a length field of 'len'
+ *   beyond the 4 bits in the token.
+ *
+ ****************************************************************************/
+
+static inline size_t lz4_extlen(size_t len)
+{
+  return len >= 15 ? (len - 15) / 255 + 1 : 0;
+}
+
+/****************************************************************************
+ * Name: lz4_getlen
+ *
+ * Description:
+ *   Add the extension bytes of a length field
+ *
+ ****************************************************************************/
+
+static inline int lz4_getlen(FAR const uint8_t **ipp,
+                             FAR const uint8_t *iend, FAR size_t *len)
+{
+  FAR const uint8_t *ip = *ipp;
+  uint8_t b;
+
+  do
+    {
+      if (ip >= iend)
+        {
+          return -EINVAL;
+        }
+
+      b     = *ip++;
+      *len += b;
+    }
+  while (b == 255);
+
+  *ipp = ip;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_compress
+ ****************************************************************************/
+
+size_t lz4_compress(FAR const void *in_data, size_t in_len,
+                    FAR void *out_data, size_t out_len, lz4_state_t htab)
+{
+  FAR const uint8_t *in     = (FAR const uint8_t *)in_data;
+  FAR const uint8_t *ip     = in;
+  FAR const uint8_t *anchor = in;
+  FAR const uint8_t *iend   = in + in_len;
+  FAR uint8_t *op           = (FAR uint8_t *)out_data;
+  FAR uint8_t *oend         = op + out_len;
+  FAR uint8_t *token;
+  size_t litlen;
+
+  if (in_len > LZ4_MAX_INPUT_SIZE)
+    {
+      set_errno(EINVAL);
+      return 0;
+    }
+
+  /* A block that is too short for a match is output as literals only */
+
+  if (in_len > LZ4_MFLIMIT)
+    {
+      FAR const uint8_t *mflimit    = iend - LZ4_MFLIMIT;
+      FAR const uint8_t *matchlimit = iend - LZ4_LASTLITERALS;
+
+      memset(htab, 0, sizeof(lz4_state_t));
+
+      while (ip < mflimit)
+        {
+          FAR const uint8_t *ref;
+          FAR const uint8_t *mptr;
+          uint32_t seq = LZ4_GET32(ip);
+          uint32_t h   = LZ4_HASH(seq);
+          size_t mlen;
+
+          ref     = in + htab[h];
+          htab[h] = (uint16_t)(ip - in);
+
+          if (ref >= ip || ip - ref > LZ4_MAXOFFSET ||
+              LZ4_GET32(ref) != seq)
+            {
+              /* No match.  Step faster through data that does not
+               * compress.
+               */
+
+              ip += 1 + ((size_t)(ip - anchor) >> 6);
+              continue;
+            }
+
+          /* Extend the match backwards and forwards */
+
+          while (ip > anchor && ref > in && ip[-1] == ref[-1])
+            {
+              ip--;
+              ref--;
+            }
+
+          mptr = ip + LZ4_MINMATCH;
+          while (mptr < matchlimit && *mptr == ref[mptr - ip])
+            {
+              mptr++;
+            }
+
+          litlen = ip - anchor;
+          mlen   = mptr - ip - LZ4_MINMATCH;
+
+          if ((size_t)(oend - op) < 1 + lz4_extlen(litlen) + litlen + 2 +
+                                    lz4_extlen(mlen))
+            {
+              goto errout;
+            }
+
+          /* Output the sequence */
+
+          token = op++;
+          if (litlen >= 15)
+            {
+              *token = 15 << 4;
+              op     = lz4_putlen(op, litlen - 15);
+            }
+          else
+            {
+              *token = (uint8_t)(litlen << 4);
+            }
+
+          memcpy(op, anchor, litlen);
+          op += litlen;
+
+          LZ4_PUT16(op, ip - ref);
+          op += 2;
+
+          if (mlen >= 15)
+            {
+              *token |= 15;
+              op      = lz4_putlen(op, mlen - 15);
+            }
+          else
+            {
+              *token |= (uint8_t)mlen;
+            }
+
+          ip     = mptr;
+          anchor = ip;
+
+          /* Also remember a position within the match */
+
+          if (ip < mflimit)
+            {
+              htab[LZ4_HASH(LZ4_GET32(ip - 2))] = (uint16_t)(ip - 2 - in);
+            }
+        }
+    }
+
+  /* Output the last literals */
+
+  litlen = iend - anchor;
+  if ((size_t)(oend - op) < 1 + lz4_extlen(litlen) + litlen)
+    {
+      goto errout;
+    }
+
+  token = op++;
+  if (litlen >= 15)
+    {
+      *token = 15 << 4;
+      op     = lz4_putlen(op, litlen - 15);
+    }
+  else
+    {
+      *token = (uint8_t)(litlen << 4);
+    }
+
+  memcpy(op, anchor, litlen);
+  op += litlen;
+
+  return op - (FAR uint8_t *)out_data;
+
+errout:
+  set_errno(E2BIG);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lz4_decompress_block
+ ****************************************************************************/
+
+ssize_t lz4_decompress_block(FAR const uint8_t *in, size_t in_len,
+                             FAR const uint8_t *base, FAR uint8_t *out,
+                             size_t out_len)
+{
+  FAR const uint8_t *ip   = in;
+  FAR const uint8_t *iend = in + in_len;
+  FAR uint8_t *op         = out;
+  FAR uint8_t *oend       = out + out_len;
+
+  if (in_len == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (; ; )
+    {
+      FAR const uint8_t *ref;
+      unsigned int token;
+      size_t offset;
+      size_t len;
+
+      /* Copy the literals */
+
+      token = *ip++;
+      len   = token >> 4;
+      if (len == 15 && lz4_getlen(&ip, iend, &len) < 0)
+        {
+          return -EINVAL;
+        }
+
+      if (len > (size_t)(iend - ip))
+        {
+          return -EINVAL;
+        }
+
+      if (len > (size_t)(oend - op))
+        {
+          return -E2BIG;
+        }
+
+      memcpy(op, ip, len);
+      op += len;
+      ip += len;
+
+      /* The last sequence has no match */
+
+      if (ip >= iend)
+        {
+          break;
+        }
+
+      /* Copy the match */
+
+      if (iend - ip < 2)
+        {
+          return -EINVAL;
+        }
+
+      offset = LZ4_GET16(ip);
+      ip    += 2;
+
+      if (offset == 0 || offset > (size_t)(op - base))
+        {
+          return -EINVAL;
+        }
+
+      len = token & 15;
+      if (len == 15 && lz4_getlen(&ip, iend, &len) < 0)
+        {
+          return -EINVAL;
+        }
+
+      len += LZ4_MINMATCH;
+      if (len > (size_t)(oend - op))
+        {
+          return -E2BIG;
+        }
+
+      ref = op - offset;
+      if (offset >= len)
+        {
+          memcpy(op, ref, len);
+          op += len;
+        }
+      else
+        {
+          /* The match overlaps the output (a repeated pattern) */
+
+          while (len-- > 0)
+            {
+              *op++ = *ref++;
+            }
+        }
+    }
+
+  return op - out;
+}
+
+/****************************************************************************
+ * Name: lz4_decompress
+ ****************************************************************************/
+
+size_t lz4_decompress(FAR const void *in_data, size_t in_len,
+                      FAR void *out_data, size_t out_len)
+{
+  ssize_t ret;
+
+  ret = lz4_decompress_block((FAR const uint8_t *)in_data, in_len,
+                             (FAR const uint8_t *)out_data,
+                             (FAR uint8_t *)out_data, out_len);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return 0;
+    }
+
+  return ret;
+}
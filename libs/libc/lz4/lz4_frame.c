@@ -0,0 +1,439 @@
+/****************************************************************************
+ * libs/libc/lz4/lz4_frame.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "lz4/lz4.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Frame descriptor FLG byte */
+
+#define LZ4_FLG_VERSION_MASK  0xc0
+#define LZ4_FLG_VERSION       0x40  /* Version 01 */
+#define LZ4_FLG_BINDEP        0x20  /* Blocks are independent */
+#define LZ4_FLG_BCHECKSUM     0x10  /* Each block has a checksum */
+#define LZ4_FLG_CSIZE         0x08  /* The content size is present */
+#define LZ4_FLG_CCHECKSUM     0x04  /* The content has a checksum */
+#define LZ4_FLG_RESERVED      0x02
+#define LZ4_FLG_DICTID        0x01  /* A dictionary ID is present */
+
+/* Frame descriptor BD byte */
+
+#define LZ4_BD_BLOCKMAX_SHIFT 4
+#define LZ4_BD_BLOCKMAX_MASK  0x70
+#define LZ4_BD_RESERVED       0x8f
+#define LZ4_BD_64KB           0x40
+
+/* Block size field */
+
+#define LZ4_BLOCK_RAW         0x80000000  /* The block is not compressed */
+
+/* xxHash32 primes */
+
+#define XXH_PRIME1            2654435761u
+#define XXH_PRIME2            2246822519u
+#define XXH_PRIME3            3266489917u
+#define XXH_PRIME4            668265263u
+#define XXH_PRIME5            374761393u
+
+#define XXH_ROTL(x,r)         (((x) << (r)) | ((x) >> (32 - (r))))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_xxh32
+ *
+ * Description:
+ *   Compute the xxHash32 checksum with seed zero, as used by the frame
+ *   header, block and content checksums.
+ *
+ ****************************************************************************/
+
+static uint32_t lz4_xxh32(FAR const uint8_t *p, size_t len)
+{
+  FAR const uint8_t *end = p + len;
+  uint32_t h;
+
+  if (len >= 16)
+    {
+      FAR const uint8_t *limit = end - 16;
+      uint32_t v1 = XXH_PRIME1 + XXH_PRIME2;
+      uint32_t v2 = XXH_PRIME2;
+      uint32_t v3 = 0;
+      uint32_t v4 = 0 - XXH_PRIME1;
+
+      do
+        {
+          v1 = XXH_ROTL(v1 + LZ4_GET32(p) * XXH_PRIME2, 13) * XXH_PRIME1;
+          v2 = XXH_ROTL(v2 + LZ4_GET32(p + 4) * XXH_PRIME2, 13) * XXH_PRIME1;
+          v3 = XXH_ROTL(v3 + LZ4_GET32(p + 8) * XXH_PRIME2, 13) * XXH_PRIME1;
+          v4 = XXH_ROTL(v4 + LZ4_GET32(p + 12) * XXH_PRIME2, 13) *
+               XXH_PRIME1;
+          p += 16;
+        }
+      while (p <= limit);
+
+      h = XXH_ROTL(v1, 1) + XXH_ROTL(v2, 7) + XXH_ROTL(v3, 12) +
+          XXH_ROTL(v4, 18);
+    }
+  else
+    {
+      h = XXH_PRIME5;
+    }
+
+  h += (uint32_t)len;
+
+  while (end - p >= 4)
+    {
+      h += LZ4_GET32(p) * XXH_PRIME3;
+      h  = XXH_ROTL(h, 17) * XXH_PRIME4;
+      p += 4;
+    }
+
+  while (p < end)
+    {
+      h += *p++ * XXH_PRIME5;
+      h  = XXH_ROTL(h, 11) * XXH_PRIME1;
+    }
+
+  h ^= h >> 15;
+  h *= XXH_PRIME2;
+  h ^= h >> 13;
+  h *= XXH_PRIME3;
+  h ^= h >> 16;
+  return h;
+}
+
+/****************************************************************************
+ * Name: lz4_hdrchecksum
+ *
+ * Description:
+ *   Return the header checksum byte of a frame descriptor
+ *
+ ****************************************************************************/
+
+static inline uint8_t lz4_hdrchecksum(FAR const uint8_t *desc, size_t len)
+{
+  return (uint8_t)(lz4_xxh32(desc, len) >> 8);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_frame_compress
+ ****************************************************************************/
+
+size_t lz4_frame_compress(FAR const void *in_data, size_t in_len,
+                          FAR void *out_data, size_t out_len,
+                          lz4_state_t htab)
+{
+  FAR const uint8_t *ip = (FAR const uint8_t *)in_data;
+  FAR const uint8_t *iend = ip + in_len;
+  FAR uint8_t *op = (FAR uint8_t *)out_data;
+  FAR uint8_t *oend = op + out_len;
+
+  /* Magic number and frame descriptor: Independent 64KB blocks and a
+   * content checksum.
+   */
+
+  if (out_len < 7)
+    {
+      goto errout;
+    }
+
+  LZ4_PUT32(op, LZ4_FRAME_MAGIC);
+  op[4] = LZ4_FLG_VERSION | LZ4_FLG_BINDEP | LZ4_FLG_CCHECKSUM;
+  op[5] = LZ4_BD_64KB;
+  op[6] = lz4_hdrchecksum(op + 4, 2);
+  op   += 7;
+
+  /* Blocks.  A block that does not compress is stored as is. */
+
+  while (ip < iend)
+    {
+      size_t blen = iend - ip;
+      size_t avail;
+      size_t clen = 0;
+
+      if (blen > LZ4_MAX_INPUT_SIZE)
+        {
+          blen = LZ4_MAX_INPUT_SIZE;
+        }
+
+      if (oend - op < 4)
+        {
+          goto errout;
+        }
+
+      avail = oend - op - 4;
+      if (blen > 1)
+        {
+          clen = lz4_compress(ip, blen, op + 4,
+                              avail < blen - 1 ? avail : blen - 1, htab);
+        }
+
+      if (clen > 0)
+        {
+          LZ4_PUT32(op, clen);
+        }
+      else if (blen <= avail)
+        {
+          LZ4_PUT32(op, LZ4_BLOCK_RAW | blen);
+          memcpy(op + 4, ip, blen);
+          clen = blen;
+        }
+      else
+        {
+          goto errout;
+        }
+
+      op += 4 + clen;
+      ip += blen;
+    }
+
+  /* End mark and content checksum */
+
+  if (oend - op < 8)
+    {
+      goto errout;
+    }
+
+  LZ4_PUT32(op, 0);
+  LZ4_PUT32(op + 4, lz4_xxh32((FAR const uint8_t *)in_data, in_len));
+  op += 8;
+
+  return op - (FAR uint8_t *)out_data;
+
+errout:
+  set_errno(E2BIG);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lz4_frame_decompress
+ ****************************************************************************/
+
+size_t lz4_frame_decompress(FAR const void *in_data, size_t in_len,
+                            FAR void *out_data, size_t out_len)
+{
+  FAR const uint8_t *ip = (FAR const uint8_t *)in_data;
+  FAR const uint8_t *iend = ip + in_len;
+  FAR uint8_t *op = (FAR uint8_t *)out_data;
+  FAR uint8_t *oend = op + out_len;
+  int errcode = EINVAL;
+
+  /* The input may hold several frames, including skippable frames */
+
+  while (ip < iend)
+    {
+      FAR uint8_t *frame;
+      uint32_t magic;
+      uint32_t blockmax;
+      uint32_t csize_lo = 0;
+      uint32_t csize_hi = 0;
+      size_t hdrlen;
+      uint8_t flg;
+      uint8_t bd;
+
+      if (iend - ip < 4)
+        {
+          goto errout;
+        }
+
+      magic = LZ4_GET32(ip);
+      ip   += 4;
+
+      if ((magic & 0xfffffff0) == LZ4_SKIPPABLE_MAGIC)
+        {
+          uint32_t size;
+
+          if (iend - ip < 4)
+            {
+              goto errout;
+            }
+
+          size = LZ4_GET32(ip);
+          ip  += 4;
+
+          if (size > (size_t)(iend - ip))
+            {
+              goto errout;
+            }
+
+          ip += size;
+          continue;
+        }
+
+      if (magic != LZ4_FRAME_MAGIC || iend - ip < 3)
+        {
+          goto errout;
+        }
+
+      /* Frame descriptor.  Dictionaries are not supported. */
+
+      flg = ip[0];
+      bd  = ip[1];
+
+      if ((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION ||
+          (flg & (LZ4_FLG_RESERVED | LZ4_FLG_DICTID)) != 0 ||
+          (bd & LZ4_BD_RESERVED) != 0 || bd < LZ4_BD_64KB)
+        {
+          goto errout;
+        }
+
+      hdrlen = (flg & LZ4_FLG_CSIZE) != 0 ? 10 : 2;
+      if ((size_t)(iend - ip) < hdrlen + 1 ||
+          lz4_hdrchecksum(ip, hdrlen) != ip[hdrlen])
+        {
+          goto errout;
+        }
+
+      if ((flg & LZ4_FLG_CSIZE) != 0)
+        {
+          csize_lo = LZ4_GET32(ip + 2);
+          csize_hi = LZ4_GET32(ip + 6);
+        }
+
+      ip      += hdrlen + 1;
+      blockmax = (uint32_t)1 <<
+                 (8 + 2 * ((bd & LZ4_BD_BLOCKMAX_MASK) >>
+                           LZ4_BD_BLOCKMAX_SHIFT));
+      frame    = op;
+
+      /* Blocks up to the end mark */
+
+      for (; ; )
+        {
+          uint32_t bsize;
+          size_t bend;
+
+          if (iend - ip < 4)
+            {
+              goto errout;
+            }
+
+          bsize = LZ4_GET32(ip);
+          ip   += 4;
+
+          if (bsize == 0)
+            {
+              break;
+            }
+
+          bend = (bsize & ~LZ4_BLOCK_RAW) +
+                 ((flg & LZ4_FLG_BCHECKSUM) != 0 ? 4 : 0);
+
+          if ((bsize & ~LZ4_BLOCK_RAW) > blockmax ||
+              bend > (size_t)(iend - ip))
+            {
+              goto errout;
+            }
+
+          if ((flg & LZ4_FLG_BCHECKSUM) != 0 &&
+              lz4_xxh32(ip, bend - 4) != LZ4_GET32(ip + bend - 4))
+            {
+              goto errout;
+            }
+
+          if ((bsize & LZ4_BLOCK_RAW) != 0)
+            {
+              bsize &= ~LZ4_BLOCK_RAW;
+              if (bsize > (size_t)(oend - op))
+                {
+                  errcode = E2BIG;
+                  goto errout;
+                }
+
+              memcpy(op, ip, bsize);
+              op += bsize;
+            }
+          else
+            {
+              ssize_t ret;
+
+              /* Linked blocks may refer back to the earlier output of the
+               * frame.
+               */
+
+              ret = lz4_decompress_block(ip, bsize,
+                                         (flg & LZ4_FLG_BINDEP) != 0 ?
+                                         op : frame, op, oend - op);
+              if (ret < 0)
+                {
+                  errcode = -ret;
+                  goto errout;
+                }
+
+              op += ret;
+            }
+
+          ip += bend;
+        }
+
+      /* Content checksum and size */
+
+      if ((flg & LZ4_FLG_CCHECKSUM) != 0)
+        {
+          if (iend - ip < 4 ||
+              lz4_xxh32(frame, op - frame) != LZ4_GET32(ip))
+            {
+              goto errout;
+            }
+
+          ip += 4;
+        }
+
+      if ((flg & LZ4_FLG_CSIZE) != 0 &&
+          (csize_hi != 0 || csize_lo != (uint32_t)(op - frame)))
+        {
+          goto errout;
+        }
+    }
+
+  return op - (FAR uint8_t *)out_data;
+
+errout:
+  set_errno(errcode);
+  return 0;
+}
@@ -0,0 +1,410 @@
+/****************************************************************************
+ * libs/libc/lzf/lzf_stream.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "lzf/lzf.h"
+
+#include <assert.h>
+
+#ifdef CONFIG_LIBC_LZF
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Decoder states */
+
+enum lzf_decstate_e
+{
+  LZF_DEC_HEADER = 0,        /* Collecting the block header */
+  LZF_DEC_RAW,               /* Copying an uncompressed block */
+  LZF_DEC_DATA               /* Collecting a compressed block */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_hdrsize
+ *
+ * Description:
+ *   Return the size of the header being collected by the decoder, once its
+ *   type is known.
+ *
+ ****************************************************************************/
+
+static inline unsigned int lzf_hdrsize(FAR struct lzf_decoder_s *dec)
+{
+  return dec->hdr[2] == LZF_TYPE1_HDR ? LZF_TYPE1_HDR_SIZE :
+                                        LZF_TYPE0_HDR_SIZE;
+}
+
+/****************************************************************************
+ * Name: lzf_parsehdr
+ *
+ * Description:
+ *   Parse the complete block header collected by the decoder.
+ *
+ ****************************************************************************/
+
+static int lzf_parsehdr(FAR struct lzf_decoder_s *dec)
+{
+  dec->clen = (uint16_t)dec->hdr[3] << 8 | dec->hdr[4];
+
+  if (dec->hdr[2] == LZF_TYPE0_HDR)
+    {
+      dec->ulen  = dec->clen;
+      dec->state = LZF_DEC_RAW;
+    }
+  else
+    {
+      dec->ulen  = (uint16_t)dec->hdr[5] << 8 | dec->hdr[6];
+      dec->state = LZF_DEC_DATA;
+
+      if (dec->clen == 0 || dec->ulen == 0)
+        {
+          return -EINVAL;
+        }
+
+      if (dec->clen > dec->blocksize || dec->ulen > dec->blocksize)
+        {
+          return -E2BIG;
+        }
+    }
+
+  dec->nbytes = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_encoder_init
+ ****************************************************************************/
+
+void lzf_encoder_init(FAR struct lzf_encoder_s *enc, lzf_state_t htab,
+                      FAR void *buffer, uint16_t blocksize)
+{
+  DEBUGASSERT(enc != NULL && htab != NULL && buffer != NULL &&
+              blocksize > 0);
+
+  /* lzf_compress() writes the header in front of the compressed data or,
+   * if the data does not compress, in front of the uncompressed data.
+   */
+
+  enc->htab      = htab;
+  enc->ibuf      = (FAR uint8_t *)buffer + LZF_TYPE0_HDR_SIZE;
+  enc->obuf      = enc->ibuf + blocksize + LZF_TYPE1_HDR_SIZE;
+  enc->outptr    = NULL;
+  enc->blocksize = blocksize;
+  enc->ilen      = 0;
+  enc->outlen    = 0;
+}
+
+/****************************************************************************
+ * Name: lzf_encode
+ ****************************************************************************/
+
+size_t lzf_encode(FAR struct lzf_encoder_s *enc, FAR const void *in,
+                  FAR size_t *inlen, FAR void *out, size_t outlen,
+                  bool flush)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)in;
+  FAR uint8_t *dest = (FAR uint8_t *)out;
+  size_t navail = *inlen;
+  size_t nconsumed = 0;
+  size_t nout = 0;
+  size_t ncopy;
+
+  for (; ; )
+    {
+      /* First, output what is left of the last block.  The input block may
+       * not be re-used until then.
+       */
+
+      if (enc->outlen > 0)
+        {
+          ncopy = outlen - nout;
+          if (ncopy > enc->outlen)
+            {
+              ncopy = enc->outlen;
+            }
+
+          memcpy(&dest[nout], enc->outptr, ncopy);
+          enc->outptr += ncopy;
+          enc->outlen -= ncopy;
+          nout        += ncopy;
+
+          if (enc->outlen > 0)
+            {
+              break;
+            }
+        }
+
+      /* Then collect more input */
+
+      ncopy = enc->blocksize - enc->ilen;
+      if (ncopy > navail - nconsumed)
+        {
+          ncopy = navail - nconsumed;
+        }
+
+      memcpy(&enc->ibuf[enc->ilen], &src[nconsumed], ncopy);
+      enc->ilen += ncopy;
+      nconsumed += ncopy;
+
+      /* Compress the block when it is full or when the last partial block
+       * is flushed.  Only keep the compressed data if it is smaller.
+       */
+
+      if (enc->ilen == enc->blocksize ||
+          (flush && enc->ilen > 0 && nconsumed == navail))
+        {
+          FAR struct lzf_header_s *hdr;
+
+          enc->outlen = lzf_compress(enc->ibuf, enc->ilen, enc->obuf,
+                                     enc->ilen - 1, enc->htab, &hdr);
+          enc->outptr = (FAR const uint8_t *)hdr;
+          enc->ilen   = 0;
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  *inlen = nconsumed;
+  return nout;
+}
+
+/****************************************************************************
+ * Name: lzf_decoder_init
+ ****************************************************************************/
+
+void lzf_decoder_init(FAR struct lzf_decoder_s *dec, FAR void *buffer,
+                      uint16_t blocksize)
+{
+  DEBUGASSERT(dec != NULL && buffer != NULL && blocksize > 0);
+
+  dec->cbuf      = (FAR uint8_t *)buffer;
+  dec->ubuf      = dec->cbuf + blocksize;
+  dec->outptr    = NULL;
+  dec->blocksize = blocksize;
+  dec->outlen    = 0;
+  dec->clen      = 0;
+  dec->ulen      = 0;
+  dec->nbytes    = 0;
+  dec->state     = LZF_DEC_HEADER;
+}
+
+/****************************************************************************
+ * Name: lzf_decode
+ ****************************************************************************/
+
+ssize_t lzf_decode(FAR struct lzf_decoder_s *dec, FAR const void *in,
+                   FAR size_t *inlen, FAR void *out, size_t outlen)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)in;
+  FAR uint8_t *dest = (FAR uint8_t *)out;
+  size_t navail = *inlen;
+  size_t nconsumed = 0;
+  size_t nout = 0;
+  size_t ncopy;
+  unsigned int n;
+  int ret;
+
+  for (; ; )
+    {
+      /* First, output what is left of the last decompressed block */
+
+      if (dec->outlen > 0)
+        {
+          ncopy = outlen - nout;
+          if (ncopy > dec->outlen)
+            {
+              ncopy = dec->outlen;
+            }
+
+          memcpy(&dest[nout], dec->outptr, ncopy);
+          dec->outptr += ncopy;
+          dec->outlen -= ncopy;
+          nout        += ncopy;
+
+          if (dec->outlen > 0)
+            {
+              break;
+            }
+        }
+
+      switch (dec->state)
+        {
+          case LZF_DEC_HEADER:
+            if (nconsumed >= navail)
+              {
+                goto done;
+              }
+
+            dec->hdr[dec->nbytes++] = src[nconsumed++];
+            if (dec->nbytes == 3 &&
+                (dec->hdr[0] != 'Z' || dec->hdr[1] != 'V' ||
+                 dec->hdr[2] > LZF_TYPE1_HDR))
+              {
+                ret = -EINVAL;
+                goto errout;
+              }
+
+            if (dec->nbytes >= 3 && dec->nbytes == lzf_hdrsize(dec))
+              {
+                ret = lzf_parsehdr(dec);
+                if (ret < 0)
+                  {
+                    goto errout;
+                  }
+              }
+            break;
+
+          case LZF_DEC_RAW:
+
+            /* Uncompressed data is copied straight to the output */
+
+            if (dec->nbytes >= dec->clen)
+              {
+                dec->state  = LZF_DEC_HEADER;
+                dec->nbytes = 0;
+                break;
+              }
+
+            ncopy = dec->clen - dec->nbytes;
+            if (ncopy > navail - nconsumed)
+              {
+                ncopy = navail - nconsumed;
+              }
+
+            if (ncopy > outlen - nout)
+              {
+                ncopy = outlen - nout;
+              }
+
+            if (ncopy == 0)
+              {
+                goto done;
+              }
+
+            memcpy(&dest[nout], &src[nconsumed], ncopy);
+            dec->nbytes += ncopy;
+            nconsumed   += ncopy;
+            nout        += ncopy;
+            break;
+
+          case LZF_DEC_DATA:
+
+            /* If the whole block is available and fits in the output, then
+             * decompress it in place.
+             */
+
+            if (dec->nbytes == 0 && navail - nconsumed >= dec->clen &&
+                outlen - nout >= dec->ulen)
+              {
+                n = lzf_decompress(&src[nconsumed], dec->clen, &dest[nout],
+                                   dec->ulen);
+                if (n != dec->ulen)
+                  {
+                    ret = -EINVAL;
+                    goto errout;
+                  }
+
+                nconsumed  += dec->clen;
+                nout       += n;
+                dec->state  = LZF_DEC_HEADER;
+                break;
+              }
+
+            /* Otherwise collect the compressed block */
+
+            ncopy = dec->clen - dec->nbytes;
+            if (ncopy > navail - nconsumed)
+              {
+                ncopy = navail - nconsumed;
+              }
+
+            if (ncopy == 0)
+              {
+                goto done;
+              }
+
+            memcpy(&dec->cbuf[dec->nbytes], &src[nconsumed], ncopy);
+            dec->nbytes += ncopy;
+            nconsumed   += ncopy;
+
+            if (dec->nbytes == dec->clen)
+              {
+                n = lzf_decompress(dec->cbuf, dec->clen, dec->ubuf,
+                                   dec->ulen);
+                if (n != dec->ulen)
+                  {
+                    ret = -EINVAL;
+                    goto errout;
+                  }
+
+                dec->outptr = dec->ubuf;
+                dec->outlen = n;
+                dec->state  = LZF_DEC_HEADER;
+                dec->nbytes = 0;
+              }
+            break;
+
+          default:
+            DEBUGPANIC();
+            ret = -EINVAL;
+            goto errout;
+        }
+    }
+
+done:
+  *inlen = nconsumed;
+  return nout;
+
+errout:
+  *inlen = nconsumed;
+  return ret;
+}
+
+#endif /* CONFIG_LIBC_LZF */
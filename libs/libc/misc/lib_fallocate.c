@@ -0,0 +1,126 @@
+/****************************************************************************
+ * libs/libc/misc/lib_fallocate.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: posix_fallocate
+ *
+ * Description:
+ *   Ensure that storage is allocated for the bytes in the range starting at
+ *   'offset' and continuing for 'len' bytes of the file.  If offset + len
+ *   is beyond the current file size, the file size is increased to
+ *   offset + len.
+ *
+ *   File systems that support it (FIOC_FALLOCATE) allocate the storage
+ *   ahead of time, contiguously if possible.  Otherwise, or in addition,
+ *   the file is extended with ftruncate().
+ *
+ * Input Parameters:
+ *   fd     - A file descriptor open for writing
+ *   offset - The start of the range
+ *   len    - The size of the range
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; an errno value (not -1) is returned
+ *   on failure:
+ *
+ *   EBADF  - fd is not a valid file descriptor open for writing
+ *   EINVAL - offset is negative or len is not positive
+ *   EFBIG  - offset + len exceeds the maximum file size
+ *   ENOSPC - There is not enough space left on the device
+ *
+ ****************************************************************************/
+
+int posix_fallocate(int fd, off_t offset, off_t len)
+{
+  struct stat buf;
+  off_t length;
+  int ret;
+
+  if (offset < 0 || len <= 0)
+    {
+      return EINVAL;
+    }
+
+  length = offset + len;
+  if (length < offset)
+    {
+      return EFBIG;
+    }
+
+  /* Let the file system reserve the storage, if it can */
+
+  ret = ioctl(fd, FIOC_FALLOCATE, (unsigned long)((uintptr_t)&length));
+  if (ret < 0 && errno != ENOSYS && errno != ENOTTY)
+    {
+      return errno;
+    }
+
+  /* Then extend the file if necessary */
+
+  if (fstat(fd, &buf) < 0)
+    {
+      return errno;
+    }
+
+  if (buf.st_size < length && ftruncate(fd, length) < 0)
+    {
+      return errno;
+    }
+
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT */
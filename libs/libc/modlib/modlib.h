@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib.h
  *
- *   Copyright (C) 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -80,6 +80,20 @@ int modlib_verifyheader(FAR const Elf32_Ehdr *header);
 
 int modlib_findsymtab(FAR struct mod_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: modlib_buffersymtab
+ *
+ * Description:
+ *   Read the symbol and string tables into memory if they are no larger
+ *   than CONFIG_MODLIB_TABLESIZE_MAX.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void modlib_buffersymtab(FAR struct mod_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: modlib_readsym
  *
@@ -127,6 +141,28 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
 int modlib_symvalue(FAR struct module_s *modp,
                     FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym);
 
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol in the kernel symbol table using its hash index.  The
+ *   index is built on the first use after the symbol table was selected.
+ *
+ * Input Parameters:
+ *   name - The name of the symbol
+ *   hash - symtab_hash() of the name
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry or NULL if the symbol is not
+ *   found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHED
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name,
+                                             uint32_t hash);
+#endif
+
 /****************************************************************************
  * Name: modlib_loadshdrs
  *
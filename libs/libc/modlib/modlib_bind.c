@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_bind.c
  *
- *   Copyright (C) 2015, 2017, 2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2019, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -88,7 +88,7 @@ static inline int modlib_readrels(FAR struct mod_loadinfo_s *loadinfo,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || index >= (relsec->sh_size / sizeof(Elf32_Rel)))
     {
       berr("ERROR: Bad relocation symbol index: %d\n", index);
       return -EINVAL;
@@ -134,12 +134,31 @@ static int modlib_relocate(FAR struct module_s *modp,
   FAR dq_entry_t *e;
   dq_queue_t      q;
   uintptr_t       addr;
+  int             nrels;
+  int             bufcount;
   int             symidx;
   int             ret;
   int             i;
   int             j;
 
-  rels = lib_malloc(CONFIG_MODLIB_RELOCATION_BUFFERCOUNT * sizeof(Elf32_Rel));
+  /* Read the whole relocation table at once if it is not too large */
+
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  if (nrels == 0)
+    {
+      return OK;
+    }
+
+  if (relsec->sh_size <= CONFIG_MODLIB_TABLESIZE_MAX)
+    {
+      bufcount = nrels;
+    }
+  else
+    {
+      bufcount = CONFIG_MODLIB_RELOCATION_BUFFERCOUNT;
+    }
+
+  rels = lib_malloc(bufcount * sizeof(Elf32_Rel));
   if (!rels)
     {
       berr("Failed to allocate memory for elf relocation rels\n");
@@ -155,15 +174,15 @@ static int modlib_relocate(FAR struct module_s *modp,
 
   ret = OK;
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  for (i = j = 0; i < nrels; i++)
     {
       /* Read the relocation entry into memory */
 
-      rel = &rels[i % CONFIG_MODLIB_RELOCATION_BUFFERCOUNT];
+      rel = &rels[i % bufcount];
 
-      if (!(i % CONFIG_MODLIB_RELOCATION_BUFFERCOUNT))
+      if (!(i % bufcount))
         {
-          ret = modlib_readrels(loadinfo, relsec, i, rels, CONFIG_MODLIB_RELOCATION_BUFFERCOUNT);
+          ret = modlib_readrels(loadinfo, relsec, i, rels, bufcount);
           if (ret < 0)
           {
               berr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
@@ -339,6 +358,10 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
       return ret;
     }
 
+  /* Read the symbol and string tables into memory if possible */
+
+  modlib_buffersymtab(loadinfo);
+
   /* Allocate an I/O buffer.  This buffer is used by mod_symname() to
    * accumulate the variable length symbol name.
    */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_init.c
  *
- *   Copyright (C) 2015, 2017-2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017-2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
 #include <string.h>
@@ -48,6 +49,7 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/modlib.h>
 
 #include "modlib/modlib.h"
@@ -167,6 +169,18 @@ int modlib_initialize(FAR const char *filename,
       return -errval;
     }
 
+#ifdef CONFIG_MODLIB_XIP
+  /* If the file lies in memory-mapped media, modlib_read() and
+   * modlib_load() can use the file in place.
+   */
+
+  if (ioctl(loadinfo->filfd, FIOC_MMAP,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = NULL;
+    }
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = modlib_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
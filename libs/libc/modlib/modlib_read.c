@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_read.c
  *
- *   Copyright (C) 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -110,6 +110,23 @@ int modlib_read(FAR struct mod_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
 
+#ifdef CONFIG_MODLIB_XIP
+  /* If the file is memory-mapped, just copy the data */
+
+  if (loadinfo->xipbase != NULL)
+    {
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
+        {
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, loadinfo->xipbase + offset, readsize);
+      return OK;
+    }
+#endif
+
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
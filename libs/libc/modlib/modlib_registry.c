@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_registry.c
  *
- *   Copyright (C) 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -173,7 +173,8 @@ void modlib_registry_unlock(void)
  * Name: modlib_registry_add
  *
  * Description:
- *   Add a new entry to the module registry.
+ *   Add a new entry to the module registry.  The module must already have
+ *   been initialized, so that its symbol exports are known.
  *
  * Input Parameters:
  *   modp - The module data structure to be registered.
@@ -189,6 +190,16 @@ void modlib_registry_unlock(void)
 void modlib_registry_add(FAR struct module_s *modp)
 {
   DEBUGASSERT(modp);
+
+#ifdef CONFIG_SYMTAB_HASHED
+  /* Index the exported symbols.  Without the index, the lookups fall back
+   * to the search by name.
+   */
+
+  modp->exphash = symtab_mkhash(modp->modinfo.exports,
+                                modp->modinfo.nexports);
+#endif
+
   modp->flink = g_mod_registry;
   g_mod_registry = modp;
 }
@@ -236,6 +247,12 @@ int modlib_registry_del(FAR struct module_s *modp)
     }
 
   modp->flink = NULL;
+
+#ifdef CONFIG_SYMTAB_HASHED
+  symtab_freehash(modp->exphash);
+  modp->exphash = NULL;
+#endif
+
   return OK;
 }
 
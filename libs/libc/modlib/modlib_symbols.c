@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_symbols.c
  *
- *   Copyright (C) 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -46,6 +46,7 @@
 
 #include <nuttx/lib/modlib.h>
 
+#include "libc.h"
 #include "modlib/modlib.h"
 
 /****************************************************************************
@@ -64,6 +65,9 @@
 struct mod_exportinfo_s
 {
   FAR const char *name;              /* Symbol name to find */
+#ifdef CONFIG_SYMTAB_HASHED
+  uint32_t hash;                     /* symtab_hash() of the name */
+#endif
   FAR struct module_s *modp;         /* The module that needs the symbol */
   FAR const struct symtab_s *symbol; /* Symbol info returned (if found) */
 };
@@ -107,6 +111,44 @@ static int modlib_symname(FAR struct mod_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+  /* If the string table was buffered, just copy the name */
+
+  if (loadinfo->strtab != NULL)
+    {
+      FAR const uint8_t *name;
+      size_t maxlen;
+
+      maxlen = loadinfo->shdr[loadinfo->strtabidx].sh_size;
+      if (sym->st_name >= maxlen)
+        {
+          berr("ERROR: Symbol name out of range\n");
+          return -EINVAL;
+        }
+
+      name    = &loadinfo->strtab[sym->st_name];
+      maxlen -= sym->st_name;
+      buffer  = memchr(name, '\0', maxlen);
+      if (buffer == NULL)
+        {
+          berr("ERROR: Symbol name is not terminated\n");
+          return -EINVAL;
+        }
+
+      readlen = buffer - name + 1;
+      if (readlen > loadinfo->buflen)
+        {
+          ret = modlib_reallocbuffer(loadinfo, readlen - loadinfo->buflen);
+          if (ret < 0)
+            {
+              berr("ERROR: mod_reallocbuffer failed: %d\n", ret);
+              return ret;
+            }
+        }
+
+      memcpy(loadinfo->iobuffer, name, readlen);
+      return OK;
+    }
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -186,7 +228,12 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_HASHED)
+  exportinfo->symbol = symtab_findbyhash(modp->modinfo.exports,
+                                         modp->exphash, exportinfo->name,
+                                         exportinfo->hash,
+                                         modp->modinfo.nexports);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
   exportinfo->symbol = symtab_findorderedbyname(modp->modinfo.exports,
                                                 exportinfo->name,
                                                 modp->modinfo.nexports);
@@ -258,6 +305,68 @@ int modlib_findsymtab(FAR struct mod_loadinfo_s *loadinfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: modlib_buffersymtab
+ *
+ * Description:
+ *   Read the symbol and string tables into memory if they are no larger
+ *   than CONFIG_MODLIB_TABLESIZE_MAX.  After this, modlib_readsym() and
+ *   modlib_symvalue() do not access the file anymore.  Failure to buffer
+ *   the tables is not an error:  They are then read piecewise.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void modlib_buffersymtab(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int ret;
+
+#ifdef CONFIG_MODLIB_XIP
+  /* Reads from memory-mapped media are already just a memcpy() */
+
+  if (loadinfo->xipbase != NULL)
+    {
+      return;
+    }
+#endif
+
+  if (loadinfo->symtab == NULL && symtab->sh_size > 0 &&
+      symtab->sh_size <= CONFIG_MODLIB_TABLESIZE_MAX)
+    {
+      loadinfo->symtab = (FAR Elf32_Sym *)lib_malloc(symtab->sh_size);
+      if (loadinfo->symtab != NULL)
+        {
+          ret = modlib_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                            symtab->sh_size, symtab->sh_offset);
+          if (ret < 0)
+            {
+              lib_free(loadinfo->symtab);
+              loadinfo->symtab = NULL;
+            }
+        }
+    }
+
+  if (loadinfo->strtab == NULL && strtab->sh_size > 0 &&
+      strtab->sh_size <= CONFIG_MODLIB_TABLESIZE_MAX)
+    {
+      loadinfo->strtab = (FAR uint8_t *)lib_malloc(strtab->sh_size);
+      if (loadinfo->strtab != NULL)
+        {
+          ret = modlib_read(loadinfo, loadinfo->strtab, strtab->sh_size,
+                            strtab->sh_offset);
+          if (ret < 0)
+            {
+              lib_free(loadinfo->strtab);
+              loadinfo->strtab = NULL;
+            }
+        }
+    }
+}
+
 /****************************************************************************
  * Name: modlib_readsym
  *
@@ -283,12 +392,20 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf32_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf32_Sym)))
     {
       berr("ERROR: Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+  /* Use the buffered symbol table if there is one */
+
+  if (loadinfo->symtab != NULL)
+    {
+      *sym = loadinfo->symtab[index];
+      return OK;
+    }
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf32_Sym) * index;
@@ -328,7 +445,9 @@ int modlib_symvalue(FAR struct module_s *modp,
   FAR const struct symtab_s *symbol;
   struct mod_exportinfo_s exportinfo;
   uintptr_t secbase;
+#ifndef CONFIG_SYMTAB_HASHED
   int nsymbols;
+#endif
   int ret;
 
   switch (sym->st_shndx)
@@ -375,6 +494,9 @@ int modlib_symvalue(FAR struct module_s *modp,
         exportinfo.name   = (FAR const char *)loadinfo->iobuffer;
         exportinfo.modp   = modp;
         exportinfo.symbol = NULL;
+#ifdef CONFIG_SYMTAB_HASHED
+        exportinfo.hash   = symtab_hash(exportinfo.name);
+#endif
 
         ret = modlib_registry_foreach(modlib_symcallback, (FAR void *)&exportinfo);
         if (ret < 0)
@@ -391,11 +513,14 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
+#if defined(CONFIG_SYMTAB_HASHED)
+            symbol = modlib_findsymbol(exportinfo.name, exportinfo.hash);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
             modlib_getsymtab(&symbol, &nsymbols);
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
             symbol = symtab_findorderedbyname(symbol, exportinfo.name,
                                               nsymbols);
 #else
+            modlib_getsymtab(&symbol, &nsymbols);
             symbol = symtab_findbyname(symbol, exportinfo.name,
                                        nsymbols);
 #endif
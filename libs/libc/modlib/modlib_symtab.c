@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_symtab.c
  *
- *   Copyright (C) 2015, 2017-2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017-2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -44,6 +44,8 @@
 #include <nuttx/symtab.h>
 #include <nuttx/lib/modlib.h>
 
+#include "modlib/modlib.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -77,6 +79,9 @@ extern int CONFIG_MODLIB_NSYMBOLS_VAR;
 
 static FAR const struct symtab_s *g_modlib_symtab;
 static FAR int g_modlib_nsymbols;
+#ifdef CONFIG_SYMTAB_HASHED
+static FAR struct symtab_hash_s *g_modlib_symhash;
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -140,5 +145,49 @@ void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   modlib_registry_lock();
   g_modlib_symtab   = symtab;
   g_modlib_nsymbols = nsymbols;
+
+#ifdef CONFIG_SYMTAB_HASHED
+  /* The index of the old symbol table is no longer valid */
+
+  symtab_freehash(g_modlib_symhash);
+  g_modlib_symhash = NULL;
+#endif
+
+  modlib_registry_unlock();
+}
+
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol in the kernel symbol table using its hash index.  See
+ *   libs/libc/modlib/modlib.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHED
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name,
+                                             uint32_t hash)
+{
+  FAR const struct symtab_s *symtab;
+  FAR const struct symtab_s *symbol = NULL;
+  int nsymbols;
+
+  modlib_registry_lock();
+  modlib_getsymtab(&symtab, &nsymbols);
+
+  if (symtab != NULL)
+    {
+      if (g_modlib_symhash == NULL)
+        {
+          g_modlib_symhash = symtab_mkhash(symtab, nsymbols);
+        }
+
+      symbol = symtab_findbyhash(symtab, g_modlib_symhash, name, hash,
+                                 nsymbols);
+    }
+
   modlib_registry_unlock();
+  return symbol;
 }
+#endif
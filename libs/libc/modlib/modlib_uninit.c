@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/modlib/modlib_uninit.c
  *
- *   Copyright (C) 2015. 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -110,5 +110,17 @@ int modlib_freebuffers(struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+  if (loadinfo->symtab != NULL)
+    {
+      lib_free((FAR void *)loadinfo->symtab);
+      loadinfo->symtab    = NULL;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      lib_free((FAR void *)loadinfo->strtab);
+      loadinfo->strtab    = NULL;
+    }
+
   return OK;
 }
@@ -2,7 +2,8 @@
  * libs/libc/netdb/lib_dns.h
  * DNS resolver code header file.
  *
- *   Copyright (C) 2007-2009, 2011-2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011-2012, 2014, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Inspired by/based on uIP logic by Adam Dunkels:
@@ -46,6 +47,7 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -78,6 +80,14 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 0
+#endif
+
+#ifndef CONFIG_NETDB_DNSCLIENT_MAXSERVERS
+#  define CONFIG_NETDB_DNSCLIENT_MAXSERVERS 1
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -204,12 +214,17 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
  * Name: dns_save_answer
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache.  An existing entry
+ *   for the hostname is replaced.
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero saves a negative
+ *              entry:  The hostname does not exist or has no address.
+ *   ttl      - The time to live of the answer in seconds.  It is limited
+ *              to CONFIG_NETDB_DNSCLIENT_LIFESEC, or, for negative entries,
+ *              replaced by CONFIG_NETDB_DNSCLIENT_NEGLIFESEC.
  *
  * Returned Value:
  *   None
@@ -218,7 +233,8 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr);
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl);
 #endif
 
 /****************************************************************************
@@ -237,9 +253,10 @@ void dns_save_answer(FAR const char *hostname,
  *
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
- *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   cache, zero (OK) will be returned.  -EADDRNOTAVAIL is returned if the
+ *   cache holds a negative entry for the hostname.  Otherwise, some negated
+ *   errno value will be returned, typically -ENOENT meaning that the
+ *   hostname was not found in the cache.
  *
  ****************************************************************************/
 
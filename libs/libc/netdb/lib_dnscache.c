@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/netdb/lib_dnscache.c
  *
- *   Copyright (C) 2007, 2009, 2012, 2014-2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2009, 2012, 2014-2016, 2020 Gregory Nutt. All rights
+ *     reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,6 +41,7 @@
 #include <nuttx/config.h>
 
 #include <sys/time.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <assert.h>
@@ -62,11 +64,23 @@
 #  define DNS_CLOCK CLOCK_REALTIME
 #endif
 
+/* There is one hash bucket per cache entry.  The buckets and the hash
+ * chains hold cache indices plus one so that zero, the initial value,
+ * terminates a chain.  CONFIG_NETDB_DNSCLIENT_ENTRIES is at most 255.
+ */
+
+#define DNS_HASH_SIZE   CONFIG_NETDB_DNSCLIENT_ENTRIES
+#define DNS_NO_ENTRY    0
+#define DNS_ENTRY(l)    (&g_dns_cache[(l) - 1])
+#define DNS_LINK(e)     ((uint8_t)((e) - g_dns_cache + 1))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames.
+/* This described one entry in the cache of resolved hostnames.  An entry
+ * with no addresses is a negative entry:  It records that the name does not
+ * exist or has no address.  An entry with an empty name is free.
  *
  * REVISIT: this consumes extra space, especially when multiple
  * addresses per name are stored.
@@ -74,11 +88,11 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t            ctime;      /* Creation time */
-#endif
-  char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
+  time_t            expire;     /* Expiration time */
+  uint32_t          lru;        /* Time of the last use, in g_dns_lru units */
+  uint8_t           hnext;      /* Next entry in the hash chain */
   uint8_t           naddr;      /* How many addresses per name */
+  char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
   union dns_addr_u  addr[CONFIG_NETDB_DNSCLIENT_MAXIP]; /* Resolved address */
 };
 
@@ -86,8 +100,15 @@ struct dns_cache_s
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
+/* The heads of the hash chains */
+
+static uint8_t g_dns_hash[DNS_HASH_SIZE];
+
+/* Incremented on each use of a cache entry.  The entry with the smallest
+ * value of lru is the least recently used one.
+ */
+
+static uint32_t g_dns_lru;
 
 /* This is the DNS resolver cache */
 
@@ -97,6 +118,172 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_hash
+ *
+ * Description:
+ *   Return the hash bucket of the hostname (FNV-1a over the cached part of
+ *   the name).
+ *
+ ****************************************************************************/
+
+static unsigned int dns_hash(FAR const char *hostname)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE && hostname[i] != '\0';
+       i++)
+    {
+      hash ^= (uint8_t)hostname[i];
+      hash *= 16777619u;
+    }
+
+  return hash % DNS_HASH_SIZE;
+}
+
+/****************************************************************************
+ * Name: dns_now
+ *
+ * Description:
+ *   Return the current time in seconds, using CLOCK_MONOTONIC if possible.
+ *
+ ****************************************************************************/
+
+static time_t dns_now(void)
+{
+  struct timespec now;
+
+  if (clock_gettime(DNS_CLOCK, &now) < 0)
+    {
+      return 0;
+    }
+
+  return now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_lookup
+ *
+ * Description:
+ *   Find the hostname in its hash chain.  Expired entries found on the way
+ *   are removed from the cache.
+ *
+ * Assumptions:
+ *   The caller holds the DNS semaphore.
+ *
+ ****************************************************************************/
+
+static FAR struct dns_cache_s *dns_lookup(FAR const char *hostname,
+                                          time_t now)
+{
+  FAR struct dns_cache_s *entry;
+  FAR uint8_t *link;
+
+  link = &g_dns_hash[dns_hash(hostname)];
+  while (*link != DNS_NO_ENTRY)
+    {
+      entry = DNS_ENTRY(*link);
+
+      if (now >= entry->expire)
+        {
+          /* This entry has expired.  Unlink and free it. */
+
+          *link          = entry->hnext;
+          entry->name[0] = '\0';
+          continue;
+        }
+
+      /* Notice that because the names are truncated to
+       * CONFIG_NETDB_DNSCLIENT_NAMESIZE, this has the possibility of
+       * aliasing two names and returning the wrong entry from the cache.
+       */
+
+      if (strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+        {
+          return entry;
+        }
+
+      link = &entry->hnext;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: dns_unlink
+ *
+ * Description:
+ *   Remove an entry from its hash chain.
+ *
+ * Assumptions:
+ *   The caller holds the DNS semaphore.
+ *
+ ****************************************************************************/
+
+static void dns_unlink(FAR struct dns_cache_s *entry)
+{
+  FAR uint8_t *link;
+
+  link = &g_dns_hash[dns_hash(entry->name)];
+  while (*link != DNS_NO_ENTRY)
+    {
+      if (*link == DNS_LINK(entry))
+        {
+          *link = entry->hnext;
+          break;
+        }
+
+      link = &DNS_ENTRY(*link)->hnext;
+    }
+
+  entry->name[0] = '\0';
+}
+
+/****************************************************************************
+ * Name: dns_alloc_entry
+ *
+ * Description:
+ *   Return a free cache entry.  If there is none, an expired entry or else
+ *   the least recently used entry is evicted.
+ *
+ * Assumptions:
+ *   The caller holds the DNS semaphore.
+ *
+ ****************************************************************************/
+
+static FAR struct dns_cache_s *dns_alloc_entry(time_t now)
+{
+  FAR struct dns_cache_s *entry;
+  FAR struct dns_cache_s *victim = NULL;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
+    {
+      entry = &g_dns_cache[ndx];
+      if (entry->name[0] == '\0')
+        {
+          return entry;
+        }
+
+      if (now >= entry->expire)
+        {
+          victim = entry;
+          break;
+        }
+
+      if (victim == NULL ||
+          (int32_t)(entry->lru - victim->lru) < 0)
+        {
+          victim = entry;
+        }
+    }
+
+  dns_unlink(victim);
+  return victim;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,12 +292,17 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Name: dns_save_answer
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache.  An existing entry
+ *   for the hostname is replaced.
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero saves a negative
+ *              entry:  The hostname does not exist or has no address.
+ *   ttl      - The time to live of the answer in seconds.  It is limited
+ *              to CONFIG_NETDB_DNSCLIENT_LIFESEC, or, for negative entries,
+ *              replaced by CONFIG_NETDB_DNSCLIENT_NEGLIFESEC.
  *
  * Returned Value:
  *   None
@@ -118,64 +310,59 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  ****************************************************************************/
 
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr)
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
-  int ndx;
+  time_t now;
+  unsigned int bucket;
 
   naddr = MIN(naddr, CONFIG_NETDB_DNSCLIENT_MAXIP);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
 
-  /* Get exclusive access to the DNS cache */
-
-  dns_semtake();
+  if (naddr == 0)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_NEGLIFESEC;
+    }
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  else if (ttl > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_LIFESEC;
+    }
+#endif
 
-  /* Get the index to the new head of the list */
+  /* An answer with a zero TTL must not be cached */
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  if (ttl == 0 || hostname[0] == '\0')
     {
-      next = 0;
+      return;
     }
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
-   */
+  /* Get exclusive access to the DNS cache */
+
+  dns_semtake();
 
-  if (next == g_dns_tail)
+  /* Re-use the entry of the hostname, if there is one, or get a new one */
+
+  now   = dns_now();
+  entry = dns_lookup(hostname, now);
+  if (entry == NULL)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-        {
-          tmp = 0;
-        }
+      entry = dns_alloc_entry(now);
 
-      g_dns_tail = tmp;
+      strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
+      bucket             = dns_hash(entry->name);
+      entry->hnext       = g_dns_hash[bucket];
+      g_dns_hash[bucket] = DNS_LINK(entry);
     }
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  (void)clock_gettime(DNS_CLOCK, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
-
-  strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
+  entry->expire = now + ttl;
+  entry->lru    = ++g_dns_lru;
+  entry->naddr  = naddr;
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
-  entry->naddr = naddr;
-
-  /* Save the updated head index */
 
-  g_dns_head = next;
   dns_semgive();
 }
 
@@ -195,9 +382,10 @@ void dns_save_answer(FAR const char *hostname,
  *
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
- *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   cache, zero (OK) will be returned.  -EADDRNOTAVAIL is returned if the
+ *   cache holds a negative entry for the hostname.  Otherwise, some negated
+ *   errno value will be returned, typically -ENOENT meaning that the
+ *   hostname was not found in the cache.
  *
  ****************************************************************************/
 
@@ -205,13 +393,7 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
-  int next;
-  int ndx;
+  int ret = -ENOENT;
 
   /* If DNS not initialized, no need to proceed */
 
@@ -225,75 +407,29 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
 
   dns_semtake();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  ret = clock_gettime(DNS_CLOCK, &now);
-#endif
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  entry = dns_lookup(hostname, dns_now());
+  if (entry != NULL)
     {
-      entry = &g_dns_cache[ndx];
-
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
-       */
+      entry->lru = ++g_dns_lru;
 
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      if (entry->naddr == 0)
         {
-          next = 0;
-        }
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
-
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
-        {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
-
-          g_dns_tail = next;
+          ret = -EADDRNOTAVAIL;
         }
       else
-#endif
         {
-          /* The entry has not expired, check for a name match.  Notice that
-           * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
+          /* We have a match.  Return as many addresses as will fit in the
+           * caller-provided buffer.
            */
 
-          if (strncmp(hostname, entry->name, CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
-
-              /* Return the address information */
-
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
-
-              dns_semgive();
-              return OK;
-            }
+          *naddr = MIN(*naddr, entry->naddr);
+          memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          ret = OK;
         }
     }
 
-  ret = -ENOENT;
-
   dns_semgive();
   return ret;
 }
 
 #endif /* CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 */
-
@@ -5,8 +5,8 @@
  * The DNS resolver functions are used to lookup a hostname and map it to a
  * numerical IP address.
  *
- *   Copyright (C) 2007, 2009, 2012, 2014-2018 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2007, 2009, 2012, 2014-2018, 2020 Gregory Nutt. All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Based heavily on portions of uIP:
@@ -50,6 +50,7 @@
 
 #include <string.h>
 #include <time.h>
+#include <poll.h>
 #include <errno.h>
 #include <debug.h>
 #include <assert.h>
@@ -79,19 +80,32 @@
 #define SEND_BUFFER_SIZE (16 + CONFIG_NETDB_DNSCLIENT_NAMESIZE + 2)
 #define RECV_BUFFER_SIZE CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 
+/* Use clock monotonic, if possible */
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define DNS_CLOCK CLOCK_MONOTONIC
+#else
+#  define DNS_CLOCK CLOCK_REALTIME
+#endif
+
+/* The address record types that are queried concurrently.  They are listed
+ * in g_dns_rectypes[] in the order of preference.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define DNS_NRECTYPES 2
+#else
+#  define DNS_NRECTYPES 1
+#endif
+
+/* One query is sent for each record type to each name server */
+
+#define DNS_MAXQUERIES (CONFIG_NETDB_DNSCLIENT_MAXSERVERS * DNS_NRECTYPES)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-struct dns_query_s
-{
-  int sd;                         /* DNS server socket */
-  int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR union dns_addr_u *addr;     /* Location to return host address */
-  FAR int *naddr;                 /* Number of returned addresses */
-};
-
 /* Query info to check response against. */
 
 struct dns_query_info_s
@@ -111,6 +125,52 @@ struct dns_query_info_s
   uint16_t qnamelen;                             /* Queried hostname length */
   char qname[CONFIG_NETDB_DNSCLIENT_NAMESIZE+2]; /* Queried hostname in encoded
                                                   * format + NUL */
+  int result;                                    /* -EAGAIN: Not answered */
+};
+
+/* The state of the concurrent queries for one hostname.  Query n asks
+ * server n / DNS_NRECTYPES for record type g_dns_rectypes[n % DNS_NRECTYPES].
+ */
+
+struct dns_query_s
+{
+  int sd;                         /* DNS server socket */
+  int result;                     /* Explanation of the failure */
+  int nservers;                   /* Number of servers in server[] */
+  uint16_t id;                    /* The ID of the first query */
+  FAR const char *hostname;       /* Hostname to lookup */
+
+  /* The name servers */
+
+  union dns_addr_u server[CONFIG_NETDB_DNSCLIENT_MAXSERVERS];
+
+  /* The queries */
+
+  struct dns_query_info_s qinfo[DNS_MAXQUERIES];
+
+  /* The first valid answer for each record type.  rtresult is -EAGAIN while
+   * the record type is unresolved, the number of addresses, or a negated
+   * errno value.  -EADDRNOTAVAIL means that the hostname has no address of
+   * the type.
+   */
+
+  int rtresult[DNS_NRECTYPES];
+  uint32_t ttl[DNS_NRECTYPES];
+  union dns_addr_u addr[DNS_NRECTYPES][CONFIG_NETDB_DNSCLIENT_MAXIP];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint16_t g_dns_rectypes[DNS_NRECTYPES] =
+{
+#ifdef CONFIG_NET_IPv4
+  DNS_RECTYPE_A,
+#endif
+#ifdef CONFIG_NET_IPv6
+  DNS_RECTYPE_AAAA
+#endif
 };
 
 /****************************************************************************
@@ -206,7 +266,7 @@ static inline uint16_t dns_alloc_id(void)
 
 static int dns_send_query(int sd, FAR const char *name,
                           FAR union dns_addr_u *uaddr, uint16_t rectype,
-                          FAR struct dns_query_info_s *qinfo)
+                          uint16_t id, FAR struct dns_query_info_s *qinfo)
 {
   FAR struct dns_header_s *hdr;
   FAR uint8_t *dest;
@@ -215,17 +275,12 @@ static int dns_send_query(int sd, FAR const char *name,
   FAR char *qptr;
   FAR const char *src;
   uint8_t buffer[SEND_BUFFER_SIZE];
-  uint16_t id;
   socklen_t addrlen;
   int errcode;
   int ret;
   int len;
   int n;
 
-  /* Get a new ID for query */
-
-  id = dns_alloc_id();
-
   /* Initialize the request header */
 
   hdr               = (FAR struct dns_header_s *)buffer;
@@ -332,54 +387,46 @@ static int dns_send_query(int sd, FAR const char *name,
 }
 
 /****************************************************************************
- * Name: dns_recv_response
+ * Name: dns_parse_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Check if the UDP data received from 'recvaddr' is the response to the
+ *   query 'qinfo' and, if so, parse the answers.
  *
  * Returned Value:
- *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   Returns number of valid IP address responses.  'ttl' is set to the
+ *   smallest time to live of these.  -EBADMSG is returned if the data is
+ *   not the response to the query.  -EADDRNOTAVAIL is returned if the
+ *   hostname does not exist or has no address of the queried type.
+ *   Negated errno value is returned in all other cases.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
-                             FAR struct dns_query_info_s *qinfo)
+static int dns_parse_response(FAR char *buffer, int buflen,
+                              FAR union dns_addr_u *recvaddr,
+                              FAR union dns_addr_u *addr, FAR int *naddr,
+                              FAR uint32_t *ttl,
+                              FAR struct dns_query_info_s *qinfo)
 {
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
   FAR uint8_t *endofbuffer;
-  char buffer[RECV_BUFFER_SIZE];
   FAR struct dns_answer_s *ans;
   FAR struct dns_header_s *hdr;
   FAR struct dns_question_s *que;
   uint16_t nquestions;
   uint16_t nanswers;
-  union dns_addr_u recvaddr;
-  socklen_t raddrlen;
+  uint32_t ansttl;
   int naddr_read;
-  int errcode;
   int ret;
 
-  /* Receive the response */
-
-  raddrlen = sizeof(recvaddr.addr);
-  ret      = _NX_RECVFROM(sd, buffer, RECV_BUFFER_SIZE, 0,
-                          &recvaddr.addr, &raddrlen);
-  if (ret < 0)
-    {
-      errcode = -_NX_GETERRNO(ret);
-      nerr("ERROR: recv failed: %d\n", errcode);
-      return errcode;
-    }
-
 #ifdef CONFIG_NET_IPv4
   /* Check for an IPv4 address */
 
-  if (recvaddr.addr.sa_family == AF_INET)
+  if (recvaddr->addr.sa_family == AF_INET)
     {
-      if (memcmp(&recvaddr.ipv4.sin_addr, &qinfo->u.srv_ipv4,
-                 sizeof(recvaddr.ipv4.sin_addr)) != 0)
+      if (memcmp(&recvaddr->ipv4.sin_addr, &qinfo->u.srv_ipv4,
+                 sizeof(recvaddr->ipv4.sin_addr)) != 0)
         {
           /* Not response from DNS server. */
 
@@ -387,7 +434,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
           return -EBADMSG;
         }
 
-      if (recvaddr.ipv4.sin_port != qinfo->srv_port)
+      if (recvaddr->ipv4.sin_port != qinfo->srv_port)
         {
           /* Not response from DNS server. */
 
@@ -399,10 +446,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
 #ifdef CONFIG_NET_IPv6
   /* Check for an IPv6 address */
 
-  if (recvaddr.addr.sa_family == AF_INET6)
+  if (recvaddr->addr.sa_family == AF_INET6)
     {
-      if (memcmp(&recvaddr.ipv6.sin6_addr, &qinfo->u.srv_ipv6,
-                 sizeof(recvaddr.ipv6.sin6_addr)) != 0)
+      if (memcmp(&recvaddr->ipv6.sin6_addr, &qinfo->u.srv_ipv6,
+                 sizeof(recvaddr->ipv6.sin6_addr)) != 0)
         {
           /* Not response from DNS server. */
 
@@ -410,7 +457,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
           return -EBADMSG;
         }
 
-      if (recvaddr.ipv6.sin6_port != qinfo->srv_port)
+      if (recvaddr->ipv6.sin6_port != qinfo->srv_port)
         {
           /* Not response from DNS server. */
 
@@ -420,7 +467,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
     }
 #endif
 
-  if (ret < sizeof(*hdr))
+  if (buflen < sizeof(*hdr))
     {
       /* DNS header can't fit in received data */
 
@@ -429,7 +476,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
     }
 
   hdr         = (FAR struct dns_header_s *)buffer;
-  endofbuffer = (FAR uint8_t*)buffer + ret;
+  endofbuffer = (FAR uint8_t*)buffer + buflen;
 
   ninfo("ID %d\n", htons(hdr->id));
   ninfo("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
@@ -438,14 +485,6 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
         htons(hdr->numquestions), htons(hdr->numanswers),
         htons(hdr->numauthrr), htons(hdr->numextrarr));
 
-  /* Check for error */
-
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
-    {
-      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
-      return -EPROTO;
-    }
-
   /* Check for matching ID. */
 
   if (hdr->id != qinfo->id)
@@ -535,12 +574,28 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
       return -EBADMSG;
     }
 
+  /* Check for error.  A name error means that the hostname does not
+   * exist.
+   */
+
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
+    {
+      ninfo("DNS reported name error\n");
+      return -EADDRNOTAVAIL;
+    }
+  else if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+    {
+      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
+      return -EPROTO;
+    }
+
   /* Skip over question */
 
   nameptr += sizeof(struct dns_question_s);
 
   ret = OK;
   naddr_read = 0;
+  *ttl = UINT32_MAX;
 
   for (; nanswers > 0; nanswers--)
     {
@@ -555,10 +610,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
 
       ans = (FAR struct dns_answer_s *)nameptr;
 
+      ansttl = ((uint32_t)htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]);
+
       ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x \n",
-            htons(ans->type), htons(ans->class),
-            (htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]),
-            htons(ans->len));
+            htons(ans->type), htons(ans->class), ansttl, htons(ans->len));
 
       /* Check for IPv4/6 address type and Internet class. Others are
        * discarded.
@@ -587,6 +642,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
               inaddr->sin_port         = 0;
               inaddr->sin_addr.s_addr  = ans->u.ipv4.s_addr;
 
+              *ttl = MIN(*ttl, ansttl);
               naddr_read++;
               if (naddr_read >= *naddr)
                 {
@@ -624,6 +680,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
               inaddr->sin6_port        = 0;
               memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
+              *ttl = MIN(*ttl, ansttl);
               naddr_read++;
               if (naddr_read >= *naddr)
                 {
@@ -660,8 +717,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
  * Name: dns_query_callback
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   Add this DNS server address to the list of name servers that are
+ *   queried.
  *
  * Input Parameters:
  *   arg      - Query arguements
@@ -669,9 +726,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) to stop the traversal when the list of name servers is
+ *   full.  Zero is returned in all other cases.
  *
  ****************************************************************************/
 
@@ -679,196 +735,303 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
-  FAR struct dns_query_info_s qinfo;
-  int retries;
-  int ret;
 
-  /* Loop while receive timeout errors occur and there are remaining
-   * retries.
-  */
+#ifdef CONFIG_NET_IPv4
+  /* Is this an IPv4 address? */
 
-  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+  if (addr->sa_family == AF_INET)
     {
-#ifdef CONFIG_NET_IPv4
-      /* Is this an IPv4 address? */
+      /* Yes.. verify the address size */
 
-      if (addr->sa_family == AF_INET)
+      if (addrlen < sizeof(struct sockaddr_in))
         {
-          /* Yes.. verify the address size */
+          /* Return zero to skip this address and try the next
+           * nameserver address in resolv.conf.
+           */
 
-          if (addrlen < sizeof(struct sockaddr_in))
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
+          nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
+        }
 
-              nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
+      memcpy(&query->server[query->nservers].ipv4, addr,
+             sizeof(struct sockaddr_in));
+    }
+  else
+#endif
 
-          /* Send the IPv4 query */
+#ifdef CONFIG_NET_IPv6
+  /* Is this an IPv6 address? */
 
-          ret = dns_send_query(query->sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_A, &qinfo);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
+  if (addr->sa_family == AF_INET6)
+    {
+      /* Yes.. verify the address size */
 
-              nerr("ERROR: IPv4 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
+      if (addrlen < sizeof(struct sockaddr_in6))
+        {
+          /* Return zero to skip this address and try the next
+           * nameserver address in resolv.conf.
+           */
 
-          /* Obtain the IPv4 response */
+          nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
+        }
 
-          ret = dns_recv_response(query->sd, query->addr, query->naddr,
-                                  &qinfo);
-          if (ret >= 0)
-            {
-              /* IPv4 response received successfully */
+      memcpy(&query->server[query->nservers].ipv6, addr,
+             sizeof(struct sockaddr_in6));
+    }
+  else
+#endif
+    {
+      /* Unsupported address family. Return zero to continue the
+       * tranversal with the next nameserver address in resolv.conf.
+       */
 
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
+      return 0;
+    }
 
-              dns_save_answer(query->hostname, query->addr,
-                              *query->naddr);
-#endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
+  query->nservers++;
+  return query->nservers >= CONFIG_NETDB_DNSCLIENT_MAXSERVERS ? 1 : 0;
+}
 
-              return 1;
-            }
+/****************************************************************************
+ * Name: dns_update_result
+ *
+ * Description:
+ *   Update the result of the record type of query 'n' after the query
+ *   completed.  The first valid answer of any server is used.  If no
+ *   server gave a valid answer, the result is the error of the last query.
+ *
+ ****************************************************************************/
 
-          /* Handle errors */
+static void dns_update_result(FAR struct dns_query_s *query, int n)
+{
+  int rt = n % DNS_NRECTYPES;
+  int i;
 
-          nerr("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
+  if (query->rtresult[rt] != -EAGAIN)
+    {
+      return;
+    }
 
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv4 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+  if (query->qinfo[n].result >= 0 || query->qinfo[n].result == -EADDRNOTAVAIL)
+    {
+      query->rtresult[rt] = query->qinfo[n].result;
+      return;
+    }
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
+  for (i = rt; i < query->nservers * DNS_NRECTYPES; i += DNS_NRECTYPES)
+    {
+      if (query->qinfo[i].result == -EAGAIN)
+        {
+          return;
+        }
+    }
+
+  query->rtresult[rt] = query->qinfo[n].result;
+}
+
+/****************************************************************************
+ * Name: dns_send_queries
+ *
+ * Description:
+ *   Send all queries that have not been answered yet and whose record type
+ *   is still unresolved.  A query keeps its ID when it is sent again so
+ *   that a late response to the previous attempt is accepted.
+ *
+ ****************************************************************************/
+
+static void dns_send_queries(FAR struct dns_query_s *query)
+{
+  FAR struct dns_query_info_s *qinfo;
+  int ret;
+  int rt;
+  int i;
+
+  for (i = 0; i < query->nservers * DNS_NRECTYPES; i++)
+    {
+      qinfo = &query->qinfo[i];
+      rt    = i % DNS_NRECTYPES;
+
+      if (qinfo->result == -EAGAIN && query->rtresult[rt] == -EAGAIN)
+        {
+          ret = dns_send_query(query->sd, query->hostname,
+                               &query->server[i / DNS_NRECTYPES],
+                               g_dns_rectypes[rt], query->id + i, qinfo);
+          if (ret < 0)
             {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next nameserver
-               * address in resolv.conf.
-               */
+              /* Do not try this server again */
 
-              query->result = ret;
-              return 0;
+              nerr("ERROR: dns_send_query failed: %d\n", ret);
+              qinfo->result = ret;
+              dns_update_result(query, i);
             }
         }
-      else
-#endif /* CONFIG_NET_IPv4 */
+    }
+}
 
-#ifdef CONFIG_NET_IPv6
-      /* Is this an IPv6 address? */
+/****************************************************************************
+ * Name: dns_query_done
+ *
+ * Description:
+ *   Check if the lookup is complete, that is if a record type has addresses
+ *   and all preferred record types are resolved.
+ *
+ * Returned Value:
+ *   The index of the record type to use, -EAGAIN if the lookup is not
+ *   complete or the negated errno value of the failure.  -EADDRNOTAVAIL is
+ *   returned only if the hostname has no address of any record type.
+ *
+ ****************************************************************************/
+
+static int dns_query_done(FAR struct dns_query_s *query)
+{
+  int ret = -EADDRNOTAVAIL;
+  int rt;
 
-      if (addr->sa_family == AF_INET6)
+  for (rt = 0; rt < DNS_NRECTYPES; rt++)
+    {
+      if (query->rtresult[rt] > 0)
+        {
+          return rt;
+        }
+      else if (query->rtresult[rt] == -EAGAIN)
+        {
+          return -EAGAIN;
+        }
+      else if (query->rtresult[rt] != -EADDRNOTAVAIL)
         {
-          /* Yes.. verify the address size */
+          ret = query->rtresult[rt];
+        }
+    }
 
-          if (addrlen < sizeof(struct sockaddr_in6))
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
+  return ret;
+}
 
-              nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
+/****************************************************************************
+ * Name: dns_recv_response
+ *
+ * Description:
+ *   Wait for the responses to the queries for up to
+ *   CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT seconds.
+ *
+ * Returned Value:
+ *   The value of dns_query_done() when the lookup is complete.  -EAGAIN
+ *   is returned on a timeout.
+ *
+ ****************************************************************************/
+
+static int dns_recv_response(FAR struct dns_query_s *query)
+{
+  FAR struct dns_query_info_s *qinfo;
+  FAR struct dns_header_s *hdr;
+  char buffer[RECV_BUFFER_SIZE];
+  union dns_addr_u recvaddr;
+  struct timespec deadline;
+  struct timespec now;
+  struct pollfd fds;
+  socklen_t raddrlen;
+  uint32_t ttl;
+  int timeout;
+  int errcode;
+  int buflen;
+  int naddr;
+  int ret;
+  int rt;
+  int i;
 
-          /* Send the IPv6 query */
+  clock_gettime(DNS_CLOCK, &deadline);
+  deadline.tv_sec += CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT;
 
-          ret = dns_send_query(query->sd, query->hostname,
-                              (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_AAAA, &qinfo);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
+  while ((ret = dns_query_done(query)) == -EAGAIN)
+    {
+      /* Wait for the next response */
 
-              nerr("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
+      clock_gettime(DNS_CLOCK, &now);
+      timeout = (deadline.tv_sec - now.tv_sec) * 1000 +
+                (deadline.tv_nsec - now.tv_nsec) / 1000000;
+      if (timeout <= 0)
+        {
+          return -EAGAIN;
+        }
 
-          /* Obtain the IPv6 response */
+      fds.fd      = query->sd;
+      fds.events  = POLLIN;
+      fds.revents = 0;
 
-          ret = dns_recv_response(query->sd, query->addr, query->naddr,
-                                  &qinfo);
-          if (ret >= 0)
+      ret = poll(&fds, 1, timeout);
+      if (ret < 0)
+        {
+          errcode = get_errno();
+          if (errcode == EINTR)
             {
-              /* IPv6 response received successfully */
+              continue;
+            }
 
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
+          nerr("ERROR: poll failed: %d\n", errcode);
+          return -errcode;
+        }
+      else if (ret == 0)
+        {
+          return -EAGAIN;
+        }
 
-              dns_save_answer(query->hostname, query->addr, *query->naddr);
-#endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
+      /* Receive the response */
 
-              return 1;
+      raddrlen = sizeof(recvaddr.addr);
+      buflen   = _NX_RECVFROM(query->sd, buffer, RECV_BUFFER_SIZE, 0,
+                              &recvaddr.addr, &raddrlen);
+      if (buflen < 0)
+        {
+          errcode = -_NX_GETERRNO(buflen);
+          nerr("ERROR: recv failed: %d\n", errcode);
+          if (errcode == -EAGAIN || errcode == -EINTR)
+            {
+              continue;
             }
 
-          /* Handle errors */
+          return errcode;
+        }
+
+      /* Find the outstanding query that this is the response to.  Late
+       * responses for record types that are already resolved are ignored.
+       */
 
-          nerr("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
+      hdr = (FAR struct dns_header_s *)buffer;
+      for (i = 0; i < query->nservers * DNS_NRECTYPES; i++)
+        {
+          qinfo = &query->qinfo[i];
+          rt    = i % DNS_NRECTYPES;
 
-          if (ret == -EADDRNOTAVAIL)
+          if (qinfo->result != -EAGAIN || query->rtresult[rt] != -EAGAIN ||
+              (buflen >= sizeof(*hdr) && hdr->id != qinfo->id))
             {
-              /* The IPv6 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
-
-              query->result = -EADDRNOTAVAIL;
-              return 0;
+              continue;
             }
-          else if (ret != -EAGAIN)
+
+          naddr = CONFIG_NETDB_DNSCLIENT_MAXIP;
+          ret   = dns_parse_response(buffer, buflen, &recvaddr,
+                                     query->addr[rt], &naddr, &ttl, qinfo);
+          if (ret == -EBADMSG)
             {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next nameserver
-               * address in resolv.conf.
-               */
+              /* Not the response to this query */
 
-              query->result = ret;
-              return 0;
+              continue;
             }
-        }
-      else
-#endif
-        {
-           /* Unsupported address family. Return zero to continue the
-            * tranversal with the next nameserver address in resolv.conf.
-            */
 
-           return 0;
+          if (ret > 0)
+            {
+              query->ttl[rt] = ttl;
+            }
+
+          qinfo->result = ret;
+          dns_update_result(query, i);
+          break;
         }
     }
 
-  /* We tried and could not communicate with this nameserver. Perhaps it
-   * is down?  Return zero to continue with the next address in the
-   * resolv.conf file.
-   */
-
-  query->result = -ETIMEDOUT;
-  return 0;
+  return ret;
 }
 
 /****************************************************************************
@@ -882,6 +1045,11 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *   Using the DNS resolver socket (sd), look up the 'hostname', and
  *   return its IP address in 'ipaddr'
  *
+ *   The address records of all types are queried concurrently from up to
+ *   CONFIG_NETDB_DNSCLIENT_MAXSERVERS name servers.  The first valid answer
+ *   for each record type is used.  IPv4 addresses are returned in
+ *   preference to IPv6 addresses.
+ *
  * Input Parameters:
  *   sd       - The socket descriptor previously initialized by dsn_bind().
  *   hostname - The hostname string to be resolved.
@@ -900,34 +1068,116 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
               FAR int *naddr)
 {
   FAR struct dns_query_s query;
+  int retries;
   int ret;
+  int i;
 
   /* Set up the query info structure */
 
   query.sd       = sd;
   query.result   = -EADDRNOTAVAIL;
+  query.nservers = 0;
+  query.id       = dns_alloc_id();
   query.hostname = hostname;
-  query.addr     = addr;
-  query.naddr    = naddr;
 
-  /* Perform the query. dns_foreach_nameserver() will return:
+  for (i = 0; i < DNS_MAXQUERIES; i++)
+    {
+      query.qinfo[i].result = -EAGAIN;
+    }
+
+  for (i = 0; i < DNS_NRECTYPES; i++)
+    {
+      query.rtresult[i] = -EAGAIN;
+    }
+
+  /* Get the list of name servers. dns_foreach_nameserver() will return:
    *
-   *  1 - The query was successful.
-   *  0 - Look up failed
+   *  1 - The list of name servers is full.
+   *  0 - All name servers were added.
    * <0 - Some other failure (?, shouldn't happen)
    */
 
   ret = dns_foreach_nameserver(dns_query_callback, &query);
-  if (ret > 0)
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (query.nservers == 0)
+    {
+      return query.result;
+    }
+
+  /* Loop while receive timeout errors occur and there are remaining
+   * retries.  Each retry sends the queries that are still unanswered.
+   */
+
+  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
     {
-      /* The lookup was successful */
+      dns_send_queries(&query);
+      ret = dns_recv_response(&query);
+      if (ret != -EAGAIN)
+        {
+          break;
+        }
 
+      /* Do not retry the preferred record types if there already are
+       * addresses of another type.
+       */
+
+      for (i = 0; i < DNS_NRECTYPES; i++)
+        {
+          if (query.rtresult[i] > 0)
+            {
+              break;
+            }
+        }
+
+      if (i < DNS_NRECTYPES)
+        {
+          break;
+        }
+    }
+
+  if (ret == -EAGAIN)
+    {
+      /* Give up on the unresolved record types.  Perhaps the name servers
+       * are down?
+       */
+
+      for (i = 0; i < DNS_NRECTYPES; i++)
+        {
+          if (query.rtresult[i] == -EAGAIN)
+            {
+              query.rtresult[i] = -ETIMEDOUT;
+            }
+        }
+
+      ret = dns_query_done(&query);
+    }
+
+  if (ret >= 0)
+    {
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      /* Save the answer in the DNS cache */
+
+      dns_save_answer(hostname, query.addr[ret], query.rtresult[ret],
+                      query.ttl[ret]);
+#endif
+
+      /* Return the addresses of the preferred record type */
+
+      *naddr = MIN(*naddr, query.rtresult[ret]);
+      memcpy(addr, query.addr[ret], *naddr * sizeof(*addr));
       ret = OK;
     }
-  else if (ret == 0)
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  else if (ret == -EADDRNOTAVAIL)
     {
-      ret = query.result;
+      /* Remember that the hostname has no address */
+
+      dns_save_answer(hostname, query.addr[0], 0, 0);
     }
+#endif
 
   return ret;
 }
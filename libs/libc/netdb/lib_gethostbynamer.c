@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/netdb/lib_gethostbynamer.c
  *
- *   Copyright (C) 2015, 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -831,16 +831,23 @@ int gethostbyname_r(FAR const char *name, FAR struct hostent *host,
 
       return OK;
     }
-#endif
 
-  /* Try to get the host address using the DNS name server */
+  /* Do not ask the DNS name server again if the cache remembers that the
+   * hostname has no address.
+   */
 
-  ret = lib_dns_lookup(name, host, buf, buflen);
-  if (ret >= 0)
+  if (ret != -EADDRNOTAVAIL)
+#endif
     {
-      /* Successful DNS lookup! */
+      /* Try to get the host address using the DNS name server */
 
-      return OK;
+      ret = lib_dns_lookup(name, host, buf, buflen);
+      if (ret >= 0)
+        {
+          /* Successful DNS lookup! */
+
+          return OK;
+        }
     }
 #endif /* CONFIG_NETDB_DNSCLIENT */
 
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/stdio/lib_fgetc.c
  *
- *   Copyright (C) 2007, 2008, 2011 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2008, 2011, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -38,6 +38,8 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <errno.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -45,15 +47,15 @@
  ****************************************************************************/
 
 /****************************************************************************
- * fgetc
+ * fgetc_unlocked
  ****************************************************************************/
 
-int fgetc(FAR FILE *stream)
+int fgetc_unlocked(FAR FILE *stream)
 {
   unsigned char ch;
   ssize_t ret;
 
-  ret = lib_fread(&ch, 1, stream);
+  ret = lib_fread_unlocked(&ch, 1, stream);
   if (ret > 0)
     {
       return ch;
@@ -63,3 +65,23 @@ int fgetc(FAR FILE *stream)
       return EOF;
     }
 }
+
+/****************************************************************************
+ * fgetc
+ ****************************************************************************/
+
+int fgetc(FAR FILE *stream)
+{
+  int ret;
+
+  if (stream == NULL)
+    {
+      set_errno(EBADF);
+      return EOF;
+    }
+
+  lib_take_semaphore(stream);
+  ret = getc_unlocked(stream);
+  lib_give_semaphore(stream);
+  return ret;
+}
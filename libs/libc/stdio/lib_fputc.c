@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/stdio/lib_fputc.c
  *
- *   Copyright (C) 2007, 2008, 2011-2012, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2008, 2011-2012, 2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -38,6 +39,8 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <errno.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -45,15 +48,15 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: fputc
+ * Name: fputc_unlocked
  ****************************************************************************/
 
-int fputc(int c, FAR FILE *stream)
+int fputc_unlocked(int c, FAR FILE *stream)
 {
   unsigned char buf = (unsigned char)c;
   int ret;
 
-  ret = lib_fwrite(&buf, 1, stream);
+  ret = lib_fwrite_unlocked(&buf, 1, stream);
   if (ret > 0)
     {
       /* Flush the buffer if a newline is output */
@@ -74,3 +77,23 @@ int fputc(int c, FAR FILE *stream)
       return EOF;
     }
 }
+
+/****************************************************************************
+ * Name: fputc
+ ****************************************************************************/
+
+int fputc(int c, FAR FILE *stream)
+{
+  int ret;
+
+  if (stream == NULL)
+    {
+      set_errno(EBADF);
+      return EOF;
+    }
+
+  lib_take_semaphore(stream);
+  ret = putc_unlocked(c, stream);
+  lib_give_semaphore(stream);
+  return ret;
+}
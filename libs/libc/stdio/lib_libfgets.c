@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/stdio/lib_libfgets.c
  *
- *   Copyright (C) 2007-2008, 2011-2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2008, 2011-2014, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -103,7 +104,7 @@ static void consume_eol(FILE *stream, bool consume)
 
       do
         {
-          ch = fgetc(stream);
+          ch = getc_unlocked(stream);
         }
 #if  defined(CONFIG_EOL_IS_LF) || defined(CONFIG_EOL_IS_BOTH_CRLF)
       while (ch != EOF && ch != '\n');
@@ -116,34 +117,16 @@ static void consume_eol(FILE *stream, bool consume)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: lib_fgets
+ * Name: lib_fgets_unlocked
  *
  * Description:
- *   lib_fgets() implements the core logic for both fgets() and gets_s().
- *   lib_fgets() reads in at most one less than 'buflen' characters from
- *   stream and stores them into the buffer pointed to by 'buf'. Reading
- *   stops after an EOF or a newline encountered or after a read error
- *   occurs.
- *
- *   If a newline is read, it is stored into the buffer only if 'keepnl' is
- *   set true.  A null terminator is always stored after the last character
- *   in the buffer.
- *
- *   If 'buflen'-1 bytes were read into 'buf' without encountering an EOF
- *   or newline then the following behavior depends on the value of
- *   'consume':  If consume is true, then lib_fgets() will continue reading
- *   bytes and discarding them until an EOF or a newline encountered or
- *   until a read error occurs.  Otherwise, lib_fgets() returns with the
- *   remaining of the incoming stream buffer.
+ *   The body of lib_fgets().  The caller holds the stream semaphore.
  *
  ****************************************************************************/
 
-FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
-                    bool keepnl, bool consume)
+static FAR char *lib_fgets_unlocked(FAR char *buf, size_t buflen,
+                                    FILE *stream, bool keepnl,
+                                    bool consume)
 {
   size_t nch = 0;
 
@@ -182,7 +165,7 @@ FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
     {
       /* Get the next character */
 
-      int ch = fgetc(stream);
+      int ch = getc_unlocked(stream);
 
       /* Check for end-of-line.  This is tricky only in that some
        * environments may return CR as end-of-line, others LF, and
@@ -253,3 +236,48 @@ FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
         }
     }
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_fgets
+ *
+ * Description:
+ *   lib_fgets() implements the core logic for both fgets() and gets_s().
+ *   lib_fgets() reads in at most one less than 'buflen' characters from
+ *   stream and stores them into the buffer pointed to by 'buf'. Reading
+ *   stops after an EOF or a newline encountered or after a read error
+ *   occurs.
+ *
+ *   If a newline is read, it is stored into the buffer only if 'keepnl' is
+ *   set true.  A null terminator is always stored after the last character
+ *   in the buffer.
+ *
+ *   If 'buflen'-1 bytes were read into 'buf' without encountering an EOF
+ *   or newline then the following behavior depends on the value of
+ *   'consume':  If consume is true, then lib_fgets() will continue reading
+ *   bytes and discarding them until an EOF or a newline encountered or
+ *   until a read error occurs.  Otherwise, lib_fgets() returns with the
+ *   remaining of the incoming stream buffer.
+ *
+ ****************************************************************************/
+
+FAR char *lib_fgets(FAR char *buf, size_t buflen, FILE *stream,
+                    bool keepnl, bool consume)
+{
+  FAR char *ret;
+
+  if (stream == NULL)
+    {
+      return NULL;
+    }
+
+  /* Take the stream semaphore once for the whole line */
+
+  lib_take_semaphore(stream);
+  ret = lib_fgets_unlocked(buf, buflen, stream, keepnl, consume);
+  lib_give_semaphore(stream);
+  return ret;
+}
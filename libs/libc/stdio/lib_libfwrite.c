@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/stdio/lib_libfwrite.c
  *
- *   Copyright (C) 2007-2009, 2011, 2013-2014, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011, 2013-2014, 2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,6 +43,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -55,16 +57,20 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: lib_fwrite
+ * Name: lib_fwrite_unlocked
+ *
+ * Description:
+ *   Write to the stream.  The caller must hold the stream semaphore.
+ *
  ****************************************************************************/
 
-ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
+ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
+                            FAR FILE *stream)
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
 {
   FAR const unsigned char *start = ptr;
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
-  unsigned char *dest;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -85,22 +91,16 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
   /* If there is no I/O buffer, then output data immediately */
 
   if (stream->fs_bufstart == NULL)
-   {
-     ret = _NX_WRITE(stream->fs_fd, ptr, count);
-#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
-     if (ret < 0)
-       {
-         _NX_SETERRNO((int)-ret);
-         ret = ERROR;
-       }
-#endif
-
-     goto errout;
-   }
-
-  /* Get exclusive access to the stream */
+    {
+      ret = _NX_WRITE(stream->fs_fd, ptr, count);
+      if (ret < 0)
+        {
+          _NX_SETERRNO(ret);
+          ret = ERROR;
+        }
 
-  lib_take_semaphore(stream);
+      goto errout;
+    }
 
   /* If the buffer is currently being used for read access, then
    * discard all of the read-ahead data.  We do not support concurrent
@@ -109,16 +109,42 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   if (lib_rdflush(stream) < 0)
     {
-      goto errout_with_semaphore;
+      goto errout;
     }
 
-  /* Loop until all of the bytes have been buffered */
+  /* Loop until all of the bytes have been buffered or written */
 
   while (count > 0)
     {
+      size_t gulp_size;
+
+      /* If the buffer is empty and the remaining data would fill it anyway,
+       * then there is no point in copying it through the buffer.  Write it
+       * directly.
+       */
+
+      if (stream->fs_bufpos == stream->fs_bufstart &&
+          count >= (size_t)(stream->fs_bufend - stream->fs_bufstart))
+        {
+          ssize_t nwritten = _NX_WRITE(stream->fs_fd, src, count);
+          if (nwritten < 0)
+            {
+              _NX_SETERRNO(nwritten);
+              goto errout;
+            }
+          else if (nwritten == 0)
+            {
+              break;
+            }
+
+          src   += nwritten;
+          count -= nwritten;
+          continue;
+        }
+
       /* Determine the number of bytes left in the buffer */
 
-      size_t gulp_size = stream->fs_bufend - stream->fs_bufpos;
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
 
       /* Will the user data fit into the amount of buffer space
        * that we have left?
@@ -131,31 +157,23 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
           gulp_size = count;
         }
 
-      /* Adjust the number of bytes remaining to be transferred
-       * on the next pass through the loop (might be zero).
-       */
-
-      count -= gulp_size;
-
       /* Transfer the data into the buffer */
 
-      for (dest = stream->fs_bufpos; gulp_size > 0; gulp_size--)
-        {
-          *dest++ = *src++;
-        }
-
-      stream->fs_bufpos = dest;
+      memcpy(stream->fs_bufpos, src, gulp_size);
+      stream->fs_bufpos += gulp_size;
+      src               += gulp_size;
+      count             -= gulp_size;
 
       /* Is the buffer full? */
 
-      if (dest >= stream->fs_bufend)
+      if (stream->fs_bufpos >= stream->fs_bufend)
         {
           /* Flush the buffered data to the IO stream */
 
           int bytes_buffered = lib_fflush(stream, false);
           if (bytes_buffered < 0)
             {
-              goto errout_with_semaphore;
+              goto errout;
             }
         }
     }
@@ -164,9 +182,6 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   ret = (uintptr_t)src - (uintptr_t)start;
 
-errout_with_semaphore:
-  lib_give_semaphore(stream);
-
 errout:
   if (ret < 0)
     {
@@ -187,3 +202,25 @@ errout:
   return ret;
 }
 #endif /* CONFIG_STDIO_DISABLE_BUFFERING */
+
+/****************************************************************************
+ * Name: lib_fwrite
+ ****************************************************************************/
+
+ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
+{
+  ssize_t ret;
+
+  if (stream == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  /* Get exclusive access to the stream */
+
+  lib_take_semaphore(stream);
+  ret = lib_fwrite_unlocked(ptr, count, stream);
+  lib_give_semaphore(stream);
+  return ret;
+}
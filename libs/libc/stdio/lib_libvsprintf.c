@@ -75,6 +75,18 @@
 
 #define putc(c,stream)  (total_len++, (stream)->put(stream, c))
 
+/* Put a block of characters with the bulk write method of the stream or,
+ * if the stream does not have one, one character at a time.
+ */
+
+#define putstr(s,n,stream) \
+  do \
+    { \
+      total_len += (n); \
+      vsprintf_puts(stream, s, n); \
+    } \
+  while (0)
+
 /* Order is relevant here and matches order in format string */
 
 #define FL_ZFILL           0x0001
@@ -143,6 +155,30 @@ struct arg
 
  static const char g_nullstring[] = "(null)";
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsprintf_puts
+ ****************************************************************************/
+
+static void vsprintf_puts(FAR struct lib_outstream_s *stream,
+                          FAR const char *buf, int len)
+{
+  if (stream->puts != NULL)
+    {
+      stream->puts(stream, buf, len);
+    }
+  else
+    {
+      while (len-- > 0)
+        {
+          stream->put(stream, *buf++);
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -185,6 +221,29 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Put the literal text up to the next conversion all at once */
+
+          FAR const char *start = fmt;
+
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+          if (fmt != start)
+            {
+#ifdef CONFIG_LIBC_NUMBERED_ARGS
+              if (stream != NULL)
+                {
+                  putstr(start, fmt - start, stream);
+                }
+#else
+              putstr(start, fmt - start, stream);
+#endif
+            }
+
+#endif
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -904,15 +963,10 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
                 }
             }
 
-          while (size)
+          if (size > 0)
             {
-              putc(*pnt++, stream);
-              if (width != 0)
-                {
-                  width -= 1;
-                }
-
-              size -= 1;
+              putstr(pnt, size, stream);
+              width = (size < width) ? width - size : 0;
             }
 
           goto tail;
@@ -1207,9 +1261,22 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
           prec--;
         }
 
-      while (c)
+      /* The digits are in reverse order.  Reverse them in place and put
+       * them all at once.
+       */
+
+      if (c > 0)
         {
-          putc(buf[--c], stream);
+          int i;
+
+          for (i = 0; i < c / 2; i++)
+            {
+              unsigned char tmp = buf[i];
+              buf[i]            = buf[c - 1 - i];
+              buf[c - 1 - i]    = tmp;
+            }
+
+          putstr((FAR const char *)buf, c, stream);
         }
 
 tail:
@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/stdio/lib_lowoutstream.c
  *
- *   Copyright (C) 2007-2009, 2011-2012, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011-2012, 2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -88,6 +89,7 @@ static void lowoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_lowoutstream(FAR struct lib_outstream_s *stream)
 {
   stream->put   = lowoutstream_putc;
+  stream->puts  = NULL;
   stream->flush = lib_noflush;
   stream->nput  = 0;
 }
@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/stdio/lib_rawsostream.c
  *
- *   Copyright (C) 2007-2009, 2011-2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011-2012, 2014, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -88,6 +89,44 @@ static void rawoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (errcode == EINTR);
 }
 
+/****************************************************************************
+ * Name: rawoutstream_puts
+ ****************************************************************************/
+
+static void rawoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const void *buf, int len)
+{
+  FAR struct lib_rawoutstream_s *rthis = (FAR struct lib_rawoutstream_s *)this;
+  FAR const char *ptr = (FAR const char *)buf;
+  ssize_t nwritten;
+
+  DEBUGASSERT(this && rthis->fd >= 0);
+
+  /* Loop until all of the characters are transferred or until an
+   * irrecoverable error occurs.
+   */
+
+  while (len > 0)
+    {
+      nwritten = _NX_WRITE(rthis->fd, ptr, len);
+      if (nwritten > 0)
+        {
+          this->nput += nwritten;
+          ptr        += nwritten;
+          len        -= nwritten;
+        }
+
+      /* The only expected error is EINTR, meaning that the write operation
+       * was awakened by a signal.
+       */
+
+      else if (nwritten == 0 || _NX_GETERRNO(nwritten) != EINTR)
+        {
+          break;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -112,6 +151,7 @@ static void rawoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_rawoutstream(FAR struct lib_rawoutstream_s *outstream, int fd)
 {
   outstream->public.put   = rawoutstream_putc;
+  outstream->public.puts  = rawoutstream_puts;
   outstream->public.flush = lib_noflush;
   outstream->public.nput  = 0;
   outstream->fd           = fd;
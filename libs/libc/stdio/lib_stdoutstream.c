@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/stdio/lib_stdoutstream.c
  *
- *   Copyright (C) 2007-2009, 2011-2012, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011-2012, 2014, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -37,6 +38,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <string.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
@@ -64,7 +66,7 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 
   do
     {
-      result = fputc(ch, sthis->stream);
+      result = putc_unlocked(ch, sthis->stream);
       if (result != EOF)
         {
           this->nput++;
@@ -78,6 +80,52 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static void stdoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const void *buf, int len)
+{
+  FAR struct lib_stdoutstream_s *sthis = (FAR struct lib_stdoutstream_s *)this;
+  FAR const char *ptr = (FAR const char *)buf;
+  ssize_t result;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Loop until all of the characters are transferred or an irrecoverable
+   * error occurs.
+   */
+
+  while (len > 0)
+    {
+      result = lib_fwrite_unlocked(ptr, len, sthis->stream);
+      if (result > 0)
+        {
+          this->nput += result;
+          ptr        += result;
+          len        -= result;
+        }
+
+      /* EINTR (meaning that the write was interrupted by a signal) is the
+       * only recoverable error.
+       */
+
+      else if (result == 0 || get_errno() != EINTR)
+        {
+          return;
+        }
+    }
+
+  /* Like fputc(), flush a line buffered stream if a newline was output */
+
+  if ((sthis->stream->fs_flags & __FS_FLAG_LBF) != 0 &&
+      memchr(buf, '\n', ptr - (FAR const char *)buf) != NULL)
+    {
+      lib_fflush(sthis->stream, true);
+    }
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -100,7 +148,8 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *this)
  * Name: lib_stdoutstream
  *
  * Description:
- *   Initializes a stream for use with a FILE instance.
+ *   Initializes a stream for use with a FILE instance.  The caller must
+ *   hold the stream semaphore while the stream is used.
  *
  * Input Parameters:
  *   outstream - User allocated, uninitialized instance of struct
@@ -116,9 +165,10 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *this)
 void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
                       FAR FILE *stream)
 {
-  /* Select the put operation */
+  /* Select the put operations */
 
-  outstream->public.put = stdoutstream_putc;
+  outstream->public.put  = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
   /* Select the correct flush operation.  This flush is only called when
    * a newline is encountered in the output stream.  However, we do not
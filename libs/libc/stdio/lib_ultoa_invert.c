@@ -39,6 +39,28 @@
 
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The decimal digit pairs "00" through "99".  Decimal conversions produce
+ * two digits per division.
+ */
+
+static const char g_digitpairs[200] =
+{
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899"
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,18 +72,71 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
   int upper = 0;
+  int shift = 0;
 
   if (base & XTOA_UPPER)
     {
       upper = 1;
       base &= ~XTOA_UPPER;
     }
+
+  if (base == 10)
+    {
+      FAR const char *pair;
+
+      /* The digits are stored in reverse order */
+
+      while (val >= 100)
+        {
+          pair   = &g_digitpairs[2 * (unsigned int)(val % 100)];
+          val   /= 100;
+          *str++ = pair[1];
+          *str++ = pair[0];
+        }
+
+      if (val >= 10)
+        {
+          pair   = &g_digitpairs[2 * (unsigned int)val];
+          *str++ = pair[1];
+          *str++ = pair[0];
+        }
+      else
+        {
+          *str++ = '0' + (int)val;
+        }
+
+      return str;
+    }
+
+  /* Avoid the (possibly long long) division for the power-of-two bases */
+
+  if (base == 16)
+    {
+      shift = 4;
+    }
+  else if (base == 8)
+    {
+      shift = 3;
+    }
+  else if (base == 2)
+    {
+      shift = 1;
+    }
+
   do
     {
       int v;
 
-      v   = val % base;
-      val = val / base;
+      if (shift != 0)
+        {
+          v     = (int)val & (base - 1);
+          val >>= shift;
+        }
+      else
+        {
+          v   = val % base;
+          val = val / base;
+        }
 
       if (v <= 9)
         {
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/string/lib_memchr.c
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +68,29 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      uintptr_t mask = LIBC_ONES * (unsigned char)c;
+
+      /* Check the bytes up to the first word boundary */
+
+      for (; n > 0 && !LIBC_ALIGNED(p); n--, p++)
+        {
+          if (*p == (unsigned char)c)
+            {
+              return (FAR void *)p;
+            }
+        }
+
+      /* Then skip over the words that do not contain 'c' */
+
+      while (n >= LIBC_WORDSIZE &&
+             !LIBC_HASZERO(*(FAR const uintptr_t *)p ^ mask))
+        {
+          p += LIBC_WORDSIZE;
+          n -= LIBC_WORDSIZE;
+        }
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
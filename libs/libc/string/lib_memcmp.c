@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/string/lib_memcmp.c
  *
- *   Copyright (C) 2007, 2011-2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2011-2012, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,6 +54,35 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   unsigned char *p1 = (unsigned char *)s1;
   unsigned char *p2 = (unsigned char *)s2;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* If both can be word aligned, then skip over the equal words.  The
+   * first word that differs is compared byte-by-byte below.
+   */
+
+  if ((((uintptr_t)p1 ^ (uintptr_t)p2) & LIBC_WORDMASK) == 0)
+    {
+      while (n > 0 && !LIBC_ALIGNED(p1))
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      while (n >= LIBC_WORDSIZE &&
+             *(FAR const uintptr_t *)p1 == *(FAR const uintptr_t *)p2)
+        {
+          p1 += LIBC_WORDSIZE;
+          p2 += LIBC_WORDSIZE;
+          n  -= LIBC_WORDSIZE;
+        }
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
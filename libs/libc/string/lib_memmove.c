@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/string/lib_memmove.c
  *
- *   Copyright (C) 2007, 2011 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2011, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,12 +53,38 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR char *tmp;
   FAR char *s;
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  bool words = (((uintptr_t)dest ^ (uintptr_t)src) & LIBC_WORDMASK) == 0;
+#endif
 
   if (dest <= src)
     {
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      /* If both can be word aligned, then copy words.  Each word is read
+       * before it is overwritten, even if the regions overlap.
+       */
+
+      if (words)
+        {
+          while (count > 0 && !LIBC_ALIGNED(s))
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          while (count >= LIBC_WORDSIZE)
+            {
+              *(FAR uintptr_t *)tmp = *(FAR const uintptr_t *)s;
+              tmp   += LIBC_WORDSIZE;
+              s     += LIBC_WORDSIZE;
+              count -= LIBC_WORDSIZE;
+            }
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -66,6 +95,25 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      if (words)
+        {
+          while (count > 0 && !LIBC_ALIGNED(s))
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          while (count >= LIBC_WORDSIZE)
+            {
+              tmp   -= LIBC_WORDSIZE;
+              s     -= LIBC_WORDSIZE;
+              count -= LIBC_WORDSIZE;
+              *(FAR uintptr_t *)tmp = *(FAR const uintptr_t *)s;
+            }
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/string/lib_strcmp.c
  *
- *   Copyright (C) 2007-2009, 2011 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -48,6 +51,40 @@
 #ifndef CONFIG_LIBC_ARCH_STRCMP
 int strcmp(FAR const char *cs, FAR const char *ct)
 {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  FAR const unsigned char *p1 = (FAR const unsigned char *)cs;
+  FAR const unsigned char *p2 = (FAR const unsigned char *)ct;
+
+  /* If both can be word aligned, then skip over the equal words that do
+   * not contain the terminator.
+   */
+
+  if ((((uintptr_t)p1 ^ (uintptr_t)p2) & LIBC_WORDMASK) == 0)
+    {
+      for (; !LIBC_ALIGNED(p1); p1++, p2++)
+        {
+          if (*p1 != *p2 || *p1 == '\0')
+            {
+              return *p1 - *p2;
+            }
+        }
+
+      while (*(FAR const uintptr_t *)p1 == *(FAR const uintptr_t *)p2 &&
+             !LIBC_HASZERO(*(FAR const uintptr_t *)p1))
+        {
+          p1 += LIBC_WORDSIZE;
+          p2 += LIBC_WORDSIZE;
+        }
+    }
+
+  while (*p1 == *p2 && *p1 != '\0')
+    {
+      p1++;
+      p2++;
+    }
+
+  return *p1 - *p2;
+#else
   register signed char result;
   for (; ; )
     {
@@ -56,5 +93,6 @@ int strcmp(FAR const char *cs, FAR const char *ct)
     }
 
   return result;
+#endif
 }
 #endif
@@ -0,0 +1,222 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASHED
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashcompare
+ *
+ * Description:
+ *   qsort() comparison function:  Order by hash then by index, so that the
+ *   order of symbols with the same hash is preserved.
+ *
+ ****************************************************************************/
+
+static int symtab_hashcompare(FAR const void *arg1, FAR const void *arg2)
+{
+  FAR const struct symtab_hash_s *entry1 =
+    (FAR const struct symtab_hash_s *)arg1;
+  FAR const struct symtab_hash_s *entry2 =
+    (FAR const struct symtab_hash_s *)arg2;
+
+  if (entry1->hash != entry2->hash)
+    {
+      return entry1->hash < entry2->hash ? -1 : 1;
+    }
+
+  return entry1->index - entry2->index;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name.  This is the GNU ELF hash function
+ *   (h = h * 33 + c).
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name)
+{
+  FAR const unsigned char *ptr = (FAR const unsigned char *)name;
+  uint32_t hash = 5381;
+
+  while (*ptr != '\0')
+    {
+      hash = (hash << 5) + hash + *ptr++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_mkhash
+ *
+ * Description:
+ *   Build the hash index of a symbol table.  See include/nuttx/symtab.h.
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *symtab_mkhash(FAR const struct symtab_s *symtab,
+                                        int nsyms)
+{
+  FAR struct symtab_hash_s *hashtab;
+  int i;
+
+  if (symtab == NULL || nsyms <= 0)
+    {
+      return NULL;
+    }
+
+  hashtab = (FAR struct symtab_hash_s *)
+    lib_malloc(nsyms * sizeof(struct symtab_hash_s));
+  if (hashtab == NULL)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < nsyms; i++)
+    {
+      hashtab[i].hash  = symtab_hash(symtab[i].sym_name);
+      hashtab[i].index = i;
+    }
+
+  qsort(hashtab, nsyms, sizeof(struct symtab_hash_s), symtab_hashcompare);
+  return hashtab;
+}
+
+/****************************************************************************
+ * Name: symtab_freehash
+ *
+ * Description:
+ *   Free a hash index created by symtab_mkhash().
+ *
+ ****************************************************************************/
+
+void symtab_freehash(FAR struct symtab_hash_s *hashtab)
+{
+  if (hashtab != NULL)
+    {
+      lib_free(hashtab);
+    }
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name using the
+ *   hash index.  See include/nuttx/symtab.h.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_s *symtab,
+                  FAR const struct symtab_hash_s *hashtab,
+                  FAR const char *name, uint32_t hash, int nsyms)
+{
+  int low;
+  int high;
+  int mid;
+
+  DEBUGASSERT(symtab != NULL && name != NULL);
+
+  /* Without an index, fall back to the search by name */
+
+  if (hashtab == NULL)
+    {
+#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+      return symtab_findorderedbyname(symtab, name, nsyms);
+#else
+      return symtab_findbyname(symtab, name, nsyms);
+#endif
+    }
+
+  /* Find the first entry with the hash */
+
+  low  = 0;
+  high = nsyms;
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (hashtab[mid].hash < hash)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  /* Then compare the names of all of the entries with the hash */
+
+  for (; low < nsyms && hashtab[low].hash == hash; low++)
+    {
+      FAR const struct symtab_s *symbol = &symtab[hashtab[low].index];
+
+      if (strcmp(name, symbol->sym_name) == 0)
+        {
+          return symbol;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_SYMTAB_HASHED */
@@ -0,0 +1,132 @@
+/****************************************************************************
+ * libs/libc/time/lib_clockgettime.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+
+/* In the kernel, clock_gettime() is provided by the OS */
+
+#if defined(CONFIG_CLOCK_TIMEPAGE) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The time page, looked up on first use */
+
+static FAR const volatile struct clock_timepage_s *g_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Return the current value of the clock 'clock_id' by reading the time
+ *   page that is published by the kernel.  Only the address of the page is
+ *   obtained with a system call, once.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const volatile struct clock_timepage_s *page = g_timepage;
+  struct timespec monotonic;
+  struct timespec basetime;
+  uint32_t seq;
+
+  if (page == NULL)
+    {
+      page = clock_timepage();
+      if (page == NULL)
+        {
+          set_errno(ENOSYS);
+          return ERROR;
+        }
+
+      g_timepage = page;
+    }
+
+  /* Copy the times, retrying if the kernel updated the page meanwhile */
+
+  do
+    {
+      seq                = page->seq;
+      monotonic.tv_sec   = page->monotonic.tv_sec;
+      monotonic.tv_nsec  = page->monotonic.tv_nsec;
+      basetime.tv_sec    = page->basetime.tv_sec;
+      basetime.tv_nsec   = page->basetime.tv_nsec;
+    }
+  while ((seq & 1) != 0 || seq != page->seq);
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clock_id == CLOCK_MONOTONIC)
+    {
+      *tp = monotonic;
+      return OK;
+    }
+#endif
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      /* Add the base time to the time since power up, as the kernel does */
+
+      tp->tv_sec  = basetime.tv_sec + monotonic.tv_sec;
+      tp->tv_nsec = basetime.tv_nsec + monotonic.tv_nsec;
+      if (tp->tv_nsec >= NSEC_PER_SEC)
+        {
+          tp->tv_nsec -= NSEC_PER_SEC;
+          tp->tv_sec++;
+        }
+
+      return OK;
+    }
+
+  set_errno(EINVAL);
+  return ERROR;
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE && !__KERNEL__ */
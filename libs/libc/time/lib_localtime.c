@@ -3,7 +3,7 @@
  *
  * Re-released as part of NuttX under the 3-clause BSD license:
  *
- *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014, 2020 Gregory Nutt. All rights reserved.
  *   Ported to NuttX by Max Neklyudov
  *   Style updates by Gregory Nutt
  *
@@ -56,9 +56,12 @@
 #include <string.h>
 #include <limits.h>
 #include <fcntl.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -72,6 +75,12 @@
 #  define TZDIR "/etc/zoneinfo"
 #endif
 
+/* Number of loaded local time zones that are kept */
+
+#ifndef CONFIG_LIBC_TZ_CACHE
+#  define CONFIG_LIBC_TZ_CACHE 2
+#endif
+
 /* Time definitions *********************************************************/
 
 /* Time zone files */
@@ -283,6 +292,11 @@ struct state_s
   char chars[BIGGEST(BIGGEST(TZ_MAX_CHARS + 1, GMTLEN), (2 * (MY_TZNAME_MAX + 1)))];
   struct lsinfo_s lsis[TZ_MAX_LEAPS];
   int defaulttype;            /* For early times or if no transitions */
+
+  /* The TZ value that the local time state was loaded for */
+
+  int lcl_isset;              /* >0: lcl_name, <0: TZ not set */
+  char lcl_name[MY_TZNAME_MAX + 1];
 };
 
 struct rule_s
@@ -312,9 +326,18 @@ static time_t const g_max_timet =
 
 static const char g_wildabbr[] = WILDABBR;
 
-static char g_lcl_tzname[MY_TZNAME_MAX + 1];
-static int g_lcl_isset;
-static int g_gmt_isset;
+/* The local time states that were loaded.  Switching back to one of these
+ * time zones does not load it again.  When a new time zone is loaded, the
+ * oldest state is replaced.  It is freed only after the new state was
+ * published, so readers of the current state never access freed memory.
+ */
+
+static FAR struct state_s *g_lcl_cache[CONFIG_LIBC_TZ_CACHE];
+static int g_lcl_next;
+
+/* Serializes the loading of the time zone states.  Readers do not lock. */
+
+static sem_t g_tz_sem = SEM_INITIALIZER(1);
 
 /* Section 4.12.3 of X3.159-1989 requires that
  *    Except for the strftime function, these functions [asctime,
@@ -376,7 +399,7 @@ static int  increment_overflow_time(time_t * t, int_fast32_t delta);
 static int  normalize_overflow32(FAR int_fast32_t * tensptr,
               FAR int *unitsptr, int base);
 static int  normalize_overflow(FAR int *tensptr, FAR int *unitsptr, int base);
-static void settzname(void);
+static void settzname(FAR struct state_s *sp);
 static time_t time1(FAR struct tm *tmp,
               FAR struct tm *(*funcp)(FAR const time_t *, int_fast32_t,
                                       FAR struct tm *),
@@ -389,6 +412,8 @@ static time_t time2sub(FAR struct tm *tmp,
               FAR struct tm *(*funcp)(FAR const time_t *,
                                       int_fast32_t, FAR struct tm *),
               int_fast32_t offset, FAR int *okayp, int do_norm_secs);
+static FAR struct tm *timesub_civil(time_t t, int_fast32_t offset,
+                                    FAR struct tm *tmp);
 static FAR struct tm *timesub(FAR const time_t * timep, int_fast32_t offset,
               FAR const struct state_s *sp, FAR struct tm *tmp);
 static int  tmcomp(FAR const struct tm *atmp, FAR const struct tm *btmp);
@@ -434,9 +459,8 @@ static int_fast64_t detzcode64(FAR const char *const codep)
   return result;
 }
 
-static void settzname(void)
+static void settzname(FAR struct state_s *const sp)
 {
-  FAR struct state_s *const sp = lclptr;
   int i;
 
   tzname[0] = tzname[1] = (FAR char *)g_wildabbr;
@@ -1609,35 +1633,135 @@ static void gmtload(FAR struct state_s *const sp)
     }
 }
 
-/* A non-static declaration of tzsetwall in a system header file
- * may cause a warning about this upcoming static declaration...
- */
+/****************************************************************************
+ * Name: tz_semtake and tz_semgive
+ *
+ * Description:
+ *   Take and release the time zone semaphore, ignoring errors do to the
+ *   receipt of signals.
+ *
+ ****************************************************************************/
 
-static void tzsetwall(void)
+static void tz_semtake(void)
 {
-  if (g_lcl_isset < 0)
+  int errcode = 0;
+  int ret;
+
+  do
     {
-      return;
+       ret = _SEM_WAIT(&g_tz_sem);
+       if (ret < 0)
+         {
+           errcode = _SEM_ERRNO(ret);
+           DEBUGASSERT(errcode == EINTR || errcode == ECANCELED);
+         }
     }
+  while (ret < 0 && errcode == EINTR);
+}
 
-  g_lcl_isset = -1;
+static void tz_semgive(void)
+{
+  DEBUGVERIFY(_SEM_POST(&g_tz_sem));
+}
 
-  if (lclptr == NULL)
+/* Return TRUE if the local time state was loaded for the TZ value 'name' */
+
+static int tzmatch(FAR const struct state_s *const sp,
+                   FAR const char *const name)
+{
+  if (name == NULL)
     {
-      lclptr = malloc(sizeof *lclptr);
-      if (lclptr == NULL)
+      return sp->lcl_isset < 0;
+    }
+
+  return sp->lcl_isset > 0 && strcmp(sp->lcl_name, name) == 0;
+}
+
+/* Make the local time state for the TZ value 'name' the current one in
+ * lclptr, loading it into a new state if it is not cached.  The readers use
+ * lclptr without locking, so a published state is never modified.  The
+ * caller holds g_tz_sem.
+ */
+
+static void tzsetlocal(FAR const char *const name)
+{
+  FAR struct state_s *sp;
+  int i;
+
+  for (i = 0; i < CONFIG_LIBC_TZ_CACHE; i++)
+    {
+      sp = g_lcl_cache[i];
+      if (sp != NULL && tzmatch(sp, name))
         {
-          settzname();          /* all we can do */
+          lclptr = sp;
+          settzname(sp);
           return;
         }
     }
 
-  if (tzload(NULL, lclptr, TRUE) != 0)
+  sp = malloc(sizeof *sp);
+  if (sp == NULL)
     {
-      gmtload(lclptr);
+      if (lclptr == NULL)
+        {
+          settzname(NULL); /* all we can do */
+        }
+
+      return;
     }
 
-  settzname();
+  if (name == NULL)
+    {
+      sp->lcl_isset = -1;
+      if (tzload(NULL, sp, TRUE) != 0)
+        {
+          gmtload(sp);
+        }
+    }
+  else
+    {
+      sp->lcl_isset = strlen(name) < sizeof sp->lcl_name;
+      if (sp->lcl_isset)
+        {
+          (void)strcpy(sp->lcl_name, name);
+        }
+
+      if (*name == '\0')
+        {
+          /* User wants it fast rather than right */
+
+          sp->leapcnt = 0; /* so, we're off a little */
+          sp->timecnt = 0;
+          sp->typecnt = 0;
+          sp->charcnt = 0;
+          sp->goback = 0;
+          sp->goahead = 0;
+          sp->defaulttype = 0;
+          sp->ttis[0].tt_isdst = 0;
+          sp->ttis[0].tt_gmtoff = 0;
+          sp->ttis[0].tt_abbrind = 0;
+          (void)strcpy(sp->chars, GMT);
+        }
+      else if (tzload(name, sp, TRUE) != 0)
+        {
+          if (name[0] == ':' || tzparse(name, sp, FALSE) != 0)
+            {
+              (void)gmtload(sp);
+            }
+        }
+    }
+
+  settzname(sp);
+
+  /* Publish the new state, then free the oldest one */
+
+  i              = g_lcl_next;
+  lclptr         = sp;
+  sp             = g_lcl_cache[i];
+  g_lcl_cache[i] = lclptr;
+  g_lcl_next     = (i + 1) % CONFIG_LIBC_TZ_CACHE;
+
+  free(sp);
 }
 
 /* The easy way to behave "as if no library function calls" localtime
@@ -1767,17 +1891,28 @@ static struct tm *localsub(FAR const time_t * const timep,
 static struct tm *gmtsub(FAR const time_t * const timep, const int_fast32_t offset,
                          struct tm *const tmp)
 {
-  if (!g_gmt_isset)
+  FAR struct state_s *sp = gmtptr;
+
+  if (sp == NULL)
     {
-      gmtptr = malloc(sizeof *gmtptr);
-      g_gmt_isset = gmtptr != NULL;
-      if (g_gmt_isset)
+      /* Load the state before publishing it in gmtptr */
+
+      tz_semtake();
+      if (gmtptr == NULL)
         {
-          gmtload(gmtptr);
+          sp = malloc(sizeof *sp);
+          if (sp != NULL)
+            {
+              gmtload(sp);
+              gmtptr = sp;
+            }
         }
+
+      sp = gmtptr;
+      tz_semgive();
     }
 
-  return timesub(timep, offset, gmtptr, tmp);
+  return timesub(timep, offset, sp, tmp);
 }
 
 /* Return the number of leap years through the end of the given year
@@ -1790,6 +1925,70 @@ static int leaps_thru_end_of(const int y)
     -(leaps_thru_end_of(-(y + 1)) + 1);
 }
 
+/* Convert the time to the broken-down time in closed form, without any
+ * loops.  This is the days-to-civil algorithm by Howard Hinnant.  The year
+ * starts in March so that the leap day is the last day of the year.
+ * Returns NULL if the time is outside of the supported range.
+ */
+
+static struct tm *timesub_civil(const time_t t, const int_fast32_t offset,
+                                struct tm *const tmp)
+{
+  int_fast64_t secs = (int_fast64_t)t + offset;
+  int_fast64_t days;
+  int_fast32_t rem;
+  int_fast32_t era;
+  int_fast32_t doe;
+  int_fast32_t yoe;
+  int_fast32_t doy;
+  int_fast32_t mp;
+  int_fast32_t y;
+
+  days = secs / SECSPERDAY;
+  rem  = secs % SECSPERDAY;
+  if (rem < 0)
+    {
+      rem += SECSPERDAY;
+      days--;
+    }
+
+  /* Keep the year well within the range of tm_year */
+
+  if (days < -(INT_MAX / DAYSPERLYEAR) || days > INT_MAX / DAYSPERLYEAR)
+    {
+      return NULL;
+    }
+
+  tmp->tm_wday = (int)((days + EPOCH_WDAY) % DAYSPERWEEK);
+  if (tmp->tm_wday < 0)
+    {
+      tmp->tm_wday += DAYSPERWEEK;
+    }
+
+  /* Count the days from 0000-03-01 and split them into 400 year eras */
+
+  days += 719468;
+  era = (int_fast32_t)((days >= 0 ? days : days - 146096) / 146097);
+  doe = (int_fast32_t)(days - (int_fast64_t)era * 146097);
+  yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / DAYSPERNYEAR;
+  doy = doe - (DAYSPERNYEAR * yoe + yoe / 4 - yoe / 100);
+  mp  = (5 * doy + 2) / 153;
+  y   = yoe + era * 400 + (mp >= 10);
+
+  tmp->tm_mday = (int)(doy - (153 * mp + 2) / 5 + 1);
+  tmp->tm_mon  = (int)(mp < 10 ? mp + 2 : mp - 10);
+  tmp->tm_yday = (int)(mp < 10 ? doy + 31 + 28 + isleap(y) : doy - 306);
+  tmp->tm_year = (int)(y - TM_YEAR_BASE);
+
+  tmp->tm_hour  = (int)(rem / SECSPERHOUR);
+  rem          %= SECSPERHOUR;
+  tmp->tm_min   = (int)(rem / SECSPERMIN);
+  tmp->tm_sec   = (int)(rem % SECSPERMIN);
+  tmp->tm_isdst = 0;
+
+  return tmp;
+}
+
 static struct tm *timesub(FAR const time_t * const timep,
                           const int_fast32_t offset,
                           FAR const struct state_s *const sp,
@@ -1835,6 +2034,13 @@ static struct tm *timesub(FAR const time_t * const timep,
         }
     }
 
+  /* Without a leap second correction, use the fast closed form */
+
+  if (corr == 0 && hit == 0 && timesub_civil(*timep, offset, tmp) != NULL)
+    {
+      return tmp;
+    }
+
   y = EPOCH_YEAR;
   tdays = *timep / SECSPERDAY;
   rem = *timep - tdays * SECSPERDAY;
@@ -2460,56 +2666,25 @@ static time_t time1(FAR struct tm *const tmp,
 void tzset(void)
 {
   FAR const char *name;
+  FAR struct state_s *sp;
 
-  name = getenv("TZ");
-  if (name == NULL)
-    {
-      tzsetwall();
-      return;
-    }
+  /* In the common case, the state was already loaded for the TZ value */
 
-  if (g_lcl_isset > 0 && strcmp(g_lcl_tzname, name) == 0)
+  name = getenv("TZ");
+  sp   = lclptr;
+  if (sp != NULL && tzmatch(sp, name))
     {
       return;
     }
 
-  g_lcl_isset = strlen(name) < sizeof g_lcl_tzname;
-  if (g_lcl_isset)
-    {
-      (void)strcpy(g_lcl_tzname, name);
-    }
-
-  if (lclptr == NULL)
-    {
-      lclptr = malloc(sizeof *lclptr);
-      if (lclptr == NULL)
-        {
-          settzname(); /* all we can do */
-          return;
-        }
-    }
-
-  if (*name == '\0')
-    {
-      /* User wants it fast rather than right */
-
-      lclptr->leapcnt = 0; /* so, we're off a little */
-      lclptr->timecnt = 0;
-      lclptr->typecnt = 0;
-      lclptr->ttis[0].tt_isdst = 0;
-      lclptr->ttis[0].tt_gmtoff = 0;
-      lclptr->ttis[0].tt_abbrind = 0;
-      (void)strcpy(lclptr->chars, GMT);
-    }
-  else if (tzload(name, lclptr, TRUE) != 0)
+  tz_semtake();
+  sp = lclptr;
+  if (sp == NULL || !tzmatch(sp, name))
     {
-      if (name[0] == ':' || tzparse(name, lclptr, FALSE) != 0)
-        {
-          (void)gmtload(lclptr);
-        }
+      tzsetlocal(name);
     }
 
-  settzname();
+  tz_semgive();
 }
 
 FAR struct tm *localtime(FAR const time_t * const timep)
@@ -2522,6 +2697,11 @@ FAR struct tm *localtime(FAR const time_t * const timep)
 
 FAR struct tm *localtime_r(FAR const time_t * const timep, struct tm *tmp)
 {
+  if (lclptr == NULL)
+    {
+      tzset();
+    }
+
   return localsub(timep, 0L, tmp);
 }
 
@@ -222,21 +222,33 @@ static inline int userfs_read_dispatch(FAR struct userfs_info_s *info,
   /* Dispatch the request */
 
   readlen = req->readlen;
+  resp    = (FAR struct userfs_read_response_s *)info->iobuffer;
+
+  DEBUGASSERT(info->userops != NULL && info->userops->read != NULL);
+
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  /* Read directly into the caller's buffer.  No data accompanies the
+   * response.
+   */
+
+  resp->nread = info->userops->read(info->volinfo, req->openinfo,
+                                    req->rdbuffer, readlen);
+  resplen     = SIZEOF_USERFS_READ_RESPONSE_S(0);
+#else
   if (readlen > info->mxwrite)
     {
       readlen = info->mxwrite;
     }
 
-  resp = (FAR struct userfs_read_response_s *)info->iobuffer;
-
-  DEBUGASSERT(info->userops != NULL && info->userops->read != NULL);
   resp->nread = info->userops->read(info->volinfo, req->openinfo,
                                     resp->rddata, readlen);
+  resplen     = SIZEOF_USERFS_READ_RESPONSE_S(resp->nread < 0 ?
+                                              0 : resp->nread);
+#endif
 
   /* Send the response */
 
   resp->resp  = USERFS_RESP_READ;
-  resplen     = SIZEOF_USERFS_READ_RESPONSE_S(resp->nread);
   nsent       = sendto(info->sockfd, resp, resplen, 0,
                        (FAR struct sockaddr *)&info->client,
                        sizeof(struct sockaddr_in));
@@ -259,12 +271,18 @@ static inline int userfs_write_dispatch(FAR struct userfs_info_s *info,
     }
 
   writelen = req->writelen;
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  /* The data is not included in the request */
+
+  expected = SIZEOF_USERFS_WRITE_REQUEST_S(0);
+#else
   if (writelen > info->mxwrite)
     {
       return -EINVAL;
     }
 
   expected = SIZEOF_USERFS_WRITE_REQUEST_S(writelen);
+#endif
   if (expected != reqlen)
     {
       return -EINVAL;
@@ -273,8 +291,13 @@ static inline int userfs_write_dispatch(FAR struct userfs_info_s *info,
   /* Dispatch the request */
 
   DEBUGASSERT(info->userops != NULL && info->userops->write != NULL);
+#ifdef CONFIG_FS_USERFS_DIRECTIO
+  resp.nwritten = info->userops->write(info->volinfo, req->openinfo,
+                                       req->wrbuffer, writelen);
+#else
   resp.nwritten = info->userops->write(info->volinfo, req->openinfo,
                                        req->wrdata, writelen);
+#endif
 
   /* Send the response */
 
@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/wqueue/work_cancel.c
  *
- *   Copyright (C) 2009-2010, 2012-2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2009-2010, 2012-2014, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -103,7 +104,7 @@ static int work_qcancel(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work
        * marked as available (i.e., the worker field is nullified).
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      work_remove(wqueue, work);
       work->worker = NULL;
       ret = OK;
     }
@@ -125,7 +126,8 @@ static int work_qcancel(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work
  *   by calling work_queue() again.
  *
  * Input Parameters:
- *   qid    - The work queue ID (must be USRWORK)
+ *   qid    - The work queue ID (USRWORK or a queue created with
+ *            work_usrcreate()).  Any priority lane of the queue will do.
  *   work   - The previously queue work structure to cancel
  *
  * Returned Value:
@@ -138,9 +140,11 @@ static int work_qcancel(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work
 
 int work_cancel(int qid, FAR struct work_s *work)
 {
-  if (qid == USRWORK)
+  FAR struct usr_wqueue_s *wqueue = work_usrqueue(qid);
+
+  if (wqueue != NULL)
     {
-      return work_qcancel(&g_usrwork, work);
+      return work_qcancel(wqueue, work);
     }
   else
     {
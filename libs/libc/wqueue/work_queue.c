@@ -1,7 +1,8 @@
 /****************************************************************************
  * libs/libc/wqueue/work_queue.c
  *
- *   Copyright (C) 2009-2011, 2014, 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2009-2011, 2014, 2016-2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -71,7 +72,8 @@
  *   and remove it from the work queue.
  *
  * Input Parameters:
- *   qid    - The work queue ID (index)
+ *   wqueue - The work queue
+ *   lane   - The priority lane of the work
  *   work   - The work structure to queue
  *   worker - The worker callback to be invoked.  The callback will invoked
  *            on the worker thread of execution.
@@ -85,10 +87,12 @@
  *
  ****************************************************************************/
 
-static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
+static int work_qqueue(FAR struct usr_wqueue_s *wqueue, int lane,
                        FAR struct work_s *work, worker_t worker,
                        FAR void *arg, clock_t delay)
 {
+  int ret;
+
   DEBUGASSERT(work != NULL);
 
   /* Get exclusive access to the work queue */
@@ -103,7 +107,7 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
        * end of the work queue.
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      work_remove(wqueue, work);
     }
 
   /* Initialize the work structure */
@@ -111,16 +115,17 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
   work->worker = worker;           /* Work callback. non-NULL means queued */
   work->arg    = arg;              /* Callback argument */
   work->delay  = delay;            /* Delay until work performed */
+  work->lane   = lane;             /* Priority lane */
 
   /* Now, time-tag that entry and put it in the work queue. */
 
   work->qtime  = clock(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
-  kill(wqueue->pid, SIGWORK);   /* Wake up the worker thread */
+  work_insert(wqueue, work);
+  ret = work_wakeup(wqueue);    /* Wake up an idle worker thread */
 
   work_unlock();
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -142,7 +147,9 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
  *   pending work will be canceled and lost.
  *
  * Input Parameters:
- *   qid    - The work queue ID (index)
+ *   qid    - The work queue ID (index).  USRWORK, a queue created with
+ *            work_usrcreate(), or a priority lane of either, see
+ *            WORK_LANE().
  *   work   - The work structure to queue
  *   worker - The worker callback to be invoked.  The callback will invoked
  *            on the worker thread of execution.
@@ -159,9 +166,11 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  if (qid == USRWORK)
+  FAR struct usr_wqueue_s *wqueue = work_usrqueue(qid);
+
+  if (wqueue != NULL)
     {
-      return work_qqueue(&g_usrwork, work, worker, arg, delay);
+      return work_qqueue(wqueue, WORK_QLANE(qid), work, worker, arg, delay);
     }
   else
     {
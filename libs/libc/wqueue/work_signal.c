@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/wqueue/work_signal.c
  *
- *   Copyright (C) 2009-2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2009-2014, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -75,9 +75,11 @@
  * Name: work_signal
  *
  * Description:
- *   Signal the worker thread to process the work queue now.  This function
- *   is used internally by the work logic but could also be used by the
- *   user to force an immediate re-assessment of pending work.
+ *   Signal a worker thread to process the work queue now.  This function
+ *   could be used by the user to force an immediate re-assessment of
+ *   pending work.  An idle worker thread is signaled; if none is idle, the
+ *   busy worker threads will re-assess the work when their current work is
+ *   done.
  *
  * Input Parameters:
  *   qid    - The work queue ID
@@ -89,22 +91,21 @@
 
 int work_signal(int qid)
 {
+  FAR struct usr_wqueue_s *wqueue = work_usrqueue(qid);
   int ret;
 
-  if (qid == USRWORK)
+  if (wqueue == NULL)
     {
-      /* Signal the worker thread */
-
-      ret = kill(g_usrwork.pid, SIGWORK);
-      if (ret < 0)
-        {
-          int errcode = get_errno();
-          ret = -errcode;
-        }
+      return -EINVAL;
     }
-  else
+
+  /* Signal an idle worker thread */
+
+  ret = work_lock();
+  if (ret >= 0)
     {
-      ret = -EINVAL;
+      ret = work_wakeup(wqueue);
+      work_unlock();
     }
 
   return ret;
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * libs/libc/wqueue/work_usrqueue.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#if defined(CONFIG_LIB_USRWORK) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The state of the private user mode work queues */
+
+#if CONFIG_LIB_USRWORKNQUEUES > 0
+struct usr_wqueue_s g_usrqueues[CONFIG_LIB_USRWORKNQUEUES];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_usrqueue
+ *
+ * Description:
+ *   Return the user-mode work queue with the ID 'qid'.
+ *
+ * Input Parameters:
+ *   qid - The work queue ID, see WORK_LANE()
+ *
+ * Returned Value:
+ *   The work queue or NULL if 'qid' is not valid.
+ *
+ ****************************************************************************/
+
+FAR struct usr_wqueue_s *work_usrqueue(int qid)
+{
+  int ndx;
+
+  if (qid < 0 || WORK_QLANE(qid) >= CONFIG_LIB_USRWORKNLANES)
+    {
+      return NULL;
+    }
+
+  ndx = WORK_QID(qid) - USRWORK;
+  if (ndx == 0)
+    {
+      return &g_usrwork;
+    }
+
+#if CONFIG_LIB_USRWORKNQUEUES > 0
+  /* Private queues are never deleted.  A queue exists once it has
+   * worker threads.
+   */
+
+  if (ndx > 0 && ndx <= CONFIG_LIB_USRWORKNQUEUES &&
+      g_usrqueues[ndx - 1].nthreads > 0)
+    {
+      return &g_usrqueues[ndx - 1];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: work_insert
+ *
+ * Description:
+ *   Add work to the end of its lane of the user-mode work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The work to add.  work->lane selects the lane.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+void work_insert(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work)
+{
+#if CONFIG_LIB_USRWORKNLANES > 1
+  FAR dq_entry_t *prev = NULL;
+  int lane;
+
+  /* The work goes after the last work of its own lane or, if that lane is
+   * empty, after the last work of the nearest higher lane.
+   */
+
+  for (lane = work->lane;
+       lane < CONFIG_LIB_USRWORKNLANES && prev == NULL;
+       lane++)
+    {
+      prev = wqueue->tail[lane];
+    }
+
+  if (prev != NULL)
+    {
+      dq_addafter(prev, (FAR dq_entry_t *)work, &wqueue->q);
+    }
+  else
+    {
+      dq_addfirst((FAR dq_entry_t *)work, &wqueue->q);
+    }
+
+  wqueue->tail[work->lane] = (FAR dq_entry_t *)work;
+#else
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_remove
+ *
+ * Description:
+ *   Remove work from the user-mode work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The queued work to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+void work_remove(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work)
+{
+#if CONFIG_LIB_USRWORKNLANES > 1
+  FAR struct work_s *prev;
+
+  if (wqueue->tail[work->lane] == (FAR dq_entry_t *)work)
+    {
+      /* The previous work becomes the last of the lane, unless it belongs
+       * to a higher lane.
+       */
+
+      prev = (FAR struct work_s *)work->dq.blink;
+      if (prev != NULL && prev->lane == work->lane)
+        {
+          wqueue->tail[work->lane] = (FAR dq_entry_t *)prev;
+        }
+      else
+        {
+          wqueue->tail[work->lane] = NULL;
+        }
+    }
+#endif
+
+  dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+}
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up one idle worker thread of the user-mode work queue.  Nothing
+ *   is done if no worker thread is idle:  The busy threads will re-assess
+ *   the work queue when their current work is done.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+int work_wakeup(FAR struct usr_wqueue_s *wqueue)
+{
+  int ndx;
+
+  for (ndx = 0; ndx < wqueue->nthreads; ndx++)
+    {
+      if ((wqueue->idle & (1ul << ndx)) != 0)
+        {
+          /* The thread is no longer idle once it has been signaled.  That
+           * keeps further work from waking up the same thread.
+           */
+
+          wqueue->idle &= ~(1ul << ndx);
+          if (kill(wqueue->pid[ndx], SIGWORK) < 0)
+            {
+              return -get_errno();
+            }
+
+          break;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_usrstats
+ *
+ * Description:
+ *   Return the deadline statistics of one lane of a user-mode work queue
+ *   and optionally reset them.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID, see WORK_LANE()
+ *   stats - The location to return the statistics
+ *   reset - True: Reset the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_usrstats(int qid, FAR struct work_stats_s *stats, bool reset)
+{
+  FAR struct usr_wqueue_s *wqueue;
+  FAR struct work_stats_s *lstats;
+  int ret;
+
+  wqueue = work_usrqueue(qid);
+  if (wqueue == NULL || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = work_lock();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  lstats = &wqueue->stats[WORK_QLANE(qid)];
+  memcpy(stats, lstats, sizeof(struct work_stats_s));
+
+  if (reset)
+    {
+      memset(lstats, 0, sizeof(struct work_stats_s));
+    }
+
+  work_unlock();
+  return OK;
+}
+
+#endif /* CONFIG_LIB_USRWORK && !__KERNEL__ */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libc/wqueue/work_usrthread.c
  *
- *   Copyright (C) 2009-2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2009-2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <signal.h>
@@ -115,15 +117,17 @@ pthread_mutex_t g_usrmutex;
  *
  * Input Parameters:
  *   wqueue - Describes the work queue to be processed
+ *   ndx    - The index of the calling worker thread
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void work_process(FAR struct usr_wqueue_s *wqueue)
+static void work_process(FAR struct usr_wqueue_s *wqueue, int ndx)
 {
   volatile FAR struct work_s *work;
+  FAR struct work_stats_s *stats;
   sigset_t sigset;
   sigset_t oldset;
   worker_t  worker;
@@ -148,6 +152,10 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
       return;
     }
 
+  /* This thread is busy until it has found no more ready work */
+
+  wqueue->idle &= ~(1ul << ndx);
+
   /* Set up the signal mask */
 
   sigemptyset(&sigset);
@@ -177,7 +185,7 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
         {
           /* Remove the ready-to-execute work from the list */
 
-          (void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
+          work_remove(wqueue, (FAR struct work_s *)work);
 
           /* Extract the work description from the entry (in case the work
            * instance by the re-used after it has been de-queued).
@@ -195,12 +203,26 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 
               arg = work->arg;
 
+              /* Account for how late the work is performed */
+
+              stats = &wqueue->stats[work->lane];
+              elapsed -= work->delay;
+
+              stats->nwork++;
+              stats->totallate += elapsed;
+              if (elapsed > stats->maxlate)
+                {
+                  stats->maxlate = elapsed;
+                }
+
               /* Mark the work as no longer being queued */
 
               work->worker = NULL;
 
               /* Do the work.  Unlock the work queue while the work is being
                * performed... we don't have any idea how long this will take!
+               * Meanwhile, the other worker threads continue with the
+               * remaining work.
                */
 
               work_unlock();
@@ -266,10 +288,12 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
   /* Unlock the work queue before waiting.  In order to assure that we do
    * not lose the SIGWORK signal before waiting, we block the SIGWORK
    * signals before unlocking the work queue.  That will cause in SIGWORK
-   * signals directed to the worker thread to pend.
+   * signals directed to the worker thread to pend.  Mark this thread as
+   * idle so that new work will wake it up.
    */
 
   (void)sigprocmask(SIG_BLOCK, &sigset, &oldset);
+  wqueue->idle |= (1ul << ndx);
   work_unlock();
 
   if (next == WORK_DELAY_MAX)
@@ -285,9 +309,11 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 
       /* Wait awhile to check the work list.  We will wait here until
        * either the time elapses or until we are awakened by a signal.
-       * Interrupts will be re-enabled while we wait.
+       * Interrupts will be re-enabled while we wait.  'next' is in clock
+       * ticks.
        */
 
+      next         = TICK2USEC(next);
       sec          = next / 1000000;
       rqtp.tv_sec  = sec;
       rqtp.tv_nsec = (next - (sec * 1000000)) * 1000;
@@ -310,7 +336,9 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
  *   application start-up logic by calling work_usrstart().
  *
  * Input Parameters:
- *   argc, argv (not used)
+ *   argc, argv - argv[1] holds the index of the work queue (zero for
+ *                USRWORK) and the index of the thread (protected build)
+ *   arg        - The same, as an integer (kernel build)
  *
  * Returned Value:
  *   Does not return
@@ -323,6 +351,22 @@ static int work_usrthread(int argc, char *argv[])
 static pthread_addr_t work_usrthread(pthread_addr_t arg)
 #endif
 {
+  FAR struct usr_wqueue_s *wqueue;
+  int id;
+
+#ifdef CONFIG_BUILD_PROTECTED
+  DEBUGASSERT(argc == 2);
+  id = atoi(argv[1]);
+#else
+  id = (int)((uintptr_t)arg);
+#endif
+
+#if CONFIG_LIB_USRWORKNQUEUES > 0
+  wqueue = (id >> 8) == 0 ? &g_usrwork : &g_usrqueues[(id >> 8) - 1];
+#else
+  wqueue = &g_usrwork;
+#endif
+
   /* Loop forever */
 
   for (; ; )
@@ -331,7 +375,7 @@ static pthread_addr_t work_usrthread(pthread_addr_t arg)
        * while we process items in the work list.
        */
 
-      work_process(&g_usrwork);
+      work_process(wqueue, id & 0xff);
     }
 
 #ifdef CONFIG_BUILD_PROTECTED
@@ -341,6 +385,112 @@ static pthread_addr_t work_usrthread(pthread_addr_t arg)
 #endif
 }
 
+/****************************************************************************
+ * Name: work_usrspawn
+ *
+ * Description:
+ *   Start the worker threads of a user mode work queue.
+ *
+ * Input Parameters:
+ *   wqueue    - The work queue
+ *   qndx      - The index of the work queue, zero for USRWORK
+ *   name      - The name of the worker threads
+ *   priority  - The priority of the worker threads
+ *   stacksize - The stack size of the worker threads
+ *   nthreads  - The number of worker threads
+ *
+ * Returned Value:
+ *   The task ID of the first worker thread is returned on success.  A
+ *   negated errno value is returned if no worker thread could be started.
+ *   If only some worker threads could be started, the work queue continues
+ *   with those.
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.  The new worker threads wait for
+ *   it before they look at the work queue.
+ *
+ ****************************************************************************/
+
+static int work_usrspawn(FAR struct usr_wqueue_s *wqueue, int qndx,
+                         FAR const char *name, int priority, int stacksize,
+                         int nthreads)
+{
+#ifdef CONFIG_BUILD_PROTECTED
+  FAR char *argv[2];
+  char arg1[16];
+  pid_t pid;
+#else
+  pthread_t usrwork;
+  pthread_attr_t attr;
+  struct sched_param param;
+#endif
+  int ret = OK;
+  int ndx;
+
+#ifndef CONFIG_BUILD_PROTECTED
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setstacksize(&attr, stacksize);
+
+#ifdef CONFIG_SCHED_SPORADIC
+  /* Get the current sporadic scheduling parameters.  Those will not be
+   * modified.
+   */
+
+  ret = sched_getparam(0, &param);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+#endif
+
+  param.sched_priority = priority;
+  (void)pthread_attr_setschedparam(&attr, &param);
+#else
+  UNUSED(name);
+#endif
+
+  for (ndx = 0; ndx < nthreads; ndx++)
+    {
+#ifdef CONFIG_BUILD_PROTECTED
+      /* Start a user-mode worker thread for use by applications. */
+
+      snprintf(arg1, sizeof(arg1), "%d", (qndx << 8) | ndx);
+      argv[0] = arg1;
+      argv[1] = NULL;
+
+      pid = task_create(name, priority, stacksize, (main_t)work_usrthread,
+                        (FAR char * const *)argv);
+      if (pid < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      wqueue->pid[ndx] = pid;
+#else
+      ret = pthread_create(&usrwork, &attr, work_usrthread,
+                           (pthread_addr_t)((uintptr_t)((qndx << 8) | ndx)));
+      if (ret != 0)
+        {
+          ret = -ret;
+          break;
+        }
+
+      /* Detach because the return value and completion status will not be
+       * requested.
+       */
+
+      (void)pthread_detach(usrwork);
+
+      wqueue->pid[ndx] = (pid_t)usrwork;
+#endif
+
+      wqueue->nthreads = ndx + 1;
+    }
+
+  return wqueue->nthreads > 0 ? wqueue->pid[0] : ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -355,86 +505,108 @@ static pthread_addr_t work_usrthread(pthread_addr_t arg)
  *   None
  *
  * Returned Value:
- *   The task ID of the worker thread is returned on success.  A negated
- *   errno value is returned on failure.
+ *   The task ID of the (first) worker thread is returned on success.  A
+ *   negated errno value is returned on failure.
  *
  ****************************************************************************/
 
 int work_usrstart(void)
 {
-  /* Initialize work queue data structures */
-
-#ifdef CONFIG_BUILD_PROTECTED
-  {
-    /* Set up the work queue lock */
-
-    (void)nxsem_init(&g_usrsem, 0, 1);
-
-    /* Start a user-mode worker thread for use by applications. */
-
-    g_usrwork.pid = task_create("uwork",
-                                CONFIG_LIB_USRWORKPRIORITY,
-                                CONFIG_LIB_USRWORKSTACKSIZE,
-                                (main_t)work_usrthread,
-                                (FAR char * const *)NULL);
+  int ret;
 
-    DEBUGASSERT(g_usrwork.pid > 0);
-    if (g_usrwork.pid < 0)
-      {
-        int errcode = get_errno();
-        DEBUGASSERT(errcode > 0);
-        return -errcode;
-      }
+  /* Set up the work queue lock */
 
-    return g_usrwork.pid;
-  }
+#ifdef CONFIG_BUILD_PROTECTED
+  (void)nxsem_init(&g_usrsem, 0, 1);
 #else
-  {
-    pthread_t usrwork;
-    pthread_attr_t attr;
-    struct sched_param param;
-    int ret;
+  (void)pthread_mutex_init(&g_usrmutex, NULL);
+#endif
 
-    /* Set up the work queue lock */
+  /* Start the worker threads for use by applications */
 
-    (void)pthread_mutex_init(&g_usrmutex, NULL);
+  while (work_lock() < 0);
+  ret = work_usrspawn(&g_usrwork, 0, "uwork", CONFIG_LIB_USRWORKPRIORITY,
+                      CONFIG_LIB_USRWORKSTACKSIZE,
+                      CONFIG_LIB_USRWORKNTHREADS);
+  work_unlock();
 
-    /* Start a user-mode worker thread for use by applications. */
+  DEBUGASSERT(ret > 0);
+  return ret;
+}
 
-    (void)pthread_attr_init(&attr);
-    (void)pthread_attr_setstacksize(&attr, CONFIG_LIB_USRWORKSTACKSIZE);
+/****************************************************************************
+ * Name: work_usrcreate
+ *
+ * Description:
+ *   Create a private user-mode work queue for an application subsystem.
+ *   The queue has its own worker threads and exists until the process
+ *   exits.  Up to CONFIG_LIB_USRWORKNQUEUES queues may be created.
+ *
+ * Input Parameters:
+ *   name      - The name of the worker threads
+ *   priority  - The priority of the worker threads
+ *   stacksize - The stack size of the worker threads
+ *   nthreads  - The number of worker threads, at most
+ *               CONFIG_LIB_USRWORKNTHREADS
+ *
+ * Returned Value:
+ *   The work queue ID to be used with work_queue() and the other work
+ *   queue interfaces is returned on success.  A negated errno value is
+ *   returned on failure.
+ *
+ * Assumptions:
+ *   work_usrstart() has been called.
+ *
+ ****************************************************************************/
 
-#ifdef CONFIG_SCHED_SPORADIC
-    /* Get the current sporadic scheduling parameters.  Those will not be
-     * modified.
-     */
-
-    ret = set_getparam(pid, &param);
-    if (ret < 0)
-      {
-        int erroode = get_errno();
-        return -errcode;
-      }
-#endif
+int work_usrcreate(FAR const char *name, int priority, int stacksize,
+                   int nthreads)
+{
+#if CONFIG_LIB_USRWORKNQUEUES > 0
+  int ret;
+  int ndx;
 
-    param.sched_priority = CONFIG_LIB_USRWORKPRIORITY;
-    (void)pthread_attr_setschedparam(&attr, &param);
+  if (nthreads < 1 || nthreads > CONFIG_LIB_USRWORKNTHREADS)
+    {
+      return -EINVAL;
+    }
+
+  ret = work_lock();
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-    ret = pthread_create(&usrwork, &attr, work_usrthread, NULL);
-    if (ret != 0)
-      {
-        return -ret;
-      }
+  /* Find an unused queue.  Queues are never deleted. */
 
-    /* Detach because the return value and completion status will not be
-     * requested.
-     */
+  for (ndx = 0; ndx < CONFIG_LIB_USRWORKNQUEUES; ndx++)
+    {
+      if (g_usrqueues[ndx].nthreads == 0)
+        {
+          break;
+        }
+    }
 
-    (void)pthread_detach(usrwork);
+  if (ndx >= CONFIG_LIB_USRWORKNQUEUES)
+    {
+      ret = -ENOSPC;
+    }
+  else
+    {
+      ret = work_usrspawn(&g_usrqueues[ndx], ndx + 1,
+                          name != NULL ? name : "uwork", priority,
+                          stacksize > 0 ? stacksize :
+                          CONFIG_LIB_USRWORKSTACKSIZE, nthreads);
+      if (ret >= 0)
+        {
+          ret = USRWORK + ndx + 1;
+        }
+    }
 
-    g_usrwork.pid = (pid_t)usrwork;
-    return g_usrwork.pid;
-  }
+  work_unlock();
+  return ret;
+#else
+  return -ENOSYS;
 #endif
 }
 
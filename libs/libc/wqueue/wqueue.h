@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/libs/libc/wqueue.h
  *
- *   Copyright (C) 2014, 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2014, 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <semaphore.h>
 #include <pthread.h>
 
@@ -53,16 +54,37 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Decode a work queue ID, see WORK_LANE() */
+
+#define WORK_QID(qid)   ((qid) & 0xff)
+#define WORK_QLANE(qid) ((unsigned int)(qid) >> 8)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
-/* This structure defines the state of one user-modework queue. */
+/* This structure defines the state of one user-mode work queue.
+ *
+ * The pending work is kept in one list, ordered by priority lane with the
+ * highest lane at the head.  Within a lane, work is kept in the order that
+ * it was queued.  Since the worker threads always scan the list from the
+ * head, ready work of a higher lane is always performed first.
+ *
+ * All worker threads of the queue take work from the same list.  A worker
+ * thread that finds no ready work marks itself idle before it waits; new
+ * work wakes up only one of the idle threads.
+ */
 
 struct usr_wqueue_s
 {
   struct dq_queue_s q;      /* The queue of pending work */
-  pid_t             pid;    /* The task ID of the worker thread(s) */
+#if CONFIG_LIB_USRWORKNLANES > 1
+  FAR dq_entry_t *tail[CONFIG_LIB_USRWORKNLANES]; /* Last work of each lane */
+#endif
+  uint8_t nthreads;         /* Number of worker threads */
+  uint32_t idle;            /* Bit set of the idle worker threads */
+  pid_t pid[CONFIG_LIB_USRWORKNTHREADS]; /* Task IDs of the worker threads */
+  struct work_stats_s stats[CONFIG_LIB_USRWORKNLANES]; /* Lane statistics */
 };
 
 /****************************************************************************
@@ -73,6 +95,12 @@ struct usr_wqueue_s
 
 extern struct usr_wqueue_s g_usrwork;
 
+/* The state of the private user mode work queues */
+
+#if CONFIG_LIB_USRWORKNQUEUES > 0
+extern struct usr_wqueue_s g_usrqueues[CONFIG_LIB_USRWORKNQUEUES];
+#endif
+
 /* This semaphore/mutex supports exclusive access to the user-mode work queue */
 
 #ifdef CONFIG_BUILD_PROTECTED
@@ -120,5 +148,82 @@ int work_lock(void);
 
 void work_unlock(void);
 
+/****************************************************************************
+ * Name: work_usrqueue
+ *
+ * Description:
+ *   Return the user-mode work queue with the ID 'qid'.
+ *
+ * Input Parameters:
+ *   qid - The work queue ID, see WORK_LANE()
+ *
+ * Returned Value:
+ *   The work queue or NULL if 'qid' is not valid.
+ *
+ ****************************************************************************/
+
+FAR struct usr_wqueue_s *work_usrqueue(int qid);
+
+/****************************************************************************
+ * Name: work_insert
+ *
+ * Description:
+ *   Add work to the end of its lane of the user-mode work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The work to add.  work->lane selects the lane.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+void work_insert(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work);
+
+/****************************************************************************
+ * Name: work_remove
+ *
+ * Description:
+ *   Remove work from the user-mode work queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The queued work to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+void work_remove(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work);
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up one idle worker thread of the user-mode work queue.  Nothing
+ *   is done if no worker thread is idle:  The busy threads will re-assess
+ *   the work queue when their current work is done.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+int work_wakeup(FAR struct usr_wqueue_s *wqueue);
+
 #endif /* CONFIG_LIB_USRWORK && !__KERNEL__*/
 #endif /* __LIBC_WQUEUE_WQUEUE_H */
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * libs/libdsp/lib_foc_b16.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_current_control_b16
+ *
+ * Description:
+ *   This function implements FOC current control algorithm.
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the FOC data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void foc_current_control_b16(FAR struct foc_data_b16_s *foc)
+{
+  FAR dq_frame_b16_t *v_dq = &foc->v_dq;
+
+  /* Get dq current error */
+
+  foc->i_dq_err.d = foc->i_dq_ref.d - foc->i_dq.d;
+  foc->i_dq_err.q = foc->i_dq_ref.q - foc->i_dq.q;
+
+  /* PI controllers for d-current (flux loop) and q-current (torque loop) */
+
+  v_dq->d = pi_controller_b16(&foc->id_pid, foc->i_dq_err.d);
+  v_dq->q = pi_controller_b16(&foc->iq_pid, foc->i_dq_err.q);
+
+  /* Saturate voltage DQ vector */
+
+  dq_saturate_b16(v_dq, foc->vdq_mag_max);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_init_b16
+ *
+ * Description:
+ *   Initialize FOC controller
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the FOC data
+ *   id_kp - (in) KP for d current
+ *   id_ki - (in) KI for d current
+ *   iq_kp - (in) KP for q current
+ *   iq_ki - (in) KI for q current
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_init_b16(FAR struct foc_data_b16_s *foc,
+                  b16_t id_kp, b16_t id_ki, b16_t iq_kp, b16_t iq_ki)
+{
+  /* Reset data */
+
+  memset(foc, 0, sizeof(struct foc_data_b16_s));
+
+  /* Initialize PI current d and q component */
+
+  pi_controller_init_b16(&foc->id_pid, id_kp, id_ki);
+  pi_controller_init_b16(&foc->iq_pid, iq_kp, iq_ki);
+}
+
+/****************************************************************************
+ * Name: foc_idq_ref_set_b16
+ *
+ * Description:
+ *   Set dq reference current vector
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the FOC data
+ *   d   - (in) reference d current
+ *   q   - (in) reference q current
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_idq_ref_set_b16(FAR struct foc_data_b16_s *foc, b16_t d, b16_t q)
+{
+  foc->i_dq_ref.d = d;
+  foc->i_dq_ref.q = q;
+}
+
+/****************************************************************************
+ * Name: foc_vbase_update_b16
+ *
+ * Description:
+ *  Update base voltage for FOC controller
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the FOC data
+ *   vbase - (in) base voltage for FOC
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_vbase_update_b16(FAR struct foc_data_b16_s *foc, b16_t vbase)
+{
+  b16_t scale   = 0;
+  b16_t mag_max = 0;
+
+  /* Only if voltage is valid */
+
+  if (vbase > 0)
+    {
+      scale   = b16divb16(b16ONE, vbase);
+      mag_max = vbase;
+    }
+
+  foc->vab_mod_scale = scale;
+  foc->vdq_mag_max   = mag_max;
+
+  /* Update regulators saturation */
+
+  if (mag_max > 0)
+    {
+      pi_saturation_set_b16(&foc->id_pid, -mag_max, mag_max);
+      pi_saturation_set_b16(&foc->iq_pid, -mag_max, mag_max);
+    }
+}
+
+/****************************************************************************
+ * Name: foc_process_b16
+ *
+ * Description:
+ *   Process FOC (Field Oriented Control)
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the FOC data
+ *   i_abc - (in) pointer to the ABC current frame
+ *   angle - (in) pointer to the phase angle data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_process_b16(FAR struct foc_data_b16_s *foc,
+                     FAR abc_frame_b16_t *i_abc,
+                     FAR phase_angle_b16_t *angle)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(i_abc != NULL);
+  DEBUGASSERT(angle != NULL);
+
+  /* Copy ABC current to foc data */
+
+  foc->i_abc = *i_abc;
+
+  /* abc current -> alpha-beta current -> dq current */
+
+  clarke_transform_b16(&foc->i_abc, &foc->i_ab);
+  park_transform_b16(angle, &foc->i_ab, &foc->i_dq);
+
+  /* Run FOC current control (current dq -> voltage dq) */
+
+  foc_current_control_b16(foc);
+
+  /* Inverse Park tranform (voltage dq -> voltage alpha-beta) */
+
+  inv_park_transform_b16(angle, &foc->v_dq, &foc->v_ab);
+
+  /* Normalize the alpha-beta voltage to get the modulation voltage */
+
+  foc->v_ab_mod.a = b16mulb16(foc->v_ab.a, foc->vab_mod_scale);
+  foc->v_ab_mod.b = b16mulb16(foc->v_ab.b, foc->vab_mod_scale);
+}
@@ -1,7 +1,7 @@
 /****************************************************************************
  * control/lib_misc.c
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Mateusz Szafoni <raiden00@railab.me>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -80,6 +80,44 @@ void f_saturate(FAR float *val, float min, float max)
     }
 }
 
+/****************************************************************************
+ * Name: lp_filter_n
+ *
+ * Description:
+ *   Filter a block of samples with the single-pole low pass filter of
+ *   LP_FILTER().
+ *
+ * Input Parameters:
+ *   val    - (in/out) pointer to the filter state (the last output)
+ *   in     - (in) array of input samples
+ *   out    - (out) array of filtered samples.  May be the same as 'in'.
+ *   filter - (in) filter coefficient, see LP_FILTER()
+ *   n      - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void lp_filter_n(FAR float *val, FAR const float *in, FAR float *out,
+                 float filter, int n)
+{
+  float y;
+  int i;
+
+  DEBUGASSERT(val != NULL && in != NULL && out != NULL);
+
+  y = *val;
+
+  for (i = 0; i < n; i++)
+    {
+      y     -= filter * (y - in[i]);
+      out[i] = y;
+    }
+
+  *val = y;
+}
+
 /****************************************************************************
  * Name: vector2d_mag
  *
@@ -1,7 +1,7 @@
 /****************************************************************************
  * control/lib_observer.c
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Mateusz Szafoni <raiden00@railab.me>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -49,6 +49,110 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: motor_observer_smo_gains
+ *
+ * Description:
+ *   Calculate the SMO gains and the low pass filter coefficients for the
+ *   current speed and motor parameters.
+ *
+ ****************************************************************************/
+
+static void motor_observer_smo_gains(FAR struct motor_observer_s *o,
+                                     FAR struct motor_observer_smo_s *smo,
+                                     FAR struct motor_phy_params_s *phy)
+{
+  float filter;
+
+  /* Calculate observer gains */
+
+  smo->F_gain = (1.0f - o->per*phy->res*phy->one_by_ind);
+  smo->G_gain = o->per*phy->one_by_ind;
+
+  /* Saturate F gain */
+
+  if (smo->F_gain < 0.0f)
+    {
+      smo->F_gain = 0.0f;
+    }
+
+  /* Saturate G gain */
+
+  if (smo->G_gain > 0.999f)
+    {
+      smo->G_gain = 0.999f;
+    }
+
+  /* Configure low pass filters
+   *
+   * We tune low-pass filters to achieve cutoff frequency equal to
+   * input singal frequency. This gives us constant phase shift between
+   * input and outpu signals equals to:
+   *
+   *   phi = -arctan(f_in/f_c) = -arctan(1) = -45deg = -PI/4
+   *
+   * Input signal frequency is equal to the frequency of the motor currents,
+   * which give us:
+   *
+   *   f_c = omega_e/(2*PI)
+   *   omega_m = omega_e/pole_pairs
+   *   f_c = omega_m*pole_pairs/(2*PI)
+   *
+   *   filter = T * (2*PI) * f_c
+   *   filter = T * omega_m * pole_pairs
+   *
+   *   T          - [s] period at which the digital filter is being calculated
+   *   f_in       - [Hz] input frequency of the filter
+   *   f_c        - [Hz] cutoff frequency of the filter
+   *   omega_m    - [rad/s] mechanical angular velocity
+   *   omega_e    - [rad/s] electrical angular velocity
+   *   pole_pairs - pole pairs
+   *
+   */
+
+  filter = o->per * o->speed * phy->p;
+
+  /* Limit SMO filters
+   * REVISIT: lowest filter limit should depend on minimum speed:
+   *          filter = T * (2*PI) * f_c = T * omega0
+   *
+   */
+
+  if (filter >= 1.0f)
+    {
+      filter = 0.99f;
+    }
+  else if (filter <= 0.0f)
+    {
+      filter = 0.005f;
+    }
+
+  smo->emf_lp_filter1 = filter;
+  smo->emf_lp_filter2 = smo->emf_lp_filter1;
+}
+
+/****************************************************************************
+ * Name: motor_observer_smo_z
+ *
+ * Description:
+ *   The SMO correction factor for a current error.  This is the same as
+ *   the linear and the non-linear cases in motor_observer_smo(), without
+ *   branches:  The error scaled to the linear region is saturated to
+ *   <-1.0, 1.0>.
+ *
+ ****************************************************************************/
+
+static inline float motor_observer_smo_z(float err, float k_slide,
+                                         float one_by_err_max)
+{
+  float x = err * one_by_err_max;
+
+  x = x > 1.0f ? 1.0f : x;
+  x = x < -1.0f ? -1.0f : x;
+
+  return x * k_slide;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -207,75 +311,12 @@ void motor_observer_smo(FAR struct motor_observer_s *o, FAR ab_frame_t *i_ab,
   float i_err_a_abs  = 0.0f;
   float i_err_b_abs  = 0.0f;
   float angle        = 0.0f;
-  float filter       = 0.0f;
 
   /* REVISIT: observer works only when IQ current is high enough */
 
-  /* Calculate observer gains */
-
-  smo->F_gain = (1.0f - o->per*phy->res*phy->one_by_ind);
-  smo->G_gain = o->per*phy->one_by_ind;
-
-  /* Saturate F gain */
-
-  if (smo->F_gain < 0.0f)
-    {
-      smo->F_gain = 0.0f;
-    }
-
-  /* Saturate G gain */
-
-  if (smo->G_gain > 0.999f)
-    {
-      smo->G_gain = 0.999f;
-    }
-
-  /* Configure low pass filters
-   *
-   * We tune low-pass filters to achieve cutoff frequency equal to
-   * input singal frequency. This gives us constant phase shift between
-   * input and outpu signals equals to:
-   *
-   *   phi = -arctan(f_in/f_c) = -arctan(1) = -45deg = -PI/4
-   *
-   * Input signal frequency is equal to the frequency of the motor currents,
-   * which give us:
-   *
-   *   f_c = omega_e/(2*PI)
-   *   omega_m = omega_e/pole_pairs
-   *   f_c = omega_m*pole_pairs/(2*PI)
-   *
-   *   filter = T * (2*PI) * f_c
-   *   filter = T * omega_m * pole_pairs
-   *
-   *   T          - [s] period at which the digital filter is being calculated
-   *   f_in       - [Hz] input frequency of the filter
-   *   f_c        - [Hz] cutoff frequency of the filter
-   *   omega_m    - [rad/s] mechanical angular velocity
-   *   omega_e    - [rad/s] electrical angular velocity
-   *   pole_pairs - pole pairs
-   *
-   */
-
-  filter = o->per * o->speed * phy->p;
+  /* Calculate observer gains and configure low pass filters */
 
-  /* Limit SMO filters
-   * REVISIT: lowest filter limit should depend on minimum speed:
-   *          filter = T * (2*PI) * f_c = T * omega0
-   *
-   */
-
-  if (filter >= 1.0f)
-    {
-      filter = 0.99f;
-    }
-  else if (filter <= 0.0f)
-    {
-      filter = 0.005f;
-    }
-
-  smo->emf_lp_filter1 = filter;
-  smo->emf_lp_filter2 = smo->emf_lp_filter1;
+  motor_observer_smo_gains(o, smo, phy);
 
   /* Get voltage error: v_err = v_ab - emf */
 
@@ -380,6 +421,142 @@ void motor_observer_smo(FAR struct motor_observer_s *o, FAR ab_frame_t *i_ab,
   o->angle = angle;
 }
 
+/****************************************************************************
+ * Name: motor_observer_smo_n
+ *
+ * Description:
+ *   Run the SMO observer on a block of n consecutive samples.  This gives
+ *   the same results as n calls of motor_observer_smo(), except that the
+ *   gains and the filter coefficients are calculated only once for the
+ *   block at the speed estimated before the block.  The inner loop works
+ *   on local copies of the observer state and has no data dependent
+ *   branches apart from those in fast_atan2().
+ *
+ * Input Parameters:
+ *   o      - (in/out) pointer to the common observer data
+ *   i_ab   - (in) array of n inverter alpha-beta currents
+ *   v_ab   - (in) array of n inverter alpha-beta voltages
+ *   phy    - (in) pointer to the motor physical parameters
+ *   dir    - (in) rotation direction (1.0 for CW, -1.0 for CCW)
+ *   angle  - (out) array of n estimated angles or NULL.  The last angle is
+ *            stored in the observer data in any case.
+ *   n      - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void motor_observer_smo_n(FAR struct motor_observer_s *o,
+                          FAR const ab_frame_t *i_ab,
+                          FAR const ab_frame_t *v_ab,
+                          FAR struct motor_phy_params_s *phy, float dir,
+                          FAR float *angle, int n)
+{
+  FAR struct motor_observer_smo_s *smo;
+  ab_frame_t i_est;
+  ab_frame_t i_err;
+  ab_frame_t emf;
+  ab_frame_t emf_f;
+  ab_frame_t z;
+  float one_by_err_max;
+  float filter1;
+  float filter2;
+  float th;
+  int i;
+
+  DEBUGASSERT(o != NULL);
+  DEBUGASSERT(i_ab != NULL);
+  DEBUGASSERT(v_ab != NULL);
+  DEBUGASSERT(phy != NULL);
+
+  if (n <= 0)
+    {
+      return;
+    }
+
+  smo = (FAR struct motor_observer_smo_s *)o->ao;
+
+  /* Calculate the coefficients once for the whole block */
+
+  motor_observer_smo_gains(o, smo, phy);
+
+  one_by_err_max = 1.0f / smo->err_max;
+  filter1        = smo->emf_lp_filter1;
+  filter2        = smo->emf_lp_filter2;
+
+  i_est = smo->i_est;
+  emf   = smo->emf;
+  emf_f = smo->emf_f;
+  z     = smo->z;
+
+  for (i = 0; i < n; i++)
+    {
+      /* Estimate stator current from v_err = v_ab - emf */
+
+      i_est.a = smo->F_gain * i_est.a +
+                smo->G_gain * (v_ab[i].a - emf.a - z.a);
+      i_est.b = smo->F_gain * i_est.b +
+                smo->G_gain * (v_ab[i].b - emf.b - z.b);
+
+      /* Slide-mode controller */
+
+      i_err.a = i_ab[i].a - i_est.a;
+      i_err.b = i_ab[i].b - i_est.b;
+
+      z.a = motor_observer_smo_z(i_err.a, smo->k_slide, one_by_err_max);
+      z.b = motor_observer_smo_z(i_err.b, smo->k_slide, one_by_err_max);
+
+      /* Filter z twice to obtain estimated emf */
+
+      LP_FILTER(emf.a, z.a, filter1);
+      LP_FILTER(emf.b, z.b, filter1);
+
+      LP_FILTER(emf_f.a, emf.a, filter2);
+      LP_FILTER(emf_f.b, emf.b, filter2);
+
+      if (angle != NULL)
+        {
+          th = fast_atan2(-emf.a, emf.b) + dir * M_PI_2_F;
+          angle[i] = th < 0.0f ? th + 2.0f*M_PI_F : th;
+        }
+    }
+
+  /* Drop invalid values.  Unlike motor_observer_smo(), this is done once
+   * for the whole block.
+   */
+
+  if (emf.a != emf.a) emf.a = 0.0f;
+  if (emf.b != emf.b) emf.b = 0.0f;
+  if (z.a != z.a) z.a = 0.0f;
+  if (z.b != z.b) z.b = 0.0f;
+  if (i_est.a != i_est.a) i_est.a = 0.0f;
+  if (i_est.b != i_est.b) i_est.b = 0.0f;
+
+  /* Store the state of the last sample */
+
+  smo->i_est   = i_est;
+  smo->i_err   = i_err;
+  smo->emf     = emf;
+  smo->emf_f   = emf_f;
+  smo->z       = z;
+  smo->v_err.a = v_ab[n - 1].a - emf.a;
+  smo->v_err.b = v_ab[n - 1].b - emf.b;
+  smo->sign.a  = i_err.a > 0.0f ? 1.0f : -1.0f;
+  smo->sign.b  = i_err.b > 0.0f ? 1.0f : -1.0f;
+
+  th = fast_atan2(-emf.a, emf.b);
+  if (th != th)
+    {
+      th = 0.0f;
+    }
+
+  th = th + dir * M_PI_2_F;
+  angle_norm_2pi(&th, 0.0f, 2.0f*M_PI_F);
+
+  o->angle = th;
+}
+
 /****************************************************************************
  * Name: motor_sobserver_div_init
  *
@@ -519,6 +696,75 @@ void motor_sobserver_div(FAR struct motor_observer_s *o,
   so->angle_prev = angle;
 }
 
+/****************************************************************************
+ * Name: motor_sobserver_div_n
+ *
+ * Description:
+ *   Run the DIV speed observer on a block of n consecutive mechanical
+ *   angle samples.  This gives the same results as n calls of
+ *   motor_sobserver_div().  The boundary crossing correction does not
+ *   branch on the rotation direction.
+ *
+ * Input Parameters:
+ *   o      - (in/out) pointer to the common observer data
+ *   angle  - (in) array of n mechanical angles normalized to <0.0, 2PI>
+ *   dir    - (in) mechanical rotation direction. Valid values:
+ *                 DIR_CW (1.0f) or DIR_CCW(-1.0f)
+ *   n      - (in) number of samples
+ *
+ ****************************************************************************/
+
+void motor_sobserver_div_n(FAR struct motor_observer_s *o,
+                           FAR const float *angle, float dir, int n)
+{
+  FAR struct motor_sobserver_div_s *so;
+  float correction = dir*2*M_PI_F;
+  float prev;
+  float acc;
+  float cntr;
+  float diff = 0.0f;
+  int i;
+
+  DEBUGASSERT(o != NULL);
+  DEBUGASSERT(angle != NULL);
+  DEBUGASSERT(dir == DIR_CW || dir == DIR_CCW);
+
+  so   = (FAR struct motor_sobserver_div_s *)o->so;
+  prev = so->angle_prev;
+  acc  = so->angle_acc;
+  cntr = so->cntr;
+
+  for (i = 0; i < n; i++)
+    {
+      /* Get the absolute angle difference, corrected if we crossed the
+       * angle boundary in the direction of the rotation.
+       */
+
+      diff = angle[i] - prev;
+      diff = (dir * diff < -ANGLE_DIFF_THR) ? diff + correction : diff;
+      diff = fabsf(diff);
+
+      acc  += diff;
+      cntr += 1;
+      prev  = angle[i];
+
+      if (cntr >= so->samples)
+        {
+          /* See motor_sobserver_div() */
+
+          LP_FILTER(o->speed, acc*so->one_by_dt, so->filter);
+
+          cntr = 0;
+          acc  = 0.0f;
+        }
+    }
+
+  so->angle_diff = diff;
+  so->angle_prev = prev;
+  so->angle_acc  = acc;
+  so->cntr       = cntr;
+}
+
 /****************************************************************************
  * Name: motor_observer_speed_get
  *
@@ -0,0 +1,271 @@
+/****************************************************************************
+ * libs/libdsp/lib_pid_b16.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pid_controller_init_b16
+ *
+ * Description:
+ *   Initialize PID controller. This function does not initialize saturation
+ *   limits.
+ *
+ * Input Parameters:
+ *   pid - (out) pointer to the PID controller data
+ *   KP  - (in) proportional gain
+ *   KI  - (in) integral gain
+ *   KD  - (in) derivative gain
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pid_controller_init_b16(FAR pid_controller_b16_t *pid, b16_t KP,
+                             b16_t KI, b16_t KD)
+{
+  DEBUGASSERT(pid != NULL);
+
+  /* Reset controller data */
+
+  memset(pid, 0, sizeof(pid_controller_b16_t));
+
+  /* Copy controller parameters */
+
+  pid->KP = KP;
+  pid->KI = KI;
+  pid->KD = KD;
+}
+
+/****************************************************************************
+ * Name: pi_controller_init_b16
+ *
+ * Description:
+ *   Initialize PI controller. This function does not initialize saturation
+ *   limits.
+ *
+ * Input Parameters:
+ *   pid - (out) pointer to the PID controller data
+ *   KP  - (in) proportional gain
+ *   KI  - (in) integral gain
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_init_b16(FAR pid_controller_b16_t *pid, b16_t KP,
+                            b16_t KI)
+{
+  pid_controller_init_b16(pid, KP, KI, 0);
+}
+
+/****************************************************************************
+ * Name: pid_saturation_set_b16
+ *
+ * Description:
+ *   Set controller saturation limits.
+ *
+ * Input Parameters:
+ *   pid - (out) pointer to the PID controller data
+ *   min - (in) lower limit
+ *   max - (in) upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pid_saturation_set_b16(FAR pid_controller_b16_t *pid, b16_t min,
+                            b16_t max)
+{
+  DEBUGASSERT(pid != NULL);
+  DEBUGASSERT(min < max);
+
+  pid->sat.max = max;
+  pid->sat.min = min;
+}
+
+/****************************************************************************
+ * Name: pi_saturation_set_b16
+ ****************************************************************************/
+
+void pi_saturation_set_b16(FAR pid_controller_b16_t *pid, b16_t min,
+                           b16_t max)
+{
+  pid_saturation_set_b16(pid, min, max);
+}
+
+/****************************************************************************
+ * Name: pid_integral_reset_b16
+ ****************************************************************************/
+
+void pid_integral_reset_b16(FAR pid_controller_b16_t *pid)
+{
+  pid->part[1] = 0;
+}
+
+/****************************************************************************
+ * Name: pi_integral_reset_b16
+ ****************************************************************************/
+
+void pi_integral_reset_b16(FAR pid_controller_b16_t *pid)
+{
+  pid_integral_reset_b16(pid);
+}
+
+/****************************************************************************
+ * Name: pi_controller_b16
+ *
+ * Description:
+ *   PI controller with output saturation and windup protection
+ *
+ * Input Parameters:
+ *   pid - (in/out) pointer to the PI controller data
+ *   err - (in) current controller error
+ *
+ * Returned Value:
+ *   Return controller output.
+ *
+ ****************************************************************************/
+
+b16_t pi_controller_b16(FAR pid_controller_b16_t *pid, b16_t err)
+{
+  DEBUGASSERT(pid != NULL);
+
+  /* Store error in controller structure */
+
+  pid->err = err;
+
+  /* Get proportional and integral parts */
+
+  pid->part[0]  = b16mulb16(pid->KP, err);
+  pid->part[1] += b16mulb16(pid->KI, err);
+
+  /* Add proportional, integral */
+
+  pid->out = pid->part[0] + pid->part[1];
+
+  /* Saturate output only if we are not in a PID calculation and only
+   * if some limits are set. Saturation for a PID controller are done later
+   * in PID routine.
+   */
+
+  if (pid->sat.max != pid->sat.min && pid->KD == 0)
+    {
+      if (pid->out > pid->sat.max)
+        {
+          /* Limit output to the upper limit */
+
+          pid->out = pid->sat.max;
+
+          /* Integral anti-windup - reset integral part */
+
+          if (err > 0)
+            {
+              pi_integral_reset_b16(pid);
+            }
+        }
+      else if (pid->out < pid->sat.min)
+        {
+          /* Limit output to the lower limit */
+
+          pid->out = pid->sat.min;
+
+          /* Integral anti-windup - reset integral part */
+
+          if (err < 0)
+            {
+              pi_integral_reset_b16(pid);
+            }
+        }
+    }
+
+  /* Return regulator output */
+
+  return pid->out;
+}
+
+/****************************************************************************
+ * Name: pid_controller_b16
+ *
+ * Description:
+ *   PID controller with output saturation and windup protection
+ *
+ * Input Parameters:
+ *   pid - (in/out) pointer to the PID controller data
+ *   err - (in) current controller error
+ *
+ * Returned Value:
+ *   Return controller output.
+ *
+ ****************************************************************************/
+
+b16_t pid_controller_b16(FAR pid_controller_b16_t *pid, b16_t err)
+{
+  DEBUGASSERT(pid != NULL);
+
+  /* Get PI output */
+
+  pi_controller_b16(pid, err);
+
+  /* Get derivative part and add it to the PI part */
+
+  pid->part[2]  = b16mulb16(pid->KD, err - pid->err_prev);
+  pid->out     += pid->part[2];
+
+  /* Store current error */
+
+  pid->err_prev = err;
+
+  /* Saturate output if limits are set */
+
+  if (pid->sat.max != pid->sat.min)
+    {
+      b16_saturate(&pid->out, pid->sat.min, pid->sat.max);
+    }
+
+  /* Return regulator output */
+
+  return pid->out;
+}
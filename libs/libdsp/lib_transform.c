@@ -1,7 +1,7 @@
 /****************************************************************************
  * control/lib_transform.c
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Mateusz Szafoni <raiden00@railab.me>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -162,3 +162,154 @@ void inv_park_transform(FAR phase_angle_t *angle,
   ab->a = angle->cos * dq->d - angle->sin * dq->q;
   ab->b = angle->cos * dq->q + angle->sin * dq->d;
 }
+
+/****************************************************************************
+ * Name: clarke_transform_n
+ *
+ * Description:
+ *   Clarke transform of n channels (for example n motors).  The components
+ *   of each frame are passed as separate arrays.  The c component is not
+ *   needed for a balanced system.  See clarke_transform().
+ *
+ * Input Parameters:
+ *   a     - (in) array of the a components
+ *   b     - (in) array of the b components
+ *   alpha - (out) array of the alpha components
+ *   beta  - (out) array of the beta components
+ *   n     - (in) number of channels
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_n(FAR const float *a, FAR const float *b,
+                        FAR float *alpha, FAR float *beta, int n)
+{
+  int i;
+
+  DEBUGASSERT(a != NULL && b != NULL && alpha != NULL && beta != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      beta[i]  = ONE_BY_SQRT3_F*a[i] + TWO_BY_SQRT3_F*b[i];
+      alpha[i] = a[i];
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_n
+ *
+ * Description:
+ *   Inverse Clarke transform of n channels.  See inv_clarke_transform().
+ *
+ * Input Parameters:
+ *   alpha - (in) array of the alpha components
+ *   beta  - (in) array of the beta components
+ *   a     - (out) array of the a components
+ *   b     - (out) array of the b components
+ *   c     - (out) array of the c components
+ *   n     - (in) number of channels
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_n(FAR const float *alpha, FAR const float *beta,
+                            FAR float *a, FAR float *b, FAR float *c,
+                            int n)
+{
+  int i;
+
+  DEBUGASSERT(alpha != NULL && beta != NULL);
+  DEBUGASSERT(a != NULL && b != NULL && c != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float va = alpha[i];
+      float vb = -0.5f*va + SQRT3_BY_TWO_F*beta[i];
+
+      a[i] = va;
+      b[i] = vb;
+      c[i] = -va - vb;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_n
+ *
+ * Description:
+ *   Park transform of n channels.  See park_transform().
+ *
+ * Input Parameters:
+ *   sin   - (in) array of the phase angle sines
+ *   cos   - (in) array of the phase angle cosines
+ *   alpha - (in) array of the alpha components
+ *   beta  - (in) array of the beta components
+ *   d     - (out) array of the direct components
+ *   q     - (out) array of the quadrature components
+ *   n     - (in) number of channels
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_n(FAR const float *sin, FAR const float *cos,
+                      FAR const float *alpha, FAR const float *beta,
+                      FAR float *d, FAR float *q, int n)
+{
+  int i;
+
+  DEBUGASSERT(sin != NULL && cos != NULL);
+  DEBUGASSERT(alpha != NULL && beta != NULL && d != NULL && q != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = alpha[i];
+      float b = beta[i];
+
+      d[i] = cos[i] * a + sin[i] * b;
+      q[i] = cos[i] * b - sin[i] * a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_n
+ *
+ * Description:
+ *   Inverse Park transform of n channels.  See inv_park_transform().
+ *
+ * Input Parameters:
+ *   sin   - (in) array of the phase angle sines
+ *   cos   - (in) array of the phase angle cosines
+ *   d     - (in) array of the direct components
+ *   q     - (in) array of the quadrature components
+ *   alpha - (out) array of the alpha components
+ *   beta  - (out) array of the beta components
+ *   n     - (in) number of channels
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_n(FAR const float *sin, FAR const float *cos,
+                          FAR const float *d, FAR const float *q,
+                          FAR float *alpha, FAR float *beta, int n)
+{
+  int i;
+
+  DEBUGASSERT(sin != NULL && cos != NULL);
+  DEBUGASSERT(d != NULL && q != NULL && alpha != NULL && beta != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float vd = d[i];
+      float vq = q[i];
+
+      alpha[i] = cos[i] * vd - sin[i] * vq;
+      beta[i]  = cos[i] * vq + sin[i] * vd;
+    }
+}
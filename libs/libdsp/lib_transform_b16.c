@@ -0,0 +1,229 @@
+/****************************************************************************
+ * libs/libdsp/lib_transform_b16.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_b16
+ *
+ * Description:
+ *   Transform the abc frame to the alpha-beta frame.  See
+ *   clarke_transform().
+ *
+ * Input Parameters:
+ *   abc - (in) pointer to the abc frame
+ *   ab  - (out) pointer to the alpha-beta frame
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_b16(FAR abc_frame_b16_t *abc, FAR ab_frame_b16_t *ab)
+{
+  DEBUGASSERT(abc != NULL);
+  DEBUGASSERT(ab != NULL);
+
+  ab->a = abc->a;
+  ab->b = b16mulb16(ONE_BY_SQRT3_B16, abc->a) +
+          b16mulb16(TWO_BY_SQRT3_B16, abc->b);
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_b16
+ *
+ * Description:
+ *   Transform the alpha-beta frame to the abc frame.
+ *
+ * Input Parameters:
+ *   ab  - (in) pointer to the alpha-beta frame
+ *   abc - (out) pointer to the abc frame
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
+                              FAR abc_frame_b16_t *abc)
+{
+  DEBUGASSERT(ab != NULL);
+  DEBUGASSERT(abc != NULL);
+
+  /* Assume non-power-invariant transform and balanced system */
+
+  abc->a = ab->a;
+  abc->b = -(ab->a >> 1) + b16mulb16(SQRT3_BY_TWO_B16, ab->b);
+  abc->c = -abc->a - abc->b;
+}
+
+/****************************************************************************
+ * Name: park_transform_b16
+ *
+ * Description:
+ *   Transform the alpha-beta frame to the direct-quadrature frame.
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angle data
+ *   ab    - (in) pointer to the alpha-beta frame
+ *   dq    - (out) pointer to the direct-quadrature frame
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_b16(FAR phase_angle_b16_t *angle,
+                        FAR ab_frame_b16_t *ab, FAR dq_frame_b16_t *dq)
+{
+  DEBUGASSERT(angle != NULL);
+  DEBUGASSERT(ab != NULL);
+  DEBUGASSERT(dq != NULL);
+
+  dq->d = b16mulb16(angle->cos, ab->a) + b16mulb16(angle->sin, ab->b);
+  dq->q = b16mulb16(angle->cos, ab->b) - b16mulb16(angle->sin, ab->a);
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_b16
+ *
+ * Description:
+ *   Transform direct-quadrature frame to alpha-beta frame.
+ *
+ * Input Parameters:
+ *   angle - (in) pointer to the phase angle data
+ *   dq    - (in) pointer to the direct-quadrature frame
+ *   ab    - (out) pointer to the alpha-beta frame
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
+                            FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab)
+{
+  DEBUGASSERT(angle != NULL);
+  DEBUGASSERT(dq != NULL);
+  DEBUGASSERT(ab != NULL);
+
+  ab->a = b16mulb16(angle->cos, dq->d) - b16mulb16(angle->sin, dq->q);
+  ab->b = b16mulb16(angle->cos, dq->q) + b16mulb16(angle->sin, dq->d);
+}
+
+/****************************************************************************
+ * Name: clarke_transform_n_b16
+ *
+ * Description:
+ *   Clarke transform of n channels.  See clarke_transform_n().
+ *
+ ****************************************************************************/
+
+void clarke_transform_n_b16(FAR const b16_t *a, FAR const b16_t *b,
+                            FAR b16_t *alpha, FAR b16_t *beta, int n)
+{
+  int i;
+
+  DEBUGASSERT(a != NULL && b != NULL && alpha != NULL && beta != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      beta[i]  = b16mulb16(ONE_BY_SQRT3_B16, a[i]) +
+                 b16mulb16(TWO_BY_SQRT3_B16, b[i]);
+      alpha[i] = a[i];
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_n_b16
+ *
+ * Description:
+ *   Park transform of n channels.  See park_transform_n().
+ *
+ ****************************************************************************/
+
+void park_transform_n_b16(FAR const b16_t *sin, FAR const b16_t *cos,
+                          FAR const b16_t *alpha, FAR const b16_t *beta,
+                          FAR b16_t *d, FAR b16_t *q, int n)
+{
+  int i;
+
+  DEBUGASSERT(sin != NULL && cos != NULL);
+  DEBUGASSERT(alpha != NULL && beta != NULL && d != NULL && q != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t a = alpha[i];
+      b16_t b = beta[i];
+
+      d[i] = b16mulb16(cos[i], a) + b16mulb16(sin[i], b);
+      q[i] = b16mulb16(cos[i], b) - b16mulb16(sin[i], a);
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_n_b16
+ *
+ * Description:
+ *   Inverse Park transform of n channels.  See inv_park_transform_n().
+ *
+ ****************************************************************************/
+
+void inv_park_transform_n_b16(FAR const b16_t *sin, FAR const b16_t *cos,
+                              FAR const b16_t *d, FAR const b16_t *q,
+                              FAR b16_t *alpha, FAR b16_t *beta, int n)
+{
+  int i;
+
+  DEBUGASSERT(sin != NULL && cos != NULL);
+  DEBUGASSERT(d != NULL && q != NULL && alpha != NULL && beta != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t vd = d[i];
+      b16_t vq = q[i];
+
+      alpha[i] = b16mulb16(cos[i], vd) - b16mulb16(sin[i], vq);
+      beta[i]  = b16mulb16(cos[i], vq) + b16mulb16(sin[i], vd);
+    }
+}
@@ -51,6 +51,15 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of glyph hash buckets in each font cache (a power of two) */
+
+#define NXF_HASHSIZE   32
+#define NXF_HASH(ch)   ((ch) & (NXF_HASHSIZE - 1))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -78,10 +87,13 @@ struct nxfonts_fcache_s
   nxgl_mxpixel_t bgcolor;              /* Background color */
   nxf_renderer_t renderer;             /* Font renderer */
 
-  /* Glyph cache data storage */
+  /* Glyph cache data storage.  The list is ordered from the most to the
+   * least recently used glyph.
+   */
 
   FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
   FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+  FAR struct nxfonts_glyph_s *hash[NXF_HASHSIZE]; /* Glyphs by character code */
 };
 
 /****************************************************************************
@@ -179,55 +191,94 @@ static void nxf_cache_lock(FAR struct nxfonts_fcache_s *priv)
 #define nxf_cache_unlock(p) (_SEM_POST(&priv->fsem))
 
 /****************************************************************************
- * Name: nxf_removeglyph
+ * Name: nxf_unlinkglyph
  *
  * Description:
- *   Removes the entry 'glyph' from the font cache.
+ *   Removes the entry 'glyph' from the list of glyphs.
  *
  ****************************************************************************/
 
-static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+static inline void nxf_unlinkglyph(FAR struct nxfonts_fcache_s *priv,
+                                   FAR struct nxfonts_glyph_s *glyph)
 {
-  ginfo("fcache=%p glyph=%p\n", priv, glyph);
-
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
-
-  if (prev == NULL)
+  if (glyph->blink == NULL)
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
+    }
+  else
+    {
+      glyph->blink->flink = glyph->flink;
+    }
 
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
+  if (glyph->flink == NULL)
+    {
+      priv->tail = glyph->blink;
+    }
+  else
+    {
+      glyph->flink->blink = glyph->blink;
     }
 
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
+  glyph->flink = NULL;
+  glyph->blink = NULL;
+}
+
+/****************************************************************************
+ * Name: nxf_linkglyph
+ *
+ * Description:
+ *   Add the entry 'glyph' to the head of the list of glyphs.
+ *
+ ****************************************************************************/
 
-  else if (glyph->flink == NULL)
+static inline void nxf_linkglyph(FAR struct nxfonts_fcache_s *priv,
+                                 FAR struct nxfonts_glyph_s *glyph)
+{
+  glyph->blink = NULL;
+  glyph->flink = priv->head;
+
+  if (priv->head == NULL)
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      priv->tail = glyph;
+    }
+  else
+    {
+      priv->head->blink = glyph;
     }
 
-  /* No.. Remove from mid-list */
+  priv->head = glyph;
+}
 
-  else
+/****************************************************************************
+ * Name: nxf_removeglyph
+ *
+ * Description:
+ *   Removes the entry 'glyph' from the font cache.
+ *
+ ****************************************************************************/
+
+static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
+                                   FAR struct nxfonts_glyph_s *glyph)
+{
+  FAR struct nxfonts_glyph_s **link;
+
+  ginfo("fcache=%p glyph=%p\n", priv, glyph);
+
+  /* Remove the glyph from the list */
+
+  nxf_unlinkglyph(priv, glyph);
+
+  /* And from its hash bucket */
+
+  for (link = &priv->hash[NXF_HASH(glyph->code)];
+       *link != glyph;
+       link = &(*link)->hlink)
     {
-      prev->flink = glyph->flink;
+      DEBUGASSERT(*link != NULL);
     }
 
-  glyph->flink = NULL;
+  *link = glyph->hlink;
+  glyph->hlink = NULL;
 
   /* Decrement the count of glyphs in the font cache */
 
@@ -246,18 +297,16 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
 static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
                                 FAR struct nxfonts_glyph_s *glyph)
 {
-  ginfo("fcache=%p glyph=%p\n", priv, glyph);
+  int ndx = NXF_HASH(glyph->code);
 
-  /* Add the glyph to the head of the list */
+  ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  glyph->flink = priv->head;
+  /* Add the glyph to the head of the list and to its hash bucket */
 
-  if (priv->head == NULL)
-    {
-      priv->tail = glyph;
-    }
+  nxf_linkglyph(priv, glyph);
 
-  priv->head = glyph;
+  glyph->hlink    = priv->hash[ndx];
+  priv->hash[ndx] = glyph;
 
   /* Increment the count of glyphs in the font cache. */
 
@@ -291,16 +340,15 @@ static FAR struct nxfonts_glyph_s *
   nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
+  /* Try to find the glyph in the hash bucket of the character */
 
-   for (prev = NULL, glyph = priv->head;
-        glyph != NULL;
-        prev = glyph, glyph = glyph->flink)
+  for (glyph = priv->hash[NXF_HASH(ch)];
+       glyph != NULL;
+       glyph = glyph->hlink)
     {
       /* Check if we found the glyph for this character */
 
@@ -310,32 +358,29 @@ static FAR struct nxfonts_glyph_s *
            * of the list (if it is not already at the head of the list).
            */
 
-          if (prev != NULL)
+          if (glyph != priv->head)
             {
-              nxf_removeglyph(priv, glyph, prev);
-              nxf_addglyph(priv, glyph);
+              nxf_unlinkglyph(priv, glyph);
+              nxf_linkglyph(priv, glyph);
             }
 
           /* And return the glyph that we found */
 
           return glyph;
         }
+    }
 
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
+  /* Has the cache reached its limit for the number of cached fonts? */
 
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
+  if (priv->tail != NULL && priv->nglyphs >= priv->maxglyphs)
+    {
+      /* Yes.. then remove the least recently used glyph and free the glyph
+       * memory.  We will surely need to have this space later.
+       */
 
-          nxf_removeglyph(priv, glyph, prev);
-          lib_free(glyph);
-          return NULL;
-        }
+      glyph = priv->tail;
+      nxf_removeglyph(priv, glyph);
+      lib_free(glyph);
     }
 
   return NULL;
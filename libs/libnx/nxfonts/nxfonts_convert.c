@@ -184,7 +184,6 @@ int NXF_FUNCNAME(nxf_convert,NXFONTS_SUFFIX)
 
   /* Render each row of the glyph */
 
-  sptr = bm->bitmap;
 #if NXFONTS_BITSPERPIXEL < 8
   mpixel = NXF_MULTIPIXEL(color);
 
@@ -195,6 +194,7 @@ int NXF_FUNCNAME(nxf_convert,NXFONTS_SUFFIX)
       /* Process each byte in the glyph row */
 
       col   = 0;
+      sptr  = &bm->bitmap[row * bm->metric.stride];
       dptr  = (FAR NXF_PIXEL_T*)line;
       pixel = *dptr;
       mask  = NXF_INITMASK;
@@ -254,12 +254,36 @@ int NXF_FUNCNAME(nxf_convert,NXFONTS_SUFFIX)
       /* Process each byte in the glyph */
 
       col  = 0;
+      sptr = &bm->bitmap[row * bm->metric.stride];
       dptr = (FAR NXF_PIXEL_T*)line;
 
       for (bmndx = 0; bmndx < bm->metric.stride && col < width; bmndx++)
         {
           bmbyte = *sptr++;
 
+          /* Bytes that are all background or all foreground are common.
+           * Handle them eight pixels at a time.
+           */
+
+          if (width - col >= 8 && (bmbyte == 0x00 || bmbyte == 0xff))
+            {
+              if (bmbyte != 0)
+                {
+                  dptr[0] = color;
+                  dptr[1] = color;
+                  dptr[2] = color;
+                  dptr[3] = color;
+                  dptr[4] = color;
+                  dptr[5] = color;
+                  dptr[6] = color;
+                  dptr[7] = color;
+                }
+
+              dptr += 8;
+              col  += 8;
+              continue;
+            }
+
           /* Process each bit in the byte */
 
           for (bmbit = 7; bmbit >= 0 && col < width; bmbit--, col++)
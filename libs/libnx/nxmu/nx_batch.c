@@ -0,0 +1,135 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nx_batch.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+#include "nxcontext.h"
+
+#ifdef CONFIG_NX_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_batchbegin
+ *
+ * Description:
+ *   Start collecting the drawing requests of the client in a buffer.  See
+ *   include/nuttx/nx/nx.h.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_batchbegin(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  /* The buffer is allocated on first use and kept until the client
+   * disconnects.
+   */
+
+  if (conn->batch == NULL)
+    {
+      conn->batch = (FAR uint8_t *)lib_umalloc(CONFIG_NX_BATCHSIZE);
+      if (conn->batch == NULL)
+        {
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+
+      conn->batchlen = 0;
+    }
+
+  conn->batching = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_batchend
+ *
+ * Description:
+ *   Send the collected drawing requests to the server and stop collecting
+ *   them.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_batchend(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  conn->batching = false;
+  return nxmu_flushbatch(conn);
+}
+
+#endif /* CONFIG_NX_BATCH */
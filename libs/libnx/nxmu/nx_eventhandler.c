@@ -83,6 +83,15 @@ static inline void nx_disconnected(FAR struct nxmu_conn_s *conn)
   (void)mq_close(conn->cwrmq);
   (void)mq_close(conn->crdmq);
 
+#ifdef CONFIG_NX_BATCH
+  /* Free the batch buffer */
+
+  if (conn->batch != NULL)
+    {
+      lib_ufree(conn->batch);
+    }
+#endif
+
   /* And free the client structure */
 
   lib_ufree(conn);
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libs/libnx/nxmu/nxmu_sendserver.c
  *
- *   Copyright (C) 2012-2013, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012-2013, 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,17 +39,127 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include <mqueue.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/nx/nxmu.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batchable
+ *
+ * Description:
+ *  Return true if the message may be batched.  These are the drawing
+ *  requests that do not wait for a response from the server.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+static bool nxmu_batchable(uint32_t msgid)
+{
+  switch (msgid)
+    {
+      case NX_SVRMSG_SETPIXEL:
+      case NX_SVRMSG_FILL:
+      case NX_SVRMSG_FILLTRAP:
+      case NX_SVRMSG_MOVE:
+      case NX_SVRMSG_SETBGCOLOR:
+      case NX_SVRMSG_REDRAWREQ:
+        return true;
+
+      default:
+        return false;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxmu_flushbatch
+ *
+ * Description:
+ *  Send any batched messages to the server and wait until the server has
+ *  processed them.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_flushbatch(FAR struct nxmu_conn_s *conn)
+{
+  struct nxsvrmsg_batch_s outmsg;
+  sem_t sem_done;
+  int ret;
+
+  if (conn->batchlen == 0)
+    {
+      return OK;
+    }
+
+  /* Format the batch command */
+
+  outmsg.msgid    = NX_SVRMSG_BATCH;
+  outmsg.buffer   = conn->batch;
+  outmsg.nbytes   = conn->batchlen;
+  outmsg.sem_done = &sem_done;
+
+  /* The sem_done semaphore is used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  ret = _SEM_INIT(&sem_done, 0, 0);
+  if (ret < 0)
+    {
+      gerr("ERROR: _SEM_INIT failed: %d\n", _SEM_ERRNO(ret));
+      return ret;
+    }
+
+  (void)_SEM_SETPROTOCOL(&sem_done, SEM_PRIO_NONE);
+
+  /* Send the buffer and wait until the server is done with it */
+
+  ret = _MQ_SEND(conn->cwrmq, (FAR const char *)&outmsg,
+                 sizeof(struct nxsvrmsg_batch_s), NX_SVRMSG_PRIO);
+  if (ret < 0)
+    {
+      gerr("ERROR: _MQ_SEND failed: %d\n", _MQ_GETERRNO(ret));
+    }
+  else
+    {
+      while ((ret = _SEM_WAIT(&sem_done)) < 0)
+        {
+          int errorcode = _SEM_ERRNO(ret);
+          DEBUGASSERT(errorcode == EINTR || errorcode == ECANCELED);
+          UNUSED(errorcode);
+        }
+
+      conn->batchlen = 0;
+    }
+
+  (void)_SEM_DESTROY(&sem_done);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: nxmu_sendserver
  *
@@ -81,6 +191,47 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn, FAR const void *msg,
     }
 #endif
 
+#ifdef CONFIG_NX_BATCH
+  if (conn->batching)
+    {
+      size_t reclen = NX_BATCH_RECLEN(msglen);
+
+      if (nxmu_batchable(*(FAR const uint32_t *)msg) &&
+          reclen <= CONFIG_NX_BATCHSIZE)
+        {
+          FAR uintptr_t *hdr;
+
+          /* Make room for the message if the buffer is full */
+
+          if (conn->batchlen + reclen > CONFIG_NX_BATCHSIZE)
+            {
+              ret = nxmu_flushbatch(conn);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          /* Then add the message to the batch */
+
+          hdr  = (FAR uintptr_t *)&conn->batch[conn->batchlen];
+          *hdr = msglen;
+          memcpy(hdr + 1, msg, msglen);
+
+          conn->batchlen += reclen;
+          return OK;
+        }
+
+      /* Any other message must follow the batched messages */
+
+      ret = nxmu_flushbatch(conn);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Send the message to the server */
 
   ret = _MQ_SEND(conn->cwrmq, msg, msglen, NX_SVRMSG_PRIO);
@@ -1,7 +1,7 @@
 //***************************************************************************
 // libs/libxx/libxx.hxx
 //
-//   Copyright (C) 2012-2013 Gregory Nutt. All rights reserved.
+//   Copyright (C) 2012-2013, 2020 Gregory Nutt. All rights reserved.
 //   Author: Gregory Nutt <gnutt@nuttx.org>
 //
 // Redistribution and use in source and binary forms, with or without
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <cstddef>
+
 //***************************************************************************
 // Definitions
 //***************************************************************************
@@ -67,6 +69,14 @@
 #  define lib_free(p)      free(p)
 #endif
 
+// The memory for operator new and delete comes from the size-class pool if
+// it is enabled, otherwise directly from the heap.
+
+#ifndef CONFIG_CXX_POOL
+#  define libxx_alloc(s)   lib_malloc(s)
+#  define libxx_free(p)    lib_free(p)
+#endif
+
 //***************************************************************************
 // Public Types
 //***************************************************************************/
@@ -85,4 +95,9 @@ extern "C" FAR void *__dso_handle;
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
 
+#ifdef CONFIG_CXX_POOL
+FAR void *libxx_alloc(size_t nbytes);
+void libxx_free(FAR void *ptr);
+#endif
+
 #endif // __LIBXX_LIBXX_HXX
@@ -1,7 +1,7 @@
 //***************************************************************************
 // libs/libxx/libxx_delete_sized.cxx
 //
-//   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+//   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
 //   Author: Gregory Nutt <gnutt@nuttx.org>
 //
 // Redistribution and use in source and binary forms, with or without
@@ -68,7 +68,7 @@ void operator delete(FAR void *ptr, unsigned long size)
 void operator delete(FAR void *ptr, unsigned int size)
 #endif
 {
-  lib_free(ptr);
+  libxx_free(ptr);
 }
 
 #endif /* CONFIG_HAVE_CXX14 */
@@ -1,7 +1,7 @@
 //***************************************************************************
 // libs/libxx/libxx_deletea.cxx
 //
-//   Copyright (C) 2009, 2013 Gregory Nutt. All rights reserved.
+//   Copyright (C) 2009, 2013, 2020 Gregory Nutt. All rights reserved.
 //   Author: Gregory Nutt <gnutt@nuttx.org>
 //
 // Redistribution and use in source and binary forms, with or without
@@ -51,5 +51,5 @@
 
 void operator delete[](void *ptr)
 {
-  lib_free(ptr);
+  libxx_free(ptr);
 }
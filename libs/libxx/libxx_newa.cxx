@@ -1,7 +1,7 @@
 //***************************************************************************
 // libs/libxx/libxx_newa.cxx
 //
-//   Copyright (C) 2009 Gregory Nutt. All rights reserved.
+//   Copyright (C) 2009, 2020 Gregory Nutt. All rights reserved.
 //   Author: Gregory Nutt <gnutt@nuttx.org>
 //
 // Redistribution and use in source and binary forms, with or without
@@ -85,7 +85,7 @@ void *operator new[](unsigned int nbytes)
 
   // Perform the allocation
 
-  void *alloc = lib_malloc(nbytes);
+  void *alloc = libxx_alloc(nbytes);
 
 #ifdef CONFIG_DEBUG_ERROR
   if (alloc == 0)
@@ -0,0 +1,424 @@
+//***************************************************************************
+// libs/libxx/libxx_pool.cxx
+//
+//   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX nor the names of its contributors may be
+//    used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <unistd.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_CXX_POOL
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// Small allocations are rounded up to a multiple of POOL_GRANULE bytes.
+// Each multiple is one size class.
+
+#define POOL_GRANULE      8
+#define POOL_NCLASSES \
+  ((CONFIG_CXX_POOL_MAXSIZE + POOL_GRANULE - 1) / POOL_GRANULE)
+#define POOL_MAXSIZE      (POOL_NCLASSES * POOL_GRANULE)
+
+#define POOL_CLASS(n)     (((n) - 1) / POOL_GRANULE)
+#define POOL_BLKSIZE(c) \
+  (sizeof(union pool_header_u) + ((c) + 1) * POOL_GRANULE)
+
+// The class of the allocations that are not taken from the pool
+
+#define POOL_HEAP         POOL_NCLASSES
+
+// The caches are initialized statically, so that they can be used before
+// any constructor has run and without a check on every allocation.
+
+#define POOL_CACHE_INITIALIZER { SEM_INITIALIZER(1) }
+
+#if CONFIG_CXX_POOL_NCACHES < 1 || CONFIG_CXX_POOL_NCACHES > 8
+#  error CONFIG_CXX_POOL_NCACHES must be within 1 and 8
+#endif
+
+#if CONFIG_CXX_POOL_BATCH > CONFIG_CXX_POOL_DEPTH
+#  error CONFIG_CXX_POOL_BATCH must not exceed CONFIG_CXX_POOL_DEPTH
+#endif
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+// Every block returned by libxx_alloc() is preceded by this header.  While
+// the block is allocated, it holds the size class that the block belongs
+// to.  While the block is free, it links the block into a free list.  It
+// also preserves the alignment of the memory that follows it.
+
+union pool_header_u
+{
+  unsigned int ph_class;                // Size class of an allocated block
+  FAR union pool_header_u *ph_flink;    // Next free block of the class
+  double ph_align;                      // Forces the alignment
+};
+
+// A list of free blocks of one size class
+
+struct pool_freelist_s
+{
+  FAR union pool_header_u *fl_head;     // The first free block
+  unsigned int fl_count;                // The number of free blocks
+};
+
+// The free blocks of all size classes, protected by one semaphore
+
+struct pool_cache_s
+{
+  sem_t cc_sem;
+  struct pool_freelist_s cc_list[POOL_NCLASSES];
+};
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+// The caches used by the threads.  A thread always uses the cache selected
+// by its thread ID, so that threads need not register and exiting threads
+// leave nothing behind.  Threads only contend for a cache if their IDs
+// select the same one.
+
+static struct pool_cache_s g_pool_caches[CONFIG_CXX_POOL_NCACHES] =
+{
+  POOL_CACHE_INITIALIZER,
+#if CONFIG_CXX_POOL_NCACHES > 1
+  POOL_CACHE_INITIALIZER,
+#endif
+#if CONFIG_CXX_POOL_NCACHES > 2
+  POOL_CACHE_INITIALIZER,
+#endif
+#if CONFIG_CXX_POOL_NCACHES > 3
+  POOL_CACHE_INITIALIZER,
+#endif
+#if CONFIG_CXX_POOL_NCACHES > 4
+  POOL_CACHE_INITIALIZER,
+#endif
+#if CONFIG_CXX_POOL_NCACHES > 5
+  POOL_CACHE_INITIALIZER,
+#endif
+#if CONFIG_CXX_POOL_NCACHES > 6
+  POOL_CACHE_INITIALIZER,
+#endif
+#if CONFIG_CXX_POOL_NCACHES > 7
+  POOL_CACHE_INITIALIZER,
+#endif
+};
+
+// The free blocks shared by all caches.  Caches are refilled from and
+// drained to these lists in batches of CONFIG_CXX_POOL_BATCH blocks.
+
+static struct pool_cache_s g_pool_shared = POOL_CACHE_INITIALIZER;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: pool_takesem and pool_givesem
+//***************************************************************************
+
+static void pool_takesem(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      // The only case that an error should occur here is if the wait was
+      // awakened by a signal.
+
+      DEBUGASSERT(errno == EINTR || errno == ECANCELED);
+    }
+}
+
+#define pool_givesem(s) sem_post(s)
+
+//***************************************************************************
+// Name: pool_thiscache
+//
+// Description:
+//   Return the cache of the calling thread.
+//
+//***************************************************************************
+
+static inline FAR struct pool_cache_s *pool_thiscache(void)
+{
+#if CONFIG_CXX_POOL_NCACHES > 1
+  return &g_pool_caches[(unsigned int)getpid() % CONFIG_CXX_POOL_NCACHES];
+#else
+  return &g_pool_caches[0];
+#endif
+}
+
+//***************************************************************************
+// Name: pool_refill
+//
+// Description:
+//   The list of size class 'ndx' is empty in 'cache'.  Move a batch of free
+//   blocks from the shared lists, or from a new slab allocated from the
+//   heap if there are none, to the cache.  One block is returned to the
+//   caller.
+//
+//   Slabs are never returned to the heap.
+//
+//***************************************************************************
+
+static FAR union pool_header_u *pool_refill(FAR struct pool_cache_s *cache,
+                                            unsigned int ndx)
+{
+  FAR struct pool_freelist_s *list;
+  FAR union pool_header_u *head;
+  FAR union pool_header_u *tail;
+  FAR union pool_header_u *blk;
+  unsigned int count;
+
+  // Try the shared list first
+
+  pool_takesem(&g_pool_shared.cc_sem);
+
+  list = &g_pool_shared.cc_list[ndx];
+  head = list->fl_head;
+  tail = head;
+
+  for (count = 0; count < CONFIG_CXX_POOL_BATCH && list->fl_head != NULL;
+       count++)
+    {
+      tail          = list->fl_head;
+      list->fl_head = tail->ph_flink;
+      list->fl_count--;
+    }
+
+  pool_givesem(&g_pool_shared.cc_sem);
+
+  if (count == 0)
+    {
+      // Carve a new slab into a list of free blocks
+
+      head = (FAR union pool_header_u *)
+        lib_malloc(CONFIG_CXX_POOL_BATCH * POOL_BLKSIZE(ndx));
+      if (head == NULL)
+        {
+          return NULL;
+        }
+
+      for (blk = head, count = 1; count < CONFIG_CXX_POOL_BATCH; count++)
+        {
+          blk->ph_flink = (FAR union pool_header_u *)
+            ((FAR char *)blk + POOL_BLKSIZE(ndx));
+          blk = blk->ph_flink;
+        }
+
+      tail = blk;
+    }
+
+  // Keep the first block for the caller and move the rest to the cache
+
+  blk = head;
+  if (--count > 0)
+    {
+      list = &cache->cc_list[ndx];
+
+      pool_takesem(&cache->cc_sem);
+      tail->ph_flink  = list->fl_head;
+      list->fl_head   = head->ph_flink;
+      list->fl_count += count;
+      pool_givesem(&cache->cc_sem);
+    }
+
+  return blk;
+}
+
+//***************************************************************************
+// Name: pool_drain
+//
+// Description:
+//   Move a batch of free blocks of size class 'ndx', detached from a cache,
+//   to the shared list.
+//
+//***************************************************************************
+
+static void pool_drain(FAR union pool_header_u *head,
+                       FAR union pool_header_u *tail, unsigned int ndx)
+{
+  FAR struct pool_freelist_s *list = &g_pool_shared.cc_list[ndx];
+
+  pool_takesem(&g_pool_shared.cc_sem);
+  tail->ph_flink  = list->fl_head;
+  list->fl_head   = head;
+  list->fl_count += CONFIG_CXX_POOL_BATCH;
+  pool_givesem(&g_pool_shared.cc_sem);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_alloc
+//
+// Description:
+//   Allocate the memory for operator new and operator new[].  Allocations
+//   of up to CONFIG_CXX_POOL_MAXSIZE bytes are satisfied from the cache of
+//   the calling thread without taking the heap semaphore in most cases.
+//   Larger allocations are passed on to the heap.
+//
+//***************************************************************************
+
+FAR void *libxx_alloc(size_t nbytes)
+{
+  FAR struct pool_cache_s *cache;
+  FAR struct pool_freelist_s *list;
+  FAR union pool_header_u *blk;
+  unsigned int ndx;
+
+  if (nbytes > POOL_MAXSIZE)
+    {
+      blk = (FAR union pool_header_u *)
+        lib_malloc(sizeof(union pool_header_u) + nbytes);
+      if (blk == NULL)
+        {
+          return NULL;
+        }
+
+      blk->ph_class = POOL_HEAP;
+      return blk + 1;
+    }
+
+  ndx   = nbytes > 0 ? POOL_CLASS(nbytes) : 0;
+  cache = pool_thiscache();
+  list  = &cache->cc_list[ndx];
+
+  pool_takesem(&cache->cc_sem);
+
+  blk = list->fl_head;
+  if (blk != NULL)
+    {
+      list->fl_head = blk->ph_flink;
+      list->fl_count--;
+    }
+
+  pool_givesem(&cache->cc_sem);
+
+  if (blk == NULL)
+    {
+      blk = pool_refill(cache, ndx);
+      if (blk == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  blk->ph_class = ndx;
+  return blk + 1;
+}
+
+//***************************************************************************
+// Name: libxx_free
+//
+// Description:
+//   Free memory allocated by libxx_alloc().  The header of the block tells
+//   where it came from, so the size is never needed.  Small blocks are
+//   returned to the cache of the calling thread.  If that holds more than
+//   CONFIG_CXX_POOL_DEPTH blocks of the class, a batch of blocks is moved
+//   on to the shared list.
+//
+//***************************************************************************
+
+void libxx_free(FAR void *ptr)
+{
+  FAR struct pool_cache_s *cache;
+  FAR struct pool_freelist_s *list;
+  FAR union pool_header_u *drain = NULL;
+  FAR union pool_header_u *blk;
+  FAR union pool_header_u *last = NULL;
+  unsigned int ndx;
+  int i;
+
+  if (ptr == NULL)
+    {
+      return;
+    }
+
+  blk = (FAR union pool_header_u *)ptr - 1;
+  ndx = blk->ph_class;
+
+  if (ndx >= POOL_NCLASSES)
+    {
+      DEBUGASSERT(ndx == POOL_HEAP);
+      lib_free(blk);
+      return;
+    }
+
+  cache = pool_thiscache();
+  list  = &cache->cc_list[ndx];
+
+  pool_takesem(&cache->cc_sem);
+
+  blk->ph_flink = list->fl_head;
+  list->fl_head = blk;
+
+  if (++list->fl_count > CONFIG_CXX_POOL_DEPTH)
+    {
+      // Detach a batch of blocks to be moved to the shared list
+
+      drain = list->fl_head;
+      for (last = drain, i = 1; i < CONFIG_CXX_POOL_BATCH; i++)
+        {
+          last = last->ph_flink;
+        }
+
+      list->fl_head   = last->ph_flink;
+      list->fl_count -= CONFIG_CXX_POOL_BATCH;
+    }
+
+  pool_givesem(&cache->cc_sem);
+
+  if (drain != NULL)
+    {
+      pool_drain(drain, last, ndx);
+    }
+}
+
+#endif // CONFIG_CXX_POOL
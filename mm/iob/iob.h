@@ -46,6 +46,11 @@
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
+
+#ifdef CONFIG_IOB_CACHE
+#  include <nuttx/spinlock.h>
+#endif
 
 #ifdef CONFIG_MM_IOB
 
@@ -83,28 +88,92 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#ifdef CONFIG_IOB_NOTIFIER
+#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
+#    define IOB_DIVIDER 1
+#  elif CONFIG_IOB_NOTIFIER_DIV < 4
+#    define IOB_DIVIDER 2
+#  elif CONFIG_IOB_NOTIFIER_DIV < 8
+#    define IOB_DIVIDER 4
+#  elif CONFIG_IOB_NOTIFIER_DIV < 16
+#    define IOB_DIVIDER 8
+#  elif CONFIG_IOB_NOTIFIER_DIV < 32
+#    define IOB_DIVIDER 16
+#  elif CONFIG_IOB_NOTIFIER_DIV < 64
+#    define IOB_DIVIDER 32
+#  else
+#    define IOB_DIVIDER 64
+#  endif
+#else
+#  define IOB_DIVIDER 1
+#endif
+
+#define IOB_MASK      (IOB_DIVIDER - 1)
+
+#ifdef CONFIG_IOB_CACHE
+/* Freed I/O buffers are only cached while at least this many I/O buffers
+ * are free in the common pool.  Below that, every free must post the
+ * semaphores so that no waiter, throttled allocation or notification is
+ * delayed by buffers held in the caches.
+ */
+
+#  define IOB_CACHE_MINFREE (CONFIG_IOB_THROTTLE + IOB_DIVIDER)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CACHE
+/* The cache of free I/O buffers of one CPU.  The cache is normally only
+ * accessed by its own CPU with local interrupts disabled;  the spinlock is
+ * only contended when another CPU drains the cache.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t ic_lock;             /* Serializes access with draining CPUs */
+  uint8_t ic_count;               /* Number of I/O buffers in ic_head */
+  FAR struct iob_s *ic_head;      /* List of free I/O buffers */
+  unsigned long ic_hits;          /* Allocations satisfied by the cache */
+  unsigned long ic_misses;        /* Allocations that found it empty */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* A list of all free, unallocated I/O buffers */
+/* The pool of all free, unallocated I/O buffers */
+
+extern struct mempool_s g_iob_pool;
 
-extern FAR struct iob_s *g_iob_freelist;
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* The pool of all free, unallocated large I/O buffers */
+
+extern struct mempool_s g_iob_largepool;
+#endif
 
 /* A list of I/O buffers that are committed for allocation */
 
 extern FAR struct iob_s *g_iob_committed;
 
 #if CONFIG_IOB_NCHAINS > 0
-/* A list of all free, unallocated I/O buffer queue containers */
+/* The pool of all free, unallocated I/O buffer queue containers */
 
-extern FAR struct iob_qentry_s *g_iob_freeqlist;
+extern struct mempool_s g_iob_qpool;
 
 /* A list of I/O buffer queue containers that are committed for allocation */
 
 extern FAR struct iob_qentry_s *g_iob_qcommitted;
 #endif
 
+#ifdef CONFIG_IOB_CACHE
+/* The per-CPU caches of free I/O buffers */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+#endif
+
 /* Counting semaphores that tracks the number of free IOBs/qentries */
 
 extern sem_t g_iob_sem;       /* Counts free I/O buffers */
@@ -154,6 +223,62 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return an I/O buffer to the free pool, or hand it over to a waiting
+ *   thread, and post the counting semaphores.  The caller must be in a
+ *   critical section.  This function is intended only for internal use by
+ *   the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU.  NULL is
+ *   returned if the cache is empty.  This function is intended only for
+ *   internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CACHE
+FAR struct iob_s *iob_cache_alloc(enum iob_user_e consumerid);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Add a free I/O buffer to the cache of the current CPU.  false is
+ *   returned if the cache is full or if the I/O buffer is needed in the
+ *   common pool;  the caller must then release it with iob_release().
+ *   This function is intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CACHE
+bool iob_cache_free(FAR struct iob_s *iob, enum iob_user_e producerid);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers held in the caches of all CPUs to the common
+ *   pool.  The number of I/O buffers returned is provided.  This function
+ *   is intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CACHE
+int iob_cache_drain(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -46,6 +46,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -100,6 +101,126 @@ static FAR struct iob_s *iob_alloc_committed(enum iob_user_e consumerid)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_pool
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the common pool without waiting for
+ *   a buffer to become free.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_pool(bool throttled,
+                                           enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount > 0)
+#endif
+    {
+      /* Take an I/O buffer from the pool */
+
+      iob = (FAR struct iob_s *)mempool_alloc(&g_iob_pool);
+      if (iob != NULL)
+        {
+          /* Decrement the counting semaphore(s) that tracks the number of
+           * available IOBs.
+           */
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          (void)NXSEM_COUNT_DEC(&g_iob_sem);
+          DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is a little more complicated because
+           * it can be negative!  Decrementing is still safe, however.
+           */
+
+          (void)NXSEM_COUNT_DEC(&g_throttle_sem);
+          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+          iob_stats_onalloc(consumerid);
+#endif
+
+          leave_critical_section(flags);
+          return iob;
+        }
+    }
+
+  leave_critical_section(flags);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_large
+ *
+ * Description:
+ *   Try to allocate a large I/O buffer.  Large I/O buffers are not counted
+ *   by the semaphores and are never waited for.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static FAR struct iob_s *iob_tryalloc_large(enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  iob   = (FAR struct iob_s *)mempool_alloc(&g_iob_largepool);
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  if (iob != NULL)
+    {
+      iob_stats_onalloc(consumerid);
+    }
+#endif
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -194,11 +315,11 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
             {
               if (throttled)
                 {
-                  g_iob_sem.semcount--;
+                  (void)NXSEM_COUNT_DEC(&g_iob_sem);
                 }
               else
                 {
-                  g_throttle_sem.semcount--;
+                  (void)NXSEM_COUNT_DEC(&g_throttle_sem);
                 }
             }
 #endif
@@ -250,78 +371,103 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid)
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
 {
-  FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
-
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
-#endif
+  FAR struct iob_s *iob = NULL;
 
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
+#ifdef CONFIG_IOB_CACHE
+  /* Try the cache of this CPU first.  Throttled allocations must be
+   * checked against the throttle semaphore, so they always use the common
+   * pool.
    */
 
-  flags = enter_critical_section();
-
 #if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
+  if (!throttled)
+#endif
+    {
+      iob = iob_cache_alloc(consumerid);
+    }
 
-  if (sem->semcount > 0)
+  if (iob == NULL)
 #endif
     {
-      /* Take the I/O buffer from the head of the free list */
+      iob = iob_tryalloc_pool(throttled, consumerid);
 
-      iob = g_iob_freelist;
-      if (iob != NULL)
+#ifdef CONFIG_IOB_CACHE
+      /* If the common pool is exhausted, return any I/O buffers held in
+       * the caches and try again.
+       */
+
+      if (iob == NULL && iob_cache_drain() > 0)
         {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
+          iob = iob_tryalloc_pool(throttled, consumerid);
+        }
+#endif
+    }
 
-          g_iob_freelist = iob->io_flink;
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
 
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+  return iob;
+}
 
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           */
+/****************************************************************************
+ * Name: iob_allocsize
+ *
+ * Description:
+ *   Allocate an I/O buffer of the smallest size class that can hold 'size'
+ *   bytes.  If no such buffer is free, a normal I/O buffer is allocated,
+ *   waiting if necessary, and the caller must chain more buffers as needed.
+ *
+ ****************************************************************************/
 
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
-#endif
+FAR struct iob_s *iob_allocsize(unsigned int size, bool throttled,
+                                enum iob_user_e consumerid)
+{
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  FAR struct iob_s *iob;
 
-#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
-    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
-          iob_stats_onalloc(consumerid);
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_large(consumerid);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
 #endif
 
-          leave_critical_section(flags);
+  return iob_alloc(throttled, consumerid);
+}
 
-          /* Put the I/O buffer in a known state */
+/****************************************************************************
+ * Name: iob_tryallocsize
+ *
+ * Description:
+ *   Like iob_allocsize(), but without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryallocsize(unsigned int size, bool throttled,
+                                   enum iob_user_e consumerid)
+{
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  FAR struct iob_s *iob;
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_large(consumerid);
+      if (iob != NULL)
+        {
           return iob;
         }
     }
+#endif
 
-  leave_critical_section(flags);
-  return NULL;
+  return iob_tryalloc(throttled, consumerid);
 }
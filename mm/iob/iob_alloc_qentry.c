@@ -45,6 +45,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -234,16 +235,13 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
    */
 
   flags = enter_critical_section();
-  iobq  = g_iob_freeqlist;
+  iobq  = (FAR struct iob_qentry_s *)mempool_alloc(&g_iob_qpool);
   if (iobq)
     {
-      /* Remove the I/O buffer chain container from the free list and
-       * decrement the counting semaphore that tracks the number of free
+      /* Decrement the counting semaphore that tracks the number of free
        * containers.
        */
 
-      g_iob_freeqlist = iobq->qe_flink;
-
       /* Take a semaphore count.  Note that we cannot do this in
        * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
        * because this function may be called from an interrupt
@@ -251,7 +249,7 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
        * so a simple decrement is all that is needed.
        */
 
-      g_qentry_sem.semcount--;
+      (void)NXSEM_COUNT_DEC(&g_qentry_sem);
       DEBUGASSERT(g_qentry_sem.semcount >= 0);
 
       /* Put the I/O buffer in a known state */
@@ -0,0 +1,239 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_CACHE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The per-CPU caches of free I/O buffers */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU.  Once local
+ *   interrupts are disabled, the current task cannot be moved to another
+ *   CPU, so the CPU index remains valid until interrupts are restored.
+ *
+ * Returned Value:
+ *   The I/O buffer (not yet initialized) or NULL if the cache is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(enum iob_user_e consumerid)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  iob = cache->ic_head;
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+      cache->ic_hits++;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      /* REVISIT:  The statistics are not protected against updates from
+       * other CPUs here and may occasionally lose counts.
+       */
+
+      iob_stats_onalloc(consumerid);
+#endif
+    }
+  else
+    {
+      cache->ic_misses++;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Add a free I/O buffer to the cache of the current CPU.  The I/O buffer
+ *   is only cached while the common pool holds at least IOB_CACHE_MINFREE
+ *   free I/O buffers:  then no thread can be waiting for an I/O buffer and
+ *   neither the throttle nor the notifier depends on this one.
+ *
+ *   The pool count is sampled while holding the cache lock.  A CPU that
+ *   drains the caches takes the same locks after the pool count has
+ *   dropped, so a buffer can never be cached behind the back of a thread
+ *   that is about to wait.
+ *
+ * Returned Value:
+ *   true if the I/O buffer was cached;  false if the caller must release
+ *   it to the common pool.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob, enum iob_user_e producerid)
+{
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+  bool cached = false;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  if (cache->ic_count < CONFIG_IOB_CACHE_DEPTH &&
+      g_iob_sem.semcount >= IOB_CACHE_MINFREE)
+    {
+      iob->io_flink  = cache->ic_head;
+      cache->ic_head = iob;
+      cache->ic_count++;
+      cached         = true;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onfree(producerid);
+#endif
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers held in the caches of all CPUs to the common
+ *   pool.  This is done when an allocation from the common pool fails,
+ *   before the caller gives up or waits for an I/O buffer.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned to the common pool.
+ *
+ ****************************************************************************/
+
+int iob_cache_drain(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int ndrained = 0;
+  int cpu;
+
+  flags = enter_critical_section();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+
+      spin_lock(&cache->ic_lock);
+      iob             = cache->ic_head;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+      spin_unlock(&cache->ic_lock);
+
+      for (; iob != NULL; iob = next)
+        {
+          next = iob->io_flink;
+          iob_release(iob);
+          ndrained++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ndrained;
+}
+
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return the current state and the statistics of the I/O buffer cache of
+ *   one CPU.
+ *
+ ****************************************************************************/
+
+void iob_getcachestats(int cpu, FAR struct iob_cachestats_s *stats)
+{
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && stats != NULL);
+  cache = &g_iob_cache[cpu];
+
+  flags = enter_critical_section();
+  spin_lock(&cache->ic_lock);
+
+  stats->ncached = cache->ic_count;
+  stats->hits    = cache->ic_hits;
+  stats->misses  = cache->ic_misses;
+
+  spin_unlock(&cache->ic_lock);
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_IOB_CACHE */
@@ -78,6 +78,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
   unsigned int avail2;
   unsigned int offset1;
   unsigned int offset2;
+  unsigned int remaining;
 
   DEBUGASSERT(iob2->io_len == 0 && iob2->io_offset == 0 &&
               iob2->io_pktlen == 0 && iob2->io_flink == NULL);
@@ -85,6 +86,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
   /* Copy the total packet size from the I/O buffer at the head of the chain */
 
   iob2->io_pktlen = iob1->io_pktlen;
+  remaining       = iob1->io_pktlen;
 
   /* Handle special case where there are empty buffers at the head
    * the list.
@@ -114,7 +116,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
        */
 
       dest   = &iob2->io_data[offset2];
-      avail2 = CONFIG_IOB_BUFSIZE - offset2;
+      avail2 = IOB_BUFSIZE(iob2) - offset2;
 
       /* Copy the smaller of the two and update the srce and destination
        * offsets.
@@ -125,6 +127,16 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
 
       offset1 += ncopy;
       offset2 += ncopy;
+      iob2->io_len = offset2;
+
+      if (remaining > ncopy)
+        {
+          remaining -= ncopy;
+        }
+      else
+        {
+          remaining = 0;
+        }
 
       /* Have we taken all of the data from the source I/O buffer? */
 
@@ -151,7 +163,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
        * transferred?
        */
 
-       if (offset2 >= CONFIG_IOB_BUFSIZE && iob1 != NULL)
+       if (offset2 >= IOB_BUFSIZE(iob2) && iob1 != NULL)
         {
           FAR struct iob_s *next;
 
@@ -159,7 +171,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
            * destination I/O buffer chain.
            */
 
-          next = iob_alloc(throttled, consumerid);
+          next = iob_allocsize(remaining, throttled, consumerid);
           if (!next)
             {
               ioberr("ERROR: Failed to allocate an I/O buffer/n");
@@ -0,0 +1,221 @@
+/****************************************************************************
+ * mm/iob/iob_dmain.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_dmain
+ *
+ * Description:
+ *   Prepare an empty I/O buffer chain to receive 'len' bytes by
+ *   scatter-gather DMA into memory, i.e., for RX.  Data is received at the
+ *   current io_offset of the first I/O buffer (so that header space may be
+ *   reserved) and at the beginning of each following I/O buffer.
+ *
+ *   The chain is extended as necessary without waiting for buffers to
+ *   become free, so this may be called when an RX descriptor ring is
+ *   refilled from interrupt level logic.  The lengths of the buffers are
+ *   set to describe the full space and the data cache is flushed over each
+ *   segment so that no dirty cache line can later overwrite received data.
+ *
+ * Input Parameters:
+ *   iob        - An empty I/O buffer
+ *   len        - The number of bytes of space to provide
+ *   segs       - The caller-provided array of segments to fill
+ *   nsegs      - The number of entries in 'segs'
+ *   throttled  - An indication of the IOB allocation is "throttled"
+ *   consumerid - The user of the I/O buffers
+ *
+ * Returned Value:
+ *   The number of segments used (> 0) OR a negative error code:  -E2BIG if
+ *   more than 'nsegs' segments would be needed or -ENOMEM if not enough
+ *   I/O buffers are available.  On failure the I/O buffer is returned to
+ *   its empty state.
+ *
+ * Assumptions:
+ *   The data of each I/O buffer must not share a cache line with anything
+ *   that is modified while the transfer is in progress.  On platforms with
+ *   a data cache, the I/O buffer sizes and the alignment of struct iob_s
+ *   must be selected accordingly.
+ *
+ ****************************************************************************/
+
+int iob_dmain(FAR struct iob_s *iob, unsigned int len,
+              FAR struct iob_dmaseg_s *segs, int nsegs, bool throttled,
+              enum iob_user_e consumerid)
+{
+  FAR struct iob_s *head = iob;
+  FAR struct iob_s *next;
+  unsigned int remaining = len;
+  unsigned int ncopy;
+  uintptr_t addr;
+  int nseg = 0;
+  int ret;
+
+  DEBUGASSERT(iob != NULL && segs != NULL);
+  DEBUGASSERT(iob->io_len == 0 && iob->io_flink == NULL);
+
+  if (len == 0 || len > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  for (; ; )
+    {
+      if (nseg >= nsegs)
+        {
+          ret = -E2BIG;
+          goto errout;
+        }
+
+      /* Give all of the space of this I/O buffer to the transfer */
+
+      addr         = (uintptr_t)IOB_DATA(iob);
+      ncopy        = MIN(IOB_BUFSIZE(iob) - iob->io_offset, remaining);
+      iob->io_len  = ncopy;
+
+      segs[nseg].addr = addr;
+      segs[nseg].len  = ncopy;
+      nseg++;
+
+      up_flush_dcache(addr, addr + ncopy);
+
+      remaining -= ncopy;
+      if (remaining == 0)
+        {
+          break;
+        }
+
+      /* Extend the chain */
+
+      next = iob_tryallocsize(remaining, throttled, consumerid);
+      if (next == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      iob->io_flink = next;
+      iob           = next;
+    }
+
+  head->io_pktlen = len;
+  return nseg;
+
+errout:
+  next             = head->io_flink;
+  head->io_flink   = NULL;
+  head->io_len     = 0;
+  head->io_pktlen  = 0;
+
+  if (next != NULL)
+    {
+      iob_free_chain(next, consumerid);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_dmain_complete
+ *
+ * Description:
+ *   Complete a DMA transfer into an I/O buffer chain prepared by
+ *   iob_dmain().  The data cache is invalidated over the 'rxlen' bytes that
+ *   were received and the chain is trimmed to that length, freeing any
+ *   unused buffers at the end of the chain.
+ *
+ * Input Parameters:
+ *   iob        - The I/O buffer chain prepared by iob_dmain()
+ *   rxlen      - The number of bytes received
+ *   producerid - The user of the I/O buffers
+ *
+ * Returned Value:
+ *   The I/O buffer chain holding the received data.  NULL is returned if
+ *   'rxlen' is zero; the entire chain has then been freed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_dmain_complete(FAR struct iob_s *iob,
+                                     unsigned int rxlen,
+                                     enum iob_user_e producerid)
+{
+  FAR struct iob_s *entry;
+  unsigned int remaining = rxlen;
+  unsigned int ncopy;
+  uintptr_t addr;
+
+  DEBUGASSERT(iob != NULL && rxlen <= iob->io_pktlen);
+
+  /* Discard any stale cache lines before the received data is accessed */
+
+  for (entry = iob; entry != NULL && remaining > 0; entry = entry->io_flink)
+    {
+      addr  = (uintptr_t)IOB_DATA(entry);
+      ncopy = MIN(entry->io_len, remaining);
+
+      up_invalidate_dcache(addr, addr + ncopy);
+      remaining -= ncopy;
+    }
+
+  /* Then remove the space that was not used */
+
+  return iob_trimtail(iob, iob->io_pktlen - rxlen, producerid);
+}
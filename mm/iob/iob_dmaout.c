@@ -0,0 +1,159 @@
+/****************************************************************************
+ * mm/iob/iob_dmaout.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_dmaout
+ *
+ * Description:
+ *   Describe 'len' bytes of data starting at 'offset' in the I/O buffer
+ *   chain as a list of segments for a scatter-gather DMA transfer out of
+ *   memory, i.e., for TX.  The data cache is cleaned over each segment so
+ *   that the DMA engine sees the current data.  No data is copied and the
+ *   I/O buffer chain is not modified; it must not be freed until the
+ *   transfer completes.
+ *
+ *   Empty I/O buffers are skipped and segments that happen to be adjacent
+ *   in memory are merged.
+ *
+ * Input Parameters:
+ *   iob    - The I/O buffer chain containing the data
+ *   len    - The number of bytes to transfer
+ *   offset - The offset to the first byte to transfer
+ *   segs   - The caller-provided array of segments to fill
+ *   nsegs  - The number of entries in 'segs'
+ *
+ * Returned Value:
+ *   The number of segments used (>= 0) or -E2BIG if more than 'nsegs'
+ *   segments would be needed.  Like iob_copyout(), fewer than 'len' bytes
+ *   are described if the chain does not hold that much data.
+ *
+ * Assumptions:
+ *   Addresses are returned as seen by the CPU.  On platforms where the DMA
+ *   engine uses different addresses, the driver must translate them.
+ *
+ ****************************************************************************/
+
+int iob_dmaout(FAR const struct iob_s *iob, unsigned int len,
+               unsigned int offset, FAR struct iob_dmaseg_s *segs,
+               int nsegs)
+{
+  FAR struct iob_dmaseg_s *seg = NULL;
+  unsigned int remaining;
+  unsigned int ncopy;
+  uintptr_t addr;
+  int nseg = 0;
+
+  DEBUGASSERT(iob != NULL && segs != NULL);
+
+  /* Skip to the I/O buffer containing the offset */
+
+  while (offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+      if (iob == NULL)
+        {
+          /* We have no requested data in iob chain */
+
+          return 0;
+        }
+    }
+
+  /* Then add one segment for each I/O buffer holding the requested data */
+
+  remaining = len;
+  while (iob && remaining > 0)
+    {
+      addr  = (uintptr_t)&iob->io_data[iob->io_offset + offset];
+      ncopy = MIN(iob->io_len - offset, remaining);
+
+      if (ncopy > 0)
+        {
+          if (seg != NULL && seg->addr + seg->len == addr)
+            {
+              /* Contiguous with the previous segment */
+
+              seg->len += ncopy;
+            }
+          else if (nseg < nsegs)
+            {
+              seg       = &segs[nseg++];
+              seg->addr = addr;
+              seg->len  = ncopy;
+            }
+          else
+            {
+              return -E2BIG;
+            }
+
+          up_clean_dcache(addr, addr + ncopy);
+          remaining -= ncopy;
+        }
+
+      /* Skip to the next I/O buffer in the chain */
+
+      iob    = iob->io_flink;
+      offset = 0;
+    }
+
+  return nseg;
+}
@@ -54,30 +54,66 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_IOB_NOTIFIER
-#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
-#    define IOB_DIVIDER 1
-#  elif CONFIG_IOB_NOTIFIER_DIV < 4
-#    define IOB_DIVIDER 2
-#  elif CONFIG_IOB_NOTIFIER_DIV < 8
-#    define IOB_DIVIDER 4
-#  elif CONFIG_IOB_NOTIFIER_DIV < 16
-#    define IOB_DIVIDER 8
-#  elif CONFIG_IOB_NOTIFIER_DIV < 32
-#    define IOB_DIVIDER 16
-#  elif CONFIG_IOB_NOTIFIER_DIV < 64
-#    define IOB_DIVIDER 32
-#  else
-#    define IOB_DIVIDER 64
-#  endif
-#endif
-
-#define IOB_MASK      (IOB_DIVIDER - 1)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return an I/O buffer to the free pool, or hand it over to a waiting
+ *   thread, and post the counting semaphores.  The caller must be in a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob)
+{
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()).
+   */
+
+  if (g_iob_sem.semcount < 0)
+    {
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+    }
+  else
+    {
+      mempool_free(&g_iob_pool, iob);
+    }
+
+  /* Signal that an IOB is available.  If there is a thread blocked,
+   * waiting for an IOB, this will wake up exactly one thread.  The
+   * semaphore count will correctly indicated that the awakened task
+   * owns an IOB and should find it in the committed list.
+   */
+
+  nxsem_post(&g_iob_sem);
+  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+  nxsem_post(&g_throttle_sem);
+  DEBUGASSERT(g_throttle_sem.semcount <= (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Signal any threads that have requested a signal notification when an
+   * IOB becomes available.  Only the free pool is considered here:  when
+   * I/O buffers are cached, the pool count always passes through a
+   * multiple of IOB_DIVIDER before buffers are cached again.
+   */
+
+  if (g_iob_sem.semcount > 0 && (g_iob_sem.semcount & IOB_MASK) == 0)
+    {
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -92,9 +128,6 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
 {
   FAR struct iob_s *next = iob->io_flink;
   irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -129,66 +162,49 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
               next, next->io_pktlen, next->io_len);
     }
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = enter_critical_section();
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()).
-   */
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* Large I/O buffers simply go back to their own pool */
 
-  if (g_iob_sem.semcount < 0)
+  if (IOB_BUFSIZE(iob) > CONFIG_IOB_BUFSIZE)
     {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-    }
-  else
-    {
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-    }
-
-  /* Signal that an IOB is available.  If there is a thread blocked,
-   * waiting for an IOB, this will wake up exactly one thread.  The
-   * semaphore count will correctly indicated that the awakened task
-   * owns an IOB and should find it in the committed list.
-   */
-
-  nxsem_post(&g_iob_sem);
-  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+      flags = enter_critical_section();
+      mempool_free(&g_iob_largepool, iob);
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
-  iob_stats_onfree(producerid);
+      iob_stats_onfree(producerid);
 #endif
 
-#if CONFIG_IOB_THROTTLE > 0
-  nxsem_post(&g_throttle_sem);
-  DEBUGASSERT(g_throttle_sem.semcount <= (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+      leave_critical_section(flags);
+      return next;
+    }
 #endif
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
+#ifdef CONFIG_IOB_CACHE
+  /* Keep the I/O buffer in the cache of this CPU if it is not needed in
+   * the common pool.
    */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (iob_cache_free(iob, producerid))
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
+      return next;
     }
 #endif
 
+  /* Free the I/O buffer by adding it to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+  iob_release(iob);
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  iob_stats_onfree(producerid);
+#endif
+
   leave_critical_section(flags);
 
   /* And return the I/O buffer after the one that was freed */
@@ -89,8 +89,7 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq)
     }
   else
     {
-      iobq->qe_flink   = g_iob_freeqlist;
-      g_iob_freeqlist  = iobq;
+      mempool_free(&g_iob_qpool, iobq);
     }
 
   /* Signal that an I/O buffer chain container is available.  If there
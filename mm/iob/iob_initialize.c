@@ -43,6 +43,7 @@
 
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
 
 #include "iob.h"
 
@@ -54,33 +55,56 @@
 #  define NULL ((FAR void *)0)
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* The storage of one large I/O buffer:  io_data[] extends into extra[] */
+
+struct iob_large_s
+{
+  struct iob_s iob;
+  uint8_t extra[CONFIG_IOB_LARGE_BUFSIZE - CONFIG_IOB_BUFSIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* This is a pool of pre-allocated I/O buffers */
 
-static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
+static struct iob_s        g_iob_buffers[CONFIG_IOB_NBUFFERS];
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static struct iob_large_s  g_iob_largebuffers[CONFIG_IOB_LARGE_NBUFFERS];
+#endif
 #if CONFIG_IOB_NCHAINS > 0
-static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
+static struct iob_qentry_s g_iob_qbuffers[CONFIG_IOB_NCHAINS];
 #endif
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* A list of all free, unallocated I/O buffers */
+/* The pool of all free, unallocated I/O buffers */
+
+struct mempool_s g_iob_pool;
 
-FAR struct iob_s *g_iob_freelist;
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* The pool of all free, unallocated large I/O buffers */
+
+struct mempool_s g_iob_largepool;
+#endif
 
 /* A list of I/O buffers that are committed for allocation */
 
 FAR struct iob_s *g_iob_committed;
 
 #if CONFIG_IOB_NCHAINS > 0
-/* A list of all free, unallocated I/O buffer queue containers */
+/* The pool of all free, unallocated I/O buffer queue containers */
 
-FAR struct iob_qentry_s *g_iob_freeqlist;
+struct mempool_s g_iob_qpool;
 
 /* A list of I/O buffer queue containers that are committed for allocation */
 
@@ -112,24 +136,45 @@ sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 void iob_initialize(void)
 {
   static bool initialized = false;
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
   int i;
+#endif
 
   /* Perform one-time initialization */
 
   if (!initialized)
     {
-      /* Add each I/O buffer to the free list */
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      /* Each I/O buffer remembers its size class.  This is preserved while
+       * the buffer is in a free list.
+       */
 
       for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
         {
-          FAR struct iob_s *iob = &g_iob_pool[i];
-
-          /* Add the pre-allocate I/O buffer to the head of the free list */
+          g_iob_buffers[i].io_bufsize = CONFIG_IOB_BUFSIZE;
+        }
 
-          iob->io_flink  = g_iob_freelist;
-          g_iob_freelist = iob;
+      for (i = 0; i < CONFIG_IOB_LARGE_NBUFFERS; i++)
+        {
+          g_iob_largebuffers[i].iob.io_bufsize = CONFIG_IOB_LARGE_BUFSIZE;
         }
 
+      /* Large I/O buffers are not counted by the semaphores */
+
+      (void)mempool_initialize(&g_iob_largepool, "ioblarge",
+                               g_iob_largebuffers,
+                               sizeof(struct iob_large_s),
+                               CONFIG_IOB_LARGE_NBUFFERS, 0, 0);
+#endif
+
+      /* Add each I/O buffer to the pool.  The pool cannot grow because
+       * the counting semaphores track the number of free I/O buffers.
+       */
+
+      (void)mempool_initialize(&g_iob_pool, "iob", g_iob_buffers,
+                               sizeof(struct iob_s), CONFIG_IOB_NBUFFERS,
+                               0, 0);
+
       g_iob_committed = NULL;
 
       nxsem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
@@ -138,17 +183,11 @@ void iob_initialize(void)
 #endif
 
 #if CONFIG_IOB_NCHAINS > 0
-      /* Add each I/O buffer chain queue container to the free list */
-
-      for (i = 0; i < CONFIG_IOB_NCHAINS; i++)
-        {
-          FAR struct iob_qentry_s *iobq = &g_iob_qpool[i];
-
-          /* Add the pre-allocate buffer container to the head of the free list */
+      /* Add each I/O buffer chain queue container to the pool */
 
-          iobq->qe_flink  = g_iob_freeqlist;
-          g_iob_freeqlist = iobq;
-        }
+      (void)mempool_initialize(&g_iob_qpool, "iobqentry", g_iob_qbuffers,
+                               sizeof(struct iob_qentry_s),
+                               CONFIG_IOB_NCHAINS, 0, 0);
 
       g_iob_qcommitted = NULL;
 
@@ -62,6 +62,9 @@ int iob_navail(bool throttled)
 {
   int navail = 0;
   int ret;
+#ifdef CONFIG_IOB_CACHE
+  int cpu;
+#endif
 
 #if CONFIG_IOB_NBUFFERS > 0
   /* Get the value of the IOB counting semaphores */
@@ -71,6 +74,15 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#ifdef CONFIG_IOB_CACHE
+      /* I/O buffers held in the per-CPU caches are available too */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          ret += g_iob_cache[cpu].ic_count;
+        }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * mm/mempool/mempool_alloc.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_remove
+ *
+ * Description:
+ *   Remove the block at the head of the free list.  The caller must hold
+ *   the lock of the pool.
+ *
+ ****************************************************************************/
+
+static inline FAR void *mempool_remove(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *blk = pool->freelist;
+
+  if (blk != NULL)
+    {
+      pool->freelist = blk->flink;
+      pool->nfree--;
+
+      if (pool->ntotal - pool->nfree > pool->npeak)
+        {
+          pool->npeak = pool->ntotal - pool->nfree;
+        }
+    }
+
+  return blk;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from a pool.  This may be called from interrupt
+ *   handlers.  The contents of the block are undefined.
+ *
+ *   Interrupt handlers may take any free block.  Task level allocations
+ *   leave the reserved blocks free.  If no unreserved block is free, a
+ *   task level allocation grows the pool by 'nexpand' blocks from the
+ *   kernel heap, if the pool may grow.  Memory added to a pool is never
+ *   returned to the heap.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated block or NULL if none is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  FAR void *blocks;
+  FAR void *blk = NULL;
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL);
+
+  flags = spin_lock_irqsave_scoped(&pool->lock);
+
+  if (pool->nfree > pool->nreserve || up_interrupt_context())
+    {
+      blk = mempool_remove(pool);
+    }
+
+  spin_unlock_irqrestore_scoped(&pool->lock, flags);
+
+  if (blk != NULL || pool->nexpand == 0 || up_interrupt_context())
+    {
+      return blk;
+    }
+
+  /* Grow the pool.  The heap may not be used from a critical section. */
+
+  blocks = kmm_malloc(pool->bsize * pool->nexpand);
+  if (blocks == NULL)
+    {
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave_scoped(&pool->lock);
+  mempool_addblocks(pool, blocks, pool->nexpand);
+  blk = mempool_remove(pool);
+  spin_unlock_irqrestore_scoped(&pool->lock, flags);
+
+  return blk;
+}
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * mm/mempool/mempool_initialize.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of all registered pools */
+
+FAR struct mempool_s *g_mempools;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_addblocks
+ *
+ * Description:
+ *   Add 'nblocks' contiguous blocks starting at 'blocks' to the free list
+ *   of a pool.  The caller must hold the lock of the pool.
+ *
+ ****************************************************************************/
+
+void mempool_addblocks(FAR struct mempool_s *pool, FAR void *blocks,
+                       unsigned int nblocks)
+{
+  FAR sq_entry_t *blk = (FAR sq_entry_t *)blocks;
+
+  DEBUGASSERT(pool->ntotal + nblocks <= UINT16_MAX);
+
+  pool->ntotal += nblocks;
+  pool->nfree  += nblocks;
+
+  for (; nblocks > 0; nblocks--)
+    {
+      blk->flink     = pool->freelist;
+      pool->freelist = blk;
+      blk            = (FAR sq_entry_t *)((FAR char *)blk + pool->bsize);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a pool of fixed-size blocks and register it so that its
+ *   statistics are reported in /proc/mempool.
+ *
+ * Input Parameters:
+ *   pool     - The pool to be initialized
+ *   name     - The name of the pool.  The string is not copied.
+ *   blocks   - The initial blocks, typically a static array.  If NULL, the
+ *              initial blocks are allocated from the kernel heap.
+ *   bsize    - The size of one block.  This is the stride between the
+ *              blocks in 'blocks' and must be at least sizeof(sq_entry_t).
+ *   nblocks  - The number of initial blocks
+ *   nreserve - The number of free blocks that only interrupt handlers may
+ *              allocate.
+ *   nexpand  - The number of blocks to allocate from the kernel heap when
+ *              a task level allocation finds no free block.  Zero if the
+ *              pool may not grow.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the initial blocks could not be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       FAR void *blocks, size_t bsize, unsigned int nblocks,
+                       unsigned int nreserve, unsigned int nexpand)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && bsize >= sizeof(sq_entry_t));
+  DEBUGASSERT(nreserve <= UINT16_MAX && nexpand <= UINT16_MAX);
+
+  pool->name     = name;
+  pool->freelist = NULL;
+  pool->bsize    = bsize;
+  pool->ntotal   = 0;
+  pool->nfree    = 0;
+  pool->npeak    = 0;
+  pool->nreserve = nreserve;
+  pool->nexpand  = nexpand;
+#ifdef CONFIG_SPINLOCK_SCOPED
+  spin_initialize(&pool->lock, SP_UNLOCKED);
+#endif
+
+  if (blocks == NULL && nblocks > 0)
+    {
+      blocks = kmm_malloc(bsize * nblocks);
+      if (blocks == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* The pool is not visible to anybody else yet, so its lock is not
+   * needed here.
+   */
+
+  mempool_addblocks(pool, blocks, nblocks);
+
+  /* Register the pool */
+
+  flags       = enter_critical_section();
+  pool->flink = g_mempools;
+  g_mempools  = pool;
+  leave_critical_section(flags);
+
+  return OK;
+}
@@ -56,8 +56,41 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
-#define SIZEOF_GRAN_S(n) \
+
+#ifdef CONFIG_GRAN_SUMMARY
+/* The summary bitmap holds one bit per GAT entry and follows the GAT */
+
+#  define SIZEOF_SUMMARY(n) \
+  ((SIZEOF_GAT(n) + 31) >> 5)
+#  define SIZEOF_GRAN_S(n) \
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_SUMMARY(n) - 1))
+#else
+#  define SIZEOF_GRAN_S(n) \
   (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+#endif
+
+/* Update the summary bit of GAT entry 'i' after the entry was modified.
+ * The bit is set if all of the granules of the entry are allocated.
+ */
+
+#ifdef CONFIG_GRAN_SUMMARY
+#  define gran_summary_update(p,i) \
+  do \
+    { \
+      if ((p)->gat[i] == 0xffffffff) \
+        { \
+          (p)->summary[(i) >> 5] |= (uint32_t)1 << ((i) & 31); \
+        } \
+      else \
+        { \
+          (p)->summary[(i) >> 5] &= ~((uint32_t)1 << ((i) & 31)); \
+        } \
+    } \
+  while (0)
+#else
+#  define gran_summary_update(p,i)
+#endif
 
 /* Debug */
 
@@ -99,6 +132,9 @@ struct gran_s
   sem_t      exclsem;   /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+#ifdef CONFIG_GRAN_SUMMARY
+  FAR uint32_t *summary; /* One bit per fully allocated GAT entry */
+#endif
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
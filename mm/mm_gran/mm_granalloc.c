@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
 #include <assert.h>
 
 #include <nuttx/mm/gran.h>
@@ -47,6 +48,106 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_nextavail
+ *
+ * Description:
+ *   Return the index of the first GAT entry at or after 'gatidx' that has
+ *   at least one free granule, or 'ngat' if there is none.  With
+ *   CONFIG_GRAN_SUMMARY, the summary bitmap is used to skip 32 fully
+ *   allocated GAT entries at a time.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_nextavail(FAR struct gran_s *priv,
+                                   unsigned int gatidx, unsigned int ngat)
+{
+#ifdef CONFIG_GRAN_SUMMARY
+  unsigned int sumidx;
+  uint32_t     avail;
+
+  while (gatidx < ngat)
+    {
+      /* Find the first entry of this summary word that is not full */
+
+      sumidx = gatidx >> 5;
+      avail  = ~priv->summary[sumidx] & (0xffffffff << (gatidx & 31));
+      if (avail != 0)
+        {
+          gatidx = (sumidx << 5) + ffs((int)avail) - 1;
+          break;
+        }
+
+      gatidx = (sumidx + 1) << 5;
+    }
+#else
+  while (gatidx < ngat && priv->gat[gatidx] == 0xffffffff)
+    {
+      gatidx++;
+    }
+#endif
+
+  return gatidx < ngat ? gatidx : ngat;
+}
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Find the first run of 'ngranules' free granules that starts in the GAT
+ *   entry 'curr'.  The run may continue into the following entry, 'next'.
+ *
+ * Returned Value:
+ *   The bit index of the start of the run in 'curr', or -1 if there is no
+ *   such run.
+ *
+ ****************************************************************************/
+
+static int gran_search(uint32_t curr, uint32_t next, unsigned int ngranules)
+{
+  uint32_t     runs;
+  unsigned int len;
+  unsigned int shift;
+  unsigned int lead;
+  unsigned int trail;
+
+  /* Bit n of 'runs' is set if granule n is free.  Each step below doubles
+   * the length of the free run that ends at each bit, so that bit n is set
+   * only if granules n through n + ngranules - 1 are all free.  Bits that
+   * would need granules beyond the MS bit are shifted out.
+   */
+
+  runs = ~curr;
+  for (len = 1; len < ngranules && runs != 0; len += shift)
+    {
+      shift = len < ngranules - len ? len : ngranules - len;
+      runs &= runs >> shift;
+    }
+
+  if (runs != 0)
+    {
+      return ffs((int)runs) - 1;
+    }
+
+  /* Otherwise, the run could start in the free MS bits of 'curr' and
+   * continue in the free LS bits of 'next'.
+   */
+
+  lead  = 32 - fls((int)curr);
+  trail = next != 0 ? ffs((int)next) - 1 : 32;
+
+  if (lead > 0 && lead + trail >= ngranules)
+    {
+      return 32 - lead;
+    }
+
+  return -1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -75,15 +176,13 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
   unsigned int ngranules;
+  unsigned int granno;
+  unsigned int ngat;
+  unsigned int gatidx;
   size_t       tmpmask;
   uintptr_t    alloc;
-  uint32_t     curr;
   uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
   int          bitidx;
-  int          shift;
 
   DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
 
@@ -98,154 +197,49 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
       tmpmask   = (1 << priv->log2gran) - 1;
       ngranules = (size + tmpmask) >> priv->log2gran;
 
-      /* Then create mask for that number of granules */
-
       DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
 
-      /* Now search the granule allocation table for that number of contiguous */
+      /* Now search the granule allocation table for that number of
+       * contiguous free granules, one GAT entry at a time.  Fully
+       * allocated entries cannot hold the start of a run and are skipped.
+       */
 
-      alloc = priv->heapstart;
+      ngat = SIZEOF_GAT(priv->ngranules);
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      for (gatidx = gran_nextavail(priv, 0, ngat);
+           gatidx < ngat;
+           gatidx = gran_nextavail(priv, gatidx + 1, ngat))
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
+          /* Use all ones after the last entry in the GAT (meaning nothing
+           * can be allocated there).
+           */
 
-          if (curr == 0xffffffff)
+          next   = gatidx + 1 < ngat ? priv->gat[gatidx + 1] : 0xffffffff;
+          bitidx = gran_search(priv->gat[gatidx], next, ngranules);
+          if (bitidx < 0)
             {
-              alloc += (32 << priv->log2gran);
               continue;
             }
 
-          /* Get the next entry from the GAT to support a 64 bit shift */
-
-          if (granidx < priv->ngranules)
-            {
-              next = priv->gat[gatidx + 1];
-            }
-
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
+          /* Any later run would start at a still higher granule, so give
+           * up if this one extends beyond the end of the heap.
            */
 
-          else
+          granno = (gatidx << 5) + bitidx;
+          if (granno + ngranules > priv->ngranules)
             {
-              next = 0xffffffff;
+              break;
             }
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
+          /* Mark these granules allocated and return the allocation
+           * address.
            */
 
-          for (bitidx = 0;
-               bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Check if we have the allocation at this bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+          alloc = priv->heapstart + ((uintptr_t)granno << priv->log2gran);
+          gran_mark_allocated(priv, alloc, ngranules);
+
+          gran_leave_critical(priv);
+          return (FAR void *)alloc;
         }
 
       gran_leave_critical(priv);
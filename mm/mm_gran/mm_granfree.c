@@ -110,6 +110,7 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
 
       priv->gat[gatidx] &= ~gatmask;
+      gran_summary_update(priv, gatidx);
       ngranules -= avail;
 
       /* Clear bits in the second GAT entry */
@@ -118,6 +119,7 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
       DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == gatmask);
 
       priv->gat[gatidx+1] &= ~gatmask;
+      gran_summary_update(priv, gatidx + 1);
     }
 
   /* Handle the case where where all of the granules came from one entry */
@@ -131,6 +133,7 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
 
       priv->gat[gatidx] &= ~gatmask;
+      gran_summary_update(priv, gatidx);
     }
 
   gran_leave_critical(priv);
@@ -149,6 +149,9 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
       priv->log2gran  = log2gran;
       priv->ngranules = ngranules;
       priv->heapstart = alignedstart;
+#ifdef CONFIG_GRAN_SUMMARY
+      priv->summary   = &priv->gat[SIZEOF_GAT(ngranules)];
+#endif
 
       /* Initialize mutual exclusion support */
 
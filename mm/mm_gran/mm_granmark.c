@@ -96,6 +96,7 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
 
       priv->gat[gatidx] |= gatmask;
+      gran_summary_update(priv, gatidx);
       ngranules -= avail;
 
       /* Mark bits in the second GAT entry */
@@ -104,6 +105,7 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
       DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == 0);
 
       priv->gat[gatidx+1] |= gatmask;
+      gran_summary_update(priv, gatidx + 1);
     }
 
   /* Handle the case where where all of the granules come from one entry */
@@ -117,6 +119,7 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
 
       priv->gat[gatidx] |= gatmask;
+      gran_summary_update(priv, gatidx);
       return;
     }
 }
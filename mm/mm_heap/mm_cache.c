@@ -0,0 +1,345 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The per-CPU lists are protected by disabling local interrupts only.  Once
+ * interrupts are disabled, the current task cannot be suspended or moved to
+ * another CPU, so the CPU index remains valid until interrupts are restored.
+ */
+
+#ifdef CONFIG_SMP
+#  define mm_thiscache(h) (&(h)->mm_cache[up_cpu_index()])
+#else
+#  define mm_thiscache(h) (&(h)->mm_cache[0])
+#endif
+
+#if CONFIG_MM_CACHE_BATCH > CONFIG_MM_CACHE_DEPTH
+#  error CONFIG_MM_CACHE_BATCH must not exceed CONFIG_MM_CACHE_DEPTH
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef MM_HAVE_CACHE
+
+/****************************************************************************
+ * Name: mm_cacherefill
+ *
+ * Description:
+ *   The cache class for 'alignsize' is empty on this CPU.  Allocate a batch
+ *   of chunks from the heap while holding the MM semaphore only once.  One
+ *   chunk is returned to the caller, the rest are added to the cache.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_cacherefill(FAR struct mm_heap_s *heap,
+                                size_t alignsize)
+{
+  FAR struct mm_cachenode_s *head = NULL;
+  FAR struct mm_cachenode_s *tail = NULL;
+  FAR struct mm_cachenode_s *node;
+  FAR struct mm_cache_s *cache;
+  FAR void *ret;
+  irqstate_t flags;
+  int ndx = MM_CACHE_NDX(alignsize);
+  int count;
+
+  mm_takesemaphore(heap);
+
+  ret = mm_allocchunk(heap, alignsize);
+  if (ret == NULL)
+    {
+      mm_givesemaphore(heap);
+      return NULL;
+    }
+
+  for (count = 1; count < CONFIG_MM_CACHE_BATCH; count++)
+    {
+      node = (FAR struct mm_cachenode_s *)mm_allocchunk(heap, alignsize);
+      if (node == NULL)
+        {
+          break;
+        }
+
+      node->flink = head;
+      head        = node;
+      if (tail == NULL)
+        {
+          tail = node;
+        }
+    }
+
+  mm_givesemaphore(heap);
+
+  /* Add the rest of the batch to the cache of whichever CPU we are running
+   * on now; we may have migrated while waiting for the semaphore.
+   */
+
+  if (head != NULL)
+    {
+      flags                 = up_irq_save();
+      cache                 = mm_thiscache(heap);
+      tail->flink           = cache->mc_head[ndx];
+      cache->mc_head[ndx]   = head;
+      cache->mc_count[ndx] += count - 1;
+      up_irq_restore(flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cachedrain
+ *
+ * Description:
+ *   Return a batch of chunks from one cache class to the heap, holding the
+ *   MM semaphore only once.
+ *
+ ****************************************************************************/
+
+static void mm_cachedrain(FAR struct mm_heap_s *heap,
+                          FAR struct mm_cachenode_s *head)
+{
+  FAR struct mm_cachenode_s *next;
+
+  mm_takesemaphore(heap);
+
+  for (; head != NULL; head = next)
+    {
+      next = head->flink;
+      mm_freechunk(heap, head);
+    }
+
+  mm_givesemaphore(heap);
+}
+
+#endif /* MM_HAVE_CACHE */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cacheinitialize
+ *
+ * Description:
+ *   Initialize the per-CPU small-object caches of a heap.
+ *
+ ****************************************************************************/
+
+void mm_cacheinitialize(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+}
+
+#ifdef MM_HAVE_CACHE
+
+/****************************************************************************
+ * Name: mm_cachealloc
+ *
+ * Description:
+ *   Allocate a chunk of exactly 'alignsize' bytes from the small-object
+ *   cache of the current CPU, refilling the cache from the heap if it is
+ *   empty.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The aligned chunk size, no larger than MM_CACHE_MAXCHUNK
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *mm_cachealloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cachenode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  int ndx;
+
+  DEBUGASSERT(alignsize <= MM_CACHE_MAXCHUNK);
+  ndx = MM_CACHE_NDX(alignsize);
+
+  flags = up_irq_save();
+  cache = mm_thiscache(heap);
+  node  = cache->mc_head[ndx];
+  if (node != NULL)
+    {
+      cache->mc_head[ndx] = node->flink;
+      cache->mc_count[ndx]--;
+      cache->mc_hits++;
+      up_irq_restore(flags);
+      return node;
+    }
+
+  cache->mc_misses++;
+  up_irq_restore(flags);
+
+  return mm_cacherefill(heap, alignsize);
+}
+
+/****************************************************************************
+ * Name: mm_cachefree
+ *
+ * Description:
+ *   Return a chunk to the small-object cache of the current CPU if it is of
+ *   a cacheable size.  If the cache class overflows, a batch of chunks is
+ *   drained back to the heap.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *   mem  - The memory to be freed (not NULL)
+ *
+ * Returned Value:
+ *   true if the chunk was taken by the cache; false if the caller must
+ *   return it to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cachefree(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *alloc;
+  FAR struct mm_cachenode_s *drain = NULL;
+  FAR struct mm_cachenode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  int ndx;
+  int i;
+
+  alloc = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(alloc->preceding & MM_ALLOC_BIT);
+
+  if (alloc->size > MM_CACHE_MAXCHUNK)
+    {
+      return false;
+    }
+
+  ndx  = MM_CACHE_NDX(alloc->size);
+  node = (FAR struct mm_cachenode_s *)mem;
+
+  flags               = up_irq_save();
+  cache               = mm_thiscache(heap);
+  node->flink         = cache->mc_head[ndx];
+  cache->mc_head[ndx] = node;
+
+  if (++cache->mc_count[ndx] > CONFIG_MM_CACHE_DEPTH)
+    {
+      /* Detach a batch of chunks to be returned to the heap */
+
+      drain = cache->mc_head[ndx];
+      for (i = 1; i < CONFIG_MM_CACHE_BATCH; i++)
+        {
+          node = node->flink;
+        }
+
+      cache->mc_head[ndx]   = node->flink;
+      cache->mc_count[ndx] -= CONFIG_MM_CACHE_BATCH;
+      node->flink           = NULL;
+    }
+
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      mm_cachedrain(heap, drain);
+    }
+
+  return true;
+}
+
+#endif /* MM_HAVE_CACHE */
+
+/****************************************************************************
+ * Name: mm_cacheinfo
+ *
+ * Description:
+ *   Add the small-object cache statistics of a heap to 'info'.  Chunks held
+ *   in the caches are accounted as allocated by mm_mallinfo(); the number
+ *   of bytes that they occupy is reported separately.
+ *
+ ****************************************************************************/
+
+void mm_cacheinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
+{
+  FAR struct mm_cache_s *cache;
+  unsigned long hits = 0;
+  unsigned long misses = 0;
+  size_t cached = 0;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < MM_CACHE_NCPUS; cpu++)
+    {
+      cache   = &heap->mm_cache[cpu];
+      hits   += cache->mc_hits;
+      misses += cache->mc_misses;
+
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          cached += MM_CACHE_SIZE(ndx) * cache->mc_count[ndx];
+        }
+    }
+
+  info->cachedblks  = cached;
+  info->cachehits   = hits;
+  info->cachemisses = misses;
+}
+
+#endif /* CONFIG_MM_CACHE */
@@ -105,6 +105,9 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
    */
 
   oldnode->size = size;
+#ifdef CONFIG_MM_TRACE
+  oldnode->pid  = MM_TRACE_NOPID;
+#endif
 
   /* The old node should already be marked as allocated */
 
@@ -115,6 +118,9 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   newnode            = (FAR struct mm_allocnode_s *)(blockend - SIZEOF_MM_ALLOCNODE);
   newnode->size      = SIZEOF_MM_ALLOCNODE;
   newnode->preceding = oldnode->size | MM_ALLOC_BIT;
+#ifdef CONFIG_MM_TRACE
+  newnode->pid       = MM_TRACE_NOPID;
+#endif
 
   heap->mm_heapend[region] = newnode;
   mm_givesemaphore(heap);
@@ -122,6 +122,11 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]->size        = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
 
+#ifdef CONFIG_MM_TRACE
+  heap->mm_heapstart[IDX]->pid       = MM_TRACE_NOPID;
+  heap->mm_heapend[IDX]->pid         = MM_TRACE_NOPID;
+#endif
+
 #undef IDX
 
 #if CONFIG_MM_REGIONS > 1
@@ -155,7 +160,9 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
                    size_t heapsize)
 {
+#ifndef CONFIG_MM_TLSF
   int i;
+#endif
 
   minfo("Heap: start=%p size=%u\n", heapstart, heapsize);
 
@@ -177,6 +184,11 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_nregions = 0;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Initialize the TLSF free lists and bitmaps */
+
+  mm_tlsf_initialize(heap);
+#else
   /* Initialize the node array */
 
   memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
@@ -185,6 +197,7 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
       heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
     }
+#endif
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
@@ -192,6 +205,33 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   mm_seminitialize(heap);
 
+#ifdef CONFIG_MM_TRACE
+  /* Initialize the allocation tracing state */
+
+  mm_traceinitialize(heap);
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Initialize the per-CPU small-object caches */
+
+  mm_cacheinitialize(heap);
+#endif
+
+#ifdef CONFIG_MM_REALLOC_STATS
+  heap->mm_reallocinplace = 0;
+  heap->mm_reallocmoved   = 0;
+  heap->mm_realloccopied  = 0;
+#endif
+
+#ifdef CONFIG_MM_HEAPSTATS
+  heap->mm_nsearches  = 0;
+  heap->mm_nscanned   = 0;
+  heap->mm_maxscanned = 0;
+  heap->mm_maxsemwait = 0;
+  heap->mm_maxmalloc  = 0;
+  heap->mm_maxfree    = 0;
+#endif
+
   /* Add the initial region of memory to the heap */
 
   mm_addregion(heap, heapstart, heapsize);
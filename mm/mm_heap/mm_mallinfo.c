@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -126,5 +127,133 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   info->mxordblk = mxordblk;
   info->uordblks = uordblks;
   info->fordblks = fordblks;
+
+#ifdef CONFIG_MM_CACHE
+  mm_cacheinfo(heap, info);
+#endif
+
+#ifdef CONFIG_MM_REALLOC_STATS
+  info->reallocinplace = heap->mm_reallocinplace;
+  info->reallocmoved   = heap->mm_reallocmoved;
+  info->realloccopied  = heap->mm_realloccopied;
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_tracewalk
+ *
+ * Description:
+ *   Call 'handler' for each allocated chunk of the heap that is tagged with
+ *   an owner.  The MM semaphore is held while the handler runs, so the
+ *   handler must not use the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TRACE
+void mm_tracewalk(FAR struct mm_heap_s *heap, mm_tracewalk_t handler,
+                  FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(handler);
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Visit each node in the region
+       * Retake the semaphore for each region to reduce latencies
+       */
+
+      mm_takesemaphore(heap);
+
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + node->size))
+        {
+          if ((node->preceding & MM_ALLOC_BIT) != 0 &&
+              node->pid != MM_TRACE_NOPID)
+            {
+              handler(node, arg);
+            }
+        }
+
+      mm_givesemaphore(heap);
+    }
+#undef region
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_heapstats
+ *
+ * Description:
+ *   Return a snapshot of the heap statistics:  A histogram of the free
+ *   chunks binned by size and the search and latency measurements gathered
+ *   by the allocator.  The histogram is an exact picture of the heap taken
+ *   by walking all chunks; it shows how fragmented the free memory is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAPSTATS
+int mm_heapstats(FAR struct mm_heap_s *heap,
+                 FAR struct mm_heapstats_s *stats)
+{
+  FAR struct mm_allocnode_s *node;
+  int ndx;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(stats);
+
+  memset(stats, 0, sizeof(struct mm_heapstats_s));
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Visit each node in the region
+       * Retake the semaphore for each region to reduce latencies
+       */
+
+      mm_takesemaphore(heap);
+
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + node->size))
+        {
+          if ((node->preceding & MM_ALLOC_BIT) == 0)
+            {
+              ndx = mm_size2ndx(node->size);
+              stats->nfree[ndx]++;
+              stats->freesize[ndx] += node->size;
+            }
+        }
+
+      mm_givesemaphore(heap);
+    }
+#undef region
+
+  stats->nsearches  = heap->mm_nsearches;
+  stats->nscanned   = heap->mm_nscanned;
+  stats->maxscanned = heap->mm_maxscanned;
+  stats->maxsemwait = heap->mm_maxsemwait;
+  stats->maxmalloc  = heap->mm_maxmalloc;
+  stats->maxfree    = heap->mm_maxfree;
   return OK;
 }
+#endif
@@ -44,6 +44,7 @@
 #include <debug.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -59,41 +60,41 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *   Find the smallest chunk that satisfies the request. Take the memory from
+ *   that chunk, save the remaining, smaller chunk (if any).
  *
- *  8-byte alignment of the allocated data is assured.
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The size of the chunk, including the allocated node header.
+ *               This must be an even multiple of the granule size.
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
   void *ret = NULL;
+#ifndef CONFIG_MM_TLSF
   int ndx;
+#endif
+#ifdef CONFIG_MM_HEAPSTATS
+  uint32_t nscanned = 1;
+#endif
 
-  /* Ignore zero-length allocations */
-
-  if (size < 1)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
-   */
-
-  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
+#ifdef CONFIG_MM_TLSF
+  /* Find a free chunk that is large enough using the TLSF bitmaps */
 
+  node = mm_tlsf_search(heap, alignsize);
+#else
   /* Get the location in the node list to start the search. Special case
    * really big allocations
    */
@@ -116,7 +117,19 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   for (node = heap->mm_nodelist[ndx].flink;
        node && node->size < alignsize;
-       node = node->flink);
+       node = node->flink)
+    {
+#ifdef CONFIG_MM_HEAPSTATS
+      nscanned++;
+#endif
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAPSTATS
+  heap->mm_nsearches++;
+  heap->mm_nscanned += nscanned;
+  MM_HEAPSTATS_MAX(heap->mm_maxscanned, nscanned);
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
@@ -129,16 +142,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -180,10 +186,79 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->preceding |= MM_ALLOC_BIT;
+#ifdef CONFIG_MM_TRACE
+      node->pid        = MM_TRACE_NOPID;
+#endif
       ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
     }
 
-  mm_givesemaphore(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  size_t alignsize;
+  void *ret = NULL;
+#ifdef MM_HAVE_LATENCY
+  uint32_t start = up_critmon_gettime();
+  uint32_t elapsed;
+#endif
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+
+#ifdef MM_HAVE_CACHE
+  /* Small allocations are satisfied from the per-CPU cache when possible.
+   * The cache refills itself from the heap in batches when it is empty.
+   */
+
+  if (alignsize <= MM_CACHE_MAXCHUNK)
+    {
+      ret = mm_cachealloc(heap, alignsize);
+    }
+  else
+#endif
+    {
+      /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+      mm_takesemaphore(heap);
+      ret = mm_allocchunk(heap, alignsize);
+      mm_givesemaphore(heap);
+    }
+
+#ifdef CONFIG_MM_TRACE
+  if (ret)
+    {
+      mm_tracealloc(heap, ret, MM_TRACE_CALLER());
+    }
+#endif
+
+#ifdef MM_HAVE_LATENCY
+  elapsed = up_critmon_gettime() - start;
+  MM_HEAPSTATS_MAX(heap->mm_maxmalloc, elapsed);
+#endif
 
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   if (ret)
@@ -68,6 +68,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   size_t alignedchunk;
   size_t mask = (size_t)(alignment - 1);
   size_t allocsize;
+#ifdef CONFIG_MM_TRACE
+  size_t rawsize;
+#endif
 
   /* If this requested alinement's less than or equal to the natural alignment
    * of malloc, then just let malloc do the work.
@@ -113,6 +116,11 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   node = (FAR struct mm_allocnode_s *)(rawchunk - SIZEOF_MM_ALLOCNODE);
 
+#ifdef CONFIG_MM_TRACE
+  rawsize = node->size;
+  node->caller = MM_TRACE_CALLER();
+#endif
+
   /* Find the aligned subregion */
 
   alignedchunk = (rawchunk + mask) & ~mask;
@@ -160,6 +168,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
       /* Set up the size of the new node */
 
+#ifdef CONFIG_MM_TRACE
+      MM_TRACE_COPY(newnode, node);
+#endif
       newnode->size = (size_t)next - (size_t)newnode;
       newnode->preceding = precedingsize | MM_ALLOC_BIT;
 
@@ -205,6 +216,10 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size);
     }
 
+#ifdef CONFIG_MM_TRACE
+  mm_traceresize(heap, (FAR void *)alignedchunk, rawsize);
+#endif
+
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
@@ -64,8 +64,12 @@
  *  extended, it will be extended by:
  *
  *     (1) Taking the additional space from the following free chunk, or
- *     (2) Taking the additional space from the preceding free chunk.
- *     (3) Or both
+ *     (2) Taking all of the following free chunk (if any) and the rest from
+ *         the preceding free chunk.
+ *
+ *  The following chunk is always preferred since growing into it does not
+ *  move the data.  Only when the preceding chunk is used must the data be
+ *  moved down in memory.
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
@@ -81,8 +85,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   FAR struct mm_freenode_s  *next;
   size_t newsize;
   size_t oldsize;
+  size_t copysize;
   size_t prevsize = 0;
   size_t nextsize = 0;
+#ifdef CONFIG_MM_TRACE
+  size_t origsize;
+#endif
   FAR void *newmem;
 
   /* If oldmem is NULL, then realloc is equivalent to malloc */
@@ -116,7 +124,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   /* Check if this is a request to reduce the size of the allocation. */
 
-  oldsize = oldnode->size;
+  oldsize  = oldnode->size;
+  copysize = oldsize - SIZEOF_MM_ALLOCNODE;
+#ifdef CONFIG_MM_TRACE
+  origsize = oldsize;
+#endif
+
   if (newsize <= oldsize)
     {
       /* Handle the special case where we are not going to change the size
@@ -126,8 +139,15 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       if (newsize < oldsize)
         {
           mm_shrinkchunk(heap, oldnode, newsize);
+#ifdef CONFIG_MM_TRACE
+          mm_traceresize(heap, oldmem, oldsize);
+#endif
         }
 
+#ifdef CONFIG_MM_REALLOC_STATS
+      heap->mm_reallocinplace++;
+#endif
+
       /* Then return the original address */
 
       mm_givesemaphore(heap);
@@ -159,58 +179,32 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
+      /* Take as much as possible from the next chunk and only the remainder
+       * (if any) from the previous chunk.
        */
 
-      if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1))
+      if (nextsize >= needed)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
-
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = needed;
-              takenext = 0;
-            }
-
-          needed = 0;
+          takenext = needed;
+        }
+      else
+        {
+          takenext = nextsize;
+          takeprev = needed - nextsize;
         }
 
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
+      /* Never leave a remainder that is too small to hold a free node; just
+       * absorb it into the allocation instead.
        */
 
-      if (nextsize > 0 && needed)
+      if (nextsize - takenext < SIZEOF_MM_FREENODE)
         {
-          /* Can we get everything we need from the next chunk? */
-
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
-
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
+          takenext = nextsize;
+        }
 
-              takeprev = 0;
-              takenext = needed;
-            }
+      if (takeprev > 0 && prevsize - takeprev < SIZEOF_MM_FREENODE)
+        {
+          takeprev = prevsize;
         }
 
       /* Extend into the previous free chunk */
@@ -220,20 +214,16 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
           newnode = (FAR struct mm_allocnode_s *)((FAR char *)oldnode - takeprev);
+#ifdef CONFIG_MM_TRACE
+          MM_TRACE_COPY(newnode, oldnode);
+#endif
 
           /* Did we consume the entire preceding chunk? */
 
@@ -266,12 +256,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           oldnode = newnode;
           oldsize = newnode->size;
 
-          /* Now we have to move the user contents 'down' in memory.  memcpy should
-           * should be save for this.
+          /* Now we have to move the user contents 'down' in memory.  The
+           * regions may overlap.
            */
 
           newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-          memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+          memmove(newmem, oldmem, copysize);
         }
 
       /* Extend into the next free chunk */
@@ -287,16 +277,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
           andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -327,6 +310,21 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+#ifdef CONFIG_MM_TRACE
+      mm_traceresize(heap, newmem, origsize);
+#endif
+
+#ifdef CONFIG_MM_REALLOC_STATS
+      if (takeprev)
+        {
+          heap->mm_reallocmoved++;
+        }
+      else
+        {
+          heap->mm_reallocinplace++;
+        }
+#endif
+
       mm_givesemaphore(heap);
       return newmem;
     }
@@ -339,11 +337,18 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
        * leave the original memory in place.
        */
 
+#ifdef CONFIG_MM_REALLOC_STATS
+      heap->mm_realloccopied++;
+#endif
+
       mm_givesemaphore(heap);
       newmem = (FAR void *)mm_malloc(heap, size);
       if (newmem)
         {
-          memcpy(newmem, oldmem, oldsize);
+#ifdef CONFIG_MM_TRACE
+          MM_TRACE_SETCALLER(newmem, MM_TRACE_CALLER());
+#endif
+          memcpy(newmem, oldmem, copysize);
           mm_free(heap, oldmem);
         }
 
@@ -45,6 +45,7 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/mm.h>
 
@@ -241,6 +242,10 @@ void mm_takesemaphore(FAR struct mm_heap_s *heap)
     }
   else
     {
+#ifdef MM_HAVE_LATENCY
+      uint32_t start = up_critmon_gettime();
+      uint32_t elapsed;
+#endif
       int ret;
 
       /* Take the semaphore (perhaps waiting) */
@@ -273,6 +278,11 @@ void mm_takesemaphore(FAR struct mm_heap_s *heap)
 
       heap->mm_holder      = my_pid;
       heap->mm_counts_held = 1;
+
+#ifdef MM_HAVE_LATENCY
+      elapsed = up_critmon_gettime() - start;
+      MM_HEAPSTATS_MAX(heap->mm_maxsemwait, elapsed);
+#endif
     }
 
 #ifdef CONFIG_SMP
@@ -0,0 +1,265 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The first level index of a chunk is the position of its most significant
+ * bit, relative to MM_MIN_SHIFT.  All chunks of MM_MAX_CHUNK bytes or more
+ * share the last first level list (second level index 0) and that list is
+ * searched linearly.
+ */
+
+#define MM_TLSF_FLLARGE   (MM_NNODES - 1)
+#define MM_TLSF_SLMASK    (MM_TLSF_SLCOUNT - 1)
+
+#if MM_NNODES > 32
+#  error The TLSF first level bitmap holds at most 32 entries
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Map a chunk size to its first and second level indices.
+ *
+ ****************************************************************************/
+
+static void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_TLSF_FLLARGE;
+      *sl = 0;
+      return;
+    }
+
+  msb = fls((int)size) - 1;
+  if (msb >= MM_TLSF_SLBITS)
+    {
+      *sl = (int)(size >> (msb - MM_TLSF_SLBITS)) & MM_TLSF_SLMASK;
+    }
+  else
+    {
+      *sl = (int)(size << (MM_TLSF_SLBITS - msb)) & MM_TLSF_SLMASK;
+    }
+
+  *fl = msb - MM_MIN_SHIFT;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_initialize
+ *
+ * Description:
+ *   Initialize the TLSF free lists and bitmaps of a heap.
+ *
+ ****************************************************************************/
+
+void mm_tlsf_initialize(FAR struct mm_heap_s *heap)
+{
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+}
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the free list of its size class.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *next;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  next        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = next;
+
+  if (next)
+    {
+      next->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slbitmap[fl]    |= (uint32_t)1 << sl;
+  heap->mm_flbitmap        |= (uint32_t)1 << fl;
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the free list of its size class.  The size of
+ *   the chunk must not have changed since it was added.  It is assumed that
+ *   the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+      heap->mm_freelist[fl][sl] = node->flink;
+    }
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  /* Update the bitmaps if the list is now empty */
+
+  if (heap->mm_freelist[fl][sl] == NULL)
+    {
+      heap->mm_slbitmap[fl] &= ~((uint32_t)1 << sl);
+      if (heap->mm_slbitmap[fl] == 0)
+        {
+          heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_search
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The size is first rounded
+ *   up to the next size class so that every chunk in the selected list, or
+ *   in any larger non-empty list, is large enough.  The lists are then
+ *   selected with the bitmaps.  The chunk is not removed from its list.
+ *
+ *   It is assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap,
+                                         size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  size_t roundup = size;
+  uint32_t bitmap;
+  int msb;
+  int fl;
+  int sl;
+
+  if (size < MM_MAX_CHUNK)
+    {
+      msb = fls((int)size) - 1;
+      if (msb > MM_TLSF_SLBITS)
+        {
+          roundup += ((size_t)1 << (msb - MM_TLSF_SLBITS)) - 1;
+        }
+    }
+
+  mm_tlsf_mapping(roundup, &fl, &sl);
+
+  /* Look for a non-empty list in this first level range first */
+
+  bitmap = heap->mm_slbitmap[fl] & ~(((uint32_t)1 << sl) - 1);
+  if (bitmap == 0)
+    {
+      /* Then in the larger first level ranges */
+
+      bitmap = heap->mm_flbitmap & ~(((uint32_t)2 << fl) - 1);
+      if (bitmap == 0)
+        {
+          return NULL;
+        }
+
+      fl     = ffs((int)bitmap) - 1;
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  sl   = ffs((int)bitmap) - 1;
+  node = heap->mm_freelist[fl][sl];
+  DEBUGASSERT(node != NULL);
+
+  /* Chunks in the list of very large chunks are of arbitrary size */
+
+  if (fl == MM_TLSF_FLLARGE)
+    {
+      while (node && node->size < size)
+        {
+          node = node->flink;
+        }
+    }
+
+  return node;
+}
+
+#endif /* CONFIG_MM_TLSF */
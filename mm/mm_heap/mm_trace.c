@@ -0,0 +1,258 @@
+/****************************************************************************
+ * mm/mm_heap/mm_trace.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TRACE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The usage table is indexed just like the scheduler's PID hash table.
+ * CONFIG_MAX_TASKS is required to be a power of two.
+ */
+
+#define MM_TRACE_NDX(pid)  ((pid) & (CONFIG_MAX_TASKS - 1))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_traceaccount
+ *
+ * Description:
+ *   Add 'delta' bytes and 'nallocs' allocations to the usage of a thread.
+ *   An entry still holding the statistics of an older thread with the same
+ *   hashed PID is reset first.  The caller must hold the MM semaphore.
+ *
+ ****************************************************************************/
+
+static void mm_traceaccount(FAR struct mm_heap_s *heap, pid_t pid,
+                            ssize_t delta, int nallocs)
+{
+  FAR struct mm_traceusage_s *usage;
+
+  if (pid < 0)
+    {
+      return;
+    }
+
+  usage = &heap->mm_traceusage[MM_TRACE_NDX(pid)];
+  if (usage->pid != pid)
+    {
+      /* Frees of chunks that belong to an exited thread are not counted */
+
+      if (delta < 0)
+        {
+          return;
+        }
+
+      usage->pid     = pid;
+      usage->nallocs = 0;
+      usage->used    = 0;
+      usage->peak    = 0;
+    }
+
+  /* Once a chunk has been accounted to a thread, the entry can only be
+   * reset by mm_traceexit(), so 'used' cannot underflow here.
+   */
+
+  usage->used    += delta;
+  usage->nallocs += nallocs;
+
+  if (usage->used > usage->peak)
+    {
+      usage->peak = usage->used;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_traceinitialize
+ *
+ * Description:
+ *   Initialize the allocation tracing state of a heap.
+ *
+ ****************************************************************************/
+
+void mm_traceinitialize(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+  heap->mm_seqno = 0;
+  memset(heap->mm_traceusage, 0, sizeof(heap->mm_traceusage));
+
+  for (i = 0; i < CONFIG_MAX_TASKS; i++)
+    {
+      heap->mm_traceusage[i].pid = MM_TRACE_NOPID;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tracealloc
+ *
+ * Description:
+ *   Tag a newly allocated chunk with the calling thread, a sequence number
+ *   and the address of the allocating code, and account it to the thread.
+ *
+ ****************************************************************************/
+
+void mm_tracealloc(FAR struct mm_heap_s *heap, FAR void *mem,
+                   FAR void *caller)
+{
+  FAR struct mm_allocnode_s *node;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+
+  node->seqno  = heap->mm_seqno++;
+  node->pid    = getpid();
+  node->caller = caller;
+
+  mm_traceaccount(heap, node->pid, node->size, 1);
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_tracefree
+ *
+ * Description:
+ *   Remove a chunk that is about to be freed from the usage of the thread
+ *   that allocated it.
+ *
+ ****************************************************************************/
+
+void mm_tracefree(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+  mm_traceaccount(heap, node->pid, -(ssize_t)node->size, -1);
+  node->pid = MM_TRACE_NOPID;
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_traceresize
+ *
+ * Description:
+ *   Account for a chunk whose size was changed in place from 'oldsize'.
+ *
+ ****************************************************************************/
+
+void mm_traceresize(FAR struct mm_heap_s *heap, FAR void *mem,
+                    size_t oldsize)
+{
+  FAR struct mm_allocnode_s *node;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+  mm_traceaccount(heap, node->pid, (ssize_t)node->size - (ssize_t)oldsize, 0);
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Name: mm_traceexit
+ *
+ * Description:
+ *   Forget the heap usage of a thread that has exited.  Chunks that it did
+ *   not free keep their tags and are still reported by mm_tracewalk().
+ *
+ *   This may be called from the scheduler while the thread is being torn
+ *   down, so it does not take the MM semaphore.  A single store of the PID
+ *   is sufficient to invalidate the entry.
+ *
+ ****************************************************************************/
+
+void mm_traceexit(FAR struct mm_heap_s *heap, pid_t pid)
+{
+  FAR struct mm_traceusage_s *usage;
+
+  usage = &heap->mm_traceusage[MM_TRACE_NDX(pid)];
+  if (usage->pid == pid)
+    {
+      usage->pid = MM_TRACE_NOPID;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_traceusage
+ *
+ * Description:
+ *   Return a copy of one entry of the per-thread usage table.
+ *
+ * Input Parameters:
+ *   heap  - The selected heap
+ *   ndx   - The table index, 0 .. CONFIG_MAX_TASKS-1
+ *   usage - Location to return the entry
+ *
+ * Returned Value:
+ *   OK if the entry is in use; -ENOENT otherwise.
+ *
+ ****************************************************************************/
+
+int mm_traceusage(FAR struct mm_heap_s *heap, int ndx,
+                  FAR struct mm_traceusage_s *usage)
+{
+  DEBUGASSERT(ndx >= 0 && ndx < CONFIG_MAX_TASKS);
+
+  mm_takesemaphore(heap);
+  memcpy(usage, &heap->mm_traceusage[ndx], sizeof(struct mm_traceusage_s));
+  mm_givesemaphore(heap);
+
+  return usage->pid == MM_TRACE_NOPID ? -ENOENT : OK;
+}
+
+#endif /* CONFIG_MM_TRACE */
@@ -60,6 +60,9 @@ FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
   FAR void *alloc = mm_malloc(heap, size);
   if (alloc)
     {
+#ifdef CONFIG_MM_TRACE
+       MM_TRACE_SETCALLER(alloc, MM_TRACE_CALLER());
+#endif
        memset(alloc, 0, size);
     }
 
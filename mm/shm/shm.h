@@ -49,6 +49,10 @@
 
 #include <nuttx/addrenv.h>
 
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+#  include <arch/arch.h>
+#endif
+
 #ifdef CONFIG_MM_SHM
 
 /****************************************************************************
@@ -59,6 +63,19 @@
 #define SRFLAG_AVAILABLE 0        /* Available if no flag bits set */
 #define SRFLAG_INUSE     (1 << 0) /* Bit 0: Region is in use */
 #define SRFLAG_UNLINKED  (1 << 1) /* Bit 1: Region perists while references */
+#define SRFLAG_LARGEPAGE (1 << 2) /* Bit 2: Region is contiguous and aligned */
+
+/* Large page shared memory.  A large page region is backed by one run of
+ * physically contiguous pages aligned to SHM_LPGSIZE and is attached at a
+ * virtual address with the same alignment so that the architecture can map
+ * it with large pages.
+ */
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+#  define SHM_LPGSIZE      (1 << ARCH_SHM_LPGSHIFT)
+#  define SHM_LPGMASK      (SHM_LPGSIZE - 1)
+#  define SHM_LPGNPAGES    (SHM_LPGSIZE >> MM_PGSHIFT)
+#endif
 
 /****************************************************************************
  * Public Types
@@ -71,7 +88,7 @@
 struct shm_region_s
 {
   struct shmid_ds sr_ds; /* Region info */
-  bool  sr_flags;        /* See SRFLAGS_* definitions */
+  uint8_t sr_flags;      /* See SRFLAGS_* definitions */
   key_t sr_key;          /* Lookup key */
   sem_t sr_sem;          /* Manages exclusive access to this region */
 
@@ -50,6 +50,65 @@
 
 #ifdef CONFIG_MM_SHM
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_largevaddr
+ *
+ * Description:
+ *   Set aside a virtual address range for a large page region that is
+ *   aligned to the large page size.  A larger range is allocated and the
+ *   excess at either end is returned to the virtual page allocator.
+ *
+ * Input Parameters:
+ *   group - The task group of the attaching process
+ *   size  - The size of the region
+ *
+ * Returned Value:
+ *   The aligned virtual address on success; zero if there is no aligned
+ *   range that is large enough.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+static uintptr_t shm_largevaddr(FAR struct task_group_s *group, size_t size)
+{
+  uintptr_t vaddr;
+  uintptr_t aligned;
+  size_t allocsize;
+  size_t head;
+  size_t tail;
+
+  size      = MM_NPAGES(size) << MM_PGSHIFT;
+  allocsize = size + SHM_LPGSIZE - MM_PGSIZE;
+
+  vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle, allocsize);
+  if (vaddr == 0)
+    {
+      return 0;
+    }
+
+  aligned = (vaddr + SHM_LPGMASK) & ~SHM_LPGMASK;
+  head    = aligned - vaddr;
+  tail    = allocsize - head - size;
+
+  if (head > 0)
+    {
+      gran_free(group->tg_shm.gs_handle, (FAR void *)vaddr, head);
+    }
+
+  if (tail > 0)
+    {
+      gran_free(group->tg_shm.gs_handle, (FAR void *)(aligned + size),
+                tail);
+    }
+
+  return aligned;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -140,10 +199,25 @@ FAR void *shmat(int shmid, FAR const void *shmaddr, int shmflg)
       goto errout_with_ret;
     }
 
-  /* Set aside a virtual address space to span this physical region */
+  /* Set aside a virtual address space to span this physical region.  Large
+   * page regions are attached at an aligned address if possible so that
+   * they can be mapped with large pages.
+   */
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+  vaddr = 0;
+  if ((region->sr_flags & SRFLAG_LARGEPAGE) != 0)
+    {
+      vaddr = shm_largevaddr(group, region->sr_ds.shm_segsz);
+    }
+
+  if (vaddr == 0)
+#endif
+    {
+      vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle,
+                                    region->sr_ds.shm_segsz);
+    }
 
-  vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle,
-                                region->sr_ds.shm_segsz);
   if (vaddr == 0)
     {
       shmerr("ERROR: gran_alloc() failed\n");
@@ -218,6 +218,85 @@ static int shm_extend(int shmid, size_t size)
   return OK;
 }
 
+/****************************************************************************
+ * Name: shm_largealloc
+ *
+ * Description:
+ *   Allocate the physical memory of a new region as one run of contiguous
+ *   pages aligned to the large page size.  More pages than needed are
+ *   allocated so that an aligned run can be carved out; the excess at either
+ *   end is returned to the page allocator.
+ *
+ * Input Parameters:
+ *   shmid - The index of the region of interest in the shared memory region
+ *     table.
+ *   size - The size of the region.
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOMEM is returned if no suitable
+ *   contiguous memory is available.  Nothing is allocated on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+static int shm_largealloc(int shmid, size_t size)
+{
+  FAR struct shm_region_s *region =  &g_shminfo.si_region[shmid];
+  unsigned int pgneeded;
+  unsigned int pgalloc;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int i;
+  uintptr_t paddr;
+  uintptr_t aligned;
+
+  /* There is no benefit unless the region spans at least one large page */
+
+  pgneeded = MM_NPAGES(size);
+  if (pgneeded < SHM_LPGNPAGES || pgneeded > CONFIG_ARCH_SHM_NPAGES)
+    {
+      return -ENOMEM;
+    }
+
+  pgalloc = pgneeded + SHM_LPGNPAGES - 1;
+  paddr   = mm_pgalloc(pgalloc);
+  if (paddr == 0)
+    {
+      shminfo("No %u contiguous pages\n", pgalloc);
+      return -ENOMEM;
+    }
+
+  /* Return the unaligned head and the unused tail */
+
+  aligned = (paddr + SHM_LPGMASK) & ~SHM_LPGMASK;
+  head    = (aligned - paddr) >> MM_PGSHIFT;
+  tail    = pgalloc - head - pgneeded;
+
+  if (head > 0)
+    {
+      mm_pgfree(paddr, head);
+    }
+
+  if (tail > 0)
+    {
+      mm_pgfree(aligned + (pgneeded << MM_PGSHIFT), tail);
+    }
+
+  /* The pages are still recorded individually so that the region can be
+   * extended and freed just like any other region.
+   */
+
+  for (i = 0; i < pgneeded; i++)
+    {
+      region->sr_pages[i] = aligned + (i << MM_PGSHIFT);
+    }
+
+  region->sr_flags       |= SRFLAG_LARGEPAGE;
+  region->sr_ds.shm_segsz = size;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: shm_create
  *
@@ -230,7 +309,8 @@ static int shm_extend(int shmid, size_t size)
  *   size    - The shared memory region that is created will be at least
  *             this size in bytes.
  *   shmflgs - See IPC_* definitions in sys/ipc.h.  Only the values
- *             IPC_PRIVATE or IPC_CREAT are supported.
+ *             IPC_PRIVATE or IPC_CREAT are supported.  SHM_HUGETLB may be
+ *             included to request large page backing.
  *
  * Returned Value:
  *   Zero is returned on success;  A negated errno value is returned on
@@ -257,11 +337,24 @@ static int shm_create(key_t key, size_t size, int shmflg)
 
   shmid = ret;
 
-  /* Then allocate the physical memory (by extending it from the initial
-   * size of zero).
+  /* Then allocate the physical memory.  If large pages were requested, try
+   * to get contiguous memory first.  Otherwise, or if that fails, extend the
+   * region from its initial size of zero one page at a time.
    */
 
-  ret = shm_extend(shmid, size);
+#ifdef CONFIG_MM_SHM_LARGEPAGES
+  ret = -ENOMEM;
+  if ((shmflg & SHM_HUGETLB) != 0)
+    {
+      ret = shm_largealloc(shmid, size);
+    }
+
+  if (ret < 0)
+#endif
+    {
+      ret = shm_extend(shmid, size);
+    }
+
   if (ret < 0)
     {
       /* Free any partial allocations and unreserve the region */
@@ -465,7 +558,7 @@ int shmget(key_t key, size_t size, int shmflg)
        * then it is no longer deleted.
        */
 
-      region->sr_flags = SRFLAG_INUSE;
+      region->sr_flags &= ~SRFLAG_UNLINKED;
     }
 
   /* Release our lock on the shared memory region list */
@@ -49,6 +49,8 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <string.h>
+#include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
@@ -60,6 +62,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 
 #include <arp/arp.h>
 #include <netdev/netdev.h>
@@ -72,10 +75,27 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* The links of the ARP table hold entry indices plus one, so that zero
+ * (the initial value) means no entry.
+ */
+
+#define ARP_NOENTRY     0
+#define ARP_ENTRY(n)    (&g_arptable[(n) - 1])
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The hash chain and LRU list links of one ARP table entry */
+
+struct arp_link_s
+{
+  uint16_t al_hnext;                  /* Next entry in the hash chain */
+  uint16_t al_prev;                   /* More recently used entry */
+  uint16_t al_next;                   /* Less recently used entry or next
+                                       * free entry */
+};
+
 struct arp_table_info_s
 {
   in_addr_t              ai_ipaddr;   /* IP address for lookup */
@@ -90,6 +110,22 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The table is indexed by a hash of the IP address.  The entries in use
+ * are also kept in a list from the most recently used (g_arpmru) to the
+ * least recently used (g_arplru) entry, which is replaced when the table
+ * is full.
+ */
+
+static struct arp_link_s g_arplinks[CONFIG_NET_ARPTAB_SIZE];
+static uint16_t g_arphash[CONFIG_NET_ARPTAB_SIZE];
+static uint16_t g_arpmru;
+static uint16_t g_arplru;
+
+/* Entries that were deleted, and the number of entries ever used */
+
+static uint16_t g_arpfree;
+static uint16_t g_arpnused;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -141,32 +177,168 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Return the hash chain of the IP address.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static inline FAR uint16_t *arp_hash(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
+  return &g_arphash[(((uint32_t)ipaddr * 0x9e3779b1) >> 16) %
+                    CONFIG_NET_ARPTAB_SIZE];
+}
+
+/****************************************************************************
+ * Name: arp_findndx
+ *
+ * Description:
+ *   Return the link index of the entry with the IP address, regardless of
+ *   its age, or ARP_NOENTRY.
+ *
+ ****************************************************************************/
+
+static uint16_t arp_findndx(in_addr_t ipaddr)
+{
+  uint16_t ndx;
+
+  for (ndx = *arp_hash(ipaddr);
+       ndx != ARP_NOENTRY;
+       ndx = g_arplinks[ndx - 1].al_hnext)
     {
-      return e1;
+      if (net_ipv4addr_cmp(ipaddr, ARP_ENTRY(ndx)->at_ipaddr))
+        {
+          break;
+        }
     }
-  else if (e2->at_ipaddr == 0)
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: arp_lru_remove
+ *
+ * Description:
+ *   Remove the entry from the LRU list.
+ *
+ ****************************************************************************/
+
+static void arp_lru_remove(uint16_t ndx)
+{
+  FAR struct arp_link_s *link = &g_arplinks[ndx - 1];
+
+  if (link->al_prev != ARP_NOENTRY)
+    {
+      g_arplinks[link->al_prev - 1].al_next = link->al_next;
+    }
+  else
     {
-      return e2;
+      g_arpmru = link->al_next;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  if (link->al_next != ARP_NOENTRY)
+    {
+      g_arplinks[link->al_next - 1].al_prev = link->al_prev;
+    }
+  else
+    {
+      g_arplru = link->al_prev;
+    }
+
+  link->al_prev = ARP_NOENTRY;
+  link->al_next = ARP_NOENTRY;
+}
+
+/****************************************************************************
+ * Name: arp_lru_insert
+ *
+ * Description:
+ *   Make the entry the most recently used one.
+ *
+ ****************************************************************************/
+
+static void arp_lru_insert(uint16_t ndx)
+{
+  FAR struct arp_link_s *link = &g_arplinks[ndx - 1];
+
+  link->al_prev = ARP_NOENTRY;
+  link->al_next = g_arpmru;
+
+  if (g_arpmru != ARP_NOENTRY)
     {
-      return e1;
+      g_arplinks[g_arpmru - 1].al_prev = ndx;
     }
   else
     {
-      return e2;
+      g_arplru = ndx;
     }
+
+  g_arpmru = ndx;
+}
+
+/****************************************************************************
+ * Name: arp_unlink
+ *
+ * Description:
+ *   Remove the entry from its hash chain and from the LRU list.
+ *
+ ****************************************************************************/
+
+static void arp_unlink(uint16_t ndx)
+{
+  FAR uint16_t *pndx;
+
+  for (pndx = arp_hash(ARP_ENTRY(ndx)->at_ipaddr);
+       *pndx != ARP_NOENTRY;
+       pndx = &g_arplinks[*pndx - 1].al_hnext)
+    {
+      if (*pndx == ndx)
+        {
+          *pndx = g_arplinks[ndx - 1].al_hnext;
+          break;
+        }
+    }
+
+  g_arplinks[ndx - 1].al_hnext = ARP_NOENTRY;
+  arp_lru_remove(ndx);
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Return the link index of an unused entry, replacing the least recently
+ *   used entry if the table is full.
+ *
+ ****************************************************************************/
+
+static uint16_t arp_alloc(void)
+{
+  uint16_t ndx;
+
+  if (g_arpfree != ARP_NOENTRY)
+    {
+      ndx       = g_arpfree;
+      g_arpfree = g_arplinks[ndx - 1].al_next;
+      g_arplinks[ndx - 1].al_next = ARP_NOENTRY;
+    }
+  else if (g_arpnused < CONFIG_NET_ARPTAB_SIZE)
+    {
+      ndx = ++g_arpnused;
+    }
+  else
+    {
+      ndx = g_arplru;
+      DEBUGASSERT(ndx != ARP_NOENTRY);
+
+      arp_unlink(ndx);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.arp.evict++;
+#endif
+    }
+
+  return ndx;
 }
 
 /****************************************************************************
@@ -195,40 +367,39 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
-
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  FAR struct arp_entry_s *tabptr;
+  uint16_t ndx;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (ipaddr == 0)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      return -EINVAL;
+    }
 
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+  /* Find the entry to update.  If there is none, the IP -> MAC address
+   * mapping is inserted in an unused or in the least recently used entry.
+   */
 
-          tabptr = &g_arptable[i];
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
+  ndx = arp_findndx(ipaddr);
+  if (ndx != ARP_NOENTRY)
+    {
+      arp_lru_remove(ndx);
+    }
+  else
+    {
+      FAR uint16_t *head = arp_hash(ipaddr);
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      ndx = arp_alloc();
+      g_arplinks[ndx - 1].al_hnext = *head;
+      *head = ndx;
     }
 
+  arp_lru_insert(ndx);
+
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
+  tabptr = ARP_ENTRY(ndx);
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = clock_systimer();
@@ -282,16 +453,20 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
+  uint16_t ndx;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  ndx = arp_findndx(ipaddr);
+  if (ndx != ARP_NOENTRY)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systimer() - tabptr->at_time <= ARP_MAXAGE_TICK)
+      tabptr = ARP_ENTRY(ndx);
+      if (clock_systimer() - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
+          /* Keep the entry from being replaced while it is in use */
+
+          arp_lru_remove(ndx);
+          arp_lru_insert(ndx);
           return tabptr;
         }
     }
@@ -330,6 +505,10 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
   tabptr = arp_lookup(ipaddr);
   if (tabptr != NULL)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.arp.hit++;
+#endif
+
       /* Yes.. return the Ethernet MAC address if the caller has provided a
        * non-NULL address in 'ethaddr'.
        */
@@ -351,6 +530,10 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
    * to the Ethernet MAC address assigned to the network device.
    */
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.miss++;
+#endif
+
   info.ai_ipaddr  = ipaddr;
   info.ai_ethaddr = ethaddr;
 
@@ -380,16 +563,22 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
 
 void arp_delete(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
+  uint16_t ndx;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr);
-  if (tabptr != NULL)
+  ndx = arp_findndx(ipaddr);
+  if (ndx != ARP_NOENTRY)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Unlink the entry, set the IP address to zero to "delete" it,
+       * and keep it for re-use.
+       */
+
+      arp_unlink(ndx);
+      ARP_ENTRY(ndx)->at_ipaddr = 0;
 
-      tabptr->at_ipaddr = 0;
+      g_arplinks[ndx - 1].al_next = g_arpfree;
+      g_arpfree = ndx;
     }
 }
 
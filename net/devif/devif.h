@@ -289,12 +289,6 @@ extern "C"
 #define EXTERN extern
 #endif
 
-#ifdef CONFIG_NET_IPv4_REASSEMBLY
-/* Reassembly timer (units: deci-seconds) */
-
-EXTERN uint8_t g_reassembly_timer;
-#endif
-
 /* Time of last poll */
 
 EXTERN clock_t g_polltime;
@@ -46,8 +46,75 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
+#include "utils/utils.h"
+
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_iob_copysum
+ *
+ * Description:
+ *   Copy 'len' bytes starting at 'offset' in the I/O buffer chain to 'dest'
+ *   and return the raw checksum of the copied data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+static uint16_t devif_iob_copysum(FAR uint8_t *dest, FAR struct iob_s *iob,
+                                  unsigned int len, unsigned int offset)
+{
+  unsigned int ncopy;
+  unsigned int done = 0;
+  uint16_t sum = 0;
+  uint16_t t;
+
+  /* Skip to the I/O buffer containing the offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && done < len)
+    {
+      ncopy = iob->io_len - offset;
+      if (ncopy > len - done)
+        {
+          ncopy = len - done;
+        }
+
+      t = chksum_copy(0, &dest[done],
+                      &iob->io_data[iob->io_offset + offset], ncopy);
+
+      /* A piece that starts at an odd position of the payload contributes
+       * with its bytes swapped.
+       */
+
+      if ((done & 1) != 0)
+        {
+          t = (t << 8) | (t >> 8);
+        }
+
+      sum += t;
+      if (sum < t)
+        {
+          sum++; /* carry */
+        }
+
+      done  += ncopy;
+      iob    = iob->io_flink;
+      offset = 0;
+    }
+
+  return sum;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -70,11 +137,22 @@
 void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                     unsigned int len, unsigned int offset)
 {
+#ifdef CONFIG_NETDEV_OFFLOAD
+  DEBUGASSERT(dev && len > 0 &&
+              (len < NETDEV_PKTSIZE(dev) ||
+               (NETDEV_OFFLOAD(dev, NETDEV_TSO) && len <= dev->d_tsomax)));
+#else
   DEBUGASSERT(dev && len > 0 && len < NETDEV_PKTSIZE(dev));
+#endif
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsum    = devif_iob_copysum(dev->d_appdata, iob, len, offset);
+  dev->d_sndsumlen = len;
+#else
   iob_copyout(dev->d_appdata, iob, len, offset);
+#endif
   dev->d_sndlen = len;
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
@@ -100,11 +100,33 @@ static bool is_loopback(FAR struct net_driver_s *dev)
 
 int devif_loopback(FAR struct net_driver_s *dev)
 {
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint8_t offload;
+#endif
+
   if (!is_loopback(dev))
     {
       return 0;
     }
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* The checksums that the hardware would have inserted on transmission
+   * are still zero.  The packet never leaves memory, so treat them as
+   * verified on reception.
+   */
+
+  offload = dev->d_offload;
+  if ((offload & NETDEV_TXCSUM_IP) != 0)
+    {
+      dev->d_offload |= NETDEV_RXCSUM_IP;
+    }
+
+  if ((offload & NETDEV_TXCSUM_L4) != 0)
+    {
+      dev->d_offload |= NETDEV_RXCSUM_L4;
+    }
+#endif
+
   /* Loop while if there is data "sent" to ourself.
    * Sending, of course, just means relaying back through the network.
    */
@@ -157,6 +179,10 @@ int devif_loopback(FAR struct net_driver_s *dev)
     }
   while (dev->d_len > 0);
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_offload = offload;
+#endif
+
   return 1;
 }
 
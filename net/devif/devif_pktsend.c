@@ -108,6 +108,9 @@ void devif_pkt_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   dev->d_len    = len;
   dev->d_sndlen = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumlen = 0;
+#endif
 }
 
 #endif /* CONFIG_NET_PKT */
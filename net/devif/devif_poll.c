@@ -60,6 +60,7 @@
 #include "icmpv6/icmpv6.h"
 #include "mld/mld.h"
 #include "ipforward/ipforward.h"
+#include "ipfrag/ipfrag.h"
 #include "sixlowpan/sixlowpan.h"
 
 /****************************************************************************
@@ -520,7 +521,10 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
  * Name: devif_poll_tcp_connections
  *
  * Description:
- *   Poll all UDP connections for available packets to send.
+ *   Poll the TCP connections that may have packets to send.  These are the
+ *   connections in the TX ready list, see tcp_txready().  A connection that
+ *   is polled by its device and has nothing to send is removed from the
+ *   list.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -532,16 +536,50 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
                                              devif_poll_callback_t callback)
 {
-  FAR struct tcp_conn_s *conn  = NULL;
+  FAR struct tcp_conn_s *conn;
+  FAR struct tcp_conn_s *next;
   int bstop = 0;
 
-  /* Traverse all of the active TCP connections and perform the poll action */
+  /* Traverse the TX ready list and perform the poll action */
 
-  while (!bstop && (conn = tcp_nextconn(conn)))
+  for (conn = tcp_nexttxready(NULL); !bstop && conn != NULL; conn = next)
     {
-      /* Perform the TCP TX poll */
+      /* Connections bound to other devices stay in the list */
+
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          next = tcp_nexttxready(conn);
+          continue;
+        }
 
-      tcp_poll(dev, conn);
+#ifdef CONFIG_NET_TCP_CONNTIMER
+      if (conn->timerdue)
+        {
+          /* The timer of the connection has expired.  Get the next
+           * connection first:  The timer may free this one.
+           */
+
+          next = tcp_nexttxready(conn);
+          tcp_timer_poll(dev, conn);
+        }
+      else
+#endif
+        {
+          /* Perform the TCP TX poll */
+
+          tcp_poll(dev, conn);
+          next = tcp_nexttxready(conn);
+        }
+
+      if (dev->d_len == 0)
+        {
+          /* Nothing to send.  The connection is added to the list again
+           * when it has something new to send.
+           */
+
+          tcp_txready_remove(conn);
+          continue;
+        }
 
       /* Perform any necessary conversions on outgoing packets */
 
@@ -571,7 +609,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-#ifdef NET_TCP_HAVE_STACK
+#if defined(NET_TCP_HAVE_STACK) && !defined(CONFIG_NET_TCP_CONNTIMER)
 static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
                                        devif_poll_callback_t callback,
                                        int hsec)
@@ -801,19 +839,16 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
       /* Perform periodic activitives that depend on hsec > 0 */
 
-#ifdef CONFIG_NET_IPv4_REASSEMBLY
-      /* Increment the timer used by the IP reassembly logic */
+#ifdef CONFIG_NET_IPFRAG
+      /* Abandon the IP reassemblies that have timed out */
 
-      if (g_reassembly_timer != 0 &&
-          g_reassembly_timer < CONFIG_NET_IPv4_REASS_MAXAGE)
-        {
-          g_reassembly_timer += hsec;
-        }
+      ipfrag_timer();
 #endif
 
-#ifdef NET_TCP_HAVE_STACK
+#if defined(NET_TCP_HAVE_STACK) && !defined(CONFIG_NET_TCP_CONNTIMER)
       /* Traverse all of the active TCP connections and perform the
-       * timer action.
+       * timer action.  With CONFIG_NET_TCP_CONNTIMER, each connection has
+       * its own timer instead.
        */
 
       bstop = devif_poll_tcp_timer(dev, callback, hsec);
@@ -71,4 +71,7 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
 
   memcpy(dev->d_appdata, buf, len);
   dev->d_sndlen = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumlen = 0;
+#endif
 }
@@ -81,6 +81,7 @@
 #ifdef CONFIG_NET_IPv6
 
 #include <sys/ioctl.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <debug.h>
@@ -103,6 +104,7 @@
 
 #include "netdev/netdev.h"
 #include "ipforward/ipforward.h"
+#include "ipfrag/ipfrag.h"
 #include "inet/inet.h"
 #include "devif/devif.h"
 
@@ -279,6 +281,10 @@ int ipv6_input(FAR struct net_driver_s *dev)
   uint16_t iphdrlen;
   uint16_t paylen;
   uint8_t nxthdr;
+#ifdef CONFIG_NET_IPFRAG
+  uint16_t nxtoff;
+  uint16_t fragoff = 0;
+#endif
 #ifdef CONFIG_NET_IPFORWARD
   int ret;
 #endif
@@ -289,6 +295,12 @@ int ipv6_input(FAR struct net_driver_s *dev)
   g_netstats.ipv6.recv++;
 #endif
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Forget the checksum of any previous outgoing payload */
+
+  dev->d_sndsumlen = 0;
+#endif
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
@@ -359,12 +371,27 @@ int ipv6_input(FAR struct net_driver_s *dev)
   payload  = PAYLOAD;     /* Assume payload starts right after IPv6 header */
   iphdrlen = IPv6_HDRLEN; /* Total length of the IPv6 header */
   nxthdr   = ipv6->proto; /* Next header determined by IPv6 header prototype */
+#ifdef CONFIG_NET_IPFRAG
+  nxtoff   = offsetof(struct ipv6_hdr_s, proto);
+#endif
 
   while (ipv6_exthdr(nxthdr))
     {
       FAR struct ipv6_extension_s *exthdr;
       uint16_t extlen;
 
+#ifdef CONFIG_NET_IPFRAG
+      if (nxthdr == NEXT_FRAGMENT_EH)
+        {
+          /* The rest of the packet is a fragment of a larger datagram */
+
+          fragoff = iphdrlen;
+          break;
+        }
+
+      nxtoff    = iphdrlen;
+#endif
+
       /* Just skip over the extension header */
 
       exthdr    = (FAR struct ipv6_extension_s *)payload;
@@ -458,6 +485,17 @@ int ipv6_input(FAR struct net_driver_s *dev)
         }
     }
 
+#ifdef CONFIG_NET_IPFRAG
+  if (fragoff > 0)
+    {
+      /* Keep the fragment.  The complete datagram comes back through
+       * ipv6_input().
+       */
+
+      return ipv6_reassemble(dev, nxtoff, fragoff);
+    }
+#endif
+
   /* Now process the incoming packet according to the protocol specified in
    * the next header IPv6 field.
    */
@@ -194,6 +194,45 @@ void ipv6_forward_broadcast(FAR struct net_driver_s *dev,
                             FAR struct ipv6_hdr_s *ipv6);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_fastpath and ipv6_fastpath
+ *
+ * Description:
+ *   Try to forward a packet immediately:  Look up the next hop and its link
+ *   layer address, decrement the TTL (updating the IPv4 header checksum
+ *   incrementally), and pass the frame from the receiving device's buffer
+ *   directly to the d_transmit() method of the forwarding device.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet must be forwarded
+ *   ipv4   - A pointer to the IPv4 header in within dev->d_buf
+ *   ipv6   - A pointer to the IPv6 header in within dev->d_buf
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the packet was sent.  A negated errno value is
+ *   returned if the fast path cannot be used.  The packet is then
+ *   unmodified and must be forwarded asynchronously.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+#ifdef CONFIG_NET_IPv4
+int ipv4_fastpath(FAR struct net_driver_s *dev,
+                  FAR struct net_driver_s *fwddev,
+                  FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int ipv6_fastpath(FAR struct net_driver_s *dev,
+                  FAR struct net_driver_s *fwddev,
+                  FAR struct ipv6_hdr_s *ipv6);
+#endif
+#endif
+
 /****************************************************************************
  * Name: devif_forward
  *
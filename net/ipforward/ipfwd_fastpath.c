@@ -0,0 +1,327 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_fastpath.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+#include <net/if.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+#include "arp/arp.h"
+#include "neighbor/neighbor.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_fastpath_check
+ *
+ * Description:
+ *   Check if the packet can be sent directly from the receiving device's
+ *   buffer:  Both devices must be Ethernet devices, the forwarding device
+ *   must be up and must support direct transmission, and the packet must
+ *   fit within the MTU of the forwarding device.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet must be forwarded
+ *   iphdr  - The IP header within dev->d_buf
+ *
+ * Returned Value:
+ *   Zero (OK) if the fast path may be used; a negated errno value if not.
+ *
+ ****************************************************************************/
+
+static int ipfwd_fastpath_check(FAR struct net_driver_s *dev,
+                                FAR struct net_driver_s *fwddev,
+                                FAR const void *iphdr)
+{
+  if (fwddev->d_transmit == NULL || !IFF_IS_UP(fwddev->d_flags))
+    {
+      return -ENOSYS;
+    }
+
+  if (dev->d_lltype != NET_LL_ETHERNET ||
+      fwddev->d_lltype != NET_LL_ETHERNET ||
+      (FAR const uint8_t *)iphdr - dev->d_buf != ETH_HDRLEN)
+    {
+      return -ENOSYS;
+    }
+
+  if (ETH_HDRLEN + dev->d_len > NETDEV_PKTSIZE(fwddev))
+    {
+      return -EFBIG;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfwd_fastpath_send
+ *
+ * Description:
+ *   Build the Ethernet header in front of the IP packet and pass the frame
+ *   to the forwarding device.
+ *
+ ****************************************************************************/
+
+static int ipfwd_fastpath_send(FAR struct net_driver_s *dev,
+                               FAR struct net_driver_s *fwddev,
+                               FAR const struct ether_addr *ethaddr,
+                               uint16_t type)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+
+  memcpy(eth->dest, ethaddr->ether_addr_octet, ETHER_ADDR_LEN);
+  memcpy(eth->src, fwddev->d_mac.ether.ether_addr_octet, ETHER_ADDR_LEN);
+  eth->type = type;
+
+  return fwddev->d_transmit(fwddev, dev->d_buf, ETH_HDRLEN + dev->d_len);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_fastpath
+ *
+ * Description:
+ *   Try to forward an IPv4 packet immediately:  Look up the next hop in the
+ *   routing table and its MAC address in the ARP table, decrement the TTL,
+ *   incrementally update the header checksum, and hand the frame directly
+ *   to the forwarding device's transmitter.  Nothing is copied and nothing
+ *   is queued.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet must be forwarded
+ *   ipv4   - A pointer to the IPv4 header in within dev->d_buf
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the packet was sent.  A negated errno value is
+ *   returned if the fast path cannot be used (for example, because the
+ *   next hop is not in the ARP table or because the transmitter is busy).
+ *   The packet is then unmodified and the caller should forward it with
+ *   ipv4_dev_forward().
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipv4_fastpath(FAR struct net_driver_s *dev,
+                  FAR struct net_driver_s *fwddev,
+                  FAR struct ipv4_hdr_s *ipv4)
+{
+  struct ether_addr ethaddr;
+  in_addr_t destipaddr;
+  in_addr_t nexthop;
+  uint16_t chksum;
+  uint32_t sum;
+  int ret;
+
+  ret = ipfwd_fastpath_check(dev, fwddev, ipv4);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Expiring packets and broadcast/multicast packets take the slow path */
+
+  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  if (ipv4->ttl <= 1 || IN_MULTICAST(NTOHL(destipaddr)) ||
+      net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST))
+    {
+      return -EINVAL;
+    }
+
+  /* Get the next hop on the network of the forwarding device */
+
+  if (net_ipv4addr_maskcmp(destipaddr, fwddev->d_ipaddr, fwddev->d_netmask))
+    {
+      if (net_ipv4addr_broadcast(destipaddr, fwddev->d_netmask))
+        {
+          return -EINVAL;
+        }
+
+      net_ipv4addr_copy(nexthop, destipaddr);
+    }
+  else
+    {
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv4_router(fwddev, destipaddr, &nexthop);
+#else
+      net_ipv4addr_copy(nexthop, fwddev->d_draddr);
+#endif
+    }
+
+  /* If the MAC address is not known, the slow path will send the ARP
+   * request.
+   */
+
+  ret = arp_find(nexthop, &ethaddr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Decrement the TTL.  The TTL is the high byte of the 16-bit word that
+   * it shares with the protocol, so the checksum is incremented by 0x0100
+   * with end-around carry (RFC 1624).
+   */
+
+  chksum          = ipv4->ipchksum;
+  sum             = (uint32_t)chksum + HTONS(0x0100);
+  ipv4->ipchksum  = (uint16_t)(sum + (sum >= 0xffff));
+  ipv4->ttl--;
+
+  ret = ipfwd_fastpath_send(dev, fwddev, &ethaddr, HTONS(ETHTYPE_IP));
+  if (ret < 0)
+    {
+      /* Restore the packet for the slow path */
+
+      ipv4->ttl++;
+      ipv4->ipchksum = chksum;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv6_fastpath
+ *
+ * Description:
+ *   Try to forward an IPv6 packet immediately:  Look up the next hop in the
+ *   routing table and its MAC address in the Neighbor Table, decrement the
+ *   hop limit, and hand the frame directly to the forwarding device's
+ *   transmitter.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet must be forwarded
+ *   ipv6   - A pointer to the IPv6 header in within dev->d_buf
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the packet was sent.  A negated errno value is
+ *   returned if the fast path cannot be used.  The packet is then
+ *   unmodified and the caller should forward it with ipv6_dev_forward().
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int ipv6_fastpath(FAR struct net_driver_s *dev,
+                  FAR struct net_driver_s *fwddev,
+                  FAR struct ipv6_hdr_s *ipv6)
+{
+  struct neighbor_addr_s laddr;
+  net_ipv6addr_t nexthop;
+  int ret;
+
+  ret = ipfwd_fastpath_check(dev, fwddev, ipv6);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ipv6->ttl <= 1 || net_is_addr_mcast(ipv6->destipaddr))
+    {
+      return -EINVAL;
+    }
+
+  /* Get the next hop on the network of the forwarding device */
+
+  if (net_ipv6addr_maskcmp(ipv6->destipaddr, fwddev->d_ipv6addr,
+                           fwddev->d_ipv6netmask))
+    {
+      net_ipv6addr_copy(nexthop, ipv6->destipaddr);
+    }
+  else
+    {
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv6_router(fwddev, ipv6->destipaddr, nexthop);
+#else
+      net_ipv6addr_copy(nexthop, fwddev->d_ipv6draddr);
+#endif
+    }
+
+  /* If the MAC address is not known, the slow path will send the Neighbor
+   * Solicitation.
+   */
+
+  ret = neighbor_lookup(nexthop, &laddr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Decrement the hop limit.  There is no IPv6 header checksum. */
+
+  ipv6->ttl--;
+
+  ret = ipfwd_fastpath_send(dev, fwddev, &laddr.u.na_ethernet,
+                            HTONS(ETHTYPE_IP6));
+  if (ret < 0)
+    {
+      ipv6->ttl++;
+    }
+
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_NET_IPFORWARD_FASTPATH */
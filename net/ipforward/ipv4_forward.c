@@ -464,6 +464,16 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
 
   if (fwddev != dev)
     {
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+      /* First try to send the packet immediately on the forwarding device */
+
+      if (ipv4_fastpath(dev, fwddev, ipv4) >= 0)
+        {
+          dev->d_len = 0;
+          return OK;
+        }
+#endif
+
       /* Send the packet asynchrously on the forwarding device. */
 
       ret = ipv4_dev_forward(dev, fwddev, ipv4);
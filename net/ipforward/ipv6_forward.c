@@ -596,6 +596,16 @@ int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
 
   if (fwddev != dev)
     {
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+      /* First try to send the packet immediately on the forwarding device */
+
+      if (ipv6_fastpath(dev, fwddev, ipv6) >= 0)
+        {
+          dev->d_len = 0;
+          return OK;
+        }
+#endif
+
       /* Send the packet asynchrously on the forwarding device. */
 
       ret = ipv6_dev_forward(dev, fwddev, ipv6);
@@ -0,0 +1,441 @@
+/****************************************************************************
+ * net/ipfrag/ipfrag.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipfrag/ipfrag.h"
+
+#ifdef CONFIG_NET_IPFRAG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for the link layer header in front of a large reassembled packet */
+
+#define IPFRAG_LLHDRSIZE  32
+
+/* The size of the buffer for the datagrams that do not fit into the device
+ * buffer.
+ */
+
+#define IPFRAG_BUFSIZE    (IPFRAG_LLHDRSIZE + IPFRAG_HDRSIZE + \
+                           CONFIG_NET_IPFRAG_MAXSIZE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pool of reassembly states */
+
+static struct ipfrag_s g_ipfrag[CONFIG_NET_IPFRAG_NREASS];
+
+/* The buffer for the large reassembled datagrams.  One is enough because
+ * the datagram is processed to the end with the network locked.
+ */
+
+static uint32_t g_ipfrag_buffer[(IPFRAG_BUFSIZE + CONFIG_NET_GUARDSIZE + 3)
+                                / 4];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfrag_complete
+ *
+ * Description:
+ *   Return true if the last fragment and all of the blocks before it have
+ *   been received.
+ *
+ ****************************************************************************/
+
+static bool ipfrag_complete(FAR struct ipfrag_s *frag)
+{
+  unsigned int nblocks;
+  unsigned int i;
+
+  if (frag->fr_total == 0 || frag->fr_hdrlen == 0)
+    {
+      return false;
+    }
+
+  nblocks = (frag->fr_total + 7) >> 3;
+  for (i = 0; i < (nblocks >> 3); i++)
+    {
+      if (frag->fr_bitmap[i] != 0xff)
+        {
+          return false;
+        }
+    }
+
+  if ((nblocks & 7) != 0)
+    {
+      uint8_t mask = (1 << (nblocks & 7)) - 1;
+
+      if ((frag->fr_bitmap[i] & mask) != mask)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfrag_find
+ *
+ * Description:
+ *   Find the reassembly state of a datagram, or allocate a new one.  If all
+ *   states are in use, the oldest reassembly is abandoned.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipfrag_s *ipfrag_find(uint8_t domain, FAR const void *srcaddr,
+                                 FAR const void *dstaddr, int addrlen,
+                                 uint32_t id, uint8_t proto)
+{
+  FAR struct ipfrag_s *oldest = NULL;
+  FAR struct ipfrag_s *frag;
+  int i;
+
+  /* Abandon the stale reassemblies first */
+
+  ipfrag_timer();
+
+  for (i = 0; i < CONFIG_NET_IPFRAG_NREASS; i++)
+    {
+      frag = &g_ipfrag[i];
+      if (frag->fr_domain == domain && frag->fr_id == id &&
+          frag->fr_proto == proto &&
+          memcmp(frag->fr_srcipaddr, srcaddr, addrlen) == 0 &&
+          memcmp(frag->fr_destipaddr, dstaddr, addrlen) == 0)
+        {
+          return frag;
+        }
+    }
+
+  /* This is the first fragment of a new datagram */
+
+  for (i = 0; i < CONFIG_NET_IPFRAG_NREASS; i++)
+    {
+      frag = &g_ipfrag[i];
+      if (frag->fr_domain == 0)
+        {
+          break;
+        }
+
+      if (oldest == NULL ||
+          (sclock_t)(frag->fr_start - oldest->fr_start) < 0)
+        {
+          oldest = frag;
+        }
+    }
+
+  if (i >= CONFIG_NET_IPFRAG_NREASS)
+    {
+      nwarn("WARNING: Out of reassembly states, dropping the oldest\n");
+      frag = oldest;
+      ipfrag_free(frag);
+    }
+
+  memset(frag, 0, sizeof(struct ipfrag_s));
+  frag->fr_start  = clock_systimer();
+  frag->fr_id     = id;
+  frag->fr_domain = domain;
+  frag->fr_proto  = proto;
+  memcpy(frag->fr_srcipaddr, srcaddr, addrlen);
+  memcpy(frag->fr_destipaddr, dstaddr, addrlen);
+  return frag;
+}
+
+/****************************************************************************
+ * Name: ipfrag_add
+ *
+ * Description:
+ *   Copy the payload of one fragment into the reassembly state.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipfrag_add(FAR struct ipfrag_s *frag, FAR const uint8_t *data,
+               uint16_t len, uint16_t offset, bool more)
+{
+  unsigned int end = offset + len;
+  unsigned int pktlen;
+  unsigned int ncopy;
+  unsigned int i;
+  int ret;
+
+  /* All but the last fragment carry a multiple of 8 bytes.  There is only
+   * one last fragment, and nothing follows it.
+   */
+
+  if (len == 0 || end > CONFIG_NET_IPFRAG_MAXSIZE ||
+      (more && (len & 7) != 0) ||
+      (frag->fr_total != 0 &&
+       (end > frag->fr_total || (!more && end != frag->fr_total))))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (frag->fr_iob == NULL)
+    {
+      frag->fr_iob = iob_tryalloc(false, IOBUSER_NET_IPFRAG);
+      if (frag->fr_iob == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+    }
+
+  if (!more)
+    {
+      if (frag->fr_iob->io_pktlen > end)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      frag->fr_total = end;
+    }
+
+  /* An IOB chain cannot have holes.  If the fragment lies beyond the end of
+   * the chain, extend the chain up to the fragment first.  Any data will
+   * do as filler.  It is overwritten when the missing fragments arrive.
+   */
+
+  while ((pktlen = frag->fr_iob->io_pktlen) < offset)
+    {
+      ncopy = offset - pktlen;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      ret = iob_trycopyin(frag->fr_iob, data, ncopy, pktlen, false,
+                          IOBUSER_NET_IPFRAG);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  ret = iob_trycopyin(frag->fr_iob, data, len, offset, false,
+                      IOBUSER_NET_IPFRAG);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Mark the blocks of the fragment as received */
+
+  for (i = offset >> 3; i < ((end + 7) >> 3); i++)
+    {
+      frag->fr_bitmap[i >> 3] |= 1 << (i & 7);
+    }
+
+  return ipfrag_complete(frag) ? 1 : 0;
+
+errout:
+  ipfrag_free(frag);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfrag_input
+ *
+ * Description:
+ *   Pass a complete datagram to the IP input function and release its
+ *   reassembly state.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipfrag_input(FAR struct net_driver_s *dev, FAR struct ipfrag_s *frag,
+                 ipfrag_input_t input)
+{
+  FAR uint8_t *buf = dev->d_buf;
+  uint16_t pktsize = NETDEV_PKTSIZE(dev);
+  uint16_t llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int pktlen = frag->fr_hdrlen + frag->fr_total;
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint8_t offload = dev->d_offload;
+#endif
+
+  DEBUGASSERT(frag->fr_iob != NULL && llhdrlen <= IPFRAG_LLHDRSIZE);
+
+  /* Use the device buffer if the datagram fits.  Otherwise, use the large
+   * buffer, keeping the link layer header of the last fragment.
+   */
+
+  if (llhdrlen + pktlen > pktsize)
+    {
+      DEBUGASSERT(llhdrlen + pktlen <= IPFRAG_BUFSIZE);
+
+      memcpy(g_ipfrag_buffer, buf, llhdrlen);
+      dev->d_buf     = (FAR uint8_t *)g_ipfrag_buffer;
+      dev->d_pktsize = IPFRAG_BUFSIZE;
+    }
+
+  memcpy(&dev->d_buf[llhdrlen], frag->fr_hdr, frag->fr_hdrlen);
+  iob_copyout(&dev->d_buf[llhdrlen + frag->fr_hdrlen], frag->fr_iob,
+              frag->fr_total, 0);
+  dev->d_len = llhdrlen + pktlen;
+
+  ipfrag_free(frag);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* The hardware could not verify the checksum of the whole datagram */
+
+  dev->d_offload &= ~NETDEV_RXCSUM_L4;
+#endif
+
+  /* The fragments are gone, so a request to hold the packet cannot be
+   * honored:  The driver could only hand back the last fragment.
+   */
+
+  (void)input(dev);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_offload = offload;
+#endif
+
+  if (dev->d_buf != buf)
+    {
+      /* Move any response into the device buffer */
+
+      if (dev->d_len > 0)
+        {
+          if (llhdrlen + dev->d_len <= pktsize)
+            {
+              memcpy(buf, dev->d_buf, llhdrlen + dev->d_len);
+            }
+          else
+            {
+              nwarn("WARNING: Response too large: %u\n", dev->d_len);
+              dev->d_len = 0;
+            }
+        }
+
+      dev->d_buf     = buf;
+      dev->d_pktsize = pktsize;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfrag_free
+ *
+ * Description:
+ *   Abandon a reassembly and free its IOBs.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfrag_free(FAR struct ipfrag_s *frag)
+{
+  if (frag->fr_iob != NULL)
+    {
+      iob_free_chain(frag->fr_iob, IOBUSER_NET_IPFRAG);
+      frag->fr_iob = NULL;
+    }
+
+  frag->fr_domain = 0;
+}
+
+/****************************************************************************
+ * Name: ipfrag_timer
+ *
+ * Description:
+ *   Abandon the reassemblies that did not complete within
+ *   CONFIG_NET_IPFRAG_MAXAGE seconds.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfrag_timer(void)
+{
+  clock_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFRAG_NREASS; i++)
+    {
+      FAR struct ipfrag_s *frag = &g_ipfrag[i];
+
+      if (frag->fr_domain != 0 &&
+          now - frag->fr_start >= SEC2TICK(CONFIG_NET_IPFRAG_MAXAGE))
+        {
+          ninfo("Reassembly timed out: id=%08lx\n",
+                (unsigned long)frag->fr_id);
+          ipfrag_free(frag);
+        }
+    }
+}
+
+#endif /* CONFIG_NET_IPFRAG */
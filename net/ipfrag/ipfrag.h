@@ -0,0 +1,293 @@
+/****************************************************************************
+ * net/ipfrag/ipfrag.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_IPFRAG_IPFRAG_H
+#define __NET_IPFRAG_IPFRAG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/ip.h>
+
+#ifdef CONFIG_NET_IPFRAG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPFRAG_NREASS
+#  define CONFIG_NET_IPFRAG_NREASS 4
+#endif
+
+#ifndef CONFIG_NET_IPFRAG_MAXSIZE
+#  define CONFIG_NET_IPFRAG_MAXSIZE 8192
+#endif
+
+#ifndef CONFIG_NET_IPFRAG_MAXAGE
+#  define CONFIG_NET_IPFRAG_MAXAGE 15
+#endif
+
+/* The IP header of the first fragment is kept up to this size.  For IPv6,
+ * that is the IPv6 header and the extension headers that precede the
+ * fragment header.
+ */
+
+#define IPFRAG_HDRSIZE     64
+
+/* One bit of the bitmap covers one 8-byte fragment block */
+
+#define IPFRAG_BITMAPSIZE  ((CONFIG_NET_IPFRAG_MAXSIZE + 63) / 64)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct iob_s;            /* Forward reference */
+struct net_driver_s;     /* Forward reference */
+
+/* The state of one datagram being reassembled.  The payload is copied into
+ * an IOB chain at its final offset as the fragments arrive.  Holes in the
+ * chain hold undefined data until the missing fragments fill them.
+ */
+
+struct ipfrag_s
+{
+  FAR struct iob_s *fr_iob;       /* The reassembled payload */
+  clock_t   fr_start;             /* Time that the first fragment arrived */
+  uint32_t  fr_id;                /* IP identification of the datagram */
+  uint16_t  fr_total;             /* Payload size.  Zero until the last
+                                   * fragment arrives */
+  uint8_t   fr_domain;            /* PF_INET or PF_INET6.  Zero if free */
+  uint8_t   fr_proto;             /* Upper layer protocol */
+  uint8_t   fr_hdrlen;            /* Size of fr_hdr.  Zero until the first
+                                   * fragment arrives */
+  net_ipv6addr_t fr_srcipaddr;    /* Source address (IPv4 in front) */
+  net_ipv6addr_t fr_destipaddr;   /* Destination address (IPv4 in front) */
+  uint8_t   fr_hdr[IPFRAG_HDRSIZE];       /* IP header of the datagram */
+  uint8_t   fr_bitmap[IPFRAG_BITMAPSIZE]; /* Received 8-byte blocks */
+};
+
+/* The input function that receives the reassembled packet */
+
+typedef int (*ipfrag_input_t)(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ipfrag_find
+ *
+ * Description:
+ *   Find the reassembly state of a datagram, or allocate a new one.  If all
+ *   states are in use, the oldest reassembly is abandoned.
+ *
+ * Input Parameters:
+ *   domain  - PF_INET or PF_INET6
+ *   srcaddr - The source address of the datagram
+ *   dstaddr - The destination address of the datagram
+ *   addrlen - The size of the addresses
+ *   id      - The IP identification of the datagram
+ *   proto   - The upper layer protocol
+ *
+ * Returned Value:
+ *   The reassembly state.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipfrag_s *ipfrag_find(uint8_t domain, FAR const void *srcaddr,
+                                 FAR const void *dstaddr, int addrlen,
+                                 uint32_t id, uint8_t proto);
+
+/****************************************************************************
+ * Name: ipfrag_add
+ *
+ * Description:
+ *   Copy the payload of one fragment into the reassembly state.
+ *
+ * Input Parameters:
+ *   frag   - The reassembly state
+ *   data   - The payload of the fragment
+ *   len    - The size of the payload
+ *   offset - The offset of the payload in the datagram
+ *   more   - False if this is the last fragment of the datagram
+ *
+ * Returned Value:
+ *   One (1) if the datagram is complete, zero if more fragments are
+ *   expected, or a negated errno value if the datagram cannot be
+ *   reassembled.  The reassembly state is released in that case.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipfrag_add(FAR struct ipfrag_s *frag, FAR const uint8_t *data,
+               uint16_t len, uint16_t offset, bool more);
+
+/****************************************************************************
+ * Name: ipfrag_input
+ *
+ * Description:
+ *   Pass a complete datagram to the IP input function and release its
+ *   reassembly state.  The caller has already updated fr_hdr to describe
+ *   the unfragmented datagram.
+ *
+ *   The packet is rebuilt in the device buffer if it fits.  Otherwise it is
+ *   rebuilt in a separate buffer of CONFIG_NET_IPFRAG_MAXSIZE bytes that
+ *   temporarily replaces the device buffer.  A response that does not fit
+ *   into the device buffer is dropped.
+ *
+ * Input Parameters:
+ *   dev   - The device that received the last fragment
+ *   frag  - The complete reassembly state
+ *   input - ipv4_input() or ipv6_input()
+ *
+ * Returned Value:
+ *   OK.  On return, d_len holds the size of any response.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipfrag_input(FAR struct net_driver_s *dev, FAR struct ipfrag_s *frag,
+                 ipfrag_input_t input);
+
+/****************************************************************************
+ * Name: ipfrag_free
+ *
+ * Description:
+ *   Abandon a reassembly and free its IOBs.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfrag_free(FAR struct ipfrag_s *frag);
+
+/****************************************************************************
+ * Name: ipfrag_timer
+ *
+ * Description:
+ *   Abandon the reassemblies that did not complete within
+ *   CONFIG_NET_IPFRAG_MAXAGE seconds.  Called periodically from the device
+ *   polling logic.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfrag_timer(void);
+
+/****************************************************************************
+ * Name: ipv4_reassemble
+ *
+ * Description:
+ *   Handle an IPv4 fragment in the device buffer.  The fragment is stored
+ *   and, once the datagram is complete, the datagram is passed to
+ *   ipv4_input().
+ *
+ * Input Parameters:
+ *   dev - The device that received the fragment.  d_len is the size of
+ *         the IPv4 packet without the link layer header.
+ *
+ * Returned Value:
+ *   OK.  On return, d_len holds the size of any response.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipv4_reassemble(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: ipv6_reassemble
+ *
+ * Description:
+ *   Handle an IPv6 fragment in the device buffer.  The fragment is stored
+ *   and, once the datagram is complete, the datagram is passed to
+ *   ipv6_input().
+ *
+ * Input Parameters:
+ *   dev     - The device that received the fragment.  d_len is the size
+ *             of the IPv6 packet without the link layer header.
+ *   nxtoff  - Offset from the IPv6 header to the next header field that
+ *             refers to the fragment header
+ *   fragoff - Offset from the IPv6 header to the fragment header
+ *
+ * Returned Value:
+ *   OK.  On return, d_len holds the size of any response.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int ipv6_reassemble(FAR struct net_driver_s *dev, uint16_t nxtoff,
+                    uint16_t fragoff);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NET_IPFRAG */
+#endif /* __NET_IPFRAG_IPFRAG_H */
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * net/ipfrag/ipv4_frag.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+
+#include "devif/devif.h"
+#include "utils/utils.h"
+#include "ipfrag/ipfrag.h"
+
+#if defined(CONFIG_NET_IPFRAG) && defined(CONFIG_NET_IPv4)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_reassemble
+ *
+ * Description:
+ *   Handle an IPv4 fragment in the device buffer.  The fragment is stored
+ *   and, once the datagram is complete, the datagram is passed to
+ *   ipv4_input().
+ *
+ * Input Parameters:
+ *   dev - The device that received the fragment.  d_len is the size of
+ *         the IPv4 packet without the link layer header.
+ *
+ * Returned Value:
+ *   OK.  On return, d_len holds the size of any response.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv4_reassemble(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct ipfrag_s *frag;
+  uint16_t iphdrlen;
+  uint16_t offset;
+  uint16_t totlen;
+  uint16_t sum;
+  uint32_t id;
+  bool more;
+  int ret;
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  if (dev->d_len <= iphdrlen)
+    {
+      goto drop;
+    }
+
+  offset = ((((uint16_t)ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) &
+            0x1fff) << 3;
+  more   = (ipv4->ipoffset[0] & (IP_FLAG_MOREFRAGS >> 8)) != 0;
+  id     = ((uint32_t)ipv4->ipid[0] << 8) | ipv4->ipid[1];
+
+  frag = ipfrag_find(PF_INET, ipv4->srcipaddr, ipv4->destipaddr,
+                     sizeof(in_addr_t), id, ipv4->proto);
+
+  /* The header of the first fragment becomes the header of the datagram */
+
+  if (offset == 0 && frag->fr_hdrlen == 0)
+    {
+      memcpy(frag->fr_hdr, ipv4, iphdrlen);
+      frag->fr_hdrlen = iphdrlen;
+    }
+
+  ret = ipfrag_add(frag, (FAR uint8_t *)ipv4 + iphdrlen,
+                   dev->d_len - iphdrlen, offset, more);
+  if (ret < 0)
+    {
+      nwarn("WARNING: Bad IPv4 fragment: %d\n", ret);
+      goto drop;
+    }
+  else if (ret == 0)
+    {
+      /* Wait for more fragments */
+
+      dev->d_len = 0;
+      return OK;
+    }
+
+  /* Pretend to be a "normal" (i.e., not fragmented) IP packet from now
+   * on.
+   */
+
+  ipv4              = (FAR struct ipv4_hdr_s *)frag->fr_hdr;
+  totlen            = frag->fr_hdrlen + frag->fr_total;
+  ipv4->len[0]      = totlen >> 8;
+  ipv4->len[1]      = totlen & 0xff;
+  ipv4->ipoffset[0] = 0;
+  ipv4->ipoffset[1] = 0;
+  ipv4->ipchksum    = 0;
+
+  sum               = chksum(0, frag->fr_hdr, frag->fr_hdrlen);
+  ipv4->ipchksum    = ~((sum == 0) ? 0xffff : htons(sum));
+
+  return ipfrag_input(dev, frag, ipv4_input);
+
+drop:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.drop++;
+  g_netstats.ipv4.fragerr++;
+#endif
+  dev->d_len = 0;
+  return OK;
+}
+
+#endif /* CONFIG_NET_IPFRAG && CONFIG_NET_IPv4 */
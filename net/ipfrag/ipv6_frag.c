@@ -0,0 +1,177 @@
+/****************************************************************************
+ * net/ipfrag/ipv6_frag.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <sys/socket.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/ipv6ext.h>
+
+#include "devif/devif.h"
+#include "ipfrag/ipfrag.h"
+
+#if defined(CONFIG_NET_IPFRAG) && defined(CONFIG_NET_IPv6)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv6_reassemble
+ *
+ * Description:
+ *   Handle an IPv6 fragment in the device buffer.  The fragment is stored
+ *   and, once the datagram is complete, the datagram is passed to
+ *   ipv6_input().
+ *
+ * Input Parameters:
+ *   dev     - The device that received the fragment.  d_len is the size
+ *             of the IPv6 packet without the link layer header.
+ *   nxtoff  - Offset from the IPv6 header to the next header field that
+ *             refers to the fragment header
+ *   fragoff - Offset from the IPv6 header to the fragment header
+ *
+ * Returned Value:
+ *   OK.  On return, d_len holds the size of any response.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv6_reassemble(FAR struct net_driver_s *dev, uint16_t nxtoff,
+                    uint16_t fragoff)
+{
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+  FAR struct ipv6_fragment_extension_s *fraghdr;
+  FAR struct ipfrag_s *frag;
+  uint16_t dataoff;
+  uint16_t offset;
+  uint16_t paylen;
+  uint32_t id;
+  bool more;
+  int ret;
+
+  dataoff = fragoff + sizeof(struct ipv6_fragment_extension_s);
+  if (dev->d_len <= dataoff)
+    {
+      goto drop;
+    }
+
+  fraghdr = (FAR struct ipv6_fragment_extension_s *)
+            ((FAR uint8_t *)ipv6 + fragoff);
+
+  offset  = (((uint16_t)fraghdr->msoffset << 8) | fraghdr->lsoffset) &
+            0xfff8;
+  more    = (fraghdr->lsoffset & 0x01) != 0;
+  id      = ((uint32_t)fraghdr->id[0] << 24) |
+            ((uint32_t)fraghdr->id[1] << 16) |
+            ((uint32_t)fraghdr->id[2] << 8)  |
+            (uint32_t)fraghdr->id[3];
+
+  frag = ipfrag_find(PF_INET6, ipv6->srcipaddr, ipv6->destipaddr,
+                     sizeof(net_ipv6addr_t), id, fraghdr->nxthdr);
+
+  /* The unfragmentable part of the first fragment becomes the header of the
+   * datagram.  The fragment header is removed:  The header that referred
+   * to it now refers to the upper layer.
+   */
+
+  if (offset == 0 && frag->fr_hdrlen == 0)
+    {
+      if (fragoff > IPFRAG_HDRSIZE)
+        {
+          ipfrag_free(frag);
+          nwarn("WARNING: IPv6 header too large: %u\n", fragoff);
+          goto drop;
+        }
+
+      memcpy(frag->fr_hdr, ipv6, fragoff);
+      frag->fr_hdr[nxtoff] = fraghdr->nxthdr;
+      frag->fr_hdrlen      = fragoff;
+    }
+
+  ret = ipfrag_add(frag, (FAR uint8_t *)ipv6 + dataoff,
+                   dev->d_len - dataoff, offset, more);
+  if (ret < 0)
+    {
+      nwarn("WARNING: Bad IPv6 fragment: %d\n", ret);
+      goto drop;
+    }
+  else if (ret == 0)
+    {
+      /* Wait for more fragments */
+
+      dev->d_len = 0;
+      return OK;
+    }
+
+  /* The IPv6 payload length does not include the IPv6 header */
+
+  ipv6         = (FAR struct ipv6_hdr_s *)frag->fr_hdr;
+  paylen       = frag->fr_hdrlen - IPv6_HDRLEN + frag->fr_total;
+  ipv6->len[0] = paylen >> 8;
+  ipv6->len[1] = paylen & 0xff;
+
+  return ipfrag_input(dev, frag, ipv6_input);
+
+drop:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv6.drop++;
+#endif
+  dev->d_len = 0;
+  return OK;
+}
+
+#endif /* CONFIG_NET_IPFRAG && CONFIG_NET_IPv6 */
@@ -62,6 +62,7 @@
 
 #define HAVE_LOCAL_POLL 1
 #define LOCAL_ACCEPT_NPOLLWAITERS 2
+#define LOCAL_RING_NPOLLWAITERS 2
 
 /* Packet format in FIFO:
  *
@@ -126,6 +127,42 @@ enum local_state_s
  *    implemented.
  */
 
+#ifdef CONFIG_NET_LOCAL_RING
+/* One direction of a connected SOCK_STREAM pair.  The byte ring is shared
+ * by the two peers:  The sending peer adds data at lr_head, the receiving
+ * peer removes data at lr_tail.
+ */
+
+struct local_ring_s
+{
+  FAR uint8_t *lr_buffer;      /* The ring buffer */
+  size_t lr_head;              /* Offset where the next byte is added */
+  size_t lr_tail;              /* Offset where the next byte is removed */
+  size_t lr_count;             /* Number of bytes in the ring */
+  uint8_t lr_crefs;            /* Number of peers using the ring */
+  bool lr_closed;              /* True: One of the peers has closed */
+  uint8_t lr_nrdwait;          /* Number of threads waiting for data */
+  uint8_t lr_nwrwait;          /* Number of threads waiting for space */
+  sem_t lr_rdsem;              /* Used to wait for data */
+  sem_t lr_wrsem;              /* Used to wait for space */
+
+#ifndef CONFIG_BUILD_KERNEL
+  /* A receiver waiting on an empty ring may offer its buffer so that the
+   * sender copies directly into it, bypassing the ring.
+   */
+
+  FAR uint8_t *lr_rdbuf;       /* Buffer of the waiting receiver */
+  size_t lr_rdlen;             /* Size of that buffer */
+  size_t lr_rdcount;           /* Number of bytes copied into it */
+#endif
+
+  /* Poll waiters for data (receiver) and for space (sender) */
+
+  FAR struct pollfd *lr_rdfds[LOCAL_RING_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_RING_NPOLLWAITERS];
+};
+#endif
+
 struct devif_callback_s;       /* Forward reference */
 
 struct local_conn_s
@@ -166,6 +203,13 @@ struct local_conn_s
 
   sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Shared rings used by connected peers in place of the FIFOs */
+
+  FAR struct local_ring_s *lc_rxring; /* Incoming data */
+  FAR struct local_ring_s *lc_txring; /* Outgoing data */
+#endif
+
 #ifdef HAVE_LOCAL_POLL
   /* The following is a list if poll structures of threads waiting for
    * socket accept events.
@@ -577,6 +621,76 @@ int local_create_halfduplex(FAR struct local_conn_s *conn,
 int local_release_fifos(FAR struct local_conn_s *conn);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate the pair of shared rings for a new SOCK_STREAM connection.
+ *   Called by the connecting client.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+int local_ring_alloc(FAR struct local_conn_s *client);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_attach
+ *
+ * Description:
+ *   Attach the server-side peer of an accepted connection to the rings of
+ *   the client.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+void local_ring_attach(FAR struct local_conn_s *server,
+                       FAR struct local_conn_s *client);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach a peer from its rings.  The other peer sees end-of-file and the
+ *   rings are freed when both peers have released them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+void local_ring_release(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_send and local_ring_recv
+ *
+ * Description:
+ *   Send data to or receive data from the shared rings of a connected
+ *   SOCK_STREAM peer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+ssize_t local_ring_send(FAR struct socket *psock, FAR const void *buf,
+                        size_t len, int flags);
+ssize_t local_ring_recv(FAR struct socket *psock, FAR void *buf,
+                        size_t len, int flags);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the poll of a connected SOCK_STREAM peer that uses
+ *   the shared rings.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_RING) && defined(HAVE_LOCAL_POLL)
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+                         FAR struct pollfd *fds, bool setup);
+#endif
+
 /****************************************************************************
  * Name: local_release_halfduplex
  *
@@ -156,6 +156,19 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Allocate the shared rings used by the connection */
+
+  ret = local_ring_alloc(client);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to allocate rings for %s: %d\n",
+           client->lc_path, ret);
+
+      net_unlock();
+      return ret;
+    }
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -183,6 +196,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   /* Set the busy "result" before giving the semaphore. */
 
@@ -218,6 +232,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       goto errout_with_outfd;
     }
 
+#ifndef CONFIG_NET_LOCAL_RING
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -229,15 +244,21 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif
+
   client->lc_state = LOCAL_STATE_CONNECTED;
   return OK;
 
 errout_with_outfd:
+#ifdef CONFIG_NET_LOCAL_RING
+  local_ring_release(client);
+#else
   (void)file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
 
 errout_with_fifos:
   (void)local_release_fifos(client);
+#endif
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
 }
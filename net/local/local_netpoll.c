@@ -53,6 +53,24 @@
 
 #ifdef HAVE_LOCAL_POLL
 
+/****************************************************************************
+ * Name: local_inout_poll_cb
+ *
+ * Description:
+ *   Forward the events of one shadow pollfd to the caller's pollfd.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+static void local_inout_poll_cb(FAR struct pollfd *fds)
+{
+  FAR struct pollfd *originfds = (FAR struct pollfd *)fds->arg;
+
+  originfds->revents |= fds->revents;
+  poll_notify(originfds);
+}
+#endif
+
 /****************************************************************************
  * Name: local_accept_pollsetup
  ****************************************************************************/
@@ -152,7 +170,7 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -194,6 +212,13 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_accept_pollsetup(conn, fds, true);
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      return local_ring_pollsetup(conn, fds, true);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       fds->priv = NULL;
@@ -226,10 +251,14 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
           shadowfds[0].fd     = 0; /* Does not matter */
           shadowfds[0].sem    = fds->sem;
           shadowfds[0].events = fds->events & ~POLLOUT;
+          shadowfds[0].cb     = local_inout_poll_cb;
+          shadowfds[0].arg    = fds;
 
           shadowfds[1].fd     = 1; /* Does not matter */
           shadowfds[1].sem    = fds->sem;
           shadowfds[1].events = fds->events & ~POLLIN;
+          shadowfds[1].cb     = local_inout_poll_cb;
+          shadowfds[1].arg    = fds;
 
           /* Setup poll for both shadow pollfds. */
 
@@ -295,7 +324,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
 pollerr:
   fds->revents |= POLLERR;
-  nxsem_post(fds->sem);
+  poll_notify(fds);
   return OK;
 }
 
@@ -335,6 +364,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_accept_pollsetup(conn, fds, false);
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      return local_ring_pollsetup(conn, fds, false);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       return OK;
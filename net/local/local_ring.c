@@ -0,0 +1,682 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define LOCAL_RINGSIZE CONFIG_NET_LOCAL_RINGSIZE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_new
+ *
+ * Description:
+ *   Allocate and initialize one ring.
+ *
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_new(void)
+{
+  FAR struct local_ring_s *ring;
+
+  ring = (FAR struct local_ring_s *)kmm_zalloc(sizeof(struct local_ring_s));
+  if (ring == NULL)
+    {
+      return NULL;
+    }
+
+  ring->lr_buffer = (FAR uint8_t *)kmm_malloc(LOCAL_RINGSIZE);
+  if (ring->lr_buffer == NULL)
+    {
+      kmm_free(ring);
+      return NULL;
+    }
+
+  /* These semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_setprotocol(&ring->lr_rdsem, SEM_PRIO_NONE);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  nxsem_setprotocol(&ring->lr_wrsem, SEM_PRIO_NONE);
+
+  ring->lr_crefs = 1;
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_free
+ ****************************************************************************/
+
+static void local_ring_free(FAR struct local_ring_s *ring)
+{
+  nxsem_destroy(&ring->lr_rdsem);
+  nxsem_destroy(&ring->lr_wrsem);
+  kmm_free(ring->lr_buffer);
+  kmm_free(ring);
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait for the ring to change state.  The network lock is released while
+ *   waiting.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, FAR uint8_t *nwait)
+{
+  int ret;
+
+  DEBUGASSERT(*nwait < UINT8_MAX);
+  (*nwait)++;
+
+  ret = net_lockedwait(sem);
+  if (ret < 0 && *nwait > 0)
+    {
+      /* Awakened by a signal.  We are no longer waiting. */
+
+      (*nwait)--;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on the semaphore.
+ *
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem, FAR uint8_t *nwait)
+{
+  while (*nwait > 0)
+    {
+      (*nwait)--;
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_pollnotify
+ *
+ * Description:
+ *   Report events to the poll waiters of one end of a ring.  POLLHUP is
+ *   always reported.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static void local_ring_pollnotify(FAR struct pollfd **slots,
+                                  pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      fds = slots[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset) | (eventset & POLLHUP);
+          if (fds->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds->revents);
+              poll_notify(fds);
+            }
+        }
+    }
+}
+#else
+#  define local_ring_pollnotify(s,e)
+#endif
+
+/****************************************************************************
+ * Name: local_ring_copyin and local_ring_copyout
+ *
+ * Description:
+ *   Add data to or remove data from the ring, handling the wrap-around.
+ *   The caller has verified that there is enough space or data.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyin(FAR struct local_ring_s *ring,
+                              FAR const uint8_t *src, size_t len)
+{
+  size_t ncopy = MIN(len, LOCAL_RINGSIZE - ring->lr_head);
+
+  memcpy(&ring->lr_buffer[ring->lr_head], src, ncopy);
+  memcpy(ring->lr_buffer, &src[ncopy], len - ncopy);
+
+  ring->lr_head   = (ring->lr_head + len) % LOCAL_RINGSIZE;
+  ring->lr_count += len;
+}
+
+static void local_ring_copyout(FAR struct local_ring_s *ring,
+                               FAR uint8_t *dest, size_t len)
+{
+  size_t ncopy = MIN(len, LOCAL_RINGSIZE - ring->lr_tail);
+
+  memcpy(dest, &ring->lr_buffer[ring->lr_tail], ncopy);
+  memcpy(&dest[ncopy], ring->lr_buffer, len - ncopy);
+
+  ring->lr_tail   = (ring->lr_tail + len) % LOCAL_RINGSIZE;
+  ring->lr_count -= len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate the pair of shared rings for a new SOCK_STREAM connection.
+ *   Called by the connecting client.
+ *
+ * Input Parameters:
+ *   client - The client connection
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings could not be allocated.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *client)
+{
+  DEBUGASSERT(client->lc_rxring == NULL && client->lc_txring == NULL);
+
+  client->lc_txring = local_ring_new();
+  if (client->lc_txring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  client->lc_rxring = local_ring_new();
+  if (client->lc_rxring == NULL)
+    {
+      local_ring_free(client->lc_txring);
+      client->lc_txring = NULL;
+      return -ENOMEM;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_attach
+ *
+ * Description:
+ *   Attach the server-side peer of an accepted connection to the rings of
+ *   the client:  The client's outgoing ring is the server's incoming ring
+ *   and vice versa.
+ *
+ * Input Parameters:
+ *   server - The new server-side peer connection
+ *   client - The connecting client
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_ring_attach(FAR struct local_conn_s *server,
+                       FAR struct local_conn_s *client)
+{
+  DEBUGASSERT(client->lc_rxring != NULL && client->lc_txring != NULL);
+
+  server->lc_rxring = client->lc_txring;
+  server->lc_txring = client->lc_rxring;
+  server->lc_rxring->lr_crefs++;
+  server->lc_txring->lr_crefs++;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach a peer from its rings.  Any threads or poll waiters of the other
+ *   peer are awakened; the other peer sees end-of-file on receive and
+ *   EPIPE on send.  The rings are freed when both peers have released
+ *   them.
+ *
+ * Input Parameters:
+ *   conn - The peer connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+  FAR struct local_ring_s *rings[2];
+  FAR struct local_ring_s *ring;
+  int i;
+
+  net_lock();
+
+  rings[0]        = conn->lc_rxring;
+  rings[1]        = conn->lc_txring;
+  conn->lc_rxring = NULL;
+  conn->lc_txring = NULL;
+
+  for (i = 0; i < 2; i++)
+    {
+      ring = rings[i];
+      if (ring == NULL)
+        {
+          continue;
+        }
+
+      ring->lr_closed = true;
+      local_ring_wakeup(&ring->lr_rdsem, &ring->lr_nrdwait);
+      local_ring_wakeup(&ring->lr_wrsem, &ring->lr_nwrwait);
+      local_ring_pollnotify(ring->lr_rdfds, POLLIN | POLLHUP);
+      local_ring_pollnotify(ring->lr_wrfds, POLLHUP);
+
+      DEBUGASSERT(ring->lr_crefs > 0);
+      if (--ring->lr_crefs == 0)
+        {
+          local_ring_free(ring);
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Send data on a connected SOCK_STREAM peer by copying it into the shared
+ *   outgoing ring, waiting for space as necessary.  If the receiving peer
+ *   is waiting on an empty ring, the data is copied directly into its
+ *   buffer instead.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   buf   - Data to send
+ *   len   - Length of data to send
+ *   flags - Send flags (only MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   The number of bytes sent on success.  A partial count is returned if a
+ *   non-blocking send runs out of space or if the wait is interrupted.  A
+ *   negated errno value is returned if nothing was sent:  -EAGAIN if the
+ *   ring is full, -EPIPE if the peer has closed.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct socket *psock, FAR const void *buf,
+                        size_t len, int flags)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR const uint8_t *src = (FAR const uint8_t *)buf;
+  FAR struct local_ring_s *ring;
+  size_t nsent = 0;
+  size_t ncopy;
+  bool nonblock;
+  int ret = OK;
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  net_lock();
+  ring = conn->lc_txring;
+  DEBUGASSERT(ring != NULL);
+
+  while (nsent < len)
+    {
+      if (ring->lr_closed)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+#ifndef CONFIG_BUILD_KERNEL
+      if (ring->lr_rdbuf != NULL && ring->lr_count == 0)
+        {
+          /* The receiver is waiting on the empty ring.  Hand the data
+           * directly to it.
+           */
+
+          ncopy = MIN(len - nsent, ring->lr_rdlen);
+          memcpy(ring->lr_rdbuf, &src[nsent], ncopy);
+
+          ring->lr_rdcount = ncopy;
+          ring->lr_rdbuf   = NULL;
+          nsent           += ncopy;
+
+          local_ring_wakeup(&ring->lr_rdsem, &ring->lr_nrdwait);
+          continue;
+        }
+#endif
+
+      ncopy = MIN(len - nsent, LOCAL_RINGSIZE - ring->lr_count);
+      if (ncopy == 0)
+        {
+          /* The ring is full */
+
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = local_ring_wait(&ring->lr_wrsem, &ring->lr_nwrwait);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      local_ring_copyin(ring, &src[nsent], ncopy);
+      nsent += ncopy;
+
+      local_ring_wakeup(&ring->lr_rdsem, &ring->lr_nrdwait);
+      local_ring_pollnotify(ring->lr_rdfds, POLLIN);
+    }
+
+  net_unlock();
+  return nsent > 0 ? (ssize_t)nsent : (ssize_t)ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive data on a connected SOCK_STREAM peer from the shared incoming
+ *   ring, waiting for data as necessary.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   buf   - Buffer to receive the data
+ *   len   - Length of the buffer
+ *   flags - Receive flags (only MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   The number of bytes received on success; zero if the peer has closed
+ *   and all data has been received.  A negated errno value is returned on
+ *   failure: -EAGAIN if no data is available on a non-blocking receive.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct socket *psock, FAR void *buf,
+                        size_t len, int flags)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR struct local_ring_s *ring;
+  ssize_t ret;
+  size_t ncopy;
+  bool nonblock;
+#ifndef CONFIG_BUILD_KERNEL
+  bool offered;
+#endif
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  net_lock();
+  ring = conn->lc_rxring;
+  DEBUGASSERT(ring != NULL);
+
+  for (; ; )
+    {
+      if (ring->lr_count > 0)
+        {
+          ncopy = MIN(len, ring->lr_count);
+          local_ring_copyout(ring, (FAR uint8_t *)buf, ncopy);
+          ret   = ncopy;
+
+          local_ring_wakeup(&ring->lr_wrsem, &ring->lr_nwrwait);
+          local_ring_pollnotify(ring->lr_wrfds, POLLOUT);
+          break;
+        }
+
+      if (ring->lr_closed || len == 0)
+        {
+          ret = 0;
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+#ifndef CONFIG_BUILD_KERNEL
+      /* Offer our buffer to the sender so that it can copy the data
+       * directly.  Only one receiver may do this at a time.
+       */
+
+      offered = false;
+      if (ring->lr_rdbuf == NULL && ring->lr_rdcount == 0)
+        {
+          ring->lr_rdbuf = (FAR uint8_t *)buf;
+          ring->lr_rdlen = len;
+          offered        = true;
+        }
+#endif
+
+      ret = local_ring_wait(&ring->lr_rdsem, &ring->lr_nrdwait);
+
+#ifndef CONFIG_BUILD_KERNEL
+      if (offered)
+        {
+          if (ring->lr_rdbuf == NULL)
+            {
+              /* The sender has filled our buffer */
+
+              ret              = ring->lr_rdcount;
+              ring->lr_rdcount = 0;
+              break;
+            }
+
+          /* Withdraw the offer */
+
+          ring->lr_rdbuf = NULL;
+        }
+#endif
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the poll of a connected SOCK_STREAM peer that uses
+ *   the shared rings.  The poll structure is registered as a receiver of
+ *   the incoming ring (POLLIN) and as a sender on the outgoing ring
+ *   (POLLOUT).
+ *
+ * Input Parameters:
+ *   conn  - The peer connection
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+                         FAR struct pollfd *fds, bool setup)
+{
+  FAR struct local_ring_s *rxring;
+  FAR struct local_ring_s *txring;
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
+  int j;
+
+  net_lock();
+  rxring = conn->lc_rxring;
+  txring = conn->lc_txring;
+  DEBUGASSERT(rxring != NULL && txring != NULL);
+
+  if (setup)
+    {
+      /* Find an available slot in each ring */
+
+      for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+        {
+          if (rxring->lr_rdfds[i] == NULL)
+            {
+              break;
+            }
+        }
+
+      for (j = 0; j < LOCAL_RING_NPOLLWAITERS; j++)
+        {
+          if (txring->lr_wrfds[j] == NULL)
+            {
+              break;
+            }
+        }
+
+      if (i >= LOCAL_RING_NPOLLWAITERS || j >= LOCAL_RING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      rxring->lr_rdfds[i] = fds;
+      txring->lr_wrfds[j] = fds;
+      fds->priv           = conn;
+
+      /* Report the events that are already pending */
+
+      eventset = 0;
+      if (rxring->lr_count > 0 || rxring->lr_closed)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (txring->lr_count < LOCAL_RINGSIZE)
+        {
+          eventset |= POLLOUT;
+        }
+
+      if (rxring->lr_closed || txring->lr_closed)
+        {
+          eventset |= POLLHUP;
+        }
+
+      fds->revents |= (fds->events & eventset) | (eventset & POLLHUP);
+      if (fds->revents != 0)
+        {
+          poll_notify(fds);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* Remove all memory of the poll setup */
+
+      for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+        {
+          if (rxring->lr_rdfds[i] == fds)
+            {
+              rxring->lr_rdfds[i] = NULL;
+            }
+
+          if (txring->lr_wrfds[i] == fds)
+            {
+              txring->lr_wrfds[i] = NULL;
+            }
+        }
+
+      fds->priv = NULL;
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET_LOCAL_RING */
@@ -77,7 +77,9 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags)
 {
   FAR struct local_conn_s *peer;
+#ifndef CONFIG_NET_LOCAL_RING
   int ret;
+#endif
 
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
@@ -87,12 +89,21 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
    */
 
   if (peer->lc_state != LOCAL_STATE_CONNECTED ||
+#ifdef CONFIG_NET_LOCAL_RING
+      peer->lc_txring == NULL)
+#else
       peer->lc_outfile.f_inode == NULL)
+#endif
     {
       nerr("ERROR: not connected\n");
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Copy the data into the shared ring.  No packet framing is needed. */
+
+  return local_ring_send(psock, buf, len, flags);
+#else
   /* Send the packet */
 
   ret = local_send_packet(&peer->lc_outfile, (FAR uint8_t *)buf, len);
@@ -100,6 +111,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
   /* If the send was successful, then the full packet will have been sent */
 
   return ret < 0 ? ret : len;
+#endif
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
@@ -46,6 +46,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <net/ethernet.h>
 
@@ -57,6 +58,32 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The links of the Neighbor Table hold entry indices plus one, so that zero
+ * (the initial value) means no entry.
+ */
+
+#define NEIGHBOR_NOENTRY  0
+#define NEIGHBOR_NDX(n)   ((uint16_t)((n) - g_neighbors) + 1)
+#define NEIGHBOR_ENTRY(n) (&g_neighbors[(n) - 1])
+#define NEIGHBOR_LINK(n)  (&g_neighbor_links[(n) - 1])
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The hash chain and LRU list links of one Neighbor Table entry */
+
+struct neighbor_link_s
+{
+  uint16_t nl_hnext;            /* Next entry in the hash chain */
+  uint16_t nl_prev;             /* More recently used entry */
+  uint16_t nl_next;             /* Less recently used entry */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -67,6 +94,18 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The table is indexed by a hash of the IPv6 address.  The entries in use
+ * are also kept in a list from the most recently used (g_neighbor_mru) to
+ * the least recently used (g_neighbor_lru) entry, which is replaced when
+ * the table is full.  g_neighbor_nused is the number of entries in use.
+ */
+
+extern struct neighbor_link_s g_neighbor_links[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern uint16_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern uint16_t g_neighbor_mru;
+extern uint16_t g_neighbor_lru;
+extern uint16_t g_neighbor_nused;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -91,6 +130,27 @@ struct net_driver_s; /* Forward reference */
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_hashchain
+ *
+ * Description:
+ *   Return the head of the hash chain of the IPv6 address.
+ *
+ ****************************************************************************/
+
+FAR uint16_t *neighbor_hashchain(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make the Neighbor Table entry the most recently used one.  'insert' is
+ *   true if the entry is not yet in the LRU list.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry_s *neighbor, bool insert);
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -53,6 +53,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
@@ -81,53 +82,92 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  FAR uint16_t *head;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
-  int     i;
+  uint16_t ndx;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Find the matching entry in the hash chain of the address */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
+  head   = neighbor_hashchain(ipaddr);
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (ndx = *head; ndx != NEIGHBOR_NOENTRY; ndx = NEIGHBOR_LINK(ndx)->nl_hnext)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      neighbor = NEIGHBOR_ENTRY(ndx);
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
+
+  if (ndx != NEIGHBOR_NOENTRY)
+    {
+      neighbor_touch(neighbor, false);
+    }
+  else
+    {
+      /* Use the first free entry or else replace the least recently used
+       * entry.
+       */
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      if (g_neighbor_nused < CONFIG_NET_IPv6_NCONF_ENTRIES)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          ndx = ++g_neighbor_nused;
+        }
+      else
+        {
+          FAR uint16_t *pndx;
+
+          ndx = g_neighbor_lru;
+          DEBUGASSERT(ndx != NEIGHBOR_NOENTRY);
+
+          /* Remove the entry from its hash chain and from the LRU list */
+
+          for (pndx = neighbor_hashchain(NEIGHBOR_ENTRY(ndx)->ne_ipaddr);
+               *pndx != NEIGHBOR_NOENTRY;
+               pndx = &NEIGHBOR_LINK(*pndx)->nl_hnext)
+            {
+              if (*pndx == ndx)
+                {
+                  *pndx = NEIGHBOR_LINK(ndx)->nl_hnext;
+                  break;
+                }
+            }
+
+          g_neighbor_lru = NEIGHBOR_LINK(ndx)->nl_prev;
+          if (g_neighbor_lru != NEIGHBOR_NOENTRY)
+            {
+              NEIGHBOR_LINK(g_neighbor_lru)->nl_next = NEIGHBOR_NOENTRY;
+            }
+          else
+            {
+              g_neighbor_mru = NEIGHBOR_NOENTRY;
+            }
+
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.neighbor.evict++;
+#endif
         }
-    }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+      neighbor = NEIGHBOR_ENTRY(ndx);
+      NEIGHBOR_LINK(ndx)->nl_hnext = *head;
+      *head = ndx;
+      neighbor_touch(neighbor, true);
+    }
 
-  g_neighbors[oldest_ndx].ne_time = clock_systimer();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_time = clock_systimer();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -52,6 +52,74 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_hashchain
+ *
+ * Description:
+ *   Return the head of the hash chain of the IPv6 address.  The low order
+ *   bits of the address are the ones that differ on a local network.
+ *
+ ****************************************************************************/
+
+FAR uint16_t *neighbor_hashchain(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash;
+
+  hash = ((uint32_t)ipaddr[4] << 16 | ipaddr[5]) ^
+         ((uint32_t)ipaddr[6] << 16 | ipaddr[7]);
+  return &g_neighbor_hash[((hash * 0x9e3779b1) >> 16) %
+                          CONFIG_NET_IPv6_NCONF_ENTRIES];
+}
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make the Neighbor Table entry the most recently used one.  'insert' is
+ *   true if the entry is not yet in the LRU list.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry_s *neighbor, bool insert)
+{
+  uint16_t ndx = NEIGHBOR_NDX(neighbor);
+  FAR struct neighbor_link_s *link = NEIGHBOR_LINK(ndx);
+
+  if (!insert)
+    {
+      if (link->nl_prev == NEIGHBOR_NOENTRY)
+        {
+          /* Already the most recently used entry */
+
+          return;
+        }
+
+      NEIGHBOR_LINK(link->nl_prev)->nl_next = link->nl_next;
+      if (link->nl_next != NEIGHBOR_NOENTRY)
+        {
+          NEIGHBOR_LINK(link->nl_next)->nl_prev = link->nl_prev;
+        }
+      else
+        {
+          g_neighbor_lru = link->nl_prev;
+        }
+    }
+
+  link->nl_prev = NEIGHBOR_NOENTRY;
+  link->nl_next = g_neighbor_mru;
+
+  if (g_neighbor_mru != NEIGHBOR_NOENTRY)
+    {
+      NEIGHBOR_LINK(g_neighbor_mru)->nl_prev = ndx;
+    }
+  else
+    {
+      g_neighbor_lru = ndx;
+    }
+
+  g_neighbor_mru = ndx;
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -70,11 +138,13 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  uint16_t ndx;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (ndx = *neighbor_hashchain(ipaddr);
+       ndx != NEIGHBOR_NOENTRY;
+       ndx = NEIGHBOR_LINK(ndx)->nl_hnext)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = NEIGHBOR_ENTRY(ndx);
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
@@ -56,3 +56,11 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash chains and LRU list of the Neighbor table */
+
+struct neighbor_link_s g_neighbor_links[CONFIG_NET_IPv6_NCONF_ENTRIES];
+uint16_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_ENTRIES];
+uint16_t g_neighbor_mru;
+uint16_t g_neighbor_lru;
+uint16_t g_neighbor_nused;
+
@@ -49,6 +49,7 @@
 
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
@@ -139,6 +140,14 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.neighbor.hit++;
+#endif
+
+      /* Keep the entry from being replaced while it is in use */
+
+      neighbor_touch(neighbor, false);
+
       /* Yes.. return the link layer address if the caller has provided a
        * non-NULL address in 'laddr'.
        */
@@ -160,6 +169,10 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
    * to the linker layer address assigned to the network device.
    */
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.neighbor.miss++;
+#endif
+
   net_ipv6addr_copy(info.ni_ipaddr, ipaddr);
   info.ni_laddr = laddr;
 
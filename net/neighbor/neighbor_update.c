@@ -73,5 +73,6 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   if (neighbor != NULL)
     {
       neighbor->ne_time = clock_systimer();
+      neighbor_touch(neighbor, false);
     }
 }
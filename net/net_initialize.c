@@ -98,6 +98,10 @@ void net_initialize(void)
 
   net_lockinitialize();
 
+  /* Initialize the list of registered network devices */
+
+  netdev_initialize();
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_MLD
   /* Initialize ICMPv6 Multicast Listener Discovery (MLD) logic */
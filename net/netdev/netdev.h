@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/rwsem.h>
 #include <nuttx/net/ip.h>
 
 #ifdef CONFIG_NETDOWN_NOTIFIER
@@ -61,6 +62,15 @@
 
 #define MAX_IFINDEX  32
 
+/* Take and release the lock that protects the list of registered devices.
+ * These cannot fail because the waits are uninterruptible.
+ */
+
+#define netdev_list_rdlock()   ((void)nxrwsem_rdlock(&g_netdev_lock))
+#define netdev_list_rdunlock() nxrwsem_rdunlock(&g_netdev_lock)
+#define netdev_list_wrlock()   ((void)nxrwsem_wrlock(&g_netdev_lock))
+#define netdev_list_wrunlock() nxrwsem_wrunlock(&g_netdev_lock)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -74,14 +84,23 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* List of registered Ethernet device drivers.  You must have the network
- * locked in order to access this list.
+/* List of registered Ethernet device drivers.  The list is modified only
+ * while holding both the network lock and the write lock on g_netdev_lock.
+ * So either the network lock or the read lock on g_netdev_lock is
+ * sufficient to walk the list.
  *
  * NOTE that this duplicates a declaration in net/tcp/tcp.h
  */
 
 EXTERN struct net_driver_s *g_netdevices;
 
+/* Protects the list of registered devices (and the interface index set).
+ * This must always be taken after the network lock.  Readers must not
+ * nest the read lock and must not wait for anything while holding it.
+ */
+
+EXTERN rw_semaphore_t g_netdev_lock;
+
 #ifdef CONFIG_NETDEV_IFINDEX
 /* The set of network devices that have been registered.  This is used to
  * assign a unique device index to the newly registered device.
@@ -114,6 +133,18 @@ typedef int (*netdev_callback_t)(FAR struct net_driver_s *dev, FAR void *arg);
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_initialize
+ *
+ * Description:
+ *   Initialize the lock that protects the list of registered network
+ *   devices.  Called from net_initialize() before any device is
+ *   registered.
+ *
+ ****************************************************************************/
+
+void netdev_initialize(void);
+
 /****************************************************************************
  * Name: netdev_ifup / netdev_ifdown
  *
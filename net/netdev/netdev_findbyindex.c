@@ -85,7 +85,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     }
 #endif
 
-  net_lock();
+  netdev_list_rdlock();
 
 #ifdef CONFIG_NETDEV_IFINDEX
   /* Check if this index has been assigned */
@@ -94,7 +94,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     {
       /* This index has not been assigned */
 
-      net_unlock();
+      netdev_list_rdunlock();
       return NULL;
     }
 #endif
@@ -117,12 +117,12 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
       if (i == (ifindex - 1))
 #endif
         {
-          net_unlock();
+          netdev_list_rdunlock();
           return dev;
         }
     }
 
-  net_unlock();
+  netdev_list_rdunlock();
   return NULL;
 }
 
@@ -154,7 +154,7 @@ int netdev_nextindex(int ifindex)
 
   if (ifindex >= 0 && ifindex < MAX_IFINDEX)
     {
-      net_lock();
+      netdev_list_rdlock();
       for (; ifindex < MAX_IFINDEX; ifindex++)
         {
           if ((g_devset & (1L << ifindex)) != 0)
@@ -163,12 +163,12 @@ int netdev_nextindex(int ifindex)
                * mean no-index in the POSIX standards.
                */
 
-              net_unlock();
+              netdev_list_rdunlock();
               return ifindex + 1;
             }
         }
 
-      net_unlock();
+      netdev_list_rdunlock();
     }
 
   return -ENODEV;
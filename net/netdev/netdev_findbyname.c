@@ -72,17 +72,17 @@ FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 
   if (ifname)
     {
-      net_lock();
+      netdev_list_rdlock();
       for (dev = g_netdevices; dev; dev = dev->flink)
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              net_unlock();
+              netdev_list_rdunlock();
               return dev;
             }
         }
 
-      net_unlock();
+      netdev_list_rdunlock();
     }
 
   return NULL;
@@ -0,0 +1,271 @@
+/****************************************************************************
+ * net/netdev/netdev_input.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ETHERNET)
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/arp.h>
+
+#ifdef CONFIG_NET_PKT
+#  include <nuttx/net/pkt.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BUF ((FAR struct eth_hdr_s *)&dev->d_buf[0])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_reply
+ *
+ * Description:
+ *   If the dispatch of a received IP packet resulted in an outgoing packet,
+ *   add the link layer addresses and send it.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+static void netdev_reply(FAR struct net_driver_s *dev,
+                         CODE int (*txframe)(FAR struct net_driver_s *dev))
+{
+  if (dev->d_len > 0)
+    {
+      /* Update the Ethernet header with the correct MAC address */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(dev->d_flags))
+#endif
+        {
+          arp_out(dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          neighbor_out(dev);
+        }
+#endif
+
+      /* And send the packet */
+
+      txframe(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_input
+ *
+ * Description:
+ *   Dispatch the Ethernet frame in d_buf to the network.  If the frame
+ *   results in an outgoing packet, such as an ACK or an ARP reply, the
+ *   link layer addresses of that packet are resolved and it is sent with
+ *   'txframe'.
+ *
+ *   This is the input processing that each Ethernet driver otherwise
+ *   implements itself.
+ *
+ * Input Parameters:
+ *   dev     - The network device.  d_buf and d_len describe the frame.
+ *   txframe - Sends the frame in d_buf and d_len
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the frame was dispatched; -EPROTO is returned
+ *   if the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_input(FAR struct net_driver_s *dev,
+                 CODE int (*txframe)(FAR struct net_driver_s *dev))
+{
+  DEBUGASSERT(dev != NULL && dev->d_buf != NULL && txframe != NULL);
+
+  /* Check if the frame is a valid size for the network buffer
+   * configuration.
+   */
+
+  if (dev->d_len < ETH_HDRLEN || dev->d_len > NETDEV_PKTSIZE(dev))
+    {
+      nwarn("WARNING: DROPPED Bad size: %u\n", dev->d_len);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+      return -EPROTO;
+    }
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the packet tap */
+
+  pkt_input(dev);
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (BUF->type == HTONS(ETHTYPE_IP))
+    {
+      NETDEV_RXIPV4(dev);
+
+      /* Handle ARP on input, then dispatch the IPv4 packet */
+
+      arp_ipin(dev);
+      ipv4_input(dev);
+      netdev_reply(dev, txframe);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+    {
+      NETDEV_RXIPV6(dev);
+
+      /* Dispatch the IPv6 packet */
+
+      ipv6_input(dev);
+      netdev_reply(dev, txframe);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (BUF->type == HTONS(ETHTYPE_ARP))
+    {
+      NETDEV_RXARP(dev);
+
+      /* Dispatch the ARP packet.  An ARP reply is sent as is. */
+
+      arp_arpin(dev);
+      if (dev->d_len > 0)
+        {
+          txframe(dev);
+        }
+    }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+      return -EPROTO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_input_batch
+ *
+ * Description:
+ *   Receive up to 'budget' frames from the driver and dispatch each of them
+ *   with netdev_input(), taking the network lock once for the whole batch.
+ *
+ *   For each frame, ops->rxframe() is called to set up d_buf and d_len.  It
+ *   returns a negated errno value when there are no more frames.  Then the
+ *   frame is dispatched.  Any reply is sent with ops->txframe(), which may
+ *   take over d_buf (and set it to NULL).  Finally ops->rxdone(), if
+ *   provided, is called to release the receive buffer if d_buf is still
+ *   set.
+ *
+ *   Transmission is batched in the same way by devif_poll():  The poll
+ *   callback of the driver is called for every outgoing packet until it
+ *   returns a non-zero value, so a driver can queue as many packets per TX
+ *   opportunity as it has TX descriptors free.
+ *
+ * Input Parameters:
+ *   dev    - The network device
+ *   ops    - The driver callbacks
+ *   budget - The maximum number of frames to receive
+ *
+ * Returned Value:
+ *   The number of frames received.  If this is equal to 'budget', more
+ *   frames may be pending.
+ *
+ ****************************************************************************/
+
+int netdev_input_batch(FAR struct net_driver_s *dev,
+                       FAR const struct netdev_rxops_s *ops, int budget)
+{
+  int nframes;
+
+  DEBUGASSERT(dev != NULL && ops != NULL && ops->rxframe != NULL &&
+              ops->txframe != NULL);
+
+  net_lock();
+  for (nframes = 0; nframes < budget; nframes++)
+    {
+      if (ops->rxframe(dev) < 0)
+        {
+          break;
+        }
+
+      netdev_input(dev, ops->txframe);
+
+      /* We are finished with the RX buffer.  If the buffer was re-used
+       * for transmission, d_buf will have been nullified.
+       */
+
+      if (ops->rxdone != NULL && dev->d_buf != NULL)
+        {
+          ops->rxdone(dev);
+        }
+    }
+
+  net_unlock();
+  return nframes;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_ETHERNET */
@@ -89,6 +89,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "pkt/pkt.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -1567,6 +1568,46 @@ ssize_t net_ioctl_arglen(int cmd)
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_recviob_ioctl
+ *
+ * Description:
+ *   Zero-copy TCP receive.  The I/O buffer chains are in kernel memory, so
+ *   this is only available to applications in the FLAT build.
+ *
+ * Input Parameters:
+ *   psock    Socket structure
+ *   cmd      The ioctl command
+ *   arg      The argument of the ioctl cmd
+ *
+ * Returned Value:
+ *   The number of bytes received for SIOCRECVIOB, zero for SIOCFREEIOB,
+ *   and a negated errno value on failure.  -ENOTTY is returned if the
+ *   command is not one of these.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_RECVIOB) && !defined(CONFIG_BUILD_PROTECTED) && \
+    !defined(CONFIG_BUILD_KERNEL)
+static int netdev_recviob_ioctl(FAR struct socket *psock, int cmd,
+                                unsigned long arg)
+{
+  switch (cmd)
+    {
+      case SIOCRECVIOB:
+        return psock_recviob(psock, (FAR struct iob_s **)((uintptr_t)arg),
+                             0);
+
+      case SIOCFREEIOB:
+        psock_freeiob((FAR struct iob_s *)((uintptr_t)arg));
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: psock_ioctl
  *
@@ -1692,6 +1733,25 @@ int psock_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
     }
 #endif
 
+#if defined(CONFIG_NET_TCP_RECVIOB) && !defined(CONFIG_BUILD_PROTECTED) && \
+    !defined(CONFIG_BUILD_KERNEL)
+  /* Check for zero-copy receive commands */
+
+  if (ret == -ENOTTY)
+    {
+      ret = netdev_recviob_ioctl(psock, cmd, arg);
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+  /* Check for the mmap() of the rings of a packet socket */
+
+  if (ret == -ENOTTY && psock->s_domain == PF_PACKET)
+    {
+      ret = pkt_ring_ioctl(psock, cmd, arg);
+    }
+#endif
+
   return ret;
 }
 
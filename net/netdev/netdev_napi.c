@@ -0,0 +1,211 @@
+/****************************************************************************
+ * net/netdev/netdev_napi.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/napi.h>
+
+#ifdef CONFIG_NETDEV_NAPI
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_napi_work
+ *
+ * Description:
+ *   Run the driver poll callback on the work queue.
+ *
+ ****************************************************************************/
+
+static void netdev_napi_work(FAR void *arg)
+{
+  FAR struct netdev_napi_s *napi = (FAR struct netdev_napi_s *)arg;
+  irqstate_t flags;
+  int nframes;
+
+  net_lock();
+  nframes = napi->poll(napi, napi->budget);
+  net_unlock();
+
+#ifdef CONFIG_NETDEV_STATISTICS
+  napi->polls++;
+  napi->frames += nframes;
+#endif
+
+  /* Nothing more to do if the poll was cancelled in the meantime */
+
+  flags = enter_critical_section();
+  if (napi->scheduled)
+    {
+      if (nframes >= napi->budget)
+        {
+          /* There may be more frames.  Keep the interrupts masked and poll
+           * again after whatever else is queued.
+           */
+
+#ifdef CONFIG_NETDEV_STATISTICS
+          napi->exhausted++;
+#endif
+          work_queue(napi->qid, &napi->work, netdev_napi_work, napi, 0);
+        }
+      else
+        {
+          /* All caught up.  A frame that arrived after the last one polled
+           * leaves its interrupt pending, so it is handled as soon as the
+           * interrupts are unmasked.
+           */
+
+          napi->scheduled = false;
+          napi->irqctl(napi, true);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_napi_init
+ *
+ * Description:
+ *   Initialize the polling state of a device.
+ *
+ * Input Parameters:
+ *   napi   - The polling state to initialize
+ *   dev    - The network device
+ *   poll   - The budget-limited driver poll callback
+ *   irqctl - The driver interrupt mask callback
+ *   qid    - The work queue to poll on.  Should be LPWORK.
+ *   budget - The maximum number of frames per poll callback, or zero to
+ *            use CONFIG_NETDEV_NAPI_BUDGET
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_napi_init(FAR struct netdev_napi_s *napi,
+                      FAR struct net_driver_s *dev,
+                      netdev_napipoll_t poll, netdev_napiirq_t irqctl,
+                      int qid, int budget)
+{
+  DEBUGASSERT(napi != NULL && dev != NULL && poll != NULL &&
+              irqctl != NULL && budget >= 0);
+
+  memset(napi, 0, sizeof(struct netdev_napi_s));
+  napi->dev     = dev;
+  napi->poll    = poll;
+  napi->irqctl  = irqctl;
+  napi->qid     = qid;
+  napi->budget  = budget > 0 ? budget : CONFIG_NETDEV_NAPI_BUDGET;
+}
+
+/****************************************************************************
+ * Name: netdev_napi_schedule
+ *
+ * Description:
+ *   Mask the device interrupts and schedule the poll callback, unless it
+ *   is already scheduled.
+ *
+ * Input Parameters:
+ *   napi - The polling state of the device
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the poll was scheduled; -EBUSY is returned if
+ *   it was already scheduled.
+ *
+ ****************************************************************************/
+
+int netdev_napi_schedule(FAR struct netdev_napi_s *napi)
+{
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  flags = enter_critical_section();
+  if (!napi->scheduled)
+    {
+      napi->scheduled = true;
+      napi->irqctl(napi, false);
+      work_queue(napi->qid, &napi->work, netdev_napi_work, napi, 0);
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_napi_cancel
+ *
+ * Description:
+ *   Cancel a scheduled poll.  The device interrupts are left masked.
+ *
+ * Input Parameters:
+ *   napi - The polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_napi_cancel(FAR struct netdev_napi_s *napi)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  napi->irqctl(napi, false);
+  napi->scheduled = false;
+  work_cancel(napi->qid, &napi->work);
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_NETDEV_NAPI */
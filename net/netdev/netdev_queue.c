@@ -0,0 +1,305 @@
+/****************************************************************************
+ * net/netdev/netdev_queue.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR const struct ipv4_hdr_s *)ipbuf)
+#define IPv6BUF ((FAR const struct ipv6_hdr_s *)ipbuf)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flowhash_mix
+ *
+ * Description:
+ *   Mix the 16-bit values 'vals' into the hash 'hash'.
+ *
+ ****************************************************************************/
+
+static uint32_t flowhash_mix(uint32_t hash, FAR const uint16_t *vals,
+                             int nvals)
+{
+  while (nvals-- > 0)
+    {
+      hash ^= *vals++;
+      hash *= 0x9e3779b1;
+      hash  = (hash << 13) | (hash >> 19);
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: flowhash_final
+ *
+ * Description:
+ *   Spread the bits of the hash so that the low order bits that select the
+ *   queue depend on all of the input.
+ *
+ ****************************************************************************/
+
+static uint32_t flowhash_final(uint32_t hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_flowhash
+ *
+ * Description:
+ *   Calculate the flow hash of an IPv4 or IPv6 packet from its addresses
+ *   and, for TCP and UDP, its port numbers.  All packets of a flow have the
+ *   same hash.
+ *
+ * Input Parameters:
+ *   ipbuf - The start of the IP header
+ *   len   - The number of valid bytes at 'ipbuf'
+ *
+ * Returned Value:
+ *   The flow hash or zero if the packet is not an IP packet.
+ *
+ ****************************************************************************/
+
+uint32_t netdev_flowhash(FAR const uint8_t *ipbuf, unsigned int len)
+{
+  FAR const uint16_t *ports = NULL;
+  unsigned int hdrlen;
+  uint32_t hash = 0;
+  uint8_t proto;
+
+  if (len < 1)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ipbuf[0] & 0xf0) == 0x40)
+    {
+      if (len < IPv4_HDRLEN)
+        {
+          return 0;
+        }
+
+      hash   = flowhash_mix(hash, IPv4BUF->srcipaddr, 2);
+      hash   = flowhash_mix(hash, IPv4BUF->destipaddr, 2);
+      proto  = IPv4BUF->proto;
+      hdrlen = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+
+      /* The ports are only in the first fragment.  Keep all fragments of a
+       * packet on the same queue by not using them for fragments.
+       */
+
+      if (((IPv4BUF->ipoffset[0] & 0x3f) | IPv4BUF->ipoffset[1]) != 0)
+        {
+          proto = 0;
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ipbuf[0] & 0xf0) == 0x60)
+    {
+      if (len < IPv6_HDRLEN)
+        {
+          return 0;
+        }
+
+      hash   = flowhash_mix(hash, IPv6BUF->srcipaddr, 8);
+      hash   = flowhash_mix(hash, IPv6BUF->destipaddr, 8);
+      proto  = IPv6BUF->proto;
+      hdrlen = IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  /* The source and destination ports are the first four bytes of both the
+   * TCP and the UDP header.  Other protocols hash by address only.
+   */
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      len >= hdrlen + 4)
+    {
+      ports = (FAR const uint16_t *)&ipbuf[hdrlen];
+      hash  = flowhash_mix(hash, ports, 2);
+    }
+
+  hash = flowhash_final(hash ^ proto);
+
+  /* Zero is reserved for packets that are not IP packets */
+
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: netdev_selectqueue
+ *
+ * Description:
+ *   Select the queue of the packet in d_buf and d_len from its flow hash.
+ *
+ * Input Parameters:
+ *   dev - The network device.  d_buf and d_len describe the packet,
+ *         including the link layer header.
+ *
+ * Returned Value:
+ *   The queue index, in the range 0 to d_nqueues - 1.
+ *
+ ****************************************************************************/
+
+int netdev_selectqueue(FAR struct net_driver_s *dev)
+{
+  unsigned int hdrlen;
+
+  DEBUGASSERT(dev != NULL);
+
+  if (dev->d_nqueues <= 1)
+    {
+      return 0;
+    }
+
+  hdrlen = NET_LL_HDRLEN(dev);
+  if (dev->d_len <= hdrlen)
+    {
+      return 0;
+    }
+
+  return netdev_flowhash(&dev->d_buf[hdrlen], dev->d_len - hdrlen) %
+         dev->d_nqueues;
+}
+
+/****************************************************************************
+ * Name: netdev_setqueue
+ *
+ * Description:
+ *   Make the buffer of queue 'qid' the current packet buffer, d_buf, of the
+ *   device.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *   qid - The queue index
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'qid' is not
+ *   a valid queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_setqueue(FAR struct net_driver_s *dev, int qid)
+{
+  DEBUGASSERT(dev != NULL);
+
+  if (qid < 0 || qid >= dev->d_nqueues || dev->d_queues == NULL)
+    {
+      return -EINVAL;
+    }
+
+  dev->d_buf = dev->d_queues[qid].q_buf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_affinity
+ *
+ * Description:
+ *   Bind the interrupt of queue 'qid' to the set of CPUs 'cpuset'.
+ *
+ * Input Parameters:
+ *   dev    - The network device
+ *   qid    - The queue index
+ *   cpuset - Bit n selects CPU n.  Zero releases the binding.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int netdev_queue_affinity(FAR struct net_driver_s *dev, int qid,
+                          cpu_set_t cpuset)
+{
+  DEBUGASSERT(dev != NULL);
+
+  if (qid < 0 || qid >= dev->d_nqueues || dev->d_queues == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (dev->d_queues[qid].q_irq < 0)
+    {
+      return -ENOSYS;
+    }
+
+  return irq_set_affinity(dev->d_queues[qid].q_irq, cpuset);
+}
+#endif
+
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
@@ -114,6 +114,10 @@ uint32_t g_devset;
 uint32_t g_devfreed;
 #endif
 
+/* Protects the list of registered devices */
+
+rw_semaphore_t g_netdev_lock;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -224,6 +228,27 @@ static int get_ifindex(void)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_initialize
+ *
+ * Description:
+ *   Initialize the lock that protects the list of registered network
+ *   devices.  Called from net_initialize() before any device is
+ *   registered.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_initialize(void)
+{
+  (void)nxrwsem_init(&g_netdev_lock);
+}
+
 /****************************************************************************
  * Name: netdev_register
  *
@@ -346,11 +371,14 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       /* We need exclusive access for the following operations */
 
       net_lock();
+      netdev_list_wrlock();
 
 #ifdef CONFIG_NETDEV_IFINDEX
       ifindex = get_ifindex();
       if (ifindex < 0)
         {
+          netdev_list_wrunlock();
+          net_unlock();
           return ifindex;
         }
 
@@ -408,6 +436,7 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       dev->flink  = g_netdevices;
       g_netdevices = dev;
+      netdev_list_wrunlock();
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
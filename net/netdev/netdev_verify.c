@@ -68,7 +68,7 @@ bool netdev_verify(FAR struct net_driver_s *dev)
 
   /* Search the list of registered devices */
 
-  net_lock();
+  netdev_list_rdlock();
   for (chkdev = g_netdevices; chkdev != NULL; chkdev = chkdev->flink)
     {
       /* Is the network device that we are looking for? */
@@ -82,6 +82,6 @@ bool netdev_verify(FAR struct net_driver_s *dev)
         }
     }
 
-  net_unlock();
+  netdev_list_rdunlock();
   return valid;
 }
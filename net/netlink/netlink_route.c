@@ -127,7 +127,11 @@ struct getlink_recvfrom_response_s
   struct nlmsghdr  hdr;
   struct ifinfomsg iface;
   struct rtattr    attr;
-  uint8_t          data[IFNAMSIZ];  /* IFLA_IFNAME is the only attribute supported */
+  uint8_t          data[RTA_ALIGN(IFNAMSIZ)];  /* IFLA_IFNAME */
+#ifdef CONFIG_NETDEV_STATISTICS
+  struct rtattr    stattr;
+  struct rtnl_link_stats stats;             /* IFLA_STATS */
+#endif
 };
 
 struct getlink_recvfrom_rsplist_s
@@ -425,11 +429,33 @@ static int netlink_device_callback(FAR struct net_driver_s *dev,
   resp->iface.ifi_flags  = devinfo->req->hdr.nlmsg_flags;
   resp->iface.ifi_change = 0xffffffff;
 
-  resp->attr.rta_len     = RTA_LENGTH(strnlen(dev->d_ifname, IFNAMSIZ));
+  /* The name attribute covers the whole, NUL padded name field so that
+   * RTA_NEXT() finds the attribute that follows.
+   */
+
+  resp->attr.rta_len     = RTA_LENGTH(IFNAMSIZ);
   resp->attr.rta_type    = IFLA_IFNAME;
 
+  memset(resp->data, 0, sizeof(resp->data));
   strncpy((FAR char *)resp->data, dev->d_ifname, IFNAMSIZ);
 
+#ifdef CONFIG_NETDEV_STATISTICS
+  /* Then the device statistics.  The device is polled cheaply by
+   * repeating the RTM_GETLINK request.
+   */
+
+  resp->stattr.rta_len   = RTA_LENGTH(sizeof(struct rtnl_link_stats));
+  resp->stattr.rta_type  = IFLA_STATS;
+
+  memset(&resp->stats, 0, sizeof(struct rtnl_link_stats));
+  resp->stats.rx_packets = dev->d_statistics.rx_packets;
+  resp->stats.tx_packets = dev->d_statistics.tx_done;
+  resp->stats.rx_errors  = dev->d_statistics.rx_errors;
+  resp->stats.tx_errors  = dev->d_statistics.tx_errors;
+  resp->stats.rx_dropped = dev->d_statistics.rx_dropped;
+  resp->stats.tx_aborted_errors = dev->d_statistics.tx_timeouts;
+#endif
+
   /* REVISIT:  Another response should be provided with nlmsg_type =
    * RTM_NEWROUTE.  That response should include struct rtmsg followed by a
    * number of attributes.  This response provides routing information for
@@ -43,6 +43,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <queue.h>
 
 #ifdef CONFIG_NET_PKT
@@ -58,6 +61,10 @@
 #define pkt_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->list)
 
+/* The number of poll waiters on the packet rings of one socket */
+
+#define PKT_RING_NPOLLWAITERS 2
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -65,6 +72,23 @@
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct pollfd;           /* Forward reference */
+struct sock_filter;      /* Forward reference */
+
+#ifdef CONFIG_NET_PKT_RING
+/* One memory-mapped packet ring.  The frames are owned by the kernel or
+ * by the application as indicated by the tp_status field of the frame
+ * header.
+ */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *pr_frames;    /* The first frame of the ring */
+  uint32_t pr_frame_size;    /* The size of one frame */
+  uint32_t pr_frame_nr;      /* The number of frames */
+  uint32_t pr_head;          /* The next frame to be used by the kernel */
+};
+#endif
 
 struct pkt_conn_s
 {
@@ -84,6 +108,29 @@ struct pkt_conn_s
   uint8_t    ifindex;
   uint16_t   proto;
   uint8_t    crefs;    /* Reference counts on this instance */
+
+#ifdef CONFIG_NET_PKT_FILTER
+  /* The attached socket filter program or NULL */
+
+  FAR struct sock_filter *filter;
+  uint16_t   flen;     /* The number of instructions in the filter */
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+  /* The receive and transmit rings share one allocation that is mapped
+   * into the application with mmap().
+   */
+
+  FAR uint8_t *ringbuf;        /* The ring memory or NULL */
+  bool       mapped;           /* The ring memory has been mapped */
+  bool       losing;           /* Packets were dropped: RX ring full */
+  struct pkt_ring_s rxring;    /* The receive ring */
+  struct pkt_ring_s txring;    /* The transmit ring */
+
+  /* The poll waiters on the rings */
+
+  FAR struct pollfd *fds[PKT_RING_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -308,6 +355,186 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET protocol-level socket option
+ *   specified by the 'option' argument to the value pointed to by the
+ *   'value' argument for the socket specified by the 'psock' argument.
+ *
+ *   See <netpacket/packet.h> for the a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_SOCKOPTS) && \
+    (defined(CONFIG_NET_PKT_RING) || defined(CONFIG_NET_PKT_FILTER))
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Name: pkt_filter_attach
+ *
+ * Description:
+ *   Validate a classic BPF program and attach a copy of it to the packet
+ *   connection, replacing any filter already attached.
+ *
+ * Input Parameters:
+ *   conn  - The packet connection
+ *   fprog - The filter program or NULL to detach the current filter
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the program is not valid; -ENOMEM if
+ *   no memory is available for the copy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_FILTER
+struct sock_fprog; /* Forward reference */
+int pkt_filter_attach(FAR struct pkt_conn_s *conn,
+                      FAR const struct sock_fprog *fprog);
+#endif
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run the filter of the packet connection on a received frame.
+ *
+ * Input Parameters:
+ *   conn - The packet connection with an attached filter
+ *   buf  - The received frame
+ *   len  - The length of the received frame
+ *
+ * Returned Value:
+ *   The number of bytes of the frame to be delivered.  Zero means that the
+ *   frame is to be dropped.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_FILTER
+unsigned int pkt_filter_run(FAR struct pkt_conn_s *conn,
+                            FAR const uint8_t *buf, unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Create, resize or release (tp_frame_nr == 0) the receive or transmit
+ *   ring of a packet connection.  The ring memory can not be changed once
+ *   it has been mapped by the application.
+ *
+ * Input Parameters:
+ *   conn - The packet connection
+ *   req  - The ring geometry
+ *   tx   - true: Set up the transmit ring; false: the receive ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RING
+struct tpacket_req; /* Forward reference */
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req *req, bool tx);
+
+/****************************************************************************
+ * Name: pkt_ring_release
+ *
+ * Description:
+ *   Free the ring memory and the filter of a packet connection that is
+ *   being closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_release(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy a received frame into the next frame of the receive ring and
+ *   notify the poll waiters.  The frame is dropped if the ring is full.
+ *
+ * Input Parameters:
+ *   dev     - The device driver structure containing the received frame
+ *   conn    - The packet connection with a receive ring
+ *   snaplen - The number of bytes of the frame to be delivered
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, unsigned int snaplen);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send all frames of the transmit ring that the application has marked
+ *   with TP_STATUS_SEND_REQUEST.  This is the send(fd, NULL, 0, 0) case.
+ *
+ * Returned Value:
+ *   The total number of bytes sent; a negated errno value if no frame
+ *   could be sent.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Handle the FIOC_MMAP ioctl command.  Return the address of the ring
+ *   memory:  The receive ring followed by the transmit ring.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOTTY if the command is not FIOC_MMAP; -ENXIO
+ *   if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_ring_ioctl(FAR struct socket *psock, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Name: pkt_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the poll of a packet socket with rings.  POLLIN is
+ *   reported when a frame of the receive ring belongs to the application.
+ *   POLLOUT is reported when the next frame of the transmit ring is
+ *   available.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSYS if the socket has no ring.
+ *
+ ****************************************************************************/
+
+int pkt_ring_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup);
+#endif /* CONFIG_NET_PKT_RING */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -186,6 +186,18 @@ void pkt_free(FAR struct pkt_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+#ifdef CONFIG_NET_PKT_FILTER
+  /* Detach the socket filter */
+
+  pkt_filter_attach(conn, NULL);
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+  /* Free the memory of the packet rings */
+
+  pkt_ring_release(conn);
+#endif
+
   _pkt_semtake(&g_free_sem);
 
   /* Remove the connection from the active list */
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * net/pkt/pkt_filter.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_FILTER)
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/bpf.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_load
+ *
+ * Description:
+ *   Load a big-endian word, half word or byte from the frame.
+ *
+ * Returned Value:
+ *   true if the load is within the frame.
+ *
+ ****************************************************************************/
+
+static bool pkt_filter_load(FAR const uint8_t *buf, unsigned int len,
+                            uint32_t offset, int size, FAR uint32_t *value)
+{
+  if (offset >= len || len - offset < (unsigned int)size)
+    {
+      return false;
+    }
+
+  buf += offset;
+  switch (size)
+    {
+      case 4:
+        *value = ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+                 ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+        break;
+
+      case 2:
+        *value = ((uint32_t)buf[0] << 8) | (uint32_t)buf[1];
+        break;
+
+      default:
+        *value = buf[0];
+        break;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_size
+ *
+ * Description:
+ *   Return the size in bytes of a BPF_LD operand.
+ *
+ ****************************************************************************/
+
+static int pkt_filter_size(uint16_t code)
+{
+  switch (BPF_SIZE(code))
+    {
+      case BPF_W:
+        return 4;
+
+      case BPF_H:
+        return 2;
+
+      default:
+        return 1;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_filter_check
+ *
+ * Description:
+ *   Verify that a filter program is safe to run:  All instructions are
+ *   known, there are no divisions by a constant zero, all memory indices
+ *   and jump targets are in range, and the program ends with a return.
+ *   Since jumps only go forward, the program always terminates.
+ *
+ * Returned Value:
+ *   Zero (OK) if the program is valid; -EINVAL otherwise.
+ *
+ ****************************************************************************/
+
+static int pkt_filter_check(FAR const struct sock_filter *filter,
+                            unsigned int flen)
+{
+  FAR const struct sock_filter *insn;
+  unsigned int pc;
+
+  if (flen == 0 || flen > BPF_MAXINSNS)
+    {
+      return -EINVAL;
+    }
+
+  for (pc = 0; pc < flen; pc++)
+    {
+      insn = &filter[pc];
+
+      switch (insn->code)
+        {
+          case BPF_LD | BPF_W | BPF_ABS:
+          case BPF_LD | BPF_H | BPF_ABS:
+          case BPF_LD | BPF_B | BPF_ABS:
+          case BPF_LD | BPF_W | BPF_IND:
+          case BPF_LD | BPF_H | BPF_IND:
+          case BPF_LD | BPF_B | BPF_IND:
+          case BPF_LD | BPF_W | BPF_LEN:
+          case BPF_LD | BPF_IMM:
+          case BPF_LDX | BPF_W | BPF_LEN:
+          case BPF_LDX | BPF_B | BPF_MSH:
+          case BPF_LDX | BPF_IMM:
+          case BPF_ALU | BPF_NEG:
+          case BPF_RET | BPF_K:
+          case BPF_RET | BPF_A:
+          case BPF_MISC | BPF_TAX:
+          case BPF_MISC | BPF_TXA:
+            break;
+
+          case BPF_LD | BPF_MEM:
+          case BPF_LDX | BPF_MEM:
+          case BPF_ST:
+          case BPF_STX:
+            if (insn->k >= BPF_MEMWORDS)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_K:
+          case BPF_ALU | BPF_MOD | BPF_K:
+            if (insn->k == 0)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_K:
+          case BPF_ALU | BPF_ADD | BPF_X:
+          case BPF_ALU | BPF_SUB | BPF_K:
+          case BPF_ALU | BPF_SUB | BPF_X:
+          case BPF_ALU | BPF_MUL | BPF_K:
+          case BPF_ALU | BPF_MUL | BPF_X:
+          case BPF_ALU | BPF_DIV | BPF_X:
+          case BPF_ALU | BPF_MOD | BPF_X:
+          case BPF_ALU | BPF_OR | BPF_K:
+          case BPF_ALU | BPF_OR | BPF_X:
+          case BPF_ALU | BPF_AND | BPF_K:
+          case BPF_ALU | BPF_AND | BPF_X:
+          case BPF_ALU | BPF_XOR | BPF_K:
+          case BPF_ALU | BPF_XOR | BPF_X:
+          case BPF_ALU | BPF_LSH | BPF_K:
+          case BPF_ALU | BPF_LSH | BPF_X:
+          case BPF_ALU | BPF_RSH | BPF_K:
+          case BPF_ALU | BPF_RSH | BPF_X:
+            break;
+
+          case BPF_JMP | BPF_JA:
+            if (insn->k >= flen - pc - 1)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_K:
+          case BPF_JMP | BPF_JEQ | BPF_X:
+          case BPF_JMP | BPF_JGT | BPF_K:
+          case BPF_JMP | BPF_JGT | BPF_X:
+          case BPF_JMP | BPF_JGE | BPF_K:
+          case BPF_JMP | BPF_JGE | BPF_X:
+          case BPF_JMP | BPF_JSET | BPF_K:
+          case BPF_JMP | BPF_JSET | BPF_X:
+            if (pc + 1 + insn->jt >= flen || pc + 1 + insn->jf >= flen)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          default:
+            return -EINVAL;
+        }
+    }
+
+  /* The last instruction must be a return */
+
+  return BPF_CLASS(filter[flen - 1].code) == BPF_RET ? OK : -EINVAL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_attach
+ *
+ * Description:
+ *   Validate a classic BPF program and attach a copy of it to the packet
+ *   connection, replacing any filter already attached.
+ *
+ * Input Parameters:
+ *   conn  - The packet connection
+ *   fprog - The filter program or NULL to detach the current filter
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the program is not valid; -ENOMEM if
+ *   no memory is available for the copy.
+ *
+ ****************************************************************************/
+
+int pkt_filter_attach(FAR struct pkt_conn_s *conn,
+                      FAR const struct sock_fprog *fprog)
+{
+  FAR struct sock_filter *filter = NULL;
+  FAR struct sock_filter *old;
+  unsigned int flen = 0;
+  int ret;
+
+  if (fprog != NULL)
+    {
+      if (fprog->filter == NULL)
+        {
+          return -EINVAL;
+        }
+
+      ret = pkt_filter_check(fprog->filter, fprog->len);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Keep a private copy so that the application can not modify the
+       * validated program.
+       */
+
+      flen   = fprog->len;
+      filter = (FAR struct sock_filter *)
+        kmm_malloc(flen * sizeof(struct sock_filter));
+
+      if (filter == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memcpy(filter, fprog->filter, flen * sizeof(struct sock_filter));
+    }
+
+  /* Replace the filter with the network locked.  pkt_input() runs the
+   * filter with the network locked.
+   */
+
+  net_lock();
+  old          = conn->filter;
+  conn->filter = filter;
+  conn->flen   = flen;
+  net_unlock();
+
+  if (old != NULL)
+    {
+      kmm_free(old);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run the filter of the packet connection on a received frame.
+ *
+ * Input Parameters:
+ *   conn - The packet connection with an attached filter
+ *   buf  - The received frame
+ *   len  - The length of the received frame
+ *
+ * Returned Value:
+ *   The number of bytes of the frame to be delivered.  Zero means that the
+ *   frame is to be dropped.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+unsigned int pkt_filter_run(FAR struct pkt_conn_s *conn,
+                            FAR const uint8_t *buf, unsigned int len)
+{
+  FAR const struct sock_filter *filter = conn->filter;
+  FAR const struct sock_filter *insn;
+  uint32_t mem[BPF_MEMWORDS];
+  uint32_t a = 0;
+  uint32_t x = 0;
+  uint32_t value;
+  unsigned int pc;
+
+  DEBUGASSERT(filter != NULL);
+  memset(mem, 0, sizeof(mem));
+
+  /* pkt_filter_check() verified that every path ends with a return */
+
+  for (pc = 0; ; pc++)
+    {
+      insn = &filter[pc];
+
+      switch (insn->code)
+        {
+          case BPF_LD | BPF_W | BPF_ABS:
+          case BPF_LD | BPF_H | BPF_ABS:
+          case BPF_LD | BPF_B | BPF_ABS:
+            if (!pkt_filter_load(buf, len, insn->k,
+                                 pkt_filter_size(insn->code), &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_W | BPF_IND:
+          case BPF_LD | BPF_H | BPF_IND:
+          case BPF_LD | BPF_B | BPF_IND:
+            if (insn->k > UINT32_MAX - x ||
+                !pkt_filter_load(buf, len, x + insn->k,
+                                 pkt_filter_size(insn->code), &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_W | BPF_LEN:
+            a = len;
+            break;
+
+          case BPF_LDX | BPF_W | BPF_LEN:
+            x = len;
+            break;
+
+          case BPF_LD | BPF_IMM:
+            a = insn->k;
+            break;
+
+          case BPF_LDX | BPF_IMM:
+            x = insn->k;
+            break;
+
+          case BPF_LD | BPF_MEM:
+            a = mem[insn->k];
+            break;
+
+          case BPF_LDX | BPF_MEM:
+            x = mem[insn->k];
+            break;
+
+          case BPF_LDX | BPF_B | BPF_MSH:
+            if (!pkt_filter_load(buf, len, insn->k, 1, &value))
+              {
+                return 0;
+              }
+
+            x = (value & 0x0f) << 2;
+            break;
+
+          case BPF_ST:
+            mem[insn->k] = a;
+            break;
+
+          case BPF_STX:
+            mem[insn->k] = x;
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_K:
+            a += insn->k;
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_X:
+            a += x;
+            break;
+
+          case BPF_ALU | BPF_SUB | BPF_K:
+            a -= insn->k;
+            break;
+
+          case BPF_ALU | BPF_SUB | BPF_X:
+            a -= x;
+            break;
+
+          case BPF_ALU | BPF_MUL | BPF_K:
+            a *= insn->k;
+            break;
+
+          case BPF_ALU | BPF_MUL | BPF_X:
+            a *= x;
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_K:
+            a /= insn->k;
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_X:
+            if (x == 0)
+              {
+                return 0;
+              }
+
+            a /= x;
+            break;
+
+          case BPF_ALU | BPF_MOD | BPF_K:
+            a %= insn->k;
+            break;
+
+          case BPF_ALU | BPF_MOD | BPF_X:
+            if (x == 0)
+              {
+                return 0;
+              }
+
+            a %= x;
+            break;
+
+          case BPF_ALU | BPF_OR | BPF_K:
+            a |= insn->k;
+            break;
+
+          case BPF_ALU | BPF_OR | BPF_X:
+            a |= x;
+            break;
+
+          case BPF_ALU | BPF_AND | BPF_K:
+            a &= insn->k;
+            break;
+
+          case BPF_ALU | BPF_AND | BPF_X:
+            a &= x;
+            break;
+
+          case BPF_ALU | BPF_XOR | BPF_K:
+            a ^= insn->k;
+            break;
+
+          case BPF_ALU | BPF_XOR | BPF_X:
+            a ^= x;
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_K:
+            a = insn->k < 32 ? a << insn->k : 0;
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_X:
+            a = x < 32 ? a << x : 0;
+            break;
+
+          case BPF_ALU | BPF_RSH | BPF_K:
+            a = insn->k < 32 ? a >> insn->k : 0;
+            break;
+
+          case BPF_ALU | BPF_RSH | BPF_X:
+            a = x < 32 ? a >> x : 0;
+            break;
+
+          case BPF_ALU | BPF_NEG:
+            a = (uint32_t)-(int32_t)a;
+            break;
+
+          case BPF_JMP | BPF_JA:
+            pc += insn->k;
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_K:
+            pc += (a == insn->k) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_X:
+            pc += (a == x) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGT | BPF_K:
+            pc += (a > insn->k) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGT | BPF_X:
+            pc += (a > x) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGE | BPF_K:
+            pc += (a >= insn->k) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGE | BPF_X:
+            pc += (a >= x) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JSET | BPF_K:
+            pc += (a & insn->k) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JSET | BPF_X:
+            pc += (a & x) ? insn->jt : insn->jf;
+            break;
+
+          case BPF_MISC | BPF_TAX:
+            x = a;
+            break;
+
+          case BPF_MISC | BPF_TXA:
+            a = x;
+            break;
+
+          case BPF_RET | BPF_K:
+            return insn->k < len ? insn->k : len;
+
+          case BPF_RET | BPF_A:
+            return a < len ? a : len;
+
+          default:
+            DEBUGPANIC();
+            return 0;
+        }
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_FILTER */
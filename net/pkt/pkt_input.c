@@ -93,8 +93,35 @@ int pkt_input(struct net_driver_s *dev)
   conn = pkt_active(pbuf);
   if (conn)
     {
+      unsigned int snaplen = dev->d_len;
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_FILTER
+      /* Run the socket filter before the frame is copied anywhere */
+
+      if (conn->filter != NULL)
+        {
+          snaplen = pkt_filter_run(conn, dev->d_buf, dev->d_len);
+          if (snaplen == 0)
+            {
+              ninfo("Frame rejected by the filter\n");
+              return OK;
+            }
+        }
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+      /* With a receive ring, the frame is copied directly into the ring */
+
+      if (conn->rxring.pr_frames != NULL)
+        {
+          pkt_ring_input(dev, conn, snaplen);
+          return OK;
+        }
+#else
+      UNUSED(snaplen);
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
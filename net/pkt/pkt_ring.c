@@ -0,0 +1,618 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_RING)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The offset of the sockaddr_ll and of the packet data in a frame */
+
+#define PKT_RING_SLLOFF  TPACKET_ALIGN(sizeof(struct tpacket2_hdr))
+#define PKT_RING_RXOFF   TPACKET_ALIGN(TPACKET2_HDRLEN)
+#define PKT_RING_TXOFF   (TPACKET2_HDRLEN - sizeof(struct sockaddr_ll))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the header of a frame of the ring.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tpacket2_hdr *
+pkt_ring_frame(FAR struct pkt_ring_s *ring, uint32_t index)
+{
+  return (FAR struct tpacket2_hdr *)
+    &ring->pr_frames[(size_t)index * ring->pr_frame_size];
+}
+
+/****************************************************************************
+ * Name: pkt_ring_getstatus and pkt_ring_setstatus
+ *
+ * Description:
+ *   Read or write the status of a frame.  The status is shared with the
+ *   application and is written after, and read before, the rest of the
+ *   frame.
+ *
+ ****************************************************************************/
+
+static inline uint32_t pkt_ring_getstatus(FAR struct tpacket2_hdr *hdr)
+{
+  return *(FAR volatile uint32_t *)&hdr->tp_status;
+}
+
+static inline void pkt_ring_setstatus(FAR struct tpacket2_hdr *hdr,
+                                      uint32_t status)
+{
+  *(FAR volatile uint32_t *)&hdr->tp_status = status;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_events
+ *
+ * Description:
+ *   Return the poll events that are pending on the rings.  The application
+ *   consumes the receive frames in order so the receive ring holds data if
+ *   the most recently filled frame has not been returned to the kernel.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static pollevent_t pkt_ring_events(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring;
+  pollevent_t eventset = 0;
+  uint32_t prev;
+
+  ring = &conn->rxring;
+  if (ring->pr_frames != NULL)
+    {
+      prev = ring->pr_head > 0 ? ring->pr_head - 1 : ring->pr_frame_nr - 1;
+      if (pkt_ring_getstatus(pkt_ring_frame(ring, prev)) !=
+          TP_STATUS_KERNEL)
+        {
+          eventset |= POLLIN;
+        }
+    }
+
+  ring = &conn->txring;
+  if (ring->pr_frames != NULL &&
+      pkt_ring_getstatus(pkt_ring_frame(ring, ring->pr_head)) ==
+      TP_STATUS_AVAILABLE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollnotify
+ *
+ * Description:
+ *   Report events to the poll waiters of the rings.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_pollnotify(FAR struct pkt_conn_s *conn,
+                                pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < PKT_RING_NPOLLWAITERS; i++)
+    {
+      fds = conn->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= fds->events & eventset;
+          if (fds->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds->revents);
+              poll_notify(fds);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Create, resize or release (tp_frame_nr == 0) the receive or transmit
+ *   ring of a packet connection.  The ring memory can not be changed once
+ *   it has been mapped by the application.
+ *
+ * Input Parameters:
+ *   conn - The packet connection
+ *   req  - The ring geometry
+ *   tx   - true: Set up the transmit ring; false: the receive ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req *req, bool tx)
+{
+  FAR struct pkt_ring_s *rxring = &conn->rxring;
+  FAR struct pkt_ring_s *txring = &conn->txring;
+  FAR uint8_t *ringbuf = NULL;
+  FAR uint8_t *oldbuf;
+  uint32_t frame_size = 0;
+  uint32_t frame_nr = 0;
+  size_t rxsize;
+  size_t txsize;
+  int ret = OK;
+
+  /* Verify the geometry.  The blocks are allocated contiguously so the
+   * frames are simply frame_size apart.
+   */
+
+  if (req->tp_frame_nr > 0)
+    {
+      if (req->tp_frame_size < PKT_RING_RXOFF ||
+          (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+          req->tp_block_size < req->tp_frame_size ||
+          req->tp_block_size % req->tp_frame_size != 0 ||
+          req->tp_block_nr == 0 ||
+          req->tp_block_nr > UINT32_MAX /
+            (req->tp_block_size / req->tp_frame_size) ||
+          req->tp_block_nr * (req->tp_block_size / req->tp_frame_size) !=
+            req->tp_frame_nr ||
+          req->tp_frame_nr > SIZE_MAX / 2 / req->tp_frame_size)
+        {
+          return -EINVAL;
+        }
+
+      frame_size = req->tp_frame_size;
+      frame_nr   = req->tp_frame_nr;
+    }
+
+  /* Allocate the memory of both rings from the user heap:  The receive
+   * ring followed by the transmit ring.
+   */
+
+  net_lock();
+  if (tx)
+    {
+      rxsize = (size_t)rxring->pr_frame_nr * rxring->pr_frame_size;
+      txsize = (size_t)frame_nr * frame_size;
+    }
+  else
+    {
+      rxsize = (size_t)frame_nr * frame_size;
+      txsize = (size_t)txring->pr_frame_nr * txring->pr_frame_size;
+    }
+
+  net_unlock();
+
+  if (rxsize + txsize > 0)
+    {
+      ringbuf = (FAR uint8_t *)kumm_zalloc(rxsize + txsize);
+      if (ringbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  net_lock();
+  if (conn->mapped)
+    {
+      /* The application may still access the old memory */
+
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  if (tx)
+    {
+      txring->pr_frame_size = frame_size;
+      txring->pr_frame_nr   = frame_nr;
+    }
+  else
+    {
+      rxring->pr_frame_size = frame_size;
+      rxring->pr_frame_nr   = frame_nr;
+    }
+
+  /* Check that the other ring did not change while the network was
+   * unlocked.
+   */
+
+  if ((size_t)rxring->pr_frame_nr * rxring->pr_frame_size != rxsize ||
+      (size_t)txring->pr_frame_nr * txring->pr_frame_size != txsize)
+    {
+      ret = -EAGAIN;
+      goto errout_with_lock;
+    }
+
+  /* Install the new memory.  All frames belong to the kernel again. */
+
+  rxring->pr_frames = rxsize > 0 ? ringbuf : NULL;
+  rxring->pr_head   = 0;
+  txring->pr_frames = txsize > 0 ? ringbuf + rxsize : NULL;
+  txring->pr_head   = 0;
+  conn->losing      = false;
+
+  /* Swap the pointers so that the old memory is freed below */
+
+  oldbuf        = conn->ringbuf;
+  conn->ringbuf = ringbuf;
+  ringbuf       = oldbuf;
+
+errout_with_lock:
+  net_unlock();
+
+  if (ringbuf != NULL)
+    {
+      kumm_free(ringbuf);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_release
+ *
+ * Description:
+ *   Free the ring memory of a packet connection that is being closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_release(FAR struct pkt_conn_s *conn)
+{
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+    }
+
+  conn->ringbuf = NULL;
+  conn->mapped  = false;
+  conn->losing  = false;
+  memset(&conn->rxring, 0, sizeof(struct pkt_ring_s));
+  memset(&conn->txring, 0, sizeof(struct pkt_ring_s));
+  memset(conn->fds, 0, sizeof(conn->fds));
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy a received frame into the next frame of the receive ring and
+ *   notify the poll waiters.  The frame is dropped if the ring is full.
+ *
+ * Input Parameters:
+ *   dev     - The device driver structure containing the received frame
+ *   conn    - The packet connection with a receive ring
+ *   snaplen - The number of bytes of the frame to be delivered
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, unsigned int snaplen)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+  FAR struct tpacket2_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  uint32_t status = TP_STATUS_USER;
+
+  DEBUGASSERT(ring->pr_frames != NULL);
+
+  hdr = pkt_ring_frame(ring, ring->pr_head);
+  if (pkt_ring_getstatus(hdr) != TP_STATUS_KERNEL)
+    {
+      /* The application has not yet consumed the frame.  Drop the packet
+       * and report the loss with the next frame that is delivered.
+       */
+
+      ninfo("Receive ring full\n");
+      conn->losing = true;
+      return;
+    }
+
+  if (snaplen > ring->pr_frame_size - PKT_RING_RXOFF)
+    {
+      snaplen = ring->pr_frame_size - PKT_RING_RXOFF;
+      status |= TP_STATUS_COPY;
+    }
+
+  if (conn->losing)
+    {
+      status      |= TP_STATUS_LOSING;
+      conn->losing = false;
+    }
+
+  memcpy((FAR uint8_t *)hdr + PKT_RING_RXOFF, dev->d_buf, snaplen);
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len       = dev->d_len;
+  hdr->tp_snaplen   = snaplen;
+  hdr->tp_mac       = PKT_RING_RXOFF;
+  hdr->tp_net       = PKT_RING_RXOFF + ETH_HDRLEN;
+  hdr->tp_sec       = ts.tv_sec;
+  hdr->tp_nsec      = ts.tv_nsec;
+  hdr->tp_vlan_tci  = 0;
+  hdr->tp_vlan_tpid = 0;
+
+  sll               = (FAR struct sockaddr_ll *)
+                      ((FAR uint8_t *)hdr + PKT_RING_SLLOFF);
+  sll->sll_family   = AF_PACKET;
+  sll->sll_protocol = eth->type;
+  sll->sll_ifindex  = dev->d_ifindex;
+
+  /* Hand the frame over to the application */
+
+  pkt_ring_setstatus(hdr, status);
+
+  ring->pr_head = (ring->pr_head + 1) % ring->pr_frame_nr;
+  pkt_ring_pollnotify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send all frames of the transmit ring that the application has marked
+ *   with TP_STATUS_SEND_REQUEST.  This is the send(fd, NULL, 0, 0) case.
+ *
+ * Returned Value:
+ *   The total number of bytes sent; a negated errno value if no frame
+ *   could be sent.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR struct pkt_ring_s *ring = &conn->txring;
+  FAR struct tpacket2_hdr *hdr;
+  ssize_t total = 0;
+  ssize_t ret = OK;
+  uint32_t len;
+  uint32_t n;
+
+  /* The ring memory does not change once it has been mapped */
+
+  if (ring->pr_frames == NULL || !conn->mapped)
+    {
+      return -ENXIO;
+    }
+
+  for (n = 0; n < ring->pr_frame_nr; n++)
+    {
+      hdr = pkt_ring_frame(ring, ring->pr_head);
+      if (pkt_ring_getstatus(hdr) != TP_STATUS_SEND_REQUEST)
+        {
+          break;
+        }
+
+      pkt_ring_setstatus(hdr, TP_STATUS_SENDING);
+
+      /* Sample the length:  The application could modify it */
+
+      len = *(FAR volatile uint32_t *)&hdr->tp_len;
+      if (len == 0 || len > ring->pr_frame_size - PKT_RING_TXOFF)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = psock_pkt_send(psock, (FAR uint8_t *)hdr + PKT_RING_TXOFF,
+                               len);
+        }
+
+      pkt_ring_setstatus(hdr, ret < 0 ? TP_STATUS_WRONG_FORMAT :
+                                        TP_STATUS_AVAILABLE);
+      ring->pr_head = (ring->pr_head + 1) % ring->pr_frame_nr;
+
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to send frame: %d\n", (int)ret);
+          break;
+        }
+
+      total += ret;
+    }
+
+  net_lock();
+  pkt_ring_pollnotify(conn, POLLOUT);
+  net_unlock();
+
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_ioctl
+ *
+ * Description:
+ *   Handle the FIOC_MMAP ioctl command.  Return the address of the ring
+ *   memory:  The receive ring followed by the transmit ring.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOTTY if the command is not FIOC_MMAP; -ENXIO
+ *   if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_ring_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR void **addr = (FAR void **)((uintptr_t)arg);
+  int ret = -ENXIO;
+
+  if (cmd != FIOC_MMAP)
+    {
+      return -ENOTTY;
+    }
+
+  if (addr == NULL)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  if (conn->ringbuf != NULL)
+    {
+      *addr        = conn->ringbuf;
+      conn->mapped = true;
+      ret          = OK;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the poll of a packet socket with rings.  POLLIN is
+ *   reported when a frame of the receive ring belongs to the application.
+ *   POLLOUT is reported when the next frame of the transmit ring is
+ *   available.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSYS if the socket has no ring.
+ *
+ ****************************************************************************/
+
+int pkt_ring_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
+
+  net_lock();
+  if (setup)
+    {
+      if (conn->ringbuf == NULL)
+        {
+          ret = -ENOSYS;
+          goto errout;
+        }
+
+      for (i = 0; i < PKT_RING_NPOLLWAITERS; i++)
+        {
+          if (conn->fds[i] == NULL)
+            {
+              break;
+            }
+        }
+
+      if (i >= PKT_RING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      conn->fds[i] = fds;
+      fds->priv    = &conn->fds[i];
+
+      /* Report the events that are already pending */
+
+      eventset = pkt_ring_events(conn);
+      fds->revents |= fds->events & eventset;
+      if (fds->revents != 0)
+        {
+          poll_notify(fds);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_RING */
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * net/pkt/pkt_setsockopt.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+#include <net/bpf.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+#if defined(CONFIG_NET_SOCKOPTS) && \
+    (defined(CONFIG_NET_PKT_RING) || defined(CONFIG_NET_PKT_FILTER))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET protocol-level socket option
+ *   specified by the 'option' argument to the value pointed to by the
+ *   'value' argument for the socket specified by the 'psock' argument.
+ *
+ *   See <netpacket/packet.h> for the a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn;
+  int ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  /* All of the packet protocol options apply only to packet sockets */
+
+  if (psock->s_domain != PF_PACKET || psock->s_type != SOCK_RAW)
+    {
+      nerr("ERROR: Not a packet socket\n");
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_PKT_RING
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value == NULL || value_len != sizeof(struct tpacket_req))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = pkt_ring_setup(conn, (FAR const struct tpacket_req *)value,
+                                 option == PACKET_TX_RING);
+          }
+        break;
+
+      case PACKET_VERSION:
+        if (value == NULL || value_len != sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            /* TPACKET_V2 is the only frame format supported */
+
+            ret = *(FAR const int *)value == TPACKET_V2 ? OK : -EINVAL;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_PKT_FILTER
+      case PACKET_ATTACH_FILTER:
+        if (value == NULL || value_len != sizeof(struct sock_fprog))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = pkt_filter_attach(conn,
+                                    (FAR const struct sock_fprog *)value);
+          }
+        break;
+
+      case PACKET_DETACH_FILTER:
+        ret = conn->filter != NULL ? pkt_filter_attach(conn, NULL) :
+                                     -ENOENT;
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_SOCKOPTS && (NET_PKT_RING || NET_PKT_FILTER) */
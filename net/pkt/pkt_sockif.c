@@ -516,7 +516,13 @@ int pkt_listen(FAR struct socket *psock, int backlog)
 static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
                           bool setup)
 {
+#ifdef CONFIG_NET_PKT_RING
+  /* Only sockets with memory-mapped rings can be polled */
+
+  return pkt_ring_pollsetup(psock, fds, setup);
+#else
   return -ENOSYS;
+#endif
 }
 
 /****************************************************************************
@@ -547,6 +553,17 @@ static ssize_t pkt_send(FAR struct socket *psock, FAR const void *buf,
 
   if (psock->s_type == SOCK_RAW)
     {
+#ifdef CONFIG_NET_PKT_RING
+      /* send(fd, NULL, 0, 0) sends the frames queued in the transmit ring */
+
+      FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+      if (buf == NULL && len == 0 && conn->txring.pr_frames != NULL)
+        {
+          return pkt_ring_send(psock);
+        }
+#endif
+
       /* Raw packet send */
 
       ret = psock_pkt_send(psock, buf, len);
@@ -80,6 +80,12 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_ARP
+static int     netprocfs_arp(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_ARP */
+#ifdef CONFIG_NET_IPv6
+static int     netprocfs_neighbor(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPv6 */
 
 /****************************************************************************
  * Private Data
@@ -114,6 +120,14 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_ARP
+  , netprocfs_arp
+#endif /* CONFIG_NET_ARP */
+
+#ifdef CONFIG_NET_IPv6
+  , netprocfs_neighbor
+#endif /* CONFIG_NET_IPv6 */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -436,6 +450,43 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_addrcache
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+static int netprocfs_addrcache(FAR struct netprocfs_file_s *netfile,
+                               FAR const char *name,
+                               FAR const struct addrcache_stats_s *stats)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  %-9s  Hit %04x  Miss %04x  Evict %04x\n",
+                  name, stats->hit, stats->miss, stats->evict);
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_arp
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP
+static int netprocfs_arp(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_addrcache(netfile, "ARP", &g_netstats.arp);
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_neighbor
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static int netprocfs_neighbor(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_addrcache(netfile, "Neighbor", &g_netstats.neighbor);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
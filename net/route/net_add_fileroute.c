@@ -50,6 +50,7 @@
 
 #include "route/fileroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -98,6 +99,10 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   nwritten = net_writeroute_ipv4(&fshandle, &route);
 
+#ifdef CONFIG_ROUTE_TRIE
+  net_invalidtrie_ipv4();
+#endif
+
   (void)net_closeroute_ipv4(&fshandle);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -132,6 +137,10 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   nwritten = net_writeroute_ipv6(&fshandle, &route);
 
+#ifdef CONFIG_ROUTE_TRIE
+  net_invalidtrie_ipv6();
+#endif
+
   (void)net_closeroute_ipv6(&fshandle);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
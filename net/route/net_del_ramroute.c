@@ -49,6 +49,7 @@
 
 #include "route/ramroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -221,7 +222,16 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv4(net_match_ipv4, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+#ifdef CONFIG_ROUTE_TRIE
+  net_invalidtrie_ipv4();
+#endif
+
+  return OK;
 }
 #endif
 
@@ -238,7 +248,16 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv6(net_match_ipv6, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+#ifdef CONFIG_ROUTE_TRIE
+  net_invalidtrie_ipv6();
+#endif
+
+  return OK;
 }
 #endif
 
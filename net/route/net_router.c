@@ -49,6 +49,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -221,6 +222,18 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_TRIE
+  /* Find the longest matching prefix in the routing table trie.  Fall
+   * back to the linear search only if the trie could not be built.
+   */
+
+  ret = net_trie_ipv4(target, router);
+  if (ret != -ENOMEM)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -296,6 +309,18 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_TRIE
+  /* Find the longest matching prefix in the routing table trie.  Fall
+   * back to the linear search only if the trie could not be built.
+   */
+
+  ret = net_trie_ipv6(target, router);
+  if (ret != -ENOMEM)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
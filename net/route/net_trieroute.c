@@ -0,0 +1,651 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "route/route.h"
+#include "route/trieroute.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The trie holds at most one leaf and one branch node per route.  Node
+ * indices are 16-bit values where zero means "no node".
+ */
+
+#define TRIE_MAXROUTES   (UINT16_MAX / 2)
+#define TRIE_NODE(t,n)   (&(t)->t_nodes[(n) - 1])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of the path-compressed binary trie.  A node either ends a route
+ * (tn_route is true) or is a branch point where two prefixes diverge.  The
+ * children of a node are selected by the bit of the address that follows
+ * the node's prefix.
+ */
+
+struct trie_node_s
+{
+  uint16_t tn_child[2];          /* Child node indices (0: none) */
+  uint8_t  tn_plen;              /* Prefix length in bits */
+  bool     tn_route;             /* True: A route ends at this node */
+  uint8_t  tn_key[16];           /* Prefix in network order, masked */
+  uint8_t  tn_router[16];        /* Router address in network order */
+};
+
+/* The trie of one address family */
+
+struct route_trie_s
+{
+  FAR struct trie_node_s *t_nodes; /* Allocated node array */
+  uint16_t t_nalloc;             /* Number of allocated nodes */
+  uint16_t t_nused;              /* Number of nodes in use */
+  uint16_t t_root;               /* Index of the root node (0: empty) */
+  uint8_t  t_keylen;             /* Address size in bytes */
+  bool     t_built;              /* True: The trie has been built */
+  unsigned int t_modgen;         /* Incremented on each table change */
+  unsigned int t_buildgen;       /* Value of t_modgen when built */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct route_trie_s g_ipv4_trie =
+{
+  NULL, 0, 0, 0, sizeof(in_addr_t), false, 0, 0
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_trie_s g_ipv6_trie =
+{
+  NULL, 0, 0, 0, sizeof(net_ipv6addr_t), false, 0, 0
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return the value of bit 'n' of the network order address, counting
+ *   from the most significant bit of the first byte.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, unsigned int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'maxbits', that two network
+ *   order addresses have in common.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                                unsigned int maxbits)
+{
+  unsigned int nbits = 0;
+  uint8_t diff;
+
+  while (nbits < maxbits)
+    {
+      diff = a[nbits >> 3] ^ b[nbits >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+
+      nbits += 8;
+    }
+
+  return nbits < maxbits ? nbits : maxbits;
+}
+
+/****************************************************************************
+ * Name: trie_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a network order netmask, i.e., its number
+ *   of leading one bits.  Non-contiguous netmasks are truncated at the
+ *   first zero bit.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_prefixlen(FAR const uint8_t *netmask,
+                                   unsigned int keylen)
+{
+  unsigned int nbits = 0;
+  unsigned int i;
+  uint8_t mask;
+
+  for (i = 0; i < keylen && netmask[i] == 0xff; i++)
+    {
+      nbits += 8;
+    }
+
+  if (i < keylen)
+    {
+      for (mask = netmask[i]; (mask & 0x80) != 0; mask <<= 1)
+        {
+          nbits++;
+        }
+    }
+
+  return nbits;
+}
+
+/****************************************************************************
+ * Name: trie_newnode
+ *
+ * Description:
+ *   Take the next free node and initialize it with the prefix of 'key' of
+ *   length 'plen'.  If 'router' is NULL, the node is a pure branch node.
+ *
+ ****************************************************************************/
+
+static uint16_t trie_newnode(FAR struct route_trie_s *trie,
+                             FAR const uint8_t *key, unsigned int plen,
+                             FAR const uint8_t *router)
+{
+  FAR struct trie_node_s *node;
+  unsigned int nbytes;
+
+  if (trie->t_nused >= trie->t_nalloc)
+    {
+      return 0;
+    }
+
+  node = &trie->t_nodes[trie->t_nused++];
+  memset(node, 0, sizeof(struct trie_node_s));
+
+  /* Keep only the leading 'plen' bits of the key */
+
+  nbytes = (plen + 7) >> 3;
+  memcpy(node->tn_key, key, nbytes);
+  if ((plen & 7) != 0)
+    {
+      node->tn_key[nbytes - 1] &= (uint8_t)(0xff << (8 - (plen & 7)));
+    }
+
+  node->tn_plen = plen;
+  if (router != NULL)
+    {
+      node->tn_route = true;
+      memcpy(node->tn_router, router, trie->t_keylen);
+    }
+
+  return trie->t_nused;
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Add one route to the trie.  If the same prefix is added more than once,
+ *   the first route is kept, as with the linear routing table search.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct route_trie_s *trie,
+                       FAR const uint8_t *key, unsigned int plen,
+                       FAR const uint8_t *router)
+{
+  FAR struct trie_node_s *node;
+  FAR uint16_t *link = &trie->t_root;
+  unsigned int common;
+  uint16_t branch;
+  uint16_t leaf;
+  uint16_t ndx;
+
+  for (; ; )
+    {
+      ndx = *link;
+      if (ndx == 0)
+        {
+          /* Empty link: The route becomes a new leaf */
+
+          ndx = trie_newnode(trie, key, plen, router);
+          if (ndx == 0)
+            {
+              return -ENOMEM;
+            }
+
+          *link = ndx;
+          return OK;
+        }
+
+      node   = TRIE_NODE(trie, ndx);
+      common = trie_common(node->tn_key, key,
+                           plen < node->tn_plen ? plen : node->tn_plen);
+
+      if (common == node->tn_plen)
+        {
+          if (plen == node->tn_plen)
+            {
+              /* Same prefix.  This may turn a branch into a route. */
+
+              if (!node->tn_route)
+                {
+                  node->tn_route = true;
+                  memcpy(node->tn_router, router, trie->t_keylen);
+                }
+
+              return OK;
+            }
+
+          /* The node's prefix covers the route.  Descend. */
+
+          link = &node->tn_child[trie_bit(key, node->tn_plen)];
+          continue;
+        }
+
+      if (common == plen)
+        {
+          /* The route covers the node's prefix.  Insert it above the node. */
+
+          leaf = trie_newnode(trie, key, plen, router);
+          if (leaf == 0)
+            {
+              return -ENOMEM;
+            }
+
+          TRIE_NODE(trie, leaf)->tn_child[trie_bit(node->tn_key, plen)] = ndx;
+          *link = leaf;
+          return OK;
+        }
+
+      /* The prefixes diverge.  Add a branch node where they do. */
+
+      branch = trie_newnode(trie, key, common, NULL);
+      leaf   = trie_newnode(trie, key, plen, router);
+      if (branch == 0 || leaf == 0)
+        {
+          return -ENOMEM;
+        }
+
+      node = TRIE_NODE(trie, ndx);
+      TRIE_NODE(trie, branch)->tn_child[trie_bit(node->tn_key, common)] = ndx;
+      TRIE_NODE(trie, branch)->tn_child[trie_bit(key, common)] = leaf;
+      *link = branch;
+      return OK;
+    }
+}
+
+/****************************************************************************
+ * Name: trie_lookup
+ *
+ * Description:
+ *   Return the route node with the longest prefix that matches 'key' or
+ *   NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_lookup(FAR struct route_trie_s *trie,
+                                           FAR const uint8_t *key)
+{
+  FAR struct trie_node_s *best = NULL;
+  FAR struct trie_node_s *node;
+  unsigned int maxbits = trie->t_keylen << 3;
+  uint16_t ndx = trie->t_root;
+
+  while (ndx != 0)
+    {
+      node = TRIE_NODE(trie, ndx);
+      if (trie_common(node->tn_key, key, node->tn_plen) < node->tn_plen)
+        {
+          break;
+        }
+
+      if (node->tn_route)
+        {
+          best = node;
+        }
+
+      if (node->tn_plen >= maxbits)
+        {
+          break;
+        }
+
+      ndx = node->tn_child[trie_bit(key, node->tn_plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: trie_reset
+ *
+ * Description:
+ *   Empty the trie and make sure that there are enough nodes for 'nroutes'
+ *   routes.
+ *
+ ****************************************************************************/
+
+static int trie_reset(FAR struct route_trie_s *trie, unsigned int nroutes)
+{
+  unsigned int nneeded;
+
+  trie->t_built = false;
+  trie->t_nused = 0;
+  trie->t_root  = 0;
+
+  if (nroutes > TRIE_MAXROUTES)
+    {
+      return -ENOMEM;
+    }
+
+  nneeded = nroutes << 1;
+  if (nneeded > trie->t_nalloc)
+    {
+      if (trie->t_nodes != NULL)
+        {
+          kmm_free(trie->t_nodes);
+        }
+
+      trie->t_nodes  = (FAR struct trie_node_s *)
+        kmm_malloc(nneeded * sizeof(struct trie_node_s));
+      trie->t_nalloc = trie->t_nodes != NULL ? nneeded : 0;
+      if (trie->t_nodes == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_count
+ *
+ * Description:
+ *   Count the routes in the routing table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int trie_count_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  (*(FAR unsigned int *)arg)++;
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int trie_count_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  (*(FAR unsigned int *)arg)++;
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: trie_add_ipv4 and trie_add_ipv6
+ *
+ * Description:
+ *   Add one route of the routing table to the trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int trie_add_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  FAR struct route_trie_s *trie = (FAR struct route_trie_s *)arg;
+  FAR const uint8_t *netmask = (FAR const uint8_t *)&route->netmask;
+
+  return trie_insert(trie, (FAR const uint8_t *)&route->target,
+                     trie_prefixlen(netmask, sizeof(in_addr_t)),
+                     (FAR const uint8_t *)&route->router);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int trie_add_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  FAR struct route_trie_s *trie = (FAR struct route_trie_s *)arg;
+  FAR const uint8_t *netmask = (FAR const uint8_t *)route->netmask;
+
+  return trie_insert(trie, (FAR const uint8_t *)route->target,
+                     trie_prefixlen(netmask, sizeof(net_ipv6addr_t)),
+                     (FAR const uint8_t *)route->router);
+}
+#endif
+
+/****************************************************************************
+ * Name: trie_build_ipv4 and trie_build_ipv6
+ *
+ * Description:
+ *   (Re-)build the trie from the routing table if the table has changed
+ *   since the trie was last built.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int trie_build_ipv4(void)
+{
+  FAR struct route_trie_s *trie = &g_ipv4_trie;
+  unsigned int modgen = trie->t_modgen;
+  unsigned int nroutes = 0;
+  int ret;
+
+  if (trie->t_built && trie->t_buildgen == modgen)
+    {
+      return OK;
+    }
+
+  (void)net_foreachroute_ipv4(trie_count_ipv4, &nroutes);
+  ret = trie_reset(trie, nroutes);
+  if (ret >= 0)
+    {
+      ret = net_foreachroute_ipv4(trie_add_ipv4, trie);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  trie->t_buildgen = modgen;
+  trie->t_built    = true;
+  return OK;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int trie_build_ipv6(void)
+{
+  FAR struct route_trie_s *trie = &g_ipv6_trie;
+  unsigned int modgen = trie->t_modgen;
+  unsigned int nroutes = 0;
+  int ret;
+
+  if (trie->t_built && trie->t_buildgen == modgen)
+    {
+      return OK;
+    }
+
+  (void)net_foreachroute_ipv6(trie_count_ipv6, &nroutes);
+  ret = trie_reset(trie, nroutes);
+  if (ret >= 0)
+    {
+      ret = net_foreachroute_ipv6(trie_add_ipv6, trie);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  trie->t_buildgen = modgen;
+  trie->t_built    = true;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_invalidtrie_ipv4 and net_invalidtrie_ipv6
+ *
+ * Description:
+ *   Mark the routing table trie as stale.  This must be called whenever a
+ *   route is added to or removed from the routing table.  The trie is
+ *   rebuilt from the routing table on the next lookup.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_invalidtrie_ipv4(void)
+{
+  g_ipv4_trie.t_modgen++;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_invalidtrie_ipv6(void)
+{
+  g_ipv6_trie.t_modgen++;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_trie_ipv4 and net_trie_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches the target address
+ *   and return its router address.  The lookup time depends only on the
+ *   address width, not on the number of routes.
+ *
+ * Input Parameters:
+ *   target - An address on a remote network to use in the lookup.
+ *   router - The location to return the router address.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no matching route.  -ENOMEM is
+ *   returned if the trie could not be built.  In that case, the caller
+ *   should fall back to a linear search of the routing table.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_trie_ipv4(in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct trie_node_s *node;
+  int ret;
+
+  ret = trie_build_ipv4();
+  if (ret < 0)
+    {
+      return -ENOMEM;
+    }
+
+  node = trie_lookup(&g_ipv4_trie, (FAR const uint8_t *)&target);
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(router, node->tn_router, sizeof(in_addr_t));
+  return OK;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_trie_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router)
+{
+  FAR struct trie_node_s *node;
+  int ret;
+
+  ret = trie_build_ipv6();
+  if (ret < 0)
+    {
+      return -ENOMEM;
+    }
+
+  node = trie_lookup(&g_ipv6_trie, (FAR const uint8_t *)target);
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(router, node->tn_router, sizeof(net_ipv6addr_t));
+  return OK;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
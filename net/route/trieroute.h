@@ -0,0 +1,108 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H 1
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_invalidtrie_ipv4 and net_invalidtrie_ipv6
+ *
+ * Description:
+ *   Mark the routing table trie as stale.  This must be called whenever a
+ *   route is added to or removed from the routing table.  The trie is
+ *   rebuilt from the routing table on the next lookup.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_invalidtrie_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_invalidtrie_ipv6(void);
+#endif
+
+/****************************************************************************
+ * Name: net_trie_ipv4 and net_trie_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches the target address
+ *   and return its router address.  The lookup time depends only on the
+ *   address width, not on the number of routes.
+ *
+ * Input Parameters:
+ *   target - An address on a remote network to use in the lookup.
+ *   router - The location to return the router address.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no matching route.  -ENOMEM is
+ *   returned if the trie could not be built.  In that case, the caller
+ *   should fall back to a linear search of the routing table.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_trie_ipv4(in_addr_t target, FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_trie_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router);
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
@@ -708,23 +708,16 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
       /* Submit all of the fragments to the MAC.  We send all frames back-
        * to-back like this to minimize any possible condition where some
        * frame which is not a fragment from this sequence from intervening.
+       * The whole list is handed to the radio in a single request so that
+       * the driver can queue the frames in one pass; the driver takes
+       * ownership of every IOB in the list, even on failure.
        */
 
-      for (iob = qhead; iob != NULL; iob = qhead)
+      ninfo("Submitting frame list\n");
+      ret = sixlowpan_frame_submit(radio, &meta, qhead);
+      if (ret < 0)
         {
-          /* Remove the IOB containing the frame from the list */
-
-          qhead         = iob->io_flink;
-          iob->io_flink = NULL;
-
-          /* And submit the frame to the MAC */
-
-          ninfo("Submitting frame\n");
-          ret = sixlowpan_frame_submit(radio, &meta, iob);
-          if (ret < 0)
-            {
-              nerr("ERROR: sixlowpan_frame_submit() failed: %d\n", ret);
-            }
+          nerr("ERROR: sixlowpan_frame_submit() failed: %d\n", ret);
         }
 
       /* Update the datagram TAG value */
@@ -282,7 +282,8 @@ int sixlowpan_frame_hdrlen(FAR struct radio_driver_s *radio,
  * Input Parameters:
  *   radio - A reference to a radio network device instance.
  *   meta  - Meta data that describes the MAC header
- *   frame - The IOB containing the frame to be submitted.
+ *   frame - The IOB containing the frame to be submitted.  This may be
+ *           the head of a list of frames linked through io_flink.
  *
  * Returned Value:
  *   Zero (OK) is returned on success; otherwise, a negated errno value is
@@ -60,6 +60,14 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Active reassembly buffers are kept in a small hash table indexed by the
+ * reassembly tag and the last byte of the fragment source address so that
+ * a fragment lookup need not visit every reassembly in progress.  The
+ * number of buckets must be a power of two.
+ */
+
+#define NET_6LOWPAN_NREASSHASH 8
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -71,9 +79,10 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* These are the hashed lists of active, allocated reassemby buffers */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reassbuf_s *
+  g_active_reass[NET_6LOWPAN_NREASSHASH];
 
 /* Pool of pre-allocated reassembly buffer stuctures */
 
@@ -115,14 +124,34 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
   return false;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the index of the hash bucket that holds the reassembly with this
+ *   reassembly tag and fragment source address.
+ *
+ ****************************************************************************/
+
+static int sixlowpan_reass_hash(uint16_t reasstag,
+                                FAR const struct netdev_varaddr_s *fragsrc)
+{
+  if (fragsrc->nv_addrlen > 0)
+    {
+      reasstag ^= fragsrc->nv_addr[fragsrc->nv_addrlen - 1];
+    }
+
+  return reasstag & (NET_6LOWPAN_NREASSHASH - 1);
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_expire
  *
  * Description:
- *   Free all expired or inactive reassembly buffers.
+ *   Free all expired or inactive reassembly buffers in one hash bucket.
  *
  * Input Parameters:
- *   None
+ *   ndx - The index of the hash bucket
  *
  * Returned Value:
  *   None
@@ -132,7 +161,7 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  *
  ****************************************************************************/
 
-static void sixlowpan_reass_expire(void)
+static void sixlowpan_reass_expire(int ndx)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
@@ -140,7 +169,7 @@ static void sixlowpan_reass_expire(void)
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (reass = g_active_reass[ndx]; reass != NULL; reass = next)
     {
       /* Needed if 'reass' is freed */
 
@@ -190,12 +219,23 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
+  /* Buffers provided by the driver are never in the active list */
+
+  if (reass->rb_pool == REASS_POOL_RADIO)
+    {
+      return;
+    }
+
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = &g_active_reass[sixlowpan_reass_hash(reass->rb_reasstag,
+                                              &reass->rb_fragsrc)];
+
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -209,7 +249,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -296,12 +336,16 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
+  int ndx;
 
   /* First, removed any expired or inactive reassembly buffers.  This might
    * free up a pre-allocated buffer for this allocation.
    */
 
-  sixlowpan_reass_expire();
+  for (ndx = 0; ndx < NET_6LOWPAN_NREASSHASH; ndx++)
+    {
+      sixlowpan_reass_expire(ndx);
+    }
 
   /* Now, try the free list first */
 
@@ -341,8 +385,9 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      ndx                 = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink     = g_active_reass[ndx];
+      g_active_reass[ndx] = reass;
     }
 
   return reass;
@@ -372,18 +417,21 @@ FAR struct sixlowpan_reassbuf_s *
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  int ndx;
 
   /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+   * to return old reassembly buffer with the same tag).  Only the hash
+   * bucket that could hold the match needs to be visited.
    */
 
-  sixlowpan_reass_expire();
+  ndx = sixlowpan_reass_hash(reasstag, fragsrc);
+  sixlowpan_reass_expire(ndx);
 
   /* Now search for the matching reassembly buffer in the remainng, active
    * reassembly buffers.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_active_reass[ndx]; reass != NULL; reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
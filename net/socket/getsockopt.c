@@ -50,6 +50,7 @@
 
 #include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "udp/udp.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -57,6 +58,85 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: psock_get_bufsize
+ *
+ * Description:
+ *   Return the SO_SNDBUF or SO_RCVBUF limit of a TCP or UDP socket.
+ *
+ * Input Parameters:
+ *   psock  Socket structure of the socket to query
+ *   option SO_SNDBUF or SO_RCVBUF
+ *   size   The location to return the limit in bytes.  Zero means that
+ *          there is no limit.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success; -ENOPROTOOPT if the socket does not
+ *   support the limit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKBUF
+static int psock_get_bufsize(FAR struct socket *psock, int option,
+                             FAR int *size)
+{
+  int ret = -ENOPROTOOPT;
+
+  if (psock->s_domain != PF_INET && psock->s_domain != PF_INET6)
+    {
+      return ret;
+    }
+
+#ifdef NET_TCP_HAVE_STACK
+  if (psock->s_type == SOCK_STREAM)
+    {
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          *size = (int)conn->sndbufs;
+          ret   = OK;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          *size = (int)conn->rcvbufs;
+          ret   = OK;
+        }
+#endif
+    }
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          *size = (int)conn->sndbufs;
+          ret   = OK;
+        }
+#endif
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          *size = (int)conn->rcvbufs;
+          ret   = OK;
+        }
+#endif
+    }
+#endif
+
+  return ret;
+}
+#endif /* CONFIG_NET_SOCKBUF */
+
 /****************************************************************************
  * Name: psock_socketlevel_option
  *
@@ -261,14 +341,38 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_SOCKBUF
+      case SO_RCVBUF:     /* Gets receive buffer size */
+      case SO_SNDBUF:     /* Gets send buffer size */
+        {
+          int ret;
+
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          ret = psock_get_bufsize(psock, option, (FAR int *)value);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          *value_len = sizeof(int);
+        }
+        break;
+#endif
+
       /* The following are not yet implemented (return values other than {0,1) */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
       case SO_ERROR:      /* Reports and clears error status. */
       case SO_LINGER:     /* Lingers on a close() if data is present */
+#ifndef CONFIG_NET_SOCKBUF
       case SO_RCVBUF:     /* Sets receive buffer size */
-      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       default:
@@ -1,7 +1,7 @@
 /****************************************************************************
  * net/socket/net_close.c
  *
- *   Copyright (C) 2007-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -85,6 +86,17 @@ int psock_close(FAR struct socket *psock)
       return -EBADF;
     }
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Drop the poll registrations cached for the socket with the last
+   * reference.
+   */
+
+  if (psock->s_crefs <= 1)
+    {
+      poll_cache_close(psock);
+    }
+
+#endif
   /* We perform the close operation only if this is the last count on
    * the socket. (actually, I think the socket crefs only takes the values
    * 0 and 1 right now).
@@ -0,0 +1,198 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' datagrams into 'msgvec' with the network locked
+ *   once for the whole batch.  Each message must have exactly one I/O
+ *   vector.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The messages to receive
+ *   vlen    - The number of messages in 'msgvec'
+ *   flags   - Receive flags.  With MSG_WAITFORONE, only the first message
+ *             is waited for.
+ *   timeout - The maximum time spent collecting messages, or NULL.  As on
+ *             other systems, this is only checked after each message.
+ *
+ * Returned Value:
+ *   The number of messages received (and msg_len of each set) is returned
+ *   on success; a negated errno value is returned if no message was
+ *   received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout)
+{
+  FAR struct msghdr *msg;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  unsigned int nrecvd;
+  socklen_t fromlen;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (timeout != NULL)
+    {
+      start = clock_systimer();
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+    }
+
+  /* The network lock is recursive:  Holding it here makes the lock in each
+   * psock_recvfrom() call cheap.  It is still released while waiting for a
+   * datagram.
+   */
+
+  net_lock();
+  for (nrecvd = 0; nrecvd < vlen; nrecvd++)
+    {
+      msg = &msgvec[nrecvd].msg_hdr;
+      if (msg->msg_iovlen != 1)
+        {
+          ret = -ENOTSUP;
+          break;
+        }
+
+      fromlen = msg->msg_namelen;
+      ret = psock_recvfrom(psock, msg->msg_iov->iov_base,
+                           msg->msg_iov->iov_len, flags & ~MSG_WAITFORONE,
+                           (FAR struct sockaddr *)msg->msg_name,
+                           msg->msg_name != NULL ? &fromlen : NULL);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msg->msg_namelen       = fromlen;
+      msg->msg_flags         = 0;
+      msgvec[nrecvd].msg_len = ret;
+
+      /* Do not wait for the remaining messages after the first one */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          nrecvd++;
+          break;
+        }
+    }
+
+  net_unlock();
+  return nrecvd > 0 ? (int)nrecvd : (int)ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   Receive several datagrams with one call.  See psock_recvmmsg().
+ *
+ * Input Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - The messages to receive
+ *   vlen    - The number of messages in 'msgvec'
+ *   flags   - Receive flags
+ *   timeout - The maximum time spent collecting messages, or NULL
+ *
+ * Returned Value:
+ *   The number of messages received is returned on success.  On error, -1
+ *   is returned and errno is set appropriately (see recvfrom()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_recvmmsg do all of the work */
+
+  ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -89,10 +89,12 @@ ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
 {
   ssize_t ret;
 
-  /* Verify that non-NULL pointers were passed */
+  /* Verify that non-NULL pointers were passed.  A zero-length send may pass
+   * a NULL buffer (see the transmit ring of packet sockets).
+   */
 
 #ifdef CONFIG_DEBUG_FEATURES
-  if (buf == NULL)
+  if (buf == NULL && len > 0)
     {
       return -EINVAL;
     }
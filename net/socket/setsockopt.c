@@ -55,9 +55,99 @@
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 #include "udp/udp.h"
+#include "pkt/pkt.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_set_bufsize
+ *
+ * Description:
+ *   Set the SO_SNDBUF or SO_RCVBUF limit of a TCP or UDP socket.
+ *
+ * Input Parameters:
+ *   psock  Socket structure of socket to operate on
+ *   option SO_SNDBUF or SO_RCVBUF
+ *   size   The new limit in bytes.  Zero removes the limit.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success; -ENOPROTOOPT if the socket does not
+ *   support the limit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKBUF
+static int psock_set_bufsize(FAR struct socket *psock, int option,
+                             uint32_t size)
+{
+  int ret = -ENOPROTOOPT;
+
+  if (psock->s_domain != PF_INET && psock->s_domain != PF_INET6)
+    {
+      return ret;
+    }
+
+  net_lock();
+
+#ifdef NET_TCP_HAVE_STACK
+  if (psock->s_type == SOCK_STREAM)
+    {
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          /* A larger limit may let waiting senders continue */
+
+          conn->sndbufs = size;
+          tcp_sendbuffer_notify(conn);
+          ret = OK;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          conn->rcvbufs = size;
+          ret = OK;
+        }
+#endif
+    }
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          conn->sndbufs = size;
+          udp_sendbuffer_notify(conn);
+          ret = OK;
+        }
+#endif
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          conn->rcvbufs = size;
+          ret = OK;
+        }
+#endif
+    }
+#endif
+
+  net_unlock();
+  return ret;
+}
+#endif /* CONFIG_NET_SOCKBUF */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -283,11 +373,35 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 #endif
+
+#ifdef CONFIG_NET_SOCKBUF
+      case SO_RCVBUF:     /* Sets receive buffer size */
+      case SO_SNDBUF:     /* Sets send buffer size */
+        {
+          int size;
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          size = *(FAR int *)value;
+          if (size < 0)
+            {
+              return -EINVAL;
+            }
+
+          return psock_set_bufsize(psock, option, (uint32_t)size);
+        }
+#endif
+
       /* The following are not yet implemented */
 
+#ifndef CONFIG_NET_SOCKBUF
       case SO_RCVBUF:     /* Sets receive buffer size */
-      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       /* There options are only valid when used with getopt */
@@ -400,6 +514,12 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#if defined(CONFIG_NET_PKT_RING) || defined(CONFIG_NET_PKT_FILTER)
+      case SOL_PACKET: /* Packet socket options (see include/netpacket/packet.h) */
+        ret = pkt_setsockopt(psock, option, value, value_len);
+        break;
+#endif
+
       default:         /* The provided level is invalid */
         ret = -EINVAL;
         break;
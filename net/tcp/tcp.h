@@ -44,12 +44,14 @@
 
 #include <sys/types.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 
-#ifdef CONFIG_TCP_NOTIFIER
+#if defined(CONFIG_TCP_NOTIFIER) || defined(CONFIG_NET_TCP_DELAYED_ACK) || \
+    defined(CONFIG_NET_TCP_CONNTIMER)
 #  include <nuttx/wqueue.h>
 #endif
 
@@ -61,6 +63,22 @@
 
 #define NET_TCP_HAVE_STACK 1
 
+/* Number of buckets in the connection and listener hash tables.  Zero
+ * means that the lists are searched linearly.
+ */
+
+#ifndef CONFIG_NET_TCP_HASHSIZE
+#  define CONFIG_NET_TCP_HASHSIZE 0
+#endif
+
+/* Hash a local port number.  The port number is in network order. */
+
+#define TCP_PORT_HASH(p) (((p) ^ ((p) >> 8)) % CONFIG_NET_TCP_HASHSIZE)
+
+/* The number of SACKed ranges that are remembered per connection */
+
+#define TCP_SACK_NRANGES 4
+
 /* Conditions for support TCP poll/select operations */
 
 #ifdef CONFIG_NET_TCP_READAHEAD
@@ -123,6 +141,44 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_conn_s;        /* Forward reference */
+
+/* A congestion control algorithm.  The common logic in tcp_cc.c does slow
+ * start, fast retransmit and fast recovery (RFC 5681 and RFC 6582).  The
+ * algorithm decides how the window is reduced on a loss and how it grows
+ * in congestion avoidance.
+ */
+
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* Name used with the TCP_CONGESTION option */
+
+  /* Initialize the algorithm specific state of the connection (optional) */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Return the new slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* Grow the congestion window when 'acked' bytes have been ACKed in the
+   * congestion avoidance phase.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+/* A range of sequence numbers that the peer has selectively acknowledged */
+
+struct tcp_sack_s
+{
+  uint32_t left;          /* The first sequence number of the range */
+  uint32_t right;         /* The sequence number after the range */
+};
+#endif
 
 struct tcp_conn_s
 {
@@ -130,6 +186,15 @@ struct tcp_conn_s
 
   dq_entry_t node;        /* Implements a doubly linked list */
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  /* Supports the singly linked hash table chains.  An active connection
+   * is hashed by its ports and remote address; a listening connection,
+   * which is never active, is hashed by its local port.
+   */
+
+  FAR struct tcp_conn_s *hnext;
+#endif
+
   /* TCP callbacks:
    *
    * Data transfer events are retained in 'list'.  Event handlers in 'list'
@@ -179,7 +244,14 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+  uint8_t  snd_wscale;    /* Shift count of the windows sent by the peer */
+  uint8_t  rcv_wscale;    /* Shift count of the windows that we send */
+  bool     wscale;        /* The peer sent the window scale option */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -193,6 +265,14 @@ struct tcp_conn_s
 
   FAR struct net_driver_s *dev;
 
+  /* Connections that may have something to send are kept in a list that is
+   * visited when a device polls for TX data, see tcp_txready().
+   */
+
+  FAR struct tcp_conn_s *txflink; /* Next connection in the TX ready list */
+  FAR struct tcp_conn_s *txblink; /* Previous connection in the list */
+  bool txready;                   /* True: In the TX ready list */
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Read-ahead buffering.
    *
@@ -201,6 +281,11 @@ struct tcp_conn_s
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_SOCKBUF
+  uint32_t   rcvbufs;     /* SO_RCVBUF limit of the read-ahead data (bytes).
+                           * Zero:  No limit */
+  bool       rcvwndupdate; /* True: Send a window update with the next poll */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -220,6 +305,74 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_SOCKBUF
+  uint32_t   sndbufs;     /* SO_SNDBUF limit of the write buffers (bytes).
+                           * Zero:  No limit */
+  sem_t      sndsem;      /* Senders waiting for room in the write buffers */
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control
+   *
+   *   cc        - The congestion control algorithm.  NULL selects the
+   *               default algorithm.
+   *   cwnd      - The congestion window (bytes)
+   *   ssthresh  - The slow start threshold (bytes)
+   *   lastack   - The highest cumulative ACK received
+   *   recover   - The highest sequence number sent when fast recovery
+   *               was entered
+   *   dupacks   - The number of consecutive duplicate ACKs
+   *   recovery  - True while in fast recovery
+   *   ccrexmit  - The first un-ACKed segment must be retransmitted
+   */
+
+  FAR const struct tcp_cc_ops_s *cc;
+  uint32_t   cwnd;
+  uint32_t   ssthresh;
+  uint32_t   lastack;
+  uint32_t   recover;
+  uint8_t    dupacks;
+  bool       recovery;
+  bool       ccrexmit;
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  /* CUBIC state (RFC 8312)
+   *
+   *   cubic_wmax   - The window just before the last reduction (bytes)
+   *   cubic_origin - The window at the plateau of the cubic function
+   *   cubic_west   - The window of an equivalent Reno flow (bytes)
+   *   cubic_k      - The time to reach cubic_origin (msec)
+   *   cubic_epoch  - The start of the current congestion avoidance epoch.
+   *                  Zero if no epoch has been started.
+   */
+
+  uint32_t   cubic_wmax;
+  uint32_t   cubic_origin;
+  uint32_t   cubic_west;
+  uint32_t   cubic_k;
+  clock_t    cubic_epoch;
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Selective acknowledgement (RFC 2018, RFC 6675)
+   *
+   *   sack     - True if both sides sent the SACK-permitted option
+   *   nsack    - The number of valid entries in sackblk[]
+   *   sackblk  - The scoreboard:  Disjoint SACKed ranges above the
+   *              cumulative ACK, in sequence number order
+   *   sackhigh - The highest sequence number SACKed since the last
+   *              cumulative ACK
+   *   rxthigh  - The highest sequence number retransmitted in the current
+   *              fast recovery
+   */
+
+  bool       sack;
+  uint8_t    nsack;
+  struct tcp_sack_s sackblk[TCP_SACK_NRANGES];
+  uint32_t   sackhigh;
+  uint32_t   rxthigh;
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -252,6 +405,57 @@ struct tcp_conn_s
   uint8_t    keepretries; /* Number of retries attempted */
 #endif
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Delayed ACKs (RFC 1122)
+   *
+   *   ackwork    - Polls the device when a delayed ACK is due
+   *   acktime    - The time when the un-ACKed data was received
+   *   ackdelayed - True if received data has not been ACKed yet
+   *   quickack   - True if every segment is ACKed at once (TCP_QUICKACK)
+   */
+
+  struct work_s ackwork;
+  clock_t    acktime;
+  bool       ackdelayed;
+  bool       quickack;
+#endif
+
+#ifdef CONFIG_NET_TCP_INFO
+  /* Per-connection statistics returned by the TCP_INFO socket option
+   *
+   *   segsin    - The number of segments received
+   *   segsout   - The number of segments sent
+   *   rexmits   - The number of retransmitted segments
+   *   bytesrcvd - The number of in-sequence bytes received
+   *   bytesackd - The number of sent bytes ACKed by the peer
+   */
+
+  uint32_t   segsin;
+  uint32_t   segsout;
+  uint32_t   rexmits;
+  uint32_t   bytesrcvd;
+  uint32_t   bytesackd;
+#endif
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+  /* Per-connection timer
+   *
+   *   timerwork     - Polls the device when the timer of the connection
+   *                   expires
+   *   timerbase     - The time when 'timer' was last brought up to date
+   *   timerdeadline - The time when timerwork is due
+   *   timerdue      - True if timerwork has expired, but tcp_timer() has
+   *                   not run yet
+   *   timerrun      - True if the retransmission timer is running
+   */
+
+  struct work_s timerwork;
+  clock_t    timerbase;
+  clock_t    timerdeadline;
+  bool       timerdue;
+  bool       timerrun;
+#endif
+
   /* connevents is a list of callbacks for each socket the uses this
    * connection (there can be more that one in the event that the the socket
    * was dup'ed).  It is used with the network monitor to handle
@@ -319,6 +523,15 @@ extern "C"
 #  define EXTERN extern
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+/* The congestion control algorithms */
+
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#endif
+
 /* List of registered Ethernet device drivers.  You must have the network
  * locked in order to access this list.
  *
@@ -763,6 +976,71 @@ void tcp_nextsequence(void);
 
 void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_txready
+ *
+ * Description:
+ *   Add the connection to the list of connections that are polled when a
+ *   device polls for TX data.  This must be called along with the TX
+ *   notification whenever the connection has something to send outside of
+ *   the input processing.
+ *
+ *   A connection leaves the list when it is polled by its device and has
+ *   nothing to send.  All connections are still polled by the periodic
+ *   timer.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_txready(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_txready_remove
+ *
+ * Description:
+ *   Remove the connection from the TX ready list, if it is there.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_txready_remove(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_nexttxready
+ *
+ * Description:
+ *   Traverse the TX ready list.  Connections added while the list is being
+ *   traversed are appended to the end of the list.
+ *
+ * Input Parameters:
+ *   conn - The current connection or NULL to get the first connection
+ *
+ * Returned Value:
+ *   The next connection in the list or NULL at the end of the list
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_nexttxready(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_timer
  *
@@ -785,6 +1063,95 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                int hsec);
 
+/****************************************************************************
+ * Name: tcp_timer_arm
+ *
+ * Description:
+ *   Start, restart or stop the timer of the connection according to its
+ *   state:  The retransmission timer while there is un-ACKed data, the
+ *   TIME_WAIT and FIN_WAIT_2 timeouts, and the keep-alive timer of an
+ *   idle, established connection.  Must be called after any change of
+ *   the state that the timer depends on.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+void tcp_timer_arm(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_timer_arm(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_settimer
+ *
+ * Description:
+ *   Set the timer of the connection to 'hsec' half-seconds, starting now.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *   hsec - The new value of the timer in halves of a second
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+void tcp_settimer(FAR struct tcp_conn_s *conn, uint8_t hsec);
+#else
+#  define tcp_settimer(conn, hsec) do { (conn)->timer = (hsec); } while (0)
+#endif
+
+/****************************************************************************
+ * Name: tcp_timer_poll
+ *
+ * Description:
+ *   The timer of the connection has expired.  Run tcp_timer() with the
+ *   time elapsed since the timer was last brought up to date, then poll
+ *   the connection if the timer did not produce a packet, and restart the
+ *   timer.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+void tcp_timer_poll(FAR struct net_driver_s *dev,
+                    FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timer_cancel
+ *
+ * Description:
+ *   Stop the timer of the connection before the connection is freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+void tcp_timer_cancel(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_listen_initialize
  *
@@ -1375,14 +1742,62 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The connection that will advertise the window
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value of the TCP receive window to use.  This is the value of the
+ *   window field of the TCP header, i.e., it is scaled if window scaling is
+ *   in effect.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_recvwindow_consumed
+ *
+ * Description:
+ *   The application has read data from the read-ahead buffers.  Send a
+ *   window update if the read opened a receive window that the SO_RCVBUF
+ *   limit had closed.
+ *
+ * Input Parameters:
+ *   conn   - The connection
+ *   queued - The number of unread bytes before the read
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_READAHEAD) && defined(CONFIG_NET_SOCKBUF)
+void tcp_recvwindow_consumed(FAR struct tcp_conn_s *conn, uint32_t queued);
+#endif
+
+/****************************************************************************
+ * Name: tcp_get_recvscale
+ *
+ * Description:
+ *   Return the window scale shift count to offer on the specified device.
+ *   This is the smallest shift count that can represent the largest
+ *   receive window that the read-ahead buffers support.
+ *
+ * Input Parameters:
+ *   dev - The device for the connection
+ *
+ * Returned Value:
+ *   The window scale shift count (0-TCP_WSCALE_MAX).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_recvscale(FAR struct net_driver_s *dev);
+#endif
 
 /****************************************************************************
  * Name: psock_tcp_cansend
@@ -1410,6 +1825,215 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
 
 int psock_tcp_cansend(FAR struct socket *psock);
 
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state when the connection enters
+ *   the ESTABLISHED state.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state on receipt of an ACK in the
+ *   ESTABLISHED state.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   ackseq - The acknowledgement number of the received segment
+ *   seglen - The length of the data in the received segment
+ *
+ * Returned Value:
+ *   True if the first un-ACKed segment should be retransmitted now (fast
+ *   retransmit or a partial ACK in fast recovery).
+ *
+ * Assumptions:
+ *   Called with the network locked.  conn->unacked has been updated for
+ *   this ACK.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq,
+                uint16_t seglen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of the connection by name.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *   name - The name of the algorithm (not necessarily NUL terminated)
+ *   len  - The length of the name
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Update the SACK scoreboard from the options of a received ACK.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   opt    - The TCP options of the received segment
+ *   optlen - The length of the TCP options
+ *   ackseq - The acknowledgement number of the received segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR const uint8_t *opt,
+                    unsigned int optlen, uint32_t ackseq);
+
+/****************************************************************************
+ * Name: tcp_sack_skip
+ *
+ * Description:
+ *   Decide how much of the data at a sequence number is to be sent again by
+ *   a retransmission.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *   seq  - The sequence number of the next data to send
+ *   len  - The length of the data that is about to be sent.  Reduced so
+ *          that the segment does not run into data that need not be sent.
+ *
+ * Returned Value:
+ *   The number of bytes at 'seq' that need not be sent:  They have been
+ *   SACKed, have already been retransmitted in this fast recovery, or are
+ *   still in flight above the highest SACKed data.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_sack_skip(FAR struct tcp_conn_s *conn, uint32_t seq,
+                       FAR uint32_t *len);
+
+/****************************************************************************
+ * Name: tcp_sack_reset
+ *
+ * Description:
+ *   Forget the SACK scoreboard.  Called on a retransmission timeout, after
+ *   which the receiver may have discarded SACKed data (RFC 2018).
+ *
+ ****************************************************************************/
+
+void tcp_sack_reset(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_delack
+ *
+ * Description:
+ *   Decide if the ACK of a received data segment may be delayed (RFC 1122,
+ *   section 4.2.3.2).  Every second segment is ACKed immediately.  Other
+ *   ACKs are sent with the next outgoing segment or when the delay
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection that received the data
+ *
+ * Returned Value:
+ *   True if the ACK is delayed; false if it must be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+bool tcp_delack(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_delack_due
+ *
+ * Description:
+ *   Return true if a delayed ACK has to be sent now.
+ *
+ ****************************************************************************/
+
+bool tcp_delack_due(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_delack_cancel
+ *
+ * Description:
+ *   Stop the timer of a delayed ACK before the connection is freed.
+ *
+ ****************************************************************************/
+
+void tcp_delack_cancel(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_wrbuffer_initialize
  *
@@ -1498,6 +2122,38 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb);
 int tcp_wrbuffer_test(void);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of the
+ *   connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_NET_SOCKBUF)
+uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up the senders waiting for room in the write buffers of the
+ *   connection if the buffered data is below the SO_SNDBUF limit.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_NET_SOCKBUF)
+void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_wrbuffer_dump
  *
@@ -159,7 +159,8 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   else
     {
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
-      DEBUGASSERT(dev->d_sndlen <= conn->mss);
+      DEBUGASSERT(dev->d_sndlen <= conn->mss ||
+                  NETDEV_OFFLOAD(dev, NETDEV_TSO));
 #else
       /* If d_sndlen > 0, the application has data to be sent. */
 
@@ -254,6 +255,12 @@ void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * the IP and TCP headers.
        */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+      /* A TSO device splits a packet that is larger than the MTU */
+
+      dev->d_tsomss = conn->mss;
+#endif
+
       tcp_send(dev, conn, TCP_ACK | TCP_PSH, dev->d_sndlen + hdrlen);
     }
 
@@ -253,7 +253,7 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
    * packet.
    */
 
-  iob = iob_tryalloc(true, IOBUSER_NET_TCP_READAHEAD);
+  iob = iob_tryallocsize(buflen, true, IOBUSER_NET_TCP_READAHEAD);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to create new I/O buffer chain\n");
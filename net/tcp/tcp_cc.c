@@ -0,0 +1,476 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of duplicate ACKs that trigger a fast retransmission */
+
+#define TCP_CC_DUPTHRESH 3
+
+/* Keep the congestion window well clear of overflow */
+
+#define TCP_CC_MAXCWND   0x40000000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* NewReno (RFC 5681 and RFC 6582) */
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",          /* name */
+  NULL,               /* init */
+  newreno_ssthresh,   /* ssthresh */
+  newreno_cong_avoid  /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All congestion control algorithms.  The first one is the fall-back
+ * default.
+ */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algorithms[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+};
+
+#define TCP_CC_NALGORITHMS \
+  (sizeof(g_tcp_cc_algorithms) / sizeof(g_tcp_cc_algorithms[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_find
+ *
+ * Description:
+ *   Find a congestion control algorithm by name.
+ *
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *tcp_cc_find(FAR const char *name,
+                                                  size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+  int i;
+
+  for (i = 0; i < TCP_CC_NALGORITHMS; i++)
+    {
+      ops = g_tcp_cc_algorithms[i];
+      if (strlen(ops->name) == len && strncmp(ops->name, name, len) == 0)
+        {
+          return ops;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ops
+ *
+ * Description:
+ *   Return the congestion control algorithm of the connection.
+ *
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *tcp_cc_ops(FAR struct tcp_conn_s *conn)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+
+  if (conn->cc == NULL)
+    {
+      ops = tcp_cc_find(CONFIG_NET_TCP_CC_DEFAULT,
+                        strlen(CONFIG_NET_TCP_CC_DEFAULT));
+      conn->cc = ops != NULL ? ops : g_tcp_cc_algorithms[0];
+    }
+
+  return conn->cc;
+}
+
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   Half of the data in flight, but no less than two segments (RFC 5681,
+ *   equation 4).
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh = conn->unacked / 2;
+
+  return ssthresh > 2 * conn->mss ? ssthresh : 2 * conn->mss;
+}
+
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Grow the window by about one segment per round-trip time (RFC 5681,
+ *   equation 3).
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t incr = (uint32_t)conn->mss * conn->mss / conn->cwnd;
+
+  conn->cwnd += incr > 0 ? incr : 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state when the connection enters
+ *   the ESTABLISHED state.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  FAR const struct tcp_cc_ops_s *ops = tcp_cc_ops(conn);
+
+  /* The initial window of RFC 5681 */
+
+  if (conn->mss > 2190)
+    {
+      conn->cwnd = 2 * conn->mss;
+    }
+  else if (conn->mss > 1095)
+    {
+      conn->cwnd = 3 * conn->mss;
+    }
+  else
+    {
+      conn->cwnd = 4 * conn->mss;
+    }
+
+  conn->ssthresh = TCP_CC_MAXCWND;
+  conn->lastack  = tcp_getsequence(conn->sndseq);
+  conn->recover  = conn->lastack;
+  conn->dupacks  = 0;
+  conn->recovery = false;
+  conn->ccrexmit = false;
+
+#ifdef CONFIG_NET_TCP_SACK
+  tcp_sack_reset(conn);
+#endif
+
+  if (ops->init != NULL)
+    {
+      ops->init(conn);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state on receipt of an ACK in the
+ *   ESTABLISHED state.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   ackseq - The acknowledgement number of the received segment
+ *   seglen - The length of the data in the received segment
+ *
+ * Returned Value:
+ *   True if the first un-ACKed segment should be retransmitted now (fast
+ *   retransmit or a partial ACK in fast recovery).
+ *
+ * Assumptions:
+ *   Called with the network locked.  conn->unacked has been updated for
+ *   this ACK.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq,
+                uint16_t seglen)
+{
+  FAR const struct tcp_cc_ops_s *ops = tcp_cc_ops(conn);
+  int32_t acked = (int32_t)(ackseq - conn->lastack);
+
+  if (acked > 0)
+    {
+      /* New data has been ACKed.  The write buffer logic does not
+       * otherwise reset the retransmission count, so that the back-off of
+       * the retransmission timer and Karn's rule would stay in effect for
+       * the rest of the connection.
+       */
+
+      conn->lastack = ackseq;
+      conn->dupacks = 0;
+      conn->nrtx    = 0;
+
+      if (conn->recovery)
+        {
+          if ((int32_t)(ackseq - conn->recover) >= 0)
+            {
+              /* A full ACK.  Leave fast recovery with the reduced window. */
+
+              ninfo("Fast recovery done: cwnd=%lu\n",
+                    (unsigned long)conn->ssthresh);
+
+              conn->cwnd     = conn->ssthresh;
+              conn->recovery = false;
+              return false;
+            }
+
+          /* A partial ACK.  The next segment was lost, too.  Retransmit it
+           * and deflate the window by the amount of new data ACKed.
+           */
+
+          conn->cwnd  = conn->cwnd > (uint32_t)acked ?
+                        conn->cwnd - acked : 0;
+          conn->cwnd += conn->mss;
+          return true;
+        }
+
+      if (conn->cwnd < conn->ssthresh)
+        {
+          /* Slow start */
+
+          conn->cwnd += (uint32_t)acked < conn->mss ? acked : conn->mss;
+        }
+      else
+        {
+          /* Congestion avoidance */
+
+          ops->cong_avoid(conn, acked);
+        }
+
+      if (conn->cwnd > TCP_CC_MAXCWND)
+        {
+          conn->cwnd = TCP_CC_MAXCWND;
+        }
+    }
+  else if (acked == 0 && seglen == 0 && conn->unacked > 0)
+    {
+      /* A duplicate ACK */
+
+      if (conn->dupacks < UINT8_MAX)
+        {
+          conn->dupacks++;
+        }
+
+      if (conn->recovery)
+        {
+          /* Each further duplicate ACK means that a segment has left the
+           * network.  Inflate the window so that new data may be sent.
+           */
+
+          conn->cwnd += conn->mss;
+        }
+      else if (conn->dupacks == TCP_CC_DUPTHRESH &&
+               (int32_t)(ackseq - conn->recover) >= 0)
+        {
+          /* Fast retransmit.  Do not enter fast recovery again for losses
+           * of data that was in flight when it was last entered.
+           */
+
+          conn->ssthresh = ops->ssthresh(conn);
+          conn->cwnd     = conn->ssthresh + TCP_CC_DUPTHRESH * conn->mss;
+          conn->recover  = conn->sndseq_max;
+          conn->recovery = true;
+#ifdef CONFIG_NET_TCP_SACK
+          conn->rxthigh  = ackseq;
+#endif
+
+          ninfo("Fast retransmit: ssthresh=%lu\n",
+                (unsigned long)conn->ssthresh);
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  FAR const struct tcp_cc_ops_s *ops = tcp_cc_ops(conn);
+
+  /* Only reduce the threshold on the first timeout of a segment
+   * (RFC 5681, section 3.1).  The retransmission count has already been
+   * incremented for this timeout.
+   */
+
+  if (conn->nrtx <= 1)
+    {
+      conn->ssthresh = ops->ssthresh(conn);
+    }
+
+  /* Restart with slow start from a window of one segment */
+
+  conn->cwnd     = conn->mss;
+  conn->recover  = conn->sndseq_max;
+  conn->dupacks  = 0;
+  conn->recovery = false;
+  conn->ccrexmit = false;
+
+#ifdef CONFIG_NET_TCP_SACK
+  tcp_sack_reset(conn);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of the connection by name.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *   name - The name of the algorithm (not necessarily NUL terminated)
+ *   len  - The length of the name
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name,
+                  size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+
+  /* Ignore a trailing NUL terminator */
+
+  len = strnlen(name, len);
+
+  ops = tcp_cc_find(name, len);
+  if (ops == NULL)
+    {
+      return -ENOENT;
+    }
+
+  conn->cc = ops;
+
+  /* Start the new algorithm from the current window if the connection is
+   * already established.
+   */
+
+  if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+      ops->init != NULL)
+    {
+      ops->init(conn);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of the connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn)
+{
+  return tcp_cc_ops(conn)->name;
+}
+
+#endif /* CONFIG_NET_TCP_CC */
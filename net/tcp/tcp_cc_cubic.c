@@ -0,0 +1,243 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The window grows as W(t) = C * (t - K)^3 + Wmax, t in seconds and W in
+ * segments, with C = 0.4.  The window is reduced to beta * Wmax with
+ * beta = 0.7 on a loss.
+ *
+ * Limit (t - K) to 100 seconds so that the cube does not overflow.
+ */
+
+#define CUBIC_MAXDELTA 100000    /* msec */
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* CUBIC (RFC 8312) */
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",            /* name */
+  cubic_init,         /* init */
+  cubic_ssthresh,     /* ssthresh */
+  cubic_cong_avoid    /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root (rounded down).
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cubic_wmax   = 0;
+  conn->cubic_origin = 0;
+  conn->cubic_west   = 0;
+  conn->cubic_k      = 0;
+  conn->cubic_epoch  = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss and reduce it by beta.  With fast
+ *   convergence, a flow that is losing bandwidth to new flows remembers a
+ *   smaller window.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh;
+
+  /* A new epoch starts with the next congestion avoidance */
+
+  conn->cubic_epoch = 0;
+
+  if (conn->cwnd < conn->cubic_wmax)
+    {
+      conn->cubic_wmax = conn->cwnd / 20 * 17;   /* (1 + beta) / 2 */
+    }
+  else
+    {
+      conn->cubic_wmax = conn->cwnd;
+    }
+
+  ssthresh = conn->cwnd / 10 * 7;                /* beta */
+  return ssthresh > 2 * conn->mss ? ssthresh : 2 * conn->mss;
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Grow the window towards the value of the cubic function, but at least
+ *   as fast as a Reno flow would grow in the same situation.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  clock_t now = clock_systimer();
+  int64_t delta;
+  int64_t target;
+
+  if (conn->cubic_epoch == 0)
+    {
+      /* Start a new epoch.  K is the time needed to grow back to the
+       * window before the loss: K = cbrt((Wmax - cwnd) / C).  In msec,
+       * and with the windows in bytes, that is
+       * K = cbrt((Wmax - cwnd) / mss * 2.5 * 10^9).
+       */
+
+      conn->cubic_epoch = now != 0 ? now : 1;
+      if (conn->cwnd < conn->cubic_wmax)
+        {
+          conn->cubic_k      =
+            cubic_cbrt((uint64_t)(conn->cubic_wmax - conn->cwnd) *
+                       2500000000ull / conn->mss);
+          conn->cubic_origin = conn->cubic_wmax;
+        }
+      else
+        {
+          conn->cubic_k      = 0;
+          conn->cubic_origin = conn->cwnd;
+        }
+
+      conn->cubic_west = conn->cwnd;
+    }
+
+  /* W(t) = C * (t - K)^3 + origin.  With t and K in msec and W in bytes,
+   * that is 0.4 * (t - K)^3 / 10^9 * mss.
+   */
+
+  delta = (int64_t)TICK2MSEC(now - conn->cubic_epoch) - conn->cubic_k;
+  if (delta > CUBIC_MAXDELTA)
+    {
+      delta = CUBIC_MAXDELTA;
+    }
+  else if (delta < -CUBIC_MAXDELTA)
+    {
+      delta = -CUBIC_MAXDELTA;
+    }
+
+  target = conn->cubic_origin +
+           delta * delta * delta / 10000 * 4 * conn->mss / 1000000;
+
+  /* The window of a Reno flow with the same loss rate grows by
+   * 3 * (1 - beta) / (1 + beta) segments every round-trip time.
+   */
+
+  conn->cubic_west += (uint64_t)acked * conn->mss * 9 / 17 / conn->cwnd;
+  if (target < (int64_t)conn->cubic_west)
+    {
+      target = conn->cubic_west;
+    }
+
+  if (target > (int64_t)conn->cwnd)
+    {
+      /* Approach the target within about one round-trip time */
+
+      conn->cwnd += (uint64_t)(target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      /* At the plateau, probe for more bandwidth very slowly */
+
+      conn->cwnd += (uint64_t)acked * conn->mss / (100 * conn->cwnd);
+    }
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -55,6 +55,8 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/mempool.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -72,6 +74,29 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Traverse the candidates for an incoming segment:  Either the hash chain
+ * selected by the ports and the remote address or all active connections.
+ */
+
+#if CONFIG_NET_TCP_HASHSIZE > 0
+#  define TCP_HASH(l,r,a)     ((TCP_PORT_HASH((l) ^ (r)) ^ \
+                               ((a) % CONFIG_NET_TCP_HASHSIZE)) % \
+                               CONFIG_NET_TCP_HASHSIZE)
+#  define TCP_ACTIVE_FIRST(h) g_tcp_hash[h]
+#  define TCP_ACTIVE_NEXT(c)  ((c)->hnext)
+#else
+#  define TCP_HASH(l,r,a)     0
+#  define TCP_ACTIVE_FIRST(h) \
+     ((FAR struct tcp_conn_s *)g_active_tcp_connections.head)
+#  define TCP_ACTIVE_NEXT(c)  ((FAR struct tcp_conn_s *)(c)->node.flink)
+#endif
+
+/* Fold an IPv6 address into 32 bits for hashing */
+
+#define TCP_IPv6_FOLD(a) \
+  (((uint32_t)((a)[6] ^ (a)[4] ^ (a)[2] ^ (a)[0]) << 16) | \
+   (uint32_t)((a)[7] ^ (a)[5] ^ (a)[3] ^ (a)[1]))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -80,14 +105,22 @@
 
 static struct tcp_conn_s g_tcp_connections[CONFIG_NET_TCP_CONNS];
 
-/* A list of all free TCP connections */
+/* The pool of all free TCP connections.  The pool does not grow:  the
+ * listener and port lookups scan g_tcp_connections[] directly.
+ */
 
-static dq_queue_t g_free_tcp_connections;
+static struct mempool_s g_tcp_connpool;
 
 /* A list of all connected TCP connections */
 
 static dq_queue_t g_active_tcp_connections;
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+/* The active connections hashed by ports and remote address */
+
+static FAR struct tcp_conn_s *g_tcp_hash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -327,9 +360,10 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+  conn       = TCP_ACTIVE_FIRST(TCP_HASH(tcp->destport, tcp->srcport,
+                                         srcipaddr));
 
   while (conn)
     {
@@ -366,7 +400,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = TCP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -394,9 +428,10 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+  conn       = TCP_ACTIVE_FIRST(TCP_HASH(tcp->destport, tcp->srcport,
+                                         TCP_IPv6_FOLD(*srcipaddr)));
 
   while (conn)
     {
@@ -433,13 +468,103 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = TCP_ACTIVE_NEXT(conn);
     }
 
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: tcp_hash_bucket
+ *
+ * Description:
+ *   Return the hash chain of an active connection.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_HASHSIZE > 0
+static FAR struct tcp_conn_s **tcp_hash_bucket(FAR struct tcp_conn_s *conn)
+{
+  uint32_t raddr;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      raddr = conn->u.ipv4.raddr;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      raddr = TCP_IPv6_FOLD(conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  return &g_tcp_hash[TCP_HASH(conn->lport, conn->rport, raddr)];
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_activate
+ *
+ * Description:
+ *   Put the connection into the list of active connections and into its
+ *   hash chain.  The ports and the remote address must be set.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_activate(FAR struct tcp_conn_s *conn)
+{
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  FAR struct tcp_conn_s **bucket = tcp_hash_bucket(conn);
+
+  conn->hnext = *bucket;
+  *bucket     = conn;
+#endif
+
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+}
+
+/****************************************************************************
+ * Name: tcp_deactivate
+ *
+ * Description:
+ *   Remove the connection from the list of active connections and from its
+ *   hash chain.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_deactivate(FAR struct tcp_conn_s *conn)
+{
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  FAR struct tcp_conn_s **bucket;
+
+  for (bucket = tcp_hash_bucket(conn); *bucket != NULL;
+       bucket = &(*bucket)->hnext)
+    {
+      if (*bucket == conn)
+        {
+          *bucket = conn->hnext;
+          break;
+        }
+    }
+#endif
+
+  dq_rem(&conn->node, &g_active_tcp_connections);
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_bind
  *
@@ -591,19 +716,23 @@ void tcp_initialize(void)
 
   /* Initialize the queues */
 
-  dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
     {
-      /* Mark the connection closed and move it to the free list */
+      /* Mark the connection closed */
 
       g_tcp_connections[i].tcpstateflags = TCP_CLOSED;
-      dq_addlast(&g_tcp_connections[i].node, &g_free_tcp_connections);
     }
 
+  /* And move them all to the free pool */
+
+  (void)mempool_initialize(&g_tcp_connpool, "tcpconn", g_tcp_connections,
+                           sizeof(struct tcp_conn_s), CONFIG_NET_TCP_CONNS,
+                           0, 0);
+
   g_last_tcp_port = 1024;
 }
 
@@ -624,14 +753,14 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
   /* Because this routine is called from both event processing (with the
    * network locked) and and from user level.  Make sure that the network
-   * locked in any cased while accessing g_free_tcp_connections[];
+   * locked in any cased while accessing g_active_tcp_connections;
    */
 
   net_lock();
 
-  /* Return the entry from the head of the free list */
+  /* Take an entry from the free pool */
 
-  conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+  conn = (FAR struct tcp_conn_s *)mempool_alloc(&g_tcp_connpool);
 
 #ifndef CONFIG_NET_SOLINGER
   /* Is the free list empty? */
@@ -701,8 +830,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
           /* Now there is guaranteed to be one free connection.  Get it! */
 
-          conn = (FAR struct tcp_conn_s *)
-            dq_remfirst(&g_free_tcp_connections);
+          conn = (FAR struct tcp_conn_s *)mempool_alloc(&g_tcp_connpool);
         }
     }
 #endif
@@ -723,6 +851,21 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepidle      = 2 * DSEC_PER_HOUR;
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
+#endif
+#ifdef CONFIG_NET_SOCKBUF
+#ifdef CONFIG_NET_TCP_READAHEAD
+      conn->rcvbufs       = CONFIG_NET_RECV_BUFSIZE;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      conn->sndbufs       = CONFIG_NET_SEND_BUFSIZE;
+
+      /* The semaphore is used for signaling and must not have priority
+       * inheritance enabled.
+       */
+
+      nxsem_init(&conn->sndsem, 0, 0);
+      nxsem_setprotocol(&conn->sndsem, SEM_PRIO_NONE);
+#endif
 #endif
     }
 
@@ -746,7 +889,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   FAR struct tcp_wrbuffer_s *wrbuffer;
 #endif
 
-  /* Because g_free_tcp_connections is accessed from user level and event
+  /* Because g_active_tcp_connections is accessed from user level and event
    * processing logic, it is necessary to keep the network locked during this
    * operation.
    */
@@ -772,9 +915,25 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_deactivate(conn);
     }
 
+  /* Remove the connection from the TX ready list */
+
+  tcp_txready_remove(conn);
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+  /* Stop the timer of the connection */
+
+  tcp_timer_cancel(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Stop the timer of a delayed ACK */
+
+  tcp_delack_cancel(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -815,10 +974,14 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     }
 #endif
 
-  /* Mark the connection available and put it into the free list */
+#if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_NET_SOCKBUF)
+  nxsem_destroy(&conn->sndsem);
+#endif
+
+  /* Mark the connection available and return it to the free pool */
 
   conn->tcpstateflags = TCP_CLOSED;
-  dq_addlast(&conn->node, &g_free_tcp_connections);
+  mempool_free(&g_tcp_connpool, conn);
   net_unlock();
 }
 
@@ -1037,7 +1200,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_activate(conn);
     }
 
   return conn;
@@ -1272,7 +1435,11 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_activate(conn);
+
+  /* Start the timer that sends the SYN */
+
+  tcp_timer_arm(conn);
   ret = OK;
 
 errout_with_lock:
@@ -0,0 +1,264 @@
+/****************************************************************************
+ * net/tcp/tcp_conntimer.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CONNTIMER
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_timer_work
+ *
+ * Description:
+ *   The timer of the connection has expired.  Poll the device so that
+ *   tcp_timer_poll() runs for the connection.
+ *
+ ****************************************************************************/
+
+static void tcp_timer_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  net_lock();
+  if (conn->tcpstateflags != TCP_CLOSED && conn->dev != NULL)
+    {
+      conn->timerdue = true;
+      tcp_txready(conn);
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_timer_arm
+ *
+ * Description:
+ *   Start, restart or stop the timer of the connection according to its
+ *   state.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_timer_arm(FAR struct tcp_conn_s *conn)
+{
+  clock_t now = clock_systimer();
+  clock_t deadline;
+  sclock_t delay;
+  uint8_t state = conn->tcpstateflags & TCP_STATE_MASK;
+
+  if (state == TCP_TIME_WAIT || state == TCP_FIN_WAIT_2)
+    {
+      /* The timer counts up to TCP_TIME_WAIT_TIMEOUT */
+
+      conn->timerrun = false;
+      deadline = conn->timerbase +
+                 (clock_t)(TCP_TIME_WAIT_TIMEOUT - conn->timer) *
+                 TICK_PER_HSEC;
+    }
+  else if (state != TCP_CLOSED && state != TCP_ALLOCATED &&
+           conn->unacked > 0)
+    {
+      /* The retransmission timer counts down from the time when the first
+       * un-ACKed data was sent.
+       */
+
+      if (!conn->timerrun)
+        {
+          conn->timerbase = now;
+          conn->timerrun  = true;
+        }
+
+      deadline = conn->timerbase + (clock_t)conn->timer * TICK_PER_HSEC;
+    }
+  else
+    {
+      conn->timerrun = false;
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+      if (state == TCP_ESTABLISHED && conn->keepalive)
+        {
+          deadline = conn->keeptime +
+                     DSEC2TICK(conn->keepretries > 0 ? conn->keepintvl :
+                                                       conn->keepidle);
+        }
+      else
+#endif
+        {
+          /* Nothing to time */
+
+          (void)work_cancel(LPWORK, &conn->timerwork);
+          return;
+        }
+    }
+
+  if (conn->dev == NULL)
+    {
+      /* Nothing can be sent without a device.  The timer is started again
+       * with the next packet.
+       */
+
+      (void)work_cancel(LPWORK, &conn->timerwork);
+      return;
+    }
+
+  /* Nothing to do if the timer is already due at that time */
+
+  if (!work_available(&conn->timerwork) && conn->timerdeadline == deadline)
+    {
+      return;
+    }
+
+  delay = (sclock_t)(deadline - now);
+  conn->timerdeadline = deadline;
+  work_queue(LPWORK, &conn->timerwork, tcp_timer_work, conn,
+             delay > 0 ? (clock_t)delay : 0);
+}
+
+/****************************************************************************
+ * Name: tcp_settimer
+ *
+ * Description:
+ *   Set the timer of the connection to 'hsec' half-seconds, starting now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_settimer(FAR struct tcp_conn_s *conn, uint8_t hsec)
+{
+  conn->timer     = hsec;
+  conn->timerbase = clock_systimer();
+  conn->timerrun  = conn->unacked > 0;
+  tcp_timer_arm(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_timer_poll
+ *
+ * Description:
+ *   The timer of the connection has expired.  Run tcp_timer() with the
+ *   time elapsed since the timer was last brought up to date, then poll
+ *   the connection if the timer did not produce a packet, and restart the
+ *   timer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_timer_poll(FAR struct net_driver_s *dev,
+                    FAR struct tcp_conn_s *conn)
+{
+  clock_t elapsed = clock_systimer() - conn->timerbase;
+  int hsec;
+
+  /* Keep the remainder of a half-second for the next run.  uint8_t is
+   * the width of the timer.
+   */
+
+  hsec = elapsed / TICK_PER_HSEC > UINT8_MAX ?
+         UINT8_MAX : (int)(elapsed / TICK_PER_HSEC);
+
+  conn->timerbase += (clock_t)hsec * TICK_PER_HSEC;
+  conn->timerdue   = false;
+
+  tcp_timer(dev, conn, hsec);
+
+  /* tcp_timer() sends a packet, closes the connection, or frees it.  A
+   * freed connection has already sent its reset.
+   */
+
+  if (conn->tcpstateflags != TCP_CLOSED)
+    {
+      if (dev->d_len == 0)
+        {
+          /* The timer had nothing to send.  Poll the connection as if the
+           * timer had not expired.
+           */
+
+          tcp_poll(dev, conn);
+        }
+
+      tcp_timer_arm(conn);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_timer_cancel
+ *
+ * Description:
+ *   Stop the timer of the connection before the connection is freed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_timer_cancel(FAR struct tcp_conn_s *conn)
+{
+  conn->timerdue = false;
+  conn->timerrun = false;
+  (void)work_cancel(LPWORK, &conn->timerwork);
+}
+
+#endif /* CONFIG_NET_TCP_CONNTIMER */
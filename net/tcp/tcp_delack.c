@@ -0,0 +1,167 @@
+/****************************************************************************
+ * net/tcp/tcp_delack.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The delay of an ACK in clock ticks, at least one tick */
+
+#define TCP_DELACK_TICKS \
+  (MSEC2TICK(CONFIG_NET_TCP_DELAYED_ACK_MSEC) > 0 ? \
+   MSEC2TICK(CONFIG_NET_TCP_DELAYED_ACK_MSEC) : 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_delack_work
+ *
+ * Description:
+ *   The delay of an ACK has expired.  Poll the device so that the ACK is
+ *   sent by tcp_poll() if it has not been sent with other data meanwhile.
+ *
+ ****************************************************************************/
+
+static void tcp_delack_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  net_lock();
+  if (conn->ackdelayed && conn->dev != NULL)
+    {
+      tcp_txready(conn);
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_delack
+ *
+ * Description:
+ *   Decide if the ACK of a received data segment may be delayed (RFC 1122,
+ *   section 4.2.3.2).  Every second segment is ACKed immediately.  Other
+ *   ACKs are sent with the next outgoing segment or when the delay
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection that received the data
+ *
+ * Returned Value:
+ *   True if the ACK is delayed; false if it must be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_delack(FAR struct tcp_conn_s *conn)
+{
+  if (conn->quickack || conn->ackdelayed)
+    {
+      return false;
+    }
+
+  conn->ackdelayed = true;
+  conn->acktime    = clock_systimer();
+
+  work_queue(LPWORK, &conn->ackwork, tcp_delack_work, conn,
+             TCP_DELACK_TICKS);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_delack_due
+ *
+ * Description:
+ *   Return true if a delayed ACK has to be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_delack_due(FAR struct tcp_conn_s *conn)
+{
+  return conn->ackdelayed &&
+         (conn->quickack ||
+          clock_systimer() - conn->acktime >= TCP_DELACK_TICKS);
+}
+
+/****************************************************************************
+ * Name: tcp_delack_cancel
+ *
+ * Description:
+ *   Stop the timer of a delayed ACK before the connection is freed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_delack_cancel(FAR struct tcp_conn_s *conn)
+{
+  conn->ackdelayed = false;
+  (void)work_cancel(LPWORK, &conn->ackwork);
+}
+
+#endif /* CONFIG_NET_TCP_DELAYED_ACK */
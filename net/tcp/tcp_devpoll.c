@@ -56,6 +56,15 @@
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of connections that may have something to send */
+
+static FAR struct tcp_conn_s *g_txready_head;
+static FAR struct tcp_conn_s *g_txready_tail;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -124,6 +133,27 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
           result = tcp_callback(dev, conn, TCP_POLL);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+          /* Send a delayed ACK that is due if no data is sent with it */
+
+          if (dev->d_sndlen == 0 && tcp_delack_due(conn))
+            {
+              result |= TCP_SNDACK;
+            }
+#endif
+
+#if defined(CONFIG_NET_TCP_READAHEAD) && defined(CONFIG_NET_SOCKBUF)
+          /* Send a window update after the application has read from a
+           * full receive buffer.  Any segment carries the new window.
+           */
+
+          if (conn->rcvwndupdate)
+            {
+              conn->rcvwndupdate = false;
+              result |= TCP_SNDACK;
+            }
+#endif
+
           /* Handle the callback response */
 
           tcp_appsend(dev, conn, result);
@@ -131,4 +161,110 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_txready
+ *
+ * Description:
+ *   Add the connection to the list of connections that are polled when a
+ *   device polls for TX data.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_txready(FAR struct tcp_conn_s *conn)
+{
+  if (!conn->txready)
+    {
+      conn->txready = true;
+      conn->txflink = NULL;
+      conn->txblink = g_txready_tail;
+
+      if (g_txready_tail != NULL)
+        {
+          g_txready_tail->txflink = conn;
+        }
+      else
+        {
+          g_txready_head = conn;
+        }
+
+      g_txready_tail = conn;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_txready_remove
+ *
+ * Description:
+ *   Remove the connection from the TX ready list, if it is there.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_txready_remove(FAR struct tcp_conn_s *conn)
+{
+  if (conn->txready)
+    {
+      if (conn->txblink != NULL)
+        {
+          conn->txblink->txflink = conn->txflink;
+        }
+      else
+        {
+          g_txready_head = conn->txflink;
+        }
+
+      if (conn->txflink != NULL)
+        {
+          conn->txflink->txblink = conn->txblink;
+        }
+      else
+        {
+          g_txready_tail = conn->txblink;
+        }
+
+      conn->txready = false;
+      conn->txflink = NULL;
+      conn->txblink = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_nexttxready
+ *
+ * Description:
+ *   Traverse the TX ready list.
+ *
+ * Input Parameters:
+ *   conn - The current connection or NULL to get the first connection
+ *
+ * Returned Value:
+ *   The next connection in the list or NULL at the end of the list
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_nexttxready(FAR struct tcp_conn_s *conn)
+{
+  return conn == NULL ? g_txready_head : conn->txflink;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
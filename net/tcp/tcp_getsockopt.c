@@ -41,12 +41,14 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
 #include <netinet/tcp.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/tcp.h>
 
@@ -56,6 +58,66 @@
 
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_getinfo
+ *
+ * Description:
+ *   Take a snapshot of the state and the statistics of the connection for
+ *   the TCP_INFO socket option.  The RTT estimator keeps the smoothed RTT
+ *   scaled by 8 and its variation scaled by 4, both in half-seconds.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection to query
+ *   info - The zeroed structure to receive the information
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_INFO
+static void tcp_getinfo(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_info *info)
+{
+  net_lock();
+
+  info->tcpi_state         = conn->tcpstateflags & TCP_STATE_MASK;
+  info->tcpi_retransmits   = conn->nrtx;
+  info->tcpi_rto           = conn->rto * USEC_PER_HSEC;
+  info->tcpi_snd_mss       = conn->mss;
+  info->tcpi_unacked       = conn->unacked;
+  info->tcpi_rtt           = (conn->sa >> 3) * USEC_PER_HSEC;
+  info->tcpi_rttvar        = (conn->sv >> 2) * USEC_PER_HSEC;
+  info->tcpi_total_retrans = conn->rexmits;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (conn->wscale)
+    {
+      info->tcpi_snd_wscale = conn->snd_wscale;
+      info->tcpi_rcv_wscale = conn->rcv_wscale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+  info->tcpi_snd_ssthresh  = conn->ssthresh;
+  info->tcpi_snd_cwnd      = conn->cwnd;
+#endif
+
+#ifdef __INT64_DEFINED
+  info->tcpi_bytes_acked    = conn->bytesackd;
+  info->tcpi_bytes_received = conn->bytesrcvd;
+  info->tcpi_segs_out       = conn->segsout;
+  info->tcpi_segs_in        = conn->segsin;
+#endif
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -97,9 +159,11 @@
 int tcp_getsockopt(FAR struct socket *psock, int option,
                    FAR void *value, FAR socklen_t *value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
-   * supported.
+#if defined(CONFIG_NET_TCP_KEEPALIVE) || defined(CONFIG_NET_TCP_CC) || \
+    defined(CONFIG_NET_TCP_DELAYED_ACK) || defined(CONFIG_NET_TCP_INFO)
+  /* Keep alive options, the congestion control, delayed ACKs and the
+   * connection information are the only TCP protocol socket options
+   * currently supported.
    */
 
   FAR struct tcp_conn_s *conn;
@@ -120,10 +184,11 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
       return -ENOTCONN;
     }
 
-  /* Handle the Keep-Alive option */
+  /* Handle the TCP-protocol options */
 
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -238,6 +303,65 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
             ret              = OK;
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Get the congestion control algorithm */
+        {
+          FAR const char *name = tcp_cc_name(conn);
+          size_t len = strlen(name) + 1;
+
+          /* Truncate the name to the size of the buffer */
+
+          if (len > *value_len)
+            {
+              len = *value_len;
+            }
+
+          memcpy(value, name, len);
+          *value_len = len;
+          ret        = OK;
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      case TCP_QUICKACK: /* ACK every segment at once */
+        if (*value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            *(FAR int *)value = (int)conn->quickack;
+            *value_len        = sizeof(int);
+            ret               = OK;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_INFO
+      case TCP_INFO: /* Get the connection information */
+        {
+          struct tcp_info info;
+          size_t len = sizeof(struct tcp_info);
+
+          memset(&info, 0, sizeof(struct tcp_info));
+          tcp_getinfo(conn, &info);
+
+          /* Truncate the information to the size of the buffer */
+
+          if (len > *value_len)
+            {
+              len = *value_len;
+            }
+
+          memcpy(value, &info, len);
+          *value_len = len;
+          ret        = OK;
+        }
+        break;
+#endif
 
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
@@ -248,7 +372,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
+#endif /* CONFIG_NET_TCP_KEEPALIVE || CONFIG_NET_TCP_CC || ... */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
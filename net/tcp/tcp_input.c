@@ -72,6 +72,127 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_options
+ *
+ * Description:
+ *   Parse the options of a received SYN or SYNACK segment.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received TCP packet.
+ *   conn   - The connection that is being established
+ *   tcp    - The TCP header of the received packet
+ *   iplen  - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *   hdrlen - Offset of the TCP options in the packet buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_options(FAR struct net_driver_s *dev,
+                              FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_hdr_s *tcp,
+                              unsigned int iplen, unsigned int hdrlen)
+{
+  uint16_t tmp16;
+  uint8_t opt;
+  int i;
+
+  if ((tcp->tcpoffset & 0xf0) > 0x50)
+    {
+      for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
+        {
+          opt = dev->d_buf[hdrlen + i];
+          if (opt == TCP_OPT_END)
+            {
+              /* End of options. */
+
+              break;
+            }
+          else if (opt == TCP_OPT_NOOP)
+            {
+              /* NOP option. */
+
+              ++i;
+            }
+          else if (opt == TCP_OPT_MSS &&
+                   dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
+            {
+              uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+              /* An MSS option with the right option length. */
+
+              tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
+                       (uint16_t)dev->d_buf[hdrlen + 3 + i];
+              conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+
+              i += TCP_OPT_MSS_LEN;
+            }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+          else if (opt == TCP_OPT_WS &&
+                   dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+            {
+              /* A window scale option.  Larger shift counts than the
+               * maximum are treated as the maximum (RFC 7323).
+               */
+
+              opt = dev->d_buf[hdrlen + 2 + i];
+              conn->snd_wscale = opt > TCP_WSCALE_MAX ? TCP_WSCALE_MAX : opt;
+              conn->wscale     = true;
+
+              i += TCP_OPT_WS_LEN;
+            }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+          else if (opt == TCP_OPT_SACK_PERM &&
+                   dev->d_buf[hdrlen + 1 + i] == TCP_OPT_SACK_PERM_LEN)
+            {
+              /* The peer accepts SACK options.  Ours is sent in our SYN
+               * or, if the peer sent one, in our SYNACK, so that SACK is
+               * negotiated.
+               */
+
+              conn->sack = true;
+
+              i += TCP_OPT_SACK_PERM_LEN;
+            }
+#endif
+          else
+            {
+              /* All other options have a length field, so that we easily
+               * can skip past them.
+               */
+
+              if (dev->d_buf[hdrlen + 1 + i] == 0)
+                {
+                  /* If the length field is zero, the options are malformed
+                   * and we don't process them further.
+                   */
+
+                  break;
+                }
+
+              i += dev->d_buf[hdrlen + 1 + i];
+            }
+        }
+    }
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Windows are scaled only if both sides sent the window scale option.
+   * Ours is sent in our SYN or, if the peer sent one, in our SYNACK.
+   */
+
+  if (!conn->wscale)
+    {
+      conn->rcv_wscale = 0;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -101,9 +222,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -133,9 +252,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_OFFLOAD(dev, NETDEV_RXCSUM_L4) && tcp_chksum(dev) != 0xffff)
     {
-      /* Compute and check the TCP checksum. */
+      /* Compute and check the TCP checksum, unless the hardware did. */
 
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.tcp.drop++;
@@ -239,59 +358,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP options, if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we
-                       * easily can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are
-                           * malformed and we don't process them further.
-                           */
-
-                          break;
-                        }
-
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_parse_options(dev, conn, tcp, iplen, hdrlen);
 
           /* Our response will be a SYNACK. */
 
@@ -322,11 +391,24 @@ reset:
   return;
 
 found:
+#ifdef CONFIG_NET_TCP_INFO
+  conn->segsin++;
+#endif
+
 
   /* Update the connection's window size */
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of a SYN segment is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_wscale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -466,6 +548,12 @@ found:
         }
     }
 
+#ifdef CONFIG_NET_TCP_INFO
+  /* The payload, if any, is the next in sequence */
+
+  conn->bytesrcvd += dev->d_len;
+#endif
+
   /* Check if the incoming segment acknowledges any outstanding data. If so,
    * we update the sequence number, reset the length of the outstanding
    * data, calculate RTT estimations, and reset the retransmission timer.
@@ -532,6 +620,14 @@ found:
 
       ninfo("sndseq: %08x->%08x unackseq: %08x new unacked: %d\n",
             tcp_getsequence(conn->sndseq), ackseq, unackseq, conn->unacked);
+
+#ifdef CONFIG_NET_TCP_INFO
+      if ((int32_t)(ackseq - tcp_getsequence(conn->sndseq)) > 0)
+        {
+          conn->bytesackd += ackseq - tcp_getsequence(conn->sndseq);
+        }
+#endif
+
       tcp_setsequence(conn->sndseq, ackseq);
 
       /* Do RTT estimation, unless we have done retransmissions. */
@@ -555,13 +651,36 @@ found:
           conn->rto = (conn->sa >> 3) + conn->sv;
         }
 
+#ifdef CONFIG_NET_TCP_SACK
+      /* Update the SACK scoreboard */
+
+      if (conn->sack &&
+          (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+        {
+          tcp_sack_input(conn, &dev->d_buf[hdrlen],
+                         ((tcp->tcpoffset >> 4) - 5) << 2, ackseq);
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+      /* Let congestion control see the ACK.  A fast retransmission is
+       * left to the send logic.
+       */
+
+      if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+          tcp_cc_ack(conn, ackseq, dev->d_len))
+        {
+          conn->ccrexmit = true;
+        }
+#endif
+
       /* Set the acknowledged flag. */
 
       flags |= TCP_ACKDATA;
 
       /* Reset the retransmission timer. */
 
-      conn->timer = conn->rto;
+      tcp_settimer(conn, conn->rto);
     }
 
   /* Do different things depending on in what state the connection is. */
@@ -620,6 +739,9 @@ found:
             conn->sndseq_max    = 0;
 #endif
             conn->unacked       = 0;
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
             flags               = TCP_CONNECTED;
             ninfo("TCP state: TCP_ESTABLISHED\n");
 
@@ -655,60 +777,9 @@ found:
         if ((flags & TCP_ACKDATA) != 0 &&
             (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP options, if present. */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_parse_options(dev, conn, tcp, iplen, hdrlen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -719,6 +790,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -906,6 +980,17 @@ found:
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+                /* A pure ACK of the new data may be delayed in the hope
+                 * that it can be sent with the next outgoing data.
+                 */
+
+                if (len > 0 && dev->d_sndlen == 0 && tcp_delack(conn))
+                  {
+                    result &= ~TCP_SNDACK;
+                  }
+#endif
               }
 
             /* Send the response, ACKing the data or not, as appropriate */
@@ -946,7 +1031,7 @@ found:
             if ((flags & TCP_ACKDATA) != 0 && conn->unacked == 0)
               {
                 conn->tcpstateflags = TCP_TIME_WAIT;
-                conn->timer         = 0;
+                tcp_settimer(conn, 0);
                 ninfo("TCP state: TCP_TIME_WAIT\n");
               }
             else
@@ -963,6 +1048,7 @@ found:
         else if ((flags & TCP_ACKDATA) != 0 && conn->unacked == 0)
           {
             conn->tcpstateflags = TCP_FIN_WAIT_2;
+            tcp_timer_arm(conn);
             ninfo("TCP state: TCP_FIN_WAIT_2\n");
             goto drop;
           }
@@ -984,7 +1070,7 @@ found:
         if ((tcp->flags & TCP_FIN) != 0)
           {
             conn->tcpstateflags = TCP_TIME_WAIT;
-            conn->timer         = 0;
+            tcp_settimer(conn, 0);
             ninfo("TCP state: TCP_TIME_WAIT\n");
 
             net_incr32(conn->rcvseq, 1);
@@ -1009,7 +1095,7 @@ found:
         if ((flags & TCP_ACKDATA) != 0)
           {
             conn->tcpstateflags = TCP_TIME_WAIT;
-            conn->timer        = 0;
+            tcp_settimer(conn, 0);
             ninfo("TCP state: TCP_TIME_WAIT\n");
           }
 
@@ -58,9 +58,18 @@
  * Private Data
  ****************************************************************************/
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+/* The currently listening connections hashed by local port and the number
+ * of listening connections.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_listenhash[CONFIG_NET_TCP_HASHSIZE];
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -83,6 +92,25 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine the connections in the hash chain of the port */
+
+  for (conn = g_tcp_listenhash[TCP_PORT_HASH(portno)];
+       conn != NULL;
+       conn = conn->hnext)
+    {
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (conn->lport == portno && conn->domain == domain)
+#else
+      if (conn->lport == portno)
+#endif
+        {
+          return conn;
+        }
+    }
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -105,6 +133,7 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
           return conn;
         }
     }
+#endif
 
   /* No listener for this port */
 
@@ -129,11 +158,21 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 
 void tcp_listen_initialize(void)
 {
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  int ndx;
+  for (ndx = 0; ndx < CONFIG_NET_TCP_HASHSIZE; ndx++)
+    {
+      g_tcp_listenhash[ndx] = NULL;
+    }
+
+  g_tcp_nlisteners = 0;
+#else
   int ndx;
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       tcp_listenports[ndx] = NULL;
     }
+#endif
 }
 
 /****************************************************************************
@@ -149,10 +188,28 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  FAR struct tcp_conn_s **next;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   net_lock();
+#if CONFIG_NET_TCP_HASHSIZE > 0
+  for (next = &g_tcp_listenhash[TCP_PORT_HASH(conn->lport)];
+       *next != NULL;
+       next = &(*next)->hnext)
+    {
+      if (*next == conn)
+        {
+          *next = conn->hnext;
+          g_tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -162,6 +219,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -209,6 +267,18 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#if CONFIG_NET_TCP_HASHSIZE > 0
+      /* Add the connection to the hash chain of its port */
+
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          ndx = TCP_PORT_HASH(conn->lport);
+          conn->hnext = g_tcp_listenhash[ndx];
+          g_tcp_listenhash[ndx] = conn;
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -224,6 +294,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
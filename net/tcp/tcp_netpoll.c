@@ -45,6 +45,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
@@ -145,14 +146,19 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
 
       if (eventset != 0)
         {
-          /* Stop further callbacks */
+          /* Stop further callbacks.  poll() is awakened only once but
+           * epoll keeps its registration until it is torn down.
+           */
 
-          info->cb->flags   = 0;
-          info->cb->priv    = NULL;
-          info->cb->event   = NULL;
+          if (info->fds->cb == NULL)
+            {
+              info->cb->flags = 0;
+              info->cb->priv  = NULL;
+              info->cb->event = NULL;
+            }
 
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -208,7 +214,7 @@ static inline void tcp_iob_work(FAR void *arg)
            */
 
           fds->revents |= (POLLERR | POLLHUP);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
@@ -226,7 +232,7 @@ static inline void tcp_iob_work(FAR void *arg)
           /* Yes.. then signal the poll logic */
 
           fds->revents |= POLLWRNORM;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
       else
         {
@@ -264,6 +270,10 @@ static inline void tcp_poll_txnotify(FAR struct socket *psock)
 {
   FAR struct tcp_conn_s *conn = psock->s_conn;
 
+  /* Have the connection polled */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -449,7 +459,7 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * net/tcp/tcp_recviob.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <semaphore.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_USRSOCK
+#  include "usrsock/usrsock.h"
+#endif
+
+#ifdef CONFIG_NET_TCP_RECVIOB
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a thread waiting for read-ahead data */
+
+struct tcp_recviob_s
+{
+  sem_t ri_sem;                 /* Posted when data or an event arrives */
+  bool ri_posted;               /* True: ri_sem has been posted */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_recviob_eventhandler
+ *
+ * Description:
+ *   Wake up the waiting thread when new data arrives or the connection is
+ *   lost.  The new data is not consumed here:  It is left to be queued in
+ *   the read-ahead buffers where the woken up thread will find it.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_recviob_eventhandler(FAR struct net_driver_s *dev,
+                                         FAR void *pvconn, FAR void *pvpriv,
+                                         uint16_t flags)
+{
+  FAR struct tcp_recviob_s *pstate = (FAR struct tcp_recviob_s *)pvpriv;
+
+  if (pstate != NULL && !pstate->ri_posted &&
+      (flags & (TCP_NEWDATA | TCP_DISCONN_EVENTS)) != 0)
+    {
+      pstate->ri_posted = true;
+      nxsem_post(&pstate->ri_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: tcp_recviob_wait
+ *
+ * Description:
+ *   Wait until new data arrives, the connection is lost, or the receive
+ *   timeout expires.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int tcp_recviob_wait(FAR struct socket *psock)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  FAR struct devif_callback_s *cb;
+  struct tcp_recviob_s state;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timespec abstime;
+#endif
+  int ret;
+
+  cb = tcp_callback_alloc(conn);
+  if (cb == NULL)
+    {
+      return -EBUSY;
+    }
+
+  /* The semaphore is used for signaling and must not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_init(&state.ri_sem, 0, 0);
+  nxsem_setprotocol(&state.ri_sem, SEM_PRIO_NONE);
+  state.ri_posted = false;
+
+  cb->flags = (TCP_NEWDATA | TCP_DISCONN_EVENTS);
+  cb->priv  = (FAR void *)&state;
+  cb->event = tcp_recviob_eventhandler;
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (psock->s_rcvtimeo != 0)
+    {
+      DEBUGVERIFY(clock_gettime(CLOCK_REALTIME, &abstime));
+
+      abstime.tv_sec  += psock->s_rcvtimeo / DSEC_PER_SEC;
+      abstime.tv_nsec += (psock->s_rcvtimeo % DSEC_PER_SEC) * NSEC_PER_DSEC;
+      if (abstime.tv_nsec >= NSEC_PER_SEC)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= NSEC_PER_SEC;
+        }
+
+      ret = net_timedwait(&state.ri_sem, &abstime);
+      if (ret == -ETIMEDOUT)
+        {
+          ret = -EAGAIN;
+        }
+    }
+  else
+#endif
+    {
+      ret = net_lockedwait(&state.ri_sem);
+    }
+
+  tcp_callback_free(conn, cb);
+  nxsem_destroy(&state.ri_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Receive data from a connected TCP socket without copying it.  The
+ *   I/O buffer chain at the head of the read-ahead queue is removed from
+ *   the queue and passed to the caller, which becomes its owner and must
+ *   release it with psock_freeiob().
+ *
+ * Input Parameters:
+ *   psock - A connected TCP socket
+ *   iob   - The location to return the I/O buffer chain
+ *   flags - Receive flags.  MSG_DONTWAIT is supported.
+ *
+ * Returned Value:
+ *   The number of bytes in the returned I/O buffer chain is returned on
+ *   success.  Zero is returned, and no chain, if the peer has closed the
+ *   connection.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR struct iob_s *head;
+  ssize_t ret;
+
+  if (psock == NULL || psock->s_crefs <= 0 || iob == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (psock->s_type != SOCK_STREAM ||
+      (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+    {
+      return -EOPNOTSUPP;
+    }
+
+#ifdef CONFIG_NET_USRSOCK
+  if (psock->s_sockif == &g_usrsock_sockif)
+    {
+      return -EOPNOTSUPP;
+    }
+#endif
+
+  *iob = NULL;
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+  for (; ; )
+    {
+      /* Take the I/O buffer chain at the head of the read-ahead queue.
+       * There may be read-ahead data even after the socket has been
+       * disconnected.
+       */
+
+      head = iob_remove_queue(&conn->readahead);
+      if (head != NULL)
+        {
+          DEBUGASSERT(head->io_pktlen > 0);
+
+          ninfo("Received %d bytes\n", head->io_pktlen);
+          *iob = head;
+          ret  = head->io_pktlen;
+          break;
+        }
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          /* A graceful close by the peer is reported as end-of-file */
+
+          ret = _SS_ISCLOSED(psock->s_flags) ? 0 : -ENOTCONN;
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = tcp_recviob_wait(psock);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_freeiob
+ *
+ * Description:
+ *   Release an I/O buffer chain obtained with psock_recviob().
+ *
+ * Input Parameters:
+ *   iob - The I/O buffer chain
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void psock_freeiob(FAR struct iob_s *iob)
+{
+  if (iob != NULL)
+    {
+      iob_free_chain(iob, IOBUSER_NET_TCP_READAHEAD);
+    }
+}
+
+#endif /* CONFIG_NET_TCP_RECVIOB */
@@ -50,6 +50,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
 
+#include "netdev/netdev.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -63,18 +64,22 @@
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The connection that will advertise the window
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value of the TCP receive window to use.  This is the value of the
+ *   window field of the TCP header, i.e., it is scaled if window scaling is
+ *   in effect.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
 {
   uint16_t iplen;
   uint16_t mss;
-  uint16_t recvwndo;
+  uint32_t recvwndo;
 #ifdef CONFIG_NET_TCP_READAHEAD
   int  niob_avail;
   int  nqentry_avail;
@@ -158,14 +163,10 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
        */
 
       rwnd = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
-      if (rwnd > UINT16_MAX)
-        {
-          rwnd = UINT16_MAX;
-        }
 
       /* Save the new receive window size */
 
-      recvwndo = (uint16_t)rwnd;
+      recvwndo = rwnd;
     }
   else /* nqentry_avail == 0 || niob_avail == 0 */
 #endif
@@ -181,5 +182,122 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
       recvwndo = mss;
     }
 
-  return recvwndo;
+#if defined(CONFIG_NET_TCP_READAHEAD) && defined(CONFIG_NET_SOCKBUF)
+  /* Never offer more than the room that the unread data leaves below the
+   * SO_RCVBUF limit.
+   */
+
+  if (conn->rcvbufs > 0)
+    {
+      uint32_t queued = iob_get_queue_size(&conn->readahead);
+      uint32_t room   = conn->rcvbufs > queued ? conn->rcvbufs - queued : 0;
+
+      if (recvwndo > room)
+        {
+          recvwndo = room;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of a SYN or SYNACK segment is never scaled */
+
+  if ((conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_SENT &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_RCVD)
+    {
+      recvwndo >>= conn->rcv_wscale;
+    }
+#endif
+
+  if (recvwndo > UINT16_MAX)
+    {
+      recvwndo = UINT16_MAX;
+    }
+
+  return (uint16_t)recvwndo;
+}
+
+/****************************************************************************
+ * Name: tcp_recvwindow_consumed
+ *
+ * Description:
+ *   The application has read data from the read-ahead buffers.  If the
+ *   SO_RCVBUF limit had closed the receive window to less than one
+ *   segment and the read opened it again, poll the connection so that a
+ *   window update is sent.  Otherwise the peer would only learn about the
+ *   room with its next zero window probe.
+ *
+ * Input Parameters:
+ *   conn   - The connection
+ *   queued - The number of unread bytes before the read
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_READAHEAD) && defined(CONFIG_NET_SOCKBUF)
+void tcp_recvwindow_consumed(FAR struct tcp_conn_s *conn, uint32_t queued)
+{
+  uint32_t now;
+
+  if (conn->rcvbufs == 0 || conn->dev == NULL ||
+      queued + conn->mss <= conn->rcvbufs)
+    {
+      /* No limit or the window was open */
+
+      return;
+    }
+
+  now = iob_get_queue_size(&conn->readahead);
+  if (now + conn->mss <= conn->rcvbufs)
+    {
+      conn->rcvwndupdate = true;
+      tcp_txready(conn);
+      netdev_txnotify_dev(conn->dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_get_recvscale
+ *
+ * Description:
+ *   Return the window scale shift count to offer on the specified device.
+ *   This is the smallest shift count that can represent the largest
+ *   receive window that the read-ahead buffers support.
+ *
+ * Input Parameters:
+ *   dev - The device for the connection
+ *
+ * Returned Value:
+ *   The window scale shift count (0-TCP_WSCALE_MAX).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_recvscale(FAR struct net_driver_s *dev)
+{
+  uint8_t scale = 0;
+#ifdef CONFIG_NET_TCP_READAHEAD
+  uint32_t maxwndo;
+
+  /* The receive window can never exceed the read-ahead buffering plus one
+   * packet (see tcp_get_recvwindow()).
+   */
+
+  maxwndo = (uint32_t)CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE +
+            dev->d_pktsize;
+
+  while (scale < TCP_WSCALE_MAX && (maxwndo >> scale) > UINT16_MAX)
+    {
+      scale++;
+    }
+#endif
+
+  return scale;
 }
+#endif
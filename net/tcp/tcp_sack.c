@@ -0,0 +1,411 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_SACK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sequence number comparisons that survive wrap-around */
+
+#define SEQ_LT(a,b)  ((int32_t)((a) - (b)) < 0)
+#define SEQ_LEQ(a,b) ((int32_t)((a) - (b)) <= 0)
+#define SEQ_GT(a,b)  ((int32_t)((a) - (b)) > 0)
+#define SEQ_GEQ(a,b) ((int32_t)((a) - (b)) >= 0)
+
+/* The size of one block of the SACK option */
+
+#define TCP_SACK_BLOCKLEN 8
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sack_getseq
+ *
+ * Description:
+ *   Get a sequence number in network order from the option data.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_sack_getseq(FAR const uint8_t *ptr)
+{
+  return ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) |
+         ((uint32_t)ptr[2] << 8) | (uint32_t)ptr[3];
+}
+
+/****************************************************************************
+ * Name: tcp_sack_trim
+ *
+ * Description:
+ *   Remove the parts of the scoreboard that have been cumulatively ACKed.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_trim(FAR struct tcp_conn_s *conn, uint32_t ackseq)
+{
+  int i;
+
+  for (i = 0; i < conn->nsack && SEQ_LEQ(conn->sackblk[i].right, ackseq);
+       i++)
+    {
+    }
+
+  if (i > 0)
+    {
+      conn->nsack -= i;
+      memmove(&conn->sackblk[0], &conn->sackblk[i],
+              conn->nsack * sizeof(struct tcp_sack_s));
+    }
+
+  if (conn->nsack > 0 && SEQ_LT(conn->sackblk[0].left, ackseq))
+    {
+      conn->sackblk[0].left = ackseq;
+    }
+
+  if (SEQ_LT(conn->sackhigh, ackseq))
+    {
+      conn->sackhigh = ackseq;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_sack_add
+ *
+ * Description:
+ *   Add a SACKed range to the scoreboard, merging it with the ranges that
+ *   it overlaps or touches.  If the scoreboard is full, the highest range
+ *   is forgotten:  That data will just be retransmitted needlessly.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_add(FAR struct tcp_conn_s *conn, uint32_t left,
+                         uint32_t right)
+{
+  FAR struct tcp_sack_s *blk;
+  int i;
+
+  if (SEQ_GT(right, conn->sackhigh))
+    {
+      conn->sackhigh = right;
+    }
+
+  /* Absorb all ranges that overlap or touch the new one  */
+
+  for (i = 0; i < conn->nsack; )
+    {
+      blk = &conn->sackblk[i];
+      if (SEQ_LT(right, blk->left) || SEQ_GT(left, blk->right))
+        {
+          i++;
+          continue;
+        }
+
+      if (SEQ_LT(blk->left, left))
+        {
+          left = blk->left;
+        }
+
+      if (SEQ_GT(blk->right, right))
+        {
+          right = blk->right;
+        }
+
+      conn->nsack--;
+      memmove(blk, blk + 1, (conn->nsack - i) * sizeof(struct tcp_sack_s));
+    }
+
+  /* Find the place of the range in sequence number order */
+
+  for (i = 0; i < conn->nsack && SEQ_LT(conn->sackblk[i].left, left); i++)
+    {
+    }
+
+  if (conn->nsack >= TCP_SACK_NRANGES)
+    {
+      if (i >= conn->nsack)
+        {
+          return;
+        }
+
+      conn->nsack--;
+    }
+
+  blk = &conn->sackblk[i];
+  memmove(blk + 1, blk, (conn->nsack - i) * sizeof(struct tcp_sack_s));
+
+  blk->left  = left;
+  blk->right = right;
+  conn->nsack++;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Update the SACK scoreboard from the options of a received ACK.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   opt    - The TCP options of the received segment
+ *   optlen - The length of the TCP options
+ *   ackseq - The acknowledgement number of the received segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR const uint8_t *opt,
+                    unsigned int optlen, uint32_t ackseq)
+{
+  unsigned int i;
+  unsigned int j;
+  uint32_t left;
+  uint32_t right;
+  uint8_t len;
+
+  /* Forget about everything that has now been ACKed */
+
+  tcp_sack_trim(conn, ackseq);
+
+  for (i = 0; i < optlen; )
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      /* All other options have a length field */
+
+      if (i + 1 >= optlen)
+        {
+          break;
+        }
+
+      len = opt[i + 1];
+      if (len < 2 || i + len > optlen)
+        {
+          /* The options are malformed */
+
+          break;
+        }
+
+      if (opt[i] == TCP_OPT_SACK)
+        {
+          for (j = i + 2; j + TCP_SACK_BLOCKLEN <= i + len;
+               j += TCP_SACK_BLOCKLEN)
+            {
+              left  = tcp_sack_getseq(&opt[j]);
+              right = tcp_sack_getseq(&opt[j + 4]);
+
+              /* Ignore empty and duplicate (RFC 2883) blocks and blocks
+               * of data that has never been sent.
+               */
+
+              if (SEQ_LEQ(right, left) || SEQ_LEQ(right, ackseq) ||
+                  SEQ_GT(right, conn->sndseq_max))
+                {
+                  continue;
+                }
+
+              if (SEQ_LT(left, ackseq))
+                {
+                  left = ackseq;
+                }
+
+              ninfo("SACK: %lu-%lu\n",
+                    (unsigned long)left, (unsigned long)right);
+              tcp_sack_add(conn, left, right);
+            }
+        }
+
+      i += len;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_sack_skip
+ *
+ * Description:
+ *   Decide how much of the data at a sequence number is to be sent again by
+ *   a retransmission.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *   seq  - The sequence number of the next data to send
+ *   len  - The length of the data that is about to be sent.  Reduced so
+ *          that the segment does not run into data that need not be sent.
+ *
+ * Returned Value:
+ *   The number of bytes at 'seq' that need not be sent:  They have been
+ *   SACKed, have already been retransmitted in this fast recovery, or are
+ *   still in flight above the highest SACKed data.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_sack_skip(FAR struct tcp_conn_s *conn, uint32_t seq,
+                       FAR uint32_t *len)
+{
+  FAR struct tcp_sack_s *blk;
+  uint32_t end = seq;
+  bool sacked;
+  bool again;
+  int i;
+
+  if (!conn->sack)
+    {
+      return 0;
+    }
+
+  /* Only the data above the highest SACKed data is still in flight.  The
+   * holes below it are the data that was lost (RFC 6675).
+   */
+
+  sacked = SEQ_GT(conn->sackhigh, conn->lastack);
+
+  do
+    {
+      again = false;
+
+      for (i = 0; i < conn->nsack; i++)
+        {
+          blk = &conn->sackblk[i];
+          if (SEQ_LEQ(blk->left, end) && SEQ_LT(end, blk->right))
+            {
+              end   = blk->right;
+              again = true;
+            }
+        }
+
+      if (conn->recovery)
+        {
+          if (SEQ_LT(end, conn->rxthigh))
+            {
+              end   = conn->rxthigh;
+              again = true;
+            }
+
+          if (sacked && SEQ_GEQ(end, conn->sackhigh) &&
+              SEQ_LT(end, conn->recover))
+            {
+              end   = conn->recover;
+              again = true;
+            }
+        }
+    }
+  while (again);
+
+  if (end != seq)
+    {
+      return end - seq;
+    }
+
+  /* Stop the segment at the next SACKed range */
+
+  for (i = 0; i < conn->nsack; i++)
+    {
+      blk = &conn->sackblk[i];
+      if (SEQ_GT(blk->left, seq))
+        {
+          if (SEQ_LT(blk->left, seq + *len))
+            {
+              *len = blk->left - seq;
+            }
+
+          break;
+        }
+    }
+
+  if (conn->recovery && sacked && SEQ_LT(seq, conn->sackhigh) &&
+      SEQ_GT(seq + *len, conn->sackhigh) &&
+      SEQ_LT(conn->sackhigh, conn->recover))
+    {
+      *len = conn->sackhigh - seq;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_reset
+ *
+ * Description:
+ *   Forget the SACK scoreboard.  Called on a retransmission timeout, after
+ *   which the receiver may have discarded SACKed data (RFC 2018).
+ *
+ ****************************************************************************/
+
+void tcp_sack_reset(FAR struct tcp_conn_s *conn)
+{
+  conn->nsack    = 0;
+  conn->sackhigh = conn->lastack;
+  conn->rxthigh  = conn->lastack;
+}
+
+#endif /* CONFIG_NET_TCP_SACK */
@@ -153,7 +153,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+  if (!NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_L4))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -168,7 +171,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_IP))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -225,7 +231,10 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+  if (!NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_L4))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -311,6 +320,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                            FAR struct tcp_conn_s *conn,
                            FAR struct tcp_hdr_s *tcp)
 {
+#ifdef CONFIG_NET_TCP_INFO
+  conn->segsout++;
+#endif
+
   /* Copy the IP address into the IPv6 header */
 
 #ifdef CONFIG_NET_IPv6
@@ -342,6 +355,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   memcpy(tcp->ackno, conn->rcvseq, 4);
   memcpy(tcp->seqno, conn->sndseq, 4);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Any delayed ACK goes out with this segment */
+
+  conn->ackdelayed = false;
+#endif
+
   tcp->srcport  = conn->lport;
   tcp->destport = conn->rport;
 
@@ -360,7 +379,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     {
       /* Update the TCP received window based on I/O buffer availability */
 
-      uint16_t recvwndo = tcp_get_recvwindow(dev);
+      uint16_t recvwndo = tcp_get_recvwindow(dev, conn);
 
       /* Set the TCP Window */
 
@@ -371,6 +390,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   /* Finish the IP portion of the message and calculate checksums */
 
   tcp_sendcomplete(dev, tcp);
+
+  /* Start or restart the timer of the connection for what was just sent */
+
+  tcp_timer_arm(conn);
 }
 
 /****************************************************************************
@@ -569,6 +592,8 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack)
 {
   struct tcp_hdr_s *tcp;
+  FAR uint8_t *optdata;
+  uint16_t optlen = TCP_OPT_MSS_LEN;
   uint16_t tcp_mss;
 
   /* Get values that vary with the underlying IP domain */
@@ -585,7 +610,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       /* Set the packet length for the TCP Maximum Segment Size */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -601,7 +626,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       /* Set the packet length for the TCP Maximum Segment Size */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -611,11 +636,44 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   /* We send out the TCP Maximum Segment Size option with our ack. */
 
-  tcp->optdata[0] = TCP_OPT_MSS;
-  tcp->optdata[1] = TCP_OPT_MSS_LEN;
-  tcp->optdata[2] = tcp_mss >> 8;
-  tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optdata         = tcp->optdata;
+  optdata[0]      = TCP_OPT_MSS;
+  optdata[1]      = TCP_OPT_MSS_LEN;
+  optdata[2]      = tcp_mss >> 8;
+  optdata[3]      = tcp_mss & 0xff;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window scale option is always offered in a SYN.  It may only be
+   * sent in a SYNACK if the peer sent it in its SYN.
+   */
+
+  if ((ack & TCP_ACK) == 0 || conn->wscale)
+    {
+      conn->rcv_wscale = tcp_get_recvscale(dev);
+
+      optdata[optlen]     = TCP_OPT_NOOP;
+      optdata[optlen + 1] = TCP_OPT_WS;
+      optdata[optlen + 2] = TCP_OPT_WS_LEN;
+      optdata[optlen + 3] = conn->rcv_wscale;
+      optlen             += TCP_OPT_WS_LEN + 1;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Likewise for the SACK-permitted option */
+
+  if ((ack & TCP_ACK) == 0 || conn->sack)
+    {
+      optdata[optlen]     = TCP_OPT_NOOP;
+      optdata[optlen + 1] = TCP_OPT_NOOP;
+      optdata[optlen + 2] = TCP_OPT_SACK_PERM;
+      optdata[optlen + 3] = TCP_OPT_SACK_PERM_LEN;
+      optlen             += TCP_OPT_SACK_PERM_LEN + 2;
+    }
+#endif
+
+  dev->d_len     += optlen;
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
@@ -162,10 +162,11 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
  * Name: psock_writebuffer_notify
  *
  * Description:
- *   The TCP connection has been lost.  Free all write buffers.
+ *   Write buffers have been freed or trimmed.  Notify the waiters for
+ *   room below the SO_SNDBUF limit and, when all write buffers have been
+ *   drained, the write buffer notifier.
  *
  * Input Parameters:
- *   psock    The socket structure
  *   conn     The connection structure associated with the socket
  *
  * Returned Value:
@@ -173,9 +174,16 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_TCP_NOTIFIER
+#if defined(CONFIG_TCP_NOTIFIER) || defined(CONFIG_NET_SOCKBUF)
 static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_SOCKBUF
+  /* Wake up any senders waiting for room below the SO_SNDBUF limit */
+
+  tcp_sendbuffer_notify(conn);
+#endif
+
+#ifdef CONFIG_TCP_NOTIFIER
   /* Check if all write buffers have been sent and ACKed */
 
   if (sq_empty(&conn->write_q) && sq_empty(&conn->unacked_q))
@@ -184,6 +192,7 @@ static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 
       tcp_writebuffer_signal(conn);
     }
+#endif
 }
 #else
 #  define psock_writebuffer_notify(conn)
@@ -291,6 +300,68 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: psock_sack_skip
+ *
+ * Description:
+ *   Skip over the data at the head of the write_q that need not be sent
+ *   again because it has been SACKed or is otherwise accounted for by the
+ *   fast recovery.  The skipped data is treated as if it had been sent.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   The maximum length of the next segment so that it does not run into
+ *   data that need not be sent.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+static uint32_t psock_sack_skip(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t skip;
+  uint32_t len;
+
+  /* Write buffers that have never been sent have no sequence number yet */
+
+  while ((wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q)) !=
+         NULL && TCP_WBSEQNO(wrb) != (unsigned)-1)
+    {
+      len  = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
+      skip = tcp_sack_skip(conn, TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb), &len);
+      if (skip == 0)
+        {
+          return len;
+        }
+
+      if (skip > TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb))
+        {
+          skip = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
+        }
+
+      ninfo("SACK: wrb=%p skip %lu bytes at seqno=%u\n",
+            wrb, (unsigned long)skip, TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb));
+
+      conn->unacked   += skip;
+      conn->sent      += skip;
+      TCP_WBSENT(wrb) += skip;
+
+      if (TCP_WBSENT(wrb) >= TCP_WBPKTLEN(wrb))
+        {
+          sq_remfirst(&conn->write_q);
+          psock_insert_segment(wrb, &conn->unacked_q);
+        }
+    }
+
+  return UINT32_MAX;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -317,6 +388,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)pvconn;
   FAR struct socket *psock = (FAR struct socket *)pvpriv;
+  bool cansend;
+#ifdef CONFIG_NET_TCP_CC
+  bool fastrexmit = false;
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  uint32_t sacklen = UINT32_MAX;
+#endif
 
   /* The TCP socket is connected and, hence, should be bound to a device.
    * Make sure that the polling device is the one that we are bound to.
@@ -445,6 +523,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                   ninfo("ACK: wrb=%p seqno=%u pktlen=%u\n",
                           wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+
+#ifdef CONFIG_NET_SOCKBUF
+                  /* The trimmed bytes are room below SO_SNDBUF */
+
+                  tcp_sendbuffer_notify(conn);
+#endif
                 }
             }
         }
@@ -679,6 +763,77 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+  cansend = (flags & (TCP_POLL | TCP_REXMIT)) != 0;
+
+#ifdef CONFIG_NET_TCP_CC
+  /* With congestion control, new data is also sent in response to an ACK
+   * without data so that the ACKs clock out the data as the congestion
+   * window opens.  The packet buffer holds no received data in that case.
+   */
+
+  if ((flags & (TCP_ACKDATA | TCP_NEWDATA)) == TCP_ACKDATA &&
+      dev->d_len == 0)
+    {
+      cansend = true;
+    }
+
+  /* Perform a pending fast retransmission:  Only the first un-ACKed
+   * segment is moved back to the write_q.
+   */
+
+  if (conn->ccrexmit && cansend)
+    {
+      FAR struct tcp_wrbuffer_s *wrb;
+
+      conn->ccrexmit = false;
+
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&conn->unacked_q);
+      if (wrb != NULL)
+        {
+          psock_insert_segment(wrb, &conn->write_q);
+        }
+      else
+        {
+          /* The un-ACKed data may be at the head of the write_q */
+
+          wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+        }
+
+      if (wrb != NULL && TCP_WBSENT(wrb) > 0)
+        {
+          uint16_t sent = TCP_WBSENT(wrb);
+
+          conn->unacked   = conn->unacked > sent ? conn->unacked - sent : 0;
+          conn->sent      = conn->sent > sent ? conn->sent - sent : 0;
+          TCP_WBSENT(wrb) = 0;
+          fastrexmit      = true;
+#ifdef CONFIG_NET_TCP_INFO
+          conn->rexmits++;
+#endif
+
+          ninfo("FAST REXMIT: wrb=%p seqno=%u\n", wrb, TCP_WBSEQNO(wrb));
+        }
+    }
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Retransmit only the holes in the data that the peer has received.
+   * The skipped data counts as in flight.
+   */
+
+  if ((conn->tcpstateflags & TCP_ESTABLISHED) && cansend)
+    {
+      sacklen = psock_sack_skip(conn);
+    }
+#endif
+
+  /* Do not send new data beyond the congestion window */
+
+  if (!fastrexmit && conn->cwnd <= conn->unacked)
+    {
+      cansend = false;
+    }
+#endif
+
   /* We get here if (1) not all of the data has been ACKed, (2) we have been
    * asked to retransmit data, (3) the connection is still healthy, and (4)
    * the outgoing packet is available for our use.  In this case, we are
@@ -687,8 +842,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
    * will have to wait for the next polling cycle.
    */
 
-  if ((conn->tcpstateflags & TCP_ESTABLISHED) &&
-      (flags & (TCP_POLL | TCP_REXMIT)) &&
+  if ((conn->tcpstateflags & TCP_ESTABLISHED) && cansend &&
       !(sq_empty(&conn->write_q)) &&
       conn->winsize > 0)
     {
@@ -713,7 +867,23 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
       if (sndlen > conn->mss)
         {
-          sndlen = conn->mss;
+#ifdef CONFIG_NETDEV_OFFLOAD
+          /* A TSO device accepts a multiple of the MSS in one packet */
+
+          if (NETDEV_OFFLOAD(dev, NETDEV_TSO) && dev->d_tsomax > conn->mss)
+            {
+              uint16_t maxseg = dev->d_tsomax - dev->d_tsomax % conn->mss;
+
+              if (sndlen > maxseg)
+                {
+                  sndlen = maxseg;
+                }
+            }
+          else
+#endif
+            {
+              sndlen = conn->mss;
+            }
         }
 
       if (sndlen > conn->winsize)
@@ -721,10 +891,35 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           sndlen = conn->winsize;
         }
 
+#ifdef CONFIG_NET_TCP_CC
+      /* A fast retransmission is not limited by the congestion window, but
+       * it is a single segment.
+       */
+
+      if (fastrexmit)
+        {
+          if (sndlen > conn->mss)
+            {
+              sndlen = conn->mss;
+            }
+        }
+      else if (sndlen > conn->cwnd - conn->unacked)
+        {
+          sndlen = conn->cwnd - conn->unacked;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+      if (sndlen > sacklen)
+        {
+          sndlen = sacklen;
+        }
+#endif
+
       ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u mss=%u "
-            "winsize=%u\n",
+            "winsize=%lu\n",
             wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen, conn->mss,
-            conn->winsize);
+            (unsigned long)conn->winsize);
 
       /* Set the sequence number for this segment.  If we are
        * retransmitting, then the sequence number will already
@@ -770,6 +965,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       conn->unacked += sndlen;
       conn->sent    += sndlen;
 
+#ifdef CONFIG_NET_TCP_SACK
+      /* Remember how far the retransmissions of a fast recovery went */
+
+      if (conn->recovery &&
+          (int32_t)(tcp_getsequence(conn->sndseq) + sndlen -
+                    conn->rxthigh) > 0)
+        {
+          conn->rxthigh = tcp_getsequence(conn->sndseq) + sndlen;
+        }
+#endif
+
       /* Below prediction will become true, unless retransmission occurrence */
 
       predicted_seqno = tcp_getsequence(conn->sndseq) + sndlen;
@@ -843,6 +1049,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Have the connection polled */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -1000,11 +1210,40 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+#ifdef CONFIG_NET_SOCKBUF
+      /* Wait while the data buffered for the connection has reached the
+       * SO_SNDBUF limit.  A single send() may exceed the limit.
+       */
+
+      while (conn->sndbufs > 0 &&
+             tcp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+        {
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_lockedwait(&conn->sndsem);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+
+          if (!_SS_ISCONNECTED(psock->s_flags))
+            {
+              ret = -ENOTCONN;
+              goto errout_with_lock;
+            }
+        }
+#endif
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           wrb = tcp_wrbuffer_tryalloc();
@@ -1183,6 +1422,10 @@ errout:
 
 int psock_tcp_cansend(FAR struct socket *psock)
 {
+#ifdef CONFIG_NET_SOCKBUF
+  FAR struct tcp_conn_s *conn;
+#endif
+
   /* Verify that we received a valid socket */
 
   if (!psock || psock->s_crefs <= 0)
@@ -1213,6 +1456,16 @@ int psock_tcp_cansend(FAR struct socket *psock)
       return -EWOULDBLOCK;
     }
 
+#ifdef CONFIG_NET_SOCKBUF
+  /* Nor can we send while the SO_SNDBUF limit is reached */
+
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  if (conn->sndbufs > 0 && tcp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+    {
+      return -EWOULDBLOCK;
+    }
+#endif
+
   return OK;
 }
 
@@ -373,6 +373,9 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
             }
 
           dev->d_sndlen = sndlen;
+#ifdef CONFIG_NET_CHKSUM_COPY
+          dev->d_sndsumlen = 0;
+#endif
 
           /* Set the sequence number for this packet.  NOTE:  The network
            * updates sndseq on recept of ACK *before* this function is
@@ -459,6 +462,10 @@ wait:
 static inline void sendfile_txnotify(FAR struct socket *psock,
                                      FAR struct tcp_conn_s *conn)
 {
+  /* Have the connection polled */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
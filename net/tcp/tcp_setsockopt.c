@@ -51,6 +51,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/tcp.h>
 
+#include "netdev/netdev.h"
 #include "socket/socket.h"
 #include "utils/utils.h"
 #include "tcp/tcp.h"
@@ -88,9 +89,10 @@
 int tcp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
-   * supported.
+#if defined(CONFIG_NET_TCP_KEEPALIVE) || defined(CONFIG_NET_TCP_CC) || \
+    defined(CONFIG_NET_TCP_DELAYED_ACK)
+  /* Keep alive options, the congestion control and delayed ACKs are the
+   * only TCP protocol socket options currently supported.
    */
 
   FAR struct tcp_conn_s *conn;
@@ -110,10 +112,11 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
       return -ENOTCONN;
     }
 
-  /* Handle the Keep-Alive option */
+  /* Handle the TCP-protocol options */
 
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -251,6 +254,47 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
               }
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Select the congestion control algorithm */
+        if (value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            net_lock();
+            ret = tcp_cc_select(conn, (FAR const char *)value, value_len);
+            net_unlock();
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      case TCP_QUICKACK: /* ACK every segment at once */
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            net_lock();
+            conn->quickack = *(FAR int *)value != 0;
+
+            /* Send any delayed ACK now */
+
+            if (conn->quickack && conn->ackdelayed && conn->dev != NULL)
+              {
+                tcp_txready(conn);
+                netdev_txnotify_dev(conn->dev);
+              }
+
+            net_unlock();
+            ret = OK;
+          }
+        break;
+#endif
 
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
@@ -258,10 +302,21 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
         break;
     }
 
+#if defined(CONFIG_NET_TCP_KEEPALIVE) && defined(CONFIG_NET_TCP_CONNTIMER)
+  /* The keep-alive timer depends on the new keep-alive options */
+
+  if (ret == OK)
+    {
+      net_lock();
+      tcp_timer_arm(conn);
+      net_unlock();
+    }
+#endif
+
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
+#endif /* CONFIG_NET_TCP_KEEPALIVE || CONFIG_NET_TCP_CC || ... */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
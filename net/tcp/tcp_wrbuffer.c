@@ -294,4 +294,68 @@ int tcp_wrbuffer_test(void)
   return ret;
 }
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of the
+ *   connection:  The unsent data and the sent, but un-ACKed data.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKBUF
+uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+  uint32_t total = 0;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      total += TCP_WBPKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+    }
+
+  for (entry = sq_peek(&conn->write_q); entry; entry = sq_next(entry))
+    {
+      total += TCP_WBPKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: tcp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up the senders waiting for room in the write buffers of the
+ *   connection if the buffered data is below the SO_SNDBUF limit.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn)
+{
+  int val = 0;
+
+  if (nxsem_getvalue(&conn->sndsem, &val) < 0 || val >= 0)
+    {
+      return;
+    }
+
+  if (conn->sndbufs == 0 || tcp_wrbuffer_inqueue_size(conn) < conn->sndbufs)
+    {
+      /* Each waiter tests the limit again */
+
+      for (; val < 0; val++)
+        {
+          nxsem_post(&conn->sndsem);
+        }
+    }
+}
+#endif /* CONFIG_NET_SOCKBUF */
+
 #endif /* CONFIG_NET_TCP && CONFIG_NET_TCP_WRITE_BUFFERS */
@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
@@ -65,6 +66,18 @@
 
 #define NET_UDP_HAVE_STACK 1
 
+/* Number of buckets in the hash table of bound local ports.  Zero means
+ * that the connections are searched linearly.
+ */
+
+#ifndef CONFIG_NET_UDP_HASHSIZE
+#  define CONFIG_NET_UDP_HASHSIZE 0
+#endif
+
+/* Hash a local port number.  The port number is in network order. */
+
+#define UDP_PORT_HASH(p) (((p) ^ ((p) >> 8)) % CONFIG_NET_UDP_HASHSIZE)
+
 /* Conditions for support UDP poll/select operations */
 
 #ifdef CONFIG_NET_UDP_READAHEAD
@@ -92,8 +105,10 @@
 /* Definitions for the UDP connection struct flag field */
 
 #define _UDP_FLAG_CONNECTMODE (1 << 0) /* Bit 0:  UDP connection-mode */
+#define _UDP_FLAG_REUSEPORT   (1 << 1) /* Bit 1:  UDP_REUSEPORT is set */
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
+#define _UDP_ISREUSEPORT(f)   (((f) & _UDP_FLAG_REUSEPORT) != 0)
 
 /****************************************************************************
  * Public Type Definitions
@@ -126,6 +141,14 @@ struct udp_conn_s
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
 
+#if CONFIG_NET_UDP_HASHSIZE > 0
+  /* Supports the singly linked hash table chains.  A connection is in the
+   * chain of its local port while the local port is non-zero.
+   */
+
+  FAR struct udp_conn_s *hnext;
+#endif
+
 #ifdef CONFIG_NET_UDP_BINDTODEVICE
   uint8_t  boundto;       /* Index of the interface we are bound to.
                            * Unbound: 0, Bound: 1-MAX_IFINDEX */
@@ -139,6 +162,10 @@ struct udp_conn_s
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_SOCKBUF
+  uint32_t rcvbufs;               /* SO_RCVBUF limit of the read-ahead
+                                   * data (bytes).  Zero:  No limit */
+#endif
 #endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -150,6 +177,17 @@ struct udp_conn_s
 
   sq_queue_t write_q;             /* Write buffering for UDP packets */
   FAR struct net_driver_s *dev;   /* Last device */
+#ifdef CONFIG_NET_IPFRAG
+  uint16_t fragoff;               /* Bytes of the head datagram already
+                                   * sent in IP fragments */
+  uint32_t fragid;                /* IP identification of those fragments */
+#endif
+#ifdef CONFIG_NET_SOCKBUF
+  uint32_t sndbufs;               /* SO_SNDBUF limit of the write buffers
+                                   * (bytes).  Zero:  No limit */
+  sem_t    sndsem;                /* Senders waiting for room in the write
+                                   * buffers */
+#endif
 #endif
 };
 
@@ -381,6 +419,50 @@ int psock_udp_cansend(FAR struct socket *psock);
 
 void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_fragment_needed
+ *
+ * Description:
+ *   Return true if a datagram of 'len' bytes of payload does not fit into
+ *   one packet on the device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_NET_IPFRAG)
+bool udp_fragment_needed(FAR struct net_driver_s *dev,
+                         FAR struct udp_conn_s *conn, unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: udp_fragment_send
+ *
+ * Description:
+ *   Set up the next IP fragment of the datagram in the IOB chain 'iob' in
+ *   the device buffer.  The first fragment carries the UDP header.  The
+ *   progress is kept in the connection structure, so one fragment is sent
+ *   per call.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The UDP connection structure
+ *   iob  - The payload of the datagram
+ *
+ * Returned Value:
+ *   True if the last fragment of the datagram was set up.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_NET_IPFRAG)
+bool udp_fragment_send(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn, FAR struct iob_s *iob);
+#endif
+
 /****************************************************************************
  * Name: udp_setsockopt
  *
@@ -479,6 +561,38 @@ void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb);
 int udp_wrbuffer_test(void);
 #endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: udp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of the
+ *   connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_NET_SOCKBUF)
+uint32_t udp_wrbuffer_inqueue_size(FAR struct udp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: udp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up the senders waiting for room in the write buffers of the
+ *   connection if the buffered data is below the SO_SNDBUF limit.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_NET_SOCKBUF)
+void udp_sendbuffer_notify(FAR struct udp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_dump
  *
@@ -99,6 +99,17 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   FAR void  *src_addr;
   uint8_t src_addr_size;
 
+#ifdef CONFIG_NET_SOCKBUF
+  /* Drop the datagram if it does not fit below the SO_RCVBUF limit */
+
+  if (conn->rcvbufs > 0 &&
+      iob_get_queue_size(&conn->readahead) + buflen > conn->rcvbufs)
+    {
+      ninfo("Dropped %d bytes: SO_RCVBUF limit reached\n", buflen);
+      return 0;
+    }
+#endif
+
   /* Allocate on I/O buffer to start the chain (throttling as necessary).
    * We will not wait for an I/O buffer to become available in this context.
    */
@@ -45,6 +45,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -55,6 +56,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/semaphore.h>
+#include <nuttx/mm/mempool.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -73,6 +75,17 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Traverse the connections that may be bound to a local port */
+
+#if CONFIG_NET_UDP_HASHSIZE > 0
+#  define UDP_ACTIVE_FIRST(p) g_udp_hash[UDP_PORT_HASH(p)]
+#  define UDP_ACTIVE_NEXT(c)  ((c)->hnext)
+#else
+#  define UDP_ACTIVE_FIRST(p) \
+     ((FAR struct udp_conn_s *)g_active_udp_connections.head)
+#  define UDP_ACTIVE_NEXT(c)  ((FAR struct udp_conn_s *)(c)->node.flink)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -81,15 +94,23 @@
 
 struct udp_conn_s g_udp_connections[CONFIG_NET_UDP_CONNS];
 
-/* A list of all free UDP connections */
+/* The pool of all free UDP connections.  The pool does not grow:
+ * udp_find_conn() scans g_udp_connections[] directly.
+ */
 
-static dq_queue_t g_free_udp_connections;
+static struct mempool_s g_udp_connpool;
 static sem_t g_free_sem;
 
 /* A list of all allocated UDP connections */
 
 static dq_queue_t g_active_udp_connections;
 
+#if CONFIG_NET_UDP_HASHSIZE > 0
+/* The hash table of the connections bound to a local port */
+
+static FAR struct udp_conn_s *g_udp_hash[CONFIG_NET_UDP_HASHSIZE];
+#endif
+
 /* Last port used by a UDP connection connection. */
 
 static uint16_t g_last_udp_port;
@@ -130,7 +151,9 @@ static inline void _udp_semtake(FAR sem_t *sem)
  * Name: udp_find_conn()
  *
  * Description:
- *   Find the UDP connection that uses this local port number.
+ *   Find the UDP connection that uses this local port number.  If
+ *   'reuseport' is true, connections that set UDP_REUSEPORT are ignored:
+ *   They may share the port with the caller.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -139,9 +162,18 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
-                                            uint16_t portno)
+                                            uint16_t portno, bool reuseport)
 {
   FAR struct udp_conn_s *conn;
+#if CONFIG_NET_UDP_HASHSIZE > 0
+
+  /* Only the connections in the hash chain of the port can match */
+
+  for (conn = g_udp_hash[UDP_PORT_HASH(portno)];
+       conn != NULL;
+       conn = conn->hnext)
+    {
+#else
   int i;
 
   /* Now search each connection structure. */
@@ -149,6 +181,16 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       conn = &g_udp_connections[i];
+#endif
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+      if (reuseport && _UDP_ISREUSEPORT(conn->flags))
+        {
+          continue;
+        }
+#else
+      UNUSED(reuseport);
+#endif
 
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
@@ -232,7 +274,7 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
           g_last_udp_port = 4096;
         }
     }
-  while (udp_find_conn(domain, u, htons(g_last_udp_port)) != NULL);
+  while (udp_find_conn(domain, u, htons(g_last_udp_port), false) != NULL);
 
   /* Initialize and return the connection structure, bind it to the
    * port number
@@ -244,6 +286,153 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
   return portno;
 }
 
+/****************************************************************************
+ * Name: udp_set_lport
+ *
+ * Description:
+ *   Set the local port number of the connection and move the connection to
+ *   the hash chain of the new port.  A port number of zero unbinds the
+ *   connection.
+ *
+ ****************************************************************************/
+
+static void udp_set_lport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_UDP_HASHSIZE > 0
+  FAR struct udp_conn_s **bucket;
+
+  net_lock();
+  if (conn->lport != 0)
+    {
+      for (bucket = &g_udp_hash[UDP_PORT_HASH(conn->lport)];
+           *bucket != NULL;
+           bucket = &(*bucket)->hnext)
+        {
+          if (*bucket == conn)
+            {
+              *bucket = conn->hnext;
+              break;
+            }
+        }
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      bucket      = &g_udp_hash[UDP_PORT_HASH(portno)];
+      conn->hnext = *bucket;
+      *bucket     = conn;
+    }
+
+  net_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_peer
+ *
+ * Description:
+ *   Return true if 'conn' shares the bound address and port of 'first' by
+ *   means of UDP_REUSEPORT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+static bool udp_reuseport_peer(FAR struct udp_conn_s *first,
+                               FAR struct udp_conn_s *conn)
+{
+  if (conn->lport != first->lport || !_UDP_ISREUSEPORT(conn->flags) ||
+      _UDP_ISCONNECTMODE(conn->flags))
+    {
+      return false;
+    }
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn->domain != first->domain)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (first->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, first->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, first->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   'first' is the first connection that matches a received datagram and
+ *   it has UDP_REUSEPORT set.  Select one of the connections that share its
+ *   address and port by the hash of the source address and port of the
+ *   datagram.  All datagrams of one flow are delivered to the same
+ *   connection for as long as the set of connections does not change.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *
+  udp_reuseport_select(FAR struct udp_conn_s *first,
+                       FAR const uint16_t *srcipaddr, int nwords,
+                       uint16_t srcport)
+{
+  FAR struct udp_conn_s *conn;
+  uint32_t hash = srcport;
+  int nconns = 0;
+  int i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = hash * 31 + srcipaddr[i];
+    }
+
+  hash ^= hash >> 16;
+
+  /* Count the connections that share the port */
+
+  for (conn = first; conn != NULL; conn = UDP_ACTIVE_NEXT(conn))
+    {
+      if (udp_reuseport_peer(first, conn))
+        {
+          nconns++;
+        }
+    }
+
+  /* And pick one of them */
+
+  hash %= nconns;
+  for (conn = first; conn != NULL; conn = UDP_ACTIVE_NEXT(conn))
+    {
+      if (udp_reuseport_peer(first, conn) && hash-- == 0)
+        {
+          break;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_UDP_REUSEPORT */
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -266,7 +455,7 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  conn = UDP_ACTIVE_FIRST(udp->destport);
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -379,9 +568,17 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = UDP_ACTIVE_NEXT(conn);
     }
 
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  if (conn != NULL && _UDP_ISREUSEPORT(conn->flags) &&
+      !_UDP_ISCONNECTMODE(conn->flags))
+    {
+      conn = udp_reuseport_select(conn, ip->srcipaddr, 2, udp->srcport);
+    }
+#endif
+
   return conn;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -405,7 +602,7 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  conn = UDP_ACTIVE_FIRST(udp->destport);
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -518,9 +715,17 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = UDP_ACTIVE_NEXT(conn);
     }
 
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  if (conn != NULL && _UDP_ISREUSEPORT(conn->flags) &&
+      !_UDP_ISCONNECTMODE(conn->flags))
+    {
+      conn = udp_reuseport_select(conn, ip->srcipaddr, 8, udp->srcport);
+    }
+#endif
+
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
@@ -544,18 +749,22 @@ void udp_initialize(void)
 
   /* Initialize the queues */
 
-  dq_init(&g_free_udp_connections);
   dq_init(&g_active_udp_connections);
   nxsem_init(&g_free_sem, 0, 1);
 
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
-      /* Mark the connection closed and move it to the free list */
+      /* Mark the connection closed */
 
       g_udp_connections[i].lport = 0;
-      dq_addlast(&g_udp_connections[i].node, &g_free_udp_connections);
     }
 
+  /* And move them all to the free pool */
+
+  (void)mempool_initialize(&g_udp_connpool, "udpconn", g_udp_connections,
+                           sizeof(struct udp_conn_s), CONFIG_NET_UDP_CONNS,
+                           0, 0);
+
   g_last_udp_port = 1024;
 }
 
@@ -575,7 +784,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
   /* The free list is protected by a semaphore (that behaves like a mutex). */
 
   _udp_semtake(&g_free_sem);
-  conn = (FAR struct udp_conn_s *)dq_remfirst(&g_free_udp_connections);
+  conn = (FAR struct udp_conn_s *)mempool_alloc(&g_udp_connpool);
   if (conn)
     {
       /* Make sure that the connection is marked as uninitialized */
@@ -595,6 +804,25 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
       sq_init(&conn->write_q);
 #endif
+
+#ifdef CONFIG_NET_SOCKBUF
+      /* Set the default buffer limits */
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+      conn->rcvbufs = CONFIG_NET_RECV_BUFSIZE;
+#endif
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      conn->sndbufs = CONFIG_NET_SEND_BUFSIZE;
+
+      /* The semaphore is used for signaling and must not have priority
+       * inheritance enabled.
+       */
+
+      nxsem_init(&conn->sndsem, 0, 0);
+      nxsem_setprotocol(&conn->sndsem, SEM_PRIO_NONE);
+#endif
+#endif
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->node, &g_active_udp_connections);
@@ -624,7 +852,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+  udp_set_lport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -644,11 +872,15 @@ void udp_free(FAR struct udp_conn_s *conn)
     {
       udp_wrbuffer_release(wrbuffer);
     }
+
+#ifdef CONFIG_NET_SOCKBUF
+  nxsem_destroy(&conn->sndsem);
+#endif
 #endif
 
   /* Free the connection */
 
-  dq_addlast(&conn->node, &g_free_udp_connections);
+  mempool_free(&g_udp_connpool, conn);
   _udp_semgive(&g_free_sem);
 }
 
@@ -775,8 +1007,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
-      ret         = OK;
+      udp_set_lport(conn, htons(udp_select_port(conn->domain, &conn->u)));
+      ret = OK;
     }
   else
     {
@@ -786,16 +1018,17 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
       /* Is any other UDP connection already bound to this address and port? */
 
-      if (udp_find_conn(conn->domain, &conn->u, portno) == NULL)
+      if (udp_find_conn(conn->domain, &conn->u, portno,
+                        _UDP_ISREUSEPORT(conn->flags)) == NULL)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
-          ret         = OK;
+          udp_set_lport(conn, portno);
+          ret = OK;
         }
       else
         {
-          ret         = -EADDRINUSE;
+          ret = -EADDRINUSE;
         }
 
       net_unlock();
@@ -843,7 +1076,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_set_lport(conn, htons(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
@@ -107,6 +107,15 @@ void udp_poll(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
           udp_send(dev, conn);
           return;
         }
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_NET_IPFRAG)
+      /* Or it may have set up a complete IP fragment */
+
+      if (dev->d_len > 0)
+        {
+          return;
+        }
+#endif
     }
 
   /* Make sure that d_len is zero meaning that there is nothing to be sent */
@@ -0,0 +1,417 @@
+/****************************************************************************
+ * net/udp/udp_fragment.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/ipv6ext.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "inet/inet.h"
+#include "utils/utils.h"
+#include "udp/udp.h"
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_NET_IPFRAG)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF \
+  ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF \
+  ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define FRAGIPv6BUF \
+  ((FAR struct ipv6_fragment_extension_s *) \
+   &dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
+
+/* The size of the IP header(s) of a fragment */
+
+#ifdef CONFIG_NET_IPv4
+#  define IPv4FRAG_HDRLEN  IPv4_HDRLEN
+#else
+#  define IPv4FRAG_HDRLEN  0
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  define IPv6FRAG_HDRLEN  (IPv6_HDRLEN + \
+                            sizeof(struct ipv6_fragment_extension_s))
+#else
+#  define IPv6FRAG_HDRLEN  0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+/* The identification of the last fragmented IPv6 datagram */
+
+static uint32_t g_ipv6_fragid;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_fragment_ipv4
+ *
+ * Description:
+ *   Return true if the datagrams of the connection are sent over IPv4.
+ *
+ ****************************************************************************/
+
+static inline bool udp_fragment_ipv4(FAR struct udp_conn_s *conn)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  return conn->domain == PF_INET ||
+         (conn->domain == PF_INET6 &&
+          ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr));
+#elif defined(CONFIG_NET_IPv4)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_fragment_chksum
+ *
+ * Description:
+ *   Calculate the UDP checksum of the whole datagram.  The IP header of the
+ *   first fragment is already in the device buffer.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the IP header
+ *   udp    - The UDP header with a zero checksum
+ *   iob    - The payload of the datagram
+ *   ipv4   - True for IPv4, false for IPv6
+ *
+ * Returned Value:
+ *   The checksum in network byte order, before complementing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CHECKSUMS
+static uint16_t udp_fragment_chksum(FAR struct net_driver_s *dev,
+                                    FAR struct udp_hdr_s *udp,
+                                    FAR struct iob_s *iob, bool ipv4)
+{
+  unsigned int done = 0;
+  uint16_t udplen = iob->io_pktlen + UDP_HDRLEN;
+  uint16_t sum;
+  uint16_t t;
+
+  /* Sum the pseudo-header.  IP protocol and length fields cannot carry. */
+
+  sum = udplen + IP_PROTO_UDP;
+
+#ifdef CONFIG_NET_IPv4
+  if (ipv4)
+    {
+      sum = chksum(sum, (FAR uint8_t *)&IPv4BUF->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!ipv4)
+    {
+      sum = chksum(sum, (FAR uint8_t *)IPv6BUF->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+#endif
+
+  /* Then the UDP header and the payload.  A piece of the payload that
+   * starts at an odd position contributes with its bytes swapped.
+   */
+
+  sum = chksum(sum, (FAR uint8_t *)udp, UDP_HDRLEN);
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      t = chksum(0, &iob->io_data[iob->io_offset], iob->io_len);
+      if ((done & 1) != 0)
+        {
+          t = (t << 8) | (t >> 8);
+        }
+
+      sum += t;
+      if (sum < t)
+        {
+          sum++; /* carry */
+        }
+
+      done += iob->io_len;
+    }
+
+  return (sum == 0) ? 0xffff : htons(sum);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_fragment_needed
+ *
+ * Description:
+ *   Return true if a datagram of 'len' bytes of payload does not fit into
+ *   one packet on the device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool udp_fragment_needed(FAR struct net_driver_s *dev,
+                         FAR struct udp_conn_s *conn, unsigned int len)
+{
+  uint16_t iplen;
+
+  iplen = udp_fragment_ipv4(conn) ? IPv4FRAG_HDRLEN :
+          IPv6FRAG_HDRLEN - sizeof(struct ipv6_fragment_extension_s);
+  return len > UDP_MSS(dev, iplen);
+}
+
+/****************************************************************************
+ * Name: udp_fragment_send
+ *
+ * Description:
+ *   Set up the next IP fragment of the datagram in the IOB chain 'iob' in
+ *   the device buffer.  The first fragment carries the UDP header.  The
+ *   progress is kept in the connection structure, so one fragment is sent
+ *   per call.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The UDP connection structure
+ *   iob  - The payload of the datagram
+ *
+ * Returned Value:
+ *   True if the last fragment of the datagram was set up.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool udp_fragment_send(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn, FAR struct iob_s *iob)
+{
+  FAR uint8_t *data;
+  uint16_t udplen = iob->io_pktlen + UDP_HDRLEN;
+  uint16_t offset = conn->fragoff;
+  uint16_t fraglen;
+  uint16_t maxlen;
+  uint16_t iplen;
+  bool ipv4 = udp_fragment_ipv4(conn);
+  bool more = false;
+
+  /* All but the last fragment carry a multiple of 8 bytes */
+
+  iplen   = ipv4 ? IPv4FRAG_HDRLEN : IPv6FRAG_HDRLEN;
+  maxlen  = (NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - iplen) & ~7;
+  fraglen = udplen - offset;
+
+  if (fraglen > maxlen)
+    {
+      fraglen = maxlen;
+      more    = true;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (ipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4hdr = IPv4BUF;
+      uint16_t ipoffset;
+
+      if (offset == 0)
+        {
+          conn->fragid = ++g_ipid;
+        }
+
+      ipoffset             = (offset >> 3) | (more ? IP_FLAG_MOREFRAGS : 0);
+
+      ipv4hdr->vhl         = 0x45;
+      ipv4hdr->tos         = 0;
+      ipv4hdr->len[0]      = (iplen + fraglen) >> 8;
+      ipv4hdr->len[1]      = (iplen + fraglen) & 0xff;
+      ipv4hdr->ipid[0]     = conn->fragid >> 8;
+      ipv4hdr->ipid[1]     = conn->fragid & 0xff;
+      ipv4hdr->ipoffset[0] = ipoffset >> 8;
+      ipv4hdr->ipoffset[1] = ipoffset & 0xff;
+      ipv4hdr->ttl         = conn->ttl;
+      ipv4hdr->proto       = IP_PROTO_UDP;
+
+      net_ipv4addr_hdrcopy(ipv4hdr->srcipaddr, &dev->d_ipaddr);
+
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain == PF_INET6)
+        {
+          in_addr_t raddr =
+            ip6_get_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr);
+          net_ipv4addr_hdrcopy(ipv4hdr->destipaddr, &raddr);
+        }
+      else
+#endif
+        {
+          net_ipv4addr_hdrcopy(ipv4hdr->destipaddr, &conn->u.ipv4.raddr);
+        }
+
+      ipv4hdr->ipchksum    = 0;
+      if (!NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_IP))
+        {
+          ipv4hdr->ipchksum = ~ipv4_chksum(dev);
+        }
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+  if (!ipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      FAR struct ipv6_fragment_extension_s *fraghdr = FRAGIPv6BUF;
+      uint16_t paylen = sizeof(struct ipv6_fragment_extension_s) + fraglen;
+
+      if (offset == 0)
+        {
+          conn->fragid = ++g_ipv6_fragid;
+        }
+
+      ipv6->vtc          = 0x60;
+      ipv6->tcf          = 0x00;
+      ipv6->flow         = 0x00;
+      ipv6->len[0]       = paylen >> 8;
+      ipv6->len[1]       = paylen & 0xff;
+      ipv6->proto        = NEXT_FRAGMENT_EH;
+      ipv6->ttl          = conn->ttl;
+
+      net_ipv6addr_copy(ipv6->srcipaddr, dev->d_ipv6addr);
+      net_ipv6addr_copy(ipv6->destipaddr, conn->u.ipv6.raddr);
+
+      fraghdr->nxthdr    = IP_PROTO_UDP;
+      fraghdr->reserved  = 0;
+      fraghdr->msoffset  = offset >> 8;
+      fraghdr->lsoffset  = (offset & 0xf8) | (more ? 0x01 : 0x00);
+      fraghdr->id[0]     = conn->fragid >> 24;
+      fraghdr->id[1]     = (conn->fragid >> 16) & 0xff;
+      fraghdr->id[2]     = (conn->fragid >> 8) & 0xff;
+      fraghdr->id[3]     = conn->fragid & 0xff;
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  /* Copy the piece of the datagram.  The first fragment starts with the
+   * UDP header, which holds the checksum of the whole datagram.  That
+   * checksum cannot be offloaded to the hardware.
+   */
+
+  data = &dev->d_buf[NET_LL_HDRLEN(dev) + iplen];
+
+  if (offset == 0)
+    {
+      struct udp_hdr_s udp;
+
+      udp.srcport   = conn->lport;
+      udp.destport  = conn->rport;
+      udp.udplen    = HTONS(udplen);
+      udp.udpchksum = 0;
+
+#ifdef CONFIG_NET_UDP_CHECKSUMS
+      udp.udpchksum = ~udp_fragment_chksum(dev, &udp, iob, ipv4);
+      if (udp.udpchksum == 0)
+        {
+          udp.udpchksum = 0xffff;
+        }
+#endif
+
+      memcpy(data, &udp, UDP_HDRLEN);
+      iob_copyout(data + UDP_HDRLEN, iob, fraglen - UDP_HDRLEN, 0);
+    }
+  else
+    {
+      iob_copyout(data, iob, fraglen, offset - UDP_HDRLEN);
+    }
+
+  ninfo("UDP fragment: offset=%u len=%u more=%d\n", offset, fraglen, more);
+
+  dev->d_len    = iplen + fraglen;
+  dev->d_sndlen = 0;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumlen = 0;
+#endif
+
+  if (more)
+    {
+      conn->fragoff = offset + fraglen;
+      return false;
+    }
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.udp.sent++;
+#endif
+
+  conn->fragoff = 0;
+  return true;
+}
+
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS && CONFIG_NET_IPFRAG */
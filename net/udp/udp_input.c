@@ -130,7 +130,11 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = &dev->d_buf[hdrlen];
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* A zero checksum is not checked.  Nor is one that the hardware has
+   * already verified.
+   */
+
+  chksum = NETDEV_OFFLOAD(dev, NETDEV_RXCSUM_L4) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
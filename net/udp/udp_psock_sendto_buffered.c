@@ -179,6 +179,12 @@ static void sendto_writebuffer_release(FAR struct socket *psock,
 
           udp_wrbuffer_release(wrb);
 
+#ifdef CONFIG_NET_IPFRAG
+          /* The next datagram starts with its first fragment */
+
+          conn->fragoff = 0;
+#endif
+
           /* Set up for the next packet transfer by setting the connection
            * address to the address of the next packet now at the header of
            * the write buffer queue.
@@ -188,6 +194,12 @@ static void sendto_writebuffer_release(FAR struct socket *psock,
         }
     }
   while (wrb != NULL && ret < 0);
+
+#ifdef CONFIG_NET_SOCKBUF
+  /* Wake up any senders waiting for room below the SO_SNDBUF limit */
+
+  udp_sendbuffer_notify(conn);
+#endif
 }
 
 /****************************************************************************
@@ -494,11 +506,31 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
       sendto_ipselect(dev, conn);
 #endif
-      /* Then set-up to send that amount of data with the offset
-       * corresponding to the size of the IP-dependent address structure.
+#ifdef CONFIG_NET_IPFRAG
+      /* A datagram that does not fit into one packet is sent in IP
+       * fragments, one per poll.
        */
 
-      devif_iob_send(dev, wrb->wb_iob, sndlen, 0);
+      if (conn->fragoff > 0 || udp_fragment_needed(dev, conn, sndlen))
+        {
+          if (!udp_fragment_send(dev, conn, wrb->wb_iob))
+            {
+              /* Poll again soon for the next fragment */
+
+              netdev_txnotify_dev(dev);
+              return flags & ~UDP_POLL;
+            }
+        }
+      else
+#endif
+        {
+          /* Then set-up to send that amount of data with the offset
+           * corresponding to the size of the IP-dependent address
+           * structure.
+           */
+
+          devif_iob_send(dev, wrb->wb_iob, sndlen, 0);
+        }
 
       /* Free the write buffer at the head of the queue and attempt to
        * setup the next transfer.
@@ -690,6 +722,17 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+#ifdef CONFIG_NET_IPFRAG
+  /* Even in fragments, the datagram is limited by the 16-bit length fields
+   * of the UDP and IPv4 headers.
+   */
+
+  if (len > UINT16_MAX - UDP_HDRLEN - IPv4_HDRLEN)
+    {
+      return -EMSGSIZE;
+    }
+#endif
+
   /* Dump the incoming buffer */
 
   BUF_DUMP("psock_udp_send", buf, len);
@@ -700,11 +743,34 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+#ifdef CONFIG_NET_SOCKBUF
+      /* Wait while the data buffered for the connection has reached the
+       * SO_SNDBUF limit.  A single datagram may exceed the limit.
+       */
+
+      while (conn->sndbufs > 0 &&
+             udp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+        {
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_lockedwait(&conn->sndsem);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+        }
+#endif
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       wrb = udp_wrbuffer_alloc();
       if (wrb == NULL)
         {
@@ -865,6 +931,10 @@ errout_with_lock:
 
 int psock_udp_cansend(FAR struct socket *psock)
 {
+#ifdef CONFIG_NET_SOCKBUF
+  FAR struct udp_conn_s *conn;
+#endif
+
   /* Verify that we received a valid socket */
 
   if (!psock || psock->s_crefs <= 0)
@@ -888,6 +958,16 @@ int psock_udp_cansend(FAR struct socket *psock)
       return -EWOULDBLOCK;
     }
 
+#ifdef CONFIG_NET_SOCKBUF
+  /* Nor can we send while the SO_SNDBUF limit is reached */
+
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+  if (conn->sndbufs > 0 && udp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+    {
+      return -EWOULDBLOCK;
+    }
+#endif
+
   return OK;
 }
 #endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
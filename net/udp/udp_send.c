@@ -164,7 +164,10 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
           /* Calculate IP checksum. */
 
           ipv4->ipchksum    = 0;
-          ipv4->ipchksum    = ~ipv4_chksum(dev);
+          if (!NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_IP))
+            {
+              ipv4->ipchksum = ~ipv4_chksum(dev);
+            }
 
 #ifdef CONFIG_NET_STATISTICS
           g_netstats.ipv4.sent++;
@@ -226,8 +229,13 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       udp->udpchksum   = 0;
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum, unless the hardware does. */
 
+      if (NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_L4))
+        {
+          /* The hardware inserts the checksum */
+        }
+      else
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
       if (conn->domain == PF_INET ||
@@ -248,7 +256,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
         }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
+      if (udp->udpchksum == 0 && !NETDEV_OFFLOAD(dev, NETDEV_TXCSUM_L4))
         {
           udp->udpchksum = 0xffff;
         }
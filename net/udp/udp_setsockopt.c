@@ -89,9 +89,9 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-#ifdef CONFIG_NET_UDP_BINDTODEVICE
-  /* Keep alive options are the only UDP protocol socket option currently
-   * supported.
+#if defined(CONFIG_NET_UDP_BINDTODEVICE) || defined(CONFIG_NET_UDP_REUSEPORT)
+  /* UDP_BINDTODEVICE and UDP_REUSEPORT are the only UDP protocol socket
+   * options currently supported.
    */
 
   FAR struct udp_conn_s *conn;
@@ -157,6 +157,38 @@ int udp_setsockopt(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_UDP_REUSEPORT
+      /* Handle the UDP_REUSEPORT option.  The option must be set on all of
+       * the sockets before they are bound to the shared address and port.
+       *
+       * NOTE: UDP_REUSEPORT is declared in linux as SO_REUSEPORT.  There
+       * is no free socket-level option bit for it in NuttX.
+       */
+
+      case UDP_REUSEPORT:  /* Share the bound address and port */
+        if (value == NULL || value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            net_lock();
+            if (*(FAR const int *)value != 0)
+              {
+                conn->flags |= _UDP_FLAG_REUSEPORT;
+              }
+            else
+              {
+                conn->flags &= ~_UDP_FLAG_REUSEPORT;
+              }
+
+            net_unlock();
+            ret = OK;
+          }
+
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized UDP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -166,7 +198,7 @@ int udp_setsockopt(FAR struct socket *psock, int option,
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_UDP_BINDTODEVICE */
+#endif /* CONFIG_NET_UDP_BINDTODEVICE || CONFIG_NET_UDP_REUSEPORT */
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
@@ -216,4 +216,63 @@ int udp_wrbuffer_test(void)
   return val > 0 ? OK : -ENOSPC;
 }
 
+/****************************************************************************
+ * Name: udp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of the
+ *   connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKBUF
+uint32_t udp_wrbuffer_inqueue_size(FAR struct udp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+  uint32_t total = 0;
+
+  for (entry = sq_peek(&conn->write_q); entry; entry = sq_next(entry))
+    {
+      total += ((FAR struct udp_wrbuffer_s *)entry)->wb_iob->io_pktlen;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: udp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up the senders waiting for room in the write buffers of the
+ *   connection if the buffered data is below the SO_SNDBUF limit.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_sendbuffer_notify(FAR struct udp_conn_s *conn)
+{
+  int val = 0;
+
+  if (nxsem_getvalue(&conn->sndsem, &val) < 0 || val >= 0)
+    {
+      return;
+    }
+
+  if (conn->sndbufs == 0 || udp_wrbuffer_inqueue_size(conn) < conn->sndbufs)
+    {
+      /* Each waiter tests the limit again */
+
+      for (; val < 0; val++)
+        {
+          nxsem_post(&conn->sndsem);
+        }
+    }
+}
+#endif /* CONFIG_NET_SOCKBUF */
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
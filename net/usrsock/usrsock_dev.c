@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <string.h>
+#include <queue.h>
 #include <poll.h>
 #include <errno.h>
 #include <assert.h>
@@ -73,6 +74,19 @@
  * Private Types
  ****************************************************************************/
 
+/* A request waiting to be read and acknowledged by the daemon.  The
+ * structure lives on the stack of the requesting thread.
+ */
+
+struct usrsockdev_req_s
+{
+  dq_entry_t node;               /* Supports a doubly linked list */
+  FAR const struct iovec *iov;   /* Request buffers */
+  int     iovcnt;                /* Number of request buffers */
+  uint8_t xid;                   /* Exchange id of the request */
+  sem_t   acksem;                /* Request acknowledgment notification */
+};
+
 struct usrsockdev_s
 {
   sem_t   devsem;     /* Lock for device node */
@@ -80,15 +94,12 @@ struct usrsockdev_s
 
   struct
   {
-    FAR const struct iovec *iov; /* Pending request buffers */
-    int     iovcnt;              /* Number of request buffers */
-    size_t  pos;                 /* Reader position on request buffer */
-    sem_t   sem;                 /* Request semaphore (only one outstanding
-                                  * request) */
-    sem_t   acksem;              /* Request acknowledgment notification */
-    uint8_t ack_xid;             /* Exchange id for which waiting ack */
-    uint16_t nbusy;              /* Number of requests blocked from different
-                                  * threads */
+    dq_queue_t pending;          /* Requests to be read by the daemon.  The
+                                  * head is the current request. */
+#ifdef CONFIG_NET_USRSOCK_BATCH
+    dq_queue_t inflight;         /* Requests read but not yet acknowledged */
+#endif
+    size_t  pos;                 /* Reader position on current request */
   } req;
 
   FAR struct usrsock_conn_s *datain_conn; /* Connection instance to receive
@@ -331,6 +342,103 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_curreq
+ *
+ * Description:
+ *   Return the request that the daemon is reading or NULL if there is no
+ *   data to be read.  With batching, a request that has been read
+ *   completely is set aside to wait for its acknowledgment and the next
+ *   request becomes current.  Otherwise, the next request is not returned
+ *   before the current one has been acknowledged.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct usrsockdev_req_s *
+usrsockdev_curreq(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  while ((req = (FAR struct usrsockdev_req_s *)
+                dq_peek(&dev->req.pending)) != NULL)
+    {
+      if (iovec_get(NULL, 0, req->iov, req->iovcnt, dev->req.pos) >= 0)
+        {
+          return req;
+        }
+
+#ifdef CONFIG_NET_USRSOCK_BATCH
+      dq_rem(&req->node, &dev->req.pending);
+      dq_addlast(&req->node, &dev->req.inflight);
+      dev->req.pos = 0;
+#else
+      break;
+#endif
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ackreq
+ *
+ * Description:
+ *   Release the thread waiting for the acknowledgment of a request.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_ackreq(FAR struct usrsockdev_s *dev,
+                              FAR dq_queue_t *queue, uint8_t xid)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  for (req = (FAR struct usrsockdev_req_s *)dq_peek(queue);
+       req != NULL;
+       req = (FAR struct usrsockdev_req_s *)dq_next(&req->node))
+    {
+      if (req->xid == xid)
+        {
+          if (queue == &dev->req.pending && dq_peek(queue) == &req->node)
+            {
+              /* This is the current request */
+
+              dev->req.pos = 0;
+            }
+
+          dq_rem(&req->node, queue);
+          nxsem_post(&req->acksem);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: usrsockdev_flushreqs
+ *
+ * Description:
+ *   Release all threads waiting for the acknowledgment of a request.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_flushreqs(FAR dq_queue_t *queue)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  while ((req = (FAR struct usrsockdev_req_s *)dq_remfirst(queue)) != NULL)
+    {
+      nxsem_post(&req->acksem);
+    }
+}
+
 /****************************************************************************
  * Name: usrsockdev_pollnotify
  ****************************************************************************/
@@ -348,7 +456,7 @@ static void usrsockdev_pollnotify(FAR struct usrsockdev_s *dev,
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -362,7 +470,9 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
   FAR struct inode        *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
+  size_t total = 0;
 
   if (len == 0)
     {
@@ -383,37 +493,33 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
   usrsockdev_semtake(&dev->devsem);
   net_lock();
 
-  /* Is request available? */
+  /* Copy the current request to user-space.  With batching, continue
+   * with the following requests while there is space in the buffer.
+   */
 
-  if (dev->req.iov)
+  while (total < len && (req = usrsockdev_curreq(dev)) != NULL)
     {
       ssize_t rlen;
 
-      /* Copy request to user-space. */
-
-      rlen = iovec_get(buffer, len, dev->req.iov, dev->req.iovcnt,
+      rlen = iovec_get(buffer + total, len - total, req->iov, req->iovcnt,
                        dev->req.pos);
-      if (rlen < 0)
-        {
-          /* Tried reading beyond buffer. */
-
-          len = 0;
-        }
-      else
+      if (rlen <= 0)
         {
-          dev->req.pos += rlen;
-          len = rlen;
+          break;
         }
-    }
-  else
-    {
-      len = 0;
+
+      dev->req.pos += rlen;
+      total        += rlen;
+
+#ifndef CONFIG_NET_USRSOCK_BATCH
+      break;
+#endif
     }
 
   net_unlock();
   usrsockdev_semgive(&dev->devsem);
 
-  return len;
+  return total;
 }
 
 /****************************************************************************
@@ -423,6 +529,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 {
   FAR struct inode        *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   off_t pos;
 
@@ -440,9 +547,12 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
   usrsockdev_semtake(&dev->devsem);
   net_lock();
 
-  /* Is request available? */
+  /* Is request available?  The position is relative to the beginning of
+   * the current request.
+   */
 
-  if (dev->req.iov)
+  req = (FAR struct usrsockdev_req_s *)dq_peek(&dev->req.pending);
+  if (req != NULL)
     {
       ssize_t rlen;
 
@@ -457,7 +567,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 
       /* Copy request to user-space. */
 
-      rlen = iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt, pos);
+      rlen = iovec_get(NULL, 0, req->iov, req->iovcnt, pos);
       if (rlen < 0)
         {
           /* Tried seek beyond buffer. */
@@ -783,16 +893,14 @@ static ssize_t usrsockdev_handle_req_response(FAR struct usrsockdev_s *dev,
       goto unlock_out;
     }
 
-  if (dev->req.ack_xid == hdr->xid && dev->req.iov)
-    {
-      /* Signal that request was received and read by daemon and
-       * acknowledgment response was received.
-       */
-
-      dev->req.iov = NULL;
+  /* Signal that request was received and read by daemon and
+   * acknowledgment response was received.
+   */
 
-      nxsem_post(&dev->req.acksem);
-    }
+  usrsockdev_ackreq(dev, &dev->req.pending, hdr->xid);
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  usrsockdev_ackreq(dev, &dev->req.inflight, hdr->xid);
+#endif
 
   ret = handle_response(dev, conn, buffer);
 
@@ -855,70 +963,91 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
 
   usrsockdev_semtake(&dev->devsem);
 
-  if (!dev->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header.
-       */
+  /* The buffer may hold several complete messages, each one possibly
+   * followed by its data.
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!dev->datain_conn)
         {
-          nwarn("message too short, %d < %d.\n", len,
-                sizeof(struct usrsock_message_common_s));
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-          ret = -EINVAL;
-          goto errout;
-        }
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %d < %d.\n", len,
+                    sizeof(struct usrsock_message_common_s));
 
-      /* Handle message. */
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Handle message. */
+
+          ret = usrsockdev_handle_message(dev, buffer, len);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      ret = usrsockdev_handle_message(dev, buffer, len);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
-          ret = origlen - len;
         }
-    }
 
-  /* Data input handling. */
+      /* Data input handling. */
 
-  if (dev->datain_conn)
-    {
-      conn = dev->datain_conn;
+      if (dev->datain_conn && len > 0)
+        {
+          conn = dev->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
-                      conn->resp.datain.pos, buffer, len);
-      if (ret < 0)
-        {
-          /* Tried writing beyond buffer. */
+          ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
+                          conn->resp.datain.pos, buffer, len);
+          if (ret < 0)
+            {
+              /* Tried writing beyond buffer. */
 
-          ret = -EINVAL;
-          conn->resp.result = -EINVAL;
-          conn->resp.datain.pos =
-              conn->resp.datain.total;
-        }
-      else
-        {
-          conn->resp.datain.pos += ret;
-          buffer += ret;
-          len -= ret;
-          ret = origlen - len;
+              ret = -EINVAL;
+              conn->resp.result = -EINVAL;
+              conn->resp.datain.pos =
+                  conn->resp.datain.total;
+            }
+          else
+            {
+              conn->resp.datain.pos += ret;
+              buffer += ret;
+              len -= ret;
+            }
         }
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
+      if (dev->datain_conn &&
+          dev->datain_conn->resp.datain.pos ==
+          dev->datain_conn->resp.datain.total)
         {
+          conn = dev->datain_conn;
           dev->datain_conn = NULL;
 
           /* Done with data response. */
 
           (void)usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
         }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+    }
+
+  /* Report the part of the buffer that was consumed, if any */
+
+  if (len < origlen)
+    {
+      ret = origlen - len;
     }
 
-errout:
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
@@ -975,7 +1104,6 @@ static int usrsockdev_close(FAR struct file *filep)
   FAR struct inode *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
   FAR struct usrsock_conn_s *conn;
-  struct timespec abstime;
   int ret;
 
   DEBUGASSERT(inode);
@@ -1012,57 +1140,15 @@ static int usrsockdev_close(FAR struct file *filep)
   DEBUGASSERT(dev->ocount == 0);
   ret = OK;
 
-  do
-    {
-      /* Give other threads short time window to complete recently completed
-       * requests.
-       */
-
-      DEBUGVERIFY(clock_gettime(CLOCK_REALTIME, &abstime));
+  /* Wake-up pending requests.  The connections were aborted above. */
 
-      abstime.tv_sec += 0;
-      abstime.tv_nsec += 10 * NSEC_PER_MSEC;
-      if (abstime.tv_nsec >= NSEC_PER_SEC)
-        {
-          abstime.tv_sec++;
-          abstime.tv_nsec -= NSEC_PER_SEC;
-        }
-
-      ret = net_timedwait(&dev->req.sem, &abstime);
-      if (ret < 0)
-        {
-          if (ret != -ETIMEDOUT && ret != -EINTR)
-            {
-              ninfo("net_timedwait errno: %d\n", ret);
-              DEBUGASSERT(false);
-            }
-        }
-      else
-        {
-          usrsockdev_semgive(&dev->req.sem);
-        }
-
-      /* Wake-up pending requests. */
-
-      if (dev->req.nbusy == 0)
-        {
-          break;
-        }
-
-      dev->req.iov = NULL;
-      nxsem_post(&dev->req.acksem);
-    }
-  while (true);
+  usrsockdev_flushreqs(&dev->req.pending);
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  usrsockdev_flushreqs(&dev->req.inflight);
+#endif
+  dev->req.pos = 0;
 
   net_unlock();
-
-  /* Check if request line is active */
-
-  if (dev->req.iov != NULL)
-    {
-      dev->req.iov = NULL;
-    }
-
   usrsockdev_semgive(&dev->devsem);
 
   return ret;
@@ -1131,9 +1217,7 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
-      if (dev->req.iov != NULL &&
-          !(iovec_get(NULL, 0, dev->req.iov,
-                      dev->req.iovcnt, dev->req.pos) < 0))
+      if (usrsockdev_curreq(dev) != NULL)
         {
           eventset |= POLLIN;
         }
@@ -1180,6 +1264,7 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
 {
   FAR struct usrsockdev_s *dev = conn->dev;
   FAR struct usrsock_request_common_s *req_head = iov[0].iov_base;
+  struct usrsockdev_req_s req;
   int ret;
 
   if (!dev)
@@ -1206,47 +1291,41 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
-  ++dev->req.nbusy; /* net_lock held. */
+  /* Queue the request for the daemon to handle.  Requests of other
+   * connections may be outstanding at the same time.
+   */
 
-  /* Set outstanding request for daemon to handle. */
+  req.iov    = iov;
+  req.iovcnt = iovcnt;
+  req.xid    = req_head->xid;
 
-  while ((ret = net_lockedwait(&dev->req.sem)) < 0)
-    {
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-    }
+  nxsem_init(&req.acksem, 0, 0);
+  nxsem_setprotocol(&req.acksem, SEM_PRIO_NONE);
 
-  if (usrsockdev_is_opened(dev))
-    {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.ack_xid = req_head->xid;
-      dev->req.iov = iov;
-      dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+  dq_addlast(&req.node, &dev->req.pending); /* net_lock held. */
 
-      /* Notify daemon of new request. */
+  /* Notify daemon of new request. */
 
-      usrsockdev_pollnotify(dev, POLLIN);
+  usrsockdev_pollnotify(dev, POLLIN);
 
-      /* Wait ack for request. */
+  /* Wait ack for request.  The request is dequeued when it is acknowledged
+   * or when the daemon closes /dev/usrsock.
+   */
 
-      while ((ret = net_lockedwait(&dev->req.acksem)) < 0)
-        {
-          DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-        }
+  while ((ret = net_lockedwait(&req.acksem)) < 0)
+    {
+      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
     }
-  else
+
+  nxsem_destroy(&req.acksem);
+
+  if (!usrsockdev_is_opened(dev))
     {
       ninfo("usockid=%d; daemon abruptly closed /dev/usrsock.\n",
             conn->usockid);
       ret = -ESHUTDOWN;
     }
 
-  /* Free request line for next command. */
-
-  usrsockdev_semgive(&dev->req.sem);
-
-  --dev->req.nbusy; /* net_lock held. */
-
   return ret;
 }
 
@@ -1263,11 +1342,12 @@ void usrsockdev_register(void)
   /* Initialize device private structure. */
 
   g_usrsockdev.ocount = 0;
-  g_usrsockdev.req.nbusy = 0;
+  g_usrsockdev.req.pos = 0;
+  dq_init(&g_usrsockdev.req.pending);
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  dq_init(&g_usrsockdev.req.inflight);
+#endif
   nxsem_init(&g_usrsockdev.devsem, 0, 1);
-  nxsem_init(&g_usrsockdev.req.sem, 0, 1);
-  nxsem_init(&g_usrsockdev.req.acksem, 0, 0);
-  nxsem_setprotocol(&g_usrsockdev.req.acksem, SEM_PRIO_NONE);
 
   (void)register_driver("/dev/usrsock", &g_usrsockdevops, 0666,
                         &g_usrsockdev);
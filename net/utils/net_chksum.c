@@ -42,6 +42,8 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -58,6 +60,198 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Fold a 32-bit one's complement sum into 16 bits */
+
+#define CHKSUM_FOLD(s) (((s) & 0xffff) + ((s) >> 16))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_words
+ *
+ * Description:
+ *   Accumulate 'nwords' aligned 32-bit words into a 32-bit partial sum in
+ *   native byte order.  Each word is added as two 16-bit halves so that the
+ *   accumulator cannot overflow for any packet size.
+ *
+ *   If CONFIG_NET_ARCH_CHKSUM32 is defined, the architecture-specific
+ *   up_chksum32() is used instead.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+#ifdef CONFIG_NET_ARCH_CHKSUM32
+#  define chksum_words(s,d,n) up_chksum32(s,d,n)
+#else
+static uint32_t chksum_words(uint32_t sum, FAR const uint32_t *data,
+                             size_t nwords)
+{
+  uint32_t w0;
+  uint32_t w1;
+  uint32_t w2;
+  uint32_t w3;
+
+  /* Four words at a time */
+
+  for (; nwords >= 4; nwords -= 4, data += 4)
+    {
+      w0   = data[0];
+      w1   = data[1];
+      w2   = data[2];
+      w3   = data[3];
+
+      sum += (w0 & 0xffff) + (w0 >> 16);
+      sum += (w1 & 0xffff) + (w1 >> 16);
+      sum += (w2 & 0xffff) + (w2 >> 16);
+      sum += (w3 & 0xffff) + (w3 >> 16);
+    }
+
+  for (; nwords > 0; nwords--, data++)
+    {
+      w0   = *data;
+      sum += (w0 & 0xffff) + (w0 >> 16);
+    }
+
+  return sum;
+}
+#endif
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Calculate the one's complement sum of the region in native byte order,
+ *   optionally copying the region to 'dest' at the same time.  The bulk of
+ *   the region is summed a 32-bit word at a time.  A region starting at an
+ *   odd address is summed one byte off and byte swapped afterward, see
+ *   RFC 1071 section 2(B).
+ *
+ * Input Parameters:
+ *   dest - If not NULL, the data is copied here.  The copy is fused with
+ *          the summation only if 'dest' and 'src' have the same alignment
+ *          modulo 4.
+ *   src  - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The 16-bit one's complement sum in native byte order.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_native(FAR uint8_t *dest, FAR const uint8_t *src,
+                              uint16_t len)
+{
+  uint32_t sum = 0;
+  uint16_t t = 0;
+  size_t nwords;
+  bool odd;
+
+  if (dest != NULL && (((uintptr_t)dest ^ (uintptr_t)src) & 3) != 0)
+    {
+      /* Cannot load and store aligned words at the same time */
+
+      memcpy(dest, src, len);
+      dest = NULL;
+    }
+
+  /* Align the source to a 16-bit boundary */
+
+  odd = ((uintptr_t)src & 1) != 0;
+  if (odd && len > 0)
+    {
+      ((FAR uint8_t *)&t)[1] = *src;
+      if (dest != NULL)
+        {
+          *dest++ = *src;
+        }
+
+      src++;
+      len--;
+    }
+
+  /* Then to a 32-bit boundary */
+
+  if (((uintptr_t)src & 2) != 0 && len >= 2)
+    {
+      sum += *(FAR const uint16_t *)src;
+      if (dest != NULL)
+        {
+          *(FAR uint16_t *)dest = *(FAR const uint16_t *)src;
+          dest += 2;
+        }
+
+      src += 2;
+      len -= 2;
+    }
+
+  /* The bulk of the data, a word at a time */
+
+  nwords = len >> 2;
+  if (dest != NULL)
+    {
+      FAR const uint32_t *sp = (FAR const uint32_t *)src;
+      FAR uint32_t *dp = (FAR uint32_t *)dest;
+      uint32_t w;
+
+      for (; nwords > 0; nwords--)
+        {
+          w     = *sp++;
+          *dp++ = w;
+          sum  += (w & 0xffff) + (w >> 16);
+        }
+
+      dest = (FAR uint8_t *)dp;
+    }
+  else if (nwords > 0)
+    {
+      uint32_t partial;
+
+      partial = chksum_words(0, (FAR const uint32_t *)src, nwords);
+      sum    += CHKSUM_FOLD(partial);
+    }
+
+  src += len & ~3;
+  len &= 3;
+
+  /* And the trailing halfword and byte */
+
+  if (len >= 2)
+    {
+      sum += *(FAR const uint16_t *)src;
+      if (dest != NULL)
+        {
+          *(FAR uint16_t *)dest = *(FAR const uint16_t *)src;
+          dest += 2;
+        }
+
+      src += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      ((FAR uint8_t *)&t)[0] = *src;
+      if (dest != NULL)
+        {
+          *dest = *src;
+        }
+    }
+
+  sum += t;
+  sum  = CHKSUM_FOLD(sum);
+  sum  = CHKSUM_FOLD(sum);
+
+  if (odd)
+    {
+      sum = ((sum & 0xff) << 8) | (sum >> 8);
+    }
+
+  return (uint16_t)sum;
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -84,42 +278,57 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
   uint16_t t;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* Return sum in host byte order. */
 
-  while (dataptr < last_byte)
+  t    = ntohs(chksum_native(NULL, data, len));
+  sum += t;
+  if (sum < t)
     {
-      /* At least two more bytes */
+      sum++; /* carry */
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  return sum;
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
 
-      dataptr += 2;
-    }
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy a buffer and calculate the raw checksum over it in the same pass.
+ *   This is otherwise identical to chksum().
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   dest - The location to copy the data to.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  uint16_t t;
 
-  if (dataptr == last_byte)
+  t    = ntohs(chksum_native(dest, src, len));
+  sum += t;
+  if (sum < t)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      sum++; /* carry */
     }
 
-  /* Return sum in host byte order. */
-
   return sum;
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif /* CONFIG_NET_CHKSUM_COPY */
 
 /****************************************************************************
  * Name: net_chksum
@@ -58,6 +58,64 @@
 #define IPv4BUF  ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF  ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ip_payload_chksum
+ *
+ * Description:
+ *   Sum the upper layer header and payload.  If the raw checksum of the
+ *   outgoing application data was already calculated when it was copied
+ *   into the device buffer, only the upper layer header is summed here.
+ *
+ * Input Parameters:
+ *   dev      - The network driver instance
+ *   sum      - The sum of the pseudo-header
+ *   upper    - The beginning of the upper layer header
+ *   upperlen - The length of the upper layer header and payload
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && \
+    (defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6))
+static uint16_t ip_payload_chksum(FAR struct net_driver_s *dev, uint16_t sum,
+                                  FAR uint8_t *upper, uint16_t upperlen)
+{
+#ifdef CONFIG_NET_CHKSUM_COPY
+  uint16_t hdrlen = dev->d_appdata - upper;
+
+  /* The cached sum can only be combined with that of an even length
+   * header.
+   */
+
+  if (dev->d_sndsumlen != 0 && dev->d_sndsumlen == dev->d_sndlen &&
+      dev->d_appdata >= upper && (hdrlen & 1) == 0 &&
+      hdrlen + dev->d_sndlen == upperlen)
+    {
+      uint16_t t = dev->d_sndsum;
+
+      dev->d_sndsumlen = 0;
+
+      sum  = chksum(sum, upper, hdrlen);
+      sum += t;
+      if (sum < t)
+        {
+          sum++; /* carry */
+        }
+
+      return sum;
+    }
+#endif
+
+  return chksum(sum, upper, upperlen);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,7 +176,9 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)], upperlen);
+  sum = ip_payload_chksum(dev, sum,
+                          &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)],
+                          upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -185,7 +245,8 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
+  sum = ip_payload_chksum(dev, sum, &dev->d_buf[NET_LL_HDRLEN(dev) + iplen],
+                          upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -135,13 +135,17 @@ void net_lockinitialize(void)
 
 int net_lock(void)
 {
-#ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
-#endif
   pid_t me = getpid();
   int ret = OK;
 
-  /* Does this thread already hold the semaphore? */
+  /* Does this thread already hold the semaphore?  No critical section is
+   * needed here:  g_holder and g_count are only written by the thread that
+   * holds the semaphore, so no other thread can make g_holder equal to
+   * 'me' or change it while it is equal to 'me'.  Taking and posting the
+   * semaphore order the accesses between holders.  Avoiding the critical
+   * section matters on SMP, where it would serialize every network lock
+   * operation with all other critical sections in the system.
+   */
 
   if (g_holder == me)
     {
@@ -163,9 +167,6 @@ int net_lock(void)
         }
     }
 
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
-#endif
   return ret;
 }
 
@@ -185,9 +186,6 @@ int net_lock(void)
 
 void net_unlock(void)
 {
-#ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
-#endif
   DEBUGASSERT(g_holder == getpid() && g_count > 0);
 
   /* If the count would go to zero, then release the semaphore */
@@ -206,10 +204,6 @@ void net_unlock(void)
 
       g_count--;
     }
-
-#ifdef CONFIG_SMP
-  leave_critical_section(flags);
-#endif
 }
 
 /****************************************************************************
@@ -238,6 +238,30 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy a buffer and calculate the raw checksum over it in the same pass.
+ *   This is otherwise identical to chksum().
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to chksum().
+ *          This should be zero on the first time that check sum is called.
+ *   dest - The location to copy the data to.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
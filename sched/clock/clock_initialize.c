@@ -229,6 +229,10 @@ void clock_initialize(void)
   /* Initialize the time value to match the RTC */
 
   clock_inittime();
+
+  /* Then publish it to user space */
+
+  clock_timepage_initialize();
 }
 
 /****************************************************************************
@@ -424,5 +428,9 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+
+  /* And publish the new time to user space */
+
+  clock_timepage_update();
 }
 #endif
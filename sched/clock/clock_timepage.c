@@ -0,0 +1,148 @@
+/****************************************************************************
+ * sched/clock/clock_timepage.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The time page.  It is allocated from the user heap so that it is
+ * accessible by user space.
+ */
+
+static FAR struct clock_timepage_s *g_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_initialize
+ *
+ * Description:
+ *   Allocate and initialize the time page.
+ *
+ * Assumptions:
+ *   Called once by clock_initialize() after the user heap was initialized.
+ *
+ ****************************************************************************/
+
+void clock_timepage_initialize(void)
+{
+  g_timepage = (FAR struct clock_timepage_s *)
+    kumm_zalloc(sizeof(struct clock_timepage_s));
+  if (g_timepage == NULL)
+    {
+      serr("ERROR: Failed to allocate the time page\n");
+      return;
+    }
+
+  clock_timepage_update();
+}
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Publish the current time in the time page.
+ *
+ * Assumptions:
+ *   Called on each timer tick and whenever the base time is changed.
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(void)
+{
+  FAR volatile struct clock_timepage_s *page = g_timepage;
+  struct timespec ts;
+  irqstate_t flags;
+
+  if (page == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  (void)clock_systimespec(&ts);
+
+  /* The sequence count is odd while the page is inconsistent */
+
+  page->seq++;
+  page->monotonic.tv_sec  = ts.tv_sec;
+  page->monotonic.tv_nsec = ts.tv_nsec;
+  page->basetime.tv_sec   = g_basetime.tv_sec;
+  page->basetime.tv_nsec  = g_basetime.tv_nsec;
+  page->seq++;
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: clock_timepage
+ *
+ * Description:
+ *   Return the address of the time page.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The address of the time page or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_timepage_s *clock_timepage(void)
+{
+  return g_timepage;
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE */
@@ -52,6 +52,7 @@
 #include "environ/environ.h"
 #include "sched/sched.h"
 #include "group/group.h"
+#include "signal/signal.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -217,14 +218,22 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 
   DEBUGASSERT(tcb && !tcb->cmn.group);
 
-  /* Allocate the group structure and assign it to the TCB */
+  /* Allocate the group structure and assign it to the TCB.  Any signal
+   * queue entries of the group are allocated together with it and freed
+   * with it.
+   */
 
-  group = (FAR struct task_group_s *)kmm_zalloc(sizeof(struct task_group_s));
+  group = (FAR struct task_group_s *)
+    kmm_zalloc(sizeof(struct task_group_s) + SIG_GROUP_POOLSIZE);
   if (!group)
     {
       return -ENOMEM;
     }
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  nxsig_initialize_group(group);
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0 && (defined(CONFIG_BUILD_PROTECTED) || \
     defined(CONFIG_BUILD_KERNEL)) && defined(CONFIG_MM_KERNEL_HEAP)
   /* If this group is being created for a privileged thread, then all elements
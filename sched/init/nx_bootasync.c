@@ -0,0 +1,274 @@
+/****************************************************************************
+ * sched/init/nx_bootasync.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_BOOT_ASYNC
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one initialization function that runs on its
+ * own thread.
+ */
+
+struct bootasync_s
+{
+  FAR const char *name;   /* The name of the thread */
+  nx_bootasync_t entry;   /* The initialization function */
+  FAR void *arg;          /* Its argument */
+#ifdef CONFIG_BOOT_TRACE
+  uint32_t start;         /* Start time (up_critmon_gettime() units) */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of running initialization functions and the first error that
+ * one of the functions returned.
+ */
+
+static volatile unsigned int g_bootasync_njobs;
+static int g_bootasync_result = OK;
+
+/* Posted each time that an initialization function returns */
+
+static sem_t g_bootasync_sem = SEM_INITIALIZER(0);
+static bool g_bootasync_initialized;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_bootasync_main
+ *
+ * Description:
+ *   The body of the thread of one initialization function.
+ *
+ ****************************************************************************/
+
+static int nx_bootasync_main(int argc, FAR char *argv[])
+{
+  FAR struct bootasync_s *job;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(argc == 2);
+  job = (FAR struct bootasync_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  ret = job->entry(job->arg);
+  if (ret < 0)
+    {
+      serr("ERROR: %s failed: %d\n", job->name, ret);
+    }
+
+#ifdef CONFIG_BOOT_TRACE
+  nx_boottrace_span(job->name, job->start);
+#endif
+
+  flags = enter_critical_section();
+  if (ret < 0 && g_bootasync_result == OK)
+    {
+      g_bootasync_result = ret;
+    }
+
+  DEBUGASSERT(g_bootasync_njobs > 0);
+  g_bootasync_njobs--;
+  leave_critical_section(flags);
+
+  nxsem_post(&g_bootasync_sem);
+  kmm_free(job);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_bootasync
+ *
+ * Description:
+ *   Run an initialization function on its own kernel thread, concurrently
+ *   with the rest of the boot sequence.  The function is called directly
+ *   if the OS is not yet ready to start threads.
+ *
+ * Input Parameters:
+ *   name  - The name of the thread.  The string must persist.
+ *   entry - The initialization function
+ *   arg   - The argument passed to the initialization function
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the function was started or, if it was
+ *   called directly, the value returned by the function.  A negated errno
+ *   value is returned if the thread could not be created.
+ *
+ ****************************************************************************/
+
+int nx_bootasync(FAR const char *name, nx_bootasync_t entry, FAR void *arg)
+{
+  FAR struct bootasync_s *job;
+  FAR char *argv[2];
+  char arg1[16];
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(name != NULL && entry != NULL);
+
+  if (!OSINIT_OS_READY())
+    {
+#ifdef CONFIG_BOOT_TRACE
+      uint32_t start = up_critmon_gettime();
+
+      ret = entry(arg);
+      nx_boottrace_span(name, start);
+      return ret;
+#else
+      return entry(arg);
+#endif
+    }
+
+  job = (FAR struct bootasync_s *)kmm_malloc(sizeof(struct bootasync_s));
+  if (job == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  job->name  = name;
+  job->entry = entry;
+  job->arg   = arg;
+#ifdef CONFIG_BOOT_TRACE
+  job->start = up_critmon_gettime();
+#endif
+
+  /* The semaphore is used for signaling and must not have priority
+   * inheritance enabled.
+   */
+
+  flags = enter_critical_section();
+  if (!g_bootasync_initialized)
+    {
+      nxsem_setprotocol(&g_bootasync_sem, SEM_PRIO_NONE);
+      g_bootasync_initialized = true;
+    }
+
+  g_bootasync_njobs++;
+  leave_critical_section(flags);
+
+  snprintf(arg1, sizeof(arg1), "%lx", (unsigned long)(uintptr_t)job);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create(name, CONFIG_BOOT_ASYNC_PRIORITY,
+                       CONFIG_BOOT_ASYNC_STACKSIZE,
+                       (main_t)nx_bootasync_main, argv);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to start %s: %d\n", name, ret);
+
+      flags = enter_critical_section();
+      g_bootasync_njobs--;
+      leave_critical_section(flags);
+
+      kmm_free(job);
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_bootasync_wait
+ *
+ * Description:
+ *   Wait until all initialization functions started by nx_bootasync()
+ *   have returned.  Only one thread may wait at a time.
+ *
+ * Returned Value:
+ *   Zero (OK) if all functions succeeded; otherwise, the first negated
+ *   errno value returned by one of the functions.
+ *
+ ****************************************************************************/
+
+int nx_bootasync_wait(void)
+{
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  while (g_bootasync_njobs > 0)
+    {
+      /* The semaphore may hold posts of functions that returned before
+       * this wait.  Then the number of running functions is just checked
+       * once more.
+       */
+
+      ret = nxsem_wait_uninterruptible(&g_bootasync_sem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  ret = g_bootasync_result;
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_BOOT_ASYNC */
@@ -0,0 +1,222 @@
+/****************************************************************************
+ * sched/init/nx_boottrace.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <syslog.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/init.h>
+
+#ifdef CONFIG_BOOT_TRACE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One recorded phase of the boot sequence */
+
+struct boottrace_s
+{
+  FAR const char *name;   /* The name of the phase */
+  uint32_t start;         /* Start time (up_critmon_gettime() units) */
+  uint32_t end;           /* End time (up_critmon_gettime() units) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct boottrace_s g_boottrace[CONFIG_BOOT_TRACE_NPHASES];
+static unsigned int g_nboottrace;    /* Number of recorded phases */
+static unsigned int g_nbootlost;     /* Number of phases that were lost */
+static uint32_t g_boottrace_last;    /* End of the last sequential phase */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_boottrace_record
+ *
+ * Description:
+ *   Record one phase.
+ *
+ ****************************************************************************/
+
+static void nx_boottrace_record(FAR const char *name, uint32_t start,
+                                uint32_t end)
+{
+  if (g_nboottrace < CONFIG_BOOT_TRACE_NPHASES)
+    {
+      FAR struct boottrace_s *trace = &g_boottrace[g_nboottrace++];
+
+      trace->name  = name;
+      trace->start = start;
+      trace->end   = end;
+    }
+  else
+    {
+      g_nbootlost++;
+    }
+}
+
+/****************************************************************************
+ * Name: nx_boottrace_usec
+ *
+ * Description:
+ *   Convert an elapsed time to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long nx_boottrace_usec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  up_critmon_convert(elapsed, &ts);
+  return (unsigned long)ts.tv_sec * USEC_PER_SEC +
+         (unsigned long)ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_boottrace
+ *
+ * Description:
+ *   Record the end of a phase of the boot sequence.  The phase started at
+ *   the previous call to nx_boottrace().
+ *
+ * Input Parameters:
+ *   name - The name of the phase.  The string must persist.
+ *
+ ****************************************************************************/
+
+void nx_boottrace(FAR const char *name)
+{
+  irqstate_t flags;
+  uint32_t now;
+
+  flags = enter_critical_section();
+  now   = up_critmon_gettime();
+
+  /* The first phase has no predecessor.  It only marks the start. */
+
+  if (g_nboottrace == 0 && g_nbootlost == 0)
+    {
+      g_boottrace_last = now;
+    }
+
+  nx_boottrace_record(name, g_boottrace_last, now);
+  g_boottrace_last = now;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nx_boottrace_span
+ *
+ * Description:
+ *   Record a phase that ran concurrently with the boot sequence.  This
+ *   does not affect the start of the next phase recorded by nx_boottrace().
+ *
+ * Input Parameters:
+ *   name  - The name of the phase.  The string must persist.
+ *   start - The start time of the phase as returned by up_critmon_gettime()
+ *
+ ****************************************************************************/
+
+void nx_boottrace_span(FAR const char *name, uint32_t start)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  nx_boottrace_record(name, start, up_critmon_gettime());
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nx_bootreport
+ *
+ * Description:
+ *   Send the recorded phases, with their start times and durations, to the
+ *   SYSLOG.  Start times are relative to the first recorded phase.
+ *
+ ****************************************************************************/
+
+void nx_bootreport(void)
+{
+  FAR struct boottrace_s *trace;
+  unsigned int ntrace;
+  unsigned int i;
+  uint32_t base;
+
+  /* Phases are only appended, so the recorded ones can be reported without
+   * holding the critical section.
+   */
+
+  ntrace = g_nboottrace;
+  if (ntrace == 0)
+    {
+      return;
+    }
+
+  base = g_boottrace[0].start;
+
+  syslog(LOG_INFO, "%-24s %10s %10s\n", "PHASE", "START(us)", "TIME(us)");
+  for (i = 0; i < ntrace; i++)
+    {
+      trace = &g_boottrace[i];
+      syslog(LOG_INFO, "%-24s %10lu %10lu\n", trace->name,
+             nx_boottrace_usec(trace->start - base),
+             nx_boottrace_usec(trace->end - trace->start));
+    }
+
+  if (g_nbootlost > 0)
+    {
+      syslog(LOG_INFO, "%u phases lost\n", g_nbootlost);
+    }
+}
+
+#endif /* CONFIG_BOOT_TRACE */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/init/nx_bringup.c
  *
- *   Copyright (C) 2011-2012, 2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011-2012, 2019, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * With extensions by:
@@ -63,6 +63,7 @@
 #endif
 # include "wqueue/wqueue.h"
 # include "init/init.h"
+# include "irq/irq.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -225,6 +226,47 @@ static inline void nx_workqueues(void)
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
 
+/****************************************************************************
+ * Name: nx_late_initialize
+ *
+ * Description:
+ *   Perform any last-minute, board-specific initialization, if so
+ *   configured, and wait for the initialization functions that run
+ *   concurrently.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void nx_late_initialize(void)
+{
+#ifdef CONFIG_BOARD_LATE_INITIALIZE
+  board_late_initialize();
+  nx_boottrace("board_late_initialize");
+#endif
+
+#ifdef CONFIG_BOOT_ASYNC
+  /* The application may depend on any of the devices and file systems
+   * that are initialized concurrently.
+   */
+
+  if (nx_bootasync_wait() < 0)
+    {
+      serr("ERROR: Concurrent initialization failed\n");
+    }
+
+  nx_boottrace("nx_bootasync_wait");
+#endif
+
+#ifdef CONFIG_BOOT_TRACE
+  nx_bootreport();
+#endif
+}
+
 /****************************************************************************
  * Name: nx_start_application
  *
@@ -245,13 +287,9 @@ static inline void nx_start_application(void)
 {
   int pid;
 
-#ifdef CONFIG_BOARD_LATE_INITIALIZE
-  /* Perform any last-minute, board-specific initialization, if so
-   * configured.
-   */
+  /* Perform any last-minute, board-specific initialization */
 
-  board_late_initialize();
-#endif
+  nx_late_initialize();
 
   /* Start the application initialization task.  In a flat build, this is
    * entrypoint is given by the definitions, CONFIG_USER_ENTRYPOINT.  In
@@ -281,13 +319,9 @@ static inline void nx_start_application(void)
 {
   int ret;
 
-#ifdef CONFIG_BOARD_LATE_INITIALIZE
-  /* Perform any last-minute, board-specific initialization, if so
-   * configured.
-   */
+  /* Perform any last-minute, board-specific initialization */
 
-  board_late_initialize();
-#endif
+  nx_late_initialize();
 
 #ifdef CONFIG_INIT_MOUNT
   /* Mount the file system containing the init program. */
@@ -453,6 +487,13 @@ int nx_bringup(void)
    */
 
   nx_workqueues();
+  nx_boottrace("kernel threads");
+
+#ifdef CONFIG_IRQ_BALANCE
+  /* Start spreading the interrupt load across the CPUs */
+
+  irq_balance_start();
+#endif
 
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
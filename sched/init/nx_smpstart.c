@@ -163,6 +163,12 @@ int nx_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SMP
+      /* Start any unassigned ready-to-run task that may run on this CPU */
+
+      sched_idle_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -1,7 +1,8 @@
 /****************************************************************************
  * sched/init/nx_start.c
  *
- *   Copyright (C) 2007-2014, 2016, 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2014, 2016, 2018, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -161,6 +162,15 @@ FAR struct tcb_s *g_running_tasks[1];
 
 volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* These are the priority indices of the g_readytorun and g_pendingtasks
+ * lists.
+ */
+
+struct sched_prioindex_s g_readytorun_index;
+struct sched_prioindex_s g_pendingtasks_index;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 volatile dq_queue_t g_waitingforsemaphore;
@@ -211,7 +221,7 @@ volatile dq_queue_t g_inactivetasks;
  * while it is within an interrupt handler.
  */
 
-volatile sq_queue_t g_delayed_kfree;
+volatile struct delayed_free_s g_delayed_kfree[DELAYED_NQUEUES];
 #endif
 
 #ifndef CONFIG_BUILD_KERNEL
@@ -223,7 +233,7 @@ volatile sq_queue_t g_delayed_kfree;
  * on a group-by-group basis.
  */
 
-volatile sq_queue_t g_delayed_kufree;
+volatile struct delayed_free_s g_delayed_kufree[DELAYED_NQUEUES];
 #endif
 
 /* This is the value of the last process ID assigned to a task */
@@ -401,6 +411,7 @@ void nx_start(void)
   /* Boot up is complete */
 
   g_nx_initstate = OSINIT_BOOT;
+  nx_boottrace("nx_start");
 
   /* Initialize RTOS Data ***************************************************/
 
@@ -421,13 +432,23 @@ void nx_start(void)
   dq_init(&g_stoppedtasks);
 #endif
   dq_init(&g_inactivetasks);
+
+  for (i = 0; i < DELAYED_NQUEUES; i++)
+    {
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
-  sq_init(&g_delayed_kfree);
+      sq_init((FAR sq_queue_t *)&g_delayed_kfree[i].queue);
+#ifdef CONFIG_SPINLOCK_SCOPED
+      spin_initialize(&g_delayed_kfree[i].lock, SP_UNLOCKED);
+#endif
 #endif
 #ifndef CONFIG_BUILD_KERNEL
-  sq_init(&g_delayed_kufree);
+      sq_init((FAR sq_queue_t *)&g_delayed_kufree[i].queue);
+#ifdef CONFIG_SPINLOCK_SCOPED
+      spin_initialize(&g_delayed_kufree[i].lock, SP_UNLOCKED);
 #endif
+#endif
+    }
 
 #ifdef CONFIG_SMP
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
@@ -553,7 +574,11 @@ void nx_start(void)
 #else
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
 #endif
+#ifdef CONFIG_SCHED_PRIOBITMAP
+      sched_addprioritized(&g_idletcb[cpu].cmn, tasklist);
+#else
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -567,6 +592,7 @@ void nx_start(void)
   /* Task lists are initialized */
 
   g_nx_initstate = OSINIT_TASKLISTS;
+  nx_boottrace("task lists");
 
   /* Initialize RTOS facilities *********************************************/
 
@@ -617,6 +643,7 @@ void nx_start(void)
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
+  nx_boottrace("memory manager");
 
 #if defined(CONFIG_SCHED_HAVE_PARENT) && defined(CONFIG_SCHED_CHILD_STATUS)
   /* Initialize tasking data structures */
@@ -696,14 +723,18 @@ void nx_start(void)
     }
 #endif
 
+  nx_boottrace("OS facilities");
+
   /* Initialize the file system (needed to support device drivers) */
 
   fs_initialize();
+  nx_boottrace("fs_initialize");
 
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
   net_initialize();
+  nx_boottrace("net_initialize");
 #endif
 
   /* Initialize Hardware Facilities *****************************************/
@@ -715,6 +746,7 @@ void nx_start(void)
    */
 
   up_initialize();
+  nx_boottrace("up_initialize");
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -723,6 +755,7 @@ void nx_start(void)
    */
 
   board_early_initialize();
+  nx_boottrace("board_early_initialize");
 #endif
 
   /* Hardware resources are now available */
@@ -749,6 +782,8 @@ void nx_start(void)
   binfmt_initialize();
 #endif
 
+  nx_boottrace("libraries");
+
   /* IDLE Group Initialization **********************************************/
 
   /* Announce that the CPU0 IDLE task has started */
@@ -799,6 +834,7 @@ void nx_start(void)
    */
 
   syslog_initialize(SYSLOG_INIT_LATE);
+  nx_boottrace("IDLE groups");
 
 #ifdef CONFIG_SMP
   /* Start all CPUs *********************************************************/
@@ -816,6 +852,7 @@ void nx_start(void)
   /* Then start the other CPUs */
 
   DEBUGVERIFY(nx_smp_start());
+  nx_boottrace("nx_smp_start");
 
 #endif /* CONFIG_SMP */
 
@@ -869,6 +906,12 @@ void nx_start(void)
         }
 #endif
 
+#ifdef CONFIG_SMP
+      /* Start any unassigned ready-to-run task that may run on this CPU */
+
+      sched_idle_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
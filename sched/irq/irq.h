@@ -84,6 +84,13 @@ struct irq_info_s
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
 #endif
+#ifdef CONFIG_IRQ_AFFINITY
+  cpu_set_t affinity; /* The CPUs that may service this IRQ */
+  bool fixed;        /* The affinity was set explicitly */
+#endif
+#ifdef CONFIG_IRQ_BALANCE
+  uint32_t nbalance; /* Number of interrupts since last balancing pass */
+#endif
 };
 
 #ifdef CONFIG_SCHED_IRQMONITOR
@@ -234,6 +241,25 @@ bool is_irqchain(int ndx, xcpt_t isr);
 int irqchain_attach(int ndx, xcpt_t isr, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_balance_start
+ *
+ * Description:
+ *   Start periodic automatic interrupt balancing.  This must be called
+ *   after the work queues have been started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_BALANCE
+void irq_balance_start(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,136 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQ_AFFINITY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The set of all CPUs */
+
+#define IRQ_ALLCPUS ((cpu_set_t)((1 << CONFIG_SMP_NCPUS) - 1))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Select the set of CPUs that may service IRQ number 'irq'.  Bit n of
+ *   'cpuset' selects CPU n.  An IRQ with an explicitly set affinity is not
+ *   moved by automatic interrupt balancing.  If 'cpuset' is zero, the
+ *   current routing is kept but the IRQ is returned to automatic
+ *   balancing.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, cpu_set_t cpuset)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  cpuset &= IRQ_ALLCPUS;
+
+  flags = enter_critical_section();
+  if (cpuset == 0)
+    {
+      g_irqvector[irq].fixed = false;
+    }
+  else
+    {
+      ret = up_affinity_irq(irq, cpuset);
+      if (ret >= 0)
+        {
+          g_irqvector[irq].affinity = cpuset;
+          g_irqvector[irq].fixed    = true;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_get_affinity
+ *
+ * Description:
+ *   Return the set of CPUs that may service IRQ number 'irq'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if 'irq' is not a valid IRQ number.
+ *
+ ****************************************************************************/
+
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset)
+{
+  DEBUGASSERT(cpuset != NULL);
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  *cpuset = g_irqvector[irq].affinity;
+  return OK;
+}
+
+#endif /* CONFIG_IRQ_AFFINITY */
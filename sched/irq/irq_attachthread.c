@@ -0,0 +1,385 @@
+/****************************************************************************
+ * sched/irq/irq_attachthread.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQTHREAD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the interrupt thread of one IRQ */
+
+struct irq_thread_s
+{
+  FAR struct irq_thread_s *flink;  /* Supports a singly linked list */
+  xcpt_t isr;                      /* The top half or NULL */
+  xcpt_t isrthread;                /* The bottom half */
+  FAR void *arg;                   /* The argument passed to both halves */
+  sem_t sem;                       /* Posted to wake up the thread */
+  pid_t pid;                       /* The ID of the interrupt thread */
+  int irq;                         /* The IRQ number */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of all interrupt threads.  Threads are never destroyed. */
+
+static sq_queue_t g_irqthreads;
+
+/* Serializes the creation of interrupt threads */
+
+static sem_t g_irqthread_lock = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_find
+ *
+ * Description:
+ *   Find the interrupt thread of the IRQ.
+ *
+ * Assumptions:
+ *   The caller holds g_irqthread_lock.
+ *
+ ****************************************************************************/
+
+static FAR struct irq_thread_s *irq_thread_find(int irq)
+{
+  FAR struct irq_thread_s *info;
+
+  for (info = (FAR struct irq_thread_s *)sq_peek(&g_irqthreads);
+       info != NULL;
+       info = info->flink)
+    {
+      if (info->irq == irq)
+        {
+          return info;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   The interrupt handler attached to the IRQ.  Call the top half and, if
+ *   requested, disable the interrupt and wake up the interrupt thread.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct irq_thread_s *info = (FAR struct irq_thread_s *)arg;
+  int ret = IRQ_WAKE_THREAD;
+
+  if (info->isr != NULL)
+    {
+      ret = info->isr(irq, context, info->arg);
+    }
+
+  if (ret == IRQ_WAKE_THREAD)
+    {
+      /* The interrupt stays disabled until the bottom half has run, so
+       * there can be at most one pending wake-up.
+       */
+
+      up_disable_irq(irq);
+      nxsem_post(&info->sem);
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_attached
+ *
+ * Description:
+ *   Return true if the interrupt thread is still attached to its IRQ.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static bool irq_thread_attached(FAR struct irq_thread_s *info)
+{
+  int ndx;
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+  ndx = g_irqmap[info->irq];
+#else
+  ndx = info->irq;
+#endif
+
+  return g_irqvector[ndx].handler == irq_thread_isr &&
+         g_irqvector[ndx].arg == info;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   The body of an interrupt thread.  Wait to be woken up by the interrupt,
+ *   run the bottom half, and re-enable the interrupt.
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_s *info;
+  irqstate_t flags;
+  xcpt_t isrthread;
+  FAR void *arg;
+
+  DEBUGASSERT(argc == 2);
+  info = (FAR struct irq_thread_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&info->sem);
+
+      /* Sample the handler.  The IRQ may have been re-attached. */
+
+      flags     = enter_critical_section();
+      isrthread = info->isrthread;
+      arg       = info->arg;
+      leave_critical_section(flags);
+
+      isrthread(info->irq, NULL, arg);
+
+      /* Do not re-enable the interrupt if it was detached in the meantime */
+
+      flags = enter_critical_section();
+      if (irq_thread_attached(info))
+        {
+          up_enable_irq(info->irq);
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Name: irq_thread_create
+ *
+ * Description:
+ *   Create the interrupt thread for the IRQ.
+ *
+ * Assumptions:
+ *   The caller holds g_irqthread_lock.
+ *
+ ****************************************************************************/
+
+static FAR struct irq_thread_s *irq_thread_create(int irq, int priority,
+                                                  int stack_size)
+{
+  FAR struct irq_thread_s *info;
+  FAR char *argv[2];
+  char name[16];
+  char arg1[16];
+  int ret;
+
+  info = (FAR struct irq_thread_s *)kmm_zalloc(sizeof(struct irq_thread_s));
+  if (info == NULL)
+    {
+      return NULL;
+    }
+
+  info->irq = irq;
+
+  /* The semaphore is used for signaling and must not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_init(&info->sem, 0, 0);
+  nxsem_setprotocol(&info->sem, SEM_PRIO_NONE);
+
+  snprintf(name, sizeof(name), "irq%d", irq);
+  snprintf(arg1, sizeof(arg1), "%lx", (unsigned long)(uintptr_t)info);
+
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create(name, priority,
+                       stack_size > 0 ? stack_size :
+                       CONFIG_IRQTHREAD_STACKSIZE,
+                       (main_t)irq_thread_main, argv);
+  if (ret < 0)
+    {
+      nxsem_destroy(&info->sem);
+      kmm_free(info);
+      return NULL;
+    }
+
+  info->pid = ret;
+  sq_addlast((FAR sq_entry_t *)info, &g_irqthreads);
+  return info;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is dispatched to
+ *   a threaded interrupt handler.  'isr' is the top half.  It is called in
+ *   the interrupt context and returns IRQ_WAKE_THREAD if the bottom half
+ *   must run.  If 'isr' is NULL, the bottom half runs on every interrupt.
+ *   'isrthread' is the bottom half.  It is called on a dedicated kernel
+ *   thread with a NULL context.  Both receive the argument 'arg'.
+ *
+ *   The interrupt is disabled when the thread is woken up and re-enabled
+ *   when 'isrthread' returns.
+ *
+ *   The thread is created by the first call for the IRQ.  It is not
+ *   destroyed when the IRQ is detached with irq_detach() but is re-used,
+ *   with the new handlers, when the IRQ is attached again.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The top half interrupt handler or NULL
+ *   isrthread  - The bottom half interrupt handler
+ *   arg        - The argument passed to both handlers
+ *   priority   - The priority of the interrupt thread
+ *   stack_size - The stack size of the interrupt thread or zero to use
+ *                CONFIG_IRQTHREAD_STACKSIZE
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size)
+{
+  FAR struct irq_thread_s *info;
+  irqstate_t flags;
+  int ret;
+
+  if ((unsigned)irq >= NR_IRQS || isrthread == NULL)
+    {
+      return -EINVAL;
+    }
+
+  DEBUGASSERT(!up_interrupt_context());
+
+  ret = nxsem_wait_uninterruptible(&g_irqthread_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  info = irq_thread_find(irq);
+  if (info == NULL)
+    {
+      info = irq_thread_create(irq, priority, stack_size);
+      if (info == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+    }
+  else
+    {
+      struct sched_param param;
+
+      /* Re-use the existing thread, but with the new priority */
+
+      param.sched_priority = priority;
+      ret = nxsched_setparam(info->pid, &param);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Install the new handlers and attach the IRQ.  The interrupt thread
+   * samples the handlers within a critical section.
+   */
+
+  flags           = enter_critical_section();
+  info->isr       = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+
+  ret = irq_attach(irq, irq_thread_isr, info);
+  leave_critical_section(flags);
+
+errout:
+  nxsem_post(&g_irqthread_lock);
+  return ret;
+}
+
+#endif /* CONFIG_IRQTHREAD */
@@ -0,0 +1,266 @@
+/****************************************************************************
+ * sched/irq/irq_balance.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQ_BALANCE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQ_BALANCE_DELAY MSEC2TICK(CONFIG_IRQ_BALANCE_PERIOD)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The number of interrupts taken on one IRQ during the last period */
+
+struct irq_load_s
+{
+  irq_t irq;
+  uint32_t count;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct work_s g_irqbalance_work;
+
+/* Only accessed from the work queue */
+
+static struct irq_load_s g_irqload[NR_IRQS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_load_compare
+ *
+ * Description:
+ *   qsort() comparison function that orders the busiest IRQs first.
+ *
+ ****************************************************************************/
+
+static int irq_load_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct irq_load_s *la = (FAR const struct irq_load_s *)a;
+  FAR const struct irq_load_s *lb = (FAR const struct irq_load_s *)b;
+
+  if (la->count > lb->count)
+    {
+      return -1;
+    }
+  else if (la->count < lb->count)
+    {
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: irq_least_loaded
+ *
+ * Description:
+ *   Return the CPU with the fewest interrupts assigned so far.
+ *
+ ****************************************************************************/
+
+static int irq_least_loaded(FAR const uint32_t *cpuload)
+{
+  int best = 0;
+  int cpu;
+
+  for (cpu = 1; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpuload[cpu] < cpuload[best])
+        {
+          best = cpu;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: irq_balance_worker
+ *
+ * Description:
+ *   Sample and reset the interrupt counts of the last period and assign
+ *   the busiest IRQs, one at a time, to the CPU with the least interrupt
+ *   load.  IRQs with fixed affinity are not moved, but their load is
+ *   accounted to the first CPU of their affinity set.
+ *
+ ****************************************************************************/
+
+static void irq_balance_worker(FAR void *arg)
+{
+  uint32_t cpuload[CONFIG_SMP_NCPUS];
+  irqstate_t flags;
+  int nloads = 0;
+  int irq;
+  int cpu;
+  int i;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cpuload[cpu] = 0;
+    }
+
+  /* Take a snapshot of the counts */
+
+  for (irq = 0; irq < NR_IRQS; irq++)
+    {
+      FAR struct irq_info_s *info = &g_irqvector[irq];
+      uint32_t count;
+
+      flags          = enter_critical_section();
+      count          = info->nbalance;
+      info->nbalance = 0;
+      leave_critical_section(flags);
+
+      if (count == 0 || info->handler == irq_unexpected_isr)
+        {
+          continue;
+        }
+
+      if (info->fixed)
+        {
+          for (cpu = 0; cpu < CONFIG_SMP_NCPUS - 1; cpu++)
+            {
+              if ((info->affinity & (1 << cpu)) != 0)
+                {
+                  break;
+                }
+            }
+
+          cpuload[cpu] += count;
+        }
+      else
+        {
+          g_irqload[nloads].irq   = (irq_t)irq;
+          g_irqload[nloads].count = count;
+          nloads++;
+        }
+    }
+
+  /* Then assign the busiest IRQs first */
+
+  qsort(g_irqload, nloads, sizeof(struct irq_load_s), irq_load_compare);
+
+  for (i = 0; i < nloads; i++)
+    {
+      FAR struct irq_info_s *info;
+      cpu_set_t cpuset;
+
+      irq    = g_irqload[i].irq;
+      info   = &g_irqvector[irq];
+      cpu    = irq_least_loaded(cpuload);
+      cpuset = (cpu_set_t)1 << cpu;
+
+      cpuload[cpu] += g_irqload[i].count;
+
+      flags = enter_critical_section();
+      if (!info->fixed && info->affinity != cpuset)
+        {
+          /* IRQs that cannot be routed (such as per-CPU interrupts) are
+           * excluded from any further balancing.
+           */
+
+          if (up_affinity_irq(irq, cpuset) < 0)
+            {
+              info->fixed = true;
+            }
+          else
+            {
+              info->affinity = cpuset;
+            }
+        }
+
+      leave_critical_section(flags);
+    }
+
+  /* Re-arm for the next period */
+
+  (void)work_queue(LPWORK, &g_irqbalance_work, irq_balance_worker, NULL,
+                   IRQ_BALANCE_DELAY);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_balance_start
+ *
+ * Description:
+ *   Start periodic automatic interrupt balancing.  This must be called
+ *   after the work queues have been started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void irq_balance_start(void)
+{
+  (void)work_queue(LPWORK, &g_irqbalance_work, irq_balance_worker, NULL,
+                   IRQ_BALANCE_DELAY);
+}
+
+#endif /* CONFIG_IRQ_BALANCE */
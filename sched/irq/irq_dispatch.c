@@ -75,6 +75,14 @@
      while (0)
 #endif
 
+/* INCR_BALANCE - Count the interrupts for automatic interrupt balancing */
+
+#ifdef CONFIG_IRQ_BALANCE
+#  define INCR_BALANCE(ndx) g_irqvector[ndx].nbalance++
+#else
+#  define INCR_BALANCE(ndx)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this interrupt
  * request
  */
@@ -92,6 +100,7 @@
          start = up_critmon_gettime(); \
          vector(irq, context, arg); \
          elapsed = up_critmon_gettime() - start; \
+         sched_critmon_irq(elapsed); \
          up_critmon_convert(elapsed, &delta); \
          if (delta.tv_nsec > g_irqvector[ndx].time) \
            { \
@@ -152,6 +161,7 @@ void irq_dispatch(int irq, FAR void *context)
             }
 
           INCR_COUNT(ndx);
+          INCR_BALANCE(ndx);
         }
 #else
       if (g_irqvector[ndx].handler)
@@ -161,6 +171,7 @@ void irq_dispatch(int irq, FAR void *context)
         }
 
       INCR_COUNT(ndx);
+      INCR_BALANCE(ndx);
 #endif
     }
 #endif
@@ -171,10 +182,14 @@ void irq_dispatch(int irq, FAR void *context)
   add_irq_randomness(irq);
 #endif
 
-  /* Then dispatch to the interrupt handler */
+  /* Then dispatch to the interrupt handler.  The time spent in the
+   * handler is not charged to the interrupted thread.
+   */
 
+  sched_cpuacct_irqenter();
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
+  sched_cpuacct_irqleave();
 
   /* Record the new "running" task.  g_running_tasks[] is only used by
    * assertion logic for reporting crashes.
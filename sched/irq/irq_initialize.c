@@ -98,6 +98,13 @@ void irq_initialize(void)
       g_irqvector[i].lscount = 0;
 #endif
       g_irqvector[i].time    = 0;
+#endif
+#ifdef CONFIG_IRQ_AFFINITY
+      g_irqvector[i].affinity = (cpu_set_t)1 << 0;
+      g_irqvector[i].fixed    = false;
+#endif
+#ifdef CONFIG_IRQ_BALANCE
+      g_irqvector[i].nbalance = 0;
 #endif
     }
 
@@ -67,20 +67,31 @@
  *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME
  *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD
  *
+ * With CONFIG_IRQ_AFFINITY, the CPU set that services each IRQ is appended
+ * as a hexadecimal mask followed by '*' if the affinity was set explicitly:
+ *
+ *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME CPUS
+ *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD XXXXXXXX*
+ *
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#ifdef CONFIG_IRQ_AFFINITY
+#  define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME CPUS\n"
+#  define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu %lx%s\n"
+#else
+#  define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
+#  define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#endif
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#define IRQ_LINELEN 60
 
 /****************************************************************************
  * Private Types
@@ -249,12 +260,22 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
 
   /* Output information about this interrupt */
 
+#ifdef CONFIG_IRQ_AFFINITY
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, IRQ_FMT,
+                      (unsigned int)irq,
+                      (unsigned long)((uintptr_t)copy.handler),
+                      (unsigned long)((uintptr_t)copy.arg),
+                      count, intpart, fracpart,
+                      (unsigned long)copy.time / 1000,
+                      (unsigned long)copy.affinity, copy.fixed ? "*" : "");
+#else
   linesize = snprintf(irqfile->line, IRQ_LINELEN, IRQ_FMT,
                       (unsigned int)irq,
                       (unsigned long)((uintptr_t)copy.handler),
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart,
                       (unsigned long)copy.time / 1000);
+#endif
 
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
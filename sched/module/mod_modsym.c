@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/module/mod_modsym.c
  *
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -109,8 +109,13 @@ FAR const void *modsym(FAR void *handle, FAR const char *name)
 
   /* Search the symbol table for the matching symbol */
 
+#ifdef CONFIG_SYMTAB_HASHED
+  symbol = symtab_findbyhash(modp->modinfo.exports, modp->exphash, name,
+                             symtab_hash(name), modp->modinfo.nexports);
+#else
   symbol = symtab_findbyname(modp->modinfo.exports, name,
                              modp->modinfo.nexports);
+#endif
   if (symbol == NULL)
     {
       berr("ERROR: Failed to find symbol in symbol \"$s\" in table\n", name);
@@ -39,11 +39,8 @@
 
 #include <nuttx/config.h>
 
-#include <queue.h>
-
-#include <nuttx/irq.h>
-#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 #include "mqueue/mqueue.h"
 
@@ -55,9 +52,8 @@
  * Name: nxmq_free_msg
  *
  * Description:
- *   The nxmq_free_msg function will return a message to the free pool of
- *   messages if it was a pre-allocated message. If the message was
- *   allocated dynamically it will be deallocated.
+ *   The nxmq_free_msg function will return a message to the pool of
+ *   messages.
  *
  * Input Parameters:
  *   mqmsg - message to free
@@ -69,49 +65,21 @@
 
 void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 {
-  irqstate_t flags;
-
-  /* If this is a generally available pre-allocated message,
-   * then just put it back in the free list.
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* A zero-copy buffer still attached to the message was never received.
+   * This happens only in task context, when the message is consumed by
+   * mq_receive() or when the message queue is destroyed.
    */
 
-  if (mqmsg->type == MQ_ALLOC_FIXED)
+  if ((mqmsg->flags & MQMSG_FLAG_ZEROCOPY) != 0)
     {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfree);
-      leave_critical_section(flags);
+      kumm_free(MQ_ZCBUF(nxmq_zcmail(mqmsg)));
     }
+#endif
 
-  /* If this is a message pre-allocated for interrupts,
-   * then put it back in the correct  free list.
+  /* Return the message to the pool.  This is safe from interrupt
+   * handlers.
    */
 
-  else if (mqmsg->type == MQ_ALLOC_IRQ)
-    {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfreeirq);
-      leave_critical_section(flags);
-    }
-
-  /* Otherwise, deallocate it.  Note:  interrupt handlers
-   * will never deallocate messages because they will not
-   * received them.
-   */
-
-  else if (mqmsg->type == MQ_ALLOC_DYN)
-    {
-      sched_kfree(mqmsg);
-    }
-  else
-    {
-      DEBUGPANIC();
-    }
+  mempool_free(&g_msgpool, mqmsg);
 }
@@ -106,6 +106,64 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen)
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmq_tryreceive
+ *
+ * Description:
+ *   Remove the message at the head of the message queue without waiting.
+ *
+ * Input Parameters:
+ *   msgq   - The message queue
+ *   msglen - The size of the caller's buffer.  A zero-copy message that is
+ *            larger than this is left in the queue.
+ *   rcvmsg - The caller-provided location in which to return the message.
+ *
+ * Returned Value:
+ *   One success, zero (OK) is returned.  A negated errno value is returned
+ *   on any failure:
+ *
+ *   EAGAIN   The message queue is empty.
+ *   EMSGSIZE The message at the head of the queue is larger than msglen.
+ *
+ * Assumptions:
+ *   Interrupts are disabled by the caller.
+ *
+ ****************************************************************************/
+
+int nxmq_tryreceive(FAR struct mqueue_inode_s *msgq, size_t msglen,
+                    FAR struct mqueue_msg_s **rcvmsg)
+{
+  FAR struct mqueue_msg_s *newmsg;
+
+  newmsg = (FAR struct mqueue_msg_s *)msgq->msglist.head;
+  if (newmsg == NULL)
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Messages that were copied into the queue always fit in a buffer that
+   * passed nxmq_verify_receive().  Zero-copy messages may be larger.
+   */
+
+  if ((newmsg->flags & MQMSG_FLAG_ZEROCOPY) != 0 &&
+      MQ_ZCBUF(nxmq_zcmail(newmsg))->msglen > msglen)
+    {
+      return -EMSGSIZE;
+    }
+#endif
+
+  /* Remove the message and decrement the number of messages in the queue
+   * while we are still in the critical section.
+   */
+
+  (void)sq_remfirst(&msgq->msglist);
+  msgq->nmsgs--;
+
+  *rcvmsg = newmsg;
+  return OK;
+}
+
 /****************************************************************************
  * Name: nxmq_wait_receive
  *
@@ -119,6 +177,7 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen)
  *   mqdes  - Message queue descriptor
  *   rcvmsg - The caller-provided location in which to return the newly
  *            received message.
+ *   msglen - The size of the caller's buffer (see nxmq_tryreceive()).
  *
  * Returned Value:
  *   One success, zero (OK) is returned.  A negated errno value is returned
@@ -133,11 +192,11 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen)
  *
  ****************************************************************************/
 
-int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
+int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg,
+                      size_t msglen)
 {
   FAR struct tcb_s *rtcb;
   FAR struct mqueue_inode_s *msgq;
-  FAR struct mqueue_msg_s *newmsg;
   int ret;
 
   DEBUGASSERT(rcvmsg != NULL);
@@ -164,7 +223,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 
   /* Get the message from the head of the queue */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist)) == NULL)
+  while ((ret = nxmq_tryreceive(msgq, msglen, rcvmsg)) == -EAGAIN)
     {
       /* The queue is empty!  Should we block until there the above condition
        * has been satisfied?
@@ -218,17 +277,61 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
         }
     }
 
-  /* If we got message, then decrement the number of messages in
-   * the queue while we are still in the critical section
-   */
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_notify_notfull
+ *
+ * Description:
+ *   Called after a message has been removed from the message queue.  Wake
+ *   up the highest priority task that is waiting for the message queue to
+ *   become non-full.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Pre-emption is disabled by the caller.
+ *
+ ****************************************************************************/
+
+void nxmq_notify_notfull(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
 
-  if (newmsg)
+  /* Check if any tasks are waiting for the MQ not full event. */
+
+  if (msgq->nwaitnotfull > 0)
     {
-      msgq->nmsgs--;
-    }
+      /* Find the highest priority task that is waiting for
+       * this queue to be not-full in g_waitingformqnotfull list.
+       * This must be performed in a critical section because
+       * messages can be sent from interrupt handlers.
+       */
 
-  *rcvmsg = newmsg;
-  return OK;
+      flags = enter_critical_section();
+      for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
+           btcb && btcb->msgwaitq != msgq;
+           btcb = btcb->flink);
+
+      /* If one was found, unblock it.  NOTE:  There is a race
+       * condition here:  the queue might be full again by the
+       * time the task is unblocked
+       */
+
+      DEBUGASSERT(btcb != NULL);
+
+      btcb->msgwaitq = NULL;
+      msgq->nwaitnotfull--;
+      up_unblock_task(btcb);
+
+      leave_critical_section(flags);
+    }
 }
 
 /****************************************************************************
@@ -262,18 +365,29 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, unsigned int *prio)
 {
-  FAR struct tcb_s *btcb;
-  irqstate_t flags;
-  FAR struct mqueue_inode_s *msgq;
+  FAR const void *mail;
   ssize_t rcvmsglen;
 
   /* Get the length of the message (also the return value) */
 
+  mail      = (FAR const void *)mqmsg->mail;
   rcvmsglen = mqmsg->msglen;
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* For a zero-copy message, the message data is in the sender's buffer.
+   * nxmq_tryreceive() has verified that it fits in the user buffer.
+   */
+
+  if ((mqmsg->flags & MQMSG_FLAG_ZEROCOPY) != 0)
+    {
+      mail      = nxmq_zcmail(mqmsg);
+      rcvmsglen = MQ_ZCBUF(mail)->msglen;
+    }
+#endif
+
   /* Copy the message into the caller's buffer */
 
-  memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+  memcpy(ubuffer, mail, rcvmsglen);
 
   /* Copy the message priority as well (if a buffer is provided) */
 
@@ -282,39 +396,15 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
       *prio = mqmsg->priority;
     }
 
-  /* We are done with the message.  Deallocate it now. */
+  /* We are done with the message.  Deallocate it now (along with any
+   * zero-copy buffer).
+   */
 
   nxmq_free_msg(mqmsg);
 
-  /* Check if any tasks are waiting for the MQ not full event. */
-
-  msgq = mqdes->msgq;
-  if (msgq->nwaitnotfull > 0)
-    {
-      /* Find the highest priority task that is waiting for
-       * this queue to be not-full in g_waitingformqnotfull list.
-       * This must be performed in a critical section because
-       * messages can be sent from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
-           btcb && btcb->msgwaitq != msgq;
-           btcb = btcb->flink);
-
-      /* If one was found, unblock it.  NOTE:  There is a race
-       * condition here:  the queue might be full again by the
-       * time the task is unblocked
-       */
+  /* Wake up any task waiting for the MQ not full event */
 
-      DEBUGASSERT(btcb != NULL);
-
-      btcb->msgwaitq = NULL;
-      msgq->nwaitnotfull--;
-      up_unblock_task(btcb);
-
-      leave_critical_section(flags);
-    }
+  nxmq_notify_notfull(mqdes->msgq);
 
   /* Return the length of the message transferred to the user buffer */
 
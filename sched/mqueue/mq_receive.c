@@ -120,7 +120,7 @@ ssize_t nxmq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
   /* Get the message from the message queue */
 
-  ret = nxmq_wait_receive(mqdes, &mqmsg);
+  ret = nxmq_wait_receive(mqdes, &mqmsg, msglen);
   leave_critical_section(flags);
 
   /* Check if we got a message from the message queue.  We might
@@ -0,0 +1,189 @@
+/****************************************************************************
+ * sched/mqueue/mq_receivebatch.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_receive_batch
+ *
+ * Description:
+ *   Receive up to nbatch messages from the message queue (mqdes) in one
+ *   call.  This waits (unless O_NONBLOCK is set) only for the first
+ *   message; then any further messages that are already in the queue are
+ *   received without waiting.  This is the internal OS version of
+ *   mq_receive_batch():  It is not a cancellation point and it does not
+ *   modify the errno value.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   batch  - Describes the buffers to receive the messages.  Each buffer
+ *            must be at least as large as the "mq_msgsize" attribute of
+ *            the message queue.
+ *   nbatch - The number of entries in batch
+ *
+ * Returned Value:
+ *   The number of messages received (at least one) is returned on success.
+ *   The length and the priority of each message are returned in batch.  A
+ *   negated errno value is returned on failure (see mq_receive()).
+ *
+ ****************************************************************************/
+
+int nxmq_receive_batch(mqd_t mqdes, FAR struct mq_rcvbatch_s *batch,
+                       int nbatch)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int nrcvd;
+  int ret;
+  int i;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (batch == NULL || nbatch < 1)
+    {
+      return -EINVAL;
+    }
+
+  /* Verify all of the buffers before any message is removed */
+
+  for (i = 0; i < nbatch; i++)
+    {
+      ret = nxmq_verify_receive(mqdes, batch[i].msg, batch[i].msglen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Wait for the first message as nxmq_receive() does */
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret = nxmq_wait_receive(mqdes, &mqmsg, batch[0].msglen);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      batch[0].rcvlen = nxmq_do_receive(mqdes, mqmsg, batch[0].msg,
+                                        &batch[0].prio);
+
+      /* Then take the messages that are already queued */
+
+      for (nrcvd = 1; nrcvd < nbatch; nrcvd++)
+        {
+          flags = enter_critical_section();
+          ret = nxmq_tryreceive(mqdes->msgq, batch[nrcvd].msglen, &mqmsg);
+          leave_critical_section(flags);
+
+          if (ret < 0)
+            {
+              break;
+            }
+
+          batch[nrcvd].rcvlen = nxmq_do_receive(mqdes, mqmsg,
+                                                batch[nrcvd].msg,
+                                                &batch[nrcvd].prio);
+        }
+
+      ret = nrcvd;
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receive_batch
+ *
+ * Description:
+ *   Receive up to nbatch messages from the message queue in one call.
+ *   This behaves like mq_receive() for the first message.  Any further
+ *   messages that are already in the queue are then received into the
+ *   remaining buffers without waiting.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   batch  - Describes the buffers to receive the messages.  Each buffer
+ *            must be at least as large as the "mq_msgsize" attribute of
+ *            the message queue.
+ *   nbatch - The number of entries in batch
+ *
+ * Returned Value:
+ *   On success, the number of messages received is returned and the
+ *   length and priority of each message are returned in batch.  On
+ *   failure, -1 (ERROR) is returned and the errno is set appropriately
+ *   (see mq_receive()).
+ *
+ ****************************************************************************/
+
+int mq_receive_batch(mqd_t mqdes, FAR struct mq_rcvbatch_s *batch,
+                     int nbatch)
+{
+  int ret;
+
+  /* mq_receive_batch() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nxmq_receive_batch(mqdes, batch, nbatch);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
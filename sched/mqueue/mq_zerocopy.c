@@ -0,0 +1,398 @@
+/****************************************************************************
+ * sched/mqueue/mq_zerocopy.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <sched.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A zero-copy receiver accepts a message of any size */
+
+#define MQ_ZC_ANYSIZE ((size_t)-1)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_zcalloc
+ *
+ * Description:
+ *   Allocate a buffer for a zero-copy message from the shared heap.
+ *
+ * Input Parameters:
+ *   size - The size of the buffer in bytes
+ *
+ * Returned Value:
+ *   The address of the buffer on success; NULL if the buffer could not be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+FAR void *mq_zcalloc(size_t size)
+{
+  FAR struct mqueue_zcbuf_s *zcbuf;
+
+  zcbuf = (FAR struct mqueue_zcbuf_s *)
+    kumm_malloc(sizeof(struct mqueue_zcbuf_s) + size);
+
+  if (zcbuf == NULL)
+    {
+      return NULL;
+    }
+
+  zcbuf->size   = size;
+  zcbuf->msglen = 0;
+  return (FAR void *)(zcbuf + 1);
+}
+
+/****************************************************************************
+ * Name: mq_zcfree
+ *
+ * Description:
+ *   Free a zero-copy message buffer that is owned by the caller:  One that
+ *   was allocated by mq_zcalloc() and not sent, or one that was returned
+ *   by mq_receive_zc().
+ *
+ * Input Parameters:
+ *   buf - The buffer to free.  May be NULL.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_zcfree(FAR void *buf)
+{
+  if (buf != NULL)
+    {
+      kumm_free(MQ_ZCBUF(buf));
+    }
+}
+
+/****************************************************************************
+ * Name: nxmq_send_zc
+ *
+ * Description:
+ *   Send a message without copying the message data.  The message is in a
+ *   buffer allocated with mq_zcalloc(); ownership of the buffer moves to
+ *   the message queue and then to the receiver.  This is the internal OS
+ *   version of mq_send_zc():  It is not a cancellation point and it does
+ *   not modify the errno value.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buf    - The buffer returned by mq_zcalloc() that holds the message
+ *   msglen - The length of the message in bytes.  This is limited only by
+ *            the size of the buffer, not by the "mq_msgsize" attribute.
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see mq_send()).  The caller still owns the buffer if the
+ *   message could not be sent.
+ *
+ ****************************************************************************/
+
+int nxmq_send_zc(mqd_t mqdes, FAR void *buf, size_t msglen,
+                 unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  if (buf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (msglen > MQ_ZCBUF(buf)->size)
+    {
+      return -EMSGSIZE;
+    }
+
+  /* Only the reference to the buffer is queued.  The message queue must be
+   * able to hold it.
+   */
+
+  ret = nxmq_verify_send(mqdes, (FAR const char *)&buf, sizeof(FAR void *),
+                         prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for space in the message queue in the same way as nxmq_send() */
+
+  sched_lock();
+  msgq  = mqdes->msgq;
+  flags = enter_critical_section();
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  leave_critical_section(flags);
+  if (ret >= 0)
+    {
+      mqmsg = nxmq_alloc_msg();
+      if (mqmsg == NULL)
+        {
+          ret = -ENOMEM;
+        }
+      else
+        {
+          /* Attach the buffer to the message.  From now on, the buffer
+           * belongs to the message queue.
+           */
+
+          MQ_ZCBUF(buf)->msglen = msglen;
+          mqmsg->flags = MQMSG_FLAG_ZEROCOPY;
+
+          ret = nxmq_do_send(mqdes, mqmsg, (FAR const char *)&buf,
+                             sizeof(FAR void *), prio);
+        }
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_send_zc
+ *
+ * Description:
+ *   Send a message without copying the message data.  This behaves like
+ *   mq_send() except that the message is passed in a buffer allocated with
+ *   mq_zcalloc() and that the message length is limited only by the size
+ *   of that buffer.  After a successful send, the buffer belongs to the
+ *   receiver and must not be accessed by the caller.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buf    - The buffer returned by mq_zcalloc() that holds the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   On success, mq_send_zc() returns 0 (OK); on error, -1 (ERROR) is
+ *   returned, with errno set to indicate the error (see mq_send()).  The
+ *   caller still owns the buffer on failure.
+ *
+ ****************************************************************************/
+
+int mq_send_zc(mqd_t mqdes, FAR void *buf, size_t msglen, unsigned int prio)
+{
+  int ret;
+
+  /* mq_send_zc() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nxmq_send_zc(mqdes, buf, msglen, prio);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_zc
+ *
+ * Description:
+ *   Receive a message without copying the message data.  The caller becomes
+ *   the owner of the returned buffer and must free it with mq_zcfree().
+ *   A message that was sent with a copy is copied once into a newly
+ *   allocated buffer.  This is the internal OS version of mq_receive_zc():
+ *   It is not a cancellation point and it does not modify the errno value.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   buf   - The location to return the buffer holding the message
+ *   prio  - If not NULL, the location to return the message priority
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_zc(mqd_t mqdes, FAR void **buf,
+                        FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR void *copybuf;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (buf == NULL || mqdes == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      return -EPERM;
+    }
+
+  /* Allocate the buffer for a message that was not sent zero-copy now.
+   * Once the message is removed from the queue, it must not be lost.
+   */
+
+  copybuf = mq_zcalloc(mqdes->msgq->maxmsgsize);
+  if (copybuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Get the next message as nxmq_receive() does */
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret = nxmq_wait_receive(mqdes, &mqmsg, MQ_ZC_ANYSIZE);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+
+      if ((mqmsg->flags & MQMSG_FLAG_ZEROCOPY) != 0)
+        {
+          /* Move the ownership of the buffer to the caller */
+
+          *buf = nxmq_zcmail(mqmsg);
+          ret  = MQ_ZCBUF(*buf)->msglen;
+          mqmsg->flags = 0;
+
+          mq_zcfree(copybuf);
+        }
+      else
+        {
+          memcpy(copybuf, mqmsg->mail, mqmsg->msglen);
+          MQ_ZCBUF(copybuf)->msglen = mqmsg->msglen;
+
+          *buf = copybuf;
+          ret  = mqmsg->msglen;
+        }
+
+      if (prio != NULL)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      nxmq_free_msg(mqmsg);
+      nxmq_notify_notfull(mqdes->msgq);
+    }
+  else
+    {
+      mq_zcfree(copybuf);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receive_zc
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages from the message
+ *   queue without copying the message data.  This behaves like
+ *   mq_receive() except that the message is returned in a buffer that now
+ *   belongs to the caller and must be freed with mq_zcfree().
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   buf   - The location to return the buffer holding the message
+ *   prio  - If not NULL, the location to return the message priority
+ *
+ * Returned Value:
+ *   On success, the length of the message in bytes is returned.  On
+ *   failure, -1 (ERROR) is returned and the errno is set appropriately
+ *   (see mq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t mq_receive_zc(mqd_t mqdes, FAR void **buf, FAR unsigned int *prio)
+{
+  ssize_t ret;
+
+  /* mq_receive_zc() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nxmq_receive_zc(mqdes, buf, prio);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
@@ -47,10 +47,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <string.h>
 #include <mqueue.h>
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/mempool.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -74,24 +76,33 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* This defines the number of messages added to the message pool each time
+ * that it grows.
+ */
+
+#define NUM_EXPAND_MSGS      4
+
+/* Values of the flags field of struct mqueue_msg_s */
+
+#define MQMSG_FLAG_ZEROCOPY  (1 << 0) /* mail holds a zero-copy buffer */
+
+/* Get the header of a zero-copy buffer from the buffer address */
+
+#define MQ_ZCBUF(b)          ((FAR struct mqueue_zcbuf_s *)(b) - 1)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
-enum mqalloc_e
-{
-  MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
-  MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
-};
-
 /* This structure describes one buffered POSIX message. */
 
 struct mqueue_msg_s
 {
   FAR struct mqueue_msg_s *next;  /* Forward link to next message */
-  uint8_t type;                   /* (Used to manage allocations) */
   uint8_t priority;               /* priority of message */
+#ifdef CONFIG_MQ_ZEROCOPY
+  uint8_t flags;                  /* See MQMSG_FLAG_* definitions */
+#endif
 #if MQ_MAX_BYTES < 256
   uint8_t msglen;                 /* Message data length */
 #else
@@ -100,6 +111,18 @@ struct mqueue_msg_s
   char mail[MQ_MAX_BYTES];        /* Message data */
 };
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/* This is the header that precedes each zero-copy message buffer allocated
+ * by mq_zcalloc().  The size keeps the buffer that follows aligned.
+ */
+
+struct mqueue_zcbuf_s
+{
+  size_t size;                    /* Allocated size of the buffer */
+  size_t msglen;                  /* Length of the message in the buffer */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -112,17 +135,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_msgfree is a list of messages that are available for general use.
- * The number of messages in this list is a system configuration item.
+/* The g_msgpool is the pool of messages.  The number of pre-allocated
+ * messages is a system configuration item.  NUM_INTERRUPT_MSGS of them are
+ * reserved for use by interrupt handlers.
  */
 
-EXTERN sq_queue_t  g_msgfree;
-
-/* The g_msgfreeInt is a list of messages that are reserved for use by
- * interrupt handlers.
- */
-
-EXTERN sq_queue_t  g_msgfreeirq;
+EXTERN struct mempool_s g_msgpool;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -151,7 +169,11 @@ void nxmq_wait_irq(FAR struct tcb_s *wtcb, int errcode);
 /* mq_rcvinternal.c ********************************************************/
 
 int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen);
-int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg);
+int nxmq_tryreceive(FAR struct mqueue_inode_s *msgq, size_t msglen,
+                    FAR struct mqueue_msg_s **rcvmsg);
+int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg,
+                      size_t msglen);
+void nxmq_notify_notfull(FAR struct mqueue_inode_s *msgq);
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio);
 
@@ -177,6 +199,29 @@ void nxmq_recover(FAR struct tcb_s *tcb);
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_zcmail
+ *
+ * Description:
+ *   Return the zero-copy buffer referenced by a message.  The mail field
+ *   may not be aligned for a pointer, so the pointer is copied out.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+static inline FAR void *nxmq_zcmail(FAR struct mqueue_msg_s *mqmsg)
+{
+  FAR void *buf;
+
+  memcpy(&buf, mqmsg->mail, sizeof(FAR void *));
+  return buf;
+}
+#endif
+
 #endif /* CONFIG_MQ_MAXMSGSIZE > 0 */
 #endif /* __SCHED_MQUEUE_MQUEUE_H */
 
@@ -2,7 +2,8 @@
  * sched/paging/pg_worker.c
  * Page fill worker thread implementation.
  *
- *   Copyright (C) 2010-2011, 2017-2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2010-2011, 2017-2018, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -50,6 +51,7 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/signal.h>
 #include <nuttx/page.h>
 #include <nuttx/clock.h>
@@ -88,8 +90,14 @@ FAR struct tcb_s *g_pftcb;
 
 #ifndef CONFIG_PAGING_BLOCKINGFILL
 
-/* When a page fill completes, the result of the fill is stored here.  The
- * value -EBUSY means that the page fill callback has not yet been received.
+/* The number of page fills for g_pftcb that have not yet completed.  With
+ * CONFIG_PAGING_PREFETCH, several fills are started for one page fault.
+ */
+
+static unsigned int g_fillpending;
+
+/* When a page fill completes with an error, the first error is stored
+ * here.
  */
 
 static int g_fillresult;
@@ -103,6 +111,19 @@ static clock_t g_starttime;
 #endif
 #endif
 
+#ifdef CONFIG_PAGING_STATS
+/* The paging statistics */
+
+static struct pg_stats_s g_pgstats;
+
+/* One bit for each page of the paged text region that has been filled at
+ * least one time.  A fault on such a page means that the page was
+ * replaced.
+ */
+
+static uint8_t g_pgfilled[(CONFIG_PAGING_NVPAGED + 7) >> 3];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -121,6 +142,8 @@ static clock_t g_starttime;
  * When pg_callback() is called, it will perform the following operations:
  *
  * - Verify that g_pftcb is non-NULL.
+ * - Save the result if it is the first error.  Return if other page fills
+ *   for g_pftcb are still in progress.
  * - Find the higher priority between the task waiting for the fill to
  *   complete in g_pftcb and the task waiting at the head of the
  *   g_waitingforfill list.  That will be the priority of he highest priority
@@ -153,6 +176,22 @@ static void pg_callback(FAR struct tcb_s *tcb, int result)
     {
       FAR struct tcb_s *htcb = (FAR struct tcb_s *)g_waitingforfill.head;
       FAR struct tcb_s *wtcb = sched_gettcb(g_pgworker);
+      int priority;
+
+      /* Save the first error of the page fills */
+
+      if (result < 0 && g_fillresult == OK)
+        {
+          g_fillresult = result;
+        }
+
+      /* Nothing more to do until the last page fill completes */
+
+      DEBUGASSERT(g_fillpending > 0);
+      if (--g_fillpending > 0)
+        {
+          return;
+        }
 
       /* Find the higher priority between the task waiting for the fill to
        * complete in g_pftcb and the task waiting at the head of the
@@ -160,7 +199,7 @@ static void pg_callback(FAR struct tcb_s *tcb, int result)
        * priority task waiting for a fill.
        */
 
-      int priority = g_pftcb->sched_priority;
+      priority = g_pftcb->sched_priority;
       if (htcb && priority < htcb->sched_priority)
         {
           priority = htcb->sched_priority;
@@ -178,15 +217,6 @@ static void pg_callback(FAR struct tcb_s *tcb, int result)
                  wtcb->sched_priority, priority);
           (void)nxsched_setpriority(wtcb, priority);
         }
-
-      /* Save the page fill result (don't permit the value -EBUSY) */
-
-      if (result == -EBUSY)
-        {
-          result = -ENOSYS;
-        }
-
-      g_fillresult = result;
     }
 
   /* Signal the page fill worker thread (in any event) */
@@ -310,6 +340,98 @@ static inline bool pg_dequeue(void)
   return false;
 }
 
+/****************************************************************************
+ * Name: pg_allocprefetch
+ *
+ * Description:
+ *   Allocate the pages that follow the faulting page in vpages[0] and that
+ *   are not yet mapped, up to CONFIG_PAGING_PREFETCH pages.  The allocated
+ *   pages are added to vpages[].
+ *
+ * Input Parameters:
+ *   vpages - The faulting page, followed by room for the prefetched pages
+ *
+ * Returned Value:
+ *   The number of pages in vpages[], including the faulting page.
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_PREFETCH > 0
+static inline int pg_allocprefetch(FAR void **vpages)
+{
+  uintptr_t vaddr = (uintptr_t)vpages[0];
+  int npages = 1;
+  int result;
+  int i;
+
+  for (i = 0; i < CONFIG_PAGING_PREFETCH; i++)
+    {
+      vaddr += PAGESIZE;
+      if (vaddr >= PG_PAGED_VEND)
+        {
+          break;
+        }
+
+      if (!up_checkmapping_va(vaddr))
+        {
+          pginfo("Call up_allocpage_va(%08lx)\n", (unsigned long)vaddr);
+          result = up_allocpage_va(vaddr, &vpages[npages]);
+          DEBUGASSERT(result == OK);
+          UNUSED(result);
+          npages++;
+        }
+    }
+
+  return npages;
+}
+#endif
+
+/****************************************************************************
+ * Name: pg_updatestats
+ *
+ * Description:
+ *   Account one page fault and the pages filled for it.
+ *
+ * Input Parameters:
+ *   vpages - The faulting page, followed by the prefetched pages
+ *   npages - The number of pages in vpages[]
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_STATS
+static inline void pg_updatestats(FAR void * const *vpages, int npages)
+{
+  unsigned int ndx;
+  int i;
+
+  g_pgstats.faults++;
+  g_pgstats.fills      += npages;
+  g_pgstats.prefetches += npages - 1;
+
+  for (i = 0; i < npages; i++)
+    {
+      ndx = ((uintptr_t)vpages[i] - PG_PAGED_VBASE) >> PAGESHIFT;
+      if (i == 0 && (g_pgfilled[ndx >> 3] & (1 << (ndx & 7))) != 0)
+        {
+          g_pgstats.refaults++;
+        }
+
+      g_pgfilled[ndx >> 3] |= (1 << (ndx & 7));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pg_startfill
  *
@@ -341,8 +463,10 @@ static inline bool pg_dequeue(void)
 
 static inline bool pg_startfill(void)
 {
-  FAR void *vpage;
+  FAR void *vpages[CONFIG_PAGING_PREFETCH + 1];
+  int npages;
   int result;
+  int i;
 
   /* Remove the TCB at the head of the g_waitfor fill list and check if there
    * is any task waiting for a page fill. pg_dequeue will handle this (plus
@@ -359,9 +483,21 @@ static inline bool pg_startfill(void)
        */
 
       pginfo("Call up_allocpage(%p)\n", g_pftcb);
-      result = up_allocpage(g_pftcb, &vpage);
+      result = up_allocpage(g_pftcb, &vpages[0]);
       DEBUGASSERT(result == OK);
 
+      /* Then set aside the pages that will be prefetched (if any) */
+
+#if CONFIG_PAGING_PREFETCH > 0
+      npages = pg_allocprefetch(vpages);
+#else
+      npages = 1;
+#endif
+
+#ifdef CONFIG_PAGING_STATS
+      pg_updatestats(vpages, npages);
+#endif
+
       /* Start the fill.  The exact way that the fill is started depends upon
        * the nature of the architecture-specific up_fillpage() function -- Is it
        * a blocking or a non-blocking call?
@@ -376,9 +512,12 @@ static inline bool pg_startfill(void)
        * status of the fill will be provided by return value from up_fillpage().
        */
 
-      pginfo("Call up_fillpage(%p)\n", g_pftcb);
-      result = up_fillpage(g_pftcb, vpage);
-      DEBUGASSERT(result == OK);
+      for (i = 0; i < npages; i++)
+        {
+          pginfo("Call up_fillpage(%p, %p)\n", g_pftcb, vpages[i]);
+          result = up_fillpage(g_pftcb, vpages[i]);
+          DEBUGASSERT(result == OK);
+        }
 #else
       /* If CONFIG_PAGING_BLOCKINGFILL is defined, then up_fillpage is non-blocking
        * call. In this case up_fillpage() will accept an additional argument: The page
@@ -389,9 +528,15 @@ static inline bool pg_startfill(void)
        * This callback will probably from interrupt level.
        */
 
-      pginfo("Call up_fillpage(%p)\n", g_pftcb);
-      result = up_fillpage(g_pftcb, vpage, pg_callback);
-      DEBUGASSERT(result == OK);
+      g_fillresult  = OK;
+      g_fillpending = npages;
+
+      for (i = 0; i < npages; i++)
+        {
+          pginfo("Call up_fillpage(%p, %p)\n", g_pftcb, vpages[i]);
+          result = up_fillpage(g_pftcb, vpages[i], pg_callback);
+          DEBUGASSERT(result == OK);
+        }
 
       /* Save the time that the fill was started.  These will be used to check for
        * timeouts.
@@ -563,11 +708,11 @@ int pg_worker(int argc, char *argv[])
 
       if (g_pftcb != NULL)
         {
-          /* If it is a real page fill completion event, then the result of the page
-           * fill will be in g_fillresult and will not be equal to -EBUSY.
+          /* If it is a real page fill completion event, then all of the page
+           * fills have completed and the result will be in g_fillresult.
            */
 
-          if (g_fillresult != -EBUSY)
+          if (g_fillpending == 0)
             {
               /* Any value other than OK, brings the system down */
 
@@ -666,4 +811,35 @@ int pg_worker(int argc, char *argv[])
 
   return OK; /* To keep some compilers happy */
 }
+
+/****************************************************************************
+ * Name: pg_statistics
+ *
+ * Description:
+ *   Return the paging statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_STATS
+void pg_statistics(FAR struct pg_stats_s *stats)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(stats != NULL);
+
+  /* The page fill worker thread updates the statistics with interrupts
+   * disabled.
+   */
+
+  flags  = enter_critical_section();
+  *stats = g_pgstats;
+  leave_critical_section(flags);
+}
+#endif
 #endif /* CONFIG_PAGING */
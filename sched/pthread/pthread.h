@@ -132,6 +132,10 @@ void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 int pthread_mutexattr_verifytype(int type);
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+void pthread_mutex_spin(FAR struct pthread_mutex_s *mutex);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -259,7 +259,23 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 
   /* Allocate a TCB for the new task. */
 
-  ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+#ifdef CONFIG_SCHED_TCBCACHE
+  /* Re-use a cached TCB with a stack of the requested size, if possible */
+
+  ptcb = NULL;
+  if (attr->stackaddr == NULL)
+    {
+      ptcb = (FAR struct pthread_tcb_s *)
+        nxsched_tcbcache_alloc(TCB_FLAG_TTYPE_PTHREAD, attr->stacksize);
+    }
+
+  if (ptcb == NULL)
+#endif
+    {
+      ptcb = (FAR struct pthread_tcb_s *)
+        kmm_zalloc(sizeof(struct pthread_tcb_s));
+    }
+
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -305,12 +321,26 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
       ret = up_use_stack((FAR struct tcb_s *)ptcb, attr->stackaddr,
                          attr->stacksize);
     }
+#ifdef CONFIG_SCHED_TCBCACHE
+  else if (ptcb->cmn.stack_alloc_ptr != NULL)
+    {
+      /* The cached TCB already has its stack */
+
+      ret = OK;
+    }
+#endif
   else
     {
       /* Allocate the stack for the TCB */
 
       ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
                             TCB_FLAG_TTYPE_PTHREAD);
+
+#ifdef CONFIG_SCHED_TCBCACHE
+      /* The TCB and this stack may be cached when the thread exits */
+
+      ptcb->cmn.cache_stack_size = attr->stacksize;
+#endif
     }
 
   if (ret != OK)
@@ -485,6 +515,16 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        /* The bandwidth reservation is not inherited.  The new thread
+         * must be admitted with sched_setscheduler().
+         */
+
+        ptcb->cmn.flags    |= TCB_FLAG_SCHED_FIFO;
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         ptcb->cmn.flags    |= TCB_FLAG_SCHED_OTHER;
@@ -0,0 +1,220 @@
+/****************************************************************************
+ * sched/pthread/pthread_mutexspin.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/pthread.h>
+
+#include "sched/sched.h"
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The reasons why a spin on an adaptive mutex may end */
+
+enum pthread_spinresult_e
+{
+  PTHREAD_SPIN_SUCCESS = 0,      /* The mutex was released */
+  PTHREAD_SPIN_BLOCKED,          /* The holder is not running */
+  PTHREAD_SPIN_TIMEOUT           /* CONFIG_PTHREAD_MUTEX_SPINLOOPS expired */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_MUTEX_SPINSTATS
+struct pthread_spinstats_s g_pthread_spinstats[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_holder
+ *
+ * Description:
+ *   Return the TCB of the thread with the given ID without entering the
+ *   critical section.  Taking the critical section here would contend with
+ *   the holder that is trying to release the mutex.  The result is only a
+ *   hint and NULL is returned if the thread no longer exists.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *pthread_mutex_holder(pid_t pid)
+{
+  FAR struct pidhash_s *hash = &g_pidhash[PIDHASH(pid)];
+  FAR struct tcb_s *tcb = hash->tcb;
+
+  return hash->pid == pid ? tcb : NULL;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_spinstats
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_MUTEX_SPINSTATS
+static void pthread_mutex_spinstats(enum pthread_spinresult_e result,
+                                    int nloops)
+{
+  FAR struct pthread_spinstats_s *stats;
+  irqstate_t flags;
+
+  /* Disable local interrupts so that we cannot migrate to another CPU
+   * while the counts of this CPU are updated.
+   */
+
+  flags = up_irq_save();
+  stats = &g_pthread_spinstats[this_cpu()];
+
+  switch (result)
+    {
+      case PTHREAD_SPIN_SUCCESS:
+        stats->nsuccess++;
+        stats->nloops += nloops;
+        break;
+
+      case PTHREAD_SPIN_BLOCKED:
+        stats->nblocked++;
+        break;
+
+      default:
+        stats->ntimeout++;
+        break;
+    }
+
+  up_irq_restore(flags);
+}
+#else
+#  define pthread_mutex_spinstats(r,n)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_spin
+ *
+ * Description:
+ *   Called from pthread_mutex_timedlock() before locking an adaptive mutex.
+ *   If the mutex is held by a thread that is running on another CPU, then
+ *   it will probably be released soon.  In that case poll the mutex until
+ *   it is released, the holder stops running, or the spin limit of
+ *   CONFIG_PTHREAD_MUTEX_SPINLOOPS is reached.
+ *
+ *   The mutex is not taken here; the caller then locks it in the normal
+ *   way, which will usually not block.
+ *
+ * Input Parameters:
+ *   mutex - The adaptive mutex to be locked
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from a thread with the scheduler unlocked.  Spinning with the
+ *   scheduler locked would hold off context switches on every CPU.
+ *
+ ****************************************************************************/
+
+void pthread_mutex_spin(FAR struct pthread_mutex_s *mutex)
+{
+  FAR struct tcb_s *htcb = NULL;
+  pid_t holder = -1;
+  int nloops;
+
+  for (nloops = 0; nloops < CONFIG_PTHREAD_MUTEX_SPINLOOPS; nloops++)
+    {
+      pid_t pid;
+
+      /* Is the mutex available? */
+
+      if (mutex->sem.semcount > 0)
+        {
+          if (nloops > 0)
+            {
+              pthread_mutex_spinstats(PTHREAD_SPIN_SUCCESS, nloops);
+            }
+
+          return;
+        }
+
+      /* Look up the holder again whenever it changes.  The holder ID is
+       * briefly invalid while the mutex is being locked and unlocked.
+       */
+
+      pid = mutex->pid;
+      if (pid <= 0)
+        {
+          continue;
+        }
+
+      if (pid != holder)
+        {
+          holder = pid;
+          htcb   = pthread_mutex_holder(pid);
+        }
+
+      /* Spinning is useless if the holder has exited or is not running on
+       * another CPU.
+       */
+
+      if (htcb == NULL || htcb->task_state != TSTATE_TASK_RUNNING ||
+          pthread_mutex_holder(pid) != htcb)
+        {
+          pthread_mutex_spinstats(PTHREAD_SPIN_BLOCKED, nloops);
+          return;
+        }
+    }
+
+  pthread_mutex_spinstats(PTHREAD_SPIN_TIMEOUT, nloops);
+}
+
+#endif /* CONFIG_PTHREAD_MUTEX_ADAPTIVE */
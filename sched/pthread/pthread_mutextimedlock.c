@@ -101,6 +101,18 @@ int pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
 
   if (mutex != NULL)
     {
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+      /* If an adaptive mutex is held by a thread running on another CPU,
+       * then spin for a while to give that thread a chance to release it.
+       * This must be done before the scheduler is locked.
+       */
+
+      if (mutex->type == PTHREAD_MUTEX_ADAPTIVE_NP && mutex->pid != mypid)
+        {
+          pthread_mutex_spin(mutex);
+        }
+
+#endif
       /* Make sure the semaphore is stable while we make the following
        * checks.  This all needs to be one atomic action.
        */
@@ -1,7 +1,8 @@
 /****************************************************************************
  * sched/sched/sched.h
  *
- *   Copyright (C) 2007-2014, 2016, 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2014, 2016, 2018, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -119,6 +120,29 @@
 #  define TLIST_BLOCKED(s)       __TLIST_HEAD(s)
 #endif
 
+/* The ready-to-run and pending task lists may be indexed by priority.  The
+ * index holds one bit for each priority level that is present in the list
+ * and a pointer to the last TCB of each of those levels.
+ */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+#  define SCHED_PRIOINDEX_NWORDS ((SCHED_PRIORITY_MAX + 32) >> 5)
+
+#  define sched_prioindex(l) \
+  ((l) == (FAR dq_queue_t *)&g_readytorun ? &g_readytorun_index : \
+   (l) == (FAR dq_queue_t *)&g_pendingtasks ? &g_pendingtasks_index : NULL)
+#else
+#  define sched_removeprioritized(t,l) dq_rem((FAR dq_entry_t *)(t), (l))
+#endif
+
+/* Delayed memory deallocations are queued per CPU */
+
+#ifdef CONFIG_SMP
+#  define DELAYED_NQUEUES        CONFIG_SMP_NCPUS
+#else
+#  define DELAYED_NQUEUES        1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -153,6 +177,35 @@ struct tasklist_s
   uint8_t attr;                   /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* This structure is the priority index of a prioritized task list.  The
+ * list is still a single doubly linked list in descending priority order;
+ * the index only records where each priority level ends so that a TCB can
+ * be inserted without searching the list.
+ */
+
+struct sched_prioindex_s
+{
+  uint32_t bitmap[SCHED_PRIOINDEX_NWORDS];      /* Priority levels present */
+  FAR struct tcb_s *last[SCHED_PRIORITY_MAX + 1]; /* Last TCB of each level */
+};
+#endif
+
+/* This structure is one queue of delayed memory deallocations */
+
+struct delayed_free_s
+{
+  sq_queue_t queue;            /* The memory waiting to be freed */
+#ifdef CONFIG_SPINLOCK_SCOPED
+  spinlock_t lock;             /* Protects the queue */
+#endif
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+  size_t ndeferred;            /* Total number of deallocations queued */
+  size_t depth;                /* Number of deallocations now queued */
+  size_t maxdepth;             /* Largest number ever queued */
+#endif
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -229,6 +282,15 @@ extern FAR struct tcb_s *g_running_tasks[1];
 
 extern volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* These are the priority indices of the g_readytorun and g_pendingtasks
+ * lists.
+ */
+
+extern struct sched_prioindex_s g_readytorun_index;
+extern struct sched_prioindex_s g_pendingtasks_index;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 extern volatile dq_queue_t g_waitingforsemaphore;
@@ -268,12 +330,13 @@ extern volatile dq_queue_t g_inactivetasks;
 /* These are lists of dayed memory deallocations that need to be handled
  * within the IDLE loop or worker thread.  These deallocations get queued
  * by sched_kufree and sched_kfree() if the OS needs to deallocate memory
- * while it is within an interrupt handler.
+ * while it is within an interrupt handler.  There is one list per CPU so
+ * that the lists are drained in batches without contention between CPUs.
  */
 
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
-extern volatile sq_queue_t g_delayed_kfree;
+extern volatile struct delayed_free_s g_delayed_kfree[DELAYED_NQUEUES];
 #endif
 
 #ifndef CONFIG_BUILD_KERNEL
@@ -285,7 +348,7 @@ extern volatile sq_queue_t g_delayed_kfree;
  * a group-by-group basis.
  */
 
-extern volatile sq_queue_t g_delayed_kufree;
+extern volatile struct delayed_free_s g_delayed_kufree[DELAYED_NQUEUES];
 #endif
 
 /* This is the value of the last process ID assigned to a task */
@@ -413,9 +476,15 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
+#ifdef CONFIG_SCHED_PRIOBITMAP
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#endif
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
+#ifdef CONFIG_SMP
+void sched_idle_balance(void);
+#endif
 
 /* Priority inheritance support */
 
@@ -457,6 +526,26 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  sched_deadline_start(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+int  sched_deadline_stop(FAR struct tcb_s *tcb);
+void sched_deadline_resume(FAR struct tcb_s *tcb);
+void sched_deadline_suspend(FAR struct tcb_s *tcb);
+
+/* True if TCB 'a' must be placed before TCB 'b' of the same priority:  Both
+ * use the deadline policy and 'a' has the earlier absolute deadline.
+ */
+
+#  define sched_deadline_before(a,b) \
+     (((a)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE && \
+      ((b)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE && \
+      (sclock_t)((a)->deadline->abs_deadline - \
+                 (b)->deadline->abs_deadline) < 0)
+#else
+#  define sched_deadline_before(a,b) (false)
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void sched_suspend(FAR struct tcb_s *tcb);
 void sched_continue(FAR struct tcb_s *tcb);
@@ -468,6 +557,11 @@ FAR struct tcb_s *this_task(void);
 #endif
 
 int  sched_cpu_select(cpu_set_t affinity);
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINE
+int  sched_cpu_select_task(FAR struct tcb_s *tcb);
+#else
+#  define sched_cpu_select_task(t) sched_cpu_select((t)->affinity)
+#endif
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
 
 irqstate_t sched_tasklist_lock(void);
@@ -485,6 +579,7 @@ void sched_tasklist_unlock(irqstate_t lock);
 
 #else
 #  define sched_cpu_select(a)     (0)
+#  define sched_cpu_select_task(t) (0)
 #  define sched_cpu_pause(t)      (-38)  /* -ENOSYS */
 #  define sched_islocked_tcb(tcb) ((tcb)->lockcount > 0)
 #endif
@@ -495,6 +590,12 @@ void sched_tasklist_unlock(irqstate_t lock);
 void weak_function nxsched_process_cpuload(void);
 #endif
 
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_SCHED_PROFILE_EXTCLK)
+/* Sampling profiler support */
+
+void weak_function nxsched_process_profile(void);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -504,9 +605,45 @@ void sched_critmon_resume(FAR struct tcb_s *tcb);
 void sched_critmon_suspend(FAR struct tcb_s *tcb);
 #endif
 
+/* Record the caller of sched_lock() or enter_critical_section() and the
+ * duration of an interrupt handler in the critical section monitor
+ * histograms.  sched_critmon_caller() must be expanded within sched_lock()
+ * or enter_critical_section() themselves.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+#  ifdef __GNUC__
+#    define sched_critmon_caller(f) \
+       ((f) = (uintptr_t)__builtin_return_address(0))
+#  else
+#    define sched_critmon_caller(f) ((f) = 0)
+#  endif
+void sched_critmon_irq(uint32_t elapsed);
+#else
+#  define sched_critmon_caller(f)
+#  define sched_critmon_irq(e)
+#endif
+
+/* Exact CPU time accounting */
+
+#ifdef CONFIG_SCHED_CPUACCT
+void sched_cpuacct_resume(FAR struct tcb_s *tcb);
+void sched_cpuacct_suspend(FAR struct tcb_s *tcb);
+void sched_cpuacct_irqenter(void);
+void sched_cpuacct_irqleave(void);
+#else
+#  define sched_cpuacct_irqenter()
+#  define sched_cpuacct_irqleave()
+#endif
+
 /* TCB operations */
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int  sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+#ifdef CONFIG_SCHED_TCBCACHE
+FAR struct tcb_s *nxsched_tcbcache_alloc(uint8_t ttype, size_t stack_size);
+bool nxsched_tcbcache_free(FAR struct tcb_s *tcb, uint8_t ttype);
+#endif
+
 #endif /* __SCHED_SCHED_SCHED_H */
@@ -41,11 +41,64 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <strings.h>
 #include <queue.h>
 #include <assert.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex_find
+ *
+ * Description:
+ *   Use the priority index of a list to find the TCB after which a TCB of
+ *   the given priority must be inserted.  That is the last TCB of the
+ *   lowest priority level that is greater than or equal to the priority.
+ *   The cost depends only on the number of bitmap words, not on the number
+ *   of TCBs in the list.
+ *
+ * Input Parameters:
+ *   index - The priority index of the list
+ *   sched_priority - The priority of the TCB to be inserted
+ *
+ * Returned Value:
+ *   The TCB to insert after or NULL if the TCB goes at the head of the
+ *   list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+static FAR struct tcb_s *
+sched_prioindex_find(FAR struct sched_prioindex_s *index,
+                     uint8_t sched_priority)
+{
+  uint32_t bits;
+  int ndx;
+
+  ndx  = sched_priority >> 5;
+  bits = index->bitmap[ndx] & ~((1ul << (sched_priority & 31)) - 1);
+
+  for (; ; )
+    {
+      if (bits != 0)
+        {
+          return index->last[(ndx << 5) + ffs((int)bits) - 1];
+        }
+
+      if (++ndx >= SCHED_PRIOINDEX_NWORDS)
+        {
+          return NULL;
+        }
+
+      bits = index->bitmap[ndx];
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,17 +135,54 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
   FAR struct tcb_s *prev;
   uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  FAR struct sched_prioindex_s *index;
+#endif
 
   /* Lets do a sanity check before we get started. */
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* If the list is indexed, then the insertion point is found from the
+   * index.  The new TCB becomes the last TCB of its priority level.  A
+   * deadline TCB must be ordered by deadline within its priority level, so
+   * it is inserted by the search below.
+   */
+
+  index = sched_prioindex(list);
+  if (index != NULL
+#ifdef CONFIG_SCHED_DEADLINE
+      && (tcb->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_DEADLINE
+#endif
+     )
+    {
+      prev = sched_prioindex_find(index, sched_priority);
+      if (prev == NULL)
+        {
+          dq_addfirst((FAR dq_entry_t *)tcb, list);
+          ret = true;
+        }
+      else
+        {
+          dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+        }
+
+      index->last[sched_priority] = tcb;
+      index->bitmap[sched_priority >> 5] |= (1ul << (sched_priority & 31));
+      return ret;
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+   * Each is list is maintained in descending sched_priority order.  Within
+   * a priority level, deadline TCBs are ordered by their absolute deadline.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && (sched_priority < next->sched_priority ||
+                 (sched_priority == next->sched_priority &&
+                  !sched_deadline_before(tcb, next))));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
@@ -151,6 +241,20 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
         }
     }
 
+#if defined(CONFIG_SCHED_PRIOBITMAP) && defined(CONFIG_SCHED_DEADLINE)
+  /* Update the index if a deadline TCB was inserted into an indexed list */
+
+  if (index != NULL)
+    {
+      if (tcb->flink == NULL || tcb->flink->sched_priority != sched_priority)
+        {
+          index->last[sched_priority] = tcb;
+        }
+
+      index->bitmap[sched_priority >> 5] |= (1ul << (sched_priority & 31));
+    }
+#endif
+
   return ret;
 }
 
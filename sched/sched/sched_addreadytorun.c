@@ -192,7 +192,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        * (possibly its IDLE task).
        */
 
-      cpu = sched_cpu_select(btcb->affinity);
+      cpu = sched_cpu_select_task(btcb);
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -0,0 +1,407 @@
+/****************************************************************************
+ * sched/sched/sched_cpuacct.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUACCT
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CONFIG_SCHED_CPUACCT requires 64-bit integer support
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define CPUACCT_NCPUS       CONFIG_SMP_NCPUS
+#  define CPUACCT_ISIDLE(tcb) ((tcb)->pid < CONFIG_SMP_NCPUS)
+#else
+#  define CPUACCT_NCPUS       1
+#  define CPUACCT_ISIDLE(tcb) ((tcb)->pid == 0)
+#endif
+
+/* Elapsed times are converted to nanoseconds in chunks of this many time
+ * units.  up_critmon_convert() only accepts a 32-bit elapsed time.
+ */
+
+#define CPUACCT_CHUNK_SHIFT   31
+#define CPUACCT_CHUNK         ((uint32_t)1 << CPUACCT_CHUNK_SHIFT)
+#define CPUACCT_CHUNK_MASK    (CPUACCT_CHUNK - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The accounting state of one CPU.  All times are in the units of
+ * up_critmon_gettime().
+ */
+
+struct cpuacct_state_s
+{
+  uint32_t start;               /* Time the current interval started */
+  bool running;                 /* A thread interval is being timed */
+  uint8_t nesting;              /* Interrupt nesting level */
+  FAR struct tcb_s *irqtcb;     /* The thread interrupted by the interrupt */
+  uint64_t busy;                /* Time running threads other than IDLE */
+  uint64_t idle;                /* Time running the IDLE thread */
+  uint64_t irq;                 /* Time in interrupt handlers */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct cpuacct_state_s g_cpuacct[CPUACCT_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_cpuacct_charge
+ *
+ * Description:
+ *   Charge the elapsed run time to the thread and to the CPU.
+ *
+ ****************************************************************************/
+
+static void sched_cpuacct_charge(FAR struct cpuacct_state_s *state,
+                                 FAR struct tcb_s *tcb, uint32_t elapsed)
+{
+  tcb->run_time += elapsed;
+
+  if (CPUACCT_ISIDLE(tcb))
+    {
+      state->idle += elapsed;
+    }
+  else
+    {
+      state->busy += elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct_convert
+ *
+ * Description:
+ *   Convert an accumulated time in the units of up_critmon_gettime() to
+ *   nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t sched_cpuacct_convert(uint64_t elapsed)
+{
+  struct timespec ts;
+  uint64_t nsec;
+
+  up_critmon_convert((uint32_t)(elapsed & CPUACCT_CHUNK_MASK), &ts);
+  nsec = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+  elapsed >>= CPUACCT_CHUNK_SHIFT;
+  if (elapsed > 0)
+    {
+      up_critmon_convert(CPUACCT_CHUNK, &ts);
+      nsec += elapsed * ((uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+    }
+
+  return nsec;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_cpuacct_resume
+ *
+ * Description:
+ *   Called when a thread resumes execution on this CPU.  Timing of the new
+ *   thread interval begins.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct cpuacct_state_s *state = &g_cpuacct[this_cpu()];
+  uint32_t now;
+
+  /* Within an interrupt handler, the interval begins on interrupt exit */
+
+  if (state->nesting > 0)
+    {
+      return;
+    }
+
+  now = up_critmon_gettime();
+
+  /* If the previous thread was not suspended (for example, because it
+   * exited), then its time can only be charged to the CPU.
+   */
+
+  if (state->running)
+    {
+      state->busy += now - state->start;
+    }
+
+  state->start   = now;
+  state->running = true;
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct_suspend
+ *
+ * Description:
+ *   Called when a thread is suspended on this CPU.  The time since the
+ *   thread was resumed (or since the last interrupt was handled) is charged
+ *   to the thread.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_suspend(FAR struct tcb_s *tcb)
+{
+  FAR struct cpuacct_state_s *state = &g_cpuacct[this_cpu()];
+  uint32_t now;
+
+  /* Within an interrupt handler, the thread was already charged on
+   * interrupt entry.
+   */
+
+  if (state->nesting > 0 || !state->running)
+    {
+      return;
+    }
+
+  now = up_critmon_gettime();
+  sched_cpuacct_charge(state, tcb, now - state->start);
+
+  state->start   = now;
+  state->running = false;
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct_irqenter
+ *
+ * Description:
+ *   Called by irq_dispatch() before the interrupt handler is called.  On
+ *   entry to the outermost interrupt, the interrupted thread is charged for
+ *   its run time and timing of the interrupt begins.
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_irqenter(void)
+{
+  FAR struct cpuacct_state_s *state = &g_cpuacct[this_cpu()];
+  FAR struct tcb_s *tcb;
+  uint32_t now;
+
+  if (state->nesting++ > 0)
+    {
+      return;
+    }
+
+  now = up_critmon_gettime();
+  tcb = this_task();
+
+  if (state->running)
+    {
+      sched_cpuacct_charge(state, tcb, now - state->start);
+    }
+
+  state->irqtcb = tcb;
+  state->start  = now;
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct_irqleave
+ *
+ * Description:
+ *   Called by irq_dispatch() after the interrupt handler returns.  On exit
+ *   from the outermost interrupt, the interrupt time is charged to the CPU
+ *   and to the interrupted thread and timing of the thread that will run
+ *   next begins.  That may not be the interrupted thread if the interrupt
+ *   caused a context switch.
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic with interrupts disabled.  The
+ *   interrupted thread cannot be deleted by the interrupt handler.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_irqleave(void)
+{
+  FAR struct cpuacct_state_s *state = &g_cpuacct[this_cpu()];
+  uint32_t now;
+  uint32_t elapsed;
+
+  DEBUGASSERT(state->nesting > 0);
+  if (--state->nesting > 0)
+    {
+      return;
+    }
+
+  now     = up_critmon_gettime();
+  elapsed = now - state->start;
+
+  state->irq             += elapsed;
+  state->irqtcb->irq_time += elapsed;
+  state->irqtcb            = NULL;
+
+  state->start   = now;
+  state->running = true;
+}
+
+/****************************************************************************
+ * Name:  clock_cpuacct
+ *
+ * Description:
+ *   Return the exact CPU time used by the select PID.
+ *
+ * Input Parameters:
+ *   pid - The task ID of the thread of interest.
+ *   cpuacct - The location to return the CPU time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+int clock_cpuacct(int pid, FAR struct cpuacct_s *cpuacct)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t run_time = 0;
+  uint64_t irq_time = 0;
+  int ret = -ESRCH;
+
+  DEBUGASSERT(cpuacct != NULL);
+
+  /* The TCB must stay valid and the times must be sampled together */
+
+  flags = enter_critical_section();
+
+  tcb = sched_gettcb(pid);
+  if (tcb != NULL)
+    {
+      run_time = tcb->run_time;
+      irq_time = tcb->irq_time;
+      ret      = OK;
+    }
+
+  leave_critical_section(flags);
+
+  /* The time the thread has run since it was last charged is not included.
+   * That is never longer than the time until the next interrupt.
+   */
+
+  cpuacct->run = sched_cpuacct_convert(run_time);
+  cpuacct->irq = sched_cpuacct_convert(irq_time);
+  return ret;
+}
+
+/****************************************************************************
+ * Name:  clock_cpuacct_cpu
+ *
+ * Description:
+ *   Return the exact busy, IDLE, and interrupt time of the select CPU.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU of interest
+ *   cpuacct - The location to return the CPU time
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+int clock_cpuacct_cpu(int cpu, FAR struct cpuacct_cpu_s *cpuacct)
+{
+  FAR struct cpuacct_state_s *state;
+  irqstate_t flags;
+  uint64_t busy;
+  uint64_t idle;
+  uint64_t irq;
+
+  DEBUGASSERT(cpuacct != NULL);
+
+  if (cpu < 0 || cpu >= CPUACCT_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  state = &g_cpuacct[cpu];
+
+  flags = enter_critical_section();
+  busy  = state->busy;
+  idle  = state->idle;
+  irq   = state->irq;
+  leave_critical_section(flags);
+
+  cpuacct->busy = sched_cpuacct_convert(busy);
+  cpuacct->idle = sched_cpuacct_convert(idle);
+  cpuacct->irq  = sched_cpuacct_convert(irq);
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_CPUACCT */
@@ -40,9 +40,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <limits.h>
 #include <assert.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/power/pm.h>
 
 #include "sched/sched.h"
 
@@ -54,6 +56,46 @@
 
 #define IMPOSSIBLE_CPU 0xff
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  sched_cpu_rank
+ *
+ * Description:
+ *   Rank a CPU that is running a task of the lowest priority found so far
+ *   for the placement of the woken task.  Lower is better:
+ *
+ *     0 - The CPU on which the task last ran
+ *     1 - The current CPU, which does not have to be paused
+ *     2 - Another CPU that is not in a low power state
+ *     3 - A CPU that is in a low power state (PM_STANDBY or deeper)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINE
+static int sched_cpu_rank(int cpu, int prevcpu, int me)
+{
+  if (cpu == prevcpu)
+    {
+      return 0;
+    }
+  else if (cpu == me)
+    {
+      return 1;
+    }
+#ifdef CONFIG_PM
+  else if (pm_cpu_querystate(cpu) >= PM_STANDBY)
+    {
+      return 3;
+    }
+#endif
+
+  return 2;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -63,7 +105,9 @@
  *
  * Description:
  *   Return the index to the CPU with the lowest priority running task,
- *   possbily its IDLE task.
+ *   possbily its IDLE task.  If several CPUs are running tasks of that
+ *   same lowest priority, then the current CPU is preferred so that the
+ *   task can be started locally without pausing another CPU.
  *
  * Input Parameters:
  *   affinity - The set of CPUs on which the thread is permitted to run.
@@ -78,24 +122,47 @@
 
 int sched_cpu_select(cpu_set_t affinity)
 {
+  FAR struct tcb_s *rtcb;
   uint8_t minprio;
   int cpu;
+  int me;
   int i;
 
-  /* Otherwise, find the CPU that is executing the lowest priority task
-   * (possibly its IDLE task).
-   */
-
   minprio = SCHED_PRIORITY_MAX;
   cpu     = IMPOSSIBLE_CPU;
 
+  /* Check the current CPU first.  Starting the task on this CPU is
+   * cheapest since no other CPU has to be paused.
+   */
+
+  me = this_cpu();
+  if ((affinity & (1 << me)) != 0)
+    {
+      rtcb = (FAR struct tcb_s *)g_assignedtasks[me].head;
+      if (rtcb->flink == NULL)
+        {
+          /* This CPU is executing its IDLE task */
+
+          DEBUGASSERT(rtcb->sched_priority == 0);
+          return me;
+        }
+
+      minprio = rtcb->sched_priority;
+      cpu     = me;
+    }
+
+  /* Otherwise, find the CPU that is executing the lowest priority task
+   * (possibly its IDLE task).  Another CPU is selected only if its task
+   * has strictly lower priority.
+   */
+
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       /* If the thread permitted to run on this CPU? */
 
-      if ((affinity & (1 << i)) != 0)
+      if (i != me && (affinity & (1 << i)) != 0)
         {
-          FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+          rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
 
           /* If this thread is executing its IDLE task, the use it.  The
            * IDLE task is always the last task in the assigned task list.
@@ -110,7 +177,7 @@ int sched_cpu_select(cpu_set_t affinity)
               DEBUGASSERT(rtcb->sched_priority == 0);
               return i;
             }
-          else if (rtcb->sched_priority < minprio)
+          else if (cpu == IMPOSSIBLE_CPU || rtcb->sched_priority < minprio)
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
@@ -123,4 +190,81 @@ int sched_cpu_select(cpu_set_t affinity)
   return cpu;
 }
 
+/****************************************************************************
+ * Name:  sched_cpu_select_task
+ *
+ * Description:
+ *   Return the index of the CPU on which a task that has become ready to
+ *   run should be placed.  As with sched_cpu_select(), only the CPUs
+ *   running the lowest priority task, possibly their IDLE task, are
+ *   considered.  Among those, the CPU on which the task last ran is
+ *   preferred since its cache may still be warm, then the current CPU, then
+ *   a CPU that is not in a low power state and only then a CPU that would
+ *   have to be brought out of a low power state.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task that has become ready to run.
+ *
+ * Returned Value:
+ *   Index of the selected CPU
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINE
+int sched_cpu_select_task(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *rtcb;
+  uint8_t minprio;
+  int minrank;
+  int prevcpu;
+  int rank;
+  int cpu;
+  int me;
+  int i;
+
+  minprio = SCHED_PRIORITY_MAX;
+  minrank = INT_MAX;
+  prevcpu = tcb->cpu;
+  cpu     = IMPOSSIBLE_CPU;
+  me      = this_cpu();
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      /* If the thread permitted to run on this CPU? */
+
+      if ((tcb->affinity & (1 << i)) == 0)
+        {
+          continue;
+        }
+
+      /* The IDLE task has priority zero and is always the last task in the
+       * assigned task list.
+       */
+
+      rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+      DEBUGASSERT(rtcb->flink != NULL || rtcb->sched_priority == 0);
+
+      if (cpu != IMPOSSIBLE_CPU && rtcb->sched_priority > minprio)
+        {
+          continue;
+        }
+
+      rank = sched_cpu_rank(i, prevcpu, me);
+      if (cpu == IMPOSSIBLE_CPU || rtcb->sched_priority < minprio ||
+          rank < minrank)
+        {
+          minprio = rtcb->sched_priority;
+          minrank = rank;
+          cpu     = i;
+        }
+    }
+
+  DEBUGASSERT(cpu != IMPOSSIBLE_CPU);
+  return cpu;
+}
+#endif
+
 #endif /* CONFIG_SMP */
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <string.h>
 
 #include "sched/sched.h"
 
@@ -74,6 +75,121 @@ uint32_t g_premp_max[1];
 uint32_t g_crit_max[1];
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* Histograms and longest intervals of each CPU */
+
+#ifdef CONFIG_SMP_NCPUS
+struct critmon_cpuhist_s g_critmon_hist[CONFIG_SMP_NCPUS];
+#else
+struct critmon_cpuhist_s g_critmon_hist[1];
+#endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/****************************************************************************
+ * Name: critmon_bucket
+ *
+ * Description:
+ *   Return the histogram bucket of an interval:  floor(log2(elapsed)),
+ *   limited to the last bucket.
+ *
+ ****************************************************************************/
+
+static inline int critmon_bucket(uint32_t elapsed)
+{
+  int bucket;
+
+  if (elapsed == 0)
+    {
+      return 0;
+    }
+
+#ifdef __GNUC__
+  bucket = 31 - __builtin_clz(elapsed);
+#else
+  for (bucket = 0; (elapsed >>= 1) != 0; bucket++);
+#endif
+
+  if (bucket >= CONFIG_SCHED_CRITMONITOR_NBUCKETS)
+    {
+      bucket = CONFIG_SCHED_CRITMONITOR_NBUCKETS - 1;
+    }
+
+  return bucket;
+}
+
+/****************************************************************************
+ * Name: critmon_record
+ *
+ * Description:
+ *   Record one interval of a thread in the thread histogram and, if it is
+ *   one of the longest seen on this CPU, in the list of top offenders.
+ *
+ ****************************************************************************/
+
+static void critmon_record(FAR uint32_t *hist,
+                           FAR struct critmon_offender_s *top,
+                           FAR struct tcb_s *tcb, uintptr_t caller,
+                           uint32_t elapsed)
+{
+  FAR struct critmon_offender_s *min = &top[0];
+  int i;
+
+  hist[critmon_bucket(elapsed)]++;
+
+  /* Replace the shortest of the top offenders */
+
+  for (i = 1; i < CONFIG_SCHED_CRITMONITOR_NOFFENDERS; i++)
+    {
+      if (top[i].elapsed < min->elapsed)
+        {
+          min = &top[i];
+        }
+    }
+
+  if (elapsed > min->elapsed)
+    {
+      min->caller  = caller;
+      min->elapsed = elapsed;
+      min->pid     = tcb->pid;
+    }
+}
+
+/****************************************************************************
+ * Name: critmon_reset_thread
+ *
+ * Description:
+ *   sched_foreach() callback that clears the histograms of one thread.
+ *
+ ****************************************************************************/
+
+static void critmon_reset_thread(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  memset(tcb->premp_hist, 0, sizeof(tcb->premp_hist));
+  memset(tcb->crit_hist, 0, sizeof(tcb->crit_hist));
+}
+
+#  define critmon_record_premp(cpu,tcb,elapsed) \
+     critmon_record((tcb)->premp_hist, g_critmon_hist[cpu].premp_top, \
+                    (tcb), (tcb)->premp_caller, (elapsed))
+#  define critmon_record_crit(cpu,tcb,elapsed) \
+     critmon_record((tcb)->crit_hist, g_critmon_hist[cpu].crit_top, \
+                    (tcb), (tcb)->crit_caller, (elapsed))
+#  define critmon_global_premp(cpu,elapsed) \
+     g_critmon_hist[cpu].premp[critmon_bucket(elapsed)]++
+#  define critmon_global_crit(cpu,elapsed) \
+     g_critmon_hist[cpu].crit[critmon_bucket(elapsed)]++
+#else
+#  define critmon_record_premp(cpu,tcb,elapsed)
+#  define critmon_record_crit(cpu,tcb,elapsed)
+#  define critmon_global_premp(cpu,elapsed)
+#  define critmon_global_crit(cpu,elapsed)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -123,6 +239,7 @@ void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
       DEBUGASSERT(now != 0);
 
       tcb->premp_start = 0;
+      critmon_record_premp(cpu, tcb, elapsed);
       if (elapsed > tcb->premp_max)
         {
           tcb->premp_max = elapsed;
@@ -135,6 +252,7 @@ void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
           elapsed            = now - g_premp_start[cpu];
           g_premp_start[cpu] = 0;
 
+          critmon_global_premp(cpu, elapsed);
           if (elapsed > g_premp_max[cpu])
             {
               g_premp_max[cpu] = elapsed;
@@ -187,6 +305,7 @@ void sched_critmon_csection(FAR struct tcb_s *tcb, bool state)
       DEBUGASSERT(now != 0);
 
       tcb->crit_start = 0;
+      critmon_record_crit(cpu, tcb, elapsed);
       if (elapsed > tcb->crit_max)
         {
           tcb->crit_max = elapsed;
@@ -199,6 +318,7 @@ void sched_critmon_csection(FAR struct tcb_s *tcb, bool state)
           elapsed           = now - g_crit_start[cpu];
           g_crit_start[cpu] = 0;
 
+          critmon_global_crit(cpu, elapsed);
           if (elapsed > g_crit_max[cpu])
             {
               g_crit_max[cpu] = elapsed;
@@ -250,6 +370,7 @@ void sched_critmon_resume(FAR struct tcb_s *tcb)
       elapsed            = up_critmon_gettime() - g_premp_start[cpu];
       g_premp_start[cpu] = 0;
 
+      critmon_global_premp(cpu, elapsed);
       if (elapsed > g_premp_max[cpu])
         {
           g_premp_max[cpu] = elapsed;
@@ -277,6 +398,7 @@ void sched_critmon_resume(FAR struct tcb_s *tcb)
       elapsed      = up_critmon_gettime() - g_crit_start[cpu];
       g_crit_start[cpu] = 0;
 
+      critmon_global_crit(cpu, elapsed);
       if (elapsed > g_crit_max[cpu])
         {
           g_crit_max[cpu] = elapsed;
@@ -299,6 +421,9 @@ void sched_critmon_resume(FAR struct tcb_s *tcb)
 
 void sched_critmon_suspend(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  int cpu = this_cpu();
+#endif
   uint32_t elapsed;
 
   /* Did this task disable preemption? */
@@ -310,6 +435,7 @@ void sched_critmon_suspend(FAR struct tcb_s *tcb)
       elapsed = up_critmon_gettime() - tcb->premp_start;
 
       tcb->premp_start = 0;
+      critmon_record_premp(cpu, tcb, elapsed);
       if (elapsed > tcb->premp_max)
         {
           tcb->premp_max = elapsed;
@@ -325,6 +451,7 @@ void sched_critmon_suspend(FAR struct tcb_s *tcb)
       elapsed = up_critmon_gettime() - tcb->crit_start;
 
       tcb->crit_start = 0;
+      critmon_record_crit(cpu, tcb, elapsed);
       if (elapsed > tcb->crit_max)
         {
           tcb->crit_max = elapsed;
@@ -332,4 +459,42 @@ void sched_critmon_suspend(FAR struct tcb_s *tcb)
     }
 }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/****************************************************************************
+ * Name: sched_critmon_irq
+ *
+ * Description:
+ *   Called after an interrupt handler has run with the time spent in the
+ *   handler.
+ *
+ * Assumptions:
+ *   - Called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_critmon_irq(uint32_t elapsed)
+{
+  g_critmon_hist[this_cpu()].irq[critmon_bucket(elapsed)]++;
+}
+
+/****************************************************************************
+ * Name: sched_critmon_reset
+ *
+ * Description:
+ *   Clear the histograms and the top offenders of all CPUs and all
+ *   threads.  The maximum times are not affected.
+ *
+ ****************************************************************************/
+
+void sched_critmon_reset(void)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  memset(g_critmon_hist, 0, sizeof(g_critmon_hist));
+  sched_foreach(critmon_reset_thread, NULL);
+  leave_critical_section(flags);
+}
+#endif
+
 #endif
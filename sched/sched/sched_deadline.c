@@ -0,0 +1,431 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The admission limit as a 16.16 fraction of the CPU */
+
+#define DEADLINE_MAXBANDWIDTH \
+  ((uint32_t)(((uint64_t)CONFIG_SCHED_DEADLINE_MAXUTIL << 16) / 100))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths of all deadline threads */
+
+static uint32_t g_deadline_bandwidth;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Change the base priority of a deadline thread.  If priority inheritance
+ *   has boosted the thread above the new priority, then only the base
+ *   priority is changed and the thread continues at the boosted priority.
+ *
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority >= priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  DEBUGVERIFY(nxsched_reprioritize(tcb, priority));
+}
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   The budget of the current period is exhausted.  Throttle the thread
+ *   until the next period starts:  It drops to SCHED_PRIORITY_MIN, so that
+ *   it can only use otherwise idle time.
+ *
+ * Input Parameters:
+ *   argc - The number of arguments (should be 1)
+ *   arg1 - The TCB of the deadline thread
+ *
+ * Assumptions:
+ *   Called from the watchdog timer interrupt handler.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_expire(int argc, wdparm_t arg1, ...)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg1;
+  FAR struct deadline_s *dl;
+
+  DEBUGASSERT(argc == 1 && tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  /* Set the throttled state first:  Dropping the priority may suspend the
+   * thread and the budget must no longer be charged then.
+   */
+
+  dl->budget    = 0;
+  dl->throttled = true;
+  deadline_set_priority(tcb, SCHED_PRIORITY_MIN);
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   Start the next period:  Replenish the budget, move the absolute
+ *   deadline and re-order the thread among the deadline threads of its
+ *   priority.
+ *
+ * Input Parameters:
+ *   argc - The number of arguments (should be 1)
+ *   arg1 - The TCB of the deadline thread
+ *
+ * Assumptions:
+ *   Called from the watchdog timer interrupt handler.
+ *
+ ****************************************************************************/
+
+static void deadline_period_expire(int argc, wdparm_t arg1, ...)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg1;
+  FAR struct deadline_s *dl;
+  clock_t now;
+
+  DEBUGASSERT(argc == 1 && tcb != NULL && tcb->deadline != NULL);
+  dl  = tcb->deadline;
+  now = clock_systimer();
+
+  DEBUGVERIFY(wd_start(&dl->period_timer, dl->period,
+                       deadline_period_expire, 1, (wdparm_t)tcb));
+
+  /* The time used by a running thread so far belongs to the previous
+   * period.
+   */
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      dl->eventtime = now;
+    }
+
+  dl->budget       = dl->runtime;
+  dl->abs_deadline = now + dl->deadline;
+
+  if (dl->throttled)
+    {
+      /* Return to the deadline priority.  This may resume the thread. */
+
+      dl->throttled = false;
+      deadline_set_priority(tcb, dl->priority);
+    }
+  else
+    {
+      /* Re-sort the thread by its new deadline.  This may let another
+       * deadline thread with an earlier deadline run.
+       */
+
+      DEBUGVERIFY(nxsched_setpriority(tcb, tcb->sched_priority));
+    }
+
+  /* If the thread is still running, then charge the new budget from
+   * now on.
+   */
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      sched_deadline_resume(tcb);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_deadline_start
+ *
+ * Description:
+ *   Assign or change the deadline scheduling parameters of a thread and
+ *   start its first period now.  The thread is admitted only if the total
+ *   bandwidth of all deadline threads does not exceed
+ *   CONFIG_SCHED_DEADLINE_MAXUTIL percent of the CPU.
+ *
+ *   The caller must set the TCB_FLAG_SCHED_DEADLINE policy on success and
+ *   then set the thread priority to param->sched_priority.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The new scheduling parameters
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL - The parameters do not satisfy runtime <= deadline <= period
+ *   EBUSY  - The thread cannot be admitted
+ *   ENOMEM - Failed to allocate the deadline data structure
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int sched_deadline_start(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  sclock_t runtime;
+  sclock_t deadline;
+  sclock_t period;
+  uint32_t bandwidth;
+  uint32_t total;
+
+  /* Convert the timespec values to system clock ticks */
+
+  (void)clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  (void)clock_time2ticks(&param->sched_dl_deadline, &deadline);
+  (void)clock_time2ticks(&param->sched_dl_period, &period);
+
+  if (deadline <= 0)
+    {
+      deadline = period;
+    }
+
+  if (runtime < 1 || runtime > deadline || deadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control */
+
+  bandwidth = (uint32_t)(((uint64_t)runtime << 16) / (uint64_t)period);
+  total     = g_deadline_bandwidth - (dl != NULL ? dl->bandwidth : 0);
+
+  if (bandwidth > DEADLINE_MAXBANDWIDTH - total ||
+      total > DEADLINE_MAXBANDWIDTH)
+    {
+      return -EBUSY;
+    }
+
+  /* Allocate the deadline add-on data structure or stop the current
+   * periods.
+   */
+
+  if (dl == NULL)
+    {
+      dl = (FAR struct deadline_s *)kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      wd_static(&dl->period_timer);
+      wd_static(&dl->budget_timer);
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->period_timer);
+      wd_cancel(&dl->budget_timer);
+    }
+
+  g_deadline_bandwidth = total + bandwidth;
+
+  /* Start the first period now */
+
+  dl->throttled    = false;
+  dl->priority     = param->sched_priority;
+  dl->runtime      = runtime;
+  dl->deadline     = deadline;
+  dl->period       = period;
+  dl->bandwidth    = bandwidth;
+  dl->budget       = runtime;
+  dl->abs_deadline = clock_systimer() + deadline;
+
+  DEBUGVERIFY(wd_start(&dl->period_timer, period,
+                       deadline_period_expire, 1, (wdparm_t)tcb));
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      sched_deadline_resume(tcb);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_stop
+ *
+ * Description:
+ *   Stop deadline scheduling of a thread because its policy is changed or
+ *   because it is exiting.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int sched_deadline_stop(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  wd_cancel(&dl->period_timer);
+  wd_cancel(&dl->budget_timer);
+  g_deadline_bandwidth -= dl->bandwidth;
+
+  /* Clear the policy before the structure is freed:  It is used to order
+   * the thread within its priority level.
+   */
+
+  tcb->flags   &= ~TCB_FLAG_POLICY_MASK;
+  tcb->deadline = NULL;
+  sched_kfree(dl);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_resume
+ *
+ * Description:
+ *   Called when a deadline thread starts running.  Unless the thread is
+ *   throttled, start the timer for the remaining budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_deadline_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  if (!dl->throttled)
+    {
+      dl->eventtime = clock_systimer();
+      DEBUGVERIFY(wd_start(&dl->budget_timer, dl->budget,
+                           deadline_budget_expire, 1, (wdparm_t)tcb));
+    }
+}
+
+/****************************************************************************
+ * Name: sched_deadline_suspend
+ *
+ * Description:
+ *   Called when a deadline thread stops running.  Charge the time it ran
+ *   to the budget of the current period.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_deadline_suspend(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  uint32_t elapsed;
+
+  DEBUGASSERT(dl != NULL);
+
+  if (!dl->throttled)
+    {
+      wd_cancel(&dl->budget_timer);
+
+      /* The thread cannot be throttled here, in the middle of a context
+       * switch.  Leave at least one tick so that the budget timer throttles
+       * it as soon as it runs again.
+       */
+
+      elapsed    = (uint32_t)(clock_systimer() - dl->eventtime);
+      dl->budget = elapsed < dl->budget ? dl->budget - elapsed : 1;
+    }
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
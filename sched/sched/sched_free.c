@@ -46,10 +46,52 @@
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wqueue.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_delay_free
+ *
+ * Description:
+ *   Add memory to the delayed deallocation queue of this CPU and signal the
+ *   worker thread.  The CPU index is only used to spread the deallocations
+ *   over the queues.  Each queue has its own lock, so it does not matter if
+ *   the caller migrates to another CPU.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_MM_KERNEL_HEAP)
+static void nxsched_delay_free(FAR volatile struct delayed_free_s *queues,
+                               FAR void *address)
+{
+  FAR volatile struct delayed_free_s *delayed = &queues[this_cpu()];
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_scoped(&delayed->lock);
+  sq_addlast((FAR sq_entry_t *)address, (FAR sq_queue_t *)&delayed->queue);
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+  delayed->ndeferred++;
+  if (++delayed->depth > delayed->maxdepth)
+    {
+      delayed->maxdepth = delayed->depth;
+    }
+#endif
+
+  spin_unlock_irqrestore_scoped(&delayed->lock, flags);
+
+  /* Signal the worker thread that is has some clean up to do */
+
+  sched_signal_free();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,13 +129,10 @@ void sched_ufree(FAR void *address)
 
   if (up_interrupt_context() || kumm_trysemaphore() != 0)
     {
-      irqstate_t flags;
-
       /* Yes.. Make sure that this is not a attempt to free kernel memory
        * using the user deallocator.
        */
 
-      flags = enter_critical_section();
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
       DEBUGASSERT(!kmm_heapmember(address));
@@ -101,13 +140,7 @@ void sched_ufree(FAR void *address)
 
       /* Delay the deallocation until a more appropriate time. */
 
-      sq_addlast((FAR sq_entry_t *)address,
-                 (FAR sq_queue_t *)&g_delayed_kufree);
-
-      /* Signal the worker thread that is has some clean up to do */
-
-      sched_signal_free();
-      leave_critical_section(flags);
+      nxsched_delay_free(g_delayed_kufree, address);
     }
   else
     {
@@ -122,8 +155,6 @@ void sched_ufree(FAR void *address)
 #ifdef CONFIG_MM_KERNEL_HEAP
 void sched_kfree(FAR void *address)
 {
-  irqstate_t flags;
-
   /* Check if this is an attempt to deallocate memory from an exception
    * handler.  If this function is called from the IDLE task, then we
    * must have exclusive access to the memory manager to do this.
@@ -135,18 +166,11 @@ void sched_kfree(FAR void *address)
        * using the kernel deallocator.
        */
 
-      flags = enter_critical_section();
       DEBUGASSERT(kmm_heapmember(address));
 
       /* Delay the deallocation until a more appropriate time. */
 
-      sq_addlast((FAR sq_entry_t *)address,
-                 (FAR sq_queue_t *)&g_delayed_kfree);
-
-      /* Signal the worker thread that is has some clean up to do */
-
-      sched_signal_free();
-      leave_critical_section(flags);
+      nxsched_delay_free(g_delayed_kfree, address);
     }
   else
     {
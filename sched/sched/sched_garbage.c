@@ -38,15 +38,89 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+
+#include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+/* The longest time spent draining one queue, in critical section monitor
+ * units.
+ */
+
+static uint32_t g_maxdrain;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_detach_garbage
+ *
+ * Description:
+ *   Remove all of the deallocations from one delayed deallocation queue so
+ *   that they can be freed as a batch without holding the queue lock.
+ *
+ * Input Parameters:
+ *   delayed - The delayed deallocation queue
+ *
+ * Returned Value:
+ *   The first entry of the detached list or NULL if the queue was empty.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_MM_KERNEL_HEAP)
+static FAR sq_entry_t *
+nxsched_detach_garbage(FAR volatile struct delayed_free_s *delayed)
+{
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_scoped(&delayed->lock);
+  entry = delayed->queue.head;
+  sq_init((FAR sq_queue_t *)&delayed->queue);
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+  delayed->depth = 0;
+#endif
+
+  spin_unlock_irqrestore_scoped(&delayed->lock, flags);
+  return entry;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_drain_done
+ *
+ * Description:
+ *   Record the time spent draining one queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+static void nxsched_drain_done(uint32_t start)
+{
+  uint32_t elapsed = up_critmon_gettime() - start;
+
+  if (elapsed > g_maxdrain)
+    {
+      g_maxdrain = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_kucleanup
  *
@@ -73,33 +147,52 @@ static inline void nxsched_kucleanup(void)
    */
 
 #else
-  irqstate_t flags;
-  FAR void *address;
-
-  /* Test if the delayed deallocation queue is empty.  No special protection
-   * is needed because this is an atomic test.
-   */
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+  uint32_t start;
+#endif
+  bool locked;
+  int i;
 
-  while (g_delayed_kufree.head)
+  for (i = 0; i < DELAYED_NQUEUES; i++)
     {
-      /* Remove the first delayed deallocation.  This is not atomic and so
-       * we must disable interrupts around the queue operation.
+      /* Test if the delayed deallocation queue is empty.  No special
+       * protection is needed because this is an atomic test.
        */
 
-      flags = enter_critical_section();
-      address = (FAR void *)sq_remfirst((FAR sq_queue_t *)&g_delayed_kufree);
-      leave_critical_section(flags);
+      if (g_delayed_kufree[i].queue.head == NULL)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+      start = up_critmon_gettime();
+#endif
 
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
+      /* Take the whole queue and return the memory to the user heap.  Hold
+       * the heap semaphore across the batch if it is available; otherwise
+       * each kumm_free() will wait for it.
        */
 
-      if (address)
+      entry  = nxsched_detach_garbage(&g_delayed_kufree[i]);
+      locked = (kumm_trysemaphore() == 0);
+
+      while (entry != NULL)
         {
-          /* Return the memory to the user heap */
+          next = entry->flink;
+          kumm_free(entry);
+          entry = next;
+        }
 
-          kumm_free(address);
+      if (locked)
+        {
+          kumm_givesemaphore();
         }
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+      nxsched_drain_done(start);
+#endif
     }
 #endif
 }
@@ -121,7 +214,17 @@ static inline void nxsched_kucleanup(void)
 #ifndef CONFIG_BUILD_KERNEL
 static inline bool nxsched_have_kugarbage(void)
 {
-  return (g_delayed_kufree.head != NULL);
+  int i;
+
+  for (i = 0; i < DELAYED_NQUEUES; i++)
+    {
+      if (g_delayed_kufree[i].queue.head != NULL)
+        {
+          return true;
+        }
+    }
+
+  return false;
 }
 #else
 #  define nxsched_have_kugarbage() false
@@ -145,33 +248,51 @@ static inline bool nxsched_have_kugarbage(void)
      defined(CONFIG_MM_KERNEL_HEAP)
 static inline void nxsched_kcleanup(void)
 {
-  irqstate_t flags;
-  FAR void *address;
-
-  /* Test if the delayed deallocation queue is empty.  No special protection
-   * is needed because this is an atomic test.
-   */
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+  uint32_t start;
+#endif
+  bool locked;
+  int i;
 
-  while (g_delayed_kfree.head)
+  for (i = 0; i < DELAYED_NQUEUES; i++)
     {
-      /* Remove the first delayed deallocation.  This is not atomic and so
-       * we must disable interrupts around the queue operation.
+      /* Test if the delayed deallocation queue is empty.  No special
+       * protection is needed because this is an atomic test.
        */
 
-      flags = enter_critical_section();
-      address = (FAR void *)sq_remfirst((FAR sq_queue_t *)&g_delayed_kfree);
-      leave_critical_section(flags);
+      if (g_delayed_kfree[i].queue.head == NULL)
+        {
+          continue;
+        }
 
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+      start = up_critmon_gettime();
+#endif
+
+      /* Take the whole queue and return the memory to the kernel heap,
+       * holding the heap semaphore across the batch if it is available.
        */
 
-      if (address)
+      entry  = nxsched_detach_garbage(&g_delayed_kfree[i]);
+      locked = (kmm_trysemaphore() == 0);
+
+      while (entry != NULL)
         {
-          /* Return the memory to the kernel heap */
+          next = entry->flink;
+          kmm_free(entry);
+          entry = next;
+        }
 
-          kmm_free(address);
+      if (locked)
+        {
+          kmm_givesemaphore();
         }
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+      nxsched_drain_done(start);
+#endif
     }
 }
 #else
@@ -196,12 +317,49 @@ static inline void nxsched_kcleanup(void)
      defined(CONFIG_MM_KERNEL_HEAP)
 static inline bool nxsched_have_kgarbage(void)
 {
-  return (g_delayed_kfree.head != NULL);
+  int i;
+
+  for (i = 0; i < DELAYED_NQUEUES; i++)
+    {
+      if (g_delayed_kfree[i].queue.head != NULL)
+        {
+          return true;
+        }
+    }
+
+  return false;
 }
 #else
 #  define nxsched_have_kgarbage() false
 #endif
 
+/****************************************************************************
+ * Name: nxsched_garbage_queueinfo
+ *
+ * Description:
+ *   Add the statistics of the delayed deallocation queues of one heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+static void
+nxsched_garbage_queueinfo(FAR volatile struct delayed_free_s *queues,
+                          FAR struct garbageinfo_s *info)
+{
+  int i;
+
+  for (i = 0; i < DELAYED_NQUEUES; i++)
+    {
+      info->ndeferred += queues[i].ndeferred;
+      info->depth     += queues[i].depth;
+      if (queues[i].maxdepth > info->maxdepth)
+        {
+          info->maxdepth = queues[i].maxdepth;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -271,3 +429,37 @@ bool sched_have_garbage(void)
   return (nxsched_have_kgarbage() || nxsched_have_kugarbage() ||
           up_sched_have_garbage());
 }
+
+/****************************************************************************
+ * Name: sched_garbage_info
+ *
+ * Description:
+ *   Return statistics of the delayed memory deallocations.
+ *
+ * Input Parameters:
+ *   info - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_STATISTICS
+void sched_garbage_info(FAR struct garbageinfo_s *info)
+{
+  struct timespec ts;
+
+  memset(info, 0, sizeof(struct garbageinfo_s));
+
+#if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
+     defined(CONFIG_MM_KERNEL_HEAP)
+  nxsched_garbage_queueinfo(g_delayed_kfree, info);
+#endif
+#ifndef CONFIG_BUILD_KERNEL
+  nxsched_garbage_queueinfo(g_delayed_kufree, info);
+#endif
+
+  up_critmon_convert(g_maxdrain, &ts);
+  info->maxdrain = ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
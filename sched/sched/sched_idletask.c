@@ -40,10 +40,13 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <sched.h>
 
 #include <nuttx/init.h>
+#include <nuttx/irq.h>
 #include <nuttx/sched.h>
 
+#include "irq/irq.h"
 #include "sched/sched.h"
 
 /****************************************************************************
@@ -97,3 +100,70 @@ bool sched_idletask(void)
 
   return true;
 }
+
+/****************************************************************************
+ * Name: sched_idle_balance
+ *
+ * Description:
+ *   Called periodically from the IDLE loop of each CPU in the SMP
+ *   configuration.  If the g_readytorun list holds a task that may run on
+ *   this CPU, then that task is made running.  Normally the task list logic
+ *   assures that the highest priority tasks are always running, but a task
+ *   may be left in the g_readytorun list while a CPU goes idle, for example
+ *   if the CPU became idle while the scheduler was locked.  This pass picks
+ *   up such tasks as soon as the scheduler is unlocked.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called only from the IDLE task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void sched_idle_balance(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int me;
+
+  /* Nothing to do if there are no unassigned ready-to-run tasks.  This
+   * unlocked test is only a hint; it is repeated below.
+   */
+
+  if (g_readytorun.head == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  me = this_cpu();
+  if (!sched_islocked_global() && !irq_cpu_locked(me))
+    {
+      /* Find the highest priority task that is permitted to run on this
+       * CPU.
+       */
+
+      for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+           tcb != NULL && !CPU_ISSET(me, &tcb->affinity);
+           tcb = (FAR struct tcb_s *)tcb->flink);
+
+      /* Re-prioritizing the task to its current priority removes it from
+       * the g_readytorun list and adds it back to the ready-to-run lists.
+       * That will start it on this CPU (or on some other idle CPU).
+       */
+
+      if (tcb != NULL)
+        {
+          (void)nxsched_setpriority(tcb, tcb->sched_priority);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif /* CONFIG_SMP */
@@ -84,7 +84,41 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && \
+    (defined(CONFIG_SCHED_PRIOBITMAP) || defined(CONFIG_SCHED_DEADLINE))
+bool sched_mergepending(void)
+{
+  FAR struct tcb_s *ptcb;
+  bool ret = false;
+
+  /* Move every TCB from the g_pendingtasks list, highest priority first,
+   * into the ready-to-run list.  With the priority index each insertion
+   * is constant time, so there is no need for the merge below.  Deadline
+   * TCBs must be ordered by deadline, which the merge below does not do.
+   */
+
+  while ((ptcb = (FAR struct tcb_s *)g_pendingtasks.head) != NULL)
+    {
+      sched_removeprioritized(ptcb, (FAR dq_queue_t *)&g_pendingtasks);
+
+      if (sched_addprioritized(ptcb, (FAR dq_queue_t *)&g_readytorun))
+        {
+          /* Inserting ptcb at the head of the list */
+
+          ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+          ptcb->task_state        = TSTATE_TASK_RUNNING;
+          ret                     = true;
+        }
+      else
+        {
+          ptcb->task_state        = TSTATE_TASK_READYTORUN;
+        }
+    }
+
+  return ret;
+}
+
+#elif !defined(CONFIG_SMP)
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -57,16 +58,42 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+#  if (CONFIG_SCHED_NOTE_BUFSIZE & (CONFIG_SCHED_NOTE_BUFSIZE - 1)) != 0
+#    error CONFIG_SCHED_NOTE_BUFSIZE must be a power of two
+#  endif
+
+#  define NOTE_MASK(n) ((n) & (CONFIG_SCHED_NOTE_BUFSIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+/* Each CPU has its own ring.  The head index is written only by the CPU that
+ * owns the ring (with its local interrupts disabled) and the tail index is
+ * written only by the reader.  The indices run freely and are masked when
+ * the buffer is accessed.  A note that does not fit is dropped and counted
+ * rather than overwriting older notes.
+ */
+
+struct note_ring_s
+{
+  volatile unsigned int nr_head;     /* Written by the owning CPU */
+  volatile unsigned int nr_tail;     /* Written by the reader */
+  volatile uint32_t nr_dropped;      /* Written by the owning CPU */
+  uint32_t nr_reported;              /* Written by the reader */
+  uint8_t nr_buffer[CONFIG_SCHED_NOTE_BUFSIZE];
+};
+#else
 struct note_info_s
 {
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   uint8_t ni_buffer[CONFIG_SCHED_NOTE_BUFSIZE];
 };
+#endif
 
 struct note_startalloc_s
 {
@@ -92,16 +119,27 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen);
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+static struct note_ring_s g_note_ring[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SCHED_NOTE_GET
+/* Serializes readers only.  It is never taken when a note is added. */
+
+static volatile spinlock_t g_note_readlock;
+#endif
+#else
 static struct note_info_s g_note_info;
 
 #ifdef CONFIG_SMP
 static volatile spinlock_t g_note_lock;
 #endif
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_NOTE_PERCPU
 /****************************************************************************
  * Name: note_next
  *
@@ -127,6 +165,7 @@ static inline unsigned int note_next(unsigned int ndx, unsigned int offset)
 
   return ndx;
 }
+#endif
 
 /****************************************************************************
  * Name: note_common
@@ -148,7 +187,11 @@ static inline unsigned int note_next(unsigned int ndx, unsigned int offset)
 static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
                         uint8_t length, uint8_t type)
 {
+#ifdef CONFIG_SCHED_NOTE_CYCLES
+  uint32_t systime    = up_critmon_gettime();
+#else
   uint32_t systime    = (uint32_t)clock_systimer();
+#endif
 
   /* Save all of the common fields */
 
@@ -202,6 +245,7 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
 }
 #endif
 
+#ifndef CONFIG_SCHED_NOTE_PERCPU
 /****************************************************************************
  * Name: note_length
  *
@@ -347,6 +391,174 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
 #endif
 }
 
+#else /* CONFIG_SCHED_NOTE_PERCPU */
+
+/****************************************************************************
+ * Name: note_add
+ *
+ * Description:
+ *   Add the variable length note to the head of this CPU's ring.  No lock
+ *   is taken:  Only this CPU ever advances the head of its ring and local
+ *   interrupts are disabled so that nested notes from interrupt handlers
+ *   cannot interleave with this one.
+ *
+ * Input Parameters:
+ *   note    - The note to add
+ *   notelen - The length of the note
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void note_add(FAR const uint8_t *note, uint8_t notelen)
+{
+  FAR struct note_ring_s *ring;
+  irqstate_t flags;
+  unsigned int head;
+  unsigned int i;
+
+  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
+
+  flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  /* Ignore notes that are not in the set of monitored CPUs */
+
+  if ((CONFIG_SCHED_INSTRUMENTATION_CPUSET & (1 << this_cpu())) == 0)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+#endif
+
+  ring = &g_note_ring[this_cpu()];
+  head = ring->nr_head;
+
+  /* Is there space for the note?  If not, drop it.  The reader will report
+   * the number of lost notes.
+   */
+
+  if (CONFIG_SCHED_NOTE_BUFSIZE - (head - ring->nr_tail) < notelen)
+    {
+      ring->nr_dropped++;
+    }
+  else
+    {
+      for (i = 0; i < notelen; i++)
+        {
+          ring->nr_buffer[NOTE_MASK(head + i)] = note[i];
+        }
+
+      /* Make sure that the note is in memory before the reader can see the
+       * new head index.
+       */
+
+      SP_DMB();
+      ring->nr_head = head + notelen;
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: note_ring_byte
+ *
+ * Description:
+ *   Return a byte at an offset from the tail of a CPU's ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static inline uint8_t note_ring_byte(FAR struct note_ring_s *ring,
+                                     unsigned int offset)
+{
+  return ring->nr_buffer[NOTE_MASK(ring->nr_tail + offset)];
+}
+#endif
+
+/****************************************************************************
+ * Name: note_ring_time
+ *
+ * Description:
+ *   Return the timestamp of the note at the tail of a CPU's ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static uint32_t note_ring_time(FAR struct note_ring_s *ring)
+{
+  unsigned int offset = offsetof(struct note_common_s, nc_systime);
+
+  return (uint32_t)note_ring_byte(ring, offset) |
+         ((uint32_t)note_ring_byte(ring, offset + 1) << 8) |
+         ((uint32_t)note_ring_byte(ring, offset + 2) << 16) |
+         ((uint32_t)note_ring_byte(ring, offset + 3) << 24);
+}
+#endif
+
+/****************************************************************************
+ * Name: note_select
+ *
+ * Description:
+ *   Select the CPU ring that provides the next note of the merged stream.
+ *   Unreported dropped notes are returned first.  Otherwise, this is the
+ *   ring with the oldest note at its tail.
+ *
+ * Input Parameters:
+ *   dropped - Location to return true if the next note is a NOTE_DROPPED
+ *             note that must be synthesized for the selected CPU.
+ *
+ * Returned Value:
+ *   The selected CPU ring or NULL if all rings are empty.
+ *
+ * Assumptions:
+ *   The caller holds g_note_readlock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static FAR struct note_ring_s *note_select(FAR bool *dropped)
+{
+  FAR struct note_ring_s *oldest = NULL;
+  FAR struct note_ring_s *ring;
+  uint32_t oldtime = 0;
+  uint32_t time;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ring = &g_note_ring[cpu];
+
+      if (ring->nr_dropped != ring->nr_reported)
+        {
+          *dropped = true;
+          return ring;
+        }
+
+      if (ring->nr_head != ring->nr_tail)
+        {
+          /* Make sure that the note is not read before its head index.
+           * Timestamps of different CPUs are compared modulo 2**32.
+           */
+
+          SP_DSB();
+          time = note_ring_time(ring);
+          if (oldest == NULL || (int32_t)(time - oldtime) < 0)
+            {
+              oldest  = ring;
+              oldtime = time;
+            }
+        }
+    }
+
+  *dropped = false;
+  return oldest;
+}
+#endif
+
+#endif /* CONFIG_SCHED_NOTE_PERCPU */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -607,7 +819,7 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_NOTE_GET
+#if defined(CONFIG_SCHED_NOTE_GET) && !defined(CONFIG_SCHED_NOTE_PERCPU)
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
   FAR struct note_common_s *note;
@@ -692,7 +904,7 @@ errout_with_csection:
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_NOTE_GET
+#if defined(CONFIG_SCHED_NOTE_GET) && !defined(CONFIG_SCHED_NOTE_PERCPU)
 ssize_t sched_note_size(void)
 {
   FAR struct note_common_s *note;
@@ -729,4 +941,152 @@ errout_with_csection:
 }
 #endif
 
+/****************************************************************************
+ * Name: sched_note_get
+ *
+ * Description:
+ *   Remove the next note from the merged per-CPU rings.  Notes are
+ *   returned oldest first.  If notes were dropped by a CPU, a NOTE_DROPPED
+ *   note holding the number of lost notes is returned before any further
+ *   notes.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the positive, non-zero length of the return note is
+ *   provided.  Zero is returned only if all per-CPU rings are empty.  A
+ *   negated errno value is returned in the event of any failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SCHED_NOTE_PERCPU)
+ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct note_ring_s *ring;
+  struct note_dropped_s note;
+  irqstate_t flags;
+  unsigned int length;
+  unsigned int i;
+  uint32_t count;
+  ssize_t notelen;
+  bool dropped;
+
+  DEBUGASSERT(buffer != NULL);
+
+  flags = up_irq_save();
+  spin_lock_wo_note(&g_note_readlock);
+
+  ring = note_select(&dropped);
+  if (ring == NULL)
+    {
+      notelen = 0;
+    }
+  else if (dropped)
+    {
+      /* Report the number of notes lost by this CPU since the last report */
+
+      length            = ring->nr_dropped;
+      count             = length - ring->nr_reported;
+      ring->nr_reported = length;
+
+      notelen           = sizeof(struct note_dropped_s);
+      note_common(this_task(), &note.ndr_cmn, notelen, NOTE_DROPPED);
+#ifdef CONFIG_SMP
+      note.ndr_cmn.nc_cpu = (uint8_t)(ring - g_note_ring);
+#endif
+      note.ndr_count[0] = (uint8_t)( count        & 0xff);
+      note.ndr_count[1] = (uint8_t)((count >> 8)  & 0xff);
+      note.ndr_count[2] = (uint8_t)((count >> 16) & 0xff);
+      note.ndr_count[3] = (uint8_t)((count >> 24) & 0xff);
+
+      if (buflen < notelen)
+        {
+          notelen = -EFBIG;
+        }
+      else
+        {
+          memcpy(buffer, &note, notelen);
+        }
+    }
+  else
+    {
+      length = note_ring_byte(ring, 0);
+      DEBUGASSERT(length > 0 && length <= ring->nr_head - ring->nr_tail);
+
+      if (buflen < length)
+        {
+          /* Remove the large note so that we do not get constipated. */
+
+          notelen = -EFBIG;
+        }
+      else
+        {
+          for (i = 0; i < length; i++)
+            {
+              buffer[i] = note_ring_byte(ring, i);
+            }
+
+          notelen = length;
+        }
+
+      /* The note must be copied before the producer may reuse the space */
+
+      SP_DSB();
+      ring->nr_tail += length;
+    }
+
+  spin_unlock_wo_note(&g_note_readlock);
+  up_irq_restore(flags);
+  return notelen;
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_note_size
+ *
+ * Description:
+ *   Return the size of the next note of the merged per-CPU rings.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero is returned if all rings are empty.  Otherwise, the size of the
+ *   next note is returned.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SCHED_NOTE_PERCPU)
+ssize_t sched_note_size(void)
+{
+  FAR struct note_ring_s *ring;
+  irqstate_t flags;
+  ssize_t notelen;
+  bool dropped;
+
+  flags = up_irq_save();
+  spin_lock_wo_note(&g_note_readlock);
+
+  ring = note_select(&dropped);
+  if (ring == NULL)
+    {
+      notelen = 0;
+    }
+  else if (dropped)
+    {
+      notelen = sizeof(struct note_dropped_s);
+    }
+  else
+    {
+      notelen = note_ring_byte(ring, 0);
+    }
+
+  spin_unlock_wo_note(&g_note_readlock);
+  up_irq_restore(flags);
+  return notelen;
+}
+#endif
+
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
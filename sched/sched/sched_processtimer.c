@@ -1,7 +1,8 @@
 /****************************************************************************
  * sched/sched/sched_processtimer.c
  *
- *   Copyright (C) 2007, 2009, 2014-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2009, 2014-2019, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -217,6 +218,17 @@ void nxsched_process_timer(void)
     }
 #endif
 
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_SCHED_PROFILE_EXTCLK)
+  /* Sample the interrupted program counter */
+
+#ifdef CONFIG_HAVE_WEAKFUNCTIONS
+  if (nxsched_process_profile != NULL)
+#endif
+    {
+      nxsched_process_profile();
+    }
+#endif
+
   /* Check if the currently executing task has exceeded its
    * timeslice.
    */
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * sched/sched/sched_profile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define PROFILE_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define PROFILE_NCPUS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The samples recorded on one CPU.  Samples are only appended by the timer
+ * interrupt on that CPU, so the samples below nsamples never change until
+ * the profile is reset.
+ */
+
+struct profile_cpu_s
+{
+  volatile size_t nsamples;                      /* Number of samples */
+  uintptr_t pc[CONFIG_SCHED_PROFILE_NSAMPLES];   /* The sampled PCs */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct profile_cpu_s g_profile[PROFILE_NCPUS];
+static volatile bool g_profile_running;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_process_profile
+ *
+ * Description:
+ *   Record the program counter interrupted by the timer interrupt on this
+ *   CPU.  When CONFIG_SCHED_PROFILE_EXTCLK is defined, this is an exported
+ *   interface that is called from the interrupt handler of a dedicated
+ *   timer.  Otherwise, it is called at every system timer tick.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+void weak_function nxsched_process_profile(void)
+{
+  FAR struct profile_cpu_s *prof;
+  size_t nsamples;
+
+  if (g_profile_running)
+    {
+      /* Samples are no longer recorded once the buffer is full */
+
+      prof     = &g_profile[this_cpu()];
+      nsamples = prof->nsamples;
+
+      if (nsamples < CONFIG_SCHED_PROFILE_NSAMPLES)
+        {
+          prof->pc[nsamples] = up_profile_pc();
+          prof->nsamples     = nsamples + 1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_profile_start
+ *
+ * Description:
+ *   Start recording samples.  New samples are appended to the samples that
+ *   were already recorded.
+ *
+ ****************************************************************************/
+
+void nxsched_profile_start(void)
+{
+  g_profile_running = true;
+}
+
+/****************************************************************************
+ * Name: nxsched_profile_stop
+ *
+ * Description:
+ *   Stop recording samples.  The recorded samples are kept.
+ *
+ ****************************************************************************/
+
+void nxsched_profile_stop(void)
+{
+  g_profile_running = false;
+}
+
+/****************************************************************************
+ * Name: nxsched_profile_reset
+ *
+ * Description:
+ *   Discard the recorded samples of all CPUs.
+ *
+ ****************************************************************************/
+
+void nxsched_profile_reset(void)
+{
+  irqstate_t flags;
+  int cpu;
+
+  flags = enter_critical_section();
+  for (cpu = 0; cpu < PROFILE_NCPUS; cpu++)
+    {
+      g_profile[cpu].nsamples = 0;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_profile_nsamples
+ *
+ * Description:
+ *   Return the number of samples recorded on a CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU index
+ *
+ * Returned Value:
+ *   The number of samples, or zero if the CPU index is not valid.
+ *
+ ****************************************************************************/
+
+size_t nxsched_profile_nsamples(int cpu)
+{
+  if (cpu < 0 || cpu >= PROFILE_NCPUS)
+    {
+      return 0;
+    }
+
+  return g_profile[cpu].nsamples;
+}
+
+/****************************************************************************
+ * Name: nxsched_profile_pc
+ *
+ * Description:
+ *   Return one sampled program counter.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU index
+ *   index - The index of the sample, less than the value returned by
+ *           nxsched_profile_nsamples()
+ *
+ * Returned Value:
+ *   The sampled program counter.
+ *
+ ****************************************************************************/
+
+uintptr_t nxsched_profile_pc(int cpu, size_t index)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < PROFILE_NCPUS &&
+              index < CONFIG_SCHED_PROFILE_NSAMPLES);
+
+  return g_profile[cpu].pc[index];
+}
+
+#endif /* CONFIG_SCHED_PROFILE */
@@ -46,6 +46,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
 
 #include "sched/sched.h"
 #include "group/group.h"
@@ -83,6 +84,19 @@ static void nxsched_releasepid(pid_t pid)
   g_cpuload_total          -= g_pidhash[hash_ndx].ticks;
   g_pidhash[hash_ndx].ticks = 0;
 #endif
+
+#ifdef CONFIG_MM_TRACE
+  /* Forget the heap usage of the thread.  Any memory that it did not free
+   * remains tagged with its PID.
+   */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  mm_traceexit(&g_kmmheap, pid);
+#endif
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+  mm_traceexit(&g_mmheap, pid);
+#endif
+#endif
 }
 
 /****************************************************************************
@@ -143,28 +157,6 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
-      /* Delete the thread's stack if one has been allocated */
-
-      if (tcb->stack_alloc_ptr)
-        {
-#ifdef CONFIG_BUILD_KERNEL
-          /* If the exiting thread is not a kernel thread, then it has an
-           * address environment.  Don't bother to release the stack memory
-           * in this case... There is no point since the memory lies in the
-           * user memory region that will be destroyed anyway (and the
-           * address environment has probably already been destroyed at
-           * this point.. so we would crash if we even tried it).  But if
-           * this is a privileged group, when we still have to release the
-           * memory using the kernel allocator.
-           */
-
-          if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
-#endif
-            {
-              up_release_stack(tcb, ttype);
-            }
-        }
-
 #ifdef CONFIG_PIC
       /* Delete the task's allocated DSpace region (external modules only) */
 
@@ -197,6 +189,37 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       group_leave(tcb);
 
+#ifdef CONFIG_SCHED_TCBCACHE
+      /* Keep the TCB and its stack for re-use, if possible */
+
+      if (nxsched_tcbcache_free(tcb, ttype))
+        {
+          return ret;
+        }
+#endif
+
+      /* Delete the thread's stack if one has been allocated */
+
+      if (tcb->stack_alloc_ptr)
+        {
+#ifdef CONFIG_BUILD_KERNEL
+          /* If the exiting thread is not a kernel thread, then it has an
+           * address environment.  Don't bother to release the stack memory
+           * in this case... There is no point since the memory lies in the
+           * user memory region that will be destroyed anyway (and the
+           * address environment has probably already been destroyed at
+           * this point.. so we would crash if we even tried it).  But if
+           * this is a privileged group, when we still have to release the
+           * memory using the kernel allocator.
+           */
+
+          if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
+#endif
+            {
+              up_release_stack(tcb, ttype);
+            }
+        }
+
       /* And, finally, release the TCB itself */
 
       sched_kfree(tcb);
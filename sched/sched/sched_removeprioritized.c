@@ -0,0 +1,108 @@
+/****************************************************************************
+ * sched/sched/sched_removeprioritized.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_removeprioritized
+ *
+ * Description:
+ *   This function removes a TCB from a prioritized TCB list, keeping the
+ *   priority index of the list (if any) up to date.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the prioritized list
+ *   list - Points to the prioritized list that holds tcb
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The TCB priority has not been changed since the TCB was added to the
+ *   list.
+ * - The caller handles the condition that occurs if the head of the task
+ *   list is changed and must set the task_state field of the TCB.
+ *
+ ****************************************************************************/
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index;
+  FAR struct tcb_s *prev;
+  uint8_t sched_priority = tcb->sched_priority;
+
+  index = sched_prioindex(list);
+  if (index != NULL && index->last[sched_priority] == tcb)
+    {
+      /* The TCB is the last of its priority level.  The TCB before it
+       * becomes the last of the level or, if there is none, the level is
+       * now empty.
+       */
+
+      prev = (FAR struct tcb_s *)tcb->blink;
+      if (prev != NULL && prev->sched_priority == sched_priority)
+        {
+          index->last[sched_priority] = prev;
+        }
+      else
+        {
+          index->last[sched_priority] = NULL;
+          index->bitmap[sched_priority >> 5] &=
+            ~(1ul << (sched_priority & 31));
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_PRIOBITMAP */
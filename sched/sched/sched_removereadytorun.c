@@ -101,7 +101,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  sched_removeprioritized(rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -232,13 +232,15 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
         {
           FAR struct tcb_s *tmptcb;
 
-          /* The TCB at the head of the ready to run list has the higher
-           * priority.  Remove that task from the head of the g_readytorun
-           * list and add to the head of the g_assignedtasks[cpu] list.
+          /* The TCB from the ready to run list has the higher priority.
+           * Remove that task from the g_readytorun list and add to the head
+           * of the g_assignedtasks[cpu] list.  NOTE that it is not
+           * necessarily the task at the head of the g_readytorun list if
+           * that task may not run on this CPU.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
+          tmptcb = rtrtcb;
+          dq_rem((FAR dq_entry_t *)tmptcb, (FAR dq_queue_t *)&g_readytorun);
 
           dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
 
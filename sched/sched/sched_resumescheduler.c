@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/sched/sched_resumescheduler.c
  *
- *   Copyright (C) 2015, 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2015, 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -45,6 +45,10 @@
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
 
+#ifdef CONFIG_TLS_THREADPTR
+#  include <arch/tls.h>
+#endif
+
 #include "irq/irq.h"
 #include "sched/sched.h"
 
@@ -95,11 +99,29 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Start charging the budget of the current period */
+
+      sched_deadline_resume(tcb);
+    }
+#endif
+
+#ifdef CONFIG_TLS_THREADPTR
+  /* Point the thread pointer register at the TLS of the resumed thread */
+
+  up_tls_resume(tcb);
+#endif
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   sched_critmon_resume(tcb);
 #endif
+#ifdef CONFIG_SCHED_CPUACCT
+  sched_cpuacct_resume(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
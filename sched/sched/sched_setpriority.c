@@ -165,9 +165,20 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_PRIOBITMAP
+      /* Move the task to its new priority level in the index.  It remains
+       * at the head of the ready-to-run list.
+       */
+
+      sched_removeprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      (void)sched_addprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+      DEBUGASSERT(this_task() == tcb);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -203,7 +214,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   if (tcb->task_state == TSTATE_TASK_READYTORUN)
     {
-      cpu = sched_cpu_select(tcb->affinity);
+      cpu = sched_cpu_select_task(tcb);
     }
 
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
@@ -231,10 +242,14 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 #endif
 
   /* A context switch will occur if the new priority of the ready-to-run
-   * task is (strictly) greater than the current running task
+   * task is (strictly) greater than the current running task or if both
+   * are deadline tasks of the same priority and the ready-to-run task has
+   * the earlier deadline.
    */
 
-  if (sched_priority > rtcb->sched_priority)
+  if (sched_priority > rtcb->sched_priority ||
+      (sched_priority == rtcb->sched_priority &&
+       sched_deadline_before(tcb, rtcb)))
     {
       /* A context switch will occur. */
 
@@ -290,7 +305,7 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
     {
       /* Remove the TCB from the prioritized task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      sched_removeprioritized(tcb, tasklist);
 
       /* Change the task priority */
 
@@ -106,6 +106,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -136,6 +139,19 @@ int nxsched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Stop any on-going deadline scheduling unless only its parameters
+   * change.
+   */
+
+  if (policy != SCHED_DEADLINE &&
+      (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      DEBUGVERIFY(sched_deadline_stop(tcb));
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -274,6 +290,27 @@ int nxsched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Admit the thread and start its first period.  On failure, a
+           * deadline thread keeps its current parameters.
+           */
+
+          ret = sched_deadline_start(tcb, param);
+          if (tcb->deadline != NULL)
+            {
+              tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -289,7 +326,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
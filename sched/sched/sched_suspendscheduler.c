@@ -83,11 +83,23 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Charge the time used to the budget of the current period */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      sched_deadline_suspend(tcb);
+    }
+#endif
+
   /* Indicate that the task has been suspended */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   sched_critmon_suspend(tcb);
 #endif
+#ifdef CONFIG_SCHED_CPUACCT
+  sched_cpuacct_suspend(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
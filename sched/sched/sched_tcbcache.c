@@ -0,0 +1,195 @@
+/****************************************************************************
+ * sched/sched/sched_tcbcache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TCBCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one cached TCB */
+
+struct tcbcache_s
+{
+  FAR struct tcb_s *tcb;           /* The cached TCB or NULL */
+  uint8_t ttype;                   /* The thread type of the TCB */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tcbcache_s g_tcbcache[CONFIG_SCHED_TCBCACHE_NENTRIES];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_tcbcache_alloc
+ *
+ * Description:
+ *   Take a TCB with a stack of the requested size out of the cache.  The
+ *   TCB is zeroed and its stack is re-initialized as if it had just been
+ *   allocated by up_create_stack().
+ *
+ * Input Parameters:
+ *   ttype      - The thread type of the new thread
+ *   stack_size - The requested stack size of the new thread
+ *
+ * Returned Value:
+ *   The TCB or NULL if there is no matching TCB in the cache.  The TCB is
+ *   of type struct pthread_tcb_s if ttype is TCB_FLAG_TTYPE_PTHREAD or of
+ *   type struct task_tcb_s otherwise.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_tcbcache_alloc(uint8_t ttype, size_t stack_size)
+{
+  FAR struct tcb_s *tcb = NULL;
+  FAR void *stack;
+  irqstate_t flags;
+  size_t size;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_SCHED_TCBCACHE_NENTRIES; i++)
+    {
+      if (g_tcbcache[i].tcb != NULL && g_tcbcache[i].ttype == ttype &&
+          g_tcbcache[i].tcb->cache_stack_size == stack_size)
+        {
+          tcb = g_tcbcache[i].tcb;
+          g_tcbcache[i].tcb = NULL;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb == NULL)
+    {
+      return NULL;
+    }
+
+  /* Zero the TCB but keep the stack.  up_use_stack() handles the stack
+   * exactly as up_create_stack() did the first time:  The adjusted size
+   * gives the same top of stack, the TLS data is cleared and the stack is
+   * painted again.  up_release_stack() will still free it.
+   */
+
+  stack = tcb->stack_alloc_ptr;
+  size  = tcb->adj_stack_size;
+
+#ifndef CONFIG_DISABLE_PTHREAD
+  if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+    {
+      memset(tcb, 0, sizeof(struct pthread_tcb_s));
+    }
+  else
+#endif
+    {
+      memset(tcb, 0, sizeof(struct task_tcb_s));
+    }
+
+  tcb->flags            = ttype;
+  up_use_stack(tcb, stack, size);
+  tcb->cache_stack_size = stack_size;
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: nxsched_tcbcache_free
+ *
+ * Description:
+ *   Put the TCB of an exited thread and its stack into the cache.  This is
+ *   the last step of sched_releasetcb(); all of the other resources of the
+ *   TCB have already been released.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB to be cached
+ *   ttype - The thread type of the TCB
+ *
+ * Returned Value:
+ *   True if the TCB was cached.  False if the TCB cannot be cached or if the
+ *   cache is full.  The TCB and its stack must then be freed.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool nxsched_tcbcache_free(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+  irqstate_t flags;
+  bool cached = false;
+  int i;
+
+  if (tcb->cache_stack_size == 0 || tcb->stack_alloc_ptr == NULL)
+    {
+      return false;
+    }
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_SCHED_TCBCACHE_NENTRIES; i++)
+    {
+      if (g_tcbcache[i].tcb == NULL)
+        {
+          g_tcbcache[i].tcb   = tcb;
+          g_tcbcache[i].ttype = ttype;
+          cached              = true;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return cached;
+}
+
+#endif /* CONFIG_SCHED_TCBCACHE */
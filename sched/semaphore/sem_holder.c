@@ -45,6 +45,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <nuttx/arch.h>
+#include <nuttx/mm/mempool.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -76,14 +77,15 @@ typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
 static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
-static FAR struct semholder_s *g_freeholders;
+static struct mempool_s g_holderpool;
 #endif
 
 /****************************************************************************
  * Name: nxsem_allocholder
  ****************************************************************************/
 
-static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
+static inline FAR struct semholder_s *
+nxsem_allocholder(sem_t *sem, FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
 
@@ -93,30 +95,42 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
+  pholder = (FAR struct semholder_s *)mempool_alloc(&g_holderpool);
   if (pholder != NULL)
     {
-      /* Remove the holder from the free list an put it into the semaphore's
-       * holder list
-       */
+      /* Put the holder from the pool into the semaphore's holder list */
 
-      g_freeholders    = pholder->flink;
       pholder->flink   = sem->hhead;
+      pholder->blink   = NULL;
+      if (sem->hhead != NULL)
+        {
+          sem->hhead->blink = pholder;
+        }
+
       sem->hhead       = pholder;
 
+      /* And into the list of counts held by the thread */
+
+      pholder->tlink   = htcb->holdsem;
+      htcb->holdsem    = pholder;
+      pholder->sem     = sem;
+
       /* Make sure the initial count is zero */
 
+      pholder->htcb    = htcb;
       pholder->counts  = 0;
     }
 #else
   if (sem->holder[0].htcb == NULL)
     {
       pholder          = &sem->holder[0];
+      pholder->htcb    = htcb;
       pholder->counts  = 0;
     }
   else if (sem->holder[1].htcb == NULL)
     {
       pholder          = &sem->holder[1];
+      pholder->htcb    = htcb;
       pholder->counts  = 0;
     }
 #endif
@@ -140,13 +154,14 @@ static FAR struct semholder_s *nxsem_findholder(sem_t *sem,
   FAR struct semholder_s *pholder;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Try to find the holder in the list of holders associated with this
-   * semaphore
+  /* Search the list of counts held by the thread.  A thread normally holds
+   * only a few semaphores at a time while a counting semaphore may have
+   * many holders.
    */
 
-  for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+  for (pholder = htcb->holdsem; pholder != NULL; pholder = pholder->tlink)
     {
-      if (pholder->htcb == htcb)
+      if (pholder->sem == sem)
         {
           /* Got it! */
 
@@ -186,7 +201,7 @@ nxsem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
   FAR struct semholder_s *pholder = nxsem_findholder(sem, htcb);
   if (!pholder)
     {
-      pholder = nxsem_allocholder(sem);
+      pholder = nxsem_allocholder(sem, htcb);
     }
 
   return pholder;
@@ -200,59 +215,46 @@ static inline void nxsem_freeholder(sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *curr;
-  FAR struct semholder_s *prev;
-#endif
-
-  /* Release the holder and counts */
+  FAR struct semholder_s **link;
 
-  pholder->htcb   = NULL;
-  pholder->counts = 0;
-
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Search the list for the matching holder */
+  /* Remove the holder from the semaphore's list */
 
-  for (prev = NULL, curr = sem->hhead;
-       curr && curr != pholder;
-       prev = curr, curr = curr->flink);
+  if (pholder->blink != NULL)
+    {
+      pholder->blink->flink = pholder->flink;
+    }
+  else
+    {
+      sem->hhead = pholder->flink;
+    }
 
-  if (curr != NULL)
+  if (pholder->flink != NULL)
     {
-      /* Remove the holder from the list */
+      pholder->flink->blink = pholder->blink;
+    }
 
-      if (prev != NULL)
-        {
-          prev->flink = pholder->flink;
-        }
-      else
-        {
-          sem->hhead = pholder->flink;
-        }
+  /* And from the list of counts held by the thread */
 
-      /* And put it in the free list */
+  for (link = &pholder->htcb->holdsem;
+       *link != NULL && *link != pholder;
+       link = &(*link)->tlink);
 
-      pholder->flink = g_freeholders;
-      g_freeholders  = pholder;
+  if (*link != NULL)
+    {
+      *link = pholder->tlink;
     }
 #endif
-}
 
-/****************************************************************************
- * Name: nxsem_findandfreeholder
- ****************************************************************************/
+  /* Release the holder and counts */
 
-static inline void nxsem_findandfreeholder(sem_t *sem, FAR struct tcb_s *htcb)
-{
-  FAR struct semholder_s *pholder = nxsem_findholder(sem, htcb);
+  pholder->htcb   = NULL;
+  pholder->counts = 0;
 
-  /* When no more counts are held, remove the holder from the list.  The
-   * count was decremented in nxsem_releaseholder.
-   */
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* And return it to the pool */
 
-  if (pholder != NULL && pholder->counts <= 0)
-    {
-      nxsem_freeholder(sem, pholder);
-    }
+  mempool_free(&g_holderpool, pholder);
+#endif
 }
 
 /****************************************************************************
@@ -374,7 +376,8 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
 
               if (htcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
                 {
-                  htcb->pend_reprios[htcb->npend_reprio] = htcb->sched_priority;
+                  htcb->pend_reprios[htcb->npend_reprio] =
+                    htcb->sched_priority;
                   htcb->npend_reprio++;
                 }
               else
@@ -391,6 +394,7 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
            */
 
           (void)nxsched_setpriority(htcb, rtcb->sched_priority);
+          sem->flags |= PRIOINHERIT_FLAGS_BOOSTED;
         }
       else
         {
@@ -405,6 +409,7 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
             {
               htcb->pend_reprios[htcb->npend_reprio] = rtcb->sched_priority;
               htcb->npend_reprio++;
+              sem->flags |= PRIOINHERIT_FLAGS_BOOSTED;
             }
           else
             {
@@ -429,6 +434,7 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
        */
 
       (void)nxsched_setpriority(htcb, rtcb->sched_priority);
+      sem->flags |= PRIOINHERIT_FLAGS_BOOSTED;
     }
 #endif
 
@@ -480,42 +486,23 @@ static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
 #endif
 
 /****************************************************************************
- * Name: nxsem_restoreholderprio
+ * Name: nxsem_restoretcbprio
  ****************************************************************************/
 
-static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
-                                   FAR sem_t *sem, FAR void *arg)
+static void nxsem_restoretcbprio(FAR struct tcb_s *htcb,
+                                 FAR struct tcb_s *stcb)
 {
-  FAR struct semholder_s *pholder = 0;
 #if CONFIG_SEM_NNESTPRIO > 0
-  FAR struct tcb_s *stcb = (FAR struct tcb_s *)arg;
   int rpriority;
   int i;
   int j;
 #endif
 
-  /* Make sure that the holder thread is still active.  If it exited without
-   * releasing its counts, then that would be a bad thing.  But we can take
-   * no real action because we don't know know that the program is doing.
-   * Perhaps its plan is to kill a thread, then destroy the semaphore.
-   */
-
-  if (!sched_verifytcb(htcb))
-    {
-      serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
-      DEBUGPANIC();
-      pholder = nxsem_findholder(sem, htcb);
-      if (pholder != NULL)
-        {
-          nxsem_freeholder(sem, pholder);
-        }
-    }
-
   /* Was the priority of the holder thread boosted? If so, then drop its
    * priority back to the correct level.  What is the correct level?
    */
 
-  else if (htcb->sched_priority != htcb->base_priority)
+  if (htcb->sched_priority != htcb->base_priority)
     {
 #if CONFIG_SEM_NNESTPRIO > 0
       /* Are there other, pending priority levels to revert to? */
@@ -623,6 +610,33 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
       (void)nxsched_reprioritize(htcb, htcb->base_priority);
 #endif
     }
+}
+
+/****************************************************************************
+ * Name: nxsem_restoreholderprio
+ ****************************************************************************/
+
+static int nxsem_restoreholderprio(FAR struct semholder_s *pholder,
+                                   FAR sem_t *sem, FAR void *arg)
+{
+  FAR struct tcb_s *htcb = pholder->htcb;
+
+  /* Make sure that the holder thread is still active.  If it exited without
+   * releasing its counts, then that would be a bad thing.  But we can take
+   * no real action because we don't know know that the program is doing.
+   * Perhaps its plan is to kill a thread, then destroy the semaphore.
+   */
+
+  if (!sched_verifytcb(htcb))
+    {
+      serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
+      DEBUGPANIC();
+      nxsem_freeholder(sem, pholder);
+    }
+  else
+    {
+      nxsem_restoretcbprio(htcb, (FAR struct tcb_s *)arg);
+    }
 
   return 0;
 }
@@ -638,57 +652,23 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
 static int nxsem_restoreholderprioall(FAR struct semholder_s *pholder,
                                       FAR sem_t *sem, FAR void *arg)
 {
-  return nxsem_restoreholderprio(pholder->htcb, sem, arg);
+  return nxsem_restoreholderprio(pholder, sem, arg);
 }
 
 /****************************************************************************
- * Name: nxsem_restoreholderprioA
+ * Name: nxsem_restoreholderprioothers
  *
  * Description:
  *   Reprioritize all holders except the currently executing task
  *
  ****************************************************************************/
 
-static int nxsem_restoreholderprioA(FAR struct semholder_s *pholder,
-                                    FAR sem_t *sem, FAR void *arg)
-{
-  FAR struct tcb_s *rtcb = this_task();
-  if (pholder->htcb != rtcb)
-    {
-      return nxsem_restoreholderprio(pholder->htcb, sem, arg);
-    }
-
-  return 0;
-}
-
-/****************************************************************************
- * Name: nxsem_restoreholderprioB
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
-
-static int nxsem_restoreholderprioB(FAR struct semholder_s *pholder,
-                                    FAR sem_t *sem, FAR void *arg)
+static int nxsem_restoreholderprioothers(FAR struct semholder_s *pholder,
+                                         FAR sem_t *sem, FAR void *arg)
 {
-  FAR struct tcb_s *rtcb = this_task();
-
-  if (pholder->htcb == rtcb)
+  if (pholder->htcb != this_task())
     {
-      /* The running task has given up a count on the semaphore */
-
-#if CONFIG_SEM_PREALLOCHOLDERS == 0
-      /* In the case where there are only 2 holders. This step
-       * is necessary to insure we have space. Release the holder
-       * if all counts have been given up. before reprioritizing
-       * causes a context switch.
-       */
-
-      nxsem_findandfreeholder(sem, rtcb);
-#endif
-      (void)nxsem_restoreholderprio(rtcb, sem, arg);
-      return 1;
+      return nxsem_restoreholderprio(pholder, sem, arg);
     }
 
   return 0;
@@ -791,6 +771,13 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
                                               FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
+  FAR struct semholder_s *pholder;
+
+  /* The currently executing task should have an entry in the list.  Its
+   * counts were previously decremented in nxsem_releaseholder().
+   */
+
+  pholder = nxsem_findholder(sem, rtcb);
 
   /* Perform the following actions only if a new thread was given a count.
    * The thread that received the count should be the highest priority
@@ -806,15 +793,31 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
        * However, we cannot drop the priority of the currently running
        * thread -- because that will cause it to be suspended.
        *
-       * So, do this in two passes.  First, reprioritizing all holders
-       * except for the running thread.
+       * So, first reprioritize all holders except for the running thread.
        */
 
-      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioA, stcb);
+      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioothers, stcb);
+
+      /* Now, reprioritize only the running task */
 
-      /* Now, find an reprioritize only the ready to run task */
+      if (pholder != NULL)
+        {
+#if CONFIG_SEM_PREALLOCHOLDERS == 0
+          /* In the case where there are only 2 holders. This step
+           * is necessary to insure we have space. Release the holder
+           * if all counts have been given up. before reprioritizing
+           * causes a context switch.
+           */
 
-      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioB, stcb);
+          if (pholder->counts <= 0)
+            {
+              nxsem_freeholder(sem, pholder);
+              pholder = NULL;
+            }
+#endif
+
+          nxsem_restoretcbprio(rtcb, stcb);
+        }
     }
 
   /* If there are no tasks waiting for available counts, then all holders
@@ -828,12 +831,14 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
     }
 #endif
 
-  /* In any case, the currently executing task should have an entry in the
-   * list.  Its counts were previously decremented; if it now holds no
-   * counts, then we need to remove it from the list of holders.
+  /* In any case, if the currently executing task now holds no counts, then
+   * we need to remove it from the list of holders.
    */
 
-  nxsem_findandfreeholder(sem, rtcb);
+  if (pholder != NULL && pholder->counts <= 0)
+    {
+      nxsem_freeholder(sem, pholder);
+    }
 }
 
 /****************************************************************************
@@ -859,17 +864,14 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
 void nxsem_initholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  int i;
-
-  /* Put all of the pre-allocated holder structures into the free list */
-
-  g_freeholders = g_holderalloc;
-  for (i = 0; i < (CONFIG_SEM_PREALLOCHOLDERS - 1); i++)
-    {
-      g_holderalloc[i].flink = &g_holderalloc[i + 1];
-    }
+  /* Put all of the pre-allocated holder structures into the pool.  Holders
+   * are allocated while taking the heap semaphore, so the pool must not
+   * grow from the heap.
+   */
 
-  g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS - 1].flink = NULL;
+  (void)mempool_initialize(&g_holderpool, "semholder", g_holderalloc,
+                           sizeof(struct semholder_s),
+                           CONFIG_SEM_PREALLOCHOLDERS, 0, 0);
 #endif
 }
 
@@ -1051,11 +1053,18 @@ void nxsem_releaseholder(FAR sem_t *sem)
   pholder = nxsem_findholder(sem, rtcb);
   if (pholder != NULL && pholder->counts > 0)
     {
-      /* Decrement the counts on this holder -- the holder will be freed
-       * later in nxsem_restorebaseprio.
+      /* Decrement the counts on this holder.  If no holder priority was
+       * boosted on behalf of a waiter, then there is nothing to restore
+       * and the holder can be freed now.  Otherwise, the holder will be
+       * freed later in nxsem_restorebaseprio.
        */
 
       pholder->counts--;
+      if (pholder->counts <= 0 &&
+          (sem->flags & PRIOINHERIT_FLAGS_BOOSTED) == 0)
+        {
+          nxsem_freeholder(sem, pholder);
+        }
     }
 }
 
@@ -1101,6 +1110,16 @@ void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
               (sem->semcount <= 0 && stcb != NULL));
 #endif
 
+  /* If no holder was boosted on behalf of a waiter, then there are no
+   * priorities to restore.  The holder record of the posting thread was
+   * already released in nxsem_releaseholder().
+   */
+
+  if ((sem->flags & PRIOINHERIT_FLAGS_BOOSTED) == 0)
+    {
+      return;
+    }
+
   /* Handler semaphore counts posed from an interrupt handler differently
    * from interrupts posted from threads.  The primary difference is that
    * if the semaphore is posted from a thread, then the poster thread is
@@ -1117,6 +1136,15 @@ void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
     {
       nxsem_restorebaseprio_task(stcb, sem);
     }
+
+  /* If there are no further waiters, then all of the boosts have now been
+   * undone.
+   */
+
+  if (sem->semcount >= 0)
+    {
+      sem->flags &= ~PRIOINHERIT_FLAGS_BOOSTED;
+    }
 }
 
 /****************************************************************************
@@ -1146,9 +1174,44 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
 
   /* Adjust the priority of every holder as necessary */
 
-  (void)nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+  if ((sem->flags & PRIOINHERIT_FLAGS_BOOSTED) != 0)
+    {
+      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+    }
 }
 
+/****************************************************************************
+ * Name: nxsem_freeholders
+ *
+ * Description:
+ *   Called from nxsem_recover() when a thread is deleted or restarted to
+ *   release the holder records of every semaphore on which the thread still
+ *   holds counts.  The counts themselves are lost, but the semaphores will
+ *   no longer reference the stale TCB.
+ *
+ * Input Parameters:
+ *   htcb - The TCB of the terminated task or thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+void nxsem_freeholders(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+
+  while ((pholder = htcb->holdsem) != NULL)
+    {
+      nxsem_freeholder(pholder->sem, pholder);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: sem_enumholders
  *
@@ -1195,15 +1258,7 @@ void sem_enumholders(FAR sem_t *sem)
 int nxsem_nfreeholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *pholder;
-  int n;
-
-  for (pholder = g_freeholders, n = 0; pholder; pholder = pholder->flink)
-    {
-      n++;
-    }
-
-  return n;
+  return mempool_nfree(&g_holderpool);
 #else
   return 0;
 #endif
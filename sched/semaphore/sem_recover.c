@@ -58,11 +58,13 @@
  *   case where a task is waiting for semaphore at the time that is was
  *   killed.
  *
+ *   If priority inheritance holders are allocated from the pool, the holder
+ *   records of the thread are also released.
+ *
  *   REVISIT:  A more complete implementation would release counts on all
- *   semaphores held by the thread.  That would, however, require some
- *   significant extension to the semaphore data structures because given
- *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   semaphores held by the thread.  The holder records now make it possible
+ *   to find those semaphores, but only when priority inheritance is enabled
+ *   for them.
  *
  * Input Parameters:
  *   tcb - The TCB of the terminated task or thread
@@ -110,7 +112,7 @@ void nxsem_recover(FAR struct tcb_s *tcb)
        * place.
        */
 
-      sem->semcount++;
+      (void)NXSEM_COUNT_INC(sem);
 
       /* Clear the semaphore to assure that it is not reused.  But leave the
        * state as TSTATE_WAIT_SEM.  This is necessary because this is a
@@ -121,5 +123,10 @@ void nxsem_recover(FAR struct tcb_s *tcb)
       tcb->waitsem = NULL;
     }
 
+  /* Release the holder records of any semaphore counts still held by the
+   * thread so that no semaphore is left referring to the stale TCB.
+   */
+
+  nxsem_freeholders(tcb);
   leave_critical_section(flags);
 }
@@ -112,10 +112,24 @@ int nxsem_reset(FAR sem_t *sem, int16_t count)
    * value of sem->semcount is already correct in this case.
    */
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* The count may be changed concurrently by the uncontended fast path */
+
+  for (; ; )
+    {
+      int16_t semcount = sem->semcount;
+
+      if (semcount < 0 || up_cmpxchg16(&sem->semcount, semcount, count))
+        {
+          break;
+        }
+    }
+#else
   if (sem->semcount >= 0)
     {
       sem->semcount = count;
     }
+#endif
 
   /* Allow any pending context switches to occur now */
 
@@ -0,0 +1,440 @@
+/****************************************************************************
+ * sched/semaphore/sem_rwsem.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/rwsem.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrwsem_release
+ *
+ * Description:
+ *   Release one nested count held by the writer.  When the last count is
+ *   released, any waiting readers and writers are allowed to proceed.
+ *
+ * Assumptions:
+ *   Called within a critical section by the writer.
+ *
+ ****************************************************************************/
+
+static void nxrwsem_release(FAR rw_semaphore_t *rwsem)
+{
+  DEBUGASSERT(rwsem->holder == getpid() && rwsem->nwriters > 0);
+
+  if (--rwsem->nwriters == 0)
+    {
+      rwsem->holder = RWSEM_NO_HOLDER;
+      nxsem_post(&rwsem->wsem);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrwsem_init
+ *
+ * Description:
+ *   Initialize a reader-writer semaphore to its unlocked state.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be initialized
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_init(FAR rw_semaphore_t *rwsem)
+{
+  int ret;
+
+  DEBUGASSERT(rwsem != NULL);
+
+  /* The writer semaphore is a normal mutex so that waiters boost the
+   * writer.  The drain semaphore is used for signaling and must not have
+   * priority inheritance enabled.
+   */
+
+  ret = nxsem_init(&rwsem->wsem, 0, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxsem_init(&rwsem->drain, 0, 0);
+  if (ret < 0)
+    {
+      nxsem_destroy(&rwsem->wsem);
+      return ret;
+    }
+
+  (void)nxsem_setprotocol(&rwsem->drain, SEM_PRIO_NONE);
+
+  rwsem->holder   = RWSEM_NO_HOLDER;
+  rwsem->nwriters = 0;
+  rwsem->nreaders = 0;
+  rwsem->draining = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_destroy
+ *
+ * Description:
+ *   Destroy a reader-writer semaphore that is no longer held.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be destroyed
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_destroy(FAR rw_semaphore_t *rwsem)
+{
+  DEBUGASSERT(rwsem != NULL);
+  DEBUGASSERT(rwsem->holder == RWSEM_NO_HOLDER && rwsem->nreaders == 0);
+
+  nxsem_destroy(&rwsem->drain);
+  return nxsem_destroy(&rwsem->wsem);
+}
+
+/****************************************************************************
+ * Name: nxrwsem_rdlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for shared, read-only access, waiting
+ *   while a writer holds it.  The wait is not interrupted by signals.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int nxrwsem_rdlock(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+  int ret = OK;
+
+  DEBUGASSERT(rwsem != NULL && !up_interrupt_context());
+
+  flags = enter_critical_section();
+
+  /* A writer may also read.  That is simply one more nested count. */
+
+  if (rwsem->holder == me)
+    {
+      rwsem->nwriters++;
+      DEBUGASSERT(rwsem->nwriters > 0);
+    }
+  else
+    {
+      /* While a writer holds or has claimed the semaphore, wait for the
+       * writer semaphore.  This boosts the priority of the writer.  The
+       * writer semaphore is passed on immediately:  A reader only needs
+       * to know that the writer is done.
+       */
+
+      while (rwsem->holder != RWSEM_NO_HOLDER)
+        {
+          ret = nxsem_wait_uninterruptible(&rwsem->wsem);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          nxsem_post(&rwsem->wsem);
+        }
+
+      rwsem->nreaders++;
+      DEBUGASSERT(rwsem->nreaders > 0);
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_tryrdlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for shared access without waiting.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EAGAIN is returned if a writer
+ *   holds the semaphore.
+ *
+ ****************************************************************************/
+
+int nxrwsem_tryrdlock(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+  int ret = OK;
+
+  DEBUGASSERT(rwsem != NULL);
+
+  flags = enter_critical_section();
+  if (rwsem->holder == me)
+    {
+      rwsem->nwriters++;
+    }
+  else if (rwsem->holder == RWSEM_NO_HOLDER)
+    {
+      rwsem->nreaders++;
+    }
+  else
+    {
+      ret = -EAGAIN;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_rdunlock
+ *
+ * Description:
+ *   Release shared access to the reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxrwsem_rdunlock(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(rwsem != NULL);
+
+  flags = enter_critical_section();
+  if (rwsem->holder == getpid())
+    {
+      /* A read lock nested within the write lock */
+
+      nxrwsem_release(rwsem);
+    }
+  else
+    {
+      DEBUGASSERT(rwsem->nreaders > 0);
+
+      /* If this is the last reader and a writer is waiting, then wake up
+       * the writer.
+       */
+
+      if (--rwsem->nreaders == 0 && rwsem->draining)
+        {
+          rwsem->draining = false;
+          nxsem_post(&rwsem->drain);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxrwsem_wrlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for exclusive access, waiting for the
+ *   current writer and then for all readers to leave.  The wait is not
+ *   interrupted by signals.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int nxrwsem_wrlock(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+  int ret = OK;
+
+  DEBUGASSERT(rwsem != NULL && !up_interrupt_context());
+
+  flags = enter_critical_section();
+  if (rwsem->holder == me)
+    {
+      rwsem->nwriters++;
+      DEBUGASSERT(rwsem->nwriters > 0);
+      goto errout;
+    }
+
+  /* Wait for any other writer to finish */
+
+  ret = nxsem_wait_uninterruptible(&rwsem->wsem);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Claim the semaphore.  From here on, new readers will wait. */
+
+  rwsem->holder   = me;
+  rwsem->nwriters = 1;
+
+  /* Then wait for the current readers to leave */
+
+  while (rwsem->nreaders > 0)
+    {
+      rwsem->draining = true;
+      ret = nxsem_wait_uninterruptible(&rwsem->drain);
+      if (ret < 0)
+        {
+          /* Give up the claim and let any waiting readers continue */
+
+          rwsem->draining = false;
+          rwsem->nwriters = 0;
+          rwsem->holder   = RWSEM_NO_HOLDER;
+          nxsem_post(&rwsem->wsem);
+          break;
+        }
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_trywrlock
+ *
+ * Description:
+ *   Take the reader-writer semaphore for exclusive access without waiting.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EAGAIN is returned if the semaphore
+ *   is held by another writer or by any reader.
+ *
+ ****************************************************************************/
+
+int nxrwsem_trywrlock(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+  int ret = OK;
+
+  DEBUGASSERT(rwsem != NULL);
+
+  flags = enter_critical_section();
+  if (rwsem->holder == me)
+    {
+      rwsem->nwriters++;
+    }
+  else if (rwsem->nreaders > 0 || nxsem_trywait(&rwsem->wsem) < 0)
+    {
+      ret = -EAGAIN;
+    }
+  else
+    {
+      rwsem->holder   = me;
+      rwsem->nwriters = 1;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_wrunlock
+ *
+ * Description:
+ *   Release one count of exclusive access to the reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxrwsem_wrunlock(FAR rw_semaphore_t *rwsem)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(rwsem != NULL);
+
+  flags = enter_critical_section();
+  nxrwsem_release(rwsem);
+  leave_critical_section(flags);
+}
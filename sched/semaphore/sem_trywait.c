@@ -1,7 +1,8 @@
 /****************************************************************************
  * sched/semaphore/sem_trywait.c
  *
- *   Copyright (C) 2007-2009, 2016-2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2016-2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -80,14 +81,33 @@
 
 int nxsem_trywait(FAR sem_t *sem)
 {
+#ifndef CONFIG_SEM_FASTPATH
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+#endif
   int ret;
 
-  /* This API should not be called from interrupt handlers */
+  /* This API should not be called from interrupt handlers.  The exception
+   * is the system call fast path, which runs in the exception handler of
+   * the system call on behalf of the calling task.
+   */
 
+#ifndef CONFIG_LIB_SYSCALL_FASTPATH
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
+#else
+  DEBUGASSERT(sem != NULL);
+#endif
 
+#ifdef CONFIG_SEM_FASTPATH
+  if (sem != NULL)
+    {
+      /* No holder is recorded here so the count can always be taken
+       * atomically without entering the critical section.
+       */
+
+      ret = nxsem_fasttake(sem) ? OK : -EAGAIN;
+    }
+#else
   if (sem != NULL)
     {
       /* The following operations must be performed with interrupts disabled
@@ -117,6 +137,7 @@ int nxsem_trywait(FAR sem_t *sem)
 
       leave_critical_section(flags);
     }
+#endif
   else
     {
       ret = -EINVAL;
@@ -93,6 +93,15 @@ int nxsem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* Take an uncontended count without entering the critical section */
+
+  if (sem != NULL && NXSEM_FASTPATH(sem) && nxsem_fasttake(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -104,13 +113,12 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
-      /* Check if the lock is available */
+      /* Take a count and check if the lock was available */
 
-      if (sem->semcount > 0)
+      if (NXSEM_COUNT_DEC(sem) >= 0)
         {
-          /* It is, let the task take the semaphore. */
+          /* It was, let the task take the semaphore. */
 
-          sem->semcount--;
           nxsem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -130,9 +138,9 @@ int nxsem_wait(FAR sem_t *sem)
 
           DEBUGASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-          sem->semcount--;
+          /* The semaphore count was already decremented above to indicate
+           * that this thread is waiting (but the owner is not set yet).
+           */
 
           /* Save the waited on semaphore in the TCB */
 
@@ -48,6 +48,27 @@
 #include <semaphore.h>
 #include <sched.h>
 #include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The fast path may only be used if it is not necessary to record the
+ * holders of the semaphore for priority inheritance.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  ifdef CONFIG_PRIORITY_INHERITANCE
+#    define NXSEM_FASTPATH(s) (((s)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#  else
+#    define NXSEM_FASTPATH(s) (true)
+#  endif
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -94,6 +115,11 @@ void nxsem_boostpriority(FAR sem_t *sem);
 void nxsem_releaseholder(FAR sem_t *sem);
 void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+void nxsem_freeholders(FAR struct tcb_s *htcb);
+#  else
+#    define nxsem_freeholders(htcb)
+#  endif
 #else
 #  define nxsem_initholders()
 #  define nxsem_destroyholder(sem)
@@ -103,6 +129,19 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define nxsem_releaseholder(sem)
 #  define nxsem_restorebaseprio(stcb,sem)
 #  define nxsem_canceled(stcb,sem)
+#  define nxsem_freeholders(htcb)
+#endif
+
+/* Contention statistics of ticket and MCS spinlocks */
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+void spinstat_register(FAR struct spinstat_s *stat, FAR const char *name);
+void spinstat_acquired(FAR struct spinstat_s *stat, uint32_t nspins);
+void spinstat_released(FAR struct spinstat_s *stat);
+#else
+#  define spinstat_register(stat,name)
+#  define spinstat_acquired(stat,nspins) ((void)(nspins))
+#  define spinstat_released(stat)
 #endif
 
 #undef EXTERN
@@ -110,4 +149,78 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+/****************************************************************************
+ * Name: nxsem_fasttake
+ *
+ * Description:
+ *   Take a count from the semaphore without entering a critical section.
+ *   This succeeds only if a count is available.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   True if a count was taken; false if the semaphore count is not
+ *   positive and the caller must use the slow path.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fasttake(FAR sem_t *sem)
+{
+  int16_t count;
+
+  do
+    {
+      count = sem->semcount;
+      if (count <= 0)
+        {
+          return false;
+        }
+    }
+  while (!up_cmpxchg16(&sem->semcount, count, count - 1));
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxsem_fastgive
+ *
+ * Description:
+ *   Give a count to the semaphore without entering a critical section.
+ *   This succeeds only if no thread is waiting for the semaphore.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   True if the count was given; false if the semaphore count is negative
+ *   and the caller must use the slow path to wake up a waiting thread.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fastgive(FAR sem_t *sem)
+{
+  int16_t count;
+
+  do
+    {
+      count = sem->semcount;
+      if (count < 0)
+        {
+          return false;
+        }
+
+      DEBUGASSERT(count < SEM_VALUE_MAX);
+    }
+  while (!up_cmpxchg16(&sem->semcount, count, count + 1));
+
+  return true;
+}
+#endif /* CONFIG_SEM_FASTPATH */
+
 #endif /* __SCHED_SEMAPHORE_SEMAPHORE_H */
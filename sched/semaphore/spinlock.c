@@ -395,4 +395,198 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 }
 #endif
 
+/****************************************************************************
+ * Name: read_lock
+ *
+ * Description:
+ *   Take the reader-writer spinlock for reading, spinning while a writer
+ *   holds it.  The underlying spinlock is held only long enough to count
+ *   the new reader.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held for reading.
+ *
+ ****************************************************************************/
+
+void read_lock(FAR rwlock_t *rwlock)
+{
+  spin_lock(&rwlock->lock);
+  rwlock->readers++;
+  spin_unlock(&rwlock->lock);
+}
+
+/****************************************************************************
+ * Name: read_trylock
+ *
+ * Description:
+ *   Try once to take the reader-writer spinlock for reading.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   true if the lock is now held for reading; false if a writer holds it.
+ *
+ ****************************************************************************/
+
+bool read_trylock(FAR rwlock_t *rwlock)
+{
+  if (spin_trylock(&rwlock->lock) == SP_LOCKED)
+    {
+      return false;
+    }
+
+  rwlock->readers++;
+  spin_unlock(&rwlock->lock);
+  return true;
+}
+
+/****************************************************************************
+ * Name: read_unlock
+ *
+ * Description:
+ *   Release a reader-writer spinlock held for reading.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void read_unlock(FAR rwlock_t *rwlock)
+{
+  spin_lock(&rwlock->lock);
+  DEBUGASSERT(rwlock->readers > 0);
+  rwlock->readers--;
+  spin_unlock(&rwlock->lock);
+}
+
+/****************************************************************************
+ * Name: write_lock
+ *
+ * Description:
+ *   Take the reader-writer spinlock for writing, spinning until no other
+ *   writer holds it and all readers have left.
+ *
+ *   The underlying spinlock is released while waiting for the readers so
+ *   that they are able to leave; readers are preferred.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held for writing.
+ *
+ ****************************************************************************/
+
+void write_lock(FAR rwlock_t *rwlock)
+{
+  for (; ; )
+    {
+      spin_lock(&rwlock->lock);
+      if (rwlock->readers == 0)
+        {
+          return;
+        }
+
+      spin_unlock(&rwlock->lock);
+
+      /* Wait without the lock until the readers appear to be gone */
+
+      while (rwlock->readers != 0)
+        {
+          SP_DSB();
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: write_trylock
+ *
+ * Description:
+ *   Try once to take the reader-writer spinlock for writing.
+ *
+ * Input Parameters:
+ *   rwlock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   true if the lock is now held for writing; false if it is held by a
+ *   writer or by any reader.
+ *
+ ****************************************************************************/
+
+bool write_trylock(FAR rwlock_t *rwlock)
+{
+  if (spin_trylock(&rwlock->lock) == SP_LOCKED)
+    {
+      return false;
+    }
+
+  if (rwlock->readers != 0)
+    {
+      spin_unlock(&rwlock->lock);
+      return false;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: spin_lock_irqsave_scoped
+ *
+ * Description:
+ *   Disable local interrupts and take the spinlock that protects one
+ *   particular data structure.  Scoped spinlocks are not reentrant.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to take.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to spin_lock_irqsave_scoped();
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SCOPED
+irqstate_t spin_lock_irqsave_scoped(FAR volatile spinlock_t *lock)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  spin_lock(lock);
+  return flags;
+}
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_irqrestore_scoped
+ *
+ * Description:
+ *   Release the spinlock taken by spin_lock_irqsave_scoped() and restore
+ *   the interrupt state as it was prior to that call.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to release.
+ *   flags - The architecture-specific value that represents the state of
+ *           the interrupts prior to the call to spin_lock_irqsave_scoped();
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SCOPED
+void spin_unlock_irqrestore_scoped(FAR volatile spinlock_t *lock,
+                                   irqstate_t flags)
+{
+  spin_unlock(lock);
+  up_irq_restore(flags);
+}
+#endif
+
 #endif /* CONFIG_SPINLOCK */
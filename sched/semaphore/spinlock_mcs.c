@@ -0,0 +1,228 @@
+/****************************************************************************
+ * sched/semaphore/spinlock_mcs.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/spinlock.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SPINLOCK
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mcs_lock_init
+ *
+ * Description:
+ *   Initialize an MCS spinlock to the unlocked state.  If
+ *   CONFIG_SPINLOCK_STATISTICS is enabled, the lock is also registered so
+ *   that its statistics are reported in /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock to initialize.
+ *   name - The name of the lock.  The string is not copied.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mcs_lock_init(FAR mcs_lock_t *lock, FAR const char *name)
+{
+  DEBUGASSERT(lock != NULL);
+
+  spin_initialize(&lock->guard, SP_UNLOCKED);
+  lock->tail = NULL;
+
+  spinstat_register(&lock->stat, name);
+}
+
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Queue 'node' on the MCS spinlock and spin on it until the lock is
+ *   handed over.  The architectures provide no atomic exchange of a
+ *   pointer, so the guard spinlock is held while the node is linked.  The
+ *   waiting itself is done on the node of the caller only.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock.
+ *   node - The queue node of the caller.  It must remain valid until the
+ *          matching mcs_unlock() returns.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void mcs_lock(FAR mcs_lock_t *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *prev;
+  uint32_t nspins = 0;
+
+  DEBUGASSERT(lock != NULL && node != NULL);
+
+  node->next    = NULL;
+  node->waiting = true;
+
+  /* Append the node to the queue */
+
+  spin_lock(&lock->guard);
+  prev       = lock->tail;
+  lock->tail = node;
+  if (prev != NULL)
+    {
+      prev->next = node;
+    }
+
+  spin_unlock(&lock->guard);
+
+  /* If there was a previous node, wait until its holder hands the lock
+   * over.
+   */
+
+  if (prev != NULL)
+    {
+      while (node->waiting)
+        {
+          nspins++;
+          SP_DSB();
+        }
+    }
+
+  SP_DMB();
+  spinstat_acquired(&lock->stat, nspins);
+}
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Take the MCS spinlock only if it is free.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock.
+ *   node - The queue node of the caller.
+ *
+ * Returned Value:
+ *   true if the lock is now held by this CPU; false otherwise.
+ *
+ ****************************************************************************/
+
+bool mcs_trylock(FAR mcs_lock_t *lock, FAR struct mcs_node_s *node)
+{
+  bool locked = false;
+
+  DEBUGASSERT(lock != NULL && node != NULL);
+
+  node->next    = NULL;
+  node->waiting = false;
+
+  spin_lock(&lock->guard);
+  if (lock->tail == NULL)
+    {
+      lock->tail = node;
+      locked     = true;
+    }
+
+  spin_unlock(&lock->guard);
+
+  if (locked)
+    {
+      SP_DMB();
+      spinstat_acquired(&lock->stat, 0);
+    }
+
+  return locked;
+}
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release the MCS spinlock to the next queued node, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock.
+ *   node - The node that was passed to mcs_lock() or mcs_trylock().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mcs_unlock(FAR mcs_lock_t *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *next;
+
+  DEBUGASSERT(lock != NULL && node != NULL && lock->tail != NULL);
+
+  spinstat_released(&lock->stat);
+  SP_DMB();
+
+  /* Either the queue becomes empty or the next node takes over.  The next
+   * link is set while the guard is held, so it cannot be in transit here.
+   */
+
+  spin_lock(&lock->guard);
+  next = node->next;
+  if (next == NULL)
+    {
+      DEBUGASSERT(lock->tail == node);
+      lock->tail = NULL;
+    }
+
+  spin_unlock(&lock->guard);
+
+  if (next != NULL)
+    {
+      next->waiting = false;
+      SP_DSB();
+    }
+}
+
+#endif /* CONFIG_SPINLOCK */
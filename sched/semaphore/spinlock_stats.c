@@ -0,0 +1,169 @@
+/****************************************************************************
+ * sched/semaphore/spinlock_stats.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of all registered locks, most recently initialized first */
+
+static FAR struct spinstat_s *g_spinstats;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinstat_register
+ *
+ * Description:
+ *   Clear the statistics of a ticket or MCS spinlock and add them to the
+ *   list reported by spinstat_foreach().
+ *
+ ****************************************************************************/
+
+void spinstat_register(FAR struct spinstat_s *stat, FAR const char *name)
+{
+  irqstate_t flags;
+
+  stat->name      = name != NULL ? name : "unnamed";
+  stat->nacquired = 0;
+  stat->nspins    = 0;
+  stat->maxhold   = 0;
+  stat->start     = 0;
+
+  flags       = enter_critical_section();
+  stat->flink = g_spinstats;
+  g_spinstats = stat;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: spinstat_acquired
+ *
+ * Description:
+ *   Account for one acquisition of a lock after 'nspins' loops of waiting.
+ *
+ * Assumptions:
+ *   Called by the holder of the lock.
+ *
+ ****************************************************************************/
+
+void spinstat_acquired(FAR struct spinstat_s *stat, uint32_t nspins)
+{
+  stat->nacquired++;
+  stat->nspins += nspins;
+  stat->start   = up_critmon_gettime();
+}
+
+/****************************************************************************
+ * Name: spinstat_released
+ *
+ * Description:
+ *   Account for the hold time of a lock that is about to be released.
+ *
+ * Assumptions:
+ *   Called by the holder of the lock.
+ *
+ ****************************************************************************/
+
+void spinstat_released(FAR struct spinstat_s *stat)
+{
+  uint32_t elapsed = up_critmon_gettime() - stat->start;
+
+  if (elapsed > stat->maxhold)
+    {
+      stat->maxhold = elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: spinstat_foreach
+ *
+ * Description:
+ *   Call 'handler' with the statistics of each registered ticket or MCS
+ *   spinlock.  No lock is held while the handler runs.  The counters are
+ *   sampled without taking the locks, so they may be slightly out of date.
+ *
+ * Input Parameters:
+ *   handler - The function to be called for each lock
+ *   arg     - An argument passed through to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spinstat_foreach(spinstat_handler_t handler, FAR void *arg)
+{
+  FAR struct spinstat_s *stat;
+  struct spinstatinfo_s info;
+  struct timespec ts;
+
+  DEBUGASSERT(handler != NULL);
+
+  for (stat = g_spinstats; stat != NULL; stat = stat->flink)
+    {
+      up_critmon_convert(stat->maxhold, &ts);
+
+      info.name      = stat->name;
+      info.nacquired = stat->nacquired;
+      info.nspins    = stat->nspins;
+      info.maxhold   = (unsigned long)ts.tv_sec * 1000000 +
+                       ts.tv_nsec / 1000;
+
+      handler(&info, arg);
+    }
+}
+
+#endif /* CONFIG_SPINLOCK_STATISTICS */
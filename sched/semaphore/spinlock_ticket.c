@@ -0,0 +1,206 @@
+/****************************************************************************
+ * sched/semaphore/spinlock_ticket.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SPINLOCK
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ticket_lock_init
+ *
+ * Description:
+ *   Initialize a ticket spinlock to the unlocked state.  If
+ *   CONFIG_SPINLOCK_STATISTICS is enabled, the lock is also registered so
+ *   that its statistics are reported in /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock to initialize.
+ *   name - The name of the lock.  The string is not copied.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ticket_lock_init(FAR ticket_lock_t *lock, FAR const char *name)
+{
+  DEBUGASSERT(lock != NULL);
+
+#ifndef CONFIG_ARCH_HAVE_FETCHADD
+  spin_initialize(&lock->guard, SP_UNLOCKED);
+#endif
+  lock->next  = 0;
+  lock->owner = 0;
+
+  spinstat_register(&lock->stat, name);
+}
+
+/****************************************************************************
+ * Name: ticket_lock
+ *
+ * Description:
+ *   Draw a ticket and spin until it is served.  The ticket is drawn with
+ *   an atomic fetch-and-add if the architecture supports it.  Otherwise,
+ *   the guard spinlock is held just long enough to draw the ticket.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void ticket_lock(FAR ticket_lock_t *lock)
+{
+  uint32_t nspins = 0;
+  int16_t ticket;
+
+  DEBUGASSERT(lock != NULL);
+
+#ifdef CONFIG_ARCH_HAVE_FETCHADD
+  /* up_fetchadd16() returns the incremented value */
+
+  ticket = up_fetchadd16(&lock->next, 1) - 1;
+#else
+  spin_lock(&lock->guard);
+  ticket = lock->next++;
+  spin_unlock(&lock->guard);
+#endif
+
+  /* Wait for our turn.  Only the owner field is read while waiting. */
+
+  while (lock->owner != ticket)
+    {
+      nspins++;
+      SP_DSB();
+    }
+
+  SP_DMB();
+  spinstat_acquired(&lock->stat, nspins);
+}
+
+/****************************************************************************
+ * Name: ticket_trylock
+ *
+ * Description:
+ *   Take the ticket spinlock only if it is free and nobody is waiting.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock.
+ *
+ * Returned Value:
+ *   true if the lock is now held by this CPU; false otherwise.
+ *
+ ****************************************************************************/
+
+bool ticket_trylock(FAR ticket_lock_t *lock)
+{
+  int16_t owner;
+  bool locked;
+
+  DEBUGASSERT(lock != NULL);
+
+  /* The lock is free if the next ticket would be served immediately */
+
+  owner = lock->owner;
+
+#ifdef CONFIG_ARCH_HAVE_FETCHADD
+  locked = up_cmpxchg16(&lock->next, owner, owner + 1);
+#else
+  spin_lock(&lock->guard);
+  locked = (lock->next == owner);
+  if (locked)
+    {
+      lock->next++;
+    }
+
+  spin_unlock(&lock->guard);
+#endif
+
+  if (locked)
+    {
+      SP_DMB();
+      spinstat_acquired(&lock->stat, 0);
+    }
+
+  return locked;
+}
+
+/****************************************************************************
+ * Name: ticket_unlock
+ *
+ * Description:
+ *   Release the ticket spinlock to the next waiter, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ticket_unlock(FAR ticket_lock_t *lock)
+{
+  DEBUGASSERT(lock != NULL && lock->owner != lock->next);
+
+  spinstat_released(&lock->stat);
+
+  /* Only the holder modifies the owner field */
+
+  SP_DMB();
+  lock->owner++;
+  SP_DSB();
+}
+
+#endif /* CONFIG_SPINLOCK */
@@ -55,21 +55,43 @@
  * Name: nxsig_alloc_pendingsigaction
  *
  * Description:
- *   Allocate a new element for the pending signal action queue
+ *   Allocate a new element for the pending signal action queue.  The
+ *   entries pre-allocated with the task group of the receiving thread are
+ *   used first.
  *
  ****************************************************************************/
 
-FAR sigq_t *nxsig_alloc_pendingsigaction(void)
+FAR sigq_t *nxsig_alloc_pendingsigaction(FAR struct task_group_s *group)
 {
   FAR sigq_t    *sigq;
   irqstate_t flags;
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  /* Try the free list of the group first.  This is the same in any
+   * context.
+   */
+
+  flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
+  sigq = (FAR sigq_t *)sq_remfirst(&group->tg_sigactionfree);
+  spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
+
+  if (sigq != NULL)
+    {
+      return sigq;
+    }
+#else
+  UNUSED(group);
+#endif
+
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
     {
-      /* Try to get the pending signal action structure from the free list */
+      /* Try to get the pending signal action structure from the free list.
+       * In SMP mode, another CPU may be accessing the list.
+       */
 
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
 
       /* If so, then try the special list of structures reserved for
@@ -80,6 +102,8 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
         {
           sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingirqaction);
         }
+
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
     }
 
   /* If we were not called from an interrupt handler, then we are
@@ -90,9 +114,9 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
     {
       /* Try to get the pending signal action structure from the free list */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
 
       /* Check if we got one. */
 
@@ -60,6 +60,51 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsig_coalesce_action
+ *
+ * Description:
+ *   Check if the same signal event is already waiting in the pending signal
+ *   action queue of the task.  A repeated event carries no new information
+ *   and need not be delivered twice: Only signals sent with sigqueue() must
+ *   be queued one by one.  Other signals with the same number, source and
+ *   value (e.g. repeated kill() or expirations of the same POSIX timer) are
+ *   merged into the entry that is already queued.
+ *
+ * Returned Value:
+ *   True if the signal was merged into a queued entry.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static bool nxsig_coalesce_action(FAR struct tcb_s *stcb,
+                                  FAR siginfo_t *info)
+{
+  FAR sigq_t *sigq;
+
+  if (info->si_code == SI_QUEUE)
+    {
+      return false;
+    }
+
+  for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head;
+       sigq != NULL;
+       sigq = sigq->flink)
+    {
+      if (sigq->info.si_signo == info->si_signo &&
+          sigq->info.si_code == info->si_code &&
+          sigq->info.si_value.sival_ptr == info->si_value.sival_ptr)
+        {
+          memcpy(&sigq->info, info, sizeof(siginfo_t));
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: nxsig_queue_action
  *
@@ -91,12 +136,24 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
+      /* A repeated signal event does not need another queue entry */
+
+      flags = enter_critical_section();
+      if (nxsig_coalesce_action(stcb, info))
+        {
+          leave_critical_section(flags);
+          sched_unlock();
+          return OK;
+        }
+
+      leave_critical_section(flags);
+
       /* Allocate a new element for the signal queue.  NOTE:
        * nxsig_alloc_pendingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data.
        */
 
-      sigq = nxsig_alloc_pendingsigaction();
+      sigq = nxsig_alloc_pendingsigaction(stcb->group);
       if (!sigq)
         {
           ret = -ENOMEM;
@@ -129,17 +186,38 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
  *
  ****************************************************************************/
 
-static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
+static FAR sigpendq_t *
+  nxsig_alloc_pendingsignal(FAR struct task_group_s *group)
 {
   FAR sigpendq_t *sigpend;
   irqstate_t      flags;
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  /* Try the free list of the group first.  This is the same in any
+   * context.
+   */
+
+  flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
+  sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendfree);
+  spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
+
+  if (sigpend != NULL)
+    {
+      return sigpend;
+    }
+#else
+  UNUSED(group);
+#endif
+
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
     {
-      /* Try to get the pending signal structure from the free list */
+      /* Try to get the pending signal structure from the free list.  In
+       * SMP mode, another CPU may be accessing the list.
+       */
 
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
       if (!sigpend)
         {
@@ -150,6 +228,8 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 
           sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingirqsignal);
         }
+
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
     }
 
   /* If we were not called from an interrupt handler, then we are
@@ -160,9 +240,9 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
     {
       /* Try to get the pending signal structure from the free list */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
 
       /* Check if we got one. */
 
@@ -254,7 +334,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
     {
       /* Allocate a new pending signal entry */
 
-      sigpend = nxsig_alloc_pendingsignal();
+      sigpend = nxsig_alloc_pendingsignal(group);
       if (sigpend != NULL)
         {
           /* Put the signal information into the allocated structure */
@@ -83,6 +83,14 @@ sq_queue_t  g_sigpendingsignal;
 
 sq_queue_t  g_sigpendingirqsignal;
 
+#ifdef CONFIG_SPINLOCK_SCOPED
+/* Protects the lists of available pending signal actions and pending
+ * signal structures.
+ */
+
+spinlock_t  g_sigpendinglock SP_SECTION = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -275,3 +283,41 @@ void nxsig_alloc_actionblock(void)
         }
     }
 }
+
+/****************************************************************************
+ * Name: nxsig_initialize_group
+ *
+ * Description:
+ *   Place the pending signal actions and pending signals that were
+ *   allocated together with the task group on the free lists of the group.
+ *   The SIG_GROUP_POOLSIZE bytes of entries follow the group structure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+void nxsig_initialize_group(FAR struct task_group_s *group)
+{
+  FAR sigq_t *sigq;
+  FAR sigpendq_t *sigpend;
+  int i;
+
+  sq_init(&group->tg_sigactionfree);
+  sq_init(&group->tg_sigpendfree);
+
+  sigq = (FAR sigq_t *)(group + 1);
+  for (i = 0; i < CONFIG_SIG_PREALLOC_GROUP; i++)
+    {
+      sigq->type  = SIG_ALLOC_GROUP;
+      sigq->group = group;
+      sq_addlast((FAR sq_entry_t *)sigq++, &group->tg_sigactionfree);
+    }
+
+  sigpend = (FAR sigpendq_t *)sigq;
+  for (i = 0; i < CONFIG_SIG_PREALLOC_GROUP; i++)
+    {
+      sigpend->type  = SIG_ALLOC_GROUP;
+      sigpend->group = group;
+      sq_addlast((FAR sq_entry_t *)sigpend++, &group->tg_sigpendfree);
+    }
+}
+#endif
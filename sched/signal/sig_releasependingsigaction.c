@@ -71,9 +71,9 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingaction);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -86,11 +86,24 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingirqaction);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
     }
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  /* If this was pre-allocated with its task group, then put it back in
+   * the free list of the group.
+   */
+
+  else if (sigq->type == SIG_ALLOC_GROUP)
+    {
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
+      sq_addlast((FAR sq_entry_t *)sigq, &sigq->group->tg_sigactionfree);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate signals because they will not
    * receive them.
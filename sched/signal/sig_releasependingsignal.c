@@ -79,9 +79,9 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -94,11 +94,24 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
       sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingirqsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
     }
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  /* If this was pre-allocated with its task group, then put it back in
+   * the free list of the group.
+   */
+
+  else if (sigpend->type == SIG_ALLOC_GROUP)
+    {
+      flags = spin_lock_irqsave_scoped(&g_sigpendinglock);
+      sq_addlast((FAR sq_entry_t *)sigpend, &sigpend->group->tg_sigpendfree);
+      spin_unlock_irqrestore_scoped(&g_sigpendinglock, flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate signals because they will not
    * receive them.
@@ -54,6 +54,7 @@
 #include <nuttx/wdog.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/timers/hrtimer.h>
 
 #include "sched/sched.h"
 #include "signal/signal.h"
@@ -143,6 +144,89 @@ static void nxsig_timeout(int argc, wdparm_t itcb)
 #endif
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   A high resolution timeout elapsed while waiting for signals to be
+ *   queued.
+ *
+ * Assumptions:
+ *   This function executes in the context of the oneshot timer interrupt
+ *   handler.  Local interrupts are assumed to be disabled on entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void nxsig_hrtimeout(FAR struct hrtimer_s *timer, FAR void *arg)
+{
+  union
+  {
+    FAR struct tcb_s *wtcb;
+    wdparm_t itcb;
+  } u;
+
+  u.wtcb = (FAR struct tcb_s *)arg;
+  nxsig_timeout(1, u.itcb);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsig_hrtimedwait
+ *
+ * Description:
+ *   Wait for a signal with a high resolution timeout.
+ *
+ * Input Parameters:
+ *   rtcb    - The TCB of the waiting task
+ *   timeout - The relative timeout
+ *
+ * Returned Value:
+ *   Zero (OK) if the wait was performed.  A negated errno value if no high
+ *   resolution timer is available; the caller must then use a watchdog.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int nxsig_hrtimedwait(FAR struct tcb_s *rtcb,
+                             FAR const struct timespec *timeout)
+{
+  struct hrtimer_s hrtimer;
+  int ret;
+
+  hrtimer_init(&hrtimer, nxsig_hrtimeout, rtcb);
+  ret = hrtimer_start(&hrtimer,
+                      (uint64_t)timeout->tv_sec * NSEC_PER_SEC +
+                      timeout->tv_nsec, HRTIMER_MODE_REL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The timer lives on this stack.  Keep a reference in the TCB so that
+   * it can be cancelled if the task is deleted while waiting.
+   */
+
+  rtcb->waithrtimer = &hrtimer;
+
+  /* Now wait for either the signal or the timer, but first, make sure this
+   * is not the idle task, descheduling that isn't going to end well.
+   */
+
+  DEBUGASSERT(NULL != rtcb->flink);
+  up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+  /* We no longer need the timer */
+
+  (void)hrtimer_cancel(&hrtimer);
+  rtcb->waithrtimer = NULL;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -314,8 +398,17 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       rtcb->sigwaitmask = *set;
 
-      /* Check if we should wait for the timeout */
+      /* Check if we should wait for the timeout.  Use a high resolution
+       * timer if one is available.
+       */
 
+#ifdef CONFIG_HRTIMER
+      if (timeout != NULL && nxsig_hrtimedwait(rtcb, timeout) == OK)
+        {
+          /* The wait is complete */
+        }
+      else
+#endif
       if (timeout != NULL)
         {
           /* Convert the timespec to system clock ticks, making sure that
@@ -49,6 +49,8 @@
 #include <sched.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -64,6 +66,13 @@
 #define NUM_SIGNALS_PENDING     16
 #define NUM_INT_SIGNALS_PENDING  8
 
+/* The size of the pending signal actions and pending signals that are
+ * allocated together with each task group.
+ */
+
+#define SIG_GROUP_POOLSIZE \
+  (CONFIG_SIG_PREALLOC_GROUP * (sizeof(sigq_t) + sizeof(sigpendq_t)))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -74,7 +83,8 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_GROUP       /* Preallocated with the task group */
 };
 
 /* The following defines the sigaction queue entry */
@@ -98,6 +108,9 @@ struct sigpendq
   FAR struct sigpendq *flink;    /* Forward link */
   siginfo_t info;                /* Signal information */
   uint8_t   type;                /* (Used to manage allocations) */
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  FAR struct task_group_s *group; /* Owner of a SIG_ALLOC_GROUP entry */
+#endif
 };
 typedef struct sigpendq sigpendq_t;
 
@@ -116,6 +129,9 @@ struct sigq_s
                                   * the signal-catching function executes */
   siginfo_t info;                /* Signal information */
   uint8_t   type;                /* (Used to manage allocations) */
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  FAR struct task_group_s *group; /* Owner of a SIG_ALLOC_GROUP entry */
+#endif
 };
 typedef struct sigq_s sigq_t;
 
@@ -153,6 +169,14 @@ extern sq_queue_t  g_sigpendingsignal;
 
 extern sq_queue_t  g_sigpendingirqsignal;
 
+#ifdef CONFIG_SPINLOCK_SCOPED
+/* Protects the lists of available pending signal actions and pending
+ * signal structures.
+ */
+
+extern spinlock_t  g_sigpendinglock;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -166,6 +190,9 @@ struct task_group_s;
 
 void weak_function nxsig_initialize(void);
 void               nxsig_alloc_actionblock(void);
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+void               nxsig_initialize_group(FAR struct task_group_s *group);
+#endif
 
 /* sig_action.c */
 
@@ -203,7 +230,7 @@ void nxsig_wait_irq(FAR struct tcb_s *wtcb, int errcode);
 
 /* In files of the same name */
 
-FAR sigq_t        *nxsig_alloc_pendingsigaction(void);
+FAR sigq_t        *nxsig_alloc_pendingsigaction(FAR struct task_group_s *group);
 void               nxsig_deliver(FAR struct tcb_s *stcb);
 FAR sigactq_t     *nxsig_find_action(FAR struct task_group_s *group, int signo);
 int                nxsig_lowest(FAR sigset_t *set);
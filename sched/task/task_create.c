@@ -93,7 +93,16 @@ static int nxthread_create(FAR const char *name, uint8_t ttype,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+#ifdef CONFIG_SCHED_TCBCACHE
+  /* Re-use a cached TCB with a stack of the requested size, if possible */
+
+  tcb = (FAR struct task_tcb_s *)nxsched_tcbcache_alloc(ttype, stack_size);
+  if (tcb == NULL)
+#endif
+    {
+      tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+    }
+
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -126,12 +135,23 @@ static int nxthread_create(FAR const char *name, uint8_t ttype,
         }
     }
 
-  /* Allocate the stack for the TCB */
+  /* Allocate the stack for the TCB.  A cached TCB already has its stack. */
 
-  ret = up_create_stack((FAR struct tcb_s *)tcb, stack_size, ttype);
-  if (ret < OK)
+#ifdef CONFIG_SCHED_TCBCACHE
+  if (tcb->cmn.stack_alloc_ptr == NULL)
+#endif
     {
-      goto errout_with_tcb;
+      ret = up_create_stack((FAR struct tcb_s *)tcb, stack_size, ttype);
+      if (ret < OK)
+        {
+          goto errout_with_tcb;
+        }
+
+#ifdef CONFIG_SCHED_TCBCACHE
+      /* The TCB and this stack may be cached when the task exits */
+
+      tcb->cmn.cache_stack_size = stack_size;
+#endif
     }
 
   /* Initialize the task control block */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/task/task_exithook.c
  *
- *   Copyright (C) 2011-2013, 2015. 2018-2019 Gregory Nutt. All rights
+ *   Copyright (C) 2011-2013, 2015. 2018-2020 Gregory Nutt. All rights
  *     reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
@@ -692,6 +692,12 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status, bool nonblocking)
       nxtask_flushstreams(tcb);
     }
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Tear down the poll registrations cached by the thread */
+
+  poll_cache_release(tcb);
+
+#endif
   /* Leave the task group.  Perhaps discarding any un-reaped child
    * status (no zombies here!)
    */
@@ -44,6 +44,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
 #include <nuttx/sched.h>
+#include <nuttx/timers/hrtimer.h>
 
 #include "semaphore/semaphore.h"
 #include "wdog/wdog.h"
@@ -80,6 +81,16 @@ void nxtask_recover(FAR struct tcb_s *tcb)
 
   wd_recover(tcb);
 
+#ifdef CONFIG_HRTIMER
+  /* Or the high resolution timer of a timed signal wait */
+
+  if (tcb->waithrtimer != NULL)
+    {
+      (void)hrtimer_cancel(tcb->waithrtimer);
+      tcb->waithrtimer = NULL;
+    }
+#endif
+
   /* If the thread holds semaphore counts or is waiting for a semaphore count,
    * then release the counts.
    */
@@ -100,4 +111,13 @@ void nxtask_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(sched_sporadic_stop(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Stop current deadline scheduling */
+
+      DEBUGVERIFY(sched_deadline_stop(tcb));
+    }
+#endif
 }
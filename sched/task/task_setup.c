@@ -176,6 +176,12 @@ static inline void nxtask_inherit_affinity(FAR struct tcb_s *tcb)
 {
   FAR struct tcb_s *rtcb = this_task();
   tcb->affinity = rtcb->affinity;
+
+  /* The new task has not run anywhere yet.  Its arguments and its parent
+   * are still in the cache of this CPU.
+   */
+
+  tcb->cpu = rtcb->cpu;
 }
 #else
 #  define nxtask_inherit_affinity(tcb)
@@ -1,7 +1,8 @@
 /****************************************************************************
  * sched/timer/timer.h
  *
- *   Copyright (C) 2007-2009, 2014-2015 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2014-2015, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -46,6 +47,7 @@
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
 
@@ -54,6 +56,8 @@
  ****************************************************************************/
 
 #define PT_FLAGS_PREALLOCATED 0x01 /* Timer comes from a pool of preallocated timers */
+#define PT_FLAGS_ARMED        0x02 /* Timer is armed in its timer wheel */
+#define PT_FLAGS_BATCHED      0x04 /* Timer waits for a batched notification */
 
 /****************************************************************************
  * Public Types
@@ -61,16 +65,29 @@
 
 /* This structure represents one POSIX timer */
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+struct timer_wheel_s; /* Forward reference */
+#endif
+
 struct posix_timer_s
 {
   FAR struct posix_timer_s *flink;
+  FAR struct posix_timer_s *blink;
 
   uint8_t          pt_flags;       /* See PT_FLAGS_* definitions */
   uint8_t          pt_crefs;       /* Reference count */
   pid_t            pt_owner;       /* Creator of timer */
   int              pt_delay;       /* If non-zero, used to reset repetitive timers */
   int              pt_last;        /* Last value used to set watchdog */
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+  FAR struct timer_wheel_s *pt_wheel; /* The wheel of the owning process */
+  FAR struct posix_timer_s *pt_wnext; /* Next timer in the wheel slot */
+  FAR struct posix_timer_s *pt_wprev; /* Previous timer in the wheel slot */
+  FAR struct posix_timer_s *pt_bnext; /* Next timer in the notification batch */
+  clock_t          pt_expiry;      /* Tick of the next expiration */
+#else
   WDOG_ID          pt_wdog;        /* The watchdog that provides the timing */
+#endif
   struct sigevent  pt_event;       /* Notification information */
   struct sigwork_s pt_work;
 };
@@ -90,7 +107,7 @@ extern volatile sq_queue_t g_freetimers;
  * timer_delete() or when the owning thread exits.
  */
 
-extern volatile sq_queue_t g_alloctimers;
+extern volatile dq_queue_t g_alloctimers;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -100,4 +117,12 @@ void weak_function timer_initialize(void);
 void weak_function timer_deleteall(pid_t pid);
 int timer_release(FAR struct posix_timer_s *timer);
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+int timer_wheel_attach(FAR struct posix_timer_s *timer);
+void timer_wheel_detach(FAR struct posix_timer_s *timer);
+int timer_wheel_start(FAR struct posix_timer_s *timer, sclock_t delay);
+void timer_wheel_cancel(FAR struct posix_timer_s *timer);
+sclock_t timer_wheel_gettime(FAR struct posix_timer_s *timer);
+#endif
+
 #endif /* __SCHED_TIMER_TIMER_H */
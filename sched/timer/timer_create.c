@@ -1,8 +1,8 @@
 /****************************************************************************
  * sched/timer/timer_create.c
  *
- *   Copyright (C) 2007-2009, 2011, 2014-2017 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2007-2009, 2011, 2014-2017, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -106,7 +106,7 @@ static FAR struct posix_timer_s *timer_allocate(void)
       /* And add it to the end of the list of allocated timers */
 
       flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)ret, (FAR sq_queue_t *)&g_alloctimers);
+      dq_addlast((FAR dq_entry_t *)ret, (FAR dq_queue_t *)&g_alloctimers);
       leave_critical_section(flags);
     }
 
@@ -170,7 +170,9 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
                  FAR timer_t *timerid)
 {
   FAR struct posix_timer_s *ret;
+#ifndef CONFIG_POSIX_TIMER_WHEEL
   WDOG_ID wdog;
+#endif
 
   /* Sanity checks.  Also, we support only CLOCK_REALTIME */
 
@@ -180,6 +182,26 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
       return ERROR;
     }
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+  /* Allocate a timer instance.  The timer wheel of the process provides
+   * the underlying CLOCK_REALTIME timer.
+   */
+
+  ret = timer_allocate();
+  if (!ret)
+    {
+      set_errno(EAGAIN);
+      return ERROR;
+    }
+
+  ret->pt_crefs = 1;
+  if (timer_wheel_attach(ret) < 0)
+    {
+      (void)timer_release(ret);
+      set_errno(EAGAIN);
+      return ERROR;
+    }
+#else
   /* Allocate a watchdog to provide the underling CLOCK_REALTIME timer */
 
   wdog = wd_create();
@@ -199,12 +221,14 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
       return ERROR;
     }
 
+  ret->pt_wdog  = wdog;
+#endif
+
   /* Initialize the timer instance */
 
   ret->pt_crefs = 1;
   ret->pt_owner = getpid();
   ret->pt_delay = 0;
-  ret->pt_wdog  = wdog;
 
   /* Was a struct sigevent provided? */
 
@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/timer/timer_gettime.c
  *
- *   Copyright (C) 2007 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -96,7 +96,11 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 
   /* Get the number of ticks before the underlying watchdog expires */
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+  ticks = timer_wheel_gettime(timer);
+#else
   ticks = wd_gettime(timer->pt_wdog);
+#endif
 
   /* Convert that to a struct timespec and return it */
 
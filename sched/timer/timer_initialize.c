@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/timer/timer_initialize.c
  *
- *   Copyright (C) 2007, 2009 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2009, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -76,7 +76,7 @@ volatile sq_queue_t g_freetimers;
  * list by timer_delete() or when the owning thread exits.
  */
 
-volatile sq_queue_t g_alloctimers;
+volatile dq_queue_t g_alloctimers;
 
 /****************************************************************************
  * Public Functions
@@ -115,7 +115,7 @@ void weak_function timer_initialize(void)
 
   /* Initialize the list of allocated timers */
 
-  sq_init((FAR sq_queue_t *)&g_alloctimers);
+  dq_init((FAR dq_queue_t *)&g_alloctimers);
 }
 
 /****************************************************************************
@@ -1,7 +1,7 @@
 /****************************************************************************
  * sched/timer/timer_release.c
  *
- *   Copyright (C) 2008 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2008, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -70,7 +70,7 @@ static inline void timer_free(struct posix_timer_s *timer)
   /* Remove the timer from the allocated list */
 
   flags = enter_critical_section();
-  sq_rem((FAR sq_entry_t *)timer, (FAR sq_queue_t *)&g_alloctimers);
+  dq_rem((FAR dq_entry_t *)timer, (FAR dq_queue_t *)&g_alloctimers);
 
   /* Return it to the free list if it is one of the preallocated timers */
 
@@ -134,11 +134,17 @@ int timer_release(FAR struct posix_timer_s *timer)
       return 1;
     }
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+  /* Disarm the timer and detach it from the timer wheel */
+
+  timer_wheel_detach(timer);
+#else
   /* Free the underlying watchdog instance (the timer will be canceled by the
    * watchdog logic before it is actually deleted)
    */
 
   (void)wd_delete(timer->pt_wdog);
+#endif
 
   /* Cancel any pending notification */
 
@@ -1,8 +1,8 @@
 /****************************************************************************
  * sched/timer/timer_settime.c
  *
- *   Copyright (C) 2007-2010, 2013-2016, 2018 Gregory Nutt. All rights
- *     reserved.
+ *   Copyright (C) 2007-2010, 2013-2016, 2018, 2020 Gregory Nutt.  All
+ *     rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -52,6 +52,7 @@
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 
+#ifndef CONFIG_POSIX_TIMER_WHEEL
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -196,6 +197,7 @@ static void timer_timeout(int argc, wdparm_t itimer)
     }
 #endif
 }
+#endif /* !CONFIG_POSIX_TIMER_WHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -286,7 +288,11 @@ int timer_settime(timer_t timerid, int flags,
     {
       /* Get the number of ticks before the underlying watchdog expires */
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+      delay = timer_wheel_gettime(timer);
+#else
       delay = wd_gettime(timer->pt_wdog);
+#endif
 
       /* Convert that to a struct timespec and return it */
 
@@ -298,7 +304,11 @@ int timer_settime(timer_t timerid, int flags,
    * is called).
    */
 
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+  timer_wheel_cancel(timer);
+#else
   (void)wd_cancel(timer->pt_wdog);
+#endif
 
   /* Cancel any pending notification */
 
@@ -371,8 +381,12 @@ int timer_settime(timer_t timerid, int flags,
        */
 
       timer->pt_last = delay;
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+      ret = timer_wheel_start(timer, delay);
+#else
       ret = wd_start(timer->pt_wdog, delay, (wdentry_t)timer_timeout,
                      1, (uint32_t)((wdparm_t)timer));
+#endif
       if (ret < 0)
         {
           set_errno(-ret);
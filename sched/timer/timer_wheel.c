@@ -0,0 +1,794 @@
+/****************************************************************************
+ * sched/timer/timer_wheel.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+#include "timer/timer.h"
+
+#ifdef CONFIG_POSIX_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TIMER_WHEEL_NSLOTS CONFIG_POSIX_TIMER_WHEEL_NSLOTS
+#define TIMER_WHEEL_MASK   (TIMER_WHEEL_NSLOTS - 1)
+
+#if (TIMER_WHEEL_NSLOTS & TIMER_WHEEL_MASK) != 0
+#  error CONFIG_POSIX_TIMER_WHEEL_NSLOTS must be a power of two
+#endif
+
+#ifdef CONFIG_SIG_EVTHREAD_HPWORK
+#  define SIG_EVTHREAD_WORK HPWORK
+#else
+#  define SIG_EVTHREAD_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The timer wheel of one process.  Armed timers are hashed into the slots
+ * by their expiration tick and each slot is ordered by expiration time, so
+ * timers that expire on the same tick are found together.  One watchdog
+ * is started for the earliest expiration.
+ */
+
+struct timer_wheel_s
+{
+  FAR struct timer_wheel_s *flink;      /* Supports a singly linked list */
+  FAR struct task_group_s *tw_group;    /* The process using the wheel */
+  WDOG_ID tw_wdog;                      /* The watchdog driving the wheel */
+  clock_t tw_last;                      /* The last tick processed */
+  clock_t tw_next;                      /* The tick the watchdog expires */
+  unsigned int tw_crefs;                /* Number of timers using the wheel */
+  unsigned int tw_narmed;               /* Number of armed timers */
+#ifdef CONFIG_SIG_EVTHREAD
+  bool tw_busy;                         /* The batch work is queued */
+  FAR struct posix_timer_s *tw_batch;   /* SIGEV_THREAD timers to notify */
+  FAR struct posix_timer_s *tw_btail;   /* The last timer of the batch */
+  struct work_s tw_work;                /* Runs the batch */
+#endif
+  FAR struct posix_timer_s *tw_slot[TIMER_WHEEL_NSLOTS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of all timer wheels, protected by a critical section.  A wheel
+ * is freed when its last timer is deleted.  The group pointer is only a
+ * key:  If a new process happens to re-use the address of a process that
+ * has exited, it simply shares its wheel.
+ */
+
+static FAR struct timer_wheel_s *g_timerwheels;
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void timer_wheel_expire(int argc, wdparm_t arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timer_wheel_insert
+ *
+ * Description:
+ *   Insert an armed timer into its slot, ordered by expiration time.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_insert(FAR struct timer_wheel_s *wheel,
+                               FAR struct posix_timer_s *timer)
+{
+  FAR struct posix_timer_s **slot;
+  FAR struct posix_timer_s *prev = NULL;
+  FAR struct posix_timer_s *next;
+
+  slot = &wheel->tw_slot[timer->pt_expiry & TIMER_WHEEL_MASK];
+  for (next = *slot;
+       next != NULL && (sclock_t)(next->pt_expiry - timer->pt_expiry) <= 0;
+       next = next->pt_wnext)
+    {
+      prev = next;
+    }
+
+  timer->pt_wprev = prev;
+  timer->pt_wnext = next;
+
+  if (next != NULL)
+    {
+      next->pt_wprev = timer;
+    }
+
+  if (prev != NULL)
+    {
+      prev->pt_wnext = timer;
+    }
+  else
+    {
+      *slot = timer;
+    }
+
+  timer->pt_flags |= PT_FLAGS_ARMED;
+  wheel->tw_narmed++;
+}
+
+/****************************************************************************
+ * Name: timer_wheel_unlink
+ *
+ * Description:
+ *   Remove an armed timer from its slot.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_unlink(FAR struct timer_wheel_s *wheel,
+                               FAR struct posix_timer_s *timer)
+{
+  if (timer->pt_wprev != NULL)
+    {
+      timer->pt_wprev->pt_wnext = timer->pt_wnext;
+    }
+  else
+    {
+      wheel->tw_slot[timer->pt_expiry & TIMER_WHEEL_MASK] = timer->pt_wnext;
+    }
+
+  if (timer->pt_wnext != NULL)
+    {
+      timer->pt_wnext->pt_wprev = timer->pt_wprev;
+    }
+
+  timer->pt_wnext  = NULL;
+  timer->pt_wprev  = NULL;
+  timer->pt_flags &= ~PT_FLAGS_ARMED;
+  wheel->tw_narmed--;
+}
+
+/****************************************************************************
+ * Name: timer_wheel_schedule
+ *
+ * Description:
+ *   Start the watchdog for the earliest expiration or cancel it if no
+ *   timer is armed.  The slots are visited in the order of their ticks in
+ *   the current rotation.  The first slot holding a timer that expires in
+ *   this rotation gives the earliest expiration; otherwise, it is the
+ *   earliest of the later rotations.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_schedule(FAR struct timer_wheel_s *wheel,
+                                 clock_t now)
+{
+  FAR struct posix_timer_s *timer;
+  clock_t next = 0;
+  bool found = false;
+  sclock_t delay;
+  int i;
+
+  if (wheel->tw_narmed == 0)
+    {
+      (void)wd_cancel(wheel->tw_wdog);
+      return;
+    }
+
+  for (i = 1; i <= TIMER_WHEEL_NSLOTS; i++)
+    {
+      timer = wheel->tw_slot[(now + i) & TIMER_WHEEL_MASK];
+      if (timer == NULL)
+        {
+          continue;
+        }
+
+      if ((sclock_t)(timer->pt_expiry - (now + i)) <= 0)
+        {
+          next  = timer->pt_expiry;
+          found = true;
+          break;
+        }
+
+      if (!found || (sclock_t)(timer->pt_expiry - next) < 0)
+        {
+          next  = timer->pt_expiry;
+          found = true;
+        }
+    }
+
+  DEBUGASSERT(found);
+
+  delay = (sclock_t)(next - now);
+  if (delay <= 0)
+    {
+      delay = 1;
+    }
+
+  wheel->tw_next = next;
+  (void)wd_start(wheel->tw_wdog, delay, (wdentry_t)timer_wheel_expire,
+                 1, (wdparm_t)wheel);
+}
+
+#ifdef CONFIG_SIG_EVTHREAD
+/****************************************************************************
+ * Name: timer_wheel_worker
+ *
+ * Description:
+ *   Call the notification functions of all SIGEV_THREAD timers that
+ *   expired since the work was queued.  This runs on the work queue used
+ *   for all SIGEV_THREAD notifications.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_worker(FAR void *arg)
+{
+  FAR struct timer_wheel_s *wheel = (FAR struct timer_wheel_s *)arg;
+  FAR struct posix_timer_s *timer;
+  sigev_notify_function_t func;
+  union sigval value;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      timer = wheel->tw_batch;
+      if (timer == NULL)
+        {
+          break;
+        }
+
+      wheel->tw_batch = timer->pt_bnext;
+      if (wheel->tw_batch == NULL)
+        {
+          wheel->tw_btail = NULL;
+        }
+
+      timer->pt_bnext  = NULL;
+      timer->pt_flags &= ~PT_FLAGS_BATCHED;
+
+      func = timer->pt_event.sigev_notify_function;
+      value.sival_ptr = timer->pt_event.sigev_value.sival_ptr;
+      leave_critical_section(flags);
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      func(value);
+#else
+      func(value.sival_ptr);
+#endif
+    }
+
+  /* The batch is empty.  If the last timer was deleted meanwhile, the
+   * wheel was left for us to free.
+   */
+
+  wheel->tw_busy = false;
+  if (wheel->tw_crefs == 0)
+    {
+      leave_critical_section(flags);
+      (void)wd_delete(wheel->tw_wdog);
+      sched_kfree(wheel);
+      return;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: timer_wheel_batch
+ *
+ * Description:
+ *   Add an expired SIGEV_THREAD timer to the batch of the wheel.  If the
+ *   timer is still in the batch from an earlier expiration, the two
+ *   expirations result in a single notification.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_batch(FAR struct timer_wheel_s *wheel,
+                              FAR struct posix_timer_s *timer)
+{
+  if ((timer->pt_flags & PT_FLAGS_BATCHED) != 0)
+    {
+      return;
+    }
+
+  timer->pt_flags |= PT_FLAGS_BATCHED;
+  timer->pt_bnext  = NULL;
+
+  if (wheel->tw_btail != NULL)
+    {
+      wheel->tw_btail->pt_bnext = timer;
+    }
+  else
+    {
+      wheel->tw_batch = timer;
+    }
+
+  wheel->tw_btail = timer;
+
+  if (!wheel->tw_busy)
+    {
+      wheel->tw_busy = true;
+      (void)work_queue(SIG_EVTHREAD_WORK, &wheel->tw_work,
+                       timer_wheel_worker, wheel, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: timer_wheel_unbatch
+ *
+ * Description:
+ *   Remove a timer from the batch of the wheel.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_unbatch(FAR struct timer_wheel_s *wheel,
+                                FAR struct posix_timer_s *timer)
+{
+  FAR struct posix_timer_s *prev = NULL;
+  FAR struct posix_timer_s *curr;
+
+  if ((timer->pt_flags & PT_FLAGS_BATCHED) == 0)
+    {
+      return;
+    }
+
+  for (curr = wheel->tw_batch; curr != timer; curr = curr->pt_bnext)
+    {
+      DEBUGASSERT(curr != NULL);
+      prev = curr;
+    }
+
+  if (prev != NULL)
+    {
+      prev->pt_bnext = timer->pt_bnext;
+    }
+  else
+    {
+      wheel->tw_batch = timer->pt_bnext;
+    }
+
+  if (wheel->tw_btail == timer)
+    {
+      wheel->tw_btail = prev;
+    }
+
+  timer->pt_bnext  = NULL;
+  timer->pt_flags &= ~PT_FLAGS_BATCHED;
+}
+#endif /* CONFIG_SIG_EVTHREAD */
+
+/****************************************************************************
+ * Name: timer_wheel_expire
+ *
+ * Description:
+ *   The watchdog handler of the wheel.  Collect the timers of all slots
+ *   passed since the last expiration, notify them and re-arm the periodic
+ *   ones.  Periodic timers are re-armed relative to their previous
+ *   expiration so that timers with the same period stay on the same tick.
+ *
+ * Assumptions:
+ *   This function executes in the context of the watchdog timer interrupt.
+ *
+ ****************************************************************************/
+
+static void timer_wheel_expire(int argc, wdparm_t arg)
+{
+  FAR struct timer_wheel_s *wheel = (FAR struct timer_wheel_s *)arg;
+  FAR struct posix_timer_s *expired = NULL;
+  FAR struct posix_timer_s *tail = NULL;
+  FAR struct posix_timer_s *timer;
+  FAR struct posix_timer_s *next;
+  clock_t now = clock_systimer();
+  clock_t nslots;
+  clock_t i;
+
+  /* Visit each slot passed since the last expiration, but each slot at
+   * most once.
+   */
+
+  nslots = now - wheel->tw_last;
+  if (nslots > TIMER_WHEEL_NSLOTS)
+    {
+      nslots = TIMER_WHEEL_NSLOTS;
+    }
+
+  for (i = 0; i < nslots; i++)
+    {
+      FAR struct posix_timer_s **slot =
+        &wheel->tw_slot[(now - i) & TIMER_WHEEL_MASK];
+
+      while ((timer = *slot) != NULL &&
+             (sclock_t)(timer->pt_expiry - now) <= 0)
+        {
+          timer_wheel_unlink(wheel, timer);
+
+          if (tail != NULL)
+            {
+              tail->pt_wnext = timer;
+            }
+          else
+            {
+              expired = timer;
+            }
+
+          tail = timer;
+        }
+    }
+
+  wheel->tw_last = now;
+
+  /* Notify the expired timers and re-arm the periodic ones */
+
+  for (timer = expired; timer != NULL; timer = next)
+    {
+      next = timer->pt_wnext;
+      timer->pt_wnext = NULL;
+
+#ifdef CONFIG_SIG_EVTHREAD
+      if (timer->pt_event.sigev_notify == SIGEV_THREAD)
+        {
+          timer_wheel_batch(wheel, timer);
+        }
+      else
+#endif
+        {
+          (void)nxsig_notification(timer->pt_owner, &timer->pt_event,
+                                   SI_TIMER, &timer->pt_work);
+        }
+
+      if (timer->pt_delay > 0)
+        {
+          clock_t missed = (now - timer->pt_expiry) / timer->pt_delay;
+
+          timer->pt_last    = timer->pt_delay;
+          timer->pt_expiry += (missed + 1) * timer->pt_delay;
+          timer_wheel_insert(wheel, timer);
+        }
+    }
+
+  timer_wheel_schedule(wheel, now);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timer_wheel_attach
+ *
+ * Description:
+ *   Attach a new timer to the timer wheel of the calling process, creating
+ *   the wheel if this is the first timer of the process.
+ *
+ * Input Parameters:
+ *   timer - The new timer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the wheel could not be created.
+ *
+ ****************************************************************************/
+
+int timer_wheel_attach(FAR struct posix_timer_s *timer)
+{
+  FAR struct task_group_s *group = this_task()->group;
+  FAR struct timer_wheel_s *wheel;
+  FAR struct timer_wheel_s *alloc = NULL;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      for (wheel = g_timerwheels; wheel != NULL; wheel = wheel->flink)
+        {
+          if (wheel->tw_group == group)
+            {
+              break;
+            }
+        }
+
+      if (wheel == NULL && alloc != NULL)
+        {
+          wheel         = alloc;
+          alloc         = NULL;
+          wheel->flink  = g_timerwheels;
+          g_timerwheels = wheel;
+        }
+
+      if (wheel != NULL)
+        {
+          wheel->tw_crefs++;
+          timer->pt_wheel = wheel;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      /* Create the wheel and look again.  Another thread of the process
+       * may have created one meanwhile.
+       */
+
+      alloc = (FAR struct timer_wheel_s *)
+        kmm_zalloc(sizeof(struct timer_wheel_s));
+      if (alloc == NULL)
+        {
+          return -EAGAIN;
+        }
+
+      alloc->tw_group = group;
+      alloc->tw_wdog  = wd_create();
+      if (alloc->tw_wdog == NULL)
+        {
+          kmm_free(alloc);
+          return -EAGAIN;
+        }
+    }
+
+  if (alloc != NULL)
+    {
+      (void)wd_delete(alloc->tw_wdog);
+      kmm_free(alloc);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timer_wheel_detach
+ *
+ * Description:
+ *   Disarm a timer that is being deleted and detach it from its wheel.
+ *   The wheel is freed with its last timer.
+ *
+ * Input Parameters:
+ *   timer - The timer being deleted
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void timer_wheel_detach(FAR struct posix_timer_s *timer)
+{
+  FAR struct timer_wheel_s *wheel = timer->pt_wheel;
+  FAR struct timer_wheel_s **link;
+  irqstate_t flags;
+
+  if (wheel == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  timer_wheel_cancel(timer);
+  timer->pt_wheel = NULL;
+
+  if (--wheel->tw_crefs > 0)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  for (link = &g_timerwheels; *link != wheel; link = &(*link)->flink)
+    {
+      DEBUGASSERT(*link != NULL);
+    }
+
+  *link = wheel->flink;
+
+#ifdef CONFIG_SIG_EVTHREAD
+  /* If the batch work is queued or running, it frees the wheel */
+
+  if (wheel->tw_busy)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+#endif
+
+  leave_critical_section(flags);
+
+  (void)wd_delete(wheel->tw_wdog);
+  sched_kfree(wheel);
+}
+
+/****************************************************************************
+ * Name: timer_wheel_start
+ *
+ * Description:
+ *   Arm a timer to expire after 'delay' ticks.
+ *
+ * Input Parameters:
+ *   timer - The timer to arm.  It must not be armed.
+ *   delay - The delay in ticks
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int timer_wheel_start(FAR struct posix_timer_s *timer, sclock_t delay)
+{
+  FAR struct timer_wheel_s *wheel = timer->pt_wheel;
+  irqstate_t flags;
+  clock_t now;
+
+  DEBUGASSERT(wheel != NULL && delay > 0);
+
+  flags = enter_critical_section();
+  DEBUGASSERT((timer->pt_flags & PT_FLAGS_ARMED) == 0);
+
+  now = clock_systimer();
+  if (wheel->tw_narmed == 0)
+    {
+      wheel->tw_last = now;
+    }
+
+  timer->pt_expiry = now + delay;
+  timer_wheel_insert(wheel, timer);
+
+  /* The watchdog only needs to be restarted if this is the earliest
+   * expiration.
+   */
+
+  if (wheel->tw_narmed == 1 ||
+      (sclock_t)(timer->pt_expiry - wheel->tw_next) < 0)
+    {
+      wheel->tw_next = timer->pt_expiry;
+      (void)wd_start(wheel->tw_wdog, delay, (wdentry_t)timer_wheel_expire,
+                     1, (wdparm_t)wheel);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timer_wheel_cancel
+ *
+ * Description:
+ *   Disarm a timer and cancel its pending SIGEV_THREAD notification.
+ *
+ * Input Parameters:
+ *   timer - The timer to disarm
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void timer_wheel_cancel(FAR struct posix_timer_s *timer)
+{
+  FAR struct timer_wheel_s *wheel = timer->pt_wheel;
+  irqstate_t flags;
+
+  if (wheel == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  if ((timer->pt_flags & PT_FLAGS_ARMED) != 0)
+    {
+      timer_wheel_unlink(wheel, timer);
+
+      /* The watchdog stays started for the cancelled expiration unless
+       * this was the last armed timer.  A spurious expiration just
+       * restarts it.
+       */
+
+      if (wheel->tw_narmed == 0)
+        {
+          (void)wd_cancel(wheel->tw_wdog);
+        }
+    }
+
+#ifdef CONFIG_SIG_EVTHREAD
+  timer_wheel_unbatch(wheel, timer);
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: timer_wheel_gettime
+ *
+ * Description:
+ *   Return the number of ticks before the timer expires, zero if it is
+ *   not armed.
+ *
+ * Input Parameters:
+ *   timer - The timer
+ *
+ * Returned Value:
+ *   The remaining ticks
+ *
+ ****************************************************************************/
+
+sclock_t timer_wheel_gettime(FAR struct posix_timer_s *timer)
+{
+  irqstate_t flags;
+  sclock_t delay = 0;
+
+  flags = enter_critical_section();
+  if ((timer->pt_flags & PT_FLAGS_ARMED) != 0)
+    {
+      delay = (sclock_t)(timer->pt_expiry - clock_systimer());
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+    }
+
+  leave_critical_section(flags);
+  return delay;
+}
+
+#endif /* CONFIG_POSIX_TIMER_WHEEL */
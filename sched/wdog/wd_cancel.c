@@ -73,8 +73,12 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  bool reassess;
+#else
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -90,6 +94,21 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Remove the watchdog from the timing wheel.  The interval timer
+       * needs to be reassessed only if this was the next watchdog to
+       * expire.
+       */
+
+      reassess = (wd_wheel_remaining(wdog) == wd_wheel_next());
+      wd_wheel_remove(wdog);
+
+      if (reassess)
+        {
+          sched_timer_reassess();
+        }
+
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -139,6 +158,7 @@ int wd_cancel(WDOG_ID wdog)
 
           sched_timer_reassess();
         }
+#endif
 
       /* Mark the watchdog inactive */
 
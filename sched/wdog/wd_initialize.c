@@ -41,31 +41,28 @@
 
 #include <queue.h>
 
+#include <nuttx/mm/mempool.h>
+
 #include "wdog/wdog.h"
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* The g_wdpool is the pool of watchdogs available to the system for
+ * delayed function use.
  */
 
-sq_queue_t g_wdfreelist;
+struct mempool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-uint16_t g_wdnfree;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -79,11 +76,11 @@ clock_t g_wdtickbase;
  * Private Data
  ****************************************************************************/
 
-/* g_wdpool is a list of pre-allocated watchdogs. The number of watchdogs
+/* g_wdblocks holds the pre-allocated watchdogs. The number of watchdogs
  * in the pool is a configuration item.
  */
 
-static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
+static struct wdog_s g_wdblocks[CONFIG_PREALLOC_WDOGS];
 
 /****************************************************************************
  * Public Functions
@@ -110,24 +107,18 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
-  FAR struct wdog_s *wdog = g_wdpool;
-  int i;
+#ifndef CONFIG_WDOG_TIMERWHEEL
+  /* Initialize the list of active watchdogs */
 
-  /* Initialize watchdog lists */
-
-  sq_init(&g_wdfreelist);
   sq_init(&g_wdactivelist);
+#endif
 
-  /* The g_wdfreelist must be loaded at initialization time to hold the
-   * configured number of watchdogs.
+  /* The pool is loaded with the configured number of watchdogs.  A few
+   * are reserved for interrupt handlers.  Task level allocations grow the
+   * pool from the kernel heap when the unreserved watchdogs are used up.
    */
 
-  for (i = 0; i < CONFIG_PREALLOC_WDOGS; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)wdog++, &g_wdfreelist);
-    }
-
-  /* All watchdogs are free */
-
-  g_wdnfree = CONFIG_PREALLOC_WDOGS;
+  (void)mempool_initialize(&g_wdpool, "wdog", g_wdblocks,
+                           sizeof(struct wdog_s), CONFIG_PREALLOC_WDOGS,
+                           CONFIG_WDOG_INTRESERVE, WDOG_NEXPAND);
 }
@@ -71,6 +71,51 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_execute
+ *
+ * Description:
+ *   Execute the function of an expired watchdog.
+ *
+ * Input Parameters:
+ *   wdog - The expired watchdog.  It has already been removed from the
+ *     active watchdogs.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_execute(FAR struct wdog_s *wdog)
+{
+  /* Indicate that the watchdog is no longer active. */
+
+  WDOG_CLRACTIVE(wdog);
+
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
+
+#if CONFIG_MAX_WDOGPARMS == 0
+  wdog->func(0);
+#elif CONFIG_MAX_WDOGPARMS == 1
+  wdog->func((int)wdog->argc,
+             wdog->parm[0]);
+#elif CONFIG_MAX_WDOGPARMS == 2
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1]);
+#elif CONFIG_MAX_WDOGPARMS == 3
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+#elif CONFIG_MAX_WDOGPARMS == 4
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2],
+             wdog->parm[3]);
+#else
+#  error Missing support
+#endif
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -86,6 +131,19 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+
+  /* Execute every watchdog that expires at the current time of the wheel */
+
+  while ((wdog = wd_wheel_expired()) != NULL)
+    {
+      wd_execute(wdog);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -114,35 +172,15 @@ static inline void wd_expiration(void)
               ((FAR struct wdog_s *)g_wdactivelist.head)->lag += wdog->lag;
             }
 
-          /* Indicate that the watchdog is no longer active. */
-
-          WDOG_CLRACTIVE(wdog);
-
-          /* Execute the watchdog function */
-
-          up_setpicbase(wdog->picbase);
+          /* Indicate that the watchdog is no longer active and execute the
+           * watchdog function.
+           */
 
-#if CONFIG_MAX_WDOGPARMS == 0
-          wdog->func(0);
-#elif CONFIG_MAX_WDOGPARMS == 1
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0]);
-#elif CONFIG_MAX_WDOGPARMS == 2
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1]);
-#elif CONFIG_MAX_WDOGPARMS == 3
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2]);
-#elif CONFIG_MAX_WDOGPARMS == 4
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2],
-                     wdog->parm[3]);
-#else
-#  error Missing support
-#endif
+          wd_execute(wdog);
         }
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -185,10 +223,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -253,6 +293,21 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Update clock tickbase if there are no other active watchdogs */
+
+  if (wd_wheel_next() == 0)
+    {
+      g_wdtickbase = clock_systimer();
+    }
+#endif
+
+  /* Add the watchdog to the timing wheel */
+
+  wd_wheel_insert(wdog, delay);
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -343,9 +398,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active. */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -389,12 +448,14 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *wdog;
+  int decr;
+#endif
 #ifdef CONFIG_SMP
   irqstate_t flags;
 #endif
   unsigned int ret;
-  int decr;
 
 #ifdef CONFIG_SMP
   /* We are in an interrupt handler as, as a consequence, interrupts are
@@ -409,6 +470,46 @@ unsigned int wd_timer(int ticks)
   flags = enter_critical_section();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Advance the wheel, stopping at each time that the wheel must be
+   * processed.
+   */
+
+  while (ticks > 0)
+    {
+      ret = wd_wheel_next();
+      if (ret == 0 || ret > (unsigned int)ticks)
+        {
+          break;
+        }
+
+      wd_wheel_advance(ret);
+      ticks        -= ret;
+      g_wdtickbase += ret;
+
+      /* Execute the watchdogs that expired at this time */
+
+      wd_expiration();
+    }
+
+  /* Advance over the remaining time where nothing happens */
+
+  if (ticks > 0)
+    {
+      wd_wheel_advance(ticks);
+    }
+
+  /* Update clock tickbase */
+
+  g_wdtickbase += ticks;
+
+  /* Return the delay for the next watchdog to expire.  This may instead be
+   * the time that the wheel must move watchdogs to its lower levels.
+   */
+
+  ret = wd_wheel_next();
+
+#else
   /* Check if there are any active watchdogs to process */
 
   while (g_wdactivelist.head != NULL && ticks > 0)
@@ -448,6 +549,7 @@ unsigned int wd_timer(int ticks)
 
   ret = g_wdactivelist.head ?
           ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
@@ -476,6 +578,13 @@ void wd_timer(void)
   flags = enter_critical_section();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Advance the wheel by one tick and execute any expired watchdogs */
+
+  wd_wheel_advance(1);
+  wd_expiration();
+
+#else
   /* Check if there are any active watchdogs to process */
 
   if (g_wdactivelist.head)
@@ -488,6 +597,7 @@ void wd_timer(void)
 
       wd_expiration();
     }
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
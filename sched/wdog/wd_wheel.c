@@ -0,0 +1,371 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel has seven levels of 32 slots.  Level 'n' holds the watchdogs
+ * that expire in 32^n up to 32^(n+1) ticks, so the seven levels cover the
+ * full range of the 32-bit tick counter.  The top level has only four
+ * usable slots.
+ */
+
+#define WHEEL_SHIFT         5
+#define WHEEL_NSLOTS        (1 << WHEEL_SHIFT)
+#define WHEEL_NLEVELS       7
+
+#define WHEEL_LSHIFT(l)     ((l) * WHEEL_SHIFT)
+#define WHEEL_LMASK(l) \
+  ((l) < WHEEL_NLEVELS - 1 ? WHEEL_NSLOTS - 1 : \
+   (1 << (32 - WHEEL_LSHIFT(WHEEL_NLEVELS - 1))) - 1)
+#define WHEEL_INDEX(t,l)    (((t) >> WHEEL_LSHIFT(l)) & WHEEL_LMASK(l))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slots of the wheel.  Each slot is the head of a doubly linked list of
+ * watchdogs.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_NLEVELS][WHEEL_NSLOTS];
+
+/* One bit for each non-empty slot of each level */
+
+static uint32_t g_wdoccupied[WHEEL_NLEVELS];
+
+/* The current time of the wheel in ticks */
+
+static uint32_t g_wdnow;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_slotdelay
+ *
+ * Description:
+ *   Return the number of ticks from the current time until a slot must be
+ *   processed.  For level zero, that is the expiration time of the
+ *   watchdogs in the slot.  For the higher levels, that is the time when
+ *   the watchdogs in the slot are moved to a lower level.
+ *
+ ****************************************************************************/
+
+static uint32_t wd_wheel_slotdelay(int level, int slot)
+{
+  uint32_t shift = WHEEL_LSHIFT(level);
+  uint32_t mask  = WHEEL_LMASK(level);
+  uint32_t cur   = WHEEL_INDEX(g_wdnow, level);
+  uint32_t low   = g_wdnow & ((1ul << shift) - 1);
+
+  /* The slot at the current index is one full rotation away */
+
+  return (((((uint32_t)slot - cur - 1) & mask) + 1) << shift) - low;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel.  The watchdog will expire after
+ *   'delay' more ticks.
+ *
+ * Input Parameters:
+ *   wdog  - The watchdog to add.  It must not be in the wheel.
+ *   delay - The delay in ticks, zero up to INT32_MAX.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, uint32_t delay)
+{
+  FAR struct wdog_s **slot;
+  int level;
+  int ndx;
+
+  /* Select the level of the wheel from the size of the delay */
+
+  for (level = 0;
+       level < WHEEL_NLEVELS - 1 &&
+       delay >= (1ul << WHEEL_LSHIFT(level + 1));
+       level++);
+
+  /* Then add the watchdog at the head of its slot */
+
+  wdog->expire = g_wdnow + delay;
+  ndx          = WHEEL_INDEX(wdog->expire, level);
+  slot         = &g_wdwheel[level][ndx];
+
+  wdog->prev   = NULL;
+  wdog->next   = *slot;
+  wdog->slot   = slot;
+
+  if (*slot != NULL)
+    {
+      (*slot)->prev = wdog;
+    }
+
+  *slot = wdog;
+  g_wdoccupied[level] |= (1ul << ndx);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.  It must be in the wheel.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **slot = wdog->slot;
+  int ndx;
+
+  DEBUGASSERT(slot != NULL);
+
+  if (wdog->prev != NULL)
+    {
+      wdog->prev->next = wdog->next;
+    }
+  else
+    {
+      *slot = wdog->next;
+      if (*slot == NULL)
+        {
+          /* The slot is now empty */
+
+          ndx = slot - &g_wdwheel[0][0];
+          g_wdoccupied[ndx >> WHEEL_SHIFT] &=
+            ~(1ul << (ndx & (WHEEL_NSLOTS - 1)));
+        }
+    }
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog->prev;
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+  wdog->slot = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks until a watchdog in the wheel expires.
+ *
+ ****************************************************************************/
+
+uint32_t wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return wdog->expire - g_wdnow;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the wheel must next be processed.
+ *   That is either the expiration of the next watchdog or the time when
+ *   the watchdogs of a higher level slot are moved to a lower level.  The
+ *   cost depends only on the number of levels.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The delay in ticks or zero if the wheel is empty.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+uint32_t wd_wheel_next(void)
+{
+  uint32_t delay;
+  uint32_t bits;
+  uint32_t cur;
+  uint32_t ret = 0;
+  int level;
+
+  for (level = 0; level < WHEEL_NLEVELS; level++)
+    {
+      bits = g_wdoccupied[level];
+      if (bits == 0)
+        {
+          continue;
+        }
+
+      /* Find the first occupied slot after the current one, wrapping
+       * around if there is none.
+       */
+
+      cur = WHEEL_INDEX(g_wdnow, level);
+      if ((bits & ~((2ul << cur) - 1)) != 0)
+        {
+          bits &= ~((2ul << cur) - 1);
+        }
+
+      delay = wd_wheel_slotdelay(level, ffs((int)bits) - 1);
+      if (ret == 0 || delay < ret)
+        {
+          ret = delay;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the time of the wheel.  When a slot boundary of a higher level
+ *   is reached, the watchdogs in that slot are moved to the lower levels.
+ *
+ * Input Parameters:
+ *   ticks - The number of ticks to advance.  This must not be greater than
+ *     the value returned by wd_wheel_next() if that is non-zero.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(uint32_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  int level;
+  int ndx;
+
+  g_wdnow += ticks;
+
+  for (level = 1; level < WHEEL_NLEVELS; level++)
+    {
+      /* Stop at the first level whose slot boundary was not reached */
+
+      if ((g_wdnow & ((1ul << WHEEL_LSHIFT(level)) - 1)) != 0)
+        {
+          break;
+        }
+
+      /* Move every watchdog from this slot to the lower levels */
+
+      ndx = WHEEL_INDEX(g_wdnow, level);
+      while ((wdog = g_wdwheel[level][ndx]) != NULL)
+        {
+          wd_wheel_remove(wdog);
+          wd_wheel_insert(wdog, wdog->expire - g_wdnow);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return one watchdog that expires at the current time of the
+ *   wheel.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if there are no more expired watchdogs.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+  FAR struct wdog_s *wdog;
+
+  wdog = g_wdwheel[0][WHEEL_INDEX(g_wdnow, 0)];
+  if (wdog != NULL)
+    {
+      DEBUGASSERT(wdog->expire == g_wdnow);
+      wd_wheel_remove(wdog);
+    }
+
+  return wdog;
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -48,11 +48,16 @@
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/mm/mempool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The number of watchdogs added to the pool each time that it grows */
+
+#define WDOG_NEXPAND 4
+
 /****************************************************************************
  * Name: wd_elapse
  *
@@ -82,25 +87,20 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* The g_wdpool is the pool of watchdogs available to the system for
+ * delayed function use.
  */
 
-extern sq_queue_t g_wdfreelist;
+extern struct mempool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-extern uint16_t g_wdnfree;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -188,6 +188,28 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_insert, wd_wheel_remove, wd_wheel_remaining, wd_wheel_next,
+ *       wd_wheel_advance, and wd_wheel_expired
+ *
+ * Description:
+ *   If CONFIG_WDOG_TIMERWHEEL is selected, the active watchdogs are held in
+ *   a hierarchical timing wheel instead of the g_wdactivelist.  Watchdogs
+ *   are added and removed in constant time.  These are the internal
+ *   interfaces of the wheel used by wd_start(), wd_cancel(), wd_gettime()
+ *   and wd_timer().  See wd_wheel.c.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog, uint32_t delay);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+uint32_t wd_wheel_remaining(FAR struct wdog_s *wdog);
+uint32_t wd_wheel_next(void);
+void wd_wheel_advance(uint32_t ticks);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
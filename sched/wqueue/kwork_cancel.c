@@ -139,6 +139,25 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
 
 int work_cancel(int qid, FAR struct work_s *work)
 {
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+  if (work_hpcpuqueue(qid) != NULL)
+    {
+      irqstate_t flags;
+      int ret;
+
+      /* Cancel per-CPU high priority work.  The work may be queued on the
+       * queue of any CPU.
+       */
+
+      DEBUGASSERT(work != NULL);
+
+      flags = enter_critical_section();
+      ret = work_qcancel(work_hpcpufind(work), work);
+      leave_critical_section(flags);
+      return ret;
+    }
+  else
+#endif
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
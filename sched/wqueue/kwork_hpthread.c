@@ -43,9 +43,11 @@
 #include <sched.h>
 #include <string.h>
 #include <errno.h>
+#include <assert.h>
 #include <queue.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
@@ -63,6 +65,12 @@
 
 struct hp_wqueue_s g_hpwork;
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues */
+
+struct kwork_wqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -159,6 +167,51 @@ static int work_hpthread(int argc, char *argv[])
   return OK; /* To keep some compilers happy */
 }
 
+/****************************************************************************
+ * Name: work_hpcputhread
+ *
+ * Description:
+ *   These are the worker threads that perform the actions placed on the
+ *   per-CPU, high priority work queues.  Each thread runs only on the CPU
+ *   of its queue.
+ *
+ * Input Parameters:
+ *   argc, argv (not used)
+ *
+ * Returned Value:
+ *   Does not return
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+static int work_hpcputhread(int argc, char *argv[])
+{
+  pid_t me = getpid();
+  int cpu;
+
+  /* Find out our CPU by searching the per-CPU queues */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_hpcpuwork[cpu].worker[0].pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(cpu < CONFIG_SMP_NCPUS);
+
+  /* Loop forever.  Garbage collection is left to the shared queue. */
+
+  for (; ; )
+    {
+      work_process(&g_hpcpuwork[cpu], 0);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -212,6 +265,39 @@ int work_hpstart(void)
       g_hpwork.worker[wndx].busy = true;
     }
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  /* Start one worker thread for each CPU and bind it to that CPU */
+
+  for (wndx = 0; wndx < CONFIG_SMP_NCPUS; wndx++)
+    {
+      cpu_set_t cpuset;
+      int ret;
+
+      pid = kthread_create(HPCPUWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           (main_t)work_hpcputhread,
+                           (FAR char * const *)NULL);
+
+      DEBUGASSERT(pid > 0);
+      if (pid < 0)
+        {
+          serr("ERROR: kthread_create CPU%d failed: %d\n", wndx, (int)pid);
+          sched_unlock();
+          return (int)pid;
+        }
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wndx, &cpuset);
+
+      ret = nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+
+      g_hpcpuwork[wndx].worker[0].pid  = pid;
+      g_hpcpuwork[wndx].worker[0].busy = true;
+    }
+#endif
+
   sched_unlock();
   return g_hpwork.worker[0].pid;
 }
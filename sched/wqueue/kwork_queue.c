@@ -162,8 +162,37 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+#endif
+
   /* Queue the new work */
 
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+  wqueue = work_hpcpuqueue(qid);
+  if (wqueue != NULL)
+    {
+      /* Queue per-CPU high priority work.  The work may still be pending
+       * on the queue of another CPU; remove it from that queue first.
+       */
+
+      DEBUGASSERT(work != NULL);
+
+      flags = enter_critical_section();
+      if (work->worker != NULL)
+        {
+          dq_rem((FAR dq_entry_t *)work, &work_hpcpufind(work)->q);
+          work->worker = NULL;
+        }
+
+      work_qqueue(wqueue, work, worker, arg, delay);
+      leave_critical_section(flags);
+
+      return work_signal(HPWORK_CPU(wqueue - g_hpcpuwork));
+    }
+  else
+#endif
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
@@ -77,6 +77,16 @@ int work_signal(int qid)
 
   /* Get the process ID of the worker thread */
 
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+  work = work_hpcpuqueue(qid);
+  if (work != NULL)
+    {
+      /* A per-CPU queue has a single worker thread */
+
+      threads = 1;
+    }
+  else
+#endif
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
@@ -46,7 +46,9 @@
 #include <stdbool.h>
 #include <queue.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -57,6 +59,7 @@
 /* Kernel thread names */
 
 #define HPWORKNAME "hpwork"
+#define HPCPUWORKNAME "hpwork_cpu"
 #define LPWORKNAME "lpwork"
 
 /****************************************************************************
@@ -119,6 +122,14 @@ struct lp_wqueue_s
 extern struct hp_wqueue_s g_hpwork;
 #endif
 
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+/* The state of the per-CPU, high priority work queues.  Each has a single
+ * worker thread that runs only on that CPU.
+ */
+
+extern struct kwork_wqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SCHED_LPWORK
 /* The state of the kernel mode, low priority work queue(s). */
 
@@ -199,5 +210,76 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx);
 void work_notifier_initialize(void);
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+/****************************************************************************
+ * Name: work_hpcpuqueue
+ *
+ * Description:
+ *   Map a work queue ID to one of the per-CPU, high priority work queues.
+ *
+ * Input Parameters:
+ *   qid - The work queue ID
+ *
+ * Returned Value:
+ *   The per-CPU work queue; NULL if qid does not identify a per-CPU queue.
+ *
+ ****************************************************************************/
+
+static inline FAR struct kwork_wqueue_s *work_hpcpuqueue(int qid)
+{
+  if (qid == HPWORK_THISCPU)
+    {
+      return &g_hpcpuwork[up_cpu_index()];
+    }
+  else if (qid >= HPWORK_CPU(0) && qid < HPWORK_CPU(CONFIG_SMP_NCPUS))
+    {
+      return &g_hpcpuwork[qid - HPWORK_CPU(0)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: work_hpcpufind
+ *
+ * Description:
+ *   Return the per-CPU work queue that holds the queued work.  dq_rem()
+ *   modifies the queue itself only when the work is at the head or the
+ *   tail, so the work need only be compared with the ends of each queue.
+ *   Any queue may be returned for work in the middle of a queue.
+ *
+ * Input Parameters:
+ *   work - The queued work (work->worker != NULL)
+ *
+ * Returned Value:
+ *   The work queue to pass to dq_rem()
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static inline FAR struct kwork_wqueue_s *
+work_hpcpufind(FAR struct work_s *work)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_hpcpuwork[cpu].q.head == (FAR dq_entry_t *)work ||
+          g_hpcpuwork[cpu].q.tail == (FAR dq_entry_t *)work)
+        {
+          return &g_hpcpuwork[cpu];
+        }
+    }
+
+  return &g_hpcpuwork[0];
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
 #endif /* __SCHED_WQUEUE_WQUEUE_H */
@@ -0,0 +1,177 @@
+/****************************************************************************
+ * syscall/syscall_fastpath.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <syscall.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL_FASTPATH) && defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_fastyield
+ *
+ * Description:
+ *   sched_yield() only has an effect if another ready-to-run task has the
+ *   same priority as the running task.  Return true if there is no such
+ *   task and the call can be completed without a context switch.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_SMP
+static bool syscall_fastyield(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *nxttcb;
+  irqstate_t flags;
+  bool noop;
+
+  flags  = enter_critical_section();
+  rtcb   = sched_self();
+  nxttcb = (FAR struct tcb_s *)rtcb->flink;
+  noop   = (nxttcb != NULL && nxttcb->sched_priority < rtcb->sched_priority);
+  leave_critical_section(flags);
+
+  return noop;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_fastpath
+ *
+ * Description:
+ *   Complete a simple, non-blocking system call directly in the system call
+ *   exception handler.  This avoids the return to dispatch_syscall() in
+ *   privileged thread mode and the second trap that returns from the system
+ *   call.
+ *
+ *   Only calls that can never block and never cause a context switch are
+ *   handled here:  The handler stores the returned value in the register
+ *   context of the caller after this function returns.
+ *
+ * Input Parameters:
+ *   nbr    - The system call number (SYS_xxx) as received in R0
+ *   parm1  - The first system call parameter
+ *   parm2  - The second system call parameter
+ *   result - The location to return the value of the system call
+ *
+ * Returned Value:
+ *   True is returned if the system call was completed and 'result' is
+ *   valid.  False is returned if the system call must be dispatched in the
+ *   normal way.
+ *
+ * Assumptions:
+ *   Called from the system call exception handler of the calling task.
+ *
+ ****************************************************************************/
+
+bool syscall_fastpath(uintptr_t nbr, uintptr_t parm1, uintptr_t parm2,
+                      FAR uintptr_t *result)
+{
+#ifdef CONFIG_LIB_SYSCALL_STATS
+  uint32_t start = up_critmon_gettime();
+#endif
+
+  switch (nbr)
+    {
+      case SYS_getpid:
+        *result = (uintptr_t)getpid();
+        break;
+
+      case SYS_get_errno:
+        *result = (uintptr_t)get_errno();
+        break;
+
+#ifndef CONFIG_CLOCK_TIMEPAGE
+      case SYS_clock_gettime:
+        *result = (uintptr_t)clock_gettime((clockid_t)parm1,
+                                           (FAR struct timespec *)parm2);
+        break;
+#endif
+
+      case SYS_sem_trywait:
+        *result = (uintptr_t)sem_trywait((FAR sem_t *)parm1);
+        break;
+
+#ifndef CONFIG_SMP
+      case SYS_sched_yield:
+        if (!syscall_fastyield())
+          {
+            return false;
+          }
+
+        *result = OK;
+        break;
+#endif
+
+      default:
+        return false;
+    }
+
+#ifdef CONFIG_LIB_SYSCALL_STATS
+  syscall_stats_record(nbr - CONFIG_SYS_RESERVED,
+                       up_critmon_gettime() - start);
+#endif
+
+  return true;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_FASTPATH && __KERNEL__ */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * syscall/syscall_lookup.h
  *
- *   Copyright (C) 2011, 2013-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011, 2013-2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -176,7 +176,11 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
 
   SYSCALL_LOOKUP(syscall_clock,            0, STUB_clock)
   SYSCALL_LOOKUP(clock_getres,             2, STUB_clock_getres)
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  SYSCALL_LOOKUP(clock_timepage,           0, STUB_clock_timepage)
+#else
   SYSCALL_LOOKUP(clock_gettime,            2, STUB_clock_gettime)
+#endif
   SYSCALL_LOOKUP(clock_settime,            2, STUB_clock_settime)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2, STUB_adjtime)
@@ -217,6 +221,9 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(aio_write,                1, STUB_aio_write)
   SYSCALL_LOOKUP(aio_fsync,                2, STUB_aio_fsync)
   SYSCALL_LOOKUP(aio_cancel,               2, STUB_aio_cancel)
+#endif
+#ifdef CONFIG_FS_IORING
+  SYSCALL_LOOKUP(ioring_enter,             2, STUB_ioring_enter)
 #endif
   SYSCALL_LOOKUP(poll,                     3, STUB_poll)
   SYSCALL_LOOKUP(select,                   5, STUB_select)
@@ -254,8 +261,9 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(statfs,                   2, STUB_statfs)
   SYSCALL_LOOKUP(fstatfs,                  2, STUB_fstatfs)
   SYSCALL_LOOKUP(telldir,                  1, STUB_telldir)
+  SYSCALL_LOOKUP(getdents,                 3, STUB_getdents)
 
-#if defined(CONFIG_FS_RAMMAP)
+#if defined(CONFIG_FS_RAMMAP) || defined(CONFIG_FS_FILEMAP)
   SYSCALL_LOOKUP(munmap,                   2, STUB_munmap)
 #endif
 
@@ -272,6 +280,12 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(mkfifo2,                  3, STUB_mkfifo2)
 #endif
 
+#if defined(CONFIG_PIPES)
+  SYSCALL_LOOKUP(splice,                   6, STUB_splice)
+  SYSCALL_LOOKUP(tee,                      4, STUB_tee)
+  SYSCALL_LOOKUP(vmsplice,                 4, STUB_vmsplice)
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0
   SYSCALL_LOOKUP(fdopen,                   3, STUB_fs_fdopen)
   SYSCALL_LOOKUP(sched_getstreams,         0, STUB_sched_getstreams)
@@ -391,6 +405,8 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(sendto,                   6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,               5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                   3, STUB_socket)
+  SYSCALL_LOOKUP(recvmmsg,                 5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(sendmmsg,                 4, STUB_sendmmsg)
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -406,6 +422,12 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(getrandom,               2, STUB_getrandom)
 #endif
 
+/* The following is defined only if vectored system calls are enabled */
+
+#ifdef CONFIG_LIB_SYSCALL_MULTICALL
+  SYSCALL_LOOKUP(multicall,                2, STUB_multicall)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * syscall/syscall_multicall.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+#include <syscall.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL_MULTICALL) && defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The stubs are called with all six parameters, just as the system call
+ * dispatch logic does.  Stubs with fewer parameters ignore the rest.
+ */
+
+typedef uintptr_t (*syscall_stub_t)(int nbr, uintptr_t parm1,
+                                    uintptr_t parm2, uintptr_t parm3,
+                                    uintptr_t parm4, uintptr_t parm5,
+                                    uintptr_t parm6);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: multicall
+ *
+ * Description:
+ *   Perform a list of system calls with a single trap into the kernel.  The
+ *   calls are performed in order.  The value returned by each call is saved
+ *   in the 'result' field of its entry.  The list stops after the first
+ *   call that fails, i.e., that returns -1 (ERROR or MAP_FAILED), so that
+ *   errno still holds the error of that call.
+ *
+ *   An entry with an invalid system call number, or a nested multicall(),
+ *   is not performed.  Its result is set to ERROR and errno is set to
+ *   ENOSYS.
+ *
+ * Input Parameters:
+ *   calls  - The list of system calls
+ *   ncalls - The number of entries in the list
+ *
+ * Returned Value:
+ *   The number of entries that were processed, including the one that
+ *   stopped the list, is returned on success.  -1 (ERROR) is returned and
+ *   errno is set to EINVAL if the list is invalid.
+ *
+ ****************************************************************************/
+
+int multicall(FAR struct multicall_s *calls, int ncalls)
+{
+  FAR struct multicall_s *call;
+  syscall_stub_t stub;
+  uintptr_t nbr;
+  int i;
+
+  if (calls == NULL || ncalls < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      call = &calls[i];
+      nbr  = call->nbr;
+
+      if (nbr < CONFIG_SYS_RESERVED || nbr >= SYS_maxsyscall ||
+          nbr == SYS_multicall)
+        {
+          call->result = (uintptr_t)ERROR;
+          set_errno(ENOSYS);
+          return i + 1;
+        }
+
+      nbr         -= CONFIG_SYS_RESERVED;
+      stub         = (syscall_stub_t)g_stublookup[nbr];
+      call->result = stub((int)nbr, call->parm[0], call->parm[1],
+                          call->parm[2], call->parm[3], call->parm[4],
+                          call->parm[5]);
+
+      if (call->result == (uintptr_t)ERROR)
+        {
+          return i + 1;
+        }
+    }
+
+  return ncalls;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_MULTICALL && __KERNEL__ */
@@ -0,0 +1,275 @@
+/****************************************************************************
+ * syscall/syscall_stats.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <syscall.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL_STATS) && defined(__KERNEL__)
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CONFIG_LIB_SYSCALL_STATS requires 64-bit integer support
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Accumulated times are converted to nanoseconds in chunks of this many
+ * time units.  up_critmon_convert() only accepts a 32-bit elapsed time.
+ */
+
+#define STATS_CHUNK_SHIFT   31
+#define STATS_CHUNK         ((uint32_t)1 << STATS_CHUNK_SHIFT)
+#define STATS_CHUNK_MASK    (STATS_CHUNK - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The real stubs are called with all six parameters, just as the system
+ * call dispatch logic does.  Stubs with fewer parameters ignore the rest.
+ */
+
+typedef uintptr_t (*syscall_stub_t)(int nbr, uintptr_t parm1,
+                                    uintptr_t parm2, uintptr_t parm3,
+                                    uintptr_t parm4, uintptr_t parm5,
+                                    uintptr_t parm6);
+
+/* The statistics of one system call.  Times are in the units of
+ * up_critmon_gettime().
+ */
+
+struct syscall_counter_s
+{
+  uint32_t count;          /* The number of calls that returned */
+  uint32_t max;            /* The longest time of one call */
+  uint64_t total;          /* The accumulated time of all calls */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uintptr_t syscall_stats_stub(int nbr, uintptr_t parm1,
+                                    uintptr_t parm2, uintptr_t parm3,
+                                    uintptr_t parm4, uintptr_t parm5,
+                                    uintptr_t parm6);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The names of the system calls, indexed by the system call number */
+
+static FAR const char * const g_stubnames[SYS_nsyscalls] =
+{
+#  undef SYSCALL_LOOKUP1
+#  define SYSCALL_LOOKUP1(f,n,p) #f
+#  undef SYSCALL_LOOKUP
+#  define SYSCALL_LOOKUP(f,n,p)  , #f
+#  include "syscall_lookup.h"
+};
+
+static struct syscall_counter_s g_syscall_counters[SYS_nsyscalls];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* All system calls are dispatched to syscall_stats_stub() which times the
+ * call of the real stub in g_stubtarget[].
+ */
+
+const uintptr_t g_stublookup[SYS_nsyscalls] =
+{
+#  undef SYSCALL_LOOKUP1
+#  define SYSCALL_LOOKUP1(f,n,p) (uintptr_t)syscall_stats_stub
+#  undef SYSCALL_LOOKUP
+#  define SYSCALL_LOOKUP(f,n,p)  , (uintptr_t)syscall_stats_stub
+#  include "syscall_lookup.h"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_stats_stub
+ *
+ * Description:
+ *   Call the real stub of the system call and record the elapsed time.
+ *   The time includes any time that the caller was blocked.  Calls that
+ *   never return, like exit(), are not counted.
+ *
+ ****************************************************************************/
+
+static uintptr_t syscall_stats_stub(int nbr, uintptr_t parm1,
+                                    uintptr_t parm2, uintptr_t parm3,
+                                    uintptr_t parm4, uintptr_t parm5,
+                                    uintptr_t parm6)
+{
+  syscall_stub_t stub = (syscall_stub_t)g_stubtarget[nbr];
+  uint32_t start = up_critmon_gettime();
+  uintptr_t ret;
+
+  ret = stub(nbr, parm1, parm2, parm3, parm4, parm5, parm6);
+  syscall_stats_record(nbr, up_critmon_gettime() - start);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syscall_stats_convert
+ *
+ * Description:
+ *   Convert an accumulated time in the units of up_critmon_gettime() to
+ *   nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t syscall_stats_convert(uint64_t elapsed)
+{
+  struct timespec ts;
+  uint64_t nsec;
+
+  up_critmon_convert((uint32_t)(elapsed & STATS_CHUNK_MASK), &ts);
+  nsec = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+  elapsed >>= STATS_CHUNK_SHIFT;
+  if (elapsed > 0)
+    {
+      up_critmon_convert(STATS_CHUNK, &ts);
+      nsec += elapsed * ((uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+    }
+
+  return nsec;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_stats_record
+ *
+ * Description:
+ *   Count one completed system call and its elapsed time.
+ *
+ * Input Parameters:
+ *   index   - The system call number less CONFIG_SYS_RESERVED
+ *   elapsed - The elapsed time in the units of up_critmon_gettime()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void syscall_stats_record(int index, uint32_t elapsed)
+{
+  FAR struct syscall_counter_s *counter;
+  irqstate_t flags;
+
+  DEBUGASSERT((unsigned int)index < SYS_nsyscalls);
+  counter = &g_syscall_counters[index];
+
+  flags = enter_critical_section();
+  counter->count++;
+  counter->total += elapsed;
+  if (elapsed > counter->max)
+    {
+      counter->max = elapsed;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: syscall_stats
+ *
+ * Description:
+ *   Return the statistics of one system call.
+ *
+ * Input Parameters:
+ *   index - The system call number less CONFIG_SYS_RESERVED
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'index' is
+ *   not a valid system call number.
+ *
+ ****************************************************************************/
+
+int syscall_stats(int index, FAR struct syscall_stats_s *stats)
+{
+  struct syscall_counter_s counter;
+  struct timespec ts;
+  irqstate_t flags;
+
+  if ((unsigned int)index >= SYS_nsyscalls || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags   = enter_critical_section();
+  counter = g_syscall_counters[index];
+  leave_critical_section(flags);
+
+  up_critmon_convert(counter.max, &ts);
+
+  stats->name  = g_stubnames[index];
+  stats->count = counter.count;
+  stats->total = syscall_stats_convert(counter.total);
+  stats->max   = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+  return OK;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_STATS && __KERNEL__ */
@@ -1,7 +1,7 @@
 /****************************************************************************
  * syscall/syscall_stublookup.c
  *
- *   Copyright (C) 2011-2013, 2015-2019 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2011-2013, 2015-2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -173,6 +173,7 @@ uintptr_t STUB_clock(int nbr);
 uintptr_t STUB_clock_getres(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_clock_gettime(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_clock_settime(int nbr, uintptr_t parm1, uintptr_t parm2);
+uintptr_t STUB_clock_timepage(int nbr);
 uintptr_t STUB_adjtime(int nbr, uintptr_t parm1, uintptr_t parm2);
 
 /* The following are defined only if POSIX timers are supported */
@@ -229,6 +230,7 @@ uintptr_t STUB_aio_read(int nbr, uintptr_t parm1);
 uintptr_t STUB_aio_write(int nbr, uintptr_t parm1);
 uintptr_t STUB_aio_fsync(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_aio_cancel(int nbr, uintptr_t parm1, uintptr_t parm2);
+uintptr_t STUB_ioring_enter(int nbr, uintptr_t parm1, uintptr_t parm2);
 
 /* Network interface indices */
 
@@ -269,6 +271,8 @@ uintptr_t STUB_fstat(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_statfs(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_fstatfs(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_telldir(int nbr, uintptr_t parm1);
+uintptr_t STUB_getdents(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
 
 uintptr_t STUB_link(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_readlink(int nbr, uintptr_t parm1, uintptr_t parm2,
@@ -277,6 +281,13 @@ uintptr_t STUB_readlink(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_pipe2(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_mkfifo2(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+            uintptr_t parm6);
+uintptr_t STUB_tee(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_vmsplice(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 
 uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
@@ -415,6 +426,10 @@ uintptr_t STUB_setsockopt(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
+uintptr_t STUB_recvmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
+uintptr_t STUB_sendmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
@@ -426,6 +441,10 @@ uintptr_t STUB_prctl(int nbr, uintptr_t parm1, uintptr_t parm2,
 
 uintptr_t STUB_getrandom(int nbr, uintptr_t parm1, uintptr_t parm2);
 
+/* The following is defined only if vectored system calls are enabled */
+
+uintptr_t STUB_multicall(int nbr, uintptr_t parm1, uintptr_t parm2);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -433,9 +452,17 @@ uintptr_t STUB_getrandom(int nbr, uintptr_t parm1, uintptr_t parm2);
 /* Stub lookup tables.  This table is indexed by the system call number.
  * Given the system call number, the corresponding entry in this table
  * provides the address of the stub function.
+ *
+ * If system call statistics are enabled, g_stublookup[] is provided by
+ * syscall_stats.c.  It dispatches all system calls to a single stub that
+ * then calls the real stubs in this table.
  */
 
+#ifdef CONFIG_LIB_SYSCALL_STATS
+const uintptr_t g_stubtarget[SYS_nsyscalls] =
+#else
 const uintptr_t g_stublookup[SYS_nsyscalls] =
+#endif
 {
 #  undef SYSCALL_LOOKUP1
 #  define SYSCALL_LOOKUP1(f,n,p) (uintptr_t)p
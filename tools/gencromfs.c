@@ -1,7 +1,7 @@
 /****************************************************************************
  * tools/gencromfs.c
  *
- *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * The function lzf_compress() comes from the file lzf_c.c (wich substantial
@@ -10,7 +10,8 @@
  *   Copyright (c) 2000-2010 Marc Alexander Lehmann <schmorp@schmorp.de>
  *
  * Which has a compatible BSD license and included here under the NuttX BSD
- * license:
+ * license.  The function lz4_compress() is a simple, greedy implementation
+ * of the LZ4 block format.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions
@@ -133,6 +134,18 @@
 #define LZF_MAX_OFF        (1 << LZF_HLOG)
 #define LZF_MAX_REF        ((1 << 8) + (1 << 3))
 
+#define CROMFS_LZ4_HDR     2          /* LZ4 block, LZF_TYPE1_HDR layout */
+
+#define LZ4_HLOG           12
+#define LZ4_HSIZE          (1 << LZ4_HLOG)
+#define LZ4_MINMATCH       4
+#define LZ4_LASTLITERALS   5
+#define LZ4_MFLIMIT        12
+
+#define LZ4_GET32(p)       ((uint32_t)(p)[0] | (uint32_t)(p)[1] << 8 | \
+                            (uint32_t)(p)[2] << 16 | (uint32_t)(p)[3] << 24)
+#define LZ4_NDX(v)         (((uint32_t)(v) * 2654435761u) >> (32 - LZ4_HLOG))
+
 #define HEX_PER_BREAK      8
 #define HEX_PER_LINE       16
 
@@ -230,6 +243,10 @@ union lzf_result_u
 
 static uint8_t *g_lzf_hashtab[LZF_HSIZE];
 
+/* LZ4 hash table (offsets into the input chunk) */
+
+static uint16_t g_lz4_hashtab[LZ4_HSIZE];
+
 /* Type of the callback from traverse_directory() */
 
 typedef int (*traversal_callback_t)(const char *dirpath, const char *name,
@@ -242,6 +259,7 @@ typedef int (*traversal_callback_t)(const char *dirpath, const char *name,
 static char *g_progname;       /* Name of this program */
 static char *g_dirname;        /* Source directory path */
 static char *g_outname;        /* Output file path */
+static bool g_lz4;             /* Compress with LZ4 instead of LZF */
 
 static FILE *g_outstream;      /* Main output stream */
 static FILE *g_tmpstream;      /* Temporary file output stream */
@@ -276,8 +294,13 @@ static void unlink_tmpfiles(void);
 static void append_tmpfile(FILE *dest, FILE *src);
 static void dump_hexbuffer(FILE *stream, const void *buffer, unsigned int nbytes);
 static void dump_nextline(FILE *stream);
+static size_t gen_blkhdr(const uint8_t *inbuffer, unsigned int inlen,
+                         size_t cs, uint8_t type, union lzf_result_u *result);
 static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
                            union lzf_result_u *result);
+static uint8_t *lz4_putlen(uint8_t *outptr, unsigned int len);
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result);
 static uint16_t get_mode(mode_t mode);
 #ifdef HOST_TGTSWAP
 static inline uint16_t tgt_uint16(uint16_t a);
@@ -306,7 +329,8 @@ static int  traverse_directory(const char *dirpath,
 
 static void show_usage(void)
 {
-  fprintf(stderr, "USAGE: %s <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "USAGE: %s [-lz4] <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "  -lz4: Compress with LZ4 (needs CONFIG_FS_CROMFS_LZ4)\n");
   exit(1);
 }
 
@@ -438,6 +462,13 @@ static void init_outfile(void)
   fprintf(g_outstream, "#include <nuttx/config.h>\n\n");
   fprintf(g_outstream, "#include <stdint.h>\n\n");
 
+  if (g_lz4)
+    {
+      fprintf(g_outstream, "#ifndef CONFIG_FS_CROMFS_LZ4\n");
+      fprintf(g_outstream, "#  error This image needs CONFIG_FS_CROMFS_LZ4\n");
+      fprintf(g_outstream, "#endif\n\n");
+    }
+
   fprintf(g_outstream, "/%s\n", g_delim);
   fprintf(g_outstream, " * Private Data\n");
   fprintf(g_outstream, " %s/\n\n", g_delim);
@@ -556,6 +587,43 @@ static void dump_nextline(FILE *stream)
     }
 }
 
+static size_t gen_blkhdr(const uint8_t *inbuffer, unsigned int inlen,
+                         size_t cs, uint8_t type, union lzf_result_u *result)
+{
+  size_t retlen;
+
+  if (cs > 0)
+    {
+      /* Write compressed header */
+
+      result->compressed.lzf_magic[0]   = 'Z';
+      result->compressed.lzf_magic[1]   = 'V';
+      result->compressed.lzf_type       = type;
+      result->compressed.lzf_clen[0]    = cs >> 8;
+      result->compressed.lzf_clen[1]    = cs & 0xff;
+      result->compressed.lzf_ulen[0]    = inlen >> 8;
+      result->compressed.lzf_ulen[1]    = inlen & 0xff;
+      retlen                            = cs + LZF_TYPE1_HDR_SIZE;
+    }
+  else
+    {
+      /* Write uncompressed header*/
+
+      result->uncompressed.lzf_magic[0] = 'Z';
+      result->uncompressed.lzf_magic[1] = 'V';
+      result->uncompressed.lzf_type     = LZF_TYPE0_HDR;
+      result->uncompressed.lzf_len[0]   = inlen >> 8;
+      result->uncompressed.lzf_len[1]   = inlen & 0xff;
+
+      /* Copy uncompressed data into the result buffer */
+
+      memcpy(result->uncompressed.lzf_buffer, inbuffer, inlen);
+      retlen                            = inlen + LZF_TYPE0_HDR_SIZE;
+    }
+
+  return retlen;
+}
+
 static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
                            union lzf_result_u *result)
 {
@@ -566,7 +634,6 @@ static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
   const uint8_t *ref;
   uintptr_t off;
   ssize_t cs;
-  ssize_t retlen;
   unsigned int hval;
   int lit;
 
@@ -810,36 +877,117 @@ static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
   cs = outptr - (uint8_t *)result->compressed.lzf_buffer;
 
 genhdr:
-  if (cs > 0)
-    {
-      /* Write compressed header */
+  return gen_blkhdr(inbuffer, inlen, cs, LZF_TYPE1_HDR, result);
+}
 
-      result->compressed.lzf_magic[0]   = 'Z';
-      result->compressed.lzf_magic[1]   = 'V';
-      result->compressed.lzf_type       = LZF_TYPE1_HDR;
-      result->compressed.lzf_clen[0]    = cs >> 8;
-      result->compressed.lzf_clen[1]    = cs & 0xff;
-      result->compressed.lzf_ulen[0]    = inlen >> 8;
-      result->compressed.lzf_ulen[1]    = inlen & 0xff;
-      retlen                            = cs + LZF_TYPE1_HDR_SIZE;
+static uint8_t *lz4_putlen(uint8_t *outptr, unsigned int len)
+{
+  while (len >= 255)
+    {
+      *outptr++ = 255;
+      len      -= 255;
     }
-  else
+
+  *outptr++ = len;
+  return outptr;
+}
+
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result)
+{
+  const uint8_t *inptr  = inbuffer;
+  const uint8_t *anchor = inbuffer;
+  const uint8_t *inend  = inbuffer + inlen;
+        uint8_t *outptr = result->compressed.lzf_buffer;
+        uint8_t *outend = outptr + (inlen > 0 ? inlen - 1 : 0);
+        uint8_t *token;
+  unsigned int lit;
+
+  /* The block is only worth compressing if it gets smaller */
+
+  memset(g_lz4_hashtab, 0, sizeof(g_lz4_hashtab));
+
+  if (inlen > LZ4_MFLIMIT)
     {
-      /* Write uncompressed header*/
+      const uint8_t *mflimit    = inend - LZ4_MFLIMIT;
+      const uint8_t *matchlimit = inend - LZ4_LASTLITERALS;
 
-      result->uncompressed.lzf_magic[0] = 'Z';
-      result->uncompressed.lzf_magic[1] = 'V';
-      result->uncompressed.lzf_type     = LZF_TYPE0_HDR;
-      result->uncompressed.lzf_len[0]   = inlen >> 8;
-      result->uncompressed.lzf_len[1]   = inlen & 0xff;
+      while (inptr < mflimit)
+        {
+          uint32_t seq = LZ4_GET32(inptr);
+          uint16_t *hslot = &g_lz4_hashtab[LZ4_NDX(seq)];
+          const uint8_t *ref = inbuffer + *hslot;
+          const uint8_t *mptr;
+          unsigned int mlen;
 
-      /* Copy uncompressed data into the result buffer */
+          *hslot = inptr - inbuffer;
 
-      memcpy(result->uncompressed.lzf_buffer, inbuffer, inlen);
-      retlen                            = inlen + LZF_TYPE0_HDR_SIZE;
+          if (ref >= inptr || LZ4_GET32(ref) != seq)
+            {
+              inptr++;
+              continue;
+            }
+
+          mptr = inptr + LZ4_MINMATCH;
+          while (mptr < matchlimit && *mptr == ref[mptr - inptr])
+            {
+              mptr++;
+            }
+
+          lit  = inptr - anchor;
+          mlen = mptr - inptr - LZ4_MINMATCH;
+
+          if (outend - outptr < 1 + (lit + 240) / 255 + lit + 2 +
+                                (mlen + 240) / 255)
+            {
+              return gen_blkhdr(inbuffer, inlen, 0, 0, result);
+            }
+
+          token = outptr++;
+          *token = (lit >= 15 ? 15 : lit) << 4 | (mlen >= 15 ? 15 : mlen);
+
+          if (lit >= 15)
+            {
+              outptr = lz4_putlen(outptr, lit - 15);
+            }
+
+          memcpy(outptr, anchor, lit);
+          outptr   += lit;
+          *outptr++ = (inptr - ref) & 0xff;
+          *outptr++ = (inptr - ref) >> 8;
+
+          if (mlen >= 15)
+            {
+              outptr = lz4_putlen(outptr, mlen - 15);
+            }
+
+          inptr  = mptr;
+          anchor = inptr;
+        }
     }
 
-  return retlen;
+  /* The last literals */
+
+  lit = inend - anchor;
+  if (inlen == 0 || outend - outptr < 1 + (lit + 240) / 255 + lit)
+    {
+      return gen_blkhdr(inbuffer, inlen, 0, 0, result);
+    }
+
+  token  = outptr++;
+  *token = (lit >= 15 ? 15 : lit) << 4;
+
+  if (lit >= 15)
+    {
+      outptr = lz4_putlen(outptr, lit - 15);
+    }
+
+  memcpy(outptr, anchor, lit);
+  outptr += lit;
+
+  return gen_blkhdr(inbuffer, inlen,
+                    outptr - result->compressed.lzf_buffer,
+                    CROMFS_LZ4_HDR, result);
 }
 
 static uint16_t get_mode(mode_t mode)
@@ -1069,7 +1217,15 @@ static void gen_file(const char *path, const char *name, mode_t mode,
 
           /* Compress the chunk */
 
-          blklen = lzf_compress(iobuffer, nread, &result);
+          if (g_lz4)
+            {
+              blklen = lz4_compress(iobuffer, nread, &result);
+            }
+          else
+            {
+              blklen = lzf_compress(iobuffer, nread, &result);
+            }
+
           if (result.cmn.lzf_type == LZF_TYPE0_HDR)
             {
               clen = nread;
@@ -1280,6 +1436,13 @@ int main(int argc, char **argv, char **envp)
   ptr = strrchr(argv[0], '/');
   g_progname = ptr == NULL ? argv[0] : ptr + 1;
 
+  if (argc > 1 && strcmp(argv[1], "-lz4") == 0)
+    {
+      g_lz4 = true;
+      argc--;
+      argv++;
+    }
+
   if (argc != 3)
     {
       fprintf(stderr, "Unexpected number of arguments\n");
@@ -443,9 +443,21 @@ void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
   while (remaining)
     {
       buf = bt_l2cap_create_pdu(conn);
+      if (buf == NULL)
+        {
+          wlerr("ERROR: Failed to allocate a fragment\n");
+
+          while ((buf = (FAR struct bt_buf_s *)sq_remfirst(&fraglist))
+                 != NULL)
+            {
+              bt_buf_release(buf);
+            }
+
+          return;
+        }
 
       len = remaining;
-      if (len < g_btdev.le_mtu)
+      if (len > g_btdev.le_mtu)
         {
           len = g_btdev.le_mtu;
         }
@@ -668,6 +668,60 @@ static void hci_disconn_complete(FAR struct bt_buf_s *buf)
     }
 }
 
+#if defined(CONFIG_BLUETOOTH_LE_DATA_LEN_EXT) || \
+    defined(CONFIG_BLUETOOTH_LE_2M_PHY)
+static void le_conn_setup(FAR struct bt_conn_s *conn)
+{
+  FAR struct bt_buf_s *buf;
+
+#ifdef CONFIG_BLUETOOTH_LE_DATA_LEN_EXT
+  /* Ask the controller to use the longest link layer PDU that it supports.
+   * Without this, each ACL fragment carries at most 27 bytes of payload.
+   */
+
+  if ((g_btdev.le_features[0] & BT_HCI_LE_DATA_LEN_EXT) != 0)
+    {
+      FAR struct bt_hci_cp_le_set_data_len_s *dl;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_DATA_LEN, sizeof(*dl));
+      if (buf != NULL)
+        {
+          dl            = bt_buf_extend(buf, sizeof(*dl));
+          dl->handle    = BT_HOST2LE16(conn->handle);
+          dl->tx_octets = BT_HOST2LE16(BT_LE_DATA_LEN_MAX_OCTETS);
+          dl->tx_time   = BT_HOST2LE16(BT_LE_DATA_LEN_MAX_TIME);
+
+          bt_hci_cmd_send(BT_HCI_OP_LE_SET_DATA_LEN, buf);
+        }
+    }
+#endif
+
+#ifdef CONFIG_BLUETOOTH_LE_2M_PHY
+  /* Prefer the 2M PHY in both directions.  The controller falls back to
+   * the 1M PHY if the peer does not support it.
+   */
+
+  if ((g_btdev.le_features[1] & BT_HCI_LE_2M_PHY) != 0)
+    {
+      FAR struct bt_hci_cp_le_set_phy_s *phy;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_PHY, sizeof(*phy));
+      if (buf != NULL)
+        {
+          phy           = bt_buf_extend(buf, sizeof(*phy));
+          phy->handle   = BT_HOST2LE16(conn->handle);
+          phy->all_phys = 0;
+          phy->tx_phys  = BT_LE_PHY_1M | BT_LE_PHY_2M;
+          phy->rx_phys  = BT_LE_PHY_1M | BT_LE_PHY_2M;
+          phy->phy_opts = 0;
+
+          bt_hci_cmd_send(BT_HCI_OP_LE_SET_PHY, buf);
+        }
+    }
+#endif
+}
+#endif
+
 static void le_conn_complete(FAR struct bt_buf_s *buf)
 {
   FAR struct bt_hci_evt_le_conn_complete_s *evt = (FAR void *)buf->data;
@@ -728,6 +782,11 @@ static void le_conn_complete(FAR struct bt_buf_s *buf)
 
   bt_conn_set_state(conn, BT_CONN_CONNECTED);
 
+#if defined(CONFIG_BLUETOOTH_LE_DATA_LEN_EXT) || \
+    defined(CONFIG_BLUETOOTH_LE_2M_PHY)
+  le_conn_setup(conn);
+#endif
+
   bt_l2cap_connected(conn);
 
   if (evt->role == BT_HCI_ROLE_SLAVE)
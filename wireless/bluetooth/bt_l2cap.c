@@ -45,10 +45,15 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <sched.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+
 #include <nuttx/wireless/bluetooth/bt_hci.h>
 #include <nuttx/wireless/bluetooth/bt_core.h>
 
@@ -59,41 +64,827 @@
 #include "bt_smp.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LE_CONN_MIN_INTERVAL         0x0028
+#define LE_CONN_MAX_INTERVAL         0x0038
+#define LE_CONN_LATENCY              0x0000
+#define LE_CONN_TIMEOUT              0x002a
+
+#define BT_L2CAP_CONN_PARAM_ACCEPTED 0
+#define BT_L2CAP_CONN_PARAM_REJECTED 1
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct bt_l2cap_chan_s *g_channels;
+static FAR struct bt_l2cap_chan_s *g_default;
+
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+static FAR struct bt_l2cap_le_chan_s *g_lechans;
+static FAR struct bt_l2cap_le_server_s *g_leservers;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint8_t get_ident(FAR struct bt_conn_s *conn)
+{
+  conn->l2cap.ident++;
+
+  /* Handle integer overflow (0 is not valid) */
+
+  if (!conn->l2cap.ident)
+    {
+      conn->l2cap.ident++;
+    }
+
+  return conn->l2cap.ident;
+}
+
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+/****************************************************************************
+ * Name: le_sig_create
+ *
+ * Description:
+ *   Allocate a buffer and add the header of an LE signaling command with a
+ *   payload of 'len' bytes.
+ *
+ ****************************************************************************/
+
+static FAR struct bt_buf_s *le_sig_create(FAR struct bt_conn_s *conn,
+                                          uint8_t code, uint8_t ident,
+                                          uint16_t len)
+{
+  FAR struct bt_l2cap_sig_hdr_s *hdr;
+  FAR struct bt_buf_s *buf;
+
+  buf = bt_l2cap_create_pdu(conn);
+  if (buf != NULL)
+    {
+      hdr        = bt_buf_extend(buf, sizeof(*hdr));
+      hdr->code  = code;
+      hdr->ident = ident;
+      hdr->len   = BT_HOST2LE16(len);
+    }
+
+  return buf;
+}
+
+/****************************************************************************
+ * Name: le_txq_add and le_txq_free
+ *
+ * Description:
+ *   Add a buffer to the end of a list of K-frames and free all K-frames in
+ *   a list.
+ *
+ ****************************************************************************/
+
+static void le_txq_add(FAR struct bt_bufferlist_s *list,
+                       FAR struct bt_buf_s *buf)
+{
+  buf->flink = NULL;
+  if (list->tail == NULL)
+    {
+      list->head = buf;
+    }
+  else
+    {
+      list->tail->flink = buf;
+    }
+
+  list->tail = buf;
+}
+
+static void le_txq_free(FAR struct bt_bufferlist_s *list)
+{
+  FAR struct bt_buf_s *buf;
+
+  while ((buf = list->head) != NULL)
+    {
+      list->head = buf->flink;
+      bt_buf_release(buf);
+    }
+
+  list->tail = NULL;
+}
+
+/****************************************************************************
+ * Name: le_chan_lookup and le_chan_lookup_ident
+ *
+ * Description:
+ *   Find the LE credit based channel of the connection by its local (rx) or
+ *   remote (tx) CID, or by the identifier of its pending request.
+ *
+ * Assumptions:
+ *   Channels are only removed from the list on the HCI receive path.  So a
+ *   channel found on that path stays valid after the critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct bt_l2cap_le_chan_s *
+le_chan_lookup(FAR struct bt_conn_s *conn, uint16_t cid, bool remote)
+{
+  FAR struct bt_l2cap_le_chan_s *chan;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (chan = g_lechans; chan != NULL; chan = chan->flink)
+    {
+      if (chan->conn == conn &&
+          (remote ? chan->tx.cid : chan->rx.cid) == cid)
+        {
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return chan;
+}
+
+static FAR struct bt_l2cap_le_chan_s *
+le_chan_lookup_ident(FAR struct bt_conn_s *conn, uint8_t ident)
+{
+  FAR struct bt_l2cap_le_chan_s *chan;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (chan = g_lechans; chan != NULL; chan = chan->flink)
+    {
+      if (chan->conn == conn && chan->ident == ident)
+        {
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return chan;
+}
+
+/****************************************************************************
+ * Name: le_chan_add
+ *
+ * Description:
+ *   Allocate a local CID for a new LE credit based channel of the
+ *   connection, initialize the local endpoint, and add the channel to the
+ *   list of channels.
+ *
+ ****************************************************************************/
+
+static int le_chan_add(FAR struct bt_conn_s *conn,
+                       FAR struct bt_l2cap_le_chan_s *chan)
+{
+  FAR struct bt_l2cap_le_chan_s *tmp;
+  irqstate_t flags;
+  uint16_t cid;
+
+  flags = enter_critical_section();
+  for (cid = BT_L2CAP_CID_LE_DYN_START; cid <= BT_L2CAP_CID_LE_DYN_END;
+       cid++)
+    {
+      for (tmp = g_lechans; tmp != NULL; tmp = tmp->flink)
+        {
+          if (tmp->conn == conn && tmp->rx.cid == cid)
+            {
+              break;
+            }
+        }
+
+      if (tmp == NULL)
+        {
+          break;
+        }
+    }
+
+  if (cid > BT_L2CAP_CID_LE_DYN_END)
+    {
+      leave_critical_section(flags);
+      return -ENOMEM;
+    }
+
+  chan->conn       = bt_conn_addref(conn);
+  chan->rx.cid     = cid;
+  chan->rx.mtu     = CONFIG_BLUETOOTH_L2CAP_LE_MTU;
+  chan->rx.mps     = CONFIG_BLUETOOTH_L2CAP_LE_MPS;
+  chan->rx.credits = CONFIG_BLUETOOTH_L2CAP_LE_CREDITS;
+  chan->ident      = 0;
+  chan->sdulen     = 0;
+  chan->sdu        = NULL;
+  chan->txq.head   = NULL;
+  chan->txq.tail   = NULL;
+
+  chan->flink      = g_lechans;
+  g_lechans        = chan;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: le_chan_del
+ *
+ * Description:
+ *   Remove an LE credit based channel from the list of channels and free
+ *   its buffers.  If 'notify' is true, then report the disconnection to the
+ *   user of the channel.
+ *
+ ****************************************************************************/
+
+static void le_chan_del(FAR struct bt_l2cap_le_chan_s *chan, bool notify)
+{
+  FAR struct bt_l2cap_le_chan_s *prev;
+  FAR struct bt_l2cap_le_chan_s *curr;
+  FAR struct bt_conn_s *conn;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (prev = NULL, curr = g_lechans; curr != NULL && curr != chan;
+       prev = curr, curr = curr->flink);
+
+  if (curr == NULL)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  if (prev == NULL)
+    {
+      g_lechans = chan->flink;
+    }
+  else
+    {
+      prev->flink = chan->flink;
+    }
+
+  conn        = chan->conn;
+  chan->flink = NULL;
+  chan->conn  = NULL;
+  chan->state = BT_L2CAP_LE_DISCONNECTED;
+  leave_critical_section(flags);
+
+  le_txq_free(&chan->txq);
+  if (chan->sdu != NULL)
+    {
+      bt_buf_release(chan->sdu);
+      chan->sdu = NULL;
+    }
+
+  bt_conn_release(conn);
+
+  if (notify && chan->disconnected != NULL)
+    {
+      chan->disconnected(chan);
+    }
+}
+
+/****************************************************************************
+ * Name: le_chan_flush
+ *
+ * Description:
+ *   Send queued K-frames for as long as the peer has given credits.
+ *
+ ****************************************************************************/
+
+static void le_chan_flush(FAR struct bt_l2cap_le_chan_s *chan)
+{
+  FAR struct bt_buf_s *buf;
+  irqstate_t flags;
+
+  /* Frames are sent from the thread of the user and from the HCI receive
+   * path.  Keep the two from reordering the frames.
+   */
+
+  sched_lock();
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      buf   = chan->txq.head;
+      if (buf == NULL || chan->tx.credits == 0 ||
+          chan->state != BT_L2CAP_LE_CONNECTED)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      chan->txq.head = buf->flink;
+      if (chan->txq.head == NULL)
+        {
+          chan->txq.tail = NULL;
+        }
+
+      buf->flink = NULL;
+      chan->tx.credits--;
+      leave_critical_section(flags);
+
+      bt_l2cap_send(chan->conn, chan->tx.cid, buf);
+    }
+
+  sched_unlock();
+}
+
+/****************************************************************************
+ * Name: le_chan_disconn_req
+ *
+ * Description:
+ *   Ask the peer to disconnect an LE credit based channel.  The channel is
+ *   removed when the response arrives or when the connection is lost.
+ *
+ ****************************************************************************/
+
+static int le_chan_disconn_req(FAR struct bt_l2cap_le_chan_s *chan)
+{
+  FAR struct bt_l2cap_disconn_req_s *req;
+  FAR struct bt_buf_s *buf;
+
+  chan->ident = get_ident(chan->conn);
+  chan->state = BT_L2CAP_LE_DISCONNECTING;
+
+  buf = le_sig_create(chan->conn, BT_L2CAP_DISCONN_REQ, chan->ident,
+                      sizeof(*req));
+  if (buf == NULL)
+    {
+      return -ENOBUFS;
+    }
+
+  req       = bt_buf_extend(buf, sizeof(*req));
+  req->dcid = BT_HOST2LE16(chan->tx.cid);
+  req->scid = BT_HOST2LE16(chan->rx.cid);
+
+  bt_l2cap_send(chan->conn, BT_L2CAP_CID_LE_SIG, buf);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: le_chan_return_credits
+ *
+ * Description:
+ *   Give the peer new credits once half of the credits have been used.
+ *   Returning the credits in one batch saves a signaling PDU per K-frame.
+ *
+ ****************************************************************************/
+
+static void le_chan_return_credits(FAR struct bt_l2cap_le_chan_s *chan)
+{
+  FAR struct bt_l2cap_le_credits_s *ev;
+  FAR struct bt_buf_s *buf;
+  uint16_t credits;
+
+  if (chan->state != BT_L2CAP_LE_CONNECTED ||
+      chan->rx.credits > CONFIG_BLUETOOTH_L2CAP_LE_CREDITS / 2)
+    {
+      return;
+    }
+
+  credits = CONFIG_BLUETOOTH_L2CAP_LE_CREDITS - chan->rx.credits;
+
+  buf = le_sig_create(chan->conn, BT_L2CAP_LE_CREDITS,
+                      get_ident(chan->conn), sizeof(*ev));
+  if (buf == NULL)
+    {
+      return;
+    }
+
+  ev               = bt_buf_extend(buf, sizeof(*ev));
+  ev->cid          = BT_HOST2LE16(chan->rx.cid);
+  ev->credits      = BT_HOST2LE16(credits);
+  chan->rx.credits = CONFIG_BLUETOOTH_L2CAP_LE_CREDITS;
+
+  bt_l2cap_send(chan->conn, BT_L2CAP_CID_LE_SIG, buf);
+}
+
+/****************************************************************************
+ * Name: le_chan_receive
+ *
+ * Description:
+ *   Receive a K-frame on an LE credit based channel.  A K-frame that holds
+ *   a complete SDU is passed on as is.  Otherwise the SDU is reassembled.
+ *
+ ****************************************************************************/
+
+static void le_chan_receive(FAR struct bt_l2cap_le_chan_s *chan,
+                            FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_buf_s *sdu;
+
+  if (chan->state != BT_L2CAP_LE_CONNECTED)
+    {
+      bt_buf_release(buf);
+      return;
+    }
+
+  if (chan->rx.credits == 0)
+    {
+      wlerr("ERROR: K-frame without credits on CID 0x%04x\n",
+            chan->rx.cid);
+      goto errout;
+    }
+
+  chan->rx.credits--;
+
+  if (buf->len > chan->rx.mps)
+    {
+      wlerr("ERROR: K-frame exceeds MPS (%u > %u)\n",
+            buf->len, chan->rx.mps);
+      goto errout;
+    }
+
+  if (chan->sdu == NULL)
+    {
+      /* The first K-frame of an SDU starts with the SDU length */
+
+      if (buf->len < BT_L2CAP_LE_SDU_HDRLEN)
+        {
+          wlerr("ERROR: Too small first K-frame\n");
+          goto errout;
+        }
+
+      chan->sdulen = bt_buf_get_le16(buf);
+      if (chan->sdulen > chan->rx.mtu)
+        {
+          wlerr("ERROR: SDU exceeds MTU (%u > %u)\n",
+                chan->sdulen, chan->rx.mtu);
+          goto errout;
+        }
+
+      if (buf->len == chan->sdulen)
+        {
+          chan->receive(chan, buf);
+          le_chan_return_credits(chan);
+          return;
+        }
+
+      chan->sdu = bt_buf_alloc(BT_ACL_IN, NULL, 0);
+      if (chan->sdu == NULL || bt_buf_tailroom(chan->sdu) < chan->sdulen)
+        {
+          wlerr("ERROR: No buffer for an SDU of %u bytes\n", chan->sdulen);
+          goto errout;
+        }
+    }
+
+  if (chan->sdu->len + buf->len > chan->sdulen)
+    {
+      wlerr("ERROR: SDU length mismatch\n");
+      goto errout;
+    }
+
+  memcpy(bt_buf_extend(chan->sdu, buf->len), buf->data, buf->len);
+  bt_buf_release(buf);
+
+  if (chan->sdu->len == chan->sdulen)
+    {
+      sdu       = chan->sdu;
+      chan->sdu = NULL;
+      chan->receive(chan, sdu);
+    }
+
+  le_chan_return_credits(chan);
+  return;
+
+errout:
+
+  /* The peer violated the protocol.  Drop the channel. */
+
+  bt_buf_release(buf);
+  if (chan->sdu != NULL)
+    {
+      bt_buf_release(chan->sdu);
+      chan->sdu = NULL;
+    }
+
+  le_chan_disconn_req(chan);
+}
+
+/****************************************************************************
+ * Name: le_conn_req
+ *
+ * Description:
+ *   Handle a request of the peer for a new LE credit based channel.
+ *
+ ****************************************************************************/
+
+static void le_conn_req(FAR struct bt_conn_s *conn, uint8_t ident,
+                        FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_l2cap_le_conn_req_s *req = (FAR void *)buf->data;
+  FAR struct bt_l2cap_le_conn_rsp_s *rsp;
+  FAR struct bt_l2cap_le_server_s *server;
+  FAR struct bt_l2cap_le_chan_s *chan = NULL;
+  uint16_t psm;
+  uint16_t scid;
+  uint16_t mtu;
+  uint16_t mps;
+  uint16_t result;
+
+  if (buf->len < sizeof(*req))
+    {
+      wlerr("ERROR: Too small LE conn req\n");
+      return;
+    }
+
+  psm  = BT_LE162HOST(req->psm);
+  scid = BT_LE162HOST(req->scid);
+  mtu  = BT_LE162HOST(req->mtu);
+  mps  = BT_LE162HOST(req->mps);
+
+  wlinfo("psm 0x%02x scid 0x%04x mtu %u mps %u\n", psm, scid, mtu, mps);
+
+  for (server = g_leservers; server != NULL; server = server->flink)
+    {
+      if (server->psm == psm)
+        {
+          break;
+        }
+    }
+
+  if (mtu < BT_L2CAP_LE_MIN_MTU || mps < BT_L2CAP_LE_MIN_MTU)
+    {
+      result = BT_L2CAP_LE_ERR_UNACCEPT;
+    }
+  else if (scid < BT_L2CAP_CID_LE_DYN_START ||
+           scid > BT_L2CAP_CID_LE_DYN_END)
+    {
+      result = BT_L2CAP_LE_ERR_INVALID_SCID;
+    }
+  else if (le_chan_lookup(conn, scid, true) != NULL)
+    {
+      result = BT_L2CAP_LE_ERR_SCID_IN_USE;
+    }
+  else if (server == NULL)
+    {
+      result = BT_L2CAP_LE_ERR_PSM_NOT_SUPP;
+    }
+  else if (server->accept(conn, &chan) < 0 || le_chan_add(conn, chan) < 0)
+    {
+      chan   = NULL;
+      result = BT_L2CAP_LE_ERR_NO_RESOURCES;
+    }
+  else
+    {
+      DEBUGASSERT(chan->receive != NULL);
+
+      chan->psm        = psm;
+      chan->tx.cid     = scid;
+      chan->tx.mtu     = mtu;
+      chan->tx.mps     = mps;
+      chan->tx.credits = BT_LE162HOST(req->credits);
+      result           = BT_L2CAP_LE_SUCCESS;
+    }
+
+  buf = le_sig_create(conn, BT_L2CAP_LE_CONN_RSP, ident, sizeof(*rsp));
+  if (buf == NULL)
+    {
+      if (chan != NULL)
+        {
+          le_chan_del(chan, false);
+        }
+
+      return;
+    }
+
+  rsp         = bt_buf_extend(buf, sizeof(*rsp));
+  memset(rsp, 0, sizeof(*rsp));
+  rsp->result = BT_HOST2LE16(result);
+
+  if (chan != NULL)
+    {
+      rsp->dcid    = BT_HOST2LE16(chan->rx.cid);
+      rsp->mtu     = BT_HOST2LE16(chan->rx.mtu);
+      rsp->mps     = BT_HOST2LE16(chan->rx.mps);
+      rsp->credits = BT_HOST2LE16(chan->rx.credits);
+    }
+
+  bt_l2cap_send(conn, BT_L2CAP_CID_LE_SIG, buf);
+
+  if (chan != NULL)
+    {
+      chan->state = BT_L2CAP_LE_CONNECTED;
+      if (chan->connected != NULL)
+        {
+          chan->connected(chan);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: le_conn_rsp
+ *
+ * Description:
+ *   Handle the response of the peer to our request for a new LE credit
+ *   based channel.
+ *
  ****************************************************************************/
 
-#define LE_CONN_MIN_INTERVAL         0x0028
-#define LE_CONN_MAX_INTERVAL         0x0038
-#define LE_CONN_LATENCY              0x0000
-#define LE_CONN_TIMEOUT              0x002a
+static void le_conn_rsp(FAR struct bt_conn_s *conn, uint8_t ident,
+                        FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_l2cap_le_conn_rsp_s *rsp = (FAR void *)buf->data;
+  FAR struct bt_l2cap_le_chan_s *chan;
+  uint16_t result;
+  uint16_t dcid;
 
-#define BT_L2CAP_CONN_PARAM_ACCEPTED 0
-#define BT_L2CAP_CONN_PARAM_REJECTED 1
+  if (buf->len < sizeof(*rsp))
+    {
+      wlerr("ERROR: Too small LE conn rsp\n");
+      return;
+    }
+
+  chan = le_chan_lookup_ident(conn, ident);
+  if (chan == NULL || chan->state != BT_L2CAP_LE_CONNECTING)
+    {
+      wlwarn("WARNING: No pending request for ident %u\n", ident);
+      return;
+    }
+
+  result      = BT_LE162HOST(rsp->result);
+  dcid        = BT_LE162HOST(rsp->dcid);
+  chan->ident = 0;
+
+  wlinfo("result 0x%04x dcid 0x%04x\n", result, dcid);
+
+  if (result != BT_L2CAP_LE_SUCCESS ||
+      dcid < BT_L2CAP_CID_LE_DYN_START || dcid > BT_L2CAP_CID_LE_DYN_END)
+    {
+      le_chan_del(chan, true);
+      return;
+    }
+
+  chan->tx.cid     = dcid;
+  chan->tx.mtu     = BT_LE162HOST(rsp->mtu);
+  chan->tx.mps     = BT_LE162HOST(rsp->mps);
+  chan->tx.credits = BT_LE162HOST(rsp->credits);
+  chan->state      = BT_L2CAP_LE_CONNECTED;
+
+  if (chan->connected != NULL)
+    {
+      chan->connected(chan);
+    }
+}
 
 /****************************************************************************
- * Private Data
+ * Name: le_credits
+ *
+ * Description:
+ *   Handle new credits from the peer and send the K-frames that waited for
+ *   them.
+ *
  ****************************************************************************/
 
-static FAR struct bt_l2cap_chan_s *g_channels;
-static FAR struct bt_l2cap_chan_s *g_default;
+static void le_credits(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_l2cap_le_credits_s *ev = (FAR void *)buf->data;
+  FAR struct bt_l2cap_le_chan_s *chan;
+  irqstate_t flags;
+  uint32_t credits;
+
+  if (buf->len < sizeof(*ev))
+    {
+      wlerr("ERROR: Too small LE credits\n");
+      return;
+    }
+
+  chan = le_chan_lookup(conn, BT_LE162HOST(ev->cid), true);
+  if (chan == NULL || chan->state != BT_L2CAP_LE_CONNECTED)
+    {
+      return;
+    }
+
+  flags   = enter_critical_section();
+  credits = (uint32_t)chan->tx.credits + BT_LE162HOST(ev->credits);
+  if (credits <= UINT16_MAX)
+    {
+      chan->tx.credits = (uint16_t)credits;
+    }
+
+  leave_critical_section(flags);
+
+  if (credits > UINT16_MAX)
+    {
+      wlerr("ERROR: Credit overflow on CID 0x%04x\n", chan->rx.cid);
+      le_chan_disconn_req(chan);
+      return;
+    }
+
+  le_chan_flush(chan);
+}
 
 /****************************************************************************
- * Private Functions
+ * Name: le_disconn_req and le_disconn_rsp
+ *
+ * Description:
+ *   Handle a request of the peer to disconnect an LE credit based channel
+ *   and the response of the peer to our request.
+ *
  ****************************************************************************/
 
-static uint8_t get_ident(FAR struct bt_conn_s *conn)
+static void le_disconn_req(FAR struct bt_conn_s *conn, uint8_t ident,
+                           FAR struct bt_buf_s *buf)
 {
-  conn->l2cap.ident++;
+  FAR struct bt_l2cap_disconn_req_s *req = (FAR void *)buf->data;
+  FAR struct bt_l2cap_disconn_rsp_s *rsp;
+  FAR struct bt_l2cap_le_chan_s *chan;
 
-  /* Handle integer overflow (0 is not valid) */
+  if (buf->len < sizeof(*req))
+    {
+      wlerr("ERROR: Too small disconn req\n");
+      return;
+    }
 
-  if (!conn->l2cap.ident)
+  chan = le_chan_lookup(conn, BT_LE162HOST(req->dcid), false);
+  if (chan == NULL || chan->tx.cid != BT_LE162HOST(req->scid))
     {
-      conn->l2cap.ident++;
+      wlwarn("WARNING: No channel 0x%04x\n", BT_LE162HOST(req->dcid));
+      return;
     }
 
-  return conn->l2cap.ident;
+  buf = le_sig_create(conn, BT_L2CAP_DISCONN_RSP, ident, sizeof(*rsp));
+  if (buf != NULL)
+    {
+      rsp       = bt_buf_extend(buf, sizeof(*rsp));
+      rsp->dcid = req->dcid;
+      rsp->scid = req->scid;
+
+      bt_l2cap_send(conn, BT_L2CAP_CID_LE_SIG, buf);
+    }
+
+  le_chan_del(chan, true);
+}
+
+static void le_disconn_rsp(FAR struct bt_conn_s *conn,
+                           FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_l2cap_disconn_rsp_s *rsp = (FAR void *)buf->data;
+  FAR struct bt_l2cap_le_chan_s *chan;
+
+  if (buf->len < sizeof(*rsp))
+    {
+      wlerr("ERROR: Too small disconn rsp\n");
+      return;
+    }
+
+  chan = le_chan_lookup(conn, BT_LE162HOST(rsp->scid), false);
+  if (chan != NULL && chan->state == BT_L2CAP_LE_DISCONNECTING)
+    {
+      le_chan_del(chan, true);
+    }
+}
+
+/****************************************************************************
+ * Name: le_cmd_reject
+ *
+ * Description:
+ *   A peer that does not support LE credit based channels rejects our
+ *   request for a new channel or for a disconnection.
+ *
+ ****************************************************************************/
+
+static void le_cmd_reject(FAR struct bt_conn_s *conn, uint8_t ident)
+{
+  FAR struct bt_l2cap_le_chan_s *chan;
+
+  chan = le_chan_lookup_ident(conn, ident);
+  if (chan != NULL && chan->state != BT_L2CAP_LE_CONNECTED)
+    {
+      le_chan_del(chan, true);
+    }
+}
+
+/****************************************************************************
+ * Name: le_chan_disconnected
+ *
+ * Description:
+ *   The connection was lost.  Remove all of its LE credit based channels.
+ *
+ ****************************************************************************/
+
+static void le_chan_disconnected(FAR struct bt_conn_s *conn)
+{
+  FAR struct bt_l2cap_le_chan_s *chan;
+  irqstate_t flags;
+
+  do
+    {
+      flags = enter_critical_section();
+      for (chan = g_lechans; chan != NULL; chan = chan->flink)
+        {
+          if (chan->conn == conn)
+            {
+              break;
+            }
+        }
+
+      leave_critical_section(flags);
+
+      if (chan != NULL)
+        {
+          le_chan_del(chan, true);
+        }
+    }
+  while (chan != NULL);
 }
+#endif /* CONFIG_BLUETOOTH_L2CAP_LE_COC */
 
 void bt_l2cap_chan_register(FAR struct bt_l2cap_chan_s *chan)
 {
@@ -152,6 +943,12 @@ void bt_l2cap_disconnected(FAR struct bt_conn_s *conn)
     {
       chan->disconnected(conn, chan->context, chan->cid);
     }
+
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+  /* Remove all LE credit based channels of the connection */
+
+  le_chan_disconnected(conn);
+#endif
 }
 
 void bt_l2cap_encrypt_change(FAR struct bt_conn_s *conn)
@@ -359,6 +1156,32 @@ static void le_sig(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf,
       le_conn_param_update_req(conn, hdr->ident, buf);
       break;
 
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+    case BT_L2CAP_CMD_REJECT:
+      le_cmd_reject(conn, hdr->ident);
+      break;
+
+    case BT_L2CAP_LE_CONN_REQ:
+      le_conn_req(conn, hdr->ident, buf);
+      break;
+
+    case BT_L2CAP_LE_CONN_RSP:
+      le_conn_rsp(conn, hdr->ident, buf);
+      break;
+
+    case BT_L2CAP_LE_CREDITS:
+      le_credits(conn, buf);
+      break;
+
+    case BT_L2CAP_DISCONN_REQ:
+      le_disconn_req(conn, hdr->ident, buf);
+      break;
+
+    case BT_L2CAP_DISCONN_RSP:
+      le_disconn_rsp(conn, buf);
+      break;
+#endif
+
     default:
       wlwarn("Unknown L2CAP PDU code 0x%02x\n", hdr->code);
       rej_not_understood(conn, hdr->ident);
@@ -387,6 +1210,22 @@ void bt_l2cap_receive(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
 
   wlinfo("Packet for CID %u len %u\n", cid, buf->len);
 
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+  /* Check for an LE credit based channel */
+
+  if (cid >= BT_L2CAP_CID_LE_DYN_START && cid <= BT_L2CAP_CID_LE_DYN_END)
+    {
+      FAR struct bt_l2cap_le_chan_s *lechan;
+
+      lechan = le_chan_lookup(conn, cid, false);
+      if (lechan != NULL)
+        {
+          le_chan_receive(lechan, buf);
+          return;
+        }
+    }
+#endif
+
   /* Search for a subscriber to this channel */
 
   for (chan = g_channels; chan != NULL; chan = chan->flink)
@@ -450,6 +1289,292 @@ void bt_l2cap_update_conn_param(FAR struct bt_conn_s *conn)
   bt_l2cap_send(conn, BT_L2CAP_CID_LE_SIG, buf);
 }
 
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+/****************************************************************************
+ * Name: bt_l2cap_le_server_register
+ *
+ * Description:
+ *   Register a server for LE credit based channels on a PSM.
+ *
+ * Input Parameters:
+ *   server - The server.  Must stay valid for as long as L2CAP runs.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int bt_l2cap_le_server_register(FAR struct bt_l2cap_le_server_s *server)
+{
+  FAR struct bt_l2cap_le_server_s *tmp;
+
+  DEBUGASSERT(server != NULL && server->accept != NULL);
+
+  if (server->psm < BT_L2CAP_LE_PSM_MIN || server->psm > BT_L2CAP_LE_PSM_MAX)
+    {
+      return -EINVAL;
+    }
+
+  for (tmp = g_leservers; tmp != NULL; tmp = tmp->flink)
+    {
+      if (tmp->psm == server->psm)
+        {
+          return -EADDRINUSE;
+        }
+    }
+
+  wlinfo("PSM 0x%02x\n", server->psm);
+
+  server->flink = g_leservers;
+  g_leservers   = server;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bt_l2cap_le_connect
+ *
+ * Description:
+ *   Request a new LE credit based channel to a PSM of the peer.  The
+ *   connected callback is called when the peer accepts the channel; the
+ *   disconnected callback if it refuses it.
+ *
+ * Input Parameters:
+ *   conn - The connection to the peer
+ *   chan - The zeroed channel with the callbacks and context filled in
+ *   psm  - The PSM of the peer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the request was sent; a negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+int bt_l2cap_le_connect(FAR struct bt_conn_s *conn,
+                        FAR struct bt_l2cap_le_chan_s *chan, uint16_t psm)
+{
+  FAR struct bt_l2cap_le_conn_req_s *req;
+  FAR struct bt_buf_s *buf;
+  int ret;
+
+  DEBUGASSERT(conn != NULL && chan != NULL && chan->receive != NULL);
+
+  if (psm < BT_L2CAP_LE_PSM_MIN || psm > BT_L2CAP_LE_PSM_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (conn->state != BT_CONN_CONNECTED)
+    {
+      return -ENOTCONN;
+    }
+
+  if (chan->state != BT_L2CAP_LE_DISCONNECTED)
+    {
+      return -EALREADY;
+    }
+
+  ret = le_chan_add(conn, chan);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  chan->psm   = psm;
+  chan->ident = get_ident(conn);
+  chan->state = BT_L2CAP_LE_CONNECTING;
+
+  buf = le_sig_create(conn, BT_L2CAP_LE_CONN_REQ, chan->ident,
+                      sizeof(*req));
+  if (buf == NULL)
+    {
+      le_chan_del(chan, false);
+      return -ENOBUFS;
+    }
+
+  req          = bt_buf_extend(buf, sizeof(*req));
+  req->psm     = BT_HOST2LE16(psm);
+  req->scid    = BT_HOST2LE16(chan->rx.cid);
+  req->mtu     = BT_HOST2LE16(chan->rx.mtu);
+  req->mps     = BT_HOST2LE16(chan->rx.mps);
+  req->credits = BT_HOST2LE16(chan->rx.credits);
+
+  bt_l2cap_send(conn, BT_L2CAP_CID_LE_SIG, buf);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bt_l2cap_le_disconnect
+ *
+ * Description:
+ *   Disconnect an LE credit based channel.  The disconnected callback is
+ *   called when the peer has confirmed the disconnection.
+ *
+ * Input Parameters:
+ *   chan - The connected channel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the request was sent; a negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+int bt_l2cap_le_disconnect(FAR struct bt_l2cap_le_chan_s *chan)
+{
+  DEBUGASSERT(chan != NULL);
+
+  if (chan->state != BT_L2CAP_LE_CONNECTED)
+    {
+      return -ENOTCONN;
+    }
+
+  return le_chan_disconn_req(chan);
+}
+
+/****************************************************************************
+ * Name: bt_l2cap_le_create_sdu
+ *
+ * Description:
+ *   Allocate a buffer for an SDU with room for all headers in front of the
+ *   data.  An SDU that fits into one K-frame is then sent without copying.
+ *
+ ****************************************************************************/
+
+FAR struct bt_buf_s *bt_l2cap_le_create_sdu(void)
+{
+  size_t head_reserve = BT_L2CAP_LE_SDU_HDRLEN +
+    sizeof(struct bt_l2cap_hdr_s) + sizeof(struct bt_hci_acl_hdr_s) +
+    g_btdev.btdev->head_reserve;
+
+  return bt_buf_alloc(BT_ACL_OUT, NULL, head_reserve);
+}
+
+/****************************************************************************
+ * Name: bt_l2cap_le_send
+ *
+ * Description:
+ *   Send an SDU on an LE credit based channel.  The SDU is segmented into
+ *   K-frames of at most the MPS of the peer.  The K-frames are queued and
+ *   sent as the peer gives credits.
+ *
+ * Input Parameters:
+ *   chan - The connected channel
+ *   buf  - The SDU.  The channel takes ownership of the buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the SDU was queued; a negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+int bt_l2cap_le_send(FAR struct bt_l2cap_le_chan_s *chan,
+                     FAR struct bt_buf_s *buf)
+{
+  struct bt_bufferlist_s frames;
+  FAR struct bt_buf_s *frame;
+  irqstate_t flags;
+  uint16_t sdulen;
+  uint16_t off;
+  size_t len;
+  int ret;
+
+  DEBUGASSERT(chan != NULL && buf != NULL);
+
+  if (chan->state != BT_L2CAP_LE_CONNECTED)
+    {
+      ret = -ENOTCONN;
+      goto errout;
+    }
+
+  sdulen = buf->len;
+  if (sdulen > chan->tx.mtu)
+    {
+      ret = -EMSGSIZE;
+      goto errout;
+    }
+
+  frames.head = NULL;
+  frames.tail = NULL;
+
+  if (sdulen + BT_L2CAP_LE_SDU_HDRLEN <= chan->tx.mps &&
+      bt_buf_headroom(buf) >= BT_L2CAP_LE_SDU_HDRLEN +
+      sizeof(struct bt_l2cap_hdr_s) + sizeof(struct bt_hci_acl_hdr_s) +
+      g_btdev.btdev->head_reserve)
+    {
+      uint16_t value = BT_HOST2LE16(sdulen);
+
+      /* The SDU fits into one K-frame.  Just add the SDU length. */
+
+      memcpy(bt_buf_provide(buf, sizeof(value)), &value, sizeof(value));
+      le_txq_add(&frames, buf);
+    }
+  else
+    {
+      /* Copy the SDU into K-frames.  The first one starts with the SDU
+       * length.
+       */
+
+      off = 0;
+      do
+        {
+          frame = bt_l2cap_create_pdu(chan->conn);
+          if (frame == NULL)
+            {
+              le_txq_free(&frames);
+              ret = -ENOBUFS;
+              goto errout;
+            }
+
+          len = chan->tx.mps;
+          if (off == 0)
+            {
+              bt_buf_put_le16(frame, sdulen);
+              len -= BT_L2CAP_LE_SDU_HDRLEN;
+            }
+
+          if (len > sdulen - off)
+            {
+              len = sdulen - off;
+            }
+
+          if (len > bt_buf_tailroom(frame))
+            {
+              len = bt_buf_tailroom(frame);
+            }
+
+          memcpy(bt_buf_extend(frame, len), buf->data + off, len);
+          le_txq_add(&frames, frame);
+          off += len;
+        }
+      while (off < sdulen);
+
+      bt_buf_release(buf);
+    }
+
+  /* Queue the K-frames and send as many as the credits allow */
+
+  flags = enter_critical_section();
+  if (chan->txq.tail == NULL)
+    {
+      chan->txq.head = frames.head;
+    }
+  else
+    {
+      chan->txq.tail->flink = frames.head;
+    }
+
+  chan->txq.tail = frames.tail;
+  leave_critical_section(flags);
+
+  le_chan_flush(chan);
+  return OK;
+
+errout:
+  bt_buf_release(buf);
+  return ret;
+}
+#endif /* CONFIG_BLUETOOTH_L2CAP_LE_COC */
+
 int bt_l2cap_init(void)
 {
   int ret;
@@ -53,14 +53,46 @@
 #define BT_L2CAP_CID_ATT             0x0004
 #define BT_L2CAP_CID_LE_SIG          0x0005
 #define BT_L2CAP_CID_SMP             0x0006
+#define BT_L2CAP_CID_LE_DYN_START    0x0040
+#define BT_L2CAP_CID_LE_DYN_END      0x007f
 
 #define BT_L2CAP_REJ_NOT_UNDERSTOOD  0x0000
 #define BT_L2CAP_REJ_MTU_EXCEEDED    0x0001
 #define BT_L2CAP_REJ_INVALID_CID     0x0002
 
 #define BT_L2CAP_CMD_REJECT          0x01
+#define BT_L2CAP_DISCONN_REQ         0x06
+#define BT_L2CAP_DISCONN_RSP         0x07
 #define BT_L2CAP_CONN_PARAM_REQ      0x12
 #define BT_L2CAP_CONN_PARAM_RSP      0x13
+#define BT_L2CAP_LE_CONN_REQ         0x14
+#define BT_L2CAP_LE_CONN_RSP         0x15
+#define BT_L2CAP_LE_CREDITS          0x16
+
+/* LE credit based connection response results */
+
+#define BT_L2CAP_LE_SUCCESS          0x0000
+#define BT_L2CAP_LE_ERR_PSM_NOT_SUPP 0x0002
+#define BT_L2CAP_LE_ERR_NO_RESOURCES 0x0004
+#define BT_L2CAP_LE_ERR_INVALID_SCID 0x0009
+#define BT_L2CAP_LE_ERR_SCID_IN_USE  0x000a
+#define BT_L2CAP_LE_ERR_UNACCEPT     0x000b
+
+/* LE credit based channels:  Range of LE PSMs, the minimum MTU and MPS, and
+ * the size of the SDU length field that starts the first K-frame of an SDU.
+ */
+
+#define BT_L2CAP_LE_PSM_MIN          0x0001
+#define BT_L2CAP_LE_PSM_MAX          0x00ff
+#define BT_L2CAP_LE_MIN_MTU          23
+#define BT_L2CAP_LE_SDU_HDRLEN       2
+
+/* LE credit based channel states */
+
+#define BT_L2CAP_LE_DISCONNECTED     0
+#define BT_L2CAP_LE_CONNECTING       1
+#define BT_L2CAP_LE_CONNECTED        2
+#define BT_L2CAP_LE_DISCONNECTING    3
 
 /****************************************************************************
  * Public Types
@@ -98,6 +130,42 @@ begin_packed_struct struct bt_l2cap_conn_param_rsp_s
   uint16_t result;
 } end_packed_struct;
 
+begin_packed_struct struct bt_l2cap_disconn_req_s
+{
+  uint16_t dcid;
+  uint16_t scid;
+} end_packed_struct;
+
+begin_packed_struct struct bt_l2cap_disconn_rsp_s
+{
+  uint16_t dcid;
+  uint16_t scid;
+} end_packed_struct;
+
+begin_packed_struct struct bt_l2cap_le_conn_req_s
+{
+  uint16_t psm;
+  uint16_t scid;
+  uint16_t mtu;
+  uint16_t mps;
+  uint16_t credits;
+} end_packed_struct;
+
+begin_packed_struct struct bt_l2cap_le_conn_rsp_s
+{
+  uint16_t dcid;
+  uint16_t mtu;
+  uint16_t mps;
+  uint16_t credits;
+  uint16_t result;
+} end_packed_struct;
+
+begin_packed_struct struct bt_l2cap_le_credits_s
+{
+  uint16_t cid;
+  uint16_t credits;
+} end_packed_struct;
+
 struct bt_l2cap_chan_s
 {
   FAR struct bt_l2cap_chan_s *flink;
@@ -114,6 +182,63 @@ struct bt_l2cap_chan_s
               FAR void *context, uint16_t cid);
 };
 
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+/* One end of an LE credit based channel */
+
+struct bt_l2cap_le_endpoint_s
+{
+  uint16_t cid;                   /* Channel ID of the endpoint */
+  uint16_t mtu;                   /* Largest SDU the endpoint accepts */
+  uint16_t mps;                   /* Largest K-frame the endpoint accepts */
+  uint16_t credits;               /* K-frames the endpoint may still accept */
+};
+
+/* An LE credit based connection-oriented channel.  The structure is
+ * provided by the user of the channel and must stay valid until the
+ * disconnected callback has been called.
+ */
+
+struct bt_l2cap_le_chan_s
+{
+  FAR struct bt_l2cap_le_chan_s *flink;
+  FAR struct bt_conn_s *conn;     /* The connection carrying the channel */
+  FAR void *context;              /* Passed back to the callbacks */
+  struct bt_l2cap_le_endpoint_s rx; /* The local endpoint */
+  struct bt_l2cap_le_endpoint_s tx; /* The remote endpoint */
+  uint16_t psm;                   /* The protocol/service multiplexer */
+  uint8_t ident;                  /* Identifier of a pending request */
+  uint8_t state;                  /* See BT_L2CAP_LE_* channel states */
+
+  /* Reassembly of a received SDU spanning several K-frames */
+
+  uint16_t sdulen;                /* Length of the SDU being reassembled */
+  FAR struct bt_buf_s *sdu;       /* The SDU being reassembled */
+
+  /* K-frames that wait for credits from the peer */
+
+  struct bt_bufferlist_s txq;
+
+  CODE void (*connected)(FAR struct bt_l2cap_le_chan_s *chan);
+  CODE void (*disconnected)(FAR struct bt_l2cap_le_chan_s *chan);
+  CODE void (*receive)(FAR struct bt_l2cap_le_chan_s *chan,
+                       FAR struct bt_buf_s *buf);
+};
+
+/* A server accepting LE credit based channels on a PSM.  accept() provides
+ * the (zeroed) channel structure for a new channel with the callbacks and
+ * context filled in or returns a negated errno value to refuse it.
+ */
+
+struct bt_l2cap_le_server_s
+{
+  FAR struct bt_l2cap_le_server_s *flink;
+  uint16_t psm;
+
+  CODE int (*accept)(FAR struct bt_conn_s *conn,
+                     FAR struct bt_l2cap_le_chan_s **chan);
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -155,6 +280,34 @@ void bt_l2cap_receive(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf);
 
 void bt_l2cap_update_conn_param(FAR struct bt_conn_s *conn);
 
+#ifdef CONFIG_BLUETOOTH_L2CAP_LE_COC
+/* Register a server for LE credit based channels on a PSM */
+
+int bt_l2cap_le_server_register(FAR struct bt_l2cap_le_server_s *server);
+
+/* Request a new LE credit based channel to a PSM of the peer.  The result
+ * is reported by the connected or the disconnected callback.
+ */
+
+int bt_l2cap_le_connect(FAR struct bt_conn_s *conn,
+                        FAR struct bt_l2cap_le_chan_s *chan, uint16_t psm);
+
+/* Disconnect an LE credit based channel */
+
+int bt_l2cap_le_disconnect(FAR struct bt_l2cap_le_chan_s *chan);
+
+/* Prepare a buffer for an SDU to be sent on an LE credit based channel */
+
+FAR struct bt_buf_s *bt_l2cap_le_create_sdu(void);
+
+/* Send an SDU on an LE credit based channel.  The channel takes ownership
+ * of the buffer, even on failure.
+ */
+
+int bt_l2cap_le_send(FAR struct bt_l2cap_le_chan_s *chan,
+                     FAR struct bt_buf_s *buf);
+#endif
+
 /* Initialize L2CAP and supported channels */
 
 int bt_l2cap_init(void);
@@ -394,11 +394,11 @@ static void btnet_l2cap_receive(FAR struct bt_conn_s *conn,
        * io_offset should be a valid IPHC header.
        */
 
-      if ((iob->io_data[iob->io_offset] & SIXLOWPAN_DISPATCH_NALP_MASK) ==
-          SIXLOWPAN_DISPATCH_NALP)
+      if ((frame->io_data[frame->io_offset] &
+           SIXLOWPAN_DISPATCH_NALP_MASK) == SIXLOWPAN_DISPATCH_NALP)
         {
           wlwarn("WARNING: Dropped... Not a 6LoWPAN frame: %02x\n",
-                 iob->io_data[iob->io_offset]);
+                 frame->io_data[frame->io_offset]);
           ret = -EINVAL;
         }
       else
@@ -409,7 +409,7 @@ static void btnet_l2cap_receive(FAR struct bt_conn_s *conn,
 
           /* And give the packet to 6LoWPAN */
 
-          ret = sixlowpan_input(&priv->bd_dev, iob, (FAR void *)meta);
+          ret = sixlowpan_input(&priv->bd_dev, frame, (FAR void *)&meta);
         }
     }
 #endif
@@ -934,6 +934,11 @@ static int btnet_req_data(FAR struct radio_driver_s *netdev,
       if (buf == NULL)
         {
           wlerr("ERROR:  Failed to allocate buffer container\n");
+
+          /* Free this frame and the frames that were not yet sent */
+
+          iob->io_flink = framelist;
+          iob_free_chain(iob, IOBUSER_WIRELESS_BLUETOOTH);
           return -ENOMEM;
         }
 
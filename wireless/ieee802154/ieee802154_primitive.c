@@ -1,7 +1,7 @@
 /****************************************************************************
  *  wireless/ieee802154/ieee802154_primitive.c
  *
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -173,6 +173,7 @@ void ieee802154_primitivepool_initialize(void)
        */
 
       prim->flink = g_primfree;
+      prim->pool  = POOL_PRIMITIVE_GENERAL;
       g_primfree  = prim;
 
       /* Set up for the next structure from the pool */
@@ -258,7 +259,7 @@ FAR struct ieee802154_primitive_s *ieee802154_primitive_allocate(void)
           g_primfree     = prim->flink;
 
           leave_critical_section(flags);
-          pool          = POOL_PRIMITIVE_GENERAL;
+          pool          = prim->pool;
         }
       else
 #endif
@@ -294,7 +295,7 @@ FAR struct ieee802154_primitive_s *ieee802154_primitive_allocate(void)
           g_primfree     = prim->flink;
 
           leave_critical_section(flags);
-          pool          = POOL_PRIMITIVE_GENERAL;
+          pool          = prim->pool;
         }
       else
 #endif
@@ -369,10 +370,16 @@ void ieee802154_primitive_free(FAR struct ieee802154_primitive_s *prim)
 
 #if CONFIG_IEEE802154_PRIMITIVE_PREALLOC > CONFIG_IEEE802154_PRIMITIVE_IRQRESERVE
   /* If this is a generally available pre-allocated primitive structure,
-   * then just put it back in the free list.
+   * then just put it back in the free list.  So is a dynamically allocated
+   * one if dynamically allocated primitives are recycled.
    */
 
+#ifdef CONFIG_IEEE802154_PRIMITIVE_RECYCLE
+  if (priv->pool == POOL_PRIMITIVE_GENERAL ||
+      priv->pool == POOL_PRIMITIVE_DYNAMIC)
+#else
   if (priv->pool == POOL_PRIMITIVE_GENERAL)
+#endif
     {
       /* Make sure we avoid concurrent access to the free
        * list from interrupt handlers.
@@ -2,7 +2,7 @@
  * wireless/ieee802154/mac802154.c
  *
  *   Copyright (C) 2016 Sebastien Lorquet. All rights reserved.
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
  *   Copyright (C) 2017 Verge Inc. All rights reserved.
  *
  *   Author: Sebastien Lorquet <sebastien@lorquet.fr>
@@ -73,6 +73,9 @@
 /* Data structure pools and allocation helpers */
 
 static void mac802154_resetqueues(FAR struct ieee802154_privmac_s *priv);
+static FAR sq_queue_t *
+  mac802154_indqueue(FAR struct ieee802154_privmac_s *priv,
+                     FAR const struct ieee802154_addr_s *addr);
 
 /* IEEE 802.15.4 PHY Interface OPs */
 
@@ -123,12 +126,20 @@ static void mac802154_resetqueues(FAR struct ieee802154_privmac_s *priv)
   int i;
 
   sq_init(&priv->txdone_queue);
-  sq_init(&priv->csma_queue);
   sq_init(&priv->gts_queue);
-  sq_init(&priv->indirect_queue);
   sq_init(&priv->dataind_queue);
   sq_init(&priv->primitive_queue);
 
+  for (i = 0; i < MAC802154_NTXPRIO; i++)
+    {
+      sq_init(&priv->csma_queue[i]);
+    }
+
+  for (i = 0; i < CONFIG_MAC802154_NINDIRECT; i++)
+    {
+      sq_init(&priv->indirect_queue[i]);
+    }
+
   /* Initialize the tx descriptor allocation pool */
 
   sq_init(&priv->txdesc_queue);
@@ -141,6 +152,37 @@ static void mac802154_resetqueues(FAR struct ieee802154_privmac_s *priv)
   nxsem_init(&priv->txdesc_sem, 0, CONFIG_MAC802154_NTXDESC);
 }
 
+/****************************************************************************
+ * Name: mac802154_indqueue
+ *
+ * Description:
+ *   Return the list of indirect transactions that holds the transactions
+ *   for the destination address.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *
+  mac802154_indqueue(FAR struct ieee802154_privmac_s *priv,
+                     FAR const struct ieee802154_addr_s *addr)
+{
+  unsigned int hash = 0;
+  int i;
+
+  if (addr->mode == IEEE802154_ADDRMODE_SHORT)
+    {
+      hash = addr->saddr[0] ^ addr->saddr[1];
+    }
+  else if (addr->mode == IEEE802154_ADDRMODE_EXTENDED)
+    {
+      for (i = 0; i < IEEE802154_EADDRSIZE; i++)
+        {
+          hash ^= addr->eaddr[i];
+        }
+    }
+
+  return &priv->indirect_queue[hash % CONFIG_MAC802154_NINDIRECT];
+}
+
 /****************************************************************************
  * Name: mac802154_txdesc_pool
  *
@@ -228,11 +270,53 @@ int mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
 
   (*txdesc)->purgetime = 0;
   (*txdesc)->retrycount = priv->maxretries;
+  (*txdesc)->txprio = MAC802154_NTXPRIO;
 
   (*txdesc)->conf = &primitive->u.dataconf;
   return OK;
 }
 
+/****************************************************************************
+ * Name: mac802154_txenqueue
+ *
+ * Description:
+ *   Link the tx descriptor into the CSMA transaction list of the priority
+ *   and notify the radio driver that there is data available.  The radio
+ *   polls for more frames after each completed transaction, so it is only
+ *   notified when the lists were empty.
+ *
+ * Assumptions:
+ *   priv MAC struct is locked when calling.
+ *
+ ****************************************************************************/
+
+void mac802154_txenqueue(FAR struct ieee802154_privmac_s *priv,
+                         FAR struct ieee802154_txdesc_s *txdesc,
+                         uint8_t txprio)
+{
+  bool notify = true;
+  int i;
+
+  DEBUGASSERT(txprio < MAC802154_NTXPRIO);
+
+  for (i = 0; i < MAC802154_NTXPRIO; i++)
+    {
+      if (!sq_empty(&priv->csma_queue[i]))
+        {
+          notify = false;
+          break;
+        }
+    }
+
+  txdesc->txprio = txprio;
+  sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue[txprio]);
+
+  if (notify)
+    {
+      priv->radio->txnotify(priv->radio, false);
+    }
+}
+
 /****************************************************************************
  * Name: mac802154_createdatareq
  *
@@ -508,6 +592,7 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
   uint8_t pendaddrspec_ind;
   uint8_t pendeaddr = 0;
   uint8_t pendsaddr = 0;
+  int i;
 
   /* Switch the buffer */
 
@@ -600,37 +685,41 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
 
   pendaddrspec_ind = beacon->bf_len++;
 
-  txdesc = (FAR struct ieee802154_txdesc_s *)
-             sq_peek(&priv->indirect_queue);
-
-  while (txdesc != NULL)
+  for (i = 0; i < CONFIG_MAC802154_NINDIRECT && pendsaddr + pendeaddr < 7;
+       i++)
     {
-      if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_SHORT)
-        {
-          pendsaddr++;
-          IEEE802154_SADDRCOPY(&beacon->bf_data[beacon->bf_len],
-                               txdesc->destaddr.saddr);
-          beacon->bf_len += IEEE802154_SADDRSIZE;
-        }
-      else if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_EXTENDED)
+      txdesc = (FAR struct ieee802154_txdesc_s *)
+                 sq_peek(&priv->indirect_queue[i]);
+
+      while (txdesc != NULL)
         {
-          pendeaddr++;
-          IEEE802154_EADDRCOPY(&beacon->bf_data[beacon->bf_len],
-                               txdesc->destaddr.eaddr);
-          beacon->bf_len += IEEE802154_EADDRSIZE;
-        }
+          if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_SHORT)
+            {
+              pendsaddr++;
+              IEEE802154_SADDRCOPY(&beacon->bf_data[beacon->bf_len],
+                                   txdesc->destaddr.saddr);
+              beacon->bf_len += IEEE802154_SADDRSIZE;
+            }
+          else if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_EXTENDED)
+            {
+              pendeaddr++;
+              IEEE802154_EADDRCOPY(&beacon->bf_data[beacon->bf_len],
+                                   txdesc->destaddr.eaddr);
+              beacon->bf_len += IEEE802154_EADDRSIZE;
+            }
 
-      /* Check if we are up to 7 addresses yet */
+          /* Check if we are up to 7 addresses yet */
 
-      if ((pendsaddr + pendeaddr) == 7)
-        {
-          break;
-        }
+          if ((pendsaddr + pendeaddr) == 7)
+            {
+              break;
+            }
 
-      /* Get the next pending indirect transation */
+          /* Get the next pending indirect transation */
 
-      txdesc = (FAR struct ieee802154_txdesc_s *)
-                 sq_next((FAR sq_entry_t *)txdesc);
+          txdesc = (FAR struct ieee802154_txdesc_s *)
+                     sq_next((FAR sq_entry_t *)txdesc);
+        }
     }
 
   /* At this point, we know how many of each transaction we have, we can setup
@@ -669,9 +758,10 @@ void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
   uint32_t ticks;
   uint32_t symbols;
 
-  /* Link the tx descriptor into the list */
+  /* Link the tx descriptor into the list of its destination */
 
-  sq_addlast((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+  sq_addlast((FAR sq_entry_t *)txdesc,
+             mac802154_indqueue(priv, &txdesc->destaddr));
 
   /* Update the timestamp for purging the transaction */
 
@@ -706,7 +796,7 @@ void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
 
   /* Check to see if the purge indirect timer is scheduled. If it is, when the
    * timer fires, it will schedule the next purge timer event. Inherently, the
-   * queue will be in order of which transaction needs to be purged next.
+   * queues will be in order of which transaction needs to be purged next.
    *
    * If the purge indirect timer has not been scheduled, schedule it for when
    * this transaction should expire.
@@ -724,10 +814,10 @@ void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
  *
  * Description:
  *   Worker function scheduled in order to purge expired indirect
- *   transactions.  The first element in the list should always be removed.
- *   The list is searched and transactions are removed until a transaction
- *   has not yet expired.  Then if there are any remaining transactions, the
- *   work function is rescheduled for the next expiring transaction.
+ *   transactions.  Each list is in order of expiration, so transactions are
+ *   removed from the head of each list until a transaction has not yet
+ *   expired.  Then if there are any remaining transactions, the work
+ *   function is rescheduled for the next expiring transaction.
  *
  ****************************************************************************/
 
@@ -736,6 +826,8 @@ static void mac802154_purge_worker(FAR void *arg)
   FAR struct ieee802154_privmac_s *priv =
     (FAR struct ieee802154_privmac_s *)arg;
   FAR struct ieee802154_txdesc_s *txdesc;
+  FAR struct ieee802154_txdesc_s *next = NULL;
+  int i;
 
   /* Get exclusive access to the driver structure.  We don't care about any
    * signals so don't allow interruptions
@@ -743,29 +835,35 @@ static void mac802154_purge_worker(FAR void *arg)
 
   mac802154_lock(priv, false);
 
-  while (1)
+  for (i = 0; i < CONFIG_MAC802154_NINDIRECT; i++)
     {
       /* Pop transactions off indirect queue until the transaction timeout
        * has not passed.
        */
 
-      txdesc = (FAR struct ieee802154_txdesc_s *)
-                 sq_peek(&priv->indirect_queue);
-      if (txdesc == NULL)
+      while ((txdesc = (FAR struct ieee802154_txdesc_s *)
+                         sq_peek(&priv->indirect_queue[i])) != NULL)
         {
-          break;
-        }
+          /* Should probably check a little ahead and remove the transaction
+           * if it is within a certain number of clock ticks away.  There is
+           * no since in scheduling the timer to expire in only a few ticks.
+           */
 
-      /* Should probably check a little ahead and remove the transaction if
-       * it is within a certain number of clock ticks away.  There is no
-       * since in scheduling the timer to expire in only a few ticks.
-       */
+          if (clock_systimer() < txdesc->purgetime)
+            {
+              /* Remember the transaction that expires next */
+
+              if (next == NULL || txdesc->purgetime < next->purgetime)
+                {
+                  next = txdesc;
+                }
+
+              break;
+            }
 
-      if (clock_systimer() >= txdesc->purgetime)
-        {
           /* Unlink the transaction */
 
-          sq_remfirst(&priv->indirect_queue);
+          sq_remfirst(&priv->indirect_queue[i]);
 
           /* Free the IOB, the notification, and the tx descriptor */
 
@@ -777,14 +875,14 @@ static void mac802154_purge_worker(FAR void *arg)
 
           wlinfo("Indirect TX purged");
         }
-      else
-        {
-          /* Reschedule the transaction for the next timeout */
+    }
 
-          work_queue(HPWORK, &priv->purge_work, mac802154_purge_worker,
-                     (FAR void *)priv, txdesc->purgetime - clock_systimer());
-          break;
-        }
+  /* Reschedule the transaction for the next timeout */
+
+  if (next != NULL)
+    {
+      work_queue(HPWORK, &priv->purge_work, mac802154_purge_worker,
+                 (FAR void *)priv, next->purgetime - clock_systimer());
     }
 
   mac802154_unlock(priv);
@@ -809,6 +907,7 @@ static int
   FAR struct mac802154_radiocb_s *cb =
     (FAR struct mac802154_radiocb_s *)radiocb;
   FAR struct ieee802154_privmac_s *priv;
+  int i;
 
   DEBUGASSERT(cb != NULL && cb->priv != NULL);
   priv = cb->priv;
@@ -817,6 +916,8 @@ static int
 
   mac802154_lock(priv, false);
 
+  *txdesc = NULL;
+
   if (gts)
     {
       /* Check to see if there are any GTS transactions waiting */
@@ -826,10 +927,15 @@ static int
     }
   else
     {
-      /* Check to see if there are any CSMA transactions waiting */
+      /* Check to see if there are any CSMA transactions waiting, highest
+       * priority first.
+       */
 
-      *txdesc = (FAR struct ieee802154_txdesc_s *)
-                  sq_remfirst(&priv->csma_queue);
+      for (i = 0; i < MAC802154_NTXPRIO && *txdesc == NULL; i++)
+        {
+          *txdesc = (FAR struct ieee802154_txdesc_s *)
+                      sq_remfirst(&priv->csma_queue[i]);
+        }
     }
 
   mac802154_unlock(priv)
@@ -872,6 +978,23 @@ static void mac802154_txdone(FAR const struct ieee802154_radiocb_s *radiocb,
 
   mac802154_lock(priv, false);
 
+  /* If the radio does not retransmit by itself, retransmit unacknowledged
+   * CSMA frames ahead of the other frames of the same priority, up to
+   * macMaxFrameRetries times.
+   */
+
+  if ((priv->radiocaps & IEEE802154_RADIOCAP_RETRY) == 0 &&
+      txdesc->conf->status == IEEE802154_STATUS_NO_ACK &&
+      txdesc->txprio < MAC802154_NTXPRIO && txdesc->retrycount > 0)
+    {
+      txdesc->retrycount--;
+      sq_addfirst((FAR sq_entry_t *)txdesc,
+                  &priv->csma_queue[txdesc->txprio]);
+      priv->radio->txnotify(priv->radio, false);
+      mac802154_unlock(priv)
+      return;
+    }
+
   sq_addlast((FAR sq_entry_t *)txdesc, &priv->txdone_queue);
 
   mac802154_unlock(priv)
@@ -1465,6 +1588,7 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
                                  FAR struct ieee802154_data_ind_s *ind)
 {
   FAR struct ieee802154_txdesc_s *txdesc;
+  FAR sq_queue_t *queue;
   FAR struct iob_s *iob;
   uint16_t *frame_ctrl;
 
@@ -1482,7 +1606,8 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
    * need to check for this condition.
    */
 
-  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
+  queue  = mac802154_indqueue(priv, &ind->src);
+  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(queue);
 
   while (txdesc != NULL)
     {
@@ -1494,7 +1619,7 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
                 {
                   /* Remove the transaction from the queue */
 
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+                  sq_rem((FAR sq_entry_t *)txdesc, queue);
 
                   /* NOTE: We don't do anything with the purge timeout,
                    * because we really don't need to. As of now, I see no
@@ -1519,7 +1644,7 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
                 {
                   /* Remove the transaction from the queue */
 
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+                  sq_rem((FAR sq_entry_t *)txdesc, queue);
 
                   /* The addresses match, send the transaction immediately */
 
@@ -1997,13 +2122,11 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
           mac802154_createdatareq(priv, &priv->pandesc.coordaddr,
                                  IEEE802154_ADDRMODE_EXTENDED, respdesc);
 
-          /* Link the transaction into the CSMA transaction list */
-
-          sq_addlast((FAR sq_entry_t *)respdesc, &priv->csma_queue);
-
-          /* Notify the radio driver that there is data available */
+          /* Link the transaction into the CSMA transaction list and notify
+           * the radio driver that there is data available.
+           */
 
-          priv->radio->txnotify(priv->radio, false);
+          mac802154_txenqueue(priv, respdesc, MAC802154_TXPRIO_CMD);
         }
       else
         {
@@ -2059,13 +2182,11 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
                                              respdesc);
                     }
 
-                  /* Link the transaction into the CSMA transaction list */
-
-                  sq_addlast((FAR sq_entry_t *)respdesc, &priv->csma_queue);
-
-                  /* Notify the radio driver that there is data available */
+                  /* Link the transaction into the CSMA transaction list and
+                   * notify the radio driver that there is data available.
+                   */
 
-                  priv->radio->txnotify(priv->radio, false);
+                  mac802154_txenqueue(priv, respdesc, MAC802154_TXPRIO_CMD);
                 }
 
               /* If there was a beacon payload, we used the primitive, so
@@ -2174,6 +2295,22 @@ MACHANDLE mac802154_create(FAR struct ieee802154_radio_s *radiodev)
 
   radiodev->bind(radiodev, &mac->radiocb.cb);
 
+  /* Find out what the radio offloads */
+
+  mac->radiocaps = IEEE802154_RADIOCAP_ALL;
+  if (radiodev->getcaps != NULL)
+    {
+      mac->radiocaps = radiodev->getcaps(radiodev);
+    }
+
+  if ((mac->radiocaps & (IEEE802154_RADIOCAP_CSMA |
+                         IEEE802154_RADIOCAP_AUTOACK)) !=
+      (IEEE802154_RADIOCAP_CSMA | IEEE802154_RADIOCAP_AUTOACK))
+    {
+      wlwarn("WARNING: Radio lacks CSMA-CA or auto-ACK: caps=%02x\n",
+             mac->radiocaps);
+    }
+
   /* Initialize our various data pools */
 
   ieee802154_primitivepool_initialize();
@@ -298,13 +298,11 @@ int mac802154_req_associate(MACHANDLE mac,
     {
       wlinfo("Queuing assoc request for CAP\n");
 
-      /* Link the transaction into the CSMA transaction list */
-
-      sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
-
-      /* Notify the radio driver that there is data available */
+      /* Link the transaction into the CSMA transaction list and notify the
+       * radio driver that there is data available.
+       */
 
-      priv->radio->txnotify(priv->radio, false);
+      mac802154_txenqueue(priv, txdesc, MAC802154_TXPRIO_CMD);
     }
 
   /* We no longer need to have the MAC layer locked. */
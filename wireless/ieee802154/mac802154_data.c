@@ -1,7 +1,7 @@
 /****************************************************************************
  * wireless/ieee802154/mac802154_data.c
  *
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
  *   Copyright (C) 2017 Verge Inc. All rights reserved.
  *
  *   Author: Gregory Nutt <gnutt@nuttx.org>
@@ -342,17 +342,18 @@ int mac802154_req_data(MACHANDLE mac,
         }
       else
         {
-          /* Link the transaction into the CSMA transaction list */
+          /* Link the transaction into the CSMA transaction list of its
+           * priority and notify the radio driver that there is data
+           * available.
+           */
 
-          sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+          mac802154_txenqueue(priv, txdesc, meta->flags.priority ?
+                              MAC802154_TXPRIO_HIGH :
+                              MAC802154_TXPRIO_NORMAL);
 
           /* We no longer need to have the MAC layer locked. */
 
           mac802154_unlock(priv)
-
-          /* Notify the radio driver that there is data available */
-
-          priv->radio->txnotify(priv->radio, false);
         }
     }
 
@@ -80,10 +80,22 @@
 #  define CONFIG_MAC802154_NTXDESC 5
 #endif
 
+#if !defined(CONFIG_MAC802154_NINDIRECT) || CONFIG_MAC802154_NINDIRECT <= 0
+#  undef CONFIG_MAC802154_NINDIRECT
+#  define CONFIG_MAC802154_NINDIRECT 8
+#endif
+
 #if !defined(CONFIG_IEEE802154_DEFAULT_EADDR)
 #  define CONFIG_IEEE802154_DEFAULT_EADDR 0xFFFFFFFFFFFFFFFF
 #endif
 
+/* CSMA transmit queues, in the order in which they are served */
+
+#define MAC802154_TXPRIO_CMD     0  /* MAC command frames */
+#define MAC802154_TXPRIO_HIGH    1  /* Data frames with the priority flag */
+#define MAC802154_TXPRIO_NORMAL  2  /* Other data frames */
+#define MAC802154_NTXPRIO        3  /* Number of queues, also "no queue" */
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -175,10 +187,11 @@ struct ieee802154_privmac_s
   /* Support a singly linked list of transactions that will be sent using the
    * CSMA algorithm.  On a non-beacon enabled PAN, these transactions will be
    * sent whenever. On a beacon-enabled PAN, these transactions will be sent
-   * during the CAP of the Coordinator's superframe.
+   * during the CAP of the Coordinator's superframe.  There is one list for
+   * each priority, see MAC802154_TXPRIO_*.
    */
 
-  sq_queue_t csma_queue;
+  sq_queue_t csma_queue[MAC802154_NTXPRIO];
   sq_queue_t gts_queue;
 
   /* Support a singly linked list of transactions that will be sent indirectly.
@@ -187,9 +200,13 @@ struct ieee802154_privmac_s
    * device sending a Data Request MAC command or if too much time passes. This
    * list should also be used to populate the address list of the outgoing
    * beacon frame.
+   *
+   * The transactions are hashed by destination address into separate lists
+   * so that a Data Request only searches the transactions of neighbours
+   * that share its hash.  Each list is in order of expiration.
    */
 
-  sq_queue_t indirect_queue;
+  sq_queue_t indirect_queue[CONFIG_MAC802154_NINDIRECT];
 
   /* Support a singly linked list of frames received */
 
@@ -321,6 +338,8 @@ struct ieee802154_privmac_s
 
   /* End of 8-bit bitfield. */
 
+  uint8_t radiocaps;                /* IEEE802154_RADIOCAP_* of the radio */
+
 
 
   /* TODO: Add Security-related MAC PIB attributes */
@@ -333,6 +352,9 @@ struct ieee802154_privmac_s
 int  mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
       FAR struct ieee802154_txdesc_s **txdesc, bool allow_interrupt);
 
+void mac802154_txenqueue(FAR struct ieee802154_privmac_s *priv,
+      FAR struct ieee802154_txdesc_s *txdesc, uint8_t txprio);
+
 void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
       FAR struct ieee802154_txdesc_s *txdesc);
 
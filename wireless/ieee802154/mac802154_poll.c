@@ -2,7 +2,7 @@
  * wireless/ieee802154/mac802154_poll.c
  *
  *   Copyright (C) 2016 Sebastien Lorquet. All rights reserved.
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017, 2020 Gregory Nutt. All rights reserved.
  *   Copyright (C) 2017 Verge Inc. All rights reserved.
  *
  *   Author: Sebastien Lorquet <sebastien@lorquet.fr>
@@ -154,18 +154,16 @@ int mac802154_req_poll(MACHANDLE mac, FAR struct ieee802154_poll_req_s *req)
 
   wlinfo("Queuing POLL.request in CSMA queue\n");
 
-  /* Link the transaction into the CSMA transaction list */
+  /* Link the transaction into the CSMA transaction list and notify the
+   * radio driver that there is data available.
+   */
 
-  sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+  mac802154_txenqueue(priv, txdesc, MAC802154_TXPRIO_CMD);
 
   /* We no longer need to have the MAC layer locked. */
 
   mac802154_unlock(priv)
 
-  /* Notify the radio driver that there is data available */
-
-  priv->radio->txnotify(priv->radio, false);
-
   return OK;
 }
 